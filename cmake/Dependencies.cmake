@@ -1,4 +1,4 @@
-# Copyright (c) 2017-2019, 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2017-2019, 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -137,6 +137,31 @@ list(APPEND DALI_LIBS ${CUDART_LIB} ${DALI_SYSTEM_LIBS})
 list(APPEND DALI_EXCLUDES libsupc++.a;libstdc++.a;libstdc++_nonshared.a;)
 
 
+##################################################################
+# cuFile (GPU Direct Storage)
+##################################################################
+if (BUILD_CUFILE)
+  # The batch I/O API is available only in the newer cuFile versions; the library is loaded
+  # dynamically, so only the header is checked
+  include(CheckCXXSourceCompiles)
+  set(CMAKE_REQUIRED_INCLUDES_OLD ${CMAKE_REQUIRED_INCLUDES})
+  list(APPEND CMAKE_REQUIRED_INCLUDES ${CMAKE_CUDA_TOOLKIT_INCLUDE_DIRECTORIES})
+  check_cxx_source_compiles("
+    #include <cufile.h>
+    int main() {
+      CUfileBatchHandle_t batch;
+      CUfileIOParams_t params;
+      CUfileIOEvents_t events;
+      (void)batch; (void)params; (void)events;
+      return 0;
+    }" CUFILE_BATCH_API)
+  set(CMAKE_REQUIRED_INCLUDES ${CMAKE_REQUIRED_INCLUDES_OLD})
+
+  if (${CUFILE_BATCH_API})
+    add_definitions(-DCUFILE_BATCH_API)
+  endif()
+endif()
+
 ##################################################################
 # Turing Optical flow API
 ##################################################################
@@ -127,6 +127,70 @@ if(BUILD_LIBTAR)
   list(APPEND DALI_EXCLUDES libtar.a)
 endif()
 
+##################################################################
+# blosc
+##################################################################
+if(BUILD_BLOSC)
+  find_library(blosc_LIBS
+          NAMES libblosc.a blosc
+          PATHS ${BLOSC_ROOT_DIR} "/usr/local" ${CMAKE_SYSTEM_PREFIX_PATH}
+          PATH_SUFFIXES lib lib64)
+  if(${blosc_LIBS} STREQUAL blosc_LIBS-NOTFOUND)
+    message(FATAL_ERROR "blosc could not be found. Try to specify it's location with `-DBLOSC_ROOT_DIR`.")
+  endif()
+  message(STATUS "Found blosc: ${blosc_LIBS}")
+  list(APPEND DALI_LIBS ${blosc_LIBS})
+  list(APPEND DALI_EXCLUDES libblosc.a)
+endif()
+
+##################################################################
+# zstd
+##################################################################
+if(BUILD_ZSTD)
+  find_library(zstd_LIBS
+          NAMES libzstd.a zstd
+          PATHS ${ZSTD_ROOT_DIR} "/usr/local" ${CMAKE_SYSTEM_PREFIX_PATH}
+          PATH_SUFFIXES lib lib64)
+  if(${zstd_LIBS} STREQUAL zstd_LIBS-NOTFOUND)
+    message(FATAL_ERROR "zstd could not be found. Try to specify it's location with `-DZSTD_ROOT_DIR`.")
+  endif()
+  message(STATUS "Found zstd: ${zstd_LIBS}")
+  list(APPEND DALI_LIBS ${zstd_LIBS})
+  list(APPEND DALI_EXCLUDES libzstd.a)
+endif()
+
+##################################################################
+# lz4
+##################################################################
+if(BUILD_LZ4)
+  find_library(lz4_LIBS
+          NAMES liblz4.a lz4
+          PATHS ${LZ4_ROOT_DIR} "/usr/local" ${CMAKE_SYSTEM_PREFIX_PATH}
+          PATH_SUFFIXES lib lib64)
+  if(${lz4_LIBS} STREQUAL lz4_LIBS-NOTFOUND)
+    message(FATAL_ERROR "lz4 could not be found. Try to specify it's location with `-DLZ4_ROOT_DIR`.")
+  endif()
+  message(STATUS "Found lz4: ${lz4_LIBS}")
+  list(APPEND DALI_LIBS ${lz4_LIBS})
+  list(APPEND DALI_EXCLUDES liblz4.a)
+endif()
+
+##################################################################
+# zlib
+##################################################################
+if(BUILD_ZLIB)
+  find_library(zlib_LIBS
+          NAMES libz.a z
+          PATHS ${ZLIB_ROOT_DIR} "/usr/local" ${CMAKE_SYSTEM_PREFIX_PATH}
+          PATH_SUFFIXES lib lib64)
+  if(${zlib_LIBS} STREQUAL zlib_LIBS-NOTFOUND)
+    message(FATAL_ERROR "zlib could not be found. Try to specify it's location with `-DZLIB_ROOT_DIR`.")
+  endif()
+  message(STATUS "Found zlib: ${zlib_LIBS}")
+  list(APPEND DALI_LIBS ${zlib_LIBS})
+  list(APPEND DALI_EXCLUDES libz.a)
+endif()
+
 
 ##################################################################
 # FFmpeg
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,9 +13,12 @@
 // limitations under the License.
 
 #include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
 
 #include "dali/benchmark/dali_bench.h"
 #include "dali/core/tensor_shape.h"
+#include "dali/kernels/imgproc/color_manipulation/color_space_conversion_cpu.h"
 #include "dali/pipeline/pipeline.h"
 #include "dali/util/image.h"
 
@@ -115,6 +118,80 @@ BENCHMARK_REGISTER_F(DecoderBench, ImageDecoder_CPU)->Iterations(100)
 ->UseRealTime()
 ->Apply(PipeArgs);
 
+BENCHMARK_DEFINE_F(DecoderBench, ImageDecoderYCbCr_CPU)(benchmark::State& st) {
+  int batch_size = st.range(0);
+  int num_thread = st.range(1);
+
+  this->DecoderPipelineTest(
+    st, batch_size, num_thread, "cpu",
+    OpSpec("ImageDecoder")
+      .AddArg("device", "cpu")
+      .AddArg("output_type", DALI_YCbCr)
+      .AddInput("raw_jpegs", "cpu")
+      .AddOutput("images", "cpu"));
+}
+
+BENCHMARK_REGISTER_F(DecoderBench, ImageDecoderYCbCr_CPU)->Iterations(100)
+->Unit(benchmark::kMillisecond)
+->UseRealTime()
+->Apply(PipeArgs);
+
+namespace {
+
+std::vector<uint8_t> RandomImage(int64_t npixels) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<uint8_t> image(npixels * 3);
+  for (auto &x : image)
+    x = dist(rng);
+  return image;
+}
+
+constexpr int64_t kColorBenchPixels = 1920 * 1080;
+
+}  // namespace
+
+// The color conversion done by the host decoders after decoding, vectorized and per-pixel
+static void BM_RgbToYCbCr(benchmark::State &st) {
+  auto image = RandomImage(kColorBenchPixels);
+  std::vector<uint8_t> out(image.size());
+  for (auto _ : st) {
+    kernels::color::rgb_to_ycbcr(out.data(), image.data(), kColorBenchPixels);
+    benchmark::DoNotOptimize(out.data());
+  }
+  st.SetItemsProcessed(st.iterations() * kColorBenchPixels);
+}
+BENCHMARK(BM_RgbToYCbCr);
+
+static void BM_RgbToYCbCr_PerPixel(benchmark::State &st) {
+  namespace color = kernels::color::itu_r_bt_601;
+  auto image = RandomImage(kColorBenchPixels);
+  std::vector<uint8_t> out(image.size());
+  for (auto _ : st) {
+    for (int64_t i = 0; i < kColorBenchPixels; i++) {
+      const uint8_t *px = &image[3 * i];
+      vec<3, uint8_t> rgb{px[0], px[1], px[2]};
+      out[3 * i] = color::rgb_to_y<uint8_t>(rgb);
+      out[3 * i + 1] = color::rgb_to_cb<uint8_t>(rgb);
+      out[3 * i + 2] = color::rgb_to_cr<uint8_t>(rgb);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  st.SetItemsProcessed(st.iterations() * kColorBenchPixels);
+}
+BENCHMARK(BM_RgbToYCbCr_PerPixel);
+
+static void BM_YCbCrToRgb(benchmark::State &st) {
+  auto image = RandomImage(kColorBenchPixels);
+  std::vector<uint8_t> out(image.size());
+  for (auto _ : st) {
+    kernels::color::ycbcr_to_rgb(out.data(), image.data(), kColorBenchPixels);
+    benchmark::DoNotOptimize(out.data());
+  }
+  st.SetItemsProcessed(st.iterations() * kColorBenchPixels);
+}
+BENCHMARK(BM_YCbCrToRgb);
+
 BENCHMARK_DEFINE_F(DecoderBench, ImageDecoder_GPU)(benchmark::State& st) {
   int batch_size = st.range(0);
   int num_thread = st.range(1);
@@ -0,0 +1,304 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/benchmark/file_stream_bench.h"
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "dali/core/error_handling.h"
+#include "dali/core/format.h"
+#include "dali/pipeline/util/thread_pool.h"
+#include "dali/util/file.h"
+#include "dali/util/uring_file.h"
+
+namespace dali {
+namespace file_stream_bench {
+
+namespace {
+
+/// The files of a size are created until they take this much (within the limits below)
+constexpr int64_t kTotalBytes = 256 << 20;
+constexpr int kMinFiles = 16;
+constexpr int kMaxFiles = 4096;
+
+/// The read ahead requested from the streams, the same as in the indexed readers
+constexpr size_t kReadAheadBytes = 4 << 20;
+
+std::string BenchDir() {
+  const char *env = std::getenv("DALI_FILE_STREAM_BENCH_DIR");
+  return env && *env ? env : "/tmp";
+}
+
+bool KeepPageCache() {
+  const char *env = std::getenv("DALI_FILE_STREAM_BENCH_WARM");
+  return env && std::atoi(env) != 0;
+}
+
+/**
+ * @brief The files of the benchmarks, removed at the exit
+ */
+class FileSets {
+ public:
+  ~FileSets() {
+    for (auto &set : sets_) {
+      for (auto &path : set.second)
+        unlink(path.c_str());
+    }
+  }
+
+  const std::vector<std::string> &Get(int64_t file_size) {
+    std::lock_guard<std::mutex> g(mtx_);
+    auto &files = sets_[file_size];
+    if (files.empty()) {
+      int num_files = std::min<int64_t>(std::max<int64_t>(kTotalBytes / file_size, kMinFiles),
+                                        kMaxFiles);
+      std::vector<uint8_t> data(file_size);
+      std::mt19937_64 rng(file_size);
+      for (auto &b : data)
+        b = static_cast<uint8_t>(rng());
+      for (int i = 0; i < num_files; i++) {
+        files.push_back(make_string(BenchDir(), "/dali_file_stream_bench_", getpid(), "_",
+                                    file_size, "_", i));
+        Write(files.back(), data);
+      }
+    }
+    return files;
+  }
+
+ private:
+  static void Write(const std::string &path, const std::vector<uint8_t> &data) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    DALI_ENFORCE(fd >= 0, make_string("Could not create ", path, ": ", std::strerror(errno)));
+    size_t written = 0;
+    while (written < data.size()) {
+      ssize_t ret = write(fd, data.data() + written, data.size() - written);
+      if (ret < 0 && errno == EINTR)
+        continue;
+      if (ret <= 0) {
+        int err = errno;
+        close(fd);
+        DALI_FAIL(make_string("Could not write ", path, ": ", std::strerror(err)));
+      }
+      written += ret;
+    }
+    // only the clean pages can be dropped from the page cache
+    fsync(fd);
+    close(fd);
+  }
+
+  std::mutex mtx_;
+  std::map<int64_t, std::vector<std::string>> sets_;
+};
+
+FileSets &GetFileSets() {
+  static FileSets sets;
+  return sets;
+}
+
+void DropFromPageCache(const std::vector<std::string> &files) {
+  for (auto &path : files) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      continue;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+}
+
+/// The CPU time (user and system) of all the threads of the process, in seconds
+double ProcessCPUTime() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         1e-6 * (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+std::vector<Block> GetBlocks(int64_t file_size, int64_t block_size, bool random_access,
+                             std::mt19937_64 &rng) {
+  int64_t num_blocks = (file_size + block_size - 1) / block_size;
+  std::vector<Block> blocks;
+  blocks.reserve(num_blocks);
+  std::uniform_int_distribution<int64_t> dist(0, num_blocks - 1);
+  for (int64_t i = 0; i < num_blocks; i++) {
+    int64_t offset = (random_access ? dist(rng) : i) * block_size;
+    blocks.push_back({ offset, std::min(block_size, file_size - offset) });
+  }
+  return blocks;
+}
+
+std::unique_ptr<FileStream> OpenStream(const std::string &path, bool read_ahead, bool use_mmap,
+                                       bool use_io_uring) {
+  auto stream = FileStream::Open(path, read_ahead, use_mmap, use_io_uring, true);
+  if (read_ahead)
+    stream->SetReadAhead(kReadAheadBytes);
+  return stream;
+}
+
+/// Thread-local buffers of the CPU backends
+class Buffers {
+ public:
+  explicit Buffers(int num_threads) : buffers_(num_threads) {}
+
+  uint8_t *Get(int thread_idx, size_t size) {
+    auto &buffer = buffers_[thread_idx];
+    if (buffer.size() < size)
+      buffer.resize(size);
+    return buffer.data();
+  }
+
+ private:
+  std::vector<std::vector<uint8_t>> buffers_;
+};
+
+/// Reads the blocks one by one, with Read when they are consecutive and ReadAt otherwise
+void RunReadBenchmark(benchmark::State &st, bool use_mmap) {
+  bool read_ahead = st.range(3);
+  Buffers buffers(st.range(1));
+  RunFileStreamBenchmark(st, [&](const std::string &path, const std::vector<Block> &blocks,
+                                 int thread_idx) {
+    auto stream = OpenStream(path, read_ahead, use_mmap, false);
+    int64_t total = 0, pos = 0;
+    for (auto &block : blocks) {
+      uint8_t *buffer = buffers.Get(thread_idx, block.n_bytes);
+      size_t n = block.offset == pos
+                     ? stream->Read(buffer, block.n_bytes)
+                     : stream->ReadAt(buffer, block.n_bytes, block.offset);
+      if (block.offset == pos)
+        pos += n;
+      total += n;
+    }
+    stream->Close();
+    return total;
+  });
+}
+
+}  // namespace
+
+void FileStreamArgs(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"file_size", "threads", "random", "read_ahead", "block"});
+  b->ArgsProduct({
+    { 4 << 10, 64 << 10, 1 << 20, 16 << 20 },
+    { 1, 4, 16 },
+    { 0, 1 },
+    { 0, 1 },
+    { 4 << 10, 256 << 10 },
+  });
+}
+
+void RunFileStreamBenchmark(benchmark::State &st, const ReadFileFn &read_file, int device_id) {
+  int64_t file_size = st.range(0);
+  int num_threads = st.range(1);
+  bool random_access = st.range(2);
+  int64_t block_size = st.range(4);
+  auto &files = GetFileSets().Get(file_size);
+  bool drop_page_cache = !KeepPageCache();
+
+  ThreadPool thread_pool(num_threads, device_id, false, "FileStreamBench");
+  std::mt19937_64 rng(1234);
+  int64_t total_bytes = 0, total_reads = 0;
+  double cpu_time = 0;
+  for (auto _ : st) {
+    st.PauseTiming();
+    if (drop_page_cache)
+      DropFromPageCache(files);
+    std::vector<std::vector<Block>> blocks;
+    blocks.reserve(files.size());
+    for (size_t i = 0; i < files.size(); i++) {
+      blocks.push_back(GetBlocks(file_size, block_size, random_access, rng));
+      total_reads += blocks.back().size();
+    }
+    std::atomic<int64_t> bytes_read{0};
+    st.ResumeTiming();
+
+    double cpu_start = ProcessCPUTime();
+    for (size_t i = 0; i < files.size(); i++) {
+      thread_pool.AddWork([&, i](int thread_idx) {
+        bytes_read += read_file(files[i], blocks[i], thread_idx);
+      });
+    }
+    thread_pool.RunAll();
+    cpu_time += ProcessCPUTime() - cpu_start;
+    total_bytes += bytes_read;
+  }
+
+  st.SetBytesProcessed(total_bytes);
+  st.counters["MB"] = benchmark::Counter(total_bytes * 1e-6, benchmark::Counter::kIsRate);
+  st.counters["IOPS"] = benchmark::Counter(total_reads, benchmark::Counter::kIsRate);
+  st.counters["CPU_s/GB"] = total_bytes > 0 ? cpu_time / (total_bytes * 1e-9) : 0;
+}
+
+static void BM_StdFileStream(benchmark::State &st) {
+  RunReadBenchmark(st, false);
+}
+
+static void BM_MmapedFileStream(benchmark::State &st) {
+  RunReadBenchmark(st, true);
+}
+
+/// Reads all the blocks of a file with a single ReadBatch, serviced with io_uring
+static void BM_UringFileStream(benchmark::State &st) {
+  if (!UringFileStream::IsSupported()) {
+    st.SkipWithError("io_uring is not supported");
+    return;
+  }
+  bool read_ahead = st.range(3);
+  Buffers buffers(st.range(1));
+  RunFileStreamBenchmark(st, [&](const std::string &path, const std::vector<Block> &blocks,
+                                 int thread_idx) {
+    auto stream = OpenStream(path, read_ahead, false, true);
+    int64_t size = 0;
+    for (auto &block : blocks)
+      size += block.n_bytes;
+    uint8_t *buffer = buffers.Get(thread_idx, size);
+    std::vector<FileStream::ReadRequest> requests;
+    requests.reserve(blocks.size());
+    for (auto &block : blocks) {
+      FileStream::ReadRequest req;
+      req.stream = stream.get();
+      req.buffer = buffer;
+      req.n_bytes = block.n_bytes;
+      req.offset = block.offset;
+      requests.push_back(req);
+      buffer += block.n_bytes;
+    }
+    FileStream::ReadBatch(make_span(requests));
+    int64_t total = 0;
+    for (auto &req : requests)
+      total += req.bytes_read;
+    stream->Close();
+    return total;
+  });
+}
+
+BENCHMARK(BM_StdFileStream)->Unit(benchmark::kMillisecond)->UseRealTime()
+->Apply(FileStreamArgs);
+
+BENCHMARK(BM_MmapedFileStream)->Unit(benchmark::kMillisecond)->UseRealTime()
+->Apply(FileStreamArgs);
+
+BENCHMARK(BM_UringFileStream)->Unit(benchmark::kMillisecond)->UseRealTime()
+->Apply(FileStreamArgs);
+
+}  // namespace file_stream_bench
+}  // namespace dali
@@ -0,0 +1,76 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_BENCHMARK_FILE_STREAM_BENCH_H_
+#define DALI_BENCHMARK_FILE_STREAM_BENCH_H_
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "dali/core/common.h"
+
+namespace dali {
+namespace file_stream_bench {
+
+/**
+ * @brief A single read of a file: `n_bytes` at `offset`
+ */
+struct Block {
+  int64_t offset;
+  int64_t n_bytes;
+};
+
+/**
+ * @brief Reads the blocks of the file with the backend under test
+ *
+ * Called concurrently, once per file; `thread_idx` is in the range [0, num_threads),
+ * so that the callback can keep per-thread buffers.
+ *
+ * @return The number of bytes read
+ */
+using ReadFileFn = std::function<int64_t(const std::string &path, const std::vector<Block> &blocks,
+                                         int thread_idx)>;
+
+/**
+ * @brief The arguments of the benchmarks - each one runs for every combination of
+ *        the file size, the number of threads, the access pattern (0 - sequential, 1 - random),
+ *        the read ahead (0 - off, 1 - on) and the size of a single read
+ */
+void FileStreamArgs(benchmark::internal::Benchmark *b);
+
+/**
+ * @brief Times reading a set of files with `read_file`, with the arguments of FileStreamArgs
+ *
+ * The files are created on the first use in the directory given by DALI_FILE_STREAM_BENCH_DIR
+ * (`/tmp` by default), so that the storage tier is selected by pointing it to a mount point.
+ * Before each iteration, the files are dropped from the page cache (unless
+ * DALI_FILE_STREAM_BENCH_WARM=1), to measure the storage rather than the memory.
+ *
+ * Sequential access reads the files block by block, random access reads as many blocks
+ * at random (aligned) offsets. Apart from the throughput (also as the "MB" rate), the benchmark
+ * reports the IOPS (the reads per second) and the CPU time (user and system, of all threads)
+ * per GB read.
+ *
+ * @param device_id the device of the threads which call `read_file`
+ */
+void RunFileStreamBenchmark(benchmark::State &state, const ReadFileFn &read_file,
+                            int device_id = CPU_ONLY_DEVICE_ID);
+
+}  // namespace file_stream_bench
+}  // namespace dali
+
+#endif  // DALI_BENCHMARK_FILE_STREAM_BENCH_H_
@@ -0,0 +1,57 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime_api.h>
+#include <string>
+#include <vector>
+#include "dali/benchmark/file_stream_bench.h"
+#include "dali/core/cuda_error.h"
+#include "dali/operators/reader/gds_mem.h"
+#include "dali/util/cufile.h"
+
+namespace dali {
+namespace file_stream_bench {
+
+/**
+ * @brief Reads the blocks with cuFile, directly to the (registered) device memory
+ *
+ * The read ahead is ignored - the reads bypass the page cache when GDS is available.
+ */
+static void BM_CUFileStream(benchmark::State &st) {
+  int device_id = 0;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  int num_threads = st.range(1);
+  int64_t block_size = st.range(4);
+  auto allocator = gds::GDSAllocator::get(device_id);
+  std::vector<mm::uptr<uint8_t>> buffers;
+  for (int i = 0; i < num_threads; i++)
+    buffers.push_back(allocator->alloc_unique(block_size));
+
+  RunFileStreamBenchmark(st, [&](const std::string &path, const std::vector<Block> &blocks,
+                                 int thread_idx) {
+    auto stream = CUFileStream::Open(path, false, false);
+    int64_t total = 0;
+    for (auto &block : blocks)
+      total += stream->ReadAtGPU(buffers[thread_idx].get(), block.n_bytes, 0, block.offset);
+    stream->Close();
+    return total;
+  }, device_id);
+  CUDA_CALL(cudaDeviceSynchronize());
+}
+
+BENCHMARK(BM_CUFileStream)->Unit(benchmark::kMillisecond)->UseRealTime()
+->Apply(FileStreamArgs);
+
+}  // namespace file_stream_bench
+}  // namespace dali
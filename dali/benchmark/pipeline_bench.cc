@@ -0,0 +1,323 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs a serialized pipeline and reports its performance as JSON:
+//
+//   dali_pipeline_benchmark.bin <serialized pipeline> [--iterations=N] [--warmup=N]
+//       [--batch_size=N] [--num_threads=N] [--device_id=N] [--prefetch_queue_depth=N]
+//       [--exec_pipelined=0|1] [--exec_async=0|1] [--low_latency=0|1] [--output=<path>]
+//
+// The pipeline is the output of Pipeline.serialize(); it must not have external inputs.
+// The batch size, unless given, is taken from the serialized pipeline.
+// With --low_latency=1, the pipeline runs in the low latency mode (see
+// Pipeline::SetLowLatency) - synchronously and without prefetching - and the latency
+// percentiles are those of the individual iterations, e.g. with --batch_size=1.
+
+#include <cuda_runtime_api.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/core/cuda_error.h"
+#include "dali/core/error_handling.h"
+#include "dali/core/mm/default_resources.h"
+#include "dali/operators.h"
+#include "dali/pipeline/init.h"
+#include "dali/pipeline/operator/op_spec.h"
+#include "dali/pipeline/pipeline.h"
+
+namespace dali {
+namespace {
+
+struct BenchOptions {
+  std::string pipeline_path;
+  std::string output_path;
+  int iterations = 100;
+  int warmup = 10;
+  int batch_size = -1;
+  int num_threads = 4;
+  int device_id = 0;
+  int prefetch_queue_depth = 2;
+  bool exec_pipelined = true;
+  bool exec_async = true;
+  bool low_latency = false;
+};
+
+struct BenchResult {
+  int batch_size = 0;
+  /// The time of obtaining each of the measured batches, in seconds
+  std::vector<double> iteration_times;
+  double total_time = 0;
+  ExecutorTiming timing;
+  size_t outputs_max_reserved = 0;
+  std::map<std::string, mm::pool_stats> pools;
+};
+
+void PrintUsage(const char *name) {
+  std::cerr << "Usage: " << name << " <serialized pipeline> [--iterations=N] [--warmup=N]\n"
+            << "    [--batch_size=N] [--num_threads=N] [--device_id=N]"
+            << " [--prefetch_queue_depth=N]\n"
+            << "    [--exec_pipelined=0|1] [--exec_async=0|1] [--low_latency=0|1]"
+            << " [--output=<path>]\n";
+}
+
+int ParseInt(const std::string &name, const std::string &value) {
+  char *end = nullptr;
+  long ret = std::strtol(value.c_str(), &end, 10);  // NOLINT
+  DALI_ENFORCE(!value.empty() && *end == '\0',
+               make_string("Invalid value of --", name, ": \"", value, "\"."));
+  return static_cast<int>(ret);
+}
+
+BenchOptions ParseOptions(int argc, char **argv) {
+  BenchOptions opts;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.rfind("--", 0) != 0) {
+      DALI_ENFORCE(opts.pipeline_path.empty(), "Only one pipeline can be given.");
+      opts.pipeline_path = arg;
+      continue;
+    }
+    auto eq = arg.find('=');
+    DALI_ENFORCE(eq != std::string::npos,
+                 make_string("Expected --<option>=<value>, got \"", arg, "\"."));
+    std::string name = arg.substr(2, eq - 2), value = arg.substr(eq + 1);
+    if (name == "output") {
+      opts.output_path = value;
+    } else if (name == "iterations") {
+      opts.iterations = ParseInt(name, value);
+    } else if (name == "warmup") {
+      opts.warmup = ParseInt(name, value);
+    } else if (name == "batch_size") {
+      opts.batch_size = ParseInt(name, value);
+    } else if (name == "num_threads") {
+      opts.num_threads = ParseInt(name, value);
+    } else if (name == "device_id") {
+      opts.device_id = ParseInt(name, value);
+    } else if (name == "prefetch_queue_depth") {
+      opts.prefetch_queue_depth = ParseInt(name, value);
+    } else if (name == "exec_pipelined") {
+      opts.exec_pipelined = ParseInt(name, value) != 0;
+    } else if (name == "exec_async") {
+      opts.exec_async = ParseInt(name, value) != 0;
+    } else if (name == "low_latency") {
+      opts.low_latency = ParseInt(name, value) != 0;
+    } else {
+      DALI_FAIL(make_string("Unknown option --", name, "."));
+    }
+  }
+  DALI_ENFORCE(!opts.pipeline_path.empty(), "The serialized pipeline is required.");
+  DALI_ENFORCE(opts.iterations > 0, "The number of iterations must be positive.");
+  DALI_ENFORCE(opts.warmup >= 0, "The number of warm-up iterations can't be negative.");
+  DALI_ENFORCE(opts.prefetch_queue_depth > 0, "The prefetch queue depth must be positive.");
+  if (opts.low_latency) {
+    opts.exec_pipelined = false;
+    opts.exec_async = false;
+    opts.prefetch_queue_depth = 1;
+  }
+  return opts;
+}
+
+std::string ReadFile(const std::string &path) {
+  std::ifstream f(path, std::ios::binary);
+  DALI_ENFORCE(f.good(), make_string("Cannot open the serialized pipeline \"", path, "\"."));
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+/**
+ * @brief Obtains a batch and waits until it's ready
+ */
+void GetOutputs(Pipeline &pipe, DeviceWorkspace &ws) {
+  pipe.Outputs(&ws);
+  if (ws.has_stream())
+    CUDA_CALL(cudaStreamSynchronize(ws.stream()));
+}
+
+BenchResult RunBenchmark(const BenchOptions &opts) {
+  using Clock = std::chrono::steady_clock;
+  Pipeline pipe(ReadFile(opts.pipeline_path), opts.batch_size, opts.num_threads, opts.device_id,
+                opts.exec_pipelined, opts.prefetch_queue_depth, opts.exec_async);
+  pipe.SetLowLatency(opts.low_latency);
+  pipe.Build();
+
+  BenchResult result;
+  result.batch_size = pipe.max_batch_size();
+  DeviceWorkspace ws;
+  // the batches are scheduled ahead, so that the queues are full, as when run from Python
+  int prefetched = opts.exec_pipelined ? opts.prefetch_queue_depth : 1;
+  for (int i = 0; i < prefetched; i++) {
+    pipe.RunCPU();
+    pipe.RunGPU();
+  }
+  for (int i = 0; i < opts.warmup; i++) {
+    GetOutputs(pipe, ws);
+    pipe.RunCPU();
+    pipe.RunGPU();
+  }
+
+  // the timing doesn't include the warm-up
+  pipe.EnableOperatorTiming();
+  auto start = Clock::now();
+  for (int i = 0; i < opts.iterations; i++) {
+    auto iter_start = Clock::now();
+    GetOutputs(pipe, ws);
+    result.iteration_times.push_back(
+        std::chrono::duration<double>(Clock::now() - iter_start).count());
+    // no more batches than measured are scheduled
+    if (i + prefetched < opts.iterations) {
+      pipe.RunCPU();
+      pipe.RunGPU();
+    }
+  }
+  result.total_time = std::chrono::duration<double>(Clock::now() - start).count();
+  result.timing = pipe.GetOperatorTiming();
+
+  for (auto &op : pipe.GetExecutorMeta()) {
+    for (auto &output : op.second)
+      result.outputs_max_reserved += output.max_reserved;
+  }
+  if (auto *stats = mm::GetDefaultDevicePoolStats(opts.device_id))
+    result.pools["device"] = stats->get_stats();
+  if (auto *stats = mm::GetDefaultPinnedPoolStats(opts.device_id))
+    result.pools["pinned"] = stats->get_stats();
+  return result;
+}
+
+std::string JsonString(const std::string &s) {
+  std::stringstream ss;
+  ss << '"';
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      ss << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+         << std::dec;
+    } else {
+      ss << c;
+    }
+  }
+  ss << '"';
+  return ss.str();
+}
+
+/**
+ * @brief The value at the given fraction of the sorted values, with linear interpolation
+ */
+double Percentile(const std::vector<double> &sorted, double fraction) {
+  double pos = fraction * (sorted.size() - 1);
+  size_t lo = static_cast<size_t>(pos);
+  size_t hi = std::min(lo + 1, sorted.size() - 1);
+  return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+void WriteJson(std::ostream &os, const BenchOptions &opts, const BenchResult &result) {
+  auto sorted = result.iteration_times;
+  std::sort(sorted.begin(), sorted.end());
+  int64_t samples = static_cast<int64_t>(result.batch_size) * opts.iterations;
+  os << std::setprecision(9);
+  os << "{\n";
+  os << "  \"pipeline\": " << JsonString(opts.pipeline_path) << ",\n";
+  os << "  \"batch_size\": " << result.batch_size << ",\n";
+  os << "  \"iterations\": " << opts.iterations << ",\n";
+  os << "  \"warmup_iterations\": " << opts.warmup << ",\n";
+  os << "  \"low_latency\": " << (opts.low_latency ? "true" : "false") << ",\n";
+  os << "  \"total_time\": " << result.total_time << ",\n";
+  os << "  \"samples_per_second\": " << samples / result.total_time << ",\n";
+  os << "  \"latency\": {\"mean\": " << result.total_time / opts.iterations
+     << ", \"p50\": " << Percentile(sorted, 0.5)
+     << ", \"p90\": " << Percentile(sorted, 0.9)
+     << ", \"p99\": " << Percentile(sorted, 0.99)
+     << ", \"max\": " << sorted.back() << "},\n";
+
+  // sorted, so that the reports of the same pipeline can be compared
+  std::map<std::string, OperatorTiming> operators(result.timing.operators.begin(),
+                                                  result.timing.operators.end());
+  os << "  \"operators\": {";
+  const char *sep = "\n";
+  for (auto &op : operators) {
+    os << sep << "    " << JsonString(op.first) << ": {\"num_runs\": " << op.second.num_runs
+       << ", \"num_samples\": " << op.second.num_samples
+       << ", \"host_time\": " << op.second.host_time
+       << ", \"num_gpu_runs\": " << op.second.num_gpu_runs
+       << ", \"gpu_time\": " << op.second.gpu_time << "}";
+    sep = ",\n";
+  }
+  os << "\n  },\n";
+
+  os << "  \"stages\": {";
+  sep = "\n";
+  for (auto stage : { OpType::CPU, OpType::MIXED, OpType::GPU }) {
+    auto &st = result.timing.stages[static_cast<int>(stage)];
+    os << sep << "    " << JsonString(to_string(stage))
+       << ": {\"num_iterations\": " << st.num_iterations
+       << ", \"host_time\": " << st.host_time
+       << ", \"wait_time\": " << st.wait_time
+       << ", \"producer_wait\": " << st.producer_wait
+       << ", \"consumer_wait\": " << st.consumer_wait
+       << ", \"num_allocations\": " << st.num_allocations
+       << ", \"last_allocations\": " << st.last_allocations
+       << ", \"limiter_fraction\": " << result.timing.bottleneck.stages[static_cast<int>(stage)]
+       << "}";
+    sep = ",\n";
+  }
+  os << "\n  },\n";
+  os << "  \"consumer_limiter_fraction\": " << result.timing.bottleneck.consumer << ",\n";
+
+  os << "  \"memory\": {\"outputs_max_reserved_bytes\": " << result.outputs_max_reserved;
+  for (auto &pool : result.pools) {
+    os << ", " << JsonString(pool.first + "_pool_peak_reserved_bytes") << ": "
+       << pool.second.peak_reserved_bytes
+       << ", " << JsonString(pool.first + "_pool_peak_allocated_bytes") << ": "
+       << pool.second.peak_allocated_bytes;
+  }
+  os << "}\n";
+  os << "}\n";
+}
+
+}  // namespace
+}  // namespace dali
+
+int main(int argc, char **argv) {
+  try {
+    auto opts = dali::ParseOptions(argc, argv);
+    dali::InitOperatorsLib();
+    dali::DALIInit(dali::OpSpec("CPUAllocator"),
+                   dali::OpSpec("PinnedCPUAllocator"),
+                   dali::OpSpec("GPUAllocator"));
+    auto result = dali::RunBenchmark(opts);
+    if (opts.output_path.empty()) {
+      dali::WriteJson(std::cout, opts, result);
+    } else {
+      std::ofstream f(opts.output_path);
+      DALI_ENFORCE(f.good(), dali::make_string("Cannot write \"", opts.output_path, "\"."));
+      dali::WriteJson(f, opts, result);
+    }
+  } catch (std::exception &e) {
+    std::cerr << e.what() << "\n";
+    dali::PrintUsage(argv[0]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+#include "dali/kernels/reduce/reduce_cpu.h"
+
+namespace dali {
+
+namespace {
+
+using CaseData = std::tuple<TensorShape<>, std::vector<int>>;
+
+static CaseData cases[] = {
+    CaseData{{1080, 1920, 3}, {0, 1}},      // HWC, per-channel
+    CaseData{{3, 1080, 1920}, {1, 2}},      // CHW, per-channel
+    CaseData{{1080, 1920, 3}, {0, 1, 2}},   // full reduction
+    CaseData{{1080, 1920, 3}, {2}},         // HWC, per-pixel
+    CaseData{{64, 64, 64, 16}, {0, 1, 2}},  // DHWC, per-channel
+};
+
+static void CustomArguments(benchmark::internal::Benchmark* b) {
+  for (unsigned int i = 0; i < sizeof(cases) / sizeof(*cases); i++)
+    b->Args({i});
+}
+
+}  // namespace
+
+template <typename In>
+class ReduceCPUFixture : public benchmark::Fixture {
+ public:
+  void SetUp(benchmark::State& st) override {
+    std::tie(in_shape_, axes_) = cases[st.range(0)];
+    out_shape_ = {};
+    for (int d = 0; d < in_shape_.size(); d++) {
+      bool reduced = std::find(axes_.begin(), axes_.end(), d) != axes_.end();
+      if (!reduced)
+        out_shape_.shape.push_back(in_shape_[d]);
+    }
+    if (out_shape_.empty())
+      out_shape_ = { 1 };
+    auto total_size = volume(in_shape_);
+    in_mem_.resize(total_size);
+    for (int64_t i = 0; i < total_size; i++)
+      in_mem_[i] = i % 251;
+    mean_mem_.resize(volume(out_shape_));
+    out_mem_.resize(volume(out_shape_));
+    in_view_ = make_tensor_cpu(in_mem_.data(), in_shape_);
+    mean_view_ = make_tensor_cpu(mean_mem_.data(), out_shape_);
+    out_view_ = make_tensor_cpu(out_mem_.data(), out_shape_);
+  }
+
+  void TearDown(benchmark::State& st) override {
+    in_mem_.clear();
+    in_mem_.shrink_to_fit();
+  }
+
+  void Mean(benchmark::State& st) {
+    kernels::MeanCPU<float, In> mean;
+    for (auto _ : st) {
+      mean.Setup(mean_view_, in_view_, make_cspan(axes_));
+      mean.Run();
+      benchmark::DoNotOptimize(mean_mem_.data());
+      benchmark::ClobberMemory();
+    }
+    st.SetBytesProcessed(st.iterations() * in_mem_.size() * sizeof(In));
+  }
+
+  void StdDev(benchmark::State& st) {
+    kernels::MeanCPU<float, In> mean;
+    mean.Setup(mean_view_, in_view_, make_cspan(axes_));
+    mean.Run();
+    kernels::StdDevCPU<float, In> stddev;
+    for (auto _ : st) {
+      stddev.Setup(out_view_, in_view_, make_cspan(axes_), mean_view_);
+      stddev.Run();
+      benchmark::DoNotOptimize(out_mem_.data());
+      benchmark::ClobberMemory();
+    }
+    st.SetBytesProcessed(st.iterations() * in_mem_.size() * sizeof(In));
+  }
+
+  TensorShape<> in_shape_, out_shape_;
+  std::vector<int> axes_;
+  std::vector<In> in_mem_;
+  std::vector<float> mean_mem_, out_mem_;
+  TensorView<StorageCPU, const In> in_view_;
+  TensorView<StorageCPU, float> mean_view_, out_view_;
+};
+
+BENCHMARK_TEMPLATE_DEFINE_F(ReduceCPUFixture, MeanUint8Test, uint8_t)(benchmark::State& st) {
+  Mean(st);
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(ReduceCPUFixture, MeanFloatTest, float)(benchmark::State& st) {
+  Mean(st);
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(ReduceCPUFixture, StdDevUint8Test, uint8_t)(benchmark::State& st) {
+  StdDev(st);
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(ReduceCPUFixture, StdDevFloatTest, float)(benchmark::State& st) {
+  StdDev(st);
+}
+
+BENCHMARK_REGISTER_F(ReduceCPUFixture, MeanUint8Test)->Apply(CustomArguments);
+BENCHMARK_REGISTER_F(ReduceCPUFixture, MeanFloatTest)->Apply(CustomArguments);
+BENCHMARK_REGISTER_F(ReduceCPUFixture, StdDevUint8Test)->Apply(CustomArguments);
+BENCHMARK_REGISTER_F(ReduceCPUFixture, StdDevFloatTest)->Apply(CustomArguments);
+
+}  // namespace dali
@@ -0,0 +1,91 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "dali/kernels/signal/resampling_cpu.h"
+
+namespace dali {
+
+using kernels::signal::resampling::ResamplerCPU;
+using kernels::signal::resampling::ResampleCPUImpl;
+using kernels::signal::resampling::resampled_length;
+
+class ResamplingCPUFixture : public benchmark::Fixture {
+ public:
+  void SetUp(benchmark::State &st) override {
+    in_rate_ = st.range(0);
+    out_rate_ = st.range(1);
+    nchannels_ = st.range(2);
+    resampler_.Initialize(16);
+    n_in_ = 10 * in_rate_;  // 10 seconds
+    in_.resize(n_in_ * nchannels_);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-1, 1);
+    for (auto &x : in_)
+      x = dist(rng);
+    n_out_ = resampled_length(n_in_, in_rate_, out_rate_);
+    out_.resize(n_out_ * nchannels_);
+  }
+
+  void TearDown(benchmark::State &st) override {
+    st.SetItemsProcessed(st.iterations() * n_out_ * nchannels_);
+    in_.clear();
+    in_.shrink_to_fit();
+    out_.clear();
+    out_.shrink_to_fit();
+  }
+
+ protected:
+  ResamplerCPU resampler_;
+  double in_rate_ = 0, out_rate_ = 0;
+  int nchannels_ = 1;
+  int64_t n_in_ = 0, n_out_ = 0;
+  std::vector<float> in_, out_;
+};
+
+BENCHMARK_DEFINE_F(ResamplingCPUFixture, Generic)(benchmark::State &st) {
+  for (auto _ : st) {
+    ResampleCPUImpl(resampler_.window, out_.data(), 0, n_out_, out_rate_, in_.data(), n_in_,
+                    in_rate_, nchannels_);
+    benchmark::DoNotOptimize(out_.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+// the filter bank is computed in the first iteration and cached
+BENCHMARK_DEFINE_F(ResamplingCPUFixture, Polyphase)(benchmark::State &st) {
+  for (auto _ : st) {
+    resampler_.Resample(out_.data(), 0, n_out_, out_rate_, in_.data(), n_in_, in_rate_,
+                        nchannels_);
+    benchmark::DoNotOptimize(out_.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+static void ResamplingArgs(benchmark::internal::Benchmark *b) {
+  for (int nchannels : {1, 2}) {
+    b->Args({44100, 16000, nchannels});
+    b->Args({48000, 16000, nchannels});
+    b->Args({22050, 44100, nchannels});
+  }
+}
+
+BENCHMARK_REGISTER_F(ResamplingCPUFixture, Generic)->Apply(ResamplingArgs)
+->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(ResamplingCPUFixture, Polyphase)->Apply(ResamplingArgs)
+->Unit(benchmark::kMillisecond);
+
+}  // namespace dali
@@ -0,0 +1,117 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_BENCHMARK_ROOFLINE_H_
+#define DALI_BENCHMARK_ROOFLINE_H_
+
+#include <benchmark/benchmark.h>
+#include <cuda_runtime_api.h>
+
+#include <random>
+
+#include "dali/core/cuda_error.h"
+#include "dali/core/tensor_shape.h"
+
+namespace dali {
+
+/**
+ * @brief The theoretical peaks of the current device
+ */
+struct DevicePeaks {
+  /// DRAM bandwidth, in bytes per second
+  double bytes_per_second = 0;
+  /// FP32 fused multiply-add throughput, in FLOP per second
+  double flops = 0;
+
+  static int FP32CoresPerSM(int major, int minor) {
+    switch (major) {
+      case 3:
+        return 192;
+      case 5:
+        return 128;
+      case 6:
+        return minor == 0 ? 64 : 128;
+      case 7:
+        return 64;
+      case 8:
+        return minor == 0 ? 64 : 128;
+      default:
+        return 128;
+    }
+  }
+
+  static const DevicePeaks &Current() {
+    static const DevicePeaks peaks = []() {
+      int device_id = 0;
+      CUDA_CALL(cudaGetDevice(&device_id));
+      auto attr = [device_id](cudaDeviceAttr a) {
+        int value = 0;
+        CUDA_CALL(cudaDeviceGetAttribute(&value, a, device_id));
+        return static_cast<double>(value);
+      };
+      DevicePeaks ret;
+      // the clock rates are in kHz; DDR - two transfers per cycle
+      ret.bytes_per_second = 2.0 * attr(cudaDevAttrMemoryClockRate) * 1e3 *
+                             attr(cudaDevAttrGlobalMemoryBusWidth) / 8;
+      ret.flops = 2.0 * attr(cudaDevAttrClockRate) * 1e3 * attr(cudaDevAttrMultiProcessorCount) *
+                  FP32CoresPerSM(attr(cudaDevAttrComputeCapabilityMajor),
+                                 attr(cudaDevAttrComputeCapabilityMinor));
+      return ret;
+    }();
+    return peaks;
+  }
+};
+
+/**
+ * @brief Reports the achieved bandwidth and arithmetic throughput of a benchmark, also as
+ *        the percentages of the device peaks
+ *
+ * Should be called after the benchmark loop.
+ *
+ * @param bytes   the bytes read and written by one iteration
+ * @param flops   the arithmetic operations performed by one iteration
+ */
+inline void SetRooflineCounters(benchmark::State &st, double bytes, double flops) {
+  const auto &peaks = DevicePeaks::Current();
+  double iters = st.iterations();
+  st.counters["GB/s"] = benchmark::Counter(bytes * iters * 1e-9, benchmark::Counter::kIsRate);
+  st.counters["BW%"] = benchmark::Counter(bytes * iters * 100 / peaks.bytes_per_second,
+                                          benchmark::Counter::kIsRate);
+  if (flops > 0) {
+    st.counters["GFLOP/s"] = benchmark::Counter(flops * iters * 1e-9,
+                                                benchmark::Counter::kIsRate);
+    st.counters["FLOP%"] = benchmark::Counter(flops * iters * 100 / peaks.flops,
+                                              benchmark::Counter::kIsRate);
+  }
+  // the arithmetic intensity - the kernels below the ridge point of the device are memory-bound
+  st.counters["FLOP/B"] = flops / bytes;
+}
+
+/**
+ * @brief Generates a batch of HWC images with the sizes of a typical image classification
+ *        dataset; the same for each call with the same arguments
+ */
+inline TensorListShape<3> ImageBatchShape(int batch_size, int min_size = 256,
+                                          int max_size = 640, int channels = 3) {
+  std::mt19937 rng(batch_size);
+  std::uniform_int_distribution<int> dist(min_size, max_size);
+  TensorListShape<3> shape(batch_size);
+  for (int i = 0; i < batch_size; i++)
+    shape.set_tensor_shape(i, {dist(rng), dist(rng), channels});
+  return shape;
+}
+
+}  // namespace dali
+
+#endif  // DALI_BENCHMARK_ROOFLINE_H_
@@ -0,0 +1,215 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The GPU kernels, run through their operators on batches of images of varying sizes, with
+// the achieved bandwidth and FLOP/s reported against the peaks of the device (see roofline.h).
+// The bytes and the operations are counted as the minimum the kernel has to read, write and
+// compute; e.g. the bilinear resize reads each input pixel once.
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "dali/benchmark/dali_bench.h"
+#include "dali/benchmark/operator_bench.h"
+#include "dali/benchmark/roofline.h"
+
+namespace dali {
+
+namespace {
+
+constexpr int kResizeOutput = 224;
+// the output of the downscaling benchmarks - 4 to 10 times smaller than the input
+constexpr int kDownscaleOutput = 64;
+
+void RooflineArgs(benchmark::internal::Benchmark *b) {
+  for (int batch_size : { 1, 32, 128 })
+    b->Args({batch_size});
+}
+
+TensorListShape<> BenchShape(int batch_size) {
+  return ImageBatchShape(batch_size);
+}
+
+template <typename T>
+double BatchBytes(const TensorListShape<> &shape) {
+  return static_cast<double>(shape.num_elements()) * sizeof(T);
+}
+
+OpSpec GPUSpec(const std::string &name, int batch_size) {
+  return OpSpec(name)
+      .AddArg("max_batch_size", batch_size)
+      .AddArg("num_threads", 1)
+      .AddArg("device", "gpu");
+}
+
+/**
+ * @brief Downscales the images with the Lanczos filter, whose window grows with the scale
+ *        (6 source pixels per output pixel), in the float or in the half-precision path
+ */
+void RunResizeDownscale(OperatorBench &bench, benchmark::State &st, bool half_precision_compute) {
+  int batch_size = st.range(0);
+  auto shape = BenchShape(batch_size);
+  bench.RunGPU<uint8_t>(
+    st,
+    GPUSpec("Resize", batch_size)
+      .AddArg("resize_x", static_cast<float>(kDownscaleOutput))
+      .AddArg("resize_y", static_cast<float>(kDownscaleOutput))
+      .AddArg("interp_type", DALI_INTERP_LANCZOS3)
+      .AddArg("half_precision_compute", half_precision_compute),
+    batch_size, shape, "HWC");
+  // a multiply-add per filter tap, counted for the horizontal pass first
+  double flops = 0;
+  for (int i = 0; i < batch_size; i++) {
+    auto sample_shape = shape[i];
+    double horz_taps = std::ceil(6.0 * sample_shape[1] / kDownscaleOutput);
+    double vert_taps = std::ceil(6.0 * sample_shape[0] / kDownscaleOutput);
+    flops += 2 * 3 * kDownscaleOutput * (sample_shape[0] * horz_taps +
+                                         kDownscaleOutput * vert_taps);
+  }
+  double out_bytes = static_cast<double>(batch_size) * kDownscaleOutput * kDownscaleOutput * 3;
+  SetRooflineCounters(st, BatchBytes<uint8_t>(shape) + out_bytes, flops);
+}
+
+}  // namespace
+
+BENCHMARK_DEFINE_F(OperatorBench, RooflineResize)(benchmark::State& st) {
+  int batch_size = st.range(0);
+  auto shape = BenchShape(batch_size);
+  this->RunGPU<uint8_t>(
+    st,
+    GPUSpec("Resize", batch_size)
+      .AddArg("resize_x", static_cast<float>(kResizeOutput))
+      .AddArg("resize_y", static_cast<float>(kResizeOutput))
+      .AddArg("interp_type", DALI_INTERP_LINEAR),
+    batch_size, shape, "HWC");
+  double out_elements = static_cast<double>(batch_size) * kResizeOutput * kResizeOutput * 3;
+  // separable: a horizontal and a vertical pass, 2 multiply-adds each
+  SetRooflineCounters(st, BatchBytes<uint8_t>(shape) + out_elements, 8 * out_elements);
+}
+
+BENCHMARK_DEFINE_F(OperatorBench, RooflineResizeDownscale)(benchmark::State& st) {
+  RunResizeDownscale(*this, st, false);
+}
+
+BENCHMARK_DEFINE_F(OperatorBench, RooflineResizeDownscaleHalfPrecision)(benchmark::State& st) {
+  RunResizeDownscale(*this, st, true);
+}
+
+BENCHMARK_DEFINE_F(OperatorBench, RooflineNormalize)(benchmark::State& st) {
+  int batch_size = st.range(0);
+  auto shape = BenchShape(batch_size);
+  this->RunGPU<float>(
+    st,
+    GPUSpec("Normalize", batch_size)
+      .AddArg("mean", 128.0f)
+      .AddArg("stddev", 64.0f),
+    batch_size, shape, "HWC");
+  // (x - mean) * inv_stddev
+  SetRooflineCounters(st, 2 * BatchBytes<float>(shape), 2.0 * shape.num_elements());
+}
+
+BENCHMARK_DEFINE_F(OperatorBench, RooflineReduceSum)(benchmark::State& st) {
+  int batch_size = st.range(0);
+  auto shape = BenchShape(batch_size);
+  this->RunGPU<float>(
+    st,
+    GPUSpec("reductions__Sum", batch_size)
+      .AddArg("axes", std::vector<int>{0, 1}),
+    batch_size, shape, "HWC");
+  // the output - a value per channel - is negligible
+  SetRooflineCounters(st, BatchBytes<float>(shape), shape.num_elements());
+}
+
+BENCHMARK_DEFINE_F(OperatorBench, RooflineTranspose)(benchmark::State& st) {
+  int batch_size = st.range(0);
+  auto shape = BenchShape(batch_size);
+  this->RunGPU<uint8_t>(
+    st,
+    GPUSpec("Transpose", batch_size)
+      .AddArg("perm", std::vector<int>{2, 0, 1}),
+    batch_size, shape, "HWC");
+  SetRooflineCounters(st, 2 * BatchBytes<uint8_t>(shape), 0);
+}
+
+BENCHMARK_DEFINE_F(OperatorBench, RooflineArithmetic)(benchmark::State& st) {
+  int batch_size = st.range(0);
+  auto shape = BenchShape(batch_size);
+  this->RunGPU<float>(
+    st,
+    GPUSpec("ArithmeticGenericOp", batch_size)
+      .AddArg("expression_desc", std::string("mul(&0 $0:float32)"))
+      .AddArg("real_constants", std::vector<float>{0.5f}),
+    batch_size, shape, "HWC");
+  SetRooflineCounters(st, 2 * BatchBytes<float>(shape), shape.num_elements());
+}
+
+BENCHMARK_DEFINE_F(OperatorBench, RooflineConvolution)(benchmark::State& st) {
+  int batch_size = st.range(0);
+  const int window = 7;
+  auto shape = BenchShape(batch_size);
+  this->RunGPU<float>(
+    st,
+    GPUSpec("GaussianBlur", batch_size)
+      .AddArg("window_size", window),
+    batch_size, shape, "HWC");
+  // separable: a multiply-add per the window element in each of the two data axes
+  SetRooflineCounters(st, 2 * BatchBytes<float>(shape), 2.0 * 2 * window * shape.num_elements());
+}
+
+BENCHMARK_DEFINE_F(OperatorBench, RooflinePaste)(benchmark::State& st) {
+  int batch_size = st.range(0);
+  const float ratio = 2;
+  auto shape = BenchShape(batch_size);
+  this->RunGPU<uint8_t>(
+    st,
+    GPUSpec("Paste", batch_size)
+      .AddArg("ratio", ratio)
+      .AddArg("fill_value", std::vector<int>{0, 0, 0}),
+    batch_size, shape, "HWC");
+  SetRooflineCounters(st, (1 + ratio * ratio) * BatchBytes<uint8_t>(shape), 0);
+}
+
+BENCHMARK_DEFINE_F(OperatorBench, RooflineColorSpaceConversion)(benchmark::State& st) {
+  int batch_size = st.range(0);
+  auto shape = BenchShape(batch_size);
+  this->RunGPU<uint8_t>(
+    st,
+    GPUSpec("ColorSpaceConversion", batch_size)
+      .AddArg("image_type", DALI_RGB)
+      .AddArg("output_type", DALI_YCbCr),
+    batch_size, shape, "HWC");
+  // a 3x3 matrix and an offset per pixel - 3 multiply-adds and an add per element
+  SetRooflineCounters(st, 2 * BatchBytes<uint8_t>(shape), 7.0 * shape.num_elements());
+}
+
+#define DALI_REGISTER_ROOFLINE_BENCHMARK(name)        \
+  BENCHMARK_REGISTER_F(OperatorBench, name)           \
+      ->Iterations(100)                               \
+      ->Unit(benchmark::kMicrosecond)                 \
+      ->UseRealTime()                                 \
+      ->Apply(RooflineArgs)
+
+DALI_REGISTER_ROOFLINE_BENCHMARK(RooflineResize);
+DALI_REGISTER_ROOFLINE_BENCHMARK(RooflineResizeDownscale);
+DALI_REGISTER_ROOFLINE_BENCHMARK(RooflineResizeDownscaleHalfPrecision);
+DALI_REGISTER_ROOFLINE_BENCHMARK(RooflineNormalize);
+DALI_REGISTER_ROOFLINE_BENCHMARK(RooflineReduceSum);
+DALI_REGISTER_ROOFLINE_BENCHMARK(RooflineTranspose);
+DALI_REGISTER_ROOFLINE_BENCHMARK(RooflineArithmetic);
+DALI_REGISTER_ROOFLINE_BENCHMARK(RooflineConvolution);
+DALI_REGISTER_ROOFLINE_BENCHMARK(RooflinePaste);
+DALI_REGISTER_ROOFLINE_BENCHMARK(RooflineColorSpaceConversion);
+
+}  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -23,11 +23,13 @@
 namespace dali {
 
 constexpr int Dims = 3;
-using InputType = float;
-using OutputType = float;
 
+template <typename T>
 class SliceBenchGPU : public DALIBenchmark {
  public:
+  using InputType = T;
+  using OutputType = T;
+
   kernels::TestTensorList<InputType, Dims> test_data;
   kernels::TestTensorList<OutputType, Dims> out_data;
 
@@ -99,7 +101,7 @@ static void SliceKernelArgs_GPU_OnlySlice(benchmark::internal::Benchmark *b) {
   }
 }
 
-BENCHMARK_DEFINE_F(SliceBenchGPU, Slice_GPU_OnlySlice)(benchmark::State& st) {
+BENCHMARK_TEMPLATE_DEFINE_F(SliceBenchGPU, Slice_GPU_OnlySlice, float)(benchmark::State& st) {
   this->RunGPU(st);
 }
 
@@ -120,7 +122,7 @@ static void SliceKernelArgs_GPU_OnlyPad(benchmark::internal::Benchmark *b) {
   }
 }
 
-BENCHMARK_DEFINE_F(SliceBenchGPU, Slice_GPU_OnlyPad)(benchmark::State& st) {
+BENCHMARK_TEMPLATE_DEFINE_F(SliceBenchGPU, Slice_GPU_OnlyPad, float)(benchmark::State& st) {
   this->RunGPU(st);
 }
 
@@ -141,7 +143,7 @@ static void SliceKernelArgs_GPU_SliceAndPad(benchmark::internal::Benchmark *b) {
   }
 }
 
-BENCHMARK_DEFINE_F(SliceBenchGPU, Slice_GPU_SliceAndPad)(benchmark::State& st) {
+BENCHMARK_TEMPLATE_DEFINE_F(SliceBenchGPU, Slice_GPU_SliceAndPad, float)(benchmark::State& st) {
   this->RunGPU(st);
 }
 
@@ -150,5 +152,35 @@ BENCHMARK_REGISTER_F(SliceBenchGPU, Slice_GPU_SliceAndPad)->Iterations(1000)
 ->UseRealTime()
 ->Apply(SliceKernelArgs_GPU_SliceAndPad);
 
+static void SliceKernelArgs_GPU_Frames(benchmark::internal::Benchmark *b) {
+  // HD and 4K frames, cropped in the middle
+  for (int H : {1080, 2160}) {
+    int W = H * 16 / 9, C = 3;
+    int crop_h = 9 * H / 10;
+    int crop_w = 9 * W / 10;
+    b->Args({H, W, C, H / 20, W / 20, 0, crop_h, crop_w, C, 1});
+    b->Args({H, W, C, H / 20, W / 20, 0, crop_h, crop_w, C, 8});
+  }
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(SliceBenchGPU, Slice_GPU_Frames_Uint8, uint8_t)(
+    benchmark::State& st) {
+  this->RunGPU(st);
+}
+
+BENCHMARK_REGISTER_F(SliceBenchGPU, Slice_GPU_Frames_Uint8)->Iterations(1000)
+->Unit(benchmark::kMicrosecond)
+->UseRealTime()
+->Apply(SliceKernelArgs_GPU_Frames);
+
+BENCHMARK_TEMPLATE_DEFINE_F(SliceBenchGPU, Slice_GPU_Frames, float)(benchmark::State& st) {
+  this->RunGPU(st);
+}
+
+BENCHMARK_REGISTER_F(SliceBenchGPU, Slice_GPU_Frames)->Iterations(1000)
+->Unit(benchmark::kMicrosecond)
+->UseRealTime()
+->Apply(SliceKernelArgs_GPU_Frames);
+
 
 }  // namespace dali
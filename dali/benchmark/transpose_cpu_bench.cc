@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -36,6 +36,13 @@ static CaseData cases[] = {
     CaseData{{100, 60, 3}, {0, 1, 2}},        // HWC
     CaseData{{100, 60, 3}, {2, 0, 1}},        // CHW
     CaseData{{100, 60, 3}, {2, 1, 0}},        // CWH
+                                              // HWC <-> CHW large images
+    CaseData{{270, 480, 3}, {2, 0, 1}},       // HWC -> CHW
+    CaseData{{3, 270, 480}, {1, 2, 0}},       // CHW -> HWC
+    CaseData{{270, 480, 16}, {2, 0, 1}},      // HWC -> CHW, many channels
+                                              // 2D
+    CaseData{{256, 256}, {1, 0}},
+    CaseData{{250, 130}, {1, 0}},
                                               // 4D
     CaseData{{20, 20, 20, 4}, {0, 1, 2, 3}},  // id
     CaseData{{20, 20, 20, 4}, {3, 2, 1, 0}},
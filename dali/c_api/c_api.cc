@@ -15,6 +15,9 @@
 #include "dali/c_api.h"  // NOLINT [build/include]
 
 #include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,6 +26,7 @@
 #include "dali/core/common.h"
 #include "dali/core/cuda_stream_pool.h"
 #include "dali/core/format.h"
+#include "dali/core/mm/default_resources.h"
 #include "dali/core/tensor_shape.h"
 #include "dali/pipeline/init.h"
 
@@ -31,6 +35,7 @@
 #include "dali/pipeline/data/tensor_list.h"
 #include "dali/pipeline/data/backend.h"
 #include "dali/pipeline/data/copy_to_external.h"
+#include "dali/pipeline/data/dltensor.h"
 
 using dali::AccessOrder;
 using dali::CPUBackend;
@@ -165,6 +170,155 @@ inline dali::mm::memory_kind_id GetMemKind(device_type_t device_type, bool is_pi
         : (is_pinned ? dali::mm::memory_kind_id::pinned : dali::mm::memory_kind_id::host);
 }
 
+/**
+ * @brief Keeps the iterations shared with the user in use as long as they are referenced - by
+ * the workspace of the handle or by the DLPack tensors exported from it.
+ *
+ * The executor releases the iterations in the order they were shared, so an iteration is
+ * released only after all the previous ones are no longer referenced.
+ * The references exported as DLPack tensors can be dropped from any thread, also after
+ * the pipeline is deleted.
+ */
+class OutputHandoff {
+ public:
+  explicit OutputHandoff(dali::Pipeline *pipeline) : pipeline_(pipeline) {}
+
+  /**
+   * @brief Registers the iteration just shared with the workspace of the handle
+   */
+  void Shared() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    iterations_.push_back({1, true});
+  }
+
+  /**
+   * @brief Drops the reference of the workspace to the oldest iteration shared with it, if any
+   */
+  void ReleaseShared() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto &it : iterations_) {
+      if (it.shared) {
+        it.shared = false;
+        it.refs--;
+        ReleaseUnreferenced();
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Adds a reference to the most recently shared iteration
+   *
+   * @return The id of the iteration, to be passed to Release
+   */
+  int64_t Acquire() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    DALI_ENFORCE(!iterations_.empty() && iterations_.back().shared,
+                 "No outputs are shared. Call daliOutput or daliShareOutput first.");
+    iterations_.back().refs++;
+    return first_id_ + iterations_.size() - 1;
+  }
+
+  void Release(int64_t id) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    assert(id >= first_id_ && id < first_id_ + static_cast<int64_t>(iterations_.size()));
+    iterations_[id - first_id_].refs--;
+    ReleaseUnreferenced();
+  }
+
+  /**
+   * @brief Called when the pipeline is deleted; the remaining references only keep the memory
+   */
+  void Detach() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    pipeline_ = nullptr;
+  }
+
+ private:
+  void ReleaseUnreferenced() {
+    while (!iterations_.empty() && iterations_.front().refs == 0) {
+      iterations_.pop_front();
+      first_id_++;
+      if (pipeline_)
+        pipeline_->ReleaseOutputs();
+    }
+  }
+
+  struct Iteration {
+    int refs;
+    bool shared;  // whether the workspace of the handle still references it
+  };
+
+  std::mutex mtx_;
+  dali::Pipeline *pipeline_;
+  std::deque<Iteration> iterations_;
+  int64_t first_id_ = 0;
+};
+
+const std::shared_ptr<OutputHandoff> &GetOutputHandoff(daliPipelineHandle *pipe_handle) {
+  return *reinterpret_cast<std::shared_ptr<OutputHandoff> *>(pipe_handle->output_handoff);
+}
+
+/**
+ * @brief Keeps the memory of the output and the iteration it belongs to referenced until
+ * the DLPack tensor is deleted
+ */
+struct SharedOutputResource : dali::DLTensorResource {
+  SharedOutputResource(dali::TensorShape<> shape, std::shared_ptr<void> data,
+                       std::shared_ptr<OutputHandoff> handoff)
+  : DLTensorResource(std::move(shape)), data(std::move(data)), handoff(std::move(handoff)) {
+    iteration = this->handoff->Acquire();
+  }
+
+  ~SharedOutputResource() override {
+    data.reset();
+    handoff->Release(iteration);
+  }
+
+  std::shared_ptr<void> data;
+  std::shared_ptr<OutputHandoff> handoff;
+  int64_t iteration = -1;
+};
+
+template <typename Backend>
+DLManagedTensor *OutputToDLPack(daliPipelineHandle *pipe_handle,
+                                dali::TensorList<Backend> &output, int sample_idx) {
+  dali::TensorShape<> shape;
+  std::shared_ptr<void> data;
+  if (sample_idx >= 0) {
+    DALI_ENFORCE(sample_idx < output.num_samples(),
+                 dali::make_string("Sample index ", sample_idx, " out of range [0, ",
+                                   output.num_samples(), ")."));
+    shape = output.tensor_shape(sample_idx);
+    data = unsafe_sample_owner(output, sample_idx);
+  } else {
+    DALI_ENFORCE(is_uniform(output.shape()) && output.IsContiguous(),
+                 "Only the outputs with a uniform shape, stored contiguously, can be exported "
+                 "as a single DLPack tensor. Export the samples separately.");
+    int N = output.num_samples();
+    if (N > 0) {
+      shape = shape_cat(N, output.tensor_shape(0));
+      data = unsafe_sample_owner(output, 0);
+    } else {
+      shape = dali::TensorShape<>(std::vector<int64_t>(output.sample_dim() + 1, 0));
+    }
+  }
+  void *ptr = data.get();
+  auto resource = std::make_unique<SharedOutputResource>(std::move(shape), std::move(data),
+                                                         GetOutputHandoff(pipe_handle));
+  return MakeDLTensor(ptr, output.type(), std::is_same<Backend, GPUBackend>::value,
+                      output.device_id(), std::move(resource)).release();
+}
+
+DLManagedTensor *OutputToDLPack(daliPipelineHandle *pipe_handle, int output_idx,
+                                int sample_idx) {
+  dali::DeviceWorkspace *ws = reinterpret_cast<dali::DeviceWorkspace *>(pipe_handle->ws);
+  if (ws->OutputIsType<CPUBackend>(output_idx))
+    return OutputToDLPack(pipe_handle, ws->Output<CPUBackend>(output_idx), sample_idx);
+  else
+    return OutputToDLPack(pipe_handle, ws->Output<GPUBackend>(output_idx), sample_idx);
+}
+
 }  // namespace
 
 
@@ -203,6 +357,8 @@ void daliCreatePipeline(daliPipelineHandle *pipe_handle, const char *serialized_
 
   pipe_handle->ws = ws.release();
   pipe_handle->copy_stream = stream.release().release();
+  pipe_handle->output_handoff =
+      new std::shared_ptr<OutputHandoff>(std::make_shared<OutputHandoff>(pipeline.get()));
   pipe_handle->pipe = pipeline.release();
   pipe_handle->batch_size_map = bs_map.release();
 }
@@ -220,6 +376,8 @@ void daliDeserializeDefault(daliPipelineHandle *pipe_handle, const char *seriali
   auto bs_map = std::make_unique<batch_size_map_t>();
   pipe_handle->ws = ws.release();
   pipe_handle->copy_stream = stream.release().release();
+  pipe_handle->output_handoff =
+      new std::shared_ptr<OutputHandoff>(std::make_shared<OutputHandoff>(pipeline.get()));
   pipe_handle->pipe = pipeline.release();
   pipe_handle->batch_size_map = bs_map.release();
 }
@@ -360,22 +518,91 @@ void daliRun(daliPipelineHandle *pipe_handle) {
 
 
 void daliOutput(daliPipelineHandle *pipe_handle) {
+  daliOutputRelease(pipe_handle);
+  daliShareOutput(pipe_handle);
+}
+
+
+void daliShareOutput(daliPipelineHandle *pipe_handle) {
   dali::Pipeline *pipeline = reinterpret_cast<dali::Pipeline *>(pipe_handle->pipe);
   dali::DeviceWorkspace *ws = reinterpret_cast<dali::DeviceWorkspace *>(pipe_handle->ws);
-  pipeline->Outputs(ws);
+  ws->reset_stream();
+  pipeline->ShareOutputs(ws);
+  GetOutputHandoff(pipe_handle)->Shared();
 }
 
 
-void daliShareOutput(daliPipelineHandle *pipe_handle) {
+void daliShareOutputAsync(daliPipelineHandle *pipe_handle, cudaStream_t stream) {
   dali::Pipeline *pipeline = reinterpret_cast<dali::Pipeline *>(pipe_handle->pipe);
   dali::DeviceWorkspace *ws = reinterpret_cast<dali::DeviceWorkspace *>(pipe_handle->ws);
+  ws->set_stream(stream);
   pipeline->ShareOutputs(ws);
+  GetOutputHandoff(pipe_handle)->Shared();
+}
+
+
+int daliTryShareOutput(daliPipelineHandle *pipe_handle) {
+  dali::Pipeline *pipeline = reinterpret_cast<dali::Pipeline *>(pipe_handle->pipe);
+  dali::DeviceWorkspace *ws = reinterpret_cast<dali::DeviceWorkspace *>(pipe_handle->ws);
+  ws->reset_stream();
+  if (!pipeline->TryShareOutputs(ws))
+    return 0;
+  GetOutputHandoff(pipe_handle)->Shared();
+  return 1;
+}
+
+
+void daliSetOutputReadyCallback(daliPipelineHandle *pipe_handle,
+                                daliOutputReadyCallback callback, void *context) {
+  dali::Pipeline *pipeline = reinterpret_cast<dali::Pipeline *>(pipe_handle->pipe);
+  if (!callback) {
+    pipeline->SetCompletionCallback({});
+    return;
+  }
+  pipeline->SetCompletionCallback([=]() { callback(context); });
 }
 
 
 void daliOutputRelease(daliPipelineHandle *pipe_handle) {
+  // the iteration may still be referenced by DLPack tensors - then it's released by the last one
+  GetOutputHandoff(pipe_handle)->ReleaseShared();
+}
+
+void daliSetOutputAllocator(daliPipelineHandle *pipe_handle, daliOutputAllocFunc alloc_fn,
+                            daliOutputFreeFunc free_fn, void *context) {
   dali::Pipeline *pipeline = reinterpret_cast<dali::Pipeline *>(pipe_handle->pipe);
-  pipeline->ReleaseOutputs();
+  if (!alloc_fn) {
+    pipeline->SetOutputAllocator({});
+    return;
+  }
+  DALI_ENFORCE(free_fn != nullptr, "The deallocation function must be provided.");
+  int device_id = pipeline->device_id();
+  pipeline->SetOutputAllocator([=](int output_idx, size_t bytes, cudaStream_t stream) {
+    void *ptr = alloc_fn(context, output_idx, bytes, device_id, stream);
+    if (!ptr)
+      throw dali::CUDABadAlloc(bytes);
+    return std::shared_ptr<uint8_t>(static_cast<uint8_t *>(ptr), [=](uint8_t *p) {
+      free_fn(context, output_idx, p);
+    });
+  });
+}
+
+
+const void *daliOutputData(daliPipelineHandle *pipe_handle, int output_idx) {
+  dali::DeviceWorkspace *ws = reinterpret_cast<dali::DeviceWorkspace *>(pipe_handle->ws);
+  if (ws->OutputIsType<CPUBackend>(output_idx))
+    return nullptr;
+  return unsafe_raw_data(ws->Output<GPUBackend>(output_idx));
+}
+
+DLManagedTensor *daliOutputDLPack(daliPipelineHandle *pipe_handle, int output_idx) {
+  return OutputToDLPack(pipe_handle, output_idx, -1);
+}
+
+DLManagedTensor *daliOutputSampleDLPack(daliPipelineHandle *pipe_handle, int output_idx,
+                                        int sample_idx) {
+  DALI_ENFORCE(sample_idx >= 0, "The sample index must not be negative.");
+  return OutputToDLPack(pipe_handle, output_idx, sample_idx);
 }
 
 int64_t daliOutputHasUniformShape(daliPipelineHandle* pipe_handle, int i) {
@@ -631,6 +858,11 @@ void daliDeletePipeline(daliPipelineHandle* pipe_handle) {
     dali::CUDAStreamPool::instance().Put(dali::CUDAStream(pipe_handle->copy_stream));
   }
   pipe_handle->copy_stream = nullptr;
+  // the DLPack tensors still alive keep only the memory of the outputs
+  auto *handoff = reinterpret_cast<std::shared_ptr<OutputHandoff> *>(pipe_handle->output_handoff);
+  (*handoff)->Detach();
+  delete handoff;
+  pipe_handle->output_handoff = nullptr;
   delete ws;
   delete pipeline;
   delete bs_map;
@@ -715,3 +947,126 @@ void daliFreeExecutorMetadata(daliExecutorMetadata *operator_meta, size_t operat
   }
   free(operator_meta);
 }
+
+void daliEnableOperatorTiming(daliPipelineHandle* pipe_handle, int enable) {
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  pipeline->EnableOperatorTiming(enable != 0);
+}
+
+void daliGetOperatorTiming(daliPipelineHandle* pipe_handle, daliOperatorTiming **timing,
+                           size_t *timing_num) {
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  auto returned = pipeline->GetOperatorTiming();
+  *timing_num = returned.operators.size();
+  *timing = static_cast<daliOperatorTiming*>(malloc(sizeof(daliOperatorTiming) *
+                                                    returned.operators.size()));
+  int i = 0;
+  for (const auto &op : returned.operators) {
+    auto &entry = (*timing)[i];
+    auto op_name_size = op.first.size();
+    entry.operator_name = static_cast<char*>(malloc(sizeof(char) * (op_name_size + 1)));
+    op.first.copy(entry.operator_name, op_name_size);
+    entry.operator_name[op_name_size] = '\0';
+    entry.num_runs = op.second.num_runs;
+    entry.num_samples = op.second.num_samples;
+    entry.host_time = op.second.host_time;
+    entry.num_gpu_runs = op.second.num_gpu_runs;
+    entry.gpu_time = op.second.gpu_time;
+    ++i;
+  }
+}
+
+void daliFreeOperatorTiming(daliOperatorTiming *timing, size_t timing_num) {
+  for (size_t i = 0; i < timing_num; ++i)
+    free(timing[i].operator_name);
+  free(timing);
+}
+
+void daliGetStageTiming(daliPipelineHandle* pipe_handle, dali_backend_t stage,
+                        daliStageTiming *timing) {
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  dali::OpType op_type;
+  switch (stage) {
+    case dali_backend_t::DALI_BACKEND_CPU:
+      op_type = dali::OpType::CPU;
+      break;
+    case dali_backend_t::DALI_BACKEND_MIXED:
+      op_type = dali::OpType::MIXED;
+      break;
+    case dali_backend_t::DALI_BACKEND_GPU:
+      op_type = dali::OpType::GPU;
+      break;
+    default:
+      DALI_FAIL("Invalid stage.");
+  }
+  auto returned = pipeline->GetOperatorTiming();
+  const auto &st = returned.stages[static_cast<int>(op_type)];
+  timing->num_iterations = st.num_iterations;
+  timing->num_samples = st.num_samples;
+  timing->host_time = st.host_time;
+  timing->wait_time = st.wait_time;
+  timing->mean_queue_occupancy = st.num_queue_samples
+      ? static_cast<double>(st.queue_occupancy_sum) / st.num_queue_samples : 0.0;
+  timing->max_queue_occupancy = st.max_queue_occupancy;
+  timing->elapsed_time = returned.elapsed_time;
+  timing->producer_wait = st.producer_wait;
+  timing->consumer_wait = st.consumer_wait;
+  timing->num_allocations = st.num_allocations;
+  timing->last_allocations = st.last_allocations;
+}
+
+void daliGetBottleneckSummary(daliPipelineHandle* pipe_handle, daliBottleneckSummary *summary) {
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  auto returned = pipeline->GetOperatorTiming().bottleneck;
+  summary->cpu = returned.stages[static_cast<int>(dali::OpType::CPU)];
+  summary->mixed = returned.stages[static_cast<int>(dali::OpType::MIXED)];
+  summary->gpu = returned.stages[static_cast<int>(dali::OpType::GPU)];
+  summary->consumer = returned.consumer;
+}
+
+namespace {
+
+dali::mm::pool_stats_provider *GetMemoryPoolStatsProvider(dali_memory_pool_t pool,
+                                                          int device_id) {
+  switch (pool) {
+    case DALI_MEMORY_POOL_DEVICE:
+      return dali::mm::GetDefaultDevicePoolStats(device_id);
+    case DALI_MEMORY_POOL_PINNED:
+      return dali::mm::GetDefaultPinnedPoolStats(device_id);
+    default:
+      DALI_FAIL(dali::make_string("Unknown memory pool kind: ", static_cast<int>(pool)));
+  }
+}
+
+}  // namespace
+
+int daliGetMemoryPoolStats(dali_memory_pool_t pool, int device_id, daliMemoryPoolStats *stats) {
+  DALI_ENFORCE(stats != nullptr, "The output statistics pointer must not be null.");
+  auto *provider = GetMemoryPoolStatsProvider(pool, device_id);
+  if (!provider)
+    return 0;
+  auto pool_stats = provider->get_stats();
+  stats->reserved_bytes = pool_stats.reserved_bytes;
+  stats->peak_reserved_bytes = pool_stats.peak_reserved_bytes;
+  stats->allocated_bytes = pool_stats.allocated_bytes;
+  stats->peak_allocated_bytes = pool_stats.peak_allocated_bytes;
+  stats->free_bytes = pool_stats.free.bytes;
+  stats->free_blocks = pool_stats.free.blocks;
+  stats->largest_free_block = pool_stats.free.largest_block;
+  stats->allocations = pool_stats.allocations;
+  stats->deallocations = pool_stats.deallocations;
+  stats->upstream_allocations = pool_stats.upstream_allocations;
+  stats->upstream_deallocations = pool_stats.upstream_deallocations;
+  stats->fragmentation = pool_stats.fragmentation();
+  return 1;
+}
+
+void daliResetMemoryPoolPeakStats(dali_memory_pool_t pool, int device_id) {
+  if (auto *provider = GetMemoryPoolStatsProvider(pool, device_id))
+    provider->reset_peak_stats();
+}
+
+size_t daliTrimMemoryPool(dali_memory_pool_t pool, int device_id, size_t keep_bytes) {
+  auto *provider = GetMemoryPoolStatsProvider(pool, device_id);
+  return provider ? provider->trim(keep_bytes) : 0;
+}
@@ -13,13 +13,19 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "dali/c_api.h"
+#include "dali/core/cuda_stream.h"
 #include "dali/pipeline/data/buffer.h"
+#include "dali/pipeline/data/dltensor.h"
 #include "dali/pipeline/data/tensor_list.h"
 #include "dali/pipeline/data/views.h"
 #include "dali/pipeline/pipeline.h"
@@ -656,6 +662,51 @@ TYPED_TEST(CApiTest, TestExecutorMeta) {
   daliDeletePipeline(&handle);
 }
 
+TYPED_TEST(CApiTest, TestOperatorTiming) {
+  auto pipe_ptr = GetTestPipeline<TypeParam>(true, this->output_device_);
+  auto serialized = pipe_ptr->SerializeToProtobuf();
+
+  pipe_ptr.reset();
+  daliPipelineHandle handle;
+  daliCreatePipeline(&handle, serialized.c_str(), serialized.size(), batch_size, num_thread,
+                     this->device_id_, false, prefetch_queue_depth, prefetch_queue_depth,
+                     prefetch_queue_depth, false);
+  daliEnableOperatorTiming(&handle, 1);
+
+  const int iters = 3;
+  for (int i = 0; i < iters; i++) {
+    daliRun(&handle);
+    daliOutput(&handle);
+  }
+  if (std::is_same_v<TypeParam, GPUBackend>)
+    CUDA_CALL(cudaDeviceSynchronize());
+
+  size_t N;
+  daliOperatorTiming *timing;
+  daliGetOperatorTiming(&handle, &timing, &N);
+  EXPECT_EQ(N, 4);
+  for (size_t i = 0; i < N; ++i) {
+    EXPECT_EQ(timing[i].num_runs, iters) << timing[i].operator_name;
+    EXPECT_EQ(timing[i].num_samples, iters * batch_size) << timing[i].operator_name;
+    EXPECT_GE(timing[i].host_time, 0);
+    EXPECT_LE(timing[i].num_gpu_runs, timing[i].num_runs);
+  }
+  daliFreeOperatorTiming(timing, N);
+
+  daliStageTiming stage;
+  daliGetStageTiming(&handle, DALI_BACKEND_CPU, &stage);
+  EXPECT_EQ(stage.num_iterations, iters);
+  EXPECT_EQ(stage.num_samples, iters * batch_size);
+  EXPECT_GE(stage.mean_queue_occupancy, 1);
+  EXPECT_GE(stage.elapsed_time, stage.host_time);
+  EXPECT_GE(stage.producer_wait, 0);
+
+  daliBottleneckSummary summary;
+  daliGetBottleneckSummary(&handle, &summary);
+  EXPECT_NEAR(summary.cpu + summary.mixed + summary.gpu + summary.consumer, 1, 1e-6);
+  daliDeletePipeline(&handle);
+}
+
 TYPED_TEST(CApiTest, UseCopyKernel) {
   TensorListShape<> input_shape = {{37, 23, 3}, {12, 22, 3}, {42, 42, 3}, {8, 8, 3},
                                    {64, 32, 3}, {32, 64, 3}, {20, 20, 3}, {64, 64, 3},
@@ -963,6 +1014,181 @@ TYPED_TEST(CApiTest, daliOutputCopySamples) {
 }
 
 
+TYPED_TEST(CApiTest, OutputDLPack) {
+  auto pipe_ptr = GetTestPipeline<TypeParam>(true, this->output_device_);
+  auto serialized = pipe_ptr->SerializeToProtobuf();
+
+  pipe_ptr->Build();
+  for (int i = 0; i < prefetch_queue_depth; i++) {
+    pipe_ptr->RunCPU();
+    pipe_ptr->RunGPU();
+  }
+
+  daliPipelineHandle handle;
+  daliCreatePipeline(&handle, serialized.c_str(), serialized.size(), batch_size, num_thread,
+                     this->device_id_, false, prefetch_queue_depth, prefetch_queue_depth,
+                     prefetch_queue_depth, false);
+  daliPrefetchUniform(&handle, prefetch_queue_depth);
+
+  dali::DeviceWorkspace ws;
+  pipe_ptr->Outputs(&ws);
+  daliOutput(&handle);
+  TensorList<CPUBackend> ref;
+  ref.set_pinned(false);
+  ref.Copy(ws.Output<TypeParam>(0), AccessOrder::host());
+
+  DLManagedTensor *batch = daliOutputDLPack(&handle, 0);
+  DLManagedTensor *sample = daliOutputSampleDLPack(&handle, 0, 1);
+  auto sample_shape = ref.tensor_shape(0);
+  int64_t sample_size = volume(sample_shape);
+  ASSERT_EQ(batch->dl_tensor.ndim, sample_shape.size() + 1);
+  EXPECT_EQ(batch->dl_tensor.shape[0], batch_size);
+  for (int d = 0; d < sample_shape.size(); d++) {
+    EXPECT_EQ(batch->dl_tensor.shape[d + 1], sample_shape[d]);
+    EXPECT_EQ(sample->dl_tensor.shape[d], sample_shape[d]);
+  }
+  EXPECT_EQ(batch->dl_tensor.dtype.code, kDLUInt);
+  EXPECT_EQ(batch->dl_tensor.dtype.bits, 8);
+  auto expected_device = std::is_same_v<TypeParam, GPUBackend> ? kDLCUDA : kDLCPU;
+  EXPECT_EQ(batch->dl_tensor.device.device_type, expected_device);
+  EXPECT_EQ(sample->dl_tensor.data, static_cast<uint8_t *>(batch->dl_tensor.data) + sample_size)
+      << "The tensors should share the memory of the output";
+
+  // the tensors keep the iteration in use - the next one is shared, but nothing is overwritten
+  daliOutputRelease(&handle);
+  daliRun(&handle);
+  pipe_ptr->RunCPU();
+  pipe_ptr->RunGPU();
+  ComparePipelinesOutputs<TypeParam>(handle, *pipe_ptr);
+
+  std::vector<uint8_t> exported(batch_size * sample_size);
+  if (std::is_same_v<TypeParam, GPUBackend>) {
+    CUDA_CALL(cudaMemcpy(exported.data(), batch->dl_tensor.data, exported.size(),
+                         cudaMemcpyDeviceToHost));
+  } else {
+    std::memcpy(exported.data(), batch->dl_tensor.data, exported.size());
+  }
+  Check(view<uint8_t>(ref),
+        TensorListView<StorageCPU, uint8_t>(exported.data(), ref.shape()));
+
+  // deleting the tensors releases the iteration, so that the pipeline can go on
+  batch->deleter(batch);
+  sample->deleter(sample);
+  for (int i = 0; i < prefetch_queue_depth + 1; i++) {
+    daliRun(&handle);
+    pipe_ptr->RunCPU();
+    pipe_ptr->RunGPU();
+    ComparePipelinesOutputs<TypeParam>(handle, *pipe_ptr);
+  }
+
+  // the memory outlives the pipeline
+  DLManagedTensor *last = daliOutputSampleDLPack(&handle, 0, 0);
+  daliDeletePipeline(&handle);
+  EXPECT_NE(last->dl_tensor.data, nullptr);
+  last->deleter(last);
+}
+
+namespace {
+
+struct ReadyNotification {
+  static void Notify(void *context) {
+    auto *self = static_cast<ReadyNotification *>(context);
+    std::lock_guard<std::mutex> lock(self->mtx);
+    self->count++;
+    self->cv.notify_all();
+  }
+
+  bool WaitFor(int n) {
+    std::unique_lock<std::mutex> lock(mtx);
+    return cv.wait_for(lock, std::chrono::seconds(10), [&]() { return count >= n; });
+  }
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  int count = 0;
+};
+
+}  // namespace
+
+TYPED_TEST(CApiTest, TryShareOutput) {
+  auto pipe_ptr = GetTestPipeline<TypeParam>(true, this->output_device_);
+  auto serialized = pipe_ptr->SerializeToProtobuf();
+
+  pipe_ptr->Build();
+
+  ReadyNotification ready;
+  daliPipelineHandle handle;
+  daliCreatePipeline(&handle, serialized.c_str(), serialized.size(), batch_size, num_thread,
+                     this->device_id_, false, prefetch_queue_depth, prefetch_queue_depth,
+                     prefetch_queue_depth, false);
+  daliSetOutputReadyCallback(&handle, ReadyNotification::Notify, &ready);
+  EXPECT_EQ(daliTryShareOutput(&handle), 0) << "Nothing was run yet";
+
+  for (int i = 0; i < 3; i++) {
+    daliRun(&handle);
+    pipe_ptr->RunCPU();
+    pipe_ptr->RunGPU();
+    ASSERT_TRUE(ready.WaitFor(i + 1)) << "The outputs of the iteration should be signaled";
+    // the notified outputs are available without waiting
+    ASSERT_EQ(daliTryShareOutput(&handle), 1);
+
+    dali::DeviceWorkspace ws;
+    pipe_ptr->Outputs(&ws);
+    TensorList<CPUBackend> ref;
+    ref.set_pinned(false);
+    ref.Copy(ws.Output<TypeParam>(0), AccessOrder::host());
+    auto num_elems = ref.shape().num_elements();
+    auto [backend_buf, cpu_buf] = AllocBufferPair<TypeParam>(num_elems, false);
+    daliOutputCopy(&handle, backend_buf.get(), 0, backend_to_device_type<TypeParam>::value, 0,
+                   DALI_ext_force_sync);
+    CopyIfDifferent(cpu_buf.get(), backend_buf.get(), num_elems, cuda_stream);
+    if (std::is_same_v<TypeParam, GPUBackend>)
+      CUDA_CALL(cudaDeviceSynchronize());
+    Check(view<uint8_t>(ref), TensorListView<StorageCPU, uint8_t>(cpu_buf.get(), ref.shape()));
+    daliOutputRelease(&handle);
+  }
+  EXPECT_EQ(daliTryShareOutput(&handle), 0);
+  daliDeletePipeline(&handle);
+}
+
+TYPED_TEST(CApiTest, ShareOutputAsync) {
+  auto pipe_ptr = GetTestPipeline<TypeParam>(true, this->output_device_);
+  auto serialized = pipe_ptr->SerializeToProtobuf();
+
+  pipe_ptr->Build();
+
+  daliPipelineHandle handle;
+  daliCreatePipeline(&handle, serialized.c_str(), serialized.size(), batch_size, num_thread,
+                     this->device_id_, false, prefetch_queue_depth, prefetch_queue_depth,
+                     prefetch_queue_depth, false);
+  auto stream = CUDAStream::Create(true);
+
+  for (int i = 0; i < 3; i++) {
+    daliRun(&handle);
+    pipe_ptr->RunCPU();
+    pipe_ptr->RunGPU();
+
+    daliShareOutputAsync(&handle, stream);
+    dali::DeviceWorkspace ws;
+    pipe_ptr->Outputs(&ws);
+    TensorList<CPUBackend> ref;
+    ref.set_pinned(false);
+    ref.Copy(ws.Output<TypeParam>(0), AccessOrder::host());
+    auto num_elems = ref.shape().num_elements();
+    auto [backend_buf, cpu_buf] = AllocBufferPair<TypeParam>(num_elems, false);
+    daliOutputCopy(&handle, backend_buf.get(), 0, backend_to_device_type<TypeParam>::value,
+                   stream, DALI_ext_default);
+    // the copy may still be running - the buffers are reused only after it's complete
+    daliOutputRelease(&handle);
+    CUDA_CALL(cudaStreamSynchronize(stream));
+    CopyIfDifferent(cpu_buf.get(), backend_buf.get(), num_elems, cuda_stream);
+    if (std::is_same_v<TypeParam, GPUBackend>)
+      CUDA_CALL(cudaDeviceSynchronize());
+    Check(view<uint8_t>(ref), TensorListView<StorageCPU, uint8_t>(cpu_buf.get(), ref.shape()));
+  }
+  daliDeletePipeline(&handle);
+}
+
 TYPED_TEST(CApiTest, IsDeserializableTest) {
   using namespace std;  // NOLINT
   vector<tuple<string /* serialized pipeline */, bool /* is deserializable? */>> test_cases;
@@ -985,6 +1211,76 @@ TYPED_TEST(CApiTest, IsDeserializableTest) {
 }
 
 
+namespace {
+
+struct TestOutputAllocator {
+  static void *Alloc(void *context, int output_idx, size_t size, int device_id,
+                     cudaStream_t stream) {
+    auto *self = static_cast<TestOutputAllocator *>(context);
+    DeviceGuard dg(device_id);
+    void *ptr = nullptr;
+    CUDA_CALL(cudaMalloc(&ptr, size));
+    std::lock_guard<std::mutex> guard(self->mtx);
+    self->live[ptr] = size;
+    self->num_allocs++;
+    return ptr;
+  }
+
+  static void Free(void *context, int output_idx, void *ptr) {
+    auto *self = static_cast<TestOutputAllocator *>(context);
+    CUDA_CALL(cudaFree(ptr));
+    std::lock_guard<std::mutex> guard(self->mtx);
+    EXPECT_EQ(self->live.erase(ptr), 1u) << "Freeing memory that wasn't allocated";
+  }
+
+  bool is_live(const void *ptr) {
+    std::lock_guard<std::mutex> guard(mtx);
+    return live.count(const_cast<void *>(ptr)) > 0;
+  }
+
+  std::mutex mtx;
+  std::map<void *, size_t> live;
+  int num_allocs = 0;
+};
+
+}  // namespace
+
+TEST(CApiTest, OutputAllocator) {
+  auto pipe_ptr = GetTestPipeline<GPUBackend>(true, "gpu");
+  auto serialized = pipe_ptr->SerializeToProtobuf();
+
+  pipe_ptr->Build();
+  for (int i = 0; i < prefetch_queue_depth; i++) {
+    pipe_ptr->RunCPU();
+    pipe_ptr->RunGPU();
+  }
+
+  TestOutputAllocator allocator;
+  daliPipelineHandle handle;
+  daliCreatePipeline(&handle, serialized.c_str(), serialized.size(), batch_size, num_thread,
+                     device_id, false, prefetch_queue_depth, prefetch_queue_depth,
+                     prefetch_queue_depth, false);
+  daliSetOutputAllocator(&handle, TestOutputAllocator::Alloc, TestOutputAllocator::Free,
+                         &allocator);
+  daliPrefetchUniform(&handle, prefetch_queue_depth);
+
+  for (int i = 0; i < prefetch_queue_depth + 2; i++) {
+    if (i >= prefetch_queue_depth) {
+      daliRun(&handle);
+      pipe_ptr->RunCPU();
+      pipe_ptr->RunGPU();
+    }
+    ComparePipelinesOutputs<GPUBackend>(handle, *pipe_ptr);
+    EXPECT_TRUE(allocator.is_live(daliOutputData(&handle, 0)))
+        << "The output should be stored in the memory obtained from the output allocator";
+  }
+  EXPECT_GE(allocator.num_allocs, prefetch_queue_depth + 2)
+      << "The memory of the released outputs shouldn't be reused";
+
+  daliDeletePipeline(&handle);
+  EXPECT_TRUE(allocator.live.empty());
+}
+
 TEST(CApiTest, CpuOnlyTest) {
   dali::Pipeline pipe(1, 1, dali::CPU_ONLY_DEVICE_ID);
   pipe.AddExternalInput("dummy");
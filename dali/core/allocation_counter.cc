@@ -0,0 +1,152 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <new>
+#include "dali/core/allocation_counter.h"
+
+namespace dali {
+
+#if ALLOCATION_COUNTING_ENABLED
+
+namespace {
+
+thread_local int64_t tl_allocation_count = 0;
+
+}  // namespace
+
+namespace detail {
+
+void *CountedAlloc(size_t size, size_t alignment = 0) {
+  tl_allocation_count++;
+  if (size == 0)
+    size = 1;
+  if (alignment) {
+    // aligned_alloc requires the size to be a multiple of the alignment
+    size = (size + alignment - 1) / alignment * alignment;
+  }
+  for (;;) {
+    void *ptr = alignment ? std::aligned_alloc(alignment, size) : std::malloc(size);
+    if (ptr)
+      return ptr;
+    auto handler = std::get_new_handler();
+    if (!handler)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+template <typename... Args>
+void *CountedAllocNoThrow(Args... args) noexcept {
+  try {
+    return CountedAlloc(args...);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+}  // namespace detail
+
+bool AllocationCountingEnabled() {
+  return true;
+}
+
+int64_t ThreadAllocationCount() {
+  return tl_allocation_count;
+}
+
+#else
+
+bool AllocationCountingEnabled() {
+  return false;
+}
+
+int64_t ThreadAllocationCount() {
+  return 0;
+}
+
+#endif  // ALLOCATION_COUNTING_ENABLED
+
+}  // namespace dali
+
+#if ALLOCATION_COUNTING_ENABLED
+
+// The replaceable global allocation functions. They are exported, so that they replace the ones
+// of the C++ runtime in the whole process, as long as this library is loaded before it.
+
+DLL_PUBLIC void *operator new(size_t size) {
+  return dali::detail::CountedAlloc(size);
+}
+
+DLL_PUBLIC void *operator new[](size_t size) {
+  return dali::detail::CountedAlloc(size);
+}
+
+DLL_PUBLIC void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return dali::detail::CountedAllocNoThrow(size);
+}
+
+DLL_PUBLIC void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return dali::detail::CountedAllocNoThrow(size);
+}
+
+DLL_PUBLIC void *operator new(size_t size, std::align_val_t alignment) {
+  return dali::detail::CountedAlloc(size, static_cast<size_t>(alignment));
+}
+
+DLL_PUBLIC void *operator new[](size_t size, std::align_val_t alignment) {
+  return dali::detail::CountedAlloc(size, static_cast<size_t>(alignment));
+}
+
+DLL_PUBLIC void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+DLL_PUBLIC void operator delete[](void *ptr) noexcept {
+  std::free(ptr);
+}
+
+DLL_PUBLIC void operator delete(void *ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+DLL_PUBLIC void operator delete[](void *ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+DLL_PUBLIC void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+
+DLL_PUBLIC void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+
+DLL_PUBLIC void operator delete(void *ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+DLL_PUBLIC void operator delete[](void *ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+DLL_PUBLIC void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+DLL_PUBLIC void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+#endif  // ALLOCATION_COUNTING_ENABLED
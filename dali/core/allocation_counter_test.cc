@@ -0,0 +1,51 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "dali/core/allocation_counter.h"
+
+namespace dali {
+
+TEST(AllocationCounter, CountsThreadAllocations) {
+  if (!AllocationCountingEnabled()) {
+    AllocationCounter counter;
+    std::vector<int> v(100);
+    EXPECT_EQ(counter.count(), 0);
+    GTEST_SKIP() << "DALI was built without BUILD_ALLOCATION_COUNTING";
+  }
+
+  AllocationCounter counter;
+  // called directly, as the allocations of new-expressions can be elided by the compiler
+  void *p = ::operator new(16);
+  EXPECT_EQ(counter.count(), 1);
+  std::vector<int> v(100);
+  EXPECT_EQ(counter.count(), 2);
+  v.resize(50);
+  ::operator delete(p);
+  EXPECT_EQ(counter.count(), 2);
+
+  // each thread has its own count
+  int64_t other_count = -1;
+  std::thread t([&]() {
+    AllocationCounter other_counter;
+    std::vector<int> a(10), b(20);
+    other_count = other_counter.count();
+  });
+  t.join();
+  EXPECT_EQ(other_count, 2);
+}
+
+}  // namespace dali
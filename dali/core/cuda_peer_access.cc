@@ -0,0 +1,65 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/core/cuda_peer_access.h"
+#include <map>
+#include <mutex>
+#include <utility>
+#include "dali/core/cuda_error.h"
+#include "dali/core/device_guard.h"
+
+namespace dali {
+
+namespace {
+
+std::mutex peer_access_mutex;
+std::map<std::pair<int, int>, bool> peer_access;
+
+}  // namespace
+
+bool EnablePeerAccess(int device, int peer) {
+  if (device == peer)
+    return true;
+  std::lock_guard<std::mutex> guard(peer_access_mutex);
+  auto it = peer_access.find({ device, peer });
+  if (it != peer_access.end())
+    return it->second;
+
+  int can_access = 0;
+  CUDA_CALL(cudaDeviceCanAccessPeer(&can_access, device, peer));
+  if (can_access) {
+    DeviceGuard dg(device);
+    cudaError_t err = cudaDeviceEnablePeerAccess(peer, 0);
+    if (err == cudaErrorPeerAccessAlreadyEnabled)
+      (void)cudaGetLastError();  // enabled outside of DALI - not an error
+    else
+      CUDA_CALL(err);
+  }
+  peer_access[{ device, peer }] = can_access != 0;
+  return can_access != 0;
+}
+
+void CopyPeer(void *dst, int dst_device, const void *src, int src_device, size_t bytes,
+              cudaStream_t stream) {
+  if (bytes == 0)
+    return;
+  if (dst_device == src_device) {
+    CUDA_CALL(cudaMemcpyAsync(dst, src, bytes, cudaMemcpyDeviceToDevice, stream));
+    return;
+  }
+  EnablePeerAccess(dst_device, src_device);
+  CUDA_CALL(cudaMemcpyPeerAsync(dst, dst_device, src, src_device, bytes, stream));
+}
+
+}  // namespace dali
@@ -0,0 +1,58 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/core/cuda_peer_access.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "dali/core/cuda_error.h"
+#include "dali/core/cuda_stream.h"
+#include "dali/core/device_guard.h"
+#include "dali/core/mm/memory.h"
+
+namespace dali {
+
+TEST(CudaPeerAccess, SameDevice) {
+  EXPECT_TRUE(EnablePeerAccess(0, 0));
+}
+
+TEST(CudaPeerAccess, CopyPeer) {
+  int count = 0;
+  CUDA_CALL(cudaGetDeviceCount(&count));
+  int peer = count > 1 ? 1 : 0;
+  const size_t n = 10000;
+  std::vector<int> in(n), out(n, -1);
+  for (size_t i = 0; i < n; i++)
+    in[i] = i * 3 + 1;
+
+  std::shared_ptr<int> src, dst;
+  {
+    DeviceGuard dg(0);
+    src = mm::alloc_raw_shared<int, mm::memory_kind::device>(n);
+    CUDA_CALL(cudaMemcpy(src.get(), in.data(), n * sizeof(int), cudaMemcpyHostToDevice));
+  }
+  DeviceGuard dg(peer);
+  dst = mm::alloc_raw_shared<int, mm::memory_kind::device>(n);
+  auto stream = CUDAStream::Create(true, peer);
+  CopyPeer(dst.get(), peer, src.get(), 0, n * sizeof(int), stream);
+  CUDA_CALL(cudaStreamSynchronize(stream));
+  CUDA_CALL(cudaMemcpy(out.data(), dst.get(), n * sizeof(int), cudaMemcpyDeviceToHost));
+  EXPECT_EQ(in, out);
+
+  // the result is cached
+  bool access = EnablePeerAccess(peer, 0);
+  EXPECT_EQ(EnablePeerAccess(peer, 0), access);
+}
+
+}  // namespace dali
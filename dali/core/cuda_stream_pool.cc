@@ -28,13 +28,13 @@ CUDAStreamPool::CUDAStreamPool() {
   dev_streams_.reserve(128);  // to avoid allocation in 1st call
 }
 
-CUDAStreamLease CUDAStreamPool::Get(int device_id) {
+CUDAStreamLease CUDAStreamPool::Get(int device_id, int priority) {
   if (device_id < 0)
     CUDA_CALL(cudaGetDevice(&device_id));
 
-  CUDAStream s = GetFromPool(device_id);
+  CUDAStream s = GetFromPool(device_id, priority);
   if (!s)
-    s = CUDAStream::Create(true, device_id);
+    s = CUDAStream::CreateWithPriority(true, priority, device_id);
   return { std::move(s), device_id, this };
 }
 
@@ -62,12 +62,16 @@ void CUDAStreamPool::Init() {
   dev_streams_.resize(num_devices);
 }
 
-CUDAStream CUDAStreamPool::GetFromPool(int device_id) {
+CUDAStream CUDAStreamPool::GetFromPool(int device_id, int priority) {
   std::lock_guard<spinlock> guard(lock_);
   if (dev_streams_.empty())
     Init();
   assert(device_id >= 0 && device_id < static_cast<int>(dev_streams_.size()));
-  StreamEntry *e = Pop(dev_streams_[device_id]);
+  // the streams of all priorities are kept in one list - there are rarely more than two
+  StreamEntry **link = &dev_streams_[device_id];
+  while (*link && (*link)->priority != priority)
+    link = &(*link)->next;
+  StreamEntry *e = Pop(*link);
   if (!e)
     return {};
   CUDAStream ev = std::move(e->stream);
@@ -78,16 +82,17 @@ CUDAStream CUDAStreamPool::GetFromPool(int device_id) {
 void CUDAStreamPool::Put(CUDAStream &&stream, int device_id) {
   if (!stream)
     throw std::invalid_argument("Cannot put a null stream in the pool.");
-  if (device_id < 0) {
-    try {
+  int priority = 0;
+  try {
+    if (device_id < 0)
       device_id = stream.GetDevice();
-    } catch (const CUDAError &e) {
-      if (e.is_unloading()) {
-        stream.reset();
-        return;
-      } else {
-        throw;
-      }
+    CUDA_CALL(cudaStreamGetPriority(stream, &priority));
+  } catch (const CUDAError &e) {
+    if (e.is_unloading()) {
+      stream.reset();
+      return;
+    } else {
+      throw;
     }
   }
 
@@ -99,10 +104,11 @@ void CUDAStreamPool::Put(CUDAStream &&stream, int device_id) {
   StreamEntry *e = Pop(unused_);
   if (!e) {
     lock.unlock();
-    e = new StreamEntry(std::move(stream));
+    e = new StreamEntry(std::move(stream), priority);
     lock.lock();
   } else {
     e->stream = std::move(stream);
+    e->priority = priority;
   }
   Push(dev_streams_[device_id], e);
 }
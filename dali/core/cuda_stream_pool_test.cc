@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -81,5 +81,34 @@ TEST_F(CUDAStreamPoolTest, PutGet) {
   TestPutGet();
 }
 
+TEST_F(CUDAStreamPoolTest, Priority) {
+  int devices = 0;
+  if (cudaGetDeviceCount(&devices) != cudaSuccess || devices == 0) {
+    (void)cudaGetLastError();
+    GTEST_SKIP() << "No CUDA devices";
+  }
+  int least = 0, greatest = 0;
+  CUDA_CALL(cudaDeviceGetStreamPriorityRange(&least, &greatest));
+  if (least == greatest)
+    GTEST_SKIP() << "Stream priorities are not supported";
+
+  CUDAStreamPool pool;
+  cudaStream_t high_handle;
+  {
+    auto high = pool.Get(-1, greatest);
+    high_handle = high;
+    int priority = least;
+    CUDA_CALL(cudaStreamGetPriority(high, &priority));
+    EXPECT_EQ(priority, greatest);
+  }
+  {
+    // the pooled stream has a different priority - a new one is created
+    auto low = pool.Get(-1, least);
+    EXPECT_NE(static_cast<cudaStream_t>(low), high_handle);
+    auto high = pool.Get(-1, greatest);
+    EXPECT_EQ(static_cast<cudaStream_t>(high), high_handle);
+  }
+}
+
 }  // namespace test
 }  // namespace dali
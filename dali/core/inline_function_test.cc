@@ -0,0 +1,120 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "dali/core/allocation_counter.h"
+#include "dali/core/inline_function.h"
+
+namespace dali {
+
+namespace {
+
+struct Counted {
+  explicit Counted(int *alive) : alive(alive) {
+    ++*alive;
+  }
+  Counted(const Counted &other) : alive(other.alive) {
+    ++*alive;
+  }
+  Counted(Counted &&other) noexcept : alive(other.alive) {
+    ++*alive;
+  }
+  ~Counted() {
+    --*alive;
+  }
+  int *alive;
+};
+
+}  // namespace
+
+TEST(InlineFunction, CallInline) {
+  int a = 1, b = 2;
+  auto f = [&a, &b](int x) { return a + b + x; };
+  static_assert(InlineFunction<int(int)>::is_inline<decltype(f)>(),
+                "A lambda capturing two references should be stored inline");
+  AllocationCounter counter;
+  InlineFunction<int(int)> fn = f;
+  EXPECT_EQ(fn(3), 6);
+  InlineFunction<int(int)> moved = std::move(fn);
+  EXPECT_FALSE(fn);
+  EXPECT_EQ(moved(4), 7);
+  EXPECT_EQ(counter.count(), 0);
+}
+
+TEST(InlineFunction, CallHeap) {
+  std::array<int, 64> data{};
+  data[10] = 5;
+  auto f = [data](int i) { return data[i]; };
+  static_assert(!InlineFunction<int(int)>::is_inline<decltype(f)>(),
+                "The callable exceeds the capacity");
+  InlineFunction<int(int)> fn = f;
+  InlineFunction<int(int)> moved;
+  moved = std::move(fn);
+  EXPECT_FALSE(fn);
+  EXPECT_EQ(moved(10), 5);
+  EXPECT_EQ(moved(0), 0);
+}
+
+TEST(InlineFunction, MoveOnly) {
+  auto ptr = std::make_unique<int>(42);
+  InlineFunction<int()> fn = [p = std::move(ptr)]() { return *p; };
+  EXPECT_EQ(fn(), 42);
+  std::vector<InlineFunction<int()>> v;
+  v.push_back(std::move(fn));
+  v.resize(10);  // relocates the functions
+  EXPECT_EQ(v[0](), 42);
+  EXPECT_FALSE(v[1]);
+}
+
+TEST(InlineFunction, Lifetime) {
+  int alive = 0;
+  {
+    Counted c(&alive);
+    InlineFunction<void()> inline_fn = [c]() {};
+    std::array<char, 100> pad{};
+    InlineFunction<void()> heap_fn = [c, pad]() {};
+    EXPECT_EQ(alive, 3);
+    InlineFunction<void()> moved_inline = std::move(inline_fn);
+    InlineFunction<void()> moved_heap = std::move(heap_fn);
+    EXPECT_EQ(alive, 3);
+    moved_inline = nullptr;
+    EXPECT_EQ(alive, 2);
+  }
+  EXPECT_EQ(alive, 0);
+}
+
+TEST(InlineFunction, Empty) {
+  InlineFunction<void(int)> fn;
+  EXPECT_FALSE(fn);
+  EXPECT_THROW(fn(0), std::bad_function_call);
+  fn = [](int) {};
+  EXPECT_TRUE(fn);
+  EXPECT_NO_THROW(fn(0));
+  fn.reset();
+  EXPECT_FALSE(fn);
+}
+
+TEST(InlineFunction, DiscardResult) {
+  int calls = 0;
+  InlineFunction<void(int)> fn = [&calls](int x) { return ++calls + x; };
+  fn(1);
+  fn(2);
+  EXPECT_EQ(calls, 2);
+}
+
+}  // namespace dali
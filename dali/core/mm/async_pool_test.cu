@@ -107,6 +107,34 @@ TEST(MMAsyncPool, TwoStream) {
   upstream.check_leaks();
 }
 
+TEST(MMAsyncPool, WaitForPendingFreesWhenOutOfMemory) {
+  mm::test::test_device_resource upstream;
+  CUDAStream s1 = CUDAStream::Create(true);
+  CUDAStream s2 = CUDAStream::Create(true);
+  stream_view sv1(s1);
+  stream_view sv2(s2);
+
+  GPUHog hog;
+  hog.init();
+  {
+    const size_t size = 1 << 20;
+    pool_options opts = default_pool_opts<memory_kind::device>();
+    opts.max_upstream_size = size;
+    async_pool_resource<memory_kind::device> pool(&upstream, false, opts);
+    void *p1 = pool.allocate_async(size, sv1);
+    hog.run(s1, 10);
+    pool.deallocate_async(p1, size, sv1);
+    // The pool has reached its limit and the only free block is still in use in s1 - the pool
+    // must wait for it instead of failing.
+    void *p2 = nullptr;
+    ASSERT_NO_THROW(p2 = pool.allocate_async(size, sv2));
+    EXPECT_EQ(p1, p2);
+    pool.deallocate_async(p2, size, sv2);
+    CUDA_CALL(cudaStreamSynchronize(s2));
+  }
+  upstream.check_leaks();
+}
+
 namespace {
 
 __global__ void Check(const void *ptr, size_t size, uint8_t fill, int *failures) {
@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -14,6 +14,7 @@
 
 #include "dali/core/mm/cu_vm.h"
 #include <gtest/gtest.h>
+#include <vector>
 
 #if DALI_USE_CUDA_VM_MAP
 
@@ -120,6 +121,36 @@ TEST(CUMemAddressRange, ReserveAndMapPiecewise) {
   EXPECT_NO_THROW(range.reset());
 }
 
+TEST(CUMemGrowableMapping, GrowAndShrink) {
+  if (!cuvm::IsSupported())
+    GTEST_SKIP() << "Virtual memory management API is not supported on this machine.";
+  size_t grain = cuvm::GetAddressGranularity();
+  cuvm::GrowableMapping mapping(16 * grain);
+  void *base = mapping.ptr();
+  EXPECT_EQ(mapping.size(), 0u);
+
+  EXPECT_NO_THROW(mapping.resize(grain));
+  EXPECT_GE(mapping.size(), grain);
+  CUDA_CALL(cudaMemset(base, 0x5a, grain));
+
+  EXPECT_NO_THROW(mapping.resize(5 * grain));
+  EXPECT_EQ(mapping.ptr(), base) << "Growing the mapping must not move the data";
+  EXPECT_GE(mapping.size(), 5 * grain);
+  std::vector<uint8_t> host(grain);
+  CUDA_CALL(cudaMemcpy(host.data(), base, grain, cudaMemcpyDeviceToHost));
+  for (size_t i = 0; i < grain; i++)
+    ASSERT_EQ(host[i], 0x5a) << "The contents were not preserved at offset " << i;
+
+  size_t grown = mapping.size();
+  EXPECT_NO_THROW(mapping.resize(grain));
+  EXPECT_LT(mapping.size(), grown) << "Shrinking should unmap the chunks past the new size";
+  EXPECT_GE(mapping.size(), grain);
+
+  EXPECT_THROW(mapping.resize(17 * grain), std::bad_alloc);
+  EXPECT_NO_THROW(mapping.resize(0));
+  EXPECT_EQ(mapping.size(), 0u);
+}
+
 }  // namespace test
 }  // namespace mm
 }  // namespace dali
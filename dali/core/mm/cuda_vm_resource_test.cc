@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -401,6 +401,33 @@ TEST_F(VMResourceTest, ExceptionSafety) {
   this->TestExceptionSafety();
 }
 
+TEST_F(VMResourceTest, Trim) {
+  if (!cuvm::IsSupported())
+    GTEST_SKIP() << "CUDA Virtual Memory Management not supported on this platform";
+  const size_t block = 4 << 20;
+  cuda_vm_resource pool(-1, block);
+  char *a = static_cast<char *>(pool.allocate(2 * block));
+  char *b = static_cast<char *>(pool.allocate(block));
+  EXPECT_EQ(pool.get_stats().reserved_bytes, 3 * block);
+
+  // only the completely free blocks are released
+  pool.deallocate(a, 2 * block);
+  EXPECT_EQ(pool.trim(2 * block), block);
+  EXPECT_EQ(pool.trim(0), block);
+  auto stats = pool.get_stats();
+  EXPECT_EQ(stats.reserved_bytes, block);
+  EXPECT_EQ(stats.upstream_deallocations, 2u);
+
+  // the released part of the address space is mapped again when needed
+  a = static_cast<char *>(pool.allocate(2 * block));
+  CUDA_CALL(cudaMemset(a, 0, 2 * block));
+  CUDA_CALL(cudaDeviceSynchronize());
+  EXPECT_EQ(pool.get_stats().reserved_bytes, 3 * block);
+  pool.deallocate(a, 2 * block);
+  pool.deallocate(b, block);
+  EXPECT_EQ(pool.trim(0), 3 * block);
+}
+
 }  // namespace test
 }  // namespace mm
 }  // namespace dali
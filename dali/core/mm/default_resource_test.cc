@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <vector>
 #include <thread>
 #include "dali/core/mm/default_resources.h"
@@ -23,6 +24,7 @@
 #include "dali/core/cuda_error.h"
 #include "dali/core/device_guard.h"
 #include "dali/core/dev_buffer.h"
+#include "dali/core/os/numa.h"
 
 namespace dali {
 namespace mm {
@@ -69,6 +71,70 @@ TEST(MMDefaultResource, GetResource_Pinned) {
 }
 
 
+TEST(MMDefaultResource, GetResource_DevicePinned) {
+  int dev = 0;
+  CUDA_CALL(cudaGetDevice(&dev));
+  auto *rsrc = GetDefaultPinnedResource(dev);
+  ASSERT_NE(rsrc, nullptr);
+  EXPECT_EQ(rsrc, GetDefaultPinnedResource(-1));
+  if (numa::NumNodes() == 1)
+    EXPECT_EQ(rsrc, GetDefaultResource<memory_kind::pinned>());
+
+  DeviceBuffer<char> dev_buf;
+  dev_buf.resize(1000);
+  char *mem = static_cast<char*>(rsrc->allocate(1000, 32));
+  ASSERT_NE(mem, nullptr);
+  EXPECT_TRUE(mm::detail::is_aligned(mem, 32));
+  for (int i = 0; i < 1000; i++)
+    mem[i] = i + 42;
+  CUDA_CALL(cudaMemcpy(dev_buf, mem, 1000, cudaMemcpyHostToDevice));
+  char back_copy[1000] = {};
+  CUDA_CALL(cudaMemcpy(back_copy, dev_buf, 1000, cudaMemcpyDeviceToHost));
+  rsrc->deallocate(mem, 1000, 32);
+  for (int i = 0; i < 1000; i++)
+    EXPECT_EQ(back_copy[i], static_cast<char>(i + 42));
+}
+
+TEST(MMDefaultResource, NumaPinnedResource) {
+  int node = std::max(numa::GetDeviceNode(), 0);
+  numa_pinned_memory_resource rsrc(node);
+  DeviceBuffer<char> dev_buf;
+  dev_buf.resize(100000);
+  for (size_t alignment : { 1, 256, 4096, 65536 }) {
+    char *mem = static_cast<char*>(rsrc.allocate(100000, alignment));
+    ASSERT_NE(mem, nullptr);
+    EXPECT_TRUE(mm::detail::is_aligned(mem, alignment));
+    cudaPointerAttributes attr = {};
+    CUDA_CALL(cudaPointerGetAttributes(&attr, mem));
+    EXPECT_EQ(attr.type, cudaMemoryTypeHost);
+    memset(mem, 42, 100000);
+    CUDA_CALL(cudaMemcpy(dev_buf, mem, 100000, cudaMemcpyHostToDevice));
+    rsrc.deallocate(mem, 100000, alignment);
+  }
+}
+
+TEST(MMDefaultResource, HugePagePinnedResource) {
+  const size_t huge_page = 2 << 20;
+  numa_pinned_memory_resource rsrc(-1, huge_page);
+  EXPECT_EQ(rsrc.huge_page_size(), huge_page);
+  const size_t size = 3 << 20;
+  DeviceBuffer<char> dev_buf;
+  dev_buf.resize(size);
+  char *mem = static_cast<char*>(rsrc.allocate(size, 4096));
+  ASSERT_NE(mem, nullptr);
+  // the mapping is rounded up to whole huge pages, whether they could be obtained or not
+  EXPECT_EQ(rsrc.huge_page_bytes() + rsrc.fallback_bytes(), 2 * huge_page);
+  cudaPointerAttributes attr = {};
+  CUDA_CALL(cudaPointerGetAttributes(&attr, mem));
+  EXPECT_EQ(attr.type, cudaMemoryTypeHost);
+  memset(mem, 42, size);
+  CUDA_CALL(cudaMemcpy(dev_buf, mem, size, cudaMemcpyHostToDevice));
+  rsrc.deallocate(mem, size, 4096);
+
+  EXPECT_FALSE(rsrc.is_equal(numa_pinned_memory_resource(-1)));
+  EXPECT_THROW(numa_pinned_memory_resource(-1, 3 << 20), std::exception);
+}
+
 TEST(MMDefaultResource, GetResource_Managed) {
   auto *rsrc = GetDefaultResource<memory_kind::managed>();
   ASSERT_NE(rsrc, nullptr);
@@ -295,6 +361,35 @@ TEST(MMDefaultResource, GetResource_Device_RangeCheck_MultiDevice) {
   EXPECT_THROW(GetDefaultDeviceResource(ndev+100), std::out_of_range);
 }
 
+TEST(MMDefaultResource, DeviceQuota) {
+  auto quota = CreateDeviceQuotaResource(-1, 1000, 3000);
+  ASSERT_NE(quota, nullptr);
+  EXPECT_EQ(quota->upstream(), GetDefaultDeviceResource(-1));
+  CUDAStream stream = CUDAStream::Create(true);
+
+  void *a = quota->allocate_async(800, 256, stream_view(stream));
+  EXPECT_EQ(quota->usage(), 800u);
+  EXPECT_FALSE(quota->over_soft_limit());
+  void *b = quota->allocate(1200, 256);
+  EXPECT_EQ(quota->usage(), 2000u);
+  EXPECT_TRUE(quota->over_soft_limit());
+  EXPECT_THROW(quota->allocate(1001, 256), quota_exceeded);
+  EXPECT_EQ(quota->usage(), 2000u) << "A failed allocation must not be counted";
+
+  quota->deallocate(b, 1200, 256);
+  EXPECT_EQ(quota->usage(), 800u);
+  EXPECT_EQ(quota->peak_usage(), 2000u);
+  quota->reset_peak_usage();
+  EXPECT_EQ(quota->peak_usage(), 800u);
+
+  // the memory can be freed after the client drops the quota
+  auto *raw = quota.get();
+  quota.reset();
+  raw->deallocate_async(a, 800, 256, stream_view(stream));
+  EXPECT_EQ(raw->usage(), 0u);
+  CUDA_CALL(cudaStreamSynchronize(stream));
+}
+
 }  // namespace test
 }  // namespace mm
 }  // namespace dali
@@ -12,8 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
 #include <stdexcept>
 #include <cstring>
+#include <thread>
+#include <vector>
 #include "dali/core/mm/default_resources.h"
 #include "dali/core/error_handling.h"
 #include "dali/core/format.h"
@@ -22,7 +28,10 @@
 #include "dali/core/mm/async_pool.h"
 #include "dali/core/mm/composite_resource.h"
 #include "dali/core/mm/cuda_vm_resource.h"
+#include "dali/core/mm/quota_resource.h"
+#include "dali/core/mm/slab_resource.h"
 #include "dali/core/call_at_exit.h"
+#include "dali/core/os/numa.h"
 
 namespace dali {
 namespace mm {
@@ -37,6 +46,11 @@ inline std::shared_ptr<T> wrap(T *p, bool own) {
     return std::shared_ptr<T>(p, [](T*){});
 }
 
+struct DeviceQuota {
+  std::shared_ptr<device_quota_resource> quota;
+  std::shared_ptr<device_async_resource> upstream;  // keeps the upstream alive
+};
+
 struct DefaultResources {
   ~DefaultResources() {
     ReleasePinned();
@@ -52,12 +66,38 @@ struct DefaultResources {
 
   std::shared_ptr<host_memory_resource> host;
   std::shared_ptr<pinned_async_resource> pinned_async;
+  // pinned memory resources allocating on a specific NUMA node, indexed by node
+  std::vector<std::shared_ptr<pinned_async_resource>> numa_pinned;
+  // set when the user replaces the default pinned resource - NUMA-local pools are not used then
+  bool pinned_overridden = false;
+  // the upstreams of the pinned pools backed with huge pages, for GetPinnedHugePageStats
+  std::vector<std::weak_ptr<numa_pinned_memory_resource>> huge_page_upstreams;
   std::shared_ptr<managed_async_resource> managed;
   std::unique_ptr<std::shared_ptr<device_async_resource>[]> device;
   int num_devices = 0;
+  // per-client quotas of the device resources, see CreateDeviceQuotaResource
+  std::vector<DeviceQuota> device_quotas;
   std::mutex mtx;
+  // releases the free memory of the idle pools, see IdleTrimmerLoop; guarded by mtx
+  std::thread idle_trimmer;
+  std::condition_variable idle_trimmer_cv;
+  bool idle_trimmer_stop = false;
+
+  void StopIdleTrimmer() {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      idle_trimmer_stop = true;
+    }
+    idle_trimmer_cv.notify_all();
+    if (idle_trimmer.joinable())
+      idle_trimmer.join();
+  }
 
   void ReleasePinned() {
+    StopIdleTrimmer();
+    for (auto &r : numa_pinned)
+      Release(r);
+    numa_pinned.clear();
     Release(pinned_async);
   }
 
@@ -66,6 +106,12 @@ struct DefaultResources {
   }
 
   void ReleaseDevice() {
+    StopIdleTrimmer();
+    for (auto &q : device_quotas) {
+      Release(q.quota);
+      Release(q.upstream);
+    }
+    device_quotas.clear();
     Release(device);
   }
 
@@ -126,8 +172,24 @@ struct DefaultResources {
 
 #define g_resources (DefaultResources::instance())
 
+bool UseHostSlabAllocator() {
+  static bool value = []() {
+    const char *env = std::getenv("DALI_USE_HOST_SLAB_ALLOC");
+    return !env || atoi(env);
+  }();
+  return value;
+}
+
 inline std::shared_ptr<host_memory_resource> CreateDefaultHostResource() {
-  static auto rsrc = std::make_shared<malloc_memory_resource>();
+  if (!UseHostSlabAllocator()) {
+    static auto rsrc = std::make_shared<malloc_memory_resource>();
+    return rsrc;
+  }
+  // The slab resource is intentionally leaked - unlike malloc, it has state and the host
+  // buffers can still be freed during the static destruction.
+  static auto *slab = new slab_resource<memory_kind::host, malloc_memory_resource>(
+      &malloc_memory_resource::instance());
+  static std::shared_ptr<host_memory_resource> rsrc(slab, [](host_memory_resource *) {});
   return rsrc;
 }
 
@@ -155,6 +217,76 @@ bool UsePinnedMemoryPool() {
   return value;
 }
 
+/**
+ * @brief Parses a size in bytes, optionally followed by a k, M or G suffix
+ */
+size_t ParseSize(const char *str) {
+  char *end = nullptr;
+  double value = std::strtod(str, &end);
+  if (end == str || value < 0)
+    DALI_FAIL(make_string("Invalid memory size: \"", str, "\"."));
+  switch (*end) {
+    case 'k': case 'K': value *= 1_uz << 10; end++; break;
+    case 'm': case 'M': value *= 1_uz << 20; end++; break;
+    case 'g': case 'G': value *= 1_uz << 30; end++; break;
+    default: break;
+  }
+  if (*end)
+    DALI_FAIL(make_string("Invalid memory size: \"", str, "\"."));
+  return static_cast<size_t>(value);
+}
+
+/**
+ * @brief The maximum size of a pinned memory pool, set with DALI_PINNED_MEM_LIMIT
+ *
+ * Past the limit, the pinned buffers are allocated from pageable memory.
+ */
+size_t PinnedMemoryLimit() {
+  static size_t value = []() {
+    const char *env = std::getenv("DALI_PINNED_MEM_LIMIT");
+    return env && *env ? ParseSize(env) : -1_uz;
+  }();
+  return value;
+}
+
+pool_options PinnedPoolOptions() {
+  auto opt = default_host_pool_opts();
+  opt.max_upstream_size = PinnedMemoryLimit();
+  return opt;
+}
+
+/**
+ * @brief The size of the huge pages backing the pinned memory pools, set with
+ *        DALI_PINNED_HUGEPAGES (e.g. 2M or 1G); 0 means regular pages
+ */
+size_t PinnedHugePageSize() {
+  static size_t value = []() {
+    const char *env = std::getenv("DALI_PINNED_HUGEPAGES");
+    return env && *env && UsePinnedMemoryPool() ? ParseSize(env) : 0_uz;
+  }();
+  return value;
+}
+
+bool UseNumaPinnedMemory() {
+  static bool value = []() {
+    const char *env = std::getenv("DALI_USE_NUMA_PINNED_MEM");
+    return UsePinnedMemoryPool() && (env ? atoi(env) : numa::NumNodes() > 1);
+  }();
+  return value;
+}
+
+/**
+ * @brief The time, in seconds, after which the free memory of an unused pool is released,
+ *        set with DALI_MEM_POOL_IDLE_TIMEOUT; 0 means never
+ */
+double PoolIdleTimeout() {
+  static double value = []() {
+    const char *env = std::getenv("DALI_MEM_POOL_IDLE_TIMEOUT");
+    return env && *env ? std::max(atof(env), 0.0) : 0.0;
+  }();
+  return value;
+}
+
 bool UseVMM() {
   static bool value = []() {
     const char *env = std::getenv("DALI_USE_VMM");
@@ -163,6 +295,94 @@ bool UseVMM() {
   return value;
 }
 
+/**
+ * @brief Releases the free memory of the default device and pinned pools which haven't been
+ *        used for PoolIdleTimeout()
+ *
+ * A pool is considered idle as long as its allocation counters don't change - the pools are
+ * checked a few times per timeout period. An idle pool is trimmed once; it's trimmed again
+ * only after it's been used and idle again.
+ */
+void IdleTrimmerLoop() {
+  using clock = std::chrono::steady_clock;
+  struct PoolActivity {
+    size_t allocations = 0, deallocations = 0;
+    clock::time_point last_used;
+    bool trimmed = false;
+  };
+  struct Pool {
+    int device_id;
+    pool_stats_provider *pool;
+    std::shared_ptr<void> keep_alive;
+  };
+  std::map<pool_stats_provider *, PoolActivity> activity;
+  std::vector<Pool> pools;
+  auto add_pool = [&](int device_id, const auto &rsrc) {
+    if (auto *pool = dynamic_cast<pool_stats_provider *>(rsrc.get()))
+      pools.push_back({ device_id, pool, rsrc });
+  };
+
+  auto timeout = std::chrono::duration_cast<clock::duration>(
+      std::chrono::duration<double>(PoolIdleTimeout()));
+  auto period = std::min<clock::duration>(timeout / 4, std::chrono::seconds(1));
+  period = std::max<clock::duration>(period, std::chrono::milliseconds(10));
+
+  std::unique_lock<std::mutex> lock(g_resources.mtx);
+  for (;;) {
+    g_resources.idle_trimmer_cv.wait_for(lock, period);
+    if (g_resources.idle_trimmer_stop)
+      break;
+    for (int dev = 0; g_resources.device && dev < g_resources.num_devices; dev++) {
+      if (g_resources.device[dev])
+        add_pool(dev, g_resources.device[dev]);
+    }
+    if (g_resources.pinned_async)
+      add_pool(-1, g_resources.pinned_async);
+    for (auto &rsrc : g_resources.numa_pinned) {
+      if (rsrc)
+        add_pool(-1, rsrc);
+    }
+    // the pools are kept alive by `pools` and the releasing functions stop this thread first
+    lock.unlock();
+
+    auto now = clock::now();
+    for (auto &p : pools) {
+      pool_stats stats = p.pool->get_stats();
+      auto it = activity.find(p.pool);
+      if (it == activity.end() ||
+          stats.allocations != it->second.allocations ||
+          stats.deallocations != it->second.deallocations) {
+        activity[p.pool] = { stats.allocations, stats.deallocations, now, false };
+        continue;
+      }
+      auto &a = it->second;
+      if (a.trimmed || now - a.last_used < timeout)
+        continue;
+      a.trimmed = true;
+      try {
+        DeviceGuard dg(p.device_id);
+        p.pool->trim(0);
+      } catch (const std::exception &e) {
+        DALI_WARN_ONCE("Warning: Cannot release the free memory of an idle memory pool: ",
+                       e.what());
+      }
+    }
+    pools.clear();
+    lock.lock();
+  }
+}
+
+/**
+ * @brief Starts IdleTrimmerLoop, if DALI_MEM_POOL_IDLE_TIMEOUT is set
+ *
+ * Must be called with g_resources.mtx locked.
+ */
+void StartIdleTrimmer() {
+  if (PoolIdleTimeout() > 0 && !g_resources.idle_trimmer.joinable() &&
+      !g_resources.idle_trimmer_stop)
+    g_resources.idle_trimmer = std::thread(IdleTrimmerLoop);
+}
+
 inline std::shared_ptr<device_async_resource> CreateDefaultDeviceResource() {
   static CUDARTLoader CUDAInit;
   CUDAEventPool::instance();
@@ -187,18 +407,44 @@ inline std::shared_ptr<device_async_resource> CreateDefaultDeviceResource() {
   }
 }
 
+/**
+ * @brief Creates the upstream of a pinned pool, obtaining the memory with mmap
+ *
+ * Must be called with g_resources.mtx locked.
+ */
+std::shared_ptr<numa_pinned_memory_resource> CreateMappedPinnedUpstream(int node) {
+  auto upstream = std::make_shared<numa_pinned_memory_resource>(node, PinnedHugePageSize());
+  if (upstream->huge_page_size())
+    g_resources.huge_page_upstreams.push_back(upstream);
+  return upstream;
+}
+
 inline std::shared_ptr<pinned_async_resource> CreateDefaultPinnedResource() {
   if (!UsePinnedMemoryPool()) {
     static auto upstream = std::make_shared<mm::pinned_malloc_memory_resource>();
     return upstream;
   }
-  static auto upstream = std::make_shared<pinned_malloc_memory_resource>();
   using resource_type = mm::async_pool_resource<mm::memory_kind::pinned,
       pool_resource_base<memory_kind::pinned, coalescing_free_tree, spinlock>>;
-  auto rsrc = std::make_shared<resource_type>(upstream.get());
+  if (PinnedHugePageSize()) {
+    // cudaMallocHost can't use huge pages - the memory is mapped and registered with CUDA instead
+    auto upstream = CreateMappedPinnedUpstream(-1);
+    auto rsrc = std::make_shared<resource_type>(upstream.get(), true, PinnedPoolOptions());
+    return make_shared_composite_resource(std::move(rsrc), std::move(upstream));
+  }
+  static auto upstream = std::make_shared<pinned_malloc_memory_resource>();
+  auto rsrc = std::make_shared<resource_type>(upstream.get(), true, PinnedPoolOptions());
   return make_shared_composite_resource(std::move(rsrc), upstream);
 }
 
+inline std::shared_ptr<pinned_async_resource> CreateNumaPinnedResource(int node) {
+  auto upstream = CreateMappedPinnedUpstream(node);
+  using resource_type = mm::async_pool_resource<mm::memory_kind::pinned,
+      pool_resource_base<memory_kind::pinned, coalescing_free_tree, spinlock>>;
+  auto rsrc = std::make_shared<resource_type>(upstream.get(), true, PinnedPoolOptions());
+  return make_shared_composite_resource(std::move(rsrc), std::move(upstream));
+}
+
 inline std::shared_ptr<managed_async_resource> CreateDefaultManagedResource() {
   static auto rsrc = std::make_shared<mm::managed_malloc_memory_resource>();
   return rsrc;
@@ -225,6 +471,7 @@ const std::shared_ptr<pinned_async_resource> &ShareDefaultResourceImpl<memory_ki
     if (!g_resources.pinned_async) {
       static CUDARTLoader init_cuda;  // force initialization of CUDA before creating the resource
       g_resources.pinned_async = CreateDefaultPinnedResource();
+      StartIdleTrimmer();
       static auto cleanup = AtScopeExit([] {
         g_resources.ReleasePinned();
       });
@@ -260,6 +507,7 @@ const std::shared_ptr<device_async_resource> &ShareDefaultDeviceResourceImpl(int
       DeviceGuard devg(device_id);
       static CUDARTLoader init_cuda;  // force initialization of CUDA before creating the resource
       g_resources.device[device_id] = CreateDefaultDeviceResource();
+      StartIdleTrimmer();
       static auto cleanup = AtScopeExit([] {
         g_resources.ReleaseDevice();
       });
@@ -273,6 +521,22 @@ const std::shared_ptr<device_async_resource> &ShareDefaultResourceImpl<memory_ki
   return ShareDefaultDeviceResourceImpl(-1);
 }
 
+std::shared_ptr<pinned_async_resource> ShareDefaultPinnedResourceImpl(int device_id) {
+  if (!UseNumaPinnedMemory())
+    return ShareDefaultResourceImpl<memory_kind::pinned>();
+  auto &global = ShareDefaultResourceImpl<memory_kind::pinned>();
+  int node = numa::GetDeviceNode(device_id);
+  std::lock_guard<std::mutex> lock(g_resources.mtx);
+  if (g_resources.pinned_overridden || node < 0)
+    return global;
+  if (node >= static_cast<int>(g_resources.numa_pinned.size()))
+    g_resources.numa_pinned.resize(node + 1);
+  auto &rsrc = g_resources.numa_pinned[node];
+  if (!rsrc)
+    rsrc = CreateNumaPinnedResource(node);
+  return rsrc;
+}
+
 }  // namespace
 
 
@@ -292,6 +556,7 @@ void SetDefaultResource<memory_kind::host>(host_memory_resource *resource, bool
 template <> DLL_PUBLIC
 void SetDefaultResource<memory_kind::pinned>(std::shared_ptr<pinned_async_resource> resource) {
   std::lock_guard<std::mutex> lock(g_resources.mtx);
+  g_resources.pinned_overridden = resource != nullptr;
   g_resources.pinned_async = std::move(resource);
 }
 
@@ -316,6 +581,23 @@ void SetDefaultDeviceResource(int device_id, device_async_resource *resource, bo
   SetDefaultDeviceResource(device_id, wrap(resource, own));
 }
 
+std::shared_ptr<device_quota_resource> CreateDeviceQuotaResource(int device_id,
+                                                                 size_t soft_limit,
+                                                                 size_t hard_limit) {
+  DeviceQuota q;
+  q.upstream = ShareDefaultDeviceResourceImpl(device_id);
+  q.quota = std::make_shared<device_quota_resource>(q.upstream.get(), soft_limit, hard_limit);
+  std::lock_guard<std::mutex> lock(g_resources.mtx);
+  auto &quotas = g_resources.device_quotas;
+  // The memory may outlive the client, so the quota is kept until its memory is freed;
+  // drop the quotas which are no longer used.
+  quotas.erase(std::remove_if(quotas.begin(), quotas.end(), [](const DeviceQuota &q) {
+    return q.quota.use_count() == 1 && q.quota->usage() == 0;
+  }), quotas.end());
+  quotas.push_back(q);
+  return q.quota;
+}
+
 // This function is for testing purposes only - it must be visible
 DLL_PUBLIC void _Test_FreeDeviceResources() {
   std::lock_guard<std::mutex> mtx(g_resources.mtx);
@@ -364,5 +646,38 @@ device_async_resource *GetDefaultDeviceResource(int device_id) {
   return ShareDefaultDeviceResourceImpl(device_id).get();
 }
 
+DLL_PUBLIC
+std::shared_ptr<pinned_async_resource> ShareDefaultPinnedResource(int device_id) {
+  return ShareDefaultPinnedResourceImpl(device_id);
+}
+
+DLL_PUBLIC
+pinned_async_resource *GetDefaultPinnedResource(int device_id) {
+  return ShareDefaultPinnedResourceImpl(device_id).get();
+}
+
+DLL_PUBLIC
+pool_stats_provider *GetDefaultDevicePoolStats(int device_id) {
+  return dynamic_cast<pool_stats_provider *>(GetDefaultDeviceResource(device_id));
+}
+
+DLL_PUBLIC
+pool_stats_provider *GetDefaultPinnedPoolStats(int device_id) {
+  return dynamic_cast<pool_stats_provider *>(GetDefaultPinnedResource(device_id));
+}
+
+pinned_huge_page_stats GetPinnedHugePageStats() {
+  pinned_huge_page_stats stats;
+  stats.huge_page_size = PinnedHugePageSize();
+  std::lock_guard<std::mutex> lock(g_resources.mtx);
+  for (auto &weak : g_resources.huge_page_upstreams) {
+    if (auto upstream = weak.lock()) {
+      stats.huge_page_bytes += upstream->huge_page_bytes();
+      stats.fallback_bytes += upstream->fallback_bytes();
+    }
+  }
+  return stats;
+}
+
 }  // namespace mm
 }  // namespace dali
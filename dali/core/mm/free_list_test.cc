@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -350,6 +350,53 @@ TEST(MMCoalescingFreeTree, Merge) {
   TestMerge<test_coalescing_free_tree>();
 }
 
+template <typename FreeList>
+void TestSpaceStats() {
+  FreeList fl;
+  char a alignas(16)[4000];
+  auto stats = fl.space_stats();
+  EXPECT_EQ(stats.bytes, 0u);
+  EXPECT_EQ(stats.blocks, 0u);
+  EXPECT_EQ(stats.largest_block, 0u);
+  fl.put(a, 100);
+  fl.put(a + 200, 300);
+  fl.put(a + 1000, 50);
+  stats = fl.space_stats();
+  EXPECT_EQ(stats.bytes, 450u);
+  EXPECT_EQ(stats.blocks, 3u);
+  EXPECT_EQ(stats.largest_block, 300u);
+  void *p = fl.get(300, 1);
+  EXPECT_EQ(p, a + 200);
+  stats = fl.space_stats();
+  EXPECT_EQ(stats.bytes, 150u);
+  EXPECT_EQ(stats.blocks, 2u);
+  EXPECT_EQ(stats.largest_block, 100u);
+}
+
+TEST(MMCoalescingFreeList, SpaceStats) {
+  TestSpaceStats<coalescing_free_list>();
+}
+
+TEST(MMCoalescingFreeTree, SpaceStats) {
+  TestSpaceStats<coalescing_free_tree>();
+}
+
+TEST(MMBestFitFreeTree, SpaceStats) {
+  TestSpaceStats<best_fit_free_tree>();
+}
+
+TEST(MMCoalescingFreeTree, SpaceStatsMerge) {
+  coalescing_free_tree fl;
+  char a alignas(16)[4000];
+  fl.put(a, 100);
+  fl.put(a + 200, 100);
+  fl.put(a + 100, 100);  // joins the blocks
+  auto stats = fl.space_stats();
+  EXPECT_EQ(stats.bytes, 300u);
+  EXPECT_EQ(stats.blocks, 1u);
+  EXPECT_EQ(stats.largest_block, 300u);
+}
+
 }  // namespace test
 }  // namespace mm
 }  // namespace dali
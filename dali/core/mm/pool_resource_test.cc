@@ -115,6 +115,138 @@ TEST(MMPoolResource, ReturnToUpstream) {
   upstream.check_leaks();
 }
 
+TEST(MMPoolResource, Stats) {
+  test_host_resource upstream;
+  {
+    auto opt = default_host_pool_opts();
+    opt.min_block_size = 1 << 16;
+    opt.max_block_size = 1 << 16;
+    pool_resource_base<memory_kind::host, coalescing_free_tree, detail::dummy_lock>
+      pool(&upstream, opt);
+    auto stats = pool.get_stats();
+    EXPECT_EQ(stats.reserved_bytes, 0u);
+    EXPECT_EQ(stats.allocated_bytes, 0u);
+    EXPECT_EQ(stats.fragmentation(), 0.0);
+
+    const int N = 16;
+    const size_t size = 1024;
+    void *mem[N];
+    for (int i = 0; i < N; i++)
+      mem[i] = pool.allocate(size, 64);
+    stats = pool.get_stats();
+    EXPECT_EQ(stats.allocations, static_cast<size_t>(N));
+    EXPECT_EQ(stats.allocated_bytes, N * size);
+    EXPECT_EQ(stats.peak_allocated_bytes, N * size);
+    EXPECT_EQ(stats.upstream_allocations, 1u);
+    EXPECT_EQ(stats.reserved_bytes, static_cast<size_t>(upstream.get_current_size()));
+    EXPECT_EQ(stats.reserved_bytes, stats.allocated_bytes + stats.free.bytes);
+
+    // free every other block - the free memory is scattered
+    for (int i = 0; i < N; i += 2)
+      pool.deallocate(mem[i], size, 64);
+    stats = pool.get_stats();
+    EXPECT_EQ(stats.deallocations, static_cast<size_t>(N / 2));
+    EXPECT_EQ(stats.allocated_bytes, N / 2 * size);
+    EXPECT_EQ(stats.peak_allocated_bytes, N * size);
+    EXPECT_EQ(stats.reserved_bytes, stats.allocated_bytes + stats.free.bytes);
+    EXPECT_GT(stats.fragmentation(), 0.0);
+
+    pool.reset_peak_stats();
+    stats = pool.get_stats();
+    EXPECT_EQ(stats.peak_allocated_bytes, N / 2 * size);
+
+    // free the rest - the free memory is contiguous again
+    for (int i = 1; i < N; i += 2)
+      pool.deallocate(mem[i], size, 64);
+    stats = pool.get_stats();
+    EXPECT_EQ(stats.allocated_bytes, 0u);
+    EXPECT_EQ(stats.free.bytes, stats.reserved_bytes);
+    EXPECT_EQ(stats.free.blocks, 1u);
+    EXPECT_EQ(stats.fragmentation(), 0.0);
+
+    pool.free_all();
+    stats = pool.get_stats();
+    EXPECT_EQ(stats.reserved_bytes, 0u);
+    EXPECT_EQ(stats.upstream_deallocations, 1u);
+  }
+  upstream.check_leaks();
+}
+
+TEST(MMPoolResource, Trim) {
+  test_host_resource upstream;
+  {
+    auto opt = default_host_pool_opts();
+    opt.min_block_size = 1 << 16;
+    opt.max_block_size = 1 << 16;
+    pool_resource_base<memory_kind::host, coalescing_free_tree, detail::dummy_lock>
+      pool(&upstream, opt);
+    EXPECT_EQ(pool.trim(0), 0u);
+
+    // each allocation takes most of an upstream block
+    const int N = 4;
+    const size_t size = 100000;
+    void *mem[N];
+    for (int i = 0; i < N; i++)
+      mem[i] = pool.allocate(size);
+    auto stats = pool.get_stats();
+    ASSERT_EQ(stats.upstream_allocations, static_cast<size_t>(N));
+    size_t block = stats.reserved_bytes / N;
+
+    // the blocks in use are kept
+    pool.deallocate(mem[1], size);
+    pool.deallocate(mem[3], size);
+    EXPECT_EQ(pool.trim(0), 2 * block);
+    stats = pool.get_stats();
+    EXPECT_EQ(stats.reserved_bytes, 2 * block);
+    EXPECT_EQ(stats.upstream_deallocations, 2u);
+    EXPECT_EQ(static_cast<size_t>(upstream.get_current_size()), 2 * block);
+
+    // the requested amount of memory stays in the pool
+    pool.deallocate(mem[0], size);
+    pool.deallocate(mem[2], size);
+    EXPECT_EQ(pool.trim(block), block);
+    EXPECT_EQ(pool.get_stats().reserved_bytes, block);
+    EXPECT_EQ(pool.trim(block), 0u);
+
+    // the pool grows again when needed
+    mem[0] = pool.allocate(size);
+    mem[1] = pool.allocate(size);
+    EXPECT_EQ(pool.get_stats().reserved_bytes, 2 * block);
+    pool.deallocate(mem[0], size);
+    pool.deallocate(mem[1], size);
+  }
+  upstream.check_leaks();
+}
+
+TEST(MMPoolResource, UpstreamSizeLimit) {
+  test_host_resource upstream;
+  {
+    auto opt = default_host_pool_opts();
+    opt.min_block_size = 1 << 16;
+    opt.max_upstream_size = 1 << 20;
+    pool_resource_base<memory_kind::host, coalescing_free_tree, detail::dummy_lock>
+      pool(&upstream, opt);
+    const size_t size = 100000;
+    std::vector<void *> mem;
+    try {
+      for (;;)
+        mem.push_back(pool.allocate(size));
+    } catch (const std::bad_alloc &) {}
+    EXPECT_GE(mem.size(), 8u);
+    EXPECT_LE(upstream.get_current_size(), opt.max_upstream_size);
+    EXPECT_LE(pool.get_stats().reserved_bytes, opt.max_upstream_size);
+    for (void *ptr : mem)
+      pool.deallocate(ptr, size);
+
+    // the free blocks are returned to the upstream to make room for a large one
+    void *large = pool.allocate(900000);
+    EXPECT_LE(upstream.get_current_size(), opt.max_upstream_size);
+    EXPECT_THROW(pool.allocate(200000), std::bad_alloc);
+    pool.deallocate(large, 900000);
+  }
+  upstream.check_leaks();
+}
+
 }  // namespace test
 }  // namespace mm
 }  // namespace dali
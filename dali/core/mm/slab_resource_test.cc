@@ -0,0 +1,205 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "dali/core/mm/detail/align.h"
+#include "dali/core/mm/mm_test_utils.h"
+#include "dali/core/mm/slab_resource.h"
+
+namespace dali {
+namespace mm {
+namespace test {
+
+namespace {
+
+struct allocation {
+  void *ptr;
+  size_t size, alignment;
+  int fill;
+};
+
+}  // namespace
+
+TEST(MMSlabResource, SizeClassesAndReuse) {
+  test_host_resource upstream;
+  {
+    slab_resource<memory_kind::host> slab(&upstream);
+    void *a = slab.allocate(1, 1);
+    void *b = slab.allocate(16, 1);
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(detail::is_aligned(a, 16));
+    EXPECT_TRUE(detail::is_aligned(b, 16));
+    EXPECT_EQ(upstream.get_num_allocs(), 1u) << "Both allocations should use the same slab";
+
+    void *c = slab.allocate(100, 128);
+    EXPECT_TRUE(detail::is_aligned(c, 128));
+    EXPECT_EQ(upstream.get_num_allocs(), 2u);
+
+    slab.deallocate(b, 16, 1);
+    EXPECT_EQ(slab.allocate(10, 8), b) << "The most recently freed object should be reused";
+    slab.deallocate(b, 10, 8);
+    slab.deallocate(a, 1, 1);
+    slab.deallocate(c, 100, 128);
+    EXPECT_EQ(upstream.get_num_deallocs(), 0u) << "The slabs should be kept until destruction";
+  }
+  EXPECT_EQ(upstream.get_current_size(), 0u);
+  upstream.check_leaks();
+}
+
+TEST(MMSlabResource, LargeAllocations) {
+  test_host_resource upstream;
+  {
+    slab_options opt;
+    opt.max_object_size = 256;
+    slab_resource<memory_kind::host> slab(&upstream, opt);
+    void *big = slab.allocate(257, 4);
+    EXPECT_EQ(upstream.get_current_size(), 257u);
+    void *overaligned = slab.allocate(16, 512);
+    EXPECT_TRUE(detail::is_aligned(overaligned, 512));
+    EXPECT_EQ(upstream.get_current_size(), 257u + 16u);
+    slab.deallocate(overaligned, 16, 512);
+    slab.deallocate(big, 257, 4);
+    EXPECT_EQ(upstream.get_current_size(), 0u);
+  }
+  upstream.check_leaks();
+}
+
+TEST(MMSlabResource, RandomAllocations) {
+  test_host_resource upstream;
+  {
+    slab_options opt;
+    opt.slab_size = 4096;
+    opt.thread_cache_size = 8;  // exercise the transfers to and from the shared lists
+    slab_resource<memory_kind::host> slab(&upstream, opt);
+    std::mt19937_64 rng(1234);
+    std::uniform_int_distribution<size_t> size_dist(1, 6000);
+    std::uniform_int_distribution<int> align_dist(0, 7);
+    std::bernoulli_distribution is_free(0.45);
+    std::vector<allocation> allocs;
+    for (int i = 0; i < 20000; i++) {
+      if (!allocs.empty() && is_free(rng)) {
+        size_t idx = std::uniform_int_distribution<size_t>(0, allocs.size() - 1)(rng);
+        std::swap(allocs[idx], allocs.back());
+        auto a = allocs.back();
+        allocs.pop_back();
+        CheckFill(a.ptr, a.size, a.fill);
+        slab.deallocate(a.ptr, a.size, a.alignment);
+      } else {
+        allocation a;
+        a.size = size_dist(rng);
+        a.alignment = size_t(1) << align_dist(rng);
+        a.fill = i;
+        a.ptr = slab.allocate(a.size, a.alignment);
+        ASSERT_TRUE(detail::is_aligned(a.ptr, a.alignment));
+        Fill(a.ptr, a.size, a.fill);
+        allocs.push_back(a);
+      }
+    }
+    for (auto &a : allocs) {
+      CheckFill(a.ptr, a.size, a.fill);
+      slab.deallocate(a.ptr, a.size, a.alignment);
+    }
+  }
+  upstream.check_leaks();
+}
+
+TEST(MMSlabResource, MultiThreaded) {
+  test_host_resource upstream;
+  {
+    slab_options opt;
+    opt.thread_cache_size = 16;
+    slab_resource<memory_kind::host> slab(&upstream, opt);
+    const int kThreads = 8;
+    // half of the objects allocated by each thread are freed by another one
+    std::vector<std::vector<allocation>> handover(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+      threads.emplace_back([&, t]() {
+        std::mt19937_64 rng(t);
+        std::uniform_int_distribution<size_t> size_dist(1, 1024);
+        std::vector<allocation> allocs;
+        for (int i = 0; i < 4000; i++) {
+          allocation a;
+          a.size = size_dist(rng);
+          a.alignment = 8;
+          a.fill = t * 10000 + i;
+          a.ptr = slab.allocate(a.size, a.alignment);
+          Fill(a.ptr, a.size, a.fill);
+          allocs.push_back(a);
+          if (i % 3 == 2) {
+            auto f = allocs[allocs.size() - 2];
+            allocs.erase(allocs.end() - 2);
+            CheckFill(f.ptr, f.size, f.fill);
+            slab.deallocate(f.ptr, f.size, f.alignment);
+          }
+        }
+        for (size_t i = 0; i < allocs.size(); i += 2)
+          handover[t].push_back(allocs[i]);
+        for (size_t i = 1; i < allocs.size(); i += 2) {
+          CheckFill(allocs[i].ptr, allocs[i].size, allocs[i].fill);
+          slab.deallocate(allocs[i].ptr, allocs[i].size, allocs[i].alignment);
+        }
+      });
+    }
+    for (auto &t : threads)
+      t.join();
+    threads.clear();
+    for (int t = 0; t < kThreads; t++) {
+      threads.emplace_back([&, t]() {
+        for (auto &a : handover[(t + 1) % kThreads]) {
+          CheckFill(a.ptr, a.size, a.fill);
+          slab.deallocate(a.ptr, a.size, a.alignment);
+        }
+      });
+    }
+    for (auto &t : threads)
+      t.join();
+  }
+  upstream.check_leaks();
+}
+
+TEST(MMSlabResource, ThreadExitReturnsCache) {
+  test_host_resource upstream;
+  {
+    slab_options opt;
+    opt.slab_size = 1024;
+    opt.thread_cache_size = 1000;
+    slab_resource<memory_kind::host> slab(&upstream, opt);
+    std::thread([&]() {
+      std::vector<void *> ptrs;
+      for (int i = 0; i < 64; i++)
+        ptrs.push_back(slab.allocate(16));
+      for (void *p : ptrs)
+        slab.deallocate(p, 16);
+    }).join();
+    auto slabs = upstream.get_num_allocs();
+    EXPECT_EQ(slabs, 1u);
+    // the objects freed by the exited thread should be available to this one
+    std::vector<void *> ptrs;
+    for (int i = 0; i < 64; i++)
+      ptrs.push_back(slab.allocate(16));
+    EXPECT_EQ(upstream.get_num_allocs(), slabs);
+    for (void *p : ptrs)
+      slab.deallocate(p, 16);
+  }
+  upstream.check_leaks();
+}
+
+}  // namespace test
+}  // namespace mm
+}  // namespace dali
@@ -50,11 +50,11 @@ class DomainTimeRangeImpl : RangeBase {
   nvtxDomainHandle_t dali_domain_;
 };
 
-DLL_PUBLIC DomainTimeRange::DomainTimeRange(const char *name, const uint32_t rgb) {
+DLL_PUBLIC void DomainTimeRange::StartNVTX(const char *name, const uint32_t rgb) {
   DomainTimeRangeImpl::GetInstance().Start(name, rgb);
 }
 
-DLL_PUBLIC DomainTimeRange::~DomainTimeRange() {
+DLL_PUBLIC void DomainTimeRange::StopNVTX() {
   DomainTimeRangeImpl::GetInstance().Stop();
 }
 
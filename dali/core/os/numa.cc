@@ -0,0 +1,112 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime_api.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "dali/core/os/numa.h"
+#include "dali/core/cuda_error.h"
+
+namespace dali {
+namespace numa {
+
+namespace {
+
+int ReadNumNodes() {
+  // the file contains a list of ranges, e.g. "0-1" or "0,2-3"
+  std::ifstream f("/sys/devices/system/node/possible");
+  std::string line;
+  if (!f || !std::getline(f, line))
+    return 1;
+  int max_node = 0;
+  int value = 0;
+  bool has_value = false;
+  for (char c : line) {
+    if (std::isdigit(c)) {
+      value = value * 10 + (c - '0');
+      has_value = true;
+    } else {
+      if (has_value)
+        max_node = std::max(max_node, value);
+      value = 0;
+      has_value = false;
+    }
+  }
+  if (has_value)
+    max_node = std::max(max_node, value);
+  return max_node + 1;
+}
+
+int ReadDeviceNode(int device_id) {
+  char bus_id[64] = {};
+  if (cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), device_id) != cudaSuccess) {
+    (void)cudaGetLastError();  // clear the error
+    return -1;
+  }
+  std::string path = "/sys/bus/pci/devices/";
+  for (char *c = bus_id; *c; c++)
+    path += std::tolower(*c);
+  path += "/numa_node";
+  std::ifstream f(path);
+  int node = -1;
+  if (!(f >> node))
+    return -1;
+  return node;
+}
+
+}  // namespace
+
+int NumNodes() {
+  static int num_nodes = ReadNumNodes();
+  return num_nodes;
+}
+
+int GetDeviceNode(int device_id) {
+  if (device_id < 0)
+    CUDA_CALL(cudaGetDevice(&device_id));
+  static std::mutex mtx;
+  static std::vector<int> nodes;
+  std::lock_guard<std::mutex> g(mtx);
+  if (device_id >= static_cast<int>(nodes.size()))
+    nodes.resize(device_id + 1, -2);
+  if (nodes[device_id] == -2)
+    nodes[device_id] = ReadDeviceNode(device_id);
+  return nodes[device_id];
+}
+
+bool BindMemory(void *ptr, size_t bytes, int node) {
+#ifdef SYS_mbind
+  if (node < 0)
+    return false;
+  constexpr int kBitsPerWord = 8 * sizeof(unsigned long);  // NOLINT
+  std::vector<unsigned long> mask(node / kBitsPerWord + 1);  // NOLINT
+  mask[node / kBitsPerWord] |= 1ul << (node % kBitsPerWord);
+  // maxnode is the number of bits in the mask, +1 due to an off-by-one in the kernel
+  long ret = syscall(SYS_mbind, ptr, bytes, MPOL_PREFERRED,  // NOLINT
+                     mask.data(), mask.size() * kBitsPerWord + 1, 0);
+  return ret == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace numa
+}  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -18,9 +18,12 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <cuda_runtime_api.h>
 #include <cstring>
 #include <exception>
 
+#include "dali/core/cuda_error.h"
+#include "dali/core/device_guard.h"
 #include "dali/core/format.h"
 #include "dali/core/os/shared_mem.h"
 
@@ -131,6 +134,13 @@ SharedMem::SharedMem(shm_handle_t handle, uint64_t size) : size_{size * sizeof(u
   memory_mapping_ = MemoryMapping(shm_handle_, size_);
 }
 
+SharedMem::~SharedMem() {
+  if (pinned_ && memory_mapping_) {
+    DeviceGuard dg(pinned_device_id_);
+    CUDA_DTOR_CALL(cudaHostUnregister(memory_mapping_.get_raw_ptr()));
+  }
+}
+
 uint64_t SharedMem::size() const {
   return size_;
 }
@@ -148,6 +158,10 @@ void SharedMem::close_handle() {
 }
 
 void SharedMem::resize(uint64_t size, bool trunc) {
+  // the registration cannot follow the mapping when it's moved, it's redone for the new one
+  bool pinned = pinned_;
+  if (pinned)
+    unregister_mapping();
   size_ = size * sizeof(uint8_t);
   if (trunc) {
     if (!shm_handle_) {
@@ -163,11 +177,47 @@ void SharedMem::resize(uint64_t size, bool trunc) {
     }
     memory_mapping_ = MemoryMapping(shm_handle_, size_);
   }
+  if (pinned)
+    register_mapping();
 }
 
 void SharedMem::close() {
+  if (pinned_)
+    unregister_mapping();
   memory_mapping_.reset();
   shm_handle_.reset();
 }
 
+void SharedMem::set_pinned(bool pinned, int device_id) {
+  if (pinned == pinned_)
+    return;
+  if (pinned) {
+    pinned_device_id_ = device_id;
+    register_mapping();
+  } else {
+    unregister_mapping();
+  }
+}
+
+bool SharedMem::is_pinned() const {
+  return pinned_;
+}
+
+void SharedMem::register_mapping() {
+  if (!memory_mapping_) {
+    throw std::logic_error("Cannot pin the memory - no memory has been mapped.");
+  }
+  DeviceGuard dg(pinned_device_id_);
+  CUDA_CALL(cudaHostRegister(memory_mapping_.get_raw_ptr(), size_, cudaHostRegisterPortable));
+  pinned_ = true;
+}
+
+void SharedMem::unregister_mapping() {
+  if (memory_mapping_) {
+    DeviceGuard dg(pinned_device_id_);
+    CUDA_CALL(cudaHostUnregister(memory_mapping_.get_raw_ptr()));
+  }
+  pinned_ = false;
+}
+
 }  // namespace dali
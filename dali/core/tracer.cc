@@ -0,0 +1,272 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/core/tracer.h"
+#include <cuda_runtime_api.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include "dali/core/cuda_error.h"
+#include "dali/core/error_handling.h"
+#include "dali/core/format.h"
+
+namespace dali {
+
+namespace {
+
+/// The GPU references older than that are replaced, so that the float elapsed times stay precise
+constexpr int64_t kGPUReferenceLifetimeNs = 1000000000;
+
+/// The tids of the tracks of the CUDA streams start here, not to collide with the threads
+constexpr int64_t kFirstStreamTid = int64_t(1) << 32;
+
+/// The thread, whose name is taken when it records its first span - after a Start
+struct ThreadInfo {
+  int64_t tid = syscall(SYS_gettid);
+  int64_t registered_generation = -1;
+};
+
+thread_local ThreadInfo this_thread_info;
+
+std::atomic<int64_t> tracer_generation{0};
+
+void AppendEscaped(std::ostream &os, const std::string &str) {
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          os << buf;
+        } else {
+          os << c;
+        }
+    }
+  }
+}
+
+/// Writes a time relative to the start of the trace in microseconds, as expected by the format
+void AppendMicroseconds(std::ostream &os, int64_t ns) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.3f", ns * 1e-3);
+  os << buf;
+}
+
+}  // namespace
+
+Tracer &Tracer::instance() {
+  // never destroyed - the events must not outlive the CUDA context at the process exit
+  static Tracer *tracer = new Tracer();
+  return *tracer;
+}
+
+int64_t Tracer::Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::Start(size_t max_events) {
+  DALI_ENFORCE(max_events > 0, "The maximum number of events must be positive.");
+  std::lock_guard<std::mutex> g(mtx_);
+  enabled_ = false;
+  // the spans of the previous recording are of no interest - only their events are reused
+  CollectGPUSpans(true);
+  spans_.clear();
+  thread_names_.clear();
+  stream_tids_.clear();
+  dropped_events_ = 0;
+  max_events_ = max_events;
+  start_ns_ = Now();
+  tracer_generation++;
+  enabled_ = true;
+}
+
+void Tracer::Stop() {
+  enabled_ = false;
+}
+
+int64_t Tracer::dropped_events() const {
+  std::lock_guard<std::mutex> g(mtx_);
+  return dropped_events_;
+}
+
+void Tracer::AddSpan(std::string name, int64_t begin_ns, int64_t end_ns) {
+  auto &info = this_thread_info;
+  std::lock_guard<std::mutex> g(mtx_);
+  if (!enabled_)
+    return;
+  int64_t generation = tracer_generation;
+  if (info.registered_generation != generation) {
+    info.registered_generation = generation;
+    char thread_name[64] = {};
+    if (pthread_getname_np(pthread_self(), thread_name, sizeof(thread_name)) != 0)
+      thread_name[0] = '\0';
+    thread_names_[info.tid] = thread_name;
+  }
+  AddSpanLocked({ std::move(name), begin_ns, end_ns, info.tid, false });
+}
+
+void Tracer::AddSpanLocked(Span span) {
+  if (spans_.size() >= max_events_) {
+    dropped_events_++;
+    return;
+  }
+  spans_.push_back(std::move(span));
+}
+
+std::shared_ptr<Tracer::GPUReference> Tracer::GetGPUReference(int device_id) {
+  auto &reference = gpu_references_[device_id];
+  if (reference && Now() - reference->host_ns < kGPUReferenceLifetimeNs)
+    return reference;
+  // The reference event is recorded in an idle stream, to be complete as soon as possible,
+  // without waiting for the work in the traced streams
+  auto &stream = reference_streams_[device_id];
+  if (!stream)
+    stream = CUDAStream::Create(true, device_id);
+  auto new_reference = std::make_shared<GPUReference>();
+  new_reference->event = CUDAEvent::CreateWithFlags(cudaEventDefault, device_id);
+  CUDA_CALL(cudaEventRecord(new_reference->event, stream));
+  CUDA_CALL(cudaEventSynchronize(new_reference->event));
+  new_reference->host_ns = Now();
+  reference = std::move(new_reference);
+  return reference;
+}
+
+Tracer::GPUSpan Tracer::BeginGPUSpan(cudaStream_t stream) {
+  GPUSpan span;
+  CUDA_CALL(cudaGetDevice(&span.device_id));
+  {
+    std::lock_guard<std::mutex> g(mtx_);
+    CollectGPUSpans(false);
+    auto &free_events = free_events_[span.device_id];
+    for (auto *event : { &span.start, &span.end }) {
+      if (free_events.empty()) {
+        *event = CUDAEvent::CreateWithFlags(cudaEventDefault, span.device_id);
+      } else {
+        *event = std::move(free_events.back());
+        free_events.pop_back();
+      }
+    }
+  }
+  CUDA_CALL(cudaEventRecord(span.start, stream));
+  return span;
+}
+
+void Tracer::EndGPUSpan(std::string name, GPUSpan span, cudaStream_t stream) {
+  CUDA_CALL(cudaEventRecord(span.end, stream));
+  std::lock_guard<std::mutex> g(mtx_);
+  if (!enabled_) {
+    free_events_[span.device_id].push_back(std::move(span.start));
+    free_events_[span.device_id].push_back(std::move(span.end));
+    return;
+  }
+  int device_id = span.device_id;
+  pending_.push_back({ std::move(name), std::move(span), GetGPUReference(device_id),
+                       StreamTid(stream, device_id) });
+}
+
+int64_t Tracer::StreamTid(cudaStream_t stream, int device_id) {
+  auto it = stream_tids_.find({ stream, device_id });
+  if (it != stream_tids_.end())
+    return it->second;
+  int64_t tid = kFirstStreamTid + stream_tids_.size();
+  stream_tids_.emplace(std::make_pair(stream, device_id), tid);
+  thread_names_[tid] = make_string("GPU ", device_id, " stream ", static_cast<void *>(stream));
+  return tid;
+}
+
+void Tracer::CollectGPUSpans(bool wait) {
+  while (!pending_.empty()) {
+    auto &pending = pending_.front();
+    if (wait) {
+      CUDA_CALL(cudaEventSynchronize(pending.span.end));
+    } else {
+      auto status = cudaEventQuery(pending.span.end);
+      if (status == cudaErrorNotReady)
+        break;
+      CUDA_CALL(status);
+    }
+    float start_ms = 0, end_ms = 0;
+    CUDA_CALL(cudaEventElapsedTime(&start_ms, pending.reference->event, pending.span.start));
+    CUDA_CALL(cudaEventElapsedTime(&end_ms, pending.reference->event, pending.span.end));
+    int64_t host_ns = pending.reference->host_ns;
+    AddSpanLocked({ std::move(pending.name), host_ns + static_cast<int64_t>(start_ms * 1e6),
+                    host_ns + static_cast<int64_t>(end_ms * 1e6), pending.tid, true });
+    auto &free_events = free_events_[pending.span.device_id];
+    free_events.push_back(std::move(pending.span.start));
+    free_events.push_back(std::move(pending.span.end));
+    pending_.pop_front();
+  }
+}
+
+std::string Tracer::ToJSON() {
+  std::lock_guard<std::mutex> g(mtx_);
+  CollectGPUSpans(true);
+  int64_t pid = getpid();
+  std::stringstream ss;
+  ss << "{\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&]() {
+    if (!first)
+      ss << ",";
+    first = false;
+    ss << "\n";
+  };
+  for (auto &thread : thread_names_) {
+    separator();
+    ss << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << thread.first
+       << ",\"args\":{\"name\":\"";
+    AppendEscaped(ss, thread.second);
+    ss << "\"}}";
+  }
+  for (auto &span : spans_) {
+    separator();
+    ss << "{\"name\":\"";
+    AppendEscaped(ss, span.name);
+    ss << "\",\"cat\":\"" << (span.gpu ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"ts\":";
+    AppendMicroseconds(ss, span.begin_ns - start_ns_);
+    ss << ",\"dur\":";
+    AppendMicroseconds(ss, span.end_ns - span.begin_ns);
+    ss << ",\"pid\":" << pid << ",\"tid\":" << span.tid << "}";
+  }
+  ss << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return ss.str();
+}
+
+void Tracer::Write(const std::string &filename) {
+  std::string json = ToJSON();
+  std::ofstream file(filename);
+  DALI_ENFORCE(file.good(), make_string("Cannot open the trace file \"", filename, "\"."));
+  file << json;
+  DALI_ENFORCE(file.good(), make_string("Cannot write the trace file \"", filename, "\"."));
+}
+
+}  // namespace dali
@@ -0,0 +1,77 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <string>
+#include <thread>
+#include "dali/core/nvtx.h"
+#include "dali/core/tracer.h"
+
+namespace dali {
+
+namespace {
+
+int CountOccurrences(const std::string &str, const std::string &what) {
+  int n = 0;
+  for (size_t pos = str.find(what); pos != std::string::npos; pos = str.find(what, pos + 1))
+    n++;
+  return n;
+}
+
+}  // namespace
+
+TEST(Tracer, RecordsDomainTimeRanges) {
+  auto &tracer = Tracer::instance();
+  tracer.Start();
+  {
+    DomainTimeRange tr("span \"1\"");
+  }
+  std::thread t([]() {
+    pthread_setname_np(pthread_self(), "tracer_test");
+    DomainTimeRange tr(std::string("span 2"));
+  });
+  t.join();
+  tracer.Stop();
+  {
+    DomainTimeRange tr("span 3");
+  }
+
+  auto json = tracer.ToJSON();
+  EXPECT_EQ(json.find("{\"traceEvents\":["), 0u);
+  EXPECT_EQ(CountOccurrences(json, "\"ph\":\"X\""), 2);
+  EXPECT_NE(json.find("\"name\":\"span \\\"1\\\"\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"span 2\""), std::string::npos);
+  EXPECT_EQ(json.find("span 3"), std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"name\":\"tracer_test\"}"), std::string::npos);
+  EXPECT_EQ(tracer.dropped_events(), 0);
+
+  // starting again discards the spans
+  tracer.Start();
+  tracer.Stop();
+  EXPECT_EQ(CountOccurrences(tracer.ToJSON(), "\"ph\":\"X\""), 0);
+}
+
+TEST(Tracer, MaxEvents) {
+  auto &tracer = Tracer::instance();
+  tracer.Start(3);
+  for (int i = 0; i < 5; i++) {
+    DomainTimeRange tr("span");
+  }
+  tracer.Stop();
+  EXPECT_EQ(CountOccurrences(tracer.ToJSON(), "\"ph\":\"X\""), 3);
+  EXPECT_EQ(tracer.dropped_events(), 2);
+}
+
+}  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -98,6 +98,24 @@ class Image {
     return use_fast_idct_;
   }
 
+  /**
+   * Allows the decoder to decode the image (or the crop) at a reduced resolution, e.g. with
+   * JPEG DCT scaling, as long as it is at least `min_height` x `min_width`.
+   * Non-positive values disable it.
+   */
+  inline void SetMinDecodedSize(int min_height, int min_width) {
+    min_decoded_height_ = min_height;
+    min_decoded_width_ = min_width;
+  }
+
+  inline int MinDecodedHeight() const {
+    return min_decoded_height_;
+  }
+
+  inline int MinDecodedWidth() const {
+    return min_decoded_width_;
+  }
+
   virtual ~Image() = default;
   DISABLE_COPY_MOVE_ASSIGN(Image);
 
@@ -135,6 +153,8 @@ class Image {
   const DALIImageType image_type_;
   bool decoded_ = false;
   bool use_fast_idct_ = false;
+  int min_decoded_height_ = 0;
+  int min_decoded_width_ = 0;
   Shape shape_;
   CropWindowGenerator crop_window_generator_;
   std::shared_ptr<uint8_t> decoded_image_ = nullptr;
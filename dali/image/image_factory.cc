@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -82,6 +82,27 @@ bool CheckIsTiff(const uint8_t *tiff, int size) {
 
 }  // namespace
 
+ImageFormat ImageFactory::GetImageFormat(const uint8_t *encoded_image, size_t length) {
+  if (!encoded_image || length < 4)
+    return ImageFormat::Unknown;
+  ImageFormat format = ImageFormat::Unknown;
+  int matches = 0;
+  auto check = [&](bool is_format, ImageFormat f) {
+    if (is_format) {
+      format = f;
+      matches++;
+    }
+  };
+  check(CheckIsPNG(encoded_image, length), ImageFormat::Png);
+  check(CheckIsBMP(encoded_image, length), ImageFormat::Bmp);
+  check(CheckIsJPEG(encoded_image, length), ImageFormat::Jpeg);
+  check(CheckIsTiff(encoded_image, length), ImageFormat::Tiff);
+  check(CheckIsPNM(encoded_image, length), ImageFormat::Pnm);
+  check(CheckIsJPEG2k(encoded_image, length), ImageFormat::Jpeg2k);
+  check(CheckIsWebP(encoded_image, length), ImageFormat::WebP);
+  return matches == 1 ? format : ImageFormat::Unknown;
+}
+
 std::unique_ptr<Image>
 ImageFactory::CreateImage(const uint8_t *encoded_image, size_t length, DALIImageType image_type) {
   bool is_png    = CheckIsPNG(encoded_image, length);
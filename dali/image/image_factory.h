@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -17,6 +17,7 @@
 
 #include <memory>
 #include "dali/image/image.h"
+#include "dali/image/image_info.h"
 
 namespace dali {
 
@@ -24,6 +25,13 @@ class ImageFactory {
  public:
   DLL_PUBLIC static std::unique_ptr<Image>
   CreateImage(const uint8_t *encoded_image, size_t length, DALIImageType image_type);
+
+  /**
+   * @brief Recognizes the format of the encoded image by its signature.
+   *
+   * @return ImageFormat::Unknown, if the signature matches no format or more than one format
+   */
+  DLL_PUBLIC static ImageFormat GetImageFormat(const uint8_t *encoded_image, size_t length);
 };
 
 }  // namespace dali
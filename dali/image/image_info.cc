@@ -0,0 +1,134 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/image/image_info.h"
+#include <exception>
+#include "dali/core/byte_io.h"
+#include "dali/image/image_factory.h"
+
+namespace dali {
+
+namespace {
+
+inline bool IsJpegFrameMarker(uint8_t marker) {
+  // SOF0-SOF15, except for DHT (0xC4), JPG (0xC8) and DAC (0xCC)
+  return marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc;
+}
+
+inline bool IsJpegProgressiveMarker(uint8_t marker) {
+  return marker == 0xc2 || marker == 0xc6 || marker == 0xca || marker == 0xce;
+}
+
+/**
+ * @brief Derives the subsampling from the sampling factors of the components of a JPEG frame
+ *
+ * @param factors the (horizontal << 4 | vertical) sampling factors, one per component
+ */
+ChromaSubsampling GetJpegSubsampling(const uint8_t *factors, int ncomponents, int stride) {
+  if (ncomponents == 1)
+    return ChromaSubsampling::Gray;
+  if (ncomponents != 3)
+    return ChromaSubsampling::Other;
+  int h0 = factors[0] >> 4, v0 = factors[0] & 0xf;
+  int h1 = factors[stride] >> 4, v1 = factors[stride] & 0xf;
+  if (factors[stride] != factors[2 * stride] || h1 == 0 || v1 == 0 ||
+      h0 % h1 != 0 || v0 % v1 != 0)
+    return ChromaSubsampling::Other;
+  int h = h0 / h1, v = v0 / v1;
+  if (h == 1 && v == 1)
+    return ChromaSubsampling::CSS444;
+  if (h == 2 && v == 1)
+    return ChromaSubsampling::CSS422;
+  if (h == 2 && v == 2)
+    return ChromaSubsampling::CSS420;
+  if (h == 1 && v == 2)
+    return ChromaSubsampling::CSS440;
+  if (h == 4 && v == 1)
+    return ChromaSubsampling::CSS411;
+  if (h == 4 && v == 2)
+    return ChromaSubsampling::CSS410;
+  return ChromaSubsampling::Other;
+}
+
+}  // namespace
+
+bool ParseJpegInfo(const uint8_t *encoded, int64_t size, ImageInfo &info) {
+  if (size < 4 || encoded[0] != 0xff || encoded[1] != 0xd8)
+    return false;
+  const uint8_t *ptr = encoded + 2;
+  const uint8_t *end = encoded + size;
+  while (end - ptr >= 4) {
+    if (ptr[0] != 0xff)
+      return false;
+    uint8_t marker = ptr[1];
+    if (marker == 0xff) {  // fill byte
+      ptr++;
+      continue;
+    }
+    if (marker == 0xda || marker == 0xd9)  // start of scan or end of image
+      return false;
+    int64_t segment_length = ReadValueBE<uint16_t>(ptr + 2);
+    if (segment_length < 2 || end - ptr - 2 < segment_length)
+      return false;
+    if (IsJpegFrameMarker(marker)) {
+      // [length:2][precision:1][height:2][width:2][ncomponents:1]{[id:1][factors:1][table:1]}
+      constexpr int kComponentsOffset = 10, kComponentSize = 3;
+      if (segment_length < 8)
+        return false;
+      int height = ReadValueBE<uint16_t>(ptr + 5);
+      int width = ReadValueBE<uint16_t>(ptr + 7);
+      int ncomponents = ptr[9];
+      if (height == 0 || width == 0 || ncomponents == 0 ||
+          segment_length < 8 + ncomponents * kComponentSize)
+        return false;
+      info.format = ImageFormat::Jpeg;
+      info.shape = { height, width, ncomponents };
+      info.jpeg_components = ncomponents;
+      info.subsampling = GetJpegSubsampling(ptr + kComponentsOffset + 1, ncomponents,
+                                            kComponentSize);
+      info.progressive = IsJpegProgressiveMarker(marker);
+      info.encoded_size = size;
+      return true;
+    }
+    ptr += 2 + segment_length;
+  }
+  return false;
+}
+
+bool ParseImageInfo(const uint8_t *encoded, int64_t size, ImageInfo &info) {
+  info = {};
+  ImageFormat format = ImageFactory::GetImageFormat(encoded, size);
+  if (format == ImageFormat::Unknown)
+    return false;
+  if (format == ImageFormat::Jpeg) {
+    if (!ParseJpegInfo(encoded, size, info))
+      return false;
+    // the same as JpegImage::PeekShape - we support only 1 or 3 channels
+    if (info.shape[2] > 3)
+      info.shape[2] = 3;
+    return true;
+  }
+  try {
+    // the shape is taken from the image, so that it's consistent with PeekShape
+    info.shape = ImageFactory::CreateImage(encoded, size, DALI_RGB)->PeekShape();
+  } catch (const std::exception &) {
+    info = {};
+    return false;
+  }
+  info.format = format;
+  info.encoded_size = size;
+  return true;
+}
+
+}  // namespace dali
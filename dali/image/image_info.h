@@ -0,0 +1,95 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_IMAGE_IMAGE_INFO_H_
+#define DALI_IMAGE_IMAGE_INFO_H_
+
+#include <cstdint>
+#include "dali/core/api_helper.h"
+#include "dali/core/tensor_shape.h"
+
+namespace dali {
+
+enum class ImageFormat : uint8_t {
+  Unknown = 0,
+  Jpeg,
+  Png,
+  Jpeg2k,
+  Bmp,
+  Tiff,
+  Pnm,
+  WebP,
+};
+
+/**
+ * @brief The chroma subsampling of a JPEG image
+ */
+enum class ChromaSubsampling : uint8_t {
+  Unknown = 0,
+  Gray,
+  CSS444,
+  CSS422,
+  CSS420,
+  CSS440,
+  CSS411,
+  CSS410,
+  Other,
+};
+
+/**
+ * @brief The properties of an encoded image, read from its header
+ *
+ * The info is parsed once per sample (see ParseImageInfo) and attached to the encoded sample
+ * as metadata, so that the operators consuming the sample don't need to parse the header again.
+ */
+struct ImageInfo {
+  ImageFormat format = ImageFormat::Unknown;
+  /// The shape, as returned by Image::PeekShape (HWC)
+  TensorShape<3> shape = { 0, 0, 0 };
+  /// The number of color components in the JPEG frame; can differ from shape[2] (e.g., CMYK)
+  int jpeg_components = 0;
+  ChromaSubsampling subsampling = ChromaSubsampling::Unknown;
+  bool progressive = false;
+  /// The size of the encoded data the info was parsed from
+  int64_t encoded_size = -1;
+
+  /**
+   * @brief Checks whether the info has been parsed and describes an encoded image
+   *        of the given size
+   */
+  bool IsValidFor(int64_t size) const {
+    return format != ImageFormat::Unknown && encoded_size == size;
+  }
+};
+
+/**
+ * @brief Reads the properties of the encoded image from its header, without decoding the image.
+ *
+ * @return false, if the format is not recognized or the header is invalid
+ */
+DLL_PUBLIC bool ParseImageInfo(const uint8_t *encoded, int64_t size, ImageInfo &info);
+
+/**
+ * @brief Reads the frame header of a JPEG image: the size, the number of components,
+ *        the subsampling and the progressive flag.
+ *
+ * The shape is stored as read from the frame header, without clamping the number of channels.
+ *
+ * @return false, if there's no valid frame header before the first scan
+ */
+DLL_PUBLIC bool ParseJpegInfo(const uint8_t *encoded, int64_t size, ImageInfo &info);
+
+}  // namespace dali
+
+#endif  // DALI_IMAGE_IMAGE_INFO_H_
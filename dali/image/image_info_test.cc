@@ -0,0 +1,124 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "dali/image/image_factory.h"
+#include "dali/image/image_info.h"
+#include "dali/test/dali_test_config.h"
+#include "dali/util/image.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief Creates the beginning of a JPEG stream: SOI, an APP0 segment and a frame header
+ *
+ * @param factors the sampling factors of the components
+ */
+std::vector<uint8_t> JpegHeader(uint8_t sof_marker, int height, int width,
+                                const std::vector<uint8_t> &factors) {
+  std::vector<uint8_t> data = { 0xff, 0xd8, 0xff, 0xe0, 0x00, 0x04, 0x00, 0x00 };
+  int ncomponents = factors.size();
+  int length = 8 + 3 * ncomponents;
+  std::vector<uint8_t> sof = {
+    0xff, sof_marker,
+    static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length),
+    8,
+    static_cast<uint8_t>(height >> 8), static_cast<uint8_t>(height),
+    static_cast<uint8_t>(width >> 8), static_cast<uint8_t>(width),
+    static_cast<uint8_t>(ncomponents)
+  };
+  for (int i = 0; i < ncomponents; i++) {
+    sof.push_back(i + 1);
+    sof.push_back(factors[i]);
+    sof.push_back(i > 0);
+  }
+  data.insert(data.end(), sof.begin(), sof.end());
+  data.insert(data.end(), { 0xff, 0xda, 0x00, 0x02 });
+  return data;
+}
+
+void CheckConsistentWithPeekShape(const std::string &dir, const std::vector<std::string> &ext,
+                                  ImageFormat format) {
+  ImgSetDescr images;
+  LoadImages(ImageList(testing::dali_extra_path() + dir, ext, 10), &images);
+  ASSERT_GT(images.nImages(), 0u);
+  for (size_t i = 0; i < images.nImages(); i++) {
+    ImageInfo info;
+    ASSERT_TRUE(ParseImageInfo(images.data_[i], images.sizes_[i], info));
+    EXPECT_EQ(info.format, format);
+    EXPECT_TRUE(info.IsValidFor(images.sizes_[i]));
+    auto img = ImageFactory::CreateImage(images.data_[i], images.sizes_[i], DALI_RGB);
+    EXPECT_EQ(info.shape, img->PeekShape());
+  }
+}
+
+}  // namespace
+
+TEST(ImageInfoTest, ParseJpegInfo) {
+  ImageInfo info;
+  auto data = JpegHeader(0xc0, 480, 640, { 0x22, 0x11, 0x11 });
+  ASSERT_TRUE(ParseImageInfo(data.data(), data.size(), info));
+  EXPECT_EQ(info.format, ImageFormat::Jpeg);
+  EXPECT_EQ(info.shape, TensorShape<3>(480, 640, 3));
+  EXPECT_EQ(info.subsampling, ChromaSubsampling::CSS420);
+  EXPECT_FALSE(info.progressive);
+  EXPECT_TRUE(info.IsValidFor(data.size()));
+  EXPECT_FALSE(info.IsValidFor(data.size() + 1));
+
+  data = JpegHeader(0xc2, 31, 17, { 0x21, 0x11, 0x11 });
+  ASSERT_TRUE(ParseImageInfo(data.data(), data.size(), info));
+  EXPECT_EQ(info.shape, TensorShape<3>(31, 17, 3));
+  EXPECT_EQ(info.subsampling, ChromaSubsampling::CSS422);
+  EXPECT_TRUE(info.progressive);
+
+  data = JpegHeader(0xc1, 10, 20, { 0x11 });
+  ASSERT_TRUE(ParseImageInfo(data.data(), data.size(), info));
+  EXPECT_EQ(info.shape, TensorShape<3>(10, 20, 1));
+  EXPECT_EQ(info.subsampling, ChromaSubsampling::Gray);
+
+  // CMYK - the shape is clamped to 3 channels, as in PeekShape
+  data = JpegHeader(0xc0, 10, 20, { 0x11, 0x11, 0x11, 0x11 });
+  ASSERT_TRUE(ParseImageInfo(data.data(), data.size(), info));
+  EXPECT_EQ(info.shape, TensorShape<3>(10, 20, 3));
+  EXPECT_EQ(info.jpeg_components, 4);
+  EXPECT_EQ(info.subsampling, ChromaSubsampling::Other);
+}
+
+TEST(ImageInfoTest, InvalidData) {
+  ImageInfo info;
+  auto data = JpegHeader(0xc0, 480, 640, { 0x22, 0x11, 0x11 });
+  std::vector<uint8_t> truncated(data.begin(), data.begin() + 12);
+  EXPECT_FALSE(ParseImageInfo(truncated.data(), truncated.size(), info));
+  EXPECT_FALSE(info.IsValidFor(truncated.size()));
+
+  auto no_height = JpegHeader(0xc0, 0, 640, { 0x22, 0x11, 0x11 });
+  EXPECT_FALSE(ParseImageInfo(no_height.data(), no_height.size(), info));
+
+  std::vector<uint8_t> unknown = { 'G', 'I', 'F', '8', '9', 'a', 0, 0, 0, 0, 0, 0 };
+  EXPECT_FALSE(ParseImageInfo(unknown.data(), unknown.size(), info));
+  EXPECT_EQ(info.format, ImageFormat::Unknown);
+}
+
+TEST(ImageInfoTest, ConsistentWithPeekShape) {
+  CheckConsistentWithPeekShape("/db/single/jpeg", {".jpg"}, ImageFormat::Jpeg);
+  CheckConsistentWithPeekShape("/db/single/png", {".png"}, ImageFormat::Png);
+  CheckConsistentWithPeekShape("/db/single/bmp", {".bmp"}, ImageFormat::Bmp);
+  CheckConsistentWithPeekShape("/db/single/jpeg2k", {".jp2"}, ImageFormat::Jpeg2k);
+}
+
+}  // namespace dali
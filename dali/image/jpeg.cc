@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,11 +13,14 @@
 // limitations under the License.
 
 #include "dali/image/jpeg.h"
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include "dali/image/jpeg_mem.h"
 #include "dali/util/ocv.h"
 #include "dali/core/byte_io.h"
+#include "dali/core/util.h"
+#include "dali/kernels/imgproc/color_manipulation/color_space_conversion_cpu.h"
 
 namespace dali {
 
@@ -27,6 +30,15 @@ JpegImage::JpegImage(const uint8_t *encoded_buffer,
   : GenericImage(encoded_buffer, length, image_type) {
 }
 
+int SelectJpegScaleDenom(int roi_height, int roi_width, int min_height, int min_width) {
+  if (min_height <= 0 || min_width <= 0)
+    return 1;
+  int denom = 8;
+  while (denom > 1 && (roi_height < min_height * denom || roi_width < min_width * denom))
+    denom /= 2;
+  return denom;
+}
+
 #ifndef DALI_USE_JPEG_TURBO
 bool get_jpeg_size(const uint8 *data, size_t data_size, int *height, int *width, int *nchannels) {
   unsigned int i = 0;
@@ -75,10 +87,8 @@ JpegImage::DecodeImpl(DALIImageType type, const uint8 *jpeg, size_t length) cons
   DALI_ENFORCE(w > 0);
 
 #ifdef DALI_USE_JPEG_TURBO
-  // not supported by libjpeg-turbo
-  if (type == DALI_YCbCr) {
-    return GenericImage::DecodeImpl(type, jpeg, length);
-  }
+  // libjpeg-turbo doesn't output ITU-R BT.601 YCbCr - the image is decoded to RGB and converted
+  const bool to_ycbcr = type == DALI_YCbCr;
 
   jpeg::UncompressFlags flags;
   if (UseFastIdct()) {
@@ -87,21 +97,36 @@ JpegImage::DecodeImpl(DALIImageType type, const uint8 *jpeg, size_t length) cons
   flags.components = c;
 
   flags.crop = false;
+  int64_t roi_y = 0, roi_x = 0;
+  int64_t roi_h = h, roi_w = w;
   auto crop_window_generator = GetCropWindowGenerator();
   if (crop_window_generator) {
     flags.crop = true;
     TensorShape<> shape{static_cast<int>(h), static_cast<int>(w)};
     auto crop = crop_window_generator(shape, "HW");
     crop.EnforceInRange(shape);
-    flags.crop_y = crop.anchor[0];
-    flags.crop_x = crop.anchor[1];
-    flags.crop_height = crop.shape[0];
-    flags.crop_width = crop.shape[1];
+    roi_y = crop.anchor[0];
+    roi_x = crop.anchor[1];
+    roi_h = crop.shape[0];
+    roi_w = crop.shape[1];
   }
 
-  DALI_ENFORCE(type == DALI_RGB || type == DALI_BGR || type == DALI_GRAY,
+  // libjpeg-turbo can skip the computation of the higher frequencies of the IDCT, producing
+  // an image scaled by 1/ratio, with the dimensions rounded up
+  flags.ratio = SelectJpegScaleDenom(roi_h, roi_w, MinDecodedHeight(), MinDecodedWidth());
+  if (flags.crop) {
+    // the crop window is given in the coordinates of the scaled image
+    const int64_t r = flags.ratio;
+    const int64_t scaled_h = div_ceil(h, r), scaled_w = div_ceil(w, r);
+    flags.crop_y = roi_y / r;
+    flags.crop_x = roi_x / r;
+    flags.crop_height = std::min(div_ceil(roi_y + roi_h, r), scaled_h) - flags.crop_y;
+    flags.crop_width = std::min(div_ceil(roi_x + roi_w, r), scaled_w) - flags.crop_x;
+  }
+
+  DALI_ENFORCE(type == DALI_RGB || type == DALI_BGR || type == DALI_GRAY || to_ycbcr,
                "Color space not supported by libjpeg-turbo");
-  flags.color_space = type;
+  flags.color_space = to_ycbcr ? DALI_RGB : type;
 
   std::shared_ptr<uint8_t> decoded_image;
   int cropped_h = 0;
@@ -122,6 +147,9 @@ JpegImage::DecodeImpl(DALIImageType type, const uint8 *jpeg, size_t length) cons
     return GenericImage::DecodeImpl(type, jpeg, length);
   }
 
+  if (to_ycbcr)
+    kernels::color::rgb_to_ycbcr(result, result, static_cast<int64_t>(cropped_h) * cropped_w);
+
   return {decoded_image, {cropped_h, cropped_w, c}};
 #else  // DALI_USE_JPEG_TURBO
   return GenericImage::DecodeImpl(type, jpeg, length);
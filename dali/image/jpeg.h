@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -23,6 +23,13 @@
 
 namespace dali {
 
+/**
+ * @brief Selects the denominator of the DCT scaling factor (1, 2, 4 or 8) for decoding a region
+ *        of `roi_height` x `roi_width` pixels, so that it's decoded at no less than
+ *        `min_height` x `min_width`.
+ */
+DLL_PUBLIC int SelectJpegScaleDenom(int roi_height, int roi_width, int min_height, int min_width);
+
 class JpegImage final : public GenericImage {
  public:
   JpegImage(const uint8_t *encoded_buffer,
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "dali/image/jpeg.h"
 #include "dali/test/dali_test_decoder.h"
 
 namespace dali {
@@ -30,4 +31,38 @@ TYPED_TEST(JpegDecodeTest, DecodeJPEGHost) {
   this->RunTestDecode(this->jpegs_);
 }
 
+TEST(JpegScaleTest, SelectJpegScaleDenom) {
+  EXPECT_EQ(SelectJpegScaleDenom(3000, 4000, 0, 0), 1);
+  EXPECT_EQ(SelectJpegScaleDenom(3000, 4000, 224, 224), 8);
+  EXPECT_EQ(SelectJpegScaleDenom(3000, 4000, 375, 224), 8);
+  EXPECT_EQ(SelectJpegScaleDenom(3000, 4000, 376, 224), 4);
+  EXPECT_EQ(SelectJpegScaleDenom(3000, 4000, 224, 1001), 2);
+  EXPECT_EQ(SelectJpegScaleDenom(3000, 4000, 1501, 224), 1);
+  EXPECT_EQ(SelectJpegScaleDenom(100, 100, 224, 224), 1);
+}
+
+#ifdef DALI_USE_JPEG_TURBO
+TEST(JpegScaleTest, DecodeScaled) {
+  ImgSetDescr jpegs;
+  LoadImages(ImageList(testing::dali_extra_path() + "/db/single/jpeg", {".jpg"}), &jpegs);
+  ASSERT_GT(jpegs.nImages(), 0u);
+  for (size_t i = 0; i < jpegs.nImages(); i++) {
+    auto full = ImageFactory::CreateImage(jpegs.data_[i], jpegs.sizes_[i], DALI_RGB);
+    full->Decode();
+    auto full_shape = full->GetShape();
+
+    const int min_h = full_shape[0] / 4, min_w = full_shape[1] / 4;
+    auto scaled = ImageFactory::CreateImage(jpegs.data_[i], jpegs.sizes_[i], DALI_RGB);
+    scaled->SetMinDecodedSize(min_h, min_w);
+    scaled->Decode();
+    auto shape = scaled->GetShape();
+    int r = SelectJpegScaleDenom(full_shape[0], full_shape[1], min_h, min_w);
+    EXPECT_GE(r, 4);
+    EXPECT_EQ(shape[0], div_ceil(full_shape[0], r));
+    EXPECT_EQ(shape[1], div_ceil(full_shape[1], r));
+    EXPECT_EQ(shape[2], 3);
+  }
+}
+#endif  // DALI_USE_JPEG_TURBO
+
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -50,6 +50,19 @@ struct MelFilterBankArgs {
   /// @brief Determines whether to normalize the filter weights by the width of the mel band
   bool normalize = true;
 
+  /// @brief If true, the output is converted to decibels in the same pass, without storing the
+  ///        intermediate mel spectrogram: `db_multiplier * log10(max(db_min_ratio, x / db_ref))`
+  bool to_decibels = false;
+
+  /// @brief Multiplier of the logarithm, used when `to_decibels` is set
+  float db_multiplier = 10.0f;
+
+  /// @brief Reference magnitude, used when `to_decibels` is set
+  float db_ref = 1.0f;
+
+  /// @brief Minimum ratio `x / db_ref`, used when `to_decibels` is set
+  float db_min_ratio = 1e-20f;
+
   bool operator==(const MelFilterBankArgs &oth) const {
     return sample_rate == oth.sample_rate
         && freq_low  == oth.freq_low
@@ -58,7 +71,11 @@ struct MelFilterBankArgs {
         && axis == oth.axis
         && nfft == oth.nfft
         && mel_formula == oth.mel_formula
-        && normalize == oth.normalize;
+        && normalize == oth.normalize
+        && to_decibels == oth.to_decibels
+        && db_multiplier == oth.db_multiplier
+        && db_ref == oth.db_ref
+        && db_min_ratio == oth.db_min_ratio;
   }
 
   bool operator!=(const MelFilterBankArgs &oth) const {
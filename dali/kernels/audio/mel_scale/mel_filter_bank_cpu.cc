@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -25,6 +25,7 @@
 #include "dali/kernels/common/for_axis.h"
 #include "dali/kernels/common/utils.h"
 #include "dali/kernels/audio/mel_scale/mel_scale.h"
+#include "dali/kernels/signal/decibel/decibel_calculator.h"
 
 namespace dali {
 namespace kernels {
@@ -58,15 +59,6 @@ class MelFilterBankCpu<T>::Impl: public MelFilterImplBase<T> {
         intervals_[fftbin] = interval;
       }
     }
-
-    mel = mel_low_ + mel_delta_;
-    interval_ends_.resize(nfilter + 2);
-    interval_ends_[0] = fftbin_start_;
-    interval_ends_[nfilter + 1] = fftbin_end_ + 1;
-    for (int interval = 1; interval < nfilter + 1; interval++, mel += mel_delta_) {
-      double freq = mel_scale.mel_to_hz(mel);
-      interval_ends_[interval] = std::ceil(freq / hz_step_);
-    }
   }
 
 
@@ -113,29 +105,23 @@ class MelFilterBankCpu<T>::Impl: public MelFilterImplBase<T> {
   /**
    * @brief Applies a mel filter bank to a one-dimensional spectrum input or
    *        individual frames in a time-major layout spectrogram input ("tf").
+   *
+   * Only the support of each filter is visited, with the precomputed (normalized) coefficients.
    */
   void ComputeTimeMajor(T* out, const T* in, int64_t nfilter, int64_t fftbin_size) {
     for (int m = 0; m < nfilter; m++) {
+      const T *band_in = in + interval_ends_[m];
+      const T *coeffs = band_coeffs_.data() + band_offsets_[m];
+      int band_size = band_offsets_[m + 1] - band_offsets_[m];
       T val = 0;
-      int fftbin = interval_ends_[m];
-      int f1 = interval_ends_[m + 1];
-      int f2 = interval_ends_[m + 2];
-      for (; fftbin < f1; ++fftbin) {
-        auto weight_up = T(1) - weights_down_[fftbin];
-        val += in[fftbin] * weight_up;
-      }
-      for (; fftbin < f2; ++fftbin) {
-        val += in[fftbin] * weights_down_[fftbin];
-      }
-      if (args_.normalize)
-        val *= norm_factors_[m];
+      for (int i = 0; i < band_size; i++)
+        val += band_in[i] * coeffs[i];
       *out++ = val;
     }
   }
 
  private:
   std::vector<int> intervals_;
-  std::vector<int> interval_ends_;
   USE_MEL_FILTER_IMPL_MEMBERS(T);
 };
 
@@ -162,18 +148,15 @@ KernelRequirements MelFilterBankCpu<T>::Setup(KernelContext &context,
 
   args.nfft = args.nfft > 0 ? args.nfft : 2 * (in.shape[args.axis] - 1);
   args.freq_high = args.freq_high > 0 ? args.freq_high : args.sample_rate / 2;
-  if (!impl_ || impl_->Args() != args) {
-    impl_.reset();
+  impl_ = GetCachedMelFilterBank(impls_, args, [&]() {
     switch (args.mel_formula) {
       case MelScaleFormula::HTK:
-        impl_ = std::make_unique<Impl>(HtkMelScale<T>(), args);
-        break;
+        return std::make_unique<Impl>(HtkMelScale<T>(), args);
       case MelScaleFormula::Slaney:
       default:
-        impl_ = std::make_unique<Impl>(SlaneyMelScale<T>(), args);
-        break;
+        return std::make_unique<Impl>(SlaneyMelScale<T>(), args);
     }
-  }
+  });
   return req;
 }
 
@@ -234,6 +217,13 @@ void MelFilterBankCpu<T>::Run(KernelContext &context,
                                       f_out_size, f_out_stride, f_in_size, f_in_stride);
             });
   }
+
+  if (args.to_decibels) {
+    signal::MagnitudeToDecibel<T> db(args.db_multiplier, args.db_ref, args.db_min_ratio);
+    int64_t n = volume(out.shape);
+    for (int64_t i = 0; i < n; i++)
+      out.data[i] = db(out.data[i]);
+  }
 }
 
 template class MelFilterBankCpu<float>;
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -160,6 +160,41 @@ INSTANTIATE_TEST_SUITE_P(MelScaleCpuTest, MelScaleCpuTest, testing::Combine(
     testing::Values(0.0f, 1000.0f),  // fmin
     testing::Values(5000.0f, 8000.0f)));  // fmax
 
+TEST(MelScaleCpuTest, AlternatingConfigurations) {
+  using T = float;
+  TensorShape<2> shape{ 7, 1025 };  // time-major
+  std::vector<T> data(volume(shape));
+  OutTensorCPU<T> in_view(data.data(), shape);
+  std::mt19937 rng;
+  UniformRandomFill(in_view, rng, 0.0, 1.0);
+
+  MelFilterBankArgs args;
+  args.axis = 1;
+  args.nfilter = 128;
+  args.normalize = true;
+  float sample_rates[] = { 16000.0f, 22050.0f, 44100.0f, 48000.0f, 8000.0f };
+
+  TensorShape<2> out_shape{ shape[0], args.nfilter };
+  std::vector<T> out(volume(out_shape)), ref(volume(out_shape));
+  OutTensorCPU<T> out_view(out.data(), out_shape), ref_view(ref.data(), out_shape);
+  KernelContext ctx;
+  MelFilterBankCpu<T> kernel;
+  // more configurations than the kernel keeps - some of them are evicted and created again
+  for (int iter = 0; iter < 3; iter++) {
+    for (float sample_rate : sample_rates) {
+      args.sample_rate = sample_rate;
+      args.freq_high = sample_rate / 2;
+      kernel.Setup(ctx, in_view, args);
+      kernel.Run(ctx, out_view, in_view);
+
+      MelFilterBankCpu<T> ref_kernel;
+      ref_kernel.Setup(ctx, in_view, args);
+      ref_kernel.Run(ctx, ref_view, in_view);
+      ASSERT_EQ(out, ref) << "sample rate: " << sample_rate;
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace audio
 }  // namespace kernels
@@ -12,10 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <vector>
+#include <algorithm>
 #include <memory>
+#include <vector>
 #include "dali/kernels/audio/mel_scale/mel_filter_bank_gpu.h"
+#include "dali/core/mm/memory.h"
 #include "dali/core/tensor_shape_print.h"
+#include "dali/kernels/signal/decibel/decibel_calculator.h"
 
 namespace dali {
 namespace kernels {
@@ -40,38 +43,40 @@ struct BlockDesc {
   };
 };
 
+/**
+ * @brief The filter bank in the device memory, in the band-sparse form
+ *
+ * The (normalized) coefficients of the filter m, which spans the FFT bins from
+ * `fftbin_start[m]`, are stored at `coeffs + offsets[m]` up to `coeffs + offsets[m + 1]`.
+ */
+template <typename T>
+struct MelBandsGPU {
+  const int *fftbin_start;
+  const int *offsets;
+  const T *coeffs;
+};
+
 template <typename T>
-__device__ T calcMel(const T* in_frame, int mel_bin,
-                     const T *weights_down, const int *interval_ends,
-                     int fft_stride, int fft_shift,
-                     T norm_factor) {
+__device__ T calcMel(const T* in_frame, int mel_bin, const MelBandsGPU<T> &bands,
+                     int fft_stride, int fft_shift) {
   T out = 0;
-  int fftbin = interval_ends[mel_bin];
-  int fftbin_end = interval_ends[mel_bin + 1];
-  const T *in =  in_frame + fftbin * fft_stride + fft_shift;
-  for (; fftbin < fftbin_end; ++fftbin, in += fft_stride) {
-    auto weight_up = T(1) - weights_down[fftbin];
-    weight_up *= norm_factor;
-    out += *in * weight_up;
-  }
-  fftbin_end = interval_ends[mel_bin + 2];
-  in =  in_frame + fftbin * fft_stride + fft_shift;
-  for (; fftbin < fftbin_end; ++fftbin, in += fft_stride) {
-    auto weight_down = weights_down[fftbin];
-    weight_down *= norm_factor;
-    out += *in * weight_down;
-  }
+  int offset = bands.offsets[mel_bin];
+  int band_size = bands.offsets[mel_bin + 1] - offset;
+  const T *coeffs = bands.coeffs + offset;
+  const T *in = in_frame + bands.fftbin_start[mel_bin] * fft_stride + fft_shift;
+  for (int i = 0; i < band_size; i++, in += fft_stride)
+    out += *in * coeffs[i];
   return out;
 }
 
 // For layouts where the frequency is not the innermost dimension, data is flattened into
 // 3 dimensions - frame, frequency, time
 // Every frame is treated as independent two-dimensional sample
+// If `to_db` is set, the mel energies are converted to decibels before they are stored.
 template <typename T>
-__global__ void MelFilterBankKernel(const BlockDesc<T> *block_desc,
-                                    const T *weights_down, const int *interval_ends,
-                                    bool normalize, const T *norm_factors,
-                                    int mel_bins) {
+__global__ void MelFilterBankKernel(const BlockDesc<T> *block_desc, MelBandsGPU<T> bands,
+                                    int mel_bins, bool to_db,
+                                    signal::MagnitudeToDecibel<T> db) {
   auto block_id = blockIdx.x;
   const T *in_frame = block_desc[block_id].in_frame;
   T *out_frame = block_desc[block_id].out_frame;
@@ -87,19 +92,16 @@ __global__ void MelFilterBankKernel(const BlockDesc<T> *block_desc,
     return;
 
   T *out = out_frame + mel_bin * nwindows + window;
-  T norm_factor = (normalize) ? norm_factors[mel_bin] : 1;
-  *out = calcMel(in_frame, mel_bin,
-                 weights_down, interval_ends,
-                 nwindows, window, norm_factor);
+  T mel = calcMel(in_frame, mel_bin, bands, nwindows, window);
+  *out = to_db ? db(mel) : mel;
 }
 
 // For layouts with the innermost frequency dimension, data is flattened
 // to two dimensions - time, frequency
 template <typename T>
-__global__ void MelFilterBankKernelInnerFft(const BlockDesc<T> *block_desc,
-                                            const T *weights_down, const int *interval_ends,
-                                            bool normalize, const T *norm_factors,
-                                            int mel_bins, int64_t fftdim) {
+__global__ void MelFilterBankKernelInnerFft(const BlockDesc<T> *block_desc, MelBandsGPU<T> bands,
+                                            int mel_bins, int64_t fftdim, bool to_db,
+                                            signal::MagnitudeToDecibel<T> db) {
   auto block_id = blockIdx.x;
   auto idx = block_desc[block_id].block_start + threadIdx.x;
 
@@ -110,9 +112,8 @@ __global__ void MelFilterBankKernelInnerFft(const BlockDesc<T> *block_desc,
   auto mel_bin = idx % mel_bins;
   const T *in = block_desc[block_id].in_frame;
   T *out =  block_desc[block_id].out_frame;
-  T norm_factor = (normalize) ? norm_factors[mel_bin] : 1;
-  *(out + idx) = calcMel(in + window * fftdim, mel_bin,
-                         weights_down, interval_ends, 1, 0, norm_factor);
+  T mel = calcMel(in + window * fftdim, mel_bin, bands, 1, 0);
+  *(out + idx) = to_db ? db(mel) : mel;
 }
 
 template <typename T>
@@ -120,23 +121,9 @@ class MelFilterBankGpu<T>::Impl : public MelFilterImplBase<T> {
  public:
   template <typename MelScale>
   Impl(MelScale mel_scale, const MelFilterBankArgs &args) :
-      MelFilterImplBase<T>(mel_scale, args),
-      interval_ends_(args.nfilter + 2) {
-    double mel = mel_low_ + mel_delta_;
-    interval_ends_[0] = fftbin_start_;
-    interval_ends_[args.nfilter + 1] = fftbin_end_ + 1;
-    for (int interval = 1; interval < args_.nfilter + 1; interval++, mel += mel_delta_) {
-      double freq = mel_scale.mel_to_hz(mel);
-      interval_ends_[interval] = std::ceil(freq / hz_step_);
-    }
-  }
+      MelFilterImplBase<T>(mel_scale, args) {}
 
   void Setup(ScratchpadEstimator &se, const TensorListShape<> &in_shape) {
-    se.add<mm::memory_kind::device, int>(interval_ends_.size());
-    se.add<mm::memory_kind::device, T>(weights_down_.size());
-    if (args_.normalize)
-      se.add<mm::memory_kind::device, T>(norm_factors_.size());
-
     inner_fft_ = true;
     for (int s = 0; s < in_shape.size(); s++) {
       inner_fft_ &= volume(in_shape.tensor_shape_span(s).begin() + args_.axis + 1,
@@ -157,23 +144,19 @@ class MelFilterBankGpu<T>::Impl : public MelFilterImplBase<T> {
     } else {
       FillBlockDescsOuterFft(in_list, out_list);
     }
-    BlockDesc<T> *block_descs = nullptr;
-    int *interval_ends = nullptr;
-    T *weights_down = nullptr, *norm_factors = nullptr;
-    std::tie(block_descs, interval_ends, weights_down, norm_factors) =
-          scratchpad->ToContiguousGPU(stream, block_descs_, interval_ends_,
-                                      weights_down_, norm_factors_);
+    BlockDesc<T> *block_descs = scratchpad->ToGPU(stream, block_descs_);
+    auto bands = UploadBands(stream);
+    signal::MagnitudeToDecibel<T> db(args_.db_multiplier, args_.db_ref, args_.db_min_ratio);
     if (inner_fft_) {
       MelFilterBankKernelInnerFft
           <<<block_descs_.size(), kBlockDim1, 0, stream>>>
-            (block_descs, weights_down, interval_ends, args_.normalize,
-             norm_factors, args_.nfilter, fft_dim_);
+            (block_descs, bands, args_.nfilter, fft_dim_, args_.to_decibels, db);
     } else {
       dim3 block(kBlockDim2, std::min(args_.nfilter, kBlockDim2));
       dim3 grid(block_descs_.size(), div_ceil(args_.nfilter, kBlockDim2));
       MelFilterBankKernel
-        <<<grid, block, 0, stream>>>(block_descs, weights_down, interval_ends,
-                                     args_.normalize, norm_factors, args_.nfilter);
+        <<<grid, block, 0, stream>>>(block_descs, bands, args_.nfilter,
+                                     args_.to_decibels, db);
     }
     CUDA_CALL(cudaGetLastError());
   }
@@ -181,6 +164,32 @@ class MelFilterBankGpu<T>::Impl : public MelFilterImplBase<T> {
   using MelFilterImplBase<T>::Args;
 
  private:
+  /**
+   * @brief Copies the filter bank to the device memory, unless it's already there
+   *
+   * The filter bank depends only on the arguments, so it's uploaded once and reused
+   * in the subsequent iterations.
+   */
+  MelBandsGPU<T> UploadBands(cudaStream_t stream) {
+    if (!coeffs_gpu_ || stream != bands_stream_) {
+      // the old buffers, if any, are released in the stream order of the old stream
+      bands_stream_ = stream;
+      fftbin_start_gpu_ = Upload(make_cspan(interval_ends_), stream);
+      offsets_gpu_ = Upload(make_cspan(band_offsets_), stream);
+      coeffs_gpu_ = Upload(make_cspan(band_coeffs_), stream);
+    }
+    return { fftbin_start_gpu_.get(), offsets_gpu_.get(), coeffs_gpu_.get() };
+  }
+
+  template <typename U>
+  static mm::async_uptr<U> Upload(span<const U> data, cudaStream_t stream) {
+    auto buf = mm::alloc_raw_async_unique<U, mm::memory_kind::device>(
+        std::max<int64_t>(data.size(), 1), stream, stream);
+    CUDA_CALL(cudaMemcpyAsync(buf.get(), data.data(), data.size() * sizeof(U),
+                              cudaMemcpyHostToDevice, stream));
+    return buf;
+  }
+
   void SetupBlockDescsOuterFft(ScratchpadEstimator &se, const TensorListShape<> &in_shape) {
     nframes_.clear();
     nwindows_.clear();
@@ -249,7 +258,9 @@ class MelFilterBankGpu<T>::Impl : public MelFilterImplBase<T> {
     }
   }
 
-  std::vector<int> interval_ends_;
+  mm::async_uptr<int> fftbin_start_gpu_, offsets_gpu_;
+  mm::async_uptr<T> coeffs_gpu_;
+  cudaStream_t bands_stream_ = nullptr;
   std::vector<int64_t> nframes_;
   std::vector<int64_t> nwindows_;
   std::vector<BlockDesc<T>> block_descs_;
@@ -279,18 +290,15 @@ KernelRequirements MelFilterBankGpu<T>::Setup(KernelContext &context,
   ScratchpadEstimator se;
   args.nfft = args.nfft > 0 ? args.nfft : 2 * (in.shape[0][args.axis] - 1);
   args.freq_high = args.freq_high > 0 ? args.freq_high : args.sample_rate / 2;
-  if (!impl_ || impl_->Args() != args) {
-    impl_.reset();
+  impl_ = GetCachedMelFilterBank(impls_, args, [&]() {
     switch (args.mel_formula) {
       case MelScaleFormula::HTK:
-        impl_ = std::make_unique<Impl>(HtkMelScale<T>(), args);
-        break;
+        return std::make_unique<Impl>(HtkMelScale<T>(), args);
       case MelScaleFormula::Slaney:
       default:
-        impl_ = std::make_unique<Impl>(SlaneyMelScale<T>(), args);
-        break;
+        return std::make_unique<Impl>(SlaneyMelScale<T>(), args);
     }
-  }
+  });
   impl_->Setup(se, in.shape);
   req.scratch_sizes = se.sizes;
   return req;
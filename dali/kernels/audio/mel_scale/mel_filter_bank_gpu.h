@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,7 @@
 #define DALI_KERNELS_AUDIO_MEL_SCALE_MEL_FILTER_BANK_GPU_H_
 
 #include <memory>
+#include <vector>
 #include "dali/core/common.h"
 #include "dali/core/host_dev.h"
 #include "dali/kernels/kernel.h"
@@ -44,7 +45,9 @@ class DLL_PUBLIC MelFilterBankGpu {
 
  private:
   class Impl;
-  std::unique_ptr<Impl> impl_;
+  /// The filter banks of the recently used configurations, the most recent first
+  std::vector<std::unique_ptr<Impl>> impls_;
+  Impl *impl_ = nullptr;
 };
 
 }  // namespace audio
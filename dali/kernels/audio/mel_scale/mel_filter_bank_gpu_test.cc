@@ -21,6 +21,7 @@
 #include "dali/kernels/audio/mel_scale/mel_filter_bank_gpu.h"
 #include "dali/kernels/audio/mel_scale/mel_filter_bank_test.h"
 #include "dali/kernels/kernel_manager.h"
+#include "dali/kernels/signal/decibel/decibel_calculator.h"
 
 namespace dali {
 namespace kernels {
@@ -164,6 +165,49 @@ TEST_P(MelScaleGpuTest, MelScaleGpuTest) {
   }
 }
 
+TEST_P(MelScaleGpuTest, ToDecibels) {
+  using T = float;
+  using Kernel = kernels::audio::MelFilterBankGpu<T>;
+  KernelContext ctx;
+  ctx.gpu.stream = 0;
+  kernels::audio::MelFilterBankArgs args;
+  args.axis = axis_;
+  args.nfilter = nfilter_;
+  args.sample_rate = sample_rate_;
+  args.freq_low = freq_low_;
+  args.freq_high = freq_high_;
+
+  // the same kernel with and without the fused conversion to decibels
+  kernels::KernelManager kmgr;
+  kmgr.Resize<Kernel>(2);
+  auto db_args = args;
+  db_args.to_decibels = true;
+  db_args.db_multiplier = 20.0f;
+  db_args.db_ref = 0.5f;
+  db_args.db_min_ratio = 1e-4f;
+  auto in_view = in_.gpu();
+  auto req = kmgr.Setup<Kernel>(0, ctx, in_view, args);
+  kmgr.Setup<Kernel>(1, ctx, in_view, db_args);
+  TestTensorList<float> mel, mel_db;
+  mel.reshape(req.output_shapes[0]);
+  mel_db.reshape(req.output_shapes[0]);
+  auto mel_gpu = mel.gpu();
+  auto mel_db_gpu = mel_db.gpu();
+  kmgr.Run<Kernel>(0, ctx, mel_gpu, in_view);
+  kmgr.Run<Kernel>(1, ctx, mel_db_gpu, in_view);
+  auto mel_cpu = mel.cpu();
+  auto mel_db_cpu = mel_db.cpu();
+  CUDA_CALL(cudaStreamSynchronize(0));
+
+  signal::MagnitudeToDecibel<T> db(20.0f, 0.5f, 1e-4f);
+  for (int b = 0; b < mel_cpu.num_samples(); ++b) {
+    for (int64_t idx = 0; idx < mel_cpu[b].num_elements(); idx++) {
+      ASSERT_NEAR(db(mel_cpu.tensor_data(b)[idx]), mel_db_cpu.tensor_data(b)[idx], 1e-4) <<
+        "Output data doesn't match in sample " << b << " (idx=" << idx << ")";
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(MelScaleGpuTestpuTest, MelScaleGpuTest, testing::Combine(
     testing::Values(std::vector<TensorShape<>>{TensorShape<>{10, 4, 6, 12}},
                     std::vector<TensorShape<>>{TensorShape<>{4, 5, 6, 5},
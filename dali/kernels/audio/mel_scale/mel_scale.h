@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,8 +15,11 @@
 #ifndef DALI_KERNELS_AUDIO_MEL_SCALE_MEL_SCALE_H_
 #define DALI_KERNELS_AUDIO_MEL_SCALE_MEL_SCALE_H_
 
-#include <vector>
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
 #include "dali/core/force_inline.h"
 #include "dali/kernels/audio/mel_scale/mel_filter_bank_args.h"
 
@@ -127,6 +130,31 @@ class MelFilterImplBase {
         weights_down_[fftbin] = (f1 - f) * slope;
       }
     }
+
+    interval_ends_.resize(nfilter + 2);
+    interval_ends_[0] = fftbin_start_;
+    interval_ends_[nfilter + 1] = fftbin_end_ + 1;
+    double mel = mel_low_ + mel_delta_;
+    for (int interval = 1; interval < nfilter + 1; interval++, mel += mel_delta_) {
+      double freq = mel_scale.mel_to_hz(mel);
+      interval_ends_[interval] = std::ceil(freq / hz_step_);
+    }
+
+    // The filter m spans the FFT bins from interval_ends_[m] to interval_ends_[m + 2];
+    // its coefficients, including the normalization, are stored contiguously.
+    band_offsets_.resize(nfilter + 1);
+    band_offsets_[0] = 0;
+    for (int m = 0; m < nfilter; m++)
+      band_offsets_[m + 1] = band_offsets_[m] + (interval_ends_[m + 2] - interval_ends_[m]);
+    band_coeffs_.resize(band_offsets_[nfilter]);
+    for (int m = 0; m < nfilter; m++) {
+      T *coeffs = band_coeffs_.data() + band_offsets_[m];
+      T norm = norm_factors_[m];
+      for (int fftbin = interval_ends_[m]; fftbin < interval_ends_[m + 1]; fftbin++)
+        *coeffs++ = (T(1) - weights_down_[fftbin]) * norm;
+      for (int fftbin = interval_ends_[m + 1]; fftbin < interval_ends_[m + 2]; fftbin++)
+        *coeffs++ = weights_down_[fftbin] * norm;
+    }
   }
 
   const MelFilterBankArgs& Args() const {
@@ -137,6 +165,9 @@ class MelFilterImplBase {
   MelFilterBankArgs args_;
   std::vector<T> weights_down_;
   std::vector<T> norm_factors_;
+  std::vector<int> interval_ends_;
+  std::vector<int> band_offsets_;
+  std::vector<T> band_coeffs_;
   int fftbin_start_ = -1, fftbin_end_ = -1;
   int fftbin_size_;
   double mel_low_, mel_high_;
@@ -152,9 +183,38 @@ class MelFilterImplBase {
   using MelFilterImplBase<T>::fftbin_size_; \
   using MelFilterImplBase<T>::weights_down_; \
   using MelFilterImplBase<T>::norm_factors_; \
+  using MelFilterImplBase<T>::interval_ends_; \
+  using MelFilterImplBase<T>::band_offsets_; \
+  using MelFilterImplBase<T>::band_coeffs_; \
   using MelFilterImplBase<T>::mel_delta_; \
   using MelFilterImplBase<T>::hz_step_
 
+/**
+ * @brief Maximum number of filter bank configurations kept by a mel filter bank kernel
+ */
+constexpr int kMaxCachedMelFilterBanks = 4;
+
+/**
+ * @brief Returns the filter bank for `args` from `cache`, calling `create` if it's not there.
+ *
+ * The most recently used filter bank is kept at the front - when the cache is full,
+ * the least recently used one is evicted.
+ */
+template <typename Impl, typename CreateImpl>
+Impl *GetCachedMelFilterBank(std::vector<std::unique_ptr<Impl>> &cache,
+                             const MelFilterBankArgs &args, CreateImpl &&create) {
+  auto it = std::find_if(cache.begin(), cache.end(),
+                         [&](const std::unique_ptr<Impl> &impl) { return impl->Args() == args; });
+  if (it != cache.end()) {
+    std::rotate(cache.begin(), it, it + 1);
+  } else {
+    if (static_cast<int>(cache.size()) >= kMaxCachedMelFilterBanks)
+      cache.pop_back();
+    cache.insert(cache.begin(), create());
+  }
+  return cache.front().get();
+}
+
 }  // namespace audio
 }  // namespace kernels
 }  // namespace dali
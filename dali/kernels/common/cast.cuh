@@ -68,6 +68,19 @@ __global__ void BinSearchCastKernel(const CastSampleDesc *samples,
   CastKernelInternal<OType, IType>(sample, block_start, block_end);
 }
 
+/**
+ * @brief Casts a flat array - used when the whole batch is densely packed in memory
+ */
+template <typename OType, typename IType>
+__global__ void FlatCastKernel(OType *__restrict__ out, const IType *__restrict__ in,
+                               int64_t size) {
+  int64_t grid_stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+  for (int64_t x = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x; x < size;
+       x += grid_stride) {
+    out[x] = ConvertSat<OType>(in[x]);
+  }
+}
+
 }  // namespace kernels
 }  // namespace dali
 
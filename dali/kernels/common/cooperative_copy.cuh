@@ -0,0 +1,77 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_COMMON_COOPERATIVE_COPY_CUH_
+#define DALI_KERNELS_COMMON_COOPERATIVE_COPY_CUH_
+
+#include <cuda_runtime.h>
+#include <cstdint>
+#include "dali/core/host_dev.h"
+
+namespace dali {
+namespace kernels {
+
+namespace detail {
+
+template <typename Vec>
+__device__ DALI_FORCEINLINE void CooperativeCopyVec(uint8_t *__restrict__ out,
+                                                    const uint8_t *__restrict__ in,
+                                                    uint64_t count, unsigned thread,
+                                                    unsigned num_threads) {
+  uint64_t head = (sizeof(Vec) - reinterpret_cast<uintptr_t>(out) % sizeof(Vec)) % sizeof(Vec);
+  if (head > count)
+    head = count;
+  uint64_t num_vecs = (count - head) / sizeof(Vec);
+  auto *out_vecs = reinterpret_cast<Vec *>(out + head);
+  auto *in_vecs = reinterpret_cast<const Vec *>(in + head);
+  for (uint64_t i = thread; i < num_vecs; i += num_threads)
+    out_vecs[i] = __ldg(in_vecs + i);
+  for (uint64_t i = thread; i < head; i += num_threads)
+    out[i] = in[i];
+  for (uint64_t i = head + num_vecs * sizeof(Vec) + thread; i < count; i += num_threads)
+    out[i] = in[i];
+}
+
+}  // namespace detail
+
+/**
+ * @brief Copies `count` contiguous bytes with `num_threads` cooperating threads
+ *
+ * The bytes are moved with the widest (up to 16 bytes) accesses for which the source
+ * and the destination are equally aligned; the unaligned head and tail are copied byte by byte.
+ *
+ * @param thread index of the calling thread among the cooperating ones
+ */
+__device__ DALI_FORCEINLINE void CooperativeCopy(void *__restrict__ out,
+                                                 const void *__restrict__ in,
+                                                 uint64_t count, unsigned thread,
+                                                 unsigned num_threads) {
+  auto *out_bytes = static_cast<uint8_t *>(out);
+  auto *in_bytes = static_cast<const uint8_t *>(in);
+  // the addresses have the same alignment if the low bits don't differ
+  auto misalignment = reinterpret_cast<uintptr_t>(out) ^ reinterpret_cast<uintptr_t>(in);
+  if (misalignment % sizeof(uint4) == 0)
+    detail::CooperativeCopyVec<uint4>(out_bytes, in_bytes, count, thread, num_threads);
+  else if (misalignment % sizeof(uint2) == 0)
+    detail::CooperativeCopyVec<uint2>(out_bytes, in_bytes, count, thread, num_threads);
+  else if (misalignment % sizeof(uint32_t) == 0)
+    detail::CooperativeCopyVec<uint32_t>(out_bytes, in_bytes, count, thread, num_threads);
+  else
+    detail::CooperativeCopyVec<uint8_t>(out_bytes, in_bytes, count, thread, num_threads);
+}
+
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_COMMON_COOPERATIVE_COPY_CUH_
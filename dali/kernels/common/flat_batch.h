@@ -0,0 +1,86 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_COMMON_FLAT_BATCH_H_
+#define DALI_KERNELS_COMMON_FLAT_BATCH_H_
+
+#include <cstdint>
+#include <vector>
+#include "dali/core/host_dev.h"
+#include "dali/core/tensor_view.h"
+
+namespace dali {
+namespace kernels {
+
+/**
+ * @brief Returns the start of the batch if the samples are stored back-to-back, in order,
+ *        in one buffer; otherwise returns nullptr.
+ *
+ * A densely packed batch can be processed as one flat array, without per-sample block setup.
+ * Empty samples are ignored. A batch without any elements yields nullptr.
+ */
+template <typename Storage, typename T, int ndim>
+T *DenselyPackedData(const TensorListView<Storage, T, ndim> &tlv) {
+  T *start = nullptr, *next = nullptr;
+  for (int i = 0; i < tlv.num_samples(); i++) {
+    int64_t vol = volume(tlv.shape.tensor_shape_span(i));
+    if (vol == 0)
+      continue;
+    if (!start)
+      start = tlv.data[i];
+    else if (tlv.data[i] != next)
+      return nullptr;
+    next = tlv.data[i] + vol;
+  }
+  return start;
+}
+
+/**
+ * @brief Calculates the offsets of the samples in a flattened batch, in units of `item_size`
+ *        elements (e.g. 4 for bounding boxes)
+ *
+ * The result has num_samples + 1 entries; the last one is the total number of items.
+ */
+template <typename Shape>
+void FlatSampleOffsets(std::vector<int64_t> &offsets, const Shape &shape, int64_t item_size = 1) {
+  int N = shape.num_samples();
+  offsets.resize(N + 1);
+  offsets[0] = 0;
+  for (int i = 0; i < N; i++)
+    offsets[i + 1] = offsets[i] + volume(shape.tensor_shape_span(i)) / item_size;
+}
+
+/**
+ * @brief Finds the sample to which the item at `flat_idx` belongs
+ *
+ * @param offsets   sample offsets, as calculated by FlatSampleOffsets
+ * @param nsamples  number of samples; `offsets` has nsamples + 1 entries
+ * @param flat_idx  index of the item in the flattened batch; must be less than offsets[nsamples]
+ */
+DALI_HOST_DEV inline int FlatSampleIdx(const int64_t *offsets, int nsamples, int64_t flat_idx) {
+  int lo = 0, hi = nsamples;  // offsets[lo] <= flat_idx < offsets[hi]
+  while (hi - lo > 1) {
+    int mid = (lo + hi) >> 1;
+    if (offsets[mid] <= flat_idx)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_COMMON_FLAT_BATCH_H_
@@ -0,0 +1,55 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+#include "dali/kernels/common/flat_batch.h"
+
+namespace dali {
+namespace kernels {
+
+TEST(FlatBatch, DenselyPackedData) {
+  std::vector<float> buf(100);
+  TensorListShape<> shape = {{ 3, 4 }, { 0, 4 }, { 5, 4 }, { 1, 4 }};
+  TensorListView<StorageCPU, float> tlv(buf.data(), shape);
+  EXPECT_EQ(DenselyPackedData(tlv), buf.data());
+
+  tlv.data[1] = nullptr;  // empty samples don't matter
+  EXPECT_EQ(DenselyPackedData(tlv), buf.data());
+
+  std::swap(tlv.data[2], tlv.data[3]);
+  EXPECT_EQ(DenselyPackedData(tlv), nullptr);
+  std::swap(tlv.data[2], tlv.data[3]);
+
+  tlv.data[3] += 1;  // a gap between samples
+  EXPECT_EQ(DenselyPackedData(tlv), nullptr);
+
+  TensorListView<StorageCPU, float> empty(buf.data(), TensorListShape<>{{ 0 }, { 0 }});
+  EXPECT_EQ(DenselyPackedData(empty), nullptr);
+}
+
+TEST(FlatBatch, FlatSampleIdx) {
+  TensorListShape<> shape = {{ 3, 4 }, { 0, 4 }, { 5, 4 }, { 0, 4 }, { 1, 4 }};
+  std::vector<int64_t> offsets;
+  FlatSampleOffsets(offsets, shape, 4);
+  EXPECT_EQ(offsets, (std::vector<int64_t>{ 0, 3, 3, 8, 8, 9 }));
+  int N = shape.num_samples();
+  std::vector<int> expected = { 0, 0, 0, 2, 2, 2, 2, 2, 4 };
+  for (int64_t i = 0; i < offsets[N]; i++)
+    EXPECT_EQ(FlatSampleIdx(offsets.data(), N, i), expected[i]) << "at index " << i;
+}
+
+}  // namespace kernels
+}  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -328,6 +328,34 @@ DALI_FORCEINLINE static void store(Out *out, multivec<num_vecs> m) noexcept {
 
 #endif  // __SSE2__
 
+/**
+ * @brief Instruction sets for which some CPU kernels have variants selected at run time
+ */
+enum class CpuIsa : int {
+  Generic = 0,  ///< baseline instruction set of the build (SSE2 on x86-64)
+  AVX2 = 1,     ///< AVX2 with FMA
+  AVX512 = 2,   ///< AVX-512F
+};
+
+/**
+ * @brief Returns the widest instruction set supported by the CPU (and the OS)
+ *
+ * The result is detected once and cached.
+ */
+inline CpuIsa GetCpuIsa() {
+  static const CpuIsa isa = []() {
+#if defined(__x86_64__) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+      return CpuIsa::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return CpuIsa::AVX2;
+#endif
+    return CpuIsa::Generic;
+  }();
+  return isa;
+}
+
 }  // namespace simd
 }  // namespace kernels
 }  // namespace dali
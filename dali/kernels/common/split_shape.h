@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,7 @@
 #define DALI_KERNELS_COMMON_SPLIT_SHAPE_H_
 
 #include <utility>
+#include "dali/core/small_vector.h"
 #include "dali/core/util.h"
 #include "dali/core/tensor_shape.h"
 
@@ -120,6 +121,45 @@ void ForEachBlock(TensorShape<ndim> start, TensorShape<ndim> end, const SplitFac
   }
 }
 
+/**
+ * @brief Divides the shape into blocks (see split_shape) and schedules `func(start, end)` for
+ *        each block as a separate task in the execution engine
+ *
+ * It allows a single large sample to be processed by all the threads of a thread pool.
+ * The work is not started, unless the engine runs it immediately (SequentialExecutionEngine).
+ *
+ * @param engine execution engine, e.g. ThreadPool or SequentialExecutionEngine
+ * @param shape the shape of the iteration space
+ * @param min_nblocks desired minimum number of blocks
+ * @param min_sz minimum practical block size
+ * @param skip_dim_mask bitmask representing the dimensions which should not be split
+ * @param func a function called with the start and end coordinates of a block
+ * @param cost_per_element used to calculate the priority of the tasks
+ * @return the number of blocks scheduled
+ */
+template <int ndim, typename ExecutionEngine, typename OnBlockFunc>
+int ScheduleBlocks(ExecutionEngine &engine, const TensorShape<ndim> &shape, int min_nblocks,
+                   int min_sz, uint64_t skip_dim_mask, OnBlockFunc &&func,
+                   int64_t cost_per_element = 1) {
+  SmallVector<int, 6> split_factor;
+  split_factor.resize(shape.size());
+  int nblocks = split_shape(split_factor, shape, min_nblocks, min_sz, skip_dim_mask);
+
+  TensorShape<ndim> start = shape;
+  for (int d = 0; d < start.size(); d++)
+    start[d] = 0;
+  ForEachBlock(start, shape, split_factor, 0, LastSplitDim(split_factor),
+    [&](const TensorShape<ndim> &blk_start, const TensorShape<ndim> &blk_end) {
+      int64_t blk_vol = 1;
+      for (int d = 0; d < blk_start.size(); d++)
+        blk_vol *= blk_end[d] - blk_start[d];
+      engine.AddWork([func, blk_start, blk_end](int) {
+        func(blk_start, blk_end);
+      }, cost_per_element * blk_vol, false);  // do not start work immediately
+    });
+  return nblocks;
+}
+
 }  // namespace kernels
 }  // namespace dali
 
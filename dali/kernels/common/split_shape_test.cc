@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 #include <vector>
+#include "dali/core/exec/engine.h"
 #include "dali/core/tensor_shape.h"
 #include "dali/kernels/common/split_shape.h"
 
@@ -75,5 +76,24 @@ TEST(split_shape, basic_test) {
   ASSERT_EQ(split_factor[2], 1);
 }
 
+TEST(split_shape, schedule_blocks) {
+  TensorShape<3> sh(10, 12, 10);
+  std::vector<int> visited(volume(sh));
+  SequentialExecutionEngine engine;
+  int nblocks = 0;
+  int scheduled = ScheduleBlocks(engine, sh, 20, 10, 0,
+    [&](const TensorShape<3> &start, const TensorShape<3> &end) {
+      nblocks++;
+      for (int64_t i = start[0]; i < end[0]; i++)
+        for (int64_t j = start[1]; j < end[1]; j++)
+          for (int64_t k = start[2]; k < end[2]; k++)
+            visited[(i * sh[1] + j) * sh[2] + k]++;
+    });
+  EXPECT_EQ(scheduled, 20);  // split factors: 10, 2, 1
+  EXPECT_EQ(nblocks, scheduled);
+  for (auto v : visited)
+    ASSERT_EQ(v, 1);
+}
+
 }  // namespace kernels
 }  // namespace dali
@@ -26,6 +26,7 @@
 #include "dali/core/mm/memory_resource.h"
 #include "dali/core/mm/memory_kind.h"
 #include "dali/core/backend_tags.h"
+#include "dali/kernels/scratch_arena.h"
 
 namespace dali {
 namespace kernels {
@@ -138,7 +139,14 @@ class Scratchpad {
   ToGPU(cudaStream_t stream, const Collection &c) {
     auto n = dali::size(c);
     T *ptr = AllocateGPU<T>(n);
-    CUDA_CALL(cudaMemcpyAsync(ptr, &c[0], n * sizeof(T), cudaMemcpyHostToDevice, stream));
+    const T *src = &c[0];
+    if (ScratchCaptureScope::Current()) {
+      // a captured copy reads the source whenever it's replayed
+      T *staging = AllocatePinned<T>(n);
+      std::copy(src, src + n, staging);
+      src = staging;
+    }
+    CUDA_CALL(cudaMemcpyAsync(ptr, src, n * sizeof(T), cudaMemcpyHostToDevice, stream));
     return ptr;
   }
 
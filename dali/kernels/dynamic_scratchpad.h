@@ -27,6 +27,7 @@
 #include "dali/core/mm/monotonic_resource.h"
 #include "dali/kernels/context.h"
 #include "dali/kernels/kernel_req.h"
+#include "dali/kernels/scratch_arena.h"
 
 namespace dali {
 namespace kernels {
@@ -129,6 +130,11 @@ class DynamicScratchpad
    *                              host-ordered. If not set, device_order is used.
    * @param managed_dealloc_order Deallocation order for managed memory. Allocation is always
    *                              host-ordered. If not set, device_order is used.
+   *
+   * If the calling thread is within a ScratchArenaScope whose arena uses `device_order`,
+   * the device memory is taken from that arena.
+   * If the calling thread is within a ScratchCaptureScope, all the memory is taken from
+   * (and retained by) the capture.
    */
   explicit DynamicScratchpad(scratch_sizes_t initial_sizes = {},
                              AccessOrder device_order = cudaStream_t(0),
@@ -147,6 +153,8 @@ class DynamicScratchpad
     device_order_ = device_order;
     pinned_dealloc_order_ = pinned_dealloc_order;
     managed_dealloc_order_ = managed_dealloc_order;
+    device_arena_ = ScratchArenaScope::Current(device_order);
+    capture_ = ScratchCaptureScope::Current();
   }
 
   virtual void *Alloc(mm::memory_kind_id kind_id, size_t bytes, size_t alignment) {
@@ -193,6 +201,12 @@ class DynamicScratchpad
     if (bytes == 0)
       return nullptr;  // do not initialize the resource in case of 0-sized allocation
 
+    if (capture_)
+      return capture_->allocate<Kind>(bytes, alignment);
+
+    if (std::is_same<Kind, mm::memory_kind::device>::value && device_arena_)
+      return device_arena_->allocate(bytes, alignment);
+
     auto &r = resource<Kind>();
     if (!r.get_upstream()) {
       InitResource(type_tag<Kind>());
@@ -202,6 +216,8 @@ class DynamicScratchpad
   }
 
   AccessOrder device_order_, pinned_dealloc_order_, managed_dealloc_order_;
+  ScratchArena *device_arena_ = nullptr;
+  ScratchCapture *capture_ = nullptr;
 };
 
 }  // namespace kernels
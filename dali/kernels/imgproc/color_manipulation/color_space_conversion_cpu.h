@@ -0,0 +1,185 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_IMGPROC_COLOR_MANIPULATION_COLOR_SPACE_CONVERSION_CPU_H_
+#define DALI_KERNELS_IMGPROC_COLOR_MANIPULATION_COLOR_SPACE_CONVERSION_CPU_H_
+
+#include <cstdint>
+#include "dali/core/force_inline.h"
+#include "dali/kernels/common/simd.h"
+#include "dali/kernels/imgproc/color_manipulation/color_space_conversion_impl.h"
+
+namespace dali {
+namespace kernels {
+namespace color {
+
+/**
+ * Vectorized conversions of interleaved, 8-bit images between RGB (or BGR) and
+ * ITU-R BT.601 YCbCr.
+ *
+ * The results are identical to the ones of the per-pixel itu_r_bt_601 functions. The pixels are
+ * processed in blocks, which are read before being written, so the conversions can be done
+ * in place.
+ */
+
+namespace detail {
+
+#ifdef __SSE2__
+
+static constexpr int kColorBlock = 16;  // pixels
+using color_vec = simd::multivec<kColorBlock / 4>;
+
+/**
+ * @brief Clamps the values to [0, 255] and rounds them half away from zero, like std::round
+ *
+ * _mm_cvtps_epi32 rounds half to even, which would differ from the scalar conversion.
+ */
+DALI_FORCEINLINE __m128i round_u8(__m128 x) {
+  x = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+  __m128i i = _mm_cvttps_epi32(x);
+  __m128 frac = _mm_sub_ps(x, _mm_cvtepi32_ps(i));  // exact
+  __m128i round_up = _mm_castps_si128(_mm_cmpge_ps(frac, _mm_set1_ps(0.5f)));
+  return _mm_sub_epi32(i, round_up);  // the mask is -1 in the lanes to be rounded up
+}
+
+DALI_FORCEINLINE void store_u8(uint8_t *out, const color_vec &v) {
+  simd::i128x4 iv;
+  for (int i = 0; i < 4; i++)
+    iv.v[i] = round_u8(v.v[i]);
+  simd::store_i32(out, iv);
+}
+
+/**
+ * @brief Computes dot(coeffs, {a, b, c}) + offset, with the same order of operations as
+ *        the scalar code
+ */
+DALI_FORCEINLINE __m128 dot3(__m128 a, __m128 b, __m128 c, float ca, float cb, float cc,
+                             float offset) {
+  __m128 ret = _mm_mul_ps(_mm_set1_ps(ca), a);
+  ret = _mm_add_ps(ret, _mm_mul_ps(_mm_set1_ps(cb), b));
+  ret = _mm_add_ps(ret, _mm_mul_ps(_mm_set1_ps(cc), c));
+  return _mm_add_ps(ret, _mm_set1_ps(offset));
+}
+
+template <bool bgr>
+inline void rgb_to_ycbcr_block(uint8_t *out, const uint8_t *in) {
+  alignas(16) uint8_t planes[3][kColorBlock];
+  for (int i = 0; i < kColorBlock; i++) {
+    planes[0][i] = in[3 * i + (bgr ? 2 : 0)];
+    planes[1][i] = in[3 * i + 1];
+    planes[2][i] = in[3 * i + (bgr ? 0 : 2)];
+  }
+  color_vec r = color_vec::load(planes[0]);
+  color_vec g = color_vec::load(planes[1]);
+  color_vec b = color_vec::load(planes[2]);
+  color_vec y, cb, cr;
+  const __m128 half_range = _mm_set1_ps(128.0f);
+  for (int i = 0; i < 4; i++) {
+    y.v[i] = dot3(r.v[i], g.v[i], b.v[i], 0.257f, 0.504f, 0.098f, 16.0f);
+    // gray pixels have the chroma of exactly 128
+    __m128 gray = _mm_and_ps(_mm_cmpeq_ps(r.v[i], g.v[i]), _mm_cmpeq_ps(r.v[i], b.v[i]));
+    cb.v[i] = dot3(r.v[i], g.v[i], b.v[i], -0.148f, -0.291f, 0.439f, 128.0f);
+    cb.v[i] = _mm_or_ps(_mm_and_ps(gray, half_range), _mm_andnot_ps(gray, cb.v[i]));
+    cr.v[i] = dot3(r.v[i], g.v[i], b.v[i], 0.439f, -0.368f, -0.071f, 128.0f);
+    cr.v[i] = _mm_or_ps(_mm_and_ps(gray, half_range), _mm_andnot_ps(gray, cr.v[i]));
+  }
+  store_u8(planes[0], y);
+  store_u8(planes[1], cb);
+  store_u8(planes[2], cr);
+  for (int i = 0; i < kColorBlock; i++) {
+    out[3 * i] = planes[0][i];
+    out[3 * i + 1] = planes[1][i];
+    out[3 * i + 2] = planes[2][i];
+  }
+}
+
+template <bool bgr>
+inline void ycbcr_to_rgb_block(uint8_t *out, const uint8_t *in) {
+  alignas(16) uint8_t planes[3][kColorBlock];
+  for (int i = 0; i < kColorBlock; i++) {
+    planes[0][i] = in[3 * i];
+    planes[1][i] = in[3 * i + 1];
+    planes[2][i] = in[3 * i + 2];
+  }
+  color_vec y = color_vec::load(planes[0]);
+  color_vec cb = color_vec::load(planes[1]);
+  color_vec cr = color_vec::load(planes[2]);
+  color_vec r, g, b;
+  for (int i = 0; i < 4; i++) {
+    __m128 tmp_y = _mm_mul_ps(_mm_set1_ps(1.164f), _mm_sub_ps(y.v[i], _mm_set1_ps(16.0f)));
+    __m128 tmp_b = _mm_sub_ps(cb.v[i], _mm_set1_ps(128.0f));
+    __m128 tmp_r = _mm_sub_ps(cr.v[i], _mm_set1_ps(128.0f));
+    r.v[i] = _mm_add_ps(tmp_y, _mm_mul_ps(_mm_set1_ps(1.596f), tmp_r));
+    g.v[i] = _mm_sub_ps(_mm_sub_ps(tmp_y, _mm_mul_ps(_mm_set1_ps(0.813f), tmp_r)),
+                        _mm_mul_ps(_mm_set1_ps(0.392f), tmp_b));
+    b.v[i] = _mm_add_ps(tmp_y, _mm_mul_ps(_mm_set1_ps(2.017f), tmp_b));
+  }
+  store_u8(planes[0], bgr ? b : r);
+  store_u8(planes[1], g);
+  store_u8(planes[2], bgr ? r : b);
+  for (int i = 0; i < kColorBlock; i++) {
+    out[3 * i] = planes[0][i];
+    out[3 * i + 1] = planes[1][i];
+    out[3 * i + 2] = planes[2][i];
+  }
+}
+
+#endif  // __SSE2__
+
+}  // namespace detail
+
+/**
+ * @brief Converts interleaved RGB (or BGR, if `bgr` is true) pixels to ITU-R BT.601 YCbCr
+ */
+template <bool bgr = false>
+void rgb_to_ycbcr(uint8_t *out, const uint8_t *in, int64_t npixels) {
+  int64_t i = 0;
+#ifdef __SSE2__
+  for (; i + detail::kColorBlock <= npixels; i += detail::kColorBlock)
+    detail::rgb_to_ycbcr_block<bgr>(out + 3 * i, in + 3 * i);
+#endif
+  for (; i < npixels; i++) {
+    const uint8_t *px = in + 3 * i;
+    vec<3, uint8_t> rgb = bgr ? vec<3, uint8_t>{px[2], px[1], px[0]}
+                              : vec<3, uint8_t>{px[0], px[1], px[2]};
+    out[3 * i] = itu_r_bt_601::rgb_to_y<uint8_t>(rgb);
+    out[3 * i + 1] = itu_r_bt_601::rgb_to_cb<uint8_t>(rgb);
+    out[3 * i + 2] = itu_r_bt_601::rgb_to_cr<uint8_t>(rgb);
+  }
+}
+
+/**
+ * @brief Converts interleaved ITU-R BT.601 YCbCr pixels to RGB (or BGR, if `bgr` is true)
+ */
+template <bool bgr = false>
+void ycbcr_to_rgb(uint8_t *out, const uint8_t *in, int64_t npixels) {
+  int64_t i = 0;
+#ifdef __SSE2__
+  for (; i + detail::kColorBlock <= npixels; i += detail::kColorBlock)
+    detail::ycbcr_to_rgb_block<bgr>(out + 3 * i, in + 3 * i);
+#endif
+  for (; i < npixels; i++) {
+    const uint8_t *px = in + 3 * i;
+    auto rgb = itu_r_bt_601::ycbcr_to_rgb<uint8_t>(vec<3, uint8_t>{px[0], px[1], px[2]});
+    out[3 * i] = bgr ? rgb[2] : rgb[0];
+    out[3 * i + 1] = rgb[1];
+    out[3 * i + 2] = bgr ? rgb[0] : rgb[2];
+  }
+}
+
+}  // namespace color
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_IMGPROC_COLOR_MANIPULATION_COLOR_SPACE_CONVERSION_CPU_H_
@@ -0,0 +1,93 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "dali/kernels/imgproc/color_manipulation/color_space_conversion_cpu.h"
+
+namespace dali {
+namespace kernels {
+namespace color {
+
+namespace {
+
+std::vector<uint8_t> RandomPixels(int64_t npixels) {
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<uint8_t> data(npixels * 3);
+  for (int64_t i = 0; i < npixels; i++) {
+    if (i % 7 == 0) {  // gray pixels are a special case for the chroma
+      data[3 * i] = data[3 * i + 1] = data[3 * i + 2] = dist(rng);
+    } else {
+      for (int c = 0; c < 3; c++)
+        data[3 * i + c] = dist(rng);
+    }
+  }
+  return data;
+}
+
+}  // namespace
+
+TEST(ColorSpaceConversionCpuTest, RgbToYCbCr) {
+  const int64_t npixels = 1000 * 16 + 5;  // with a tail, not handled by the vectorized loop
+  auto in = RandomPixels(npixels);
+  std::vector<uint8_t> out(in.size()), out_bgr(in.size());
+  rgb_to_ycbcr<false>(out.data(), in.data(), npixels);
+  rgb_to_ycbcr<true>(out_bgr.data(), in.data(), npixels);
+  for (int64_t i = 0; i < npixels; i++) {
+    const uint8_t *px = &in[3 * i];
+    vec<3, uint8_t> rgb{px[0], px[1], px[2]};
+    ASSERT_EQ(out[3 * i], itu_r_bt_601::rgb_to_y<uint8_t>(rgb)) << "pixel " << i;
+    ASSERT_EQ(out[3 * i + 1], itu_r_bt_601::rgb_to_cb<uint8_t>(rgb)) << "pixel " << i;
+    ASSERT_EQ(out[3 * i + 2], itu_r_bt_601::rgb_to_cr<uint8_t>(rgb)) << "pixel " << i;
+    vec<3, uint8_t> bgr{px[2], px[1], px[0]};
+    ASSERT_EQ(out_bgr[3 * i], itu_r_bt_601::rgb_to_y<uint8_t>(bgr)) << "pixel " << i;
+    ASSERT_EQ(out_bgr[3 * i + 1], itu_r_bt_601::rgb_to_cb<uint8_t>(bgr)) << "pixel " << i;
+    ASSERT_EQ(out_bgr[3 * i + 2], itu_r_bt_601::rgb_to_cr<uint8_t>(bgr)) << "pixel " << i;
+  }
+}
+
+TEST(ColorSpaceConversionCpuTest, YCbCrToRgb) {
+  const int64_t npixels = 1000 * 16 + 11;
+  auto in = RandomPixels(npixels);
+  std::vector<uint8_t> out(in.size()), out_bgr(in.size());
+  ycbcr_to_rgb<false>(out.data(), in.data(), npixels);
+  ycbcr_to_rgb<true>(out_bgr.data(), in.data(), npixels);
+  for (int64_t i = 0; i < npixels; i++) {
+    const uint8_t *px = &in[3 * i];
+    auto rgb = itu_r_bt_601::ycbcr_to_rgb<uint8_t>(vec<3, uint8_t>{px[0], px[1], px[2]});
+    for (int c = 0; c < 3; c++) {
+      ASSERT_EQ(out[3 * i + c], rgb[c]) << "pixel " << i;
+      ASSERT_EQ(out_bgr[3 * i + c], rgb[2 - c]) << "pixel " << i;
+    }
+  }
+}
+
+TEST(ColorSpaceConversionCpuTest, InPlace) {
+  const int64_t npixels = 100 * 16 + 3;
+  auto in = RandomPixels(npixels);
+  std::vector<uint8_t> expected(in.size());
+  rgb_to_ycbcr<true>(expected.data(), in.data(), npixels);
+  rgb_to_ycbcr<true>(in.data(), in.data(), npixels);
+  EXPECT_EQ(in, expected);
+
+  ycbcr_to_rgb(expected.data(), in.data(), npixels);
+  ycbcr_to_rgb(in.data(), in.data(), npixels);
+  EXPECT_EQ(in, expected);
+}
+
+}  // namespace color
+}  // namespace kernels
+}  // namespace dali
@@ -15,9 +15,14 @@
 #ifndef DALI_KERNELS_IMGPROC_CONVOLUTION_CONVOLUTION_GPU_H_
 #define DALI_KERNELS_IMGPROC_CONVOLUTION_CONVOLUTION_GPU_H_
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
 #include "dali/core/boundary.h"
 #include "dali/core/convert.h"
+#include "dali/core/cuda_error.h"
 #include "dali/core/format.h"
+#include "dali/core/mm/memory.h"
 #include "dali/core/span.h"
 #include "dali/core/tensor_view.h"
 #include "dali/kernels/common/utils.h"
@@ -103,8 +108,8 @@ struct ConvolutionGpu {
                    make_string("Window is too big for sample ", i, ", got: ", window_size[i][0],
                                ", expected at most: ", kMaxWindowSize / num_channels, "."));
     }
+    // The device copy of the windows is kept by the kernel (see DeviceWindows)
     se.add<mm::memory_kind::host, W>(num_samples * kWindowCopyBufferSize);
-    se.add<mm::memory_kind::device, W>(num_samples * kWindowCopyBufferSize);
     se.add<mm::memory_kind::device, typename CutlassConv::SampleParams>(num_samples);
     req.scratch_sizes = se.sizes;
     req.output_shapes.push_back(in_shape);
@@ -134,11 +139,14 @@ struct ConvolutionGpu {
     auto* window_tmp_buffer_host_ptr =
         ctx.scratchpad->AllocateHost<W>(num_samples * kWindowCopyBufferSize);
     span<W> window_tmp_buffer_host(window_tmp_buffer_host_ptr, num_samples * kWindowCopyBufferSize);
+    // the whole buffer is compared with the uploaded copy - the padding must not contain
+    // leftovers from the previous uses of the scratch memory
+    std::fill(window_tmp_buffer_host.begin(), window_tmp_buffer_host.end(), W());
 
-    // Pad and align windows in tmp memory, transfer the aligned windows to GPU
+    // Pad and align windows in tmp memory, transfer the aligned windows to GPU - unless
+    // they're the same as in the previous run (e.g. the same Gaussian sigma)
     FillAlignedWindows(window_tmp_buffer_host, windows, in.shape);
-    // ToGPU allocates num_samples * kWindowCopyBufferSize * sizeof(W) memory through scratchpad
-    auto* window_tmp_buffer_gpu = ctx.scratchpad->ToGPU(ctx.gpu.stream, window_tmp_buffer_host);
+    auto* window_tmp_buffer_gpu = gpu_windows_.Upload(window_tmp_buffer_host, ctx.gpu.stream);
 
     Arguments args;
     args.device_params_ptr =
@@ -280,6 +288,38 @@ struct ConvolutionGpu {
 
   using Arguments = typename CutlassConv::Arguments;
 
+  /**
+   * @brief The device copy of the padded windows, kept across runs
+   *
+   * The buffer is used only in one stream - that's what makes it safe to overwrite it
+   * in subsequent runs.
+   */
+  struct DeviceWindows {
+    mm::async_uptr<W> data;
+    size_t capacity = 0;
+    /// @brief The host copy of the contents of `data`
+    std::vector<W> uploaded;
+    cudaStream_t stream = 0;
+
+    W* Upload(span<const W> windows, cudaStream_t new_stream) {
+      if (new_stream != stream)
+        *this = {};  // the old buffer is released in the stream order of the old stream
+      stream = new_stream;
+      size_t count = windows.size();
+      if (uploaded.size() == count && count > 0 &&
+          !memcmp(uploaded.data(), windows.data(), count * sizeof(W)))
+        return data.get();
+      if (count > capacity) {
+        capacity = std::max(count, 2 * capacity);
+        data = mm::alloc_raw_async_unique<W, mm::memory_kind::device>(capacity, stream, stream);
+      }
+      CUDA_CALL(cudaMemcpyAsync(data.get(), windows.data(), count * sizeof(W),
+                                cudaMemcpyHostToDevice, stream));
+      uploaded.assign(windows.begin(), windows.end());
+      return data.get();
+    }
+  } gpu_windows_;
+
   using SampleArguments = typename CutlassConv::SampleArguments;
 
   static_assert(0 <= axis && axis <= kLastSpatialDim,
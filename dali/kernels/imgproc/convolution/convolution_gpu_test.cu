@@ -156,7 +156,11 @@ struct ConvolutionGpuKernelTest : public ::testing::Test {
     baseline_output_.reshape(GetShape());
   }
 
-  void RunTest() {
+  /**
+   * @param stale_windows If true, the GPU kernel is first run with different windows, so that
+   *                      the windows it keeps on the GPU need to be replaced
+   */
+  void RunTest(bool stale_windows = false) {
     KernelContext ctx_cpu, ctx_gpu;
     ctx_gpu.gpu.stream = 0;
     KernelCpu kernel_cpu;
@@ -165,6 +169,26 @@ struct ConvolutionGpuKernelTest : public ::testing::Test {
     auto data_shape = GetShape();
     int num_samples = data_shape.size();
 
+    if (stale_windows) {
+      TestTensorList<WinType, 1> other_window;
+      TestTensorList<OutType, T::ndim> other_output;
+      other_window.reshape(shape_window);
+      other_output.reshape(GetShape());
+      auto other_win = other_window.cpu();
+      for (int sample = 0; sample < num_samples; sample++) {
+        for (int i = 0; i < shape_window[sample][0]; i++)
+          other_win[sample].data[i] = 1;
+      }
+      auto req = kernel_gpu.Setup(ctx_gpu, in_.shape, shape_window);
+      ScratchpadAllocator scratch_alloc;
+      scratch_alloc.Reserve(req.scratch_sizes);
+      auto scratchpad = scratch_alloc.GetScratchpad();
+      ctx_gpu.scratchpad = &scratchpad;
+      kernel_gpu.Run(ctx_gpu, other_output.gpu(), in_, other_win);
+      CUDA_CALL(cudaStreamSynchronize(ctx_gpu.gpu.stream));
+      ctx_gpu.scratchpad = nullptr;
+    }
+
     TransformCase transform(num_samples);
     baseline_out_ = baseline_output_.cpu();
     transform.FillOut(baseline_out_);
@@ -284,7 +308,11 @@ TYPED_TEST_P(ConvolutionGpuKernelTest, DoConvolution) {
   this->RunTest();
 }
 
-REGISTER_TYPED_TEST_SUITE_P(ConvolutionGpuKernelTest, DoConvolution);
+TYPED_TEST_P(ConvolutionGpuKernelTest, ChangedWindows) {
+  this->RunTest(true);
+}
+
+REGISTER_TYPED_TEST_SUITE_P(ConvolutionGpuKernelTest, DoConvolution, ChangedWindows);
 INSTANTIATE_TYPED_TEST_SUITE_P(ConvolutionGpuKernel, ConvolutionGpuKernelTest,
                                ConvolutionTestValues);
 
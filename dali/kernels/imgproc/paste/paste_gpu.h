@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -12,233 +12,114 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-// THIS WHOLE CODE IS A COPY-PASTE OF multiply-add kernel
-
 #ifndef DALI_KERNELS_IMGPROC_PASTE_PASTE_GPU_H_
 #define DALI_KERNELS_IMGPROC_PASTE_PASTE_GPU_H_
 
 #include <vector>
-#include <unordered_set>
-#include <set>
-#include <map>
 #include <tuple>
 #include "dali/core/span.h"
 #include "dali/core/convert.h"
-#include "dali/core/geom/box.h"
+#include "dali/core/cuda_utils.h"
+#include "dali/core/geom/vec.h"
 #include "dali/kernels/kernel.h"
-#include "dali/kernels/imgproc/roi.h"
-#include "dali/kernels/common/block_setup.h"
+#include "dali/kernels/common/flat_batch.h"
 #include "dali/kernels/imgproc/paste/paste_gpu_input.h"
 
 namespace dali {
 namespace kernels {
 namespace paste {
 
-template<class InputType, int ndims>
-struct PatchDesc {
+/**
+ * @brief A pasted region, in the output coordinates with the channels merged with the width
+ */
+template <class InputType, int ndims>
+struct PasteRegion {
   const InputType *in;
   int in_sample_idx;
-  ivec<ndims> patch_start, patch_end, in_anchor, in_pitch;
+  ivec<ndims> out_start, out_end, in_anchor;
+  int in_pitch;
 };
 
-template <class OutputType, class InputType, int ndims>
-struct SampleDescriptorGPU {
+template <class OutputType, int ndims>
+struct PasteSampleDesc {
   OutputType *out;
-  int patch_start_idx;
-  ivec<ndims> patch_counts, out_pitch;
+  ivec<ndims> size;  // height, width * channels
+  int tiles_x;
+  int region_start, num_regions;
 };
 
-// Could not fill this in Setup - there are no pointers yet
-template <class OutputType, class InputType, int ndims>
-void FillPointers(span<SampleDescriptorGPU<OutputType, InputType, ndims - 1>> descs,
-                  span<PatchDesc<InputType, ndims - 1>> patches,
-                  const OutListGPU<OutputType, ndims> &out,
-                  const InListGPU<InputType, ndims> &in) {
-  int batch_size = descs.size();
-
-  for (int i = 0; i < batch_size; i++) {
-    descs[i].out = out.data[i];
-  }
-
-  for (auto &p : patches) {
-    p.in = p.in_sample_idx < 0 ? nullptr : in.data[p.in_sample_idx];
-  }
-}
+// The output is processed in tiles of kTileHeight rows by kTileWidth elements (not pixels)
+static constexpr int kTileHeight = 16;
+static constexpr int kTileWidth = 128;
+static constexpr int kBlockWidth = 64;
+static constexpr int kBlockHeight = 4;
+// The number of regions (overlapping a tile) cached in shared memory
+static constexpr int kMaxTileRegions = 128;
 
 /**
- * Note: Since the operation we perform is channel-agnostic (it is performed in the same
- * way for every channel), SampleDescriptor assumes, that sample is channel-agnostic. Therefore it
- * needs to be flattened
- * @see FlattenChannels
+ * @brief Pastes the regions to a batch of outputs; each CUDA block fills one tile
+ *
+ * There's no per-block setup: the tile of a block is found in `first_tile`, the prefix sum of
+ * the number of tiles of each sample (nsamples + 1 entries). The first warp gathers the regions
+ * overlapping the tile, in their original order, to the shared memory; then each output element
+ * takes its value from the last (top-most) of them which contains it, or is zeroed, if there's
+ * none.
  */
-template <class OutputType, class InputType, int ndims>
-void CreateSampleDescriptors(
-    vector<SampleDescriptorGPU<OutputType, InputType, ndims - 1>> &out_descs,
-    vector<PatchDesc<InputType, ndims - 1>> &out_patches,
-    const TensorListShape<ndims> &in_shape,
-    span<paste::MultiPasteSampleInput<ndims - 1>> samples) {
-  static_assert(ndims == 3, "Only 2D data with channels supported");
-
-  int batch_size = samples.size();
-
-  out_descs.resize(batch_size);
-  out_patches.clear();
-
-  for (int out_idx = 0; out_idx < batch_size; out_idx++) {
-    const auto &sample = samples[out_idx];
-      const int channels = sample.channels;
-      int n = sample.inputs.size();
-
-      // Get all significant points on x and y axis
-      // Those will be the starts and ends of the patches
-      int NO_DATA = 0;
-      std::map<int, int> x_points;
-      std::map<int, int> y_points;
-      x_points[0] = NO_DATA;
-      x_points[sample.out_size[1]] = NO_DATA;
-      y_points[0] = NO_DATA;
-      y_points[sample.out_size[0]] = NO_DATA;
-
-      for (int i = 0; i < n; i++) {
-        x_points[sample.inputs[i].out_anchor[1]] = NO_DATA;
-        x_points[sample.inputs[i].out_anchor[1] + sample.inputs[i].size[1]] = NO_DATA;
-        y_points[sample.inputs[i].out_anchor[0]] = NO_DATA;
-        y_points[sample.inputs[i].out_anchor[0] + sample.inputs[i].size[0]] = NO_DATA;
-      }
-
-      // When we know how many of those points there are, we know how big our patch patch is
-      int x_patch_cnt = static_cast<int>(x_points.size()) - 1;
-      int y_patch_cnt = static_cast<int>(y_points.size()) - 1;
-
-      // Now lets fill forward and backward mapping of those significant points to patch indices
-      vector<int> scaled_x_to_x;
-      for (auto &x_point : x_points) {
-        x_point.second = scaled_x_to_x.size();
-        scaled_x_to_x.push_back(x_point.first);
-      }
-      vector<int> scaled_y_to_y;
-      for (auto &y_point : y_points) {
-        y_point.second = scaled_y_to_y.size();
-        scaled_y_to_y.push_back(y_point.first);
-      }
-
-      // We create events that will fire when sweeping
-      vector<vector<std::tuple<int, int, int>>> y_starting(y_patch_cnt + 1);
-      vector<vector<std::tuple<int, int, int>>> y_ending(y_patch_cnt + 1);
-      for (int i = 0; i < n; i++) {
-        y_starting[y_points[sample.inputs[i].out_anchor[0]]].emplace_back(
-                i, x_points[sample.inputs[i].out_anchor[1]],
-                x_points[sample.inputs[i].out_anchor[1] + sample.inputs[i].size[1]]);
-        y_ending[y_points[sample.inputs[i].out_anchor[0] + sample.inputs[i].size[0]]].emplace_back(
-                i, x_points[sample.inputs[i].out_anchor[1]],
-                x_points[sample.inputs[i].out_anchor[1] + sample.inputs[i].size[1]]);
-      }
-      y_starting[0].emplace_back(-1, 0, x_patch_cnt);
-      y_ending[y_patch_cnt].emplace_back(-1, 0, x_patch_cnt);
-
-      // Filling sample
-      int prev_patch_count = out_patches.size();
-      auto &out_sample = out_descs[out_idx];
-      out_sample.patch_start_idx = prev_patch_count;
-      out_sample.patch_counts[1] = x_patch_cnt;
-      out_sample.patch_counts[0] = y_patch_cnt;
-      out_sample.out_pitch[1] = sample.out_size[1] * channels;
-
-      // And now the sweeping itself
-      out_patches.resize(prev_patch_count + x_patch_cnt * y_patch_cnt);
-      vector<std::unordered_set<int>> starting(x_patch_cnt + 1);
-      vector<std::unordered_set<int>> ending(x_patch_cnt + 1);
-      std::set<int> open_pastes;
-      for (int y = 0; y < y_patch_cnt; y++) {
-        // Add open and close events on x axis for regions with given y start coordinate
-        for (auto &i : y_starting[y]) {
-          starting[std::get<1>(i)].insert(std::get<0>(i));
-          ending[std::get<2>(i)].insert(std::get<0>(i));
-        }
-        // Now sweep through x
-        for (int x = 0; x < x_patch_cnt; x++) {
-          // Open regions starting here
-          for (int i : starting[x]) {
-            open_pastes.insert(i);
-          }
-
-          // Take top most region
-          int max_paste = *(--open_pastes.end());
-          auto& patch = out_patches[prev_patch_count + y * x_patch_cnt + x];
-
-
-          // And fill the patch
-          patch.patch_start[0] = scaled_y_to_y[y];
-          patch.patch_start[1] = scaled_x_to_x[x];
-          patch.patch_end[0] = scaled_y_to_y[y + 1];
-          patch.patch_end[1] = scaled_x_to_x[x + 1];
-          patch.in = nullptr;  // to be filled later
-          patch.in_sample_idx = max_paste == -1 ? -1 : sample.inputs[max_paste].in_idx;
-          patch.in_pitch[0] = 0;
-          patch.in_pitch[1] = max_paste == -1 ? -1 : in_shape[sample.inputs[max_paste].in_idx][1];
-
-          if (max_paste != -1) {
-            patch.in_anchor[0] = sample.inputs[max_paste].in_anchor[0] +
-                              patch.patch_start[0] - sample.inputs[max_paste].out_anchor[0];
-            patch.in_anchor[1] = sample.inputs[max_paste].in_anchor[1] +
-                              patch.patch_start[1] - sample.inputs[max_paste].out_anchor[1];
-          }
-          patch.patch_start[1] *= channels;
-          patch.patch_end[1] *= channels;
-          patch.in_pitch[1] *= channels;
-          patch.in_anchor[1] *= channels;
-
-          // Now remove regions that end here
-          for (int i : ending[x + 1]) {
-            open_pastes.erase(i);
-          }
-        }
-        // And remove start/events for regions whose y ends here
-        for (auto &i : y_ending[y + 1]) {
-          starting[std::get<1>(i)].erase(std::get<0>(i));
-          ending[std::get<2>(i)].erase(std::get<0>(i));
-        }
+template <class OutputType, class InputType>
+__global__ void PasteKernel(const PasteSampleDesc<OutputType, 2> *samples,
+                            const PasteRegion<InputType, 2> *regions,
+                            const int64_t *first_tile, int nsamples) {
+  __shared__ PasteRegion<InputType, 2> tile_regions[kMaxTileRegions];
+  __shared__ int tile_region_count;
+
+  int sample_idx = FlatSampleIdx(first_tile, nsamples, blockIdx.x);
+  const auto &sample = samples[sample_idx];
+  int tile = blockIdx.x - first_tile[sample_idx];
+  ivec2 tile_start(tile / sample.tiles_x * kTileHeight, tile % sample.tiles_x * kTileWidth);
+  ivec2 tile_end(cuda_min(tile_start[0] + kTileHeight, sample.size[0]),
+                 cuda_min(tile_start[1] + kTileWidth, sample.size[1]));
+  const auto *sample_regions = regions + sample.region_start;
+
+  if (threadIdx.y == 0 && threadIdx.x < 32) {
+    int count = 0;
+    for (int base = 0; base < sample.num_regions; base += 32) {
+      int i = base + threadIdx.x;
+      bool overlaps = false;
+      if (i < sample.num_regions) {
+        const auto &r = sample_regions[i];
+        overlaps = r.out_start[0] < tile_end[0] && r.out_end[0] > tile_start[0] &&
+                   r.out_start[1] < tile_end[1] && r.out_end[1] > tile_start[1];
       }
+      unsigned mask = __ballot_sync(0xffffffffu, overlaps);
+      int pos = count + __popc(mask & ((1u << threadIdx.x) - 1));
+      if (overlaps && pos < kMaxTileRegions)
+        tile_regions[pos] = sample_regions[i];
+      count += __popc(mask);
+    }
+    if (threadIdx.x == 0)
+      tile_region_count = count;
   }
-}
-
-
-
-template <class OutputType, class InputType, int ndims>
-__global__ void
-PasteKernel(const SampleDescriptorGPU<OutputType, InputType, ndims> *samples,
-            const PatchDesc<InputType, ndims> *patches,
-            const BlockDesc<ndims> *blocks) {
-  static_assert(ndims == 2, "Function requires 2 dimensions in the input");
-  const auto &block = blocks[blockIdx.x];
-  const auto &sample = samples[block.sample_idx];
-  const PatchDesc<InputType, ndims> *my_patches = patches + sample.patch_start_idx;
-
-
-  auto *__restrict__ out = sample.out;
-
-  int patch_y = 0;
-  int min_patch_x = 0;
-  while (block.start.x + static_cast<int>(threadIdx.x) >= my_patches[min_patch_x].patch_end[1]) {
-    min_patch_x++;
-  }
-
-  for (int y = block.start.y + static_cast<int>(threadIdx.y);
-       y < block.end.y; y += static_cast<int>(blockDim.y)) {
-    while (y >= my_patches[patch_y * sample.patch_counts[1]].patch_end[0]) patch_y++;
-    int patch_x = min_patch_x;
-    for (int x = block.start.x + static_cast<int>(threadIdx.x);
-         x < block.end.x; x += static_cast<int>(blockDim.x)) {
-      while (x >= my_patches[patch_y * sample.patch_counts[1] + patch_x].patch_end[1]) patch_x++;
-      const PatchDesc<InputType, ndims> *patch =
-              &my_patches[patch_y * sample.patch_counts[1] + patch_x];
-      if (patch->in == nullptr) {
-          out[y * sample.out_pitch[1] + x] = 0;
-      } else {
-        out[y * sample.out_pitch[1] + x] = ConvertSat<OutputType>(
-                patch->in[(y - patch->patch_start[0] + patch->in_anchor[0]) * patch->in_pitch[1]
-                         + (x - patch->patch_start[1] + patch->in_anchor[1])]);
+  __syncthreads();
+
+  // If the overlapping regions don't fit in the shared memory, all the regions are checked
+  int count = tile_region_count;
+  bool cached = count <= kMaxTileRegions;
+  const PasteRegion<InputType, 2> *lookup = cached ? tile_regions : sample_regions;
+  int n = cached ? count : sample.num_regions;
+
+  for (int y = tile_start[0] + threadIdx.y; y < tile_end[0]; y += blockDim.y) {
+    for (int x = tile_start[1] + threadIdx.x; x < tile_end[1]; x += blockDim.x) {
+      OutputType value = 0;
+      for (int k = n - 1; k >= 0; k--) {
+        const auto &r = lookup[k];
+        if (y >= r.out_start[0] && y < r.out_end[0] && x >= r.out_start[1] && x < r.out_end[1]) {
+          value = ConvertSat<OutputType>(
+              r.in[static_cast<int64_t>(y - r.out_start[0] + r.in_anchor[0]) * r.in_pitch +
+                   (x - r.out_start[1] + r.in_anchor[1])]);
+          break;
+        }
       }
+      sample.out[static_cast<int64_t>(y) * sample.size[1] + x] = value;
     }
   }
 }
@@ -248,57 +129,90 @@ PasteKernel(const SampleDescriptorGPU<OutputType, InputType, ndims> *samples,
 template <typename OutputType, typename InputType, int ndims>
 class PasteGPU {
  private:
-  static constexpr size_t spatial_dims = ndims - 1;
-  using BlockDesc = kernels::BlockDesc<spatial_dims>;
-  using SampleDesc = paste::SampleDescriptorGPU<OutputType, InputType, spatial_dims>;
-  using PatchDesc = paste::PatchDesc<InputType, spatial_dims>;
+  static constexpr int spatial_dims = ndims - 1;
+  static_assert(spatial_dims == 2, "Only 2D data with channels supported");
+  using SampleDesc = paste::PasteSampleDesc<OutputType, spatial_dims>;
+  using Region = paste::PasteRegion<InputType, spatial_dims>;
 
-  std::vector<SampleDesc> sample_descriptors_;
-  std::vector<PatchDesc> patch_descriptors_;
+  std::vector<SampleDesc> sample_descs_;
+  std::vector<Region> regions_;
+  std::vector<int64_t> first_tile_;
 
  public:
-  BlockSetup<spatial_dims, -1 /* No channel dimension, only spatial */> block_setup_;
-
+  /**
+   * @brief Lists the pasted regions of each sample
+   *
+   * The host work is linear in the number of regions - the overlaps are resolved by the kernel,
+   * in each tile separately.
+   */
   KernelRequirements Setup(
       KernelContext &context,
       span<paste::MultiPasteSampleInput<spatial_dims>> samples,
       const TensorListShape<ndims> &out_shape,
       const TensorListShape<ndims> &in_shape) {
-    paste::CreateSampleDescriptors(sample_descriptors_, patch_descriptors_, in_shape, samples);
+    int nsamples = samples.size();
+    sample_descs_.resize(nsamples);
+    first_tile_.resize(nsamples + 1);
+    regions_.clear();
+    first_tile_[0] = 0;
+    for (int i = 0; i < nsamples; i++) {
+      const auto &sample = samples[i];
+      const int channels = sample.channels;
+      auto &desc = sample_descs_[i];
+      desc.out = nullptr;  // filled in Run
+      desc.size = ivec2(sample.out_size[0], sample.out_size[1] * channels);
+      desc.tiles_x = div_ceil(desc.size[1], paste::kTileWidth);
+      desc.region_start = regions_.size();
+      desc.num_regions = sample.inputs.size();
+      for (auto &input : sample.inputs) {
+        Region r;
+        r.in = nullptr;  // filled in Run
+        r.in_sample_idx = input.in_idx;
+        r.out_start = ivec2(input.out_anchor[0], input.out_anchor[1] * channels);
+        r.out_end = ivec2(input.out_anchor[0] + input.size[0],
+                          (input.out_anchor[1] + input.size[1]) * channels);
+        r.in_anchor = ivec2(input.in_anchor[0], input.in_anchor[1] * channels);
+        r.in_pitch = in_shape[input.in_idx][1] * channels;
+        regions_.push_back(r);
+      }
+      int64_t tiles = desc.size[0] > 0 && desc.size[1] > 0
+                    ? div_ceil(desc.size[0], paste::kTileHeight) * desc.tiles_x
+                    : 0;
+      first_tile_[i + 1] = first_tile_[i] + tiles;
+    }
 
     KernelRequirements req;
     ScratchpadEstimator se;
-    // merge width with channels
-    auto flattened_shape = collapse_dim(out_shape, spatial_dims - 1);
-    block_setup_.SetupBlocks(flattened_shape, true);
-    se.add<mm::memory_kind::device, SampleDesc>(sample_descriptors_.size());
-    se.add<mm::memory_kind::device, PatchDesc>(patch_descriptors_.size());
-    se.add<mm::memory_kind::device, BlockDesc>(block_setup_.Blocks().size());
+    se.add<mm::memory_kind::device, SampleDesc>(sample_descs_.size());
+    se.add<mm::memory_kind::device, Region>(regions_.size());
+    se.add<mm::memory_kind::device, int64_t>(first_tile_.size());
     req.output_shapes = { out_shape };
     req.scratch_sizes = se.sizes;
     return req;
   }
 
-
   void Run(
       KernelContext &context,
       const OutListGPU<OutputType, ndims> &out,
       const InListGPU<InputType, ndims> &in) {
-    paste::FillPointers(make_span(sample_descriptors_), make_span(patch_descriptors_), out, in);
+    int nsamples = sample_descs_.size();
+    int64_t num_tiles = first_tile_[nsamples];
+    if (num_tiles == 0)
+      return;
+    for (int i = 0; i < nsamples; i++)
+      sample_descs_[i].out = out.data[i];
+    for (auto &r : regions_)
+      r.in = in.data[r.in_sample_idx];
 
     SampleDesc *samples_gpu;
-    PatchDesc  *patches_gpu;
-    BlockDesc *blocks_gpu;
-
-    std::tie(samples_gpu, patches_gpu, blocks_gpu) = context.scratchpad->ToContiguousGPU(
-        context.gpu.stream, sample_descriptors_, patch_descriptors_, block_setup_.Blocks());
-
-    dim3 patch_dim = block_setup_.GridDim();
-    dim3 block_dim = block_setup_.BlockDim();
-    auto stream = context.gpu.stream;
-
-    paste::PasteKernel<<<patch_dim, block_dim, 0, stream>>>(
-        samples_gpu, patches_gpu, blocks_gpu);
+    Region *regions_gpu;
+    int64_t *first_tile_gpu;
+    std::tie(samples_gpu, regions_gpu, first_tile_gpu) = context.scratchpad->ToContiguousGPU(
+        context.gpu.stream, sample_descs_, regions_, first_tile_);
+
+    dim3 block_dim(paste::kBlockWidth, paste::kBlockHeight);
+    paste::PasteKernel<<<num_tiles, block_dim, 0, context.gpu.stream>>>(
+        samples_gpu, regions_gpu, first_tile_gpu, nsamples);
     CUDA_CALL(cudaGetLastError());
   }
 };
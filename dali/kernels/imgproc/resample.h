@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -36,6 +36,21 @@ struct ResampleGPU {
   using Params = typename Impl::Params;
   using ImplPtr = typename Impl::Ptr;
 
+  ResampleGPU() = default;
+
+  /**
+   * @param half_precision_intermediate if true, the intermediate results of 3D resampling are
+   *                                    stored as `float16`; see SeparableResamplingFilter::Create
+   * @param half_precision_compute      if true, the 2D resampling of `uint8_t` images uses
+   *                                    half-precision tensor-core math;
+   *                                    see SeparableResamplingFilter::Create
+   */
+  explicit ResampleGPU(bool half_precision_intermediate, bool half_precision_compute = false)
+  : half_precision_intermediate(half_precision_intermediate),
+    half_precision_compute(half_precision_compute) {}
+
+  bool half_precision_intermediate = false;
+  bool half_precision_compute = false;
   ImplPtr pImpl;
 
   Impl *SelectImpl(
@@ -43,7 +58,7 @@ struct ResampleGPU {
       const Input &input,
       const Params &params) {
     if (!pImpl)
-      pImpl = Impl::Create(params);
+      pImpl = Impl::Create(params, half_precision_intermediate, half_precision_compute);
     return pImpl.get();
   }
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -58,6 +58,13 @@ struct FilterDesc {
   : type(type), radius(radius) {}
   ResamplingFilterType type = ResamplingFilterType::Nearest;
   float radius = 0;
+
+  constexpr bool operator==(const FilterDesc &other) const {
+    return type == other.type && radius == other.radius;
+  }
+  constexpr bool operator!=(const FilterDesc &other) const {
+    return !(*this == other);
+  }
 };
 
 /**
@@ -76,8 +83,23 @@ struct ResamplingParams {
     bool use_roi = false;
     float start = 0;
     float end = 0;
+
+    constexpr bool operator==(const ROI &other) const {
+      return use_roi == other.use_roi && start == other.start && end == other.end;
+    }
+    constexpr bool operator!=(const ROI &other) const {
+      return !(*this == other);
+    }
   };
   ROI roi;
+
+  constexpr bool operator==(const ResamplingParams &other) const {
+    return min_filter == other.min_filter && mag_filter == other.mag_filter &&
+           output_size == other.output_size && roi == other.roi;
+  }
+  constexpr bool operator!=(const ResamplingParams &other) const {
+    return !(*this == other);
+  }
 };
 
 template <int ndim>
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <cuda_runtime.h>
+#include "dali/core/float16.h"
 #include "dali/kernels/imgproc/resample/resampling_batch.h"
 #include "dali/kernels/imgproc/resample/bilinear_impl.cuh"
 #include "dali/kernels/imgproc/resample/nearest_impl.cuh"
@@ -27,7 +28,8 @@ template <int spatial_ndim, typename Output, typename Input>
 __global__ void BatchedSeparableResampleKernel(
     int which_pass,
     const SampleDesc<spatial_ndim> *__restrict__ samples,
-    const BlockDesc<spatial_ndim> *__restrict__ block2sample) {
+    const BlockDesc<spatial_ndim> *__restrict__ block2sample,
+    bool half_precision_compute) {
   // find which part of which sample this block will process
   BlockDesc<spatial_ndim> bdesc = block2sample[blockIdx.x];
   const auto &sample = samples[bdesc.sample_idx];
@@ -77,7 +79,13 @@ __global__ void BatchedSeparableResampleKernel(
     }
     break;
   default:
-    if (axis == 0) {
+    if (half_precision_compute && axis == 0) {
+      ResampleHorzTC(lo, hi, origin, scale, sample_out, out_strides, sample_in,
+        in_strides, in_shape, sample.channels, filter, support);
+    } else if (half_precision_compute && axis == 1) {
+      ResampleVertTC(lo, hi, origin, scale, sample_out, out_strides, sample_in,
+        in_strides, in_shape, sample.channels, filter, support);
+    } else if (axis == 0) {
       ResampleHorz(lo, hi, origin, scale, sample_out, out_strides, sample_in,
         in_strides, in_shape, sample.channels, filter, support);
     } else if (axis == 1) {
@@ -97,14 +105,16 @@ void BatchedSeparableResample(
     const SampleDesc<spatial_ndim> *samples,
     const BlockDesc<spatial_ndim> *block2sample, int num_blocks,
     ivec3 block_size,
-    cudaStream_t stream) {
+    cudaStream_t stream,
+    bool half_precision_compute) {
   if (num_blocks <= 0)
     return;
 
   dim3 block(block_size.x, block_size.y, block_size.z);
 
   BatchedSeparableResampleKernel<spatial_ndim, Output, Input>
-  <<<num_blocks, block, ResampleSharedMemSize, stream>>>(which_pass, samples, block2sample);
+  <<<num_blocks, block, ResampleSharedMemSize, stream>>>(
+    which_pass, samples, block2sample, half_precision_compute);
   CUDA_CALL(cudaGetLastError());
 }
 
@@ -114,7 +124,7 @@ template DLL_PUBLIC void BatchedSeparableResample<spatial_ndim, Output, Input>(
   int which_pass,                                                               \
   const SampleDesc<spatial_ndim> *samples,                                      \
   const BlockDesc<spatial_ndim> *block2sample, int num_blocks,                  \
-  ivec3 block_size, cudaStream_t stream)
+  ivec3 block_size, cudaStream_t stream, bool half_precision_compute)
 
 // Instantiate the resampling functions.
 // The resampling always goes through intermediate image of float type.
@@ -151,6 +161,26 @@ INSTANTIATE_BATCHED_RESAMPLE(3, float, uint16_t);
 INSTANTIATE_BATCHED_RESAMPLE(3, int32_t, float);
 INSTANTIATE_BATCHED_RESAMPLE(3, float, int32_t);
 
+// Half-precision intermediate buffers - 3D only, where the intermediate passes dominate
+// the memory traffic.
+
+INSTANTIATE_BATCHED_RESAMPLE(3, float16, float16);
+
+INSTANTIATE_BATCHED_RESAMPLE(3, float16, float);
+INSTANTIATE_BATCHED_RESAMPLE(3, float, float16);
+
+INSTANTIATE_BATCHED_RESAMPLE(3, float16, uint8_t);
+INSTANTIATE_BATCHED_RESAMPLE(3, uint8_t, float16);
+
+INSTANTIATE_BATCHED_RESAMPLE(3, float16, int16_t);
+INSTANTIATE_BATCHED_RESAMPLE(3, int16_t, float16);
+
+INSTANTIATE_BATCHED_RESAMPLE(3, uint16_t, float16);
+INSTANTIATE_BATCHED_RESAMPLE(3, float16, uint16_t);
+
+INSTANTIATE_BATCHED_RESAMPLE(3, int32_t, float16);
+INSTANTIATE_BATCHED_RESAMPLE(3, float16, int32_t);
+
 
 }  // namespace resampling
 }  // namespace kernels
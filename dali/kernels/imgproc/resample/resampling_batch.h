@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -21,13 +21,22 @@ namespace dali {
 namespace kernels {
 namespace resampling {
 
+/**
+ * @brief Runs one pass of the separable resampling for all samples
+ *
+ * @param half_precision_compute if true, the 2D passes with filters other than nearest
+ *                               neighbor and linear are computed as half-precision matrix
+ *                               multiplications on tensor cores, with float accumulation;
+ *                               see ResampleHorzTC and ResampleVertTC
+ */
 template <int spatial_ndim, typename Output, typename Input>
 void BatchedSeparableResample(
   int which_pass,
   const SampleDesc<spatial_ndim> *samples,
   const BlockDesc<spatial_ndim> *block2sample, int num_blocks,
   ivec3 block_size,
-  cudaStream_t stream);
+  cudaStream_t stream,
+  bool half_precision_compute = false);
 
 }  // namespace resampling
 }  // namespace kernels
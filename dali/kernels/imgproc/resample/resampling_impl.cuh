@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,8 @@
 #define DALI_KERNELS_IMGPROC_RESAMPLE_RESAMPLING_IMPL_CUH_
 
 #include <cuda_runtime.h>
+#include <cuda_fp16.h>
+#include <mma.h>
 #include "dali/core/geom/vec.h"
 #include "dali/core/static_switch.h"
 #include "dali/core/convert.h"
@@ -720,6 +722,291 @@ __device__ void ResampleDepth(
   ));  // NOLINT
 }
 
+namespace resample_tc {
+
+/// The size of the WMMA tile - 16x16 outputs, computed in 16-element steps of the filter window
+constexpr int kTile = 16;
+
+/// The maximum number of source pixels that contribute to a tile of 16 output pixels
+constexpr int kMaxSpan = 240;
+
+/// The shared memory used by the filter coefficients and their normalization factors, in floats
+constexpr int kCoeffAreaSize = kMaxSpan * kTile / 2 + kTile;
+
+/// The shared memory used by one warp, in floats - sized for a tile of the float accumulators
+constexpr int kWarpAreaSize = kTile * kTile;
+
+constexpr int kMaxWarps = (ResampleSharedMemSize / sizeof(float) - kCoeffAreaSize) / kWarpAreaSize;
+
+/**
+ * @brief Checks whether the half-precision tensor-core path can process the given pass
+ *
+ * The tiles of source pixels that contribute to a strip of 16 outputs must fit in the shared
+ * memory and the block must consist of whole warps.
+ */
+__device__ inline bool CanUseTensorCores(float scale, int support) {
+#if __CUDA_ARCH__ >= 700
+  int span = static_cast<int>(ceilf(fabsf(scale) * (kTile - 1))) + 1 + support;
+  int num_threads = blockDim.x * blockDim.y * blockDim.z;
+  return span <= kMaxSpan && num_threads % 32 == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace resample_tc
+
+/**
+ * @brief Implements horizontal resampling as matrix multiplications on tensor cores
+ *
+ * The output is processed in strips 16 pixels wide. For each strip, the filter coefficients are
+ * gathered in a banded matrix `W`, with a row for each source pixel in the strip's span and
+ * a column for each output pixel. Each warp then computes 16 rows of the strip, one channel at
+ * a time, as `out = in * W` with 16x16x16 WMMA operations - the source pixels and the
+ * coefficients are rounded to half precision and the products are accumulated in float.
+ *
+ * Falls back to ResampleHorz when the span doesn't fit in the shared memory (big downscaling
+ * factors) or when tensor cores are not available.
+ */
+template <typename Dst, typename Src>
+__device__ void ResampleHorzTC(
+    ivec2 lo, ivec2 hi,
+    float src_x0, float scale,
+    Dst *__restrict__ out, ptrdiff_vec<1> out_strides,
+    const Src *__restrict__ in, ptrdiff_vec<1> in_strides, ivec2 in_shape, int channels,
+    ResamplingFilter filter, int support) {
+  using namespace resample_tc;  // NOLINT
+  if (!CanUseTensorCores(scale, support)) {
+    ResampleHorz<2>(lo, hi, src_x0, scale, out, out_strides, in, in_strides, in_shape,
+                    channels, filter, support);
+    return;
+  }
+#if __CUDA_ARCH__ >= 700
+  namespace wmma = nvcuda::wmma;
+  using resample_shared::coeffs;
+
+  __half *W = reinterpret_cast<__half *>(coeffs);  // W[s][n], kTile columns
+  float *norms = coeffs + kMaxSpan * kTile / 2;
+  const int tid = threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z);
+  const int num_threads = blockDim.x * blockDim.y * blockDim.z;
+  const int warp = tid / 32, lane = tid % 32;
+  const int num_warps = ::min(num_threads / 32, kMaxWarps);
+  float *warp_area = coeffs + kCoeffAreaSize + warp * kWarpAreaSize;
+  __half *tile = reinterpret_cast<__half *>(warp_area);  // a 16x16 tile of the source pixels
+  float *acc_tile = warp_area;
+
+  int out_stride = out_strides.x;
+  int in_stride = in_strides.x;
+  int in_w = in_shape.x;
+
+  src_x0 += 0.5f * scale - 0.5f - filter.anchor;
+
+  const float filter_step = filter.scale;
+
+  for (int j = lo.x; j < hi.x; j += kTile) {
+    int sx_first = __float2int_ru(j * scale + src_x0);
+    int sx_last = __float2int_ru((j + kTile - 1) * scale + src_x0);
+    int base = ::min(sx_first, sx_last);
+    int span = ::max(sx_first, sx_last) - base + support;
+    int padded_span = (span + kTile - 1) / kTile * kTile;
+
+    __syncthreads();
+    for (int idx = tid; idx < padded_span * kTile; idx += num_threads) {
+      int s = idx / kTile, n = idx % kTile;
+      const float sx0f = (j + n) * scale + src_x0;
+      const int sx0 = __float2int_ru(sx0f);
+      int k = base + s - sx0;
+      float flt = k >= 0 && k < support ? filter((sx0 - sx0f) * filter_step + k * filter_step) : 0;
+      W[idx] = __float2half(flt);
+    }
+    __syncthreads();
+    if (tid < kTile) {
+      // normalize with the rounded coefficients, so that a flat input stays flat
+      float norm = 0;
+      for (int s = 0; s < padded_span; s++)
+        norm += __half2float(W[s * kTile + tid]);
+      norms[tid] = 1.0f / norm;
+    }
+    __syncthreads();
+
+    if (warp >= num_warps)
+      continue;
+
+    for (int i = lo.y + warp * kTile; i < hi.y; i += num_warps * kTile) {
+      for (int c = 0; c < channels; c++) {
+        wmma::fragment<wmma::matrix_a, kTile, kTile, kTile, __half, wmma::row_major> a;
+        wmma::fragment<wmma::matrix_b, kTile, kTile, kTile, __half, wmma::row_major> b;
+        wmma::fragment<wmma::accumulator, kTile, kTile, kTile, float> acc;
+        wmma::fill_fragment(acc, 0.0f);
+
+        for (int s0 = 0; s0 < padded_span; s0 += kTile) {
+          for (int e = lane; e < kTile * kTile; e += 32) {
+            int y = ::min(i + e / kTile, hi.y - 1);
+            int x = base + s0 + e % kTile;
+            int xsample = x < 0 ? 0 : x >= in_w-1 ? in_w-1 : x;
+            tile[e] = __float2half(static_cast<float>(__ldg(in + y * in_stride +
+                                                            channels * xsample + c)));
+          }
+          __syncwarp();
+          wmma::load_matrix_sync(a, tile, kTile);
+          wmma::load_matrix_sync(b, W + s0 * kTile, kTile);
+          wmma::mma_sync(acc, a, b, acc);
+          __syncwarp();
+        }
+
+        wmma::store_matrix_sync(acc_tile, acc, kTile, wmma::mem_row_major);
+        __syncwarp();
+        for (int e = lane; e < kTile * kTile; e += 32) {
+          int y = i + e / kTile, n = e % kTile, dx = j + n;
+          if (y < hi.y && dx < hi.x)
+            out[y * out_stride + channels * dx + c] = ConvertSat<Dst>(acc_tile[e] * norms[n]);
+        }
+        __syncwarp();
+      }
+    }
+  }
+#endif
+}
+
+/**
+ * @brief Implements vertical resampling as matrix multiplications on tensor cores
+ *
+ * The output is processed in strips 16 rows high. For each strip, the filter coefficients are
+ * gathered in a banded matrix `W`, with a row for each output row and a column for each source
+ * row in the strip's span. Each warp then computes 16 columns of the strip, counted in elements
+ * of the rows, with the channels interleaved, as `out = W * in` with 16x16x16 WMMA operations -
+ * the source pixels and the coefficients are rounded to half precision and the products are
+ * accumulated in float.
+ *
+ * Falls back to ResampleVert when the span doesn't fit in the shared memory (big downscaling
+ * factors) or when tensor cores are not available.
+ */
+template <typename Dst, typename Src>
+__device__ void ResampleVertTC(
+    ivec2 lo, ivec2 hi,
+    float src_y0, float scale,
+    Dst *__restrict__ out, ptrdiff_vec<1> out_strides,
+    const Src *__restrict__ in, ptrdiff_vec<1> in_strides, ivec2 in_shape, int channels,
+    ResamplingFilter filter, int support) {
+  using namespace resample_tc;  // NOLINT
+  if (!CanUseTensorCores(scale, support)) {
+    ResampleVert<2>(lo, hi, src_y0, scale, out, out_strides, in, in_strides, in_shape,
+                    channels, filter, support);
+    return;
+  }
+#if __CUDA_ARCH__ >= 700
+  namespace wmma = nvcuda::wmma;
+  using resample_shared::coeffs;
+
+  __half *W = reinterpret_cast<__half *>(coeffs);  // W[n][s], padded_span columns
+  float *norms = coeffs + kMaxSpan * kTile / 2;
+  const int tid = threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z);
+  const int num_threads = blockDim.x * blockDim.y * blockDim.z;
+  const int warp = tid / 32, lane = tid % 32;
+  const int num_warps = ::min(num_threads / 32, kMaxWarps);
+  float *warp_area = coeffs + kCoeffAreaSize + warp * kWarpAreaSize;
+  __half *tile = reinterpret_cast<__half *>(warp_area);  // a 16x16 tile of the source pixels
+  float *acc_tile = warp_area;
+
+  int out_stride = out_strides.x;
+  int in_stride = in_strides.x;
+  int in_h = in_shape.y;
+  const int row_lo = lo.x * channels, row_hi = hi.x * channels;
+
+  src_y0 += 0.5f * scale - 0.5f - filter.anchor;
+
+  const float filter_step = filter.scale;
+
+  for (int i = lo.y; i < hi.y; i += kTile) {
+    int sy_first = __float2int_ru(i * scale + src_y0);
+    int sy_last = __float2int_ru((i + kTile - 1) * scale + src_y0);
+    int base = ::min(sy_first, sy_last);
+    int span = ::max(sy_first, sy_last) - base + support;
+    int padded_span = (span + kTile - 1) / kTile * kTile;
+
+    __syncthreads();
+    for (int idx = tid; idx < kTile * padded_span; idx += num_threads) {
+      int n = idx / padded_span, s = idx % padded_span;
+      const float sy0f = (i + n) * scale + src_y0;
+      const int sy0 = __float2int_ru(sy0f);
+      int k = base + s - sy0;
+      float flt = k >= 0 && k < support ? filter((sy0 - sy0f) * filter_step + k * filter_step) : 0;
+      W[idx] = __float2half(flt);
+    }
+    __syncthreads();
+    if (tid < kTile) {
+      // normalize with the rounded coefficients, so that a flat input stays flat
+      float norm = 0;
+      for (int s = 0; s < padded_span; s++)
+        norm += __half2float(W[tid * padded_span + s]);
+      norms[tid] = 1.0f / norm;
+    }
+    __syncthreads();
+
+    if (warp >= num_warps)
+      continue;
+
+    for (int j = row_lo + warp * kTile; j < row_hi; j += num_warps * kTile) {
+      wmma::fragment<wmma::matrix_a, kTile, kTile, kTile, __half, wmma::row_major> a;
+      wmma::fragment<wmma::matrix_b, kTile, kTile, kTile, __half, wmma::row_major> b;
+      wmma::fragment<wmma::accumulator, kTile, kTile, kTile, float> acc;
+      wmma::fill_fragment(acc, 0.0f);
+
+      for (int s0 = 0; s0 < padded_span; s0 += kTile) {
+        for (int e = lane; e < kTile * kTile; e += 32) {
+          int y = base + s0 + e / kTile;
+          int ysample = y < 0 ? 0 : y >= in_h-1 ? in_h-1 : y;
+          int x = ::min(j + e % kTile, row_hi - 1);
+          tile[e] = __float2half(static_cast<float>(__ldg(in + ysample * in_stride + x)));
+        }
+        __syncwarp();
+        wmma::load_matrix_sync(a, W + s0, padded_span);
+        wmma::load_matrix_sync(b, tile, kTile);
+        wmma::mma_sync(acc, a, b, acc);
+        __syncwarp();
+      }
+
+      wmma::store_matrix_sync(acc_tile, acc, kTile, wmma::mem_row_major);
+      __syncwarp();
+      for (int e = lane; e < kTile * kTile; e += 32) {
+        int n = e / kTile, dy = i + n, x = j + e % kTile;
+        if (dy < hi.y && x < row_hi)
+          out[dy * out_stride + x] = ConvertSat<Dst>(acc_tile[e] * norms[n]);
+      }
+      __syncwarp();
+    }
+  }
+#endif
+}
+
+/**
+ * @brief Volumetric resampling has no tensor-core path - uses ResampleHorz
+ */
+template <typename Dst, typename Src>
+__device__ void ResampleHorzTC(
+    ivec3 lo, ivec3 hi,
+    float src_x0, float scale,
+    Dst *__restrict__ out, ptrdiff_vec<2> out_strides,
+    const Src *__restrict__ in, ptrdiff_vec<2> in_strides, ivec3 in_shape, int channels,
+    ResamplingFilter filter, int support) {
+  ResampleHorz<3>(lo, hi, src_x0, scale, out, out_strides, in, in_strides, in_shape,
+                  channels, filter, support);
+}
+
+/**
+ * @brief Volumetric resampling has no tensor-core path - uses ResampleVert
+ */
+template <typename Dst, typename Src>
+__device__ void ResampleVertTC(
+    ivec3 lo, ivec3 hi,
+    float src_y0, float scale,
+    Dst *__restrict__ out, ptrdiff_vec<2> out_strides,
+    const Src *__restrict__ in, ptrdiff_vec<2> in_strides, ivec3 in_shape, int channels,
+    ResamplingFilter filter, int support) {
+  ResampleVert<3>(lo, hi, src_y0, scale, out, out_strides, in, in_strides, in_shape,
+                  channels, filter, support);
+}
+
 }  // namespace kernels
 }  // namespace dali
 
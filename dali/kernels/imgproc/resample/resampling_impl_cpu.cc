@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,11 @@
 #include "dali/kernels/imgproc/resample/resampling_filters.cuh"
 #include "dali/kernels/imgproc/resample/resampling_impl_cpu.h"
 
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define DALI_RESAMPLE_CPU_DISPATCH 1
+#endif
+
 namespace dali {
 namespace kernels {
 
@@ -46,5 +51,153 @@ void InitializeResamplingFilter(
   }
 }
 
+namespace {
+
+template <typename In>
+inline float ResampleVertAccumulateScalar(const In *const *rows, int64_t idx,
+                                          const float *kernel, int support) {
+  float sum = 0;
+  for (int k = 0; k < support; k++)
+    sum += rows[k][idx] * kernel[k];
+  return sum;
+}
+
+#if DALI_RESAMPLE_CPU_DISPATCH
+
+#define DALI_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define DALI_TARGET_AVX512 __attribute__((target("avx512f")))
+
+// Loads 8 values and converts them to float
+
+DALI_TARGET_AVX2 inline __m256 load8_f(const float *in) {
+  return _mm256_loadu_ps(in);
+}
+
+DALI_TARGET_AVX2 inline __m256 load8_f(const int32_t *in) {
+  return _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in)));
+}
+
+DALI_TARGET_AVX2 inline __m256 load8_f(const uint16_t *in) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(v));
+}
+
+DALI_TARGET_AVX2 inline __m256 load8_f(const int16_t *in) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v));
+}
+
+DALI_TARGET_AVX2 inline __m256 load8_f(const uint8_t *in) {
+  __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in));
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v));
+}
+
+DALI_TARGET_AVX2 inline __m256 load8_f(const int8_t *in) {
+  __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in));
+  return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(v));
+}
+
+// Loads 16 values and converts them to float
+
+DALI_TARGET_AVX512 inline __m512 load16_f(const float *in) {
+  return _mm512_loadu_ps(in);
+}
+
+DALI_TARGET_AVX512 inline __m512 load16_f(const int32_t *in) {
+  return _mm512_cvtepi32_ps(_mm512_loadu_si512(in));
+}
+
+DALI_TARGET_AVX512 inline __m512 load16_f(const uint16_t *in) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+  return _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(v));
+}
+
+DALI_TARGET_AVX512 inline __m512 load16_f(const int16_t *in) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+  return _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(v));
+}
+
+DALI_TARGET_AVX512 inline __m512 load16_f(const uint8_t *in) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(v));
+}
+
+DALI_TARGET_AVX512 inline __m512 load16_f(const int8_t *in) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  return _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(v));
+}
+
+template <typename In>
+DALI_TARGET_AVX2
+void ResampleVertAccumulateAVX2(float *out, const In *const *rows, int64_t offset, int n,
+                                const float *kernel, int support) {
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (int k = 0; k < support; k++) {
+      const In *in = rows[k] + offset + i;
+      __m256 coeff = _mm256_set1_ps(kernel[k]);
+      acc0 = _mm256_fmadd_ps(coeff, load8_f(in), acc0);
+      acc1 = _mm256_fmadd_ps(coeff, load8_f(in + 8), acc1);
+    }
+    _mm256_storeu_ps(out + i, acc0);
+    _mm256_storeu_ps(out + i + 8, acc1);
+  }
+  for (; i < n; i++)
+    out[i] = ResampleVertAccumulateScalar(rows, offset + i, kernel, support);
+}
+
+template <typename In>
+DALI_TARGET_AVX512
+void ResampleVertAccumulateAVX512(float *out, const In *const *rows, int64_t offset, int n,
+                                  const float *kernel, int support) {
+  int i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (int k = 0; k < support; k++) {
+      const In *in = rows[k] + offset + i;
+      __m512 coeff = _mm512_set1_ps(kernel[k]);
+      acc0 = _mm512_fmadd_ps(coeff, load16_f(in), acc0);
+      acc1 = _mm512_fmadd_ps(coeff, load16_f(in + 16), acc1);
+    }
+    _mm512_storeu_ps(out + i, acc0);
+    _mm512_storeu_ps(out + i + 16, acc1);
+  }
+  for (; i < n; i++)
+    out[i] = ResampleVertAccumulateScalar(rows, offset + i, kernel, support);
+}
+
+#endif  // DALI_RESAMPLE_CPU_DISPATCH
+
+template <typename In>
+void ResampleVertAccumulateImpl(float *out, const In *const *rows, int64_t offset, int n,
+                                const float *kernel, int support, simd::CpuIsa isa) {
+#if DALI_RESAMPLE_CPU_DISPATCH
+  if (isa == simd::CpuIsa::AVX512)
+    return ResampleVertAccumulateAVX512(out, rows, offset, n, kernel, support);
+  if (isa == simd::CpuIsa::AVX2)
+    return ResampleVertAccumulateAVX2(out, rows, offset, n, kernel, support);
+#endif
+  for (int i = 0; i < n; i++)
+    out[i] = ResampleVertAccumulateScalar(rows, offset + i, kernel, support);
+}
+
+}  // namespace
+
+#define DALI_DEFINE_RESAMPLE_VERT_ACCUMULATE(In)                                               \
+void ResampleVertAccumulate(float *out, const In *const *rows, int64_t offset, int n,         \
+                            const float *kernel, int support, simd::CpuIsa isa) {             \
+  ResampleVertAccumulateImpl(out, rows, offset, n, kernel, support, isa);                     \
+}
+
+DALI_DEFINE_RESAMPLE_VERT_ACCUMULATE(uint8_t)
+DALI_DEFINE_RESAMPLE_VERT_ACCUMULATE(int8_t)
+DALI_DEFINE_RESAMPLE_VERT_ACCUMULATE(uint16_t)
+DALI_DEFINE_RESAMPLE_VERT_ACCUMULATE(int16_t)
+DALI_DEFINE_RESAMPLE_VERT_ACCUMULATE(int32_t)
+DALI_DEFINE_RESAMPLE_VERT_ACCUMULATE(float)
+
 }  // namespace kernels
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,7 @@
 #ifndef DALI_KERNELS_IMGPROC_RESAMPLE_RESAMPLING_IMPL_CPU_H_
 #define DALI_KERNELS_IMGPROC_RESAMPLE_RESAMPLING_IMPL_CPU_H_
 
+#include <algorithm>
 #include <cassert>
 #include <type_traits>
 #include "dali/core/static_switch.h"
@@ -85,6 +86,32 @@ void ResampleCol(Out *out, const In *in, int x, int w, const int32_t *in_columns
   }
 }
 
+/**
+ * @brief Calculates a weighted sum of input rows: `out[i] = sum(rows[k][offset + i] * kernel[k])`
+ *        for k in [0, support) and i in [0, n)
+ *
+ * The function uses the vector instructions specified by `isa` - it must be supported by the CPU
+ * (see simd::GetCpuIsa).
+ */
+DLL_PUBLIC void ResampleVertAccumulate(float *out, const uint8_t *const *rows, int64_t offset,
+                                       int n, const float *kernel, int support, simd::CpuIsa isa);
+DLL_PUBLIC void ResampleVertAccumulate(float *out, const int8_t *const *rows, int64_t offset,
+                                       int n, const float *kernel, int support, simd::CpuIsa isa);
+DLL_PUBLIC void ResampleVertAccumulate(float *out, const uint16_t *const *rows, int64_t offset,
+                                       int n, const float *kernel, int support, simd::CpuIsa isa);
+DLL_PUBLIC void ResampleVertAccumulate(float *out, const int16_t *const *rows, int64_t offset,
+                                       int n, const float *kernel, int support, simd::CpuIsa isa);
+DLL_PUBLIC void ResampleVertAccumulate(float *out, const int32_t *const *rows, int64_t offset,
+                                       int n, const float *kernel, int support, simd::CpuIsa isa);
+DLL_PUBLIC void ResampleVertAccumulate(float *out, const float *const *rows, int64_t offset,
+                                       int n, const float *kernel, int support, simd::CpuIsa isa);
+
+template <typename T>
+constexpr bool HasResampleVertAccumulate =
+    std::is_same<T, uint8_t>::value || std::is_same<T, int8_t>::value ||
+    std::is_same<T, uint16_t>::value || std::is_same<T, int16_t>::value ||
+    std::is_same<T, int32_t>::value || std::is_same<T, float>::value;
+
 template <typename Out, typename In>
 struct SIMD_vert_resample_impl {
 #ifdef __SSE2__
@@ -95,12 +122,35 @@ struct SIMD_vert_resample_impl {
   static constexpr int kNumVecs = kNumLanes * sizeof(float) / kVecSize;
 
   using vec_pack = simd::multivec<kNumVecs>;
+
+  /// @brief The number of elements accumulated in a temporary buffer before conversion to Out
+  static constexpr int kAccTile = 256;
 #endif
 
   static void run(Out *out, const In **rows, const float *kernel, int support,
                    int begin_col, int end_col) {
     int i = begin_col;
 #ifdef __SSE2__
+    if constexpr (HasResampleVertAccumulate<In> && HasResampleVertAccumulate<Out>) {
+      simd::CpuIsa isa = simd::GetCpuIsa();
+      if (isa != simd::CpuIsa::Generic) {
+        if constexpr (std::is_same<Out, float>::value) {
+          ResampleVertAccumulate(out + i, rows, i, end_col - i, kernel, support, isa);
+          return;
+        } else {
+          // accumulate with wide vectors, convert with saturation and store with SSE
+          float tmp[kAccTile];
+          while (i + kNumLanes <= end_col) {
+            int n = std::min(kAccTile, (end_col - i) / kNumLanes * kNumLanes);
+            ResampleVertAccumulate(tmp, rows, i, n, kernel, support, isa);
+            for (int j = 0; j < n; j += kNumLanes)
+              store(out + i + j, vec_pack::load(tmp + j));
+            i += n;
+          }
+        }
+      }
+    }
+
     for (; i + kNumLanes <= end_col; i += kNumLanes) {
       vec_pack vtmp = vec_pack::zero();
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -327,6 +327,13 @@ void SeparableResamplingSetup<spatial_ndim>::SetupSample(
  * It does not calculate block descriptors directly, but it calculates the number of blocks
  * required to calculate each stage of each sample using SampleDesc::logical_block_shape.
  */
+template <int spatial_ndim>
+bool BatchResamplingSetup<spatial_ndim>::IsCached(
+    const TensorListShape<tensor_ndim> &in, const Params &params) const {
+  return version > 0 && in == cached_in_shape_ &&
+         std::equal(params.begin(), params.end(), cached_params_.begin(), cached_params_.end());
+}
+
 template <int spatial_ndim>
 void BatchResamplingSetup<spatial_ndim>::SetupBatch(
     const TensorListShape<tensor_ndim> &in, const Params &params) {
@@ -337,6 +344,10 @@ void BatchResamplingSetup<spatial_ndim>::SetupBatch(
   int N = in.num_samples();
   assert(params.size() == static_cast<span_extent_t>(N));
 
+  if (IsCached(in, params))
+    return;  // same shapes and parameters - the previous setup is still valid
+  cached_params_.clear();  // invalidate, in case the setup fails
+
   sample_descs.resize(N);
   for (auto &shape : intermediate_shapes)
     shape.resize(N);
@@ -374,6 +385,10 @@ void BatchResamplingSetup<spatial_ndim>::SetupBatch(
       total_blocks[pass] += volume(blocks);
     }
   }
+
+  cached_in_shape_ = in;
+  cached_params_.assign(params.begin(), params.end());
+  version++;
 }
 
 template <int n>
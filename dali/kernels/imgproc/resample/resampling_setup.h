@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -171,6 +171,15 @@ class BatchResamplingSetup : public SeparableResamplingSetup<_spatial_ndim> {
   size_t intermediate_sizes[num_tmp_buffers];  // NOLINT
   ivec<spatial_ndim> total_blocks;
 
+  /**
+   * @brief Incremented each time SetupBatch calculates a new setup
+   *
+   * When the input shapes and the parameters are the same as in the previous call, SetupBatch
+   * keeps the previous setup (all but the base pointers in sample descriptors, which are set
+   * in each run) and the version doesn't change - the users can keep the data derived from it.
+   */
+  int64_t version = 0;
+
   /** @brief Prepares sample descriptors and block info for entire batch */
   DLL_PUBLIC void SetupBatch(const TensorListShape<tensor_ndim> &in, const Params &params);
 
@@ -181,6 +190,12 @@ class BatchResamplingSetup : public SeparableResamplingSetup<_spatial_ndim> {
 
   /** @brief Calculates the mapping from grid block indices to samples and regions within samples */
   DLL_PUBLIC void InitializeSampleLookup(const OutTensorCPU<BlockDesc, 1> &sample_lookup);
+
+ private:
+  bool IsCached(const TensorListShape<tensor_ndim> &in, const Params &params) const;
+
+  TensorListShape<tensor_ndim> cached_in_shape_;
+  std::vector<ResamplingParamsND<spatial_ndim>> cached_params_;
 };
 
 }  // namespace resampling
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -45,7 +45,20 @@ struct SeparableResamplingFilter {
 
   using Ptr = std::unique_ptr<SeparableResamplingFilter>;
 
-  static Ptr Create(const Params &params);
+  /**
+   * @brief Creates an implementation suitable for the given parameters
+   *
+   * @param half_precision_intermediate if true, the intermediate results of 3D resampling are
+   *                                    stored as `float16` - this reduces the memory traffic
+   *                                    at the cost of precision; ignored in 2D
+   * @param half_precision_compute if true, the 2D resampling of `uint8_t` images computes
+   *                               the filters as half-precision matrix multiplications on
+   *                               tensor cores, with float accumulation - this is faster for
+   *                               filters with wide support, at the cost of precision;
+   *                               ignored in 3D and for other input types
+   */
+  static Ptr Create(const Params &params, bool half_precision_intermediate = false,
+                    bool half_precision_compute = false);
 };
 
 }  // namespace kernels
@@ -16,6 +16,11 @@
 #define DALI_KERNELS_IMGPROC_RESAMPLE_SEPARABLE_IMPL_H_
 
 #include <cuda_runtime.h>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "dali/core/mm/memory.h"
 #include "dali/kernels/imgproc/resample/separable.h"
 #include "dali/kernels/imgproc/resample/resampling_setup.h"
 #include "dali/kernels/imgproc/resample/resampling_batch.h"
@@ -32,9 +37,13 @@ namespace resampling {
  * Resampling order is chosen based on input/output shapes and filter type and support.
  * The filter allocates memory only in `Setup` - and even there, it won't reallocate
  * if subsequent calls do not exceed previous number of samples.
+ *
+ * @tparam _IntermediateElement the type of the buffers between the passes; using `float16`
+ *                              halves the memory traffic of the intermediate passes
  */
 template <typename OutputElement, typename InputElement,
           int _spatial_ndim,
+          typename _IntermediateElement = float,
           typename Interface = SeparableResamplingFilter<OutputElement, InputElement, _spatial_ndim>
           >
 struct SeparableResamplingGPUImpl : Interface {
@@ -53,7 +62,7 @@ struct SeparableResamplingGPUImpl : Interface {
    */
   ResamplingSetup setup;
 
-  using IntermediateElement = float;
+  using IntermediateElement = _IntermediateElement;
   using Intermediate = OutListGPU<IntermediateElement, tensor_ndim>;
 
   /**
@@ -61,6 +70,18 @@ struct SeparableResamplingGPUImpl : Interface {
    */
   Intermediate intermediate[num_tmp_buffers];  // NOLINT
 
+  /**
+   * @brief If true, the 2D passes are computed as half-precision matrix multiplications
+   *        on tensor cores
+   *
+   * Only used for `uint8_t` inputs - the values of the wider types, and the intermediate
+   * results computed from them, may exceed the range of `float16`.
+   */
+  bool half_precision_compute = false;
+
+  static constexpr bool half_precision_compute_supported =
+      spatial_ndim == 2 && std::is_same<InputElement, uint8_t>::value;
+
   void Initialize(KernelContext &context) {
     setup.Initialize();
   }
@@ -98,16 +119,13 @@ struct SeparableResamplingGPUImpl : Interface {
     KernelRequirements req;
     ScratchpadEstimator se;
 
-    // Sample descriptions need to be delivered to the GPU - hence, the storage
-    se.add<mm::memory_kind::device, SampleDesc>(setup.sample_descs.size());
-
     // CPU block2sample lookup may change in size and is large enough
     // to mandate declaring it as a requirement for external allocator.
+    // The device copies of the descriptors are kept by the kernel (see DeviceDescriptors).
     size_t num_blocks = 0;
     for (auto x : setup.total_blocks)
       num_blocks += x;
 
-    se.add<mm::memory_kind::device, BlockDesc>(num_blocks);
     se.add<mm::memory_kind::pinned, BlockDesc>(num_blocks);
 
     // Request memory for intermediate storage.
@@ -128,40 +146,47 @@ struct SeparableResamplingGPUImpl : Interface {
         which_pass,
         descs_gpu, block2sample.data, block2sample.shape[0],
         setup.block_dim,
-        stream);
+        stream,
+        half_precision_compute_supported && half_precision_compute);
   }
 
   /**
-   * @remarks This function shall not allocate memory by ano other means
-   *          than through `context.scratchpad`
+   * @remarks Apart from the persistent descriptor buffers (see DeviceDescriptors), which are
+   *          reallocated only when they grow, this function shall not allocate memory by any
+   *          other means than through `context.scratchpad`
    */
   virtual void
   Run(KernelContext &context, const Output &out, const Input &in, const Params &params) {
     cudaStream_t stream = context.gpu.stream;
-
-    SampleDesc *descs_gpu = context.scratchpad->AllocateGPU<SampleDesc>(setup.sample_descs.size());
+    if (stream != gpu_descs_.stream)
+      gpu_descs_ = {};  // the old buffers are released in the stream order of the old stream
+    gpu_descs_.stream = stream;
 
     int blocks_in_all_passes = 0;
     for (auto x : setup.total_blocks)
       blocks_in_all_passes += x;
 
-    OutTensorCPU<BlockDesc, 1> sample_lookup_cpu = {
-      context.scratchpad->AllocatePinned<BlockDesc>(blocks_in_all_passes),
-      { blocks_in_all_passes }
-    };
-    OutTensorGPU<BlockDesc, 1> sample_lookup_gpu = {
-      context.scratchpad->AllocateGPU<BlockDesc>(blocks_in_all_passes),
-      { blocks_in_all_passes }
-    };
-    setup.InitializeSampleLookup(sample_lookup_cpu);
-    copy(sample_lookup_gpu, sample_lookup_cpu, stream);  // NOLINT (it thinks it's std::copy)
+    if (gpu_descs_.block_version != setup.version) {
+      OutTensorCPU<BlockDesc, 1> sample_lookup_cpu = {
+        context.scratchpad->AllocatePinned<BlockDesc>(blocks_in_all_passes),
+        { blocks_in_all_passes }
+      };
+      setup.InitializeSampleLookup(sample_lookup_cpu);
+      gpu_descs_.Reserve(gpu_descs_.blocks, gpu_descs_.block_capacity, blocks_in_all_passes);
+      OutTensorGPU<BlockDesc, 1> sample_lookup_gpu = {
+        gpu_descs_.blocks.get(), { blocks_in_all_passes }
+      };
+      copy(sample_lookup_gpu, sample_lookup_cpu, stream);  // NOLINT (it thinks it's std::copy)
+      gpu_descs_.block_version = setup.version;
+    }
+    BlockDesc *sample_lookup_gpu = gpu_descs_.blocks.get();
 
 
     InTensorGPU<BlockDesc, 1> pass_lookup[spatial_ndim];
 
     size_t pass_lookup_offset = 0;
     for (int pass = 0; pass < spatial_ndim; pass++) {
-      pass_lookup[pass] = make_tensor_gpu<1>(sample_lookup_gpu.data + pass_lookup_offset,
+      pass_lookup[pass] = make_tensor_gpu<1>(sample_lookup_gpu + pass_lookup_offset,
                                              { setup.total_blocks[pass] });
       pass_lookup_offset += setup.total_blocks[pass];
     }
@@ -185,16 +210,51 @@ struct SeparableResamplingGPUImpl : Interface {
         out.tensor_data(i));
     }
 
-    CUDA_CALL(cudaMemcpyAsync(
-        descs_gpu,
-        setup.sample_descs.data(),
-        setup.sample_descs.size()*sizeof(SampleDesc),
-        cudaMemcpyHostToDevice,
-        stream));
+    // The sample descriptors contain the data pointers, so they usually change in each run -
+    // but when they don't (e.g. the same buffers are reused), the upload is skipped.
+    const auto &descs = setup.sample_descs;
+    if (gpu_descs_.uploaded_samples.size() != descs.size() || (!descs.empty() &&
+        memcmp(gpu_descs_.uploaded_samples.data(), descs.data(),
+               descs.size() * sizeof(SampleDesc)))) {
+      gpu_descs_.Reserve(gpu_descs_.samples, gpu_descs_.sample_capacity, descs.size());
+      CUDA_CALL(cudaMemcpyAsync(
+          gpu_descs_.samples.get(),
+          descs.data(),
+          descs.size()*sizeof(SampleDesc),
+          cudaMemcpyHostToDevice,
+          stream));
+      gpu_descs_.uploaded_samples = descs;
+    }
+    SampleDesc *descs_gpu = gpu_descs_.samples.get();
 
     RunPasses(descs_gpu, pass_lookup, stream, std::integral_constant<int, spatial_ndim>());
   }
 
+  /**
+   * @brief Device copies of the sample and block descriptors, kept across runs
+   *
+   * The buffers are used only in one stream - that's what makes it safe to overwrite them
+   * in subsequent runs.
+   */
+  struct DeviceDescriptors {
+    mm::async_uptr<SampleDesc> samples;
+    mm::async_uptr<BlockDesc> blocks;
+    size_t sample_capacity = 0, block_capacity = 0;
+    /// @brief The host copy of the contents of `samples`
+    std::vector<SampleDesc> uploaded_samples;
+    /// @brief The version of the setup from which the `blocks` were calculated
+    int64_t block_version = -1;
+    cudaStream_t stream = 0;
+
+    template <typename T>
+    void Reserve(mm::async_uptr<T> &buf, size_t &capacity, size_t count) {
+      if (count > capacity) {
+        capacity = std::max(count, 2 * capacity);
+        buf = mm::alloc_raw_async_unique<T, mm::memory_kind::device>(capacity, stream, stream);
+      }
+    }
+  } gpu_descs_;
+
   void RunPasses(SampleDesc *descs_gpu,
                  const InTensorGPU<BlockDesc, 1> *pass_lookup,
                  cudaStream_t stream,
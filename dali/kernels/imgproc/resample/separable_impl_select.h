@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,9 @@
 #ifndef DALI_KERNELS_IMGPROC_RESAMPLE_SEPARABLE_IMPL_SELECT_H_
 #define DALI_KERNELS_IMGPROC_RESAMPLE_SEPARABLE_IMPL_SELECT_H_
 
+#include <memory>
+#include <type_traits>
+#include "dali/core/float16.h"
 #include "dali/kernels/imgproc/resample/separable.h"
 #include "dali/kernels/imgproc/resample/separable_impl.h"
 
@@ -23,14 +26,40 @@ namespace kernels {
 
 using namespace resampling;  // NOLINT
 
+namespace resampling {
+
+template <typename OutputElement, typename InputElement>
+typename SeparableResamplingFilter<OutputElement, InputElement, 2>::Ptr
+CreateSeparableImpl(bool /*half_precision_intermediate*/, bool half_precision_compute,
+                    std::integral_constant<int, 2>) {
+  using ImplType = SeparableResamplingGPUImpl<OutputElement, InputElement, 2>;
+  auto impl = std::make_unique<ImplType>();
+  impl->half_precision_compute = half_precision_compute;
+  return impl;
+}
+
+template <typename OutputElement, typename InputElement>
+typename SeparableResamplingFilter<OutputElement, InputElement, 3>::Ptr
+CreateSeparableImpl(bool half_precision_intermediate, bool /*half_precision_compute*/,
+                    std::integral_constant<int, 3>) {
+  if (half_precision_intermediate) {
+    using ImplType = SeparableResamplingGPUImpl<OutputElement, InputElement, 3, float16>;
+    return std::make_unique<ImplType>();
+  }
+  using ImplType = SeparableResamplingGPUImpl<OutputElement, InputElement, 3>;
+  return std::make_unique<ImplType>();
+}
+
+}  // namespace resampling
+
 template <typename OutputElement, typename InputElement, int spatial_ndim>
 typename SeparableResamplingFilter<OutputElement, InputElement, spatial_ndim>::Ptr
 SeparableResamplingFilter<OutputElement, InputElement, spatial_ndim>::Create(
-    const Params &params) {
+    const Params &params, bool half_precision_intermediate, bool half_precision_compute) {
   (void)params;
-  using ImplType =
-    resampling::SeparableResamplingGPUImpl<OutputElement, InputElement, spatial_ndim>;
-  return Ptr(new ImplType());
+  return resampling::CreateSeparableImpl<OutputElement, InputElement>(
+      half_precision_intermediate, half_precision_compute,
+      std::integral_constant<int, spatial_ndim>());
 }
 
 }  // namespace kernels
@@ -0,0 +1,230 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_IMGPROC_RESIZE_CROP_MIRROR_NORMALIZE_GPU_CUH_
+#define DALI_KERNELS_IMGPROC_RESIZE_CROP_MIRROR_NORMALIZE_GPU_CUH_
+
+#include <cuda_runtime.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "dali/core/common.h"
+#include "dali/core/convert.h"
+#include "dali/core/cuda_error.h"
+#include "dali/core/error_handling.h"
+#include "dali/core/format.h"
+#include "dali/core/geom/vec.h"
+#include "dali/core/math_util.h"
+#include "dali/core/span.h"
+#include "dali/core/tensor_view.h"
+#include "dali/core/util.h"
+#include "dali/kernels/kernel.h"
+
+namespace dali {
+namespace kernels {
+
+/**
+ * @brief Parameters of the ResizeCropMirrorNormalizeGPU kernel for one sample
+ */
+struct ResizeCropMirrorNormalizeArgs {
+  static constexpr int kMaxChannels = 4;
+
+  /// @brief The region of the input which is resized, in (x, y) pixel coordinates
+  vec2 roi_lo, roi_hi;
+  /// @brief The size of the output, (width, height)
+  ivec2 out_size;
+  bool mirror = false;
+  /// @brief Per-channel mean and inverse standard deviation; out = (in - mean) * inv_stddev
+  float mean[kMaxChannels] = { 0, 0, 0, 0 };
+  float inv_stddev[kMaxChannels] = { 1, 1, 1, 1 };
+};
+
+namespace rcmn {
+
+template <typename Out, typename In>
+struct SampleDesc {
+  Out *__restrict__ out;
+  const In *__restrict__ in;
+  ivec2 in_size, out_size;
+  int channels;
+  /// @brief The source position of output (x, y) is `origin + (x, y) * scale`
+  vec2 origin, scale;
+  /// @brief The radius of the triangular filter, in source pixels
+  vec2 radius;
+  float mean[ResizeCropMirrorNormalizeArgs::kMaxChannels];
+  float inv_stddev[ResizeCropMirrorNormalizeArgs::kMaxChannels];
+};
+
+/**
+ * @brief Resamples the region of interest of the HWC input with a triangular filter and writes
+ *        the normalized result (HWC or CHW)
+ *
+ * The filter radius is 1 when upscaling (bilinear interpolation) and equal to the scale when
+ * downscaling (antialiasing) - as the Triangular/Linear filters in the separable resampling.
+ * One thread calculates all channels of one output pixel.
+ */
+template <bool channel_first, typename Out, typename In>
+__global__ void ResizeCropMirrorNormalizeKernel(const SampleDesc<Out, In> *samples) {
+  constexpr int kMaxChannels = ResizeCropMirrorNormalizeArgs::kMaxChannels;
+  const auto &sample = samples[blockIdx.z];
+  int x = blockIdx.x * blockDim.x + threadIdx.x;
+  int y = blockIdx.y * blockDim.y + threadIdx.y;
+  if (x >= sample.out_size.x || y >= sample.out_size.y)
+    return;
+
+  int channels = sample.channels;
+  int in_w = sample.in_size.x, in_h = sample.in_size.y;
+  // the center of the output pixel, in source coordinates, shifted so that the source pixel
+  // centers are at integer positions
+  float sx = fmaf(x + 0.5f, sample.scale.x, sample.origin.x) - 0.5f;
+  float sy = fmaf(y + 0.5f, sample.scale.y, sample.origin.y) - 0.5f;
+  float rx = sample.radius.x, ry = sample.radius.y;
+  float inv_rx = 1.0f / rx, inv_ry = 1.0f / ry;
+  int x0 = __float2int_ru(sx - rx), x1 = __float2int_rd(sx + rx);
+  int y0 = __float2int_ru(sy - ry), y1 = __float2int_rd(sy + ry);
+
+  float acc[kMaxChannels] = { 0, 0, 0, 0 };
+  float total_weight = 0;
+  for (int sy_i = y0; sy_i <= y1; sy_i++) {
+    float wy = 1.0f - fabsf(sy_i - sy) * inv_ry;
+    if (wy <= 0)
+      continue;
+    int row = clamp(sy_i, 0, in_h - 1);
+    const In *in_row = sample.in + static_cast<int64_t>(row) * in_w * channels;
+    for (int sx_i = x0; sx_i <= x1; sx_i++) {
+      float wx = 1.0f - fabsf(sx_i - sx) * inv_rx;
+      if (wx <= 0)
+        continue;
+      float w = wx * wy;
+      const In *px = in_row + clamp(sx_i, 0, in_w - 1) * channels;
+      #pragma unroll
+      for (int c = 0; c < kMaxChannels; c++) {
+        if (c < channels)
+          acc[c] = fmaf(w, __ldg(px + c), acc[c]);
+      }
+      total_weight += w;
+    }
+  }
+
+  float norm = 1.0f / total_weight;
+  int64_t out_plane = static_cast<int64_t>(sample.out_size.x) * sample.out_size.y;
+  int64_t out_px = static_cast<int64_t>(y) * sample.out_size.x + x;
+  #pragma unroll
+  for (int c = 0; c < kMaxChannels; c++) {
+    if (c < channels) {
+      float v = (acc[c] * norm - sample.mean[c]) * sample.inv_stddev[c];
+      int64_t out_idx = channel_first ? c * out_plane + out_px : out_px * channels + c;
+      sample.out[out_idx] = ConvertSat<Out>(v);
+    }
+  }
+}
+
+}  // namespace rcmn
+
+/**
+ * @brief Resizes a region of interest of HWC images, optionally mirrors it horizontally and
+ *        normalizes it, in one pass
+ *
+ * It fuses a (random) resized crop with CropMirrorNormalize: the output is calculated directly
+ * from the input image, without a resized intermediate image.
+ * The resampling uses a triangular filter (see rcmn::ResizeCropMirrorNormalizeKernel).
+ * The output is HWC or CHW (`channel_first`). Up to 4 channels are supported.
+ */
+template <typename Out, typename In>
+class ResizeCropMirrorNormalizeGPU {
+ public:
+  static constexpr int kMaxChannels = ResizeCropMirrorNormalizeArgs::kMaxChannels;
+
+  KernelRequirements Setup(KernelContext &context,
+                           const InListGPU<In, 3> &in,
+                           span<const ResizeCropMirrorNormalizeArgs> args,
+                           bool channel_first) {
+    int N = in.num_samples();
+    DALI_ENFORCE(static_cast<int>(args.size()) == N,
+                 "The number of sample arguments must match the number of samples");
+    KernelRequirements req;
+    TensorListShape<3> out_shape(N);
+    for (int i = 0; i < N; i++) {
+      auto in_shape = in.shape[i];
+      int64_t channels = in_shape[2];
+      DALI_ENFORCE(channels >= 1 && channels <= kMaxChannels, make_string(
+        "The number of channels must be between 1 and ", kMaxChannels, ", got ", channels));
+      const auto &out_size = args[i].out_size;
+      DALI_ENFORCE(out_size.x > 0 && out_size.y > 0, make_string(
+        "The output size must be positive, got ", out_size.x, "x", out_size.y));
+      if (channel_first)
+        out_shape.set_tensor_shape(i, { channels, out_size.y, out_size.x });
+      else
+        out_shape.set_tensor_shape(i, { out_size.y, out_size.x, channels });
+    }
+    req.output_shapes = { out_shape };
+    return req;
+  }
+
+  void Run(KernelContext &context,
+           const OutListGPU<Out, 3> &out,
+           const InListGPU<In, 3> &in,
+           span<const ResizeCropMirrorNormalizeArgs> args,
+           bool channel_first) {
+    int N = in.num_samples();
+    if (N == 0)
+      return;
+    samples_.resize(N);
+    ivec2 max_size = { 0, 0 };
+    for (int i = 0; i < N; i++) {
+      auto &s = samples_[i];
+      auto &a = args[i];
+      auto in_shape = in.shape[i];
+      s.out = out.tensor_data(i);
+      s.in = in.tensor_data(i);
+      s.in_size = { static_cast<int>(in_shape[1]), static_cast<int>(in_shape[0]) };
+      s.out_size = a.out_size;
+      s.channels = in_shape[2];
+      vec2 roi_size = a.roi_hi - a.roi_lo;
+      s.scale = roi_size / vec2(a.out_size);
+      s.origin = a.roi_lo;
+      if (a.mirror) {
+        s.origin.x = a.roi_hi.x;
+        s.scale.x = -s.scale.x;
+      }
+      s.radius = { std::max(1.0f, std::abs(s.scale.x)), std::max(1.0f, std::abs(s.scale.y)) };
+      for (int c = 0; c < kMaxChannels; c++) {
+        s.mean[c] = a.mean[c];
+        s.inv_stddev[c] = a.inv_stddev[c];
+      }
+      max_size.x = std::max(max_size.x, a.out_size.x);
+      max_size.y = std::max(max_size.y, a.out_size.y);
+    }
+
+    auto *gpu_samples = context.scratchpad->ToGPU(context.gpu.stream, samples_);
+    dim3 block(32, 8);
+    dim3 grid(div_ceil(max_size.x, block.x), div_ceil(max_size.y, block.y), N);
+    if (channel_first) {
+      rcmn::ResizeCropMirrorNormalizeKernel<true>
+        <<<grid, block, 0, context.gpu.stream>>>(gpu_samples);
+    } else {
+      rcmn::ResizeCropMirrorNormalizeKernel<false>
+        <<<grid, block, 0, context.gpu.stream>>>(gpu_samples);
+    }
+    CUDA_CALL(cudaGetLastError());
+  }
+
+ private:
+  std::vector<rcmn::SampleDesc<Out, In>> samples_;
+};
+
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_IMGPROC_RESIZE_CROP_MIRROR_NORMALIZE_GPU_CUH_
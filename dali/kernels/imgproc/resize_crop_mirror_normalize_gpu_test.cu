@@ -0,0 +1,129 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/kernels/imgproc/resize_crop_mirror_normalize_gpu.cuh"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/test/test_tensors.h"
+#include "dali/test/tensor_test_utils.h"
+
+namespace dali {
+namespace kernels {
+
+namespace {
+
+/**
+ * @brief Separable triangular filter reference
+ */
+void RefResizeCropMirrorNormalize(float *out, const uint8_t *in, TensorShape<3> in_shape,
+                                  const ResizeCropMirrorNormalizeArgs &args, bool channel_first) {
+  int in_h = in_shape[0], in_w = in_shape[1], C = in_shape[2];
+  int out_w = args.out_size.x, out_h = args.out_size.y;
+  double scale_x = (args.roi_hi.x - args.roi_lo.x) / out_w;
+  double scale_y = (args.roi_hi.y - args.roi_lo.y) / out_h;
+  double rx = std::max(1.0, scale_x), ry = std::max(1.0, scale_y);
+  for (int y = 0; y < out_h; y++) {
+    double sy = args.roi_lo.y + (y + 0.5) * scale_y - 0.5;
+    for (int x = 0; x < out_w; x++) {
+      int src_x = args.mirror ? out_w - 1 - x : x;
+      double sx = args.roi_lo.x + (src_x + 0.5) * scale_x - 0.5;
+      for (int c = 0; c < C; c++) {
+        double acc = 0, total = 0;
+        for (int i = std::ceil(sy - ry); i <= std::floor(sy + ry); i++) {
+          double wy = std::max(0.0, 1 - std::abs(i - sy) / ry);
+          int row = clamp(i, 0, in_h - 1);
+          for (int j = std::ceil(sx - rx); j <= std::floor(sx + rx); j++) {
+            double wx = std::max(0.0, 1 - std::abs(j - sx) / rx);
+            int col = clamp(j, 0, in_w - 1);
+            acc += wx * wy * in[(row * in_w + col) * C + c];
+            total += wx * wy;
+          }
+        }
+        float v = (acc / total - args.mean[c]) * args.inv_stddev[c];
+        int64_t idx = channel_first ? (c * out_h + y) * out_w + x : (y * out_w + x) * C + c;
+        out[idx] = v;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+class ResizeCropMirrorNormalizeGPUTest : public ::testing::TestWithParam<bool> {};
+
+TEST_P(ResizeCropMirrorNormalizeGPUTest, CompareWithReference) {
+  bool channel_first = GetParam();
+  TensorListShape<3> in_shape = {{ 100, 120, 3 }, { 40, 30, 3 }, { 200, 50, 1 }, { 33, 77, 4 }};
+  int N = in_shape.num_samples();
+  TestTensorList<uint8_t, 3> in;
+  in.reshape(in_shape);
+  std::mt19937_64 rng(1234);
+  UniformRandomFill(in.cpu(), rng, 0, 255);
+
+  std::vector<ResizeCropMirrorNormalizeArgs> args(N);
+  // downscaling
+  args[0].roi_lo = { 10, 20 };
+  args[0].roi_hi = { 110, 90 };
+  args[0].out_size = { 24, 16 };
+  args[0].mirror = true;
+  // upscaling
+  args[1].roi_lo = { 5, 5 };
+  args[1].roi_hi = { 25, 35 };
+  args[1].out_size = { 50, 64 };
+  // mixed, fractional ROI
+  args[2].roi_lo = { 0.5f, 10.25f };
+  args[2].roi_hi = { 50, 190.75f };
+  args[2].out_size = { 64, 30 };
+  args[2].mirror = true;
+  // whole image
+  args[3].roi_lo = { 0, 0 };
+  args[3].roi_hi = { 77, 33 };
+  args[3].out_size = { 32, 32 };
+  for (auto &a : args) {
+    for (int c = 0; c < ResizeCropMirrorNormalizeArgs::kMaxChannels; c++) {
+      a.mean[c] = 100 + 10 * c;
+      a.inv_stddev[c] = 1.0f / (50 + 5 * c);
+    }
+  }
+
+  ResizeCropMirrorNormalizeGPU<float, uint8_t> kernel;
+  KernelContext ctx;
+  ctx.gpu.stream = 0;
+  auto req = kernel.Setup(ctx, in.gpu(), make_cspan(args), channel_first);
+  ASSERT_EQ(req.output_shapes.size(), 1u);
+  TestTensorList<float, 3> out;
+  out.reshape(req.output_shapes[0].to_static<3>());
+  DynamicScratchpad scratchpad({}, AccessOrder(ctx.gpu.stream));
+  ctx.scratchpad = &scratchpad;
+  kernel.Run(ctx, out.gpu(), in.gpu(), make_cspan(args), channel_first);
+
+  auto out_cpu = out.cpu();
+  auto in_cpu = in.cpu();
+  for (int i = 0; i < N; i++) {
+    std::vector<float> ref(volume(out_cpu.shape[i]));
+    RefResizeCropMirrorNormalize(ref.data(), in_cpu.tensor_data(i), in_shape[i], args[i],
+                                 channel_first);
+    auto ref_view = make_tensor_cpu<3>(ref.data(), out_cpu.shape[i]);
+    Check(out_cpu[i], ref_view, EqualEps(1e-4));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(ResizeCropMirrorNormalizeGPUTest, ResizeCropMirrorNormalizeGPUTest,
+                         ::testing::Values(false, true));
+
+}  // namespace kernels
+}  // namespace dali
@@ -0,0 +1,291 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_IMGPROC_STRUCTURE_CONNECTED_COMPONENTS_GPU_CUH_
+#define DALI_KERNELS_IMGPROC_STRUCTURE_CONNECTED_COMPONENTS_GPU_CUH_
+
+#include <cuda_runtime.h>
+#include <algorithm>
+#include <climits>
+#include "dali/core/cuda_error.h"
+#include "dali/core/tensor_shape.h"
+#include "dali/core/util.h"
+
+namespace dali {
+namespace kernels {
+namespace connected_components {
+
+constexpr int kMaxBlobDims = 6;
+
+/**
+ * @brief A blob of connected elements with equal (non-background) input labels.
+ */
+struct BlobInfo {
+  /// Flat index of the first element of the blob (in the raster order)
+  int64_t first;
+  /// Input label of the blob's elements
+  int label;
+  /// Bounding box of the blob (`hi` is exclusive)
+  int lo[kMaxBlobDims], hi[kMaxBlobDims];
+};
+
+namespace detail {
+
+struct ShapeDesc {
+  int ndim;
+  int64_t volume;
+  int64_t shape[kMaxBlobDims];
+  int64_t strides[kMaxBlobDims];
+};
+
+inline ShapeDesc GetShapeDesc(const TensorShape<> &shape) {
+  assert(shape.sample_dim() <= kMaxBlobDims);
+  ShapeDesc desc;
+  desc.ndim = shape.sample_dim();
+  int64_t stride = 1;
+  for (int d = desc.ndim - 1; d >= 0; d--) {
+    desc.shape[d] = shape[d];
+    desc.strides[d] = stride;
+    stride *= shape[d];
+  }
+  desc.volume = stride;
+  return desc;
+}
+
+inline __device__ int AtomicMin(int *addr, int value) {
+  return atomicMin(addr, value);
+}
+
+inline __device__ int64_t AtomicMin(int64_t *addr, int64_t value) {
+  return atomicMin(reinterpret_cast<long long *>(addr), static_cast<long long>(value));  // NOLINT
+}
+
+/**
+ * @brief Finds the root of the set containing `x`
+ *
+ * The parents are only ever decreased, so a stale read still yields an element of the same set.
+ */
+template <typename Label>
+__device__ Label FindRoot(const Label *labels, Label x) {
+  Label parent = labels[x];
+  while (parent != x) {
+    x = parent;
+    parent = labels[x];
+  }
+  return x;
+}
+
+/**
+ * @brief Merges the sets containing `a` and `b`; the root with the lower index becomes the root
+ *        of the merged set (like in the CPU disjoint_set), so the root is the first element.
+ */
+template <typename Label>
+__device__ void Merge(Label *labels, Label a, Label b) {
+  bool done;
+  do {
+    a = FindRoot(labels, a);
+    b = FindRoot(labels, b);
+    if (a < b) {
+      Label old = AtomicMin(&labels[b], a);
+      done = old == b;
+      b = old;
+    } else if (b < a) {
+      Label old = AtomicMin(&labels[a], b);
+      done = old == a;
+      a = old;
+    } else {
+      done = true;
+    }
+  } while (!done);
+}
+
+template <typename Label, typename T>
+__global__ void InitLabelsKernel(Label *labels, const T *in, int64_t n, T background) {
+  for (int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; i < n;
+       i += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    labels[i] = in[i] != background ? static_cast<Label>(i) : static_cast<Label>(-1);
+  }
+}
+
+template <typename Label, typename T>
+__global__ void MergeLabelsKernel(Label *labels, const T *in, ShapeDesc shape) {
+  for (int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; i < shape.volume;
+       i += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    if (labels[i] < 0)
+      continue;
+    T value = in[i];
+    for (int d = 0; d < shape.ndim; d++) {
+      int64_t stride = shape.strides[d];
+      if ((i / stride) % shape.shape[d] > 0 && in[i - stride] == value)
+        Merge<Label>(labels, i, i - stride);
+    }
+  }
+}
+
+template <typename Label>
+__global__ void FlattenLabelsKernel(Label *labels, int64_t n, int *num_blobs) {
+  for (int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; i < n;
+       i += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    if (labels[i] < 0)
+      continue;
+    Label root = FindRoot<Label>(labels, i);
+    labels[i] = root;
+    if (root == i)
+      atomicAdd(num_blobs, 1);
+  }
+}
+
+/**
+ * @brief Assigns consecutive blob indices to the roots, storing them in the labels
+ *        as `-2 - blob_index`
+ */
+template <typename Label, typename T>
+__global__ void InitBlobsKernel(BlobInfo *blobs, Label *labels, const T *in, ShapeDesc shape,
+                                int *counter) {
+  for (int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; i < shape.volume;
+       i += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    if (labels[i] != i)
+      continue;
+    int blob = atomicAdd(counter, 1);
+    labels[i] = -2 - blob;
+    BlobInfo &info = blobs[blob];
+    info.first = i;
+    info.label = in[i];
+    for (int d = 0; d < shape.ndim; d++) {
+      int coord = (i / shape.strides[d]) % shape.shape[d];
+      info.lo[d] = coord;
+      info.hi[d] = coord + 1;
+    }
+  }
+}
+
+/**
+ * @brief Extends the boxes of the blobs to all their elements.
+ *
+ * The updates are reduced within a warp when all its elements belong to one blob (which is
+ * the common case for large objects), so that they don't contend for the same atomics.
+ */
+template <typename Label>
+__global__ void BlobBoxesKernel(BlobInfo *blobs, const Label *labels, ShapeDesc shape) {
+  const unsigned full_mask = 0xffffffffu;
+  int lane = threadIdx.x % 32;
+  // The loop condition is uniform within a warp, so that all lanes take part in the reduction.
+  for (int64_t base = blockIdx.x * static_cast<int64_t>(blockDim.x); base < shape.volume;
+       base += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    int64_t i = base + threadIdx.x;
+    int blob = -1;
+    if (i < shape.volume) {
+      Label label = labels[i];
+      if (label >= 0)
+        label = labels[label];
+      if (label != -1)
+        blob = -2 - label;
+    }
+    unsigned valid = __ballot_sync(full_mask, blob >= 0);
+    if (!valid)
+      continue;
+    int leader = __ffs(valid) - 1;
+    int leader_blob = __shfl_sync(full_mask, blob, leader);
+    bool uniform = __all_sync(full_mask, blob < 0 || blob == leader_blob);
+    for (int d = 0; d < shape.ndim; d++) {
+      int coord = blob >= 0 ? (i / shape.strides[d]) % shape.shape[d] : 0;
+      if (uniform) {
+        int lo = blob >= 0 ? coord : INT_MAX;
+        int hi = blob >= 0 ? coord + 1 : INT_MIN;
+        for (int offset = 16; offset > 0; offset /= 2) {
+          lo = min(lo, __shfl_xor_sync(full_mask, lo, offset));
+          hi = max(hi, __shfl_xor_sync(full_mask, hi, offset));
+        }
+        if (lane == leader) {
+          atomicMin(&blobs[leader_blob].lo[d], lo);
+          atomicMax(&blobs[leader_blob].hi[d], hi);
+        }
+      } else if (blob >= 0) {
+        atomicMin(&blobs[blob].lo[d], coord);
+        atomicMax(&blobs[blob].hi[d], coord + 1);
+      }
+    }
+  }
+}
+
+inline int GetGridSize(int64_t n, int block_size) {
+  return std::max<int64_t>(1, std::min<int64_t>(div_ceil(n, block_size), 4096));
+}
+
+}  // namespace detail
+
+/**
+ * @brief Labels the blobs of connected elements with equal input labels, excluding the
+ *        `background`, and counts them.
+ *
+ * Two elements are connected when they are neighbors along one of the axes. This is the GPU
+ * (union-find) counterpart of LabelConnectedRegions - the elements of a blob are set to the flat
+ * index of its first element and the background elements are set to -1.
+ *
+ * @tparam Label      type of the labels; must be able to hold the flat index of any element
+ * @param labels      output labels, with the same number of elements as `in`
+ * @param in          the input labels, with `shape`
+ * @param background  the input label denoting the background
+ * @param num_blobs   device pointer to the number of blobs, incremented by the number of blobs
+ *                    found (it should be zeroed)
+ */
+template <typename Label, typename T>
+void LabelConnectedRegionsGPU(Label *labels, const T *in, const TensorShape<> &shape,
+                              T background, int *num_blobs, cudaStream_t stream) {
+  auto desc = detail::GetShapeDesc(shape);
+  if (desc.volume == 0)
+    return;
+  const int block_size = 256;
+  int grid_size = detail::GetGridSize(desc.volume, block_size);
+  detail::InitLabelsKernel<<<grid_size, block_size, 0, stream>>>(
+      labels, in, desc.volume, background);
+  CUDA_CALL(cudaGetLastError());
+  detail::MergeLabelsKernel<<<grid_size, block_size, 0, stream>>>(labels, in, desc);
+  CUDA_CALL(cudaGetLastError());
+  detail::FlattenLabelsKernel<<<grid_size, block_size, 0, stream>>>(
+      labels, desc.volume, num_blobs);
+  CUDA_CALL(cudaGetLastError());
+}
+
+/**
+ * @brief Calculates the labels and bounding boxes of the blobs found with
+ *        LabelConnectedRegionsGPU.
+ *
+ * The blobs are stored in an unspecified order - they can be sorted by BlobInfo::first to get
+ * the order of the blob labels produced on the CPU.
+ *
+ * @param blobs     output blobs, with room for the number of blobs found in `labels`
+ * @param labels    the labels produced by LabelConnectedRegionsGPU; they're overwritten
+ * @param in        the input of LabelConnectedRegionsGPU
+ * @param counter   device pointer to a zeroed counter, used to assign the blob indices
+ */
+template <typename Label, typename T>
+void GetBlobsGPU(BlobInfo *blobs, Label *labels, const T *in, const TensorShape<> &shape,
+                 int *counter, cudaStream_t stream) {
+  auto desc = detail::GetShapeDesc(shape);
+  if (desc.volume == 0)
+    return;
+  const int block_size = 256;
+  int grid_size = detail::GetGridSize(desc.volume, block_size);
+  detail::InitBlobsKernel<<<grid_size, block_size, 0, stream>>>(blobs, labels, in, desc, counter);
+  CUDA_CALL(cudaGetLastError());
+  detail::BlobBoxesKernel<<<grid_size, block_size, 0, stream>>>(blobs, labels, desc);
+  CUDA_CALL(cudaGetLastError());
+}
+
+}  // namespace connected_components
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_IMGPROC_STRUCTURE_CONNECTED_COMPONENTS_GPU_CUH_
@@ -0,0 +1,111 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "dali/core/dev_buffer.h"
+#include "dali/kernels/imgproc/structure/connected_components.h"
+#include "dali/kernels/imgproc/structure/connected_components_gpu.cuh"
+#include "dali/kernels/imgproc/structure/label_bbox.h"
+#include "dali/test/tensor_test_utils.h"
+
+namespace dali {
+namespace kernels {
+namespace connected_components {
+
+template <int ndim>
+void CompareWithCPU(const std::vector<int> &input, const TensorShape<ndim> &shape, int bg) {
+  int64_t n = volume(shape);
+  ASSERT_EQ(static_cast<int64_t>(input.size()), n);
+
+  std::vector<int64_t> ref_labels(n);
+  auto in_tv = make_tensor_cpu<ndim>(input.data(), shape);
+  auto ref_tv = make_tensor_cpu<ndim>(ref_labels.data(), shape);
+  int64_t ref_nblobs = LabelConnectedRegions<int64_t, int, ndim>(ref_tv, in_tv, -1, bg);
+  std::vector<Box<ndim, int>> ref_boxes(ref_nblobs);
+  label_bbox::GetLabelBoundingBoxes(make_span(ref_boxes), make_tensor_cpu<ndim>(
+      static_cast<const int64_t *>(ref_labels.data()), shape), int64_t(-1));
+
+  DeviceBuffer<int> in_gpu, counters;
+  DeviceBuffer<int32_t> labels;
+  in_gpu.from_host(input);
+  labels.resize(n);
+  counters.resize(2);
+  CUDA_CALL(cudaMemset(counters.data(), 0, 2 * sizeof(int)));
+  LabelConnectedRegionsGPU(labels.data(), in_gpu.data(), shape, bg, counters.data(), 0);
+  int nblobs = 0;
+  CUDA_CALL(cudaMemcpy(&nblobs, counters.data(), sizeof(int), cudaMemcpyDeviceToHost));
+  ASSERT_EQ(nblobs, ref_nblobs);
+
+  DeviceBuffer<BlobInfo> blobs_gpu;
+  blobs_gpu.resize(nblobs);
+  GetBlobsGPU(blobs_gpu.data(), labels.data(), in_gpu.data(), shape, counters.data() + 1, 0);
+  std::vector<BlobInfo> blobs(nblobs);
+  copyD2H(blobs.data(), blobs_gpu.data(), nblobs);
+  CUDA_CALL(cudaDeviceSynchronize());
+  std::sort(blobs.begin(), blobs.end(), [](const BlobInfo &a, const BlobInfo &b) {
+    return a.first < b.first;
+  });
+
+  for (int i = 0; i < nblobs; i++) {
+    auto &blob = blobs[i];
+    ASSERT_EQ(ref_labels[blob.first], i) << "The blobs are not in the raster order";
+    EXPECT_EQ(blob.label, input[blob.first]);
+    for (int d = 0; d < ndim; d++) {
+      EXPECT_EQ(blob.lo[d], ref_boxes[i].lo[d]) << "blob " << i << ", dim " << d;
+      EXPECT_EQ(blob.hi[d], ref_boxes[i].hi[d]) << "blob " << i << ", dim " << d;
+    }
+  }
+}
+
+TEST(ConnectedComponentsGPU, 2D) {
+  const int H = 5;
+  const int W = 8;
+  std::vector<int> objects = {
+     5,  5,  5,  5,  2,  2,  2,  2,
+     5,  5,  3,  5,  2,  2,  3,  2,
+    -2,  5,  3,  3,  3,  3,  3,  2,
+    -2, -2, -2, -2, -2,  3, -2,  2,
+     5,  5,  3,  3,  3,  3,  2, -2,
+  };
+  CompareWithCPU(objects, TensorShape<2>{H, W}, -2);
+}
+
+TEST(ConnectedComponentsGPU, Random3D) {
+  std::mt19937_64 rng(1234);
+  TensorShape<3> shape = { 13, 67, 129 };
+  std::vector<int> input(volume(shape));
+  // Random walk along the rows, so that there are both large blobs and scattered elements.
+  std::uniform_int_distribution<int> label_dist(0, 3);
+  std::bernoulli_distribution change(0.05);
+  int label = 0;
+  for (auto &x : input) {
+    if (change(rng))
+      label = label_dist(rng);
+    x = label;
+  }
+  CompareWithCPU(input, shape, 0);
+}
+
+TEST(ConnectedComponentsGPU, AllForeground) {
+  TensorShape<1> shape = { 100000 };
+  std::vector<int> input(volume(shape), 1);
+  CompareWithCPU(input, shape, 0);
+}
+
+}  // namespace connected_components
+}  // namespace kernels
+}  // namespace dali
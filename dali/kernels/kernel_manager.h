@@ -179,7 +179,8 @@ class DLL_PUBLIC KernelManager {
    * @param context        - context for the kernel
    *                         * should contain valid CUDA stream for GPU kernels;
    *                         * if scratchpad pointer is null, a temporary dynamic scratchpad is
-   *                           created
+   *                           created; within a ScratchArenaScope, its device memory comes from
+   *                           the arena shared by all the operators of the stage
    * @param out_in_args    - pack of arguments (outputs, inputs, arguments) used in Kernel::Run
    */
   template <typename Kernel, typename... OutInArgs>
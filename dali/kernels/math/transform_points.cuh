@@ -15,9 +15,12 @@
 #ifndef DALI_KERNELS_MATH_TRANSFORM_POINTS_CUH_
 #define DALI_KERNELS_MATH_TRANSFORM_POINTS_CUH_
 
+#include <algorithm>
+#include <vector>
 #include "dali/core/convert.h"
 #include "dali/core/geom/mat.h"
 #include "dali/core/format.h"
+#include "dali/kernels/common/flat_batch.h"
 #include "dali/kernels/kernel.h"
 
 namespace dali {
@@ -52,6 +55,34 @@ __global__ void TransformPointsKernel(
   }
 }
 
+/**
+ * @brief Transforms the points of a densely packed batch - used when there are many small samples
+ *
+ * The sample to which a point belongs is found in `offsets` (a prefix sum of the number of
+ * points in the samples); only the M and T fields of the descriptors are used.
+ */
+template <typename Out, typename In, int out_pt_dim, int in_pt_dim>
+__global__ void TransformPointsFlatKernel(
+      Out *__restrict__ out, const In *__restrict__ in,
+      const TransformPointsSampleDesc<Out, In, out_pt_dim, in_pt_dim> *descs,
+      const int64_t *offsets, int nsamples) {
+  int64_t size = offsets[nsamples];
+  int64_t grid_stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+  int64_t start_idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  for (int64_t idx = start_idx; idx < size; idx += grid_stride) {
+    const auto &desc = descs[FlatSampleIdx(offsets, nsamples, idx)];
+    vec<in_pt_dim> v_in;
+    #pragma unroll
+    for (int c = 0; c < in_pt_dim; c++)
+      v_in[c] = in[idx * in_pt_dim + c];
+
+    vec<out_pt_dim> v_out = desc.M * v_in + desc.T;
+
+    #pragma unroll
+    for (int c = 0; c < out_pt_dim; c++)
+      out[idx * out_pt_dim + c] = ConvertSat<Out>(v_out[c]);
+  }
+}
 
 template <typename Out, typename In, int out_pt_dim, int in_pt_dim>
 class TransformPointsGPU {
@@ -66,6 +97,7 @@ class TransformPointsGPU {
     int N = in_shape.num_samples();
     se.add<mm::memory_kind::pinned, SampleDesc>(N);
     se.add<mm::memory_kind::device, SampleDesc>(N);
+    se.add<mm::memory_kind::device, int64_t>(N + 1);  // sample offsets for the flat variant
 
     req.scratch_sizes = se.sizes;
     return req;
@@ -93,6 +125,20 @@ class TransformPointsGPU {
     }
     auto *gpu_descs = ctx.scratchpad->ToGPU(ctx.gpu.stream, make_span(host_descs, N));
     const int block = 256;
+
+    Out *out_flat = DenselyPackedData(out);
+    const In *in_flat = DenselyPackedData(in);
+    if (out_flat && in_flat) {
+      // No grid is spent on padding each sample's size to the largest sample
+      FlatSampleOffsets(offsets_, in.shape, in_pt_dim);
+      auto *gpu_offsets = ctx.scratchpad->ToGPU(ctx.gpu.stream, offsets_);
+      int grid = std::min<int64_t>(div_ceil(offsets_[N], block), 1024);
+      TransformPointsFlatKernel<<<grid, block, 0, ctx.gpu.stream>>>(
+          out_flat, in_flat, gpu_descs, gpu_offsets, N);
+      CUDA_CALL(cudaGetLastError());
+      return;
+    }
+
     dim3 grid = GetGridSize(max_size, N, block);
     TransformPointsKernel<<<grid, block, 0, ctx.gpu.stream>>>(gpu_descs);
     CUDA_CALL(cudaGetLastError());
@@ -120,6 +166,8 @@ class TransformPointsGPU {
     int blocks_per_sample = div_ceil(max_blocks, 4);
     return dim3(std::min(blocks_per_sample, 1024), num_samples);
   }
+
+  std::vector<int64_t> offsets_;
 };
 
 }  // namespace kernels
@@ -1,4 +1,4 @@
-// Copyright (c) 2020, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <vector>
 #include "dali/kernels/kernel_manager.h"
 #include "dali/kernels/math/transform_points.h"
@@ -35,11 +36,13 @@ struct TransformPointsTest : ::testing::Test {
       { 480, 640, in_dim },
       { 100, 120, in_dim }
     }};
+    PrepareData(shape);
+  }
 
-    TensorListShape<3> out_shape = {{
-      { 480, 640, out_dim },
-      { 100, 120, out_dim }
-    }};
+  void PrepareData(const TensorListShape<3> &shape) {
+    TensorListShape<3> out_shape = shape;
+    for (int i = 0; i < shape.num_samples(); i++)
+      out_shape.tensor_shape_span(i)[2] = out_dim;
 
     in_data_.reshape(shape);
     out_data_.reshape(out_shape);
@@ -84,8 +87,11 @@ struct TransformPointsTest : ::testing::Test {
     }
   }
 
-  void RunGPU() {
-    PrepareData();
+  /**
+   * @param reverse_order - if true, the kernel sees the samples in reverse order, so the batch
+   *                        is not densely packed and the per-sample variant is used
+   */
+  void RunGPU(bool reverse_order = false) {
     using Kernel = TransformPointsGPU<Out, In, out_dim, in_dim>;
     auto dist = uniform_distribution<float>(-0.5, 0.5);
     auto t_dist = uniform_distribution<float>(min_value<In>() / 2, max_value<In>() / 2);
@@ -102,12 +108,28 @@ struct TransformPointsTest : ::testing::Test {
         T[s][i] = t_dist(rng_);
       }
 
+    auto run_M = M;
+    auto run_T = T;
+    if (reverse_order) {
+      auto reverse = [N](auto &tlv) {
+        auto copy = tlv;
+        for (int i = 0; i < N; i++) {
+          tlv.data[i] = copy.data[N - 1 - i];
+          tlv.shape.set_tensor_shape(i, copy.shape[N - 1 - i]);
+        }
+      };
+      reverse(in_gpu);
+      reverse(out_gpu);
+      std::reverse(run_M.begin(), run_M.end());
+      std::reverse(run_T.begin(), run_T.end());
+    }
+
     kmgr_.Resize<Kernel>(1);
     KernelContext ctx;
     ctx.gpu.stream = 0;
     auto &req = kmgr_.Setup<Kernel>(0, ctx, in_gpu.shape);
     ASSERT_EQ(req.output_shapes[0], out_gpu.shape);
-    kmgr_.Run<Kernel>(0, ctx, out_gpu, in_gpu, make_span(M), make_span(T));
+    kmgr_.Run<Kernel>(0, ctx, out_gpu, in_gpu, make_span(run_M), make_span(run_T));
 
     auto in_cpu = in_data_.cpu();
     auto out_cpu = out_data_.cpu();
@@ -140,7 +162,23 @@ TEST_F(TransformPointsTest, CPU) {
 }
 
 TEST_F(TransformPointsTest, GPU) {
+  PrepareData();
+  RunGPU();
+}
+
+TEST_F(TransformPointsTest, GPUNotPacked) {
+  PrepareData();
+  RunGPU(true);
+}
+
+TEST_F(TransformPointsTest, GPUManySmallSamples) {
+  TensorListShape<3> shape(1000, 3);
+  for (int i = 0; i < shape.num_samples(); i++)
+    shape.set_tensor_shape(i, { 1, i % 7, in_dim });  // some samples are empty
+  PrepareData(shape);
   RunGPU();
+  PrepareData(shape);
+  RunGPU(true);
 }
 
 }  // namespace kernels
@@ -0,0 +1,380 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_REDUCE_MEAN_INV_STDDEV_GPU_CUH_
+#define DALI_KERNELS_REDUCE_MEAN_INV_STDDEV_GPU_CUH_
+
+#include <cuda_runtime.h>
+#include <algorithm>
+#include <vector>
+#include "dali/core/cuda_error.h"
+#include "dali/core/error_handling.h"
+#include "dali/core/fast_div.h"
+#include "dali/core/format.h"
+#include "dali/core/math_util.h"
+#include "dali/core/span.h"
+#include "dali/core/tensor_view.h"
+#include "dali/kernels/kernel.h"
+#include "dali/kernels/reduce/reduce_setup_utils.h"
+
+namespace dali {
+namespace kernels {
+namespace mean_inv_stddev {
+
+/**
+ * @brief Partial result of Welford's online mean and variance algorithm
+ */
+struct WelfordState {
+  float mean = 0;
+  float m2 = 0;  ///< sum of squared differences from the mean
+  int64_t n = 0;
+
+  __host__ __device__ void add(float x) {
+    n++;
+    float d = x - mean;
+    mean += d / n;
+    m2 += d * (x - mean);
+  }
+
+  /// @brief Merges two partial results (Chan et al.)
+  __host__ __device__ void add(const WelfordState &other) {
+    if (other.n == 0)
+      return;
+    if (n == 0) {
+      *this = other;
+      return;
+    }
+    int64_t total = n + other.n;
+    float d = other.mean - mean;
+    float wb = static_cast<float>(other.n) / total;
+    mean += d * wb;
+    m2 += other.m2 + d * d * n * wb;
+    n = total;
+  }
+};
+
+/// @brief The maximum number of (merged) reduced or non-reduced dimensions
+constexpr int kMaxGroups = 8;
+
+/**
+ * @brief Describes the reduction of one input sample
+ *
+ * The sample is viewed as a set of outputs (the non-reduced dimensions) and each output
+ * as `reduced_size` reduced elements. The reduced elements of each output are split into
+ * `nchunks` interleaved chunks - chunk `j` gets the elements `j, j + nchunks, j + 2*nchunks...`
+ * - so that the consecutive threads access consecutive (or nearly consecutive) elements.
+ */
+template <typename In>
+struct SampleDesc {
+  const In *__restrict__ in;
+  WelfordState *partials;  ///< one partial result per (output, chunk) pair
+  int64_t num_outputs, reduced_size, num_items;
+  int nchunks;
+  /// @brief If true, the chunk index is the fastest-changing in the partials (innermost reduced)
+  bool chunk_fastest;
+  int out_ndim, red_ndim;
+  fast_div<uint64_t> out_shape[kMaxGroups], red_shape[kMaxGroups];
+  int64_t out_strides[kMaxGroups], red_strides[kMaxGroups];
+};
+
+struct OutputDesc {
+  float *mean, *inv_stddev;
+  int64_t num_outputs;
+};
+
+__device__ inline int64_t GroupOffset(uint64_t idx, int ndim, const fast_div<uint64_t> *shape,
+                                      const int64_t *strides) {
+  int64_t offset = 0;
+  for (int d = ndim - 1; d > 0; d--) {
+    uint64_t m;
+    idx = div_mod(m, idx, shape[d]);
+    offset += m * strides[d];
+  }
+  return offset + idx * strides[0];
+}
+
+/**
+ * @brief Calculates the partial mean and M2 of each (output, chunk) pair in one pass
+ *
+ * Grid: x - items, y - samples
+ */
+template <typename In>
+__global__ void MeanM2Partial(const SampleDesc<In> *samples) {
+  const SampleDesc<In> &s = samples[blockIdx.y];
+  for (int64_t item = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       item < s.num_items;
+       item += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    int64_t o, j;
+    if (s.chunk_fastest) {
+      o = item / s.nchunks;
+      j = item - o * s.nchunks;
+    } else {
+      j = item / s.num_outputs;
+      o = item - j * s.num_outputs;
+    }
+    const In *base = s.in + GroupOffset(o, s.out_ndim, s.out_shape, s.out_strides);
+    WelfordState w;
+    for (int64_t r = j; r < s.reduced_size; r += s.nchunks)
+      w.add(static_cast<float>(__ldg(base + GroupOffset(r, s.red_ndim, s.red_shape,
+                                                        s.red_strides))));
+    s.partials[item] = w;
+  }
+}
+
+__device__ inline WelfordState WarpShuffleDown(const WelfordState &w, int delta) {
+  WelfordState r;
+  r.mean = __shfl_down_sync(0xffffffffu, w.mean, delta);
+  r.m2 = __shfl_down_sync(0xffffffffu, w.m2, delta);
+  r.n = __shfl_down_sync(0xffffffffu, static_cast<long long>(w.n), delta);  // NOLINT
+  return r;
+}
+
+/**
+ * @brief Merges the partial results - one warp per output - and stores the mean and
+ *        the regularized inverse standard deviation
+ *
+ * If `reduce_batch` is true, there's just one output sample and the partials of all
+ * input samples are merged.
+ *
+ * Grid: x - outputs (blockDim.y per block), y - output samples
+ */
+template <typename In>
+__global__ void MeanInvStdDevFinalize(const OutputDesc *outputs,
+                                      const SampleDesc<In> *samples, int num_samples,
+                                      bool reduce_batch, int ddof, float epsilon) {
+  const OutputDesc &out = outputs[blockIdx.y];
+  int64_t o = static_cast<int64_t>(blockIdx.x) * blockDim.y + threadIdx.y;
+  if (o >= out.num_outputs)
+    return;  // the whole warp exits
+  int first = reduce_batch ? 0 : blockIdx.y;
+  int last = reduce_batch ? num_samples : first + 1;
+  WelfordState w;
+  for (int i = first; i < last; i++) {
+    const SampleDesc<In> &s = samples[i];
+    for (int j = threadIdx.x; j < s.nchunks; j += 32) {
+      int64_t item = s.chunk_fastest ? o * s.nchunks + j : j * s.num_outputs + o;
+      w.add(s.partials[item]);
+    }
+  }
+  for (int delta = 16; delta > 0; delta >>= 1)
+    w.add(WarpShuffleDown(w, delta));
+  if (threadIdx.x == 0) {
+    float scale = w.n > ddof ? 1.0f / (w.n - ddof) : 0.0f;
+    float var = w.m2 * scale + epsilon;
+    out.mean[o] = w.mean;
+    out.inv_stddev[o] = var ? rsqrtf(var) : 0.0f;
+  }
+}
+
+}  // namespace mean_inv_stddev
+
+/**
+ * @brief Calculates the mean and the (regularized) inverse standard deviation
+ *        along given axes, reading the input only once
+ *
+ * The results are the same as with MeanGPU followed by InvStdDevGPU, but the mean and variance
+ * are calculated in a single pass, with Welford's algorithm; the partial results are merged
+ * in a second, small kernel, one warp per output element.
+ *
+ * The outputs have the shape of the input with reduced dimensions of extent 1 (keep_dims).
+ * If `reduce_batch` is true, the output is a single sample.
+ *
+ * The inverse standard deviation is calculated as `1 / sqrt(M2 / (n - ddof) + epsilon)`,
+ * as in InvStdDevGPU: the variance is 0 if `n <= ddof` and the result is 0 if the argument
+ * of sqrt is 0.
+ */
+template <typename In>
+class MeanInvStdDevGPU {
+ public:
+  /// @brief The maximum number of dimensions of the input, which is always supported
+  static constexpr int kMaxNDim = 2 * mean_inv_stddev::kMaxGroups;
+
+  KernelRequirements Setup(KernelContext &ctx,
+                           const TensorListShape<> &in_shape,
+                           span<const int> axes,
+                           bool reduce_batch) {
+    int N = in_shape.num_samples();
+    reduce_impl::CheckAxes(axes, in_shape.sample_dim());
+    uint64_t axis_mask = to_bit_mask(axes);
+    reduce_batch_ = reduce_batch;
+    if (reduce_batch)
+      reduce_impl::CheckBatchReduce(in_shape, axes);
+
+    TensorListShape<> out_shape;
+    if (N > 0)
+      reduce_impl::CalculateReducedShape(out_shape, in_shape, axes, true, reduce_batch);
+
+    samples_.resize(N);
+    int64_t num_outputs = N > 0 ? volume(out_shape.tensor_shape_span(0)) : 0;
+    int64_t total_reduced = 0;
+    for (int i = 0; i < N; i++) {
+      SetupSample(samples_[i], in_shape.tensor_shape_span(i), axis_mask, N);
+      total_reduced += samples_[i].reduced_size;
+      if (!reduce_batch) {
+        DALI_ENFORCE(samples_[i].reduced_size > 0 || samples_[i].num_outputs == 0,
+          make_string("Cannot calculate the mean and standard deviation of sample ", i,
+                      " - 0 elements are reduced."));
+      }
+    }
+    if (reduce_batch) {
+      DALI_ENFORCE(total_reduced > 0 || num_outputs == 0,
+        "Cannot calculate the mean and standard deviation - 0 elements are reduced.");
+    }
+
+    KernelRequirements req;
+    req.output_shapes = { out_shape, out_shape };
+    return req;
+  }
+
+  void Run(KernelContext &ctx,
+           const OutListGPU<float> &mean,
+           const OutListGPU<float> &inv_stddev,
+           const InListGPU<In> &in,
+           int ddof, float epsilon) {
+    using namespace mean_inv_stddev;  // NOLINT
+    DALI_ENFORCE(ddof >= 0, "Degrees of freedom must be a non-negative number.");
+    DALI_ENFORCE(epsilon >= 0, "Regularization epsilon must be a non-negative number.");
+    int N = in.num_samples();
+    assert(N == static_cast<int>(samples_.size()));
+    if (N == 0)
+      return;
+
+    int64_t total_items = 0, max_items = 0;
+    for (auto &s : samples_) {
+      total_items += s.num_items;
+      max_items = std::max(max_items, s.num_items);
+    }
+    auto *partials = ctx.scratchpad->AllocateGPU<WelfordState>(total_items);
+    for (int i = 0; i < N; i++) {
+      samples_[i].in = in.tensor_data(i);
+      samples_[i].partials = partials;
+      partials += samples_[i].num_items;
+    }
+
+    int num_out = mean.num_samples();
+    assert(inv_stddev.num_samples() == num_out);
+    outputs_.resize(num_out);
+    int64_t max_outputs = 0;
+    for (int i = 0; i < num_out; i++) {
+      outputs_[i].mean = mean.tensor_data(i);
+      outputs_[i].inv_stddev = inv_stddev.tensor_data(i);
+      outputs_[i].num_outputs = mean.shape.tensor_size(i);
+      max_outputs = std::max(max_outputs, outputs_[i].num_outputs);
+    }
+
+    auto *gpu_samples = ctx.scratchpad->ToGPU(ctx.gpu.stream, samples_);
+    auto *gpu_outputs = ctx.scratchpad->ToGPU(ctx.gpu.stream, outputs_);
+
+    if (max_items > 0) {
+      dim3 grid(std::min<int64_t>(div_ceil(max_items, kBlockSize), kMaxBlocksX), N);
+      MeanM2Partial<<<grid, kBlockSize, 0, ctx.gpu.stream>>>(gpu_samples);
+      CUDA_CALL(cudaGetLastError());
+    }
+    if (max_outputs > 0) {
+      dim3 block(32, kOutputsPerBlock);
+      dim3 grid(div_ceil(max_outputs, kOutputsPerBlock), num_out);
+      MeanInvStdDevFinalize<<<grid, block, 0, ctx.gpu.stream>>>(
+          gpu_outputs, gpu_samples, N, reduce_batch_, ddof, epsilon);
+      CUDA_CALL(cudaGetLastError());
+    }
+  }
+
+ private:
+  static constexpr int kBlockSize = 256;
+  static constexpr int kMaxBlocksX = 1 << 16;
+  static constexpr int kOutputsPerBlock = 8;
+  /// @brief Each (output, chunk) item should reduce at least this many elements...
+  static constexpr int kMinItemSize = 16;
+  /// @brief ...unless the total number of items doesn't exceed this value
+  static constexpr int64_t kTargetItems = 1 << 18;
+
+  void SetupSample(mean_inv_stddev::SampleDesc<In> &s, span<const int64_t> shape,
+                   uint64_t axis_mask, int num_samples) {
+    using mean_inv_stddev::kMaxGroups;
+    int64_t out_shape[kMaxGroups], red_shape[kMaxGroups];
+    int64_t out_strides[kMaxGroups], red_strides[kMaxGroups];
+    int out_ndim = 0, red_ndim = 0;
+    // -1 - none yet, 0 - non-reduced, 1 - reduced
+    int last_kind = -1, innermost_kind = -1;
+    int64_t stride = 1;
+    // merge the adjacent dimensions of the same kind, innermost first; skip unit dimensions
+    for (int d = shape.size() - 1; d >= 0; d--) {
+      int64_t extent = shape[d];
+      if (extent == 1)
+        continue;
+      int kind = (axis_mask >> d) & 1;
+      if (innermost_kind < 0)
+        innermost_kind = kind;
+      int64_t *g_shape = kind ? red_shape : out_shape;
+      int64_t *g_strides = kind ? red_strides : out_strides;
+      int &g_ndim = kind ? red_ndim : out_ndim;
+      if (kind == last_kind) {
+        g_shape[g_ndim - 1] *= extent;
+      } else {
+        DALI_ENFORCE(g_ndim < kMaxGroups, make_string("The input shape ", TensorShape<>(shape),
+                     " has too many alternating reduced and non-reduced dimensions."));
+        g_shape[g_ndim] = extent;
+        g_strides[g_ndim] = stride;
+        g_ndim++;
+      }
+      last_kind = kind;
+      stride *= extent;
+    }
+    // the groups were collected innermost first - store them outermost first
+    s.out_ndim = std::max(out_ndim, 1);
+    s.red_ndim = std::max(red_ndim, 1);
+    s.num_outputs = 1;
+    s.reduced_size = 1;
+    for (int g = 0; g < s.out_ndim; g++) {
+      int src = out_ndim - 1 - g;
+      s.out_shape[g] = out_ndim ? out_shape[src] : 1;
+      s.out_strides[g] = out_ndim ? out_strides[src] : 0;
+      s.num_outputs *= out_ndim ? out_shape[src] : 1;
+    }
+    for (int g = 0; g < s.red_ndim; g++) {
+      int src = red_ndim - 1 - g;
+      s.red_shape[g] = red_ndim ? red_shape[src] : 1;
+      s.red_strides[g] = red_ndim ? red_strides[src] : 0;
+      s.reduced_size *= red_ndim ? red_shape[src] : 1;
+    }
+    // an empty non-reduced dimension means no outputs; an empty reduced one - nothing to reduce
+    for (int d = 0; d < static_cast<int>(shape.size()); d++) {
+      if (shape[d] == 0) {
+        if ((axis_mask >> d) & 1)
+          s.reduced_size = 0;
+        else
+          s.num_outputs = 0;
+      }
+    }
+
+    s.chunk_fastest = innermost_kind == 1;
+    if (s.reduced_size == 0 || s.num_outputs == 0) {
+      s.nchunks = 0;
+    } else {
+      int64_t max_chunks = div_ceil(s.reduced_size, kMinItemSize);
+      int64_t budget = std::max<int64_t>(1, kTargetItems / (num_samples * s.num_outputs));
+      s.nchunks = clamp<int64_t>(std::min(max_chunks, budget), 1, 1 << 20);
+    }
+    s.num_items = s.num_outputs * s.nchunks;
+  }
+
+  bool reduce_batch_ = false;
+  std::vector<mean_inv_stddev::SampleDesc<In>> samples_;
+  std::vector<mean_inv_stddev::OutputDesc> outputs_;
+};
+
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_REDUCE_MEAN_INV_STDDEV_GPU_CUH_
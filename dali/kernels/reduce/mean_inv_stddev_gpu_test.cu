@@ -0,0 +1,151 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/kernels/reduce/mean_inv_stddev_gpu.cuh"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "dali/core/tensor_shape_print.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/test/test_tensors.h"
+#include "dali/test/tensor_test_utils.h"
+
+namespace dali {
+namespace kernels {
+
+namespace {
+
+/**
+ * @brief Calculates the mean and the inverse standard deviation in double precision
+ */
+void RefMeanInvStdDev(std::vector<float> &mean, std::vector<float> &inv_stddev,
+                      const InListCPU<float> &in, const TensorListShape<> &out_shape,
+                      int out_sample, uint64_t axis_mask, bool reduce_batch,
+                      int ddof, float epsilon) {
+  int64_t num_outputs = volume(out_shape.tensor_shape_span(out_sample));
+  std::vector<double> sum(num_outputs, 0), sum_sq(num_outputs, 0);
+  std::vector<int64_t> count(num_outputs, 0);
+  int ndim = in.sample_dim();
+  auto out_sample_shape = out_shape.tensor_shape_span(out_sample);
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < in.num_samples(); i++) {
+      if (!reduce_batch && i != out_sample)
+        continue;
+      auto sample_shape = in.shape.tensor_shape_span(i);
+      const float *data = in.tensor_data(i);
+      int64_t n = volume(sample_shape);
+      for (int64_t idx = 0; idx < n; idx++) {
+        int64_t rem = idx, out_idx = 0, out_stride = 1;
+        for (int d = ndim - 1; d >= 0; d--) {
+          int64_t coord = rem % sample_shape[d];
+          rem /= sample_shape[d];
+          if (!((axis_mask >> d) & 1))
+            out_idx += coord * out_stride;
+          out_stride *= out_sample_shape[d];
+        }
+        if (pass == 0) {
+          sum[out_idx] += data[idx];
+          count[out_idx]++;
+        } else {
+          double d = data[idx] - sum[out_idx] / count[out_idx];
+          sum_sq[out_idx] += d * d;
+        }
+      }
+    }
+  }
+  mean.resize(num_outputs);
+  inv_stddev.resize(num_outputs);
+  for (int64_t o = 0; o < num_outputs; o++) {
+    mean[o] = sum[o] / count[o];
+    double var = count[o] > ddof ? sum_sq[o] / (count[o] - ddof) : 0;
+    var += epsilon;
+    inv_stddev[o] = var ? 1 / std::sqrt(var) : 0;
+  }
+}
+
+void TestMeanInvStdDev(const TensorListShape<> &in_shape, std::vector<int> axes,
+                       bool reduce_batch, int ddof, float epsilon) {
+  TestTensorList<float> in;
+  in.reshape(in_shape);
+  std::mt19937_64 rng(4321);
+  // a large offset makes the naive sum-of-squares variance inaccurate
+  UniformRandomFill(in.cpu(), rng, 90, 110);
+
+  MeanInvStdDevGPU<float> kernel;
+  KernelContext ctx;
+  ctx.gpu.stream = 0;
+  auto req = kernel.Setup(ctx, in_shape, make_span(axes), reduce_batch);
+  ASSERT_EQ(req.output_shapes.size(), 2u);
+  auto out_shape = req.output_shapes[0];
+  ASSERT_EQ(out_shape.num_samples(), reduce_batch ? 1 : in_shape.num_samples());
+
+  TestTensorList<float> mean, inv_stddev;
+  mean.reshape(out_shape);
+  inv_stddev.reshape(out_shape);
+  DynamicScratchpad scratchpad({}, AccessOrder(ctx.gpu.stream));
+  ctx.scratchpad = &scratchpad;
+  kernel.Run(ctx, mean.gpu(), inv_stddev.gpu(), in.gpu(), ddof, epsilon);
+
+  auto mean_cpu = mean.cpu();
+  auto inv_stddev_cpu = inv_stddev.cpu();
+  uint64_t axis_mask = to_bit_mask(axes);
+  for (int s = 0; s < out_shape.num_samples(); s++) {
+    std::vector<float> ref_mean, ref_inv_stddev;
+    RefMeanInvStdDev(ref_mean, ref_inv_stddev, in.cpu(), out_shape, s, axis_mask,
+                     reduce_batch, ddof, epsilon);
+    Check(mean_cpu[s], make_tensor_cpu(ref_mean.data(), out_shape[s]), EqualEpsRel(1e-4, 1e-5));
+    Check(inv_stddev_cpu[s], make_tensor_cpu(ref_inv_stddev.data(), out_shape[s]),
+          EqualEpsRel(1e-5, 1e-3));
+  }
+}
+
+}  // namespace
+
+TEST(MeanInvStdDevGPU, AllAxes) {
+  TensorListShape<> shape = {{ 480, 640, 3 }, { 1, 1, 1 }, { 100, 27, 1 }, { 3, 1000, 7 }};
+  TestMeanInvStdDev(shape, { 0, 1, 2 }, false, 0, 0);
+  TestMeanInvStdDev(shape, { 0, 1, 2 }, true, 1, 0);
+}
+
+TEST(MeanInvStdDevGPU, InnerAxes) {
+  TensorListShape<> shape = {{ 3, 480, 640 }, { 3, 10, 10 }, { 3, 1, 1001 }};
+  TestMeanInvStdDev(shape, { 1, 2 }, false, 0, 1e-3f);
+  TestMeanInvStdDev(shape, { 1, 2 }, true, 0, 0);
+}
+
+TEST(MeanInvStdDevGPU, OuterAxes) {
+  TensorListShape<> shape = {{ 480, 640, 3 }, { 10, 10, 3 }, { 1, 1001, 3 }};
+  TestMeanInvStdDev(shape, { 0, 1 }, false, 1, 0);
+  TestMeanInvStdDev(shape, { 0, 1 }, true, 0, 0.5f);
+}
+
+TEST(MeanInvStdDevGPU, AlternatingAxes) {
+  TensorListShape<> shape = {{ 5, 60, 7, 80, 2 }, { 5, 1, 7, 3, 2 }, { 5, 33, 7, 1, 2 }};
+  TestMeanInvStdDev(shape, { 1, 3 }, false, 0, 0);
+  TestMeanInvStdDev(shape, { 0, 2, 4 }, false, 0, 0);
+  TestMeanInvStdDev(shape, { 1, 3 }, true, 1, 0);
+}
+
+TEST(MeanInvStdDevGPU, NoReducedElements) {
+  TensorListShape<> shape = {{ 0, 10 }, { 5, 10 }};
+  MeanInvStdDevGPU<float> kernel;
+  KernelContext ctx;
+  std::vector<int> axes = { 0 };
+  EXPECT_THROW(kernel.Setup(ctx, shape, make_span(axes), false), std::exception);
+  EXPECT_NO_THROW(kernel.Setup(ctx, shape, make_span(axes), true));
+}
+
+}  // namespace kernels
+}  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,7 +15,9 @@
 #ifndef DALI_KERNELS_REDUCE_REDUCE_CPU_H_
 #define DALI_KERNELS_REDUCE_REDUCE_CPU_H_
 
+#include <algorithm>
 #include <cassert>
+#include <numeric>
 #include <utility>
 #include <vector>
 #include "dali/kernels/kernel.h"
@@ -36,12 +38,49 @@ namespace reduce_impl {
 
 constexpr int kTreeReduceThreshold = 32;
 
+/**
+ * @brief Number of independent accumulators used when reducing contiguous data
+ *
+ * The accumulators don't depend on each other, so the compiler can keep them in one
+ * SIMD register (or a few) and the additions are not serialized.
+ */
+constexpr int kReduceLanes = 8;
+
+/**
+ * @brief Reduces up to `kTreeReduceThreshold * kReduceLanes` contiguous values
+ *
+ * Each lane receives at most kTreeReduceThreshold values, so the accuracy is the same as
+ * that of the leaves of the tree reduction.
+ */
+template <typename Dst, typename Src, typename Preprocessor, typename Reduction>
+void reduce1D_lanes(Dst &reduced, const Src *data, int64_t n,
+                    const Preprocessor &P, const Reduction &R) {
+  const Dst neutral = R.template neutral<Dst>();
+  Dst acc[kReduceLanes];
+  for (int k = 0; k < kReduceLanes; k++)
+    acc[k] = neutral;
+  int64_t i = 0;
+  for (; i + kReduceLanes <= n; i += kReduceLanes) {
+    for (int k = 0; k < kReduceLanes; k++)
+      R(acc[k], P(data[i + k]));
+  }
+  for (int k = 0; i < n; i++, k++)
+    R(acc[k], P(data[i]));
+  for (int w = kReduceLanes / 2; w > 0; w >>= 1) {
+    for (int k = 0; k < w; k++)
+      R(acc[k], acc[k + w]);
+  }
+  R(reduced, acc[0]);
+}
+
 template <int static_stride, typename Dst, typename Src, typename Preprocessor, typename Reduction>
 void reduce1D_stride(Dst &reduced, const Src *data, int64_t dynamic_stride, int64_t n,
                      const Preprocessor &P, const Reduction &R) {
   const int64_t stride = static_stride < 0 ? dynamic_stride : static_stride;
   const Dst neutral = R.template neutral<Dst>();
-  if (n > kTreeReduceThreshold) {
+  if (static_stride == 1 && n >= 2 * kReduceLanes && n <= kTreeReduceThreshold * kReduceLanes) {
+    reduce1D_lanes(reduced, data, n, P, R);
+  } else if (n > kTreeReduceThreshold) {
     int64_t m = n >> 1;
     Dst tmp1 = neutral, tmp2 = neutral;
     // reduce first half and accumulate
@@ -69,6 +108,23 @@ void reduce1D(Dst &reduced, const Src *data, int64_t stride, int64_t n,
   );  // NOLINT
 }
 
+/**
+ * @brief Accumulates a row of values in a row of partial results, with a separate preprocessor
+ *        for each element
+ */
+template <typename Dst, typename Src, typename Preprocessor, typename Reduction>
+DALI_FORCEINLINE void accumulate_row(Dst *__restrict__ acc, const Src *__restrict__ row,
+                                     const Preprocessor *P, int64_t n, const Reduction &R) {
+  int64_t i = 0;
+  // the fixed trip count of the inner loop lets the compiler vectorize it
+  for (; i + kReduceLanes <= n; i += kReduceLanes) {
+    for (int k = 0; k < kReduceLanes; k++)
+      R(acc[i + k], P[i + k](row[i + k]));
+  }
+  for (; i < n; i++)
+    R(acc[i], P[i](row[i]));
+}
+
 template <typename Backend, typename T>
 struct StridedTensor {
   T *data = nullptr;
@@ -212,7 +268,9 @@ struct ReduceBaseCPU {
  protected:
   void ReduceAxis(bool clear, span<int64_t> pos, int axis, int64_t offset = 0) {
     auto R = This().GetReduction();
-    if (axis == output.dim()) {
+    if (vertical && axis == output.dim() - 1) {
+      ReduceVertical(clear, pos, offset);
+    } else if (axis == output.dim()) {
       Dst &r = *output(pos);
       if (clear) {
         r = R.template neutral<Dst>();
@@ -226,6 +284,116 @@ struct ReduceBaseCPU {
     }
   }
 
+  /**
+   * @brief Reduces all the values along the innermost output axis at once
+   *
+   * Used when the innermost axis is not reduced - the values reduced to adjacent outputs are
+   * adjacent in the input, too. The input is traversed once, in the memory order, a row of
+   * `n` values at a time, instead of once for each output with a large stride.
+   * When the rows are adjacent, a few of them are accumulated at once in a wider row of
+   * partial results, so that short rows (e.g. the channels of an HWC image) are vectorized, too.
+   *
+   * The rows are accumulated in blocks of kTreeReduceThreshold and the partial results of
+   * the blocks are combined pairwise, which gives the accuracy of the tree reduction.
+   */
+  void ReduceVertical(bool clear, span<int64_t> pos, int64_t offset) {
+    auto R = This().GetReduction();
+    const Dst neutral = R.template neutral<Dst>();
+    int axis = output.dim() - 1;
+    int64_t n = output.shape[axis];
+    pos[axis] = 0;
+    Dst *out = output(pos);
+
+    int inner = strided_in.dim() - 1;
+    int64_t run_length = strided_in.size[inner];
+    int64_t run_stride = strided_in.stride[inner];
+    int64_t group = 1;  // number of rows accumulated at once
+    if (run_stride == n) {
+      // the width is a multiple of the number of lanes, if possible
+      group = reduce_impl::kReduceLanes / std::gcd<int64_t>(n, reduce_impl::kReduceLanes);
+      group *= std::max<int64_t>(1, kVerticalMinWidth / (group * n));
+      group = std::min(group, run_length);
+    }
+    int64_t width = group * n;
+
+    using Preprocessor = decltype(This().GetPreprocessor(pos));
+    SmallVector<Preprocessor, 64> P;
+    P.reserve(width);
+    for (int64_t j = 0; j < n; j++) {
+      pos[axis] = j;
+      P.push_back(This().GetPreprocessor(pos));
+    }
+    for (int64_t e = n; e < width; e++)
+      P.push_back(P[e - n]);
+
+    int64_t groups_per_run = div_ceil(run_length, group);
+    int64_t runs = volume(strided_in.size.begin(), strided_in.size.begin() + inner);
+    int64_t blocks = div_ceil(runs * groups_per_run, reduce_impl::kTreeReduceThreshold);
+    int levels = 1;
+    while ((1_i64 << levels) <= blocks)
+      levels++;
+    // the wide row of partial results, the current block and the results of 2^level blocks
+    vertical_acc.resize(width + n * (levels + 1));
+    Dst *wide = vertical_acc.data();
+    Dst *block = wide + width;
+    auto level_acc = [&](int level) { return block + (level + 1) * n; };
+    uint64_t occupied = 0;
+    int groups_in_block = 0;
+
+    auto flush_block = [&]() {
+      for (int64_t j = 0; j < n; j++)
+        block[j] = neutral;
+      for (int64_t e = 0; e < width; e++) {
+        R(block[e % n], wide[e]);
+        wide[e] = neutral;
+      }
+      int level = 0;
+      for (; occupied & (1_u64 << level); level++) {
+        Dst *acc = level_acc(level);
+        for (int64_t j = 0; j < n; j++)
+          R(block[j], acc[j]);
+      }
+      occupied &= ~((1_u64 << level) - 1);
+      occupied |= 1_u64 << level;
+      std::copy(block, block + n, level_acc(level));
+      groups_in_block = 0;
+    };
+
+    for (int64_t e = 0; e < width; e++)
+      wide[e] = neutral;
+    SmallVector<int64_t, 6> idx;
+    idx.resize(inner, 0);
+    const Src *run = strided_in.data + offset;
+    for (int64_t r = 0; r < runs; r++) {
+      for (int64_t g = 0; g < run_length; g += group) {
+        const Src *row = run + g * run_stride;
+        int64_t w = std::min(group, run_length - g) * n;
+        reduce_impl::accumulate_row(wide, row, P.data(), w, R);
+        if (++groups_in_block == reduce_impl::kTreeReduceThreshold)
+          flush_block();
+      }
+      // next run
+      for (int d = inner - 1; d >= 0; d--) {
+        run += strided_in.stride[d];
+        if (++idx[d] < strided_in.size[d])
+          break;
+        run -= strided_in.stride[d] * strided_in.size[d];
+        idx[d] = 0;
+      }
+    }
+    if (groups_in_block > 0)
+      flush_block();
+
+    for (int64_t j = 0; j < n; j++) {
+      if (clear)
+        out[j] = neutral;
+      for (int level = 0; level < levels; level++) {
+        if (occupied & (1_u64 << level))
+          R(out[j], level_acc(level)[j]);
+      }
+    }
+  }
+
   void ReduceForEmptyAxes(span<int64_t> pos) {
     auto P = This().GetPreprocessor(pos);
     for (int64_t i = 0; i < output.num_elements(); i++) {
@@ -319,6 +487,7 @@ struct ReduceBaseCPU {
       }
     }
     assert((oaxis == 0 && output.dim() == 1) || oaxis == output.dim());
+    vertical = !axes.empty() && !step.empty() && step.back() == 1;
   }
 
   DALI_FORCEINLINE int ndim() const noexcept { return input.shape.size(); }
@@ -332,6 +501,11 @@ struct ReduceBaseCPU {
   reduce_impl::StridedTensor<StorageCPU, const Src> strided_in;
   SmallVector<int64_t, 6> step;
   uint64_t axis_mask = 0;
+  /// The innermost axis is not reduced - see ReduceVertical
+  bool vertical = false;
+  /// Minimum number of partial results accumulated at once in ReduceVertical
+  static constexpr int kVerticalMinWidth = 32;
+  std::vector<Dst> vertical_acc;
 };
 
 template <typename Dst, typename Src>
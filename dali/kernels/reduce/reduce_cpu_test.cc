@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,8 +13,10 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <random>
 #include <chrono>
+#include <vector>
 #include "dali/kernels/reduce/reduce_cpu.h"
 
 namespace dali {
@@ -164,6 +166,59 @@ TEST(ReduceTest, RootMeanSquare3D) {
     sqrt);
 }
 
+TEST(ReduceTest, MinMax3D) {
+  MinCPU<int, int> min;
+  MaxCPU<int, int> max;
+
+  const int H = 37, W = 129, C = 5;
+  std::vector<int> in_v(H*W*C);
+  std::mt19937_64 rng(1234);
+  std::uniform_int_distribution<int> dist(-1000000, 1000000);
+  for (auto &x : in_v)
+    x = dist(rng);
+  auto in = make_tensor_cpu<3>(in_v.data(), { H, W, C });
+
+  SmallVector<int, 3> axes_sets[] = { { 0 }, { 1 }, { 2 }, { 0, 1 }, { 1, 2 }, { 0, 1, 2 } };
+  std::vector<int> out_min(H*W*C), out_max(H*W*C), ref_min(H*W*C), ref_max(H*W*C);
+  for (auto &axes : axes_sets) {
+    unsigned reduction_mask = 0;
+    for (auto a : axes)
+      reduction_mask |= (1 << a);
+    TensorShape<> out_shape;
+    for (int d = 0; d < 3; d++) {
+      if (!(reduction_mask & (1u << d)))
+        out_shape.shape.push_back(in.shape[d]);
+    }
+    if (out_shape.empty())
+      out_shape = { 1 };
+
+    min.Setup(make_tensor_cpu(out_min.data(), out_shape), in, make_cspan(axes));
+    min.Run();
+    max.Setup(make_tensor_cpu(out_max.data(), out_shape), in, make_cspan(axes));
+    max.Run();
+
+    int64_t n = volume(out_shape);
+    std::fill(ref_min.begin(), ref_min.begin() + n, max_value<int>());
+    std::fill(ref_max.begin(), ref_max.begin() + n, min_value<int>());
+    for (int i = 0; i < H; i++) {
+      ptrdiff_t ofs_i = reduction_mask&1 ? 0 : i;
+      for (int j = 0; j < W; j++) {
+        ptrdiff_t ofs_j = reduction_mask&2 ? ofs_i : W*ofs_i+j;
+        for (int k = 0; k < C; k++) {
+          ptrdiff_t ofs_k = reduction_mask&4 ? ofs_j : C*ofs_j+k;
+          int v = in_v[(i*W+j)*C+k];
+          ref_min[ofs_k] = std::min(ref_min[ofs_k], v);
+          ref_max[ofs_k] = std::max(ref_max[ofs_k], v);
+        }
+      }
+    }
+    for (int64_t i = 0; i < n; i++) {
+      EXPECT_EQ(out_min[i], ref_min[i]) << " at " << i;
+      EXPECT_EQ(out_max[i], ref_max[i]) << " at " << i;
+    }
+  }
+}
+
 TEST(ReduceTest, StdDev) {
   MeanCPU<float, float> mean;
   StdDevCPU<float, float> stddev;
@@ -0,0 +1,137 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/kernels/scratch_arena.h"
+#include <algorithm>
+#include <new>
+#include "dali/core/error_handling.h"
+#include "dali/core/mm/default_resources.h"
+#include "dali/core/mm/detail/align.h"
+#include "dali/core/util.h"
+
+namespace dali {
+namespace kernels {
+
+namespace {
+
+constexpr size_t kBufferAlignment = 256;
+constexpr size_t kBufferGranularity = 1 << 16;  // 64 KiB
+
+thread_local ScratchArena *tls_scratch_arena = nullptr;
+thread_local ScratchCapture *tls_scratch_capture = nullptr;
+
+}  // namespace
+
+ScratchArena::ScratchArena(AccessOrder order, mm::device_async_resource *upstream)
+: order_(order), upstream_(upstream ? upstream : mm::GetDefaultDeviceResource()) {
+  DALI_ENFORCE(order_.is_device(), "The scratch arena must be associated with a stream.");
+}
+
+ScratchArena::~ScratchArena() {
+  free_overflow();
+  free_buffer();
+}
+
+void *ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+  if (buffer_) {
+    char *base = buffer_ + used_;
+    char *aligned = mm::detail::align_ptr(base, alignment);
+    size_t needed = (aligned - base) + bytes;
+    if (used_ + needed <= capacity_) {
+      used_ += needed;
+      peak_ = std::max(peak_, used_ + overflow_);
+      return aligned;
+    }
+  }
+  void *ptr = upstream_->allocate_async(bytes, alignment, order_.stream());
+  try {
+    overflow_blocks_.push_back({ ptr, bytes, alignment });
+  } catch (...) {
+    upstream_->deallocate_async(ptr, bytes, alignment, order_.stream());
+    throw;
+  }
+  // when the buffer is regrown, this allocation may need padding
+  overflow_ += bytes + alignment - 1;
+  peak_ = std::max(peak_, used_ + overflow_);
+  return ptr;
+}
+
+void ScratchArena::free_overflow() {
+  while (!overflow_blocks_.empty()) {
+    auto &blk = overflow_blocks_.back();
+    upstream_->deallocate_async(blk.ptr, blk.bytes, blk.alignment, order_.stream());
+    overflow_blocks_.pop_back();
+  }
+  overflow_ = 0;
+}
+
+void ScratchArena::Reset() {
+  free_overflow();
+  used_ = 0;
+  if (peak_ > capacity_) {
+    size_t new_capacity = align_up(peak_, kBufferGranularity);
+    free_buffer();
+    try {
+      buffer_ = static_cast<char *>(
+          upstream_->allocate_async(new_capacity, kBufferAlignment, order_.stream()));
+      capacity_ = new_capacity;
+    } catch (const std::bad_alloc &) {
+      // Not fatal - the allocations will be served by the upstream resource
+    }
+  }
+  peak_ = 0;
+}
+
+void ScratchArena::Release() {
+  free_overflow();
+  free_buffer();
+  used_ = 0;
+  peak_ = 0;
+}
+
+void ScratchArena::free_buffer() {
+  if (buffer_) {
+    upstream_->deallocate_async(buffer_, capacity_, kBufferAlignment, order_.stream());
+    buffer_ = nullptr;
+    capacity_ = 0;
+  }
+}
+
+ScratchArenaScope::ScratchArenaScope(ScratchArena *arena) : prev_(tls_scratch_arena) {
+  tls_scratch_arena = arena;
+}
+
+ScratchArenaScope::~ScratchArenaScope() {
+  tls_scratch_arena = prev_;
+}
+
+ScratchArena *ScratchArenaScope::Current(AccessOrder order) {
+  ScratchArena *arena = tls_scratch_arena;
+  return arena && arena->order() == order ? arena : nullptr;
+}
+
+ScratchCaptureScope::ScratchCaptureScope(ScratchCapture *capture) : prev_(tls_scratch_capture) {
+  tls_scratch_capture = capture;
+}
+
+ScratchCaptureScope::~ScratchCaptureScope() {
+  tls_scratch_capture = prev_;
+}
+
+ScratchCapture *ScratchCaptureScope::Current() {
+  return tls_scratch_capture;
+}
+
+}  // namespace kernels
+}  // namespace dali
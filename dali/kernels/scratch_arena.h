@@ -0,0 +1,197 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_SCRATCH_ARENA_H_
+#define DALI_KERNELS_SCRATCH_ARENA_H_
+
+#include <memory>
+#include <vector>
+#include "dali/core/access_order.h"
+#include "dali/core/api_helper.h"
+#include "dali/core/mm/memory.h"
+#include "dali/core/mm/memory_resource.h"
+#include "dali/core/small_vector.h"
+
+namespace dali {
+namespace kernels {
+
+/**
+ * @brief Device memory for the scratchpads of the operators which run in one stream.
+ *
+ * The memory is handed out from a single buffer, by bumping a pointer, and is never freed
+ * individually - `Reset` makes the whole buffer available again. Since all the work which uses
+ * the arena is issued to the same stream, the memory can be reused as soon as that work has been
+ * scheduled - there's no need to wait for it to complete.
+ *
+ * When the buffer is exhausted, the excess is allocated from the upstream resource; on the next
+ * `Reset`, the buffer is reallocated to accommodate the peak usage. The memory is allocated
+ * and freed in the order of the arena's stream.
+ */
+class DLL_PUBLIC ScratchArena : public mm::memory_resource<mm::memory_kind::device> {
+ public:
+  /**
+   * @param order     The stream in which the memory is used
+   * @param upstream  The resource from which the memory is obtained; if null, the default
+   *                  device resource for the current device is used
+   */
+  explicit ScratchArena(AccessOrder order, mm::device_async_resource *upstream = nullptr);
+  ~ScratchArena();
+
+  ScratchArena(const ScratchArena &) = delete;
+  ScratchArena &operator=(const ScratchArena &) = delete;
+
+  AccessOrder order() const noexcept {
+    return order_;
+  }
+
+  /// The size of the buffer
+  size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+  /// The largest amount of memory used between two consecutive calls to Reset
+  size_t peak_usage() const noexcept {
+    return peak_;
+  }
+
+  /**
+   * @brief Makes all the memory available for reuse; regrows the buffer, if the usage
+   *        exceeded its capacity.
+   */
+  void Reset();
+
+  /**
+   * @brief Returns all the memory to the upstream resource.
+   *
+   * The buffer is reallocated on the next call to Reset, if it's still needed.
+   * The memory must not be in use.
+   */
+  void Release();
+
+ private:
+  void *do_allocate(size_t bytes, size_t alignment) override;
+
+  void do_deallocate(void *, size_t, size_t) override {}
+
+  bool do_is_equal(const mm::memory_resource<mm::memory_kind::device> &other)
+      const noexcept override {
+    return this == &other;
+  }
+
+  void free_overflow();
+  void free_buffer();
+
+  struct block {
+    void *ptr;
+    size_t bytes, alignment;
+  };
+
+  AccessOrder order_;
+  mm::device_async_resource *upstream_ = nullptr;
+  char *buffer_ = nullptr;
+  size_t capacity_ = 0;
+  size_t used_ = 0;      // the buffer usage, including the alignment padding
+  size_t overflow_ = 0;  // the memory allocated from upstream since the last Reset
+  size_t peak_ = 0;
+  SmallVector<block, 8> overflow_blocks_;
+};
+
+/**
+ * @brief Makes the device memory of the dynamic scratchpads created by the calling thread
+ *        come from the arena, for the lifetime of the object.
+ *
+ * Only the scratchpads whose device order is the same as the order of the arena use it.
+ * The scopes can be nested; a null arena disables the arena within the scope.
+ */
+class DLL_PUBLIC ScratchArenaScope {
+ public:
+  explicit ScratchArenaScope(ScratchArena *arena);
+  ~ScratchArenaScope();
+
+  ScratchArenaScope(const ScratchArenaScope &) = delete;
+  ScratchArenaScope &operator=(const ScratchArenaScope &) = delete;
+
+  /**
+   * @brief Returns the arena of the innermost scope of the calling thread or nullptr,
+   *        if there's no arena or it's used in a different order.
+   */
+  static ScratchArena *Current(AccessOrder order);
+
+ private:
+  ScratchArena *prev_;
+};
+
+/**
+ * @brief Keeps the memory of dynamic scratchpads alive after the scratchpads are destroyed
+ *
+ * This is necessary when the work which uses the memory is captured in a CUDA graph - each
+ * launch of the graph uses the same (device and host) memory. Within a ScratchCaptureScope,
+ * the dynamic scratchpads created by the calling thread take all their memory from the capture,
+ * instead of their usual resources or an arena. The memory is freed when the capture is cleared
+ * or destroyed; it must not be in use by then.
+ */
+class DLL_PUBLIC ScratchCapture {
+ public:
+  ScratchCapture() = default;
+  ScratchCapture(const ScratchCapture &) = delete;
+  ScratchCapture &operator=(const ScratchCapture &) = delete;
+
+  template <typename Kind>
+  void *allocate(size_t bytes, size_t alignment) {
+    auto mem = mm::alloc_raw_shared<char, Kind>(bytes, alignment);
+    blocks_.push_back(mem);
+    bytes_ += bytes;
+    return mem.get();
+  }
+
+  /// The total size of the retained allocations, in bytes
+  size_t size() const noexcept {
+    return bytes_;
+  }
+
+  void clear() {
+    blocks_.clear();
+    bytes_ = 0;
+  }
+
+ private:
+  std::vector<std::shared_ptr<void>> blocks_;
+  size_t bytes_ = 0;
+};
+
+/**
+ * @brief Makes all the memory of the dynamic scratchpads created by the calling thread
+ *        come from the capture, for the lifetime of the object.
+ *
+ * Takes precedence over ScratchArenaScope. A null capture disables the capture within the scope.
+ */
+class DLL_PUBLIC ScratchCaptureScope {
+ public:
+  explicit ScratchCaptureScope(ScratchCapture *capture);
+  ~ScratchCaptureScope();
+
+  ScratchCaptureScope(const ScratchCaptureScope &) = delete;
+  ScratchCaptureScope &operator=(const ScratchCaptureScope &) = delete;
+
+  /// Returns the capture of the innermost scope of the calling thread or nullptr
+  static ScratchCapture *Current();
+
+ private:
+  ScratchCapture *prev_;
+};
+
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_SCRATCH_ARENA_H_
@@ -0,0 +1,146 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/kernels/scratch_arena.h"  // NOLINT
+#include <gtest/gtest.h>
+#include <cstring>
+#include "dali/core/cuda_stream_pool.h"
+#include "dali/core/mm/detail/align.h"
+#include "dali/core/mm/mm_test_utils.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+
+namespace dali {
+namespace kernels {
+namespace test {
+
+TEST(ScratchArena, GrowAndReuse) {
+  auto stream = CUDAStreamPool::instance().Get();
+  mm::test::test_dev_pool_resource upstream;
+  {
+    ScratchArena arena(AccessOrder(stream), &upstream);
+    EXPECT_EQ(arena.capacity(), 0u);
+    // nothing's reserved yet - the memory comes from the upstream
+    void *a = arena.allocate(1000, 64);
+    void *b = arena.allocate(3000, 256);
+    EXPECT_TRUE(mm::detail::is_aligned(b, 256));
+    EXPECT_EQ(upstream.get_num_allocs(), 2u);
+    EXPECT_GE(arena.peak_usage(), 4000u);
+
+    arena.Reset();
+    EXPECT_GE(arena.capacity(), 4000u) << "The buffer should accommodate the peak usage";
+    auto allocs = upstream.get_num_allocs();
+    for (int iter = 0; iter < 3; iter++) {
+      void *c = arena.allocate(1000, 64);
+      void *d = arena.allocate(3000, 256);
+      EXPECT_TRUE(mm::detail::is_aligned(c, 64));
+      EXPECT_TRUE(mm::detail::is_aligned(d, 256));
+      EXPECT_NE(c, d);
+      EXPECT_EQ(upstream.get_num_allocs(), allocs) << "The buffer should be reused";
+      arena.Reset();
+    }
+    (void)a;
+  }
+  CUDA_CALL(cudaStreamSynchronize(stream));
+  upstream.check_leaks();
+}
+
+TEST(ScratchArena, Release) {
+  auto stream = CUDAStreamPool::instance().Get();
+  mm::test::test_dev_pool_resource upstream;
+  {
+    ScratchArena arena(AccessOrder(stream), &upstream);
+    arena.allocate(100000, 256);
+    arena.Reset();
+    ASSERT_GE(arena.capacity(), 100000u);
+    arena.allocate(100000, 256);
+    arena.allocate(100000, 256);  // overflow
+    arena.Release();
+    EXPECT_EQ(arena.capacity(), 0u);
+    EXPECT_EQ(arena.peak_usage(), 0u);
+    CUDA_CALL(cudaStreamSynchronize(stream));
+    upstream.check_leaks();
+
+    arena.allocate(1000, 64);
+    arena.Reset();
+    EXPECT_GE(arena.capacity(), 1000u);
+  }
+  CUDA_CALL(cudaStreamSynchronize(stream));
+  upstream.check_leaks();
+}
+
+TEST(ScratchArena, DynamicScratchpadInScope) {
+  auto stream = CUDAStreamPool::instance().Get();
+  auto other_stream = CUDAStreamPool::instance().Get();
+  mm::test::test_dev_pool_resource upstream;
+  {
+    ScratchArena arena(AccessOrder(stream), &upstream);
+    {
+      ScratchArenaScope scope(&arena);
+      {
+        DynamicScratchpad scratch({}, AccessOrder(stream));
+        scratch.Allocate<mm::memory_kind::device, char>(12345);
+      }
+      EXPECT_GE(arena.peak_usage(), 12345u);
+      arena.Reset();
+      {
+        DynamicScratchpad scratch({}, AccessOrder(other_stream));
+        scratch.Allocate<mm::memory_kind::device, char>(100);
+      }
+      EXPECT_EQ(arena.peak_usage(), 0u) << "A scratchpad in another stream shouldn't use the arena";
+    }
+    EXPECT_EQ(ScratchArenaScope::Current(AccessOrder(stream)), nullptr);
+  }
+  CUDA_CALL(cudaStreamSynchronize(stream));
+  upstream.check_leaks();
+}
+
+TEST(ScratchArena, DynamicScratchpadInCapture) {
+  auto stream = CUDAStreamPool::instance().Get();
+  mm::test::test_dev_pool_resource upstream;
+  ScratchCapture capture;
+  {
+    ScratchArena arena(AccessOrder(stream), &upstream);
+    ScratchArenaScope arena_scope(&arena);
+    void *dev = nullptr, *host = nullptr;
+    {
+      ScratchCaptureScope scope(&capture);
+      EXPECT_EQ(ScratchCaptureScope::Current(), &capture);
+      {
+        DynamicScratchpad scratch({}, AccessOrder(stream));
+        dev = scratch.Allocate<mm::memory_kind::device, char>(1000);
+        host = scratch.Allocate<mm::memory_kind::host, char>(500);
+      }
+      EXPECT_EQ(arena.peak_usage(), 0u) << "The capture should take precedence over the arena";
+      EXPECT_EQ(upstream.get_num_allocs(), 0u);
+      EXPECT_GE(capture.size(), 1500u);
+      {
+        ScratchCaptureScope no_capture(nullptr);
+        EXPECT_EQ(ScratchCaptureScope::Current(), nullptr);
+      }
+      EXPECT_EQ(ScratchCaptureScope::Current(), &capture);
+    }
+    EXPECT_EQ(ScratchCaptureScope::Current(), nullptr);
+    // the memory is still valid after the scratchpad's gone
+    memset(host, 0x55, 500);
+    CUDA_CALL(cudaMemsetAsync(dev, 0x55, 1000, stream));
+    CUDA_CALL(cudaStreamSynchronize(stream));
+  }
+  capture.clear();
+  EXPECT_EQ(capture.size(), 0u);
+  upstream.check_leaks();
+}
+
+}  // namespace test
+}  // namespace kernels
+}  // namespace dali
@@ -22,6 +22,7 @@
 #include "dali/core/traits.h"
 #include "dali/core/mm/memory.h"
 #include "dali/kernels/context.h"
+#include "dali/kernels/scratch_arena.h"
 
 namespace dali {
 namespace kernels {
@@ -135,13 +136,20 @@ ToContiguousGPUMem(Scratchpad &scratchpad, cudaStream_t stream, const Collection
   size_t alignment = detail::variadic_max(alignof(element_t<Collections>)...);
   size_t total_size = std::get<N>(offsets);
 
-  auto tmp = mm::alloc_raw_async_unique<char, mm::memory_kind::pinned>(
-        total_size, mm::host_sync, stream, 256);
-
-  detail::copy_to_buffer(tmp.get(), &offsets[0], c...);
   void *out_ptr = scratchpad.Alloc<mm::memory_kind::device>(total_size, alignment);
-
-  CUDA_CALL(cudaMemcpyAsync(out_ptr, tmp.get(), total_size, cudaMemcpyHostToDevice, stream));
+  auto copy = [&](char *staging) {
+    detail::copy_to_buffer(staging, &offsets[0], c...);
+    CUDA_CALL(cudaMemcpyAsync(out_ptr, staging, total_size, cudaMemcpyHostToDevice, stream));
+  };
+
+  if (ScratchCaptureScope::Current()) {
+    // a captured copy reads the staging buffer whenever it's replayed, so it must be retained
+    copy(scratchpad.Allocate<mm::memory_kind::pinned, char>(total_size, 256));
+  } else {
+    auto tmp = mm::alloc_raw_async_unique<char, mm::memory_kind::pinned>(
+          total_size, mm::host_sync, stream, 256);
+    copy(tmp.get());
+  }
   return detail::GetCollectionPtrs(out_ptr, &offsets[0], c...);
 }
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -14,10 +14,14 @@
 
 #include "dali/kernels/signal/dct/dct_gpu.h"
 #include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
 #include "dali/core/common.h"
 #include "dali/core/convert.h"
 #include "dali/core/error_handling.h"
 #include "dali/core/format.h"
+#include "dali/core/math_util.h"
 #include "dali/core/util.h"
 #include "dali/kernels/common/utils.h"
 #include "dali/kernels/kernel.h"
@@ -113,6 +117,215 @@ __global__ void ApplyDctInner(const typename Dct1DGpu<OutputType, InputType>::Sa
   }
 }
 
+namespace {
+
+/// @brief The size of a square output tile of the `Gemm` implementation
+constexpr int kGemmTile = 32;
+/// @brief The number of thread rows of the `Gemm` implementation - each thread computes
+///        kGemmTile / kGemmThreadRows outputs
+constexpr int kGemmThreadRows = 8;
+
+constexpr int kFftBlockSize = 256;
+constexpr int kFftMaxBlocks = 1024;
+/// @brief The maximum number of elements transformed by one cuFFT call
+constexpr int64_t kMaxFftBatchElements = 1 << 24;
+
+inline cufftResult ExecFft(cufftHandle plan, cufftComplex *data, int direction) {
+  return cufftExecC2C(plan, data, data, direction);
+}
+
+inline cufftResult ExecFft(cufftHandle plan, cufftDoubleComplex *data, int direction) {
+  return cufftExecZ2Z(plan, data, data, direction);
+}
+
+/**
+ * @brief Splits `ntransforms` transforms of `length` into batches with sizes being powers of 2
+ *
+ * @param fn callable with the batch size and the index of its first transform
+ */
+template <typename Fn>
+void ForEachFftBatch(int length, int64_t ntransforms, Fn &&fn) {
+  int64_t max_batch = int64_t(1) << ilog2(std::max<int64_t>(kMaxFftBatchElements / length, 1));
+  int64_t start = 0;
+  while (start < ntransforms) {
+    int64_t batch = std::min(max_batch, int64_t(1) << ilog2(ntransforms - start));
+    fn(static_cast<int>(batch), start);
+    start += batch;
+  }
+}
+
+__device__ inline void SinCosPi(float x, float *s, float *c) {
+  sincospif(x, s, c);
+}
+
+__device__ inline void SinCosPi(double x, double *s, double *c) {
+  sincospi(x, s, c);
+}
+
+}  // namespace
+
+// The output tile (kGemmTile x kGemmTile) of a product of the cosine table (ndct x n) and the
+// input, where the columns are all the transformed sequences (outer x inner). Both matrices are
+// staged in the shared memory in tiles, so the table doesn't need to fit there as a whole.
+template <typename OutputType, typename InputType, bool HasLifter>
+__global__ void ApplyDctGemm(
+    const typename Dct1DGpu<OutputType, InputType>::GemmSampleDesc *samples,
+    const typename Dct1DGpu<OutputType, InputType>::GemmBlockDesc *blocks,
+    const float *lifter_coeffs) {
+  constexpr int kOutputsPerThread = kGemmTile / kGemmThreadRows;
+  __shared__ OutputType table_tile[kGemmTile][kGemmTile + 1];
+  __shared__ OutputType data_tile[kGemmTile][kGemmTile + 1];  // [input index][column]
+  auto block = blocks[blockIdx.x];
+  const auto &sample = samples[block.sample_idx];
+  int n = sample.input_length;
+  int ndct = sample.ndct;
+  int64_t inner = sample.inner;
+  // with the innermost axis transformed, the input and output sequences are contiguous
+  bool inner_axis = inner == 1;
+  int tx = threadIdx.x, ty = threadIdx.y;
+
+  // the columns loaded by this thread
+  const InputType *in_cols[kOutputsPerThread];
+  bool col_valid[kOutputsPerThread];
+  for (int j = 0; j < kOutputsPerThread; j++) {
+    int64_t c = block.col_start + (inner_axis ? ty + j * kGemmThreadRows : tx);
+    col_valid[j] = c < sample.ncols;
+    int64_t z = c / inner, x = c - z * inner;
+    in_cols[j] = sample.input + z * n * inner + x;
+  }
+
+  OutputType acc[kOutputsPerThread] = {};
+  for (int i0 = 0; i0 < n; i0 += kGemmTile) {
+    for (int j = 0; j < kOutputsPerThread; j++) {
+      int r = ty + j * kGemmThreadRows;
+      int y = block.row_start + r;
+      table_tile[r][tx] = y < ndct && i0 + tx < n ? sample.cos_table[y * n + i0 + tx] : 0;
+      if (inner_axis) {
+        data_tile[tx][r] = col_valid[j] && i0 + tx < n ? in_cols[j][i0 + tx] : 0;
+      } else {
+        data_tile[r][tx] = col_valid[j] && i0 + r < n ? in_cols[j][(i0 + r) * inner] : 0;
+      }
+    }
+    __syncthreads();
+    for (int i = 0; i < kGemmTile; i++) {
+      OutputType in_val = data_tile[i][tx];
+      for (int j = 0; j < kOutputsPerThread; j++)
+        acc[j] = fma(table_tile[ty + j * kGemmThreadRows][i], in_val, acc[j]);
+    }
+    __syncthreads();
+  }
+
+  for (int j = 0; j < kOutputsPerThread; j++) {
+    int r = ty + j * kGemmThreadRows;
+    int y = block.row_start + r;
+    if (HasLifter && y < ndct)
+      acc[j] *= lifter_coeffs[y];
+    if (inner_axis) {
+      data_tile[r][tx] = acc[j];  // staged, to write whole output sequences
+    } else {
+      int64_t c = block.col_start + tx;
+      if (y < ndct && c < sample.ncols) {
+        int64_t z = c / inner, x = c - z * inner;
+        sample.output[(z * ndct + y) * inner + x] = acc[j];
+      }
+    }
+  }
+  if (inner_axis) {
+    __syncthreads();
+    int y = block.row_start + tx;
+    for (int j = 0; j < kOutputsPerThread; j++) {
+      int64_t c = block.col_start + ty + j * kGemmThreadRows;
+      if (y < ndct && c < sample.ncols)
+        sample.output[c * ndct + y] = data_tile[tx][ty + j * kGemmThreadRows];
+    }
+  }
+}
+
+// Reorders (and twiddles) the input sequences, so that the DCT can be obtained from their FFT:
+// type II:  v[j] = x[2j], v[n-1-j] = x[2j+1]
+// type III: V[j] = exp(i*pi*j/2n) * (W[j] - i*W[n-j]), where W is the scaled input and W[n] = 0
+// type IV:  t[j] = (x[2j] + i*x[n-1-2j]) * exp(-i*pi*(4j+1)/4n), of length n/2
+template <typename OutputType, typename InputType>
+__global__ void DctFftPreprocess(
+    const typename Dct1DGpu<OutputType, InputType>::FftSampleDesc *samples) {
+  using T = OutputType;
+  const auto &sample = samples[blockIdx.y];
+  int n = sample.input_length;
+  int m = sample.dct_type == 4 ? n / 2 : n;
+  int64_t inner = sample.inner;
+  int64_t size = sample.ntransforms * m;
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < size;
+       idx += blockDim.x * gridDim.x) {
+    int64_t t = idx / m;
+    int j = idx - t * m;
+    int64_t z = t / inner, x = t - z * inner;
+    const InputType *in = sample.input + z * n * inner + x;
+    T re, im;
+    if (sample.dct_type == 2) {
+      re = in[(j < (n + 1) / 2 ? 2 * j : 2 * (n - 1 - j) + 1) * inner];
+      im = 0;
+    } else if (sample.dct_type == 3) {
+      T w = j == 0 ? sample.scale_0 * in[0] : T(0.5) * sample.scale * in[j * inner];
+      T w_rev = j == 0 ? T(0) : T(0.5) * sample.scale * in[(n - j) * inner];
+      T sin_phase, cos_phase;
+      SinCosPi(T(j) / (2 * n), &sin_phase, &cos_phase);
+      re = w * cos_phase + w_rev * sin_phase;
+      im = w * sin_phase - w_rev * cos_phase;
+    } else {
+      T a = in[2 * j * inner];
+      T b = in[(n - 1 - 2 * j) * inner];
+      T sin_phase, cos_phase;
+      SinCosPi(T(4 * j + 1) / (4 * n), &sin_phase, &cos_phase);
+      re = a * cos_phase + b * sin_phase;
+      im = b * cos_phase - a * sin_phase;
+    }
+    sample.buffer[idx] = {re, im};
+  }
+}
+
+// Calculates the DCT coefficients from the FFT of the preprocessed sequences:
+// type II:  X[k] = Re(exp(-i*pi*k/2n) * V[k])
+// type III: y[2j] = Re(v[j]), y[2j+1] = Re(v[n-1-j])
+// type IV:  y[2j] = Re(u[j]), y[n-1-2j] = -Im(u[j]), where u[j] = exp(-i*pi*j/n) * T[j]
+template <typename OutputType, typename InputType, bool HasLifter>
+__global__ void DctFftPostprocess(
+    const typename Dct1DGpu<OutputType, InputType>::FftSampleDesc *samples,
+    const float *lifter_coeffs) {
+  using T = OutputType;
+  const auto &sample = samples[blockIdx.y];
+  int n = sample.input_length;
+  int ndct = sample.ndct;
+  int m = sample.dct_type == 4 ? n / 2 : n;
+  int64_t inner = sample.inner;
+  int64_t size = sample.ntransforms * ndct;
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < size;
+       idx += blockDim.x * gridDim.x) {
+    int64_t z = idx / (ndct * inner);
+    int64_t rem = idx - z * ndct * inner;
+    int k = rem / inner;
+    int64_t x = rem - k * inner;
+    const auto *v = sample.buffer + (z * inner + x) * m;
+    T out;
+    if (sample.dct_type == 2) {
+      T sin_phase, cos_phase;
+      SinCosPi(T(k) / (2 * n), &sin_phase, &cos_phase);
+      auto val = v[k];
+      out = (val.x * cos_phase + val.y * sin_phase) * (k == 0 ? sample.scale_0 : sample.scale);
+    } else if (sample.dct_type == 3) {
+      out = v[k % 2 == 0 ? k / 2 : n - 1 - k / 2].x;
+    } else {
+      int j = k % 2 == 0 ? k / 2 : (n - 1 - k) / 2;
+      T sin_phase, cos_phase;
+      SinCosPi(T(j) / n, &sin_phase, &cos_phase);
+      auto val = v[j];
+      out = k % 2 == 0 ? val.x * cos_phase + val.y * sin_phase
+                       : val.x * sin_phase - val.y * cos_phase;
+      out *= sample.scale;
+    }
+    sample.output[idx] = HasLifter ? out * lifter_coeffs[k] : out;
+  }
+}
+
 template <typename OutputType, typename InputType>
 KernelRequirements Dct1DGpu<OutputType, InputType>::Setup(KernelContext &ctx,
                                                           const InListGPU<InputType> &in,
@@ -121,12 +334,16 @@ KernelRequirements Dct1DGpu<OutputType, InputType>::Setup(KernelContext &ctx,
   KernelRequirements req{};
   ScratchpadEstimator se{};
   args_.clear();
+  impls_.clear();
   cos_tables_.clear();
   sample_descs_.clear();
+  gemm_blocks_.clear();
   int64_t dims = in.sample_dim();
   TensorListShape<> out_shape(in.num_samples(), dims);
-  TensorListShape<3> reduced_shape(in.num_samples());
+  std::vector<TensorShape<3>> direct_shapes;
+  int num_gemm_samples = 0;
   max_cos_table_size_ = 0;
+  max_staged_table_size_ = 0;
   axis_ = axis >= 0 ? axis : dims - 1;
   DALI_ENFORCE(axis_ >= 0 && axis_ < dims,
                make_string("Axis is out of bounds: ", axis_));
@@ -148,47 +365,126 @@ KernelRequirements Dct1DGpu<OutputType, InputType>::Setup(KernelContext &ctx,
     if (arg.ndct <= 0) {
       arg.ndct = n;
     }
-    if (cos_tables_.find({n, arg}) == cos_tables_.end()) {
+    auto impl = SelectDctImpl(n, arg, sizeof(OutputType));
+    impls_.push_back(impl);
+    if (impl != DctImpl::Fft && cos_tables_.find({n, arg}) == cos_tables_.end()) {
       cos_tables_[{n, arg}] = nullptr;
       se.add<mm::memory_kind::device, OutputType>(n * arg.ndct);
-      if (n * arg.ndct > max_cos_table_size_) {
-        max_cos_table_size_ = n * arg.ndct;
+      if (n * arg.ndct > max_staged_table_size_) {
+        max_staged_table_size_ = n * arg.ndct;
       }
     }
     auto reduced_samle_shape = reduce_shape(in_shape, axis_, arg.ndct);
-    reduced_shape.set_tensor_shape(s, reduced_samle_shape);
-    if (reduced_samle_shape[2] != 1)
-      inner_axis_ = false;
+    if (impl == DctImpl::Direct) {
+      max_cos_table_size_ = std::max(max_cos_table_size_, n * arg.ndct);
+      direct_shapes.push_back(reduced_samle_shape);
+      if (reduced_samle_shape[2] != 1)
+        inner_axis_ = false;
+    } else if (impl == DctImpl::Gemm) {
+      int64_t ncols = reduced_samle_shape[0] * reduced_samle_shape[2];
+      for (int row = 0; row < arg.ndct; row += kGemmTile) {
+        for (int64_t col = 0; col < ncols; col += kGemmTile)
+          gemm_blocks_.push_back({num_gemm_samples, row, col});
+      }
+      num_gemm_samples++;
+    }
     auto sample_shape = in.shape[s];
     sample_shape[axis_] = arg.ndct;
     out_shape.set_tensor_shape(s, sample_shape);
   }
-  se.add<mm::memory_kind::pinned, OutputType>(max_cos_table_size_);
+  se.add<mm::memory_kind::pinned, OutputType>(max_staged_table_size_);
   if (cos_tables_.size() > 1) {
-    se.add<mm::memory_kind::pinned, OutputType>(max_cos_table_size_);
+    se.add<mm::memory_kind::pinned, OutputType>(max_staged_table_size_);
   }
-  se.add<mm::memory_kind::device, SampleDesc>(in.num_samples());
-  if (inner_axis_) {
-    block_setup_inner_.Setup(reduced_shape);
-    se.add<mm::memory_kind::device, BlockSetupInner::BlockDesc>(block_setup_inner_.Blocks().size());
-  } else {
-    block_setup_.SetupBlocks(reduced_shape, true);
-    se.add<mm::memory_kind::device, BlockDesc<3>>(block_setup_.Blocks().size());
+  if (!direct_shapes.empty()) {
+    TensorListShape<3> reduced_shape(direct_shapes);
+    se.add<mm::memory_kind::device, SampleDesc>(reduced_shape.num_samples());
+    if (inner_axis_) {
+      block_setup_inner_.Setup(reduced_shape);
+      se.add<mm::memory_kind::device, BlockSetupInner::BlockDesc>(
+          block_setup_inner_.Blocks().size());
+    } else {
+      block_setup_.SetupBlocks(reduced_shape, true);
+      se.add<mm::memory_kind::device, BlockDesc<3>>(block_setup_.Blocks().size());
+    }
+  }
+  if (!gemm_blocks_.empty()) {
+    se.add<mm::memory_kind::device, GemmSampleDesc>(num_gemm_samples);
+    se.add<mm::memory_kind::device, GemmBlockDesc>(gemm_blocks_.size());
   }
+  SetupFft(se, in.shape);
   req.output_shapes = {out_shape};
   req.scratch_sizes = se.sizes;
   return req;
 }
 
+template <typename OutputType, typename InputType>
+void Dct1DGpu<OutputType, InputType>::SetupFft(ScratchpadEstimator &se,
+                                               const TensorListShape<> &in_shape) {
+  fft_groups_.clear();
+  fft_buffer_offsets_.clear();
+  fft_buffer_size_ = 0;
+  fft_work_size_ = 0;
+  // the indices of the samples (in the order of the samples) for each length and direction
+  std::map<std::pair<int, int>, std::vector<int>> groups;
+  int num_fft_samples = 0;
+  for (int s = 0; s < in_shape.num_samples(); s++) {
+    if (impls_[s] != DctImpl::Fft)
+      continue;
+    int n = in_shape[s][axis_];
+    int length = args_[s].dct_type == 4 ? n / 2 : n;
+    int direction = args_[s].dct_type == 3 ? CUFFT_INVERSE : CUFFT_FORWARD;
+    groups[{length, direction}].push_back(num_fft_samples++);
+  }
+  if (groups.empty())
+    return;
+
+  fft_buffer_offsets_.resize(num_fft_samples);
+  std::vector<int64_t> ntransforms;
+  ntransforms.reserve(num_fft_samples);
+  for (int s = 0; s < in_shape.num_samples(); s++) {
+    if (impls_[s] == DctImpl::Fft)
+      ntransforms.push_back(in_shape.tensor_size(s) / in_shape[s][axis_]);
+  }
+
+  int n[1];
+  auto type = std::is_same<Complex, cufftComplex>::value ? CUFFT_C2C : CUFFT_Z2Z;
+  for (auto &entry : groups) {
+    FftGroup group{entry.first.first, entry.first.second, 0, fft_buffer_size_};
+    for (int i : entry.second) {
+      fft_buffer_offsets_[i] = fft_buffer_size_;
+      group.ntransforms += ntransforms[i];
+      fft_buffer_size_ += ntransforms[i] * group.length;
+    }
+    n[0] = group.length;
+    ForEachFftBatch(group.length, group.ntransforms, [&](int batch, int64_t) {
+      auto &plan = fft_plans_[{group.length, batch}];
+      if (!plan.handle) {
+        cufftHandle handle;
+        CUDA_CALL(cufftCreate(&handle));
+        plan.handle.reset(handle);
+        CUDA_CALL(cufftSetAutoAllocation(handle, false));
+        CUDA_CALL(cufftMakePlanMany(handle, 1, n, nullptr, 0, 0, nullptr, 0, 0,
+                                    type, batch, &plan.work_size));
+      }
+      fft_work_size_ = std::max(fft_work_size_, plan.work_size);
+    });
+    fft_groups_.push_back(group);
+  }
+  se.add<mm::memory_kind::device, Complex>(fft_buffer_size_);
+  se.add<mm::memory_kind::device, char>(fft_work_size_, alignof(double2));
+  se.add<mm::memory_kind::device, FftSampleDesc>(num_fft_samples);
+}
+
 template <typename OutputType, typename InputType>
 DLL_PUBLIC void Dct1DGpu<OutputType, InputType>::Run(KernelContext &ctx,
                                                      const OutListGPU<OutputType> &out,
                                                      const InListGPU<InputType> &in,
                                                      InTensorGPU<float, 1> lifter_coeffs) {
   OutputType *cpu_cos_table[2];
-  cpu_cos_table[0] = ctx.scratchpad->AllocatePinned<OutputType>(max_cos_table_size_);
+  cpu_cos_table[0] = ctx.scratchpad->AllocatePinned<OutputType>(max_staged_table_size_);
   if (cos_tables_.size() > 1) {
-    cpu_cos_table[1] = ctx.scratchpad->AllocatePinned<OutputType>(max_cos_table_size_);
+    cpu_cos_table[1] = ctx.scratchpad->AllocatePinned<OutputType>(max_staged_table_size_);
   }
 
   int i = 0;
@@ -206,7 +502,8 @@ DLL_PUBLIC void Dct1DGpu<OutputType, InputType>::Run(KernelContext &ctx,
     ++i;
   }
   sample_descs_.clear();
-  sample_descs_.reserve(args_.size());
+  gemm_sample_descs_.clear();
+  fft_sample_descs_.clear();
   int s = 0;
   int max_ndct = 0;
   int max_input_length = 0;
@@ -217,21 +514,43 @@ DLL_PUBLIC void Dct1DGpu<OutputType, InputType>::Run(KernelContext &ctx,
                  make_string("Not enough lifter coefficients. NDCT for sample ", s, " is ",
                              out_shape[1], " and only ", lifter_coeffs.num_elements(),
                              " coefficients were passed."));
-    ivec3 out_stride = GetStrides(ivec3{out_shape[0], out_shape[1], out_shape[2]});
-    ivec3 in_stride = GetStrides(ivec3{in_shape[0], in_shape[1], in_shape[2]});;
     int n = in_shape[1];
-    auto *cos_tables = cos_tables_[{n, arg}];
-    sample_descs_.push_back(SampleDesc{out.tensor_data(s), in.tensor_data(s),
-                                       cos_tables, in_stride, out_stride, n});
-    max_ndct = std::max(max_ndct, arg.ndct);
-    max_input_length = std::max(max_input_length, n);
+    if (impls_[s] == DctImpl::Direct) {
+      ivec3 out_stride = GetStrides(ivec3{out_shape[0], out_shape[1], out_shape[2]});
+      ivec3 in_stride = GetStrides(ivec3{in_shape[0], in_shape[1], in_shape[2]});
+      auto *cos_tables = cos_tables_[{n, arg}];
+      sample_descs_.push_back(SampleDesc{out.tensor_data(s), in.tensor_data(s),
+                                         cos_tables, in_stride, out_stride, n});
+      max_ndct = std::max(max_ndct, arg.ndct);
+      max_input_length = std::max(max_input_length, n);
+    } else if (impls_[s] == DctImpl::Gemm) {
+      gemm_sample_descs_.push_back(GemmSampleDesc{out.tensor_data(s), in.tensor_data(s),
+                                                  cos_tables_[{n, arg}],
+                                                  in_shape[0] * in_shape[2], in_shape[2],
+                                                  n, arg.ndct});
+    } else {
+      OutputType scale_0 = arg.dct_type == 3 ? 0.5 : 1, scale = 1;
+      if (arg.normalize) {
+        scale = std::sqrt(2.0 / n);
+        scale_0 = arg.dct_type == 4 ? scale : 1.0 / std::sqrt(n);
+      }
+      fft_sample_descs_.push_back(FftSampleDesc{out.tensor_data(s), in.tensor_data(s), nullptr,
+                                                in_shape[0] * in_shape[2], in_shape[2],
+                                                n, arg.ndct, arg.dct_type, scale_0, scale});
+    }
     ++s;
   }
-  if (inner_axis_) {
-    RunInnerDCT(ctx, max_input_length, lifter_coeffs);
-  } else {
-    RunPlanarDCT(ctx, max_ndct, lifter_coeffs);
+  if (!sample_descs_.empty()) {
+    if (inner_axis_) {
+      RunInnerDCT(ctx, max_input_length, lifter_coeffs);
+    } else {
+      RunPlanarDCT(ctx, max_ndct, lifter_coeffs);
+    }
   }
+  if (!gemm_sample_descs_.empty())
+    RunGemmDCT(ctx, lifter_coeffs);
+  if (!fft_sample_descs_.empty())
+    RunFftDCT(ctx, lifter_coeffs);
 }
 
 void BlockSetupInner::Setup(const TensorListShape<3> &reduced_shape) {
@@ -294,6 +613,63 @@ void Dct1DGpu<OutputType, InputType>::RunPlanarDCT(KernelContext &ctx, int max_n
   }
 }
 
+template <typename OutputType, typename InputType>
+void Dct1DGpu<OutputType, InputType>::RunGemmDCT(KernelContext &ctx,
+                                                 InTensorGPU<float, 1> lifter_coeffs) {
+  GemmSampleDesc *sample_descs_gpu;
+  GemmBlockDesc *block_descs_gpu;
+  std::tie(sample_descs_gpu, block_descs_gpu) =
+    ctx.scratchpad->ToContiguousGPU(ctx.gpu.stream, gemm_sample_descs_, gemm_blocks_);
+  dim3 grid_dim(gemm_blocks_.size());
+  dim3 block_dim(kGemmTile, kGemmThreadRows);
+  if (lifter_coeffs.num_elements() > 0) {
+    ApplyDctGemm<OutputType, InputType, true>
+      <<<grid_dim, block_dim, 0, ctx.gpu.stream>>>(sample_descs_gpu, block_descs_gpu,
+                                                   lifter_coeffs.data);
+  } else {
+    ApplyDctGemm<OutputType, InputType, false>
+      <<<grid_dim, block_dim, 0, ctx.gpu.stream>>>(sample_descs_gpu, block_descs_gpu, nullptr);
+  }
+}
+
+template <typename OutputType, typename InputType>
+void Dct1DGpu<OutputType, InputType>::RunFftDCT(KernelContext &ctx,
+                                                InTensorGPU<float, 1> lifter_coeffs) {
+  auto *buffer = ctx.scratchpad->AllocateGPU<Complex>(fft_buffer_size_);
+  auto *work = ctx.scratchpad->AllocateGPU<char>(fft_work_size_, alignof(double2));
+  int64_t max_size = 0;
+  for (size_t i = 0; i < fft_sample_descs_.size(); i++) {
+    auto &sample = fft_sample_descs_[i];
+    sample.buffer = buffer + fft_buffer_offsets_[i];
+    // the number of outputs doesn't exceed the (whole) input length
+    max_size = std::max(max_size, sample.ntransforms * sample.input_length);
+  }
+  auto *sample_descs_gpu = ctx.scratchpad->ToGPU(ctx.gpu.stream, fft_sample_descs_);
+  dim3 block_dim(kFftBlockSize);
+  dim3 grid_dim(clamp<int64_t>(div_ceil(max_size, kFftBlockSize), 1, kFftMaxBlocks),
+                fft_sample_descs_.size());
+  DctFftPreprocess<OutputType, InputType>
+    <<<grid_dim, block_dim, 0, ctx.gpu.stream>>>(sample_descs_gpu);
+
+  for (auto &group : fft_groups_) {
+    ForEachFftBatch(group.length, group.ntransforms, [&](int batch, int64_t start) {
+      auto &plan = fft_plans_[{group.length, batch}];
+      CUDA_CALL(cufftSetStream(plan.handle, ctx.gpu.stream));
+      CUDA_CALL(cufftSetWorkArea(plan.handle, work));
+      CUDA_CALL(ExecFft(plan.handle, buffer + group.buffer_offset + start * group.length,
+                        group.direction));
+    });
+  }
+
+  if (lifter_coeffs.num_elements() > 0) {
+    DctFftPostprocess<OutputType, InputType, true>
+      <<<grid_dim, block_dim, 0, ctx.gpu.stream>>>(sample_descs_gpu, lifter_coeffs.data);
+  } else {
+    DctFftPostprocess<OutputType, InputType, false>
+      <<<grid_dim, block_dim, 0, ctx.gpu.stream>>>(sample_descs_gpu, nullptr);
+  }
+}
+
 template class Dct1DGpu<float, float>;
 
 template class Dct1DGpu<double, double>;
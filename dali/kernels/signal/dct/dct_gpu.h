@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,9 +15,12 @@
 #ifndef DALI_KERNELS_SIGNAL_DCT_DCT_GPU_H_
 #define DALI_KERNELS_SIGNAL_DCT_DCT_GPU_H_
 
+#include <cufft.h>
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <map>
+#include <type_traits>
 #include <utility>
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
@@ -26,6 +29,7 @@
 #include "dali/kernels/kernel.h"
 #include "dali/kernels/signal/dct/dct_args.h"
 #include "dali/kernels/common/block_setup.h"
+#include "dali/kernels/signal/fft/cufft_helper.h"
 #include "dali/core/cuda_event.h"
 
 namespace dali {
@@ -66,6 +70,47 @@ class BlockSetupInner {
   const int64_t frames_per_block_ = 8;
 };
 
+/**
+ * @brief The method used to calculate the DCT of a sample
+ */
+enum class DctImpl {
+  /// Dot products with the cosine table, which is cached in the shared memory
+  Direct,
+  /// Tiled matrix product of the cosine table and the input, for tables too big for the above
+  Gemm,
+  /// A complex FFT with pre- and post-processing, O(N log N); DCT types II, III and IV
+  Fft
+};
+
+/// @brief The shortest transform calculated with the FFT
+constexpr int kDctMinFftLength = 256;
+
+/// @brief The shared memory budget of the `Direct` implementation
+constexpr int64_t kDctMaxDirectShmSize = 48 << 10;
+
+/**
+ * @brief Selects the implementation for a transform of length `n`, described by `args`
+ *
+ * The FFT is used for long transforms, unless only a few coefficients are requested - the cost
+ * of the dot products grows with `ndct`, the cost of the FFT doesn't.
+ * The DCT type IV, calculated with an FFT of half the length, requires `n` to be even.
+ *
+ * @param args DCT arguments, with `ndct` already resolved
+ */
+inline DctImpl SelectDctImpl(int64_t n, const DctArgs &args, size_t element_size) {
+  bool fft_supported = (args.dct_type == 2 || args.dct_type == 3 ||
+                        (args.dct_type == 4 && n % 2 == 0)) && args.ndct <= n;
+  if (fft_supported && n >= kDctMinFftLength && args.ndct >= 4 * ilog2(n))
+    return DctImpl::Fft;
+  // the table and the staged data get half of the budget each, so that the shared memory
+  // size calculated from the maxima over the batch still fits
+  int64_t table_size = element_size * n * args.ndct;
+  int64_t data_size = element_size * std::max<int64_t>(8 * n, 32 * args.ndct);
+  if (table_size <= kDctMaxDirectShmSize / 2 && data_size <= kDctMaxDirectShmSize / 2)
+    return DctImpl::Direct;
+  return DctImpl::Gemm;
+}
+
 /**
  * @brief Discrete Cosine Transform 1D GPU kernel.
  *        Performs a DCT transformation over a single dimension in a multi-dimensional input.
@@ -74,6 +119,8 @@ class BlockSetupInner {
  *          https://en.wikipedia.org/wiki/Discrete_cosine_transform
  *          DCT generally stands for type II and inverse DCT stands for DCT type III
  *
+ * The implementation is selected for each sample separately, with `SelectDctImpl`.
+ *
  * @see DCTArgs
  */
 template <typename OutputType = float,  typename InputType = OutputType>
@@ -88,6 +135,42 @@ class DLL_PUBLIC Dct1DGpu {
     int input_length;
   };
 
+  /// @brief Sample descriptor of the `Gemm` implementation
+  struct GemmSampleDesc {
+    OutputType *output;
+    const InputType *input;
+    const OutputType *cos_table;
+    int64_t ncols;  ///< the number of transforms, outer * inner extent
+    int64_t inner;  ///< the extent of the dimensions after the transformed axis
+    int input_length;
+    int ndct;
+  };
+
+  /// @brief A tile of the output, made of `ndct` rows and `ncols` columns (transforms)
+  struct GemmBlockDesc {
+    int sample_idx;
+    int row_start;
+    int64_t col_start;
+  };
+
+  using Complex = std::conditional_t<std::is_same<OutputType, double>::value,
+                                     cufftDoubleComplex, cufftComplex>;
+
+  /// @brief Sample descriptor of the `Fft` implementation
+  struct FftSampleDesc {
+    OutputType *output;
+    const InputType *input;
+    Complex *buffer;      ///< the sequences transformed by the FFT, one after another
+    int64_t ntransforms;  ///< outer * inner extent
+    int64_t inner;        ///< the extent of the dimensions after the transformed axis
+    int input_length;
+    int ndct;
+    int dct_type;
+    /// @brief The normalization factor of the first DCT-II output or DCT-III input
+    OutputType scale_0;
+    OutputType scale;
+  };
+
  private:
   /// @brief Calculate the output shape, reduced to 3D
   static TensorShape<3> reduce_shape(span<const int64_t> shape, int axis, int ndct = -1) {
@@ -124,12 +207,43 @@ class DLL_PUBLIC Dct1DGpu {
   void RunPlanarDCT(KernelContext &context, int max_ndct,
                     InTensorGPU<float, 1> lifter_coeffs);
 
+  void RunGemmDCT(KernelContext &context, InTensorGPU<float, 1> lifter_coeffs);
+
+  void RunFftDCT(KernelContext &context, InTensorGPU<float, 1> lifter_coeffs);
+
+  void SetupFft(ScratchpadEstimator &se, const TensorListShape<> &in_shape);
+
+  /// @brief The transforms of the same length and direction, computed with the same plans
+  struct FftGroup {
+    int length;
+    int direction;
+    int64_t ntransforms;
+    int64_t buffer_offset;
+  };
+
+  struct FftPlan {
+    CUFFTHandle handle;
+    size_t work_size = 0;
+  };
+
   std::map<std::pair<int, DctArgs>, OutputType*> cos_tables_{};
   std::vector<DctArgs> args_{};
+  std::vector<DctImpl> impls_{};
   BlockSetup<3, -1> block_setup_{};
   BlockSetupInner block_setup_inner_{};
   std::vector<SampleDesc> sample_descs_{};
-  int64_t max_cos_table_size_ = 0;
+  std::vector<GemmSampleDesc> gemm_sample_descs_{};
+  std::vector<GemmBlockDesc> gemm_blocks_{};
+  std::vector<FftSampleDesc> fft_sample_descs_{};
+  std::vector<FftGroup> fft_groups_{};
+  std::vector<int64_t> fft_buffer_offsets_{};
+  /// @brief Plans keyed by the transform length and the batch size - never discarded,
+  ///        the batch sizes are powers of 2, so there are only a few of them for each length
+  std::map<std::pair<int, int>, FftPlan> fft_plans_{};
+  int64_t fft_buffer_size_ = 0;
+  size_t fft_work_size_ = 0;
+  int64_t max_cos_table_size_ = 0;  ///< the largest table cached in the shared memory
+  int64_t max_staged_table_size_ = 0;  ///< the largest table filled on the host
   int axis_ = -1;
   bool inner_axis_ = false;
   CUDAEvent buffer_events_[2];
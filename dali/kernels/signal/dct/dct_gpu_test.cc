@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <tuple>
 #include <string>
+#include <vector>
 #include "dali/kernels/signal/dct/dct_gpu.h"
 #include "dali/kernels/kernel_manager.h"
 #include "dali/kernels/common/utils.h"
@@ -191,6 +193,94 @@ INSTANTIATE_TEST_SUITE_P(Dct1DGpuTest, Dct1DGpuTest, testing::Combine(
   ));  // NOLINT
 
 
+TEST(Dct1DGpuImplTest, GemmAndFft) {
+  using Kernel = Dct1DGpu<float>;
+  struct TestCase {
+    TensorShape<> shape;
+    DctArgs args;
+    DctImpl impl;
+  };
+  // the transformed axis is 1
+  std::vector<TestCase> cases = {
+    {{3, 20}, {2, false, 10}, DctImpl::Direct},
+    {{4, 128}, {1, false, -1}, DctImpl::Gemm},
+    {{2, 100, 7}, {3, true, 90}, DctImpl::Gemm},
+    {{5, 300}, {2, true, -1}, DctImpl::Fft},
+    {{2, 512, 3}, {2, false, 100}, DctImpl::Fft},
+    {{3, 301}, {3, false, -1}, DctImpl::Fft},
+    {{2, 256, 2}, {3, true, 256}, DctImpl::Fft},
+    {{4, 300}, {4, false, -1}, DctImpl::Fft},
+    {{2, 1024, 2}, {4, true, 200}, DctImpl::Fft},
+    {{2, 257}, {4, false, -1}, DctImpl::Gemm},  // odd length
+    {{3, 1024}, {2, false, 13}, DctImpl::Gemm},  // few coefficients
+  };
+  int nsamples = cases.size();
+  TensorListShape<> in_shape(nsamples, 3), out_shape(nsamples, 3);
+  std::vector<DctArgs> args;
+  int max_ndct = 0;
+  for (int s = 0; s < nsamples; s++) {
+    auto shape = cases[s].shape;
+    if (shape.size() == 2)
+      shape = {shape[0], shape[1], 1};
+    in_shape.set_tensor_shape(s, shape);
+    auto arg = cases[s].args;
+    if (arg.ndct <= 0)
+      arg.ndct = shape[1];
+    EXPECT_EQ(SelectDctImpl(shape[1], arg, sizeof(float)), cases[s].impl) << "sample " << s;
+    max_ndct = std::max(max_ndct, arg.ndct);
+    shape[1] = arg.ndct;
+    out_shape.set_tensor_shape(s, shape);
+    args.push_back(cases[s].args);
+  }
+
+  for (float lifter : {0.f, 0.5f}) {
+    std::vector<float> lifter_coeffs(lifter ? max_ndct : 0);
+    for (int i = 0; i < static_cast<int>(lifter_coeffs.size()); ++i)
+      lifter_coeffs[i] = 1.0 + lifter / 2 * std::sin(M_PI / lifter * (i + 1));
+    DeviceBuffer<float> lifter_coeffs_gpu;
+    if (!lifter_coeffs.empty())
+      lifter_coeffs_gpu.from_host(lifter_coeffs);
+    auto lifter_view = make_tensor_gpu<1>(lifter_coeffs_gpu.data(),
+                                          {static_cast<int64_t>(lifter_coeffs.size())});
+
+    TestTensorList<float> in, out;
+    in.reshape(in_shape);
+    std::mt19937_64 rng{12345};
+    UniformRandomFill(in.cpu(), rng, 0., 1.);
+    KernelContext ctx;
+    ctx.gpu.stream = 0;
+    KernelManager kmgr;
+    kmgr.Resize<Kernel>(1);
+    auto req = kmgr.Setup<Kernel>(0, ctx, in.gpu(), make_cspan(args), 1);
+    ASSERT_EQ(req.output_shapes[0], out_shape);
+    out.reshape(out_shape);
+    kmgr.Run<Kernel>(0, ctx, out.gpu(), in.gpu(), lifter_view);
+    CUDA_CALL(cudaStreamSynchronize(ctx.gpu.stream));
+
+    auto in_cpu = in.cpu();
+    auto out_cpu = out.cpu();
+    for (int s = 0; s < nsamples; s++) {
+      int64_t outer = in_shape[s][0], n = in_shape[s][1], inner = in_shape[s][2];
+      int64_t ndct = out_shape[s][1];
+      DctArgs arg = args[s];
+      // the magnitude of unnormalized outputs grows with the length
+      float eps = arg.normalize ? 1e-4 : 1e-6 * n;
+      std::vector<float> in_buf(n), ref(ndct);
+      for (int64_t z = 0; z < outer; z++) {
+        for (int64_t x = 0; x < inner; x++) {
+          for (int64_t i = 0; i < n; i++)
+            in_buf[i] = in_cpu.tensor_data(s)[(z * n + i) * inner + x];
+          ReferenceDct(arg.dct_type, make_span(ref), make_cspan(in_buf), arg.normalize, lifter);
+          for (int64_t k = 0; k < ndct; k++) {
+            ASSERT_NEAR(ref[k], out_cpu.tensor_data(s)[(z * ndct + k) * inner + x], eps)
+              << "sample " << s << ", transform " << z * inner + x << ", coefficient " << k;
+          }
+        }
+      }
+    }
+  }
+}
+
 class Dct1DGpuPerfTest : public ::testing::TestWithParam<bool> {
  protected:
   Dct1DGpuPerfTest(): inner_(GetParam()) {}
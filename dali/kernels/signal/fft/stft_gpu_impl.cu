@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -22,7 +22,6 @@ namespace signal {
 namespace fft {
 
 void StftImplGPU::Reset() {
-  plans_.clear();
   post_complex_.reset();
   post_real_.reset();
 }
@@ -112,18 +111,21 @@ void StftImplGPU::CreatePlans(int64_t nwindows) {
   while (max_windows * transform_size() > kMaxSize)
     max_windows >>= 1;
 
-  while (max_windows > nwindows)
-    max_windows >>= 1;
+  // The number of windows is rounded up to a power of 2 and the plans are never discarded,
+  // so that batches of variable-length signals are planned for only until the largest bucket
+  // is seen - not every time the total number of windows changes.
+  max_windows = std::min(max_windows, next_pow2(std::max<int64_t>(nwindows, 1)));
 
-  if (max_windows == 0)
-    max_windows = 1;
+  auto &plan_set = plan_cache_[transform_size()];
+  plan_set.max_windows = std::max<int>(plan_set.max_windows, max_windows);
+  plans_ = &plan_set.plans;
 
-  max_windows_ = max_windows;
+  max_windows_ = plan_set.max_windows;
   min_windows_ = std::min(max_windows_, next_pow2(kMinSize / transform_size()));
 
   int n[1] = { transform_size() };
   for (int w = max_windows_; w >= min_windows_; w >>= 1) {
-    auto &plan = plans_[w];
+    auto &plan = (*plans_)[w];
     if (!plan.handle) {
       cufftHandle handle;
       CUDA_CALL(cufftCreate(&handle));
@@ -137,7 +139,7 @@ void StftImplGPU::CreatePlans(int64_t nwindows) {
     }
   }
 
-  CreateStreams(std::min<int>(plans_.size(), kMaxStreams + 0 /* clang bug */));
+  CreateStreams(std::min<int>(plans_->size(), kMaxStreams + 0 /* clang bug */));
 }
 
 void StftImplGPU::CreateStreams(int new_num_streams) {
@@ -163,8 +165,8 @@ void StftImplGPU::ReserveTempStorage(ScratchpadEstimator &se) {
 
   size_t max_work = 0;
   while (windows_left > 0) {
-    auto it = plans_.upper_bound(max_plan);
-    assert(it != plans_.begin());
+    auto it = plans_->upper_bound(max_plan);
+    assert(it != plans_->begin());
     --it;
     int batch = it->first;
     max_work = std::max(max_work, it->second.work_size);
@@ -272,8 +274,8 @@ void StftImplGPU::RunTransform(ExecutionContext &ctx) {
     main_stream_ready_ = CUDAEvent::Create();
   CUDA_CALL(cudaEventRecord(main_stream_ready_, ctx.stream()));
   while (windows_left > 0) {
-    auto it = plans_.upper_bound(max_plan);
-    assert(it != plans_.begin());
+    auto it = plans_->upper_bound(max_plan);
+    assert(it != plans_->begin());
     --it;
     int64_t batch = it->first;  // widen for multiplication
 
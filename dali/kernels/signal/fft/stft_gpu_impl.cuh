@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -112,7 +112,21 @@ class StftImplGPU {
     CUFFTHandle handle;
     size_t work_size = 0;
   };
-  std::map<int, PlanInfo> plans_;
+
+  /**
+   * @brief The plans for one transform size, keyed by the number of windows (a power of 2)
+   *
+   * The plans are created without a work area, so keeping the ones which are not used in
+   * the current iteration only costs the memory of the plan itself.
+   */
+  struct PlanSet {
+    std::map<int, PlanInfo> plans;
+    int max_windows = 0;  ///< the largest number of windows the plans were created for
+  };
+
+  /// @brief Plan sets keyed by the transform size - they survive changes of the arguments
+  std::map<int, PlanSet> plan_cache_;
+  std::map<int, PlanInfo> *plans_ = nullptr;  ///< plans for the current transform size
   struct Stream {
     CUDAStream stream;
     CUDAEvent event;
@@ -98,6 +98,72 @@ inline int64_t resampled_length(int64_t in_length, double in_rate, double out_ra
   return std::ceil(in_length * out_rate / in_rate);
 }
 
+/**
+ * @brief The window coefficients of all the phases of a rational resampling ratio
+ *
+ * When in_rate / out_rate = down / up, the output sample `n` lies at the input position
+ * `n * down / up`. Its integer part is `base = floor(n * down / up)` and the fractional part,
+ * or phase, `(n * down) % up`, is one of `up` values. `taps` coefficients of each phase are
+ * applied to the input samples `[base - lobes, base + lobes]`, so no window evaluation is needed
+ * when the ratio is the same for many samples.
+ */
+struct PolyphaseFilterBank {
+  int64_t up = 0, down = 0;
+  int lobes = 0, taps = 0;
+  std::vector<float> coeffs;  // up x taps
+
+  const float *phase(int64_t p) const {
+    return coeffs.data() + p * taps;
+  }
+};
+
+/**
+ * @brief Reduces in_rate / out_rate to down / up
+ *
+ * @return false, if the rates are not integers or the ratio has more than max_phases phases
+ */
+inline bool rational_ratio(double in_rate, double out_rate, int64_t &up, int64_t &down,
+                           int64_t max_phases = 1024) {
+  if (in_rate != std::floor(in_rate) || out_rate != std::floor(out_rate) ||
+      in_rate <= 0 || out_rate <= 0 || in_rate > (1 << 30) || out_rate > (1 << 30))
+    return false;
+  int64_t in_i = in_rate, out_i = out_rate;
+  int64_t a = in_i, b = out_i;
+  while (b) {
+    int64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  up = out_i / a;
+  down = in_i / a;
+  return up <= max_phases;
+}
+
+/**
+ * @brief Computes the filter bank of a rational ratio with the given window
+ *
+ * The coefficients are exactly the ones used by the generic resampler for the same positions,
+ * including the taps skipped by it, which are set to zero.
+ */
+inline void polyphase_filter_bank(PolyphaseFilterBank &bank, const ResamplingWindow &window,
+                                  int64_t up, int64_t down) {
+  assert(up > 0 && down > 0 && window.lobes > 0);
+  bank.up = up;
+  bank.down = down;
+  bank.lobes = window.lobes;
+  bank.taps = 2 * window.lobes + 1;
+  bank.coeffs.resize(up * bank.taps);
+  for (int64_t p = 0; p < up; p++) {
+    float frac = static_cast<float>(p) / up;
+    auto irange = window.input_range(frac);
+    float *coeffs = bank.coeffs.data() + p * bank.taps;
+    for (int j = 0; j < bank.taps; j++) {
+      int i = j - bank.lobes;
+      coeffs[j] = i >= irange.i0 && i < irange.i1 ? window(i - frac) : 0.0f;
+    }
+  }
+}
+
 }  // namespace resampling
 }  // namespace signal
 }  // namespace kernels
@@ -22,6 +22,7 @@
 #endif
 #include <cmath>
 #include <functional>
+#include <memory>
 #include <utility>
 #include <vector>
 #include "dali/core/convert.h"
@@ -83,6 +84,17 @@ inline float filter_vec(const ResamplingWindow &window, int &i_ref, float in_pos
   return vget_lane_f32(f2, 0);
 }
 
+inline float dot_vec(const float *a, const float *b, int n, int &i_ref) {
+  float32x4_t f4 = vdupq_n_f32(0);
+  int i = 0;
+  for (; i + 3 < n; i += 4)
+    f4 = vfmaq_f32(f4, vld1q_f32(a + i), vld1q_f32(b + i));
+  float32x2_t f2 = vpadd_f32(vget_low_f32(f4), vget_high_f32(f4));
+  f2 = vpadd_f32(f2, f2);
+  i_ref = i;
+  return vget_lane_f32(f2, 0);
+}
+
 #elif defined(__SSE2__)
 
 inline __m128 evaluate(const ResamplingWindow &window, __m128 x) {
@@ -118,12 +130,30 @@ inline float filter_vec(const ResamplingWindow &window, int &i_ref, float in_pos
   return _mm_cvtss_f32(f4);
 }
 
+inline float dot_vec(const float *a, const float *b, int n, int &i_ref) {
+  __m128 f4 = _mm_setzero_ps();
+  int i = 0;
+  for (; i + 3 < n; i += 4)
+    f4 = _mm_add_ps(f4, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  i_ref = i;
+
+  // Sum elements in f4
+  f4 = _mm_add_ps(f4, _mm_shuffle_ps(f4, f4, _MM_SHUFFLE(1, 0, 3, 2)));
+  f4 = _mm_add_ps(f4, _mm_shuffle_ps(f4, f4, _MM_SHUFFLE(0, 1, 0, 1)));
+  return _mm_cvtss_f32(f4);
+}
+
 #else
 
 inline float filter_vec(const ResamplingWindow &, int &, float, int, const float *) {
   return 0;
 }
 
+inline float dot_vec(const float *, const float *, int, int &i_ref) {
+  i_ref = 0;
+  return 0;
+}
+
 #endif
 
 /**
@@ -259,11 +289,97 @@ void ResampleCPUImpl(ResamplingWindow window, Out *__restrict__ out, int64_t out
       in, n_in, in_rate, num_channels)));
 }
 
+/**
+ * @brief Resample multi-channel (or single channel) signal with a polyphase filter bank
+ *
+ * @tparam static_channels   number of channels, if known at compile time, or -1
+ */
+template <int static_channels, typename Out>
+void ResamplePolyphaseCPUImpl(const PolyphaseFilterBank &bank, Out *__restrict__ out,
+                              int64_t out_begin, int64_t out_end, const float *__restrict__ in,
+                              int64_t n_in, int dynamic_num_channels) {
+  static_assert(static_channels != 0,
+                "Static number of channels must be positive (use static) "
+                "or negative (use dynamic).");
+  const int num_channels = static_channels < 0 ? dynamic_num_channels : static_channels;
+  assert(num_channels > 0);
+  const int lobes = bank.lobes, taps = bank.taps;
+  const int64_t up = bank.up;
+  const int64_t step_base = bank.down / up, step_phase = bank.down % up;
+
+  SmallVector<float, (static_channels < 0 ? 16 : static_channels)> tmp;
+  tmp.resize(num_channels);
+
+  // the input position of the output sample is base + phase / up
+  int64_t base = out_begin * bank.down / up;
+  int64_t phase = out_begin * bank.down % up;
+  for (int64_t out_pos = out_begin; out_pos < out_end; out_pos++) {
+    const float *coeffs = bank.phase(phase);
+    int64_t i0 = base - lobes;
+    int j0 = i0 < 0 ? -i0 : 0;
+    int j1 = i0 + taps > n_in ? n_in - i0 : taps;
+    auto rel_pos = out_pos - out_begin;
+
+    if (num_channels == 1) {
+      const float *in_ptr = in + i0 + j0;
+      int n = j1 - j0, j = 0;
+      float f = n > 0 ? dot_vec(coeffs + j0, in_ptr, n, j) : 0;
+      for (; j < n; j++)
+        f += coeffs[j0 + j] * in_ptr[j];
+      out[rel_pos] = ConvertSatNorm<Out>(f);
+    } else {
+      for (int c = 0; c < num_channels; c++)
+        tmp[c] = 0;
+      for (int j = j0; j < j1; j++) {
+        float w = coeffs[j];
+        const float *in_ptr = in + (i0 + j) * num_channels;
+        for (int c = 0; c < num_channels; c++)
+          tmp[c] += in_ptr[c] * w;
+      }
+      for (int c = 0; c < num_channels; c++)
+        out[rel_pos * num_channels + c] = ConvertSatNorm<Out>(tmp[c]);
+    }
+
+    base += step_base;
+    phase += step_phase;
+    if (phase >= up) {
+      phase -= up;
+      base++;
+    }
+  }
+}
+
+template <typename Out>
+void ResamplePolyphaseCPUImpl(const PolyphaseFilterBank &bank, Out *__restrict__ out,
+                              int64_t out_begin, int64_t out_end, const float *__restrict__ in,
+                              int64_t n_in, int num_channels) {
+  VALUE_SWITCH(num_channels, static_channels, (1, 2, 3, 4, 5, 6, 7, 8),
+    (ResamplePolyphaseCPUImpl<static_channels, Out>(bank, out, out_begin, out_end,
+      in, n_in, static_channels);),
+    (ResamplePolyphaseCPUImpl<-1, Out>(bank, out, out_begin, out_end,
+      in, n_in, num_channels)));
+}
+
+const PolyphaseFilterBank &PolyphaseFilterBankCache::Get(const ResamplingWindow &window,
+                                                         int64_t up, int64_t down) {
+  std::lock_guard<std::mutex> guard(mtx_);
+  auto &bank = banks_[{up, down}];
+  if (!bank) {
+    bank = std::make_unique<PolyphaseFilterBank>();
+    polyphase_filter_bank(*bank, window, up, down);
+  }
+  return *bank;
+}
+
 #define DALI_INSTANTIATE_RESAMPLER_CPU_OUT(Out)                                             \
   template void ResampleCPUImpl(ResamplingWindow window, Out *__restrict__ out,             \
                                 int64_t out_begin, int64_t out_end, double out_rate,        \
                                 const float *__restrict__ in, int64_t n_in, double in_rate, \
-                                int num_channels);
+                                int num_channels);                                          \
+  template void ResamplePolyphaseCPUImpl(const PolyphaseFilterBank &bank,                   \
+                                         Out *__restrict__ out, int64_t out_begin,          \
+                                         int64_t out_end, const float *__restrict__ in,     \
+                                         int64_t n_in, int num_channels);
 
 #define DALI_INSTANTIATE_RESAMPLER_CPU()        \
   DALI_INSTANTIATE_RESAMPLER_CPU_OUT(float);    \
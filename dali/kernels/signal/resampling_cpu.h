@@ -15,6 +15,10 @@
 #ifndef DALI_KERNELS_SIGNAL_RESAMPLING_CPU_H_
 #define DALI_KERNELS_SIGNAL_RESAMPLING_CPU_H_
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
 #include "dali/kernels/signal/resampling.h"
 #include "dali/core/api_helper.h"
 
@@ -29,11 +33,58 @@ DLL_PUBLIC void ResampleCPUImpl(ResamplingWindow window, Out *__restrict__ out,
                                 int64_t out_end, double out_rate, const float *__restrict__ in,
                                 int64_t n_in, double in_rate, int num_channels);
 
+/**
+ * @brief Resample multi-channel (or single channel) signal with a polyphase filter bank
+ *        and convert to Out
+ *
+ * Equivalent to ResampleCPUImpl with the window and the rational ratio of the filter bank.
+ */
+template <typename Out>
+DLL_PUBLIC void ResamplePolyphaseCPUImpl(const PolyphaseFilterBank &bank, Out *__restrict__ out,
+                                         int64_t out_begin, int64_t out_end,
+                                         const float *__restrict__ in, int64_t n_in,
+                                         int num_channels);
+
+/**
+ * @brief The filter banks of the resampling ratios seen so far
+ *
+ * The banks are computed once per ratio and never evicted - there are few distinct sampling
+ * rates in practice. It's safe to use from multiple threads.
+ */
+class DLL_PUBLIC PolyphaseFilterBankCache {
+ public:
+  /**
+   * @brief Returns the filter bank of the ratio down / up, computing it, if needed
+   *
+   * The returned bank stays valid as long as the cache.
+   */
+  DLL_PUBLIC const PolyphaseFilterBank &Get(const ResamplingWindow &window, int64_t up,
+                                            int64_t down);
+
+ private:
+  std::mutex mtx_;
+  std::map<std::pair<int64_t, int64_t>, std::unique_ptr<PolyphaseFilterBank>> banks_;
+};
+
 struct DLL_PUBLIC ResamplerCPU {
   ResamplingWindowCPU window;
+  // shared by the copies of the resampler, which use the same window
+  std::shared_ptr<PolyphaseFilterBankCache> filter_banks;
 
   inline void Initialize(int lobes = 16, int lookup_size = 2048) {
     windowed_sinc(window, lookup_size, lobes);
+    filter_banks = std::make_shared<PolyphaseFilterBankCache>();
+  }
+
+  /**
+   * @brief Returns the filter bank for the ratio of the sampling rates or nullptr, if the ratio
+   *        is not a rational number with a small enough number of phases.
+   */
+  const PolyphaseFilterBank *GetFilterBank(double in_rate, double out_rate) {
+    int64_t up, down;
+    if (!filter_banks || !rational_ratio(in_rate, out_rate, up, down))
+      return nullptr;
+    return &filter_banks->Get(window, up, down);
   }
 
   /**
@@ -42,11 +93,16 @@ struct DLL_PUBLIC ResamplerCPU {
    * Calculates a range of resampled signal.
    * The function can resample a region-of-interest (ROI) of the output, specified by `out_begin` and
    * `out_end`. In this case, the output pointer points to the beginning of the ROI.
+   *
+   * The ratios of integer sampling rates (e.g. 44100 -> 16000) use a cached polyphase filter bank.
    */
   template <typename Out>
   void Resample(Out *__restrict__ out, int64_t out_begin, int64_t out_end, double out_rate,
                 const float *__restrict__ in, int64_t n_in, double in_rate, int num_channels) {
-    ResampleCPUImpl(window, out, out_begin, out_end, out_rate, in, n_in, in_rate, num_channels);
+    if (auto *bank = GetFilterBank(in_rate, out_rate))
+      ResamplePolyphaseCPUImpl(*bank, out, out_begin, out_end, in, n_in, num_channels);
+    else
+      ResampleCPUImpl(window, out, out_begin, out_end, out_rate, in, n_in, in_rate, num_channels);
   }
 };
 
@@ -13,8 +13,12 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <numeric>
+#include <random>
+#include <utility>
 #include "dali/kernels/signal/resampling_cpu.h"
 #include "dali/kernels/signal/resampling_test.h"
 
@@ -193,6 +197,59 @@ TEST_F(ResamplingCPUTest, ThreeChannelNeedHighPrecision) {
   this->RunTest();
 }
 
+/**
+ * @brief Evaluates the window at the exact input positions of the output samples
+ */
+void ReferenceResample(float *out, int64_t out_begin, int64_t out_end, double out_rate,
+                       const float *in, int64_t n_in, double in_rate, int nchannels,
+                       const ResamplingWindow &window) {
+  for (int64_t o = out_begin; o < out_end; o++) {
+    double pos = o * in_rate / out_rate;
+    int64_t xc = std::ceil(pos);
+    for (int c = 0; c < nchannels; c++) {
+      double acc = 0;
+      for (int64_t i = std::max<int64_t>(xc - window.lobes, 0);
+           i < std::min<int64_t>(xc + window.lobes, n_in); i++)
+        acc += in[i * nchannels + c] * window(i - pos);
+      out[(o - out_begin) * nchannels + c] = acc;
+    }
+  }
+}
+
+TEST(ResamplingPolyphaseCPUTest, ExactPositions) {
+  ResamplerCPU R;
+  R.Initialize(16);
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> dist(-1, 1);
+  std::pair<double, double> rates[] = {
+    {44100, 16000}, {16000, 44100}, {48000, 44100}, {22050, 22050}
+  };
+  for (auto &rate : rates) {
+    double in_rate = rate.first, out_rate = rate.second;
+    auto *bank = R.GetFilterBank(in_rate, out_rate);
+    ASSERT_NE(bank, nullptr);
+    EXPECT_EQ(bank, R.GetFilterBank(in_rate, out_rate)) << "The filter bank should be cached";
+    for (int nchannels : {1, 3, 30}) {
+      int64_t n_in = 5000;
+      std::vector<float> in(n_in * nchannels);
+      for (auto &x : in)
+        x = dist(rng);
+      int64_t n_out = resampled_length(n_in, in_rate, out_rate);
+      int64_t out_begin = 7, out_end = n_out - 3;
+      std::vector<float> ref((out_end - out_begin) * nchannels), out(ref.size());
+      ReferenceResample(ref.data(), out_begin, out_end, out_rate, in.data(), n_in, in_rate,
+                        nchannels, R.window);
+      R.Resample(out.data(), out_begin, out_end, out_rate, in.data(), n_in, in_rate, nchannels);
+      for (size_t i = 0; i < ref.size(); i++) {
+        ASSERT_NEAR(out[i], ref[i], 1e-5) << "@ " << i << " for " << in_rate << " -> "
+                                          << out_rate << " with " << nchannels << " channels";
+      }
+    }
+  }
+  EXPECT_EQ(R.GetFilterBank(44100.5, 16000), nullptr);
+  EXPECT_EQ(R.GetFilterBank(1000003, 1000033), nullptr);  // too many phases
+}
+
 }  // namespace test
 }  // namespace resampling
 }  // namespace signal
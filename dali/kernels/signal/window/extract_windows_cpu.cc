@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -100,6 +100,21 @@ void ExtractWindowsCpu<OutputType, InputType, Dims, vertical>::Run(
     const InTensorCPU<InputType, InputDims> &in,
     const InTensorCPU<float, 1> &window_fn,
     const ExtractWindowsArgs &args) {
+  RunWindows(context, out, in, window_fn, args, 0);
+}
+
+template <typename OutputType, typename InputType, int Dims, bool vertical>
+void ExtractWindowsCpu<OutputType, InputType, Dims, vertical>::RunWindows(
+    KernelContext &context,
+    const OutTensorCPU<OutputType, OutputDims> &out,
+    const InTensorCPU<InputType, InputDims> &in,
+    const InTensorCPU<float, 1> &window_fn,
+    const ExtractWindowsArgs &args,
+    int64_t first_window) {
+  int64_t nwindows = out.shape[vertical ? axis_ + 1 : axis_];
+  DALI_ENFORCE(first_window >= 0 && first_window + nwindows <= nwindows_,
+    make_string("The windows [", first_window, ", ", first_window + nwindows,
+                ") are out of range [0, ", nwindows_, ")"));
 
   auto in_shape = in.shape;
   auto in_strides = GetStrides(in_shape);
@@ -107,21 +122,21 @@ void ExtractWindowsCpu<OutputType, InputType, Dims, vertical>::Run(
   // flat_out_shape is the output shape with both window index and time dimensions combined into
   // one dimension
   auto flat_out_shape = in_shape;
-  flat_out_shape[axis_] = nwindows_ * window_length_;
+  flat_out_shape[axis_] = nwindows * window_length_;
   auto out_strides = GetStrides(flat_out_shape);
 
   ForAxis(
     out.data, in.data, flat_out_shape.data(), out_strides.data(),
     in_shape.data(), in_strides.data(), axis_, InputDims,
-    [this, &window_fn](
+    [this, &window_fn, first_window, nwindows](
       OutputType *out_data, const InputType *in_data,
       int64_t out_size, int64_t out_stride, int64_t in_size, int64_t in_stride) {
-        for (int64_t w = 0; w < nwindows_; w++) {
-          int64_t window_start = w * window_step_ - window_center_offset_;
+        for (int64_t w = 0; w < nwindows; w++) {
+          int64_t window_start = (first_window + w) * window_step_ - window_center_offset_;
           // Window needs special treatment (falls outside of the signal)
           if (window_start < 0 || window_start + window_length_ > in_size) {
             for (int t = 0; t < window_length_; t++) {
-              int64_t out_idx = vertical ? t * nwindows_ + w : w * window_length_ + t;
+              int64_t out_idx = vertical ? t * nwindows + w : w * window_length_ + t;
               int64_t in_idx = window_start + t;
               if (padding_ == Padding::Reflect) {
                 // find the mirrored position if the index is out of bounds
@@ -136,7 +151,7 @@ void ExtractWindowsCpu<OutputType, InputType, Dims, vertical>::Run(
             }
           } else {  // no special treatment for this window (just copy)
             for (int t = 0; t < window_length_; t++) {
-              int64_t out_idx = vertical ? t * nwindows_ + w : w * window_length_ + t;
+              int64_t out_idx = vertical ? t * nwindows + w : w * window_length_ + t;
               int64_t in_idx = window_start + t;
               out_data[out_idx * out_stride] = window_fn.data[t] * in_data[in_idx * in_stride];
             }
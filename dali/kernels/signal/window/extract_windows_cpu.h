@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -85,6 +85,20 @@ class DLL_PUBLIC ExtractWindowsCpu {
                       const InTensorCPU<float, 1> &window_fn,
                       const ExtractWindowsArgs &args);
 
+  /**
+   * @brief Extracts only the windows `[first_window, first_window + n)`, where `n` is the extent of
+   *        the window index dimension in `out`
+   *
+   * It allows the windows of a long signal to be processed in chunks, in parallel.
+   * The kernel must have been set up for the input.
+   */
+  DLL_PUBLIC void RunWindows(KernelContext &context,
+                      const OutTensorCPU<OutputType, OutputDims> &out,
+                      const InTensorCPU<InputType, InputDims> &in,
+                      const InTensorCPU<float, 1> &window_fn,
+                      const ExtractWindowsArgs &args,
+                      int64_t first_window);
+
  private:
   int window_length_ = -1;
   int window_step_ = -1;
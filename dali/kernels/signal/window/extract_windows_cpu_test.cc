@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <tuple>
 #include <vector>
 #include <complex>
@@ -176,6 +177,28 @@ void ExtractWindowsCpuTest::RunTest() {
     ASSERT_EQ(expected_out[idx], out_view.data[idx]) <<
       "Output data doesn't match reference (idx=" << idx << ")";
   }
+
+  // extracting the windows in chunks
+  for (int64_t first = 0; first < nwindows; first += 2) {
+    int64_t count = std::min<int64_t>(2, nwindows - first);
+    auto chunk_shape = out_shape.to_static<OutputDims>();
+    chunk_shape[vertical ? axis_ + 1 : axis_] = count;
+    std::vector<OutputType> chunk(volume(chunk_shape));
+    auto chunk_view = OutTensorCPU<OutputType, OutputDims>(chunk.data(), chunk_shape);
+    kernel.RunWindows(ctx, chunk_view, in_view_, window_fn_view, args, first);
+    for (int i = 0; i < in_view_.shape[0]; i++) {
+      for (int w = 0; w < count; w++) {
+        for (int t = 0; t < window_length_; t++) {
+          auto chunk_k = vertical ? w + t * count : w * window_length_ + t;
+          auto out_k = vertical ? first + w + t * nwindows : (first + w) * window_length_ + t;
+          ASSERT_EQ(expected_out[i * out_strides[0] + out_k],
+                    chunk[i * count * window_length_ + chunk_k])
+            << "Chunk data doesn't match reference (first=" << first << ", w=" << w
+            << ", t=" << t << ")";
+        }
+      }
+    }
+  }
 }
 
 TEST_P(ExtractWindowsCpuTest, Vertical) {
@@ -16,17 +16,21 @@
 #define DALI_KERNELS_SLICE_SLICE_GPU_H_
 
 #include <cuda_runtime.h>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include "dali/core/common.h"
 #include "dali/core/convert.h"
 #include "dali/core/cuda_error.h"
+#include "dali/core/cuda_utils.h"
 #include "dali/core/dev_array.h"
 #include "dali/core/error_handling.h"
 #include "dali/core/fast_div.h"
 #include "dali/core/static_switch.h"
 #include "dali/core/util.h"
+#include "dali/kernels/common/cooperative_copy.cuh"
 #include "dali/kernels/common/copy.h"
+#include "dali/kernels/common/flat_batch.h"
 #include "dali/kernels/common/type_erasure.h"
 #include "dali/kernels/kernel.h"
 #include "dali/kernels/slice/slice_kernel_utils.h"
@@ -65,12 +69,8 @@ struct SliceSampleDesc {
 
   fast_div<uint64_t> out_strides[Dims];
   TensorShape<Dims> in_strides;
-};
 
-struct SliceBlockDesc {
-  int sampleIdx;
-  uint64_t offset;
-  uint64_t size;
+  uint64_t size;  // output volume
 };
 
 template<typename T>
@@ -96,6 +96,47 @@ union PackedBuffer {
   }
 };
 
+/**
+ * @brief The shortest contiguous run of elements, in bytes, copied with vectorized accesses
+ */
+constexpr uint64_t kMinVectorizedRunBytes = 256;
+
+/**
+ * @brief Copies the range [start, end) of the output elements, which are contiguous in both
+ *        the input and the output in runs of `run_length` elements
+ *
+ * The runs long enough to keep the whole block busy are copied by all its threads, one by one;
+ * the shorter ones are distributed among the warps.
+ * @remarks `in` already refers to the slice anchor start
+ */
+template <int Dims, typename T>
+__device__ void SliceRunsNoPad(T *__restrict__ out, const T *__restrict__ in,
+                               const fast_div<uint64_t> *out_strides, const int64_t *in_strides,
+                               uint64_t run_length, uint64_t start, uint64_t end) {
+  unsigned group_size = run_length * sizeof(T) >= blockDim.x * sizeof(uint4)
+                      ? blockDim.x : warpSize;
+  unsigned lane = threadIdx.x % group_size;
+  unsigned group = threadIdx.x / group_size;
+  unsigned num_groups = blockDim.x / group_size;
+  // the first run can be partial
+  uint64_t first_end = start + run_length - start % run_length;
+  for (uint64_t run = group; ; run += num_groups) {
+    uint64_t run_start = run == 0 ? start : first_end + (run - 1) * run_length;
+    if (run_start >= end)
+      break;
+    uint64_t idx = run_start;
+    uint64_t in_idx = 0;
+    #pragma unroll
+    for (int d = 0; d < Dims; d++) {
+      int i_d = div_mod(idx, idx, out_strides[d]);
+      in_idx += i_d * in_strides[d];
+    }
+    in_idx += idx;  // remaining dims have equal strides
+    uint64_t n = cuda_min(run_length - run_start % run_length, end - run_start);
+    CooperativeCopy(out + run_start, in + in_idx, n * sizeof(T), lane, group_size);
+  }
+}
+
 /**
  * @brief Simplified algorithm when no padding is necessary
  * @remarks `in` already refers to the slice anchor start
@@ -111,6 +152,20 @@ __device__ void SliceFuncNoPad(OutputType *__restrict__ out, const InputType *__
     return;
   }
 
+  if (std::is_same<OutputType, InputType>::value) {
+    // The elements are contiguous in both the input and the output in runs of the length of
+    // the innermost stride - or all of them, if the outermost dimension isn't sliced either
+    uint64_t run_length = out_strides[Dims - 1];
+    if (Dims == 1 && run_length == static_cast<uint64_t>(in_strides[0]))
+      run_length = block_end;
+    if (run_length * sizeof(OutputType) >= kMinVectorizedRunBytes) {
+      uint64_t block_start = offset - threadIdx.x * PackedBuffer<OutputType>::kCapacity;
+      SliceRunsNoPad<Dims>(out, reinterpret_cast<const OutputType *>(in), out_strides, in_strides,
+                           run_length, block_start, block_end);
+      return;
+    }
+  }
+
   for (; offset < block_end; offset += blockDim.x * PackedBuffer<OutputType>::kCapacity) {
     PackedBuffer<OutputType> result;
 
@@ -206,12 +261,21 @@ __device__ void SliceFunc(OutputType *__restrict__ out, const InputType *__restr
   }
 }
 
+/**
+ * @brief Slices a batch; each CUDA block processes `block_size` consecutive output elements
+ *        of one sample
+ *
+ * The block decomposition is not stored - the sample processed by a block is found in
+ * `first_block`, the prefix sum of the number of blocks of each sample (nsamples + 1 entries).
+ */
 template <typename OutputType, typename InputType, int Dims, bool SupportPad>
-__global__ void SliceKernel(const SliceSampleDesc<Dims> *samples, const SliceBlockDesc *blocks) {
-  int sampleIdx = blocks[blockIdx.x].sampleIdx;
-  uint64_t offset = blocks[blockIdx.x].offset + threadIdx.x * PackedBuffer<OutputType>::kCapacity;
-  uint64_t block_end = blocks[blockIdx.x].offset + blocks[blockIdx.x].size;
+__global__ void SliceKernel(const SliceSampleDesc<Dims> *samples, const int64_t *first_block,
+                            int nsamples, uint64_t block_size) {
+  int sampleIdx = FlatSampleIdx(first_block, nsamples, blockIdx.x);
   auto sample = samples[sampleIdx];
+  uint64_t block_start = (blockIdx.x - first_block[sampleIdx]) * block_size;
+  uint64_t block_end = cuda_min(block_start + block_size, sample.size);
+  uint64_t offset = block_start + threadIdx.x * PackedBuffer<OutputType>::kCapacity;
   auto *out = static_cast<OutputType*>(sample.out);
   auto *in = static_cast<const InputType*>(sample.in);
   auto *out_strides = sample.out_strides;
@@ -304,8 +368,8 @@ class SliceGPU {
       block_count_ += div_ceil(sample_size, block_size_);
     }
 
-    se.add<mm::memory_kind::pinned, detail::SliceBlockDesc>(block_count_);
-    se.add<mm::memory_kind::device, detail::SliceBlockDesc>(block_count_);
+    se.add<mm::memory_kind::pinned, int64_t>(num_samples + 1);
+    se.add<mm::memory_kind::device, int64_t>(num_samples + 1);
     req.scratch_sizes = se.sizes;
 
     req.output_shapes = { GetOutputShapes<Dims>(in.shape, slice_args) };
@@ -339,11 +403,10 @@ class SliceGPU {
     // Host memory
     detail::SliceSampleDesc<Dims> *sample_descs_cpu =
         context.scratchpad->AllocatePinned<detail::SliceSampleDesc<Dims>>(num_samples);
-    detail::SliceBlockDesc *block_descs_cpu =
-        context.scratchpad->AllocatePinned<detail::SliceBlockDesc>(block_count_);
+    int64_t *first_block_cpu = context.scratchpad->AllocatePinned<int64_t>(num_samples + 1);
 
     bool any_padded_sample = false;
-    std::vector<int64_t> sample_sizes(in.size());
+    first_block_cpu[0] = 0;
     for (int i = 0; i < in.size(); i++) {
       const auto in_shape = in.tensor_shape(i);
       const auto out_shape = out.tensor_shape(i);
@@ -362,7 +425,8 @@ class SliceGPU {
 
       sample_desc.out = out.tensor_data(i);
       sample_desc.in = in_data;
-      sample_sizes[i] = volume(out_shape);
+      sample_desc.size = volume(out_shape);
+      first_block_cpu[i + 1] = first_block_cpu[i] + div_ceil(sample_desc.size, block_size_);
 
       // fill values points to gpu memory
       sample_desc.fill_values = fill_values_gpu + i * nfill_values_;
@@ -371,30 +435,21 @@ class SliceGPU {
       any_padded_sample |= sample_desc.need_pad;
     }
 
-    int64_t block_idx = 0;
-    for (int i = 0; i < num_samples; i++) {
-      uint64_t offset = 0;
-      uint64_t remaining = sample_sizes[i];
-      while (remaining > 0) {
-        uint64_t size = remaining < block_size_ ? remaining : block_size_;
-        block_descs_cpu[block_idx++] = {i, offset, size};
-        remaining -= size;
-        offset += size;
-      }
-    }
+    assert(static_cast<uint64_t>(first_block_cpu[num_samples]) == block_count_);
 
     detail::SliceSampleDesc<Dims> *sample_descs;
-    detail::SliceBlockDesc *block_descs;
-    std::tie(sample_descs, block_descs) =
+    int64_t *first_block;
+    std::tie(sample_descs, first_block) =
         context.scratchpad->ToContiguousGPU(context.gpu.stream,
                                             make_cspan(sample_descs_cpu, num_samples),
-                                            make_cspan(block_descs_cpu, block_count_));
+                                            make_cspan(first_block_cpu, num_samples + 1));
     CUDA_CALL(cudaGetLastError());
 
     const auto grid = block_count_;
     BOOL_SWITCH(any_padded_sample, NeedPad, (
       detail::SliceKernel<OutputType, InputType, Dims, NeedPad>
-        <<<grid, kBlockDim, 0, context.gpu.stream>>>(sample_descs, block_descs);
+        <<<grid, kBlockDim, 0, context.gpu.stream>>>(sample_descs, first_block, num_samples,
+                                                     block_size_);
     ));  // NOLINT
     CUDA_CALL(cudaGetLastError());
   }
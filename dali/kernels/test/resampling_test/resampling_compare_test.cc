@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -87,13 +87,31 @@ ResamplingTestBatch CropBatch = {
   },
 };
 
+// large downscaling factors, with wide filter windows
+ResamplingTestBatch DownscaleBatch = {
+  {
+    "imgproc/alley.png", "",
+    { 96, 60 }, tri(), 1
+  },
+  {
+    "imgproc/alley.png", "",
+    { 40, 100 }, lanczos(), 1
+  },
+  {
+    "imgproc/score.png", "",
+    { 50, 30 }, cubic(), 1
+  }
+};
+
 }  // namespace
 
 class ResamplingCompareTest : public ::testing::Test,
                             public ::testing::WithParamInterface<ResamplingTestBatch> {
+ protected:
+  void RunCompare(bool half_precision_compute = false);
 };
 
-TEST_P(ResamplingCompareTest, ResamplingKernelAPI) {
+void ResamplingCompareTest::RunCompare(bool half_precision_compute) {
   const ResamplingTestBatch &batch = GetParam();
 
   int N = batch.size();
@@ -109,7 +127,7 @@ TEST_P(ResamplingCompareTest, ResamplingKernelAPI) {
   KernelContext ctx_gpu, ctx_cpu;
   ctx_gpu.gpu.stream = 0;
   ctx_cpu.gpu.stream = 0;
-  ResampleGPU<uint8_t, uint8_t> kernel_gpu;
+  ResampleGPU<uint8_t, uint8_t> kernel_gpu(false, half_precision_compute);
   ResampleCPU<uint8_t, uint8_t> kernel_cpu;
   TestTensorList<uint8_t, 3> input, output_gpu, output_cpu;
 
@@ -186,7 +204,10 @@ TEST_P(ResamplingCompareTest, ResamplingKernelAPI) {
   for (int i = 0; i < N; i++) {
     auto out_tensor_gpu = output_gpu.cpu()[i];
     auto out_tensor_cpu = output_cpu.cpu()[i];
-    ASSERT_NO_FATAL_FAILURE(Check(out_tensor_gpu, out_tensor_cpu, EqualEps(batch[i].epsilon)))
+    // the input pixels are exact in half precision, but the intermediate values and
+    // the filter coefficients are rounded to 11 significant bits
+    double eps = batch[i].epsilon + (half_precision_compute ? 1 : 0);
+    ASSERT_NO_FATAL_FAILURE(Check(out_tensor_gpu, out_tensor_cpu, EqualEps(eps)))
     << [&]() {
       cv::Mat tmp1(out_tensor_cpu.shape[0], out_tensor_cpu.shape[1], CV_8UC3, out_tensor_cpu.data);
       cv::Mat tmp2(out_tensor_gpu.shape[0], out_tensor_gpu.shape[1], CV_8UC3, out_tensor_gpu.data);
@@ -209,10 +230,19 @@ TEST_P(ResamplingCompareTest, ResamplingKernelAPI) {
   }
 }
 
+TEST_P(ResamplingCompareTest, ResamplingKernelAPI) {
+  RunCompare();
+}
+
+TEST_P(ResamplingCompareTest, HalfPrecisionCompute) {
+  RunCompare(true);
+}
+
 INSTANTIATE_TEST_SUITE_P(SingleImage, ResamplingCompareTest, ::testing::Values(SingleImageBatch));
 INSTANTIATE_TEST_SUITE_P(MultipleImages, ResamplingCompareTest, ::testing::Values(Batch1));
 
 INSTANTIATE_TEST_SUITE_P(Crop, ResamplingCompareTest, ::testing::Values(CropBatch));
+INSTANTIATE_TEST_SUITE_P(Downscale, ResamplingCompareTest, ::testing::Values(DownscaleBatch));
 
 }  // namespace resample_test
 }  // namespace kernels
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <random>
+#include <vector>
 #include <opencv2/imgcodecs.hpp>
 #include "dali/kernels/test/test_data.h"
 #include "dali/test/tensor_test_utils.h"
@@ -156,6 +158,43 @@ TEST(ResampleCPU, Vertical) {
   Check(out_tensor, ref_tensor, EqualEps(1));
 }
 
+template <typename In>
+class ResampleVertAccumulateTest : public ::testing::Test {};
+
+using ResampleVertAccumulateTypes = ::testing::Types<uint8_t, int8_t, uint16_t, int16_t,
+                                                     int32_t, float>;
+TYPED_TEST_SUITE(ResampleVertAccumulateTest, ResampleVertAccumulateTypes);
+
+TYPED_TEST(ResampleVertAccumulateTest, AllInstructionSets) {
+  using In = TypeParam;
+  const int support = 5, w = 333, offset = 7, n = w - offset;
+  std::mt19937_64 rng(1234);
+  std::uniform_int_distribution<int> dist(std::is_signed<In>::value ? -100 : 0, 100);
+  std::vector<std::vector<In>> rows(support, std::vector<In>(w));
+  std::vector<const In *> row_ptrs(support);
+  std::vector<float> kernel(support);
+  for (int k = 0; k < support; k++) {
+    for (auto &v : rows[k])
+      v = dist(rng);
+    row_ptrs[k] = rows[k].data();
+    kernel[k] = 0.1f * (k + 1);
+  }
+
+  std::vector<float> ref(n);
+  for (int i = 0; i < n; i++)
+    for (int k = 0; k < support; k++)
+      ref[i] += rows[k][offset + i] * kernel[k];
+
+  for (auto isa : { simd::CpuIsa::Generic, simd::CpuIsa::AVX2, simd::CpuIsa::AVX512 }) {
+    if (isa > simd::GetCpuIsa())
+      break;
+    std::vector<float> out(n, -1);
+    ResampleVertAccumulate(out.data(), row_ptrs.data(), offset, n, kernel.data(), support, isa);
+    for (int i = 0; i < n; i++)
+      ASSERT_NEAR(out[i], ref[i], 1e-3f) << " at " << i << " isa " << static_cast<int>(isa);
+  }
+}
+
 TEST(ResampleCPU, NN) {
   auto img = testing::data::image("imgproc/blobs.png");
   auto ref = testing::data::image("imgproc/dots.png");
@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
+#include <algorithm>
 #include <random>
 #include <string>
 #include <vector>
@@ -400,10 +401,10 @@ class Resample3DTest<ResamplingTestParams<Out, In, interp>>
     return true;
   }
 
-  void RunGPU() {
+  void RunGPU(bool half_precision_intermediate = false) {
     cudaStream_t stream = 0;
 
-    ResampleGPU<Out, In, 3> kernel;
+    ResampleGPU<Out, In, 3> kernel(half_precision_intermediate);
     KernelContext ctx;
     ctx.gpu.stream = stream;
     ScratchpadAllocator sa;
@@ -447,7 +448,13 @@ class Resample3DTest<ResamplingTestParams<Out, In, interp>>
         // Epsilons are quite big because, processing order in the reference is forced to be XYZ
         // or YXZ, whereas the tested implementation can use any order.
         double eps = std::is_integral<Out>::value ? 1 : 1e-3;
-        Check(out_cpu, ref_cpu, EqualEpsRel(eps, 1e-4));
+        double rel = 1e-4;
+        if (half_precision_intermediate) {
+          // the intermediate values are rounded to 11 significant bits
+          eps = std::max(eps, std::is_integral<In>::value ? max_value<In>()*4e-3 : 1e-2);
+          rel = 1e-2;
+        }
+        Check(out_cpu, ref_cpu, EqualEpsRel(eps, rel));
       }
     }
   }
@@ -532,6 +539,10 @@ TYPED_TEST(Resample3DTest, TestGPU) {
   this->RunGPU();
 }
 
+TYPED_TEST(Resample3DTest, TestGPUHalfPrecisionIntermediate) {
+  this->RunGPU(true);
+}
+
 TYPED_TEST(Resample3DTest, TestCPU) {
   this->RunCPU();
 }
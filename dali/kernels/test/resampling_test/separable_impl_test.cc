@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -125,6 +125,31 @@ TEST(SeparableImpl, Setup3D) {
   TestSetup<3>();
 }
 
+TEST(SeparableImpl, SetupCache) {
+  int N = 8;
+  KernelContext ctx;
+  ctx.gpu.stream = 0;
+  SeparableResamplingGPUImpl<uint8_t, uint8_t, 2> resampling;
+  TestTensorList<uint8_t, 3> input;
+
+  TensorListShape<3> tls;
+  std::vector<ResamplingParams2D> params;
+  RandomParams<2>(tls, params, N);
+  input.reshape(tls);
+  auto in_tv = input.gpu();
+
+  auto req1 = resampling.Setup(ctx, in_tv, make_span(params));
+  int64_t version = resampling.setup.version;
+  auto req2 = resampling.Setup(ctx, in_tv, make_span(params));
+  EXPECT_EQ(resampling.setup.version, version) << "Same shapes and parameters - expected reuse";
+  EXPECT_EQ(req1.output_shapes[0], req2.output_shapes[0]);
+
+  params[N/2][0].output_size++;
+  auto req3 = resampling.Setup(ctx, in_tv, make_span(params));
+  EXPECT_GT(resampling.setup.version, version) << "Parameters changed - expected a new setup";
+  EXPECT_EQ(req3.output_shapes[0][N/2][0], params[N/2][0].output_size);
+}
+
 ResamplingTestBatch SingleImageBatch = {
   {
     "imgproc/alley.png", "imgproc/ref/resampling/alley_tri_300x300.png",
@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,12 +15,19 @@
 #ifndef DALI_KERNELS_TRANSPOSE_TRANSPOSE_H_
 #define DALI_KERNELS_TRANSPOSE_TRANSPOSE_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
 #include <utility>
 #include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "dali/core/static_switch.h"
 #include "dali/core/tensor_view.h"
+#include "dali/kernels/common/split_shape.h"
 #include "dali/kernels/common/utils.h"
 #include "dali/kernels/transpose/transpose_util.h"
 
@@ -50,14 +57,196 @@ std::enable_if_t<LevelsLeft == 1> TransposeImplStatic(T *dst, const T *src, int
   }
 }
 
+#ifdef __SSE2__
+
+/**
+ * @brief Size of the square tile transposed with SIMD, in elements of given size; 0 if there's
+ *        no SIMD implementation for this element size.
+ */
+template <int element_size>
+constexpr int SimdTileSize() {
+  return element_size == 1 || element_size == 2 ? 8 : element_size == 4 ? 4 : 0;
+}
+
+/**
+ * @brief Transposes an 8x8 tile of bytes: dst[i * dst_stride + j] = src[j * src_stride + i]
+ *
+ * The strides are in bytes.
+ */
+inline void TransposeTileSimd(std::integral_constant<int, 1>, void *dst, const void *src,
+                              int64_t dst_stride, int64_t src_stride) {
+  auto *in = static_cast<const char *>(src);
+  auto *out = static_cast<char *>(dst);
+  __m128i r[8];
+  for (int k = 0; k < 8; k++)
+    r[k] = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + k * src_stride));
+  __m128i a0 = _mm_unpacklo_epi8(r[0], r[1]);
+  __m128i a1 = _mm_unpacklo_epi8(r[2], r[3]);
+  __m128i a2 = _mm_unpacklo_epi8(r[4], r[5]);
+  __m128i a3 = _mm_unpacklo_epi8(r[6], r[7]);
+  __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+  __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+  __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+  __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+  // each of the vectors contains two output rows
+  __m128i c[4] = {
+    _mm_unpacklo_epi32(b0, b2), _mm_unpackhi_epi32(b0, b2),
+    _mm_unpacklo_epi32(b1, b3), _mm_unpackhi_epi32(b1, b3)
+  };
+  for (int k = 0; k < 4; k++) {
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out + (2 * k) * dst_stride), c[k]);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out + (2 * k + 1) * dst_stride),
+                     _mm_srli_si128(c[k], 8));
+  }
+}
+
+/**
+ * @brief Transposes an 8x8 tile of 16-bit elements
+ *
+ * The strides are in bytes.
+ */
+inline void TransposeTileSimd(std::integral_constant<int, 2>, void *dst, const void *src,
+                              int64_t dst_stride, int64_t src_stride) {
+  auto *in = static_cast<const char *>(src);
+  auto *out = static_cast<char *>(dst);
+  __m128i r[8];
+  for (int k = 0; k < 8; k++)
+    r[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + k * src_stride));
+  __m128i a[8], b[8];
+  for (int k = 0; k < 4; k++) {
+    a[2 * k]     = _mm_unpacklo_epi16(r[2 * k], r[2 * k + 1]);
+    a[2 * k + 1] = _mm_unpackhi_epi16(r[2 * k], r[2 * k + 1]);
+  }
+  for (int k = 0; k < 2; k++) {
+    b[4 * k]     = _mm_unpacklo_epi32(a[4 * k],     a[4 * k + 2]);
+    b[4 * k + 1] = _mm_unpackhi_epi32(a[4 * k],     a[4 * k + 2]);
+    b[4 * k + 2] = _mm_unpacklo_epi32(a[4 * k + 1], a[4 * k + 3]);
+    b[4 * k + 3] = _mm_unpackhi_epi32(a[4 * k + 1], a[4 * k + 3]);
+  }
+  for (int k = 0; k < 4; k++) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + (2 * k) * dst_stride),
+                     _mm_unpacklo_epi64(b[k], b[k + 4]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + (2 * k + 1) * dst_stride),
+                     _mm_unpackhi_epi64(b[k], b[k + 4]));
+  }
+}
+
+/**
+ * @brief Transposes a 4x4 tile of 32-bit elements
+ *
+ * The elements are only moved, so the floating point shuffles are used for any 32-bit type.
+ * The strides are in bytes.
+ */
+inline void TransposeTileSimd(std::integral_constant<int, 4>, void *dst, const void *src,
+                              int64_t dst_stride, int64_t src_stride) {
+  auto *in = static_cast<const char *>(src);
+  auto *out = static_cast<char *>(dst);
+  __m128 r0 = _mm_loadu_ps(reinterpret_cast<const float *>(in));
+  __m128 r1 = _mm_loadu_ps(reinterpret_cast<const float *>(in + src_stride));
+  __m128 r2 = _mm_loadu_ps(reinterpret_cast<const float *>(in + 2 * src_stride));
+  __m128 r3 = _mm_loadu_ps(reinterpret_cast<const float *>(in + 3 * src_stride));
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  _mm_storeu_ps(reinterpret_cast<float *>(out), r0);
+  _mm_storeu_ps(reinterpret_cast<float *>(out + dst_stride), r1);
+  _mm_storeu_ps(reinterpret_cast<float *>(out + 2 * dst_stride), r2);
+  _mm_storeu_ps(reinterpret_cast<float *>(out + 3 * dst_stride), r3);
+}
+
+#endif  // __SSE2__
+
+/**
+ * @brief Transposes a block which fits in the cache:
+ *        dst[i * dst_stride + j] = src[j * src_stride + i]
+ */
+template <typename T>
+void TransposeBlock(T *dst, const T *src, int64_t rows, int64_t cols,
+                    int64_t dst_stride, int64_t src_stride) {
+  int64_t i = 0;
+#ifdef __SSE2__
+  constexpr int tile = SimdTileSize<sizeof(T)>();
+  if constexpr (tile > 0) {
+    std::integral_constant<int, sizeof(T)> element_size;
+    for (; cols >= tile && i + tile <= rows; i += tile) {
+      int64_t j = 0;
+      for (; j + tile <= cols; j += tile)
+        TransposeTileSimd(element_size, dst + i * dst_stride + j, src + j * src_stride + i,
+                          dst_stride * sizeof(T), src_stride * sizeof(T));
+      for (int64_t ti = i; ti < i + tile; ti++) {
+        for (int64_t tj = j; tj < cols; tj++)
+          dst[ti * dst_stride + tj] = src[tj * src_stride + ti];
+      }
+    }
+  }
+#endif
+  for (; i < rows; i++) {
+    for (int64_t j = 0; j < cols; j++)
+      dst[i * dst_stride + j] = src[j * src_stride + i];
+  }
+}
+
+/**
+ * @brief Transposes a 2D matrix: dst[i * dst_stride + j] = src[j * src_stride + i]
+ *
+ * The matrix is processed in blocks, so that both the rows of the source and of the
+ * destination, that are touched by one block, stay in the cache. The blocks are square,
+ * unless one of the dimensions is small - then they are elongated to keep the inner loops long.
+ */
+template <typename T>
+void Transpose2D(T *dst, const T *src, int64_t rows, int64_t cols,
+                 int64_t dst_stride, int64_t src_stride) {
+  constexpr int64_t kBlock = sizeof(T) <= 2 ? 64 : 32;
+  constexpr int64_t kBlockArea = kBlock * kBlock;
+  int64_t max_block_rows = cols < kBlock ? kBlockArea / cols : kBlock;
+  int64_t max_block_cols = rows < kBlock ? kBlockArea / rows : kBlock;
+  for (int64_t i0 = 0; i0 < rows; i0 += max_block_rows) {
+    int64_t block_rows = std::min(max_block_rows, rows - i0);
+    for (int64_t j0 = 0; j0 < cols; j0 += max_block_cols) {
+      int64_t block_cols = std::min(max_block_cols, cols - j0);
+      TransposeBlock(dst + i0 * dst_stride + j0, src + j0 * src_stride + i0,
+                     block_rows, block_cols, dst_stride, src_stride);
+    }
+  }
+}
+
 /**
  * @brief Transpose recursion that should allow to inline innermost loops.
+ *        The case of two innermost levels.
+ *
+ * When the two levels form a 2D transposition (the innermost source dimension goes to
+ * the outer of the two levels), it's done in cache-friendly blocks.
  *
- * @tparam LevelsLeft how many levels of recursion are left, here grater than 1
+ * @tparam LevelsLeft how many levels of recursion are left, here equal to 2
  * @tparam MaxLevels statically known number of dimensions or -1 otherwise
  */
 template <int LevelsLeft, int MaxLevels = -1, typename T>
-std::enable_if_t<(LevelsLeft > 1)> TransposeImplStatic(T *dst, const T *src, int max_levels,
+std::enable_if_t<LevelsLeft == 2> TransposeImplStatic(T *dst, const T *src, int max_levels,
+                                                      span<const int64_t> dst_stride,
+                                                      span<const int64_t> src_stride,
+                                                      TensorShape<> size, span<const int> perm) {
+  const auto level = MaxLevels >= 0 ? (MaxLevels - LevelsLeft) : max_levels - LevelsLeft;
+  auto dst_level_stride = dst_stride[level];
+  auto src_level_stride = src_stride[perm[level]];
+  if (src_level_stride == 1 && dst_stride[level + 1] == 1) {
+    Transpose2D(dst, src, size[level], size[level + 1],
+                dst_level_stride, src_stride[perm[level + 1]]);
+    return;
+  }
+  for (int64_t i = 0; i < size[level]; i++) {
+    TransposeImplStatic<LevelsLeft - 1, MaxLevels>(dst, src, max_levels, dst_stride, src_stride,
+                                                      size, perm);
+    dst += dst_level_stride;
+    src += src_level_stride;
+  }
+}
+
+/**
+ * @brief Transpose recursion that should allow to inline innermost loops.
+ *
+ * @tparam LevelsLeft how many levels of recursion are left, here grater than 2
+ * @tparam MaxLevels statically known number of dimensions or -1 otherwise
+ */
+template <int LevelsLeft, int MaxLevels = -1, typename T>
+std::enable_if_t<(LevelsLeft > 2)> TransposeImplStatic(T *dst, const T *src, int max_levels,
                                                        span<const int64_t> dst_stride,
                                                        span<const int64_t> src_stride,
                                                        TensorShape<> size, span<const int> perm) {
@@ -111,8 +300,28 @@ void TransposeImpl(T *dst, const T *src, int level, int max_levels, span<const i
   }
 }
 
+/**
+ * @brief Transposes a (sub)tensor of dst-ordered shape `size`, for given strides of the tensors
+ */
+template <typename T>
+void TransposeStrided(T *dst, const T *src, span<const int64_t> dst_stride,
+                      span<const int64_t> src_stride, const TensorShape<> &size,
+                      span<const int> perm) {
+  int N = size.sample_dim();
+  VALUE_SWITCH(N, static_dims, (1, 2, 3), (
+    TransposeImplStatic<static_dims, static_dims>(
+        dst, src, static_dims, dst_stride, src_stride, size, perm);),
+  (
+    TransposeImpl(dst, src, 0, N, dst_stride, src_stride, size, perm);));
+}
+
 }  // namespace transpose_impl
 
+/**
+ * @brief The minimum number of elements transposed in one task
+ */
+static constexpr int kTransposeMinBlockSize = 16 << 10;
+
 /**
  * @brief Transpose `src` Tensor to `dst` wrt to permutation `perm`
  *
@@ -130,13 +339,8 @@ void Transpose(const TensorView<StorageCPU, T> &dst, const TensorView<StorageCPU
   assert(volume(src.shape) == volume(dst.shape));
   auto dst_strides = GetStrides(dst.shape);
   auto src_strides = GetStrides(src.shape);
-  VALUE_SWITCH(N, static_dims, (1, 2, 3), (
-    transpose_impl::TransposeImplStatic<static_dims, static_dims>(
-        dst.data, src.data,
-        static_dims, make_span(dst_strides), make_span(src_strides), dst.shape, perm);),
-  (
-    transpose_impl::TransposeImpl(dst.data, src.data, 0, N,
-        make_span(dst_strides), make_span(src_strides), dst.shape, perm);));
+  transpose_impl::TransposeStrided(dst.data, src.data, make_cspan(dst_strides),
+                                   make_cspan(src_strides), dst.shape, perm);
 }
 
 /**
@@ -163,6 +367,48 @@ void TransposeGrouped(const TensorView<StorageCPU, T> &dst,
             make_cspan(collapsed_perm));
 }
 
+/**
+ * @brief Schedules the transposition of `src` to `dst` wrt to permutation `perm` in
+ *        the execution engine
+ *
+ * Same as TransposeGrouped, but the output is divided into blocks, which are transposed in
+ * separate tasks, so that a large tensor can be processed by multiple threads.
+ * The work is not started - it's up to the caller to run the engine.
+ *
+ * @param min_blk_sz minimum number of elements in a block
+ * @param req_nblocks desired minimum number of blocks; by default, 8 per thread
+ */
+template <typename T, typename ExecutionEngine>
+void TransposeGrouped(ExecutionEngine &engine, const TensorView<StorageCPU, T> &dst,
+                      const TensorView<StorageCPU, const T> &src, span<const int> perm,
+                      int min_blk_sz = kTransposeMinBlockSize, int req_nblocks = -1) {
+  if (req_nblocks < 0)
+    req_nblocks = engine.NumThreads() * 8;
+  TensorShape<> collapsed_src_shape;
+  SmallVector<int, DynamicTensorShapeContainer::static_size> collapsed_perm;
+  transpose_impl::SimplifyPermute(collapsed_src_shape, collapsed_perm, src.shape, perm);
+  TensorShape<> collapsed_dst_shape = permute(collapsed_src_shape, collapsed_perm);
+  if (collapsed_dst_shape.sample_dim() == 0) {  // it's a scalar - just copy it
+    engine.AddWork([dst, src](int) { *dst.data = *src.data; }, 1, false);
+    return;
+  }
+  auto dst_strides = GetStrides(collapsed_dst_shape);
+  auto src_strides = GetStrides(collapsed_src_shape);
+  ScheduleBlocks(engine, collapsed_dst_shape, req_nblocks, min_blk_sz, 0,
+    [=](const TensorShape<> &start, const TensorShape<> &end) {
+      T *dst_ptr = dst.data;
+      const T *src_ptr = src.data;
+      TensorShape<> size = end;
+      for (int d = 0; d < size.sample_dim(); d++) {
+        dst_ptr += start[d] * dst_strides[d];
+        src_ptr += start[d] * src_strides[collapsed_perm[d]];
+        size[d] -= start[d];
+      }
+      transpose_impl::TransposeStrided(dst_ptr, src_ptr, make_cspan(dst_strides),
+                                       make_cspan(src_strides), size, make_cspan(collapsed_perm));
+    });
+}
+
 }  // namespace kernels
 }  // namespace dali
 
@@ -0,0 +1,88 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include "dali/core/exec/engine.h"
+#include "dali/core/tensor_shape_print.h"
+#include "dali/kernels/transpose/transpose.h"
+#include "dali/kernels/transpose/transpose_test.h"
+#include "dali/pipeline/util/thread_pool.h"
+
+namespace dali {
+namespace kernels {
+
+template <typename ExecutionEngine>
+void TestBlockedTranspose(ExecutionEngine &engine) {
+  TensorShape<> in_shape = { 19, 7, 11, 5 };
+  int64_t n = volume(in_shape);
+  std::vector<int> in(n), out(n), ref(n);
+  std::iota(in.begin(), in.end(), 0);
+  for (auto &perm : testing::Permutations4) {
+    auto out_shape = permute(in_shape, perm);
+    testing::RefTranspose(ref.data(), in.data(), in_shape.data(), perm, 4);
+    std::fill(out.begin(), out.end(), -1);
+    // small blocks, so that the tensor is divided
+    TransposeGrouped(engine, TensorView<StorageCPU, int>{out.data(), out_shape},
+                     TensorView<StorageCPU, const int>{in.data(), in_shape},
+                     make_cspan(perm, 4), 64);
+    engine.RunAll();
+    ASSERT_EQ(out, ref);
+  }
+}
+
+TEST(TransposeCPU, BlockedThreadPool) {
+  ThreadPool tp(4, CPU_ONLY_DEVICE_ID, false, "TransposeCPU test");
+  TestBlockedTranspose(tp);
+}
+
+TEST(TransposeCPU, BlockedSequential) {
+  SequentialExecutionEngine engine;
+  TestBlockedTranspose(engine);
+}
+
+template <typename T>
+void TestLargeTranspose(const TensorShape<> &in_shape, span<const int> perm) {
+  int64_t n = volume(in_shape);
+  std::vector<T> in(n), out(n), ref(n);
+  for (int64_t i = 0; i < n; i++)
+    in[i] = static_cast<T>(i * 7 + 1);
+  auto out_shape = permute(in_shape, perm);
+  testing::RefTranspose(ref.data(), in.data(), in_shape.data(), perm.data(), in_shape.size());
+  Transpose(TensorView<StorageCPU, T>{out.data(), out_shape},
+            TensorView<StorageCPU, const T>{in.data(), in_shape}, perm);
+  ASSERT_EQ(out, ref) << "shape: " << in_shape << " element size: " << sizeof(T);
+}
+
+TEST(TransposeCPU, Blocked2D) {
+  // the sizes are not multiples of the block nor of the SIMD tile
+  TensorShape<> shapes[] = { { 131, 67 }, { 3, 1000 }, { 1000, 3 }, { 9, 254 } };
+  int perm2[] = { 1, 0 };
+  for (auto &shape : shapes) {
+    TestLargeTranspose<uint8_t>(shape, make_cspan(perm2));
+    TestLargeTranspose<int16_t>(shape, make_cspan(perm2));
+    TestLargeTranspose<float>(shape, make_cspan(perm2));
+    TestLargeTranspose<double>(shape, make_cspan(perm2));
+  }
+  TensorShape<> shape4 = { 5, 37, 70, 9 };
+  for (auto &perm : testing::Permutations4) {
+    TestLargeTranspose<uint8_t>(shape4, make_cspan(perm, 4));
+    TestLargeTranspose<float>(shape4, make_cspan(perm, 4));
+  }
+}
+
+}  // namespace kernels
+}  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -157,6 +157,12 @@ class TransposeGPU::Impl {
       }
     }
 
+    block_descs_.clear();
+    int num_methods = !tiled_descs_.empty() + !deinterleave_descs_.empty() +
+                      !generic_descs_.empty();
+    if (num_methods > 1)
+      SetupMixed<T>();
+
     KernelRequirements req;
     req.output_shapes = { out_shape_ };
     ScratchpadEstimator se;
@@ -164,6 +170,7 @@ class TransposeGPU::Impl {
     se.add<mm::memory_kind::device, TiledTransposeDesc<T>>(tiled_descs_.size());
     se.add<mm::memory_kind::device, DeinterleaveDesc<T>>(deinterleave_descs_.size());
     se.add<mm::memory_kind::device, GenericTransposeDesc<T>>(generic_descs_.size());
+    se.add<mm::memory_kind::device, TransposeBlockDesc>(block_descs_.size());
 
     req.scratch_sizes = se.sizes;
 
@@ -182,8 +189,53 @@ class TransposeGPU::Impl {
     return req;
   }
 
+  /**
+   * @brief Calculates the blocks of a batch, in which the samples use different methods
+   *
+   * Such a batch is processed with a single launch of TransposeMixedBatch - the number of blocks
+   * is calculated for each sample separately, so the grid is not padded to the largest sample.
+   */
+  template <typename T>
+  void SetupMixed() {
+    int max_threads = MaxThreadsPerBlock(TransposeMixedBatch<T>);
+    assert(max_threads >= kTileSize);
+    mixed_block_y_ = 8;
+    while (kTileSize * mixed_block_y_ > max_threads)
+      mixed_block_y_ >>= 1;
+    const int block_size = kTileSize * mixed_block_y_;
+
+    auto add_blocks = [&](TransposeMethod method, int desc_idx, int64_t num_blocks) {
+      for (int64_t b = 0; b < num_blocks; b++) {
+        block_descs_.push_back({ static_cast<uint8_t>(method), static_cast<uint32_t>(desc_idx),
+                                 static_cast<uint32_t>(b), static_cast<uint32_t>(num_blocks) });
+      }
+    };
+
+    if (!tiled_descs_.empty()) {
+      mixed_tiled_grid_x_ = TiledGridX();
+      for (size_t i = 0; i < tiled_descs_.size(); i++) {
+        auto &desc = tiled_descs_[i];
+        desc.tiles_per_block = div_ceil(desc.total_tiles, mixed_tiled_grid_x_);
+        if (desc.tiles_per_block > 0)
+          add_blocks(TransposeMethod::Tiled, i, div_ceil(desc.total_tiles, desc.tiles_per_block));
+      }
+    }
+    for (size_t i = 0; i < deinterleave_descs_.size(); i++) {
+      auto &desc = deinterleave_descs_[i];
+      int64_t outer_size = desc.size / desc.in_strides[desc.ndim-2];
+      add_blocks(TransposeMethod::Deinterleave, i, div_ceil(outer_size, 4*block_size));
+    }
+    for (size_t i = 0; i < generic_descs_.size(); i++) {
+      add_blocks(TransposeMethod::Generic, i, div_ceil(generic_descs_[i].size, block_size * 8));
+    }
+  }
+
   template <typename T>
   void RunTyped(KernelContext &ctx, T *const *out, const T *const *in) {
+    if (!block_descs_.empty()) {
+      RunMixed(ctx, out, in);
+      return;
+    }
     RunTiled(ctx, out, in);
     RunDeinterleave(ctx, out, in);
     RunGeneric(ctx, out, in);
@@ -235,19 +287,62 @@ class TransposeGPU::Impl {
     }
   }
 
+  /**
+   * @brief The number of blocks (per sample) for the tiled transposition
+   */
+  int TiledGridX() const {
+    int64_t max_tiles = 0;
+    for (size_t i = 0; i < tiled_descs_.size(); i++) {
+      if (tiled_descs_[i].total_tiles > max_tiles)
+        max_tiles = tiled_descs_[i].total_tiles;
+    }
+    int grid_x = max_tiles;
+    int threshold = 64 / tiled_descs_.size();
+    if (grid_x > threshold) {
+      grid_x = threshold + (grid_x - threshold) / 4;
+    }
+    return grid_x;
+  }
+
   template <typename T>
-  void RunTiled(KernelContext &ctx, T *const *out, const T *const *in) {
+  void RunMixed(KernelContext &ctx, T *const *out, const T *const *in) {
+    TransposeMixedBatchDescs<T> descs = {};
     if (!tiled_descs_.empty()) {
-      int64_t max_tiles = 0;
       for (size_t i = 0; i < tiled_descs_.size(); i++) {
-        if (tiled_descs_[i].total_tiles > max_tiles)
-          max_tiles = tiled_descs_[i].total_tiles;
+        UpdateTiledTranspose(tiled_descs_[i], out[idx_tiled_[i]], in[idx_tiled_[i]],
+                             mixed_tiled_grid_x_);
       }
-      int grid_x = max_tiles;
-      int threshold = 64 / tiled_descs_.size();
-      if (grid_x > threshold) {
-        grid_x = threshold + (grid_x - threshold) / 4;
+      descs.tiled = reinterpret_cast<TiledTransposeDesc<T>*>(
+        ctx.scratchpad->ToGPU(ctx.gpu.stream, tiled_descs_));
+    }
+    if (!deinterleave_descs_.empty()) {
+      for (size_t i = 0; i < deinterleave_descs_.size(); i++) {
+        deinterleave_descs_[i].out = out[idx_deinterleave_[i]];
+        deinterleave_descs_[i].in =  in[idx_deinterleave_[i]];
+      }
+      descs.deinterleave = reinterpret_cast<DeinterleaveDesc<T>*>(
+        ctx.scratchpad->ToGPU(ctx.gpu.stream, deinterleave_descs_));
+    }
+    if (!generic_descs_.empty()) {
+      for (size_t i = 0; i < generic_descs_.size(); i++) {
+        generic_descs_[i].out = out[idx_generic_[i]];
+        generic_descs_[i].in =  in[idx_generic_[i]];
       }
+      descs.generic = reinterpret_cast<GenericTransposeDesc<T>*>(
+        ctx.scratchpad->ToGPU(ctx.gpu.stream, generic_descs_));
+    }
+    auto *gpu_blocks = ctx.scratchpad->ToGPU(ctx.gpu.stream, block_descs_);
+
+    dim3 block(kTileSize, mixed_block_y_);
+    const int shm_size = tiled_descs_.empty() ? 0 : kTiledTransposeMaxSharedMem;
+    TransposeMixedBatch<<<block_descs_.size(), block, shm_size, ctx.gpu.stream>>>(
+      descs, gpu_blocks);
+  }
+
+  template <typename T>
+  void RunTiled(KernelContext &ctx, T *const *out, const T *const *in) {
+    if (!tiled_descs_.empty()) {
+      int grid_x = TiledGridX();
       for (size_t i = 0; i < tiled_descs_.size(); i++) {
         UpdateTiledTranspose(tiled_descs_[i], out[idx_tiled_[i]], in[idx_tiled_[i]], grid_x);
       }
@@ -299,6 +394,10 @@ class TransposeGPU::Impl {
   std::vector<TiledTransposeDesc<void>>   tiled_descs_;
   std::vector<DeinterleaveDesc<void>>     deinterleave_descs_;
   std::vector<int> idx_generic_, idx_tiled_, idx_deinterleave_;  // sample indices
+  // the blocks of a mixed batch (empty if all samples use the same method)
+  std::vector<TransposeBlockDesc> block_descs_;
+  int mixed_block_y_ = 8;
+  int mixed_tiled_grid_x_ = 0;
 };
 
 TransposeGPU::TransposeGPU() {
@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -29,6 +29,14 @@ static constexpr int kTiledTransposeMaxSharedMem =
 static_assert(kTiledTransposeMaxSharedMem <= 48<<10,
   "Tile won't fit in shared memory on some supported archs.");
 
+enum class TransposeMethod {
+  Copy = 0,
+  Generic,
+  Tiled,
+  Interleave,
+  Deinterleave
+};
+
 }  // namespace transpose_impl
 }  // namespace kernels
 }  // namespace dali
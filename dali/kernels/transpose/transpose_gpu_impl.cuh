@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -101,8 +101,8 @@ namespace transpose_shared {
 }  // namespace transpose_shared
 
 template <int ndim, unsigned pack_ratio_log, typename T, typename OldT>
-__device__ inline void TransposeTiledPacked(TiledTransposeDesc<OldT> desc) {
-  unsigned start_tile = blockIdx.x * desc.tiles_per_block;
+__device__ inline void TransposeTiledPacked(TiledTransposeDesc<OldT> desc, unsigned block_idx) {
+  unsigned start_tile = block_idx * desc.tiles_per_block;
   unsigned end_tile = min(desc.total_tiles, start_tile + desc.tiles_per_block);
   if (start_tile >= end_tile)
     return;
@@ -189,37 +189,40 @@ __device__ inline void TransposeTiledPacked(TiledTransposeDesc<OldT> desc) {
 }
 
 template <int ndim, typename T>
-__device__ void TransposeTiledStatic(TiledTransposeDesc<T> desc) {
+__device__ void TransposeTiledStatic(TiledTransposeDesc<T> desc, unsigned block_idx) {
   if (sizeof(T) == 1 && desc.lanes % 4 == 0 && reinterpret_cast<uintptr_t>(desc.out) % 4 == 0 &&
       reinterpret_cast<uintptr_t>(desc.in) % 4 == 0) {
-    return TransposeTiledPacked<ndim, 2, type_of_size<4>>(desc);
+    return TransposeTiledPacked<ndim, 2, type_of_size<4>>(desc, block_idx);
   }
   if (sizeof(T) < 4 && desc.lanes % 2 == 0 && reinterpret_cast<uintptr_t>(desc.out) % 2 == 0 &&
       reinterpret_cast<uintptr_t>(desc.in) % 2 == 0) {
     if (sizeof(T) == 2) {
-      return TransposeTiledPacked<ndim, 1, type_of_size<4>>(desc);
+      return TransposeTiledPacked<ndim, 1, type_of_size<4>>(desc, block_idx);
     } else {
-      return TransposeTiledPacked<ndim, 1, type_of_size<2>>(desc);
+      return TransposeTiledPacked<ndim, 1, type_of_size<2>>(desc, block_idx);
     }
   }
-  return TransposeTiledPacked<ndim, 0, T>(desc);
+  return TransposeTiledPacked<ndim, 0, T>(desc, block_idx);
 }
 
+/**
+ * @param block_idx index of the block (a range of desc.tiles_per_block tiles) in the sample
+ */
 template <typename T>
-__device__ void TransposeTiled(const TiledTransposeDesc<T> &desc) {
+__device__ void TransposeTiled(const TiledTransposeDesc<T> &desc, unsigned block_idx) {
   VALUE_SWITCH(desc.ndim, static_ndim, (2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16),
-    TransposeTiledStatic<static_ndim>(desc),
+    TransposeTiledStatic<static_ndim>(desc, block_idx),
     {});
 }
 
 template <typename T>
 __global__ void TransposeTiledSingle(TiledTransposeDesc<T> desc) {
-  TransposeTiled(desc);
+  TransposeTiled(desc, blockIdx.x);
 }
 
 template <typename T>
 __global__ void TransposeTiledBatch(const TiledTransposeDesc<T> *descs) {
-  TransposeTiled(descs[blockIdx.y]);
+  TransposeTiled(descs[blockIdx.y], blockIdx.x);
 }
 
 template <typename T>
@@ -233,18 +236,25 @@ struct DeinterleaveDesc {
   int ndim;
 };
 
+/**
+ * @param block_idx   index of the block among the blocks processing the sample
+ * @param num_blocks  number of blocks processing the sample
+ *
+ * The block can be one- or two-dimensional - the threads are flattened.
+ */
 template <typename T>
-__device__ void TransposeDeinterleave(const DeinterleaveDesc<T> &desc) {
-  const int tid = threadIdx.x;
+__device__ void TransposeDeinterleave(const DeinterleaveDesc<T> &desc,
+                                      unsigned block_idx, unsigned num_blocks) {
+  const int tid = threadIdx.y * blockDim.x + threadIdx.x;
 
   int ndim = desc.ndim;
   int lanes = desc.in_strides[ndim-2];
 
   uint64_t lane_stride = desc.out_strides[ndim-1];
 
-  const uint64_t block_size = blockDim.x;
-  uint64_t start_ofs = (blockIdx.x * block_size + tid) * lanes;
-  uint64_t grid_stride = gridDim.x * block_size * lanes;
+  const uint64_t block_size = blockDim.x * blockDim.y;
+  uint64_t start_ofs = (block_idx * block_size + tid) * lanes;
+  uint64_t grid_stride = num_blocks * block_size * lanes;
 
   T *out = desc.out;
   const T *in = desc.in;
@@ -276,15 +286,22 @@ struct GenericTransposeDesc {
   int ndim;
 };
 
+/**
+ * @param block_idx   index of the block among the blocks processing the sample
+ * @param num_blocks  number of blocks processing the sample
+ *
+ * The block can be one- or two-dimensional - the threads are flattened.
+ */
 template <typename T>
-__device__ void TransposeGeneric(const GenericTransposeDesc<T> &desc) {
-  const int tid = threadIdx.x;
+__device__ void TransposeGeneric(const GenericTransposeDesc<T> &desc,
+                                 unsigned block_idx, unsigned num_blocks) {
+  const int tid = threadIdx.y * blockDim.x + threadIdx.x;
 
   int ndim = desc.ndim;
 
-  const uint64_t block_size = blockDim.x;
-  uint64_t start_ofs = blockIdx.x * block_size + tid;
-  uint64_t grid_stride = gridDim.x * block_size;
+  const uint64_t block_size = blockDim.x * blockDim.y;
+  uint64_t start_ofs = block_idx * block_size + tid;
+  uint64_t grid_stride = num_blocks * block_size;
 
   T *out = desc.out;
   const T *in = desc.in;
@@ -304,22 +321,64 @@ __device__ void TransposeGeneric(const GenericTransposeDesc<T> &desc) {
 
 template <typename T>
 __global__ void TransposeDeinterleaveSingle(DeinterleaveDesc<T> desc) {
-  TransposeDeinterleave(desc);
+  TransposeDeinterleave(desc, blockIdx.x, gridDim.x);
 }
 
 template <typename T>
 __global__ void TransposeDeinterleaveBatch(const DeinterleaveDesc<T> *descs) {
-  TransposeDeinterleave(descs[blockIdx.y]);
+  TransposeDeinterleave(descs[blockIdx.y], blockIdx.x, gridDim.x);
 }
 
 template <typename T>
 __global__ void TransposeGenericSingle(GenericTransposeDesc<T> desc) {
-  TransposeGeneric(desc);
+  TransposeGeneric(desc, blockIdx.x, gridDim.x);
 }
 
 template <typename T>
 __global__ void TransposeGenericBatch(const GenericTransposeDesc<T> *descs) {
-  TransposeGeneric(descs[blockIdx.y]);
+  TransposeGeneric(descs[blockIdx.y], blockIdx.x, gridDim.x);
+}
+
+/**
+ * @brief Assigns a block of the mixed batch kernel to a sample and a transposition method
+ */
+struct TransposeBlockDesc {
+  uint8_t method;        ///< TransposeMethod - Tiled, Deinterleave or Generic
+  uint32_t desc_idx;     ///< index of the sample descriptor in the array for this method
+  uint32_t block_idx;    ///< index of the block among the blocks processing the sample
+  uint32_t num_blocks;   ///< number of blocks processing the sample
+};
+
+template <typename T>
+struct TransposeMixedBatchDescs {
+  const TiledTransposeDesc<T> *tiled;
+  const DeinterleaveDesc<T> *deinterleave;
+  const GenericTransposeDesc<T> *generic;
+};
+
+/**
+ * @brief Transposes a batch in which the samples use different methods, in one launch
+ *
+ * Each block reads its method and sample from `blocks[blockIdx.x]`. The whole block takes
+ * the same path, so the tiled transposition can synchronize the threads.
+ * The block must be kTileSize threads wide and the dynamic shared memory must be large enough
+ * for the tiled transposition, if any of the samples uses it.
+ */
+template <typename T>
+__global__ void TransposeMixedBatch(TransposeMixedBatchDescs<T> descs,
+                                    const TransposeBlockDesc *blocks) {
+  TransposeBlockDesc blk = blocks[blockIdx.x];
+  switch (blk.method) {
+    case static_cast<uint8_t>(TransposeMethod::Tiled):
+      TransposeTiled(descs.tiled[blk.desc_idx], blk.block_idx);
+      break;
+    case static_cast<uint8_t>(TransposeMethod::Deinterleave):
+      TransposeDeinterleave(descs.deinterleave[blk.desc_idx], blk.block_idx, blk.num_blocks);
+      break;
+    default:
+      TransposeGeneric(descs.generic[blk.desc_idx], blk.block_idx, blk.num_blocks);
+      break;
+  }
 }
 
 
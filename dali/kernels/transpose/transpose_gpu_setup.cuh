@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -27,14 +27,6 @@ namespace dali {
 namespace kernels {
 namespace transpose_impl {
 
-enum class TransposeMethod {
-  Copy = 0,
-  Generic,
-  Tiled,
-  Interleave,
-  Deinterleave
-};
-
 DLL_PUBLIC TransposeMethod GetTransposeMethod(const int64_t *shape,
                                               const int *perm,
                                               int ndim,
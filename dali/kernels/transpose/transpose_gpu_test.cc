@@ -106,6 +106,45 @@ TEST(TransposeGPU, Test4DAll) {
 
 
 
+TEST(TransposeGPU, MixedMethods) {
+  std::mt19937_64 rng;
+  // the shapes are chosen so that the samples use the tiled, deinterleave and generic methods
+  TensorListShape<> shape = {{ 64, 64, 64 }, { 100, 100, 3 }, { 5, 7, 40 },
+                             { 40, 50, 60 }, { 33, 17, 2 }};
+  int perm[] = { 2, 0, 1 };
+  int N = shape.num_samples();
+  int D = shape.sample_dim();
+
+  TestTensorList<int> in, out, ref;
+  in.reshape(shape);
+  auto in_cpu = in.cpu();
+  UniformRandomFill(in_cpu, rng, 0, 1000);
+
+  TransposeGPU transpose;
+  ScratchpadAllocator sa;
+  KernelContext ctx;
+  ctx.gpu.stream = 0;
+  auto req = transpose.Setup(ctx, shape, make_span(perm), sizeof(int));
+  auto out_shape = req.output_shapes[0];
+  out.reshape(out_shape);
+  ref.reshape(out_shape);
+  sa.Reserve(req.scratch_sizes);
+  auto scratch = sa.GetScratchpad();
+  ctx.scratchpad = &scratch;
+
+  auto out_gpu = out.gpu();
+  CUDA_CALL(cudaMemset(out_gpu.data[0], 0xff, shape.num_elements() * sizeof(int)));
+  transpose.Run<int>(ctx, out_gpu, in.gpu());
+  CUDA_CALL(cudaGetLastError());
+
+  auto ref_cpu = ref.cpu();
+  for (int i = 0; i < N; i++) {
+    testing::RefTranspose(ref_cpu.data[i], in_cpu.data[i],
+                          in_cpu.tensor_shape_span(i).data(), perm, D);
+  }
+  Check(out.cpu(), ref_cpu);
+}
+
 template <typename T, typename RNG>
 void RunPerfTest(RNG &rng, const TensorListShape<> &shape, span<const int> perm) {
   auto start = CUDAEvent::CreateWithFlags(0);
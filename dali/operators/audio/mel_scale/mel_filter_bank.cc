@@ -63,7 +63,29 @@ The supported values are:
     consistent with Librosa's default implementation.
 - | ``htk``, which follows O'Shaughnessy's book formula, ``m = 2595 * log10(1 + (f/700))``.
   | This value is consistent with the implementation of the Hidden Markov Toolkit (HTK).
-)code", "slaney");
+)code", "slaney")
+    .AddOptionalArg("to_decibels",
+      R"code(If set to True, the mel spectrogram is converted to decibels in the same pass.
+
+The result is equivalent to applying :meth:`nvidia.dali.fn.to_decibels` with a fixed ``reference``
+to the output of this operator, but the intermediate mel spectrogram is never stored in memory::
+
+  min_ratio = pow(10, db_cutoff / db_multiplier)
+  out[i] = db_multiplier * log10( max(min_ratio, mel[i] / db_reference) )
+
+The per-sample maximum cannot be used as the reference in this mode.)code",
+      false)
+    .AddOptionalArg("db_multiplier",
+      R"code(Factor by which the logarithm is multiplied, if ``to_decibels`` is set.)code",
+      10.0f)
+    .AddOptionalArg("db_reference",
+      R"code(Reference magnitude, if ``to_decibels`` is set.)code",
+      1.0f)
+    .AddOptionalArg("db_cutoff",
+      R"code(Minimum or cut-off ratio in dB, if ``to_decibels`` is set.
+
+Any value below this value will saturate.)code",
+      -200.0f);
 
 template <>
 bool MelFilterBank<CPUBackend>::SetupImpl(std::vector<OutputDesc> &output_desc,
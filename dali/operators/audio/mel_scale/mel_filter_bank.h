@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -65,6 +65,17 @@ class MelFilterBank : public Operator<Backend> {
     }
 
     args_.normalize = spec.GetArgument<bool>("normalize");
+
+    args_.to_decibels = spec.GetArgument<bool>("to_decibels");
+    if (args_.to_decibels) {
+      args_.db_multiplier = spec.GetArgument<float>("db_multiplier");
+      args_.db_ref = spec.GetArgument<float>("db_reference");
+      DALI_ENFORCE(args_.db_ref > 0, "`db_reference` should be > 0");
+      auto cutoff_db = spec.GetArgument<float>("db_cutoff");
+      args_.db_min_ratio = std::pow(10.0f, cutoff_db / args_.db_multiplier);
+      if (args_.db_min_ratio == 0)
+        args_.db_min_ratio = std::nextafter(0.0f, 1.0f);
+    }
   }
 
  protected:
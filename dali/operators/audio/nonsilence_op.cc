@@ -39,12 +39,10 @@ Inputs and outputs:
 .. note::
   If ``Outputs[1] == 0``,  the value in ``Outputs[0]`` is undefined.
 
-.. warning::
-  At this moment, the 'gpu' backend of this operator is implemented in terms of the 'cpu'
-  implementation. This results in a device-to-host copy of the inputs and a host-to-device copy of the
-  outputs. While using the 'gpu' implementation of this operator doesn't add any performance
-  benefit on its own, using it might make sense in order to enable moving preceding operations in the
-  pipeline to the GPU.
+.. note::
+  The 'gpu' backend calculates the short term power and the region on the device, without
+  copying the audio to the host, so its outputs can be passed directly to the GPU operators, like
+  :meth:`nvidia.dali.fn.slice`.
 )code")
   .NumInput(1)
   .NumOutput(detail::kNumOutputs)
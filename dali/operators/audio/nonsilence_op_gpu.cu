@@ -0,0 +1,251 @@
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include "dali/core/cuda_utils.h"
+#include "dali/core/static_switch.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/kernels/reduce/reduce_common.cuh"
+#include "dali/kernels/reduce/reductions.h"
+#include "dali/operators/audio/nonsilence_op.h"
+#include "dali/pipeline/data/views.h"
+
+namespace dali {
+
+namespace detail {
+
+/**
+ * @brief Accumulator of the sum of squares - the same as in MovingMeanSquareCpu
+ *
+ * Small integers are accumulated exactly, the other types use float.
+ */
+template <typename T>
+using mms_acc_t = std::conditional_t<std::is_integral<T>::value && sizeof(T) <= 2,
+                                     int64_t, float>;
+
+template <typename T>
+__device__ DALI_FORCEINLINE mms_acc_t<T> Square(T value) {
+  mms_acc_t<T> acc = value;
+  return acc * acc;
+}
+
+template <typename T>
+struct NonsilenceSampleDesc {
+  const T *in;
+  int *begin, *length;
+  int64_t num_windows;    // the number of values of the moving mean square
+  int window_length;
+  int run_length;         // the number of consecutive windows calculated by one thread
+  float mean_factor;
+  float reference_power;  // not used if the maximum power is the reference
+  float cutoff_ratio;     // the power threshold relative to the reference
+};
+
+/**
+ * @brief Per-sample results of the reductions, zero-initialized
+ */
+struct NonsilenceState {
+  float max_power;  // non-negative, so it can be compared as int
+  int rev_first;    // num_windows - (the first nonsilent window), 0 if there's none
+  int last_end;     // the last nonsilent window + 1, 0 if there's none
+};
+
+/**
+ * @brief Calls `f(window, mean_square)` for the windows starting in [begin, end)
+ *
+ * The sum of squares is calculated from scratch at `begin` and then updated for each
+ * following window, as in MovingMeanSquareCpu.
+ */
+template <typename T, typename F>
+__device__ void ForEachMeanSquare(const NonsilenceSampleDesc<T> &sample,
+                                  int64_t begin, int64_t end, F &&f) {
+  const T *in = sample.in;
+  mms_acc_t<T> sumsq = 0;
+  for (int i = 0; i < sample.window_length; i++)
+    sumsq += Square(in[begin + i]);
+  f(begin, sumsq * sample.mean_factor);
+  for (int64_t w = begin + 1; w < end; w++) {
+    sumsq += Square(in[w + sample.window_length - 1]) - Square(in[w - 1]);
+    f(w, sumsq * sample.mean_factor);
+  }
+}
+
+/**
+ * @brief Calls `f(window, mean_square)` for the windows of the blockIdx.y-th sample
+ *        assigned to this thread
+ */
+template <typename T, typename F>
+__device__ void ForEachThreadMeanSquare(const NonsilenceSampleDesc<T> &sample, F &&f) {
+  int64_t block_threads = blockDim.x * blockDim.y;
+  int64_t num_runs = div_ceil(sample.num_windows, sample.run_length);
+  int64_t run = blockIdx.x * block_threads + threadIdx.y * blockDim.x + threadIdx.x;
+  for (; run < num_runs; run += gridDim.x * block_threads) {
+    int64_t begin = run * sample.run_length;
+    int64_t end = cuda_min(begin + sample.run_length, sample.num_windows);
+    ForEachMeanSquare(sample, begin, end, f);
+  }
+}
+
+template <typename T>
+__global__ void MaxPowerKernel(const NonsilenceSampleDesc<T> *samples, NonsilenceState *states) {
+  const auto &sample = samples[blockIdx.y];
+  float max_power = 0;
+  ForEachThreadMeanSquare(sample, [&](int64_t, float power) {
+    max_power = cuda_max(max_power, power);
+  });
+  if (kernels::BlockReduce(max_power, kernels::reductions::max()))
+    atomicMax(reinterpret_cast<int *>(&states[blockIdx.y].max_power), __float_as_int(max_power));
+}
+
+template <typename T>
+__global__ void ThresholdKernel(const NonsilenceSampleDesc<T> *samples, NonsilenceState *states,
+                                bool reference_max) {
+  const auto &sample = samples[blockIdx.y];
+  auto &state = states[blockIdx.y];
+  float reference = reference_max ? state.max_power : sample.reference_power;
+  float threshold = reference * sample.cutoff_ratio;
+  int rev_first = 0, last_end = 0;
+  ForEachThreadMeanSquare(sample, [&](int64_t window, float power) {
+    if (power >= threshold) {
+      rev_first = cuda_max<int>(rev_first, sample.num_windows - window);
+      last_end = cuda_max<int>(last_end, window + 1);
+    }
+  });
+  if (kernels::BlockReduce(rev_first, kernels::reductions::max()))
+    atomicMax(&state.rev_first, rev_first);
+  __syncthreads();  // the shared memory of BlockReduce is reused
+  if (kernels::BlockReduce(last_end, kernels::reductions::max()))
+    atomicMax(&state.last_end, last_end);
+}
+
+template <typename T>
+__global__ void OutputKernel(const NonsilenceSampleDesc<T> *samples,
+                             const NonsilenceState *states, int nsamples) {
+  int i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i >= nsamples)
+    return;
+  const auto &sample = samples[i];
+  const auto &state = states[i];
+  if (state.last_end == 0) {  // the whole buffer is silent
+    *sample.begin = 0;
+    *sample.length = 0;
+    return;
+  }
+  int begin = sample.num_windows - state.rev_first;
+  *sample.begin = begin;
+  // we don't know where in the window the non-silent signal is, so the window is included
+  *sample.length = state.last_end - begin + sample.window_length - 1;
+}
+
+}  // namespace detail
+
+class NonsilenceOperatorGpu : public NonsilenceOperator<GPUBackend> {
+ public:
+  explicit NonsilenceOperatorGpu(const OpSpec &spec)
+      : NonsilenceOperator<GPUBackend>(spec) {}
+  ~NonsilenceOperatorGpu() override = default;
+  DISABLE_COPY_MOVE_ASSIGN(NonsilenceOperatorGpu);
+
+ protected:
+  bool SetupImpl(std::vector<OutputDesc> &output_desc,
+                 const workspace_t<GPUBackend> &ws) override {
+    AcquireArgs(spec_, ws);
+    const auto &input = ws.Input<GPUBackend>(0);
+    DALI_ENFORCE(input.sample_dim() == 1, make_string(
+        "The input of NonsilentRegion must be a 1D audio buffer. Got: ", input.sample_dim(),
+        "D input."));
+    auto curr_batch_size = ws.GetInputBatchSize(0);
+    output_desc.resize(detail::kNumOutputs);
+    for (int i = 0; i < detail::kNumOutputs; i++) {
+      output_desc[i].shape = uniform_list_shape(curr_batch_size, TensorShape<>{});
+      output_desc[i].type = DALI_INT32;
+    }
+    return true;
+  }
+
+  void RunImpl(workspace_t<GPUBackend> &ws) override;
+
+ private:
+  template <typename InputType>
+  void RunImplTyped(workspace_t<GPUBackend> &ws);
+
+  // the minimum number of consecutive windows calculated by one thread
+  static constexpr int kMinRunLength = 1024;
+};
+
+template <typename InputType>
+void NonsilenceOperatorGpu::RunImplTyped(workspace_t<GPUBackend> &ws) {
+  using SampleDesc = detail::NonsilenceSampleDesc<InputType>;
+  const auto &input = ws.Input<GPUBackend>(0);
+  auto &output_begin = ws.Output<GPUBackend>(0);
+  auto &output_length = ws.Output<GPUBackend>(1);
+  int nsamples = ws.GetInputBatchSize(0);
+  auto stream = ws.stream();
+
+  std::vector<SampleDesc> samples(nsamples);
+  int64_t max_runs = 0;
+  for (int i = 0; i < nsamples; i++) {
+    auto &sample = samples[i];
+    int64_t size = input.tensor_shape_span(i)[0];
+    sample.in = input.tensor<InputType>(i);
+    sample.begin = output_begin.mutable_tensor<int>(i);
+    sample.length = output_length.mutable_tensor<int>(i);
+    sample.window_length = window_length_ < size ? window_length_ : size;
+    sample.num_windows = size > 0 ? size - sample.window_length + 1 : 0;
+    sample.mean_factor = 1.f / sample.window_length;
+    sample.reference_power = reference_max_ ? 0.f : reference_power_[i];
+    sample.cutoff_ratio = std::pow(10.f, cutoff_db_[i] * (1.f / 10.f));
+    // the sum of squares is recalculated where MovingMeanSquareCpu would reset it, or more often
+    sample.run_length = std::max(sample.window_length, kMinRunLength);
+    if (reset_interval_ > 0)
+      sample.run_length = std::min(sample.run_length, reset_interval_ - sample.window_length + 1);
+    max_runs = std::max(max_runs, div_ceil(sample.num_windows, sample.run_length));
+  }
+
+  kernels::DynamicScratchpad scratchpad({}, stream);
+  auto *samples_gpu = scratchpad.ToGPU(stream, samples);
+  auto *states_gpu = scratchpad.AllocateGPU<detail::NonsilenceState>(nsamples);
+  CUDA_CALL(cudaMemsetAsync(states_gpu, 0, nsamples * sizeof(detail::NonsilenceState), stream));
+
+  dim3 block(32, 8);
+  int64_t block_threads = block.x * block.y;
+  int max_blocks = std::max(32, 1024 / nsamples);
+  int blocks_per_sample = std::max<int64_t>(1, std::min<int64_t>(
+      div_ceil(max_runs, block_threads), max_blocks));
+  dim3 grid(blocks_per_sample, nsamples);
+  if (reference_max_)
+    detail::MaxPowerKernel<<<grid, block, 0, stream>>>(samples_gpu, states_gpu);
+  detail::ThresholdKernel<<<grid, block, 0, stream>>>(samples_gpu, states_gpu, reference_max_);
+  detail::OutputKernel<<<div_ceil(nsamples, 256), 256, 0, stream>>>(
+      samples_gpu, states_gpu, nsamples);
+  CUDA_CALL(cudaGetLastError());
+}
+
+#define NONSILENCE_TYPES (uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, uint64_t, int64_t, float)  // NOLINT
+
+void NonsilenceOperatorGpu::RunImpl(workspace_t<GPUBackend> &ws) {
+  const auto &input = ws.Input<GPUBackend>(0);
+  TYPE_SWITCH(input.type(), type2id, InputType, NONSILENCE_TYPES, (
+    RunImplTyped<InputType>(ws);
+  ), DALI_FAIL(make_string("Unsupported input type: ", input.type())));  // NOLINT
+}
+
+#undef NONSILENCE_TYPES
+
+DALI_REGISTER_OPERATOR(NonsilentRegion, NonsilenceOperatorGpu, GPU);
+
+}  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -29,6 +29,7 @@ The bounding box coordinates for the  input are in the [x, y, width, height] - `
 system, that is 0.0-1.0)code")
     .NumInput(1)
     .NumOutput(1)
+    .CudaGraphCapturable()
     .AddOptionalArg("ltrb",
                     R"code(True for ``ltrb`` or False for ``xywh``.)code",
                     false, false)
@@ -12,11 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 #include "dali/core/format.h"
 #include "dali/operators/bbox/bb_flip.cuh"
+#include "dali/kernels/common/flat_batch.h"
 #include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/pipeline/data/views.h"
 
 namespace dali {
 
@@ -30,25 +33,26 @@ __global__ void BbFlipKernel(const BbFlipSampleDesc *samples, const kernels::Blo
   const auto &sample = samples[block.sample_idx];
 
   for (int idx = threadIdx.x + block.start.x; idx < block.end.x; idx += blockDim.x) {
-    bool h = sample.horz;
-    bool v = sample.vert;
-
-    const auto *in = &sample.input[4 * idx];
-    auto *out = &sample.output[4 * idx];
-    if (ltrb) {
-      out[0] = h ? 1.0f - in[2] : in[0];
-      out[1] = v ? 1.0f - in[3] : in[1];
-      out[2] = h ? 1.0f - in[0] : in[2];
-      out[3] = v ? 1.0f - in[1] : in[3];
-    } else {
-      // No range checking required if the parenthesis is respected in the two lines below.
-      // If the original bounding box satisfies the condition that x + w <= 1.0f, then the
-      // expression 1.0f - (x + w) is guaranteed to yield a non-negative result. QED.
-      out[0] = h ? 1.0f - (in[0] + in[2]) : in[0];
-      out[1] = v ? 1.0f - (in[1] + in[3]) : in[1];
-      out[2] = in[2];  // width and
-      out[3] = in[3];  // height remain unaffected
-    }
+    FlipBox<ltrb>(&sample.output[4 * idx], &sample.input[4 * idx], sample.horz, sample.vert);
+  }
+}
+
+/**
+ * @brief Flips the boxes of a densely packed batch, one box per thread
+ *
+ * @param box_offsets - Index of the first box of each sample, nsamples + 1 entries
+ * @param flags       - Flipping configuration of each sample
+ */
+template <bool ltrb>
+__global__ void BbFlipFlatKernel(float *__restrict__ out, const float *__restrict__ in,
+                                 const int64_t *box_offsets, const BbFlipFlags *flags,
+                                 int nsamples) {
+  int64_t nboxes = box_offsets[nsamples];
+  int64_t grid_stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+  for (int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x; idx < nboxes;
+       idx += grid_stride) {
+    BbFlipFlags f = flags[kernels::FlatSampleIdx(box_offsets, nsamples, idx)];
+    FlipBox<ltrb>(&out[4 * idx], &in[4 * idx], f.horz, f.vert);
   }
 }
 
@@ -90,13 +94,7 @@ void BbFlipGPU::RunImpl(workspace_t<GPUBackend> &ws) {
                  "Flat representation of bounding boxes must have size divisible by 4");
   }
 
-  TensorListShape<2> strong_shape = GetNormalizedShape(shape);
-
-  block_setup_.SetupBlocks(strong_shape, true);
   kernels::DynamicScratchpad scratchpad({}, ws.stream());
-
-  samples_.resize(nsamples);
-
   auto stream = ws.stream();
 
   const auto num_boxes = input._num_elements() / 4;
@@ -105,6 +103,39 @@ void BbFlipGPU::RunImpl(workspace_t<GPUBackend> &ws) {
     return;
   }
 
+  // Bounding box tensors are tiny - process densely packed batches as one array of boxes,
+  // instead of setting up blocks for each sample.
+  auto *out_flat = kernels::DenselyPackedData(view<float>(output));
+  const auto *in_flat = kernels::DenselyPackedData(view<const float>(input));
+  if (out_flat && in_flat) {
+    kernels::FlatSampleOffsets(box_offsets_, shape, 4);
+    flags_.resize(nsamples);
+    for (int sample_idx = 0; sample_idx < nsamples; sample_idx++) {
+      flags_[sample_idx].horz = horz_[sample_idx].data[0];
+      flags_[sample_idx].vert = vert_[sample_idx].data[0];
+    }
+    int64_t *offsets_dev;
+    BbFlipFlags *flags_dev;
+    std::tie(offsets_dev, flags_dev) = scratchpad.ToContiguousGPU(stream, box_offsets_, flags_);
+    const int block = 256;
+    int grid = std::min<int64_t>(div_ceil(num_boxes, block), 1024);
+    if (ltrb_) {
+      BbFlipFlatKernel<true><<<grid, block, 0, stream>>>(out_flat, in_flat, offsets_dev,
+                                                          flags_dev, nsamples);
+    } else {
+      BbFlipFlatKernel<false><<<grid, block, 0, stream>>>(out_flat, in_flat, offsets_dev,
+                                                           flags_dev, nsamples);
+    }
+    CUDA_CALL(cudaGetLastError());
+    return;
+  }
+
+  TensorListShape<2> strong_shape = GetNormalizedShape(shape);
+
+  block_setup_.SetupBlocks(strong_shape, true);
+
+  samples_.resize(nsamples);
+
   for (int sample_idx = 0; sample_idx < nsamples; sample_idx++) {
     samples_[sample_idx].output = output.mutable_tensor<float>(sample_idx);
     samples_[sample_idx].input = input.tensor<float>(sample_idx);
@@ -24,6 +24,27 @@
 
 namespace dali {
 
+/**
+ * @brief Flips a box; `out` must not alias `in`
+ */
+template <bool ltrb>
+__device__ __forceinline__ void FlipBox(float *out, const float *in, bool h, bool v) {
+  if (ltrb) {
+    out[0] = h ? 1.0f - in[2] : in[0];
+    out[1] = v ? 1.0f - in[3] : in[1];
+    out[2] = h ? 1.0f - in[0] : in[2];
+    out[3] = v ? 1.0f - in[1] : in[3];
+  } else {
+    // No range checking required if the parenthesis is respected in the two lines below.
+    // If the original bounding box satisfies the condition that x + w <= 1.0f, then the
+    // expression 1.0f - (x + w) is guaranteed to yield a non-negative result. QED.
+    out[0] = h ? 1.0f - (in[0] + in[2]) : in[0];
+    out[1] = v ? 1.0f - (in[1] + in[3]) : in[1];
+    out[2] = in[2];  // width and
+    out[3] = in[3];  // height remain unaffected
+  }
+}
+
 struct BbFlipSampleDesc {
   float *output;
   const float *input;
@@ -31,6 +52,11 @@ struct BbFlipSampleDesc {
   bool vert;
 };
 
+struct BbFlipFlags {
+  bool horz;
+  bool vert;
+};
+
 class BbFlipGPU : public BbFlip<GPUBackend> {
  public:
   explicit BbFlipGPU(const OpSpec &spec)
@@ -55,6 +81,8 @@ class BbFlipGPU : public BbFlip<GPUBackend> {
 
   GpuBlockSetup block_setup_;
   std::vector<BbFlipSampleDesc> samples_;
+  std::vector<int64_t> box_offsets_;
+  std::vector<BbFlipFlags> flags_;
 };
 
 
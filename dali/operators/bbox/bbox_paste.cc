@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -54,24 +54,9 @@ canvas and ``(1,1)`` aligns it to bottom-right.
       R"code(Vertical position of the paste in image coordinates (0.0 - 1.0).)code",
       0.5f, true);
 
-template<>
-void BBoxPaste<CPUBackend>::RunImpl(Workspace<CPUBackend> &ws) {
-  const auto &input = ws.Input<CPUBackend>(0);
-  const auto input_data = input.data<float>();
-
-  DALI_ENFORCE(input.type() == DALI_FLOAT, "Bounding box in wrong format");
-  DALI_ENFORCE(input.size() % 4 == 0, "Bounding box tensor size must be a multiple of 4."
-                                      "Got: " + std::to_string(input.size()));
-
-  auto &output = ws.Output<CPUBackend>(0);
-  output.Resize(input.shape(), DALI_FLOAT);
-  auto *output_data = output.mutable_data<float>();
-
-  const auto data_idx = ws.data_idx();
+BBoxPasteParams GetBBoxPasteParams(float ratio, float px, float py) {
+  BBoxPasteParams params;
   // pasting onto a larger canvas scales bounding boxes down by scale ratio
-  float ratio = spec_.GetArgument<float>("ratio", &ws, data_idx);
-  float px = spec_.GetArgument<float>("paste_x", &ws, data_idx);
-  float py = spec_.GetArgument<float>("paste_y", &ws, data_idx);
   float scale = 1 / ratio;
 
   // offsets are scaled so that (0,0) pastes the image aligned to the top-left
@@ -91,28 +76,35 @@ void BBoxPaste<CPUBackend>::RunImpl(Workspace<CPUBackend> &ws) {
     while (scale + ofsy > 1)
       ofsy = std::nextafter(ofsy, -1.0f);
   }
+  params.scale = scale;
+  params.ofsx = ofsx;
+  params.ofsy = ofsy;
+  return params;
+}
+
+template<>
+void BBoxPaste<CPUBackend>::RunImpl(Workspace<CPUBackend> &ws) {
+  const auto &input = ws.Input<CPUBackend>(0);
+  const auto input_data = input.data<float>();
+
+  DALI_ENFORCE(input.type() == DALI_FLOAT, "Bounding box in wrong format");
+  DALI_ENFORCE(input.size() % 4 == 0, "Bounding box tensor size must be a multiple of 4."
+                                      "Got: " + std::to_string(input.size()));
+
+  auto &output = ws.Output<CPUBackend>(0);
+  output.Resize(input.shape(), DALI_FLOAT);
+  auto *output_data = output.mutable_data<float>();
+
+  const auto data_idx = ws.data_idx();
+  auto params = GetBBoxPasteParams(spec_.GetArgument<float>("ratio", &ws, data_idx),
+                                   spec_.GetArgument<float>("paste_x", &ws, data_idx),
+                                   spec_.GetArgument<float>("paste_y", &ws, data_idx));
 
   for (int j = 0; j + 4 <= input.size(); j += 4) {
-    auto x0 = input_data[j];
-    auto y0 = input_data[j + 1];
-    auto x1w = input_data[j + 2];
-    auto y1h = input_data[j + 3];
-    // (x1w, y1h) contain (x1, y1) for LTRB representation and (W, H) otherwise
-
-    x0 = x0 * scale + ofsx;
-    y0 = y0 * scale + ofsy;
-    if (use_ltrb_) {
-      x1w = x1w * scale + ofsx;
-      y1h = y1h * scale + ofsy;
-    } else {
-      x1w = x1w * scale;
-      y1h = y1h * scale;
-    }
-
-    output_data[j] = x0;
-    output_data[j+1] = y0;
-    output_data[j+2] = x1w;
-    output_data[j+3] = y1h;
+    if (use_ltrb_)
+      PasteBox<true>(output_data + j, input_data + j, params);
+    else
+      PasteBox<false>(output_data + j, input_data + j, params);
   }
 }
 
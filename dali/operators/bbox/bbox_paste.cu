@@ -0,0 +1,86 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <vector>
+#include "dali/core/format.h"
+#include "dali/operators/bbox/bbox_paste.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+
+namespace dali {
+
+struct BBoxPasteSampleDesc {
+  float *output;
+  const float *input;
+  int64_t num_boxes;
+  BBoxPasteParams params;
+};
+
+/**
+ * @brief Pastes the boxes of the sample `blockIdx.y`
+ */
+template <bool ltrb>
+__global__ void BBoxPasteKernel(const BBoxPasteSampleDesc *samples) {
+  const auto &sample = samples[blockIdx.y];
+  for (int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       idx < sample.num_boxes; idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    PasteBox<ltrb>(&sample.output[4 * idx], &sample.input[4 * idx], sample.params);
+  }
+}
+
+template <>
+void BBoxPaste<GPUBackend>::RunImpl(Workspace<GPUBackend> &ws) {
+  const auto &input = ws.Input<GPUBackend>(0);
+  DALI_ENFORCE(input.type() == DALI_FLOAT, "Bounding box in wrong format");
+  const auto &shape = input.shape();
+  int nsamples = shape.num_samples();
+
+  auto &output = ws.Output<GPUBackend>(0);
+  output.Resize(shape, DALI_FLOAT);
+  output.SetLayout(input.GetLayout());
+
+  std::vector<BBoxPasteSampleDesc> samples(nsamples);
+  int64_t max_boxes = 0;
+  for (int i = 0; i < nsamples; i++) {
+    int64_t size = shape.tensor_size(i);
+    DALI_ENFORCE(size % 4 == 0, make_string(
+        "Bounding box tensor size must be a multiple of 4. Got: ", size));
+    auto &sample = samples[i];
+    sample.output = output.mutable_tensor<float>(i);
+    sample.input = input.tensor<float>(i);
+    sample.num_boxes = size / 4;
+    sample.params = GetBBoxPasteParams(spec_.GetArgument<float>("ratio", &ws, i),
+                                       spec_.GetArgument<float>("paste_x", &ws, i),
+                                       spec_.GetArgument<float>("paste_y", &ws, i));
+    max_boxes = std::max(max_boxes, sample.num_boxes);
+  }
+  if (max_boxes == 0)
+    return;
+
+  auto stream = ws.stream();
+  kernels::DynamicScratchpad scratchpad({}, stream);
+  auto *samples_dev = scratchpad.ToGPU(stream, samples);
+
+  const int block = 256;
+  dim3 grid(std::min<int64_t>(div_ceil(max_boxes, block), 64), nsamples);
+  if (use_ltrb_)
+    BBoxPasteKernel<true><<<grid, block, 0, stream>>>(samples_dev);
+  else
+    BBoxPasteKernel<false><<<grid, block, 0, stream>>>(samples_dev);
+  CUDA_CALL(cudaGetLastError());
+}
+
+DALI_REGISTER_OPERATOR(BBoxPaste, BBoxPaste<GPUBackend>, GPU);
+
+}  // namespace dali
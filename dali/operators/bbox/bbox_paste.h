@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -19,11 +19,50 @@
 
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
+#include "dali/core/host_dev.h"
 #include "dali/pipeline/operator/common.h"
 #include "dali/pipeline/operator/operator.h"
 
 namespace dali {
 
+/**
+ * @brief Scale and offsets which map the boxes of an image to the canvas it's pasted onto
+ */
+struct BBoxPasteParams {
+  float scale = 1;
+  float ofsx = 0, ofsy = 0;
+};
+
+/**
+ * @brief Calculates the box transform for pasting onto a canvas `ratio` times larger,
+ *        at the relative position (`paste_x`, `paste_y`)
+ */
+BBoxPasteParams GetBBoxPasteParams(float ratio, float paste_x, float paste_y);
+
+template <bool ltrb>
+DALI_HOST_DEV inline void PasteBox(float *out, const float *in, const BBoxPasteParams &params) {
+  auto x0 = in[0];
+  auto y0 = in[1];
+  auto x1w = in[2];
+  auto y1h = in[3];
+  // (x1w, y1h) contain (x1, y1) for LTRB representation and (W, H) otherwise
+
+  x0 = x0 * params.scale + params.ofsx;
+  y0 = y0 * params.scale + params.ofsy;
+  if (ltrb) {
+    x1w = x1w * params.scale + params.ofsx;
+    y1h = y1h * params.scale + params.ofsy;
+  } else {
+    x1w = x1w * params.scale;
+    y1h = y1h * params.scale;
+  }
+
+  out[0] = x0;
+  out[1] = y0;
+  out[2] = x1w;
+  out[3] = y1h;
+}
+
 template <typename Backend>
 class BBoxPaste : public Operator<Backend> {
  public:
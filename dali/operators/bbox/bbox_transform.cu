@@ -0,0 +1,225 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <vector>
+#include "dali/core/format.h"
+#include "dali/operators/bbox/bb_flip.cuh"
+#include "dali/operators/bbox/bbox_paste.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/pipeline/operator/arg_helper.h"
+
+namespace dali {
+
+DALI_SCHEMA(BBoxTransform)
+  .DocStr(R"code(Applies a crop, a flip and a paste to bounding boxes, in this order, in one pass.
+
+This operator fuses the box transforms of a typical detection augmentation chain, so that the
+boxes can stay on the GPU between :meth:`nvidia.dali.fn.random_bbox_crop` and
+:meth:`nvidia.dali.fn.box_encoder`. Each of the steps produces the same results as:
+
+* crop - the boxes output by :meth:`nvidia.dali.fn.random_bbox_crop` for the cropping window
+  given as ``crop_anchor`` and ``crop_shape`` (the boxes are clamped to the window, but not
+  removed),
+* flip - :meth:`nvidia.dali.fn.bb_flip` with ``horizontal`` and ``vertical``,
+* paste - :meth:`nvidia.dali.fn.bbox_paste` with ``paste_ratio``, ``paste_x`` and ``paste_y``.
+
+The steps whose arguments are not specified are skipped.
+
+The boxes are given in relative coordinates, as a tensor of shape ``[N, 4]`` or a flat tensor
+with a multiple of 4 elements.)code")
+  .NumInput(1)
+  .NumOutput(1)
+  .AddOptionalArg("ltrb", R"code(True for ``ltrb`` or False for ``xywh``.)code", false)
+  .AddOptionalArg<vector<float>>("crop_anchor",
+      R"code(Relative coordinates of the start of the cropping window, as ``(x, y)``.
+
+Defaults to ``(0, 0)`` if only ``crop_shape`` is specified.)code", nullptr, true)
+  .AddOptionalArg<vector<float>>("crop_shape",
+      R"code(Relative extent of the cropping window, as ``(w, h)``.
+
+If not specified, the boxes are not cropped.)code", nullptr, true)
+  .AddOptionalArg("horizontal", R"code(Flip horizontal dimension.)code", 0, true)
+  .AddOptionalArg("vertical", R"code(Flip vertical dimension.)code", 0, true)
+  .AddOptionalArg("paste_ratio",
+      R"code(Ratio of the canvas size to the input size; the value must be at least 1.
+
+The default ratio of 1 leaves the boxes in place.)code", 1.0f, true)
+  .AddOptionalArg("paste_x",
+      R"code(Horizontal position of the paste in image coordinates (0.0 - 1.0).)code",
+      0.5f, true)
+  .AddOptionalArg("paste_y",
+      R"code(Vertical position of the paste in image coordinates (0.0 - 1.0).)code",
+      0.5f, true);
+
+struct BBoxTransformSampleDesc {
+  float *output;
+  const float *input;
+  int64_t num_boxes;
+  bool crop;
+  float crop_lo[2], crop_hi[2];
+  bool horz, vert;
+  BBoxPasteParams paste;
+};
+
+/**
+ * @brief Remaps the box to the coordinate space of the cropping window,
+ *        like RemapBox in bounding_box_utils.h
+ */
+template <bool ltrb>
+__device__ __forceinline__ void CropBox(float *out, const float *in, const float *crop_lo,
+                                        const float *crop_hi) {
+  for (int d = 0; d < 2; d++) {
+    float lo = in[d];
+    float hi = ltrb ? in[d + 2] : in[d] + in[d + 2];
+    float extent = crop_hi[d] - crop_lo[d];
+    float start = (fmaxf(crop_lo[d], lo) - crop_lo[d]) / extent;
+    float end = (fminf(crop_hi[d], hi) - crop_lo[d]) / extent;
+    start = fminf(fmaxf(start, 0.0f), 1.0f);
+    end = fminf(fmaxf(end, 0.0f), 1.0f);
+    out[d] = start;
+    out[d + 2] = ltrb ? end : end - start;
+  }
+}
+
+/**
+ * @brief Transforms the boxes of the sample `blockIdx.y`
+ */
+template <bool ltrb>
+__global__ void BBoxTransformKernel(const BBoxTransformSampleDesc *samples) {
+  const auto &sample = samples[blockIdx.y];
+  for (int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       idx < sample.num_boxes; idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    float box[4], flipped[4];
+    for (int k = 0; k < 4; k++)
+      box[k] = sample.input[4 * idx + k];
+    if (sample.crop)
+      CropBox<ltrb>(box, box, sample.crop_lo, sample.crop_hi);
+    FlipBox<ltrb>(flipped, box, sample.horz, sample.vert);
+    PasteBox<ltrb>(&sample.output[4 * idx], flipped, sample.paste);
+  }
+}
+
+class BBoxTransformGPU : public Operator<GPUBackend> {
+ public:
+  explicit BBoxTransformGPU(const OpSpec &spec)
+      : Operator<GPUBackend>(spec),
+        ltrb_(spec.GetArgument<bool>("ltrb")),
+        crop_anchor_("crop_anchor", spec),
+        crop_shape_("crop_shape", spec),
+        horz_("horizontal", spec),
+        vert_("vertical", spec),
+        paste_ratio_("paste_ratio", spec),
+        paste_x_("paste_x", spec),
+        paste_y_("paste_y", spec) {}
+
+ protected:
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
+  bool SetupImpl(std::vector<OutputDesc> &output_descs, const DeviceWorkspace &ws) override {
+    const auto &input = ws.Input<GPUBackend>(0);
+    DALI_ENFORCE(input.type() == DALI_FLOAT,
+                 make_string("Expected input data as float; got ", input.type()));
+    const auto &shape = input.shape();
+    int nsamples = shape.num_samples();
+    for (int i = 0; i < nsamples; i++) {
+      auto sample_shape = shape[i];
+      int dim = sample_shape.sample_dim();
+      DALI_ENFORCE(dim < 2 || sample_shape[dim - 1] == 4,
+                   "If bounding box tensor is >= 2D, innermost dimension must be 4");
+      DALI_ENFORCE(volume(sample_shape) % 4 == 0, make_string(
+          "Bounding box tensor size must be a multiple of 4. Got: ", volume(sample_shape)));
+    }
+    if (crop_shape_.HasExplicitValue()) {
+      crop_shape_.Acquire(spec_, ws, nsamples, TensorShape<1>{2});
+      if (crop_anchor_.HasExplicitValue())
+        crop_anchor_.Acquire(spec_, ws, nsamples, TensorShape<1>{2});
+    } else {
+      DALI_ENFORCE(!crop_anchor_.HasExplicitValue(),
+                   "``crop_anchor`` cannot be used without ``crop_shape``.");
+    }
+    horz_.Acquire(spec_, ws, nsamples, TensorShape<0>{});
+    vert_.Acquire(spec_, ws, nsamples, TensorShape<0>{});
+    paste_ratio_.Acquire(spec_, ws, nsamples, TensorShape<0>{});
+    paste_x_.Acquire(spec_, ws, nsamples, TensorShape<0>{});
+    paste_y_.Acquire(spec_, ws, nsamples, TensorShape<0>{});
+
+    output_descs.resize(1);
+    output_descs[0].type = DALI_FLOAT;
+    output_descs[0].shape = shape;
+    return true;
+  }
+
+  void RunImpl(DeviceWorkspace &ws) override {
+    const auto &input = ws.Input<GPUBackend>(0);
+    auto &output = ws.Output<GPUBackend>(0);
+    output.SetLayout(input.GetLayout());
+    int nsamples = input.num_samples();
+
+    samples_.resize(nsamples);
+    int64_t max_boxes = 0;
+    for (int i = 0; i < nsamples; i++) {
+      auto &sample = samples_[i];
+      sample.output = output.mutable_tensor<float>(i);
+      sample.input = input.tensor<float>(i);
+      sample.num_boxes = input.shape().tensor_size(i) / 4;
+      max_boxes = std::max(max_boxes, sample.num_boxes);
+
+      sample.crop = crop_shape_.HasExplicitValue();
+      if (sample.crop) {
+        for (int d = 0; d < 2; d++) {
+          sample.crop_lo[d] = crop_anchor_.HasExplicitValue() ? crop_anchor_[i].data[d] : 0.0f;
+          sample.crop_hi[d] = sample.crop_lo[d] + crop_shape_[i].data[d];
+        }
+      }
+      sample.horz = horz_[i].data[0];
+      sample.vert = vert_[i].data[0];
+      float ratio = paste_ratio_[i].data[0];
+      DALI_ENFORCE(ratio >= 1, make_string(
+          "``paste_ratio`` must be at least 1; got ", ratio, " for sample ", i));
+      sample.paste = GetBBoxPasteParams(ratio, paste_x_[i].data[0], paste_y_[i].data[0]);
+    }
+    if (max_boxes == 0)
+      return;
+
+    auto stream = ws.stream();
+    kernels::DynamicScratchpad scratchpad({}, stream);
+    auto *samples_dev = scratchpad.ToGPU(stream, samples_);
+
+    const int block = 256;
+    dim3 grid(std::min<int64_t>(div_ceil(max_boxes, block), 64), nsamples);
+    if (ltrb_)
+      BBoxTransformKernel<true><<<grid, block, 0, stream>>>(samples_dev);
+    else
+      BBoxTransformKernel<false><<<grid, block, 0, stream>>>(samples_dev);
+    CUDA_CALL(cudaGetLastError());
+  }
+
+ private:
+  const bool ltrb_;
+  ArgValue<float, 1> crop_anchor_;
+  ArgValue<float, 1> crop_shape_;
+  ArgValue<int> horz_;
+  ArgValue<int> vert_;
+  ArgValue<float> paste_ratio_;
+  ArgValue<float> paste_x_;
+  ArgValue<float> paste_y_;
+  std::vector<BBoxTransformSampleDesc> samples_;
+};
+
+DALI_REGISTER_OPERATOR(BBoxTransform, BBoxTransformGPU, GPU);
+
+}  // namespace dali
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "dali/operators/decoder/audio/audio_decoder_impl.h"
+#include <algorithm>
+#include <utility>
+#include "dali/core/small_vector.h"
 #include "dali/kernels/signal/downmixing.h"
 
 namespace dali {
@@ -46,21 +49,91 @@ TensorShape<> DecodedAudioShape(const AudioMetadata &meta, float target_sample_r
   return downmix ? TensorShape<>{len} : TensorShape<>{len, channels};
 }
 
+std::pair<int64_t, int64_t> DecodeAudioScratchSizes(const AudioMetadata &meta,
+                                                    float target_sample_rate, bool downmix,
+                                                    bool preemphasis) {
+  bool should_resample = target_sample_rate > 0 && meta.sample_rate != target_sample_rate;
+  bool should_downmix = meta.channels > 1 && downmix;
+  int64_t decode_scratch_sz = 0, resample_scratch_sz = 0;
+  // the chunks of the decoded signal or, with resampling, of the resampled one
+  if (should_downmix || preemphasis)
+    decode_scratch_sz = std::max<int64_t>(std::min(meta.length, kAudioDecodeChunkFrames), 1) *
+                        meta.channels;
+  if (should_resample)
+    resample_scratch_sz = should_downmix ? meta.length : meta.length * meta.channels;
+  return {decode_scratch_sz, resample_scratch_sz};
+}
+
+namespace {
+
+/**
+ * @brief Applies the preemphasis filter to consecutive chunks of an interleaved signal and
+ *        converts the result to Out
+ */
+class StreamingPreemphasis {
+ public:
+  StreamingPreemphasis(const PreemphasisParams &params, int channels)
+  : params_(params), channels_(channels) {
+    prev_.resize(channels);
+  }
+
+  template <typename Out>
+  void operator()(Out *__restrict__ out, const float *__restrict__ in, int64_t frames) {
+    if (frames <= 0)
+      return;
+    if (first_) {
+      // the border is taken from the first chunk
+      for (int c = 0; c < channels_; c++) {
+        if (params_.border == PreemphasisParams::Border::Zero)
+          prev_[c] = 0;
+        else if (params_.border == PreemphasisParams::Border::Reflect && frames > 1)
+          prev_[c] = in[channels_ + c];
+        else
+          prev_[c] = in[c];
+      }
+      first_ = false;
+    }
+    const float coeff = params_.coeff;
+    const int64_t n = frames * channels_;
+    for (int c = 0; c < channels_; c++)
+      out[c] = ConvertSatNorm<Out>(in[c] - coeff * prev_[c]);
+    if (channels_ == 1) {
+      for (int64_t i = 1; i < n; i++)
+        out[i] = ConvertSatNorm<Out>(in[i] - coeff * in[i - 1]);
+    } else {
+      for (int64_t i = channels_; i < n; i++)
+        out[i] = ConvertSatNorm<Out>(in[i] - coeff * in[i - channels_]);
+    }
+    for (int c = 0; c < channels_; c++)
+      prev_[c] = in[n - channels_ + c];
+  }
+
+ private:
+  PreemphasisParams params_;
+  int channels_;
+  SmallVector<float, 8> prev_;
+  bool first_ = true;
+};
+
+}  // namespace
+
 template <typename T>
 void DecodeAudio(TensorView<StorageCPU, T, DynamicDimensions> audio, AudioDecoderBase &decoder,
                  const AudioMetadata &meta, kernels::signal::resampling::ResamplerCPU &resampler,
                  span<float> decode_scratch_mem,
                  span<float> resample_scratch_mem,
                  float target_sample_rate, bool downmix,
-                 const char *audio_filepath) {  // audio_filepath for debug purposes
+                 const char *audio_filepath,  // audio_filepath for debug purposes
+                 const PreemphasisParams &preemph) {
   assert(meta.sample_rate > 0 && "Invalid sampling rate");
   bool should_resample = target_sample_rate > 0 && meta.sample_rate != target_sample_rate;
   bool should_downmix = meta.channels > 1 && downmix;
+  bool should_filter = preemph.coeff != 0;
   assert(audio.data != nullptr);
   if (volume(audio.shape) <= 0)
     return;
 
-  if (!should_resample && !should_downmix) {
+  if (!should_resample && !should_downmix && !should_filter) {
     assert(audio.shape[0] <= meta.length && "Requested to decode more data than available.");
     assert(meta.channels == (audio.shape.size() == 1 ? 1 : audio.shape[1]) &&
            "Number of channels should match the metadata.");
@@ -71,36 +144,72 @@ void DecodeAudio(TensorView<StorageCPU, T, DynamicDimensions> audio, AudioDecode
     return;
   }
 
-  assert(decode_scratch_mem.size() > 0 &&
-         "Dowmixing or resampling is required but decoder scratch memory is empty.");
-  assert(decode_scratch_mem.size() % meta.channels == 0 &&
-         "Expected to decode full audio frames only.");
-  assert(decode_scratch_mem.size() <= meta.length * meta.channels &&
-         "Requested to decode more data than available.");
-  int64_t decoded_audio_len = decode_scratch_mem.size() / meta.channels;
-  if (should_resample && should_downmix) {
-    // When downmixing, we need an extra buffer for the input of resampling
-    assert(resample_scratch_mem.size() == decoded_audio_len &&
-           "Downmixing and resampling is required but resampler scratch is either empty or doesn't "
-           "have the expected size");
+  int out_channels = should_downmix ? 1 : meta.channels;
+  int64_t out_length = audio.shape[0];
+  StreamingPreemphasis filter(preemph, out_channels);
+  // decodes the next n frames, with interleaved channels
+  auto decode_chunk = [&](float *chunk, int64_t n) {
+    int64_t ret = decoder.DecodeFrames(chunk, n);
+    DALI_ENFORCE(ret == n, make_string("Error decoding audio file ", audio_filepath));
+  };
+
+  if (!should_resample) {
+    assert(out_length <= meta.length && "Requested to decode more data than available.");
+    assert(decode_scratch_mem.size() >= meta.channels &&
+           "Downmixing or preemphasis is required but decoder scratch memory is too small.");
+    int64_t chunk_frames = decode_scratch_mem.size() / meta.channels;
+    float *chunk = decode_scratch_mem.data();
+    for (int64_t pos = 0; pos < out_length; pos += chunk_frames) {
+      int64_t n = std::min(chunk_frames, out_length - pos);
+      decode_chunk(chunk, n);
+      T *out = audio.data + pos * out_channels;
+      if (!should_filter) {
+        kernels::signal::Downmix(out, chunk, n, meta.channels);
+        continue;
+      }
+      if (should_downmix)
+        kernels::signal::Downmix(chunk, chunk, n, meta.channels);  // in place
+      filter(out, chunk, n);
+    }
+    return;
   }
 
-  int64_t ret = decoder.DecodeFrames(decode_scratch_mem.data(), decoded_audio_len);
-  DALI_ENFORCE(ret == decoded_audio_len, make_string("Error decoding audio file ", audio_filepath));
-
-  if (should_resample && should_downmix) {
-    kernels::signal::Downmix(resample_scratch_mem.data(), decode_scratch_mem.data(),
-                             decoded_audio_len, meta.channels);
-    resampler.Resample(audio.data, 0, audio.shape[0], target_sample_rate,
-                       resample_scratch_mem.data(), decoded_audio_len, meta.sample_rate, 1);
-  } else if (should_resample) {  // No downmix
-    resampler.Resample(audio.data, 0, audio.shape[0], target_sample_rate, decode_scratch_mem.data(),
-                       decoded_audio_len, meta.sample_rate, meta.channels);
-  } else if (should_downmix) {  // downmix only
-    kernels::signal::Downmix(audio.data, decode_scratch_mem.data(), decoded_audio_len,
-                             meta.channels);
+  int64_t in_length = meta.length;
+  assert(resample_scratch_mem.size() == in_length * out_channels &&
+         "Resampling is required but resampler scratch is either empty or doesn't "
+         "have the expected size");
+  float *resample_in = resample_scratch_mem.data();
+  if (should_downmix) {
+    // the input of resampling is downmixed chunk by chunk, as it's decoded
+    assert(decode_scratch_mem.size() >= meta.channels &&
+           "Downmixing is required but decoder scratch memory is too small.");
+    int64_t chunk_frames = decode_scratch_mem.size() / meta.channels;
+    float *chunk = decode_scratch_mem.data();
+    for (int64_t pos = 0; pos < in_length; pos += chunk_frames) {
+      int64_t n = std::min(chunk_frames, in_length - pos);
+      decode_chunk(chunk, n);
+      kernels::signal::Downmix(resample_in + pos, chunk, n, meta.channels);
+    }
   } else {
-    assert(false && "Logic error. This should never happen.");
+    decode_chunk(resample_in, in_length);
+  }
+
+  if (!should_filter) {
+    resampler.Resample(audio.data, 0, out_length, target_sample_rate,
+                       resample_in, in_length, meta.sample_rate, out_channels);
+    return;
+  }
+
+  // the resampled signal is filtered and converted chunk by chunk
+  assert(decode_scratch_mem.size() >= out_channels &&
+         "Preemphasis is required but decoder scratch memory is too small.");
+  int64_t chunk_frames = decode_scratch_mem.size() / out_channels;
+  float *chunk = decode_scratch_mem.data();
+  for (int64_t pos = 0; pos < out_length; pos += chunk_frames) {
+    int64_t n = std::min(chunk_frames, out_length - pos);
+    resampler.Resample(chunk, pos, pos + n, target_sample_rate,
+                       resample_in, in_length, meta.sample_rate, out_channels);
+    filter(audio.data + pos * out_channels, chunk, n);
   }
 }
 
@@ -109,7 +218,8 @@ void DecodeAudio(TensorView<StorageCPU, T, DynamicDimensions> audio, AudioDecode
       TensorView<StorageCPU, OutType, DynamicDimensions> audio, AudioDecoderBase & decoder,       \
       const AudioMetadata &meta, kernels::signal::resampling::ResamplerCPU &resampler,            \
       span<float> decode_scratch_mem, span<float> resample_scratch_mem,                           \
-      float target_sample_rate, bool downmix, const char *audio_filepath);
+      float target_sample_rate, bool downmix, const char *audio_filepath,                         \
+      const PreemphasisParams &preemph);
 
 DECLARE_IMPL(float);
 DECLARE_IMPL(int16_t);
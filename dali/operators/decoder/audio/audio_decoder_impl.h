@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_DECODER_AUDIO_AUDIO_DECODER_IMPL_H_
 #define DALI_OPERATORS_DECODER_AUDIO_AUDIO_DECODER_IMPL_H_
 
+#include <cstdint>
 #include <utility>
 #include "dali/operators/decoder/audio/audio_decoder.h"
 #include "dali/operators/decoder/audio/generic_decoder.h"
@@ -48,14 +49,52 @@ DLL_PUBLIC TensorShape<> DecodedAudioShape(const AudioMetadata &meta, float targ
                                            bool downmix = true);
 
 /**
- * @brief Decodes audio data, with optional downmixing and resampling
+ * @brief Preemphasis filter applied to the decoded audio, after downmixing and resampling
+ *
+ * The filter is ``Y[t] = X[t] - coeff * X[t-1]``, applied to each channel separately.
+ */
+struct PreemphasisParams {
+  enum class Border : uint8_t {
+    Zero = 0,  ///< X[-1] = 0
+    Clamp,     ///< X[-1] = X[0]
+    Reflect,   ///< X[-1] = X[1]
+  };
+
+  /// @brief The filter coefficient; 0 disables the filter
+  float coeff = 0;
+  Border border = Border::Clamp;
+};
+
+/**
+ * @brief The number of frames decoded at a time, when the decoded audio is further processed
+ *
+ * The chunks are small enough to stay in the cache between the steps of the processing.
+ */
+constexpr int64_t kAudioDecodeChunkFrames = 4096;
+
+/**
+ * @brief Returns the sizes of the scratch buffers required by `DecodeAudio`: decode and resample
+ */
+DLL_PUBLIC std::pair<int64_t, int64_t> DecodeAudioScratchSizes(const AudioMetadata &meta,
+                                                               float target_sample_rate,
+                                                               bool downmix,
+                                                               bool preemphasis = false);
+
+/**
+ * @brief Decodes audio data, with optional downmixing, resampling and preemphasis
+ *
+ * The decoded frames are downmixed, filtered and converted in chunks, as they're decoded,
+ * without intermediate buffers for the whole recording. Only the input of the resampling,
+ * if needed, is kept whole.
+ *
  * @param audio Destination buffer. The function will decode as many audio samples as the shape of this argument
  * @param decoder Decoder object.
  * @param meta Audio metadata.
  * @param resampler ResamplerCPU instance used if resampling is required
- * @param decode_scratch_mem Scratch memory used for decoding, when decoding can't be done directly to the output buffer.
- *                           If downmixing or resampling is required, this buffer should have a positive length, representing
- *                           decoded audio length at the original sampling rate: ``length * nchannels``
+ * @param decode_scratch_mem Scratch memory used for the decoded (or resampled) chunks, when decoding can't be done directly
+ *                           to the output buffer. If downmixing or preemphasis is required, this buffer should hold at least
+ *                           one frame, ``nchannels`` samples; the chunk length is the number of frames it can hold.
+ *                           See `DecodeAudioScratchSizes`.
  * @param resample_scratch_mem Scratch memory used for the input of resampling.
  *                             If resampling is required, the buffer should have a positive length, representing the
  *                             decoded audio length, ``length`` if downmixing is enabled, or the decoded audio length including
@@ -64,13 +103,15 @@ DLL_PUBLIC TensorShape<> DecodedAudioShape(const AudioMetadata &meta, float targ
  *                           is equal to the target.
  * @param downmix If true, the audio channes will be downmixed to a single one
  * @param audio_filepath Path to the audio file being decoded, only used for debugging purposes
+ * @param preemph Preemphasis filter, applied to the decoded (and resampled) signal
  */
 template <typename T>
 DLL_PUBLIC void DecodeAudio(TensorView<StorageCPU, T, DynamicDimensions> audio,
                             AudioDecoderBase &decoder, const AudioMetadata &meta,
                             kernels::signal::resampling::ResamplerCPU &resampler,
                             span<float> decode_scratch_mem, span<float> resample_scratch_mem,
-                            float target_sample_rate, bool downmix, const char *audio_filepath);
+                            float target_sample_rate, bool downmix, const char *audio_filepath,
+                            const PreemphasisParams &preemph = {});
 
 }  // namespace dali
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,7 +13,13 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <string>
 #include <utility>
+#include <vector>
+#include "dali/core/convert.h"
+#include "dali/kernels/signal/downmixing.h"
+#include "dali/operators/audio/resampling_params.h"
 #include "dali/operators/decoder/audio/audio_decoder_impl.h"
 
 namespace dali {
@@ -52,5 +58,147 @@ TEST(AudioDecoderImpl, ProcessOffsetAndLength) {
   }
 }
 
+namespace {
+
+/**
+ * @brief Decodes frames from a buffer with interleaved channels
+ */
+class TestAudioDecoder : public AudioDecoderBase {
+ public:
+  TestAudioDecoder(std::vector<float> data, int channels)
+  : data_(std::move(data)), channels_(channels) {}
+
+ private:
+  int64_t SeekFramesImpl(int64_t nframes, int whence) override {
+    pos_ = (whence == SEEK_SET ? 0 : pos_) + nframes;
+    return pos_;
+  }
+
+  ptrdiff_t DecodeImpl(span<float> output) override { return 0; }
+  ptrdiff_t DecodeImpl(span<int16_t> output) override { return 0; }
+  ptrdiff_t DecodeImpl(span<int32_t> output) override { return 0; }
+
+  template <typename T>
+  ptrdiff_t Decode(T *output, int64_t nframes) {
+    nframes = std::min<int64_t>(nframes, data_.size() / channels_ - pos_);
+    for (int64_t i = 0; i < nframes * channels_; i++)
+      output[i] = ConvertSatNorm<T>(data_[pos_ * channels_ + i]);
+    pos_ += nframes;
+    return nframes;
+  }
+
+  ptrdiff_t DecodeFramesImpl(float *output, int64_t nframes) override {
+    return Decode(output, nframes);
+  }
+  ptrdiff_t DecodeFramesImpl(int16_t *output, int64_t nframes) override {
+    return Decode(output, nframes);
+  }
+  ptrdiff_t DecodeFramesImpl(int32_t *output, int64_t nframes) override {
+    return Decode(output, nframes);
+  }
+
+  AudioMetadata OpenImpl(span<const char>) override { return {}; }
+  AudioMetadata OpenFromFileImpl(const std::string &) override { return {}; }
+  void CloseImpl() override {}
+
+  std::vector<float> data_;
+  int channels_;
+  int64_t pos_ = 0;
+};
+
+/**
+ * @brief Preemphasis of an interleaved signal, applied to each channel
+ */
+void ReferencePreemphasis(std::vector<float> &signal, int channels,
+                          const PreemphasisParams &params) {
+  int64_t frames = signal.size() / channels;
+  for (int c = 0; c < channels; c++) {
+    float border = params.border == PreemphasisParams::Border::Zero ? 0.0f
+                 : params.border == PreemphasisParams::Border::Reflect ? signal[channels + c]
+                 : signal[c];
+    for (int64_t t = frames - 1; t >= 0; t--) {
+      float prev = t > 0 ? signal[(t - 1) * channels + c] : border;
+      signal[t * channels + c] -= params.coeff * prev;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(AudioDecoderImpl, DecodeFusedProcessing) {
+  const int channels = 2;
+  const int64_t length = 10007;
+  const int sample_rate = 16000;
+  std::vector<float> data(length * channels);
+  for (int64_t t = 0; t < length; t++) {
+    for (int c = 0; c < channels; c++)
+      data[t * channels + c] = 0.5f * std::sin(0.01f * (c + 1) * t) + 0.1f * std::cos(0.3f * t);
+  }
+  kernels::signal::resampling::ResamplerCPU resampler;
+  auto params = audio::ResamplingParams::FromQuality(50);
+  resampler.Initialize(params.lobes, params.lookup_size);
+
+  PreemphasisParams::Border borders[] = {
+    PreemphasisParams::Border::Zero,
+    PreemphasisParams::Border::Clamp,
+    PreemphasisParams::Border::Reflect
+  };
+  for (float target_rate : {-1.0f, 12345.0f}) {
+    for (bool downmix : {false, true}) {
+      for (auto border : borders) {
+        for (int64_t chunk_frames : {int64_t(7), kAudioDecodeChunkFrames}) {
+          AudioMetadata meta{length, sample_rate, channels};
+          PreemphasisParams preemph{0.97f, border};
+          int out_channels = downmix ? 1 : channels;
+
+          // reference: downmixing, resampling and preemphasis of the whole signal
+          std::vector<float> ref = data;
+          if (downmix) {
+            kernels::signal::Downmix(ref.data(), data.data(), length, channels);
+            ref.resize(length);
+          }
+          auto shape = DecodedAudioShape(meta, target_rate, downmix);
+          int64_t out_length = shape[0];
+          if (target_rate > 0) {
+            std::vector<float> resampled(out_length * out_channels);
+            resampler.Resample(resampled.data(), 0, out_length, target_rate, ref.data(), length,
+                               sample_rate, out_channels);
+            ref = std::move(resampled);
+          }
+          ReferencePreemphasis(ref, out_channels, preemph);
+
+          int64_t decode_scratch_sz, resample_scratch_sz;
+          std::tie(decode_scratch_sz, resample_scratch_sz) =
+              DecodeAudioScratchSizes(meta, target_rate, downmix, true);
+          EXPECT_EQ(decode_scratch_sz, kAudioDecodeChunkFrames * channels);
+          decode_scratch_sz = chunk_frames * channels;
+          std::vector<float> decode_scratch(decode_scratch_sz);
+          std::vector<float> resample_scratch(resample_scratch_sz);
+
+          std::vector<float> out(volume(shape));
+          std::vector<int16_t> out_int(volume(shape));
+          for (bool to_int : {false, true}) {
+            TestAudioDecoder decoder(data, channels);
+            if (to_int) {
+              DecodeAudio(TensorView<StorageCPU, int16_t>(out_int.data(), shape), decoder, meta,
+                          resampler, make_span(decode_scratch), make_span(resample_scratch),
+                          target_rate, downmix, "test", preemph);
+            } else {
+              DecodeAudio(TensorView<StorageCPU, float>(out.data(), shape), decoder, meta,
+                          resampler, make_span(decode_scratch), make_span(resample_scratch),
+                          target_rate, downmix, "test", preemph);
+            }
+          }
+          ASSERT_EQ(ref.size(), out.size());
+          for (size_t i = 0; i < ref.size(); i++) {
+            ASSERT_NEAR(out[i], ref[i], 1e-5) << "at " << i;
+            ASSERT_NEAR(out_int[i], ConvertSatNorm<int16_t>(ref[i]), 1) << "at " << i;
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace dali
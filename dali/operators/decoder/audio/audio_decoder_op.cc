@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "dali/operators/decoder/audio/audio_decoder_op.h"
+#include <algorithm>
+#include <tuple>
 #include "dali/operators/decoder/audio/audio_decoder_impl.h"
 #include "dali/pipeline/operator/op_schema.h"
 #include "dali/pipeline/data/views.h"
@@ -46,7 +48,29 @@ Supported types: ``INT16``, ``INT32``, ``FLOAT``.)code", DALI_FLOAT)
 the highest.
 
 0 gives 3 lobes of the sinc filter, 50 gives 16 lobes, and 100 gives 64 lobes.)code",
-          50.0f, false);
+          50.0f, false)
+  .AddOptionalArg("offset", R"code(The start of the decoded window, in seconds.
+
+The decoder seeks to the offset and decodes only the frames in the window, which is much
+cheaper than decoding the whole recording and slicing it, when a short excerpt of a long
+recording is needed. An offset past the end of the recording results in an empty output.)code",
+          0.0f, true)
+  .AddOptionalArg("duration", R"code(The length of the decoded window, in seconds.
+
+If negative, the audio is decoded until its end. The window is limited to the end of
+the recording.)code",
+          -1.0f, true)
+  .AddOptionalArg("preemph_coeff", R"code(Coefficient of the preemphasis filter applied to
+the decoded signal.
+
+The filter, ``Y[t] = X[t] - preemph_coeff * X[t-1]``, is applied after downmixing and resampling,
+to each channel separately, as the signal is decoded - it is equivalent to, but cheaper than,
+a separate :meth:`preemphasis_filter`. 0 disables the filter.)code",
+          0.0f, true)
+  .AddOptionalArg("preemph_border", R"code(Border value policy of the preemphasis filter.
+
+Possible values are \"zero\", \"clamp\", \"reflect\". See :meth:`preemphasis_filter`.)code",
+          "clamp");
 
 
 DALI_REGISTER_OPERATOR(AudioDecoder, AudioDecoderCpu, CPU);
@@ -68,6 +92,9 @@ AudioDecoderCpu::SetupImpl(std::vector<OutputDesc> &output_desc, const workspace
   auto &input = ws.template Input<Backend>(0);
   const auto batch_size = input.shape().num_samples();
   GetPerSampleArgument<float>(target_sample_rates_, "sample_rate", ws, batch_size);
+  GetPerSampleArgument<float>(offsets_sec_, "offset", ws, batch_size);
+  GetPerSampleArgument<float>(durations_sec_, "duration", ws, batch_size);
+  GetPerSampleArgument<float>(preemph_coeffs_, "preemph_coeff", ws, batch_size);
 
   for (int i = 0; i < batch_size; i++) {
     DALI_ENFORCE(input.shape()[i].size() == 1, "Raw input must be 1D encoded byte data");
@@ -75,6 +102,7 @@ AudioDecoderCpu::SetupImpl(std::vector<OutputDesc> &output_desc, const workspace
   DALI_ENFORCE(IsType<uint8_t>(input.type()), "Raw files must be stored as uint8 data.");
   decoders_.resize(batch_size);
   sample_meta_.resize(batch_size);
+  sample_offsets_.resize(batch_size);
   files_names_.resize(batch_size);
 
   decode_type_ = use_resampling_ ? DALI_FLOAT : output_type_;
@@ -90,6 +118,13 @@ AudioDecoderCpu::SetupImpl(std::vector<OutputDesc> &output_desc, const workspace
     auto &meta = sample_meta_[i] =
         decoders_[i]->Open({static_cast<const char *>(input.raw_tensor(i)),
                             input.tensor_shape(i).num_elements()});
+    DALI_ENFORCE(offsets_sec_[i] >= 0,
+                 make_string("The offset must not be negative, got ", offsets_sec_[i]));
+    int64_t length;
+    std::tie(sample_offsets_[i], length) =
+        ProcessOffsetAndLength(meta, offsets_sec_[i], durations_sec_[i]);
+    // only the window is decoded
+    meta.length = std::max<int64_t>(length, 0);
     TensorShape<> data_sample_shape = DecodedAudioShape(
         meta, use_resampling_ ? target_sample_rates_[i] : -1.0f, downmix_);
     shape_data.set_tensor_shape(i, data_sample_shape);
@@ -108,18 +143,10 @@ AudioDecoderCpu::DecodeSample(const TensorView<StorageCPU, OutputType, DynamicDi
                               int thread_idx, int sample_idx) {
   auto &meta = sample_meta_[sample_idx];
   float target_sr = use_resampling_ ? target_sample_rates_[sample_idx] : meta.sample_rate;
-  bool should_resample = target_sr != meta.sample_rate;
-  bool should_downmix = meta.channels > 1 && downmix_;
-  int64_t decode_scratch_sz = 0;
-  int64_t resample_scratch_sz = 0;
-  if (should_resample || should_downmix)
-    decode_scratch_sz = meta.length * meta.channels;
-
-  // resample scratch is used to prepare a single or multiple (depending if
-  // downmixing is needed) channel float input, required by the resampling
-  // kernel
-  if (should_resample)
-    resample_scratch_sz = should_downmix ? meta.length : meta.length * meta.channels;
+  PreemphasisParams preemph{preemph_coeffs_[sample_idx], preemph_border_};
+  int64_t decode_scratch_sz, resample_scratch_sz;
+  std::tie(decode_scratch_sz, resample_scratch_sz) =
+      DecodeAudioScratchSizes(meta, target_sr, downmix_, preemph.coeff != 0);
 
   auto &scratch_decoder = scratch_decoder_[thread_idx];
   scratch_decoder.resize(decode_scratch_sz);
@@ -127,14 +154,18 @@ AudioDecoderCpu::DecodeSample(const TensorView<StorageCPU, OutputType, DynamicDi
   auto &scratch_resampler = scratch_resampler_[thread_idx];
   scratch_resampler.resize(resample_scratch_sz);
 
-  // TODO(janton): handle offset and duration
+  if (sample_offsets_[sample_idx] > 0 && meta.length > 0) {
+    auto pos = decoders_[sample_idx]->SeekFrames(sample_offsets_[sample_idx], SEEK_SET);
+    DALI_ENFORCE(pos == sample_offsets_[sample_idx],
+                 make_string("Could not seek to the frame ", sample_offsets_[sample_idx]));
+  }
 
   DecodeAudio<OutputType>(
     audio, *decoders_[sample_idx], meta, resampler_,
     {scratch_decoder.data(), decode_scratch_sz},
     {scratch_resampler.data(), resample_scratch_sz},
     target_sr, downmix_,
-    files_names_[sample_idx].c_str());
+    files_names_[sample_idx].c_str(), preemph);
 }
 
 template <typename OutputType>
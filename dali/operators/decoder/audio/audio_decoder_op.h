@@ -20,6 +20,7 @@
 #include <vector>
 #include "dali/core/static_switch.h"
 #include "dali/operators/decoder/audio/audio_decoder.h"
+#include "dali/operators/decoder/audio/audio_decoder_impl.h"
 #include "dali/operators/decoder/audio/generic_decoder.h"
 #include "dali/operators/audio/resampling_params.h"
 #include "dali/pipeline/data/backend.h"
@@ -50,6 +51,16 @@ class AudioDecoderCpu : public Operator<CPUBackend> {
       auto params = audio::ResamplingParams::FromQuality(q);
       resampler_.Initialize(params.lobes, params.lookup_size);
     }
+    auto border = spec.GetArgument<std::string>("preemph_border");
+    if (border == "zero") {
+      preemph_border_ = PreemphasisParams::Border::Zero;
+    } else if (border == "reflect") {
+      preemph_border_ = PreemphasisParams::Border::Reflect;
+    } else if (border == "clamp") {
+      preemph_border_ = PreemphasisParams::Border::Clamp;
+    } else {
+      DALI_FAIL(make_string("``preemph_border`` mode \"", border, "\" is not supported."));
+    }
   }
 
   inline ~AudioDecoderCpu() override = default;
@@ -83,12 +94,17 @@ class AudioDecoderCpu : public Operator<CPUBackend> {
   }
 
   std::vector<float> target_sample_rates_;
+  std::vector<float> offsets_sec_, durations_sec_;
+  std::vector<float> preemph_coeffs_;
+  PreemphasisParams::Border preemph_border_ = PreemphasisParams::Border::Clamp;
   kernels::signal::resampling::ResamplerCPU resampler_;
   DALIDataType output_type_ = DALI_NO_TYPE, decode_type_ = DALI_NO_TYPE;
   const bool downmix_ = false, use_resampling_ = false;
   const float quality_ = 50.0f;
   std::vector<std::string> files_names_;
   std::vector<AudioMetadata> sample_meta_;
+  // the first decoded frame of each sample
+  std::vector<int64_t> sample_offsets_;
   std::vector<vector<float>> scratch_decoder_;
   std::vector<vector<float>> scratch_resampler_;
   std::vector<std::unique_ptr<AudioDecoderBase>> decoders_;
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -35,13 +35,18 @@ CachedDecoderImpl::CachedDecoderImpl(const OpSpec& spec)
     if (cache_size > 0 && cache_size >= cache_threshold) {
       const std::string cache_type = spec.GetArgument<std::string>("cache_type");
       const bool cache_debug = spec.GetArgument<bool>("cache_debug");
+      const std::size_t host_cache_size =
+          static_cast<std::size_t>(spec.GetArgument<int>("cache_host_size")) * 1024 * 1024;
+      const std::string shared_name = spec.GetArgument<std::string>("cache_shared_name");
       cache_ = ImageCacheFactory::Instance().Get(
-        device_id_, cache_type, cache_size, cache_debug, cache_threshold);
+        device_id_, cache_type, cache_size, cache_debug, cache_threshold, host_cache_size,
+        shared_name);
 
       use_batch_copy_kernel_ = spec.GetArgument<bool>("cache_batch_copy");
       auto batch_size = spec.GetArgument<int>("max_batch_size");
       const size_t kMaxSizePerBlock = 1<<18;  // 256 kB per block
       scatter_gather_.reset(new kernels::ScatterGatherGPU(kMaxSizePerBlock));
+      host_scatter_gather_.reset(new kernels::ScatterGatherGPU(kMaxSizePerBlock));
     }
   }
 }
@@ -61,7 +66,10 @@ bool CachedDecoderImpl::DeferCacheLoad(const std::string& file_name, uint8_t *ou
   auto img = cache_->Get(file_name);
   if (!img.data)
     return false;
-  scatter_gather_->AddCopy(output_data, img.data, img.num_elements());
+  if (cache_->IsHostData(img.data))
+    host_scatter_gather_->AddCopy(output_data, img.data, img.num_elements());
+  else
+    scatter_gather_->AddCopy(output_data, img.data, img.num_elements());
   return true;
 }
 
@@ -74,6 +82,9 @@ void CachedDecoderImpl::LoadDeferred(cudaStream_t stream) {
   auto copy_method = use_batch_copy_kernel_ ? Method::Default
                                             : Method::Memcpy;
   CUDA_CALL((scatter_gather_->Run(stream, true, copy_method), cudaGetLastError()));
+  // the adjacent ranges are coalesced, so the images stored together are copied at once
+  host_scatter_gather_->Run(stream, true, Method::Memcpy, cudaMemcpyHostToDevice);
+  cache_->SyncAfterRead(stream);
 }
 
 ImageCache::ImageShape CachedDecoderImpl::CacheImageShape(const std::string& file_name) {
@@ -81,6 +92,16 @@ ImageCache::ImageShape CachedDecoderImpl::CacheImageShape(const std::string& fil
     cache_->GetShape(file_name) : ImageCache::ImageShape{};
 }
 
+void CachedDecoderImpl::CacheImageShapes(span<const std::string> file_names,
+                                         span<ImageCache::ImageShape> shapes) {
+  if (cache_) {
+    cache_->GetShapes(file_names, shapes);
+  } else {
+    for (auto &shape : shapes)
+      shape = {};
+  }
+}
+
 void CachedDecoderImpl::CacheStore(const std::string& file_name, const uint8_t *data,
                                    const ImageCache::ImageShape& data_shape,
                                    cudaStream_t stream) {
@@ -117,6 +138,21 @@ If set to True, multiple images from the cache are copied with a batched copy ke
 Otherwise, unless the order in the batch is the same as in the cache, each image is
 copied with ``cudaMemcpy``.)code",
       true)
+  .AddOptionalArg("cache_host_size",
+      R"code(Applies **only** to the ``mixed`` backend type and the ``lru`` cache type.
+
+The size, in megabytes, of the second tier of the decoder cache, in pinned host memory. The images
+evicted from the GPU cache are moved there and they are copied from the host when accessed again,
+which is still faster than decoding them.
+)code",
+      0)
+  .AddOptionalArg("cache_shared_name",
+      R"code(Applies **only** to the ``mixed`` backend type and the ``shared`` cache type.
+
+The name of the shared memory segment holding the cache. The processes using the same name share
+the cache, so it should be unique for the dataset and the decoding parameters.
+)code",
+      std::string())
   .AddOptionalArg("cache_type",
       R"code(Applies **only** to the ``mixed`` backend type.
 
@@ -128,6 +164,15 @@ Here is a list of the available cache types:
   The warm-up time for threshold policy is 1 epoch.
 * | ``largest``: stores the largest images that can fit in the cache.
   | The warm-up time for largest policy is 2 epochs
+* | ``lru``: caches every image with a size that is larger than ``cache_threshold`` and, when
+  | the cache is full, evicts the least recently used images to make room for the new ones.
+  | Suitable for the datasets which don't fit in the cache. The images larger than 16 MB are
+  | not cached. With ``cache_debug``, the hit rate is printed when the cache is destroyed.
+  | Can be extended with a host memory tier - see ``cache_host_size``.
+* | ``shared``: like ``threshold``, but the cache is kept in host memory shared by all the
+  | processes on the node which use the same ``cache_shared_name`` - e.g. the data-parallel
+  | ranks - so that each image is decoded once per node rather than once per process.
+  | ``cache_size`` has to be the same in all the processes.
 
   .. note::
     To take advantage of caching, it is recommended to configure readers with `stick_to_shard=True`
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -18,6 +18,7 @@
 #include <cuda_runtime_api.h>
 #include <memory>
 #include <string>
+#include "dali/core/span.h"
 #include "dali/operators/decoder/cache/image_cache.h"
 #include "dali/pipeline/operator/op_spec.h"
 
@@ -51,6 +52,13 @@ class CachedDecoderImpl {
   ImageCache::ImageShape CacheImageShape(
     const std::string& file_name);
 
+  /**
+   * @brief Looks up the whole batch at once; the shapes of the images not cached are empty
+   */
+  void CacheImageShapes(
+    span<const std::string> file_names,
+    span<ImageCache::ImageShape> shapes);
+
   bool IsCacheEnabled() const noexcept { return cache_ != nullptr; }
 
  protected:
@@ -59,6 +67,8 @@ class CachedDecoderImpl {
  private:
   std::shared_ptr<ImageCache> cache_;
   std::unique_ptr<kernels::ScatterGatherGPU> scatter_gather_;
+  // the copies from the host tier of the cache
+  std::unique_ptr<kernels::ScatterGatherGPU> host_scatter_gather_;
   int device_id_;
   bool use_batch_copy_kernel_ = true;
 };
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,8 +16,10 @@
 #define DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_H_
 
 #include <cuda_runtime.h>
+#include <cassert>
 #include <string>
 #include "dali/core/api_helper.h"
+#include "dali/core/span.h"
 #include "dali/core/tensor_shape.h"
 #include "dali/core/tensor_view.h"
 
@@ -43,6 +45,17 @@ class DLL_PUBLIC ImageCache {
    */
   DLL_PUBLIC virtual const ImageShape& GetShape(const ImageKey& image_key) const = 0;
 
+  /**
+   * @brief Get the dimensions of a batch of images
+   * @param shapes the output; the shapes of the images which are not cached are empty
+   */
+  DLL_PUBLIC virtual void GetShapes(span<const ImageKey> image_keys,
+                                    span<ImageShape> shapes) const {
+    assert(image_keys.size() == shapes.size());
+    for (int64_t i = 0; i < image_keys.size(); i++)
+      shapes[i] = IsCached(image_keys[i]) ? GetShape(image_keys[i]) : ImageShape{};
+  }
+
     /**
      * @brief Try to read from cache
      * @param image_key key representing the image in cache
@@ -72,8 +85,8 @@ class DLL_PUBLIC ImageCache {
    * @brief Get a cache entry describing an image
    * @param image_key key of the cached image
    * @return Pointer and shape of the cached image; if not found, data is null
-   * @remarks This function is valid only if the implementation doesn't evict
-   *          images from the cache.
+   * @remarks If the implementation evicts images from the cache, the data is valid only until
+   *          the next call to Add. The data may reside in host memory - see IsHostData.
    */
   DLL_PUBLIC virtual DecodedImage Get(const ImageKey &image_key) const = 0;
 
@@ -84,6 +97,18 @@ class DLL_PUBLIC ImageCache {
    *          Read/Add calls are already synchronized and don't require using this API
    */
   DLL_PUBLIC virtual void SyncToRead(cudaStream_t stream) const = 0;
+
+  /**
+   * @brief Marks the end of the copies from the cache launched so far in the provided stream
+   * @remarks To be called after launching a memory copy from a pointer provided by Get, so that
+   *          the implementations which evict images don't overwrite the data still being read.
+   */
+  DLL_PUBLIC virtual void SyncAfterRead(cudaStream_t stream) const {}
+
+  /**
+   * @brief Tells whether the pointer provided by Get points to (pinned) host memory
+   */
+  DLL_PUBLIC virtual bool IsHostData(const uint8_t *data) const { return false; }
 };
 
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,12 +13,16 @@
 // limitations under the License.
 
 #include "dali/operators/decoder/cache/image_cache_blob.h"
+#include <algorithm>
 #include <fstream>
 #include <mutex>
+#include <utility>
 #include <unordered_map>
 #include "dali/core/error_handling.h"
 #include "dali/core/span.h"
 #include "dali/core/mm/memory.h"
+#include "dali/core/small_vector.h"
+#include "dali/kernels/common/fast_hash.h"
 #include "dali/pipeline/data/backend.h"
 
 namespace dali {
@@ -51,16 +55,55 @@ ImageCacheBlob::~ImageCacheBlob() {
   if (stats_enabled_ && images_seen() > 0) print_stats();
 }
 
+ImageCacheBlob::KeyHash ImageCacheBlob::HashKey(const ImageKey& image_key) {
+  kernels::fast_hash_t h = {};
+  kernels::fast_hash(h, image_key.data(), image_key.size());
+  return { (static_cast<uint64_t>(h.data[1]) << 32) | h.data[0],
+           static_cast<int>(h.data[2] % kNumShards) };
+}
+
+const ImageCacheBlob::Entry* ImageCacheBlob::Find(const KeyHash& key_hash,
+                                                  const ImageKey& image_key) const {
+  auto &entries = shards_[key_hash.shard].entries;
+  const auto it = entries.find(key_hash.hash);
+  return it != entries.end() && it->second.key == image_key ? &it->second : nullptr;
+}
+
 bool ImageCacheBlob::IsCached(const ImageKey& image_key) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return cache_.find(image_key) != cache_.end();
+  auto key_hash = HashKey(image_key);
+  std::lock_guard<std::mutex> lock(shards_[key_hash.shard].mutex);
+  return Find(key_hash, image_key) != nullptr;
 }
 
 const ImageCache::ImageShape& ImageCacheBlob::GetShape(const ImageKey& image_key) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  const auto it = cache_.find(image_key);
-  DALI_ENFORCE(it != cache_.end(), "cache entry [" + image_key + "] not found");
-  return it->second.shape;
+  auto key_hash = HashKey(image_key);
+  std::lock_guard<std::mutex> lock(shards_[key_hash.shard].mutex);
+  const auto *entry = Find(key_hash, image_key);
+  DALI_ENFORCE(entry != nullptr, "cache entry [" + image_key + "] not found");
+  return entry->image.shape;
+}
+
+void ImageCacheBlob::GetShapes(span<const ImageKey> image_keys, span<ImageShape> shapes) const {
+  assert(image_keys.size() == shapes.size());
+  SmallVector<std::pair<int, KeyHash>, 256> lookups;  // sorted by the shard
+  for (int i = 0; i < image_keys.size(); i++) {
+    shapes[i] = {};
+    if (!image_keys[i].empty())
+      lookups.push_back({ i, HashKey(image_keys[i]) });
+  }
+  std::sort(lookups.begin(), lookups.end(), [](const auto &a, const auto &b) {
+    return a.second.shard < b.second.shard;
+  });
+  for (int begin = 0, end = 0; begin < static_cast<int>(lookups.size()); begin = end) {
+    int shard = lookups[begin].second.shard;
+    std::lock_guard<std::mutex> lock(shards_[shard].mutex);
+    for (end = begin; end < static_cast<int>(lookups.size()) &&
+                      lookups[end].second.shard == shard; end++) {
+      int i = lookups[end].first;
+      if (const auto *entry = Find(lookups[end].second, image_keys[i]))
+        shapes[i] = entry->image.shape;
+    }
+  }
 }
 
 bool ImageCacheBlob::Read(const ImageKey& image_key,
@@ -68,70 +111,98 @@ bool ImageCacheBlob::Read(const ImageKey& image_key,
                           cudaStream_t stream) const {
   DALI_ENFORCE(!image_key.empty());
   DALI_ENFORCE(destination_buffer != nullptr);
-  std::lock_guard<std::mutex> lock(mutex_);
   LOG_LINE << "Read: image_key[" << image_key << "]" << std::endl;
-  const auto it = cache_.find(image_key);
-  if (it == cache_.end())
-    return false;
-  const auto& data = it->second;
-  DALI_ENFORCE(data.data < tail_);
+  auto key_hash = HashKey(image_key);
+  DecodedImage data;
+  {
+    std::lock_guard<std::mutex> lock(shards_[key_hash.shard].mutex);
+    const auto *entry = Find(key_hash, image_key);
+    if (!entry)
+      return false;
+    data = entry->image;
+  }
   const auto n = data.num_elements();
-  DALI_ENFORCE(data.data + n <= tail_);
+  DALI_ENFORCE(data.data >= buffer_.get() && data.data + n <= buffer_end_);
 
   SyncToRead(stream);
   MemCopy(destination_buffer, data.data, n, stream);
 
-  if (stats_enabled_) stats_[image_key].reads++;
+  if (stats_enabled_) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_[image_key].reads++;
+  }
   return true;
 }
 
 ImageCache::DecodedImage ImageCacheBlob::Get(const ImageKey& image_key) const {
   DALI_ENFORCE(!image_key.empty());
-  std::lock_guard<std::mutex> lock(mutex_);
   LOG_LINE << "Get: image_key[" << image_key << "]" << std::endl;
-  const auto it = cache_.find(image_key);
-  if (it == cache_.end())
-    return {};
-  if (stats_enabled_) stats_[image_key].reads++;
-  auto ret = it->second;  // make a copy _before_ leaving the mutex
+  auto key_hash = HashKey(image_key);
+  DecodedImage ret;
+  {
+    std::lock_guard<std::mutex> lock(shards_[key_hash.shard].mutex);
+    const auto *entry = Find(key_hash, image_key);
+    if (!entry)
+      return {};
+    ret = entry->image;  // make a copy _before_ leaving the mutex
+  }
+  if (stats_enabled_) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_[image_key].reads++;
+  }
   return ret;
 }
 
 void ImageCacheBlob::Add(const ImageKey& image_key, const uint8_t* data,
                          const ImageShape& data_shape, cudaStream_t stream) {
-  std::lock_guard<std::mutex> lock(mutex_);
-
   const std::size_t data_size = volume(data_shape);
-  if (stats_enabled_) stats_[image_key].decodes++;
+  if (stats_enabled_) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_[image_key].decodes++;
+  }
   if (data_size < image_size_threshold_) return;
   DALI_ENFORCE(!image_key.empty());
 
-  if (cache_.find(image_key) != cache_.end())
-    return;
-
-  if (bytes_left() < data_size) {
-    LOG_LINE << "WARNING: not enough space in cache. Ignore" << std::endl;
-    if (stats_enabled_) is_full = true;
-    return;
+  // the shard stays locked until the image is written, so that it's added only once
+  auto key_hash = HashKey(image_key);
+  auto &shard = shards_[key_hash.shard];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (shard.entries.count(key_hash.hash))
+    return;  // already cached - or a hash collision, in which case the image is not cached
+
+  uint8_t *dst = nullptr;
+  {
+    std::lock_guard<std::mutex> alloc_lock(alloc_mutex_);
+    if (bytes_left() < data_size) {
+      LOG_LINE << "WARNING: not enough space in cache. Ignore" << std::endl;
+      if (stats_enabled_) is_full = true;
+      return;
+    }
+    dst = tail_;
+    tail_ += data_size;
   }
 
-  MemCopy(tail_, data, data_size, stream);
+  MemCopy(dst, data, data_size, stream);
   SyncAfterWrite(stream);
 
-  cache_[image_key] = {tail_, data_shape};
-  tail_ += data_size;
+  shard.entries.emplace(key_hash.hash, Entry{image_key, {dst, data_shape}});
 
-  if (stats_enabled_) stats_[image_key].is_cached = true;
+  if (stats_enabled_) {
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    stats_[image_key].is_cached = true;
+  }
 }
 
 void ImageCacheBlob::SyncToRead(cudaStream_t stream) const {
   // synchronizing with cache instance stream with provided stream
+  std::lock_guard<std::mutex> lock(sync_mutex_);
   CUDA_CALL(cudaEventRecord(cache_read_event_, cache_stream_));
   CUDA_CALL(cudaStreamWaitEvent(stream, cache_read_event_, 0));
 }
 
 void ImageCacheBlob::SyncAfterWrite(cudaStream_t stream) const {
   // synchronizing with cache instance stream with provided stream
+  std::lock_guard<std::mutex> lock(sync_mutex_);
   CUDA_CALL(cudaEventRecord(cache_write_event_, stream));
   CUDA_CALL(cudaStreamWaitEvent(cache_stream_, cache_write_event_, 0));
 }
@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_BLOB_H_
 #define DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_BLOB_H_
 
+#include <atomic>
 #include <fstream>
 #include <mutex>
 #include <unordered_map>
@@ -43,6 +44,11 @@ class DLL_PUBLIC ImageCacheBlob : public ImageCache {
 
     const ImageShape& GetShape(const ImageKey& image_key) const override;
 
+    /**
+     * @remarks Each shard of the index is locked once for the whole batch
+     */
+    void GetShapes(span<const ImageKey> image_keys, span<ImageShape> shapes) const override;
+
     void Add(const ImageKey& image_key,
              const uint8_t *data,
              const ImageShape& data_shape,
@@ -55,6 +61,35 @@ class DLL_PUBLIC ImageCacheBlob : public ImageCache {
  protected:
     void SyncAfterWrite(cudaStream_t stream) const;       // internal impl only
 
+    static constexpr int kNumShards = 64;
+
+    /**
+     * @brief The index is divided into shards, locked separately, to limit the contention
+     *        between the decoding threads
+     *
+     * The entries are keyed by 64-bit hashes of the image keys, but the keys are kept to
+     * detect the collisions - the colliding images are simply not cached.
+     */
+    struct Entry {
+        ImageKey key;
+        DecodedImage image;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, Entry> entries;
+    };
+
+    struct KeyHash {
+        uint64_t hash;
+        int shard;
+    };
+
+    static KeyHash HashKey(const ImageKey& image_key);
+
+    /// @brief Finds the entry in the shard, which must be locked
+    const Entry* Find(const KeyHash& key_hash, const ImageKey& image_key) const;
+
     void print_stats() const;
 
     inline std::size_t images_seen() const {
@@ -74,8 +109,10 @@ class DLL_PUBLIC ImageCacheBlob : public ImageCache {
     uint8_t* buffer_end_ = nullptr;
     uint8_t* tail_ = nullptr;
 
-    std::unordered_map<ImageKey, DecodedImage> cache_;
-    mutable std::mutex mutex_;
+    Shard shards_[kNumShards];
+    std::mutex alloc_mutex_;  // guards the tail_ and is_full
+    // guards the recording of the events, shared by all the threads
+    mutable std::mutex sync_mutex_;
 
     struct Stats {
         std::size_t decodes = 0;
@@ -83,7 +120,8 @@ class DLL_PUBLIC ImageCacheBlob : public ImageCache {
         bool is_cached = false;
     };
     mutable std::unordered_map<ImageKey, Stats> stats_;
-    bool is_full = false;
+    mutable std::mutex stats_mutex_;
+    std::atomic<bool> is_full{false};
     std::size_t total_seen_images_ = 0;
 
     cudaStream_t cache_stream_;
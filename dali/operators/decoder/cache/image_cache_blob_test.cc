@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,8 @@
 #include "dali/operators/decoder/cache/image_cache_blob.h"
 #include <gtest/gtest.h>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace dali {
@@ -87,5 +89,48 @@ TEST_F(ImageCacheBlobTest, AllocateMoreThan2000MB) {
   }
 }
 
+TEST_F(ImageCacheBlobTest, GetShapes) {
+  SetUpImpl(1 << 20);
+  std::vector<ImageCache::ImageKey> keys;
+  for (int i = 0; i < 200; i++) {
+    keys.push_back(std::to_string(i) + ".jpg");
+    if (i % 3 == 0)
+      cache_->Add(keys.back(), &kValue1[0], {i + 1, 1, 1}, 0);
+  }
+  keys.push_back("");
+  std::vector<ImageCache::ImageShape> shapes(keys.size(), {7, 7, 7});
+  cache_->GetShapes(make_cspan(keys), make_span(shapes));
+  for (int i = 0; i < 200; i++) {
+    if (i % 3 == 0)
+      EXPECT_EQ(shapes[i], ImageCache::ImageShape(i + 1, 1, 1)) << i;
+    else
+      EXPECT_EQ(volume(shapes[i]), 0) << i;
+  }
+  EXPECT_EQ(volume(shapes.back()), 0);
+}
+
+TEST_F(ImageCacheBlobTest, ConcurrentAccess) {
+  const int kThreads = 8, kImages = 100;
+  // fits each image exactly once
+  SetUpImpl(kImages * kValue1.size());
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t]() {
+      // all the threads add the same images, in a different order
+      std::vector<uint8_t> cached_data(kValue1.size());
+      for (int j = 0; j < kImages; j++) {
+        auto key = std::to_string((j * 7 + t * 13) % kImages) + "_key";
+        cache_->Add(key, &kValue1[0], kShape1, 0);
+        EXPECT_TRUE(cache_->IsCached(key));
+        EXPECT_TRUE(cache_->Read(key, &cached_data[0], 0));
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  for (int j = 0; j < kImages; j++)
+    EXPECT_EQ(cache_->GetShape(std::to_string(j) + "_key"), kShape1);
+}
+
 }  // namespace testing
 }  // namespace dali
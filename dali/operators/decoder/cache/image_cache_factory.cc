@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,8 @@
 #include <memory>
 #include "dali/operators/decoder/cache/image_cache_blob.h"
 #include "dali/operators/decoder/cache/image_cache_largest.h"
+#include "dali/operators/decoder/cache/image_cache_lru.h"
+#include "dali/operators/decoder/cache/image_cache_shared.h"
 
 namespace dali {
 
@@ -23,16 +25,27 @@ std::shared_ptr<ImageCache> ImageCacheFactory::Get(int device_id,
                                                    const std::string& cache_policy,
                                                    std::size_t cache_size,
                                                    bool cache_debug,
-                                                   std::size_t cache_threshold) {
+                                                   std::size_t cache_threshold,
+                                                   std::size_t host_cache_size,
+                                                   const std::string& shared_name) {
   std::lock_guard<std::mutex> lock(mutex_);
-  const CacheParams params{cache_policy, cache_size, cache_debug, cache_threshold};
+  const CacheParams params{cache_policy, cache_size, cache_debug, cache_threshold,
+                           host_cache_size, shared_name};
   auto &instance = caches_[device_id];
   auto cache = instance.cache.lock();
   if (!cache) {
+    DALI_ENFORCE(host_cache_size == 0 || cache_policy == "lru",
+                 "Only the `lru` cache policy supports a host memory tier");
+    DALI_ENFORCE(shared_name.empty() == (cache_policy != "shared"),
+                 "The name is required by, and only by, the `shared` cache policy");
     if (cache_policy == "threshold") {
       cache.reset(new ImageCacheBlob(cache_size, cache_threshold, cache_debug));
     } else if (cache_policy == "largest") {
       cache.reset(new ImageCacheLargest(cache_size, cache_debug));
+    } else if (cache_policy == "lru") {
+      cache.reset(new ImageCacheLRU(cache_size, cache_threshold, cache_debug, host_cache_size));
+    } else if (cache_policy == "shared") {
+      cache.reset(new ImageCacheShared(shared_name, cache_size, cache_threshold, cache_debug));
     } else {
       DALI_FAIL("unexpected cache policy `" + cache_policy + "`");
     }
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -36,13 +36,18 @@ class DLL_PUBLIC ImageCacheFactory {
    * are the same.
    * Will fail if the cache was already allocated but with different
    * parameters
+   * @param host_cache_size size of the host memory tier, supported only by the `lru` policy
+   * @param shared_name name of the cache shared between the processes, required by (and only
+   *                    by) the `shared` policy
    */
   DLL_PUBLIC std::shared_ptr<ImageCache> Get(
     int device_id,
     const std::string& cache_policy,
     std::size_t cache_size,
     bool cache_debug = false,
-    std::size_t cache_threshold = 0);
+    std::size_t cache_threshold = 0,
+    std::size_t host_cache_size = 0,
+    const std::string& shared_name = "");
 
   /**
    * @brief Get the already allocated cache
@@ -65,12 +70,16 @@ class DLL_PUBLIC ImageCacheFactory {
     std::size_t cache_size;
     bool cache_debug;
     std::size_t cache_threshold;
+    std::size_t host_cache_size;
+    std::string shared_name;
 
     inline bool operator==(const CacheParams& oth) const {
       return cache_policy == oth.cache_policy
           && cache_size == oth.cache_size
           && cache_debug == oth.cache_debug
-          && cache_threshold == oth.cache_threshold;
+          && cache_threshold == oth.cache_threshold
+          && host_cache_size == oth.host_cache_size
+          && shared_name == oth.shared_name;
     }
   };
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -112,5 +112,21 @@ TEST_F(ImageCacheFactoryTest, GetAndRefCount) {
   auto cache03 = factory.Get(0, "threshold", 2*1024*1024, true, 1024);
 }
 
+TEST_F(ImageCacheFactoryTest, HostTier) {
+  auto &factory = ImageCacheFactory::Instance();
+  ASSERT_FALSE(factory.IsInitialized(0));
+
+  EXPECT_THROW(
+    factory.Get(0, "threshold", 1*1024*1024, true, 1024, 1*1024*1024),
+    std::runtime_error);
+  EXPECT_FALSE(factory.IsInitialized(0));
+
+  auto cache0 = factory.Get(0, "lru", 1*1024*1024, true, 1024, 1*1024*1024);
+  ASSERT_NE(nullptr, cache0);
+  EXPECT_THROW(
+    factory.Get(0, "lru", 1*1024*1024, true, 1024),
+    std::runtime_error);
+}
+
 }  // namespace testing
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,7 @@
 #define DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_LARGEST_H_
 
 #include <functional>
+#include <mutex>
 #include <queue>
 #include <unordered_set>
 #include <utility>
@@ -42,6 +43,7 @@ class DLL_PUBLIC ImageCacheLargest : public ImageCacheBlob {
   std::unordered_set<ImageKey> images_;
   bool start_caching_ = false;
   std::size_t biggest_images_total_ = 0;
+  std::mutex mutex_;  // guards the selection of the images to be cached
 };
 
 }  // namespace dali
@@ -0,0 +1,367 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/decoder/cache/image_cache_lru.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include "dali/core/error_handling.h"
+#include "dali/pipeline/data/backend.h"
+
+namespace dali {
+
+constexpr std::size_t ImageCacheLRU::kDefaultPageSize;
+constexpr std::size_t ImageCacheLRU::kMinChunkSize;
+
+namespace {
+
+// the chunk sizes of the consecutive slab classes grow by this factor
+constexpr double kChunkGrowthFactor = 1.25;
+constexpr std::size_t kChunkAlignment = 256;
+
+}  // namespace
+
+ImageCacheLRU::ImageCacheLRU(std::size_t cache_size,
+                             std::size_t image_size_threshold,
+                             bool stats_enabled,
+                             std::size_t host_cache_size,
+                             std::size_t page_size)
+    : cache_size_(cache_size)
+    , host_cache_size_(host_cache_size)
+    , image_size_threshold_(image_size_threshold)
+    , page_size_(std::min(page_size, cache_size))
+    , stats_enabled_(stats_enabled) {
+  DALI_ENFORCE(page_size_ > 0, "Cache size and page size must be positive");
+  DALI_ENFORCE(image_size_threshold <= page_size_, "Cache page should fit at least one image");
+  DALI_ENFORCE(host_cache_size_ == 0 || host_cache_size_ >= page_size_,
+               make_string("The host cache should fit at least one page of ", page_size_,
+                           " bytes"));
+
+  std::vector<SlabClass> classes;
+  for (std::size_t chunk = std::min(kMinChunkSize, page_size_); ; ) {
+    classes.emplace_back();
+    classes.back().chunk_size = chunk;
+    if (chunk >= page_size_)
+      break;
+    std::size_t next = static_cast<std::size_t>(chunk * kChunkGrowthFactor);
+    next = align_up(std::max(next, chunk + 1), kChunkAlignment);
+    chunk = std::min(next, page_size_);
+  }
+  for (auto &tier : tiers_)
+    tier.classes = classes;
+
+  buffer_ = mm::alloc_raw_unique<uint8_t, mm::memory_kind::device>(cache_size_);
+  DALI_ENFORCE(buffer_ != nullptr);
+  InitTier(tiers_[kDeviceTier], buffer_.get(), cache_size_);
+  if (host_cache_size_ > 0) {
+    host_buffer_ = mm::alloc_raw_unique<uint8_t, mm::memory_kind::pinned>(host_cache_size_);
+    DALI_ENFORCE(host_buffer_ != nullptr);
+    InitTier(tiers_[kHostTier], host_buffer_.get(), host_cache_size_);
+  }
+  LOG_LINE << "cache size is " << cache_size_ / (1024 * 1024) << " MB + "
+           << host_cache_size_ / (1024 * 1024) << " MB of host memory, "
+           << classes.size() << " slab classes" << std::endl;
+
+  CUDA_CALL(cudaStreamCreateWithPriority(&cache_stream_, cudaStreamNonBlocking, 0));
+  CUDA_CALL(cudaEventCreate(&cache_read_event_));
+  CUDA_CALL(cudaEventCreate(&cache_write_event_));
+}
+
+void ImageCacheLRU::InitTier(Tier &tier, uint8_t *base, std::size_t size) {
+  tier.base = base;
+  tier.num_pages = size / page_size_;
+  tier.page_class.resize(tier.num_pages, -1);
+  for (int page = tier.num_pages - 1; page >= 0; page--)
+    tier.free_pages.push_back(page);
+}
+
+ImageCacheLRU::~ImageCacheLRU() {
+  CUDA_CALL(cudaStreamSynchronize(cache_stream_));
+  for (auto &stream_event : read_done_events_) {
+    CUDA_CALL(cudaEventSynchronize(stream_event.second));
+    CUDA_CALL(cudaEventDestroy(stream_event.second));
+  }
+  CUDA_CALL(cudaEventDestroy(cache_read_event_));
+  CUDA_CALL(cudaEventDestroy(cache_write_event_));
+  CUDA_CALL(cudaStreamDestroy(cache_stream_));
+
+  if (stats_enabled_ && stats_.hits + stats_.misses > 0) print_stats();
+}
+
+bool ImageCacheLRU::IsCached(const ImageKey& image_key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_.find(image_key) != cache_.end();
+}
+
+const ImageCache::ImageShape& ImageCacheLRU::GetShape(const ImageKey& image_key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = cache_.find(image_key);
+  DALI_ENFORCE(it != cache_.end(), "cache entry [" + image_key + "] not found");
+  return it->second.image.shape;
+}
+
+bool ImageCacheLRU::Read(const ImageKey& image_key,
+                         void* destination_buffer,
+                         cudaStream_t stream) const {
+  DALI_ENFORCE(!image_key.empty());
+  DALI_ENFORCE(destination_buffer != nullptr);
+  std::lock_guard<std::mutex> lock(mutex_);
+  LOG_LINE << "Read: image_key[" << image_key << "]" << std::endl;
+  const auto it = cache_.find(image_key);
+  if (it == cache_.end())
+    return false;
+  const auto &entry = it->second;
+  Touch(entry);
+  stats_.hits++;
+  if (entry.tier == kHostTier)
+    stats_.host_hits++;
+
+  SyncToRead(stream);
+  MemCopy(destination_buffer, entry.image.data, entry.image.num_elements(), stream);
+  SyncAfterRead(stream);
+  return true;
+}
+
+ImageCache::DecodedImage ImageCacheLRU::Get(const ImageKey& image_key) const {
+  DALI_ENFORCE(!image_key.empty());
+  std::lock_guard<std::mutex> lock(mutex_);
+  LOG_LINE << "Get: image_key[" << image_key << "]" << std::endl;
+  const auto it = cache_.find(image_key);
+  if (it == cache_.end())
+    return {};
+  Touch(it->second);
+  stats_.hits++;
+  if (it->second.tier == kHostTier)
+    stats_.host_hits++;
+  auto ret = it->second.image;  // make a copy _before_ leaving the mutex
+  return ret;
+}
+
+void ImageCacheLRU::Add(const ImageKey& image_key, const uint8_t* data,
+                        const ImageShape& data_shape, cudaStream_t stream) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const std::size_t data_size = volume(data_shape);
+  stats_.misses++;
+  if (data_size < image_size_threshold_) return;
+  DALI_ENFORCE(!image_key.empty());
+
+  if (cache_.find(image_key) != cache_.end())
+    return;
+
+  int slab_class = SlabClassIndex(data_size);
+  if (slab_class < 0) {
+    LOG_LINE << "WARNING: image [" << image_key << "] doesn't fit in the cache. Ignore"
+             << std::endl;
+    stats_.rejected++;
+    return;
+  }
+
+  // the chunks of the evicted images might be still read from (or written to) by pending copies
+  if (NeedsEviction(kDeviceTier, slab_class))
+    SyncToEvict(stream);
+  uint8_t *chunk = AllocateChunk(kDeviceTier, slab_class, stream);
+  MemCopy(chunk, data, data_size, stream);
+  SyncAfterWrite(stream);
+
+  auto &lru = tiers_[kDeviceTier].classes[slab_class].lru;
+  lru.push_front(image_key);
+  auto &entry = cache_[image_key];
+  entry = { DecodedImage{chunk, data_shape}, kDeviceTier, slab_class, lru.begin() };
+  Touch(entry);
+}
+
+void ImageCacheLRU::SyncToRead(cudaStream_t stream) const {
+  // synchronizing with cache instance stream with provided stream
+  CUDA_CALL(cudaEventRecord(cache_read_event_, cache_stream_));
+  CUDA_CALL(cudaStreamWaitEvent(stream, cache_read_event_, 0));
+}
+
+void ImageCacheLRU::SyncAfterRead(cudaStream_t stream) const {
+  auto &event = read_done_events_[stream];
+  if (!event)
+    CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  CUDA_CALL(cudaEventRecord(event, stream));
+}
+
+void ImageCacheLRU::SyncAfterWrite(cudaStream_t stream) const {
+  // synchronizing with cache instance stream with provided stream
+  CUDA_CALL(cudaEventRecord(cache_write_event_, stream));
+  CUDA_CALL(cudaStreamWaitEvent(cache_stream_, cache_write_event_, 0));
+}
+
+bool ImageCacheLRU::IsHostData(const uint8_t *data) const {
+  const uint8_t *host_start = host_buffer_.get();
+  return host_start && data >= host_start && data < host_start + host_cache_size_;
+}
+
+void ImageCacheLRU::SyncToEvict(cudaStream_t stream) {
+  SyncToRead(stream);
+  for (auto &stream_event : read_done_events_) {
+    if (stream_event.first != stream)
+      CUDA_CALL(cudaStreamWaitEvent(stream, stream_event.second, 0));
+  }
+}
+
+ImageCacheLRU::Stats ImageCacheLRU::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+int ImageCacheLRU::SlabClassIndex(std::size_t size) const {
+  auto &classes = tiers_[kDeviceTier].classes;
+  auto it = std::lower_bound(classes.begin(), classes.end(), size,
+                             [](const SlabClass &c, std::size_t s) { return c.chunk_size < s; });
+  return it == classes.end() ? -1 : static_cast<int>(it - classes.begin());
+}
+
+bool ImageCacheLRU::NeedsEviction(int tier, int slab_class) const {
+  return tiers_[tier].classes[slab_class].free_chunks.empty() && tiers_[tier].free_pages.empty();
+}
+
+uint8_t *ImageCacheLRU::AllocateChunk(int tier_idx, int slab_class, cudaStream_t stream) {
+  auto &tier = tiers_[tier_idx];
+  auto &cls = tier.classes[slab_class];
+  if (cls.free_chunks.empty() && !tier.free_pages.empty()) {
+    AssignPage(tier_idx, tier.free_pages.back(), slab_class);
+    tier.free_pages.pop_back();
+  }
+  if (cls.free_chunks.empty()) {
+    if (!cls.lru.empty()) {
+      ImageKey victim = cls.lru.back();
+      Evict(victim, stream);
+    } else {
+      // the class has no memory - take over the page of the least recently used image
+      const Entry *oldest = nullptr;
+      for (auto &c : tier.classes) {
+        if (c.lru.empty())
+          continue;
+        const Entry &e = cache_.at(c.lru.back());
+        if (!oldest || e.last_use < oldest->last_use)
+          oldest = &e;
+      }
+      // if there are no images, all the pages are assigned to the classes with free chunks
+      int page = oldest ? (oldest->image.data - tier.base) / page_size_ : 0;
+      ReleasePage(tier_idx, page, stream);
+      AssignPage(tier_idx, page, slab_class);
+    }
+  }
+  uint8_t *chunk = cls.free_chunks.back();
+  cls.free_chunks.pop_back();
+  return chunk;
+}
+
+void ImageCacheLRU::AssignPage(int tier_idx, int page, int slab_class) {
+  auto &tier = tiers_[tier_idx];
+  auto &cls = tier.classes[slab_class];
+  tier.page_class[page] = slab_class;
+  uint8_t *page_start = tier.base + page * page_size_;
+  std::size_t num_chunks = page_size_ / cls.chunk_size;
+  // reversed, so that the chunks are used in the order of addresses
+  for (std::size_t i = num_chunks; i > 0; i--)
+    cls.free_chunks.push_back(page_start + (i - 1) * cls.chunk_size);
+}
+
+void ImageCacheLRU::ReleasePage(int tier_idx, int page, cudaStream_t stream) {
+  auto &tier = tiers_[tier_idx];
+  int slab_class = tier.page_class[page];
+  assert(slab_class >= 0);
+  auto &cls = tier.classes[slab_class];
+  const uint8_t *page_start = tier.base + page * page_size_;
+  const uint8_t *page_end = page_start + page_size_;
+  auto in_page = [&](const uint8_t *ptr) { return ptr >= page_start && ptr < page_end; };
+
+  std::vector<ImageKey> to_evict;
+  for (auto &key : cls.lru) {
+    if (in_page(cache_.at(key).image.data))
+      to_evict.push_back(key);
+  }
+  for (auto &key : to_evict)
+    Evict(key, stream);
+  cls.free_chunks.erase(
+      std::remove_if(cls.free_chunks.begin(), cls.free_chunks.end(), in_page),
+      cls.free_chunks.end());
+  tier.page_class[page] = -1;
+}
+
+void ImageCacheLRU::Evict(const ImageKey &image_key, cudaStream_t stream) {
+  auto it = cache_.find(image_key);
+  assert(it != cache_.end());
+  auto &entry = it->second;
+  auto &cls = tiers_[entry.tier].classes[entry.slab_class];
+  cls.free_chunks.push_back(entry.image.data);
+  cls.lru.erase(entry.lru_it);
+  if (entry.tier == kDeviceTier && HasHostTier()) {
+    LOG_LINE << "Demote: image_key[" << image_key << "]" << std::endl;
+    Demote(image_key, entry, stream);
+  } else {
+    LOG_LINE << "Evict: image_key[" << image_key << "]" << std::endl;
+    cache_.erase(it);
+    stats_.evictions++;
+  }
+}
+
+void ImageCacheLRU::Demote(const ImageKey &image_key, Entry &entry, cudaStream_t stream) {
+  // the image keeps its shape, so it goes to the same slab class in the host tier
+  const uint8_t *device_data = entry.image.data;
+  uint8_t *host_chunk = AllocateChunk(kHostTier, entry.slab_class, stream);
+  // the device chunk was just freed, but it's overwritten only by the copies issued later
+  MemCopy(host_chunk, device_data, entry.image.num_elements(), stream);
+
+  auto &lru = tiers_[kHostTier].classes[entry.slab_class].lru;
+  lru.push_front(image_key);
+  entry.image.data = host_chunk;
+  entry.tier = kHostTier;
+  entry.lru_it = lru.begin();
+  stats_.demotions++;
+}
+
+void ImageCacheLRU::Touch(const Entry &entry) const {
+  auto &lru = tiers_[entry.tier].classes[entry.slab_class].lru;
+  lru.splice(lru.begin(), lru, entry.lru_it);
+  entry.last_use = ++clock_;
+}
+
+void ImageCacheLRU::print_stats() const {
+  static std::mutex stats_mutex;
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  const char* log_filename = std::getenv("DALI_LOG_FILE");
+  std::ofstream log_file;
+  if (log_filename) log_file.open(log_filename);
+  std::ostream& out = log_filename ? log_file : std::cout;
+  out << "#################### CACHE STATS ####################" << std::endl;
+  out << "cache_size: " << cache_size_ << std::endl;
+  out << "cache_threshold: " << image_size_threshold_ << std::endl;
+  out << "page_size: " << page_size_ << std::endl;
+  out << "images_cached: " << cache_.size() << std::endl;
+  out << "host_cache_size: " << host_cache_size_ << std::endl;
+  out << "hits: " << stats_.hits << std::endl;
+  out << "host_hits: " << stats_.host_hits << std::endl;
+  out << "misses: " << stats_.misses << std::endl;
+  out << "hit_rate: " << stats_.hit_rate() << std::endl;
+  out << "evictions: " << stats_.evictions << std::endl;
+  out << "demotions: " << stats_.demotions << std::endl;
+  out << "rejected: " << stats_.rejected << std::endl;
+  for (int t = 0; t < kNumTiers; t++) {
+    for (auto &cls : tiers_[t].classes) {
+      if (cls.lru.empty() && cls.free_chunks.empty())
+        continue;
+      out << (t == kHostTier ? "host_slab[" : "slab[") << cls.chunk_size << "] : images["
+          << cls.lru.size() << "] free_chunks[" << cls.free_chunks.size() << "]" << std::endl;
+    }
+  }
+  out << "#################### END   STATS ####################" << std::endl;
+}
+
+}  // namespace dali
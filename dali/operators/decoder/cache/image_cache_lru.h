@@ -0,0 +1,193 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_LRU_H_
+#define DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_LRU_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "dali/core/common.h"
+#include "dali/core/mm/memory.h"
+#include "dali/operators/decoder/cache/image_cache.h"
+
+namespace dali {
+
+/**
+ * @brief An image cache which evicts the least recently used images when it's full
+ *
+ * The GPU buffer is divided into pages, which are assigned on demand to slab classes of
+ * growing chunk sizes. An image is stored in a chunk of the smallest class it fits in. When
+ * there's no free chunk, the least recently used image of the class is evicted - or, if the
+ * class has no chunks at all, the page holding the least recently used image is reassigned, so
+ * that the division of the memory between the classes follows the images seen.
+ * The images larger than a page are not cached.
+ *
+ * Optionally, the images evicted from the GPU are moved to a second tier, in pinned host memory,
+ * that is managed in the same way. The images in the host tier are returned by Get as host
+ * pointers (see IsHostData) and are evicted for good when it's full.
+ */
+class DLL_PUBLIC ImageCacheLRU : public ImageCache {
+ public:
+  static constexpr std::size_t kDefaultPageSize = 16 << 20;
+  static constexpr std::size_t kMinChunkSize = 16 << 10;
+
+  /**
+   * @param host_cache_size the size of the host tier; 0 means no host tier
+   */
+  DLL_PUBLIC ImageCacheLRU(std::size_t cache_size,
+                           std::size_t image_size_threshold,
+                           bool stats_enabled = false,
+                           std::size_t host_cache_size = 0,
+                           std::size_t page_size = kDefaultPageSize);
+
+  ~ImageCacheLRU() override;
+
+  DISABLE_COPY_MOVE_ASSIGN(ImageCacheLRU);
+
+  bool IsCached(const ImageKey& image_key) const override;
+
+  bool Read(const ImageKey& image_key,
+            void* destination_data,
+            cudaStream_t stream) const override;
+
+  const ImageShape& GetShape(const ImageKey& image_key) const override;
+
+  void Add(const ImageKey& image_key,
+           const uint8_t *data,
+           const ImageShape& data_shape,
+           cudaStream_t stream) override;
+
+  /**
+   * @remarks The data is valid until the next call to Add
+   */
+  DecodedImage Get(const ImageKey &image_key) const override;
+
+  void SyncToRead(cudaStream_t stream) const override;
+
+  void SyncAfterRead(cudaStream_t stream) const override;
+
+  bool IsHostData(const uint8_t *data) const override;
+
+  struct Stats {
+    std::size_t hits = 0;       ///< reads of cached images
+    std::size_t host_hits = 0;  ///< the hits served from the host tier
+    std::size_t misses = 0;     ///< images added (i.e. decoded), cached or not
+    std::size_t evictions = 0;  ///< images dropped from the cache
+    std::size_t demotions = 0;  ///< images moved from the GPU to the host tier
+    std::size_t rejected = 0;   ///< images too large to be cached
+
+    double hit_rate() const {
+      return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+    }
+  };
+
+  DLL_PUBLIC Stats GetStats() const;
+
+  std::size_t page_size() const noexcept { return page_size_; }
+
+ private:
+  struct SlabClass {
+    std::size_t chunk_size = 0;
+    std::vector<uint8_t *> free_chunks;
+    std::list<ImageKey> lru;  // the most recently used first
+  };
+
+  /// @brief A memory pool (GPU or host) divided into pages and slab classes
+  struct Tier {
+    uint8_t *base = nullptr;
+    std::size_t num_pages = 0;
+    std::vector<SlabClass> classes;
+    std::vector<int> page_class;  // -1 for pages not assigned to any class
+    std::vector<int> free_pages;
+  };
+
+  enum TierIndex { kDeviceTier = 0, kHostTier = 1, kNumTiers = 2 };
+
+  struct Entry {
+    DecodedImage image;
+    int tier = kDeviceTier;
+    int slab_class = -1;
+    std::list<ImageKey>::iterator lru_it;
+    mutable uint64_t last_use = 0;
+  };
+
+  void InitTier(Tier &tier, uint8_t *base, std::size_t size);
+
+  bool HasHostTier() const noexcept { return tiers_[kHostTier].num_pages > 0; }
+
+  /// @return the index of the smallest slab class with chunks of at least `size` bytes, or -1
+  int SlabClassIndex(std::size_t size) const;
+
+  /// @return true if obtaining a chunk of the given class requires evicting an image
+  bool NeedsEviction(int tier, int slab_class) const;
+
+  /**
+   * @brief Obtains a free chunk of the given class, evicting other images if needed
+   *
+   * The evicted images are demoted to the host tier, if there's one, with copies issued
+   * in `stream`.
+   */
+  uint8_t *AllocateChunk(int tier, int slab_class, cudaStream_t stream);
+
+  void AssignPage(int tier, int page, int slab_class);
+
+  /// @brief Evicts all the images stored in the page and takes its chunks from their class
+  void ReleasePage(int tier, int page, cudaStream_t stream);
+
+  void Evict(const ImageKey &image_key, cudaStream_t stream);
+
+  /// @brief Moves the image from the GPU to the host tier
+  void Demote(const ImageKey &image_key, Entry &entry, cudaStream_t stream);
+
+  /// @brief Moves the entry to the front of its LRU list
+  void Touch(const Entry &entry) const;
+
+  /**
+   * @brief Makes the stream wait for the copies to and from the cache issued so far, so that
+   *        the chunks of the evicted images can be reused
+   */
+  void SyncToEvict(cudaStream_t stream);
+
+  void SyncAfterWrite(cudaStream_t stream) const;
+
+  void print_stats() const;
+
+  std::size_t cache_size_ = 0;
+  std::size_t host_cache_size_ = 0;
+  std::size_t image_size_threshold_ = 0;
+  std::size_t page_size_ = 0;
+  bool stats_enabled_ = false;
+  mm::uptr<uint8_t> buffer_;
+  mm::uptr<uint8_t> host_buffer_;
+
+  // the LRU lists are reordered by the readers, hence mutable
+  mutable Tier tiers_[kNumTiers];
+  std::unordered_map<ImageKey, Entry> cache_;
+  mutable std::mutex mutex_;
+  mutable Stats stats_;
+  mutable uint64_t clock_ = 0;  // the logical time of the accesses, for choosing the LRU image
+
+  cudaStream_t cache_stream_;
+  cudaEvent_t cache_read_event_;
+  cudaEvent_t cache_write_event_;
+  /// lazily created events, recorded in the streams reading from the cache
+  mutable std::unordered_map<cudaStream_t, cudaEvent_t> read_done_events_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_LRU_H_
@@ -0,0 +1,170 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/decoder/cache/image_cache_lru.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dali {
+namespace testing {
+
+namespace {
+
+constexpr std::size_t kPageSize = 64 << 10;
+constexpr std::size_t kNumPages = 2;
+constexpr std::size_t kSmallImage = ImageCacheLRU::kMinChunkSize;  // 4 per page
+constexpr std::size_t kChunksPerPage = kPageSize / kSmallImage;
+
+std::string Key(int i) {
+  return "file" + std::to_string(i) + ".jpg";
+}
+
+}  // namespace
+
+struct ImageCacheLRUTest : public ::testing::Test {
+  void SetUp() override { SetUpImpl(kNumPages * kPageSize); }
+
+  void SetUpImpl(std::size_t cache_size, std::size_t image_size_threshold = 0,
+                 std::size_t host_cache_size = 0) {
+    cache_.reset(new ImageCacheLRU(cache_size, image_size_threshold, false, host_cache_size,
+                                   kPageSize));
+  }
+
+  void AddImage(int i, std::size_t size) {
+    std::vector<uint8_t> data(size, static_cast<uint8_t>(i));
+    cache_->Add(Key(i), data.data(), {static_cast<Index>(size), 1, 1}, 0);
+  }
+
+  std::unique_ptr<ImageCacheLRU> cache_;
+};
+
+TEST_F(ImageCacheLRUTest, Add) {
+  EXPECT_FALSE(cache_->IsCached(Key(1)));
+  AddImage(1, 300);
+  ASSERT_TRUE(cache_->IsCached(Key(1)));
+  EXPECT_EQ(cache_->GetShape(Key(1)), ImageCache::ImageShape(300, 1, 1));
+  std::vector<uint8_t> cached_data(300);
+  EXPECT_TRUE(cache_->Read(Key(1), cached_data.data(), 0));
+  EXPECT_EQ(cached_data, std::vector<uint8_t>(300, 1));
+  EXPECT_FALSE(cache_->Read(Key(2), cached_data.data(), 0));
+}
+
+TEST_F(ImageCacheLRUTest, Threshold) {
+  SetUpImpl(kNumPages * kPageSize, 1000);
+  AddImage(1, 999);
+  AddImage(2, 1000);
+  EXPECT_FALSE(cache_->IsCached(Key(1)));
+  EXPECT_TRUE(cache_->IsCached(Key(2)));
+}
+
+TEST_F(ImageCacheLRUTest, LargerThanPageNotCached) {
+  AddImage(1, kPageSize + 1);
+  EXPECT_FALSE(cache_->IsCached(Key(1)));
+  EXPECT_EQ(cache_->GetStats().rejected, 1u);
+}
+
+TEST_F(ImageCacheLRUTest, EvictsLeastRecentlyUsed) {
+  const int n = kNumPages * kChunksPerPage;
+  for (int i = 0; i < n; i++)
+    AddImage(i, kSmallImage);
+  for (int i = 0; i < n; i++)
+    EXPECT_TRUE(cache_->IsCached(Key(i)));
+
+  // reading the oldest image makes the next one the least recently used
+  std::vector<uint8_t> cached_data(kSmallImage);
+  ASSERT_TRUE(cache_->Read(Key(0), cached_data.data(), 0));
+  AddImage(n, kSmallImage);
+  EXPECT_TRUE(cache_->IsCached(Key(0)));
+  EXPECT_FALSE(cache_->IsCached(Key(1)));
+  EXPECT_TRUE(cache_->IsCached(Key(n)));
+
+  ASSERT_TRUE(cache_->Get(Key(2)).data);
+  AddImage(n + 1, kSmallImage);
+  EXPECT_TRUE(cache_->IsCached(Key(2)));
+  EXPECT_FALSE(cache_->IsCached(Key(3)));
+
+  // the chunks are reused without corrupting the other images
+  for (int i : {0, 2, n}) {
+    ASSERT_TRUE(cache_->Read(Key(i), cached_data.data(), 0));
+    EXPECT_EQ(cached_data, std::vector<uint8_t>(kSmallImage, i));
+  }
+  EXPECT_EQ(cache_->GetStats().evictions, 2u);
+}
+
+TEST_F(ImageCacheLRUTest, ReassignsPages) {
+  const int n = kNumPages * kChunksPerPage;
+  for (int i = 0; i < n; i++)
+    AddImage(i, kSmallImage);
+
+  // there's no memory for the large images - the page of the oldest images is taken over
+  AddImage(n, kPageSize);
+  EXPECT_TRUE(cache_->IsCached(Key(n)));
+  for (int i = 0; i < n; i++)
+    EXPECT_EQ(cache_->IsCached(Key(i)), i >= static_cast<int>(kChunksPerPage)) << i;
+
+  std::vector<uint8_t> cached_data(kPageSize);
+  ASSERT_TRUE(cache_->Read(Key(n), cached_data.data(), 0));
+  EXPECT_EQ(cached_data, std::vector<uint8_t>(kPageSize, n));
+
+  // and the large image's own class evicts within itself
+  AddImage(n + 1, kPageSize);
+  EXPECT_FALSE(cache_->IsCached(Key(n)));
+  EXPECT_TRUE(cache_->IsCached(Key(n + 1)));
+}
+
+TEST_F(ImageCacheLRUTest, HostTier) {
+  SetUpImpl(kNumPages * kPageSize, 0, kPageSize);
+  const int n = kNumPages * kChunksPerPage;
+  for (int i = 0; i < n + kChunksPerPage; i++)
+    AddImage(i, kSmallImage);
+
+  // the oldest images were moved to the host
+  std::vector<uint8_t> cached_data(kSmallImage);
+  for (int i = 0; i < n + static_cast<int>(kChunksPerPage); i++) {
+    ASSERT_TRUE(cache_->IsCached(Key(i))) << i;
+    auto img = cache_->Get(Key(i));
+    ASSERT_TRUE(img.data);
+    EXPECT_EQ(cache_->IsHostData(img.data), i < static_cast<int>(kChunksPerPage)) << i;
+    ASSERT_TRUE(cache_->Read(Key(i), cached_data.data(), 0));
+    EXPECT_EQ(cached_data, std::vector<uint8_t>(kSmallImage, i)) << i;
+  }
+  auto stats = cache_->GetStats();
+  EXPECT_EQ(stats.demotions, kChunksPerPage);
+  EXPECT_EQ(stats.host_hits, 2 * kChunksPerPage);
+  EXPECT_EQ(stats.evictions, 0u);
+
+  // when the host tier is full, the images are dropped
+  AddImage(-1, kSmallImage);
+  EXPECT_EQ(cache_->GetStats().evictions, 1u);
+  EXPECT_EQ(cache_->GetStats().demotions, kChunksPerPage + 1);
+  EXPECT_TRUE(cache_->IsCached(Key(-1)));
+}
+
+TEST_F(ImageCacheLRUTest, Stats) {
+  AddImage(1, 300);
+  AddImage(2, 300);
+  std::vector<uint8_t> cached_data(300);
+  for (int i = 0; i < 6; i++)
+    EXPECT_TRUE(cache_->Read(Key(1 + i % 2), cached_data.data(), 0));
+  auto stats = cache_->GetStats();
+  EXPECT_EQ(stats.hits, 6u);
+  EXPECT_EQ(stats.misses, 2u);
+  EXPECT_DOUBLE_EQ(stats.hit_rate(), 0.75);
+  EXPECT_EQ(stats.evictions, 0u);
+}
+
+}  // namespace testing
+}  // namespace dali
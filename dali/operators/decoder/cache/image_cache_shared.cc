@@ -0,0 +1,373 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/decoder/cache/image_cache_shared.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <thread>
+#include "dali/core/error_handling.h"
+#include "dali/core/util.h"
+#include "dali/pipeline/data/backend.h"
+
+namespace dali {
+
+namespace {
+
+constexpr uint64_t kMagic = 0x45484341434c4144ull;  // "DALCACHE"
+constexpr std::size_t kDataAlignment = 256;
+constexpr std::size_t kPageAlignment = 4096;
+// the expected size of a cached image, used to choose the size of the index
+constexpr std::size_t kAvgImageSize = 64 << 10;
+constexpr auto kAttachTimeout = std::chrono::seconds(30);
+
+enum SlotState : uint32_t {
+  kEmpty = 0,
+  kWriting = 1,  // claimed, but the copy of the data is not complete
+  kReady = 2,
+};
+
+// FNV-1a - unlike std::hash, guaranteed to be the same in all the processes
+uint64_t HashKey(const std::string &key) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (unsigned char c : key) {
+    hash ^= c;
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+}  // namespace
+
+struct ImageCacheShared::Header {
+  uint64_t magic;
+  std::atomic<uint32_t> initialized;
+  std::atomic<int32_t> num_attached;
+  pthread_mutex_t mutex;  // guards the fields below and the claiming of the slots
+  uint64_t data_size;
+  uint64_t data_used;
+  uint64_t num_slots;
+  uint64_t num_entries;
+};
+
+struct ImageCacheShared::Slot {
+  std::atomic<uint32_t> state;
+  uint32_t key_length;
+  uint64_t hash;
+  uint64_t offset;
+  ImageShape shape;
+  char key[kMaxKeyLength];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+              std::atomic<int32_t>::is_always_lock_free,
+              "The atomics placed in the shared memory must be lock-free");
+
+ImageCacheShared::ImageCacheShared(const std::string &name,
+                                   std::size_t cache_size,
+                                   std::size_t image_size_threshold,
+                                   bool stats_enabled)
+    : name_("/" + name)
+    , image_size_threshold_(image_size_threshold)
+    , stats_enabled_(stats_enabled) {
+  DALI_ENFORCE(!name.empty() && name.find('/') == std::string::npos,
+               make_string("Invalid shared cache name: \"", name, "\""));
+  DALI_ENFORCE(cache_size > 0, "Cache size must be positive");
+
+  // the layout depends only on the cache size, so it's the same in all the processes
+  const std::size_t num_slots = next_pow2(std::max<std::size_t>(cache_size / kAvgImageSize, 1024));
+  const std::size_t slots_offset = align_up(sizeof(Header), alignof(Slot));
+  const std::size_t data_offset = align_up(slots_offset + num_slots * sizeof(Slot),
+                                           kPageAlignment);
+  const std::size_t total_size = align_up(data_offset + cache_size, kPageAlignment);
+
+  int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  const bool creator = fd >= 0;
+  if (!creator) {
+    if (errno != EEXIST)
+      POSIX_CHECK_STATUS_EX(-1, "shm_open", name_);
+    fd = shm_open(name_.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+    POSIX_CHECK_STATUS_EX(fd, "shm_open", name_);
+  }
+  ShmHandle handle(fd);
+
+  auto start = std::chrono::steady_clock::now();
+  auto wait = [&](const char *what) {
+    DALI_ENFORCE(std::chrono::steady_clock::now() - start < kAttachTimeout,
+                 make_string("Timed out waiting for the ", what, " of the shared cache ", name_));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  };
+
+  if (creator) {
+    POSIX_CALL_EX(ftruncate(fd, total_size), name_);
+  } else {
+    struct stat st;
+    for (;;) {
+      POSIX_CALL_EX(fstat(fd, &st), name_);
+      if (st.st_size != 0)
+        break;
+      wait("creation");
+    }
+    DALI_ENFORCE(static_cast<std::size_t>(st.st_size) == total_size,
+                 make_string("The shared cache ", name_, " was created with a different size"));
+  }
+
+  mapping_ = MemoryMapping(fd, total_size);
+  uint8_t *base = mapping_.get_raw_ptr();
+  header_ = reinterpret_cast<Header *>(base);
+  slots_ = reinterpret_cast<Slot *>(base + slots_offset);
+  data_ = base + data_offset;
+
+  if (creator) {
+    // the memory is zero-initialized by ftruncate, which makes all the slots empty
+    new(header_) Header();
+    header_->magic = kMagic;
+    header_->data_size = cache_size;
+    header_->num_slots = num_slots;
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&header_->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    header_->num_attached = 1;
+    header_->initialized.store(1, std::memory_order_release);
+  } else {
+    while (!header_->initialized.load(std::memory_order_acquire))
+      wait("initialization");
+    DALI_ENFORCE(header_->magic == kMagic && header_->data_size == cache_size &&
+                 header_->num_slots == num_slots,
+                 make_string("The shared cache ", name_, " has an incompatible layout"));
+    header_->num_attached++;
+  }
+
+  CUDA_CALL(cudaHostRegister(base, total_size, cudaHostRegisterPortable));
+  LOG_LINE << (creator ? "created" : "attached to") << " the shared cache " << name_ << " of "
+           << cache_size / (1024 * 1024) << " MB" << std::endl;
+}
+
+ImageCacheShared::~ImageCacheShared() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PublishPending(true);
+    for (auto event : free_events_)
+      CUDA_DTOR_CALL(cudaEventDestroy(event));
+  }
+  if (stats_enabled_ && hits_ + misses_ > 0)
+    print_stats();
+  CUDA_DTOR_CALL(cudaHostUnregister(mapping_.get_raw_ptr()));
+  if (--header_->num_attached == 0)
+    shm_unlink(name_.c_str());
+}
+
+ImageCacheShared::Slot *ImageCacheShared::Probe(const ImageKey &image_key, uint64_t hash) const {
+  const uint64_t mask = header_->num_slots - 1;
+  for (uint64_t i = 0; i <= mask; i++) {
+    Slot *slot = &slots_[(hash + i) & mask];
+    uint32_t state = slot->state.load(std::memory_order_acquire);
+    if (state == kEmpty)
+      return slot;
+    if (slot->hash == hash && slot->key_length == image_key.size() &&
+        !memcmp(slot->key, image_key.data(), image_key.size()))
+      return slot;
+  }
+  return nullptr;
+}
+
+const ImageCacheShared::Slot *ImageCacheShared::Find(const ImageKey &image_key) const {
+  if (image_key.empty() || image_key.size() > kMaxKeyLength)
+    return nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PublishPending(false);
+  }
+  const Slot *slot = Probe(image_key, HashKey(image_key));
+  return slot && slot->state.load(std::memory_order_acquire) == kReady ? slot : nullptr;
+}
+
+bool ImageCacheShared::IsCached(const ImageKey& image_key) const {
+  return Find(image_key) != nullptr;
+}
+
+const ImageCache::ImageShape& ImageCacheShared::GetShape(const ImageKey& image_key) const {
+  const Slot *slot = Find(image_key);
+  DALI_ENFORCE(slot != nullptr, "cache entry [" + image_key + "] not found");
+  return slot->shape;
+}
+
+bool ImageCacheShared::Read(const ImageKey& image_key,
+                            void* destination_buffer,
+                            cudaStream_t stream) const {
+  DALI_ENFORCE(!image_key.empty());
+  DALI_ENFORCE(destination_buffer != nullptr);
+  LOG_LINE << "Read: image_key[" << image_key << "]" << std::endl;
+  const Slot *slot = Find(image_key);
+  if (!slot)
+    return false;
+  MemCopy(destination_buffer, data_ + slot->offset, volume(slot->shape), stream);
+  std::lock_guard<std::mutex> lock(mutex_);
+  hits_++;
+  return true;
+}
+
+ImageCache::DecodedImage ImageCacheShared::Get(const ImageKey& image_key) const {
+  DALI_ENFORCE(!image_key.empty());
+  LOG_LINE << "Get: image_key[" << image_key << "]" << std::endl;
+  const Slot *slot = Find(image_key);
+  if (!slot)
+    return {};
+  std::lock_guard<std::mutex> lock(mutex_);
+  hits_++;
+  return { data_ + slot->offset, slot->shape };
+}
+
+void ImageCacheShared::Add(const ImageKey& image_key, const uint8_t* data,
+                           const ImageShape& data_shape, cudaStream_t stream) {
+  const std::size_t data_size = volume(data_shape);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    misses_++;
+    PublishPending(false);
+  }
+  if (data_size < image_size_threshold_) return;
+  DALI_ENFORCE(!image_key.empty());
+  if (image_key.size() > kMaxKeyLength) {
+    LOG_LINE << "WARNING: image key [" << image_key << "] is too long. Ignore" << std::endl;
+    return;
+  }
+
+  const uint64_t hash = HashKey(image_key);
+  Slot *slot = nullptr;
+  uint64_t offset = 0;
+  LockIndex();
+  try {
+    slot = Probe(image_key, hash);
+    // keep the load factor of the index low, so that the probe sequences are short
+    bool index_full = (header_->num_entries + 1) * 4 > header_->num_slots * 3;
+    bool data_full = header_->data_used + data_size > header_->data_size;
+    if (!slot || slot->state.load(std::memory_order_relaxed) != kEmpty) {
+      slot = nullptr;  // already cached or being added by another process
+    } else if (index_full || data_full) {
+      LOG_LINE << "WARNING: not enough space in cache. Ignore" << std::endl;
+      slot = nullptr;
+    } else {
+      offset = header_->data_used;
+      header_->data_used = align_up(offset + data_size, kDataAlignment);
+      header_->num_entries++;
+      slot->hash = hash;
+      slot->key_length = image_key.size();
+      memcpy(slot->key, image_key.data(), image_key.size());
+      slot->offset = offset;
+      slot->shape = data_shape;
+      slot->state.store(kWriting, std::memory_order_release);
+    }
+  } catch (...) {
+    UnlockIndex();
+    throw;
+  }
+  UnlockIndex();
+  if (!slot)
+    return;
+
+  MemCopy(data_ + offset, data, data_size, stream);
+  std::lock_guard<std::mutex> lock(mutex_);
+  cudaEvent_t event;
+  if (free_events_.empty()) {
+    CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  } else {
+    event = free_events_.back();
+    free_events_.pop_back();
+  }
+  CUDA_CALL(cudaEventRecord(event, stream));
+  pending_.push_back({slot, event});
+}
+
+void ImageCacheShared::PublishPending(bool wait) const {
+  auto it = pending_.begin();
+  for (; it != pending_.end(); ++it) {
+    if (wait) {
+      CUDA_CALL(cudaEventSynchronize(it->event));
+    } else {
+      auto ret = cudaEventQuery(it->event);
+      if (ret == cudaErrorNotReady)
+        break;
+      CUDA_CALL(ret);
+    }
+    it->slot->state.store(kReady, std::memory_order_release);
+    free_events_.push_back(it->event);
+  }
+  pending_.erase(pending_.begin(), it);
+}
+
+void ImageCacheShared::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PublishPending(true);
+}
+
+std::size_t ImageCacheShared::NumImages() const {
+  LockIndex();
+  std::size_t n = header_->num_entries;
+  UnlockIndex();
+  return n;
+}
+
+bool ImageCacheShared::IsHostData(const uint8_t *data) const {
+  return data >= data_ && data < data_ + header_->data_size;
+}
+
+void ImageCacheShared::LockIndex() const {
+  int ret = pthread_mutex_lock(&header_->mutex);
+  if (ret == EOWNERDEAD) {
+    // a process died while adding an image - its slot, if claimed, stays unpublished
+    pthread_mutex_consistent(&header_->mutex);
+  } else {
+    DALI_ENFORCE(ret == 0, make_string("Failed to lock the shared cache ", name_, ": ", ret));
+  }
+}
+
+void ImageCacheShared::UnlockIndex() const {
+  pthread_mutex_unlock(&header_->mutex);
+}
+
+void ImageCacheShared::print_stats() const {
+  static std::mutex stats_mutex;
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  const char* log_filename = std::getenv("DALI_LOG_FILE");
+  std::ofstream log_file;
+  if (log_filename) log_file.open(log_filename);
+  std::ostream& out = log_filename ? log_file : std::cout;
+  out << "#################### CACHE STATS ####################" << std::endl;
+  out << "shared_cache: " << name_ << std::endl;
+  out << "cache_size: " << header_->data_size << std::endl;
+  out << "cache_threshold: " << image_size_threshold_ << std::endl;
+  out << "cache_used: " << header_->data_used << std::endl;
+  out << "images_cached: " << header_->num_entries << std::endl;
+  out << "processes_attached: " << header_->num_attached << std::endl;
+  out << "hits: " << hits_ << std::endl;
+  out << "misses: " << misses_ << std::endl;
+  out << "hit_rate: " << static_cast<double>(hits_) / (hits_ + misses_) << std::endl;
+  out << "#################### END   STATS ####################" << std::endl;
+}
+
+}  // namespace dali
@@ -0,0 +1,139 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_SHARED_H_
+#define DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_SHARED_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "dali/core/common.h"
+#include "dali/core/os/shared_mem.h"
+#include "dali/operators/decoder/cache/image_cache.h"
+
+namespace dali {
+
+/**
+ * @brief An image cache in host memory, shared by all the processes on a node
+ *
+ * The cache is a named POSIX shared memory segment, so the processes (e.g. the data-parallel
+ * ranks) which open the cache with the same name see each other's images. The segment holds
+ * an open-addressing index and the image data; the index is updated under a process-shared
+ * mutex, while the lookups are lock-free.
+ *
+ * As in ImageCacheBlob, the images are added until the cache is full and they are never evicted,
+ * so an image, once published, stays valid for the lifetime of the segment. An image is
+ * published only when its copy from the GPU is complete - until then, it's invisible to all the
+ * processes, including the one that added it.
+ *
+ * The segment is registered as pinned memory, so the images are returned by Get as host pointers
+ * (see IsHostData) suitable for asynchronous copies. It's removed when the last process detaches;
+ * if a process exits without detaching, the segment is left in /dev/shm and reused by the next
+ * processes opening the cache with the same name.
+ */
+class DLL_PUBLIC ImageCacheShared : public ImageCache {
+ public:
+  static constexpr int kMaxKeyLength = 256;
+
+  /**
+   * @param name the name identifying the cache on the node
+   * @param cache_size the size of the image data; it has to be the same in all the processes
+   */
+  DLL_PUBLIC ImageCacheShared(const std::string &name,
+                              std::size_t cache_size,
+                              std::size_t image_size_threshold,
+                              bool stats_enabled = false);
+
+  ~ImageCacheShared() override;
+
+  DISABLE_COPY_MOVE_ASSIGN(ImageCacheShared);
+
+  bool IsCached(const ImageKey& image_key) const override;
+
+  bool Read(const ImageKey& image_key,
+            void* destination_data,
+            cudaStream_t stream) const override;
+
+  const ImageShape& GetShape(const ImageKey& image_key) const override;
+
+  void Add(const ImageKey& image_key,
+           const uint8_t *data,
+           const ImageShape& data_shape,
+           cudaStream_t stream) override;
+
+  DecodedImage Get(const ImageKey &image_key) const override;
+
+  /**
+   * @remarks No-op - the images are published only after they are written
+   */
+  void SyncToRead(cudaStream_t stream) const override {}
+
+  bool IsHostData(const uint8_t *data) const override;
+
+  /**
+   * @brief Waits for the pending copies of the added images and publishes them
+   */
+  DLL_PUBLIC void Flush();
+
+  /// @brief The number of images in the cache, added by all the processes, published or not
+  DLL_PUBLIC std::size_t NumImages() const;
+
+ private:
+  struct Header;
+  struct Slot;
+
+  struct PendingWrite {
+    Slot *slot;
+    cudaEvent_t event;
+  };
+
+  /**
+   * @brief Finds the slot of the image or the first empty slot of its probe sequence
+   *
+   * @return nullptr if there's neither
+   */
+  Slot *Probe(const ImageKey &image_key, uint64_t hash) const;
+
+  /// @return the slot of a published image or nullptr
+  const Slot *Find(const ImageKey &image_key) const;
+
+  /// @brief Publishes the images whose copies are complete; requires mutex_ to be held
+  void PublishPending(bool wait) const;
+
+  void LockIndex() const;
+  void UnlockIndex() const;
+
+  void print_stats() const;
+
+  std::string name_;
+  std::size_t image_size_threshold_ = 0;
+  bool stats_enabled_ = false;
+
+  MemoryMapping mapping_;
+  Header *header_ = nullptr;
+  Slot *slots_ = nullptr;
+  uint8_t *data_ = nullptr;
+
+  // guards the members below, shared between the threads of this process
+  mutable std::mutex mutex_;
+  mutable std::vector<PendingWrite> pending_;
+  mutable std::vector<cudaEvent_t> free_events_;
+  mutable std::size_t hits_ = 0;
+  mutable std::size_t misses_ = 0;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_DECODER_CACHE_IMAGE_CACHE_SHARED_H_
@@ -0,0 +1,109 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/decoder/cache/image_cache_shared.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dali {
+namespace testing {
+
+namespace {
+
+constexpr std::size_t kCacheSize = 1 << 20;
+
+// unique for the test process, so that the tests running concurrently don't interfere
+std::string CacheName() {
+  return "dali_image_cache_test_" + std::to_string(getpid());
+}
+
+}  // namespace
+
+TEST(ImageCacheSharedTest, AddAndRead) {
+  ImageCacheShared cache(CacheName(), kCacheSize, 0);
+  std::vector<uint8_t> data(300, 0xAA);
+  EXPECT_FALSE(cache.IsCached("file1.jpg"));
+  cache.Add("file1.jpg", data.data(), {100, 1, 3}, 0);
+  cache.Flush();
+  ASSERT_TRUE(cache.IsCached("file1.jpg"));
+  EXPECT_EQ(cache.GetShape("file1.jpg"), ImageCache::ImageShape(100, 1, 3));
+  std::vector<uint8_t> cached_data(300);
+  EXPECT_TRUE(cache.Read("file1.jpg", cached_data.data(), 0));
+  EXPECT_EQ(cached_data, data);
+
+  auto img = cache.Get("file1.jpg");
+  ASSERT_TRUE(img.data);
+  EXPECT_TRUE(cache.IsHostData(img.data));
+  EXPECT_FALSE(cache.Get("file2.jpg").data);
+}
+
+TEST(ImageCacheSharedTest, SharedBetweenInstances) {
+  // the instances attached to the same segment behave like the caches of different processes
+  auto cache0 = std::make_unique<ImageCacheShared>(CacheName(), kCacheSize, 0);
+  auto cache1 = std::make_unique<ImageCacheShared>(CacheName(), kCacheSize, 0);
+  std::vector<uint8_t> data0(1000, 1), data1(2000, 2);
+  cache0->Add("file0.jpg", data0.data(), {10, 100, 1}, 0);
+  cache1->Add("file1.jpg", data1.data(), {20, 100, 1}, 0);
+  cache1->Add("file0.jpg", data0.data(), {10, 100, 1}, 0);  // already added by the other one
+  cache0->Flush();
+  cache1->Flush();
+  EXPECT_EQ(cache0->NumImages(), 2u);
+
+  std::vector<uint8_t> cached_data(2000);
+  ASSERT_TRUE(cache0->Read("file1.jpg", cached_data.data(), 0));
+  EXPECT_EQ(cached_data, data1);
+  cached_data.resize(1000);
+  ASSERT_TRUE(cache1->Read("file0.jpg", cached_data.data(), 0));
+  EXPECT_EQ(cached_data, data0);
+
+  // the segment outlives the instance which created it
+  cache0.reset();
+  EXPECT_TRUE(cache1->IsCached("file1.jpg"));
+  EXPECT_THROW(ImageCacheShared(CacheName(), 2 * kCacheSize, 0), std::exception);
+}
+
+TEST(ImageCacheSharedTest, RemovedWithLastInstance) {
+  std::vector<uint8_t> data(300, 0xAA);
+  {
+    ImageCacheShared cache(CacheName(), kCacheSize, 0);
+    cache.Add("file1.jpg", data.data(), {100, 1, 3}, 0);
+  }
+  // a new segment, possibly of a different size
+  ImageCacheShared cache(CacheName(), 2 * kCacheSize, 0);
+  EXPECT_FALSE(cache.IsCached("file1.jpg"));
+  EXPECT_EQ(cache.NumImages(), 0u);
+}
+
+TEST(ImageCacheSharedTest, Full) {
+  ImageCacheShared cache(CacheName(), kCacheSize, 1000);
+  std::vector<uint8_t> data(kCacheSize / 4, 0xAA);
+  ImageCache::ImageShape shape(static_cast<int64_t>(data.size()), 1, 1);
+  cache.Add("small.jpg", data.data(), {999, 1, 1}, 0);  // below the threshold
+  for (int i = 0; i < 5; i++)
+    cache.Add(std::to_string(i) + ".jpg", data.data(), shape, 0);
+  cache.Flush();
+  EXPECT_FALSE(cache.IsCached("small.jpg"));
+  for (int i = 0; i < 5; i++)
+    EXPECT_EQ(cache.IsCached(std::to_string(i) + ".jpg"), i < 4) << i;
+
+  std::string long_key(ImageCacheShared::kMaxKeyLength + 1, 'x');
+  cache.Add(long_key, data.data(), {1000, 1, 1}, 0);
+  EXPECT_FALSE(cache.IsCached(long_key));
+}
+
+}  // namespace testing
+}  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -29,8 +29,12 @@ class HostDecoder : public Operator<CPUBackend> {
   explicit inline HostDecoder(const OpSpec &spec) :
       Operator<CPUBackend>(spec),
       output_type_(spec.GetArgument<DALIImageType>("output_type")),
-      use_fast_idct_(spec.GetArgument<bool>("use_fast_idct"))
-  {}
+      use_fast_idct_(spec.GetArgument<bool>("use_fast_idct")),
+      min_decoded_size_(spec.GetRepeatedArgument<int>("min_decoded_size")) {
+    DALI_ENFORCE(min_decoded_size_.empty() || min_decoded_size_.size() == 2,
+                 make_string("`min_decoded_size` must have 2 elements: [height, width]. Got ",
+                             min_decoded_size_.size(), " elements."));
+  }
 
   inline ~HostDecoder() override = default;
   DISABLE_COPY_MOVE_ASSIGN(HostDecoder);
@@ -48,6 +52,7 @@ class HostDecoder : public Operator<CPUBackend> {
 
   DALIImageType output_type_;
   bool use_fast_idct_ = false;
+  std::vector<int> min_decoded_size_;
 };
 
 }  // namespace dali
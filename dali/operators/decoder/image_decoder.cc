@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -14,6 +14,7 @@
 
 #include "dali/pipeline/operator/operator.h"
 #include "dali/operators/decoder/host/host_decoder.h"
+#include "dali/operators/decoder/nvjpeg/huffman_cost_model.h"
 
 namespace dali {
 
@@ -33,13 +34,32 @@ following the YCbCr definition from ITU-R BT.601.
   .AddOptionalArg("hybrid_huffman_threshold",
       R"code(Applies **only** to the ``mixed`` backend type.
 
-Images with a total number of pixels (``height * width``) that is higher than this threshold will
-use the nvJPEG hybrid Huffman decoder. Images that have fewer pixels will use the nvJPEG host-side
-Huffman decoder.
+If specified, images with a total number of pixels (``height * width``) that is higher than this
+threshold will use the nvJPEG hybrid Huffman decoder. Images that have fewer pixels will use
+the nvJPEG host-side Huffman decoder.
+
+If not specified, the Huffman decoder is selected with the cost model described in
+``huffman_cost_model``.
 
 .. note::
   Hybrid Huffman decoder still largely uses the CPU.)code",
       1000u*1000u)
+  .AddOptionalArg("huffman_cost_model",
+      R"code(Applies **only** to the ``mixed`` backend type.
+
+The coefficients of the model used to select between the nvJPEG host-side and hybrid Huffman
+decoders, unless ``hybrid_huffman_threshold`` is specified.
+
+The model estimates the decoding time of each image from its encoded size, the number of decoded
+samples (which depends on the chroma subsampling), and the presence of restart markers. The batch
+is then split so that the CPU threads and the GPU are busy for a similar time. Progressive JPEGs
+always use the host-side decoder.
+
+The six coefficients, in nanoseconds, are the host decoder's time per encoded byte and per decoded
+sample, the hybrid decoder's CPU time per encoded byte, its GPU time per image and per encoded
+byte, and the speedup of the GPU decoding for images with restart markers. They can be
+calibrated for a given system and dataset with ``tools/huffman_cost_bench.py``.)code",
+      HuffmanCostModel::DefaultCoeffs())
   .AddOptionalArg("device_memory_padding",
       R"code(Applies **only** to the ``mixed`` backend type.
 
@@ -92,6 +112,13 @@ allocations will occur during the pipeline execution. One way to find the ideal
 do a complete run over the dataset with the ``memory_stats`` argument set to True, and then copy
 the largest allocation value that is printed in the statistics.)code",
       0)
+  .AddOptionalArg("num_streams_jpeg2k",
+      R"code(Applies **only** to the ``mixed`` backend type.
+
+The number of CUDA streams used by nvJPEG2k. The consecutive images are decoded in different
+streams, so that the decoding of small images overlaps, and the tiles of large tiled images are
+decoded in all the streams in parallel.)code",
+      4)
   .AddOptionalArg("hw_decoder_load",
       R"code(The percentage of the image data to be processed by the HW JPEG decoder.
 
@@ -102,6 +129,15 @@ if available. The optimal workload depends on the number of threads that are pro
 the DALI pipeline and should be found empirically. More details can be found at
 https://developer.nvidia.com/blog/loading-data-fast-with-dali-and-new-jpeg-decoder-in-a100)code",
       0.65f)
+  .AddOptionalArg("adaptive_hw_decoder_load",
+      R"code(If set to True, the share of the HW JPEG decoder is adjusted during the run.
+
+Applies **only** to the ``mixed`` backend type in NVIDIA Ampere GPU architecture.
+
+The decoding times of the HW decoder and of the CUDA decoder are measured in every iteration
+and ``hw_decoder_load`` is adjusted, so that both finish at the same time.
+The value of ``hw_decoder_load`` is used as the initial value.)code",
+      false)
   .AddOptionalArg("preallocate_width_hint",
       R"code(Image width hint.
 
@@ -144,6 +180,17 @@ the GPU implementation.
 According to the libjpeg-turbo documentation, decompression performance is improved by up to 14%
 with little reduction in quality.)code",
       false)
+  .AddOptionalArg("min_decoded_size",
+      R"code(Applies **only** to the ``cpu`` backend type.
+
+If specified, as ``[height, width]``, JPEG images may be decoded at 1/2, 1/4 or 1/8 of their
+resolution, using the DCT scaling of libjpeg-turbo, as long as the decoded image (or the region
+of interest, for the fused decoders) is at least this large. The largest such downscale is used.
+
+This significantly reduces the decoding time when the images are resized to a much smaller size
+afterwards - set it to the output size of the subsequent resize. The shape of the decoded image
+depends on the selected scale.)code",
+      std::vector<int>())
   .AddOptionalArg("memory_stats",
       R"code(Applies **only** to the ``mixed`` backend type.
 
@@ -175,6 +222,9 @@ The output of the decoder is in *HWC* layout.
 Supported formats: JPG, BMP, PNG, TIFF, PNM, PPM, PGM, PBM, JPEG 2000, WebP.
 Please note that GPU acceleration for JPEG 2000 decoding is only available for CUDA 11.
 
+With the ``mixed`` backend, the 8 and 16-bit PNG images which are not interlaced and don't use
+a palette are inflated in the CPU threads, and their color conversion runs on the GPU.
+
 .. note::
   WebP decoding currently only supports the simple file format (lossy and lossless compression).
   For details on the different WebP file formats, see
@@ -185,7 +235,9 @@ Please note that GPU acceleration for JPEG 2000 decoding is only available for C
   .NumInput(1)
   .NumOutput(1)
   .AddParent("ImageDecoderAttr")
-  .AddParent("CachedDecoderAttr");
+  .AddParent("CachedDecoderAttr")
+  .SampleChainable()
+  .IterationOverlap();
 
 // Fused
 
@@ -211,7 +263,8 @@ Supported formats: JPG, BMP, PNG, TIFF, PNM, PPM, PGM, PBM, JPEG 2000, WebP.
   .NumInput(1)
   .NumOutput(1)
   .AddParent("ImageDecoderAttr")
-  .AddParent("CropAttr");
+  .AddParent("CropAttr")
+  .IterationOverlap();
 
 DALI_SCHEMA(decoders__ImageRandomCrop)
   .DocStr(R"code(Decodes images and randomly crops them.
@@ -237,7 +290,8 @@ Supported formats: JPG, BMP, PNG, TIFF, PNM, PPM, PGM, PBM, JPEG 2000, WebP.
   .NumInput(1)
   .NumOutput(1)
   .AddParent("ImageDecoderAttr")
-  .AddParent("RandomCropAttr");
+  .AddParent("RandomCropAttr")
+  .IterationOverlap();
 
 
 DALI_SCHEMA(decoders__ImageSlice)
@@ -289,6 +343,7 @@ Supported formats: JPG, BMP, PNG, TIFF, PNM, PPM, PGM, PBM, JPEG 2000, WebP.
   .NumOutput(1)
   .AddParent("ImageDecoderAttr")
   .AddParent("SliceAttr")
+  .IterationOverlap()
   .InputDox(0, "data", "TensorList", R"code(Batch that contains the input data.)code")
   .InputDox(1, "anchor", "1D TensorList of float or int",
             R"code(Input that contains normalized or absolute coordinates for the starting
@@ -313,6 +368,8 @@ DALI_SCHEMA(ImageDecoder)
     .NumInput(1)
     .NumOutput(1)
     .AddParent("decoders__Image")
+    .SampleChainable()
+    .IterationOverlap()
     .MakeDocPartiallyHidden()
     .Deprecate(
         "decoders__Image",
@@ -327,6 +384,7 @@ DALI_SCHEMA(ImageDecoderCrop)
     .NumInput(1)
     .NumOutput(1)
     .AddParent("decoders__ImageCrop")
+    .IterationOverlap()
     .MakeDocPartiallyHidden()
     .Deprecate(
         "decoders__ImageCrop",
@@ -339,6 +397,7 @@ DALI_SCHEMA(ImageDecoderRandomCrop)
     .NumInput(1)
     .NumOutput(1)
     .AddParent("decoders__ImageRandomCrop")
+    .IterationOverlap()
     .MakeDocPartiallyHidden()
     .Deprecate(
         "decoders__ImageRandomCrop",
@@ -352,6 +411,7 @@ DALI_SCHEMA(ImageDecoderSlice)
     .NumInput(1, 3)
     .NumOutput(1)
     .AddParent("decoders__ImageSlice")
+    .IterationOverlap()
     .MakeDocPartiallyHidden()
     .Deprecate(
         "decoders__ImageSlice",
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_DECODER_NVJPEG_FUSED_NVJPEG_DECODER_RANDOM_CROP_H_
 #define DALI_OPERATORS_DECODER_NVJPEG_FUSED_NVJPEG_DECODER_RANDOM_CROP_H_
 
+#include <string>
 #include "dali/operators/decoder/nvjpeg/nvjpeg_decoder_decoupled_api.h"
 #include "dali/operators/image/crop/random_crop_attr.h"
 
@@ -29,6 +30,14 @@ class nvJPEGDecoderRandomCrop : public nvJPEGDecoder, public RandomCropAttr {
 
   DISABLE_COPY_MOVE_ASSIGN(nvJPEGDecoderRandomCrop);
 
+  std::string SaveState() override {
+    return RandomCropAttr::SaveState();
+  }
+
+  void RestoreState(const std::string &state) override {
+    RandomCropAttr::RestoreState(state);
+  }
+
  protected:
   CropWindowGenerator GetCropWindowGenerator(int data_idx) const override {
     return RandomCropAttr::GetCropWindowGenerator(data_idx);
@@ -0,0 +1,80 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <vector>
+#include "dali/core/error_handling.h"
+#include "dali/core/format.h"
+#include "dali/operators/decoder/nvjpeg/huffman_cost_model.h"
+
+namespace dali {
+
+constexpr int HuffmanCostModel::kNumCoeffs;
+
+HuffmanCostModel::HuffmanCostModel() {
+  auto coeffs = DefaultCoeffs();
+  SetCoeffs(make_cspan(coeffs));
+}
+
+void HuffmanCostModel::SetCoeffs(span<const float> coeffs) {
+  DALI_ENFORCE(coeffs.size() == kNumCoeffs,
+               make_string("The Huffman cost model requires ", kNumCoeffs, " coefficients, got ",
+                           coeffs.size(), "."));
+  for (float c : coeffs)
+    DALI_ENFORCE(c >= 0, "The coefficients of the Huffman cost model must not be negative.");
+  DALI_ENFORCE(coeffs[5] > 0, "The restart marker speedup must be positive.");
+  host_per_byte_ = coeffs[0];
+  host_per_sample_ = coeffs[1];
+  gpu_cpu_per_byte_ = coeffs[2];
+  gpu_per_image_ = coeffs[3];
+  gpu_per_byte_ = coeffs[4];
+  restart_speedup_ = coeffs[5];
+}
+
+void HuffmanCostModel::Route(std::vector<bool> &on_gpu, span<const JpegHuffmanFeatures> samples,
+                             int num_threads, float other_cpu_time) const {
+  int n = samples.size();
+  on_gpu.assign(n, false);
+  num_threads = std::max(num_threads, 1);
+
+  float cpu_time = other_cpu_time;
+  order_.clear();
+  for (int i = 0; i < n; i++) {
+    cpu_time += HostTime(samples[i]);
+    if (!samples[i].progressive && HostTime(samples[i]) > GpuCpuTime(samples[i]))
+      order_.push_back(i);
+  }
+  cpu_time /= num_threads;
+
+  // the CPU time saved per unit of the GPU time
+  auto gain = [&](int i) {
+    return (HostTime(samples[i]) - GpuCpuTime(samples[i])) / GpuTime(samples[i]);
+  };
+  std::sort(order_.begin(), order_.end(), [&](int a, int b) {
+    return gain(a) > gain(b);
+  });
+
+  float gpu_time = 0;
+  for (int i : order_) {
+    float new_cpu_time = cpu_time - (HostTime(samples[i]) - GpuCpuTime(samples[i])) / num_threads;
+    float new_gpu_time = gpu_time + GpuTime(samples[i]);
+    if (std::max(new_cpu_time, new_gpu_time) >= std::max(cpu_time, gpu_time))
+      break;
+    on_gpu[i] = true;
+    cpu_time = new_cpu_time;
+    gpu_time = new_gpu_time;
+  }
+}
+
+}  // namespace dali
@@ -0,0 +1,109 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_DECODER_NVJPEG_HUFFMAN_COST_MODEL_H_
+#define DALI_OPERATORS_DECODER_NVJPEG_HUFFMAN_COST_MODEL_H_
+
+#include <cstdint>
+#include <vector>
+#include "dali/core/api_helper.h"
+#include "dali/core/span.h"
+
+namespace dali {
+
+/**
+ * @brief The properties of an encoded JPEG which affect the cost of its Huffman decoding
+ */
+struct JpegHuffmanFeatures {
+  int64_t encoded_size = 0;  // bytes
+  /// The number of decoded component samples (e.g. 1.5 per pixel for 4:2:0), up to the last
+  /// row of the region of interest
+  int64_t num_samples = 0;
+  bool progressive = false;
+  bool restart_markers = false;
+};
+
+/**
+ * @brief Estimates the time of the host and the GPU (hybrid) Huffman decoding in nvJPEG
+ *        and splits a batch between them, so that the CPU threads and the GPU are busy
+ *        for a similar time.
+ *
+ * The model is linear in the features; the coefficients (in nanoseconds) are:
+ *  0. host Huffman decoding - CPU time per encoded byte,
+ *  1. host Huffman decoding - CPU time per decoded sample,
+ *  2. GPU Huffman decoding - CPU time per encoded byte (parsing and the transfer),
+ *  3. GPU Huffman decoding - fixed GPU time per image,
+ *  4. GPU Huffman decoding - GPU time per encoded byte,
+ *  5. GPU Huffman decoding - the speedup of the GPU time for images with restart markers.
+ *
+ * Progressive JPEGs are always decoded on the host.
+ */
+class DLL_PUBLIC HuffmanCostModel {
+ public:
+  static constexpr int kNumCoeffs = 6;
+
+  /// The default coefficients, fitted with tools/huffman_cost_bench.py
+  static std::vector<float> DefaultCoeffs() {
+    return { 8.0f, 0.5f, 1.0f, 40000.0f, 1.5f, 2.0f };
+  }
+
+  HuffmanCostModel();
+  explicit HuffmanCostModel(span<const float> coeffs) {
+    SetCoeffs(coeffs);
+  }
+
+  void SetCoeffs(span<const float> coeffs);
+
+  /// CPU time of the host Huffman decoding
+  float HostTime(const JpegHuffmanFeatures &f) const {
+    return host_per_byte_ * f.encoded_size + host_per_sample_ * f.num_samples;
+  }
+
+  /// CPU time of the GPU Huffman decoding
+  float GpuCpuTime(const JpegHuffmanFeatures &f) const {
+    return gpu_cpu_per_byte_ * f.encoded_size;
+  }
+
+  /// GPU time of the GPU Huffman decoding
+  float GpuTime(const JpegHuffmanFeatures &f) const {
+    float t = gpu_per_byte_ * f.encoded_size;
+    if (f.restart_markers)
+      t /= restart_speedup_;
+    return gpu_per_image_ + t;
+  }
+
+  /**
+   * @brief Selects the samples to be decoded with the GPU Huffman decoder.
+   *
+   * The samples which save the most CPU time per unit of GPU time are moved to the GPU,
+   * for as long as it shortens the estimated time of the batch, i.e. the greater of
+   * the CPU time (divided between `num_threads`) and the GPU time.
+   *
+   * @param on_gpu          output: for each sample, whether to use the GPU Huffman decoder
+   * @param samples         the samples to split
+   * @param num_threads     the number of CPU threads decoding the samples
+   * @param other_cpu_time  the time the CPU threads spend on other work (e.g. host fallback)
+   */
+  void Route(std::vector<bool> &on_gpu, span<const JpegHuffmanFeatures> samples,
+             int num_threads, float other_cpu_time = 0) const;
+
+ private:
+  float host_per_byte_, host_per_sample_;
+  float gpu_cpu_per_byte_, gpu_per_image_, gpu_per_byte_, restart_speedup_;
+  mutable std::vector<int> order_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_DECODER_NVJPEG_HUFFMAN_COST_MODEL_H_
@@ -0,0 +1,95 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "dali/operators/decoder/nvjpeg/huffman_cost_model.h"
+
+namespace dali {
+
+namespace {
+
+JpegHuffmanFeatures Features(int64_t encoded_size, bool progressive = false,
+                             bool restart_markers = false) {
+  JpegHuffmanFeatures f;
+  f.encoded_size = encoded_size;
+  f.num_samples = encoded_size * 10;
+  f.progressive = progressive;
+  f.restart_markers = restart_markers;
+  return f;
+}
+
+}  // namespace
+
+TEST(HuffmanCostModelTest, Costs) {
+  std::vector<float> coeffs = { 2, 0.5f, 1, 100, 0.5f, 4 };
+  HuffmanCostModel model(make_cspan(coeffs));
+  auto f = Features(1000);
+  EXPECT_FLOAT_EQ(model.HostTime(f), 2 * 1000 + 0.5f * 10000);
+  EXPECT_FLOAT_EQ(model.GpuCpuTime(f), 1000);
+  EXPECT_FLOAT_EQ(model.GpuTime(f), 100 + 0.5f * 1000);
+  f.restart_markers = true;
+  EXPECT_FLOAT_EQ(model.GpuTime(f), 100 + 0.5f * 1000 / 4);
+}
+
+TEST(HuffmanCostModelTest, InvalidCoeffs) {
+  std::vector<float> too_few = { 1, 2, 3 };
+  EXPECT_THROW(HuffmanCostModel(make_cspan(too_few)), std::exception);
+  std::vector<float> negative = { 1, -2, 3, 4, 5, 6 };
+  EXPECT_THROW(HuffmanCostModel(make_cspan(negative)), std::exception);
+  std::vector<float> zero_speedup = { 1, 2, 3, 4, 5, 0 };
+  EXPECT_THROW(HuffmanCostModel(make_cspan(zero_speedup)), std::exception);
+}
+
+TEST(HuffmanCostModelTest, RouteBalancesCpuAndGpu) {
+  // host: 10 per byte; GPU: 1 per byte CPU, 5 per byte GPU
+  std::vector<float> coeffs = { 10, 0, 1, 0, 5, 1 };
+  HuffmanCostModel model(make_cspan(coeffs));
+  std::vector<JpegHuffmanFeatures> samples(8, Features(100));
+  std::vector<bool> on_gpu;
+
+  // a single CPU thread is slower than the GPU - some samples go to the GPU
+  model.Route(on_gpu, make_cspan(samples), 1);
+  int ngpu = std::count(on_gpu.begin(), on_gpu.end(), true);
+  // k samples on GPU: CPU = (8 - k) * 1000 + k * 100, GPU = k * 500 -> the best is k = 6
+  EXPECT_EQ(ngpu, 6);
+
+  // with many threads, the CPU is faster - everything stays on the host
+  model.Route(on_gpu, make_cspan(samples), 64);
+  EXPECT_EQ(std::count(on_gpu.begin(), on_gpu.end(), true), 0);
+
+  // a busy CPU sends more samples to the GPU
+  model.Route(on_gpu, make_cspan(samples), 1, 4000);
+  EXPECT_GT(std::count(on_gpu.begin(), on_gpu.end(), true), ngpu);
+}
+
+TEST(HuffmanCostModelTest, RoutePrefersLargestGain) {
+  std::vector<float> coeffs = { 10, 0, 1, 1000, 5, 2 };
+  HuffmanCostModel model(make_cspan(coeffs));
+  std::vector<JpegHuffmanFeatures> samples = {
+    Features(100),                 // small - the fixed GPU cost dominates
+    Features(10000, true),         // progressive - can't use the GPU
+    Features(10000),
+    Features(10000, false, true),  // restart markers - cheaper on the GPU
+  };
+  std::vector<bool> on_gpu;
+  model.Route(on_gpu, make_cspan(samples), 2);
+  EXPECT_EQ(on_gpu, (std::vector<bool>{false, false, true, true}));
+  // with more threads, only the image with the largest gain goes to the GPU
+  model.Route(on_gpu, make_cspan(samples), 8);
+  EXPECT_EQ(on_gpu, (std::vector<bool>{false, false, false, true}));
+}
+
+}  // namespace dali
@@ -0,0 +1,46 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+#include "dali/core/error_handling.h"
+#include "dali/kernels/slice/slice_gpu.cuh"
+#include "dali/operators/decoder/nvjpeg/hw_decoder_crop.h"
+
+namespace dali {
+
+void CropDecodedImages(kernels::KernelManager &kmgr,
+                       const TensorListView<StorageGPU, uint8_t, 3> &out,
+                       const TensorListView<StorageGPU, const uint8_t, 3> &in,
+                       span<const CropWindow> rois, cudaStream_t stream) {
+  int nsamples = in.num_samples();
+  assert(out.num_samples() == nsamples && rois.size() == nsamples);
+  if (nsamples == 0)
+    return;
+  std::vector<kernels::SliceArgs<uint8_t, 3>> args(nsamples);
+  for (int i = 0; i < nsamples; i++) {
+    const auto &roi = rois[i];
+    int64_t nchannels = in.tensor_shape_span(i)[2];
+    args[i].anchor = { roi.anchor[0], roi.anchor[1], 0 };
+    args[i].shape = { roi.shape[0], roi.shape[1], nchannels };
+    assert(out.tensor_shape(i) == args[i].shape);
+  }
+  kernels::KernelContext ctx;
+  ctx.gpu.stream = stream;
+  using Kernel = kernels::SliceGPU<uint8_t, uint8_t, 3>;
+  kmgr.Resize<Kernel>(1);
+  kmgr.Setup<Kernel>(0, ctx, in, args);
+  kmgr.Run<Kernel>(0, ctx, out, in, args);
+}
+
+}  // namespace dali
@@ -0,0 +1,46 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_DECODER_NVJPEG_HW_DECODER_CROP_H_
+#define DALI_OPERATORS_DECODER_NVJPEG_HW_DECODER_CROP_H_
+
+#include <cuda_runtime.h>
+#include <stdint.h>
+#include "dali/core/span.h"
+#include "dali/core/tensor_view.h"
+#include "dali/kernels/kernel_manager.h"
+#include "dali/util/crop_window.h"
+
+namespace dali {
+
+/**
+ * @brief Crops a batch of decoded HWC images to their regions of interest, in a single kernel.
+ *
+ * Used when the HW decoder can't decode the regions of interest directly - the images are then
+ * decoded in full to an intermediate buffer.
+ *
+ * @param kmgr    the kernel manager which keeps the state of the kernel
+ * @param out     the cropped images; the shape of the i-th image is the shape of `rois[i]`
+ *                and the number of channels of `in[i]`
+ * @param in      the full images
+ * @param rois    the regions of interest, in HW order
+ */
+void CropDecodedImages(kernels::KernelManager &kmgr,
+                       const TensorListView<StorageGPU, uint8_t, 3> &out,
+                       const TensorListView<StorageGPU, const uint8_t, 3> &in,
+                       span<const CropWindow> rois, cudaStream_t stream);
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_DECODER_NVJPEG_HW_DECODER_CROP_H_
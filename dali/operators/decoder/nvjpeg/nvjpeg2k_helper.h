@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -26,6 +26,13 @@
 #include "dali/core/common.h"
 #include "dali/core/cuda_error.h"
 
+// nvjpeg2kDecodeTile and the decode params are available since nvJPEG2000 0.3
+#if defined(NVJPEG2K_VER_MAJOR) && (NVJPEG2K_VER_MAJOR > 0 || NVJPEG2K_VER_MINOR >= 3)
+#define NVJPEG2K_DECODE_TILE_API 1
+#else
+#define NVJPEG2K_DECODE_TILE_API 0
+#endif
+
 namespace dali {
 
 class Nvjpeg2kError : public std::runtime_error {
@@ -139,6 +146,8 @@ struct NvJPEG2KStream : public UniqueHandle<nvjpeg2kStream_t, NvJPEG2KStream> {
 struct NvJPEG2KDecodeState : public UniqueHandle<nvjpeg2kDecodeState_t, NvJPEG2KDecodeState> {
   DALI_INHERIT_UNIQUE_HANDLE(nvjpeg2kDecodeState_t, NvJPEG2KDecodeState);
 
+  NvJPEG2KDecodeState() = default;
+
   explicit NvJPEG2KDecodeState(nvjpeg2kHandle_t nvjpeg2k_handle) {
     CUDA_CALL(nvjpeg2kDecodeStateCreate(nvjpeg2k_handle, &handle_));
   }
@@ -150,6 +159,24 @@ struct NvJPEG2KDecodeState : public UniqueHandle<nvjpeg2kDecodeState_t, NvJPEG2K
   }
 };
 
+#if NVJPEG2K_DECODE_TILE_API
+struct NvJPEG2KDecodeParams : public UniqueHandle<nvjpeg2kDecodeParams_t, NvJPEG2KDecodeParams> {
+  DALI_INHERIT_UNIQUE_HANDLE(nvjpeg2kDecodeParams_t, NvJPEG2KDecodeParams);
+
+  static NvJPEG2KDecodeParams Create() {
+    nvjpeg2kDecodeParams_t handle{};
+    CUDA_CALL(nvjpeg2kDecodeParamsCreate(&handle));
+    return NvJPEG2KDecodeParams(handle);
+  }
+
+  static constexpr nvjpeg2kDecodeParams_t null_handle() { return nullptr; }
+
+  static void DestroyHandle(nvjpeg2kDecodeParams_t handle) {
+    nvjpeg2kDecodeParamsDestroy(handle);
+  }
+};
+#endif  // NVJPEG2K_DECODE_TILE_API
+
 }  // namespace dali
 
 #endif  // NVJPEG2K_ENABLED
@@ -15,6 +15,8 @@
 #ifndef DALI_OPERATORS_DECODER_NVJPEG_NVJPEG_DECODER_DECOUPLED_API_H_
 #define DALI_OPERATORS_DECODER_NVJPEG_NVJPEG_DECODER_DECOUPLED_API_H_
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <string>
 #include <utility>
@@ -24,14 +26,19 @@
 #include <atomic>
 #include "dali/pipeline/operator/operator.h"
 #include "dali/operators/decoder/nvjpeg/nvjpeg_helper.h"
+#include "dali/operators/decoder/nvjpeg/huffman_cost_model.h"
+#include "dali/operators/decoder/nvjpeg/hw_decoder_crop.h"
 #include "dali/operators/decoder/nvjpeg/nvjpeg_memory.h"
 #include "dali/operators/decoder/nvjpeg/nvjpeg2k_helper.h"
+#include "dali/operators/decoder/nvjpeg/png_convert.h"
+#include "dali/operators/decoder/nvjpeg/png_decode.h"
 #include "dali/operators/decoder/cache/cached_decoder_impl.h"
 #include "dali/core/mm/memory.h"
 #include "dali/util/image.h"
 #include "dali/util/ocv.h"
 #include "dali/util/nvml.h"
 #include "dali/image/image_factory.h"
+#include "dali/image/image_info.h"
 #include "dali/pipeline/util/thread_pool.h"
 #include "dali/core/device_guard.h"
 #include "dali/core/dev_buffer.h"
@@ -57,6 +64,8 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
     CachedDecoderImpl(spec),
     output_image_type_(spec.GetArgument<DALIImageType>("output_type")),
     hybrid_huffman_threshold_(spec.GetArgument<unsigned int>("hybrid_huffman_threshold")),
+    // an explicit threshold selects the Huffman decoder by the image size alone
+    use_huffman_cost_model_(!spec.HasArgument("hybrid_huffman_threshold")),
     use_fast_idct_(spec.GetArgument<bool>("use_fast_idct")),
     output_shape_(max_batch_size_, kOutputDim),
     pinned_buffers_(num_threads_*2),
@@ -66,14 +75,14 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
     hw_decoder_jpeg_streams_(num_threads_),
 #endif
 #if NVJPEG2K_ENABLED
-    nvjpeg2k_intermediate_buffer_(),
+    nvjpeg2k_lanes_(NumStreamsJpeg2k(spec)),
     nvjpeg2k_dev_alloc_(nvjpeg_memory::GetDeviceAllocatorNvJpeg2k()),
     nvjpeg2k_pin_alloc_(nvjpeg_memory::GetPinnedAllocatorNvJpeg2k()),
     nvjpeg2k_streams_(max_batch_size_),
 #endif  // NVJPEG2K_ENABLED
-    device_buffers_(num_threads_),
+    device_buffers_(num_threads_*2),
     streams_(num_threads_),
-    decode_events_(num_threads_),
+    decode_events_(num_threads_*2),
     thread_page_ids_(num_threads_),
     device_id_(spec.GetArgument<int>("device_id")),
     device_allocator_(nvjpeg_memory::GetDeviceAllocator()),
@@ -86,18 +95,34 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
                      spec.GetArgument<int>("device_id"),
                      spec.GetArgument<bool>("affine"),
                      "image decoder nvJPEG2k") {
+    auto huffman_cost_coeffs = spec.GetRepeatedArgument<float>("huffman_cost_model");
+    huffman_cost_model_.SetCoeffs(make_cspan(huffman_cost_coeffs));
+
+    size_t device_memory_padding = spec.GetArgument<Index>("device_memory_padding");
+    size_t host_memory_padding = spec.GetArgument<Index>("host_memory_padding");
+    size_t device_memory_padding_jpeg2k = spec.GetArgument<Index>("device_memory_padding_jpeg2k");
+    size_t host_memory_padding_jpeg2k = spec.GetArgument<Index>("host_memory_padding_jpeg2k");
+
+    // The library handles are shared by all the decoders in the process
+    auto acquire_handle = [&](nvjpegBackend_t backend) {
+      shared_handle_ = GetSharedNvjpegHandle(device_id_, backend,
+                                             device_memory_padding, host_memory_padding);
+      handle_ = shared_handle_.get();
+      return handle_ != nullptr;
+    };
+
 #if IS_HW_DECODER_COMPATIBLE
     // if hw_decoder_load is not present in the schema (crop/sliceDecoder) then it is not supported
     bool try_init_hw_decoder = false;
     if (spec_.GetSchema().HasArgument("hw_decoder_load")) {
       hw_decoder_load_ = spec.GetArgument<float>("hw_decoder_load");
+      adaptive_hw_decoder_load_ = spec.GetArgument<bool>("adaptive_hw_decoder_load");
       try_init_hw_decoder = true;
     } else {
       hw_decoder_load_ = 0;
     }
 
-    if (try_init_hw_decoder &&
-        nvjpegCreate(NVJPEG_BACKEND_HARDWARE, NULL, &handle_) == NVJPEG_STATUS_SUCCESS) {
+    if (try_init_hw_decoder && acquire_handle(NVJPEG_BACKEND_HARDWARE)) {
     // disable HW decoder for drivers < 455.x as the memory pool for it is not available
     // and multi GPU performance is far from perfect due to frequent memory allocations
 #if NVML_ENABLED
@@ -106,19 +131,21 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
       if (driverVersion < 455) {
         try_init_hw_decoder = false,
         hw_decoder_load_ = 0;
-        CUDA_CALL(nvjpegDestroy(handle_));
+        adaptive_hw_decoder_load_ = false;
         LOG_LINE << "NVJPEG_BACKEND_HARDWARE is disabled due to performance reason" << std::endl;
-        CUDA_CALL(nvjpegCreateSimple(&handle_));
+        acquire_handle(NVJPEG_BACKEND_DEFAULT);
         DALI_WARN("Due to performance reason HW NVJPEG decoder is disbaled for the driver "
                   "older than 455.x");
       } else {
 #endif
         LOG_LINE << "Using NVJPEG_BACKEND_HARDWARE" << std::endl;
         CUDA_CALL(nvjpegJpegStateCreate(handle_, &state_hw_batched_));
+        // in the adaptive mode, the whole batch may end up in the HW decoder
+        float max_hw_decoder_load = adaptive_hw_decoder_load_ ? 1.f : hw_decoder_load_;
         if (!RestrictPinnedMemUsage()) {
           hw_decoder_images_staging_.set_pinned(true);
           // assume close the worst case size 300kb per image
-          auto shapes = uniform_list_shape(CalcHwDecoderBatchSize(hw_decoder_load_,
+          auto shapes = uniform_list_shape(CalcHwDecoderBatchSize(max_hw_decoder_load,
                                            max_batch_size_), TensorShape<1>{300*1024});
           hw_decoder_images_staging_.Resize(shapes, DALI_UINT8);
         }
@@ -144,7 +171,7 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
           CUDA_CALL(nvjpegDecodeBatchedPreAllocate(
             handle_,
             state_hw_batched_,
-            CalcHwDecoderBatchSize(hw_decoder_load_, max_batch_size_),
+            CalcHwDecoderBatchSize(max_hw_decoder_load, max_batch_size_),
             preallocate_width_hint,
             preallocate_height_hint,
             NVJPEG_CSS_444,
@@ -162,19 +189,13 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 #endif
     } else {
       LOG_LINE << "NVJPEG_BACKEND_HARDWARE is either disabled or not supported" << std::endl;
-      CUDA_CALL(nvjpegCreateSimple(&handle_));
+      acquire_handle(NVJPEG_BACKEND_DEFAULT);
+      adaptive_hw_decoder_load_ = false;
     }
 #else
-    CUDA_CALL(nvjpegCreateSimple(&handle_));
+    acquire_handle(NVJPEG_BACKEND_DEFAULT);
 #endif
 
-    size_t device_memory_padding = spec.GetArgument<Index>("device_memory_padding");
-    size_t host_memory_padding = spec.GetArgument<Index>("host_memory_padding");
-    size_t device_memory_padding_jpeg2k = spec.GetArgument<Index>("device_memory_padding_jpeg2k");
-    size_t host_memory_padding_jpeg2k = spec.GetArgument<Index>("host_memory_padding_jpeg2k");
-    CUDA_CALL(nvjpegSetDeviceMemoryPadding(device_memory_padding, handle_));
-    CUDA_CALL(nvjpegSetPinnedMemoryPadding(host_memory_padding, handle_));
-
     nvjpegDevAllocator_t *device_allocator_ptr = &device_allocator_;
     nvjpegPinnedAllocator_t *pinned_allocator_ptr = &pinned_allocator_;
 
@@ -220,6 +241,19 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
     CUDA_CALL(cudaEventCreate(&hw_decode_event_));
     CUDA_CALL(cudaEventRecord(hw_decode_event_, hw_decode_stream_));
 
+#if ZLIB_ENABLED
+    png_scratch_.resize(num_threads_);
+    png_staging_.set_pinned(true);
+    CUDA_CALL(cudaEventCreate(&png_copy_event_));
+    CUDA_CALL(cudaEventRecord(png_copy_event_, hw_decode_stream_));
+#endif  // ZLIB_ENABLED
+
+    if (adaptive_hw_decoder_load_) {
+      CUDA_CALL(cudaEventCreate(&hw_timing_start_));
+      CUDA_CALL(cudaEventCreate(&hw_timing_end_));
+      cuda_path_end_.resize(num_threads_);
+    }
+
 #if NVJPEG2K_ENABLED
     auto nvjpeg2k_thread_id = nvjpeg2k_thread_.GetThreadIds()[0];
     nvjpeg2k_thread_.AddWork([this, device_memory_padding_jpeg2k, host_memory_padding_jpeg2k,
@@ -237,7 +271,8 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
         nvjpeg_memory::AddBuffer<mm::memory_kind::device>(nvjpeg2k_thread_id, 1024);
         nvjpeg_memory::AddBuffer<mm::memory_kind::device>(nvjpeg2k_thread_id, 4 * 1024);
         nvjpeg_memory::AddBuffer<mm::memory_kind::device>(nvjpeg2k_thread_id, 16 * 1024);
-        nvjpeg2k_intermediate_buffer_.resize(device_memory_padding_jpeg2k / 8);
+        for (auto &lane : nvjpeg2k_lanes_)
+          lane.intermediate_buffer.resize(device_memory_padding_jpeg2k / 8);
         nvjpeg_memory::AddBuffer<mm::memory_kind::device>(nvjpeg2k_thread_id,
                                  device_memory_padding_jpeg2k);
         nvjpeg_memory::AddBuffer<mm::memory_kind::device>(nvjpeg2k_thread_id,
@@ -247,14 +282,21 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
         nvjpeg_memory::AddBuffer<mm::memory_kind::pinned>(nvjpeg2k_thread_id,
                                                           host_memory_padding_jpeg2k);
       }
-      nvjpeg2k_decoder_ = NvJPEG2KDecodeState(nvjpeg2k_handle_);
+      for (auto &lane : nvjpeg2k_lanes_) {
+        lane.decode_state = NvJPEG2KDecodeState(nvjpeg2k_handle_);
+#if NVJPEG2K_DECODE_TILE_API
+        lane.decode_params = NvJPEG2KDecodeParams::Create();
+#endif  // NVJPEG2K_DECODE_TILE_API
+      }
     });
     nvjpeg2k_thread_.RunAll();
 
-    CUDA_CALL(cudaStreamCreateWithPriority(&nvjpeg2k_cu_stream_, cudaStreamNonBlocking,
-                                           default_cuda_stream_priority_));
-    CUDA_CALL(cudaEventCreate(&nvjpeg2k_decode_event_));
-    CUDA_CALL(cudaEventRecord(nvjpeg2k_decode_event_, nvjpeg2k_cu_stream_));
+    for (auto &lane : nvjpeg2k_lanes_) {
+      CUDA_CALL(cudaStreamCreateWithPriority(&lane.stream, cudaStreamNonBlocking,
+                                             default_cuda_stream_priority_));
+      CUDA_CALL(cudaEventCreate(&lane.event));
+      CUDA_CALL(cudaEventRecord(lane.event, lane.stream));
+    }
 
     for (auto &stream : nvjpeg2k_streams_) {
       stream = NvJPEG2KStream::Create();
@@ -297,6 +339,16 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
         CUDA_CALL(cudaEventDestroy(event));
       }
       CUDA_CALL(cudaEventDestroy(hw_decode_event_));
+#if ZLIB_ENABLED
+      CUDA_CALL(cudaEventSynchronize(png_copy_event_));
+      CUDA_CALL(cudaEventDestroy(png_copy_event_));
+#endif  // ZLIB_ENABLED
+      if (hw_timing_start_) {
+        CUDA_CALL(cudaEventDestroy(hw_timing_start_));
+      }
+      if (hw_timing_end_) {
+        CUDA_CALL(cudaEventDestroy(hw_timing_end_));
+      }
 
       for (auto &stream : streams_) {
         CUDA_CALL(cudaStreamDestroy(stream));
@@ -307,7 +359,7 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
         CUDA_CALL(nvjpegJpegStateDestroy(state_hw_batched_));
       }
 
-      CUDA_CALL(nvjpegDestroy(handle_));
+      shared_handle_.reset();
 
       // Free any remaining buffers and remove the thread entry from the global map
       for (auto thread_id : thread_pool_.GetThreadIds()) {
@@ -315,8 +367,10 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
       }
 
 #if NVJPEG2K_ENABLED
-      CUDA_CALL(cudaEventDestroy(nvjpeg2k_decode_event_));
-      CUDA_CALL(cudaStreamDestroy(nvjpeg2k_cu_stream_));
+      for (auto &lane : nvjpeg2k_lanes_) {
+        CUDA_CALL(cudaEventDestroy(lane.event));
+        CUDA_CALL(cudaStreamDestroy(lane.stream));
+      }
       for (auto thread_id : nvjpeg2k_thread_.GetThreadIds()) {
         nvjpeg_memory::DeleteAllBuffers(thread_id);
       }
@@ -332,6 +386,8 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const MixedWorkspace &ws) override {
     auto curr_batch_size = ws.GetInputBatchSize(0);
+    if (adaptive_hw_decoder_load_)
+      UpdateHwDecoderLoad();
     hw_decoder_bs_ = CalcHwDecoderBatchSize(hw_decoder_load_, curr_batch_size);
     return false;
   }
@@ -355,6 +411,9 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 #if NVJPEG2K_ENABLED
     Nvjpeg2k,
 #endif  // NVJPEG2K_ENABLED
+#if ZLIB_ENABLED
+    Png,
+#endif  // ZLIB_ENABLED
     Cache,
   };
 
@@ -371,7 +430,14 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
     TensorShape<> shape;
     int req_nchannels = -1;
     int bpp = 8;  // currently used for jpeg2k only
+    // the tiling of a jpeg2k image
+    int tile_height = 0, tile_width = 0;
+    int num_tiles_y = 1, num_tiles_x = 1;
     CropWindow roi;
+    // the HW decoder can't decode the ROI - the image is decoded in full and then cropped
+    bool hw_decode_full = false;
+    JpegHuffmanFeatures huffman_features;
+    PngInfo png_info;
     DecodeMethod method = DecodeMethod::Host;
     nvjpegDecodeParams_t params;
     nvjpegChromaSubsampling_t subsampling = NVJPEG_CSS_UNKNOWN;
@@ -399,8 +465,13 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
       sample_idx = -1;
       encoded_length = 0;
       bpp = 8;
+      tile_height = tile_width = 0;
+      num_tiles_y = num_tiles_x = 1;
       selected_decoder = nullptr;
       is_progressive = false;
+      hw_decode_full = false;
+      huffman_features = {};
+      png_info = {};
       req_nchannels = -1;
       method = DecodeMethod::Host;
       subsampling = NVJPEG_CSS_UNKNOWN;
@@ -433,10 +504,13 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
   std::vector<SampleData> sample_data_;
 
   std::vector<SampleData*> samples_cache_;
+  std::vector<std::string> cache_keys_;
+  std::vector<ImageCache::ImageShape> cached_shapes_;  // empty for the samples not cached
   std::vector<SampleData*> samples_host_;
   std::vector<SampleData*> samples_hw_batched_;
   std::vector<SampleData*> samples_single_;
   std::vector<SampleData*> samples_jpeg2k_;
+  std::vector<SampleData*> samples_png_;
 
   nvjpegJpegState_t state_hw_batched_ = nullptr;
 
@@ -494,24 +568,94 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
       samples_single_.push_back(samples_hw_batched_.back());
       samples_hw_batched_.pop_back();
 
-      auto &data = *samples_single_.back();
-      data.method = DecodeMethod::NvjpegCuda;
-      int64_t sz = data.roi
-        ? data.roi.shape[1] * (data.roi.anchor[0] + data.roi.shape[0])
-        : data.shape[0] * data.shape[1];
-      if (sz > hybrid_huffman_threshold_ && !data.is_progressive) {
-        data.selected_decoder = &data.decoders[NVJPEG_BACKEND_GPU_HYBRID];
-      } else {
-        data.selected_decoder = &data.decoders[NVJPEG_BACKEND_HYBRID];
-      }
+      samples_single_.back()->method = DecodeMethod::NvjpegCuda;
     }
 
+    SelectHuffmanDecoders();
+
     if (sort_method != SORT_METHOD_NO_SORTING) {
       std::sort(samples_single_.begin(), samples_single_.end(), sample_order);
       std::sort(samples_host_.begin(), samples_host_.end(), sample_order);
     }
   }
 
+  static float SamplesPerPixel(nvjpegChromaSubsampling_t subsampling, int nchannels) {
+    switch (subsampling) {
+      case NVJPEG_CSS_444:
+        return 3;
+      case NVJPEG_CSS_422:
+      case NVJPEG_CSS_440:
+        return 2;
+      case NVJPEG_CSS_420:
+      case NVJPEG_CSS_411:
+        return 1.5f;
+      case NVJPEG_CSS_410:
+        return 1.25f;
+      case NVJPEG_CSS_GRAY:
+        return 1;
+      case NVJPEG_CSS_UNKNOWN:
+      default:
+        return nchannels;
+    }
+  }
+
+  /**
+   * @brief Selects the host or the GPU (hybrid) Huffman decoder for the samples decoded with CUDA
+   *
+   * With the cost model, the batch is split so that the thread pool and the GPU are busy for
+   * a similar time; the host-decoded samples add to the load of the thread pool.
+   * Otherwise, the images larger than hybrid_huffman_threshold use the GPU Huffman decoder.
+   */
+  void SelectHuffmanDecoders() {
+    if (use_huffman_cost_model_) {
+      huffman_features_.clear();
+      for (auto *sample : samples_single_)
+        huffman_features_.push_back(sample->huffman_features);
+      float host_fallback_time = 0;
+      for (auto *sample : samples_host_) {
+        JpegHuffmanFeatures features;
+        features.encoded_size = sample->encoded_length;
+        features.num_samples = volume(sample->shape);
+        host_fallback_time += huffman_cost_model_.HostTime(features);
+      }
+      huffman_cost_model_.Route(use_gpu_huffman_, make_cspan(huffman_features_), num_threads_,
+                                host_fallback_time);
+    }
+    for (size_t i = 0; i < samples_single_.size(); i++) {
+      auto &data = *samples_single_[i];
+      bool gpu_huffman;
+      if (use_huffman_cost_model_) {
+        gpu_huffman = use_gpu_huffman_[i];
+      } else {
+        int64_t sz = data.roi
+          ? data.roi.shape[1] * (data.roi.anchor[0] + data.roi.shape[0])
+          : data.shape[0] * data.shape[1];
+        gpu_huffman = sz > hybrid_huffman_threshold_ && !data.is_progressive;
+      }
+      data.selected_decoder = gpu_huffman ? &data.decoders[NVJPEG_BACKEND_GPU_HYBRID]
+                                          : &data.decoders[NVJPEG_BACKEND_HYBRID];
+    }
+  }
+
+  bool ParsePng(SampleData &data, span<const uint8_t> input) {
+#if ZLIB_ENABLED
+    auto &info = data.png_info;
+    if (!ParsePngHeader(input, info) || !IsPngRegionDecodingSupported(info))
+      return false;
+    // the CPU decoder keeps 16 bits per sample when the output has the channels of the image
+    // and there are 4 of them - the output would not be 8-bit
+    if (output_image_type_ == DALI_ANY_DATA && info.bit_depth == 16 &&
+        info.color_type == PngInfo::kRGBA)
+      return false;
+    // the alpha of the grayscale images is dropped, as in the CPU decoder
+    int channels = info.color_type == PngInfo::kRGBA ? 4 : info.color_type == PngInfo::kRGB ? 3 : 1;
+    data.shape = {info.height, info.width, channels};
+    data.method = DecodeMethod::Png;
+    return true;
+#endif  // ZLIB_ENABLED
+    return false;
+  }
+
   bool ParseNvjpeg2k(SampleData &data, span<const uint8_t> input) {
 #if NVJPEG2K_ENABLED
     if (!nvjpeg2k_handle_) {
@@ -538,6 +682,10 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
       }
       data.shape = {height, width, image_info.num_components};
       data.req_nchannels = NumberOfChannels(output_image_type_, data.shape[2]);
+      data.tile_height = std::min(image_info.tile_height, height);
+      data.tile_width = std::min(image_info.tile_width, width);
+      data.num_tiles_y = image_info.num_tiles_y;
+      data.num_tiles_x = image_info.num_tiles_x;
       data.method = DecodeMethod::Nvjpeg2k;
       return true;
     }
@@ -555,20 +703,30 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 #if NVJPEG2K_ENABLED
     samples_jpeg2k_.clear();
 #endif  // NVJPEG2K_ENABLED
+    samples_png_.clear();
 
     const auto &input = ws.Input<CPUBackend>(0);
+    cached_shapes_.resize(curr_batch_size);
+    if (IsCacheEnabled()) {
+      // a single lookup for the whole batch, instead of one per sample in each of the threads
+      cache_keys_.resize(curr_batch_size);
+      for (int i = 0; i < curr_batch_size; i++)
+        cache_keys_[i] = input.GetMeta(i).GetSourceInfo();
+      CacheImageShapes(make_cspan(cache_keys_), make_span(cached_shapes_));
+    }
     for (int i = 0; i < curr_batch_size; i++) {
       auto *input_data = input.tensor<uint8_t>(i);
       const auto in_size = input.tensor_shape(i).num_elements();
       const auto &source_info = input.GetMeta(i).GetSourceInfo();
-      thread_pool_.AddWork([this, i, input_data, in_size, source_info](int tid) {
+      const ImageInfo *image_info = &input.GetMeta(i).GetImageInfo();
+      thread_pool_.AddWork([this, i, input_data, in_size, source_info, image_info](int tid) {
         SampleData &data = sample_data_[i];
         data.clear();
         data.sample_idx = i;
         data.file_name = source_info;
         data.encoded_length = in_size;
 
-        auto cached_shape = CacheImageShape(data.file_name);
+        const auto &cached_shape = cached_shapes_[i];
         if (volume(cached_shape) > 0) {
           data.method = DecodeMethod::Cache;
           data.shape = cached_shape;
@@ -576,10 +734,19 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
           return;
         }
 
+        // the header info parsed by the reader tells which parsers can accept the image
+        bool known_format = image_info->IsValidFor(in_size);
+        auto is_format = [&](ImageFormat format) {
+          return !known_format || image_info->format == format;
+        };
+
         int widths[NVJPEG_MAX_COMPONENT], heights[NVJPEG_MAX_COMPONENT], c;
         nvjpegChromaSubsampling_t subsampling;
-        nvjpegStatus_t ret = nvjpegGetImageInfo(handle_, input_data, in_size, &c,
-                                                &subsampling, widths, heights);
+        nvjpegStatus_t ret = NVJPEG_STATUS_BAD_JPEG;
+        if (is_format(ImageFormat::Jpeg)) {
+          ret = nvjpegGetImageInfo(handle_, input_data, in_size, &c, &subsampling, widths,
+                                   heights);
+        }
         bool hw_decode = false;
         bool nvjpeg_decode = (ret == NVJPEG_STATUS_SUCCESS);
 
@@ -587,12 +754,19 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
         if (nvjpeg_decode) {
           data.shape = {heights[0], widths[0], c};
           data.subsampling = subsampling;
-        } else if (crop_generator || !ParseNvjpeg2k(data,
-                                                    span<const uint8_t>(input_data, in_size))) {
+        } else if (is_format(ImageFormat::Png) &&
+                   ParsePng(data, span<const uint8_t>(input_data, in_size))) {
+          // inflated on the CPU and converted on the GPU
+        } else if (crop_generator || !is_format(ImageFormat::Jpeg2k) ||
+                   !ParseNvjpeg2k(data, span<const uint8_t>(input_data, in_size))) {
           try {
             data.method = DecodeMethod::Host;
-            auto image = ImageFactory::CreateImage(input_data, in_size, output_image_type_);
-            data.shape = image->PeekShape();
+            if (known_format) {
+              data.shape = image_info->shape;
+            } else {
+              auto image = ImageFactory::CreateImage(input_data, in_size, output_image_type_);
+              data.shape = image->PeekShape();
+            }
           } catch (const std::runtime_error &e) {
             DALI_FAIL(e.what() + ". File: " + data.file_name);
           }
@@ -623,14 +797,15 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
             if (ret == NVJPEG_STATUS_SUCCESS) {
               int is_supported = -1;
               // if nvjpegDecodeBatchedSupportedEx is not available ROI support in HW decoder is
-              // not available, so check only if we can decode images without ROI
-              // otherwise use the hybrid approach
+              // not available, so check only if we can decode images without ROI;
+              // the images with ROI are then decoded in full and cropped
               if (nvjpegIsSymbolAvailable("nvjpegDecodeBatchedSupportedEx")) {
                 CUDA_CALL(nvjpegDecodeBatchedSupportedEx(handle_, hw_decoder_jpeg_streams_[tid],
                                                          data.params, &is_supported));
-              } else if (!crop_generator) {
+              } else {
                 CUDA_CALL(nvjpegDecodeBatchedSupported(handle_, hw_decoder_jpeg_streams_[tid],
                                                        &is_supported));
+                data.hw_decode_full = crop_generator && is_supported == 0;
               }
               hw_decode = is_supported == 0;
             }
@@ -649,16 +824,19 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
           }
         }
 
-        data.is_progressive = IsProgressiveJPEG(input_data, in_size);
-        if (data.method == DecodeMethod::NvjpegCuda) {
-          int64_t sz = data.roi
+        data.is_progressive = known_format ? image_info->progressive
+                                           : IsProgressiveJPEG(input_data, in_size);
+        if (data.method == DecodeMethod::NvjpegCuda || data.method == DecodeMethod::NvjpegHw) {
+          // the samples for the HW decoder may be moved to the CUDA decoder
+          auto &features = data.huffman_features;
+          int64_t npixels = data.roi
             ? data.roi.shape[1] * (data.roi.anchor[0] + data.roi.shape[0])
             : data.shape[0] * data.shape[1];
-          if (sz > hybrid_huffman_threshold_ && !data.is_progressive) {
-            data.selected_decoder = &data.decoders[NVJPEG_BACKEND_GPU_HYBRID];
-          } else {
-            data.selected_decoder = &data.decoders[NVJPEG_BACKEND_HYBRID];
-          }
+          features.encoded_size = in_size;
+          features.num_samples = npixels * SamplesPerPixel(data.subsampling, data.shape[2]);
+          features.progressive = data.is_progressive;
+          if (use_huffman_cost_model_ && !data.is_progressive)
+            features.restart_markers = HasRestartMarkers(input_data, in_size);
         }
       }, in_size);
     }
@@ -684,6 +862,11 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
           samples_jpeg2k_.push_back(&data);
           break;
       #endif  // NVJPEG2K_ENABLED
+      #if ZLIB_ENABLED
+        case DecodeMethod::Png:
+          samples_png_.push_back(&data);
+          break;
+      #endif  // ZLIB_ENABLED
         default:
           DALI_FAIL(make_string("Unknown decoder backend ", static_cast<int>(data.method)));
       }
@@ -696,11 +879,19 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 
   void ProcessImagesCache(MixedWorkspace &ws) {
     auto& output = ws.Output<GPUBackend>(0);
+    const auto &input = ws.Input<CPUBackend>(0);
     for (auto *sample : samples_cache_) {
       assert(sample);
       auto i = sample->sample_idx;
       auto *output_data = output.mutable_tensor<uint8_t>(i);
-      DALI_ENFORCE(DeferCacheLoad(sample->file_name, output_data));
+      if (!DeferCacheLoad(sample->file_name, output_data)) {
+        // the image was evicted (by another decoder sharing the cache) since it was looked up
+        sample->method = DecodeMethod::Host;
+        const auto *in_data = input.tensor<uint8_t>(i);
+        const auto in_size = input.tensor_shape(i).num_elements();
+        HostFallback<StorageGPU>(in_data, in_size, output_image_type_, output_data,
+                                 ws.stream(), sample->file_name, sample->roi, use_fast_idct_);
+      }
     }
     LoadDeferred(ws.stream());
   }
@@ -718,20 +909,108 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
         [this, sample, in_data, in_size, output_data](int tid) {
           SampleWorker(sample->sample_idx, sample->file_name, in_size, tid,
             in_data, output_data, streams_[tid]);
+          if (measure_paths_)
+            cuda_path_end_[tid] = std::chrono::steady_clock::now();
         }, task_priority_seq_--);  // FIFO order, since the samples were already ordered
     }
   }
 
 #if NVJPEG2K_ENABLED
-  void DecodeJpeg2k(uint8_t* output_data, const SampleData *sample,
-                    span<const uint8_t> input_data) {
+  static int NumStreamsJpeg2k(const OpSpec &spec) {
+    int num_streams = spec.GetArgument<int>("num_streams_jpeg2k");
+    DALI_ENFORCE(num_streams >= 1, make_string("`num_streams_jpeg2k` must be positive. Got ",
+                                               num_streams, "."));
+    return num_streams;
+  }
+
+  /**
+   * @brief Selects the lane for the next image - the images are distributed round-robin, so that
+   *        the decoding of consecutive (small) images overlaps on the GPU.
+   */
+  int NextNvjpeg2kLane() {
+    int lane = nvjpeg2k_next_lane_;
+    nvjpeg2k_next_lane_ = (lane + 1) % nvjpeg2k_lanes_.size();
+    return lane;
+  }
+
+  /**
+   * @brief Decodes the tiles of an image in all the lanes, starting with `main_lane`; the main
+   *        lane's stream then waits for all the tiles.
+   */
+  nvjpeg2kStatus_t DecodeJpeg2kTiles(int main_lane, const SampleData *sample,
+                                     uint8_t *decoder_out, int pixel_sz,
+                                     nvjpeg2kImageType_t pixel_type) {
+#if NVJPEG2K_DECODE_TILE_API
+    const auto &jpeg2k_stream = nvjpeg2k_streams_[sample->sample_idx];
+    const int64_t height = sample->shape[0], width = sample->shape[1];
+    const int64_t comp_size = height * width * pixel_sz;
+    const int nlanes = nvjpeg2k_lanes_.size();
+    nvjpeg2kStatus_t ret = NVJPEG2K_STATUS_SUCCESS;
+    uint32_t tile_id = 0;
+    for (int ty = 0; ty < sample->num_tiles_y && ret == NVJPEG2K_STATUS_SUCCESS; ty++) {
+      for (int tx = 0; tx < sample->num_tiles_x; tx++, tile_id++) {
+        auto &lane = nvjpeg2k_lanes_[(main_lane + tile_id) % nlanes];
+        int64_t y = static_cast<int64_t>(ty) * sample->tile_height;
+        int64_t x = static_cast<int64_t>(tx) * sample->tile_width;
+        void *pixel_data[NVJPEG_MAX_COMPONENT] = {};
+        size_t pitch_in_bytes[NVJPEG_MAX_COMPONENT] = {};
+        for (uint32_t c = 0; c < sample->shape[2]; ++c) {
+          pixel_data[c] = decoder_out + c * comp_size + (y * width + x) * pixel_sz;
+          pitch_in_bytes[c] = width * pixel_sz;
+        }
+        nvjpeg2kImage_t tile_image;
+        tile_image.pixel_data = pixel_data;
+        tile_image.pitch_in_bytes = pitch_in_bytes;
+        tile_image.pixel_type = pixel_type;
+        tile_image.num_components = sample->shape[2];
+        ret = nvjpeg2kDecodeTile(nvjpeg2k_handle_, lane.decode_state, jpeg2k_stream,
+                                 lane.decode_params, tile_id, 0 /* full resolution */,
+                                 &tile_image, lane.stream);
+        if (ret != NVJPEG2K_STATUS_SUCCESS)
+          break;
+      }
+    }
+    auto &main = nvjpeg2k_lanes_[main_lane];
+    for (int l = 0; l < nlanes; l++) {
+      if (l == main_lane)
+        continue;
+      CUDA_CALL(cudaEventRecord(nvjpeg2k_lanes_[l].event, nvjpeg2k_lanes_[l].stream));
+      CUDA_CALL(cudaStreamWaitEvent(main.stream, nvjpeg2k_lanes_[l].event, 0));
+    }
+    return ret;
+#else
+    return NVJPEG2K_STATUS_IMPLEMENTATION_NOT_SUPPORTED;
+#endif  // NVJPEG2K_DECODE_TILE_API
+  }
+
+  bool UseJpeg2kTiles(const SampleData *sample) const {
+#if NVJPEG2K_DECODE_TILE_API
+    return nvjpeg2k_lanes_.size() > 1 && sample->num_tiles_y * sample->num_tiles_x > 1 &&
+           sample->tile_height > 0 && sample->tile_width > 0;
+#else
+    return false;
+#endif  // NVJPEG2K_DECODE_TILE_API
+  }
+
+  /**
+   * @brief Decodes a jpeg2k image in the next lane; the tiles of large images are spread over
+   *        all the lanes.
+   *
+   * @return The stream on which the output is ready
+   */
+  cudaStream_t DecodeJpeg2k(uint8_t* output_data, const SampleData *sample,
+                            span<const uint8_t> input_data) {
     assert(sample->bpp == 8 || sample->bpp == 16);
     bool need_processing = sample->shape[2] > 1 || sample->bpp == 16;
     int pixel_sz = sample->bpp == 16 ? sizeof(uint16_t) : sizeof(uint8_t);
     int64_t npixels = sample->shape[0] * sample->shape[1];
     int64_t comp_size = npixels * pixel_sz;
-    CUDA_CALL(cudaEventSynchronize(nvjpeg2k_decode_event_));
-    auto &buffer = nvjpeg2k_intermediate_buffer_;
+    int lane_idx = NextNvjpeg2kLane();
+    auto &lane = nvjpeg2k_lanes_[lane_idx];
+    cudaStream_t stream = lane.stream;
+    // the previous image decoded in this lane is done - the intermediate buffer can be reused
+    CUDA_CALL(cudaEventSynchronize(lane.event));
+    auto &buffer = lane.intermediate_buffer;
     buffer.clear();
     if (need_processing) {
       buffer.resize(volume(sample->shape) * pixel_sz);
@@ -756,8 +1035,13 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
       output_image.pixel_type = NVJPEG2K_UINT8;
     }
     output_image.num_components = sample->shape[2];
-    auto ret = nvjpeg2kDecode(nvjpeg2k_handle_, nvjpeg2k_decoder_,
-                              jpeg2k_stream, &output_image, nvjpeg2k_cu_stream_);
+    nvjpeg2kStatus_t ret;
+    if (UseJpeg2kTiles(sample)) {
+      ret = DecodeJpeg2kTiles(lane_idx, sample, decoder_out, pixel_sz, output_image.pixel_type);
+    } else {
+      ret = nvjpeg2kDecode(nvjpeg2k_handle_, lane.decode_state,
+                           jpeg2k_stream, &output_image, stream);
+    }
     if (ret == NVJPEG2K_STATUS_SUCCESS) {
       if (need_processing) {
         if (output_image_type_ == DALI_GRAY) {
@@ -766,7 +1050,7 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
           TYPE_SWITCH(pixel_type, type2id, Input, (uint8_t, uint16_t), (
             PlanarRGBToGray<uint8_t, Input>(
               output_data, reinterpret_cast<Input*>(decoder_out), npixels,
-              pixel_type, nvjpeg2k_cu_stream_);
+              pixel_type, stream);
           ), DALI_FAIL(make_string("Unsupported input type: ", pixel_type)))  // NOLINT
         } else {
           // Converting to interleaved, dropping alpha channels if needed
@@ -775,19 +1059,19 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
             PlanarToInterleaved<uint8_t, Input>(
               output_data, reinterpret_cast<Input*>(decoder_out), npixels,
               sample->req_nchannels,
-              output_image_type_, pixel_type, nvjpeg2k_cu_stream_);
+              output_image_type_, pixel_type, stream);
           ), DALI_FAIL(make_string("Unsupported input type: ", pixel_type)))  // NOLINT
         }
       }
-      CUDA_CALL(cudaEventRecord(nvjpeg2k_decode_event_, nvjpeg2k_cu_stream_));
     } else if (ret == NVJPEG2K_STATUS_BAD_JPEG || ret == NVJPEG2K_STATUS_JPEG_NOT_SUPPORTED) {
       HostFallback<StorageGPU>(input_data.data(), input_data.size(), output_image_type_,
-                               output_data, nvjpeg2k_cu_stream_, sample->file_name,
+                               output_data, stream, sample->file_name,
                                sample->roi, use_fast_idct_);
-
     } else {
       CUDA_CALL_EX(ret, sample->file_name);
     }
+    CUDA_CALL(cudaEventRecord(lane.event, stream));
+    return stream;
   }
 #endif  // NVJPEG2K_ENABLED
 
@@ -806,8 +1090,8 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
         auto output_data = output.mutable_tensor<uint8_t>(i);
         auto in = span<const uint8_t>(input.tensor<uint8_t>(i), input_shape[i].num_elements());
         ImageCache::ImageShape shape = output_shape_[i].to_static<3>();
-        DecodeJpeg2k(output_data, sample, in);
-        CacheStore(sample->file_name, output_data, shape, nvjpeg2k_cu_stream_);
+        auto stream = DecodeJpeg2k(output_data, sample, in);
+        CacheStore(sample->file_name, output_data, shape, stream);
       }
     });
 #endif  // NVJPEG2K_ENABLED
@@ -831,6 +1115,102 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
     }
   }
 
+  /**
+   * @brief Inflates and unfilters the PNG images in the thread pool, to a pinned staging buffer.
+   *
+   * The samples which can't be decoded fall back to the CPU decoder. The rest is converted
+   * to the output color space on the GPU, by FinishImagesPng.
+   */
+  void ProcessImagesPng(MixedWorkspace &ws) {
+#if ZLIB_ENABLED
+    png_convert_samples_.clear();
+    if (samples_png_.empty())
+      return;
+    const auto &input = ws.Input<CPUBackend>(0);
+    auto &output = ws.Output<GPUBackend>(0);
+
+    int64_t staging_size = 0;
+    std::vector<int64_t> &offsets = png_staging_offsets_;
+    offsets.clear();
+    for (auto *sample : samples_png_) {
+      const auto &info = sample->png_info;
+      int64_t npixels = sample->roi ? sample->roi.shape[0] * sample->roi.shape[1]
+                                    : static_cast<int64_t>(info.height) * info.width;
+      offsets.push_back(staging_size);
+      staging_size += npixels * info.bytes_per_pixel();
+    }
+    // the previous batch was already copied to the GPU
+    CUDA_CALL(cudaEventSynchronize(png_copy_event_));
+    png_staging_.Resize({staging_size}, DALI_UINT8);
+    png_staging_gpu_.resize(staging_size, ws.stream());
+
+    for (size_t k = 0; k < samples_png_.size(); k++) {
+      auto *sample = samples_png_[k];
+      auto i = sample->sample_idx;
+      const auto &info = sample->png_info;
+      auto *output_data = output.mutable_tensor<uint8_t>(i);
+      PngConvertSample convert;
+      convert.in = png_staging_gpu_.data() + offsets[k];
+      convert.out = output_data;
+      convert.npixels = sample->roi ? sample->roi.shape[0] * sample->roi.shape[1]
+                                    : static_cast<int64_t>(info.height) * info.width;
+      convert.in_channels = info.channels();
+      convert.bytes_per_sample = info.bit_depth / 8;
+      convert.out_channels = sample->req_nchannels;
+      png_convert_samples_.push_back(convert);
+
+      const auto *input_data = input.tensor<uint8_t>(i);
+      auto in_size = input.tensor_shape(i).num_elements();
+      uint8_t *staging = png_staging_.mutable_data<uint8_t>() + offsets[k];
+      ImageCache::ImageShape shape = output_shape_[i].to_static<3>();
+      thread_pool_.AddWork(
+        [this, k, sample, input_data, in_size, output_data, staging, shape](int tid) {
+          try {
+            DecodePngRegion(make_cspan(input_data, in_size), sample->png_info, sample->roi,
+                            staging, png_scratch_[tid]);
+          } catch (const std::exception &e) {
+            LOG_LINE << "Sample \"" << sample->file_name << "\" can't be decoded on the GPU: "
+                     << e.what() << ". Falling back to the CPU decoder." << std::endl;
+            png_convert_samples_[k].npixels = 0;  // skipped by the conversion
+            HostFallback<StorageGPU>(input_data, in_size, output_image_type_, output_data,
+                                     streams_[tid], sample->file_name, sample->roi,
+                                     use_fast_idct_);
+            CacheStore(sample->file_name, output_data, shape, streams_[tid]);
+          }
+        }, task_priority_seq_--);  // FIFO order, since the samples were already ordered
+    }
+#endif  // ZLIB_ENABLED
+  }
+
+  /**
+   * @brief Copies the decoded PNG images to the GPU and converts them to the output, in one
+   *        kernel, once all the samples were inflated.
+   */
+  void FinishImagesPng(MixedWorkspace &ws) {
+#if ZLIB_ENABLED
+    if (png_convert_samples_.empty())
+      return;
+    auto &output = ws.Output<GPUBackend>(0);
+    auto stream = ws.stream();
+    int64_t max_npixels = 0;
+    for (auto &convert : png_convert_samples_)
+      max_npixels = std::max(max_npixels, convert.npixels);
+    CUDA_CALL(cudaMemcpyAsync(png_staging_gpu_.data(), png_staging_.raw_data(),
+                              png_staging_.nbytes(), cudaMemcpyHostToDevice, stream));
+    CUDA_CALL(cudaEventRecord(png_copy_event_, stream));
+    png_convert_samples_gpu_.from_host(png_convert_samples_, stream);
+    ConvertPngImages(png_convert_samples_gpu_.data(), png_convert_samples_.size(), max_npixels,
+                     output_image_type_, stream);
+    for (size_t k = 0; k < samples_png_.size(); k++) {
+      if (png_convert_samples_[k].npixels == 0)
+        continue;  // already stored by the fallback, if at all
+      int i = samples_png_[k]->sample_idx;
+      CacheStore(samples_png_[k]->file_name, output.mutable_tensor<uint8_t>(i),
+                 output_shape_.tensor_shape(i).to_static<3>(), stream);
+    }
+#endif  // ZLIB_ENABLED
+  }
+
   void ProcessImagesHw(MixedWorkspace &ws) {
 #if IS_HW_DECODER_COMPATIBLE
     auto& output = ws.Output<GPUBackend>(0);
@@ -854,6 +1234,23 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
       int j = 0;
       TensorVector<CPUBackend> tv(samples_hw_batched_.size());
 
+      // the previous batch is done - the intermediate buffer can be reused
+      CUDA_CALL(cudaEventSynchronize(hw_decode_event_));
+      int64_t full_decode_size = 0;
+      int nsamples_full = 0;
+      for (auto *sample : samples_hw_batched_) {
+        if (sample->hw_decode_full) {
+          full_decode_size += sample->shape[0] * sample->shape[1] * sample->req_nchannels;
+          nsamples_full++;
+        }
+      }
+      hw_decode_full_buffer_.resize(full_decode_size, hw_decode_stream_);
+      hw_decode_full_view_.resize(nsamples_full);
+      hw_decode_crop_view_.resize(nsamples_full);
+      hw_decode_crop_rois_.clear();
+      int64_t full_decode_offset = 0;
+      int k = 0;
+
       const auto &input = ws.Input<CPUBackend>(0);
       tv.SetupLike(input);
       for (auto *sample : samples_hw_batched_) {
@@ -862,13 +1259,26 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 
         tv.UnsafeSetSample(j, input, i);
         in_lengths_[j] = input.tensor_shape(i).num_elements();
-        nvjpeg_destinations_[j].channel[0] = output.mutable_tensor<uint8_t>(i);
-        nvjpeg_destinations_[j].pitch[0] = out_shape[1] * out_shape[2];
+        if (sample->hw_decode_full) {
+          TensorShape<3> full_shape{sample->shape[0], sample->shape[1], out_shape[2]};
+          uint8_t *full_image = hw_decode_full_buffer_.data() + full_decode_offset;
+          full_decode_offset += volume(full_shape);
+          nvjpeg_destinations_[j].channel[0] = full_image;
+          nvjpeg_destinations_[j].pitch[0] = full_shape[1] * full_shape[2];
+          hw_decode_full_view_.data[k] = full_image;
+          hw_decode_full_view_.shape.set_tensor_shape(k, full_shape);
+          hw_decode_crop_view_.data[k] = output.mutable_tensor<uint8_t>(i);
+          hw_decode_crop_view_.shape.set_tensor_shape(k, out_shape.to_static<3>());
+          hw_decode_crop_rois_.push_back(sample->roi);
+          k++;
+        } else {
+          nvjpeg_destinations_[j].channel[0] = output.mutable_tensor<uint8_t>(i);
+          nvjpeg_destinations_[j].pitch[0] = out_shape[1] * out_shape[2];
+        }
         nvjpeg_params_[j] = sample->params;
         j++;
       }
 
-      CUDA_CALL(cudaEventSynchronize(hw_decode_event_));
       if (RestrictPinnedMemUsage()) {
         for (size_t k = 0; k < samples_hw_batched_.size(); ++k) {
           in_data_[k] = static_cast<unsigned char*>(tv.raw_mutable_tensor(k));
@@ -881,6 +1291,8 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
           in_data_[k] = hw_decoder_images_staging_.mutable_tensor<uint8_t>(k);
         }
       }
+      if (measure_paths_)
+        CUDA_CALL(cudaEventRecord(hw_timing_start_, hw_decode_stream_));
       // if nvjpegDecodeBatchedSupportedEx is available nvjpegDecodeBatchedEx should be as well,
       // otherwise no ROI should be provided anyway so we can safely call nvjpegDecodeBatched
       if (nvjpegIsSymbolAvailable("nvjpegDecodeBatchedEx")) {
@@ -892,6 +1304,11 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
                                       nvjpeg_destinations_.data(), hw_decode_stream_));
       }
 
+      if (nsamples_full > 0) {
+        CropDecodedImages(kmgr_hw_decode_crop_, hw_decode_crop_view_, hw_decode_full_view_,
+                          make_cspan(hw_decode_crop_rois_), hw_decode_stream_);
+      }
+
       if (output_image_type_ == DALI_YCbCr) {
         // We don't decode directly to YCbCr, since we want to control the YCbCr definition,
         // which is different between general color conversion libraries (OpenCV) and
@@ -910,6 +1327,8 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
         CacheStore(sample->file_name, output.mutable_tensor<uint8_t>(i),
                    output_shape_.tensor_shape(i).to_static<3>(), hw_decode_stream_);
       }
+      if (measure_paths_)
+        CUDA_CALL(cudaEventRecord(hw_timing_end_, hw_decode_stream_));
       CUDA_CALL(cudaEventRecord(hw_decode_event_, hw_decode_stream_));
     }
 #endif
@@ -923,16 +1342,23 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
     output.SetLayout("HWC");
 
     UpdateTestCounters(samples_hw_batched_.size(), samples_single_.size(), samples_host_.size(),
-                       samples_jpeg2k_.size());
+                       samples_jpeg2k_.size(), samples_png_.size());
 
     // Reset the task priority. Subsequent tasks will use decreasing numbers to ensure the
     // expected order of execution.
     task_priority_seq_ = 0;
     ProcessImagesCache(ws);
 
+    // a new measurement is taken only when the previous one was used
+    measure_paths_ = adaptive_hw_decoder_load_ && !paths_measured_;
+    auto start = std::chrono::steady_clock::now();
+    if (measure_paths_)
+      std::fill(cuda_path_end_.begin(), cuda_path_end_.end(), start);
+
     ProcessImagesCuda(ws);
     ProcessImagesHost(ws);
     ProcessImagesJpeg2k(ws);
+    ProcessImagesPng(ws);
     thread_pool_.RunAll(false);  // don't block
     nvjpeg2k_thread_.RunAll(false);
 
@@ -940,17 +1366,31 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 
     thread_pool_.WaitForWork();
     nvjpeg2k_thread_.WaitForWork();
+
+    if (measure_paths_) {
+      auto end = *std::max_element(cuda_path_end_.begin(), cuda_path_end_.end());
+      cuda_path_time_ms_ = std::chrono::duration<float, std::milli>(end - start).count();
+      cuda_path_nsamples_ = samples_single_.size();
+      hw_path_nsamples_ = samples_hw_batched_.size();
+      paths_measured_ = true;
+      measure_paths_ = false;
+    }
     // wait for all work in workspace main stream
     for (int tid = 0; tid < num_threads_; tid++) {
-      CUDA_CALL(cudaEventRecord(decode_events_[tid], streams_[tid]));
-      CUDA_CALL(cudaStreamWaitEvent(ws.stream(), decode_events_[tid], 0));
+      // a later point in the thread's stream, so the event still covers the page's last sample
+      auto &event = decode_events_[2*tid + thread_page_ids_[tid]];
+      CUDA_CALL(cudaEventRecord(event, streams_[tid]));
+      CUDA_CALL(cudaStreamWaitEvent(ws.stream(), event, 0));
     }
     CUDA_CALL(cudaEventRecord(hw_decode_event_, hw_decode_stream_));
     CUDA_CALL(cudaStreamWaitEvent(ws.stream(), hw_decode_event_, 0));
 #if NVJPEG2K_ENABLED
-    CUDA_CALL(cudaEventRecord(nvjpeg2k_decode_event_, nvjpeg2k_cu_stream_));
-    CUDA_CALL(cudaStreamWaitEvent(ws.stream(), nvjpeg2k_decode_event_, 0));
+    for (auto &lane : nvjpeg2k_lanes_) {
+      CUDA_CALL(cudaEventRecord(lane.event, lane.stream));
+      CUDA_CALL(cudaStreamWaitEvent(ws.stream(), lane.event, 0));
+    }
 #endif  // NVJPEG2K_ENABLED
+    FinishImagesPng(ws);
   }
 
   inline int GetNextBufferIndex(int thread_id) {
@@ -971,6 +1411,11 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
     const int buff_idx = GetNextBufferIndex(thread_id);
     const int jpeg_stream_idx = buff_idx;
 
+    // The buffers of this page were last used by the sample decoded two samples ago by this
+    // thread - only its GPU work must be complete. The previous sample may still be decoded on
+    // the GPU while this one is being decoded on the host and queued after it.
+    CUDA_CALL(cudaEventSynchronize(decode_events_[buff_idx]));
+
     // At this point sample data should have a valid selected decoder
     auto &decoder = data.selected_decoder->decoder;
     assert(decoder != nullptr);
@@ -1013,8 +1458,7 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
       nvjpeg_image.channel[0] = output_data;
       nvjpeg_image.pitch[0] = out_shape[1] * out_shape[2];
 
-      CUDA_CALL(cudaEventSynchronize(decode_events_[thread_id]));
-      CUDA_CALL_EX(nvjpegStateAttachDeviceBuffer(state, device_buffers_[thread_id]), file_name);
+      CUDA_CALL_EX(nvjpegStateAttachDeviceBuffer(state, device_buffers_[buff_idx]), file_name);
 
       CUDA_CALL_EX(nvjpegDecodeJpegTransferToDevice(handle_, decoder, state,
                                                       jpeg_streams_[jpeg_stream_idx], stream),
@@ -1042,18 +1486,23 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
       }
 
       CacheStore(file_name, output_data, out_shape, stream);
-      CUDA_CALL(cudaEventRecord(decode_events_[thread_id], stream));
+      CUDA_CALL(cudaEventRecord(decode_events_[buff_idx], stream));
     }
   }
 
 
   USE_OPERATOR_MEMBERS();
-  nvjpegHandle_t handle_;
+  NvjpegHandle shared_handle_;
+  nvjpegHandle_t handle_ = nullptr;
 
   // output colour format
   DALIImageType output_image_type_;
 
   unsigned int hybrid_huffman_threshold_;
+  bool use_huffman_cost_model_;
+  HuffmanCostModel huffman_cost_model_;
+  std::vector<JpegHuffmanFeatures> huffman_features_;
+  std::vector<bool> use_gpu_huffman_;
   bool use_fast_idct_;
 
   TensorListShape<> output_shape_;
@@ -1066,10 +1515,21 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 #if NVJPEG2K_ENABLED
   // nvjpeg2k
   NvJPEG2KHandle nvjpeg2k_handle_{};
-  NvJPEG2KDecodeState nvjpeg2k_decoder_{};
-  DeviceBuffer<uint8_t> nvjpeg2k_intermediate_buffer_;
-  cudaStream_t nvjpeg2k_cu_stream_;
-  cudaEvent_t nvjpeg2k_decode_event_;
+  /**
+   * @brief A stream with its own decoder state, so that the images (or the tiles of an image)
+   *        decoded in different lanes can run concurrently.
+   */
+  struct Nvjpeg2kLane {
+    NvJPEG2KDecodeState decode_state{};
+#if NVJPEG2K_DECODE_TILE_API
+    NvJPEG2KDecodeParams decode_params{};
+#endif  // NVJPEG2K_DECODE_TILE_API
+    DeviceBuffer<uint8_t> intermediate_buffer;
+    cudaStream_t stream = nullptr;
+    cudaEvent_t event = nullptr;  // recorded after the last image decoded in the lane
+  };
+  std::vector<Nvjpeg2kLane> nvjpeg2k_lanes_;
+  int nvjpeg2k_next_lane_ = 0;
   nvjpeg2kDeviceAllocator_t nvjpeg2k_dev_alloc_;
   nvjpeg2kPinnedAllocator_t nvjpeg2k_pin_alloc_;
 
@@ -1078,7 +1538,7 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 #endif  // NVJPEG2K_ENABLED
 
   // GPU
-  // Per thread
+  // Per thread; the buffers and their events are double-buffered, like the pinned buffers
   std::vector<nvjpegBufferDevice_t> device_buffers_;
   std::vector<cudaStream_t> streams_;
   cudaStream_t hw_decode_stream_;
@@ -1093,6 +1553,18 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
   float hw_decoder_load_ = 0.0f;
   int hw_decoder_bs_ = 0;
 
+  // The adaptive hw_decoder_load: the decoding times of the HW and CUDA paths in an iteration
+  bool adaptive_hw_decoder_load_ = false;
+  bool measure_paths_ = false;
+  bool paths_measured_ = false;
+  cudaEvent_t hw_timing_start_ = nullptr;
+  cudaEvent_t hw_timing_end_ = nullptr;
+  int hw_path_nsamples_ = 0;
+  // per thread, the time when the last sample decoded with CUDA was done
+  std::vector<std::chrono::steady_clock::time_point> cuda_path_end_;
+  float cuda_path_time_ms_ = 0.0f;
+  int cuda_path_nsamples_ = 0;
+
   // Those are used to feed nvjpeg's batched API
   std::vector<const unsigned char*> in_data_;
   std::vector<size_t> in_lengths_;
@@ -1109,13 +1581,32 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 
   TensorList<CPUBackend> hw_decoder_images_staging_;
 
+  // The images with ROI, decoded in full by the HW decoder and then cropped to the output
+  DeviceBuffer<uint8_t> hw_decode_full_buffer_;
+  TensorListView<StorageGPU, const uint8_t, 3> hw_decode_full_view_;
+  TensorListView<StorageGPU, uint8_t, 3> hw_decode_crop_view_;
+  std::vector<CropWindow> hw_decode_crop_rois_;
+  kernels::KernelManager kmgr_hw_decode_crop_;
+
+#if ZLIB_ENABLED
+  // PNG - inflated and unfiltered on the CPU, converted on the GPU
+  std::vector<std::vector<uint8_t>> png_scratch_;  // per thread
+  Tensor<CPUBackend> png_staging_;  // pinned
+  std::vector<int64_t> png_staging_offsets_;
+  DeviceBuffer<uint8_t> png_staging_gpu_;
+  std::vector<PngConvertSample> png_convert_samples_;
+  DeviceBuffer<PngConvertSample> png_convert_samples_gpu_;
+  cudaEvent_t png_copy_event_;
+#endif  // ZLIB_ENABLED
+
  private:
   void UpdateTestCounters(int nsamples_hw, int nsamples_cuda,
-                          int nsamples_host, int nsamples_nvjpeg2k) {
+                          int nsamples_host, int nsamples_nvjpeg2k, int nsamples_png) {
     nsamples_hw_ += nsamples_hw;
     nsamples_cuda_ += nsamples_cuda;
     nsamples_host_ += nsamples_host;
     nsamples_nvjpeg2k_ += nsamples_nvjpeg2k;
+    nsamples_png_ += nsamples_png;
   }
 
   /**
@@ -1126,8 +1617,54 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
     RegisterDiagnostic("nsamples_cuda", &nsamples_cuda_);
     RegisterDiagnostic("nsamples_host", &nsamples_host_);
     RegisterDiagnostic("nsamples_nvjpeg2k", &nsamples_nvjpeg2k_);
+    RegisterDiagnostic("nsamples_png", &nsamples_png_);
     RegisterDiagnostic("using_hw_decoder", &using_hw_decoder_);
     RegisterDiagnostic("using_hw_decoder_roi", &using_hw_decoder_roi_);
+    RegisterDiagnostic("hw_decoder_load", &hw_decoder_load_);
+  }
+
+  /**
+   * @brief Moves hw_decoder_load towards the value with which the HW and CUDA paths take
+   *        the same time, based on the times measured in a previous iteration.
+   *
+   * The measurement is skipped, without waiting, if the HW decoder is still busy with it.
+   */
+  void UpdateHwDecoderLoad() {
+    if (!paths_measured_)
+      return;
+    float hw_path_time_ms = 0;
+    if (hw_path_nsamples_ > 0) {
+      auto ret = cudaEventQuery(hw_timing_end_);
+      if (ret == cudaErrorNotReady)
+        return;
+      CUDA_CALL(ret);
+      CUDA_CALL(cudaEventElapsedTime(&hw_path_time_ms, hw_timing_start_, hw_timing_end_));
+    }
+    paths_measured_ = false;
+    hw_decoder_load_ = AdaptHwDecoderLoad(hw_decoder_load_, hw_path_time_ms, hw_path_nsamples_,
+                                          cuda_path_time_ms_, cuda_path_nsamples_);
+  }
+
+  static float AdaptHwDecoderLoad(float load, float hw_time, int hw_nsamples,
+                                  float cuda_time, int cuda_nsamples) {
+    constexpr float kSmoothing = 0.3f;  // damps the noise of the measurements
+    constexpr float kProbeStep = 0.05f;  // used when one of the paths wasn't used at all
+    float new_load;
+    if (hw_nsamples > 0 && cuda_nsamples > 0) {
+      float hw_cost = hw_time / hw_nsamples;
+      float cuda_cost = cuda_time / cuda_nsamples;
+      if (hw_cost + cuda_cost <= 0)
+        return load;
+      float balanced = cuda_cost / (hw_cost + cuda_cost);
+      new_load = load + kSmoothing * (balanced - load);
+    } else if (hw_nsamples > 0) {
+      new_load = load - kProbeStep;
+    } else if (cuda_nsamples > 0) {
+      new_load = load + kProbeStep;
+    } else {
+      return load;
+    }
+    return std::min(std::max(new_load, 0.f), 1.f);
   }
 
   int CalcHwDecoderBatchSize(float hw_decoder_load, int curr_batch_size) {
@@ -1158,10 +1695,15 @@ class nvJPEGDecoder : public Operator<MixedBackend>, CachedDecoderImpl {
 #if NVJPEG2K_ENABLED
     samples_jpeg2k_.reserve(max_batch_size_);
 #endif  // NVJPEG2K_ENABLED
+#if ZLIB_ENABLED
+    samples_png_.reserve(max_batch_size_);
+    png_convert_samples_.reserve(max_batch_size_);
+#endif  // ZLIB_ENABLED
   }
 
   // HW/CUDA Utilization test counters
   int64_t nsamples_hw_ = 0, nsamples_cuda_ = 0, nsamples_host_ = 0, nsamples_nvjpeg2k_ = 0;
+  int64_t nsamples_png_ = 0;
 
   // Used to ensure the work in the thread pool is picked FIFO
   int64_t task_priority_seq_ = 0;
@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -303,6 +303,67 @@ TEST_F(HwDecoderMemoryPoolTest, MemoryPoolTest) {
   this->pipeline_.RunGPU();
 }
 
+class HwDecoderAdaptiveLoadTest : public ::testing::Test {
+ public:
+  void SetUp() final {
+    dali::string list_root(testing::dali_extra_path() + "/db/single/jpeg");
+
+    pipeline_.AddOperator(
+            OpSpec("FileReader")
+                    .AddArg("device", "cpu")
+                    .AddArg("file_root", list_root)
+                    .AddOutput("compressed_images", "cpu")
+                    .AddOutput("labels", "cpu"));
+    auto decoder_spec =
+            OpSpec("ImageDecoder")
+                    .AddArg("device", "mixed")
+                    .AddArg("output_type", DALI_RGB)
+                    .AddArg("hw_decoder_load", .7f)
+                    .AddArg("adaptive_hw_decoder_load", true)
+                    .AddInput("compressed_images", "cpu")
+                    .AddOutput("images", "gpu");
+    pipeline_.AddOperator(decoder_spec, decoder_name_);
+
+    pipeline_.Build(outputs_);
+
+    auto node = pipeline_.GetOperatorNode(decoder_name_);
+    if (!node->op->GetDiagnostic<bool>("using_hw_decoder")) {
+      PrintDeviceInfo();
+      if (ShouldUseHwDecoder()) {
+        FAIL() << "HW Decoder exists in the system and failed to open";
+      }
+      GTEST_SKIP();
+    }
+  }
+
+
+  int batch_size_ = 47;
+  Pipeline pipeline_{batch_size_, 1, 0, -1, false, 2, false};
+  vector<std::pair<string, string>> outputs_ = {{"images", "gpu"}};
+  std::string decoder_name_ = "Lorem Ipsum";
+};
+
+TEST_F(HwDecoderAdaptiveLoadTest, LoadIsAdjusted) {
+  constexpr int kIters = 10;
+  for (int i = 0; i < kIters; i++) {
+    this->pipeline_.RunCPU();
+    this->pipeline_.RunGPU();
+    DeviceWorkspace ws;
+    this->pipeline_.Outputs(&ws);
+  }
+
+  auto node = this->pipeline_.GetOperatorNode(this->decoder_name_);
+  auto load = node->op->GetDiagnostic<float>("hw_decoder_load");
+  EXPECT_GE(load, 0.f);
+  EXPECT_LE(load, 1.f);
+  auto nsamples_hw = node->op->GetDiagnostic<int64_t>("nsamples_hw");
+  auto nsamples_cuda = node->op->GetDiagnostic<int64_t>("nsamples_cuda");
+  auto nsamples_host = node->op->GetDiagnostic<int64_t>("nsamples_host");
+  EXPECT_EQ(nsamples_hw + nsamples_cuda, kIters * this->batch_size_);
+  EXPECT_EQ(nsamples_host, 0)
+                << "Image decoding malfunction: all images should've been decoded by CUDA or HW";
+}
+
 class HwDecoderSliceUtilizationTest : public ::testing::Test {
  public:
   void SetUp() final {
@@ -349,7 +410,8 @@ class HwDecoderSliceUtilizationTest : public ::testing::Test {
     pipeline_.SetExternalInput("crop_data", crop_data);
 
     auto node = pipeline_.GetOperatorNode(decoder_name_);
-    if (!node->op->GetDiagnostic<bool>("using_hw_decoder_roi")) {
+    // without the ROI support in the HW decoder, the images are decoded in full and cropped
+    if (!node->op->GetDiagnostic<bool>("using_hw_decoder")) {
       PrintDeviceInfo();
       if (ShouldUseHwDecoder()) {
         FAIL() << "HW Decoder exists in the system and failed to open";
@@ -402,7 +464,8 @@ class HwDecoderCropUtilizationTest : public ::testing::Test {
     pipeline_.Build(outputs_);
 
     auto node = pipeline_.GetOperatorNode(decoder_name_);
-    if (!node->op->GetDiagnostic<bool>("using_hw_decoder_roi")) {
+    // without the ROI support in the HW decoder, the images are decoded in full and cropped
+    if (!node->op->GetDiagnostic<bool>("using_hw_decoder")) {
       PrintDeviceInfo();
       if (ShouldUseHwDecoder()) {
         FAIL() << "HW Decoder exists in the system and failed to open";
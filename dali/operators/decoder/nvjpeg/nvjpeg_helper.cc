@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -12,7 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include "dali/operators/decoder/nvjpeg/nvjpeg_helper.h"
+#include "dali/core/device_guard.h"
 #include "dali/core/util.h"
 
 namespace dali {
@@ -27,4 +32,38 @@ DLL_PUBLIC int nvjpegGetVersion() {
   return GetVersionNumber(major, minor, patch);
 }
 
+NvjpegHandle GetSharedNvjpegHandle(int device_id, nvjpegBackend_t backend,
+                                   size_t device_memory_padding, size_t pinned_memory_padding) {
+  using Key = std::tuple<int, nvjpegBackend_t, size_t, size_t>;
+  static std::mutex mtx;
+  static std::map<Key, std::weak_ptr<std::remove_pointer_t<nvjpegHandle_t>>> handles;
+
+  std::lock_guard<std::mutex> guard(mtx);
+  auto &cached = handles[Key{device_id, backend, device_memory_padding, pinned_memory_padding}];
+  if (auto handle = cached.lock())
+    return handle;
+
+  DeviceGuard dg(device_id);
+  nvjpegHandle_t raw_handle = nullptr;
+  if (backend == NVJPEG_BACKEND_DEFAULT) {
+    CUDA_CALL(nvjpegCreateSimple(&raw_handle));
+  } else if (nvjpegCreate(backend, nullptr, &raw_handle) != NVJPEG_STATUS_SUCCESS) {
+    return {};
+  }
+  NvjpegHandle handle(raw_handle, [device_id](nvjpegHandle_t h) {
+    try {
+      DeviceGuard dg(device_id);
+      CUDA_DTOR_CALL(nvjpegDestroy(h));
+    } catch (const std::exception &e) {
+      std::cerr << "Fatal error: exception when destroying the nvJPEG handle:\n"
+                << e.what() << std::endl;
+      std::terminate();
+    }
+  });
+  CUDA_CALL(nvjpegSetDeviceMemoryPadding(device_memory_padding, raw_handle));
+  CUDA_CALL(nvjpegSetPinnedMemoryPadding(pinned_memory_padding, raw_handle));
+  cached = handle;
+  return handle;
+}
+
 }  // namespace dali
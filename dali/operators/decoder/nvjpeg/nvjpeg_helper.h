@@ -19,6 +19,7 @@
 
 #include <string>
 #include <memory>
+#include <type_traits>
 
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
@@ -120,6 +121,26 @@ inline void cudaResultCheck<nvjpegStatus_t>(nvjpegStatus_t status, const string
 // Obtain nvJPEG library version or -1 if it is not available
 int nvjpegGetVersion();
 
+/**
+ * @brief A reference-counted nvJPEG library handle
+ */
+using NvjpegHandle = std::shared_ptr<std::remove_pointer_t<nvjpegHandle_t>>;
+
+/**
+ * @brief Returns the nvJPEG library handle for the given device, backend and memory paddings,
+ *        shared by all the users in the process.
+ *
+ * The library handle is thread-safe, so the decoders (also the ones in different pipelines)
+ * can share it instead of creating their own, which is a considerable part of their construction
+ * time. The handle is destroyed when the last reference to it is released.
+ * The states and the buffers created with the handle are not shared.
+ *
+ * @param backend NVJPEG_BACKEND_DEFAULT or NVJPEG_BACKEND_HARDWARE
+ * @return the handle; empty, if the backend is not supported (NVJPEG_BACKEND_HARDWARE only)
+ */
+NvjpegHandle GetSharedNvjpegHandle(int device_id, nvjpegBackend_t backend,
+                                   size_t device_memory_padding, size_t pinned_memory_padding);
+
 struct StateNvJPEG {
   nvjpegBackend_t nvjpeg_backend;
   nvjpegBufferPinned_t pinned_buffer;
@@ -203,6 +224,30 @@ inline bool IsProgressiveJPEG(const uint8_t* raw_jpeg, size_t size) {
   return segment_marker == progressive_sof;
 }
 
+// Returns true if a non-zero restart interval is defined before the first scan of the JPEG
+inline bool HasRestartMarkers(const uint8_t* input, size_t size) {
+  if (size < 4 || input[0] != 0xff || input[1] != 0xd8)
+    return false;
+  const uint8_t* ptr = input + 2;
+  const uint8_t* end = input + size;
+  while (end - ptr >= 4) {
+    if (ptr[0] != 0xff)
+      return false;
+    uint8_t marker = ptr[1];
+    if (marker == 0xff) {  // fill byte
+      ptr++;
+      continue;
+    }
+    if (marker == 0xda)  // start of scan
+      return false;
+    uint16_t segment_length = (ptr[2] << 8) + ptr[3];
+    if (marker == 0xdd)  // define restart interval
+      return segment_length >= 4 && end - ptr >= 6 && ((ptr[4] << 8) + ptr[5]) != 0;
+    ptr += 2 + segment_length;
+  }
+  return false;
+}
+
 // Predicate to determine if the image should be decoded with the nvJPEG
 // hybrid Huffman decoder instead of the nvjpeg host Huffman decoder
 template <typename T>
@@ -0,0 +1,85 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include "dali/core/error_handling.h"
+#include "dali/core/util.h"
+#include "dali/kernels/imgproc/color_manipulation/color_space_conversion_impl.h"
+#include "dali/operators/decoder/nvjpeg/png_convert.h"
+
+namespace dali {
+
+namespace {
+
+__device__ DALI_FORCEINLINE vec<4, uint8_t> LoadPngPixel(const PngConvertSample &s, int64_t idx) {
+  // the most significant byte of a big-endian sample comes first
+  const uint8_t *p = s.in + idx * s.in_channels * s.bytes_per_sample;
+  const int step = s.bytes_per_sample;
+  vec<4, uint8_t> px;
+  if (s.in_channels <= 2) {
+    px[0] = px[1] = px[2] = p[0];
+    px[3] = s.in_channels == 2 ? p[step] : 255;
+  } else {
+    px[0] = p[0];
+    px[1] = p[step];
+    px[2] = p[2 * step];
+    px[3] = s.in_channels == 4 ? p[3 * step] : 255;
+  }
+  return px;
+}
+
+__global__ void ConvertPngKernel(const PngConvertSample *samples, DALIImageType out_type) {
+  const PngConvertSample s = samples[blockIdx.y];
+  for (int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       idx < s.npixels; idx += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    auto px = LoadPngPixel(s, idx);
+    vec<3, uint8_t> rgb = { px[0], px[1], px[2] };
+    uint8_t *out = s.out + idx * s.out_channels;
+    switch (out_type) {
+      case DALI_GRAY:
+        out[0] = s.in_channels <= 2 ? px[0] : kernels::color::rgb_to_gray<uint8_t>(rgb);
+        break;
+      case DALI_BGR:
+        out[0] = px[2];
+        out[1] = px[1];
+        out[2] = px[0];
+        break;
+      case DALI_YCbCr:
+        out[0] = kernels::color::itu_r_bt_601::rgb_to_y<uint8_t>(rgb);
+        out[1] = kernels::color::itu_r_bt_601::rgb_to_cb<uint8_t>(rgb);
+        out[2] = kernels::color::itu_r_bt_601::rgb_to_cr<uint8_t>(rgb);
+        break;
+      default:  // RGB, or ANY_DATA with the channels of the image, without the gray alpha
+        for (int c = 0; c < s.out_channels; c++)
+          out[c] = px[c];
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+void ConvertPngImages(const PngConvertSample *samples, int nsamples, int64_t max_npixels,
+                      DALIImageType out_type, cudaStream_t stream) {
+  if (nsamples == 0 || max_npixels == 0)
+    return;
+  const int block_size = 256;
+  // the larger images are processed in a grid-stride loop
+  int blocks_per_sample = std::min<int64_t>(div_ceil(max_npixels, block_size), 1024);
+  dim3 grid(blocks_per_sample, nsamples);
+  ConvertPngKernel<<<grid, block_size, 0, stream>>>(samples, out_type);
+  CUDA_CALL(cudaGetLastError());
+}
+
+}  // namespace dali
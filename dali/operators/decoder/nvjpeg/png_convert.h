@@ -0,0 +1,50 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_DECODER_NVJPEG_PNG_CONVERT_H_
+#define DALI_OPERATORS_DECODER_NVJPEG_PNG_CONVERT_H_
+
+#include <cuda_runtime.h>
+#include <stdint.h>
+#include "dali/core/common.h"
+
+namespace dali {
+
+/**
+ * @brief A PNG image, decoded to the layout of its image data, and its output
+ */
+struct PngConvertSample {
+  const uint8_t *in;  // interleaved; 16-bit samples are big-endian
+  uint8_t *out;       // interleaved, 8-bit
+  int64_t npixels;
+  int in_channels;       // 1 (gray), 2 (gray + alpha), 3 (RGB) or 4 (RGBA)
+  int bytes_per_sample;  // 1 or 2
+  int out_channels;      // 1, 3 or 4 (RGBA, only for DALI_ANY_DATA)
+};
+
+/**
+ * @brief Converts a batch of decoded PNG images to the output color space, in a single kernel.
+ *
+ * The alpha channel is dropped, unless the output is RGBA, and the 16-bit samples are reduced
+ * to their most significant byte, as in the CPU decoder.
+ *
+ * @param samples     the samples, in device memory
+ * @param max_npixels the number of pixels of the largest sample
+ */
+void ConvertPngImages(const PngConvertSample *samples, int nsamples, int64_t max_npixels,
+                      DALIImageType out_type, cudaStream_t stream);
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_DECODER_NVJPEG_PNG_CONVERT_H_
@@ -0,0 +1,230 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/decoder/nvjpeg/png_decode.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include "dali/core/byte_io.h"
+#include "dali/core/error_handling.h"
+#include "dali/core/format.h"
+
+#if ZLIB_ENABLED
+#include <zlib.h>
+#endif  // ZLIB_ENABLED
+
+namespace dali {
+
+namespace {
+
+// https://www.w3.org/TR/PNG/#5DataRep
+constexpr uint8_t kPngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+constexpr int kChunkHeaderSize = 8;  // length and type
+constexpr int kChunkCrcSize = 4;
+constexpr int kIhdrSize = 13;
+
+struct PngChunk {
+  const uint8_t *type;
+  span<const uint8_t> data;
+};
+
+/**
+ * @brief Reads the chunk at `offset` and advances `offset` past it.
+ *
+ * @return false, if the chunk doesn't fit in the data
+ */
+bool ReadChunk(span<const uint8_t> data, int64_t &offset, PngChunk &chunk) {
+  if (data.size() - offset < kChunkHeaderSize)
+    return false;
+  int64_t length = ReadValueBE<uint32_t>(data.data() + offset);
+  if (data.size() - offset - kChunkHeaderSize - kChunkCrcSize < length)
+    return false;
+  chunk.type = data.data() + offset + 4;
+  chunk.data = make_span(data.data() + offset + kChunkHeaderSize, length);
+  offset += kChunkHeaderSize + length + kChunkCrcSize;
+  return true;
+}
+
+inline bool IsChunk(const PngChunk &chunk, const char *type) {
+  return std::memcmp(chunk.type, type, 4) == 0;
+}
+
+#if ZLIB_ENABLED
+
+inline uint8_t PaethPredictor(int a, int b, int c) {
+  int p = a + b - c;
+  int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc)
+    return a;
+  return pb <= pc ? b : c;
+}
+
+/**
+ * @brief Reverses the filtering of a row, in place.
+ *
+ * https://www.w3.org/TR/PNG/#9Filters
+ *
+ * @param prev the previous, already unfiltered row (zeros for the first row)
+ */
+void UnfilterRow(int filter, uint8_t *row, const uint8_t *prev, int64_t row_bytes, int bpp) {
+  switch (filter) {
+    case 0:  // None
+      break;
+    case 1:  // Sub
+      for (int64_t i = bpp; i < row_bytes; i++)
+        row[i] += row[i - bpp];
+      break;
+    case 2:  // Up
+      for (int64_t i = 0; i < row_bytes; i++)
+        row[i] += prev[i];
+      break;
+    case 3:  // Average
+      for (int64_t i = 0; i < bpp; i++)
+        row[i] += prev[i] >> 1;
+      for (int64_t i = bpp; i < row_bytes; i++)
+        row[i] += (row[i - bpp] + prev[i]) >> 1;
+      break;
+    case 4:  // Paeth
+      for (int64_t i = 0; i < bpp; i++)
+        row[i] += prev[i];  // the predictor of (0, up, 0) is up
+      for (int64_t i = bpp; i < row_bytes; i++)
+        row[i] += PaethPredictor(row[i - bpp], prev[i], prev[i - bpp]);
+      break;
+    default:
+      DALI_FAIL(make_string("Invalid PNG filter type: ", filter));
+  }
+}
+
+/**
+ * @brief Inflates the concatenated IDAT chunks to `out`, until it's full.
+ *
+ * @return the number of bytes inflated
+ */
+int64_t InflateImageData(span<const uint8_t> data, int64_t offset, uint8_t *out,
+                         int64_t out_size) {
+  z_stream zs;
+  std::memset(&zs, 0, sizeof(zs));
+  DALI_ENFORCE(inflateInit(&zs) == Z_OK, "Could not initialize zlib.");
+  struct InflateGuard {
+    z_stream *zs;
+    ~InflateGuard() { inflateEnd(zs); }
+  } guard{&zs};
+
+  constexpr int64_t kMaxAvail = std::numeric_limits<uInt>::max();
+  int64_t produced = 0;
+  bool stream_end = false;
+  PngChunk chunk;
+  while (!stream_end && produced < out_size && ReadChunk(data, offset, chunk)) {
+    if (IsChunk(chunk, "IEND"))
+      break;
+    if (!IsChunk(chunk, "IDAT"))
+      continue;
+    const uint8_t *in = chunk.data.data();
+    int64_t in_left = chunk.data.size();
+    while (in_left > 0 && produced < out_size) {
+      zs.next_in = const_cast<Bytef *>(in);
+      zs.avail_in = std::min(in_left, kMaxAvail);
+      zs.next_out = out + produced;
+      zs.avail_out = std::min(out_size - produced, kMaxAvail);
+      uInt avail_in = zs.avail_in, avail_out = zs.avail_out;
+      int ret = inflate(&zs, Z_NO_FLUSH);
+      DALI_ENFORCE(ret == Z_OK || ret == Z_STREAM_END || ret == Z_BUF_ERROR,
+                   make_string("Corrupted PNG image data: ", zs.msg ? zs.msg : "zlib error"));
+      in += avail_in - zs.avail_in;
+      in_left -= avail_in - zs.avail_in;
+      produced += avail_out - zs.avail_out;
+      if (ret == Z_STREAM_END) {
+        stream_end = true;
+        break;
+      }
+    }
+  }
+  return produced;
+}
+
+#endif  // ZLIB_ENABLED
+
+}  // namespace
+
+bool ParsePngHeader(span<const uint8_t> data, PngInfo &info) {
+  int64_t offset = sizeof(kPngSignature);
+  if (data.size() < offset || std::memcmp(data.data(), kPngSignature, offset) != 0)
+    return false;
+  PngChunk ihdr;
+  if (!ReadChunk(data, offset, ihdr) || !IsChunk(ihdr, "IHDR") || ihdr.data.size() < kIhdrSize)
+    return false;
+  const uint8_t *p = ihdr.data.data();
+  uint32_t width = ReadValueBE<uint32_t>(p);
+  uint32_t height = ReadValueBE<uint32_t>(p + 4);
+  if (width > static_cast<uint32_t>(std::numeric_limits<int>::max()) ||
+      height > static_cast<uint32_t>(std::numeric_limits<int>::max()))
+    return false;
+  info.width = width;
+  info.height = height;
+  info.bit_depth = p[8];
+  info.color_type = p[9];
+  // p[10] and p[11] are the compression and filter methods - only 0 is defined
+  if (p[10] != 0 || p[11] != 0)
+    return false;
+  info.interlaced = p[12] != 0;
+  return true;
+}
+
+#if ZLIB_ENABLED
+
+void DecodePngRegion(span<const uint8_t> data, const PngInfo &info, const CropWindow &roi,
+                     uint8_t *dst, std::vector<uint8_t> &scratch) {
+  DALI_ENFORCE(IsPngRegionDecodingSupported(info), "Unsupported PNG image.");
+  int64_t y0 = 0, x0 = 0, h = info.height, w = info.width;
+  if (roi) {
+    y0 = roi.anchor[0];
+    x0 = roi.anchor[1];
+    h = roi.shape[0];
+    w = roi.shape[1];
+    DALI_ENFORCE(y0 >= 0 && x0 >= 0 && y0 + h <= info.height && x0 + w <= info.width,
+                 "The region of interest is out of the image bounds.");
+  }
+
+  const int bpp = info.bytes_per_pixel();
+  const int64_t row_bytes = info.width * static_cast<int64_t>(bpp);
+  const int64_t stride = row_bytes + 1;  // each row starts with the filter type
+  const int64_t nrows = y0 + h;          // the rows below the region are not needed
+  // the first row is a zero row, preceding the image
+  scratch.resize((nrows + 1) * stride);
+  std::memset(scratch.data(), 0, stride);
+  uint8_t *filtered = scratch.data() + stride;
+  int64_t out_size = nrows * stride;
+
+  int64_t offset = sizeof(kPngSignature);
+  int64_t produced = InflateImageData(data, offset, filtered, out_size);
+  DALI_ENFORCE(produced == out_size,
+               make_string("Truncated PNG image data: got ", produced, " bytes out of ",
+                           out_size, "."));
+
+  for (int64_t y = 0; y < nrows; y++) {
+    uint8_t *row = filtered + y * stride;
+    UnfilterRow(row[0], row + 1, row + 1 - stride, row_bytes, bpp);
+  }
+
+  const int64_t out_row_bytes = w * bpp;
+  for (int64_t y = y0; y < nrows; y++) {
+    std::memcpy(dst, filtered + y * stride + 1 + x0 * bpp, out_row_bytes);
+    dst += out_row_bytes;
+  }
+}
+
+#endif  // ZLIB_ENABLED
+
+}  // namespace dali
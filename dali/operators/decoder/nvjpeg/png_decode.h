@@ -0,0 +1,104 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_DECODER_NVJPEG_PNG_DECODE_H_
+#define DALI_OPERATORS_DECODER_NVJPEG_PNG_DECODE_H_
+
+#include <cstdint>
+#include <vector>
+#include "dali/core/api_helper.h"
+#include "dali/core/common.h"
+#include "dali/core/span.h"
+#include "dali/util/crop_window.h"
+
+namespace dali {
+
+/**
+ * @brief The properties of a PNG image, read from its IHDR chunk
+ */
+struct PngInfo {
+  enum ColorType : uint8_t {
+    kGray = 0,
+    kRGB = 2,
+    kPalette = 3,
+    kGrayAlpha = 4,
+    kRGBA = 6,
+  };
+
+  int height = 0;
+  int width = 0;
+  int bit_depth = 0;
+  uint8_t color_type = kGray;
+  bool interlaced = false;
+
+  /// The number of channels stored in the image data
+  int channels() const {
+    switch (color_type) {
+      case kGrayAlpha:
+        return 2;
+      case kRGB:
+        return 3;
+      case kRGBA:
+        return 4;
+      default:
+        return 1;
+    }
+  }
+
+  /// The number of bytes per pixel, for the bit depths of 8 and more
+  int bytes_per_pixel() const {
+    return channels() * bit_depth / 8;
+  }
+};
+
+/**
+ * @brief Reads the header of a PNG image.
+ *
+ * @return false, if the data is not a PNG image
+ */
+DLL_PUBLIC bool ParsePngHeader(span<const uint8_t> data, PngInfo &info);
+
+/**
+ * @brief Checks whether the image can be decoded by DecodePngRegion: 8 or 16-bit grayscale or
+ *        RGB, with or without alpha, not interlaced.
+ *
+ * The palette images and the bit depths below 8 are left to the general purpose decoders.
+ */
+inline bool IsPngRegionDecodingSupported(const PngInfo &info) {
+  return (info.bit_depth == 8 || info.bit_depth == 16) && !info.interlaced &&
+         info.color_type != PngInfo::kPalette && info.height > 0 && info.width > 0;
+}
+
+#if ZLIB_ENABLED
+
+/**
+ * @brief Inflates and unfilters the rows of a PNG image, up to the last row of the region of
+ *        interest, and copies the region to `dst`.
+ *
+ * The pixels are stored densely, with the channels of the image data (see PngInfo::channels)
+ * and the 16-bit samples in the big-endian order - the color conversion is left to the caller.
+ * Only the image data is decoded: the ancillary chunks (e.g. gamma or transparency) are ignored.
+ *
+ * @param roi     the region of interest, in HW order; if empty, the whole image is decoded
+ * @param scratch a buffer for the filtered rows, reused between the calls
+ */
+DLL_PUBLIC void DecodePngRegion(span<const uint8_t> data, const PngInfo &info,
+                                const CropWindow &roi, uint8_t *dst,
+                                std::vector<uint8_t> &scratch);
+
+#endif  // ZLIB_ENABLED
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_DECODER_NVJPEG_PNG_DECODE_H_
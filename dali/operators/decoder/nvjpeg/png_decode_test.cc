@@ -0,0 +1,143 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <random>
+#include <vector>
+#include "dali/operators/decoder/nvjpeg/png_decode.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief Encodes a random, partially smooth image, so that different filters are used.
+ */
+std::vector<uint8_t> EncodeTestPng(int height, int width, int cv_type, cv::Mat &image) {
+  std::mt19937 rng(height * 31 + width + cv_type);
+  image = cv::Mat(height, width, cv_type);
+  int channels = image.channels();
+  bool is16 = image.depth() == CV_16U;
+  std::uniform_int_distribution<int> noise(0, is16 ? 65535 : 255);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      for (int c = 0; c < channels; c++) {
+        int v = x < width / 2 ? (x * 7 + y * 3 + c * 50) : noise(rng);
+        if (is16)
+          image.ptr<uint16_t>(y)[x * channels + c] = v * 257;
+        else
+          image.ptr<uint8_t>(y)[x * channels + c] = v;
+      }
+    }
+  }
+  std::vector<uint8_t> encoded;
+  EXPECT_TRUE(cv::imencode(".png", image, encoded));
+  return encoded;
+}
+
+/**
+ * @brief Converts an OpenCV image to the layout of the PNG image data (RGB, big-endian)
+ */
+std::vector<uint8_t> ToPngData(const cv::Mat &bgr) {
+  cv::Mat image = bgr;
+  if (bgr.channels() == 3)
+    cv::cvtColor(bgr, image, cv::COLOR_BGR2RGB);
+  else if (bgr.channels() == 4)
+    cv::cvtColor(bgr, image, cv::COLOR_BGRA2RGBA);
+  std::vector<uint8_t> data;
+  int64_t row_bytes = image.cols * image.elemSize();
+  for (int y = 0; y < image.rows; y++) {
+    const uint8_t *row = image.ptr<uint8_t>(y);
+    if (image.depth() == CV_16U) {
+      for (int64_t i = 0; i < row_bytes; i += 2) {
+        data.push_back(row[i + 1]);
+        data.push_back(row[i]);
+      }
+    } else {
+      data.insert(data.end(), row, row + row_bytes);
+    }
+  }
+  return data;
+}
+
+}  // namespace
+
+TEST(PngDecodeTest, ParseHeader) {
+  cv::Mat image;
+  auto encoded = EncodeTestPng(21, 37, CV_8UC3, image);
+  PngInfo info;
+  ASSERT_TRUE(ParsePngHeader(make_cspan(encoded), info));
+  EXPECT_EQ(info.height, 21);
+  EXPECT_EQ(info.width, 37);
+  EXPECT_EQ(info.bit_depth, 8);
+  EXPECT_EQ(info.color_type, PngInfo::kRGB);
+  EXPECT_EQ(info.channels(), 3);
+  EXPECT_FALSE(info.interlaced);
+  EXPECT_TRUE(IsPngRegionDecodingSupported(info));
+
+  std::vector<uint8_t> not_png(encoded.begin(), encoded.end());
+  not_png[1] = 'X';
+  EXPECT_FALSE(ParsePngHeader(make_cspan(not_png), info));
+  std::vector<uint8_t> truncated(encoded.begin(), encoded.begin() + 20);
+  EXPECT_FALSE(ParsePngHeader(make_cspan(truncated), info));
+}
+
+#if ZLIB_ENABLED
+
+TEST(PngDecodeTest, DecodeFull) {
+  std::vector<uint8_t> scratch;
+  for (int cv_type : { CV_8UC1, CV_8UC3, CV_8UC4, CV_16UC1, CV_16UC3, CV_16UC4 }) {
+    cv::Mat image;
+    auto encoded = EncodeTestPng(45, 67, cv_type, image);
+    PngInfo info;
+    ASSERT_TRUE(ParsePngHeader(make_cspan(encoded), info));
+    ASSERT_TRUE(IsPngRegionDecodingSupported(info));
+    auto expected = ToPngData(image);
+    std::vector<uint8_t> decoded(expected.size());
+    DecodePngRegion(make_cspan(encoded), info, {}, decoded.data(), scratch);
+    EXPECT_EQ(decoded, expected) << "cv type: " << cv_type;
+  }
+}
+
+TEST(PngDecodeTest, DecodeRegion) {
+  cv::Mat image;
+  auto encoded = EncodeTestPng(50, 60, CV_8UC3, image);
+  PngInfo info;
+  ASSERT_TRUE(ParsePngHeader(make_cspan(encoded), info));
+  CropWindow roi;
+  roi.anchor = {10, 15};
+  roi.shape = {20, 30};
+  std::vector<uint8_t> decoded(20 * 30 * 3);
+  std::vector<uint8_t> scratch;
+  DecodePngRegion(make_cspan(encoded), info, roi, decoded.data(), scratch);
+  auto expected = ToPngData(image(cv::Rect(15, 10, 30, 20)).clone());
+  EXPECT_EQ(decoded, expected);
+}
+
+TEST(PngDecodeTest, Truncated) {
+  cv::Mat image;
+  auto encoded = EncodeTestPng(50, 60, CV_8UC3, image);
+  PngInfo info;
+  ASSERT_TRUE(ParsePngHeader(make_cspan(encoded), info));
+  encoded.resize(encoded.size() / 2);
+  std::vector<uint8_t> decoded(50 * 60 * 3);
+  std::vector<uint8_t> scratch;
+  EXPECT_THROW(DecodePngRegion(make_cspan(encoded), info, {}, decoded.data(), scratch),
+               std::exception);
+}
+
+#endif  // ZLIB_ENABLED
+
+}  // namespace dali
@@ -71,6 +71,7 @@ DALI_SCHEMA(Cast)
     .NumOutput(1)
     .AllowSequences()
     .SupportVolumetric()
+    .CudaGraphCapturable()
     .AddArg("dtype", R"code(Output data type.)code", DALI_DATA_TYPE);
 
 }  // namespace dali
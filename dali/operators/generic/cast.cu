@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 #include "dali/core/convert.h"
@@ -21,8 +22,10 @@
 #include "dali/core/static_switch.h"
 #include "dali/kernels/common/block_setup.h"
 #include "dali/kernels/common/cast.cuh"
+#include "dali/kernels/common/flat_batch.h"
 #include "dali/kernels/dynamic_scratchpad.h"
 #include "dali/operators/generic/cast.h"
+#include "dali/pipeline/data/views.h"
 
 
 namespace dali {
@@ -39,6 +42,15 @@ class CastGPU : public Cast<GPUBackend> {
  protected:
   void PrepareBlocks(const DeviceWorkspace &ws);
 
+  /**
+   * @brief Casts the whole batch as one flat array, if both the input and the output
+   *        are densely packed
+   *
+   * @return true, if the batch was processed
+   */
+  template <typename OType, typename IType>
+  bool TryRunFlat(DeviceWorkspace &ws);
+
   static const int block_volume_scale = 4;
 
  private:
@@ -69,12 +81,38 @@ void CastGPU::PrepareBlocks(const DeviceWorkspace &ws) {
   block_setup_.SetupBlocks(collapsed_shape, true);
 }
 
+template <typename OType, typename IType>
+bool CastGPU::TryRunFlat(DeviceWorkspace &ws) {
+  const auto &input = ws.Input<GPUBackend>(0);
+  auto *out = kernels::DenselyPackedData(view<OType>(ws.Output<GPUBackend>(0)));
+  const auto *in = kernels::DenselyPackedData(view<const IType>(input));
+  if (!out || !in)
+    return false;
+  int64_t size = input.shape().num_elements();
+  const int block_size = 256;
+  int grid_size = std::min<int64_t>(div_ceil(size, block_size * block_volume_scale), 65535);
+  kernels::FlatCastKernel<<<grid_size, block_size, 0, ws.stream()>>>(out, in, size);
+  CUDA_CALL(cudaGetLastError());
+  return true;
+}
+
 void CastGPU::RunImpl(DeviceWorkspace &ws) {
   const auto &input = ws.Input<GPUBackend>(0);
   const auto &input_shape = input.shape();
   auto &output = ws.Output<GPUBackend>(0);
   output.SetLayout(input.GetLayout());
 
+  DALIDataType itype = input.type();
+  // Many small samples (e.g. labels) are cheaper to cast when the batch is treated as one array
+  bool done = false;
+  TYPE_SWITCH(output_type_, type2id, OType, CAST_ALLOWED_TYPES, (
+    TYPE_SWITCH(itype, type2id, IType, CAST_ALLOWED_TYPES, (
+      done = TryRunFlat<OType, IType>(ws);
+    ), DALI_FAIL(make_string("Invalid input type: ", itype)););  // NOLINT(whitespace/parens)
+  ), DALI_FAIL(make_string("Invalid output type: ", output_type_)););  // NOLINT(whitespace/parens)
+  if (done)
+    return;
+
   kernels::DynamicScratchpad scratchpad({}, ws.stream());
   auto num_samples = input_shape.num_samples();
   samples_.resize(num_samples);
@@ -102,7 +140,6 @@ void CastGPU::RunImpl(DeviceWorkspace &ws) {
   std::tie(params_dev, samples_dev) = scratchpad.ToContiguousGPU(ws.stream(),
                                                                  params_host, samples_);
 
-  DALIDataType itype = input.type();
   dim3 grid_dim = block_setup_.GridDim();
   dim3 block_dim = block_setup_.BlockDim();
   TYPE_SWITCH(output_type_, type2id, OType, CAST_ALLOWED_TYPES, (
@@ -36,7 +36,10 @@ This argument is mutually exclusive with ``axis``.
 This argument requires that at least one input has a non-empty layout and that all non-empty
 input layouts match.)", nullptr, false)
   .NumInput(1, 999)
-  .NumOutput(1);
+  .NumOutput(1)
+  .ConcatenatesInputsFn([](const OpSpec &spec) {
+    return !spec.HasArgument("axis_name") && spec.GetArgument<int>("axis") == 0;
+  });
 
 DALI_SCHEMA(Stack)
   .DocStr(R"(Joins the input tensors along a new axis.
@@ -54,7 +57,10 @@ constructed by inserting that character into the input layout at the position in
 For example, specifying ``axis = 0`` and ``axis_name = "C"`` with input layout "HW" will yield
 the output layout "CHW")", nullptr, false)
   .NumInput(1, 999)
-  .NumOutput(1);
+  .NumOutput(1)
+  .ConcatenatesInputsFn([](const OpSpec &spec) {
+    return spec.GetArgument<int>("axis") == 0;
+  });
 
 #define TENSOR_JOIN_TYPES (bool, uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, \
                           uint64_t, int64_t, float16, float, double)
@@ -170,9 +176,34 @@ void TensorJoin<Backend, new_axis>::SetupAxis() {
   }
 }
 
+template <typename Backend, bool new_axis>
+bool TensorJoin<Backend, new_axis>::InputsInPlace(workspace_t<Backend> &ws) {
+  if (axis_ != 0)
+    return false;
+  auto &out = ws.template Output<Backend>(0);
+  int ninp = this->spec_.NumRegularInput();
+  size_t type_size = out.type_info().size();
+  for (int s = 0; s < out.num_samples(); s++) {
+    auto *ptr = static_cast<const uint8_t *>(out.raw_tensor(s));
+    for (int i = 0; i < ninp; i++) {
+      const auto &in = ws.template Input<Backend>(i);
+      size_t bytes = volume(in.tensor_shape(s)) * type_size;
+      if (bytes > 0 && in.raw_tensor(s) != ptr)
+        return false;
+      ptr += bytes;
+    }
+  }
+  return true;
+}
+
 template <typename Backend, bool new_axis>
 void TensorJoin<Backend, new_axis>::RunImpl(workspace_t<Backend> &ws) {
   auto &out = ws.template Output<Backend>(0);
+  if (InputsInPlace(ws)) {
+    // the producers have written the inputs directly into the output
+    out.SetLayout(output_layout_);
+    return;
+  }
   if (copy_idx_ >= 0) {
     // just one non-empty input - copy it to the output and return
     TensorListShape<> shape;
@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -73,6 +73,13 @@ class TensorJoin : public Operator<Backend> {
   template <typename T>
   void RunTyped(const TensorListView<Storage, T> &out, DeviceWorkspace &ws);
 
+  /**
+   * @brief Checks whether the inputs are already stored in the output, one after another
+   *
+   * The executor makes the producers write the inputs there, see OpSchema::ConcatenatesInputsFn.
+   */
+  bool InputsInPlace(workspace_t<Backend> &ws);
+
   void GetInputLayout(const workspace_t<Backend> &ws);
   void SetupAxis();
   void SetOutputLayout(const workspace_t<Backend> &ws);
@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <random>
+#include <string>
 #include "dali/pipeline/operator/operator.h"
 #include "dali/pipeline/util/batch_rng.h"
 #include "dali/pipeline/operator/arg_helper.h"
@@ -71,6 +72,8 @@ class ROIRandomCropCPU : public Operator<CPUBackend> {
  public:
   explicit ROIRandomCropCPU(const OpSpec &spec);
   bool CanInferOutputs() const override { return true; }
+  std::string SaveState() override { return rngs_.SaveState(); }
+  void RestoreState(const std::string &state) override { rngs_.RestoreState(state); }
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<CPUBackend> &ws) override;
   void RunImpl(workspace_t<CPUBackend> &ws) override;
 
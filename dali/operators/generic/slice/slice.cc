@@ -61,6 +61,7 @@ order for the slice arguments.)code")
     .NumInput(1, 3)
     .InputDevice(1, 3, InputDevice::CPU)
     .NumOutput(1)
+    .CacheableSetup({1, 2})
     .InputDox(0, "data", "TensorList", R"code(Batch that contains the input data.)code")
     .InputDox(1, "anchor", "1D TensorList of float or int",
                  R"code((Optional) Input that contains normalized or absolute coordinates for the starting
@@ -0,0 +1,231 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+#include "dali/core/static_switch.h"
+#include "dali/operators/generic/split_merge.h"
+
+#define PREDICATE_TYPES \
+  (bool, uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t, int32_t, int64_t)
+
+namespace dali {
+
+DALI_SCHEMA(_conditional__Split)
+  .DocStr(R"code(Splits the batch into the samples with a true and a false ``predicate``.
+
+The first output contains the samples for which the predicate is true, the second one -
+the remaining samples; both keep the order of the samples in the input. The branches of
+a conditional are computed from these outputs, so that each of them processes only the samples
+which it owns.
+
+The CPU operator doesn't copy the data - the output samples share the memory of the input.)code")
+  .NumInput(1)
+  .NumOutput(2)
+  .AddArg("predicate", R"code(A batch of per-sample scalars, boolean or integral.
+
+Nonzero values route the sample to the first output.)code", DALI_BOOL, true)
+  .NonUniformBatch()
+  .MakeInternal();
+
+DALI_SCHEMA(_conditional__Merge)
+  .DocStr(R"code(Merges the outputs of the two branches of a conditional into one batch.
+
+The output sample ``i`` is the next sample of the first input if ``predicate[i]`` is true,
+or the next sample of the second input otherwise. The inputs must contain exactly as many
+samples as the predicate routes to them - typically they're computed from the outputs of
+``_conditional.Split`` with the same predicate. Both inputs must have the same type,
+dimensionality and layout.)code")
+  .NumInput(2)
+  .NumOutput(1)
+  .AddArg("predicate", R"code(A batch of per-sample scalars, boolean or integral.
+
+Nonzero values take the sample from the first input.)code", DALI_BOOL, true)
+  .NonUniformBatch()
+  .MakeInternal();
+
+namespace {
+
+TensorListShape<> GatherShapes(const TensorListShape<> &in_shape, const std::vector<int> &indices) {
+  TensorListShape<> out_shape(indices.size(), in_shape.sample_dim());
+  for (int i = 0; i < out_shape.num_samples(); i++)
+    out_shape.set_tensor_shape(i, in_shape[indices[i]]);
+  return out_shape;
+}
+
+}  // namespace
+
+template <typename Backend>
+int BranchRouting<Backend>::RouteSamples(const workspace_t<Backend> &ws) {
+  const auto &pred = ws.ArgumentInput("predicate");
+  int nsamples = pred.num_samples();
+  predicate_.resize(nsamples);
+  TYPE_SWITCH(pred.type(), type2id, T, PREDICATE_TYPES, (
+    for (int i = 0; i < nsamples; i++) {
+      DALI_ENFORCE(volume(pred.tensor_shape(i)) == 1, make_string(
+          "The predicate must be a scalar for each sample. Got a tensor of shape ",
+          pred.tensor_shape(i), " for the sample ", i, "."));
+      predicate_[i] = *pred.template tensor<T>(i) != 0;
+    }
+  ), (DALI_FAIL(make_string("The predicate must be boolean or integral. Got: ",  // NOLINT
+                            pred.type()))));
+
+  branch_samples_[0].clear();
+  branch_samples_[1].clear();
+  branch_sample_idx_.resize(nsamples);
+  for (int i = 0; i < nsamples; i++) {
+    auto &samples = branch_samples_[predicate_[i] ? 0 : 1];
+    branch_sample_idx_[i] = samples.size();
+    samples.push_back(i);
+  }
+  return nsamples;
+}
+
+bool Split<CPUBackend>::SetupImpl(vector<OutputDesc> &outputs, const HostWorkspace &ws) {
+  int nsamples = RouteSamples(ws);
+  DALI_ENFORCE(nsamples == ws.GetInputBatchSize(0), make_string(
+      "The predicate has ", nsamples, " samples, but the input batch has ",
+      ws.GetInputBatchSize(0), "."));
+  return false;
+}
+
+void Split<CPUBackend>::RunImpl(HostWorkspace &ws) {
+  const auto &input = ws.Input<CPUBackend>(0);
+  for (int b = 0; b < 2; b++) {
+    auto &output = ws.Output<CPUBackend>(b);
+    const auto &samples = branch_samples_[b];
+    output.Reset();
+    output.SetupLike(input);
+    output.SetSize(samples.size());
+    for (int i = 0; i < static_cast<int>(samples.size()); i++)
+      output.UnsafeSetSample(i, input, samples[i]);
+  }
+}
+
+bool Split<GPUBackend>::SetupImpl(vector<OutputDesc> &outputs, const DeviceWorkspace &ws) {
+  int nsamples = RouteSamples(ws);
+  const auto &input = ws.Input<GPUBackend>(0);
+  DALI_ENFORCE(nsamples == input.num_samples(), make_string(
+      "The predicate has ", nsamples, " samples, but the input batch has ", input.num_samples(),
+      "."));
+  const auto &in_shape = input.shape();
+  outputs.resize(2);
+  for (int b = 0; b < 2; b++) {
+    outputs[b].type = input.type();
+    outputs[b].shape = GatherShapes(in_shape, branch_samples_[b]);
+  }
+  return true;
+}
+
+void Split<GPUBackend>::RunImpl(DeviceWorkspace &ws) {
+  const auto &input = ws.Input<GPUBackend>(0);
+  const auto &in_shape = input.shape();
+  int element_size = input.type_info().size();
+  for (int b = 0; b < 2; b++) {
+    auto &output = ws.Output<GPUBackend>(b);
+    const auto &samples = branch_samples_[b];
+    output.SetLayout(input.GetLayout());
+    for (int i = 0; i < static_cast<int>(samples.size()); i++) {
+      int src = samples[i];
+      output.SetMeta(i, input.GetMeta(src));
+      sg_.AddCopy(output.raw_mutable_tensor(i), input.raw_tensor(src),
+                  in_shape.tensor_size(src) * element_size);
+    }
+  }
+  sg_.Run(ws.stream());
+}
+
+template <typename Backend>
+bool MergeBase<Backend>::SetupImpl(vector<OutputDesc> &outputs,
+                                   const workspace_t<Backend> &ws) {
+  int nsamples = this->RouteSamples(ws);
+  const char *branch_names[2] = { "true", "false" };
+  for (int b = 0; b < 2; b++) {
+    int routed = branch_samples_[b].size();
+    DALI_ENFORCE(ws.GetInputBatchSize(b) == routed, make_string(
+        "The ", branch_names[b], " branch produced ", ws.GetInputBatchSize(b),
+        " samples, but the predicate routed ", routed, " samples to it."));
+  }
+  const auto &in_true = ws.template Input<Backend>(0);
+  const auto &in_false = ws.template Input<Backend>(1);
+  // A branch without any samples doesn't run, so its output carries no type or layout
+  const auto &ref = branch_samples_[0].empty() ? in_false : in_true;
+  if (!branch_samples_[0].empty() && !branch_samples_[1].empty()) {
+    DALI_ENFORCE(in_true.type() == in_false.type() &&
+                 in_true.shape().sample_dim() == in_false.shape().sample_dim() &&
+                 in_true.GetLayout() == in_false.GetLayout(), make_string(
+        "The outputs of both branches must have the same type, dimensionality and layout. Got: ",
+        in_true.type(), " ", in_true.shape().sample_dim(), "D \"", in_true.GetLayout(),
+        "\" and ", in_false.type(), " ", in_false.shape().sample_dim(), "D \"",
+        in_false.GetLayout(), "\"."));
+  }
+
+  TensorListShape<> in_shapes[2] = { in_true.shape(), in_false.shape() };
+  outputs.resize(1);
+  outputs[0].type = ref.type();
+  auto &out_shape = outputs[0].shape;
+  out_shape.resize(nsamples, ref.shape().sample_dim());
+  for (int i = 0; i < nsamples; i++)
+    out_shape.set_tensor_shape(i, in_shapes[predicate_[i] ? 0 : 1][branch_sample_idx_[i]]);
+  return true;
+}
+
+void Merge<CPUBackend>::RunImpl(HostWorkspace &ws) {
+  auto &output = ws.Output<CPUBackend>(0);
+  const TensorVector<CPUBackend> *inputs[2] = {
+    &ws.Input<CPUBackend>(0), &ws.Input<CPUBackend>(1)
+  };
+  output.SetLayout(inputs[branch_samples_[0].empty() ? 1 : 0]->GetLayout());
+  const auto &out_shape = output.shape();
+
+  auto &tp = ws.GetThreadPool();
+  for (int i = 0; i < out_shape.num_samples(); i++) {
+    const auto *input = inputs[predicate_[i] ? 0 : 1];
+    int src = branch_sample_idx_[i];
+    tp.AddWork([&, i, input, src](int tid) {
+      output.SetMeta(i, input->GetMeta(src));
+      output.UnsafeCopySample(i, *input, src);
+    }, out_shape.tensor_size(i));
+  }
+  tp.RunAll();
+}
+
+void Merge<GPUBackend>::RunImpl(DeviceWorkspace &ws) {
+  auto &output = ws.Output<GPUBackend>(0);
+  const TensorList<GPUBackend> *inputs[2] = {
+    &ws.Input<GPUBackend>(0), &ws.Input<GPUBackend>(1)
+  };
+  output.SetLayout(inputs[branch_samples_[0].empty() ? 1 : 0]->GetLayout());
+  const auto &out_shape = output.shape();
+  int element_size = output.type_info().size();
+  for (int i = 0; i < out_shape.num_samples(); i++) {
+    const auto *input = inputs[predicate_[i] ? 0 : 1];
+    int src = branch_sample_idx_[i];
+    output.SetMeta(i, input->GetMeta(src));
+    sg_.AddCopy(output.raw_mutable_tensor(i), input->raw_tensor(src),
+                out_shape.tensor_size(i) * element_size);
+  }
+  sg_.Run(ws.stream());
+}
+
+template class BranchRouting<CPUBackend>;
+template class BranchRouting<GPUBackend>;
+template class MergeBase<CPUBackend>;
+template class MergeBase<GPUBackend>;
+
+DALI_REGISTER_OPERATOR(_conditional__Split, Split<CPUBackend>, CPU);
+DALI_REGISTER_OPERATOR(_conditional__Split, Split<GPUBackend>, GPU);
+DALI_REGISTER_OPERATOR(_conditional__Merge, Merge<CPUBackend>, CPU);
+DALI_REGISTER_OPERATOR(_conditional__Merge, Merge<GPUBackend>, GPU);
+
+}  // namespace dali
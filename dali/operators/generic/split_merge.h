@@ -0,0 +1,139 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_GENERIC_SPLIT_MERGE_H_
+#define DALI_OPERATORS_GENERIC_SPLIT_MERGE_H_
+
+#include <vector>
+#include "dali/pipeline/operator/operator.h"
+#include "dali/kernels/common/scatter_gather.h"
+
+namespace dali {
+
+/**
+ * @brief Common part of the operators which route the samples to the branches of a conditional
+ *
+ * The samples are assigned to the branches by the per-sample ``predicate`` argument input:
+ * the samples with a true predicate go to the branch 0, the remaining ones - to the branch 1.
+ */
+template <typename Backend>
+class BranchRouting : public Operator<Backend> {
+ public:
+  explicit BranchRouting(const OpSpec &spec) : Operator<Backend>(spec) {
+    DALI_ENFORCE(spec.HasTensorArgument("predicate"),
+                 "The ``predicate`` must be an argument input - a batch of per-sample scalars.");
+  }
+
+ protected:
+  /**
+   * @brief Reads the predicate and lists the samples of each branch, in their original order
+   *
+   * @return the number of samples in the predicate
+   */
+  int RouteSamples(const workspace_t<Backend> &ws);
+
+  /**
+   * @brief For each of the branches, the indices (in the whole batch) of its samples
+   */
+  std::vector<int> branch_samples_[2];
+  /**
+   * @brief For each sample of the whole batch, its index in the batch of its branch
+   */
+  std::vector<int> branch_sample_idx_;
+  std::vector<bool> predicate_;
+};
+
+/**
+ * @brief Splits the batch into the samples with a true and a false predicate
+ */
+template <typename Backend>
+class Split;
+
+template <>
+class Split<CPUBackend> : public BranchRouting<CPUBackend> {
+ public:
+  using BranchRouting::BranchRouting;
+
+  // The samples are not copied - the outputs share them with the input
+  bool CanInferOutputs() const override {
+    return false;
+  }
+
+  bool SetupImpl(vector<OutputDesc> &outputs, const HostWorkspace &ws) override;
+
+  void RunImpl(HostWorkspace &ws) override;
+};
+
+template <>
+class Split<GPUBackend> : public BranchRouting<GPUBackend> {
+ public:
+  explicit Split(const OpSpec &spec) : BranchRouting<GPUBackend>(spec), sg_(1<<18) {}
+
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
+  bool SetupImpl(vector<OutputDesc> &outputs, const DeviceWorkspace &ws) override;
+
+  void RunImpl(DeviceWorkspace &ws) override;
+
+ private:
+  kernels::ScatterGatherGPU sg_;
+};
+
+/**
+ * @brief Merges the outputs of the two branches back into one batch, in the original order
+ */
+template <typename Backend>
+class MergeBase : public BranchRouting<Backend> {
+ public:
+  using BranchRouting<Backend>::BranchRouting;
+
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
+  bool SetupImpl(vector<OutputDesc> &outputs, const workspace_t<Backend> &ws) override;
+
+ protected:
+  using BranchRouting<Backend>::branch_samples_;
+  using BranchRouting<Backend>::branch_sample_idx_;
+  using BranchRouting<Backend>::predicate_;
+};
+
+template <typename Backend>
+class Merge;
+
+template <>
+class Merge<CPUBackend> : public MergeBase<CPUBackend> {
+ public:
+  using MergeBase::MergeBase;
+
+  void RunImpl(HostWorkspace &ws) override;
+};
+
+template <>
+class Merge<GPUBackend> : public MergeBase<GPUBackend> {
+ public:
+  explicit Merge(const OpSpec &spec) : MergeBase<GPUBackend>(spec), sg_(1<<18) {}
+
+  void RunImpl(DeviceWorkspace &ws) override;
+
+ private:
+  kernels::ScatterGatherGPU sg_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_GENERIC_SPLIT_MERGE_H_
@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -18,6 +18,7 @@
 #include <string>
 #include <vector>
 
+#include "dali/pipeline/operator/arg_helper.h"
 #include "dali/pipeline/operator/common.h"
 #include "dali/pipeline/operator/operator.h"
 
@@ -28,7 +29,9 @@ class CoordFlip : public Operator<Backend> {
  public:
   explicit CoordFlip(const OpSpec &spec)
       : Operator<Backend>(spec)
-      , layout_(spec.GetArgument<TensorLayout>("layout")) {}
+      , layout_(spec.GetArgument<TensorLayout>("layout"))
+      , flip_x_("flip_x", spec), flip_y_("flip_y", spec), flip_z_("flip_z", spec)
+      , center_x_("center_x", spec), center_y_("center_y", spec), center_z_("center_z", spec) {}
 
   ~CoordFlip() override = default;
   DISABLE_COPY_MOVE_ASSIGN(CoordFlip);
@@ -100,6 +103,9 @@ class CoordFlip : public Operator<Backend> {
   int ndim_ = -1;
   // Indices of x, y and z dimensions
   int x_dim_ = -1, y_dim_ = -1, z_dim_ = -1;
+  // Per-sample arguments
+  ScalarArg<int> flip_x_, flip_y_, flip_z_;
+  ScalarArg<float> center_x_, center_y_, center_z_;
 };
 
 }  // namespace dali
@@ -37,6 +37,7 @@ This operator can be used for many operations. Here's the (incomplete) list:
 )")
   .NumInput(1)
   .NumOutput(1)
+  .CudaGraphCapturable()
   .AddOptionalArg("dtype", R"(Data type of the output coordinates.
 
 If an integral type is used, the output values are rounded to the nearest integer and clamped
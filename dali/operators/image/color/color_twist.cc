@@ -12,11 +12,23 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <vector>
 #include "dali/operators/image/color/color_twist.h"
 #include "dali/kernels/imgproc/pointwise/linear_transformation_cpu.h"
 
 namespace dali {
 
+namespace {
+
+const char kFusedStagesDoc[] =
+    R"code(Color transforms applied before the ones given by the other arguments.
+
+This argument is set by the pipeline, when it fuses consecutive color transforms into one
+operator. Each transform is described by 6 numbers: the kind (0 - a color twist,
+1 - a brightness and contrast adjustment) and its parameters.)code";
+
+}  // namespace
+
 DALI_SCHEMA(Hsv)
     .DocStr(R"code(Adjusts hue, saturation and value (brightness) of the images.
 
@@ -48,6 +60,7 @@ they would in case of rotation.)code",
 
 If a value is not set, the input type is used.)code",
                     DALI_UINT8)
+    .AddOptionalArg(color::kFusedStages, kFusedStagesDoc, std::vector<float>())
     .InputLayout(0, {"HWC", "FHWC", "DHWC"})
     .AllowSequences();
 
@@ -59,6 +72,7 @@ DALI_SCHEMA(ColorTransformBase)
 
 If not set, the input type is used.)code",
                     DALI_UINT8)
+    .AddOptionalArg(color::kFusedStages, kFusedStagesDoc, std::vector<float>())
     .AllowSequences()
     .SupportVolumetric();
 
@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_IMAGE_COLOR_COLOR_TWIST_H_
 #define DALI_OPERATORS_IMAGE_COLOR_COLOR_TWIST_H_
 
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
@@ -23,6 +24,7 @@
 #include "dali/core/tensor_shape_print.h"
 #include "dali/kernels/imgproc/pointwise/linear_transformation_cpu.h"
 #include "dali/kernels/kernel_manager.h"
+#include "dali/operators/image/color/brightness_contrast.h"
 #include "dali/pipeline/data/views.h"
 #include "dali/pipeline/operator/common.h"
 #include "dali/pipeline/operator/operator.h"
@@ -41,6 +43,24 @@ const std::string kValue = "value";             // NOLINT
 const std::string kBrightness = "brightness";   // NOLINT
 const std::string kContrast = "contrast";       // NOLINT
 const std::string kOutputType = "dtype";        // NOLINT
+const std::string kFusedStages = "fused_stages";  // NOLINT
+
+/**
+ * The number of values describing one stage in the `fused_stages` argument: the kind of the stage,
+ * followed by its parameters
+ */
+constexpr int kFusedStageSize = 6;
+
+/**
+ * Hue, saturation, value, brightness and contrast, as in ColorTwist and Hsv
+ */
+constexpr int kFusedColorTwist = 0;
+
+/**
+ * Brightness, absolute brightness shift, contrast and contrast center (NaN for the default),
+ * as in BrightnessContrast
+ */
+constexpr int kFusedBrightnessContrast = 1;
 
 /**
  * Color space conversion
@@ -80,6 +100,22 @@ inline mat3 sat_mat(float saturation) {
   return ret;
 }
 
+/**
+ * Composes the complete transformation matrix of the color twist
+ */
+inline mat3 twist_mat(float hue, float saturation, float value, float brightness,
+                      float contrast) {
+  return mat3(brightness) * mat3(contrast) *
+         Yiq2Rgb * hue_mat(hue) * sat_mat(saturation) * mat3(value) * Rgb2Yiq;
+}
+
+/**
+ * The grey level, around which the contrast of the color twist is changed
+ */
+inline float twist_half_range(DALIDataType type) {
+  return type == DALI_FLOAT16 || type == DALI_FLOAT || type == DALI_FLOAT64 ? 0.5f : 128.f;
+}
+
 }  // namespace color
 
 
@@ -96,6 +132,11 @@ class ColorTwistBase : public Operator<Backend> {
       : Operator<Backend>(spec),
         output_type_arg_(spec.GetArgument<DALIDataType>(color::kOutputType)),
         output_type_(DALI_NO_TYPE) {
+    if (spec.HasArgument(color::kFusedStages))
+      fused_stages_ = spec.GetRepeatedArgument<float>(color::kFusedStages);
+    DALI_ENFORCE(fused_stages_.size() % color::kFusedStageSize == 0,
+                 make_string("Each of the fused stages is described by ", color::kFusedStageSize,
+                             " values, got ", fused_stages_.size(), " values."));
     if (std::is_same<Backend, GPUBackend>::value) {
       kernel_manager_.Resize(1);
     } else {
@@ -142,13 +183,45 @@ class ColorTwistBase : public Operator<Backend> {
     auto in_type = ws.template Input<Backend>(0).type();
     output_type_ = output_type_arg_ != DALI_NO_TYPE ? output_type_arg_ : in_type;
 
-    if (in_type == DALI_FLOAT16 || in_type == DALI_FLOAT || in_type == DALI_FLOAT64) {
-      half_range_ = 0.5f;
-    } else {
-      half_range_ = 128.f;
+    // the fused stages produce floats
+    half_range_ = color::twist_half_range(fused_stages_.empty() ? in_type : DALI_FLOAT);
+  }
+
+  /**
+   * @brief Composes the fused stages into a single affine transform of the input
+   *
+   * The stages don't depend on the sample - only the first one depends on the input type.
+   */
+  void ComposeFusedStages(DALIDataType in_type) {
+    using namespace color;  // NOLINT
+    pre_matrix_ = mat3::eye();
+    pre_offset_ = vec3(0);
+    for (size_t s = 0; s < fused_stages_.size(); s += kFusedStageSize) {
+      const float *p = &fused_stages_[s + 1];
+      // only the first stage reads the input, the following ones get the (float) results
+      DALIDataType stage_in_type = s == 0 ? in_type : DALI_FLOAT;
+      mat3 m;
+      vec3 o;
+      if (static_cast<int>(fused_stages_[s]) == kFusedBrightnessContrast) {
+        float center = std::isnan(p[3]) ? ContrastCenter(stage_in_type) : p[3];
+        m = mat3(p[0] * p[2]);
+        o = p[1] + p[0] * (center - p[2] * center);
+      } else {
+        float half_range = twist_half_range(stage_in_type);
+        m = twist_mat(p[0], p[1], p[2], p[3], p[4]);
+        o = (half_range - half_range * p[4]) * p[3];
+      }
+      pre_matrix_ = m * pre_matrix_;
+      pre_offset_ = m * pre_offset_ + o;
     }
   }
 
+  static float ContrastCenter(DALIDataType type) {
+    TYPE_SWITCH(type, type2id, T, COLOR_TWIST_SUPPORTED_TYPES, (
+      return brightness_contrast::HalfRange<T>();
+    ), DALI_FAIL(make_string("Unsupported input type: ", type)));  // NOLINT
+  }
+
   /**
    * @brief Creates transformation matrices based on given args
    */
@@ -161,11 +234,16 @@ class ColorTwistBase : public Operator<Backend> {
     tmatrices_.resize(size);
     toffsets_.resize(size);
     for (size_t i = 0; i < size; i++) {
-      tmatrices_[i] =
-               mat3(brightness_[i]) * mat3(contrast_[i]) *
-               Yiq2Rgb * hue_mat(hue_[i]) * sat_mat(saturation_[i]) * mat3(value_[i]) * Rgb2Yiq;
+      tmatrices_[i] = twist_mat(hue_[i], saturation_[i], value_[i], brightness_[i], contrast_[i]);
       toffsets_[i] = (half_range_ - half_range_ * contrast_[i]) * brightness_[i];
     }
+    if (!fused_stages_.empty()) {
+      ComposeFusedStages(ws.template Input<Backend>(0).type());
+      for (size_t i = 0; i < size; i++) {
+        toffsets_[i] = tmatrices_[i] * pre_offset_ + toffsets_[i];
+        tmatrices_[i] = tmatrices_[i] * pre_matrix_;
+      }
+    }
   }
 
   bool SetupImpl(std::vector<OutputDesc> &output_desc,
@@ -187,6 +265,10 @@ class ColorTwistBase : public Operator<Backend> {
   std::vector<float> hue_, saturation_, value_, brightness_, contrast_;
   std::vector<mat3> tmatrices_;
   std::vector<vec3> toffsets_;
+  /// The stages applied before the ones given by the arguments, see the `fused_stages` argument
+  std::vector<float> fused_stages_;
+  mat3 pre_matrix_ = mat3::eye();
+  vec3 pre_offset_;
   DALIDataType output_type_arg_, output_type_;
   kernels::KernelManager kernel_manager_;
 };
@@ -62,6 +62,7 @@ The same input can be provided as per-sample tensors.
     .NumOutput(1)
     .AllowSequences()
     .SupportVolumetric()
+    .BatchSplittable()
     .AddOptionalArg<int>(kWindowSizeArgName, "The diameter of the kernel.",
                          std::vector<int>{0}, true, true)
     .AddOptionalArg<float>(kSigmaArgName, "Sigma value for the Gaussian Kernel.",
@@ -76,6 +76,7 @@ Operator uses 32-bit floats as an intermediate type.
     .NumOutput(1)
     .AllowSequences()
     .SupportVolumetric()
+    .BatchSplittable()
     .AddOptionalArg<int>(laplacian::windowSizeArgName,
                          R"code(Size of derivative window used in convolutions.
 
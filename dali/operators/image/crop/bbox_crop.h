@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,9 +16,12 @@
 #define DALI_OPERATORS_IMAGE_CROP_BBOX_CROP_H_
 
 #include <memory>
+#include <random>
+#include <string>
 #include <vector>
 #include "dali/pipeline/operator/common.h"
 #include "dali/pipeline/operator/operator.h"
+#include "dali/pipeline/util/batch_rng.h"
 #include "dali/pipeline/util/operator_impl_utils.h"
 
 namespace dali {
@@ -29,11 +32,21 @@ class RandomBBoxCrop : public Operator<Backend> {
   explicit inline RandomBBoxCrop(const OpSpec &spec);
   ~RandomBBoxCrop() override;
 
+  std::string SaveState() override {
+    return rngs_.SaveState();
+  }
+
+  void RestoreState(const std::string &state) override {
+    rngs_.RestoreState(state);
+  }
+
  protected:
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override;
   void RunImpl(workspace_t<Backend> &ws) override;
 
  private:
+  // shared by the implementations for different dimensionalities
+  BatchRNG<std::mt19937> rngs_;
   std::unique_ptr<OpImplBase<Backend>> impl_;
   int impl_ndim_ = -1;
   using Operator<Backend>::spec_;
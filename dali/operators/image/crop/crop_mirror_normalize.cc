@@ -65,12 +65,15 @@ The value used for padding is determined by the ``fill_values`` argument.)code",
     std::vector<float>{1.0f}, true)
   .AddOptionalArg("scale", R"(The value by which the result is multiplied.
 
-This argument is useful when using integer outputs to improve dynamic range utilization.)",
-    1.0f)
+This argument is useful when using integer outputs to improve dynamic range utilization.
+It can be a scalar or have one value per channel - together with a per-channel ``shift``, it
+allows quantizing the output (for example, to ``INT8``) with per-channel scales and zero-points.)",
+    std::vector<float>{1.0f})
   .AddOptionalArg("shift", R"(The value added to the (scaled) result.
 
-This argument is useful when using unsigned integer outputs to improve dynamic range utilization.)",
-    0.0f)
+This argument is useful when using unsigned integer outputs to improve dynamic range utilization.
+It can be a scalar or have one value per channel.)",
+    std::vector<float>{0.0f})
   .AddParent("CropAttr")
   .AddParent("OutOfBoundsAttr");
 
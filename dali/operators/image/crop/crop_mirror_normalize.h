@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_IMAGE_CROP_CROP_MIRROR_NORMALIZE_H_
 #define DALI_OPERATORS_IMAGE_CROP_CROP_MIRROR_NORMALIZE_H_
 
+#include <algorithm>
 #include <cstring>
 #include <utility>
 #include <vector>
@@ -104,8 +105,11 @@ class CropMirrorNormalize : public Operator<Backend> {
         out_of_bounds_policy_(GetOutOfBoundsPolicy(spec)),
         mean_arg_("mean", spec),
         std_arg_("std", spec),
-        scale_(spec.GetArgument<float>("scale")),
-        shift_(spec.GetArgument<float>("shift")) {
+        mirror_arg_("mirror", spec),
+        scale_(spec.GetRepeatedArgument<float>("scale")),
+        shift_(spec.GetRepeatedArgument<float>("shift")) {
+    DALI_ENFORCE(!scale_.empty() && !shift_.empty(),
+      "``scale`` and ``shift`` must not be empty.");
     if (out_of_bounds_policy_ == OutOfBoundsPolicy::Pad) {
       fill_values_ = spec.GetRepeatedArgument<float>("fill_values");
     }
@@ -125,23 +129,29 @@ class CropMirrorNormalize : public Operator<Backend> {
   void ProcessNormArgs(int sample_idx) {
     span<const float> mean_arg(mean_arg_[sample_idx].data, mean_arg_[sample_idx].num_elements());
     span<const float> std_arg(std_arg_[sample_idx].data, std_arg_[sample_idx].num_elements());
-    auto arg_sz = std::max(mean_arg.size(), std_arg.size());
+    int64_t arg_sz = std::max<int64_t>({ mean_arg.size(), std_arg.size(),
+                                         static_cast<int64_t>(scale_.size()),
+                                         static_cast<int64_t>(shift_.size()) });
 
-    DALI_ENFORCE(
-        mean_arg.size() == std_arg.size() || mean_arg.size() == 1 || std_arg.size() == 1,
-        "``mean`` and ``std`` must either be of the same size, be scalars, or one of them can be a "
-        "vector and the other a scalar.");
+    auto valid_size = [arg_sz](int64_t sz) { return sz == arg_sz || sz == 1; };
+    DALI_ENFORCE(valid_size(mean_arg.size()) && valid_size(std_arg.size()) &&
+                 valid_size(scale_.size()) && valid_size(shift_.size()),
+        "``mean``, ``std``, ``scale`` and ``shift`` must either be of the same size or be "
+        "scalars.");
 
     mean_vec_.resize(arg_sz);
     inv_std_vec_.resize(arg_sz);
 
-    int nargs = std::max(std_arg.size(), mean_arg.size());
-    assert(mean_arg.size() == std_arg.size() || mean_arg.size() == 1 || std_arg.size() == 1);
-    for (int d = 0; d < nargs; d++) {
+    // The (per-channel) scale and shift are folded into the normalization parameters:
+    //   (in - mean) / std * scale + shift = (in - (mean - shift * std / scale)) * (scale / std)
+    for (int64_t d = 0; d < arg_sz; d++) {
       double mean_val = mean_arg[d % mean_arg.size()];
       double std_val = std_arg[d % std_arg.size()];
-      mean_vec_[d] = std::fma(-shift_, std_val / scale_, mean_val);
-      inv_std_vec_[d] = scale_ / std_val;
+      double scale = scale_[d % scale_.size()];
+      double shift = shift_[d % shift_.size()];
+      DALI_ENFORCE(scale != 0, "``scale`` must not be zero.");
+      mean_vec_[d] = std::fma(-shift, std_val / scale, mean_val);
+      inv_std_vec_[d] = scale / std_val;
     }
 
     bool should_norm =
@@ -201,7 +211,7 @@ class CropMirrorNormalize : public Operator<Backend> {
       auto crop_win_gen = crop_attr_.GetCropWindowGenerator(data_idx);
       assert(crop_win_gen);
       CropWindow crop_window = crop_win_gen(in_shape[data_idx], input_layout_);
-      bool horizontal_flip = this->spec_.template GetArgument<int>("mirror", &ws, data_idx);
+      bool horizontal_flip = mirror_arg_.Get(ws, data_idx);
       ApplySliceBoundsPolicy(out_of_bounds_policy_, in_shape[data_idx], crop_window.anchor,
                               crop_window.shape);
 
@@ -240,8 +250,9 @@ class CropMirrorNormalize : public Operator<Backend> {
 
   ArgValue<float, 1> mean_arg_;
   ArgValue<float, 1> std_arg_;
-  float scale_ = 1.0f;
-  float shift_ = 0.0f;
+  ScalarArg<int> mirror_arg_;
+  std::vector<float> scale_;
+  std::vector<float> shift_;
   bool const_norm_args_read_ = false;
 
   std::vector<float> mean_vec_, inv_std_vec_;
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -17,11 +17,13 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
 #include "dali/pipeline/operator/common.h"
+#include "dali/pipeline/operator/checkpointing.h"
 #include "dali/pipeline/operator/operator.h"
 #include "dali/util/crop_window.h"
 #include "dali/util/random_crop_generator.h"
@@ -54,6 +56,7 @@ class RandomCropAttr {
     seq.generate(seeds.begin(), seeds.end());
 
     crop_window_generators_.resize(max_batch_size);
+    generators_.resize(max_batch_size);
 
     for (int i = 0; i < max_batch_size; i++) {
       std::shared_ptr<RandomCropGenerator> random_crop_generator(
@@ -62,6 +65,7 @@ class RandomCropAttr {
       crop_window_generators_[i] = std::bind(
         &RandomCropGenerator::GenerateCropWindow, random_crop_generator,
         std::placeholders::_1);
+      generators_[i] = std::move(random_crop_generator);
     }
   }
 
@@ -69,8 +73,26 @@ class RandomCropAttr {
     return crop_window_generators_[data_idx];
   }
 
+  /**
+   * @brief Returns the state of the random generators, see OperatorBase::SaveState
+   */
+  std::string SaveState() const {
+    std::string state;
+    for (auto &generator : generators_)
+      AppendOpState(state, generator->GetRNG());
+    return state;
+  }
+
+  void RestoreState(const std::string &state) {
+    size_t offset = 0;
+    for (auto &generator : generators_)
+      ReadOpState(generator->GetRNG(), state, offset);
+    CheckOpStateEnd(state, offset);
+  }
+
  private:
   std::vector<CropWindowGenerator> crop_window_generators_;
+  std::vector<std::shared_ptr<RandomCropGenerator>> generators_;
 };
 
 }  // namespace dali
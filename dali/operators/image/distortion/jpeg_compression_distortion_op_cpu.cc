@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,7 +13,11 @@
 // limitations under the License.
 
 #include <opencv2/opencv.hpp>
+#include <string>
 #include <vector>
+#include "dali/core/error_handling.h"
+#include "dali/core/math_util.h"
+#include "dali/image/jpeg_mem.h"
 #include "dali/operators/image/distortion/jpeg_compression_distortion_op.h"
 
 namespace dali {
@@ -53,11 +57,44 @@ class JpegCompressionDistortionCPU : public JpegCompressionDistortion<CPUBackend
 
  private:
   struct ThreadCtx {
+#ifdef DALI_USE_JPEG_TURBO
+    std::string encoded;
+#else
     std::vector<uint8_t> encoded;
+#endif
   };
   std::vector<ThreadCtx> thread_ctx_;
 };
 
+#ifdef DALI_USE_JPEG_TURBO
+
+/**
+ * @brief Encodes and decodes the RGB frame in memory, with libjpeg-turbo
+ *
+ * The frame goes through the codec directly in RGB and is decoded straight to the output,
+ * so no intermediate images or color conversions are needed.
+ * The encoded buffer is kept in the thread context, so its memory is reused.
+ */
+template <typename ThreadCtx>
+static void RunJpegDistortionCPU(ThreadCtx &ctx, const uint8_t *input, uint8_t *output,
+                                 size_t width, size_t height, int quality) {
+  jpeg::CompressFlags compress_flags;
+  compress_flags.format = jpeg::FORMAT_RGB;
+  compress_flags.quality = clamp(quality, 1, 100);
+  DALI_ENFORCE(jpeg::Compress(input, width, height, compress_flags, &ctx.encoded),
+               make_string("Failed to encode a ", width, "x", height, " image."));
+
+  jpeg::UncompressFlags uncompress_flags;
+  uncompress_flags.components = 3;
+  uncompress_flags.color_space = DALI_RGB;
+  auto *decoded = jpeg::Uncompress(ctx.encoded.data(), ctx.encoded.size(), uncompress_flags,
+                                   nullptr, [output](int, int, int) { return output; });
+  DALI_ENFORCE(decoded == output,
+               make_string("Failed to decode a ", width, "x", height, " image."));
+}
+
+#else  // DALI_USE_JPEG_TURBO
+
 template <typename ThreadCtx>
 static void RunJpegDistortionCPU(ThreadCtx &ctx, const uint8_t *input, uint8_t *output,
                                  size_t width, size_t height, int quality) {
@@ -70,6 +107,8 @@ static void RunJpegDistortionCPU(ThreadCtx &ctx, const uint8_t *input, uint8_t *
   cv::cvtColor(out_mat, out_mat, cv::COLOR_BGR2RGB);
 }
 
+#endif  // DALI_USE_JPEG_TURBO
+
 void JpegCompressionDistortionCPU::RunImpl(workspace_t<CPUBackend> &ws) {
   const auto &input = ws.Input<CPUBackend>(0);
   auto &output = ws.Output<CPUBackend>(0);
@@ -0,0 +1,183 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <nvjpeg.h>
+#include <iostream>
+#include <vector>
+#include "dali/core/cuda_error.h"
+#include "dali/core/device_guard.h"
+#include "dali/core/math_util.h"
+#include "dali/kernels/common/copy.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/operators/decoder/nvjpeg/nvjpeg_helper.h"
+#include "dali/pipeline/data/views.h"
+#include "dali/pipeline/operator/arg_helper.h"
+#include "dali/pipeline/operator/operator.h"
+
+namespace dali {
+
+DALI_SCHEMA(encoders__Jpeg)
+    .DocStr(R"code(Encodes RGB images as JPEG, with nvJPEG.
+
+The output is a batch of 1D ``uint8`` tensors, each one holding the whole JPEG bitstream of
+the respective image - the same as the content of a ``.jpg`` file.
+It can be fed back to :meth:`nvidia.dali.fn.decoders.image` or written to disk, so the results
+of the preprocessing can be stored and reused.
+
+The images of the batch are encoded concurrently. The sizes of the bitstreams are known only
+when the encoding is complete, so the operator waits for its CUDA stream once per batch.
+)code")
+    .NumInput(1)
+    .InputLayout(0, "HWC")
+    .NumOutput(1)
+    .AddOptionalArg(
+        "quality",
+        R"code(JPEG compression quality from 1 (lowest quality) to 100 (highest quality).
+
+Any values outside the range 1-100 will be clamped.)code",
+        95, true)
+    .AddOptionalArg("chroma_subsampling",
+                    R"code(If True, the chroma is subsampled 2x in both dimensions (4:2:0).
+
+Otherwise, the chroma is stored at the full resolution (4:4:4).)code",
+                    true);
+
+/**
+ * @brief Encodes the RGB images as JPEG with nvJPEG
+ *
+ * Each sample has its own encoder state and parameters, so that all the samples can be
+ * scheduled before waiting for the stream, which is needed to learn the sizes of the outputs.
+ */
+class JpegEncoderGPU : public Operator<GPUBackend> {
+ public:
+  explicit JpegEncoderGPU(const OpSpec &spec)
+      : Operator<GPUBackend>(spec),
+        quality_arg_("quality", spec),
+        chroma_subsampling_(spec.GetArgument<bool>("chroma_subsampling")),
+        device_id_(spec.GetArgument<int>("device_id")) {
+    handle_ = GetSharedNvjpegHandle(device_id_, NVJPEG_BACKEND_DEFAULT, 0, 0);
+  }
+
+  ~JpegEncoderGPU() override {
+    try {
+      DeviceGuard g(device_id_);
+      for (auto &encoder : encoders_) {
+        CUDA_CALL(nvjpegEncoderStateDestroy(encoder.state));
+        CUDA_CALL(nvjpegEncoderParamsDestroy(encoder.params));
+      }
+      handle_.reset();
+    } catch (const std::exception &e) {
+      // If destroying nvJPEG resources failed we are leaking something so terminate
+      std::cerr << "Fatal error: exception in ~JpegEncoderGPU():\n" << e.what() << std::endl;
+      std::terminate();
+    }
+  }
+
+  bool CanInferOutputs() const override {
+    return false;
+  }
+
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const DeviceWorkspace &ws) override {
+    const auto &input = ws.Input<GPUBackend>(0);
+    DALI_ENFORCE(input.type() == DALI_UINT8,
+                 make_string("Unsupported input type: ", input.type(), "; expected uint8."));
+    const auto &in_sh = input.shape();
+    DALI_ENFORCE(in_sh.sample_dim() == 3,
+                 make_string("Expected HWC images, got ", in_sh.sample_dim(), "D input."));
+    for (int s = 0; s < in_sh.num_samples(); s++) {
+      auto sh = in_sh.tensor_shape_span(s);
+      DALI_ENFORCE(sh[2] == 3,
+                   make_string("Invalid number of channels. Expected a channel-last layout, with 3 "
+                               "channels (RGB), got shape: ", in_sh[s]));
+      DALI_ENFORCE(sh[0] > 0 && sh[1] > 0,
+                   make_string("Cannot encode an empty image; got shape: ", in_sh[s]));
+    }
+    quality_arg_.Acquire(spec_, ws, in_sh.num_samples(), TensorShape<0>{});
+    return false;
+  }
+
+  void RunImpl(DeviceWorkspace &ws) override {
+    const auto &input = ws.Input<GPUBackend>(0);
+    auto &output = ws.Output<GPUBackend>(0);
+    auto stream = ws.stream();
+    int nsamples = input.num_samples();
+    auto in_view = view<const uint8_t, 3>(input);
+    ReserveEncoders(nsamples, stream);
+
+    auto subsampling = chroma_subsampling_ ? NVJPEG_CSS_420 : NVJPEG_CSS_444;
+    for (int i = 0; i < nsamples; i++) {
+      auto &encoder = encoders_[i];
+      int height = in_view.shape[i][0];
+      int width = in_view.shape[i][1];
+      int quality = clamp(quality_arg_[i].data[0], 1, 100);
+      CUDA_CALL(nvjpegEncoderParamsSetQuality(encoder.params, quality, stream));
+      CUDA_CALL(nvjpegEncoderParamsSetSamplingFactors(encoder.params, subsampling, stream));
+      nvjpegImage_t image = {};
+      image.channel[0] = const_cast<uint8_t *>(in_view.data[i]);
+      image.pitch[0] = width * 3;
+      CUDA_CALL(nvjpegEncodeImage(handle_.get(), encoder.state, encoder.params, &image,
+                                  NVJPEG_INPUT_RGBI, width, height, stream));
+    }
+    CUDA_CALL(cudaStreamSynchronize(stream));
+
+    TensorListShape<1> out_shape(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+      size_t length = 0;
+      CUDA_CALL(nvjpegEncodeRetrieveBitstream(handle_.get(), encoders_[i].state, nullptr,
+                                              &length, stream));
+      out_shape.set_tensor_shape(i, TensorShape<1>{static_cast<int64_t>(length)});
+    }
+    output.Resize(out_shape, DALI_UINT8);
+
+    // nvJPEG returns the bitstreams in the host memory
+    kernels::DynamicScratchpad scratchpad({}, stream);
+    auto out_cpu = make_tensor_list_cpu(
+        scratchpad.AllocatePinned<uint8_t>(out_shape.num_elements()), out_shape);
+    for (int i = 0; i < nsamples; i++) {
+      size_t length = out_shape[i][0];
+      CUDA_CALL(nvjpegEncodeRetrieveBitstream(handle_.get(), encoders_[i].state,
+                                              out_cpu.tensor_data(i), &length, stream));
+    }
+    kernels::copy(view<uint8_t, 1>(output), out_cpu, stream);
+  }
+
+ private:
+  struct Encoder {
+    nvjpegEncoderState_t state = nullptr;
+    nvjpegEncoderParams_t params = nullptr;
+  };
+
+  void ReserveEncoders(int nsamples, cudaStream_t stream) {
+    while (static_cast<int>(encoders_.size()) < nsamples) {
+      Encoder encoder;
+      CUDA_CALL(nvjpegEncoderStateCreate(handle_.get(), &encoder.state, stream));
+      auto params_status = nvjpegEncoderParamsCreate(handle_.get(), &encoder.params, stream);
+      if (params_status != NVJPEG_STATUS_SUCCESS) {
+        CUDA_DTOR_CALL(nvjpegEncoderStateDestroy(encoder.state));
+        CUDA_CALL(params_status);
+      }
+      encoders_.push_back(encoder);
+    }
+  }
+
+  ArgValue<int> quality_arg_;
+  bool chroma_subsampling_ = true;
+  int device_id_ = 0;
+  NvjpegHandle handle_;
+  std::vector<Encoder> encoders_;
+};
+
+DALI_REGISTER_OPERATOR(encoders__Jpeg, JpegEncoderGPU, GPU);
+
+}  // namespace dali
@@ -35,7 +35,7 @@ void MultiPasteGPU::InitSamples(const TensorListShape<> &out_shape) {
 
     sample.inputs.resize(n);
 
-    sample.channels = 3;
+    sample.channels = out_shape[i][2];
 
     to_vec(sample.out_size, out_shape[i]);
     for (int j = 0; j < n; j++) {
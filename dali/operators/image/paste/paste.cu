@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -140,14 +140,14 @@ void Paste<GPUBackend>::SetupSampleParams(DeviceWorkspace &ws) {
     int W = input_shape[1];
     C_ = input_shape[2];
 
-    float ratio = spec_.GetArgument<float>("ratio", &ws, i);
+    float ratio = ratio_arg_.Get(ws, i);
     DALI_ENFORCE(ratio >= 1.,
       "ratio of less than 1 is not supported");
 
     int new_H = static_cast<int>(ratio * H);
     int new_W = static_cast<int>(ratio * W);
 
-    int min_canvas_size_ = spec_.GetArgument<float>("min_canvas_size", &ws, i);
+    int min_canvas_size_ = min_canvas_size_arg_.Get(ws, i);
     DALI_ENFORCE(min_canvas_size_ >= 0.,
       "min_canvas_size_ of less than 0 is not supported");
 
@@ -156,8 +156,8 @@ void Paste<GPUBackend>::SetupSampleParams(DeviceWorkspace &ws) {
 
     output_shape[i] = {new_H, new_W, C_};
 
-    float paste_x_ = spec_.GetArgument<float>("paste_x", &ws, i);
-    float paste_y_ = spec_.GetArgument<float>("paste_y", &ws, i);
+    float paste_x_ = paste_x_arg_.Get(ws, i);
+    float paste_y_ = paste_y_arg_.Get(ws, i);
     DALI_ENFORCE(paste_x_ >= 0,
       "paste_x of less than 0 is not supported");
     DALI_ENFORCE(paste_x_ <= 1,
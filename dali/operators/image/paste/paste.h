@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -21,6 +21,7 @@
 #include <random>
 
 #include "dali/core/common.h"
+#include "dali/pipeline/operator/arg_helper.h"
 #include "dali/pipeline/operator/common.h"
 #include "dali/core/error_handling.h"
 #include "dali/pipeline/operator/operator.h"
@@ -34,7 +35,9 @@ class Paste : public Operator<Backend> {
   static const int NUM_INDICES = 6;
 
   explicit Paste(const OpSpec &spec)
-      : Operator<Backend>(spec), C_(spec.GetArgument<int>("n_channels")) {
+      : Operator<Backend>(spec), C_(spec.GetArgument<int>("n_channels")),
+        ratio_arg_("ratio", spec), min_canvas_size_arg_("min_canvas_size", spec),
+        paste_x_arg_("paste_x", spec), paste_y_arg_("paste_y", spec) {
     // Kind of arbitrary, we need to set some limit here
     // because we use static shared memory for storing
     // fill value array
@@ -73,6 +76,7 @@ class Paste : public Operator<Backend> {
 
   // Op parameters
   int C_;
+  ScalarArg<float> ratio_arg_, min_canvas_size_arg_, paste_x_arg_, paste_y_arg_;
   Tensor<Backend> fill_value_;
 
   Tensor<CPUBackend> input_ptrs_, output_ptrs_, in_out_dims_paste_yx_;
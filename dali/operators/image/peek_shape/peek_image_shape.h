@@ -82,9 +82,16 @@ class PeekImageShape : public Operator<CPUBackend> {
     for (size_t sample_id = 0; sample_id < batch_size; ++sample_id) {
       thread_pool.AddWork([sample_id, &input, &output, this] (int tid) {
         const auto& image = input[sample_id];
-        auto img =
-            ImageFactory::CreateImage(image.data<uint8>(), image.shape().num_elements(), {});
-        auto shape = img->PeekShape();
+        int64_t size = image.shape().num_elements();
+        // reuse the header info parsed by the reader, if available
+        const auto &image_info = input.GetMeta(sample_id).GetImageInfo();
+        TensorShape<3> shape;
+        if (image_info.IsValidFor(size)) {
+          shape = image_info.shape;
+        } else {
+          auto img = ImageFactory::CreateImage(image.data<uint8>(), size, {});
+          shape = img->PeekShape();
+        }
         TYPE_SWITCH(output_type_, type2id, type,
                 (int32_t, uint32_t, int64_t, uint64_t, float, double),
           (WriteShape(view<type, 1>(output[sample_id]), shape);),
@@ -40,8 +40,12 @@ transform and it is inverted before applying the formula above.
 
 It is equivalent to OpenCV's ``warpAffine`` operation with the ``inverse_map`` argument being
 analog to the ``WARP_INVERSE_MAP`` flag.
+
+In the GPU operator, the matrix can be also provided as a GPU data node, in which case it's
+used without copying it to the host.
 )code",
       vector<float>(), true)
+  .AllowGPUArgumentInput("matrix")
   .AddOptionalArg<bool>("inverse_map", "Set to ``False`` if the given transform is a "
                         "destination to source mapping, ``True`` otherwise.", true, false)
   .AddParent("WarpAttr");
@@ -57,7 +57,11 @@ class WarpAffineParamProvider
         UseInputAsParams(ws_->template Input<CPUBackend>(1), invert);
       }
     } else if (spec_->HasTensorArgument("matrix")) {
-      UseInputAsParams(ws_->ArgumentInput("matrix"), invert);
+      // the GPU argument input is transformed on the device, without a copy to the host
+      if (ws_->ArgumentInputIsGPU("matrix"))
+        UseInputAsParams(ws_->GPUArgumentInput("matrix"), invert);
+      else
+        UseInputAsParams(ws_->ArgumentInput("matrix"), invert);
     } else {
       std::vector<float> matrix = spec_->template GetArgument<std::vector<float>>("matrix");
       DALI_ENFORCE(!matrix.empty(),
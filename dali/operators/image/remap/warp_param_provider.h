@@ -16,6 +16,7 @@
 #define DALI_OPERATORS_IMAGE_REMAP_WARP_PARAM_PROVIDER_H_
 
 #include <cassert>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -25,7 +26,7 @@
 #include "dali/core/tensor_view.h"
 #include "dali/kernels/common/copy.h"
 #include "dali/kernels/imgproc/sampler.h"
-#include "dali/kernels/scratch.h"
+#include "dali/kernels/dynamic_scratchpad.h"
 #include "dali/pipeline/data/views.h"
 #include "dali/pipeline/operator/operator.h"
 
@@ -207,6 +208,10 @@ class WarpParamProvider : public InterpTypeProvider, public BorderTypeProvider<B
     return ws_ && ws_->has_stream() ? ws_->stream() : 0;
   }
 
+  inline AccessOrder GetOrder() const {
+    return ws_ && ws_->has_stream() ? AccessOrder(ws_->stream()) : AccessOrder::host();
+  }
+
   static inline int NumSamples(const Workspace &ws) {
     return ws.template Input<Backend>(0).shape().num_samples();
   }
@@ -214,6 +219,8 @@ class WarpParamProvider : public InterpTypeProvider, public BorderTypeProvider<B
   virtual void ResetParams() {
     params_gpu_ = {};
     params_cpu_ = {};
+    // the memory from the previous iteration is returned in the order of its stream
+    param_mem_.reset();
   }
 
   virtual void SetParams() {
@@ -332,9 +339,10 @@ class WarpParamProvider : public InterpTypeProvider, public BorderTypeProvider<B
   /** @brief Allocates count MappingParams objects in memory specified by alloc  */
   template <typename MemoryKind>
   MappingParams *AllocParams(int count) {
-    param_mem_.Reserve<MemoryKind>(count * sizeof(MappingParams));
-    auto scratch = param_mem_.GetScratchpad();
-    auto tmp = scratch.template AllocTensor<MemoryKind, MappingParams, 1>(count);
+    if (!param_mem_)
+      param_mem_ = std::make_unique<kernels::DynamicScratchpad>(kernels::scratch_sizes_t{},
+                                                                 GetOrder());
+    auto tmp = param_mem_->template AllocTensor<MemoryKind, MappingParams, 1>(count);
     SelectParamView<MemoryKind>() = tmp;
     return tmp.data;
   }
@@ -349,7 +357,9 @@ class WarpParamProvider : public InterpTypeProvider, public BorderTypeProvider<B
   std::vector<SpatialShape> out_sizes_;
   TensorView<StorageGPU, const MappingParams, 1> params_gpu_;
   TensorView<StorageCPU, const MappingParams, 1> params_cpu_;
-  kernels::ScratchpadAllocator param_mem_;
+  /// The parameters live until the next ResetParams; the device memory comes from the scratch
+  /// arena of the stage, like the scratch of the kernels, instead of a per-operator reservation
+  std::unique_ptr<kernels::DynamicScratchpad> param_mem_;
 };
 
 }  // namespace dali
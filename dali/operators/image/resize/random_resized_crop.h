@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_IMAGE_RESIZE_RANDOM_RESIZED_CROP_H_
 #define DALI_OPERATORS_IMAGE_RESIZE_RANDOM_RESIZED_CROP_H_
 
+#include <string>
 #include <vector>
 #include <random>
 #include <memory>
@@ -49,6 +50,14 @@ class RandomResizedCrop : public Operator<Backend>
 
   bool CanInferOutputs() const override { return true; }
 
+  std::string SaveState() override {
+    return crop_attr_.SaveState();
+  }
+
+  void RestoreState(const std::string &state) override {
+    crop_attr_.RestoreState(state);
+  }
+
  protected:
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override {
     auto curr_batch_size = ws.GetInputBatchSize(0);
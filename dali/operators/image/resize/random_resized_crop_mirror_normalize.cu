@@ -0,0 +1,154 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+#include "dali/operators/image/resize/random_resized_crop_mirror_normalize.h"
+#include "dali/core/static_switch.h"
+#include "dali/pipeline/data/views.h"
+
+#define RRCMN_IN_TYPES (uint8_t, float)
+#define RRCMN_OUT_TYPES (float, float16)
+
+namespace dali {
+
+DALI_SCHEMA(RandomResizedCropMirrorNormalize)
+  .DocStr(R"code(Performs a crop with a randomly selected area and aspect ratio, resizes it to
+the specified size, optionally mirrors it horizontally and normalizes it.
+
+The result is equivalent to :meth:`nvidia.dali.fn.random_resized_crop` followed by
+:meth:`nvidia.dali.fn.crop_mirror_normalize` (without cropping), but the output is calculated
+in one pass, directly from the input, without the resized intermediate image. The intermediate
+values are not rounded to the input type.
+
+The resampling uses a triangular filter - bilinear interpolation when upscaling and
+an antialiasing filter when downscaling, as the default (linear) filtering of
+:meth:`nvidia.dali.fn.random_resized_crop`.
+
+Expects a three-dimensional input in height, width, channels (HWC) layout, with up to 4
+channels.)code")
+  .NumInput(1)
+  .NumOutput(1)
+  .AddArg("size",
+      R"code(Size of the resized image.)code",
+      DALI_INT_VEC)
+  .AddOptionalArg("dtype",
+       R"code(Output data type.
+
+Supported types: ``FLOAT``, ``FLOAT16``.)code", DALI_FLOAT)
+  .AddOptionalArg("output_layout",
+    R"code(Tensor data layout for the output - ``"CHW"`` or ``"HWC"``.)code", TensorLayout("CHW"))
+  .AddOptionalArg("mirror",
+    R"code(If nonzero, the image will be flipped (mirrored) horizontally.)code",
+    0, true)
+  .AddOptionalArg("mean",
+    R"code(Mean pixel values for image normalization.)code",
+    std::vector<float>{0.0f}, true)
+  .AddOptionalArg("std",
+    R"code(Standard deviation values for image normalization.)code",
+    std::vector<float>{1.0f}, true)
+  .AddParent("RandomCropAttr")
+  .InputLayout(0, "HWC");
+
+RandomResizedCropMirrorNormalize::RandomResizedCropMirrorNormalize(const OpSpec &spec)
+    : Operator<GPUBackend>(spec)
+    , crop_attr_(spec)
+    , output_type_(spec.GetArgument<DALIDataType>("dtype"))
+    , output_layout_(spec.GetArgument<TensorLayout>("output_layout"))
+    , mean_arg_("mean", spec)
+    , std_arg_("std", spec) {
+  GetSingleOrRepeatedArg(spec, size_, "size", 2);
+  DALI_ENFORCE(size_[0] > 0 && size_[1] > 0,
+    make_string("The output size must be positive, got: ", size_[0], "x", size_[1]));
+  DALI_ENFORCE(output_type_ == DALI_FLOAT || output_type_ == DALI_FLOAT16,
+    make_string("Unsupported output type: ", output_type_));
+  DALI_ENFORCE(output_layout_ == "CHW" || output_layout_ == "HWC",
+    make_string("The output layout must be \"CHW\" or \"HWC\", got: \"", output_layout_, "\""));
+}
+
+void RandomResizedCropMirrorNormalize::ProcessNormArgs(
+    int sample_idx, int channels, kernels::ResizeCropMirrorNormalizeArgs &args) {
+  auto mean = mean_arg_[sample_idx];
+  auto stddev = std_arg_[sample_idx];
+  int64_t mean_sz = mean.num_elements(), std_sz = stddev.num_elements();
+  DALI_ENFORCE((mean_sz == 1 || mean_sz == channels) && (std_sz == 1 || std_sz == channels),
+    make_string("``mean`` and ``std`` must be scalars or have one value per channel. Got ",
+                mean_sz, " and ", std_sz, " values for an image with ", channels, " channels."));
+  for (int c = 0; c < channels; c++) {
+    float std_val = stddev.data[std_sz == 1 ? 0 : c];
+    DALI_ENFORCE(std_val != 0, "``std`` must not be zero");
+    args.mean[c] = mean.data[mean_sz == 1 ? 0 : c];
+    args.inv_stddev[c] = 1.0f / std_val;
+  }
+}
+
+bool RandomResizedCropMirrorNormalize::SetupImpl(std::vector<OutputDesc> &output_desc,
+                                                 const DeviceWorkspace &ws) {
+  const auto &input = ws.Input<GPUBackend>(0);
+  const auto &in_shape = input.shape();
+  int N = in_shape.num_samples();
+  DALI_ENFORCE(in_shape.sample_dim() == 3, make_string(
+    "Expected a three-dimensional input (HWC), got ", in_shape.sample_dim(), " dimensions"));
+
+  mean_arg_.Acquire(spec_, ws, N);
+  std_arg_.Acquire(spec_, ws, N);
+
+  args_.resize(N);
+  for (int i = 0; i < N; i++) {
+    auto sample_shape = in_shape.tensor_shape_span(i);
+    int H = sample_shape[0], W = sample_shape[1], C = sample_shape[2];
+    auto crop = crop_attr_.GetCropWindowGenerator(i)({H, W}, "HW");
+    auto &a = args_[i];
+    a.roi_lo = { static_cast<float>(crop.anchor[1]), static_cast<float>(crop.anchor[0]) };
+    a.roi_hi = a.roi_lo + vec2(crop.shape[1], crop.shape[0]);
+    a.out_size = { size_[1], size_[0] };
+    a.mirror = spec_.GetArgument<int>("mirror", &ws, i);
+    ProcessNormArgs(i, C, a);
+  }
+
+  bool channel_first = output_layout_ == "CHW";
+  kernels::KernelContext ctx;
+  ctx.gpu.stream = ws.stream();
+  output_desc.resize(1);
+  output_desc[0].type = output_type_;
+  TYPE_SWITCH(input.type(), type2id, In, RRCMN_IN_TYPES, (
+    TYPE_SWITCH(output_type_, type2id, Out, RRCMN_OUT_TYPES, (
+      using Kernel = kernels::ResizeCropMirrorNormalizeGPU<Out, In>;
+      kmgr_.Resize<Kernel>(1);
+      auto &req = kmgr_.Setup<Kernel>(0, ctx, view<const In, 3>(input), make_cspan(args_),
+                                      channel_first);
+      output_desc[0].shape = req.output_shapes[0];
+    ), DALI_FAIL(make_string("Unsupported output type: ", output_type_)));  // NOLINT
+  ), DALI_FAIL(make_string("Unsupported input type: ", input.type())));  // NOLINT
+  return true;
+}
+
+void RandomResizedCropMirrorNormalize::RunImpl(DeviceWorkspace &ws) {
+  const auto &input = ws.Input<GPUBackend>(0);
+  auto &output = ws.Output<GPUBackend>(0);
+  output.SetLayout(output_layout_);
+  bool channel_first = output_layout_ == "CHW";
+  kernels::KernelContext ctx;
+  ctx.gpu.stream = ws.stream();
+  TYPE_SWITCH(input.type(), type2id, In, RRCMN_IN_TYPES, (
+    TYPE_SWITCH(output_type_, type2id, Out, RRCMN_OUT_TYPES, (
+      using Kernel = kernels::ResizeCropMirrorNormalizeGPU<Out, In>;
+      kmgr_.Run<Kernel>(0, ctx, view<Out, 3>(output), view<const In, 3>(input),
+                        make_cspan(args_), channel_first);
+    ), DALI_FAIL(make_string("Unsupported output type: ", output_type_)));  // NOLINT
+  ), DALI_FAIL(make_string("Unsupported input type: ", input.type())));  // NOLINT
+}
+
+DALI_REGISTER_OPERATOR(RandomResizedCropMirrorNormalize, RandomResizedCropMirrorNormalize, GPU);
+
+}  // namespace dali
@@ -0,0 +1,71 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_IMAGE_RESIZE_RANDOM_RESIZED_CROP_MIRROR_NORMALIZE_H_
+#define DALI_OPERATORS_IMAGE_RESIZE_RANDOM_RESIZED_CROP_MIRROR_NORMALIZE_H_
+
+#include <string>
+#include <vector>
+#include "dali/kernels/imgproc/resize_crop_mirror_normalize_gpu.cuh"
+#include "dali/kernels/kernel_manager.h"
+#include "dali/operators/image/crop/random_crop_attr.h"
+#include "dali/pipeline/operator/arg_helper.h"
+#include "dali/pipeline/operator/common.h"
+#include "dali/pipeline/operator/operator.h"
+
+namespace dali {
+
+/**
+ * @brief RandomResizedCrop followed by CropMirrorNormalize, in one GPU kernel
+ *
+ * The output is calculated directly from the input image, without the resized intermediate.
+ */
+class RandomResizedCropMirrorNormalize : public Operator<GPUBackend> {
+ public:
+  explicit RandomResizedCropMirrorNormalize(const OpSpec &spec);
+
+  DISABLE_COPY_MOVE_ASSIGN(RandomResizedCropMirrorNormalize);
+
+  std::string SaveState() override {
+    return crop_attr_.SaveState();
+  }
+
+  void RestoreState(const std::string &state) override {
+    crop_attr_.RestoreState(state);
+  }
+
+ protected:
+  bool CanInferOutputs() const override { return true; }
+
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const DeviceWorkspace &ws) override;
+
+  void RunImpl(DeviceWorkspace &ws) override;
+
+ private:
+  void ProcessNormArgs(int sample_idx, int channels, kernels::ResizeCropMirrorNormalizeArgs &args);
+
+  RandomCropAttr crop_attr_;
+  std::vector<int> size_;
+  DALIDataType output_type_ = DALI_NO_TYPE;
+  TensorLayout output_layout_;
+  ArgValue<float, 1> mean_arg_;
+  ArgValue<float, 1> std_arg_;
+
+  std::vector<kernels::ResizeCropMirrorNormalizeArgs> args_;
+  kernels::KernelManager kmgr_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_IMAGE_RESIZE_RANDOM_RESIZED_CROP_MIRROR_NORMALIZE_H_
@@ -40,7 +40,31 @@ Must be same as input type or ``float``. If not set, input type is used.)code",
       0)
   .AddOptionalArg("minibatch_size", R"code(Maximum number of images that are processed in
 a kernel call.)code",
-      32);
+      32)
+  .AddOptionalArg("half_precision_intermediate",
+      R"code(Stores the intermediate results of the separable volumetric resampling
+in half precision.
+
+The volumetric resampling is done in three passes, two of which read and write intermediate
+buffers. Storing them in half precision halves the memory traffic of these passes, which
+dominates the run time for large volumes, at the cost of a reduced precision of the result.
+
+.. note::
+  This argument is ignored for the CPU variant and for 2D resampling.)code",
+      false)
+  .AddOptionalArg("half_precision_compute",
+      R"code(Computes the 2D resampling filters as half-precision matrix multiplications
+on tensor cores, with the products accumulated in single precision.
+
+The input pixels and the filter coefficients are rounded to half precision, which reduces
+the precision of the result. The speedup grows with the filter support, e.g. in large
+downscaling with the triangular, cubic or Lanczos filters.
+
+.. note::
+  This argument is ignored for the CPU variant, for volumetric resampling, for input types
+  other than ``uint8``, for the nearest neighbor and linear filters and on GPUs older
+  than Volta.)code",
+      false);
 
 
 using namespace kernels;  // NOLINT
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -22,13 +22,25 @@ DALI_SCHEMA(Resize)
   .DocStr(R"code(Resize images.)code")
   .NumInput(1)
   .NumOutput(1)
+  .CacheableSetup()
   .AdditionalOutputsFn([](const OpSpec& spec) {
-    return static_cast<int>(spec.GetArgument<bool>("save_attrs"));
+    return spec.GetArgument<int>("pyramid_levels") - 1 +
+           static_cast<int>(spec.GetArgument<bool>("save_attrs"));
   })
   .InputLayout(0, {"HWC",  "FHWC",  "CHW",  "FCHW",  "CFHW" ,
                    "DHWC", "FDHWC", "CDHW", "FCDHW", "CFDHW"  })
   .AddOptionalArg("save_attrs",
       R"code(Save reshape attributes for testing.)code", false)
+  .AddOptionalArg("pyramid_levels",
+      R"code(Number of resolutions to produce.
+
+The first output is the input resized as specified by the other arguments. Each of the following
+outputs is the previous one scaled by ``pyramid_scale``, with the same filters. The levels are
+computed from each other, so the full resolution input is read only once.)code", 1)
+  .AddOptionalArg("pyramid_scale",
+      R"code(The scale of each pyramid level with respect to the previous one.
+
+Only used when ``pyramid_levels`` is greater than 1.)code", 0.5f)
   .AddOptionalArg<DALIImageType>("image_type", "Image type", nullptr)
   .DeprecateArg("image_type")  // deprecated since 0.25dev
   .SupportVolumetric()
@@ -41,6 +53,14 @@ Resize<Backend>::Resize(const OpSpec &spec)
     : Operator<Backend>(spec)
     , ResizeBase<Backend>(spec) {
   save_attrs_ = this->spec_.HasArgument("save_attrs");
+  int num_levels = spec.GetArgument<int>("pyramid_levels");
+  DALI_ENFORCE(num_levels >= 1, make_string("`pyramid_levels` must be positive, got ",
+               num_levels, "."));
+  pyramid_scale_ = spec.GetArgument<float>("pyramid_scale");
+  DALI_ENFORCE(pyramid_scale_ > 0, make_string("`pyramid_scale` must be positive, got ",
+               pyramid_scale_, "."));
+  for (int l = 1; l < num_levels; l++)
+    extra_levels_.push_back(std::make_unique<ResizeBase<Backend>>(spec));
   resample_params_.resize(num_threads_);
   InitializeBackend();
 }
@@ -48,6 +68,8 @@ Resize<Backend>::Resize(const OpSpec &spec)
 template <>
 void Resize<CPUBackend>::InitializeBackend() {
   InitializeCPU(num_threads_);
+  for (auto &level : extra_levels_)
+    level->InitializeCPU(num_threads_);
 }
 
 template <>
@@ -57,10 +79,15 @@ void Resize<CPUBackend>::RunImpl(HostWorkspace &ws) {
 
   RunResize(ws, output, input);
   output.SetLayout(input.GetLayout());
+  for (int l = 1; l < NumLevels(); l++) {
+    auto &level = ws.Output<CPUBackend>(l);
+    extra_levels_[l - 1]->RunResize(ws, level, ws.Output<CPUBackend>(l - 1));
+    level.SetLayout(input.GetLayout());
+  }
 
   if (save_attrs_) {
     const auto &input_shape = input.shape();
-    auto &attr_out = ws.Output<CPUBackend>(1);
+    auto &attr_out = ws.Output<CPUBackend>(NumLevels());
     const auto &attr_shape = attr_out.shape();
     assert(attr_shape.num_samples() == input_shape.num_samples() &&
           attr_shape.sample_dim() == 1 &&
@@ -78,6 +105,8 @@ template <>
 void Resize<GPUBackend>::InitializeBackend() {
   InitializeGPU(spec_.GetArgument<int>("minibatch_size"),
                 spec_.GetArgument<int64_t>("temp_buffer_hint"));
+  for (auto &level : extra_levels_)
+    level->InitializeGPU(spec_.GetArgument<int>("minibatch_size"));
 }
 
 template<>
@@ -87,9 +116,14 @@ void Resize<GPUBackend>::RunImpl(DeviceWorkspace &ws) {
 
   RunResize(ws, output, input);
   output.SetLayout(input.GetLayout());
+  for (int l = 1; l < NumLevels(); l++) {
+    auto &level = ws.Output<GPUBackend>(l);
+    extra_levels_[l - 1]->RunResize(ws, level, ws.Output<GPUBackend>(l - 1));
+    level.SetLayout(input.GetLayout());
+  }
 
   if (save_attrs_) {
-    auto &attr_out = ws.Output<GPUBackend>(1);
+    auto &attr_out = ws.Output<GPUBackend>(NumLevels());
     const auto &attr_shape = attr_out.shape();
     assert(attr_shape.num_samples() == input.shape().num_samples() &&
            attr_shape.sample_dim() == 1 &&
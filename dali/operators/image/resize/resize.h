@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,9 @@
 #ifndef DALI_OPERATORS_IMAGE_RESIZE_RESIZE_H_
 #define DALI_OPERATORS_IMAGE_RESIZE_RESIZE_H_
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
 #include <random>
 #include <utility>
 #include <vector>
@@ -79,10 +82,41 @@ class Resize : public Operator<Backend>
                                          make_cspan(resize_attr_.params_));
   }
 
+  /**
+   * @brief Calculates the parameters of a pyramid level from the shape of the previous one
+   *
+   * Each spatial extent is scaled by `pyramid_scale_`; the filters are the same as in the first
+   * level, but there's no ROI - the whole previous level is resampled.
+   */
+  void GetLevelParams(std::vector<kernels::ResamplingParams> &level_params,
+                      const TensorListShape<> &prev_shape) const {
+    int N = prev_shape.num_samples();
+    int D = NumSpatialDims();
+    level_params.resize(N * D);
+    for (int i = 0; i < N; i++) {
+      auto sample_shape = prev_shape.tensor_shape_span(i);
+      for (int d = 0; d < D; d++) {
+        auto &p = level_params[i * D + d];
+        const auto &first_level = resample_params_[i * D + d];
+        p = {};
+        p.min_filter = first_level.min_filter;
+        p.mag_filter = first_level.mag_filter;
+        int64_t extent = sample_shape[FirstSpatialDim() + d];
+        p.output_size = std::max<int64_t>(1, std::llround(extent * pyramid_scale_));
+      }
+    }
+  }
+
+  int NumLevels() const { return 1 + extra_levels_.size(); }
+
   void InitializeBackend();
 
   USE_OPERATOR_MEMBERS();
   std::vector<kernels::ResamplingParams> resample_params_;
+  std::vector<kernels::ResamplingParams> level_params_;
+  /// The resize of the second and further pyramid levels, each reading the previous level
+  std::vector<std::unique_ptr<ResizeBase<Backend>>> extra_levels_;
+  float pyramid_scale_ = 0.5f;
   TensorList<CPUBackend> attr_staging_;
   using Operator<Backend>::RunImpl;
   bool save_attrs_ = false;
@@ -94,7 +128,8 @@ class Resize : public Operator<Backend>
 template <typename Backend>
 bool Resize<Backend>::SetupImpl(std::vector<OutputDesc> &output_desc,
                                 const workspace_t<Backend> &ws) {
-  output_desc.resize(save_attrs_ ? 2 : 1);
+  int num_levels = NumLevels();
+  output_desc.resize(num_levels + (save_attrs_ ? 1 : 0));
   auto &input = ws.template Input<Backend>(0);
 
   const auto &in_shape = input.shape();
@@ -110,9 +145,18 @@ bool Resize<Backend>::SetupImpl(std::vector<OutputDesc> &output_desc,
   this->SetupResize(output_desc[0].shape, out_type, in_shape, in_type,
                     make_cspan(this->resample_params_), NumSpatialDims(), FirstSpatialDim());
 
+  for (int l = 1; l < num_levels; l++) {
+    const auto &prev_shape = output_desc[l - 1].shape;
+    GetLevelParams(level_params_, prev_shape);
+    output_desc[l].type = out_type;
+    extra_levels_[l - 1]->SetupResize(output_desc[l].shape, out_type, prev_shape, out_type,
+                                      make_cspan(level_params_), NumSpatialDims(),
+                                      FirstSpatialDim());
+  }
+
   if (save_attrs_) {
-    output_desc[1].shape = uniform_list_shape(N, TensorShape<1>({ NumSpatialDims() }));
-    output_desc[1].type = DALI_INT32;
+    output_desc[num_levels].shape = uniform_list_shape(N, TensorShape<1>({ NumSpatialDims() }));
+    output_desc[num_levels].type = DALI_INT32;
   }
   return true;
 }
@@ -27,6 +27,8 @@ namespace dali {
 template <typename Backend>
 ResizeBase<Backend>::ResizeBase(const OpSpec &spec) {
   size_t temp_buffer_hint = spec.GetArgument<int64_t>("temp_buffer_hint");
+  half_precision_intermediate_ = spec.GetArgument<bool>("half_precision_intermediate");
+  half_precision_compute_ = spec.GetArgument<bool>("half_precision_compute");
 }
 
 template <typename Backend>
@@ -79,7 +81,9 @@ void ResizeBase<GPUBackend>::SetupResizeStatic(
   auto *impl = dynamic_cast<ImplType*>(impl_.get());
   if (!impl) {
     impl_.reset();
-    auto unq_impl = std::make_unique<ImplType>(kmgr_, minibatch_size_);
+    auto unq_impl = std::make_unique<ImplType>(kmgr_, minibatch_size_,
+                                               half_precision_intermediate_,
+                                               half_precision_compute_);
     impl = unq_impl.get();
     impl_ = std::move(unq_impl);
   }
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -95,6 +95,8 @@ class DLL_PUBLIC ResizeBase {
 
   int num_threads_ = 1;
   int minibatch_size_ = 32;
+  bool half_precision_intermediate_ = false;
+  bool half_precision_compute_ = false;
   std::unique_ptr<Impl> impl_;
   kernels::KernelManager kmgr_;
 };
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2018, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -38,7 +38,8 @@ random resizing and cropping are supported.)code")
       DALI_INTERP_LINEAR)
   .AddParent("Crop")
   .AddParent("ResizeCropMirrorAttr")
-  .InputLayout("HWC");
+  .InputLayout("HWC")
+  .SampleChainable();
 
 DALI_REGISTER_OPERATOR(FastResizeCropMirror, FastResizeCropMirror<CPUBackend>, CPU);
 
@@ -51,6 +52,7 @@ work that is performed.)code")
   .NumInput(1)
   .NumOutput(1)
   .AddParent("ResizeCropMirror")
-  .InputLayout("HWC");
+  .InputLayout("HWC")
+  .SampleChainable();
 
 }  // namespace dali
@@ -29,8 +29,12 @@ namespace dali {
 template <typename Out, typename In, int spatial_ndim>
 class ResizeOpImplGPU : public ResizeBase<GPUBackend>::Impl {
  public:
-  explicit ResizeOpImplGPU(kernels::KernelManager &kmgr, int minibatch_size)
-  : kmgr_(kmgr), minibatch_size_(minibatch_size) {
+  ResizeOpImplGPU(kernels::KernelManager &kmgr, int minibatch_size,
+                  bool half_precision_intermediate = false,
+                  bool half_precision_compute = false)
+  : kmgr_(kmgr), minibatch_size_(minibatch_size),
+    half_precision_intermediate_(half_precision_intermediate),
+    half_precision_compute_(half_precision_compute) {
     kmgr_.Reset();
   }
 
@@ -106,7 +110,8 @@ class ResizeOpImplGPU : public ResizeBase<GPUBackend>::Impl {
   void SetNumFrames(int n) {
     int num_minibatches = CalculateMinibatchPartition(n, minibatch_size_);
     if (static_cast<int>(kmgr_.NumInstances()) < num_minibatches)
-      kmgr_.Resize<Kernel>(num_minibatches);
+      kmgr_.Resize<Kernel>(num_minibatches, half_precision_intermediate_,
+                           half_precision_compute_);
   }
 
   int CalculateMinibatchPartition(int total_frames, int minibatch_size) {
@@ -149,6 +154,8 @@ class ResizeOpImplGPU : public ResizeBase<GPUBackend>::Impl {
   }
 
   int minibatch_size_;
+  bool half_precision_intermediate_;
+  bool half_precision_compute_;
 };
 
 }  // namespace dali
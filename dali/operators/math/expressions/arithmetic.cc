@@ -22,7 +22,7 @@ namespace dali {
 template <>
 void ArithmeticGenericOp<CPUBackend>::RunImpl(HostWorkspace &ws) {
   PrepareTilesForTasks<CPUBackend>(tiles_per_task_, exec_order_, tile_cover_, ws, constant_storage_,
-                                   spec_);
+                                   spec_, intermediate_);
   auto &pool = ws.GetThreadPool();
   ws.Output<CPUBackend>(0).SetLayout(result_layout_);
   for (size_t task_idx = 0; task_idx < tile_range_.size(); task_idx++) {
@@ -71,6 +71,8 @@ Examples::
     .NumInput(1, 64)  // Some arbitrary number that needs to be validated in operator
     .AddOptionalArg("real_constants", "", std::vector<float>{}, true)
     .NumOutput(1)
+    // element-wise - every output element depends only on the input elements at the same index
+    .InPlaceFn([](const OpSpec &) { return true; })
     .MakeDocHidden();
 
 DALI_REGISTER_OPERATOR(ArithmeticGenericOp, ArithmeticGenericOp<CPUBackend>, CPU);
@@ -17,6 +17,7 @@
 
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -29,6 +30,7 @@
 #include "dali/kernels/type_tag.h"
 #include "dali/operators/math/expressions/arithmetic_meta.h"
 #include "dali/operators/math/expressions/expression_impl_factory.h"
+#include "dali/operators/math/expressions/fused_chain.h"
 #include "dali/pipeline/operator/operator.h"
 
 namespace dali {
@@ -288,7 +290,8 @@ inline void CheckAllowedOperations(ExprNode &expr) {
  * @brief Arithmetic operator capable of executing expression tree of element-wise
  *        arithmetic operations.
  *
- * Only expressions consisting of one function node with tensor inputs are now supported.
+ * The function nodes are evaluated bottom-up, the results of the inner nodes are kept
+ * in intermediate buffers, tile by tile.
  *
  * There are 3 levels for unit of work.
  * - Thread (CPUBackend) or CUDA kernel invokation (GPUBackend)
@@ -328,15 +331,18 @@ class ArithmeticGenericOp : public Operator<Backend> {
       AccessOrder order = ws.has_stream() ? ws.stream() : AccessOrder::host();
       constant_storage_.Initialize(spec_, order, constant_nodes);
       CheckAllowedOperations(*expr_);
+      // On the GPU every node is a separate kernel with a buffer for its result
+      if (std::is_same<Backend, GPUBackend>::value)
+        FuseScalarChains(expr_, spec_);
       types_layout_inferred_ = true;
     }
 
     result_shape_ = PropagateShapes<Backend>(*expr_, ws, curr_batch_size);
-    AllocateIntermediateNodes();
     exec_order_ = CreateExecutionTasks<Backend>(*expr_, cache_, ws.has_stream() ? ws.stream() : 0);
 
     output_desc[0] = {result_shape_, result_type_id_};
     std::tie(tile_cover_, tile_range_) = GetTiledCover(result_shape_, kTileSize, kTaskSize);
+    AllocateIntermediateNodes(ws);
     return true;
   }
 
@@ -344,20 +350,50 @@ class ArithmeticGenericOp : public Operator<Backend> {
   void RunImpl(workspace_t<Backend> &ws) override;
 
  private:
-  void AllocateIntermediateNodes() {
-    auto &expr = *expr_;
-    bool is_simple_expression = expr.GetNodeType() == NodeType::Function &&
-                                expr.GetSubexpressionCount() > 0 &&
-                                expr.GetSubexpressionCount() <= kMaxArity;
-    auto &func = dynamic_cast<ExprFunc &>(expr);
-    for (int i = 0; i < func.GetSubexpressionCount(); i++) {
-      is_simple_expression = is_simple_expression && func[i].GetNodeType() != NodeType::Function;
+  /**
+   * @brief Allocates the buffers for the results of the inner function nodes.
+   *
+   * The subexpressions are evaluated over the same tiles as the whole expression.
+   * On the CPU the tiles of a task are processed one by one by a single thread, so every task
+   * needs only one tile of memory per node. On the GPU every node is evaluated for the whole
+   * batch, before its parent, so all the tiles have to be stored.
+   */
+  void AllocateIntermediateNodes(const workspace_t<Backend> &ws) {
+    DALI_ENFORCE(expr_->GetNodeType() == NodeType::Function,
+                 "The expression must contain at least one function node.");
+    std::vector<const ExprNode *> inner_nodes;
+    for (auto &task : exec_order_) {
+      if (task.ctx.node != expr_.get())
+        inner_nodes.push_back(task.ctx.node);
+    }
+    intermediate_.buffers.clear();
+    if (inner_nodes.empty())
+      return;
+
+    int num_slots = 0;
+    intermediate_.tile_slot.resize(tile_cover_.size());
+    if (std::is_same<Backend, CPUBackend>::value) {
+      num_slots = tile_range_.size();
+      for (int task_idx = 0; task_idx < num_slots; task_idx++) {
+        for (int t = tile_range_[task_idx].begin; t < tile_range_[task_idx].end; t++)
+          intermediate_.tile_slot[t] = task_idx;
+      }
+    } else {
+      num_slots = tile_cover_.size();
+      std::iota(intermediate_.tile_slot.begin(), intermediate_.tile_slot.end(), 0);
     }
 
-    DALI_ENFORCE(is_simple_expression,
-                 "Complex expression trees are not yet supported. Only expressions containing one "
-                 "function node with one or two inputs are supported.");
-    // TODO(klecki): allocate memory for intermediate results and point the threads to them
+    if (intermediate_buffers_.size() < inner_nodes.size())
+      intermediate_buffers_.resize(inner_nodes.size());
+    AccessOrder order = ws.has_stream() ? ws.stream() : AccessOrder::host();
+    for (size_t i = 0; i < inner_nodes.size(); i++) {
+      auto &buffer = intermediate_buffers_[i];
+      if (std::is_same<Backend, CPUBackend>::value && !buffer.raw_data())
+        buffer.set_pinned(false);
+      buffer.set_order(order);
+      buffer.Resize({static_cast<int64_t>(num_slots) * kTileSize}, inner_nodes[i]->GetTypeId());
+      intermediate_.buffers[inner_nodes[i]] = buffer.raw_mutable_data();
+    }
   }
 
   std::unique_ptr<ExprNode> expr_;
@@ -369,6 +405,8 @@ class ArithmeticGenericOp : public Operator<Backend> {
   std::vector<TileRange> tile_range_;
   std::vector<ExprImplTask> exec_order_;
   std::vector<std::vector<ExtendedTileDesc>> tiles_per_task_;
+  std::vector<Tensor<Backend>> intermediate_buffers_;
+  IntermediateResults intermediate_;
   ConstantStorage<Backend> constant_storage_;
   ExprImplCache cache_;
   // For CPU we limit the tile size to limit the sizes of intermediate buffers
@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -678,4 +678,166 @@ TEST(ArithmeticOpsTest, UnaryPipeline) {
   }
 }
 
+TEST(ArithmeticOpsTest, NestedExpressionPipeline) {
+  constexpr int magic_int = 3;
+  constexpr int batch_size = 8;
+  constexpr int num_threads = 4;
+  // spans a few CPU tiles
+  constexpr int tensor_elements = 10000;
+  Pipeline pipe(batch_size, num_threads, 0);
+
+  pipe.AddExternalInput("data0");
+  pipe.AddExternalInput("data1");
+
+  // 3 * d0 + (-d1 - d0), where d1 is a batch of scalars
+  const std::string expression = "add(mul(&0 $0:int32) sub(minus(&1) &0))";
+  for (std::string device : {"cpu", "gpu"}) {
+    pipe.AddOperator(OpSpec("ArithmeticGenericOp")
+                         .AddArg("device", device)
+                         .AddArg("expression_desc", expression)
+                         .AddArg("integer_constants", std::vector<int>{magic_int})
+                         .AddInput("data0", device)
+                         .AddInput("data1", device)
+                         .AddOutput("result_" + device, device),
+                     "arithm_" + device);
+  }
+
+  vector<std::pair<string, string>> outputs = {{"result_cpu", "cpu"}, {"result_gpu", "gpu"}};
+
+  pipe.Build(outputs);
+
+  TensorList<CPUBackend> batch0, batch1;
+  FillBatch<int>(batch0, uniform_list_shape(batch_size, {tensor_elements}));
+  FillBatch<int>(batch1, uniform_list_shape(batch_size, {1}));
+
+  pipe.SetExternalInput("data0", batch0);
+  pipe.SetExternalInput("data1", batch1);
+  pipe.RunCPU();
+  pipe.RunGPU();
+  DeviceWorkspace ws;
+  pipe.Outputs(&ws);
+
+  vector<int32_t> result_gpu_cpu(tensor_elements);
+  for (int sample_id = 0; sample_id < batch_size; sample_id++) {
+    const auto *data0 = batch0.tensor<int>(sample_id);
+    const auto scalar = batch1.tensor<int>(sample_id)[0];
+    auto *result_cpu = ws.Output<CPUBackend>(0).tensor<int32_t>(sample_id);
+    auto *result_gpu = ws.Output<GPUBackend>(1).tensor<int32_t>(sample_id);
+
+    MemCopy(result_gpu_cpu.data(), result_gpu, tensor_elements * sizeof(int));
+    CUDA_CALL(cudaStreamSynchronize(0));
+
+    for (int i = 0; i < tensor_elements; i++) {
+      int expected = magic_int * data0[i] + (-scalar - data0[i]);
+      EXPECT_EQ(result_cpu[i], expected);
+      EXPECT_EQ(result_gpu_cpu[i], expected);
+    }
+  }
+}
+
+TEST(ArithmeticOpsTest, ScalarChainPipeline) {
+  constexpr int batch_size = 8;
+  constexpr int num_threads = 4;
+  constexpr int tensor_elements = 10000;
+  constexpr int magic_int = 3;
+  const std::vector<float> reals = {0.5f, 3.f, 7.f};
+  Pipeline pipe(batch_size, num_threads, 0);
+
+  pipe.AddExternalInput("data0");
+
+  // 3 - (d0 + 3) * 0.5 / 7 - the float operations are fused into one kernel on the GPU
+  const std::string expression = "sub($1:float32 div(mul(add(&0 $0:int32) $0:float32) $2:float32))";
+  for (std::string device : {"cpu", "gpu"}) {
+    pipe.AddOperator(OpSpec("ArithmeticGenericOp")
+                         .AddArg("device", device)
+                         .AddArg("expression_desc", expression)
+                         .AddArg("integer_constants", std::vector<int>{magic_int})
+                         .AddArg("real_constants", reals)
+                         .AddInput("data0", device)
+                         .AddOutput("result_" + device, device),
+                     "arithm_" + device);
+  }
+
+  vector<std::pair<string, string>> outputs = {{"result_cpu", "cpu"}, {"result_gpu", "gpu"}};
+
+  pipe.Build(outputs);
+
+  TensorList<CPUBackend> batch0;
+  FillBatch<int>(batch0, uniform_list_shape(batch_size, {tensor_elements}));
+
+  pipe.SetExternalInput("data0", batch0);
+  pipe.RunCPU();
+  pipe.RunGPU();
+  DeviceWorkspace ws;
+  pipe.Outputs(&ws);
+
+  vector<float> result_gpu_cpu(tensor_elements);
+  for (int sample_id = 0; sample_id < batch_size; sample_id++) {
+    const auto *data0 = batch0.tensor<int>(sample_id);
+    auto *result_cpu = ws.Output<CPUBackend>(0).tensor<float>(sample_id);
+    auto *result_gpu = ws.Output<GPUBackend>(1).tensor<float>(sample_id);
+
+    MemCopy(result_gpu_cpu.data(), result_gpu, tensor_elements * sizeof(float));
+    CUDA_CALL(cudaStreamSynchronize(0));
+
+    for (int i = 0; i < tensor_elements; i++) {
+      float expected = reals[1] - static_cast<float>(data0[i] + magic_int) * reals[0] / reals[2];
+      EXPECT_FLOAT_EQ(result_cpu[i], expected);
+      // the fused chain is evaluated in the same order, without contracting the operations
+      EXPECT_EQ(result_gpu_cpu[i], result_cpu[i]);
+    }
+  }
+}
+
+TEST(ArithmeticOpsTest, FusedPipeline) {
+  constexpr int batch_size = 16;
+  constexpr int num_threads = 4;
+  constexpr int tensor_elements = 16;
+  Pipeline pipe(batch_size, num_threads, 0);
+
+  pipe.AddExternalInput("data0");
+  pipe.AddExternalInput("data1");
+
+  // `tmp` is not an output, so the two operators are fused into one
+  pipe.AddOperator(OpSpec("ArithmeticGenericOp")
+                       .AddArg("device", "cpu")
+                       .AddArg("expression_desc", "sub(&0 &1)")
+                       .AddInput("data0", "cpu")
+                       .AddInput("data1", "cpu")
+                       .AddOutput("tmp", "cpu"),
+                   "arithm_cpu_sub");
+
+  pipe.AddOperator(OpSpec("ArithmeticGenericOp")
+                       .AddArg("device", "cpu")
+                       .AddArg("expression_desc", "mul(&0 &1)")
+                       .AddInput("tmp", "cpu")
+                       .AddInput("data1", "cpu")
+                       .AddOutput("result", "cpu"),
+                   "arithm_cpu_mul");
+
+  vector<std::pair<string, string>> outputs = {{"result", "cpu"}};
+
+  pipe.Build(outputs);
+
+  TensorList<CPUBackend> batch0, batch1;
+  FillBatch<int>(batch0, uniform_list_shape(batch_size, {tensor_elements}));
+  FillBatch<int>(batch1, uniform_list_shape(batch_size, {tensor_elements}));
+
+  pipe.SetExternalInput("data0", batch0);
+  pipe.SetExternalInput("data1", batch1);
+  pipe.RunCPU();
+  pipe.RunGPU();
+  DeviceWorkspace ws;
+  pipe.Outputs(&ws);
+
+  for (int sample_id = 0; sample_id < batch_size; sample_id++) {
+    const auto *data0 = batch0.tensor<int>(sample_id);
+    const auto *data1 = batch1.tensor<int>(sample_id);
+    auto *result = ws.Output<CPUBackend>(0).tensor<int32_t>(sample_id);
+    for (int i = 0; i < tensor_elements; i++) {
+      EXPECT_EQ(result[i], (data0[i] - data1[i]) * data1[i]);
+    }
+  }
+}
+
 }  // namespace dali
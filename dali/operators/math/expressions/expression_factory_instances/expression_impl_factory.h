@@ -29,7 +29,7 @@ namespace dali {
  *        implementation for unary (executor for given expression) and return it.
  *
  * The static type switch goes over input types and input kinds.
- * This is unary case and only tensor inputs are allowed.
+ * This is unary case and only tensor inputs (or subexpressions) are allowed.
  *
  * @tparam ImplTensor template that maps unary Arithmetic Op and input/output type
  *                    to a functor that can execute it over a tile of a tensor (by creating a loop)
@@ -43,7 +43,7 @@ std::unique_ptr<ExprImplBase> ExprImplFactoryUnOp(const ExprFunc &expr) {
   auto input_type = expr[0].GetTypeId();
   TYPE_SWITCH(input_type, type2id, Input_t, ARITHMETIC_ALLOWED_TYPES, (
     using Out_t = typename arithm_meta<op, Backend>::template result_t<Input_t>;
-    if (expr[0].GetNodeType() == NodeType::Tensor) {
+    if (expr[0].GetNodeType() != NodeType::Constant) {
       result.reset(new ImplTensor<op, Out_t, Input_t>());
     } else {
       DALI_FAIL("Expression cannot have a constant operand");
@@ -57,7 +57,8 @@ std::unique_ptr<ExprImplBase> ExprImplFactoryUnOp(const ExprFunc &expr) {
  *        implementation for binary op (executor for given expression) and return it.
  *
  * The static type switch goes over input types and input kinds.
- * This is binary case and three possible input kind combinations are supported:
+ * This is binary case and three possible input kind combinations are supported
+ * (the results of subexpressions are passed as tensors):
  * * Tensor and Tensor
  * * Tensor and Constant
  * * Constant and Tensor
@@ -89,12 +90,11 @@ std::unique_ptr<ExprImplBase> ExprImplFactoryBinOp(const ExprFunc &expr) {
   TYPE_SWITCH(left_type, type2id, Left_t, ARITHMETIC_ALLOWED_TYPES, (
     TYPE_SWITCH(right_type, type2id, Right_t, ARITHMETIC_ALLOWED_TYPES, (
       using Out_t = typename arithm_meta<op, Backend>::template result_t<Left_t, Right_t>;
-      if (expr[0].GetNodeType() == NodeType::Tensor && IsScalarLike(expr[1])) {
+      if (IsTensorLike(expr[0]) && IsScalarLike(expr[1])) {
         result.reset(new ImplTensorConstant<op, Out_t, Left_t, Right_t>());
-      } else if (IsScalarLike(expr[0]) && expr[1].GetNodeType() == NodeType::Tensor) {
+      } else if (IsScalarLike(expr[0]) && IsTensorLike(expr[1])) {
         result.reset( new ImplConstantTensor<op, Out_t, Left_t, Right_t>());
-      } else if (expr[0].GetNodeType() == NodeType::Tensor &&
-                 expr[1].GetNodeType() == NodeType::Tensor) {
+      } else if (IsTensorLike(expr[0]) && IsTensorLike(expr[1])) {
         // Both are non-scalar tensors
         result.reset(new ImplTensorTensor<op, Out_t, Left_t, Right_t>());
       } else {
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_MATH_EXPRESSIONS_EXPRESSION_IMPL_CPU_H_
 #define DALI_OPERATORS_MATH_EXPRESSIONS_EXPRESSION_IMPL_CPU_H_
 
+#include <algorithm>
 #include <vector>
 
 #include "dali/pipeline/data/types.h"
@@ -154,12 +155,24 @@ class ExprImplCpuTernary : public ExprImplBase {
                       expression_detail::param_t<IsThirdTensor, Result> third,
                       DALIDataType first_type, DALIDataType second_type, DALIDataType third_type,
                       int64_t extent) {
-    for (int64_t i = 0; i < extent; i++) {
-      result[i] = meta_t::impl(expression_detail::Access<Result>(first, i, first_type),
-                               expression_detail::Access<Result>(second, i, second_type),
-                               expression_detail::Access<Result>(third, i, third_type));
+    using expression_detail::Access;
+    using expression_detail::Load;
+    // The tensor operands are converted to Result in chunks, so that the type switch
+    // is not done for every element and the inner loop can be vectorized
+    Result buf0[kChunkSize], buf1[kChunkSize], buf2[kChunkSize];
+    for (int64_t start = 0; start < extent; start += kChunkSize) {
+      int64_t n = std::min<int64_t>(kChunkSize, extent - start);
+      auto a = Load<IsFirstTensor>(buf0, first, start, n, first_type);
+      auto b = Load<IsSecondTensor>(buf1, second, start, n, second_type);
+      auto c = Load<IsThirdTensor>(buf2, third, start, n, third_type);
+      Result *out = result + start;
+      for (int64_t i = 0; i < n; i++) {
+        out[i] = meta_t::impl(Access(a, i), Access(b, i), Access(c, i));
+      }
     }
   }
+
+  static constexpr int kChunkSize = 256;
 };
 
 }  // namespace dali
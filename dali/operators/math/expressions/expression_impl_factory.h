@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_MATH_EXPRESSIONS_EXPRESSION_IMPL_FACTORY_H_
 #define DALI_OPERATORS_MATH_EXPRESSIONS_EXPRESSION_IMPL_FACTORY_H_
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -122,6 +123,28 @@ DALI_HOST_DEV T Access(T value, int64_t, DALIDataType) {
 template <bool as_ptr, typename T>
 using param_t = std::conditional_t<as_ptr, const void*, T>;
 
+/**
+ * @brief Returns the elements [offset, offset + count) of the type-erased tensor operand,
+ *        converted to T and stored in `buffer`, or passes the scalar operand through.
+ *
+ * It does the type switch once per `count` elements, instead of once per element.
+ */
+template <bool as_ptr, typename T>
+std::enable_if_t<as_ptr, const T*> Load(T *buffer, const void *ptr, int64_t offset,
+                                        int64_t count, DALIDataType type_id) {
+  TYPE_SWITCH(type_id, type2id, AccessType, ARITHMETIC_ALLOWED_TYPES, (
+    const auto *access = reinterpret_cast<const AccessType*>(ptr) + offset;
+    for (int64_t i = 0; i < count; i++)
+      buffer[i] = static_cast<T>(access[i]);
+  ), std::fill(buffer, buffer + count, T{}););  // NOLINT(whitespace/parens)
+  return buffer;
+}
+
+template <bool as_ptr, typename T>
+std::enable_if_t<!as_ptr, T> Load(T *, T value, int64_t, int64_t, DALIDataType) {
+  return value;
+}
+
 }  // namespace expression_detail
 
 struct ExprImplTask {
@@ -145,8 +168,32 @@ inline InputSamplePtr GetInputSamplePointer(DeviceWorkspace &ws, int input_idx,
   return ws.template Input<GPUBackend>(input_idx).raw_tensor(sample_idx);
 }
 
+/**
+ * @brief Memory for the results of the inner function nodes of the expression tree.
+ *
+ * The results are stored per tile: the i-th tile of `node` is computed to
+ * `buffers[node] + tile_slot[i] * tile_size` elements. Tiles processed one after another
+ * by the same thread can share a slot.
+ */
+struct IntermediateResults {
+  std::map<const ExprNode *, void *> buffers;
+  std::vector<int> tile_slot;
+};
+
+inline void *GetIntermediatePointer(const IntermediateResults &intermediate,
+                                    const ExprNode &node, TileDesc tile, int tile_idx) {
+  auto it = intermediate.buffers.find(&node);
+  DALI_ENFORCE(it != intermediate.buffers.end(),
+               "No buffer allocated for the result of the subexpression.");
+  return static_cast<char *>(it->second) + intermediate.tile_slot[tile_idx] * tile.tile_size *
+                                               TypeTable::GetTypeInfo(node.GetTypeId()).size();
+}
+
 template <typename Backend>
-inline OutputSamplePtr GetOutput(const ExprFunc &func, workspace_t<Backend> &ws, TileDesc tile) {
+inline OutputSamplePtr GetOutput(const ExprFunc &func, workspace_t<Backend> &ws, TileDesc tile,
+                                 const IntermediateResults &intermediate, int tile_idx) {
+  if (intermediate.buffers.count(&func))
+    return GetIntermediatePointer(intermediate, func, tile, tile_idx);
   return reinterpret_cast<char *>(GetOutputSamplePointer(ws, 0, tile.sample_idx)) +
          tile.tile_size * tile.extent_idx * TypeTable::GetTypeInfo(func.GetTypeId()).size();
 }
@@ -156,13 +203,15 @@ inline OutputSamplePtr GetOutput(const ExprFunc &func, workspace_t<Backend> &ws,
  */
 template <typename Backend>
 inline ArgPack GetArgPack(const ExprFunc &func, workspace_t<Backend> &ws,
-                          const ConstantStorage<Backend> &st, const OpSpec &spec, TileDesc tile) {
+                          const ConstantStorage<Backend> &st, const OpSpec &spec, TileDesc tile,
+                          const IntermediateResults &intermediate, int tile_idx) {
   ArgPack result;
   result.resize(func.GetSubexpressionCount());
   for (int i = 0; i < func.GetSubexpressionCount(); i++) {
-    DALI_ENFORCE(func[i].GetNodeType() != NodeType::Function,
-                 "Function nodes are not supported as subexpressions");
-    if (IsScalarLike(func[i])) {
+    if (func[i].GetNodeType() == NodeType::Function) {
+      // The subexpressions are computed over the same tiles before this node
+      result[i] = GetIntermediatePointer(intermediate, func[i], tile, tile_idx);
+    } else if (IsScalarLike(func[i])) {
       if (func[i].GetNodeType() == NodeType::Constant) {
         const auto &constant = dynamic_cast<const ExprConstant &>(func[i]);
         result[i] = st.GetPointer(constant.GetConstIndex(), constant.GetTypeId());
@@ -188,7 +237,7 @@ inline ArgPack GetArgPack(const ExprFunc &func, workspace_t<Backend> &ws,
 /**
  * @brief Transfor vector of TileDesc into vector of ExtendedTileDesc
  * based on the ExprFunc by extracting the input and output pointers to data
- * from workspace and constant storage.
+ * from workspace, constant storage and the buffers for the intermediate results.
  *
  * @param extended_tiles Output vector of ExtendedTiles for given task
  */
@@ -196,16 +245,23 @@ template <typename Backend>
 void TransformDescs(std::vector<ExtendedTileDesc> &extended_tiles,
                     const std::vector<TileDesc> &tiles, const ExprFunc &func,
                     workspace_t<Backend> &ws, const ConstantStorage<Backend> &st,
-                    const OpSpec &spec) {
+                    const OpSpec &spec, const IntermediateResults &intermediate) {
   extended_tiles.reserve(tiles.size());
   SmallVector<DALIDataType, kMaxArity> in_types;
   in_types.resize(func.GetSubexpressionCount());
   for (int i = 0; i < func.GetSubexpressionCount(); i++) {
     in_types[i] = func[i].GetTypeId();
   }
-  for (auto &tile : tiles) {
-    extended_tiles.emplace_back(tile, GetOutput<Backend>(func, ws, tile),
-                                GetArgPack(func, ws, st, spec, tile), func.GetTypeId(), in_types);
+  // A scalar-like subexpression is an operand broadcast over the tile, it's enough
+  // to compute its one element
+  bool is_scalar = IsScalarLike(func);
+  for (int tile_idx = 0; tile_idx < static_cast<int>(tiles.size()); tile_idx++) {
+    auto tile = tiles[tile_idx];
+    if (is_scalar)
+      tile.extent_size = std::min<int64_t>(tile.extent_size, 1);
+    extended_tiles.emplace_back(tile, GetOutput<Backend>(func, ws, tile, intermediate, tile_idx),
+                                GetArgPack(func, ws, st, spec, tile, intermediate, tile_idx),
+                                func.GetTypeId(), in_types);
   }
 }
 
@@ -219,13 +275,15 @@ template <typename Backend>
 void PrepareTilesForTasks(std::vector<std::vector<ExtendedTileDesc>> &tiles_per_task,
                           const std::vector<ExprImplTask> &task_exec_order,
                           const std::vector<TileDesc> &tiles, workspace_t<Backend> &ws,
-                          const ConstantStorage<Backend> &constant_storage, const OpSpec &spec) {
+                          const ConstantStorage<Backend> &constant_storage, const OpSpec &spec,
+                          const IntermediateResults &intermediate) {
   tiles_per_task.resize(task_exec_order.size());
   for (size_t i = 0; i < task_exec_order.size(); i++) {
     const auto &expr_task = task_exec_order[i];
     const auto &expr_func = dynamic_cast<const ExprFunc &>(*expr_task.ctx.node);
     tiles_per_task[i].resize(0);
-    TransformDescs<Backend>(tiles_per_task[i], tiles, expr_func, ws, constant_storage, spec);
+    TransformDescs<Backend>(tiles_per_task[i], tiles, expr_func, ws, constant_storage, spec,
+                            intermediate);
   }
 }
 
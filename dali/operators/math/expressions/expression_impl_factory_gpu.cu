@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -20,6 +20,7 @@
 #include "dali/operators/math/expressions/expression_impl_factory.h"
 #include "dali/operators/math/expressions/expression_impl_gpu.cuh"
 #include "dali/operators/math/expressions/expression_tree.h"
+#include "dali/operators/math/expressions/fused_chain.h"
 
 namespace dali {
 
@@ -68,6 +69,9 @@ std::unique_ptr<ExprImplBase> ExprImplFactoryGpuTernary(const ExprFunc &expr) {
 std::unique_ptr<ExprImplBase> ExprImplFactory(const DeviceWorkspace &ws, const ExprNode &expr) {
   DALI_ENFORCE(expr.GetNodeType() == NodeType::Function, "Only function nodes can be executed.");
 
+  if (auto *fused_chain = dynamic_cast<const ExprFusedChain *>(&expr))
+    return ExprImplFactoryGpuFusedChain(*fused_chain);
+
   switch (expr.GetSubexpressionCount()) {
     case 1:
       return ExprImplFactoryGpuUnary(dynamic_cast<const ExprFunc&>(expr));
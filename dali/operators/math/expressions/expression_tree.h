@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -165,6 +165,13 @@ class ExprFunc : public ExprNode {
     return *subexpr_[i];
   }
 
+  /**
+   * @brief Returns the owning pointer to the i-th subexpression, so that it can be replaced
+   */
+  std::unique_ptr<ExprNode> &Subexpression(int i) {
+    return subexpr_[i];
+  }
+
  private:
   std::string func_name_;
   std::vector<std::unique_ptr<ExprNode>> subexpr_;
@@ -220,12 +227,21 @@ class ExprConstant : public ExprNode {
 DLL_PUBLIC std::unique_ptr<ExprNode> ParseExpressionString(const std::string &expr);
 
 /**
- * @brief Scalar-like nodes are the Constant nodes and Tensor nodes that consist of batch of
- * scalars.
+ * @brief Scalar-like nodes are the Constant nodes and Tensor or Function nodes that consist of
+ * batch of scalars.
  */
 inline bool IsScalarLike(const ExprNode &node) {
-  return node.GetNodeType() == NodeType::Constant ||
-         (node.GetNodeType() == NodeType::Tensor && IsScalarLike(node.GetShape()));
+  return node.GetNodeType() == NodeType::Constant || IsScalarLike(node.GetShape());
+}
+
+/**
+ * @brief Tensor-like nodes are the Tensor nodes and the Function nodes, which are evaluated
+ * to a buffer.
+ *
+ * Note that a Tensor node can be both scalar-like and tensor-like.
+ */
+inline bool IsTensorLike(const ExprNode &node) {
+  return node.GetNodeType() == NodeType::Tensor || node.GetNodeType() == NodeType::Function;
 }
 
 }  // namespace dali
@@ -0,0 +1,117 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "dali/core/static_switch.h"
+#include "dali/operators/math/expressions/fused_chain.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief Returns the index of the constant operand of `node`, if the node can be a part of
+ *        a fused chain, or -1 otherwise
+ */
+int GetChainConstantIdx(const ExprNode &node) {
+  if (node.GetNodeType() != NodeType::Function || node.GetSubexpressionCount() != 2 ||
+      node.GetTypeId() != DALI_FLOAT || dynamic_cast<const ExprFusedChain *>(&node))
+    return -1;
+  auto &func = dynamic_cast<const ExprFunc &>(node);
+  auto op = NameToOp(func.GetFuncName());
+  if (op != ArithmeticOp::add && op != ArithmeticOp::sub && op != ArithmeticOp::mul &&
+      op != ArithmeticOp::div)
+    return -1;
+  bool left_constant = func[0].GetNodeType() == NodeType::Constant;
+  bool right_constant = func[1].GetNodeType() == NodeType::Constant;
+  if (left_constant == right_constant)
+    return -1;
+  return left_constant ? 0 : 1;
+}
+
+/**
+ * @brief Returns the value of the constant, as it's seen by an operation computed in float
+ *
+ * The constant is converted to its own type first, the same as in ConstantStorage.
+ */
+float GetConstantValue(const ExprConstant &constant, const std::vector<int> &integers,
+                       const std::vector<float> &reals) {
+  int idx = constant.GetConstIndex();
+  float value = 0;
+  if (IsIntegral(constant.GetTypeId())) {
+    DALI_ENFORCE(idx < static_cast<int>(integers.size()), "Missing an integer constant.");
+    TYPE_SWITCH(constant.GetTypeId(), type2id, Type,
+        (bool, uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t, int32_t, int64_t), (
+      value = static_cast<float>(static_cast<Type>(integers[idx]));
+    ), DALI_FAIL(make_string("Unsupported type: ", constant.GetTypeId())););  // NOLINT
+  } else {
+    DALI_ENFORCE(idx < static_cast<int>(reals.size()), "Missing a real constant.");
+    TYPE_SWITCH(constant.GetTypeId(), type2id, Type, (float16, float, double), (
+      value = static_cast<float>(static_cast<Type>(reals[idx]));
+    ), DALI_FAIL(make_string("Unsupported type: ", constant.GetTypeId())););  // NOLINT
+  }
+  return value;
+}
+
+void FuseScalarChains(std::unique_ptr<ExprNode> &expr, const std::vector<int> &integers,
+                      const std::vector<float> &reals) {
+  if (expr->GetNodeType() != NodeType::Function)
+    return;
+  // Walk the chain from the top; the operations are evaluated from the bottom
+  std::vector<FusedChainStep> steps;
+  ExprFunc *bottom = nullptr;
+  int source_idx = -1;
+  for (ExprNode *node = expr.get();
+       static_cast<int>(steps.size()) < FusedChainSteps::kMaxSteps;) {
+    int constant_idx = GetChainConstantIdx(*node);
+    if (constant_idx < 0)
+      break;
+    auto &func = dynamic_cast<ExprFunc &>(*node);
+    auto &constant = dynamic_cast<const ExprConstant &>(func[constant_idx]);
+    steps.push_back({NameToOp(func.GetFuncName()), constant_idx == 0,
+                     GetConstantValue(constant, integers, reals)});
+    bottom = &func;
+    source_idx = 1 - constant_idx;
+    node = &func[source_idx];
+  }
+
+  if (steps.size() >= 2) {
+    FusedChainSteps fused_steps;
+    std::reverse_copy(steps.begin(), steps.end(), fused_steps.steps);
+    fused_steps.count = steps.size();
+    auto source = std::move(bottom->Subexpression(source_idx));
+    expr = std::make_unique<ExprFusedChain>(fused_steps, std::move(source));
+  }
+
+  auto &func = dynamic_cast<ExprFunc &>(*expr);
+  for (int i = 0; i < func.GetSubexpressionCount(); i++)
+    FuseScalarChains(func.Subexpression(i), integers, reals);
+}
+
+}  // namespace
+
+void FuseScalarChains(std::unique_ptr<ExprNode> &expr, const OpSpec &spec) {
+  auto integers = spec.HasArgument("integer_constants")
+                      ? spec.GetRepeatedArgument<int>("integer_constants")
+                      : std::vector<int>{};
+  auto reals = spec.HasArgument("real_constants")
+                   ? spec.GetRepeatedArgument<float>("real_constants")
+                   : std::vector<float>{};
+  FuseScalarChains(expr, integers, reals);
+}
+
+}  // namespace dali
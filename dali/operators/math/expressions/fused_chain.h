@@ -0,0 +1,93 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_MATH_EXPRESSIONS_FUSED_CHAIN_H_
+#define DALI_OPERATORS_MATH_EXPRESSIONS_FUSED_CHAIN_H_
+
+#include <memory>
+#include <utility>
+
+#include "dali/operators/math/expressions/arithmetic_meta.h"
+#include "dali/operators/math/expressions/expression_tree.h"
+#include "dali/pipeline/operator/op_spec.h"
+
+namespace dali {
+
+/**
+ * @brief A single operation of a fused chain: `value = value op constant`,
+ *        or `value = constant op value`, if `constant_on_left` is set
+ */
+struct FusedChainStep {
+  ArithmeticOp op;
+  bool constant_on_left;
+  float constant;
+};
+
+/**
+ * @brief The operations of a fused chain, in the order of evaluation
+ *
+ * The structure is passed to the kernel by value.
+ */
+struct FusedChainSteps {
+  static constexpr int kMaxSteps = 8;
+  FusedChainStep steps[kMaxSteps];
+  int count = 0;
+};
+
+/**
+ * @brief Function node which replaces a chain of operations with scalar constants, like
+ *        `(x - mean) * scale + shift`, see FuseScalarChains
+ *
+ * The only subexpression is the source of the chain (`x`). The node is evaluated by a single
+ * kernel, which keeps the intermediate values in registers instead of a buffer per operation.
+ */
+class ExprFusedChain : public ExprFunc {
+ public:
+  ExprFusedChain(const FusedChainSteps &steps, std::unique_ptr<ExprNode> source)
+      : ExprFunc("fused_chain"), steps_(steps) {
+    SetTypeId(DALI_FLOAT);
+    AddSubexpression(std::move(source));
+  }
+
+  const FusedChainSteps &GetSteps() const {
+    return steps_;
+  }
+
+ private:
+  FusedChainSteps steps_;
+};
+
+/**
+ * @brief Replaces the chains of scalar operations in the expression tree `expr` with
+ *        ExprFusedChain nodes
+ *
+ * A chain consists of at least 2 nested `add`, `sub`, `mul` or `div` nodes of the float type,
+ * each of them with exactly one constant operand. Such a node computes
+ * `static_cast<float>(l) op static_cast<float>(r)`, so the fused chain gives the same results.
+ * Longer chains are split into parts of FusedChainSteps::kMaxSteps operations.
+ *
+ * The types of the nodes must be already propagated.
+ *
+ * @param spec the spec of the operator, which holds the values of the constants
+ */
+DLL_PUBLIC void FuseScalarChains(std::unique_ptr<ExprNode> &expr, const OpSpec &spec);
+
+/**
+ * @brief Returns the GPU implementation of the fused chain node `expr`
+ */
+std::unique_ptr<ExprImplBase> ExprImplFactoryGpuFusedChain(const ExprFusedChain &expr);
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_MATH_EXPRESSIONS_FUSED_CHAIN_H_
@@ -0,0 +1,91 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <vector>
+
+#include "dali/core/static_switch.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/operators/math/expressions/expression_impl_gpu.cuh"
+#include "dali/operators/math/expressions/fused_chain.h"
+
+namespace dali {
+
+/**
+ * @brief Applies a single operation of the chain
+ *
+ * The intrinsics prevent the compiler from contracting the operations (e.g. to FMA), so the
+ * result is the same as when each operation is evaluated by a separate kernel.
+ */
+__device__ __forceinline__ float ApplyFusedChainStep(const FusedChainStep &step, float value) {
+  float l = step.constant_on_left ? step.constant : value;
+  float r = step.constant_on_left ? value : step.constant;
+  switch (step.op) {
+    case ArithmeticOp::add:
+      return __fadd_rn(l, r);
+    case ArithmeticOp::sub:
+      return __fsub_rn(l, r);
+    case ArithmeticOp::mul:
+      return __fmul_rn(l, r);
+    default:
+      return __fdiv_rn(l, r);
+  }
+}
+
+/**
+ * @brief Go over all tiles, converting the source to float and applying the chain of operations
+ */
+template <typename Input>
+__global__ void ExecuteTiledFusedChain(const ExtendedTileDesc *tiles, FusedChainSteps steps) {
+  const auto &tile = tiles[blockIdx.y];
+  auto *output = static_cast<float *>(tile.output);
+  auto *in = static_cast<const Input *>(tile.args[0]);
+  int64_t start_ofs = static_cast<int64_t>(blockDim.x) * blockIdx.x + threadIdx.x;
+  int64_t stride = static_cast<int64_t>(blockDim.x) * gridDim.x;
+  for (int64_t i = start_ofs; i < tile.desc.extent_size; i += stride) {
+    float value = static_cast<float>(in[i]);
+    for (int s = 0; s < steps.count; s++)
+      value = ApplyFusedChainStep(steps.steps[s], value);
+    output[i] = value;
+  }
+}
+
+template <typename Input>
+class ExprImplGpuFusedChain : public ExprImplBase {
+ public:
+  void Execute(ExprImplContext &ctx, const std::vector<ExtendedTileDesc> &tiles,
+               TileRange range) override {
+    const auto &steps = dynamic_cast<const ExprFusedChain &>(*ctx.node).GetSteps();
+    kernels::DynamicScratchpad s({}, ctx.stream);
+    auto *tiles_pinned = s.ToPinned(make_span(tiles));
+    auto *tiles_gpu = s.ToGPU(ctx.stream, make_span(tiles_pinned, tiles.size()));
+    auto grid = GetGridLayout(kBlocksX, tiles.size());
+    auto block = dim3(kThreadNum, 1, 1);
+    ExecuteTiledFusedChain<Input><<<grid, block, 0, ctx.stream>>>(tiles_gpu, steps);
+  }
+
+ private:
+  static constexpr int kThreadNum = 256;
+  static constexpr int kBlocksX = 64;
+};
+
+std::unique_ptr<ExprImplBase> ExprImplFactoryGpuFusedChain(const ExprFusedChain &expr) {
+  std::unique_ptr<ExprImplBase> result;
+  TYPE_SWITCH(expr[0].GetTypeId(), type2id, Input, ARITHMETIC_ALLOWED_TYPES, (
+      result = std::make_unique<ExprImplGpuFusedChain<Input>>();
+  ), DALI_FAIL(make_string("Invalid type of the fused chain source: ", expr[0].GetTypeId())););  // NOLINT
+  return result;
+}
+
+}  // namespace dali
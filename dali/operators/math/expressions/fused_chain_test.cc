@@ -0,0 +1,118 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dali/operators/math/expressions/arithmetic.h"
+#include "dali/operators/math/expressions/fused_chain.h"
+
+namespace dali {
+
+namespace {
+
+std::unique_ptr<ExprNode> ParseWithTypes(const std::string &expr_str, DALIDataType input_type) {
+  auto expr = ParseExpressionString(expr_str);
+  HostWorkspace ws;
+  auto in = std::make_shared<TensorVector<CPUBackend>>();
+  in->Resize({{4}, {2}}, input_type);
+  ws.AddInput(in);
+  PropagateTypes<CPUBackend>(*expr, ws);
+  return expr;
+}
+
+const OpSpec &ConstantsSpec() {
+  static const OpSpec spec = OpSpec("ArithmeticGenericOp")
+                                 .AddArg("integer_constants", std::vector<int>{3, 5})
+                                 .AddArg("real_constants", std::vector<float>{0.5f, 2.f});
+  return spec;
+}
+
+}  // namespace
+
+TEST(FusedChainTest, FuseChain) {
+  // 5 - (x * 0.5 + 3) / 2, the int32 constants are used in float operations
+  auto expr = ParseWithTypes("sub($1:int32 div(add(mul(&0 $0:float32) $0:int32) $1:float32))",
+                             DALI_UINT8);
+  FuseScalarChains(expr, ConstantsSpec());
+
+  auto *fused = dynamic_cast<ExprFusedChain *>(expr.get());
+  ASSERT_NE(fused, nullptr);
+  EXPECT_EQ(fused->GetTypeId(), DALI_FLOAT);
+  ASSERT_EQ(fused->GetSubexpressionCount(), 1);
+  ASSERT_EQ((*fused)[0].GetNodeType(), NodeType::Tensor);
+  EXPECT_EQ((*fused)[0].GetTypeId(), DALI_UINT8);
+
+  auto &steps = fused->GetSteps();
+  ASSERT_EQ(steps.count, 4);
+  EXPECT_EQ(steps.steps[0].op, ArithmeticOp::mul);
+  EXPECT_FALSE(steps.steps[0].constant_on_left);
+  EXPECT_EQ(steps.steps[0].constant, 0.5f);
+  EXPECT_EQ(steps.steps[1].op, ArithmeticOp::add);
+  EXPECT_FALSE(steps.steps[1].constant_on_left);
+  EXPECT_EQ(steps.steps[1].constant, 3.f);
+  EXPECT_EQ(steps.steps[2].op, ArithmeticOp::div);
+  EXPECT_FALSE(steps.steps[2].constant_on_left);
+  EXPECT_EQ(steps.steps[2].constant, 2.f);
+  EXPECT_EQ(steps.steps[3].op, ArithmeticOp::sub);
+  EXPECT_TRUE(steps.steps[3].constant_on_left);
+  EXPECT_EQ(steps.steps[3].constant, 5.f);
+}
+
+TEST(FusedChainTest, KeepNonFloatNodes) {
+  // The integer addition is not a part of the chain, but its result is the source of the chain
+  auto expr = ParseWithTypes("mul(sub(add(&0 $0:int32) $0:float32) $1:float32)", DALI_INT32);
+  FuseScalarChains(expr, ConstantsSpec());
+
+  auto *fused = dynamic_cast<ExprFusedChain *>(expr.get());
+  ASSERT_NE(fused, nullptr);
+  EXPECT_EQ(fused->GetSteps().count, 2);
+  ASSERT_EQ((*fused)[0].GetNodeType(), NodeType::Function);
+  EXPECT_EQ((*fused)[0].GetFuncName(), "add");
+  EXPECT_EQ((*fused)[0].GetTypeId(), DALI_INT32);
+
+  // A single operation is left as it is
+  expr = ParseWithTypes("sin(mul(&0 $0:float32))", DALI_FLOAT);
+  FuseScalarChains(expr, ConstantsSpec());
+  EXPECT_EQ(expr->GetFuncName(), "sin");
+  auto &func = dynamic_cast<ExprFunc &>(*expr);
+  EXPECT_EQ(func[0].GetFuncName(), "mul");
+  EXPECT_EQ(dynamic_cast<ExprFusedChain *>(&func[0]), nullptr);
+
+  // Integer operations are not fused
+  expr = ParseWithTypes("mul(add(&0 $0:int32) $1:int32)", DALI_INT32);
+  FuseScalarChains(expr, ConstantsSpec());
+  EXPECT_EQ(expr->GetFuncName(), "mul");
+}
+
+TEST(FusedChainTest, SplitLongChain) {
+  std::string expr_str = "&0";
+  constexpr int kLength = FusedChainSteps::kMaxSteps + 3;
+  for (int i = 0; i < kLength; i++)
+    expr_str = "add(" + expr_str + " $0:float32)";
+  auto expr = ParseWithTypes(expr_str, DALI_FLOAT);
+  FuseScalarChains(expr, ConstantsSpec());
+
+  auto *fused = dynamic_cast<ExprFusedChain *>(expr.get());
+  ASSERT_NE(fused, nullptr);
+  EXPECT_EQ(fused->GetSteps().count, FusedChainSteps::kMaxSteps);
+  auto *rest = dynamic_cast<ExprFusedChain *>(&(*fused)[0]);
+  ASSERT_NE(rest, nullptr);
+  EXPECT_EQ(rest->GetSteps().count, kLength - FusedChainSteps::kMaxSteps);
+  EXPECT_EQ((*rest)[0].GetNodeType(), NodeType::Tensor);
+}
+
+}  // namespace dali
@@ -16,6 +16,7 @@
 #include "dali/core/math_util.h"
 #include "dali/core/tensor_layout.h"
 #include "dali/kernels/normalize/normalize_gpu.h"
+#include "dali/kernels/reduce/mean_inv_stddev_gpu.cuh"
 #include "dali/kernels/reduce/reduce_gpu.h"
 #include "dali/kernels/common/copy.h"
 
@@ -51,6 +52,11 @@ class Normalize<GPUBackend> : public NormalizeBase<GPUBackend> {
     return stddev_kernel_.create_or_get<InvStdDevGPU<ParamType, InputType>>();
   }
 
+  template <typename InputType>
+  MeanInvStdDevGPU<InputType> &GetMeanInvStdDevKernel() {
+    return mean_kernel_.create_or_get<MeanInvStdDevGPU<InputType>>();
+  }
+
   template <typename OutputType, typename InputType>
   NormalizeGPU<OutputType, InputType> &GetNormalizeKernel() {
     return normalize_kernel_.create_or_get<NormalizeGPU<OutputType, InputType>>();
@@ -59,7 +65,8 @@ class Normalize<GPUBackend> : public NormalizeBase<GPUBackend> {
   TensorListView<StorageGPU, float> BroadcastMean(KernelContext &ctx, float value) const;
 
   AnyKernelInstance mean_kernel_, stddev_kernel_, normalize_kernel_;
-  ScratchpadAllocator alloc_;
+  /// @brief If true, the mean and stddev are calculated together, reading the input once
+  bool fused_stats_ = false;
 };
 
 
@@ -67,43 +74,6 @@ DALI_REGISTER_OPERATOR(Normalize, Normalize<GPUBackend>, GPU);
 
 namespace {
 
-template <typename ToUpdate, typename Other>
-inline void MaxInPlace(ToUpdate &inout, const Other &other) {
-  auto b1 = dali::begin(inout);
-  auto b2 = dali::begin(other);
-  auto e1 = dali::end(inout);
-  auto e2 = dali::end(other);
-  for (; b1 != e1 && b2 != e2; b1++, b2++) {
-    if (*b1 < *b2) {
-      *b1 = *b2;
-    }
-  }
-}
-
-using scratch_sizes_t = dali::kernels::scratch_sizes_t;
-
-class ScratchpadSnapshot {
- public:
-  explicit ScratchpadSnapshot(PreallocatedScratchpad &scratch) : scratch_(scratch) {
-    for (size_t i = 0; i < ss_.size(); i++)
-      ss_[i] = scratch_.allocs[i].used();
-  }
-
-  ~ScratchpadSnapshot() {
-    restore();
-  }
-
- private:
-  void restore() {
-    scratch_.Clear();  // this doesn't clear the memory - just resets the usage counter to 0
-    for (size_t i = 0; i < ss_.size(); i++)
-      scratch_.allocs[i].alloc(ss_[i]);
-  }
-
-  scratch_sizes_t ss_;
-  PreallocatedScratchpad &scratch_;
-};
-
 template <int ndim>
 int64_t MaxSampleSize(const TensorListShape<ndim> &tls) {
   int64_t max_sample_size = 0;
@@ -150,59 +120,39 @@ void Normalize<GPUBackend>::SetupTyped(const DeviceWorkspace &ws) {
   KernelContext ctx;
   ctx.gpu.stream = ws.stream();
 
-  ScratchpadEstimator se;
-
-  int64_t param_volume = param_shape_.num_elements();
-
-  // estimate memory requirements for intermediate buffers
-
-  if (!has_scalar_mean_) {
-    se.add<mm::memory_kind::device, float>(param_volume);
-  } else {
-    if (ShouldCalcStdDev()) {
-      // StdDev kernel requires the mean to have the same shape as the output.
-      // We can save memory by broadcasting the mean only to the size of the largest sample
-      // and repeat the pointer for all samples.
-      se.add<mm::memory_kind::device, float>(MaxSampleSize(param_shape_));
-    }
-  }
-
-  if (!has_scalar_stddev_) {
-    se.add<mm::memory_kind::device, float>(param_volume);
-  }
-
-  // setup and get memory requirements from kernels
+  // The scratch memory is allocated dynamically when the kernels are run - only the kernels
+  // are set up here
 
   auto &norm = GetNormalizeKernel<OutputType, InputType>();
   // if stddev is calculated internally, it's already inverse
   bool scale_is_stddev = !ShouldCalcStdDev();
-  auto req = norm.Setup(ctx, data_shape_, make_span(axes_),
-                        has_scalar_mean_, has_scalar_stddev_, scale_is_stddev);
+  norm.Setup(ctx, data_shape_, make_span(axes_),
+             has_scalar_mean_, has_scalar_stddev_, scale_is_stddev);
+
+  fused_stats_ = ShouldCalcMean() && ShouldCalcStdDev() &&
+                 data_shape_.sample_dim() <= MeanInvStdDevGPU<InputType>::kMaxNDim;
+
+  if (fused_stats_) {
+    auto &stats = GetMeanInvStdDevKernel<InputType>();
+    auto stats_req = stats.Setup(ctx, data_shape_, make_span(axes_), batch_norm_);
+    assert(stats_req.output_shapes[0] == param_shape_);
+    (void)stats_req;
+    return;
+  }
 
   if (ShouldCalcMean()) {
     auto &mean = GetMeanKernel<float, InputType>();
     auto mean_req = mean.Setup(ctx, data_shape_, make_span(axes_), true, batch_norm_);
     assert(mean_req.output_shapes[0] == param_shape_);
-    MaxInPlace(req.scratch_sizes, mean_req.scratch_sizes);
+    (void)mean_req;
   }
 
   if (ShouldCalcStdDev()) {
     auto &stddev = GetInvStdDevKernel<float, InputType>();
     auto stddev_req = stddev.Setup(ctx, data_shape_, make_span(axes_), true, batch_norm_);
     assert(stddev_req.output_shapes[0] == param_shape_);
-    MaxInPlace(req.scratch_sizes, stddev_req.scratch_sizes);
+    (void)stddev_req;
   }
-
-  se.add<mm::memory_kind::host, char>(
-    req.scratch_sizes[static_cast<int>(mm::memory_kind_id::host)], 64);
-  se.add<mm::memory_kind::pinned, char>(
-    req.scratch_sizes[static_cast<int>(mm::memory_kind_id::pinned)], 64);
-  se.add<mm::memory_kind::device, char>(
-    req.scratch_sizes[static_cast<int>(mm::memory_kind_id::device)], 64);
-  se.add<mm::memory_kind::managed, char>(
-    req.scratch_sizes[static_cast<int>(mm::memory_kind_id::managed)], 64);
-
-  alloc_.Reserve(se.sizes);
 }
 
 template <typename OutputType, typename InputType>
@@ -240,7 +190,13 @@ void Normalize<GPUBackend>::RunTyped(DeviceWorkspace &ws) {
     stddev_gpu = buffer_scratchpad.AllocTensorList<mm::memory_kind::device, float>(param_shape_);
   }
 
-  if (ShouldCalcMean()) {
+  if (fused_stats_) {
+    DynamicScratchpad scratchpad({}, stream);
+    ctx.scratchpad = &scratchpad;
+    auto &stats_kernel = GetMeanInvStdDevKernel<InputType>();
+    stats_kernel.Run(ctx, mean_gpu, stddev_gpu, in_view, degrees_of_freedom_, epsilon_);
+    ctx.scratchpad = nullptr;
+  } else if (ShouldCalcMean()) {
     DynamicScratchpad scratchpad({}, stream);
     ctx.scratchpad = &scratchpad;
     auto &mean_kernel = GetMeanKernel<float, InputType>();
@@ -250,7 +206,7 @@ void Normalize<GPUBackend>::RunTyped(DeviceWorkspace &ws) {
     kernels::copy(mean_gpu, mean_input_, stream);
   }
 
-  if (ShouldCalcStdDev()) {
+  if (ShouldCalcStdDev() && !fused_stats_) {
     DynamicScratchpad scratchpad({}, stream);
     ctx.scratchpad = &scratchpad;
     auto &stddev_kernel = GetInvStdDevKernel<float, InputType>();
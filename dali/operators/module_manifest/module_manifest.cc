@@ -0,0 +1,47 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Writes the manifest of an operator module - the names of the schemas, which it registers.
+// The manifest lets the module be loaded only when one of its operators is used.
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include "dali/operators.h"
+#include "dali/pipeline/operator/op_schema.h"
+#include "dali/plugin/plugin_manager.h"
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s <module library> <manifest>\n", argv[0]);
+    return 1;
+  }
+  // the schemas of libdali_operators, which the module depends on, are not a part of the module
+  dali::InitOperatorsLib();
+  auto registered = dali::SchemaRegistry::RegisteredSchemas();
+  std::set<std::string> known(registered.begin(), registered.end());
+  try {
+    dali::PluginManager::LoadLibrary(argv[1]);
+  } catch (const std::exception &e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  std::ofstream manifest(argv[2]);
+  for (auto &name : dali::SchemaRegistry::RegisteredSchemas()) {
+    if (!known.count(name))
+      manifest << name << "\n";
+  }
+  return manifest ? 0 : 1;
+}
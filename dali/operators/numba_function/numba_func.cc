@@ -13,7 +13,9 @@
 // limitations under the License.
 
 
+#include <cuda.h>
 #include "dali/operators/numba_function/numba_func.h"
+#include "dali/core/dynlink_cuda.h"
 
 namespace dali {
 
@@ -94,6 +96,21 @@ A run function working per-sample may look like this:
         for i in range(in0.shape[0]):
             for j in range(in0.shape[1]):
                 out0[j, i] = in0[i, j]
+
+**GPU:**
+
+When the operator runs on the GPU (``device="gpu"``), the run function is compiled with
+``numba.cuda.jit`` as a CUDA kernel, where ``out0``, ``in0``... are device arrays, and it is launched
+on the pipeline's stream once per sample, with the ``blocks`` and ``threads_per_block`` launch
+configuration. The setup function, if provided, still runs on the CPU, as it only deals with
+the shapes. Batch processing is not supported on the GPU.
+
+.. code-block:: python
+
+    def run_fn(out0, in0):
+        i, j = numba.cuda.grid(2)
+        if i < in0.shape[0] and j < in0.shape[1]:
+            out0[j, i] = in0[i, j]
 )code")
   .NumInput(1, 6)
   .OutputFn([](const OpSpec &spec) { return spec.GetRepeatedArgument<int>("out_types").size(); })
@@ -117,7 +134,11 @@ separately for each sample in the batch.
 When ``batch_processing`` is set to ``True``, the function processes the whole batch. It is necessary if the
 function has to perform cross-sample operations and may be beneficial if significant part of the work can
 be reused. For other use cases, specifying False and using per-sample processing function allows the operator
-to process samples in parallel.)code", false);
+to process samples in parallel.)code", false)
+  .AddOptionalArg("blocks", R"code(Number of blocks of the grid, in 3 dimensions, used to launch the kernel
+of every sample when the operator runs on the GPU.)code", std::vector<int>())
+  .AddOptionalArg("threads_per_block", R"code(Number of threads of every block, in 3 dimensions,
+used to launch the kernel of every sample when the operator runs on the GPU.)code", std::vector<int>());
 
 DALI_SCHEMA(NumbaFuncImpl)
   .DocStr("")
@@ -136,7 +157,11 @@ DALI_SCHEMA(NumbaFuncImpl)
   .AddOptionalArg<int>("setup_fn", R"code(Address of setup function setting shapes for outputs.
 This function is invoked once per batch.)code", 0)
   .AddOptionalArg("batch_processing", R"code(Determines whether the function is invoked once per batch or
-separately for each sample in the batch.)code", false);
+separately for each sample in the batch.)code", false)
+  .AddOptionalArg("blocks", R"code(Grid dimensions of the kernel launched for every sample (GPU only).)code",
+                  std::vector<int>())
+  .AddOptionalArg("threads_per_block", R"code(Block dimensions of the kernel launched for every sample
+(GPU only).)code", std::vector<int>());
 
 template <typename Backend>
 NumbaFuncImpl<Backend>::NumbaFuncImpl(const OpSpec &spec) : Base(spec) {
@@ -174,11 +199,23 @@ NumbaFuncImpl<Backend>::NumbaFuncImpl(const OpSpec &spec) : Base(spec) {
       "All dimensions should be non negative. Value specified in "
       "`ins_ndim` at index ", i, " is negative."));
   }
+
+  if (std::is_same<Backend, GPUBackend>::value) {
+    DALI_ENFORCE(!batch_processing_, "Batch processing is not supported on the GPU.");
+    blocks_ = spec.GetRepeatedArgument<int>("blocks");
+    threads_per_block_ = spec.GetRepeatedArgument<int>("threads_per_block");
+    DALI_ENFORCE(blocks_.size() == 3 && threads_per_block_.size() == 3,
+      "`blocks` and `threads_per_block` must have 3 elements each when running on the GPU.");
+    for (int d = 0; d < 3; d++) {
+      DALI_ENFORCE(blocks_[d] > 0 && threads_per_block_[d] > 0,
+        "The launch configuration given by `blocks` and `threads_per_block` must be positive.");
+    }
+  }
 }
 
-template <>
-bool NumbaFuncImpl<CPUBackend>::SetupImpl(std::vector<OutputDesc> &output_desc,
-    const workspace_t<CPUBackend> &ws) {
+template <typename Backend>
+bool NumbaFuncImpl<Backend>::SetupImpl(std::vector<OutputDesc> &output_desc,
+    const workspace_t<Backend> &ws) {
   int ninputs = ws.NumInput();
   int noutputs = out_types_.size();
   DALI_ENFORCE(in_types_.size() == static_cast<size_t>(ninputs), make_string(
@@ -189,7 +226,7 @@ bool NumbaFuncImpl<CPUBackend>::SetupImpl(std::vector<OutputDesc> &output_desc,
   output_desc.resize(out_types_.size());
   in_shapes_.resize(ninputs);
   for (int in_id = 0; in_id < ninputs; in_id++) {
-    auto& in = ws.Input<CPUBackend>(in_id);
+    auto& in = ws.template Input<Backend>(in_id);
     in_shapes_[in_id] = in.shape();
     DALI_ENFORCE(in_shapes_[in_id].sample_dim() == ins_ndim_[in_id], make_string(
       "Number of dimensions passed in `ins_ndim` at index ", in_id,
@@ -210,7 +247,7 @@ bool NumbaFuncImpl<CPUBackend>::SetupImpl(std::vector<OutputDesc> &output_desc,
 
   if (!setup_fn_) {
     for (int i = 0; i < noutputs; i++) {
-      const auto &in = ws.Input<CPUBackend>(i);
+      const auto &in = ws.template Input<Backend>(i);
       output_desc[i] = {in.shape(), in.type()};
     }
     return true;
@@ -315,7 +352,52 @@ void NumbaFuncImpl<CPUBackend>::RunImpl(workspace_t<CPUBackend> &ws) {
   tp.RunAll();
 }
 
+template <typename Backend>
+void NumbaFuncImpl<Backend>::AppendArrayArg(const void *data, TensorShape<> shape,
+                                            DALIDataType type) {
+  int64_t item_size = TypeTable::GetTypeInfo(type).size();
+  kernel_arg_values_.push_back(0);  // meminfo
+  kernel_arg_values_.push_back(0);  // parent
+  kernel_arg_values_.push_back(volume(shape));
+  kernel_arg_values_.push_back(item_size);
+  kernel_arg_values_.push_back(reinterpret_cast<int64_t>(data));
+  for (int d = 0; d < shape.size(); d++)
+    kernel_arg_values_.push_back(shape[d]);
+  int64_t stride = item_size;
+  size_t strides_offset = kernel_arg_values_.size();
+  kernel_arg_values_.resize(strides_offset + shape.size());
+  for (int d = shape.size() - 1; d >= 0; d--) {
+    kernel_arg_values_[strides_offset + d] = stride;
+    stride *= shape[d];
+  }
+}
+
+template <>
+void NumbaFuncImpl<GPUBackend>::RunImpl(workspace_t<GPUBackend> &ws) {
+  auto N = ws.Input<GPUBackend>(0).shape().num_samples();
+  auto kernel = reinterpret_cast<CUfunction>(run_fn_);
+  for (int sample_id = 0; sample_id < N; sample_id++) {
+    kernel_arg_values_.clear();
+    for (size_t out_id = 0; out_id < out_types_.size(); out_id++) {
+      auto &out = ws.Output<GPUBackend>(out_id);
+      AppendArrayArg(out.raw_mutable_tensor(sample_id), out.shape()[sample_id], out.type());
+    }
+    for (size_t in_id = 0; in_id < in_types_.size(); in_id++) {
+      auto &in = ws.Input<GPUBackend>(in_id);
+      AppendArrayArg(in.raw_tensor(sample_id), in.shape()[sample_id], in.type());
+    }
+    // the parameters are copied by cuLaunchKernel, so the storage can be reused for the next one
+    kernel_args_.resize(kernel_arg_values_.size());
+    for (size_t i = 0; i < kernel_args_.size(); i++)
+      kernel_args_[i] = &kernel_arg_values_[i];
+    CUDA_CALL(cuLaunchKernel(kernel, blocks_[0], blocks_[1], blocks_[2],
+                             threads_per_block_[0], threads_per_block_[1], threads_per_block_[2],
+                             0, ws.stream(), kernel_args_.data(), nullptr));
+  }
+}
+
 DALI_REGISTER_OPERATOR(NumbaFuncImpl, NumbaFuncImpl<CPUBackend>, CPU);
+DALI_REGISTER_OPERATOR(NumbaFuncImpl, NumbaFuncImpl<GPUBackend>, GPU);
 
 }  // namespace dali
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -39,6 +39,12 @@ class NumbaFuncImpl : public Operator<Backend> {
  private:
   using NumbaPtr = uint64_t;
 
+  /**
+   * @brief Appends the kernel parameters of a C-contiguous array argument, the way Numba
+   *        flattens them when launching a CUDA kernel
+   */
+  void AppendArrayArg(const void *data, TensorShape<> shape, DALIDataType type);
+
   NumbaPtr run_fn_;
   NumbaPtr setup_fn_;
   bool batch_processing_;
@@ -50,6 +56,12 @@ class NumbaFuncImpl : public Operator<Backend> {
   std::vector<uint64_t> input_shape_ptrs_;
   vector<TensorListShape<-1>> in_shapes_;
   vector<TensorListShape<-1>> out_shapes_;
+
+  // GPU only: the launch configuration and the storage of the kernel parameters
+  SmallVector<int, 3> blocks_;
+  SmallVector<int, 3> threads_per_block_;
+  std::vector<int64_t> kernel_arg_values_;
+  std::vector<void *> kernel_args_;
 };
 
 
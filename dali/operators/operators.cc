@@ -12,10 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <dlfcn.h>
+#include <string>
 #include "dali/core/api_helper.h"
 #include "dali/operators.h"
 #include "dali/operators/util/npp.h"
 #include "dali/core/cuda_stream_pool.h"
+#include "dali/plugin/plugin_manager.h"
 
 #if DALI_USE_NVJPEG
   #include "dali/operators/decoder/nvjpeg/nvjpeg_helper.h"
@@ -31,6 +34,27 @@
 
 namespace dali {
 
+namespace {
+
+/**
+ * @brief Registers the operator modules, which accompany this library
+ *
+ * The operators built as separate modules are loaded only when a pipeline uses them.
+ */
+int DiscoverOperatorModules() {
+  Dl_info info;
+  if (!dladdr(reinterpret_cast<void *>(&DiscoverOperatorModules), &info) || !info.dli_fname)
+    return 0;
+  std::string lib_path = info.dli_fname;
+  auto sep = lib_path.rfind('/');
+  PluginManager::DiscoverOperatorModules(sep == std::string::npos ? "." : lib_path.substr(0, sep));
+  return 0;
+}
+
+int operator_modules_discovered = DiscoverOperatorModules();
+
+}  // namespace
+
 DLL_PUBLIC void InitOperatorsLib() {
   (void)CUDAStreamPool::instance();
 }
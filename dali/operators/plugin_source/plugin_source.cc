@@ -0,0 +1,115 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+#include "dali/operators/plugin_source/plugin_source.h"
+
+namespace dali {
+
+DALI_SCHEMA(PluginSource)
+  .DocStr(R"code(Produces the batches with a source provider implemented in a plugin library.
+
+The provider is a table of C functions (see ``dali/plugin/source_provider.h``), registered
+under a name when the plugin library is loaded with
+:func:`nvidia.dali.plugin_manager.load_library`. The operator asks the provider for the shapes
+of the samples of each iteration and then has the provider write the samples, in parallel on
+the threads of the pipeline, directly to the preallocated output batch.
+
+Unlike the Python ``external_source``, the user code is neither bound by the GIL nor requires
+serialization of the data between processes, so that it does not take a full custom operator
+to read a custom data format at native speed.)code")
+  .NumInput(0)
+  .NumOutput(1)
+  .AddArg("provider",
+          "The name under which the source provider was registered.",
+          DALI_STRING)
+  .AddOptionalArg("config",
+                  "Configuration of the provider, passed verbatim to its ``create`` function.",
+                  std::string());
+
+PluginSource::PluginSource(const OpSpec &spec)
+    : Operator<CPUBackend>(spec), provider_name_(spec.GetArgument<std::string>("provider")) {
+  provider_ = daliGetSourceProvider(provider_name_.c_str());
+  DALI_ENFORCE(provider_ != nullptr, make_string("No source provider is registered as \"",
+               provider_name_, "\". Make sure that the plugin library implementing it is loaded."));
+  state_ = provider_->create(spec.GetArgument<std::string>("config").c_str());
+  DALI_ENFORCE(state_ != nullptr, make_string("Source provider \"", provider_name_,
+                                              "\" failed to create its state."));
+  try {
+    dali_data_type_t dtype = ::DALI_NO_TYPE;
+    CheckStatus(provider_->get_output_desc(state_, &dtype, &ndim_), "describe the output");
+    dtype_ = static_cast<DALIDataType>(dtype);
+    DALI_ENFORCE(IsValidType(dtype_) && TypeTable::TryGetTypeInfo(dtype_) != nullptr,
+                 make_string("Source provider \"", provider_name_,
+                             "\" reported an invalid output type: ", static_cast<int>(dtype)));
+    DALI_ENFORCE(ndim_ >= 0, make_string("Source provider \"", provider_name_,
+                                         "\" reported a negative number of dimensions."));
+  } catch (...) {
+    provider_->destroy(state_);
+    throw;
+  }
+  shapes_.resize(static_cast<size_t>(max_batch_size_) * ndim_);
+}
+
+PluginSource::~PluginSource() {
+  provider_->destroy(state_);
+}
+
+void PluginSource::CheckStatus(int status, const char *what) const {
+  DALI_ENFORCE(status == 0, make_string("Source provider \"", provider_name_, "\" failed to ",
+                                        what, " in iteration ", iteration_, " (status ", status,
+                                        ")."));
+}
+
+bool PluginSource::SetupImpl(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) {
+  int batch_size = max_batch_size_;
+  CheckStatus(provider_->prepare_batch(state_, iteration_, &batch_size, shapes_.data()),
+              "prepare the batch");
+  DALI_ENFORCE(batch_size >= 0 && batch_size <= max_batch_size_,
+               make_string("Source provider \"", provider_name_, "\" set the batch size to ",
+                           batch_size, ", which is not in the range [0, ", max_batch_size_,
+                           "]."));
+  auto shapes_end = shapes_.begin() + static_cast<size_t>(batch_size) * ndim_;
+  for (auto it = shapes_.begin(); it != shapes_end; ++it)
+    DALI_ENFORCE(*it >= 0, make_string("Source provider \"", provider_name_,
+                                       "\" reported a negative extent: ", *it));
+  output_desc.resize(1);
+  output_desc[0].type = dtype_;
+  output_desc[0].shape =
+      TensorListShape<>(std::vector<int64_t>(shapes_.begin(), shapes_end), batch_size, ndim_);
+  return true;
+}
+
+void PluginSource::RunImpl(HostWorkspace &ws) {
+  auto &output = ws.Output<CPUBackend>(0);
+  auto &tp = ws.GetThreadPool();
+  const auto &shape = output.shape();
+  int nsamples = shape.num_samples();
+  sample_status_.assign(nsamples, 0);
+  for (int i = 0; i < nsamples; i++) {
+    tp.AddWork([&, i](int tid) {
+      sample_status_[i] =
+          provider_->produce_sample(state_, iteration_, i, output.raw_mutable_tensor(i), tid);
+    }, shape.tensor_size(i));
+  }
+  tp.RunAll();
+  for (int i = 0; i < nsamples; i++)
+    CheckStatus(sample_status_[i], make_string("produce sample ", i).c_str());
+  iteration_++;
+}
+
+DALI_REGISTER_OPERATOR(PluginSource, PluginSource, CPU);
+
+}  // namespace dali
@@ -0,0 +1,59 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_PLUGIN_SOURCE_PLUGIN_SOURCE_H_
+#define DALI_OPERATORS_PLUGIN_SOURCE_PLUGIN_SOURCE_H_
+
+#include <string>
+#include <vector>
+#include "dali/pipeline/operator/operator.h"
+#include "dali/plugin/source_provider.h"
+
+namespace dali {
+
+/**
+ * @brief Produces the batches with a source provider registered by a plugin library
+ *
+ * @see daliSourceProvider
+ */
+class PluginSource : public Operator<CPUBackend> {
+ public:
+  explicit PluginSource(const OpSpec &spec);
+  ~PluginSource() override;
+
+  DISABLE_COPY_MOVE_ASSIGN(PluginSource);
+
+ protected:
+  bool CanInferOutputs() const override { return true; }
+
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) override;
+
+  void RunImpl(HostWorkspace &ws) override;
+
+ private:
+  void CheckStatus(int status, const char *what) const;
+
+  std::string provider_name_;
+  const daliSourceProvider *provider_ = nullptr;
+  void *state_ = nullptr;
+  DALIDataType dtype_ = DALI_NO_TYPE;
+  int ndim_ = 0;
+  int64_t iteration_ = 0;
+  std::vector<int64_t> shapes_;
+  std::vector<int> sample_status_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_PLUGIN_SOURCE_PLUGIN_SOURCE_H_
@@ -0,0 +1,129 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "dali/pipeline/data/views.h"
+#include "dali/pipeline/pipeline.h"
+#include "dali/plugin/source_provider.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * The sample `i` of iteration `n` has the shape {i + 1, 2} and is filled with n * 100 + i.
+ * The samples of the batch given in the config fail to be produced.
+ */
+struct CountingSource {
+  int64_t failing_iteration = -1;
+};
+
+const daliSourceProvider counting_source_provider = {
+  DALI_SOURCE_PROVIDER_ABI_VERSION,
+  [](const char *config) -> void * {
+    auto *src = new CountingSource();
+    if (*config)
+      src->failing_iteration = std::stoll(config);
+    return src;
+  },
+  [](void *state) {
+    delete static_cast<CountingSource *>(state);
+  },
+  [](void *, dali_data_type_t *dtype, int *ndim) {
+    *dtype = ::DALI_INT32;
+    *ndim = 2;
+    return 0;
+  },
+  [](void *, int64_t, int *batch_size, int64_t *shapes) {
+    *batch_size -= 1;
+    for (int i = 0; i < *batch_size; i++) {
+      shapes[2 * i] = i + 1;
+      shapes[2 * i + 1] = 2;
+    }
+    return 0;
+  },
+  [](void *state, int64_t iteration, int sample_idx, void *data, int) {
+    if (static_cast<CountingSource *>(state)->failing_iteration == iteration)
+      return 42;
+    auto *out = static_cast<int32_t *>(data);
+    for (int j = 0; j < (sample_idx + 1) * 2; j++)
+      out[j] = iteration * 100 + sample_idx;
+    return 0;
+  }
+};
+
+DALI_REGISTER_SOURCE_PROVIDER("counting_source", counting_source_provider);
+
+std::unique_ptr<Pipeline> MakePipeline(int batch_size, const std::string &provider,
+                                       const std::string &config = "") {
+  auto pipe = std::make_unique<Pipeline>(batch_size, 3, CPU_ONLY_DEVICE_ID);
+  pipe->AddOperator(OpSpec("PluginSource")
+                        .AddArg("device", "cpu")
+                        .AddArg("provider", provider)
+                        .AddArg("config", config)
+                        .AddOutput("out", "cpu"));
+  std::vector<std::pair<std::string, std::string>> outputs = {{"out", "cpu"}};
+  pipe->Build(outputs);
+  return pipe;
+}
+
+}  // namespace
+
+TEST(PluginSourceTest, ProduceSamples) {
+  const int batch_size = 5;
+  auto pipe = MakePipeline(batch_size, "counting_source");
+  for (int iter = 0; iter < 3; iter++) {
+    DeviceWorkspace ws;
+    pipe->RunCPU();
+    pipe->RunGPU();
+    pipe->Outputs(&ws);
+    auto out = view<const int32_t>(ws.Output<CPUBackend>(0));
+    ASSERT_EQ(out.num_samples(), batch_size - 1);
+    for (int i = 0; i < out.num_samples(); i++) {
+      ASSERT_EQ(out.tensor_shape(i), TensorShape<>(i + 1, 2));
+      for (int j = 0; j < (i + 1) * 2; j++)
+        EXPECT_EQ(out.data[i][j], iter * 100 + i);
+    }
+  }
+}
+
+TEST(PluginSourceTest, SampleFailure) {
+  auto pipe = MakePipeline(4, "counting_source", "1");
+  DeviceWorkspace ws;
+  pipe->RunCPU();
+  pipe->RunGPU();
+  EXPECT_NO_THROW(pipe->Outputs(&ws));
+  pipe->RunCPU();
+  pipe->RunGPU();
+  EXPECT_THROW(pipe->Outputs(&ws), std::runtime_error);
+}
+
+TEST(PluginSourceTest, UnknownProvider) {
+  EXPECT_THROW(MakePipeline(4, "no_such_provider"), std::runtime_error);
+}
+
+TEST(PluginSourceTest, RegisterProvider) {
+  EXPECT_EQ(daliGetSourceProvider("counting_source"), &counting_source_provider);
+  EXPECT_EQ(daliRegisterSourceProvider("counting_source", &counting_source_provider), 0);
+  daliSourceProvider other = counting_source_provider;
+  EXPECT_NE(daliRegisterSourceProvider("counting_source", &other), 0);
+  other.abi_version = DALI_SOURCE_PROVIDER_ABI_VERSION + 1;
+  EXPECT_NE(daliRegisterSourceProvider("other_source", &other), 0);
+  EXPECT_EQ(daliGetSourceProvider("other_source"), nullptr);
+}
+
+}  // namespace dali
@@ -35,6 +35,7 @@ This argument can be a list that contains a distinct layout for each output. If
 fewer than num_outputs elements, only the first outputs have the layout set and the rest of the
 outputs have no layout assigned.)code", nullptr)
     .NoPrune()
+    .NoParallelConstruction()
     .Unserializable()
     .MakeInternal();
 
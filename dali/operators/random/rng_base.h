@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,15 +16,41 @@
 #define DALI_OPERATORS_RANDOM_RNG_BASE_H_
 
 #include <random>
+#include <string>
 #include <vector>
 #include "dali/core/convert.h"
+#include "dali/pipeline/operator/checkpointing.h"
 #include "dali/pipeline/operator/operator.h"
-#include "dali/pipeline/util/batch_rng.h"
 #include "dali/core/static_switch.h"
+#include "dali/operators/util/philox.h"
 #include "dali/operators/util/randomizer.cuh"
 
 namespace dali {
 
+namespace detail {
+
+inline uint64_t splitmix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Returns the key of the Philox streams used for a sample in a given iteration
+ *
+ * The generated numbers depend only on the seed, the iteration, the sample index and the
+ * position within the sample, so they don't depend on the number of threads or on how the work
+ * is split, and any iteration can be reproduced without replaying the previous ones.
+ */
+inline uint64_t RNGSampleKey(int64_t seed, int64_t iteration, int sample) {
+  uint64_t key = detail::splitmix64(static_cast<uint64_t>(seed));
+  key = detail::splitmix64(key ^ static_cast<uint64_t>(iteration));
+  return detail::splitmix64(key ^ static_cast<uint64_t>(sample));
+}
+
 template <typename Backend, bool IsNoiseGen>
 struct RNGBaseFields;
 
@@ -33,8 +59,8 @@ class RNGBase : public Operator<Backend> {
  protected:
   explicit RNGBase(const OpSpec &spec)
       : Operator<Backend>(spec),
-        rng_(spec.GetArgument<int64_t>("seed"), max_batch_size_),
-        backend_data_(spec.GetArgument<int64_t>("seed"), max_batch_size_) {
+        seed_(spec.GetArgument<int64_t>("seed")),
+        backend_data_(max_batch_size_) {
   }
 
   Impl &This() noexcept { return static_cast<Impl&>(*this); }
@@ -44,6 +70,18 @@ class RNGBase : public Operator<Backend> {
     return true;
   }
 
+  std::string SaveState() override {
+    std::string state;
+    AppendOpState(state, iteration_);
+    return state;
+  }
+
+  void RestoreState(const std::string &state) override {
+    size_t offset = 0;
+    ReadOpState(iteration_, state, offset);
+    CheckOpStateEnd(state, offset);
+  }
+
   int GetBatchSize(const workspace_t<Backend> &ws) const {
     if (spec_.NumRegularInput() == 1)
       return ws.template Input<Backend>(0).shape().size();
@@ -106,7 +144,9 @@ class RNGBase : public Operator<Backend> {
   using Operator<Backend>::max_batch_size_;
 
   DALIDataType dtype_ = DALI_NO_TYPE;
-  BatchRNG<std::mt19937_64> rng_;
+  int64_t seed_;
+  /// Number of the current iteration; together with the seed, it's all the state of the generators
+  int64_t iteration_ = 0;
   TensorListShape<> shape_;
   RNGBaseFields<Backend, IsNoiseGen> backend_data_;
 };
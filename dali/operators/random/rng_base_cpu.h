@@ -21,14 +21,13 @@
 #include "dali/operators/random/rng_base.h"
 #include "dali/core/convert.h"
 #include "dali/pipeline/operator/operator.h"
-#include "dali/pipeline/util/batch_rng.h"
 #include "dali/core/static_switch.h"
 
 namespace dali {
 
 template <bool IsNoiseGen>
 struct RNGBaseFields<CPUBackend, IsNoiseGen> {
-  RNGBaseFields(int64_t seed, int nsamples) {}
+  explicit RNGBaseFields(int nsamples) {}
 
   std::vector<uint8_t> dists_cpu_;
 };
@@ -111,7 +110,7 @@ void RNGBase<Backend, Impl, IsNoiseGen>::RunImplTyped(workspace_t<CPUBackend> &w
   auto &tp = ws.GetThreadPool();
   constexpr int64_t kThreshold = 1 << 18;
   constexpr int64_t kChunkSize = 1 << 16;
-  constexpr size_t kNumChunkSeeds = 16;
+  int64_t iteration = iteration_++;
   int nsamples = output.shape().size();
   int ndim = output.shape().sample_dim();
 
@@ -160,39 +159,24 @@ void RNGBase<Backend, Impl, IsNoiseGen>::RunImplTyped(workspace_t<CPUBackend> &w
       p_stride = channel_dim == 0 ? 1 : nchannels;
     }
 
-    if (total_p_count < kThreshold) {
+    // Each chunk of the sample draws from its own Philox stream
+    uint64_t key = RNGSampleKey(seed_, iteration, sample_id);
+    int chunks = total_p_count < kThreshold ? 1 : div_ceil(total_p_count, kChunkSize);
+    for (int c = 0; c < chunks; c++) {
+      int64_t p_offset, p_count;
+      std::tie(p_offset, p_count) = get_chunk<T>(total_p_count, c, chunks);
       tp.AddWork(
         [=](int thread_id) {
+          Philox4x32_10 chunk_rng(key, c, 0);
           auto dist = use_default_dist ? Dist() : dists[sample_id];
           if (independent_channels) {
-            dist_gen_.template gen<T>(out_span, in_span, dist, rng_[sample_id], 0, total_p_count);
+            dist_gen_.template gen<T>(out_span, in_span, dist, chunk_rng,
+                                      p_offset, p_count);
           } else {
-            dist_gen_.template gen_all_channels<T>(out_span, in_span, dist, rng_[sample_id], 0,
-                                                   total_p_count, nchannels, c_stride, p_stride);
+            dist_gen_.template gen_all_channels<T>(out_span, in_span, dist, chunk_rng, p_offset,
+                                                   p_count, nchannels, c_stride, p_stride);
           }
-        }, total_p_count);
-    } else {
-      int chunks = div_ceil(total_p_count, kChunkSize);
-      std::array<uint32_t, kNumChunkSeeds> seed;
-      for (int c = 0; c < chunks; c++) {
-        int64_t p_offset, p_count;
-        std::tie(p_offset, p_count) = get_chunk<T>(total_p_count, c, chunks);
-        for (auto &s : seed)
-          s = rng_[sample_id]();
-        tp.AddWork(
-          [=](int thread_id) {
-            std::seed_seq seq(seed.begin(), seed.end());
-            std::mt19937_64 chunk_rng(seq);
-            auto dist = use_default_dist ? Dist() : dists[sample_id];
-            if (independent_channels) {
-              dist_gen_.template gen<T>(out_span, in_span, dist, chunk_rng,
-                                        p_offset, p_count);
-            } else {
-              dist_gen_.template gen_all_channels<T>(out_span, in_span, dist, chunk_rng, p_offset,
-                                                     p_count, nchannels, c_stride, p_stride);
-            }
-          }, p_count);
-      }
+        }, p_count);
     }
   }
   tp.RunAll();
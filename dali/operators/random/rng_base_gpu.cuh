@@ -20,7 +20,6 @@
 #include "dali/core/convert.h"
 #include "dali/operators/random/rng_base_gpu.h"
 #include "dali/pipeline/operator/operator.h"
-#include "dali/pipeline/util/batch_rng.h"
 #include "dali/core/static_switch.h"
 #include "dali/kernels/dynamic_scratchpad.h"
 
@@ -31,17 +30,30 @@ namespace {
 template <bool value>
 using bool_const = std::integral_constant<bool, value>;
 
+/**
+ * @brief Initializes the generator of the element `idx` of a sample
+ *
+ * Each element draws from its own Philox stream, so the results don't depend on how the
+ * elements are distributed among the blocks and threads.
+ */
+__device__ __forceinline__ void InitElementRNG(curandStatePhilox4_32_10_t *state,
+                                               const SampleDesc &sample, int64_t idx) {
+  curand_init(sample.rng_key, idx, 0, state);
+}
+
 template <typename T, typename Dist>
 __device__ __inline__ void Generate(const SampleDesc &sample,
                                     const BlockDesc &block,
                                     Dist& dist,
-                                    curandState* __restrict__ rng,
                                     bool_const<true>,     // is_noise_gen
                                     bool_const<true>) {   // is_per_channel
   auto out = static_cast<T*>(sample.output);
   auto in = static_cast<const T*>(sample.input);
   auto idx_end = block.p_offset + block.p_count;
   for (auto idx = block.p_offset + threadIdx.x; idx < idx_end; idx += blockDim.x) {
+    curandStatePhilox4_32_10_t state;
+    InitElementRNG(&state, sample, idx);
+    auto *rng = &state;
     auto n = dist.Generate(in[idx], rng);
     dist.Apply(out[idx], in[idx], n);
   }
@@ -51,13 +63,15 @@ template <typename T, typename Dist>
 __device__ __inline__ void Generate(const SampleDesc &sample,
                                     const BlockDesc &block,
                                     Dist& dist,
-                                    curandState* __restrict__ rng,
                                     bool_const<true>,     // is_noise_gen
                                     bool_const<false>) {  // is_per_channel
   auto out = static_cast<T*>(sample.output);
   auto in = static_cast<const T*>(sample.input);
   auto idx_end = block.p_offset + block.p_count;
   for (auto idx = block.p_offset + threadIdx.x; idx < idx_end; idx += blockDim.x) {
+    curandStatePhilox4_32_10_t state;
+    InitElementRNG(&state, sample, idx);
+    auto *rng = &state;
     int64_t pos = idx * sample.p_stride;
     // Implementations that generate noise once for all channels should not depend on the input
     // to generate the number.
@@ -72,12 +86,14 @@ template <typename T, typename Dist>
 __device__ __inline__ void Generate(const SampleDesc &sample,
                                     const BlockDesc &block,
                                     Dist& dist,
-                                    curandState* __restrict__ rng,
                                     bool_const<false>,     // is_noise_gen
                                     bool_const<true>) {    // is_per_channel
   auto out = static_cast<T*>(sample.output);
   auto idx_end = block.p_offset + block.p_count;
   for (auto idx = block.p_offset + threadIdx.x; idx < idx_end; idx += blockDim.x) {
+    curandStatePhilox4_32_10_t state;
+    InitElementRNG(&state, sample, idx);
+    auto *rng = &state;
     auto n = dist.Generate(rng);
     out[idx] = ConvertSat<T>(n);
   }
@@ -87,12 +103,14 @@ template <typename T, typename Dist>
 __device__ __inline__ void Generate(const SampleDesc &sample,
                                     const BlockDesc &block,
                                     Dist& dist,
-                                    curandState* __restrict__ rng,
                                     bool_const<false>,      // is_noise_gen
                                     bool_const<false>) {    // is_per_channel
   auto out = static_cast<T*>(sample.output);
   auto idx_end = block.p_offset + block.p_count;
   for (auto idx = block.p_offset + threadIdx.x; idx < idx_end; idx += blockDim.x) {
+    curandStatePhilox4_32_10_t state;
+    InitElementRNG(&state, sample, idx);
+    auto *rng = &state;
     int64_t pos = idx * sample.p_stride;
     auto n = dist.Generate(rng);
     for (int c = 0; c < sample.c_count; c++, pos += sample.c_stride) {
@@ -104,19 +122,14 @@ __device__ __inline__ void Generate(const SampleDesc &sample,
 template <typename T, typename Dist, bool DefaultDist, bool IsNoiseGen, bool IsPerChannel>
 __global__ void RNGKernel(SampleDesc* __restrict__ sample_descs,
                           BlockDesc* __restrict__ block_descs,
-                          curandState* __restrict__ states,
                           const Dist* __restrict__ dists, int nblocks) {
-  int block_size = blockDim.x * blockDim.y;
-  int local_tid = blockDim.x * threadIdx.y + threadIdx.x;
-  int64_t global_tid = blockIdx.y * block_size + local_tid;
-  auto rng = states + global_tid;
   int blk_stride = blockDim.y * gridDim.y;
   int blk = blockIdx.y * blockDim.y + threadIdx.y;
   for (; blk < nblocks; blk += blk_stride) {
     auto block = block_descs[blk];
     auto sample = sample_descs[block.sample_idx];
     Dist dist = DefaultDist ? Dist() : dists[block.sample_idx];
-    Generate<T, Dist>(sample, block, dist, rng,
+    Generate<T, Dist>(sample, block, dist,
                       bool_const<IsNoiseGen>(), bool_const<IsPerChannel>());
   }
 }
@@ -128,7 +141,7 @@ template <typename T, typename Dist>
 void RNGBase<Backend, Impl, IsNoiseGen>::RunImplTyped(workspace_t<GPUBackend> &ws) {
   static_assert(std::is_same<Backend, GPUBackend>::value, "Unexpected backend");
   auto &output = ws.template Output<GPUBackend>(0);
-  auto rngs = backend_data_.randomizer_.states();
+  int64_t iteration = iteration_++;
   int block_sz = backend_data_.block_size_;
   int max_nblocks = backend_data_.max_blocks_;
   int blockdesc_count = -1;
@@ -159,6 +172,8 @@ void RNGBase<Backend, Impl, IsNoiseGen>::RunImplTyped(workspace_t<GPUBackend> &w
   auto &samples_cpu = backend_data_.sample_descs_cpu_;
   samples_cpu.resize(nsamples);
   SetupSampleDescs(samples_cpu.data(), out_view, in_view, channel_dim);
+  for (int s = 0; s < nsamples; s++)
+    samples_cpu[s].rng_key = RNGSampleKey(seed_, iteration, s);
 
   auto &blocks_cpu = backend_data_.block_descs_cpu_;
   blocks_cpu.resize(max_nblocks);
@@ -203,7 +218,7 @@ void RNGBase<Backend, Impl, IsNoiseGen>::RunImplTyped(workspace_t<GPUBackend> &w
     VALUE_SWITCH(independent_channels ? 1 : 0, IsPerChannel, (false, true), (
       RNGKernel<T, Dist, DefaultDist, IsNoiseGen, IsPerChannel>
         <<<gridDim, blockDim, 0, ws.stream()>>>(samples_gpu, blocks_gpu,
-                                                rngs, dists_gpu, blockdesc_count);
+                                                dists_gpu, blockdesc_count);
     ), ());  // NOLINT
   ), ());  // NOLINT
   CUDA_CALL(cudaGetLastError());
@@ -22,7 +22,6 @@
 #include "dali/core/span.h"
 #include "dali/operators/random/rng_base.h"
 #include "dali/pipeline/operator/operator.h"
-#include "dali/pipeline/util/batch_rng.h"
 #include "dali/core/static_switch.h"
 
 namespace dali {
@@ -30,6 +29,7 @@ namespace dali {
 struct SampleDesc {
   void *output;
   const void* input;
+  uint64_t rng_key;
   int64_t p_count;
   int64_t p_stride;
   int64_t c_count;
@@ -44,21 +44,19 @@ struct BlockDesc {
 
 template <bool IsNoiseGen>
 struct RNGBaseFields<GPUBackend, IsNoiseGen> {
-  RNGBaseFields<GPUBackend, IsNoiseGen>(int64_t seed, int max_batch_size,
-                                        int64_t static_sample_size = -1)
+  explicit RNGBaseFields<GPUBackend, IsNoiseGen>(int max_batch_size,
+                                                 int64_t static_sample_size = -1)
       : block_size_(static_sample_size < 0 ? 256 : std::min<int64_t>(static_sample_size, 256)),
         max_blocks_(static_sample_size < 0 ?
                         1024 :
                         std::min<int64_t>(
-                            max_batch_size * div_ceil(static_sample_size, block_size_), 1024)),
-        randomizer_(seed, block_size_ * max_blocks_) {
+                            max_batch_size * div_ceil(static_sample_size, block_size_), 1024)) {
     sample_descs_cpu_.resize(max_batch_size);
     block_descs_cpu_.resize(max_blocks_);
   }
 
   const int block_size_;
   const int max_blocks_;
-  curand_states randomizer_;
 
   std::vector<SampleDesc> sample_descs_cpu_;
   std::vector<BlockDesc> block_descs_cpu_;
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,7 @@
 #include "dali/operators/reader/coco_reader_op.h"
 
 #include <set>
+#include "dali/image/image_info.h"
 
 extern "C" {
 #include "third_party/cocoapi/common/maskApi.h"
@@ -83,7 +84,11 @@ This readers produces the following outputs::
 * **image_ids** (Optional, present if argument ``image_ids`` is set to True)
   One element per sample, representing an image identifier.)code")
   .AddOptionalArg("preprocessed_annotations",
-    "Path to the directory with meta files that contain preprocessed COCO annotations.",
+    R"code(Path to the directory with meta files that contain preprocessed COCO annotations.
+
+The annotations are memory-mapped rather than loaded, so the reader starts immediately and
+only the annotations of the samples being read are brought to memory. The masks are decoded
+when their samples are read.)code",
     std::string())
   .DeprecateArgInFavorOf("meta_files_path", "preprocessed_annotations")  // deprecated since 0.28dev
   .AddOptionalArg("annotations_file",
@@ -207,6 +212,9 @@ void COCOReader::RunImpl(SampleWorkspace &ws) {
   image_output.Resize({image_size}, DALI_UINT8);
   image_output.SetSourceInfo(image_label.image.GetSourceInfo());
   std::memcpy(image_output.mutable_data<uint8_t>(), image_label.image.raw_data(), image_size);
+  ImageInfo image_info;
+  ParseImageInfo(image_output.data<uint8_t>(), image_size, image_info);
+  image_output.SetImageInfo(image_info);
 
   auto &loader_impl = LoaderImpl();
   auto bboxes = loader_impl.bboxes(image_idx);
@@ -300,12 +308,13 @@ void COCOReader::PixelwiseMasks(int image_idx, int* mask) {
   RLE* R;
   rlesInit(&R, *labels.rbegin() + 1);
 
-  // Mask was originally described in RLE format
+  // Mask was originally described in RLE format - it's decoded only now
   for (uint ann_id = 0 ; ann_id < masks_info.mask_indices.size(); ann_id++) {
-    const auto &rle = masks_info.rles[ann_id];
+    auto rle = masks_info.rles->Decode(masks_info.first_rle + ann_id);
     auto mask_idx = masks_info.mask_indices[ann_id];
     int label = labels_span[mask_idx];
-    rleInit(&R[label], (*rle)->h, (*rle)->w, (*rle)->m, (*rle)->cnts);
+    rleFree(&R[label]);
+    R[label] = rle.release();
   }
 
   // Merge each label (from multi-polygons annotations)
@@ -0,0 +1,117 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/operators/reader/file_reader_gpu_op.h"
+
+namespace dali {
+
+FileReaderGPU::FileReaderGPU(const OpSpec& spec)
+    : DataReader<GPUBackend, FileLabelWrapperGPU>(spec),
+      thread_pool_(num_threads_, spec.GetArgument<int>("device_id"), false, "FileReaderGPU") {
+  prefetched_batch_tensors_.resize(prefetch_queue_depth_);
+  labels_.set_pinned(false);
+  // make the device current
+  DeviceGuard g(device_id_);
+
+  staging_stream_ = CUDAStreamPool::instance().Get(-1, default_cuda_stream_priority_);
+  staging_ready_ = CUDAEventPool::instance().Get();
+  staging_.set_stream(staging_stream_);
+
+  bool shuffle_after_epoch = spec.GetArgument<bool>("shuffle_after_epoch");
+  loader_ = InitLoader<FileLabelLoaderGPU>(spec, shuffle_after_epoch);
+}
+
+void FileReaderGPU::Prefetch() {
+  // We actually prepare the next batch
+  DomainTimeRange tr("[DALI][FileReaderGPU] Prefetch #" + to_string(curr_batch_producer_),
+                      DomainTimeRange::kRed);
+  DataReader<GPUBackend, FileLabelWrapperGPU>::Prefetch();
+  auto &curr_batch = prefetched_batch_queue_[curr_batch_producer_];
+  auto &curr_tensor_list = prefetched_batch_tensors_[curr_batch_producer_];
+
+  // get the sizes
+  for (size_t data_idx = 0; data_idx < curr_batch.size(); ++data_idx) {
+    thread_pool_.AddWork([&curr_batch, data_idx](int tid) {
+        curr_batch[data_idx]->Open();
+      });
+  }
+  thread_pool_.RunAll();
+
+  TensorListShape<1> shapes(curr_batch.size());
+  for (size_t data_idx = 0; data_idx < curr_batch.size(); ++data_idx)
+    shapes.set_tensor_shape(data_idx, {curr_batch[data_idx]->size});
+  curr_tensor_list.Resize(shapes, DALI_UINT8);
+
+  // read the data
+  for (int data_idx = 0; data_idx < curr_tensor_list.num_samples(); ++data_idx) {
+    curr_tensor_list.SetMeta(data_idx, curr_batch[data_idx]->meta);
+    ScheduleChunkedRead(curr_tensor_list.mutable_tensor<uint8_t>(data_idx), *curr_batch[data_idx]);
+  }
+  thread_pool_.RunAll();
+  staging_.commit();
+  CUDA_CALL(cudaEventRecord(staging_ready_, staging_stream_));
+
+  for (auto &sample : curr_batch) {
+    if (sample->file_stream) {
+      sample->file_stream->Close();
+      sample->file_stream.reset();
+    }
+  }
+}
+
+void FileReaderGPU::ScheduleChunkedRead(uint8_t *dst, FileLabelWrapperGPU &target) {
+  // the files are read from the beginning, so the reads are aligned
+  for (int64_t offset = 0; offset < target.size; offset += chunk_size_) {
+    size_t length = std::min<int64_t>(target.size - offset, chunk_size_);
+    uint8_t *chunk_dst = dst + offset;
+    thread_pool_.AddWork([=, &target](int tid) {
+      auto buffer = staging_.get_staging_buffer();
+      target.ReadRawChunk(buffer.at(0), length, 0, offset);
+      staging_.copy_to_client(chunk_dst, length, std::move(buffer), 0);
+    });
+  }
+}
+
+bool FileReaderGPU::SetupImpl(std::vector<OutputDesc> &output_desc, const DeviceWorkspace &ws) {
+  DataReader<GPUBackend, FileLabelWrapperGPU>::SetupImpl(output_desc, ws);
+  int batch_size = GetCurrBatchSize();
+  output_desc.resize(2);
+  output_desc[0] = { prefetched_batch_tensors_[curr_batch_consumer_].shape(), DALI_UINT8 };
+  output_desc[1] = { uniform_list_shape(batch_size, {1}), DALI_INT32 };
+  return true;
+}
+
+void FileReaderGPU::RunImpl(DeviceWorkspace &ws) {
+  auto &data_output = ws.Output<GPUBackend>(0);
+  auto &label_output = ws.Output<GPUBackend>(1);
+  int batch_size = GetCurrBatchSize();
+
+  // the data is read on the staging stream
+  CUDA_CALL(cudaStreamWaitEvent(ws.stream(), staging_ready_, 0));
+  data_output.Copy(prefetched_batch_tensors_[curr_batch_consumer_], ws.stream());
+
+  labels_.Resize(uniform_list_shape(batch_size, {1}), DALI_INT32);
+  for (int i = 0; i < batch_size; i++)
+    labels_.mutable_tensor<int>(i)[0] = GetSample(i).label;
+  label_output.Copy(labels_, ws.stream());
+}
+
+DALI_REGISTER_OPERATOR(readers__File, FileReaderGPU, GPU);
+
+}  // namespace dali
@@ -0,0 +1,68 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_FILE_READER_GPU_OP_H_
+#define DALI_OPERATORS_READER_FILE_READER_GPU_OP_H_
+
+#include <vector>
+
+#include "dali/core/cuda_event_pool.h"
+#include "dali/core/cuda_stream_pool.h"
+#include "dali/operators/reader/gds_mem.h"
+#include "dali/operators/reader/loader/file_label_loader_gpu.h"
+#include "dali/operators/reader/reader_op.h"
+
+namespace dali {
+
+/**
+ * @brief Reads the files directly to the GPU memory, with GPUDirect Storage.
+ *
+ * The files are read with cuFile to staging buffers in the device memory and copied to the
+ * output, bypassing the host memory.
+ */
+class FileReaderGPU : public DataReader<GPUBackend, FileLabelWrapperGPU> {
+ public:
+  explicit FileReaderGPU(const OpSpec& spec);
+
+  ~FileReaderGPU() override {
+    // The prefetch thread uses the thread pool - stop it before the pool is destroyed.
+    DataReader<GPUBackend, FileLabelWrapperGPU>::StopPrefetchThread();
+  }
+
+  void Prefetch() override;
+
+ protected:
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const DeviceWorkspace &ws) override;
+  void RunImpl(DeviceWorkspace &ws) override;
+  using Operator<GPUBackend>::RunImpl;
+
+  USE_READER_OPERATOR_MEMBERS(GPUBackend, FileLabelWrapperGPU);
+
+ private:
+  void ScheduleChunkedRead(uint8_t *dst, FileLabelWrapperGPU &target);
+
+  // GPU workspaces don't have a thread pool
+  ThreadPool thread_pool_;
+  vector<TensorList<GPUBackend>> prefetched_batch_tensors_;
+  TensorList<CPUBackend> labels_;
+
+  size_t chunk_size_ = gds::GetGDSChunkSize();
+  gds::GDSStagingEngine staging_;
+  CUDAStreamLease staging_stream_;
+  CUDAEvent staging_ready_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_FILE_READER_GPU_OP_H_
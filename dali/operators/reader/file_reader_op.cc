@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -78,6 +78,9 @@ The file names can contain spaces in the middle, but cannot contain trailing whi
 As with other readers, the (file, label) pairs returned by this operator can be randomly shuffled
 and various sharding strategies can be applied. See documentation of this operator's arguments
 for details.
+
+The GPU variant of this operator reads the files directly to the GPU memory with GPUDirect
+Storage, bypassing the host memory. The files are returned as they are - they are not decoded.
 )")
   .NumInput(0)
   .NumOutput(2)  // (Images, Labels)
@@ -116,6 +119,17 @@ This argument is ignored when file paths are taken from ``file_list`` or ``files
       kKnownExtensionsGlob)
   .AddOptionalArg<bool>("case_sensitive_filter", R"(If set to True, the filter will be matched
 case-sensitively, otherwise case-insensitively.)", false)
+  .AddOptionalArg<string>("index_cache_dir", R"(A directory where the list of files found in
+``file_root`` is cached.
+
+Traversing a large directory tree can take a long time, especially on a network file system.
+When this argument is set, the list is stored in a file in this directory and the subsequent runs
+reuse it, as long as none of the directories changed in the meantime (only the modification
+times of the directories are checked). When ``stick_to_shard`` is set and the data is not
+shuffled, each shard reads only its part of the list.
+
+The directory must exist. This argument is ignored when file paths are taken from ``file_list``
+or ``files``.)", "")
   .AddParent("LoaderBase");
 
 
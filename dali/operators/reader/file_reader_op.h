@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -19,6 +19,7 @@
 #include <utility>
 #include <vector>
 
+#include "dali/image/image_info.h"
 #include "dali/operators/reader/loader/file_label_loader.h"
 #include "dali/operators/reader/reader_op.h"
 
@@ -50,6 +51,10 @@ class FileReader : public DataReader<CPUBackend, ImageLabelWrapper> {
                 image_label.image.raw_data(),
                 image_size);
     image_output.SetSourceInfo(image_label.image.GetSourceInfo());
+    // the header is parsed here, in the thread pool, and reused by the decoders
+    ImageInfo image_info;
+    ParseImageInfo(image_output.data<uint8_t>(), image_size, image_info);
+    image_output.SetImageInfo(image_info);
 
     label_output.mutable_data<int>()[0] = image_label.label;
   }
@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdlib>
 #include <list>
 #include <map>
 #include <unordered_map>
@@ -21,6 +22,7 @@
 
 #include "dali/operators/reader/loader/coco_loader.h"
 #include "dali/pipeline/util/lookahead_parser.h"
+#include "dali/util/file.h"
 
 namespace dali {
 namespace detail {
@@ -44,7 +46,9 @@ struct Annotation {
   std::array<float, 4> box_;
   // union
   Polygons poly_;
-  RLEMaskPtr rle_;
+  // the RLE mask, as the compressed string - it's decoded only when the sample is read
+  siz rle_h_ = 0, rle_w_ = 0;
+  std::string rle_counts_;
 
   void ToLtrb() {
     box_[2] += box_[0];
@@ -105,8 +109,8 @@ void SaveToFile(const std::vector<T> &input, const std::string path) {
   DALI_ENFORCE(file.good(), make_string("Error writing to path: ", path));
 }
 
-template <>
-void SaveToFile(const std::vector<RLEMaskPtr> &input, const std::string path) {
+template <typename T>
+void SaveToFile(const AnnotationArray<T> &input, const std::string path) {
   if (input.empty())
     return;
   std::ofstream file(path, std::ios_base::binary | std::ios_base::out);
@@ -114,12 +118,12 @@ void SaveToFile(const std::vector<RLEMaskPtr> &input, const std::string path) {
 
   unsigned size = input.size();
   Write(file, size, path.c_str());
-  for (auto &rle : input) {
-    assert((*rle)->h > 0 && (*rle)->w > 0 && (*rle)->m > 0);
-    siz dims[3] = {(*rle)->h, (*rle)->w, (*rle)->m};
-    Write(file, span<const siz>{&dims[0], 3}, path.c_str());
-    Write(file, span<const uint>{(*rle)->cnts, static_cast<ptrdiff_t>((*rle)->m)}, path.c_str());
-  }
+  Write(file, span<const T>{input.data(), input.size()}, path.c_str());
+  DALI_ENFORCE(file.good(), make_string("Error writing to path: ", path));
+}
+
+void SaveToFile(const RLEMasks &input, const std::string path) {
+  input.Save(path);
 }
 
 template <typename T>
@@ -165,24 +169,47 @@ void LoadFromFile(std::vector<T> &output, const std::string path) {
   Read(file, make_span(output), path.c_str());
 }
 
-template <>
-void LoadFromFile(std::vector<RLEMaskPtr> &output, const std::string path) {
-  std::ifstream file(path);
+/**
+ * @brief Maps the whole file to memory; the streams which can't be mapped are read instead
+ */
+std::shared_ptr<void> MapFile(const std::string &path, size_t &size) {
+  auto stream = FileStream::Open(path, false, true);
+  size = stream->Size();
+  std::shared_ptr<void> data;
+  if (size > 0) {
+    data = stream->Get(size);
+    if (!data) {
+      std::shared_ptr<uint8_t> buffer(new uint8_t[size], std::default_delete<uint8_t[]>());
+      DALI_ENFORCE(stream->Read(buffer.get(), size) == size,
+                   make_string("Error reading from path: ", path));
+      data = std::move(buffer);
+    }
+  }
+  stream->Close();
+  return data;
+}
+
+template <typename T>
+void LoadFromFile(AnnotationArray<T> &output, const std::string path) {
   output.clear();
-  if (!file.good())
+  if (!std::ifstream(path).good())
     return;
 
+  size_t file_size;
+  auto mapping = MapFile(path, file_size);
   unsigned size;
-  Read(file, size, path.c_str());
-  output.clear();
-  output.resize(size);
-  for (auto &rle : output) {
-    siz dims[3];
-    Read(file, span<siz>{&dims[0], 3}, path.c_str());
-    siz h = dims[0], w = dims[1], m = dims[2];
-    rle = std::make_shared<RLEMask>(h, w, m);
-    Read(file, span<uint>{(*rle)->cnts, static_cast<ptrdiff_t>((*rle)->m)}, path.c_str());
-  }
+  DALI_ENFORCE(file_size >= sizeof(size), make_string("Error reading from path: ", path,
+                                                      ". The file is truncated."));
+  std::memcpy(&size, mapping.get(), sizeof(size));
+  DALI_ENFORCE(file_size >= sizeof(size) + size * sizeof(T), make_string(
+      "Error reading from path: ", path, ". The file is truncated."));
+  auto *data = reinterpret_cast<const T *>(static_cast<const uint8_t *>(mapping.get()) +
+                                           sizeof(size));
+  output.Map(std::move(mapping), data, size);
+}
+
+void LoadFromFile(RLEMasks &output, const std::string path) {
+  output.Load(path);
 }
 
 template <typename T>
@@ -331,10 +358,16 @@ void ParseAnnotations(LookaheadParser &parser, std::vector<Annotation> &annotati
             }
           }
           DALI_ENFORCE(h > 0 && w > 0, "Invalid or missing mask sizes");
+          annotation.rle_h_ = h;
+          annotation.rle_w_ = w;
           if (!rle_str.empty()) {
-            annotation.rle_ = std::make_shared<RLEMask>(h, w, rle_str.c_str());
+            annotation.rle_counts_ = std::move(rle_str);
           } else if (!rle_uints.empty()) {
-            annotation.rle_ = std::make_shared<RLEMask>(h, w, make_cspan(rle_uints));
+            // the uncompressed run lengths are compressed, to be kept in a single form
+            RLEMask mask(h, w, make_cspan(rle_uints));
+            char *counts = rleToString(mask.operator->());
+            annotation.rle_counts_ = counts;
+            free(counts);
           } else {
             DALI_FAIL("Missing or invalid ``counts`` attribute.");
           }
@@ -411,6 +444,51 @@ void ParseJsonFile(const OpSpec &spec, std::vector<detail::ImageInfo> &image_inf
 
 }  // namespace detail
 
+void RLEMasks::Save(const std::string &path) const {
+  if (empty())
+    return;
+  std::ofstream file(path, std::ios_base::binary | std::ios_base::out);
+  DALI_ENFORCE(file, "CocoReader meta file error while saving: " + path);
+
+  using detail::Write;
+  unsigned size = entries_.size();
+  Write(file, size, path.c_str());
+  for (int64_t i = 0; i < size; i++) {
+    auto rle = Decode(i);
+    assert(rle->h > 0 && rle->w > 0 && rle->m > 0);
+    siz dims[3] = {rle->h, rle->w, rle->m};
+    Write(file, span<const siz>{&dims[0], 3}, path.c_str());
+    Write(file, span<const uint>{rle->cnts, static_cast<ptrdiff_t>(rle->m)}, path.c_str());
+  }
+}
+
+void RLEMasks::Load(const std::string &path) {
+  clear();
+  if (!std::ifstream(path).good())
+    return;
+
+  size_t file_size;
+  mapping_ = detail::MapFile(path, file_size);
+  auto *data = static_cast<const uint8_t *>(mapping_.get());
+  unsigned size;
+  int64_t offset = sizeof(size);
+  DALI_ENFORCE(file_size >= sizeof(size), make_string("Error reading from path: ", path,
+                                                      ". The file is truncated."));
+  std::memcpy(&size, data, sizeof(size));
+  entries_.resize(size);
+  for (auto &entry : entries_) {
+    siz dims[3];
+    DALI_ENFORCE(offset + sizeof(dims) <= file_size, make_string(
+        "Error reading from path: ", path, ". The file is truncated."));
+    std::memcpy(dims, data + offset, sizeof(dims));
+    offset += sizeof(dims);
+    entry = {dims[0], dims[1], dims[2], offset};
+    offset += dims[2] * sizeof(uint);
+    DALI_ENFORCE(offset <= static_cast<int64_t>(file_size), make_string(
+        "Error reading from path: ", path, ". The file is truncated."));
+  }
+}
+
 void CocoLoader::SavePreprocessedAnnotations(const std::string &path,
                                              const ImageIdPairs &image_id_pairs) {
   using detail::SaveToFile;
@@ -591,7 +669,8 @@ void CocoLoader::ParseJsonAnnotations() {
           }
           case detail::Annotation::RLE: {
             masks_rles_idx_.push_back(objects_in_sample);
-            masks_rles_.push_back(annotation.rle_);
+            masks_rles_.Append(annotation.rle_h_, annotation.rle_w_,
+                               annotation.rle_counts_.c_str());
             mask_count++;
             break;
           }
@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,7 @@
 #define DALI_OPERATORS_READER_LOADER_COCO_LOADER_H_
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
@@ -97,6 +98,111 @@ struct RLEMask : public UniqueHandle<RLE, RLEMask> {
 
 using RLEMaskPtr = std::shared_ptr<RLEMask>;
 
+/**
+ * @brief A flat array of the annotations, built in memory or memory-mapped from a file of
+ *        the preprocessed annotations
+ *
+ * The mapped arrays are not loaded upfront - their pages are read when the samples which use
+ * them are.
+ */
+template <typename T>
+class AnnotationArray {
+ public:
+  void push_back(const T &value) {
+    assert(!mapping_);
+    data_.push_back(value);
+  }
+
+  void clear() {
+    data_.clear();
+    mapping_.reset();
+    mapped_ = nullptr;
+    mapped_size_ = 0;
+  }
+
+  /**
+   * @brief Makes the array a view of `size` elements at `data`, in a mapping owned by `mapping`
+   */
+  void Map(std::shared_ptr<void> mapping, const T *data, int64_t size) {
+    static_assert(alignof(T) <= sizeof(unsigned),
+                  "The arrays in the preprocessed annotations are aligned only to their header");
+    data_.clear();
+    mapping_ = std::move(mapping);
+    mapped_ = data;
+    mapped_size_ = size;
+  }
+
+  const T *data() const { return mapping_ ? mapped_ : data_.data(); }
+  int64_t size() const { return mapping_ ? mapped_size_ : static_cast<int64_t>(data_.size()); }
+  bool empty() const { return size() == 0; }
+  const T &operator[](int64_t idx) const { return data()[idx]; }
+
+ private:
+  std::vector<T> data_;
+  std::shared_ptr<void> mapping_;
+  const T *mapped_ = nullptr;
+  int64_t mapped_size_ = 0;
+};
+
+/**
+ * @brief The run-length encoded masks of the dataset, decoded on demand
+ *
+ * The masks parsed from JSON are kept as the COCO compressed strings and the masks of the
+ * preprocessed annotations - in the memory-mapped file. Only the masks of the samples being
+ * read are decoded, in Decode.
+ */
+class DLL_PUBLIC RLEMasks {
+ public:
+  /**
+   * @brief Adds a mask, given by its compressed string
+   */
+  void Append(siz h, siz w, const char *counts) {
+    assert(!mapping_);
+    entries_.push_back({h, w, 0, static_cast<int64_t>(strings_.size())});
+    strings_.insert(strings_.end(), counts, counts + std::strlen(counts) + 1);
+  }
+
+  RLEMask Decode(int64_t idx) const {
+    const auto &entry = entries_[idx];
+    if (mapping_) {
+      auto *counts = static_cast<const uint8_t *>(mapping_.get()) + entry.offset;
+      return RLEMask(entry.h, entry.w,
+                     span<const uint>(reinterpret_cast<const uint *>(counts), entry.m));
+    }
+    return RLEMask(entry.h, entry.w, strings_.data() + entry.offset);
+  }
+
+  int64_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  void clear() {
+    entries_.clear();
+    strings_.clear();
+    mapping_.reset();
+  }
+
+  /**
+   * @brief Saves the masks, decoded to the run lengths, in the format of the preprocessed
+   *        annotations
+   */
+  void Save(const std::string &path) const;
+
+  /**
+   * @brief Maps the masks saved with Save; only the headers of the masks are read
+   */
+  void Load(const std::string &path);
+
+ private:
+  struct Entry {
+    siz h, w, m;
+    // the offset of the compressed string or, when mapped, of the run lengths
+    int64_t offset;
+  };
+  std::vector<Entry> entries_;
+  std::vector<char> strings_;
+  std::shared_ptr<void> mapping_;
+};
+
 class DLL_PUBLIC CocoLoader : public FileLabelLoader {
  public:
   explicit inline CocoLoader(const OpSpec &spec)
@@ -129,7 +235,8 @@ class DLL_PUBLIC CocoLoader : public FileLabelLoader {
 
   struct PixelwiseMasksInfo {
     TensorShape<3> shape;
-    span<const RLEMaskPtr> rles;
+    const RLEMasks *rles;
+    int64_t first_rle;
     span<const int> mask_indices;
   };
 
@@ -156,7 +263,7 @@ class DLL_PUBLIC CocoLoader : public FileLabelLoader {
     assert(output_pixelwise_masks_);
     return {
       {heights_[image_idx], widths_[image_idx], 1},
-      {masks_rles_.data() + mask_offsets_[image_idx], mask_counts_[image_idx]},
+      &masks_rles_, mask_offsets_[image_idx],
       {masks_rles_idx_.data() + mask_offsets_[image_idx], mask_counts_[image_idx]}
     };
   }
@@ -205,23 +312,24 @@ class DLL_PUBLIC CocoLoader : public FileLabelLoader {
   std::vector<int> heights_;
   std::vector<int> widths_;
   std::vector<int> offsets_;
-  std::vector<float> boxes_;
-  std::vector<int> labels_;
+  // the per-annotation arrays are memory-mapped from the preprocessed annotations
+  AnnotationArray<float> boxes_;
+  AnnotationArray<int> labels_;
   std::vector<int> counts_;
   std::vector<int> original_ids_;
 
   // polygons: (mask_idx, offset, size)
-  std::vector<ivec3> polygon_data_;
+  AnnotationArray<ivec3> polygon_data_;
   std::vector<int64_t> polygon_offset_;  // per-sample offset of polygons
   std::vector<int64_t> polygon_count_;   // number of polygon per sample
   // vertices: (all polygons concatenated)
-  std::vector<vec2> vertices_data_;
+  AnnotationArray<vec2> vertices_data_;
   std::vector<int64_t> vertices_offset_;  // per-sample offset of vertices
   std::vector<int64_t> vertices_count_;   // number of vertices per sample
 
   // masks_rles: (run-length encodings)
-  std::vector<RLEMaskPtr> masks_rles_;
-  std::vector<int> masks_rles_idx_;
+  RLEMasks masks_rles_;
+  AnnotationArray<int> masks_rles_idx_;
   std::vector<int64_t> mask_offsets_;  // per-sample offsets of masks
   std::vector<int64_t> mask_counts_;   // number of masks per sample
 
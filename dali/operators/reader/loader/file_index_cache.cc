@@ -0,0 +1,265 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+#include "dali/operators/reader/loader/file_index_cache.h"
+
+namespace dali {
+namespace filesystem {
+
+namespace {
+
+/*
+ * The layout of the cache file:
+ *   header
+ *   dir_entry[num_dirs]    - the root, followed by the subdirectories, in label order
+ *   file_entry[num_files]
+ *   char[strings_size]     - the key, followed by the names of the directories and files
+ *
+ * All the structures are 8-byte aligned, so the entries can be accessed in the mapped file
+ * directly.
+ */
+constexpr char kMagic[8] = { 'D', 'A', 'L', 'I', 'F', 'I', 'D', 'X' };
+constexpr uint32_t kVersion = 1;
+
+struct header {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_dirs;
+  uint64_t num_files;
+  uint64_t key_size;
+  uint64_t strings_size;
+};
+
+struct dir_entry {
+  int64_t mtime_sec, mtime_nsec;
+  uint64_t name_offset, name_size;
+};
+
+struct file_entry {
+  uint64_t name_offset;
+  uint32_t name_size;
+  int32_t label;
+};
+
+static_assert(sizeof(header) % 8 == 0 && sizeof(dir_entry) % 8 == 0 &&
+              sizeof(file_entry) % 8 == 0, "The entries must be 8-byte aligned");
+
+/**
+ * @brief Identifies the traversal - the files depend on the root and the filters.
+ */
+string make_key(const string &file_root, const vector<string> &filters,
+                bool case_sensitive_filter) {
+  string key;
+  char resolved[PATH_MAX];
+  key += realpath(file_root.c_str(), resolved) ? resolved : file_root.c_str();
+  key += '\0';
+  key += case_sensitive_filter ? '1' : '0';
+  for (auto &filter : filters) {
+    key += '\0';
+    key += filter;
+  }
+  return key;
+}
+
+/**
+ * @brief 64-bit FNV-1a - it must not change between runs and builds
+ */
+uint64_t hash_key(const string &key) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (unsigned char c : key) {
+    h ^= c;
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+}  // namespace
+
+FileIndex::FileIndex(const string &file_root, const vector<string> &filters,
+                     bool case_sensitive_filter, const string &cache_dir) {
+  string key;
+  if (!cache_dir.empty()) {
+    key = make_key(file_root, filters, case_sensitive_filter);
+    char name[32];
+    snprintf(name, sizeof(name), "file_index_%016llx.bin",
+             static_cast<unsigned long long>(hash_key(key)));  // NOLINT(runtime/int)
+    cache_path_ = join_path(cache_dir, name);
+    if (Open(file_root, key))
+      return;
+  }
+
+  vector<dir_stamp> dirs;
+  files_ = traverse_directories(file_root, filters, case_sensitive_filter,
+                                cache_path_.empty() ? nullptr : &dirs);
+  num_files_ = files_.size();
+  if (!cache_path_.empty())
+    Write(key, dirs);
+}
+
+FileIndex::~FileIndex() {
+  Unmap();
+}
+
+void FileIndex::Unmap() {
+  if (mapping_) {
+    munmap(mapping_, mapping_size_);
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+  }
+}
+
+bool FileIndex::Open(const string &file_root, const string &key) {
+  int fd = open(cache_path_.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat s;
+  void *mapping = MAP_FAILED;
+  if (fstat(fd, &s) == 0 && static_cast<size_t>(s.st_size) >= sizeof(header))
+    mapping = mmap(nullptr, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return false;
+  mapping_ = mapping;
+  mapping_size_ = s.st_size;
+
+  auto *hdr = static_cast<const header *>(mapping_);
+  auto *dirs = reinterpret_cast<const dir_entry *>(hdr + 1);
+  size_t size = mapping_size_ - sizeof(header);
+  bool valid = memcmp(hdr->magic, kMagic, sizeof(kMagic)) == 0 && hdr->version == kVersion &&
+               hdr->num_dirs <= size / sizeof(dir_entry);
+  if (valid) {
+    size -= hdr->num_dirs * sizeof(dir_entry);
+    valid = hdr->num_files <= size / sizeof(file_entry) &&
+            size - hdr->num_files * sizeof(file_entry) == hdr->strings_size &&
+            hdr->key_size == key.size() && hdr->key_size <= hdr->strings_size;
+  }
+  if (valid) {
+    file_entries_ = dirs + hdr->num_dirs;
+    strings_ = reinterpret_cast<const char *>(
+        static_cast<const file_entry *>(file_entries_) + hdr->num_files);
+    strings_size_ = hdr->strings_size;
+    valid = memcmp(strings_, key.data(), key.size()) == 0;
+  }
+  for (uint32_t i = 0; valid && i < hdr->num_dirs; i++) {
+    auto &d = dirs[i];
+    valid = d.name_offset <= strings_size_ && d.name_size <= strings_size_ - d.name_offset;
+    if (!valid)
+      break;
+    dir_stamp cached{ string(strings_ + d.name_offset, d.name_size), d.mtime_sec, d.mtime_nsec };
+    struct stat ds;
+    string path = join_path(file_root, cached.name);
+    valid = stat(path.c_str(), &ds) == 0 && S_ISDIR(ds.st_mode) &&
+            ds.st_mtim.tv_sec == cached.mtime_sec && ds.st_mtim.tv_nsec == cached.mtime_nsec;
+  }
+  if (!valid) {
+    Unmap();
+    return false;
+  }
+  num_files_ = hdr->num_files;
+  // the entries can be read in any order - don't read ahead the whole index
+  madvise(mapping_, mapping_size_, MADV_RANDOM);
+  return true;
+}
+
+void FileIndex::Write(const string &key, const vector<dir_stamp> &dirs) const {
+  // A directory modified within the resolution of the timestamps could be modified again
+  // without changing its timestamp - don't cache such directories.
+  time_t now = time(nullptr);
+  for (auto &d : dirs) {
+    if (d.mtime_sec + 1 >= now)
+      return;
+  }
+
+  header hdr;
+  memcpy(hdr.magic, kMagic, sizeof(kMagic));
+  hdr.version = kVersion;
+  hdr.num_dirs = dirs.size();
+  hdr.num_files = files_.size();
+  hdr.key_size = key.size();
+
+  vector<dir_entry> dir_entries;
+  vector<file_entry> file_entries;
+  dir_entries.reserve(dirs.size());
+  file_entries.reserve(files_.size());
+  uint64_t offset = key.size();
+  for (auto &d : dirs) {
+    dir_entries.push_back({ d.mtime_sec, d.mtime_nsec, offset, d.name.size() });
+    offset += d.name.size();
+  }
+  for (auto &f : files_) {
+    file_entries.push_back({ offset, static_cast<uint32_t>(f.first.size()), f.second });
+    offset += f.first.size();
+  }
+  hdr.strings_size = offset;
+
+  // Several processes may write the cache at once - each writes its own file and atomically
+  // replaces the cache with it.
+  string tmp_path = make_string(cache_path_, ".tmp.", getpid());
+  FILE *f = fopen(tmp_path.c_str(), "wb");
+  if (!f) {
+    DALI_WARN("Cannot write the file index cache ", tmp_path, ": ", strerror(errno));
+    return;
+  }
+  bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+  ok = ok && fwrite(dir_entries.data(), sizeof(dir_entry), dir_entries.size(), f) ==
+             dir_entries.size();
+  ok = ok && fwrite(file_entries.data(), sizeof(file_entry), file_entries.size(), f) ==
+             file_entries.size();
+  ok = ok && fwrite(key.data(), 1, key.size(), f) == key.size();
+  for (size_t i = 0; ok && i < dirs.size(); i++)
+    ok = fwrite(dirs[i].name.data(), 1, dirs[i].name.size(), f) == dirs[i].name.size();
+  for (size_t i = 0; ok && i < files_.size(); i++)
+    ok = fwrite(files_[i].first.data(), 1, files_[i].first.size(), f) == files_[i].first.size();
+  ok = (fclose(f) == 0) && ok;
+  if (!ok || rename(tmp_path.c_str(), cache_path_.c_str()) != 0) {
+    DALI_WARN("Cannot write the file index cache ", cache_path_, ": ", strerror(errno));
+    remove(tmp_path.c_str());
+  }
+}
+
+vector<std::pair<string, int>> FileIndex::Get(size_t begin, size_t end) const {
+  DALI_ENFORCE(begin <= end && end <= num_files_, make_string("Invalid range of files: [",
+               begin, ", ", end, ") - the index contains ", num_files_, " files."));
+  if (!mapping_)
+    return { files_.begin() + begin, files_.begin() + end };
+
+  vector<std::pair<string, int>> files;
+  files.reserve(end - begin);
+  auto *entries = static_cast<const file_entry *>(file_entries_);
+  for (size_t i = begin; i < end; i++) {
+    auto &e = entries[i];
+    DALI_ENFORCE(e.name_offset <= strings_size_ && e.name_size <= strings_size_ - e.name_offset,
+                 make_string("The file index cache ", cache_path_, " is corrupted."));
+    files.emplace_back(string(strings_ + e.name_offset, e.name_size), e.label);
+  }
+  return files;
+}
+
+}  // namespace filesystem
+}  // namespace dali
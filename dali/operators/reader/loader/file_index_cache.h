@@ -0,0 +1,97 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_LOADER_FILE_INDEX_CACHE_H_
+#define DALI_OPERATORS_READER_LOADER_FILE_INDEX_CACHE_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "dali/core/common.h"
+#include "dali/operators/reader/loader/filesystem.h"
+
+namespace dali {
+namespace filesystem {
+
+/**
+ * @brief The list of (file, label) pairs found in the subdirectories of a root directory,
+ *        optionally cached on disk.
+ *
+ * The files are the same, and in the same order, as returned by `traverse_directories`.
+ *
+ * When a cache directory is given, the index is read from a file in that directory, as long as
+ * none of the traversed directories was modified since the file was written; otherwise the
+ * directories are traversed and the index is stored for subsequent runs. The cache file is
+ * memory-mapped and its entries have fixed size, so any range of files can be read without
+ * parsing the whole index.
+ *
+ * Only the modification times of the directories are checked - adding, removing or renaming
+ * a file invalidates the cache, but changing the contents of a file doesn't (and needn't).
+ */
+class DLL_PUBLIC FileIndex {
+ public:
+  /**
+   * @param file_root             The directory whose subdirectories contain the files
+   * @param filters               Glob patterns that the file names must match
+   * @param case_sensitive_filter Whether the patterns are matched case-sensitively
+   * @param cache_dir             The directory where the index is cached; if empty, the index
+   *                              is not cached
+   */
+  FileIndex(const string &file_root, const vector<string> &filters, bool case_sensitive_filter,
+            const string &cache_dir);
+  ~FileIndex();
+
+  FileIndex(const FileIndex &) = delete;
+  FileIndex &operator=(const FileIndex &) = delete;
+
+  /// The number of files
+  size_t size() const noexcept {
+    return num_files_;
+  }
+
+  /// Whether the index was read from the cache (rather than by traversing the directories)
+  bool from_cache() const noexcept {
+    return mapping_ != nullptr;
+  }
+
+  /// The path of the cache file; empty, if there's no cache directory
+  const string &cache_path() const noexcept {
+    return cache_path_;
+  }
+
+  /**
+   * @brief Returns the (file, label) pairs with indices in the range [begin, end)
+   */
+  vector<std::pair<string, int>> Get(size_t begin, size_t end) const;
+
+ private:
+  bool Open(const string &file_root, const string &key);
+  void Unmap();
+  void Write(const string &key, const vector<dir_stamp> &dirs) const;
+
+  string cache_path_;
+  vector<std::pair<string, int>> files_;  // used when not reading from the cache
+  size_t num_files_ = 0;
+
+  void *mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+  const void *file_entries_ = nullptr;
+  const char *strings_ = nullptr;
+  size_t strings_size_ = 0;
+};
+
+}  // namespace filesystem
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_LOADER_FILE_INDEX_CACHE_H_
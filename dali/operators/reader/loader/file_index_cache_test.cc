@@ -0,0 +1,159 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ftw.h>
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/core/format.h"
+#include "dali/operators/reader/loader/file_index_cache.h"
+#include "dali/operators/reader/loader/filesystem.h"
+
+namespace dali {
+namespace filesystem {
+namespace test {
+
+namespace {
+
+int Remove(const char *fpath, const struct stat *, int, struct FTW *) {
+  return remove(fpath);
+}
+
+}  // namespace
+
+class FileIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string tmpl = "/tmp/file_index_test_XXXXXX";
+    tmp_dir_ = mkdtemp(&tmpl[0]);
+    root_ = join_path(tmp_dir_, "root");
+    cache_dir_ = join_path(tmp_dir_, "cache");
+    ASSERT_EQ(mkdir(root_.c_str(), 0755), 0);
+    ASSERT_EQ(mkdir(cache_dir_.c_str(), 0755), 0);
+    for (const char *cls : { "cat", "dog", "snail" }) {
+      ASSERT_EQ(mkdir(join_path(root_, cls).c_str(), 0755), 0);
+      for (int i = 0; i < 5; i++)
+        AddFile(make_string(cls, dir_sep, i, ".jpg"));
+    }
+    AddFile("dog/readme.txt");
+    MakeOld();
+  }
+
+  void TearDown() override {
+    nftw(tmp_dir_.c_str(), Remove, 64, FTW_DEPTH | FTW_PHYS);
+  }
+
+  void AddFile(const std::string &rel_path) {
+    std::ofstream(join_path(root_, rel_path)) << rel_path;
+  }
+
+  /**
+   * @brief Sets the modification times of the directories to the past - recently modified
+   *        directories are not cached.
+   */
+  void MakeOld() {
+    struct timeval times[2] = {};
+    times[0].tv_sec = times[1].tv_sec = 1000000000 + num_changes_++;
+    for (const char *dir : { "", "cat", "dog", "snail" })
+      ASSERT_EQ(utimes(join_path(root_, dir).c_str(), times), 0);
+  }
+
+  std::string tmp_dir_, root_, cache_dir_;
+  int num_changes_ = 0;
+  std::vector<std::string> filters_ = { "*.jpg" };
+};
+
+TEST_F(FileIndexTest, ReuseCache) {
+  auto expected = traverse_directories(root_, filters_);
+  ASSERT_EQ(expected.size(), 15u);
+  {
+    FileIndex index(root_, filters_, false, cache_dir_);
+    EXPECT_FALSE(index.from_cache());
+    EXPECT_EQ(index.Get(0, index.size()), expected);
+    struct stat s;
+    EXPECT_EQ(stat(index.cache_path().c_str(), &s), 0) << "The cache file should be written";
+  }
+  {
+    FileIndex index(root_, filters_, false, cache_dir_);
+    EXPECT_TRUE(index.from_cache());
+    EXPECT_EQ(index.Get(0, index.size()), expected);
+    decltype(expected) slice(expected.begin() + 4, expected.begin() + 11);
+    EXPECT_EQ(index.Get(4, 11), slice);
+    EXPECT_THROW(index.Get(4, 16), std::exception);
+  }
+  {
+    FileIndex index(root_, { "*.txt" }, false, cache_dir_);
+    EXPECT_FALSE(index.from_cache()) << "Different filters should use a different cache";
+    EXPECT_EQ(index.size(), 1u);
+  }
+}
+
+TEST_F(FileIndexTest, InvalidateOnChange) {
+  { FileIndex index(root_, filters_, false, cache_dir_); }
+  AddFile("snail/5.jpg");
+  {
+    FileIndex index(root_, filters_, false, cache_dir_);
+    EXPECT_FALSE(index.from_cache());
+    EXPECT_EQ(index.size(), 16u);
+  }
+  {
+    FileIndex index(root_, filters_, false, cache_dir_);
+    EXPECT_FALSE(index.from_cache()) << "A recently modified directory should not be cached";
+  }
+  MakeOld();
+  {
+    FileIndex index(root_, filters_, false, cache_dir_);
+    EXPECT_FALSE(index.from_cache());
+  }
+  {
+    FileIndex index(root_, filters_, false, cache_dir_);
+    EXPECT_TRUE(index.from_cache());
+    EXPECT_EQ(index.size(), 16u);
+  }
+  ASSERT_EQ(mkdir(join_path(root_, "zebra").c_str(), 0755), 0);
+  {
+    FileIndex index(root_, filters_, false, cache_dir_);
+    EXPECT_FALSE(index.from_cache());
+    EXPECT_EQ(index.Get(0, index.size()), traverse_directories(root_, filters_));
+  }
+}
+
+TEST_F(FileIndexTest, CorruptedCache) {
+  std::string cache_path;
+  {
+    FileIndex index(root_, filters_, false, cache_dir_);
+    cache_path = index.cache_path();
+  }
+  std::ofstream(cache_path, std::ios::binary | std::ios::trunc) << "garbage";
+  FileIndex index(root_, filters_, false, cache_dir_);
+  EXPECT_FALSE(index.from_cache());
+  EXPECT_EQ(index.Get(0, index.size()), traverse_directories(root_, filters_));
+}
+
+TEST_F(FileIndexTest, NoCacheDir) {
+  FileIndex index(root_, filters_, false, "");
+  EXPECT_FALSE(index.from_cache());
+  EXPECT_TRUE(index.cache_path().empty());
+  EXPECT_EQ(index.Get(0, index.size()), traverse_directories(root_, filters_));
+}
+
+}  // namespace test
+}  // namespace filesystem
+}  // namespace dali
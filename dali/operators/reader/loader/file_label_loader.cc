@@ -12,7 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "dali/core/common.h"
 #include "dali/operators/reader/loader/file_label_loader.h"
@@ -28,28 +32,59 @@ void FileLabelLoader::PrepareEmpty(ImageLabelWrapper &image_label) {
 }
 
 void FileLabelLoader::ReadSample(ImageLabelWrapper &image_label) {
-  auto image_pair = image_label_pairs_[current_index_++];
+  auto read = ReadSampleDeferred(image_label);
+  if (read)
+    read();
+}
+
+std::function<void()> FileLabelLoader::ReadSampleDeferred(ImageLabelWrapper &image_label) {
+  std::string image_file;
+  if (!NextImage(image_label, image_file))
+    return {};
+  return [this, &image_label, image_file = std::move(image_file)]() {
+    ReadImage(image_label, image_file);
+  };
+}
+
+void FileLabelLoader::QueueReadSample(ImageLabelWrapper &image_label) {
+  std::string image_file;
+  if (NextImage(image_label, image_file))
+    ReadImage(image_label, image_file, true);
+}
+
+bool FileLabelLoader::NextImage(ImageLabelWrapper &image_label, std::string &image_file) {
+  PrefetchFiles(current_index_);
+  auto image_pair = image_label_pairs_[GlobalSampleIndex(current_index_++) - slice_begin_];
 
   // handle wrap-around
   MoveToNextShard(current_index_);
 
   // copy the label
   image_label.label = image_pair.second;
-  DALIMeta meta;
-  meta.SetSourceInfo(image_pair.first);
-  meta.SetSkipSample(false);
 
   // if image is cached, skip loading
   if (ShouldSkipImage(image_pair.first)) {
+    DALIMeta meta;
+    meta.SetSourceInfo(image_pair.first);
     meta.SetSkipSample(true);
     image_label.image.Reset();
     image_label.image.SetMeta(meta);
     image_label.image.Resize({0}, DALI_UINT8);
-    return;
+    return false;
   }
+  image_file = std::move(image_pair.first);
+  return true;
+}
+
+void FileLabelLoader::ReadImage(ImageLabelWrapper &image_label, const std::string &image_file,
+                                bool queue) {
+  DALIMeta meta;
+  meta.SetSourceInfo(image_file);
+  meta.SetSkipSample(false);
 
-  auto current_image = FileStream::Open(filesystem::join_path(file_root_, image_pair.first),
-                                        read_ahead_, !copy_read_data_);
+  queue = queue && copy_read_data_;
+  auto image_path = filesystem::join_path(file_root_, image_file);
+  auto current_image = OpenSampleFile(image_path, read_ahead_, !copy_read_data_, queue);
   Index image_size = current_image->Size();
 
   if (copy_read_data_) {
@@ -57,23 +92,46 @@ void FileLabelLoader::ReadSample(ImageLabelWrapper &image_label) {
       image_label.image.Reset();
     }
     image_label.image.Resize({image_size}, DALI_UINT8);
+    if (queue) {
+      QueuedRead read;
+      read.stream = std::move(current_image);
+      read.request.buffer = image_label.image.mutable_data<uint8_t>();
+      read.request.n_bytes = image_size;
+      read.done = [this, image_path, image_file](QueuedRead &read) {
+        DALI_ENFORCE(read.request.bytes_read == read.request.n_bytes,
+                     make_string("Failed to read file: ", image_file));
+        ReleaseSampleFile(image_path, std::move(read.stream), false);
+      };
+      image_label.image.SetMeta(meta);
+      QueueRead(image_label, std::move(read));
+      return;
+    }
     // copy the image
     Index ret = current_image->Read(image_label.image.mutable_data<uint8_t>(), image_size);
-    DALI_ENFORCE(ret == image_size, make_string("Failed to read file: ", image_pair.first));
+    DALI_ENFORCE(ret == image_size, make_string("Failed to read file: ", image_file));
   } else {
     auto p = current_image->Get(image_size);
-    DALI_ENFORCE(p != nullptr, make_string("Failed to read file: ", image_pair.first));
+    DALI_ENFORCE(p != nullptr, make_string("Failed to read file: ", image_file));
     // Wrap the raw data in the Tensor object.
     image_label.image.ShareData(p, image_size, false, {image_size}, DALI_UINT8);
   }
 
-  // close the file handle
-  current_image->Close();
+  // close the file handle or keep it for later
+  ReleaseSampleFile(image_path, std::move(current_image), !copy_read_data_);
 
   image_label.image.SetMeta(meta);
 }
 
-Index FileLabelLoader::SizeImpl() {
-  return static_cast<Index>(image_label_pairs_.size());
+void FileLabelLoader::PrefetchFiles(Index pos) {
+  if (!UseFileHandleCache(!copy_read_data_))
+    return;
+  std::vector<std::string> paths;
+  for (auto idx : FilePrefetchIndices(pos)) {
+    size_t local_idx = idx - slice_begin_;
+    if (local_idx < image_label_pairs_.size())
+      paths.push_back(filesystem::join_path(file_root_, image_label_pairs_[local_idx].first));
+  }
+  PrefetchSampleFiles(paths, read_ahead_, !copy_read_data_);
 }
+
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -20,6 +20,7 @@
 #include <errno.h>
 
 #include <fstream>
+#include <functional>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -29,6 +30,7 @@
 #include "dali/core/common.h"
 #include "dali/operators/reader/loader/loader.h"
 #include "dali/operators/reader/loader/filesystem.h"
+#include "dali/operators/reader/loader/file_index_cache.h"
 #include "dali/util/file.h"
 
 namespace dali {
@@ -38,15 +40,20 @@ struct ImageLabelWrapper {
   int label;
 };
 
-class DLL_PUBLIC FileLabelLoader : public Loader<CPUBackend, ImageLabelWrapper> {
+/**
+ * @brief Lists the files and their labels; reading the files is left to the derived classes
+ */
+template <typename Backend, typename Target, typename InputStream = FileStream>
+class FileLabelLoaderBase : public Loader<Backend, Target> {
  public:
-  explicit inline FileLabelLoader(
+  explicit inline FileLabelLoaderBase(
     const OpSpec& spec,
     bool shuffle_after_epoch = false)
-    : Loader<CPUBackend, ImageLabelWrapper>(spec),
+    : Loader<Backend, Target>(spec),
       shuffle_after_epoch_(shuffle_after_epoch),
       current_index_(0),
-      current_epoch_(0) {
+      current_epoch_(0),
+      num_threads_(std::max(1, spec.GetArgument<int>("num_threads"))) {
 
       vector<string> files;
       vector<int> labels;
@@ -60,6 +67,7 @@ class DLL_PUBLIC FileLabelLoader : public Loader<CPUBackend, ImageLabelWrapper>
       // TODO(ksztenderski): CocoLoader inherits after FileLabelLoader and it doesn't work with
       // GetArgument.
       spec.TryGetArgument(case_sensitive_filter_, "case_sensitive_filter");
+      spec.TryGetArgument(index_cache_dir_, "index_cache_dir");
 
       DALI_ENFORCE(has_file_root_arg_ || has_files_arg_ || has_file_list_arg_,
         "``file_root`` argument is required when not using ``files`` or ``file_list``.");
@@ -104,6 +112,8 @@ class DLL_PUBLIC FileLabelLoader : public Loader<CPUBackend, ImageLabelWrapper>
       * Still when `shuffle_after_epoch` we will set `stick_to_shard` internally in the FileLabelLoader so all
       * DALI instances will do shuffling after each epoch
       */
+      DALI_ENFORCE(!(shuffle_after_epoch_ && global_shuffle_),
+                   "shuffle_after_epoch and global_shuffle cannot be both true");
       DALI_ENFORCE(!(shuffle_after_epoch_  && stick_to_shard_),
                    "shuffle_after_epoch and stick_to_shard cannot be both true");
       DALI_ENFORCE(!(shuffle_after_epoch_ && shuffle_),
@@ -115,63 +125,52 @@ class DLL_PUBLIC FileLabelLoader : public Loader<CPUBackend, ImageLabelWrapper>
         stick_to_shard_ = true;
       }
     if (!dont_use_mmap_) {
-      mmap_reserver_ = FileStream::MappingReserver(
+      mmap_reserver_ = typename InputStream::MappingReserver(
                                   static_cast<unsigned int>(initial_buffer_fill_));
     }
     copy_read_data_ = dont_use_mmap_ || !mmap_reserver_.CanShareMappedData();
   }
 
-  void PrepareEmpty(ImageLabelWrapper &tensor) override;
-  void ReadSample(ImageLabelWrapper &tensor) override;
-
  protected:
-  Index SizeImpl() override;
+  Index SizeImpl() override {
+    return total_size_ >= 0 ? total_size_ : static_cast<Index>(image_label_pairs_.size());
+  }
+
+  /**
+   * @brief Fills image_label_pairs_ from the (possibly cached) index of file_root_.
+   *
+   * A reader which sticks to its shard and doesn't shuffle only loads the files of its shard.
+   */
+  void LoadFileIndex() {
+    filesystem::FileIndex index(file_root_, filters_, case_sensitive_filter_, index_cache_dir_);
+    size_t total = index.size();
+    if (stick_to_shard_ && !shuffle_ && !shuffle_after_epoch_ && !global_shuffle_ &&
+        num_shards_ > 1 && total > 0) {
+      total_size_ = total;
+      slice_begin_ = start_index(shard_id_, num_shards_, total);
+      // With padding, the end of the shard is calculated from the padded size
+      size_t end = std::max(start_index(shard_id_ + 1, num_shards_, total),
+                            start_index(shard_id_ + 1, num_shards_, Size()));
+      image_label_pairs_ = index.Get(slice_begin_, std::min(end, total));
+    } else {
+      image_label_pairs_ = index.Get(0, total);
+    }
+  }
 
   void PrepareMetadataImpl() override {
     if (image_label_pairs_.empty()) {
       if (!has_file_list_arg_ && !has_files_arg_) {
-        image_label_pairs_ =
-            filesystem::traverse_directories(file_root_, filters_, case_sensitive_filter_);
+        if (index_cache_dir_.empty()) {
+          image_label_pairs_ =
+              filesystem::traverse_directories(file_root_, filters_, case_sensitive_filter_);
+        } else {
+          LoadFileIndex();
+        }
       } else if (has_file_list_arg_) {
         // load (path, label) pairs from list
         std::ifstream s(file_list_);
         DALI_ENFORCE(s.is_open(), "Cannot open: " + file_list_);
-
-        vector<char> line_buf(16 << 10);  // 16 kB should be more than enough for a line
-        char *line = line_buf.data();
-        for  (int n = 1; s.getline(line, line_buf.size()); n++) {
-          // parse the line backwards:
-          // - skip trailing whitespace
-          // - consume digits
-          // - skip whitespace between label and
-          int i = strlen(line) - 1;
-
-          for (; i >= 0 && isspace(line[i]); i--) {}  // skip trailing spaces
-
-          int label_end = i + 1;
-
-          if (i < 0)  // empty line - skip
-            continue;
-
-          for (; i >= 0 && isdigit(line[i]); i--) {}  // skip
-
-          int label_start = i + 1;
-
-          for (; i >= 0 && isspace(line[i]); i--) {}
-
-          int name_end = i + 1;
-          DALI_ENFORCE(name_end > 0 && name_end < label_start &&
-                       label_start >= 2 && label_end > label_start,
-                       make_string("Incorrect format of the list file \"",  file_list_, "\":", n,
-                       " expected file name followed by a label; got: ", line));
-
-          line[label_end] = 0;
-          line[name_end] = 0;
-
-          image_label_pairs_.emplace_back(line, std::atoi(line + label_start));
-        }
-
-        DALI_ENFORCE(s.eof(), "Wrong format of file_list: " + file_list_);
+        image_label_pairs_ = filesystem::parse_file_list(s, file_list_, num_threads_);
       }
     }
     DALI_ENFORCE(SizeImpl() > 0, "No files found.");
@@ -193,6 +192,7 @@ class DLL_PUBLIC FileLabelLoader : public Loader<CPUBackend, ImageLabelWrapper>
     }
 
     current_epoch_++;
+    ShuffleGlobally();
 
     if (shuffle_after_epoch_) {
       std::mt19937 g(kDaliDataloaderSeed + current_epoch_);
@@ -200,11 +200,26 @@ class DLL_PUBLIC FileLabelLoader : public Loader<CPUBackend, ImageLabelWrapper>
     }
   }
 
-  using Loader<CPUBackend, ImageLabelWrapper>::shard_id_;
-  using Loader<CPUBackend, ImageLabelWrapper>::num_shards_;
-
-  string file_root_, file_list_;
+  using Loader<Backend, Target>::shard_id_;
+  using Loader<Backend, Target>::num_shards_;
+  using Loader<Backend, Target>::stick_to_shard_;
+  using Loader<Backend, Target>::global_shuffle_;
+  using Loader<Backend, Target>::shuffle_;
+  using Loader<Backend, Target>::dont_use_mmap_;
+  using Loader<Backend, Target>::initial_buffer_fill_;
+  using Loader<Backend, Target>::copy_read_data_;
+  using Loader<Backend, Target>::read_ahead_;
+  using Loader<Backend, Target>::MoveToNextShard;
+  using Loader<Backend, Target>::ShouldSkipImage;
+  using Loader<Backend, Target>::Size;
+  using Loader<Backend, Target>::ShuffleGlobally;
+  using Loader<Backend, Target>::GlobalSampleIndex;
+
+  string file_root_, file_list_, index_cache_dir_;
   vector<std::pair<string, int>> image_label_pairs_;
+  // when only a part of the files is loaded: the index of the first one and the total number
+  Index slice_begin_ = 0;
+  Index total_size_ = -1;
   vector<string> filters_;
 
   bool has_files_arg_ = false;
@@ -216,7 +231,40 @@ class DLL_PUBLIC FileLabelLoader : public Loader<CPUBackend, ImageLabelWrapper>
   bool shuffle_after_epoch_;
   Index current_index_;
   int current_epoch_;
-  FileStream::MappingReserver mmap_reserver_;
+  // the number of threads parsing file_list_
+  int num_threads_;
+  typename InputStream::MappingReserver mmap_reserver_;
+};
+
+class DLL_PUBLIC FileLabelLoader : public FileLabelLoaderBase<CPUBackend, ImageLabelWrapper> {
+ public:
+  using FileLabelLoaderBase<CPUBackend, ImageLabelWrapper>::FileLabelLoaderBase;
+
+  void PrepareEmpty(ImageLabelWrapper &tensor) override;
+  void ReadSample(ImageLabelWrapper &tensor) override;
+  std::function<void()> ReadSampleDeferred(ImageLabelWrapper &tensor) override;
+  void QueueReadSample(ImageLabelWrapper &tensor) override;
+
+ protected:
+  /**
+   * @brief Advances to the next sample and sets its label
+   *
+   * @return false, if the image is cached and its read should be skipped
+   */
+  bool NextImage(ImageLabelWrapper &image_label, std::string &image_file);
+
+  /**
+   * @brief Reads the image; if `queue` is set and the data is copied, the read is left queued,
+   *        to be submitted with the rest of the batch
+   */
+  void ReadImage(ImageLabelWrapper &image_label, const std::string &image_file,
+                 bool queue = false);
+
+  /**
+   * @brief Starts opening the files of the samples following the one at position `pos`,
+   *        if the file handle cache is enabled
+   */
+  void PrefetchFiles(Index pos);
 };
 
 }  // namespace dali
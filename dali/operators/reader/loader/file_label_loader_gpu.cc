@@ -0,0 +1,66 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <utility>
+
+#include "dali/core/common.h"
+#include "dali/operators/reader/loader/file_label_loader_gpu.h"
+
+namespace dali {
+
+void FileLabelWrapperGPU::Open() {
+  if (filename.empty()) {
+    size = 0;
+    return;
+  }
+  file_stream = CUFileStream::Open(filename, read_ahead, false);
+  size = file_stream->Size();
+}
+
+void FileLabelWrapperGPU::ReadRawChunk(void* buffer, size_t bytes,
+                                       Index buffer_offset, Index file_offset) {
+  size_t n_read = file_stream->ReadAtGPU(static_cast<uint8_t *>(buffer),
+                                         bytes, buffer_offset, file_offset);
+  DALI_ENFORCE(n_read == bytes, make_string("Failed to read file: ", filename));
+}
+
+void FileLabelLoaderGPU::PrepareEmpty(FileLabelWrapperGPU& target) {
+  target = {};
+}
+
+void FileLabelLoaderGPU::ReadSample(FileLabelWrapperGPU& target) {
+  auto image_pair = image_label_pairs_[GlobalSampleIndex(current_index_++) - slice_begin_];
+
+  // handle wrap-around
+  MoveToNextShard(current_index_);
+
+  target.label = image_pair.second;
+  target.read_ahead = read_ahead_;
+
+  DALIMeta meta;
+  meta.SetSourceInfo(image_pair.first);
+  meta.SetSkipSample(false);
+
+  // if image is cached, skip loading
+  if (ShouldSkipImage(image_pair.first)) {
+    meta.SetSkipSample(true);
+    target.filename.clear();
+  } else {
+    target.filename = filesystem::join_path(file_root_, image_pair.first);
+  }
+  target.meta = meta;
+}
+
+}  // namespace dali
@@ -0,0 +1,67 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_LOADER_FILE_LABEL_LOADER_GPU_H_
+#define DALI_OPERATORS_READER_LOADER_FILE_LABEL_LOADER_GPU_H_
+
+#include <memory>
+#include <string>
+
+#include "dali/core/common.h"
+#include "dali/operators/reader/loader/file_label_loader.h"
+#include "dali/util/cufile.h"
+
+namespace dali {
+
+/**
+ * @brief A file to be read directly to the GPU memory, with GPUDirect Storage
+ */
+struct FileLabelWrapperGPU {
+  std::string filename;  // empty, if the sample is skipped
+  int label = 0;
+  int64_t size = 0;
+  DALIMeta meta;
+
+  std::unique_ptr<CUFileStream> file_stream;
+  bool read_ahead = false;
+
+  /// Opens the file and gets its size
+  void Open();
+
+  void ReadRawChunk(void* buffer, size_t bytes, Index buffer_offset, Index file_offset);
+};
+
+/**
+ * @brief Lists the files like FileLabelLoader; the files are read by the operator, which
+ *        places their contents in the GPU memory.
+ */
+class FileLabelLoaderGPU
+    : public FileLabelLoaderBase<GPUBackend, FileLabelWrapperGPU, CUFileStream> {
+ public:
+  using FileLabelLoaderBase<GPUBackend, FileLabelWrapperGPU, CUFileStream>::FileLabelLoaderBase;
+
+  ~FileLabelLoaderGPU() override {
+    // the samples may still hold cuFile resources, release them while cuFile is accessible
+    last_sample_ptr_tmp.reset();
+    sample_buffer_.clear();
+    empty_tensors_.clear();
+  }
+
+  void PrepareEmpty(FileLabelWrapperGPU& target) override;
+  void ReadSample(FileLabelWrapperGPU& target) override;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_LOADER_FILE_LABEL_LOADER_GPU_H_
@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -82,6 +82,8 @@ class FileLoader : public Loader<Backend, Target> {
      * Still when `shuffle_after_epoch` we will set `stick_to_shard` internally in the FileLoader so
      * all DALI instances will do shuffling after each epoch
      */
+    DALI_ENFORCE(!(shuffle_after_epoch_ && global_shuffle_),
+                 "shuffle_after_epoch and global_shuffle cannot be both true");
     DALI_ENFORCE(!(shuffle_after_epoch_ && stick_to_shard_),
                  "shuffle_after_epoch and stick_to_shard cannot be both true");
     DALI_ENFORCE(!(shuffle_after_epoch_ && shuffle_),
@@ -142,6 +144,7 @@ class FileLoader : public Loader<Backend, Target> {
     }
 
     current_epoch_++;
+    ShuffleGlobally();
 
     if (shuffle_after_epoch_) {
       std::mt19937 g(kDaliDataloaderSeed + current_epoch_);
@@ -152,6 +155,7 @@ class FileLoader : public Loader<Backend, Target> {
   using Loader<Backend, Target>::shard_id_;
   using Loader<Backend, Target>::num_shards_;
   using Loader<Backend, Target>::stick_to_shard_;
+  using Loader<Backend, Target>::global_shuffle_;
   using Loader<Backend, Target>::shuffle_;
   using Loader<Backend, Target>::dont_use_mmap_;
   using Loader<Backend, Target>::initial_buffer_fill_;
@@ -160,6 +164,8 @@ class FileLoader : public Loader<Backend, Target> {
   using Loader<Backend, Target>::MoveToNextShard;
   using Loader<Backend, Target>::ShouldSkipImage;
   using Loader<Backend, Target>::Size;
+  using Loader<Backend, Target>::ShuffleGlobally;
+  using Loader<Backend, Target>::GlobalSampleIndex;
   using Loader<Backend, Target>::PrepareEmptyTensor;
 
   string file_list_, file_root_, file_filter_;
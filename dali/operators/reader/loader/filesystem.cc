@@ -19,6 +19,7 @@
 #include <sys/stat.h>
 #include <algorithm>
 #include <cstring>
+#include <iterator>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,6 +31,94 @@
 namespace dali {
 namespace filesystem {
 
+namespace {
+
+// smaller lists are not worth splitting
+constexpr size_t kMinFileListChunk = 1 << 18;
+
+struct FileListChunk {
+  vector<std::pair<string, int>> entries;
+  int64_t num_lines = 0;
+  // the (0-based) number of the first incorrect line in the chunk and its contents
+  int64_t error_line = -1;
+  string error_text;
+};
+
+void parse_file_list_chunk(FileListChunk &chunk, char *begin, char *end) {
+  int64_t line_no = -1;
+  chunk.num_lines = ForEachLine(begin, end, [&](char *line, size_t length) {
+    line_no++;
+    if (chunk.error_line >= 0)
+      return;
+    // parse the line backwards:
+    // - skip trailing whitespace
+    // - consume digits
+    // - skip whitespace between label and
+    int i = static_cast<int>(length) - 1;
+
+    for (; i >= 0 && isspace(line[i]); i--) {}  // skip trailing spaces
+
+    int label_end = i + 1;
+
+    if (i < 0)  // empty line - skip
+      return;
+
+    for (; i >= 0 && isdigit(line[i]); i--) {}  // skip
+
+    int label_start = i + 1;
+
+    for (; i >= 0 && isspace(line[i]); i--) {}
+
+    int name_end = i + 1;
+    if (!(name_end > 0 && name_end < label_start && label_start >= 2 &&
+          label_end > label_start)) {
+      chunk.error_line = line_no;
+      chunk.error_text = line;
+      return;
+    }
+
+    line[label_end] = 0;
+    line[name_end] = 0;
+
+    chunk.entries.emplace_back(line, std::atoi(line + label_start));
+  });
+}
+
+}  // namespace
+
+vector<std::pair<string, int>> parse_file_list(std::istream &list, const string &name,
+                                               int num_threads) {
+  // The list is split into chunks of whole lines, which are parsed in place, in parallel
+  string text = ReadWholeStream(list);
+  auto offsets = SplitIntoLineChunks(text.data(), text.size(), 4 * num_threads,
+                                     kMinFileListChunk);
+  int num_chunks = offsets.size() - 1;
+  vector<FileListChunk> chunks(num_chunks);
+  ParseChunks(num_chunks, num_threads, [&](int i) {
+    parse_file_list_chunk(chunks[i], &text[0] + offsets[i], &text[0] + offsets[i + 1]);
+  });
+
+  size_t total = 0;
+  int64_t line_offset = 0;
+  for (auto &chunk : chunks) {
+    DALI_ENFORCE(chunk.error_line < 0,
+                 make_string("Incorrect format of the list file \"",  name, "\":",
+                             line_offset + chunk.error_line + 1,
+                             " expected file name followed by a label; got: ", chunk.error_text));
+    line_offset += chunk.num_lines;
+    total += chunk.entries.size();
+  }
+  if (num_chunks == 1)
+    return std::move(chunks[0].entries);
+  vector<std::pair<string, int>> entries;
+  entries.reserve(total);
+  for (auto &chunk : chunks) {
+    entries.insert(entries.end(), std::make_move_iterator(chunk.entries.begin()),
+                   std::make_move_iterator(chunk.entries.end()));
+  }
+  return entries;
+}
+
 std::string join_path(const std::string &dir, const std::string &path) {
   if (dir.empty())
     return path;
@@ -78,9 +167,33 @@ inline void assemble_file_list(std::vector<std::pair<std::string, int>> &file_la
   closedir(dir);
 }
 
+namespace {
+
+inline dir_stamp make_dir_stamp(const std::string &name, const struct stat &s) {
+  return { name, static_cast<int64_t>(s.st_mtim.tv_sec), static_cast<int64_t>(s.st_mtim.tv_nsec) };
+}
+
+}  // namespace
+
+dir_stamp get_dir_stamp(const std::string &file_root, const std::string &name) {
+  struct stat s;
+  std::string full_path = join_path(file_root, name);
+  DALI_ENFORCE(stat(full_path.c_str(), &s) == 0 && S_ISDIR(s.st_mode),
+      "Could not access directory " + full_path);
+  return make_dir_stamp(name, s);
+}
+
 vector<std::pair<string, int>> traverse_directories(const std::string &file_root,
                                                     const std::vector<std::string> &filters,
-                                                    const bool case_sensitive_filter) {
+                                                    const bool case_sensitive_filter,
+                                                    vector<dir_stamp> *dirs) {
+  // the times are taken before listing the contents - if anything changes in the meantime,
+  // the stamps are outdated rather than seemingly up to date
+  if (dirs) {
+    dirs->clear();
+    dirs->push_back(get_dir_stamp(file_root, ""));
+  }
+
   // open the root
   DIR *dir = opendir(file_root.c_str());
 
@@ -91,6 +204,7 @@ vector<std::pair<string, int>> traverse_directories(const std::string &file_root
 
   std::vector<std::pair<std::string, int>> file_label_pairs;
   std::vector<std::string> entry_name_list;
+  std::vector<dir_stamp> entry_stamps;
 
   while ((entry = readdir(dir))) {
     struct stat s;
@@ -102,12 +216,19 @@ vector<std::pair<string, int>> traverse_directories(const std::string &file_root
     if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
     if (S_ISDIR(s.st_mode)) {
       entry_name_list.push_back(entry_name);
+      if (dirs)
+        entry_stamps.push_back(make_dir_stamp(entry_name, s));
     }
   }
   // sort directories to preserve class alphabetic order, as readdir could
   // return unordered dir list. Otherwise file reader for training and validation
   // could return directories with the same names in completely different order
   std::sort(entry_name_list.begin(), entry_name_list.end());
+  if (dirs) {
+    std::sort(entry_stamps.begin(), entry_stamps.end(),
+              [](const dir_stamp &a, const dir_stamp &b) { return a.name < b.name; });
+    dirs->insert(dirs->end(), entry_stamps.begin(), entry_stamps.end());
+  }
   for (unsigned dir_count = 0; dir_count < entry_name_list.size(); ++dir_count) {
       assemble_file_list(file_label_pairs, file_root, entry_name_list[dir_count], dir_count,
                          filters, case_sensitive_filter);
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_READER_LOADER_FILESYSTEM_H_
 #define DALI_OPERATORS_READER_LOADER_FILESYSTEM_H_
 
+#include <istream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,12 +26,44 @@ namespace filesystem {
 
 DLL_PUBLIC vector<string> traverse_directories(const string &path, const string &filter);
 
+/**
+ * @brief The modification time of a directory
+ */
+struct dir_stamp {
+  string name;  ///< the path relative to the traversed root; empty for the root itself
+  int64_t mtime_sec, mtime_nsec;
+
+  bool operator==(const dir_stamp &other) const {
+    return name == other.name && mtime_sec == other.mtime_sec && mtime_nsec == other.mtime_nsec;
+  }
+};
+
 /**
  * @brief Finds all (file, label) pairs matching any filter from the list.
+ *
+ * @param dirs  If not null, receives the modification times of the root and of the traversed
+ *              subdirectories (in label order) - the result remains valid as long as they don't
+ *              change.
  */
 DLL_PUBLIC vector<std::pair<string, int>> traverse_directories(
     const string &file_root, const vector<string> &filters,
-    const bool case_sensitive_filter = false);
+    const bool case_sensitive_filter = false, vector<dir_stamp> *dirs = nullptr);
+
+/**
+ * @brief Parses a list of (file, label) pairs, one per line, with the label separated from the
+ *        file name by whitespace; the empty lines are skipped.
+ *
+ * A large list is split into chunks of lines, parsed in parallel by `num_threads` threads.
+ *
+ * @param name  The name of the list, for the error messages
+ */
+DLL_PUBLIC vector<std::pair<string, int>> parse_file_list(std::istream &list, const string &name,
+                                                          int num_threads = 1);
+
+/**
+ * @brief Returns the modification time of a directory or throws, if it can't be accessed.
+ */
+DLL_PUBLIC dir_stamp get_dir_stamp(const string &file_root, const string &name);
 
 /**
  * @brief Prepends dir to a relative path and keeps absolute path unchanged.
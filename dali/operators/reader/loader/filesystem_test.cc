@@ -15,6 +15,7 @@
 #include <glob.h>
 #include <gtest/gtest.h>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -147,4 +148,45 @@ TEST_F(FilesystemTest, CaseInsensitiveFilters) {
     EXPECT_EQ(correct_match[i], file_label_pairs_filtered[i].first);
   }
 }
+
+TEST(FileListTest, ParseInParallel) {
+  std::stringstream ss;
+  for (int i = 0; i < 30000; i++) {
+    ss << "dir " << i % 7 << "/file_" << i << ".jpg \t" << i % 1000 << "  \n";
+    if (i % 1000 == 0)
+      ss << "\n";
+  }
+  ss << "last.jpg 5";  // no line break at the end
+  for (int num_threads : {1, 4}) {
+    ss.clear();
+    ss.seekg(0);
+    auto entries = filesystem::parse_file_list(ss, "list.txt", num_threads);
+    ASSERT_EQ(entries.size(), 30001u);
+    for (int i = 0; i < 30000; i++) {
+      EXPECT_EQ(entries[i].first, make_string("dir ", i % 7, "/file_", i, ".jpg"));
+      EXPECT_EQ(entries[i].second, i % 1000);
+    }
+    EXPECT_EQ(entries.back().first, "last.jpg");
+    EXPECT_EQ(entries.back().second, 5);
+  }
+}
+
+TEST(FileListTest, IncorrectLine) {
+  std::stringstream ss;
+  for (int i = 0; i < 30000; i++)
+    ss << "file_" << i << ".jpg " << i << "\n";
+  ss << "no_label.jpg\n";
+  for (int num_threads : {1, 4}) {
+    ss.clear();
+    ss.seekg(0);
+    try {
+      filesystem::parse_file_list(ss, "list.txt", num_threads);
+      FAIL() << "Expected an error";
+    } catch (const std::runtime_error &e) {
+      EXPECT_NE(std::string(e.what()).find("\"list.txt\":30001 expected file name"),
+                std::string::npos) << e.what();
+    }
+  }
+}
+
 }  // namespace dali
@@ -15,11 +15,15 @@
 #ifndef DALI_OPERATORS_READER_LOADER_INDEXED_FILE_LOADER_H_
 #define DALI_OPERATORS_READER_LOADER_INDEXED_FILE_LOADER_H_
 
+#include <algorithm>
 #include <vector>
+#include <random>
 #include <string>
 #include <tuple>
 #include <fstream>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 
 #include "dali/core/common.h"
 #include "dali/operators/reader/loader/loader.h"
@@ -34,6 +38,12 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
       uris_(options.GetRepeatedArgument<std::string>("path")),
       index_uris_(options.GetRepeatedArgument<std::string>("index_path")),
       current_index_(0), current_file_index_(0), current_file_(nullptr) {
+      options.TryGetArgument(interleave_files_, "interleave_files");
+      DALI_ENFORCE(interleave_files_ >= 0, "``interleave_files`` must not be negative.");
+      DALI_ENFORCE(interleave_files_ == 0 || !global_shuffle_,
+                   "``interleave_files`` cannot be used with ``global_shuffle``.");
+      std::seed_seq seq({seed_});
+      interleave_rng_ = std::default_random_engine(seq);
     }
 
   void ReadSample(Tensor<CPUBackend>& tensor) override {
@@ -41,17 +51,17 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
 
     int64 seek_pos, size;
     size_t file_index;
-    std::tie(seek_pos, size, file_index) = indices_[current_index_];
-    ++current_index_;
+    size_t pos = current_index_++;
+    std::tie(seek_pos, size, file_index) = indices_[SampleIndex(pos)];
 
     std::string image_key = uris_[file_index] + " at index " + to_string(seek_pos);
     DALIMeta meta;
     meta.SetSourceInfo(image_key);
     meta.SetSkipSample(false);
 
-    if (file_index != current_file_index_) {
+    if (interleave_files_ == 0 && !global_shuffle_ && file_index != current_file_index_) {
       current_file_->Close();
-      current_file_ = FileStream::Open(uris_[file_index], read_ahead_, !copy_read_data_);
+      current_file_ = OpenStream(uris_[file_index], read_ahead_, !copy_read_data_);
       current_file_index_ = file_index;
     }
 
@@ -65,15 +75,32 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
       return;
     }
 
-    if (should_seek_ || next_seek_pos_ != seek_pos) {
-      current_file_->Seek(seek_pos);
-      should_seek_ = false;
+    if (global_shuffle_) {
+      // the consecutive samples are scattered over the files, so they're read in batches
+      ReadPrefetched(tensor, pos, size);
+      tensor.SetMeta(meta);
+      return;
+    }
+
+    FileStream *file;
+    if (interleave_files_ > 0) {
+      auto &open_file = GetInterleavedFile(file_index);
+      if (open_file.next_pos != seek_pos)
+        open_file.stream->Seek(seek_pos);
+      open_file.next_pos = seek_pos + size;
+      file = open_file.stream.get();
+    } else {
+      if (should_seek_ || next_seek_pos_ != seek_pos) {
+        current_file_->Seek(seek_pos);
+        should_seek_ = false;
+      }
+      next_seek_pos_ = seek_pos + size;
+      file = current_file_.get();
     }
-    next_seek_pos_ = seek_pos + size;
 
     if (!copy_read_data_) {
-      auto p = current_file_->Get(size);
-      DALI_ENFORCE(p != nullptr, "Error reading from a file " + uris_[current_file_index_]);
+      auto p = file->Get(size);
+      DALI_ENFORCE(p != nullptr, "Error reading from a file " + uris_[file_index]);
       // Wrap the raw data in the Tensor object.
       tensor.ShareData(p, size, false, {size}, DALI_UINT8);
     } else {
@@ -82,9 +109,8 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
       }
       tensor.Resize({size}, DALI_UINT8);
 
-      int64 n_read = current_file_->Read(reinterpret_cast<uint8_t*>(tensor.raw_mutable_data()),
-                          size);
-      DALI_ENFORCE(n_read == size, "Error reading from a file " + uris_[current_file_index_]);
+      int64 n_read = file->Read(reinterpret_cast<uint8_t*>(tensor.raw_mutable_data()), size);
+      DALI_ENFORCE(n_read == size, "Error reading from a file " + uris_[file_index]);
     }
 
     tensor.SetMeta(meta);
@@ -95,6 +121,10 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     if (current_file_ != nullptr) {
       current_file_->Close();
     }
+    for (auto &open_file : open_files_)
+      open_file.stream->Close();
+    for (auto &prefetch_file : prefetch_files_)
+      prefetch_file.second->Close();
   }
 
   virtual void ReadIndexFile(const std::vector<std::string>& index_uris) {
@@ -119,7 +149,8 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
   void PrepareMetadataImpl() override {
     if (!dont_use_mmap_) {
       mmap_reserver_ = FileStream::MappingReserver(
-                                  static_cast<unsigned int>(initial_buffer_fill_));
+                                  static_cast<unsigned int>(initial_buffer_fill_ +
+                                                            interleave_files_));
     }
     copy_read_data_ = dont_use_mmap_ || !mmap_reserver_.CanShareMappedData();
 
@@ -138,17 +169,164 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     } else {
       current_index_ = 0;
     }
-    std::tie(seek_pos, size, file_index) = indices_[current_index_];
+    ShuffleGlobally();
+    prefetched_.clear();
+    if (interleave_files_ > 0) {
+      MakeInterleavedOrder(current_index_, ShardEnd());
+      return;
+    }
+    std::tie(seek_pos, size, file_index) = indices_[SampleIndex(current_index_)];
     if (file_index != current_file_index_) {
       if (current_file_index_ != static_cast<size_t>(INVALID_INDEX)) {
         current_file_->Close();
       }
-      current_file_ = FileStream::Open(uris_[file_index], read_ahead_, !copy_read_data_);
+      current_file_ = OpenStream(uris_[file_index], read_ahead_, !copy_read_data_);
       current_file_index_ = file_index;
     }
     current_file_->Seek(seek_pos);
   }
 
+  /**
+   * @brief Returns the index (in `indices_`) of the sample at given position in the epoch
+   */
+  size_t SampleIndex(size_t pos) const {
+    return interleave_files_ > 0 ? order_[pos - order_begin_] : GlobalSampleIndex(pos);
+  }
+
+  /**
+   * @brief Wraps the data of the sample at position `pos` in the epoch, read ahead by
+   *        PrefetchSamples, in `tensor`
+   */
+  void ReadPrefetched(Tensor<CPUBackend> &tensor, size_t pos, int64 size) {
+    if (pos < prefetch_begin_ || pos >= prefetch_begin_ + prefetched_.size())
+      PrefetchSamples(pos);
+    tensor.ShareData(std::move(prefetched_[pos - prefetch_begin_]), size, false, {size},
+                     DALI_UINT8);
+  }
+
+  /**
+   * @brief Reads the samples of the prefetch queue (`prefetch_queue_depth` batches), starting
+   *        at position `pos` in the epoch, at once
+   *
+   * The reads are submitted together with FileStream::ReadBatch (through io_uring, if the system
+   * supports it), so that the storage can service them in parallel.
+   */
+  void PrefetchSamples(size_t pos) {
+    auto upcoming = UpcomingSampleIndices(pos, initial_empty_size_ / 2);
+    std::vector<FileStream::ReadRequest> requests(upcoming.size());
+    std::unordered_map<size_t, std::unique_ptr<FileStream>> files;
+    prefetched_.resize(upcoming.size());
+    for (size_t i = 0; i < upcoming.size(); i++) {
+      int64 seek_pos, size;
+      size_t file_index;
+      std::tie(seek_pos, size, file_index) = indices_[upcoming[i]];
+      auto &file = files[file_index];
+      if (!file) {
+        auto it = prefetch_files_.find(file_index);
+        if (it != prefetch_files_.end())
+          file = std::move(it->second);
+        else
+          file = OpenStream(uris_[file_index], false, false, true);
+      }
+      prefetched_[i] = std::shared_ptr<uint8_t>(new uint8_t[size],
+                                                std::default_delete<uint8_t[]>());
+      requests[i].stream = file.get();
+      requests[i].buffer = prefetched_[i].get();
+      requests[i].n_bytes = size;
+      requests[i].offset = seek_pos;
+    }
+    // close the files which are not used by this batch
+    for (auto &prefetch_file : prefetch_files_) {
+      if (prefetch_file.second)
+        prefetch_file.second->Close();
+    }
+    prefetch_files_ = std::move(files);
+    prefetch_begin_ = pos;
+
+    FileStream::ReadBatch(make_span(requests));
+    for (size_t i = 0; i < upcoming.size(); i++) {
+      DALI_ENFORCE(requests[i].bytes_read == requests[i].n_bytes,
+                   "Error reading from a file " + uris_[std::get<2>(indices_[upcoming[i]])]);
+    }
+  }
+
+  /**
+   * @brief Arranges the samples in range [begin, end) so that at most `interleave_files_` files
+   *        are read at the same time, each of them sequentially.
+   *
+   * The samples of each file form a contiguous run. The runs are visited in random order and
+   * the samples are taken from a random one of the current runs (if `random_shuffle` is set) or
+   * in file order and round-robin, respectively.
+   */
+  void MakeInterleavedOrder(size_t begin, size_t end) {
+    std::vector<std::pair<size_t, size_t>> runs;
+    for (size_t i = begin; i < end; i++) {
+      if (runs.empty() || std::get<2>(indices_[i]) != std::get<2>(indices_[i - 1]))
+        runs.emplace_back(i, i + 1);
+      else
+        runs.back().second = i + 1;
+    }
+    if (shuffle_)
+      std::shuffle(runs.begin(), runs.end(), interleave_rng_);
+
+    order_.clear();
+    order_.reserve(end - begin);
+    order_begin_ = begin;
+    std::vector<std::pair<size_t, size_t>> current;
+    size_t next_run = 0, pick = 0;
+    for (;;) {
+      while (current.size() < static_cast<size_t>(interleave_files_) && next_run < runs.size())
+        current.push_back(runs[next_run++]);
+      if (current.empty())
+        break;
+      if (shuffle_) {
+        pick = std::uniform_int_distribution<size_t>(0, current.size() - 1)(interleave_rng_);
+      } else if (pick >= current.size()) {
+        pick = 0;
+      }
+      auto &run = current[pick];
+      order_.push_back(run.first++);
+      if (run.first == run.second)
+        current.erase(current.begin() + pick);  // a new run is added at the end
+      else
+        pick++;
+    }
+  }
+
+  struct OpenFile {
+    size_t index;
+    std::unique_ptr<FileStream> stream;
+    int64 next_pos;
+    int64 last_use;
+  };
+
+  /**
+   * @brief Returns an open stream for the given file, closing the least recently used one,
+   *        if there are already `interleave_files_` streams open.
+   */
+  OpenFile &GetInterleavedFile(size_t file_index) {
+    use_counter_++;
+    for (auto &open_file : open_files_) {
+      if (open_file.index == file_index) {
+        open_file.last_use = use_counter_;
+        return open_file;
+      }
+    }
+    if (open_files_.size() >= static_cast<size_t>(interleave_files_)) {
+      auto lru = std::min_element(open_files_.begin(), open_files_.end(),
+          [](const OpenFile &a, const OpenFile &b) { return a.last_use < b.last_use; });
+      lru->stream->Close();
+      open_files_.erase(lru);
+    }
+    auto stream = OpenStream(uris_[file_index], read_ahead_, !copy_read_data_);
+    stream->SetReadAhead(kInterleavedReadAhead);
+    open_files_.push_back({ file_index, std::move(stream), 0, use_counter_ });
+    return open_files_.back();
+  }
+
+  // the read-ahead of each of the interleaved files
+  static constexpr size_t kInterleavedReadAhead = 4 << 20;
+
   std::vector<std::string> uris_;
   std::vector<std::string> index_uris_;
   std::vector<std::tuple<int64, int64, size_t>> indices_;
@@ -159,6 +337,19 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
   static constexpr int INVALID_INDEX = -1;
   bool should_seek_ = false;
   int64 next_seek_pos_ = 0;
+
+  int interleave_files_ = 0;
+  std::default_random_engine interleave_rng_;
+  std::vector<size_t> order_;  // the samples of the current epoch, when interleaving files
+  size_t order_begin_ = 0;
+  std::vector<OpenFile> open_files_;
+  int64 use_counter_ = 0;
+
+  // with global_shuffle: the samples read ahead, starting at position prefetch_begin_,
+  // and the files they were read from
+  std::vector<std::shared_ptr<uint8_t>> prefetched_;
+  size_t prefetch_begin_ = 0;
+  std::unordered_map<size_t, std::unique_ptr<FileStream>> prefetch_files_;
 };
 
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,8 +16,14 @@
 #define DALI_OPERATORS_READER_LOADER_LMDB_H_
 
 #include <lmdb.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "dali/core/common.h"
@@ -31,12 +37,35 @@ namespace dali {
                                         ", with file: " + filename); \
   } while (0)
 
+/**
+ * @brief Brings the memory-mapped pages of the value into memory
+ *
+ * It's run by the I/O threads, so that the storage is read by them, in parallel, rather than
+ * by the parser, when it page-faults on the value.
+ */
+inline void PrefaultValue(const MDB_val &value) {
+  if (value.mv_size == 0)
+    return;
+  static const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  auto begin = reinterpret_cast<uintptr_t>(value.mv_data);
+  auto end = begin + value.mv_size;
+  auto page_begin = begin & ~(page_size - 1);
+#if !defined(__AARCH64_QNX__) && !defined(__AARCH64_GNU__) && !defined(__aarch64__)
+  madvise(reinterpret_cast<void *>(page_begin), end - page_begin, MADV_WILLNEED);
+#endif
+  char sum = 0;
+  for (uintptr_t page = page_begin; page < end; page += page_size)
+    sum += *reinterpret_cast<const volatile char *>(std::max(page, begin));
+  (void)sum;
+}
 
 class IndexedLMDB {
   MDB_env* mdb_env_ = nullptr;
   MDB_cursor* mdb_cursor_ = nullptr;
   MDB_dbi mdb_dbi_;
   MDB_txn* mdb_transaction_ = nullptr;
+  // Owns the environment and the read transaction
+  std::shared_ptr<void> mapping_;
   int num_;
   Index mdb_index_;
   std::string db_path_;
@@ -53,6 +82,11 @@ class IndexedLMDB {
 
     // Create transaction and cursor
     CHECK_LMDB(mdb_txn_begin(mdb_env_, NULL, MDB_RDONLY, &mdb_transaction_), db_path_);
+    // The values stay valid, in the memory map, as long as the read transaction is alive
+    mapping_ = std::shared_ptr<void>(nullptr, [env = mdb_env_, txn = mdb_transaction_](void *) {
+      mdb_txn_abort(txn);
+      mdb_env_close(env);
+    });
     CHECK_LMDB(mdb_dbi_open(mdb_transaction_, NULL, 0, &mdb_dbi_), db_path_);
     CHECK_LMDB(mdb_cursor_open(mdb_transaction_, mdb_dbi_, &mdb_cursor_), db_path_);
     MDB_stat stat;
@@ -63,6 +97,41 @@ class IndexedLMDB {
     mdb_index_ = 0;
   }
   size_t GetSize() const { return mdb_size_; }
+
+  /**
+   * @brief Returns a pointer to the value which keeps the memory map alive
+   *
+   * The value is not copied - the environment and the read transaction are closed only when
+   * the last of such pointers is released, even if the database is closed before.
+   */
+  std::shared_ptr<void> ShareValue(const MDB_val &value) const {
+    return std::shared_ptr<void>(mapping_, value.mv_data);
+  }
+
+  /**
+   * @brief Lists the keys and the values of all the entries, in one pass of the cursor
+   *
+   * The values point to the memory map, so they stay valid as long as the read transaction and
+   * can be then accessed in any order, from any thread, without moving the cursor.
+   */
+  std::vector<std::pair<MDB_val, MDB_val>> ListEntries() {
+    std::vector<std::pair<MDB_val, MDB_val>> entries;
+    entries.reserve(mdb_size_);
+    MDB_val key, value;
+    int status = mdb_cursor_get(mdb_cursor_, &key, &value, MDB_FIRST);
+    while (status == MDB_SUCCESS) {
+      entries.emplace_back(key, value);
+      status = mdb_cursor_get(mdb_cursor_, &key, &value, MDB_NEXT);
+    }
+    if (status != MDB_NOTFOUND)
+      CHECK_LMDB(status, db_path_);
+    DALI_ENFORCE(static_cast<Index>(entries.size()) == mdb_size_, make_string(
+        "lmdb ", db_path_, " has ", entries.size(), " entries, expected ", mdb_size_, "."));
+    if (mdb_size_ > 0)
+      SeekByIndex(0);
+    return entries;
+  }
+
   Index GetIndex() const { return mdb_index_; }
   void SeekByIndex(Index index, MDB_val* key = nullptr, MDB_val* value = nullptr) {
     MDB_val tmp_key, tmp_value;
@@ -110,14 +179,9 @@ class IndexedLMDB {
       mdb_dbi_close(mdb_env_, mdb_dbi_);
       mdb_cursor_ = nullptr;
     }
-    if (mdb_transaction_) {
-      mdb_txn_abort(mdb_transaction_);
-      mdb_transaction_ = nullptr;
-    }
-    if (mdb_env_) {
-      mdb_env_close(mdb_env_);
-      mdb_env_ = nullptr;
-    }
+    mapping_.reset();
+    mdb_transaction_ = nullptr;
+    mdb_env_ = nullptr;
   }
 };
 
@@ -165,13 +229,22 @@ class LMDBLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
   }
 
   void ReadSample(Tensor<CPUBackend>& tensor) override {
-    // assume cursor is valid, read next, loop to start if necessary
+    auto read = ReadSampleDeferred(tensor);
+    if (read)
+      read();
+  }
 
+  std::function<void()> ReadSampleDeferred(Tensor<CPUBackend>& tensor) override {
     Index file_index, local_index;
-    MapIndexToFile(current_index_, file_index, local_index);
+    MapIndexToFile(GlobalSampleIndex(current_index_), file_index, local_index);
 
     MDB_val key, value;
-    mdb_[file_index].SeekByIndex(local_index, &key, &value);
+    if (entries_.empty()) {
+      // assume cursor is valid, read next, loop to start if necessary
+      mdb_[file_index].SeekByIndex(local_index, &key, &value);
+    } else {
+      std::tie(key, value) = entries_[file_index][local_index];
+    }
     ++current_index_;
 
     MoveToNextShard(current_index_);
@@ -189,14 +262,15 @@ class LMDBLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
       tensor.Reset();
       tensor.SetMeta(meta);
       tensor.Resize({0}, DALI_UINT8);
-      return;
+      return {};
     }
 
+    // The sample shares the memory-mapped pages, so that the parser reads the datum in place
+    tensor.ShareData(mdb_[file_index].ShareValue(value), value.mv_size, false,
+                     {static_cast<Index>(value.mv_size)}, DALI_UINT8);
     tensor.SetMeta(meta);
-    tensor.Resize({static_cast<Index>(value.mv_size)}, DALI_UINT8);
-    std::memcpy(tensor.raw_mutable_data(),
-                reinterpret_cast<uint8_t*>(value.mv_data),
-                value.mv_size * sizeof(uint8_t));
+    // Only the reads of the pages from the storage are left for the I/O threads
+    return [value]() { PrefaultValue(value); };
   }
 
  protected:
@@ -212,6 +286,13 @@ class LMDBLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
       mdb_[i].Open(db_paths_[i], i);
       offsets_[i + 1] = offsets_[i] + mdb_[i].GetSize();
     }
+    // The cursor can only step to the neighboring entries - the samples of the permutation
+    // are looked up in the list of the entries instead
+    if (global_shuffle_) {
+      entries_.resize(mdb_.size());
+      for (size_t i = 0; i < mdb_.size(); i++)
+        entries_[i] = mdb_[i].ListEntries();
+    }
     Reset(true);
   }
 
@@ -223,6 +304,9 @@ class LMDBLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     } else {
       current_index_ = 0;
     }
+    ShuffleGlobally();
+    if (!entries_.empty())
+      return;
     Index file_index, local_index;
     MapIndexToFile(current_index_, file_index, local_index);
 
@@ -230,8 +314,13 @@ class LMDBLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
   }
   using Loader<CPUBackend, Tensor<CPUBackend>>::shard_id_;
   using Loader<CPUBackend, Tensor<CPUBackend>>::num_shards_;
+  using Loader<CPUBackend, Tensor<CPUBackend>>::global_shuffle_;
+  using Loader<CPUBackend, Tensor<CPUBackend>>::ShuffleGlobally;
+  using Loader<CPUBackend, Tensor<CPUBackend>>::GlobalSampleIndex;
 
   std::vector<IndexedLMDB> mdb_;
+  // The keys and the values of the entries of each database, listed for ``global_shuffle``
+  std::vector<std::vector<std::pair<MDB_val, MDB_val>>> entries_;
 
   Index current_index_ = 0;
 
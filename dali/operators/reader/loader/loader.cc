@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -41,6 +41,26 @@ the entire dataset.
 
 If decoder caching is used, it significantly reduces the amount of data to be cached, but
 might affect accuracy of the training.)code", false)
+  .AddOptionalArg("global_shuffle",
+      R"code(Determines whether to read the samples in the order of a random permutation of the
+entire dataset, drawn anew in every epoch.
+
+Unlike ``random_shuffle``, which picks the samples randomly from a buffer of ``initial_fill``
+consecutive ones, this shuffle doesn't depend on the order of the samples in the dataset (e.g. a
+dataset sorted by class is still shuffled uniformly) and doesn't need the buffer. The permutation
+is the same in all the shards, which read consecutive parts of it, so that each epoch goes through
+the entire dataset exactly once. This option implies ``stick_to_shard`` and cannot be combined with
+``random_shuffle``.
+
+A checkpoint of a reader with this option can be restored with a different ``num_shards`` (e.g.
+when an elastic training changes the number of ranks in the middle of an epoch): the samples of
+the epoch, which none of the old shards read, are split between the new shards and read before
+the next epoch. The old shards are assumed to have read the same number of batches.
+
+.. note::
+  Currently ``readers.file``, ``readers.coco``, ``readers.numpy``, ``readers.zarr``,
+  ``readers.tfrecord``, ``readers.mxnet``, ``readers.webdataset``, ``readers.caffe`` and
+  ``readers.caffe2`` support this option; the other readers raise an error.)code", false)
   .AddOptionalArg("read_ahead",
       R"code(Determines whether the accessed data should be read ahead.
 
@@ -71,7 +91,76 @@ the file in memory.
 
 Mapping provides a small performance benefit when accessing a local file system, but most network file
 systems, do not provide optimum performance.
-)code", false);
+)code", false)
+  .AddOptionalArg("num_io_threads",
+      R"code(Number of threads used to read the sample data.
+
+With a value greater than 1, the reader keeps picking the samples in the same order, but the reads
+of the data are issued in parallel by a dedicated pool of threads. This helps to hide the
+latency of network and parallel file systems, where a single thread reading one file at a time
+cannot saturate the storage.
+
+.. note::
+  Currently only the readers loading one file per sample (like ``readers.file`` and
+  ``readers.coco``) and the LMDB readers (``readers.caffe`` and ``readers.caffe2``) make use of
+  this option; the other readers ignore it.)code", 1)
+  .AddOptionalArg("local_cache_dir",
+      R"code(A local directory (e.g. on an NVMe drive), where the reader keeps copies of the data
+files, so that the following epochs read them from there instead of the original storage.
+
+The files are copied whole, when first read, and evicted in the least-recently-used order, when
+their total size exceeds ``local_cache_size``. The copies are identified by the paths of the
+original files, so the dataset must not change while it's cached. The copies left in the
+directory by earlier runs are reused.
+
+If empty, the files are read directly.
+
+.. note::
+  Currently ``readers.file``, ``readers.coco``, ``readers.tfrecord``, ``readers.mxnet`` and
+  ``readers.webdataset`` make use of this option; the other readers ignore it.)code", std::string())
+  .AddOptionalArg<int64_t>("local_cache_size",
+      R"code(The maximum total size, in bytes, of the files kept in ``local_cache_dir``.
+
+If 0, the size is not limited.)code", 0)
+  .AddOptionalArg<int64_t>("memory_cache_size",
+      R"code(The size, in bytes, of the host memory, where the reader keeps the contents of the data
+files, so that the following epochs don't access the storage at all.
+
+The files are kept in memory, as they are read, until their total size reaches this value; they are
+never evicted. This way, when the (encoded) dataset fits in memory, it's read from the storage only
+once, while the decoded samples can still be augmented differently in each epoch. The files are
+identified by their paths, so the dataset must not change while it's cached.
+
+If 0, the memory cache is disabled.
+
+.. note::
+  Currently ``readers.file``, ``readers.coco``, ``readers.tfrecord``, ``readers.mxnet`` and
+  ``readers.webdataset`` make use of this option; the other readers ignore it.)code", 0)
+  .AddOptionalArg("file_handle_cache_size",
+      R"code(The number of files kept open by a reader loading one file per sample, so that reading
+them again doesn't require opening and closing them.
+
+On network and parallel file systems (NFS, Lustre), the metadata round trips of opening and closing
+a file can take longer than reading it, when the files are small. When the cache is enabled, the
+files of the next samples are also opened ahead of need, by the I/O threads (see ``num_io_threads``),
+while the current ones are read. The least recently used files are closed when the limit is reached.
+
+The cache is used only when the files are read without memory mapping (see ``dont_use_mmap``).
+If 0, each file is opened and closed for every sample it's read for.
+
+.. note::
+  Currently ``readers.file`` and ``readers.numpy`` make use of this option; the other readers
+  ignore it.)code", 0)
+  .AddOptionalArg("no_atime",
+      R"code(If set, the data files are opened with ``O_NOATIME``, so that reading them doesn't update
+their access time.
+
+This saves a metadata update per file on the storage. The flag is ignored for the files not owned
+by the user running the reader, for which it is not permitted.
+
+.. note::
+  Currently ``readers.file`` and ``readers.numpy`` make use of this option; the other readers
+  ignore it.)code", false);
 
 size_t start_index(const size_t shard_id,
                    const size_t shard_num,
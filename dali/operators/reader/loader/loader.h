@@ -15,10 +15,12 @@
 #ifndef DALI_OPERATORS_READER_LOADER_LOADER_H_
 #define DALI_OPERATORS_READER_LOADER_LOADER_H_
 
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <random>
 #include <string>
 #include <type_traits>
@@ -26,13 +28,20 @@
 #include <vector>
 #include <deque>
 #include <atomic>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "dali/core/nvtx.h"
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
 #include "dali/pipeline/operator/op_spec.h"
 #include "dali/pipeline/data/tensor.h"
+#include "dali/pipeline/util/thread_pool.h"
 #include "dali/operators/decoder/cache/image_cache_factory.h"
+#include "dali/util/file.h"
+#include "dali/util/file_handle_cache.h"
+#include "dali/util/local_file_cache.h"
+#include "dali/util/memory_file_cache.h"
 
 namespace dali {
 
@@ -42,6 +51,16 @@ DLL_PUBLIC size_t start_index(const size_t shard_id,
 
 DLL_PUBLIC Index num_samples(const size_t shard_num,
                              const size_t size);
+
+/**
+ * @brief The positions [begin, end) in the ``global_shuffle`` permutation of the epoch `epoch`
+ */
+struct EpochRange {
+  int64_t epoch;
+  int64_t begin;
+  int64_t end;
+};
+
 /**
  * @brief Base class for Loaders, responsible for reading samples from resource of some kind
  *        into memory.
@@ -66,6 +85,7 @@ class Loader {
       copy_read_data_(false),
       read_ahead_(options.GetArgument<bool>("read_ahead")),
       stick_to_shard_(options.GetArgument<bool>("stick_to_shard")),
+      global_shuffle_(options.GetArgument<bool>("global_shuffle")),
       device_id_(options.GetArgument<int>("device_id")),
       skip_cached_images_(options.GetArgument<bool>("skip_cached_images")),
       lazy_init_(options.GetArgument<bool>("lazy_init")),
@@ -73,17 +93,40 @@ class Loader {
       read_sample_counter_(0),
       returned_sample_counter_(0),
       pad_last_batch_(options.GetArgument<bool>("pad_last_batch")),
-      dont_use_mmap_(options.GetArgument<bool>("dont_use_mmap")) {
+      dont_use_mmap_(options.GetArgument<bool>("dont_use_mmap")),
+      num_io_threads_(options.GetArgument<int>("num_io_threads")),
+      file_handle_cache_size_(options.GetArgument<int>("file_handle_cache_size")),
+      no_atime_(options.GetArgument<bool>("no_atime")) {
     DALI_ENFORCE(initial_empty_size_ > 0, "Batch size needs to be greater than 0");
     DALI_ENFORCE(num_shards_ > shard_id_, "num_shards needs to be greater than shard_id");
+    DALI_ENFORCE(num_io_threads_ > 0, "num_io_threads needs to be greater than 0");
+    DALI_ENFORCE(!(global_shuffle_ && shuffle_),
+                 "global_shuffle and random_shuffle cannot be both true");
+    DALI_ENFORCE(!(global_shuffle_ && stick_to_shard_),
+                 "global_shuffle and stick_to_shard cannot be both true");
+    // Each shard reads its part of the permutation, which is different in every epoch
+    if (global_shuffle_)
+      stick_to_shard_ = true;
     // initialize a random distribution -- this will be
     // used to pick from our sample buffer
     std::seed_seq seq({seed_});
     e_ = std::default_random_engine(seq);
     virtual_shard_id_ = shard_id_;
+    auto local_cache_dir = options.GetArgument<std::string>("local_cache_dir");
+    if (!local_cache_dir.empty())
+      local_cache_ = LocalFileCache::Get(local_cache_dir,
+                                         options.GetArgument<int64_t>("local_cache_size"));
+    auto memory_cache_size = options.GetArgument<int64_t>("memory_cache_size");
+    DALI_ENFORCE(memory_cache_size >= 0, "memory_cache_size must not be negative");
+    if (memory_cache_size > 0)
+      memory_cache_ = std::make_unique<MemoryFileCache>(memory_cache_size);
+    DALI_ENFORCE(file_handle_cache_size_ >= 0, "file_handle_cache_size must not be negative");
   }
 
   virtual ~Loader() {
+    io_thread_pool_.reset();
+    queued_reads_.clear();
+    file_handle_cache_.reset();
     sample_buffer_.clear();
     empty_tensors_.clear();
   }
@@ -130,11 +173,12 @@ class Loader {
       for (int i = 0; i < initial_buffer_fill_; ++i) {
         auto tensor_ptr = LoadTargetUniquePtr(new LoadTarget());
         PrepareEmpty(*tensor_ptr);
-        ReadSample(*tensor_ptr);
+        ScheduleReadSample(*tensor_ptr);
         IncreaseReadSampleCounter();
         sample_buffer_.push_back(std::move(tensor_ptr));
         ++shards_.back().end;
       }
+      WaitForPendingReads();
 
       // need some entries in the empty_tensors_ list
       DomainTimeRange tr2("[DALI][Loader] Filling empty list", DomainTimeRange::kOrange);
@@ -172,6 +216,9 @@ class Loader {
 
     int offset = shuffle_ ? dis(e_) : 0;
     Index idx = (shards_.front().start + offset) % sample_buffer_.size();
+    // the sample may still be loaded by the I/O thread pool
+    if (pending_reads_.count(sample_buffer_[idx].get()))
+      WaitForPendingReads();
     LoadTargetSharedPtr sample_ptr(sample_buffer_[idx].release(),
       [this](LoadTarget* sample) {
         LoadTargetUniquePtr recycle_ptr(sample);
@@ -188,7 +235,7 @@ class Loader {
       tensor_ptr = std::move(empty_tensors_.back());
       empty_tensors_.pop_back();
     }
-    ReadSample(*tensor_ptr);
+    ScheduleReadSample(*tensor_ptr);
     IncreaseReadSampleCounter();
     std::swap(sample_buffer_[shards_.back().end % sample_buffer_.size()], tensor_ptr);
     ++shards_.back().end;
@@ -211,11 +258,233 @@ class Loader {
   // reads.
   virtual void ReadSample(LoadTarget& tensor) = 0;
 
+  /**
+   * @brief Advances the loader to the next sample and returns a function that reads its data
+   *        into `tensor`.
+   *
+   * It is used when the loader runs with more than one I/O thread: the call itself is always
+   * made from the prefetch thread, in sample order, so it should only do the (cheap) sequential
+   * part of ReadSample, like picking the next file and advancing the index. The returned function
+   * is run on the I/O thread pool and must only touch `tensor` and thread-safe members.
+   *
+   * The default implementation reads the sample immediately and returns an empty function.
+   */
+  virtual std::function<void()> ReadSampleDeferred(LoadTarget& tensor) {
+    ReadSample(tensor);
+    return {};
+  }
+
+  /**
+   * @brief Advances the loader past the next sample, see FastForward
+   *
+   * The default implementation makes only the sequential part of the read, with
+   * ReadSampleDeferred, so it's cheap for the loaders which override that function.
+   */
+  virtual void SkipSample() {
+    if (!skip_target_) {
+      skip_target_ = LoadTargetUniquePtr(new LoadTarget());
+      PrepareEmpty(*skip_target_);
+    }
+    ReadSampleDeferred(*skip_target_);
+  }
+
+  /**
+   * @brief Reads the next sample into `tensor`, possibly leaving the data reads queued
+   *        (see QueueRead), to be submitted together with the other reads of the batch
+   *
+   * It is used when the loader reads in the prefetch thread (a single I/O thread). The queued
+   * reads are complete after WaitForPendingReads.
+   *
+   * The default implementation reads the sample immediately, with ReadSample.
+   */
+  virtual void QueueReadSample(LoadTarget& tensor) {
+    ReadSample(tensor);
+  }
+
+  /**
+   * @brief Waits until all the reads scheduled on the I/O thread pool are complete
+   *
+   * Rethrows the first error encountered by the I/O threads.
+   */
+  void WaitForPendingReads() {
+    if (pending_reads_.empty())
+      return;
+    pending_reads_.clear();
+    FlushQueuedReads();
+    if (io_thread_pool_)
+      io_thread_pool_->WaitForWork();
+  }
+
+  /**
+   * @brief Moves the loader to the state it would be in after `num_samples` calls to ReadOne,
+   *        without reading the data of the samples which are already gone from it.
+   *
+   * Used to resume the reader from a checkpoint. Must be called before the first ReadOne.
+   * First, ReadOne is run without reading the data, which moves the sample buffer, the
+   * shuffling and the shard boundaries exactly as the original run did. Then, the reads are
+   * replayed in their order: the samples still held by the loader (the sample buffer and the
+   * padding sample) are read, the others are skipped with SkipSample.
+   *
+   * @param samples_per_batch the number of ReadOne calls per batch, see `is_new_batch`
+   */
+  void FastForward(int64_t num_samples, int samples_per_batch) {
+    DALI_ENFORCE(!initial_buffer_filled_,
+                 "The loader can only be fast-forwarded before it starts reading.");
+    DALI_ENFORCE(samples_per_batch > 0, "The batch size must be positive.");
+    if (num_samples == 0)
+      return;
+    dry_run_ = true;
+    dry_run_reads_ = 0;
+    for (int64_t i = 0; i < num_samples; i++)
+      ReadOne(i % samples_per_batch == 0);
+    dry_run_ = false;
+
+    std::unordered_map<Index, LoadTarget*> held;
+    for (auto &sample : sample_buffer_)
+      held[dry_run_ordinals_.at(sample.get())] = sample.get();
+    if (last_sample_ptr_tmp)
+      held[dry_run_ordinals_.at(last_sample_ptr_tmp.get())] = last_sample_ptr_tmp.get();
+    dry_run_ordinals_.clear();
+
+    for (Index ordinal = 0; ordinal < dry_run_reads_; ordinal++) {
+      auto it = held.find(ordinal);
+      if (it != held.end())
+        ScheduleReadSample(*it->second);
+      else
+        SkipSample();
+    }
+    WaitForPendingReads();
+  }
+
+  /**
+   * @brief Makes the shards read the samples at `ranges` before the regular epochs, which start
+   *        with the epoch `first_epoch`
+   *
+   * The samples of the ranges are split between the shards as the epochs are. The ranges are the
+   * samples left over from the epochs read with a different number of shards, see Reshard. Must be
+   * called before the first ReadOne; a loader resumed from a checkpoint restores the ranges and
+   * then is fast-forwarded within them, as usual.
+   */
+  void RestoreEpochRanges(std::vector<EpochRange> ranges, int64_t first_epoch) {
+    PrepareMetadata();
+    DALI_ENFORCE(!initial_buffer_filled_,
+                 "The epoch ranges can only be restored before the loader starts reading.");
+    DALI_ENFORCE(global_shuffle_, "Only the readers with ``global_shuffle`` can be resharded.");
+    Index size = SizeImpl();
+    Index total = 0;
+    for (auto &range : ranges) {
+      DALI_ENFORCE(range.epoch >= 0 && range.epoch < first_epoch &&
+                   range.begin >= 0 && range.begin <= range.end && range.end <= size,
+                   "The epoch ranges in the checkpoint don't match the data set.");
+      total += range.end - range.begin;
+    }
+    DALI_ENFORCE(total == 0 || !pad_last_batch_,
+                 "A reader with ``pad_last_batch`` cannot be resharded.");
+    leftover_ranges_ = std::move(ranges);
+    first_epoch_ = first_epoch;
+
+    // this shard's part of the concatenation of the ranges
+    Index begin = start_index(shard_id_, num_shards_, total);
+    Index end = start_index(shard_id_ + 1, num_shards_, total);
+    std::map<int64_t, std::vector<Index>> permutations;
+    leftover_indices_.clear();
+    Index range_start = 0;
+    for (auto &range : leftover_ranges_) {
+      Index from = std::max(begin - range_start, Index(0));
+      Index to = std::min(end - range_start, static_cast<Index>(range.end - range.begin));
+      range_start += range.end - range.begin;
+      if (from >= to)
+        continue;
+      auto &permutation = permutations[range.epoch];
+      if (permutation.empty())
+        permutation = EpochPermutation(range.epoch);
+      for (Index pos = range.begin + from; pos < range.begin + to; pos++)
+        leftover_indices_.push_back(permutation[pos]);
+    }
+    // the loader was reset to the start of its shard by PrepareMetadata, where it now reads
+    // the leftover samples
+    leftover_begin_ = start_index(shard_id_, num_shards_, size);
+    global_epoch_ = first_epoch;
+    if (leftover_indices_.empty())
+      ShuffleGlobally();
+  }
+
+  /**
+   * @brief Splits the samples of the epoch, which weren't read by any of the `old_num_shards`
+   *        shards, between the shards of this loader
+   *
+   * Used to resume from a checkpoint taken with a different number of shards, e.g. when
+   * an elastic training changes the number of ranks in the middle of an epoch. All the old
+   * shards are assumed to have read `consumed_samples` samples since they restored `ranges`
+   * and `first_epoch` (see RestoreEpochRanges), as the ranks of a synchronous training do.
+   * The samples left in the current epoch of each old shard are read first, then the regular
+   * epochs follow, with the new sharding.
+   *
+   * The shards of different sizes drift apart by a sample per epoch; if the old shards end up
+   * in different epochs, only the current epoch of each of them is carried over.
+   */
+  void Reshard(const std::vector<EpochRange> &ranges, int64_t first_epoch, int old_num_shards,
+               int64_t consumed_samples) {
+    PrepareMetadata();
+    DALI_ENFORCE(old_num_shards > 0 && consumed_samples >= 0,
+                 "The sharding in the checkpoint is invalid.");
+    Index size = SizeImpl();
+    Index total = 0;
+    for (auto &range : ranges)
+      total += range.end - range.begin;
+
+    std::vector<EpochRange> leftover;
+    int64_t next_epoch = first_epoch;
+    for (int shard = 0; shard < old_num_shards; shard++) {
+      Index begin = start_index(shard, old_num_shards, total);
+      Index end = start_index(shard + 1, old_num_shards, total);
+      if (consumed_samples < end - begin) {
+        // still in the ranges: the rest of its part of them is left
+        begin += consumed_samples;
+        Index range_start = 0;
+        for (auto &range : ranges) {
+          Index from = std::max(begin - range_start, Index(0));
+          Index to = std::min(end - range_start, static_cast<Index>(range.end - range.begin));
+          range_start += range.end - range.begin;
+          if (from < to)
+            leftover.push_back({range.epoch, range.begin + from, range.begin + to});
+        }
+        continue;
+      }
+      Index shard_begin = start_index(shard, old_num_shards, size);
+      Index shard_size = start_index(shard + 1, old_num_shards, size) - shard_begin;
+      int64_t read = consumed_samples - (end - begin);
+      int64_t epoch = first_epoch + read / shard_size;
+      Index offset = read % shard_size;
+      if (offset == 0) {
+        // done with the previous epoch, the next one is not started
+        next_epoch = std::max(next_epoch, epoch);
+      } else {
+        leftover.push_back({epoch, shard_begin + offset, shard_begin + shard_size});
+        next_epoch = std::max(next_epoch, epoch + 1);
+      }
+    }
+    RestoreEpochRanges(std::move(leftover), next_epoch);
+  }
+
+  /**
+   * @brief The ranges restored with RestoreEpochRanges, which are read before FirstEpoch
+   */
+  const std::vector<EpochRange> &LeftoverRanges() const {
+    return leftover_ranges_;
+  }
+
+  int64_t FirstEpoch() const {
+    return first_epoch_;
+  }
+
   void PrepareMetadata() {
     if (!loading_flag_) {
       std::lock_guard<std::mutex> l(prepare_metadata_mutex_);
       if (!loading_flag_) {
         PrepareMetadataImpl();
+        DALI_ENFORCE(!global_shuffle_ || !permutation_.empty(),
+                     "This reader doesn't support ``global_shuffle``.");
         std::atomic_thread_fence(std::memory_order_release);
         loading_flag_ = true;
         DALI_ENFORCE(num_shards_ <= Size(), make_string("The number of input samples: ", Size(),
@@ -254,8 +523,229 @@ class Loader {
  protected:
   virtual Index SizeImpl() = 0;
 
+  void ScheduleReadSample(LoadTarget& tensor) {
+    if (dry_run_) {
+      dry_run_ordinals_[&tensor] = dry_run_reads_++;
+      return;
+    }
+    if (num_io_threads_ == 1) {
+      QueueReadSample(tensor);
+      return;
+    }
+    auto read = ReadSampleDeferred(tensor);
+    if (!read)
+      return;
+    if (!io_thread_pool_)
+      io_thread_pool_ = std::make_unique<ThreadPool>(num_io_threads_, CPU_ONLY_DEVICE_ID, false,
+                                                     "Loader I/O");
+    pending_reads_.insert(&tensor);
+    io_thread_pool_->AddWork([read = std::move(read)](int) { read(); }, 0, true);
+  }
+
+  /**
+   * @brief A data read queued by QueueRead
+   */
+  struct QueuedRead {
+    /// The stream to read from - kept open until the read is complete
+    std::unique_ptr<FileStream> stream;
+    /// The read; `request.stream` is set by QueueRead
+    FileStream::ReadRequest request;
+    /// Called once the read is serviced - checks the result and releases the stream
+    std::function<void(QueuedRead &)> done;
+  };
+
+  /**
+   * @brief Queues a read of sample data, which is issued with FileStream::ReadBatch along with
+   *        the other reads of the batch
+   *
+   * The read buffer and the target of the read must stay valid until WaitForPendingReads,
+   * which is called once per batch and before a sample with a queued read is returned.
+   */
+  void QueueRead(const LoadTarget &tensor, QueuedRead read) {
+    read.request.stream = read.stream.get();
+    queued_reads_.push_back(std::move(read));
+    pending_reads_.insert(&tensor);
+  }
+
+  /**
+   * @brief Submits the queued reads at once and calls their completion functions, in order.
+   *
+   * The streams which don't support batched reads (not opened with `use_io_uring`, or
+   * if io_uring is not available) are read one by one with ReadAt.
+   */
+  void FlushQueuedReads() {
+    if (queued_reads_.empty())
+      return;
+    auto reads = std::move(queued_reads_);
+    queued_reads_.clear();
+    std::vector<FileStream::ReadRequest> requests;
+    requests.reserve(reads.size());
+    for (auto &read : reads)
+      requests.push_back(read.request);
+    FileStream::ReadBatch(make_span(requests));
+    for (size_t i = 0; i < reads.size(); i++) {
+      reads[i].request.bytes_read = requests[i].bytes_read;
+      reads[i].done(reads[i]);
+    }
+  }
+
   virtual void PrepareMetadataImpl() {}
 
+  /**
+   * @brief Starts a new epoch of ``global_shuffle``, by drawing a new permutation of the dataset
+   *
+   * The loaders supporting ``global_shuffle`` call it whenever they wrap to their shard (in Reset)
+   * and map the position in the epoch to a sample with GlobalSampleIndex. The permutation depends
+   * only on the epoch number, so that the shards split the same permutation between themselves.
+   */
+  void ShuffleGlobally() {
+    if (!global_shuffle_)
+      return;
+    leftover_indices_.clear();
+    permutation_ = EpochPermutation(global_epoch_++);
+  }
+
+  std::vector<Index> EpochPermutation(int64_t epoch) {
+    std::vector<Index> permutation(SizeImpl());
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::mt19937 g(kDaliDataloaderSeed + epoch);
+    std::shuffle(permutation.begin(), permutation.end(), g);
+    return permutation;
+  }
+
+  /**
+   * @brief Returns the index of the sample at position `pos` in the epoch
+   *
+   * Before the first regular epoch, the positions of the shard map to its leftover samples,
+   * see RestoreEpochRanges.
+   */
+  Index GlobalSampleIndex(Index pos) const {
+    if (!global_shuffle_)
+      return pos;
+    return leftover_indices_.empty() ? permutation_[pos] : leftover_indices_[pos - leftover_begin_];
+  }
+
+  /**
+   * @brief Returns the position in the epoch at which the reading of the current shard stops,
+   *        as in IsNextShard
+   *
+   * Doesn't call Size(), so that it can be used in PrepareMetadataImpl.
+   */
+  Index ShardEnd() {
+    if (!leftover_indices_.empty())
+      return leftover_begin_ + static_cast<Index>(leftover_indices_.size());
+    return stick_to_shard_ && shard_id_ + 1 < num_shards_
+         ? static_cast<Index>(start_index(shard_id_ + 1, num_shards_, SizeImpl()))
+         : SizeImpl();
+  }
+
+  /**
+   * @brief Returns the indices of (at most) `count` samples which are read next, starting with
+   *        the one at position `pos` in the epoch.
+   *
+   * The list stops at the end of the shard. It lets the loaders issue the I/O of the upcoming
+   * samples ahead of need, which pays off with ``global_shuffle``, where the consecutive samples
+   * are scattered all over the dataset.
+   */
+  std::vector<Index> UpcomingSampleIndices(Index pos, Index count) {
+    Index end = std::min(pos + count, ShardEnd());
+    std::vector<Index> indices;
+    indices.reserve(std::max<Index>(end - pos, 0));
+    for (; pos < end; pos++)
+      indices.push_back(GlobalSampleIndex(pos));
+    return indices;
+  }
+
+  /**
+   * @brief Opens a data file, through the memory and the local file cache, if they're enabled
+   */
+  std::unique_ptr<FileStream> OpenStream(const std::string &uri, bool read_ahead, bool use_mmap,
+                                         bool use_io_uring = false) {
+    if (memory_cache_) {
+      return memory_cache_->Open(uri, [&]() {
+        return OpenStorageStream(uri, read_ahead, use_mmap, use_io_uring);
+      });
+    }
+    return OpenStorageStream(uri, read_ahead, use_mmap, use_io_uring);
+  }
+
+  std::unique_ptr<FileStream> OpenStorageStream(const std::string &uri, bool read_ahead,
+                                                bool use_mmap, bool use_io_uring = false) {
+    if (local_cache_)
+      return local_cache_->Open(uri, read_ahead, use_mmap);
+    return FileStream::Open(uri, read_ahead, use_mmap, use_io_uring, no_atime_);
+  }
+
+  /**
+   * @brief Opens the file of a sample, through the file handle cache, if it's enabled
+   *
+   * The file should be released with ReleaseSampleFile, which puts it back in the cache.
+   * The handles are cached only when the files are not memory-mapped, as the mappings are
+   * a limited resource, reserved by the readers up front.
+   */
+  std::unique_ptr<FileStream> OpenSampleFile(const std::string &uri, bool read_ahead,
+                                             bool use_mmap, bool use_io_uring = false) {
+    if (!UseFileHandleCache(use_mmap))
+      return OpenStream(uri, read_ahead, use_mmap, use_io_uring);
+    return file_handle_cache_->Open(uri, [&]() {
+      return OpenStream(uri, read_ahead, use_mmap, use_io_uring);
+    });
+  }
+
+  void ReleaseSampleFile(const std::string &uri, std::unique_ptr<FileStream> stream,
+                         bool use_mmap) {
+    if (UseFileHandleCache(use_mmap))
+      file_handle_cache_->Release(uri, std::move(stream));
+    else
+      stream->Close();
+  }
+
+  /**
+   * @brief Starts opening the files of the upcoming samples in the background
+   *
+   * Does nothing, if the file handle cache is disabled.
+   */
+  void PrefetchSampleFiles(const std::vector<std::string> &uris, bool read_ahead, bool use_mmap) {
+    if (!UseFileHandleCache(use_mmap))
+      return;
+    for (auto &uri : uris) {
+      file_handle_cache_->Prefetch(uri, [this, uri, read_ahead, use_mmap]() {
+        return OpenStream(uri, read_ahead, use_mmap);
+      });
+    }
+  }
+
+  /**
+   * @brief Returns the indices of the samples whose files should be opened ahead, when
+   *        the sample at position `pos` in the epoch is read
+   *
+   * The files are opened up to half of the prefetch queue (or of the file handle cache) ahead;
+   * the next part of the window is requested when half of it has been read.
+   */
+  std::vector<Index> FilePrefetchIndices(Index pos) {
+    Index window = std::max<Index>(
+        1, std::min<Index>(initial_empty_size_ / 2, file_handle_cache_size_ / 2));
+    // the reading started or wrapped around
+    if (pos < file_prefetch_pos_ || pos > file_prefetch_end_)
+      file_prefetch_end_ = pos;
+    file_prefetch_pos_ = pos;
+    if (file_prefetch_end_ - pos > window / 2)
+      return {};
+    Index begin = file_prefetch_end_;
+    file_prefetch_end_ = pos + window;
+    return UpcomingSampleIndices(begin, file_prefetch_end_ - begin);
+  }
+
+  bool UseFileHandleCache(bool use_mmap) {
+    if (file_handle_cache_size_ == 0 || use_mmap)
+      return false;
+    std::call_once(file_handle_cache_init_, [this]() {
+      file_handle_cache_ = std::make_unique<FileHandleCache>(file_handle_cache_size_,
+                                                             num_io_threads_);
+    });
+    return true;
+  }
+
   virtual void MoveToNextShard(Index current_index) {
     if (IsNextShard(current_index)) {
       Reset(stick_to_shard_);
@@ -266,6 +756,8 @@ class Loader {
 
   // Check if given reader moved to the next shard
   virtual inline bool IsNextShard(Index current_index) {
+     if (!leftover_indices_.empty())
+       return current_index >= leftover_begin_ + static_cast<Index>(leftover_indices_.size());
      return current_index >= Size() ||
             (stick_to_shard_ && shard_id_ + 1 < num_shards_ &&
             current_index >= static_cast<Index>(start_index(shard_id_ + 1, num_shards_, Size())));
@@ -340,6 +832,18 @@ class Loader {
   // if reader for the given GPU should read over and over the same shard or should go through
   // whole data set
   bool stick_to_shard_;
+  // if the samples should be read in the order of a permutation of the whole data set, drawn
+  // anew in every epoch
+  bool global_shuffle_;
+  std::vector<Index> permutation_;
+  int64_t global_epoch_ = 0;
+  // The samples read before the epoch first_epoch_, left over by a different sharding
+  std::vector<EpochRange> leftover_ranges_;
+  int64_t first_epoch_ = 0;
+  // This shard's part of leftover_ranges_, read from the position leftover_begin_ until the loader
+  // wraps to its shard for the first time
+  std::vector<Index> leftover_indices_;
+  Index leftover_begin_ = 0;
 
   // Pipeline's device id, used to lookup if an image was cached
   int device_id_;
@@ -372,6 +876,32 @@ class Loader {
   int virtual_shard_id_;
   // Keeps pointer to the last returned sample just in case it needs to be cloned
   LoadTargetSharedPtr last_sample_ptr_tmp;
+  // Number of threads used to read the sample data, 1 means reading in the prefetch thread
+  int num_io_threads_;
+  std::unique_ptr<ThreadPool> io_thread_pool_;
+  // Samples which are still being read by io_thread_pool_ or have queued reads
+  std::unordered_set<const LoadTarget*> pending_reads_;
+  // Reads queued with QueueRead, submitted together by FlushQueuedReads
+  std::vector<QueuedRead> queued_reads_;
+  // In FastForward: the reads are only counted, each target keeps the ordinal of its last read
+  bool dry_run_ = false;
+  Index dry_run_reads_ = 0;
+  std::unordered_map<const LoadTarget*, Index> dry_run_ordinals_;
+  // The target of the reads made by SkipSample, which are discarded
+  LoadTargetUniquePtr skip_target_;
+  // Local copies of the data files, shared by the readers using the same directory
+  std::shared_ptr<LocalFileCache> local_cache_;
+  // Contents of the data files kept in host memory after they are first read
+  std::unique_ptr<MemoryFileCache> memory_cache_;
+  // The maximum number of the files of the samples kept open, 0 disables the cache
+  int file_handle_cache_size_;
+  // Whether the data files are opened with O_NOATIME
+  bool no_atime_;
+  std::once_flag file_handle_cache_init_;
+  std::unique_ptr<FileHandleCache> file_handle_cache_;
+  // The position of the last sample passed to FilePrefetchIndices and the end of the window of
+  // the samples whose files were requested
+  Index file_prefetch_pos_ = 0, file_prefetch_end_ = 0;
 
   struct ShardBoundaries {
     Index start;
@@ -1,4 +1,4 @@
-// Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,7 +13,16 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "dali/core/common.h"
 #include "dali/pipeline/data/backend.h"
@@ -62,6 +71,35 @@ TYPED_TEST(DataLoadStoreTest, LMDBTest) {
     auto sample = reader->ReadOne(false);
   }
 }
+
+TYPED_TEST(DataLoadStoreTest, LMDBZeroCopy) {
+  shared_ptr<dali::LMDBLoader> reader(
+      new LMDBLoader(
+          OpSpec("CaffeReader")
+          .AddArg("max_batch_size", 32)
+          .AddArg("path", testing::dali_extra_path() + "/db/c2lmdb/")
+          .AddArg("device_id", 0)));
+
+  reader->PrepareMetadata();
+  for (int i = 0; i < 100; ++i) {
+    auto sample = reader->ReadOne(false);
+    ASSERT_TRUE(sample->shares_data());
+    ASSERT_GT(sample->size(), 0);
+  }
+}
+
+TYPED_TEST(DataLoadStoreTest, LMDBSharedValueOutlivesDatabase) {
+  IndexedLMDB db;
+  db.Open(testing::dali_extra_path() + "/db/c2lmdb/", 0);
+  MDB_val key, value;
+  db.SeekByIndex(1, &key, &value);
+  auto shared = db.ShareValue(value);
+  std::vector<uint8_t> copy(static_cast<uint8_t *>(value.mv_data),
+                            static_cast<uint8_t *>(value.mv_data) + value.mv_size);
+  db.Close();
+  // the memory map is still valid
+  EXPECT_EQ(std::memcmp(shared.get(), copy.data(), copy.size()), 0);
+}
 #endif
 
 TYPED_TEST(DataLoadStoreTest, FileLabelLoaderMmmap) {
@@ -153,6 +191,262 @@ TYPED_TEST(DataLoadStoreTest, LoaderTest) {
   }
 }
 
+TYPED_TEST(DataLoadStoreTest, FileLabelLoaderIOThreads) {
+  auto make_loader = [](int num_io_threads) {
+    return std::make_unique<FileLabelLoader>(
+        OpSpec("FileReader")
+        .AddArg("file_root", loader_test_image_folder)
+        .AddArg("max_batch_size", 8)
+        .AddArg("device_id", 0)
+        .AddArg("random_shuffle", true)
+        .AddArg("initial_fill", 16)
+        .AddArg("seed", 123)
+        .AddArg("dont_use_mmap", true)
+        .AddArg("num_io_threads", num_io_threads));
+  };
+  auto ref_loader = make_loader(1);
+  auto loader = make_loader(4);
+  ref_loader->PrepareMetadata();
+  loader->PrepareMetadata();
+
+  for (int i = 0; i < 50; ++i) {
+    auto ref = ref_loader->ReadOne(i % 8 == 0);
+    auto sample = loader->ReadOne(i % 8 == 0);
+    EXPECT_EQ(sample->image.GetSourceInfo(), ref->image.GetSourceInfo());
+    EXPECT_EQ(sample->label, ref->label);
+    ASSERT_EQ(sample->image.nbytes(), ref->image.nbytes());
+    EXPECT_EQ(std::memcmp(sample->image.raw_data(), ref->image.raw_data(), ref->image.nbytes()),
+              0);
+  }
+  loader->WaitForPendingReads();
+}
+
+TYPED_TEST(DataLoadStoreTest, FileLabelLoaderBatchedReads) {
+  auto make_loader = [](bool dont_use_mmap) {
+    return std::make_unique<FileLabelLoader>(
+        OpSpec("FileReader")
+        .AddArg("file_root", loader_test_image_folder)
+        .AddArg("max_batch_size", 8)
+        .AddArg("device_id", 0)
+        .AddArg("random_shuffle", true)
+        .AddArg("initial_fill", 16)
+        .AddArg("seed", 123)
+        .AddArg("dont_use_mmap", dont_use_mmap));
+  };
+  // the mapped files are shared with the samples, the copied ones are read in batches
+  auto ref_loader = make_loader(false);
+  auto loader = make_loader(true);
+  ref_loader->PrepareMetadata();
+  loader->PrepareMetadata();
+
+  for (int batch = 0; batch < 6; ++batch) {
+    std::vector<std::shared_ptr<ImageLabelWrapper>> refs, samples;
+    for (int i = 0; i < 8; ++i) {
+      refs.push_back(ref_loader->ReadOne(i == 0));
+      samples.push_back(loader->ReadOne(i == 0));
+    }
+    loader->WaitForPendingReads();
+    for (int i = 0; i < 8; ++i) {
+      auto &ref = refs[i];
+      auto &sample = samples[i];
+      EXPECT_EQ(sample->image.GetSourceInfo(), ref->image.GetSourceInfo());
+      EXPECT_EQ(sample->label, ref->label);
+      ASSERT_EQ(sample->image.nbytes(), ref->image.nbytes());
+      EXPECT_EQ(std::memcmp(sample->image.raw_data(), ref->image.raw_data(), ref->image.nbytes()),
+                0);
+    }
+  }
+}
+
+TYPED_TEST(DataLoadStoreTest, FileLabelLoaderFastForward) {
+  auto make_loader = [](int num_io_threads, bool pad_last_batch) {
+    return std::make_unique<FileLabelLoader>(
+        OpSpec("FileReader")
+        .AddArg("file_root", loader_test_image_folder)
+        .AddArg("max_batch_size", 8)
+        .AddArg("device_id", 0)
+        .AddArg("random_shuffle", true)
+        .AddArg("initial_fill", 16)
+        .AddArg("seed", 123)
+        .AddArg("num_shards", 3)
+        .AddArg("shard_id", 1)
+        .AddArg("pad_last_batch", pad_last_batch)
+        .AddArg("num_io_threads", num_io_threads));
+  };
+  for (int num_io_threads : {1, 4}) {
+    for (bool pad_last_batch : {false, true}) {
+      auto ref_loader = make_loader(1, pad_last_batch);
+      auto loader = make_loader(num_io_threads, pad_last_batch);
+      ref_loader->PrepareMetadata();
+      loader->PrepareMetadata();
+      // more than an epoch of the shard
+      const int skipped = 8 * (ref_loader->Size() / 3 / 8 + 3);
+      for (int i = 0; i < skipped; ++i)
+        ref_loader->ReadOne(i % 8 == 0);
+      loader->FastForward(skipped, 8);
+
+      for (int i = skipped; i < skipped + 50; ++i) {
+        auto ref = ref_loader->ReadOne(i % 8 == 0);
+        auto sample = loader->ReadOne(i % 8 == 0);
+        EXPECT_EQ(sample->image.GetSourceInfo(), ref->image.GetSourceInfo());
+        EXPECT_EQ(sample->label, ref->label);
+        ASSERT_EQ(sample->image.nbytes(), ref->image.nbytes());
+        EXPECT_EQ(std::memcmp(sample->image.raw_data(), ref->image.raw_data(),
+                              ref->image.nbytes()), 0);
+      }
+      loader->WaitForPendingReads();
+    }
+  }
+}
+
+TYPED_TEST(DataLoadStoreTest, FileLabelLoaderGlobalShuffle) {
+  const int num_shards = 3;
+  std::vector<std::unique_ptr<FileLabelLoader>> loaders;
+  for (int shard_id = 0; shard_id < num_shards; shard_id++) {
+    loaders.push_back(std::make_unique<FileLabelLoader>(
+        OpSpec("FileReader")
+        .AddArg("file_root", loader_test_image_folder)
+        .AddArg("max_batch_size", 8)
+        .AddArg("device_id", 0)
+        .AddArg("global_shuffle", true)
+        .AddArg("num_shards", num_shards)
+        .AddArg("shard_id", shard_id)));
+    loaders.back()->PrepareMetadata();
+  }
+  Index size = loaders[0]->Size();
+  std::vector<std::string> prev_order;
+  for (int epoch = 0; epoch < 2; epoch++) {
+    std::vector<std::string> order;
+    for (int shard_id = 0; shard_id < num_shards; shard_id++) {
+      Index shard_size = start_index(shard_id + 1, num_shards, size) -
+                         start_index(shard_id, num_shards, size);
+      for (Index i = 0; i < shard_size; i++)
+        order.push_back(loaders[shard_id]->ReadOne(i == 0)->image.GetSourceInfo());
+    }
+    // each epoch goes through the entire data set, in a different order
+    std::set<std::string> unique(order.begin(), order.end());
+    EXPECT_EQ(static_cast<Index>(unique.size()), size);
+    EXPECT_NE(order, prev_order);
+    prev_order = std::move(order);
+  }
+}
+
+TYPED_TEST(DataLoadStoreTest, FileLabelLoaderReshard) {
+  auto make_loaders = [](int num_shards) {
+    std::vector<std::unique_ptr<FileLabelLoader>> loaders;
+    for (int shard_id = 0; shard_id < num_shards; shard_id++) {
+      loaders.push_back(std::make_unique<FileLabelLoader>(
+          OpSpec("FileReader")
+          .AddArg("file_root", loader_test_image_folder)
+          .AddArg("max_batch_size", 8)
+          .AddArg("device_id", 0)
+          .AddArg("global_shuffle", true)
+          .AddArg("num_shards", num_shards)
+          .AddArg("shard_id", shard_id)));
+      loaders.back()->PrepareMetadata();
+    }
+    return loaders;
+  };
+  auto read = [](std::vector<std::unique_ptr<FileLabelLoader>> &loaders, Index count,
+                 std::vector<std::string> &order) {
+    for (auto &loader : loaders) {
+      for (Index i = 0; i < count; i++)
+        order.push_back(loader->ReadOne(i % 8 == 0)->image.GetSourceInfo());
+    }
+  };
+
+  // 3 shards read a part of the epoch, then 2 shards take over, then 4
+  auto loaders = make_loaders(3);
+  Index size = loaders[0]->Size();
+  const Index consumed = size / 9;
+  std::vector<std::string> order;
+  read(loaders, consumed, order);
+
+  auto resharded = make_loaders(2);
+  for (auto &loader : resharded)
+    loader->Reshard(loaders[0]->LeftoverRanges(), loaders[0]->FirstEpoch(), 3, consumed);
+  ASSERT_EQ(resharded[0]->FirstEpoch(), 1);
+  read(resharded, consumed, order);
+
+  // resuming the resharded loader within its leftover samples
+  auto resumed = make_loaders(2);
+  resumed[1]->RestoreEpochRanges(resharded[1]->LeftoverRanges(), resharded[1]->FirstEpoch());
+  resumed[1]->FastForward(consumed, 8);
+
+  auto resharded_again = make_loaders(4);
+  for (auto &loader : resharded_again)
+    loader->Reshard(resharded[0]->LeftoverRanges(), resharded[0]->FirstEpoch(), 2, consumed);
+  Index left = size - 3 * consumed - 2 * consumed;
+  for (int shard_id = 0; shard_id < 4; shard_id++) {
+    Index count = start_index(shard_id + 1, 4, left) - start_index(shard_id, 4, left);
+    for (Index i = 0; i < count; i++)
+      order.push_back(resharded_again[shard_id]->ReadOne(i % 8 == 0)->image.GetSourceInfo());
+  }
+  // the epoch is read exactly once
+  ASSERT_EQ(static_cast<Index>(order.size()), size);
+  std::set<std::string> unique(order.begin(), order.end());
+  EXPECT_EQ(static_cast<Index>(unique.size()), size);
+
+  std::vector<std::string> resumed_order, ref_order;
+  for (Index i = 0; i < 10; i++) {
+    resumed_order.push_back(resumed[1]->ReadOne(i % 8 == 0)->image.GetSourceInfo());
+    ref_order.push_back(resharded[1]->ReadOne(i % 8 == 0)->image.GetSourceInfo());
+  }
+  EXPECT_EQ(resumed_order, ref_order);
+
+  // then, the regular epochs follow, as if the loaders were created with 4 shards
+  auto ref = make_loaders(4);
+  for (int shard_id = 0; shard_id < 4; shard_id++) {
+    Index shard_size = start_index(shard_id + 1, 4, size) - start_index(shard_id, 4, size);
+    for (Index i = 0; i < shard_size; i++)
+      ref[shard_id]->ReadOne(i == 0);
+    for (Index i = 0; i < shard_size; i++) {
+      EXPECT_EQ(resharded_again[shard_id]->ReadOne(i == 0)->image.GetSourceInfo(),
+                ref[shard_id]->ReadOne(i == 0)->image.GetSourceInfo());
+    }
+  }
+}
+
+TYPED_TEST(DataLoadStoreTest, TFRecordLoaderGlobalShuffle) {
+  std::vector<std::string> path = {testing::dali_extra_path() + "/db/tfrecord/train"};
+  std::vector<std::string> index_path = {testing::dali_extra_path() + "/db/tfrecord/train.idx"};
+  auto make_loader = [&](bool global_shuffle) {
+    return std::make_unique<IndexedFileLoader>(
+        OpSpec("TFRecordReader")
+        .AddArg("path", path)
+        .AddArg("index_path", index_path)
+        .AddArg("max_batch_size", 8)
+        .AddArg("device_id", 0)
+        .AddArg("global_shuffle", global_shuffle)
+        .AddArg("num_shards", 2)
+        .AddArg("shard_id", 1));
+  };
+  auto ref_loader = make_loader(false);
+  auto loader = make_loader(true);
+  ref_loader->PrepareMetadata();
+  loader->PrepareMetadata();
+  Index size = ref_loader->Size();
+
+  std::map<std::string, std::vector<uint8_t>> ref;
+  for (Index i = 0; i < size; i++) {
+    auto sample = ref_loader->ReadOne(i % 8 == 0);
+    auto *data = static_cast<const uint8_t *>(sample->raw_data());
+    ref[sample->GetSourceInfo()].assign(data, data + sample->nbytes());
+  }
+  // the records of the shard are read ahead in batches, in a random order
+  Index shard_size = size - static_cast<Index>(start_index(1, 2, size));
+  std::set<std::string> seen;
+  for (Index i = 0; i < shard_size; i++) {
+    auto sample = loader->ReadOne(i % 8 == 0);
+    auto it = ref.find(sample->GetSourceInfo());
+    ASSERT_NE(it, ref.end());
+    ASSERT_EQ(sample->nbytes(), it->second.size());
+    EXPECT_EQ(std::memcmp(sample->raw_data(), it->second.data(), it->second.size()), 0);
+    seen.insert(it->first);
+  }
+  EXPECT_EQ(static_cast<Index>(seen.size()), shard_size);
+}
+
 TYPED_TEST(DataLoadStoreTest, LoaderTestFail) {
   shared_ptr<dali::FileLabelLoader> reader(
       new FileLabelLoader(OpSpec("FileReader")
@@ -180,4 +474,69 @@ TYPED_TEST(DataLoadStoreTest, CachedLMDBTest) {
 }
 #endif
 
+TYPED_TEST(DataLoadStoreTest, IndexedFileLoaderInterleaveFiles) {
+  // 3 files with 4 records each; each record contains its file and record number
+  const int kFiles = 3, kRecords = 4, kRecordSize = 8;
+  std::string tmpl = "/tmp/interleave_test_XXXXXX";
+  std::string tmp_dir = mkdtemp(&tmpl[0]);
+  std::vector<std::string> path, index_path;
+  for (int f = 0; f < kFiles; f++) {
+    path.push_back(make_string(tmp_dir, "/data", f));
+    index_path.push_back(make_string(tmp_dir, "/data", f, ".idx"));
+    std::ofstream data(path.back(), std::ios::binary), index(index_path.back());
+    for (int r = 0; r < kRecords; r++) {
+      char record[kRecordSize + 1];
+      snprintf(record, sizeof(record), "f%dr%05d", f, r);
+      data.write(record, kRecordSize);
+      index << r * kRecordSize << " " << kRecordSize << "\n";
+    }
+  }
+
+  for (bool shuffle : { false, true }) {
+    IndexedFileLoader reader(OpSpec("TFRecordReader")
+                             .AddArg("path", path)
+                             .AddArg("index_path", index_path)
+                             .AddArg("max_batch_size", 4)
+                             .AddArg("device_id", 0)
+                             .AddArg("random_shuffle", shuffle)
+                             .AddArg("initial_fill", 1)
+                             .AddArg("interleave_files", 2));
+    reader.PrepareMetadata();
+    for (int epoch = 0; epoch < 2; epoch++) {
+      std::set<std::string> seen;
+      std::map<int, int> next_record;
+      std::set<int> open_files;
+      std::vector<std::string> order;
+      for (int i = 0; i < kFiles * kRecords; i++) {
+        auto sample = reader.ReadOne(i == 0);
+        std::string record(reinterpret_cast<const char *>(sample->template data<uint8_t>()),
+                           kRecordSize);
+        order.push_back(record);
+        seen.insert(record);
+        int f = record[1] - '0', r = std::atoi(&record[3]);
+        EXPECT_EQ(r, next_record[f]) << "Each file should be read sequentially";
+        next_record[f] = r + 1;
+        if (r == 0)
+          open_files.insert(f);
+        EXPECT_LE(open_files.size(), 2u) << "At most 2 files should be read at a time";
+        if (r == kRecords - 1)
+          open_files.erase(f);
+      }
+      EXPECT_EQ(seen.size(), static_cast<size_t>(kFiles * kRecords))
+          << "Each record should be read once per epoch";
+      if (!shuffle) {
+        EXPECT_EQ(order[0], "f0r00000");
+        EXPECT_EQ(order[1], "f1r00000");
+        EXPECT_EQ(order[2], "f0r00001");
+      }
+    }
+  }
+
+  for (int f = 0; f < kFiles; f++) {
+    std::remove(path[f].c_str());
+    std::remove(index_path[f].c_str());
+  }
+  rmdir(tmp_dir.c_str());
+}
+
 };  // namespace dali
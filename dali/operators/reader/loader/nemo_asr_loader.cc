@@ -12,8 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <string>
 #include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
 #include "dali/operators/decoder/audio/generic_decoder.h"
@@ -30,44 +34,107 @@ namespace dali {
 
 namespace detail {
 
-void ParseManifest(std::vector<NemoAsrEntry> &entries, std::istream& manifest_file,
-                   double min_duration, double max_duration, bool read_text) {
-  std::string line;
+namespace {
+
+// smaller manifests are not worth splitting
+constexpr size_t kMinManifestChunk = 1 << 18;
+
+void ParseManifestChunk(NemoAsrManifest &entries, char *begin, char *end,
+                        double min_duration, double max_duration, bool read_text) {
   int64_t index = 0;
-  while (std::getline(manifest_file, line)) {
-    detail::LookaheadParser parser(const_cast<char*>(line.c_str()));
+  std::string audio_filepath, text;
+  ForEachLine(begin, end, [&](char *line, size_t) {
+    detail::LookaheadParser parser(line);
     if (parser.PeekType() != kObjectType) {
       DALI_WARN(make_string("Skipping invalid manifest line: ", line));
-      continue;
+      return;
     }
     parser.EnterObject();
-    NemoAsrEntry entry;
-    entry.index = index;
+    double duration = kDefaultDuration, offset = 0.0;
+    audio_filepath.clear();
+    text.clear();
     while (const char* key = parser.NextObjectKey()) {
       if (0 == std::strcmp(key, "audio_filepath")) {
-        entry.audio_filepath = parser.GetString();
+        audio_filepath = parser.GetString();
       } else if (0 == std::strcmp(key, "duration")) {
-        entry.duration = parser.GetDouble();
+        duration = parser.GetDouble();
       } else if (0 == std::strcmp(key, "offset")) {
-        entry.offset = parser.GetDouble();
+        offset = parser.GetDouble();
       } else if (read_text && 0 == std::strcmp(key, "text")) {
-        entry.text = parser.GetString();
+        text = parser.GetString();
       } else {
         parser.SkipValue();
       }
     }
-    if (entry.audio_filepath.empty()) {
+    if (audio_filepath.empty()) {
       DALI_WARN(make_string("Skipping manifest line without an audio filepath: ", line));
-      continue;
+      return;
     }
 
-    if ((max_duration > 0.0f && entry.duration > max_duration) ||
-        (min_duration > 0.0f && entry.duration < min_duration)) {
-      continue;  // skipping sample
+    if ((max_duration > 0.0f && duration > max_duration) ||
+        (min_duration > 0.0f && duration < min_duration)) {
+      return;  // skipping sample
     }
 
-    entries.emplace_back(std::move(entry));
-    index++;
+    entries.Append(audio_filepath.c_str(), duration, offset, index++, text.c_str());
+  });
+}
+
+}  // namespace
+
+void ParseManifest(NemoAsrManifest &entries, std::istream& manifest_file,
+                   double min_duration, double max_duration, bool read_text, int num_threads) {
+  // The manifest is split into chunks of whole lines, which are parsed in place, in parallel;
+  // the entries of the chunks are then concatenated, in order.
+  std::string text = ReadWholeStream(manifest_file);
+  auto offsets = SplitIntoLineChunks(text.data(), text.size(), 4 * num_threads,
+                                     kMinManifestChunk);
+  int num_chunks = offsets.size() - 1;
+  if (num_chunks == 1) {
+    ParseManifestChunk(entries, &text[0], &text[0] + text.size(), min_duration, max_duration,
+                       read_text);
+    return;
+  }
+  std::vector<NemoAsrManifest> chunks(num_chunks);
+  ParseChunks(num_chunks, num_threads, [&](int chunk) {
+    ParseManifestChunk(chunks[chunk], &text[0] + offsets[chunk], &text[0] + offsets[chunk + 1],
+                       min_duration, max_duration, read_text);
+  });
+  int64_t index = 0;
+  for (auto &chunk : chunks) {
+    entries.Append(chunk, index);
+    index += chunk.size();
+  }
+}
+
+void BucketByDuration(span<size_t> indices, const NemoAsrManifest &entries,
+                      int batch_size, int64_t bucket_size, std::mt19937 &rng) {
+  assert(batch_size > 0 && bucket_size > 0);
+  auto by_duration = [&](size_t a, size_t b) {
+    return entries.duration(a) < entries.duration(b);
+  };
+  std::vector<size_t> bucket;
+  std::vector<int64_t> batch_starts;
+  int64_t total = indices.size();
+  for (int64_t start = 0; start < total; start += bucket_size) {
+    auto bucket_begin = indices.begin() + start;
+    auto bucket_end = indices.begin() + std::min(start + bucket_size, total);
+    std::stable_sort(bucket_begin, bucket_end, by_duration);
+
+    int64_t n = bucket_end - bucket_begin;
+    batch_starts.clear();
+    for (int64_t b = 0; b < n; b += batch_size)
+      batch_starts.push_back(b);
+    // an incomplete batch stays at the end, so that the following batches remain aligned
+    int64_t full_batches = n / batch_size;
+    std::shuffle(batch_starts.begin(), batch_starts.begin() + full_batches, rng);
+
+    bucket.assign(bucket_begin, bucket_end);
+    auto out = bucket_begin;
+    for (auto b : batch_starts) {
+      auto batch_end = std::min<int64_t>(b + batch_size, n);
+      out = std::copy(bucket.begin() + b, bucket.begin() + batch_end, out);
+    }
   }
 }
 
@@ -78,7 +145,8 @@ void NemoAsrLoader::PrepareMetadataImpl() {
     std::ifstream fstream(manifest_filepath);
     DALI_ENFORCE(fstream,
                  make_string("Could not open NEMO ASR manifest file: \"", manifest_filepath, "\""));
-    detail::ParseManifest(entries_, fstream, min_duration_, max_duration_, read_text_);
+    detail::ParseManifest(entries_, fstream, min_duration_, max_duration_, read_text_,
+                          num_threads_);
   }
   shuffled_indices_.resize(entries_.size());
   std::iota(shuffled_indices_.begin(), shuffled_indices_.end(), 0);
@@ -90,9 +158,31 @@ void NemoAsrLoader::PrepareMetadataImpl() {
     std::mt19937 g(kDaliDataloaderSeed);
     std::shuffle(shuffled_indices_.begin(), shuffled_indices_.end(), g);
   }
+  if (bucket_batches_ > 0) {
+    for (int64_t i = 0; i < entries_.size(); i++) {
+      DALI_ENFORCE(entries_.duration(i) >= 0, make_string("``bucket_batches`` requires the "
+                   "duration of all the samples in the manifest. The duration of \"",
+                   entries_.audio_filepath(i), "\" is missing."));
+    }
+    if (!shuffle_after_epoch_)
+      BucketIndices();  // otherwise, it's done after each shuffle
+  }
   Reset(true);
 }
 
+void NemoAsrLoader::BucketIndices() {
+  // The shards are bucketed separately, so that the batches of each shard start at its beginning.
+  // The seed is the same on every shard, as in the case of shuffling.
+  std::mt19937 g(kDaliDataloaderSeed + current_epoch_);
+  Index size = SizeImpl();
+  for (int shard = 0; shard < num_shards_; shard++) {
+    Index begin = start_index(shard, num_shards_, size);
+    Index end = start_index(shard + 1, num_shards_, size);
+    detail::BucketByDuration(make_span(shuffled_indices_.data() + begin, end - begin), entries_,
+                             batch_size_, static_cast<int64_t>(bucket_batches_) * batch_size_, g);
+  }
+}
+
 void NemoAsrLoader::Reset(bool wrap_to_shard) {
   current_index_ = wrap_to_shard ? start_index(shard_id_, num_shards_, SizeImpl()) : 0;
   current_epoch_++;
@@ -100,6 +190,8 @@ void NemoAsrLoader::Reset(bool wrap_to_shard) {
   if (shuffle_after_epoch_) {
     std::mt19937 g(kDaliDataloaderSeed + current_epoch_);
     std::shuffle(shuffled_indices_.begin(), shuffled_indices_.end(), g);
+    if (bucket_batches_ > 0)
+      BucketIndices();
   }
 }
 
@@ -110,25 +202,14 @@ void NemoAsrLoader::PrepareEmpty(AsrSample &sample) {
 template <typename OutputType>
 void NemoAsrLoader::ReadAudio(SampleView<CPUBackend> audio,
                               const AudioMetadata &audio_meta,
-                              const NemoAsrEntry &entry,
+                              const char *audio_filepath,
                               AudioDecoderBase &decoder,
                               std::vector<float> &decode_scratch,
                               std::vector<float> &resample_scratch) {
-  bool should_resample = sample_rate_ > 0 && audio_meta.sample_rate != sample_rate_;
-  bool should_downmix = audio_meta.channels > 1 && downmix_;
-
-  int64_t decode_scratch_sz = 0;
-  if (should_resample || should_downmix)
-    decode_scratch_sz = audio_meta.length * audio_meta.channels;
+  int64_t decode_scratch_sz, resample_scratch_sz;
+  std::tie(decode_scratch_sz, resample_scratch_sz) =
+      DecodeAudioScratchSizes(audio_meta, sample_rate_, downmix_);
   decode_scratch.resize(decode_scratch_sz);
-
-  // resample scratch is used to prepare a single or multiple (depending if
-  // downmixing is needed) channel float input, required by the resampling
-  // kernel
-  int64_t resample_scratch_sz = 0;
-  if (should_resample)
-    resample_scratch_sz =
-        should_downmix ? audio_meta.length : audio_meta.length * audio_meta.channels;
   resample_scratch.resize(resample_scratch_sz);
 
   DecodeAudio<OutputType>(
@@ -136,11 +217,12 @@ void NemoAsrLoader::ReadAudio(SampleView<CPUBackend> audio,
     {decode_scratch.data(), decode_scratch_sz},
     {resample_scratch.data(), resample_scratch_sz},
     sample_rate_, downmix_,
-    entry.audio_filepath.c_str());
+    audio_filepath);
 }
 
 void NemoAsrLoader::ReadSample(AsrSample& sample) {
-  auto &entry = entries_[shuffled_indices_[current_index_]];
+  size_t entry_idx = shuffled_indices_[current_index_];
+  auto entry = entries_[entry_idx];
 
   // handle wrap-around
   ++current_index_;
@@ -170,12 +252,13 @@ void NemoAsrLoader::ReadSample(AsrSample& sample) {
 
   TYPE_SWITCH(dtype_, type2id, OutputType, (int16_t, int32_t, float), (
     // Audio decoding will be run in the prefetch function, once the batch is formed
-    sample.decode_f_ = [this, &sample, &entry, offset](SampleView<CPUBackend> audio, int tid) {
-      sample.decoder().OpenFromFile(entry.audio_filepath);
+    sample.decode_f_ = [this, &sample, entry_idx, offset](SampleView<CPUBackend> audio, int tid) {
+      const char *audio_filepath = entries_.audio_filepath(entry_idx);
+      sample.decoder().OpenFromFile(audio_filepath);
       if (offset > 0)
         sample.decoder().SeekFrames(offset);
       ReadAudio<OutputType>(
-        audio, sample.audio_meta_, entry, sample.decoder(),
+        audio, sample.audio_meta_, audio_filepath, sample.decoder(),
         decode_scratch_[tid], resample_scratch_[tid]);
       sample.decoder().Close();
     };
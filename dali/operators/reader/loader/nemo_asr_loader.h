@@ -16,15 +16,18 @@
 #define DALI_OPERATORS_READER_LOADER_NEMO_ASR_LOADER_H_
 
 #include <algorithm>
+#include <cstring>
 #include <future>
 #include <istream>
 #include <memory>
+#include <random>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
+#include "dali/core/span.h"
 #include "dali/kernels/signal/resampling_cpu.h"
 #include "dali/operators/decoder/audio/audio_decoder.h"
 #include "dali/operators/decoder/audio/audio_decoder_impl.h"
@@ -43,6 +46,73 @@ struct NemoAsrEntry {
   std::string text;  // transcription
 };
 
+/**
+ * @brief The entries of the parsed manifests
+ *
+ * The paths and the transcripts of all the entries are kept in one buffer, so that a manifest
+ * of tens of millions of entries doesn't need as many string allocations.
+ */
+class DLL_PUBLIC NemoAsrManifest {
+ public:
+  void Append(const char *audio_filepath, double duration = kDefaultDuration,
+              double offset = 0.0, int64_t index = -1, const char *text = "") {
+    entries_.push_back({duration, offset, index, static_cast<int64_t>(strings_.size()), 0});
+    strings_.insert(strings_.end(), audio_filepath,
+                    audio_filepath + std::strlen(audio_filepath) + 1);
+    entries_.back().text_offset = strings_.size();
+    strings_.insert(strings_.end(), text, text + std::strlen(text) + 1);
+  }
+
+  /**
+   * @brief Appends the entries of `other`, with their indices increased by `index_offset`
+   */
+  void Append(const NemoAsrManifest &other, int64_t index_offset = 0) {
+    int64_t strings_offset = strings_.size();
+    for (auto entry : other.entries_) {
+      entry.index += index_offset;
+      entry.path_offset += strings_offset;
+      entry.text_offset += strings_offset;
+      entries_.push_back(entry);
+    }
+    strings_.insert(strings_.end(), other.strings_.begin(), other.strings_.end());
+  }
+
+  const char *audio_filepath(int64_t idx) const {
+    return strings_.data() + entries_[idx].path_offset;
+  }
+
+  const char *text(int64_t idx) const {
+    return strings_.data() + entries_[idx].text_offset;
+  }
+
+  double duration(int64_t idx) const { return entries_[idx].duration; }
+  double offset(int64_t idx) const { return entries_[idx].offset; }
+  int64_t index(int64_t idx) const { return entries_[idx].index; }
+
+  NemoAsrEntry operator[](int64_t idx) const {
+    const auto &entry = entries_[idx];
+    return {audio_filepath(idx), entry.duration, entry.offset, entry.index, text(idx)};
+  }
+
+  int64_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  void clear() {
+    entries_.clear();
+    strings_.clear();
+  }
+
+ private:
+  struct Entry {
+    double duration, offset;
+    int64_t index;
+    // the offsets of the null-terminated strings in strings_
+    int64_t path_offset, text_offset;
+  };
+  std::vector<Entry> entries_;
+  std::vector<char> strings_;
+};
+
 class AsrSample {
  public:
   int64_t index() const {
@@ -94,16 +164,28 @@ class AsrSample {
 namespace detail {
 
 /**
- * @brief Parses the contents of a manifest file and populates a vector of NemoAsrEntry
+ * @brief Parses the contents of a manifest file and appends the entries to `entries`
  * @param min_duration Minimum audio duration, in seconds. Shorter samples will be filtered out.
  * @param max_duration Maximum audio duration, in seconds. Longer samples will be filtered out.
  * @param read_text If True, the parser will read the text transcript from the manifest.
  *                  If False, the text field is ignored.
+ * @param num_threads The number of threads parsing the chunks of a large manifest
  */
-DLL_PUBLIC void ParseManifest(std::vector<NemoAsrEntry> &entries, std::istream &manifest_file,
+DLL_PUBLIC void ParseManifest(NemoAsrManifest &entries, std::istream &manifest_file,
                               double min_duration = kDefaultDuration,
                               double max_duration = kDefaultDuration,
-                              bool read_text = true);
+                              bool read_text = true, int num_threads = 1);
+
+/**
+ * @brief Reorders `indices` (of `entries`), so that the consecutive batches group samples
+ *        of similar durations
+ *
+ * The indices are split into buckets of `bucket_size` samples. Each bucket is sorted by
+ * the duration and split into batches of `batch_size` samples. The complete batches are
+ * shuffled with `rng`, so that the batches of short and long samples are interleaved.
+ */
+DLL_PUBLIC void BucketByDuration(span<size_t> indices, const NemoAsrManifest &entries,
+                                 int batch_size, int64_t bucket_size, std::mt19937 &rng);
 
 }  // namespace detail
 
@@ -120,6 +202,8 @@ class DLL_PUBLIC NemoAsrLoader : public Loader<CPUBackend, AsrSample> {
         min_duration_(spec.GetArgument<float>("min_duration")),
         max_duration_(spec.GetArgument<float>("max_duration")),
         read_text_(spec.GetArgument<bool>("read_text")),
+        batch_size_(spec.GetArgument<int>("max_batch_size")),
+        bucket_batches_(spec.GetArgument<int>("bucket_batches")),
         num_threads_(std::max(1, spec.GetArgument<int>("num_threads"))),
         decode_scratch_(num_threads_),
         resample_scratch_(num_threads_) {
@@ -140,6 +224,12 @@ class DLL_PUBLIC NemoAsrLoader : public Loader<CPUBackend, AsrSample> {
     if (shuffle_after_epoch_)
       stick_to_shard_ = true;
 
+    DALI_ENFORCE(bucket_batches_ >= 0, "``bucket_batches`` must not be negative");
+    // the shuffling buffer of the loader would mix the samples of the batches
+    DALI_ENFORCE(bucket_batches_ == 0 || !shuffle_,
+                 "``bucket_batches`` can't be used with ``random_shuffle``. "
+                 "Use ``shuffle_after_epoch`` instead.");
+
     double q = quality_;
     DALI_ENFORCE(q >= 0 && q <= 100, "Resampling quality must be in [0..100] range");
     // this should give 3 lobes for q = 0, 16 lobes for q = 50 and 64 lobes for q = 100
@@ -157,16 +247,19 @@ class DLL_PUBLIC NemoAsrLoader : public Loader<CPUBackend, AsrSample> {
   void Reset(bool wrap_to_shard) override;
 
  private:
+  /// @brief Groups samples of similar durations in batches, if `bucket_batches` is set
+  void BucketIndices();
+
   template <typename OutputType>
   void ReadAudio(SampleView<CPUBackend> audio,
                  const AudioMetadata &audio_meta,
-                 const NemoAsrEntry &entry,
+                 const char *audio_filepath,
                  AudioDecoderBase &decoder,
                  std::vector<float> &decode_scratch,
                  std::vector<float> &resample_scratch);
 
   std::vector<std::string> manifest_filepaths_;
-  std::vector<NemoAsrEntry> entries_;
+  NemoAsrManifest entries_;
   std::vector<size_t> shuffled_indices_;
 
   bool shuffle_after_epoch_;
@@ -180,6 +273,8 @@ class DLL_PUBLIC NemoAsrLoader : public Loader<CPUBackend, AsrSample> {
   double min_duration_;
   double max_duration_;
   bool read_text_;
+  int batch_size_;
+  int bucket_batches_;
   int num_threads_;
   kernels::signal::resampling::ResamplerCPU resampler_;
   std::vector<std::vector<float>> decode_scratch_;
@@ -13,10 +13,13 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cstdio>
+#include <random>
 #include <utility>
 #include <sstream>
 #include <string>
+#include <vector>
 #include "dali/pipeline/data/backend.h"
 #include "dali/test/dali_test_config.h"
 #include "dali/pipeline/data/views.h"
@@ -34,7 +37,7 @@ TEST(NemoAsrLoaderTest, ParseManifest) {
   ss << R"code({"audio_filepath": "path/to/audio1.wav", "duration": 1.45, "text": "     A ab B C D   "})code" << std::endl;
   ss << R"code({"audio_filepath": "path/to/audio2.wav", "duration": 2.45, "offset": 1.03, "text": "C DA B"})code" << std::endl;
   ss << R"code({"audio_filepath": "path/to/audio3.wav", "duration": 3.45})code" << std::endl;
-  std::vector<NemoAsrEntry> entries;
+  NemoAsrManifest entries;
   detail::ParseManifest(entries, ss);
   ASSERT_EQ(3, entries.size());
 
@@ -109,11 +112,11 @@ TEST(NemoAsrLoaderTest, ParseNonAsciiTransript) {
   for (const auto& data : tests) {
     std::stringstream ss;
     ss << R"code({"audio_filepath": "path/to/audio1.wav", "duration": 1.45, "text": ")code" << data.first << R"code("})code" << std::endl;
-    std::vector<NemoAsrEntry> entries;
+    NemoAsrManifest entries;
     detail::ParseManifest(entries, ss);
     ASSERT_EQ(1, entries.size());
     ASSERT_EQ(data.second.size(), entries[0].text.length());
-    EXPECT_EQ(0, std::memcmp(data.second.data(), entries[0].text.c_str(), data.second.size()));
+    EXPECT_EQ(0, std::memcmp(data.second.data(), entries.text(0), data.second.size()));
   }
 }
 
@@ -135,6 +138,74 @@ void tempfile(std::string& filename, std::string content = "") {
   close(fd);
 }
 
+TEST(NemoAsrLoaderTest, ParseManifestInParallel) {
+  std::stringstream ss;
+  ss << "not a json\n\n";
+  for (int i = 0; i < 20000; i++) {
+    ss << R"code({"audio_filepath": "path/to/audio)code" << i << R"code(.wav", "duration": )code"
+       << i % 100 << R"code(, "offset": 0.5, "text": "transcript )code" << i << R"code("})code"
+       << "\n";
+  }
+  for (int num_threads : {1, 4}) {
+    ss.clear();
+    ss.seekg(0);
+    NemoAsrManifest entries;
+    entries.Append("path/to/first.wav");  // the entries are appended after the existing ones
+    detail::ParseManifest(entries, ss, 1.0, 90.0, true, num_threads);
+    ASSERT_EQ(entries.size(), 1 + 20000 / 100 * 90);
+    int64_t index = 0;
+    for (int i = 0; i < 20000; i++) {
+      if (i % 100 < 1 || i % 100 > 90)
+        continue;
+      auto entry = entries[index + 1];
+      EXPECT_EQ(entry.audio_filepath, make_string("path/to/audio", i, ".wav"));
+      EXPECT_EQ(entry.duration, i % 100);
+      EXPECT_EQ(entry.offset, 0.5);
+      EXPECT_EQ(entry.text, make_string("transcript ", i));
+      ASSERT_EQ(entry.index, index);
+      index++;
+    }
+  }
+}
+
+TEST(NemoAsrLoaderTest, BucketByDuration) {
+  NemoAsrManifest entries;
+  std::vector<size_t> indices(23);
+  for (size_t i = 0; i < indices.size(); i++) {
+    entries.Append("", (i * 7) % 11);
+    indices[i] = i;
+  }
+  std::mt19937 rng(123);
+  const int batch_size = 4, bucket_size = 12;
+  detail::BucketByDuration(make_span(indices), entries, batch_size, bucket_size, rng);
+
+  auto sorted = indices;
+  std::sort(sorted.begin(), sorted.end());
+  for (size_t i = 0; i < sorted.size(); i++)
+    ASSERT_EQ(sorted[i], i) << "Not a permutation of the indices";
+
+  for (int64_t start = 0; start < static_cast<int64_t>(indices.size()); start += bucket_size) {
+    int64_t end = std::min<int64_t>(start + bucket_size, indices.size());
+    // each bucket contains the same samples as before
+    for (int64_t i = start; i < end; i++) {
+      EXPECT_GE(indices[i], start);
+      EXPECT_LT(indices[i], end);
+    }
+    // the batches of a bucket don't overlap in duration
+    for (int64_t b0 = start; b0 < end; b0 += batch_size) {
+      for (int64_t b1 = start; b1 < end; b1 += batch_size) {
+        double max0 = 0, min1 = 1e9;
+        for (int64_t i = b0; i < std::min<int64_t>(b0 + batch_size, end); i++)
+          max0 = std::max(max0, entries.duration(indices[i]));
+        for (int64_t i = b1; i < std::min<int64_t>(b1 + batch_size, end); i++)
+          min1 = std::min(min1, entries.duration(indices[i]));
+        if (entries.duration(indices[b0]) < entries.duration(indices[b1]))
+          EXPECT_LE(max0, min1);
+      }
+    }
+  }
+}
+
 TEST(NemoAsrLoaderTest, ParseManifestContent) {
   std::string manifest_filepath =
       "/tmp/nemo_asr_manifest_XXXXXX";  // XXXXXX is replaced in tempfile()
@@ -16,6 +16,9 @@
 #include <errno.h>
 #include <cstdlib>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "dali/core/common.h"
 #include "dali/operators/reader/loader/numpy_loader.h"
@@ -217,10 +220,91 @@ void NumpyHeaderCache::UpdateCache(const string &file_name, const NumpyHeaderMet
   }
 }
 
+void GetRoiReads(std::vector<FileStream::ReadRequest> &reads, FileStream *file,
+                 uint8_t *buffer, const NumpyHeaderMeta &header,
+                 const TensorShape<> &anchor, const TensorShape<> &shape) {
+  const auto &array_shape = header.shape;
+  int ndim = array_shape.sample_dim();
+  DALI_ENFORCE(anchor.sample_dim() == ndim && shape.sample_dim() == ndim,
+               "The region of interest must have the same dimensionality as the array.");
+  for (int d = 0; d < ndim; d++) {
+    DALI_ENFORCE(anchor[d] >= 0 && shape[d] >= 0 && anchor[d] + shape[d] <= array_shape[d],
+                 make_string("The region of interest with anchor ", anchor, " and shape ", shape,
+                             " exceeds the bounds of the array of shape ", array_shape));
+  }
+  if (volume(shape) == 0)
+    return;
+
+  // The elements of the dimensions that the box spans entirely, and of the innermost
+  // dimension that it doesn't, are contiguous - they're read at once.
+  int64_t elem_size = header.type_info->size();
+  int outer_dims = ndim - 1;
+  int64_t run_size = elem_size;
+  while (outer_dims >= 0) {
+    run_size *= shape[outer_dims];
+    if (shape[outer_dims] != array_shape[outer_dims])
+      break;
+    outer_dims--;
+  }
+
+  TensorShape<> strides;
+  strides.resize(ndim);
+  int64_t stride = elem_size;
+  for (int d = ndim - 1; d >= 0; d--) {
+    strides[d] = stride;
+    stride *= array_shape[d];
+  }
+  int64_t base_offset = header.data_offset;
+  for (int d = std::max(outer_dims, 0); d < ndim; d++)
+    base_offset += anchor[d] * strides[d];
+
+  TensorShape<> pos;
+  pos.resize(std::max(outer_dims, 0));
+  for (auto &p : pos)
+    p = 0;
+  int64_t num_runs = volume(shape.begin(), shape.begin() + pos.size());
+  reads.reserve(reads.size() + num_runs);
+  for (int64_t r = 0; r < num_runs; r++) {
+    int64_t offset = base_offset;
+    for (int d = 0; d < pos.sample_dim(); d++)
+      offset += (anchor[d] + pos[d]) * strides[d];
+    FileStream::ReadRequest req;
+    req.stream = file;
+    req.buffer = buffer + r * run_size;
+    req.n_bytes = run_size;
+    req.offset = offset;
+    reads.push_back(req);
+    // next position, in C order
+    for (int d = pos.sample_dim() - 1; d >= 0; d--) {
+      if (++pos[d] < shape[d])
+        break;
+      pos[d] = 0;
+    }
+  }
+}
+
 }  // namespace detail
 
+void NumpyLoader::PrefetchFiles(Index pos) {
+  if (!UseFileHandleCache(!copy_read_data_))
+    return;
+  std::vector<std::string> paths;
+  for (auto idx : FilePrefetchIndices(pos))
+    paths.push_back(filesystem::join_path(file_root_, files_[idx]));
+  PrefetchSampleFiles(paths, read_ahead_, !copy_read_data_);
+}
+
 void NumpyLoader::ReadSample(NumpyFileWrapper& target) {
-  auto filename = files_[current_index_++];
+  ReadSampleImpl(target, false);
+}
+
+void NumpyLoader::QueueReadSample(NumpyFileWrapper& target) {
+  ReadSampleImpl(target, true);
+}
+
+void NumpyLoader::ReadSampleImpl(NumpyFileWrapper& target, bool queue) {
+  PrefetchFiles(current_index_);
+  auto filename = files_[GlobalSampleIndex(current_index_++)];
 
   // handle wrap-around
   MoveToNextShard(current_index_);
@@ -240,8 +324,9 @@ void NumpyLoader::ReadSample(NumpyFileWrapper& target) {
     return;
   }
 
+  queue = queue && copy_read_data_ && !defer_data_read_;
   auto path = filesystem::join_path(file_root_, filename);
-  auto current_file = FileStream::Open(path, read_ahead_, !copy_read_data_);
+  auto current_file = OpenSampleFile(path, read_ahead_, !copy_read_data_, queue);
 
   // read the header
   NumpyHeaderMeta header;
@@ -257,6 +342,18 @@ void NumpyLoader::ReadSample(NumpyFileWrapper& target) {
     DALI_FAIL(e.what() + ". File: " + filename);
   }
 
+  if (defer_data_read_) {
+    // the data is read by the operator, once the region of interest is known
+    target.data.Reset();
+    target.data.SetMeta(meta);
+    target.header = header;
+    target.file_stream = std::move(current_file);
+    target.filename = std::move(path);
+    target.fortran_order = header.fortran_order;
+    return;
+  }
+  target.file_stream.reset();
+
   Index nbytes = header.nbytes();
 
   if (copy_read_data_) {
@@ -264,6 +361,23 @@ void NumpyLoader::ReadSample(NumpyFileWrapper& target) {
       target.data.Reset();
     }
     target.data.Resize(header.shape, header.type());
+    if (queue) {
+      QueuedRead read;
+      read.stream = std::move(current_file);
+      read.request.buffer = static_cast<uint8_t*>(target.data.raw_mutable_data());
+      read.request.n_bytes = nbytes;
+      read.request.offset = header.data_offset;
+      read.done = [this, path, filename](QueuedRead &read) {
+        DALI_ENFORCE(read.request.bytes_read == read.request.n_bytes,
+                     make_string("Failed to read file: ", filename));
+        ReleaseSampleFile(path, std::move(read.stream), false);
+      };
+      QueueRead(target, std::move(read));
+      target.data.SetMeta(meta);
+      target.filename = std::move(path);
+      target.fortran_order = header.fortran_order;
+      return;
+    }
     // copy the image
     Index ret = current_file->Read(static_cast<uint8_t*>(target.data.raw_mutable_data()),
                                     nbytes);
@@ -276,8 +390,8 @@ void NumpyLoader::ReadSample(NumpyFileWrapper& target) {
     target.data.Resize(header.shape, header.type());
   }
 
-  // close the file handle
-  current_file->Close();
+  // close the file handle or keep it for later
+  ReleaseSampleFile(path, std::move(current_file), !copy_read_data_);
 
   // set metadata
   target.data.SetMeta(meta);
@@ -63,12 +63,19 @@ struct NumpyFileWrapper {
   std::string filename;
   bool fortran_order = false;
 
+  /**
+   * @brief The file to read the data from, when reading is deferred until the region
+   *        of interest is known; otherwise null and the data is stored in `data`.
+   */
+  std::unique_ptr<FileStream> file_stream;
+  NumpyHeaderMeta header;
+
   DALIDataType get_type() const {
-    return data.type();
+    return file_stream ? header.type() : data.type();
   }
 
   const TensorShape<>& get_shape() const {
-    return data.shape();
+    return file_stream ? header.shape : data.shape();
   }
 
   const DALIMeta& get_meta() const {
@@ -83,6 +90,16 @@ DLL_PUBLIC void ParseHeaderMetadata(NumpyHeaderMeta& target, const std::string &
 // parser function, only for internal use
 void ParseHeader(FileStream *file, NumpyHeaderMeta& target);
 
+/**
+ * @brief Lists the reads which load a box of the array stored in a file to a dense buffer.
+ *
+ * The box, given by `anchor` and `shape` in the (C-order) layout of the data in the file, must
+ * lie within the array; its contiguous parts are read with single requests.
+ */
+DLL_PUBLIC void GetRoiReads(std::vector<FileStream::ReadRequest> &reads, FileStream *file,
+                            uint8_t *buffer, const NumpyHeaderMeta &header,
+                            const TensorShape<> &anchor, const TensorShape<> &shape);
+
 class NumpyHeaderCache {
  public:
   explicit NumpyHeaderCache(bool cache_headers) : cache_headers_(cache_headers) {}
@@ -104,7 +121,14 @@ class NumpyLoader : public FileLoader<CPUBackend, NumpyFileWrapper> {
     const OpSpec& spec,
     bool shuffle_after_epoch = false)
     : FileLoader(spec, shuffle_after_epoch),
-    header_cache_(spec.GetArgument<bool>("cache_header_information")) {}
+    header_cache_(spec.GetArgument<bool>("cache_header_information")) {
+    // With a region of interest, only the part of the array within it is read - when the
+    // (possibly per-sample) region is known.
+    for (const char *arg : { "roi_start", "rel_roi_start", "roi_end", "rel_roi_end",
+                             "roi_shape", "rel_roi_shape" }) {
+      defer_data_read_ = defer_data_read_ || spec.ArgumentDefined(arg);
+    }
+  }
 
   void PrepareEmpty(NumpyFileWrapper &target) override {
     target = {};
@@ -112,9 +136,23 @@ class NumpyLoader : public FileLoader<CPUBackend, NumpyFileWrapper> {
 
   // we want to make it possible to override this function as well
   void ReadSample(NumpyFileWrapper& target) override;
+  void QueueReadSample(NumpyFileWrapper& target) override;
 
  private:
+  /**
+   * @brief Reads the next sample; if `queue` is set and the data is copied, the data read is
+   *        left queued, to be submitted with the rest of the batch
+   */
+  void ReadSampleImpl(NumpyFileWrapper& target, bool queue);
+
+  /**
+   * @brief Starts opening the files of the samples following the one at position `pos`,
+   *        if the file handle cache is enabled
+   */
+  void PrefetchFiles(Index pos);
+
   detail::NumpyHeaderCache header_cache_;
+  bool defer_data_read_ = false;
 };
 
 }  // namespace dali
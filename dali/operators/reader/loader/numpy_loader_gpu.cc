@@ -63,7 +63,7 @@ void NumpyLoaderGPU::ReadSample(NumpyFileWrapperGPU& target) {
   DeviceGuard g(device_id_);
 
   // extract image file
-  auto filename = files_[current_index_++];
+  auto filename = files_[GlobalSampleIndex(current_index_++)];
 
   // handle wrap-around
   MoveToNextShard(current_index_);
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 #include "dali/operators/reader/loader/numpy_loader.h"
 
 
@@ -59,5 +60,43 @@ TEST(NumpyLoaderTest, ParseHeaderError) {
   }
 }
 
+TEST(NumpyLoaderTest, RoiReads) {
+  NumpyHeaderMeta header;
+  detail::ParseHeaderMetadata(header, "{'descr':'<i2', 'fortran_order':False, 'shape':(4,5,6),}");
+  header.data_offset = 128;
+  uint8_t buffer[1];
+  std::vector<FileStream::ReadRequest> reads;
+
+  // the innermost dimension is cropped - a read per row
+  detail::GetRoiReads(reads, nullptr, buffer, header, {1, 2, 3}, {2, 2, 3});
+  ASSERT_EQ(reads.size(), 4u);
+  for (int i = 0; i < 4; i++) {
+    int y = 1 + i / 2, z = 2 + i % 2;
+    EXPECT_EQ(reads[i].offset, 128 + ((y * 5 + z) * 6 + 3) * 2);
+    EXPECT_EQ(reads[i].n_bytes, 3u * 2);
+    EXPECT_EQ(reads[i].buffer, buffer + i * 3 * 2);
+  }
+
+  // the inner dimensions are whole - the planes are contiguous
+  reads.clear();
+  detail::GetRoiReads(reads, nullptr, buffer, header, {1, 0, 0}, {3, 5, 6});
+  ASSERT_EQ(reads.size(), 1u);
+  EXPECT_EQ(reads[0].offset, 128 + 5 * 6 * 2);
+  EXPECT_EQ(reads[0].n_bytes, 3u * 5 * 6 * 2);
+
+  reads.clear();
+  detail::GetRoiReads(reads, nullptr, buffer, header, {0, 1, 0}, {4, 2, 6});
+  ASSERT_EQ(reads.size(), 4u);
+  EXPECT_EQ(reads[3].offset, 128 + (3 * 5 + 1) * 6 * 2);
+  EXPECT_EQ(reads[3].n_bytes, 2u * 6 * 2);
+
+  reads.clear();
+  detail::GetRoiReads(reads, nullptr, buffer, header, {0, 0, 0}, {4, 0, 6});
+  EXPECT_TRUE(reads.empty());
+
+  EXPECT_THROW(detail::GetRoiReads(reads, nullptr, buffer, header, {0, 4, 0}, {4, 2, 6}),
+               std::runtime_error);
+}
+
 }  // namespace dali
 
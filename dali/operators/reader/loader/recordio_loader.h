@@ -84,10 +84,17 @@ class RecordIOLoader : public IndexedFileLoader {
 
     int64 seek_pos, size;
     size_t file_index;
-    std::tie(seek_pos, size, file_index) = indices_[current_index_];
+    std::tie(seek_pos, size, file_index) = indices_[SampleIndex(current_index_)];
 
     ++current_index_;
 
+    // with global_shuffle, the consecutive records come from different files
+    if (file_index != current_file_index_) {
+      current_file_ = OpenStream(uris_[file_index], read_ahead_, !copy_read_data_);
+      current_file_index_ = file_index;
+      should_seek_ = true;
+    }
+
     std::string image_key = uris_[file_index] + " at index " + to_string(seek_pos);
     DALIMeta meta;
     meta.SetSourceInfo(image_key);
@@ -140,8 +147,7 @@ class RecordIOLoader : public IndexedFileLoader {
         DALI_ENFORCE(current_file_index_ + 1 < uris_.size(),
           "Incomplete or corrupted record files");
         // Release previously opened file
-        current_file_ = FileStream::Open(uris_[++current_file_index_], read_ahead_,
-                                         !copy_read_data_);
+        current_file_ = OpenStream(uris_[++current_file_index_], read_ahead_, !copy_read_data_);
         next_seek_pos_ = 0;
         continue;
       }
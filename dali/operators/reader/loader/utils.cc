@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,7 @@
 #include <iostream>
 #include <sstream>
 #include "dali/operators/reader/loader/utils.h"
+#include "dali/pipeline/util/thread_pool.h"
 
 namespace dali {
 
@@ -67,4 +68,46 @@ bool HasKnownExtension(const std::string &filepath) {
   return HasExtension(filepath, extensions);
 }
 
+std::string ReadWholeStream(std::istream &stream) {
+  std::string text;
+  char buffer[1 << 16];
+  while (stream.read(buffer, sizeof(buffer)) || stream.gcount() > 0)
+    text.append(buffer, stream.gcount());
+  return text;
+}
+
+std::vector<size_t> SplitIntoLineChunks(const char *text, size_t size, int max_chunks,
+                                        size_t min_chunk_size) {
+  int num_chunks = std::max<int>(1, std::min<size_t>(max_chunks, size / std::max<size_t>(
+                                                                     min_chunk_size, 1)));
+  size_t chunk_size = size / num_chunks;
+  std::vector<size_t> offsets = {0};
+  for (int i = 1; i < num_chunks; i++) {
+    size_t start = std::max(offsets.back() + 1, i * chunk_size);
+    if (start >= size)
+      break;
+    // the chunk starts after the line break at or following its nominal start
+    auto *line_break = static_cast<const char *>(std::memchr(text + start - 1, '\n',
+                                                             size - start + 1));
+    if (!line_break || line_break + 1 == text + size)
+      break;
+    offsets.push_back(line_break + 1 - text);
+  }
+  offsets.push_back(size);
+  return offsets;
+}
+
+void ParseChunks(int num_chunks, int num_threads, const std::function<void(int)> &parse_chunk) {
+  if (num_threads <= 1 || num_chunks <= 1) {
+    for (int i = 0; i < num_chunks; i++)
+      parse_chunk(i);
+    return;
+  }
+  ThreadPool thread_pool(std::min(num_threads, num_chunks), CPU_ONLY_DEVICE_ID, false,
+                         "Reader metadata");
+  for (int i = 0; i < num_chunks; i++)
+    thread_pool.AddWork([&parse_chunk, i](int) { parse_chunk(i); });
+  thread_pool.RunAll();
+}
+
 }  // namespace dali
@@ -15,6 +15,10 @@
 #ifndef DALI_OPERATORS_READER_LOADER_UTILS_H_
 #define DALI_OPERATORS_READER_LOADER_UTILS_H_
 
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <istream>
 #include <vector>
 #include <string>
 #include "dali/core/api_helper.h"
@@ -45,6 +49,54 @@ DLL_PUBLIC bool HasExtension(std::string filepath, const std::vector<std::string
  */
 DLL_PUBLIC bool HasKnownExtension(const std::string &filepath);
 
+/**
+ * @brief Reads the remaining contents of the stream
+ */
+DLL_PUBLIC std::string ReadWholeStream(std::istream &stream);
+
+/**
+ * @brief Splits the text into (at most `max_chunks`) consecutive chunks of whole lines, which can
+ *        be parsed independently; the chunks, except the last one, have at least `min_chunk_size`
+ *        bytes.
+ *
+ * @return The offsets of the chunks, followed by `size`
+ */
+DLL_PUBLIC std::vector<size_t> SplitIntoLineChunks(const char *text, size_t size, int max_chunks,
+                                                   size_t min_chunk_size);
+
+/**
+ * @brief Runs `parse_chunk(chunk)` for each chunk in [0, num_chunks), on a thread pool of (at most)
+ *        `num_threads` threads, and rethrows the first error
+ *
+ * With one thread or one chunk, the chunks are parsed in the calling thread.
+ */
+DLL_PUBLIC void ParseChunks(int num_chunks, int num_threads,
+                            const std::function<void(int)> &parse_chunk);
+
+/**
+ * @brief Calls `f(line, length)` for each line in [begin, end), with the line break replaced by
+ *        the null character.
+ *
+ * The lines are found with memchr, which the C library vectorizes. `*end` must be writable, e.g.
+ * the terminating null character of a string.
+ *
+ * @return The number of lines, including the empty ones
+ */
+template <typename F>
+int64_t ForEachLine(char *begin, char *end, F &&f) {
+  int64_t num_lines = 0;
+  while (begin < end) {
+    char *line_end = static_cast<char *>(std::memchr(begin, '\n', end - begin));
+    if (!line_end)
+      line_end = end;
+    *line_end = '\0';
+    f(begin, line_end - begin);
+    num_lines++;
+    begin = line_end + 1;
+  }
+  return num_lines;
+}
+
 }  // namespace dali
 
 #endif  // DALI_OPERATORS_READER_LOADER_UTILS_H_
@@ -13,8 +13,16 @@
 // limitations under the License.
 
 #include "dali/operators/reader/loader/video/frames_decoder.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <memory>
 #include <iomanip>
+#include <string>
+#include <utility>
+#include <vector>
 #include "dali/core/error_handling.h"
 
 
@@ -30,6 +38,43 @@ std::string av_error_string(int ret) {
 
 using AVPacketScope = std::unique_ptr<AVPacket, decltype(&av_packet_unref)>;
 
+namespace {
+
+constexpr char kIndexMagic[8] = {'D', 'A', 'L', 'I', 'F', 'I', 'D', 'X'};
+constexpr uint32_t kIndexVersion = 1;
+
+/**
+ * @brief Header of a stored frame index. The size and the modification time of the video
+ *        identify the version of the file the index was built for.
+ */
+struct IndexFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t entry_size;
+  int64_t video_size;
+  int64_t video_mtime_ns;
+  int64_t num_entries;
+};
+
+struct IndexFileEntry {
+  int64_t pts;
+  int32_t last_keyframe_id;
+  uint8_t is_keyframe;
+  uint8_t is_flush_frame;
+  uint8_t padding[2];
+};
+
+bool VideoFileStamp(const std::string &filename, int64_t &size, int64_t &mtime_ns) {
+  struct stat s;
+  if (stat(filename.c_str(), &s) != 0)
+    return false;
+  size = s.st_size;
+  mtime_ns = static_cast<int64_t>(s.st_mtim.tv_sec) * 1000000000 + s.st_mtim.tv_nsec;
+  return true;
+}
+
+}  // namespace
+
 const std::vector<AVCodecID> FramesDecoder::SupportedCodecs = {
   AVCodecID::AV_CODEC_ID_H264,
   AVCodecID::AV_CODEC_ID_HEVC
@@ -44,6 +89,11 @@ void FramesDecoder::InitAvState() {
     ret >= 0,
     make_string("Could not fill the codec based on parameters: ", detail::av_error_string(ret)));
 
+  // The frames are still returned in order, the threading (if supported by the codec) only adds
+  // to the latency of the decoder.
+  av_state_->codec_ctx_->thread_count = num_threads_;
+  av_state_->codec_ctx_->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
   ret = avcodec_open2(av_state_->codec_ctx_, av_state_->codec_, nullptr);
   DALI_ENFORCE(
     ret == 0,
@@ -81,8 +131,10 @@ void FramesDecoder::FindVideoStream() {
   DALI_FAIL(make_string("Could not find a valid video stream in a file ", filename_));
 }
 
-FramesDecoder::FramesDecoder(const std::string &filename)
-    : av_state_(std::make_unique<AvState>()), filename_(filename) {
+FramesDecoder::FramesDecoder(const std::string &filename, const std::string &index_dir,
+                             int num_threads)
+    : av_state_(std::make_unique<AvState>()), filename_(filename), index_dir_(index_dir),
+      num_threads_(num_threads) {
 
   av_log_set_level(AV_LOG_ERROR);
 
@@ -98,7 +150,99 @@ FramesDecoder::FramesDecoder(const std::string &filename)
     CheckCodecSupport(),
     make_string("Unsupported video codec: ", av_state_->codec_->name, " in file: ", filename));
   InitAvState();
-  BuildIndex();
+  if (index_dir_.empty() || !LoadIndex()) {
+    BuildIndex();
+    if (!index_dir_.empty())
+      SaveIndex();
+  }
+}
+
+std::string FramesDecoder::IndexPath() const {
+  // 64-bit FNV-1a of the path of the video, which must not change between runs and builds
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (unsigned char c : filename_) {
+    h ^= c;
+    h *= 0x100000001b3ull;
+  }
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.frames_index",
+           static_cast<unsigned long long>(h));  // NOLINT(runtime/int)
+  return index_dir_ + "/" + name;
+}
+
+bool FramesDecoder::LoadIndex() {
+  int64_t video_size, video_mtime_ns;
+  if (!VideoFileStamp(filename_, video_size, video_mtime_ns))
+    return false;
+  FILE *f = fopen(IndexPath().c_str(), "rb");
+  if (!f)
+    return false;
+  std::unique_ptr<FILE, int(*)(FILE *)> file(f, fclose);
+
+  IndexFileHeader header;
+  if (fread(&header, sizeof(header), 1, f) != 1 ||
+      memcmp(header.magic, kIndexMagic, sizeof(kIndexMagic)) != 0 ||
+      header.version != kIndexVersion || header.entry_size != sizeof(IndexFileEntry) ||
+      header.video_size != video_size || header.video_mtime_ns != video_mtime_ns ||
+      header.num_entries <= 0)
+    return false;
+
+  std::vector<IndexFileEntry> entries(header.num_entries);
+  if (fread(entries.data(), sizeof(IndexFileEntry), entries.size(), f) != entries.size())
+    return false;
+
+  std::vector<IndexEntry> index;
+  index.reserve(entries.size());
+  for (auto &e : entries) {
+    if (e.last_keyframe_id < -1 || e.last_keyframe_id >= header.num_entries)
+      return false;
+    index.push_back({e.pts, e.last_keyframe_id, e.is_keyframe != 0, e.is_flush_frame != 0});
+  }
+  index_ = std::move(index);
+  LOG_LINE << "Loaded the index of " << filename_ << " with " << index_.size() << " frames"
+           << std::endl;
+  return true;
+}
+
+void FramesDecoder::SaveIndex() const {
+  IndexFileHeader header = {};
+  memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+  header.version = kIndexVersion;
+  header.entry_size = sizeof(IndexFileEntry);
+  header.num_entries = index_.size();
+  if (!VideoFileStamp(filename_, header.video_size, header.video_mtime_ns))
+    return;
+
+  std::vector<IndexFileEntry> entries(index_.size());
+  for (size_t i = 0; i < index_.size(); i++) {
+    entries[i] = {};
+    entries[i].pts = index_[i].pts;
+    entries[i].last_keyframe_id = index_[i].last_keyframe_id;
+    entries[i].is_keyframe = index_[i].is_keyframe;
+    entries[i].is_flush_frame = index_[i].is_flush_frame;
+  }
+
+  if (mkdir(index_dir_.c_str(), 0755) != 0 && errno != EEXIST) {
+    DALI_WARN("Cannot create the frame index directory ", index_dir_, ": ", strerror(errno));
+    return;
+  }
+  // Several processes may build the index of the same video - each writes its own copy and
+  // atomically replaces the stored index with it.
+  std::string path = IndexPath();
+  std::string tmp_path = make_string(path, ".tmp.", getpid(), ".", this);
+  FILE *f = fopen(tmp_path.c_str(), "wb");
+  bool ok = f != nullptr;
+  if (ok) {
+    ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+         fwrite(entries.data(), sizeof(IndexFileEntry), entries.size(), f) == entries.size();
+    ok = (fclose(f) == 0) && ok;
+    ok = ok && rename(tmp_path.c_str(), path.c_str()) == 0;
+  }
+  if (!ok) {
+    DALI_WARN("Cannot store the frame index of ", filename_, " in ", path, ": ",
+              strerror(errno));
+    remove(tmp_path.c_str());
+  }
 }
 
 void FramesDecoder::BuildIndex() {
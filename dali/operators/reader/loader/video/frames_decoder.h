@@ -82,8 +82,14 @@ class DLL_PUBLIC FramesDecoder {
    * @brief Construct a new FramesDecoder object.
    * 
    * @param filename Path to a video file.
+   * @param index_dir Directory where the frame index of the video is stored, so that it's built
+   *                  only once - by the first decoder opening the video. If empty, the index is
+   *                  built every time.
+   * @param num_threads The number of threads used by FFmpeg to decode the video (with frame and
+   *                    slice threading). If 0, FFmpeg chooses it.
    */
-  explicit FramesDecoder(const std::string &filename);
+  explicit FramesDecoder(const std::string &filename, const std::string &index_dir = {},
+                         int num_threads = 1);
 
   /**
    * @brief Number of frames in the video
@@ -195,6 +201,24 @@ class DLL_PUBLIC FramesDecoder {
 
   void BuildIndex();
 
+  /**
+   * @brief Path of the stored index of the video
+   */
+  std::string IndexPath() const;
+
+  /**
+   * @brief Loads the index stored in index_dir_
+   *
+   * @return false, if there's no index or it's stale, i.e. the video has changed since it was
+   * stored
+   */
+  bool LoadIndex();
+
+  /**
+   * @brief Stores the index in index_dir_. Failures are reported as warnings.
+   */
+  void SaveIndex() const;
+
   void InitAvState();
 
   void FindVideoStream();
@@ -206,6 +230,8 @@ class DLL_PUBLIC FramesDecoder {
   int channels_ = 3;
   bool flush_state_ = false;
   std::string filename_;
+  std::string index_dir_;
+  int num_threads_ = 1;
 };
 }  // namespace dali
 
@@ -40,8 +40,9 @@ int process_picture_decode(void *user_data, CUVIDPICPARAMS *picture_params) {
 }
 }  // namespace detail
 
-FramesDecoderGpu::FramesDecoderGpu(const std::string &filename, cudaStream_t stream) :
-    FramesDecoder(filename),
+FramesDecoderGpu::FramesDecoderGpu(const std::string &filename, cudaStream_t stream,
+                                   const std::string &index_dir) :
+    FramesDecoder(filename, index_dir),
     frame_buffer_(num_decode_surfaces_),
     stream_(stream) {
     nvdecode_state_ = std::make_unique<NvDecodeState>();
@@ -111,7 +112,9 @@ int FramesDecoderGpu::ProcessPictureDecode(void *user_data, CUVIDPICPARAMS *pict
   videoProcessingParameters.unpaired_field = 0;
   videoProcessingParameters.output_stream = stream_;
 
-  uint8_t *frame_output = nullptr;
+  // the buffered frames are stored as the plain RGB
+  FrameOutputDesc frame_output;
+  frame_output.row_stride = Width() * 3;
 
   // Take pts of the currently decoded frame
   int current_pts = piped_pts_.front();
@@ -138,7 +141,7 @@ int FramesDecoderGpu::ProcessPictureDecode(void *user_data, CUVIDPICPARAMS *pict
     // Put currently decoded frame to the buffer for later
     auto &slot = FindEmptySlot();
     slot.pts_ = current_pts;
-    frame_output = slot.frame_.data();
+    frame_output.data = slot.frame_.data();
   }
 
   CUdeviceptr frame = {};
@@ -152,14 +155,19 @@ int FramesDecoderGpu::ProcessPictureDecode(void *user_data, CUVIDPICPARAMS *pict
     &videoProcessingParameters));
 
   // TODO(awolant): Benchmark, if copy would be faster
-  yuv_to_rgb(
-    reinterpret_cast<uint8_t *>(frame),
-    pitch,
-    frame_output,
-    Width()* 3,
-    Width(),
-    Height(),
-    stream_);
+  if (frame_output.IsInterleavedUint8(Width())) {
+    yuv_to_rgb(
+      reinterpret_cast<uint8_t *>(frame),
+      pitch,
+      static_cast<uint8_t *>(frame_output.data),
+      Width()* 3,
+      Width(),
+      Height(),
+      stream_);
+  } else {
+    yuv_to_rgb(reinterpret_cast<const uint8_t *>(frame), pitch, frame_output, Width(), Height(),
+               stream_);
+  }
   // TODO(awolant): Alterantive is to copy the data to a buffer
   // and then process it on the stream. Check, if this is faster, when
   // the benchmark is ready.
@@ -176,6 +184,13 @@ void FramesDecoderGpu::SeekFrame(int frame_id) {
 }
 
 bool FramesDecoderGpu::ReadNextFrame(uint8_t *data, bool copy_to_output) {
+  FrameOutputDesc output;
+  output.data = data;
+  output.row_stride = Width() * 3;
+  return ReadNextFrame(output, copy_to_output);
+}
+
+bool FramesDecoderGpu::ReadNextFrame(const FrameOutputDesc &output, bool copy_to_output) {
   // No more frames in the file
   if (next_frame_idx_ == -1) {
     return false;
@@ -185,7 +200,12 @@ bool FramesDecoderGpu::ReadNextFrame(uint8_t *data, bool copy_to_output) {
   for (auto &frame : frame_buffer_) {
     if (frame.pts_ == index_[next_frame_idx_].pts) {
       if (copy_to_output) {
-        copyD2D(data, frame.frame_.data(), FrameSize());
+        if (output.IsInterleavedUint8(Width())) {
+          copyD2D(static_cast<uint8_t *>(output.data), frame.frame_.data(), FrameSize());
+        } else {
+          convert_rgb(frame.frame_.data(), output, Width(), Height(), stream_);
+          CUDA_CALL(cudaStreamSynchronize(stream_));
+        }
       }
       LOG_LINE << "Read frame, index " << next_frame_idx_ << ", timestamp " <<
         std::setw(5) << frame.pts_ << ", current copy " << copy_to_output << std::endl;
@@ -198,7 +218,7 @@ bool FramesDecoderGpu::ReadNextFrame(uint8_t *data, bool copy_to_output) {
   }
 
   current_copy_to_output_ = copy_to_output;
-  current_frame_output_ = data;
+  current_frame_output_ = output;
 
   while (av_read_frame(av_state_->ctx_, av_state_->packet_) >= 0) {
     if (av_state_->packet_->stream_index != av_state_->stream_id_) {
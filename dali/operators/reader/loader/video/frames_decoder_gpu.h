@@ -26,6 +26,7 @@ extern "C" {
 #include <queue>
 #include <vector>
 
+#include "dali/operators/reader/loader/video/nvdecode/color_space.h"
 #include "dali/operators/reader/loader/video/nvdecode/cuviddec.h"
 #include "dali/operators/reader/loader/video/nvdecode/nvcuvid.h"
 
@@ -55,17 +56,33 @@ class DLL_PUBLIC FramesDecoderGpu : public FramesDecoder {
    * 
    * @param filename Path to a video file.
    * @param stream Stream used for decode processing.
+   * @param index_dir Directory where the frame index is stored, see FramesDecoder.
    */
-  explicit FramesDecoderGpu(const std::string &filename, cudaStream_t stream = 0);
+  explicit FramesDecoderGpu(const std::string &filename, cudaStream_t stream = 0,
+                            const std::string &index_dir = {});
 
   bool ReadNextFrame(uint8_t *data, bool copy_to_output = true) override;
 
+  /**
+   * @brief Reads the next frame, storing it as described by `output`
+   *
+   * The type conversion, normalization and layout change are fused with the conversion
+   * of the decoded frame to RGB.
+   */
+  bool ReadNextFrame(const FrameOutputDesc &output, bool copy_to_output = true);
+
   void SeekFrame(int frame_id) override;
 
   void Reset() override;
 
   int NextFramePts() { return index_[NextFrameIdx()].pts; }
 
+  /**
+   * @brief Sets the stream used for decode processing, e.g. by the thread which currently
+   *        decodes the video
+   */
+  void SetStream(cudaStream_t stream) { stream_ = stream; }
+
   int ProcessPictureDecode(void *user_data, CUVIDPICPARAMS *picture_params);
 
   FramesDecoderGpu(FramesDecoderGpu&&) = default;
@@ -74,7 +91,7 @@ class DLL_PUBLIC FramesDecoderGpu : public FramesDecoder {
 
  private:
   std::unique_ptr<NvDecodeState> nvdecode_state_;
-  uint8_t *current_frame_output_ = nullptr;
+  FrameOutputDesc current_frame_output_;
   bool current_copy_to_output_ = false;
   bool frame_returned_ = false;
   bool flush_ = false;
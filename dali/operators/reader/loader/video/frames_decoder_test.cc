@@ -13,8 +13,14 @@
 // limitations under the License.
 
 #include <cuda_runtime_api.h>
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
 #include <exception>
+#include <fstream>
 #include <random>
+#include <string>
+#include <vector>
 
 #include "dali/core/cuda_error.h"
 #include "dali/core/dev_buffer.h"
@@ -201,6 +207,60 @@ TEST_F(FramesDecoderTest_CpuOnlyTests, InvalidCodec) {
     make_string("Unsupported video codec: vp9 in file: ", path));
 }
 
+class FramesDecoderIndexTest : public FramesDecoderTest_CpuOnlyTests {
+ public:
+  void SetUp() override {
+    FramesDecoderTest_CpuOnlyTests::SetUp();
+    std::string tmpl = "/tmp/frames_decoder_index_test_XXXXXX";
+    index_dir_ = mkdtemp(&tmpl[0]);
+  }
+
+  void TearDown() override {
+    for (auto &file : IndexFiles())
+      remove(file.c_str());
+    rmdir(index_dir_.c_str());
+  }
+
+  std::vector<std::string> IndexFiles() {
+    std::vector<std::string> files;
+    DIR *d = opendir(index_dir_.c_str());
+    while (struct dirent *entry = readdir(d)) {
+      if (entry->d_name[0] != '.')
+        files.push_back(index_dir_ + "/" + entry->d_name);
+    }
+    closedir(d);
+    return files;
+  }
+
+  std::string index_dir_;
+};
+
+TEST_F(FramesDecoderIndexTest, StoredIndex) {
+  {
+    FramesDecoder decoder(vfr_videos_paths_[1], index_dir_);
+    ASSERT_EQ(decoder.NumFrames(), vfr_videos_[1].NumFrames());
+  }
+  auto files = IndexFiles();
+  ASSERT_EQ(files.size(), 1u);
+
+  // the stored index is used for seeking
+  FramesDecoder decoder(vfr_videos_paths_[1], index_dir_);
+  RunTest(decoder, vfr_videos_[1]);
+}
+
+TEST_F(FramesDecoderIndexTest, InvalidIndexIsRebuilt) {
+  { FramesDecoder decoder(cfr_videos_paths_[0], index_dir_); }
+  auto files = IndexFiles();
+  ASSERT_EQ(files.size(), 1u);
+  std::ofstream(files[0], std::ios::trunc) << "not an index";
+
+  FramesDecoder decoder(cfr_videos_paths_[0], index_dir_);
+  RunTest(decoder, cfr_videos_[0]);
+  // and stored again
+  FramesDecoder decoder2(cfr_videos_paths_[0], index_dir_);
+  RunTest(decoder2, cfr_videos_[0]);
+}
+
 TEST_F(FramesDecoderGpuTest, ConstantFrameRate) {
   FramesDecoderGpu decoder(cfr_videos_paths_[0]);
   RunTest(decoder, cfr_videos_[0]);
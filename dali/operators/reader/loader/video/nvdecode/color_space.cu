@@ -1,92 +1,202 @@
-// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
-//
-// Licensed under the Apache License, Version 2.0 (the "License");
-// you may not use this file except in compliance with the License.
-// You may obtain a copy of the License at
-//
-//     http://www.apache.org/licenses/LICENSE-2.0
-//
-// Unless required by applicable law or agreed to in writing, software
-// distributed under the License is distributed on an "AS IS" BASIS,
-// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
-// See the License for the specific language governing permissions and
-// limitations under the License.
-
-#include "color_space.h"
-
-#include <cuda_runtime.h>
-
-typedef struct {
-    uint8_t r, g, b;
-} Rgb;
-
-__constant__ float mat_yuv_to_rgb[3][3] = {
-    1.164383f,  0.0f,       1.596027f,
-    1.164383f, -0.391762f, -0.812968f,
-    1.164383f,  2.017232f,  0.0f
-};
-
-__device__ static uint8_t clamp(float x, float lower, float upper) {
-    return fminf(fmaxf(x, lower), upper);
-}
-
-__device__ inline Rgb pixel_yuv_to_rgb(uint8_t y, uint8_t u, uint8_t v) {
-    const int low = 1 << (sizeof(uint8_t) * 8 - 4);
-    const int mid = 1 << (sizeof(uint8_t) * 8 - 1);
-    float fy = (int)y - low;
-    float fu = (int)u - mid;
-    float fv = (int)v - mid;
-    const float maxf = (1 << sizeof(uint8_t) * 8) - 1.0f;
-
-    return Rgb { 
-        clamp(mat_yuv_to_rgb[0][0] * fy + mat_yuv_to_rgb[0][1] * fu + mat_yuv_to_rgb[0][2] * fv, 0.0f, maxf),
-        clamp(mat_yuv_to_rgb[1][0] * fy + mat_yuv_to_rgb[1][1] * fu + mat_yuv_to_rgb[1][2] * fv, 0.0f, maxf),
-        clamp(mat_yuv_to_rgb[2][0] * fy + mat_yuv_to_rgb[2][1] * fu + mat_yuv_to_rgb[2][2] * fv, 0.0f, maxf)};
-}
-
-__global__ static void yuv_to_rgb_kernel(
-    uint8_t *yuv, int yuv_pitch, uint8_t *rgb, int rgb_pitch, int width, int height) {
-    int x = (threadIdx.x + blockIdx.x * blockDim.x) * 2;
-    int y = (threadIdx.y + blockIdx.y * blockDim.y) * 2;
-    if (x + 1 >= width || y + 1 >= height) {
-        return;
-    }
-
-    uint8_t *src = yuv + x * sizeof(uint8_t) + y * yuv_pitch;
-
-    uint8_t *dst_1 = rgb + x * sizeof(Rgb) + y * rgb_pitch;
-    uint8_t *dst_2 = rgb + x * sizeof(Rgb) + (y+1) * rgb_pitch;
-
-    uint8_t luma_1 = *src;
-    uint8_t luma_2 = *(src + yuv_pitch);
-    uint8_t *chroma = (src + (height - y / 2) * yuv_pitch);
-
-    Rgb pixel_1 = pixel_yuv_to_rgb(luma_1, chroma[0], chroma[1]);
-    Rgb pixel_2 = pixel_yuv_to_rgb(luma_2, chroma[0], chroma[1]);
-
-    dst_1[0] = pixel_1.r;
-    dst_1[1] = pixel_1.g;
-    dst_1[2] = pixel_1.b;
-
-    dst_1[3] = pixel_1.r;
-    dst_1[4] = pixel_1.g;
-    dst_1[5] = pixel_1.b;
-
-    dst_2[0] = pixel_2.r;
-    dst_2[1] = pixel_2.g;
-    dst_2[2] = pixel_2.b;
-
-    dst_2[3] = pixel_2.r;
-    dst_2[4] = pixel_2.g;
-    dst_2[5] = pixel_2.b;
-
-}
-
-void yuv_to_rgb(uint8_t *yuv, int yuv_pitch, uint8_t *rgb, int rgb_pitch, int width, int height, cudaStream_t stream) {
-    auto grid_layout = dim3((width + 63) / 32 / 2, (height + 3)); 
-    auto block_layout = dim3(32, 2);
-
-    yuv_to_rgb_kernel
-        <<<grid_layout, block_layout, 0, stream>>>
-        (yuv, yuv_pitch, rgb, rgb_pitch, width, height);
-}
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "color_space.h"
+
+#include <cuda_runtime.h>
+
+#include "dali/core/convert.h"
+#include "dali/core/error_handling.h"
+#include "dali/core/float16.h"
+#include "dali/core/static_switch.h"
+#include "dali/pipeline/data/types.h"
+
+typedef struct {
+    uint8_t r, g, b;
+} Rgb;
+
+__constant__ float mat_yuv_to_rgb[3][3] = {
+    1.164383f,  0.0f,       1.596027f,
+    1.164383f, -0.391762f, -0.812968f,
+    1.164383f,  2.017232f,  0.0f
+};
+
+__device__ static uint8_t clamp(float x, float lower, float upper) {
+    return fminf(fmaxf(x, lower), upper);
+}
+
+__device__ inline Rgb pixel_yuv_to_rgb(uint8_t y, uint8_t u, uint8_t v) {
+    const int low = 1 << (sizeof(uint8_t) * 8 - 4);
+    const int mid = 1 << (sizeof(uint8_t) * 8 - 1);
+    float fy = (int)y - low;
+    float fu = (int)u - mid;
+    float fv = (int)v - mid;
+    const float maxf = (1 << sizeof(uint8_t) * 8) - 1.0f;
+
+    return Rgb { 
+        clamp(mat_yuv_to_rgb[0][0] * fy + mat_yuv_to_rgb[0][1] * fu + mat_yuv_to_rgb[0][2] * fv, 0.0f, maxf),
+        clamp(mat_yuv_to_rgb[1][0] * fy + mat_yuv_to_rgb[1][1] * fu + mat_yuv_to_rgb[1][2] * fv, 0.0f, maxf),
+        clamp(mat_yuv_to_rgb[2][0] * fy + mat_yuv_to_rgb[2][1] * fu + mat_yuv_to_rgb[2][2] * fv, 0.0f, maxf)};
+}
+
+__global__ static void yuv_to_rgb_kernel(
+    uint8_t *yuv, int yuv_pitch, uint8_t *rgb, int rgb_pitch, int width, int height) {
+    int x = (threadIdx.x + blockIdx.x * blockDim.x) * 2;
+    int y = (threadIdx.y + blockIdx.y * blockDim.y) * 2;
+    if (x + 1 >= width || y + 1 >= height) {
+        return;
+    }
+
+    uint8_t *src = yuv + x * sizeof(uint8_t) + y * yuv_pitch;
+
+    uint8_t *dst_1 = rgb + x * sizeof(Rgb) + y * rgb_pitch;
+    uint8_t *dst_2 = rgb + x * sizeof(Rgb) + (y+1) * rgb_pitch;
+
+    uint8_t luma_1 = *src;
+    uint8_t luma_2 = *(src + yuv_pitch);
+    uint8_t *chroma = (src + (height - y / 2) * yuv_pitch);
+
+    Rgb pixel_1 = pixel_yuv_to_rgb(luma_1, chroma[0], chroma[1]);
+    Rgb pixel_2 = pixel_yuv_to_rgb(luma_2, chroma[0], chroma[1]);
+
+    dst_1[0] = pixel_1.r;
+    dst_1[1] = pixel_1.g;
+    dst_1[2] = pixel_1.b;
+
+    dst_1[3] = pixel_1.r;
+    dst_1[4] = pixel_1.g;
+    dst_1[5] = pixel_1.b;
+
+    dst_2[0] = pixel_2.r;
+    dst_2[1] = pixel_2.g;
+    dst_2[2] = pixel_2.b;
+
+    dst_2[3] = pixel_2.r;
+    dst_2[4] = pixel_2.g;
+    dst_2[5] = pixel_2.b;
+
+}
+
+void yuv_to_rgb(uint8_t *yuv, int yuv_pitch, uint8_t *rgb, int rgb_pitch, int width, int height, cudaStream_t stream) {
+    auto grid_layout = dim3((width + 63) / 32 / 2, (height + 3)); 
+    auto block_layout = dim3(32, 2);
+
+    yuv_to_rgb_kernel
+        <<<grid_layout, block_layout, 0, stream>>>
+        (yuv, yuv_pitch, rgb, rgb_pitch, width, height);
+}
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief The parameters of a fused conversion, passed by value to the kernels
+ */
+struct OutputParams {
+  int64_t row_stride, pixel_stride, channel_stride;
+  float mean[3], inv_std[3];
+};
+
+template <typename Out, bool Normalize>
+__device__ inline void store_rgb(Out *out, const OutputParams &params, float r, float g, float b) {
+  float rgb[3] = { r, g, b };
+  #pragma unroll
+  for (int c = 0; c < 3; c++) {
+    float value = Normalize ? (rgb[c] - params.mean[c]) * params.inv_std[c] : rgb[c];
+    out[c * params.channel_stride] = ConvertSat<Out>(value);
+  }
+}
+
+template <typename Out, bool Normalize>
+__global__ void yuv_to_rgb_fused_kernel(const uint8_t *yuv, int yuv_pitch, Out *out,
+                                        OutputParams params, int width, int height) {
+  int x = threadIdx.x + blockIdx.x * blockDim.x;
+  int y = threadIdx.y + blockIdx.y * blockDim.y;
+  if (x >= width || y >= height)
+    return;
+
+  const int low = 16, mid = 128;
+  float fy = static_cast<int>(yuv[y * yuv_pitch + x]) - low;
+  // the interleaved UV plane of NV12 is subsampled in both dimensions
+  const uint8_t *chroma = yuv + (height + y / 2) * yuv_pitch + (x & ~1);
+  float fu = static_cast<int>(chroma[0]) - mid;
+  float fv = static_cast<int>(chroma[1]) - mid;
+
+  const auto &m = mat_yuv_to_rgb;
+  // not rounded, so that the floating point outputs keep the precision
+  float r = fminf(fmaxf(m[0][0] * fy + m[0][1] * fu + m[0][2] * fv, 0.0f), 255.0f);
+  float g = fminf(fmaxf(m[1][0] * fy + m[1][1] * fu + m[1][2] * fv, 0.0f), 255.0f);
+  float b = fminf(fmaxf(m[2][0] * fy + m[2][1] * fu + m[2][2] * fv, 0.0f), 255.0f);
+
+  store_rgb<Out, Normalize>(out + y * params.row_stride + x * params.pixel_stride, params, r, g, b);
+}
+
+template <typename Out, bool Normalize>
+__global__ void convert_rgb_kernel(const uint8_t *rgb, Out *out, OutputParams params,
+                                   int width, int height) {
+  int x = threadIdx.x + blockIdx.x * blockDim.x;
+  int y = threadIdx.y + blockIdx.y * blockDim.y;
+  if (x >= width || y >= height)
+    return;
+  const uint8_t *in = rgb + (y * width + x) * 3;
+  store_rgb<Out, Normalize>(out + y * params.row_stride + x * params.pixel_stride, params,
+                            in[0], in[1], in[2]);
+}
+
+OutputParams GetOutputParams(const FrameOutputDesc &out) {
+  OutputParams params;
+  params.row_stride = out.row_stride;
+  params.pixel_stride = out.pixel_stride;
+  params.channel_stride = out.channel_stride;
+  for (int c = 0; c < 3; c++) {
+    params.mean[c] = out.mean[c];
+    params.inv_std[c] = out.inv_std[c];
+  }
+  return params;
+}
+
+#define FUSED_OUTPUT_TYPES (uint8_t, float, float16)
+
+}  // namespace
+
+void yuv_to_rgb(const uint8_t *yuv, int yuv_pitch, const FrameOutputDesc &out,
+                int width, int height, cudaStream_t stream) {
+  dim3 block(32, 8);
+  dim3 grid((width + block.x - 1) / block.x, (height + block.y - 1) / block.y);
+  auto params = GetOutputParams(out);
+  TYPE_SWITCH(out.dtype, type2id, Out, FUSED_OUTPUT_TYPES, (
+    BOOL_SWITCH(out.normalize, Normalize, (
+      yuv_to_rgb_fused_kernel<Out, Normalize><<<grid, block, 0, stream>>>(
+          yuv, yuv_pitch, static_cast<Out *>(out.data), params, width, height);
+    ));  // NOLINT
+  ), DALI_FAIL(make_string("Unsupported output type of the video frames: ", out.dtype)));  // NOLINT
+  CUDA_CALL(cudaGetLastError());
+}
+
+void convert_rgb(const uint8_t *rgb, const FrameOutputDesc &out,
+                 int width, int height, cudaStream_t stream) {
+  dim3 block(32, 8);
+  dim3 grid((width + block.x - 1) / block.x, (height + block.y - 1) / block.y);
+  auto params = GetOutputParams(out);
+  TYPE_SWITCH(out.dtype, type2id, Out, FUSED_OUTPUT_TYPES, (
+    BOOL_SWITCH(out.normalize, Normalize, (
+      convert_rgb_kernel<Out, Normalize><<<grid, block, 0, stream>>>(
+          rgb, static_cast<Out *>(out.data), params, width, height);
+    ));  // NOLINT
+  ), DALI_FAIL(make_string("Unsupported output type of the video frames: ", out.dtype)));  // NOLINT
+  CUDA_CALL(cudaGetLastError());
+}
+
+}  // namespace dali
@@ -1,29 +1,73 @@
-// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
-//
-// Licensed under the Apache License, Version 2.0 (the "License");
-// you may not use this file except in compliance with the License.
-// You may obtain a copy of the License at
-//
-//     http://www.apache.org/licenses/LICENSE-2.0
-//
-// Unless required by applicable law or agreed to in writing, software
-// distributed under the License is distributed on an "AS IS" BASIS,
-// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
-// See the License for the specific language governing permissions and
-// limitations under the License.
-
-#ifndef DALI_OPERATORS_READER_LOADER_VIDEO_NVDECODE_COLOR_SPACE_GPU_H_
-#define DALI_OPERATORS_READER_LOADER_VIDEO_NVDECODE_COLOR_SPACE_GPU_H_
-
-#include <stdint.h>
-
-void yuv_to_rgb(
-    uint8_t *yuv,
-    int yuv_pitch,
-    uint8_t *rgb,
-    int rgb_pitch,
-    int width,
-    int height,
-    cudaStream_t stream);
-
-#endif  // DALI_OPERATORS_READER_LOADER_VIDEO_NVDECODE_COLOR_SPACE_GPU_H_
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_LOADER_VIDEO_NVDECODE_COLOR_SPACE_GPU_H_
+#define DALI_OPERATORS_READER_LOADER_VIDEO_NVDECODE_COLOR_SPACE_GPU_H_
+
+#include <cuda_runtime_api.h>
+#include <stdint.h>
+#include "dali/core/common.h"
+#include "dali/pipeline/data/types.h"
+
+void yuv_to_rgb(
+    uint8_t *yuv,
+    int yuv_pitch,
+    uint8_t *rgb,
+    int rgb_pitch,
+    int width,
+    int height,
+    cudaStream_t stream);
+
+namespace dali {
+
+/**
+ * @brief Describes where and how an RGB frame is stored by the fused conversions
+ *
+ * The strides allow the interleaved (HWC) and the planar (CHW) layouts, also with the planes
+ * of a channel for all the frames of a sequence stored together (CFHW).
+ */
+struct FrameOutputDesc {
+  void *data = nullptr;
+  DALIDataType dtype = DALI_UINT8;
+  /// the distances between the consecutive rows, pixels and channels, in elements
+  int64_t row_stride = 0, pixel_stride = 3, channel_stride = 1;
+  /// if set, the output is (value - mean[c]) * inv_std[c], where value is in the range [0, 255]
+  bool normalize = false;
+  float mean[3] = {0, 0, 0};
+  float inv_std[3] = {1, 1, 1};
+
+  /// @brief Whether it's the uint8 HWC frame produced by the plain conversion
+  bool IsInterleavedUint8(int width) const {
+    return dtype == DALI_UINT8 && !normalize && row_stride == 3 * width &&
+           pixel_stride == 3 && channel_stride == 1;
+  }
+};
+
+/**
+ * @brief Converts an NV12 frame to RGB, storing it with the type, normalization
+ *        and layout given by `out`, in one pass
+ */
+DLL_PUBLIC void yuv_to_rgb(const uint8_t *yuv, int yuv_pitch, const FrameOutputDesc &out,
+                           int width, int height, cudaStream_t stream);
+
+/**
+ * @brief Stores an interleaved uint8 RGB frame with the type, normalization
+ *        and layout given by `out`
+ */
+DLL_PUBLIC void convert_rgb(const uint8_t *rgb, const FrameOutputDesc &out,
+                            int width, int height, cudaStream_t stream);
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_LOADER_VIDEO_NVDECODE_COLOR_SPACE_GPU_H_
@@ -44,7 +44,8 @@ class VideoLoaderDecoderBase {
     filenames_(spec.GetRepeatedArgument<std::string>("filenames")),
     sequence_len_(spec.GetArgument<int>("sequence_length")),
     stride_(spec.GetArgument<int>("stride")),
-    step_(spec.GetArgument<int>("step")) {
+    step_(spec.GetArgument<int>("step")),
+    frame_index_dir_(spec.GetArgument<std::string>("frame_index_dir")) {
     has_labels_ = spec.TryGetRepeatedArgument(labels_, "labels");
     DALI_ENFORCE(
         !has_labels_ || labels_.size() == filenames_.size(),
@@ -67,6 +68,8 @@ class VideoLoaderDecoderBase {
   int sequence_len_;
   int stride_;
   int step_;
+  // where the frame indices of the videos are stored, empty if they are not
+  std::string frame_index_dir_;
 
   std::vector<VideoSampleDesc> sample_spans_;
 };
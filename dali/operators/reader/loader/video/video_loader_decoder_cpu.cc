@@ -14,33 +14,82 @@
 
 #include "dali/operators/reader/loader/video/video_loader_decoder_cpu.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace dali {
-void VideoLoaderDecoderCpu::PrepareEmpty(VideoSample<CPUBackend> &sample) {
+void VideoSampleCpu::Decode() {
+  data_.Resize(
+    TensorShape<4>{sequence_len_, video_file_->Height(), video_file_->Width(),
+                   video_file_->Channels()},
+    DALIDataType::DALI_UINT8);
+  data_.SetLayout("FHWC");
+
+  auto data = data_.mutable_data<uint8_t>();
+
+  for (int i = 0; i < sequence_len_; ++i) {
+    // TODO(awolant): This seek can be optimized - for consecutive frames not needed etc.
+    video_file_->SeekFrame(span_->start_ + i * span_->stride_);
+    video_file_->ReadNextFrame(data + i * video_file_->FrameSize());
+  }
+}
+
+void VideoLoaderDecoderCpu::DecodeSamples(const std::vector<VideoSampleCpu *> &samples) {
+  bool pinned = decode_to_pinned_.load(std::memory_order_relaxed);
+  for (auto *sample : samples) {
+    // the allocation kind can only be changed when the sample doesn't hold any memory
+    if (sample->data_.is_pinned() != pinned) {
+      sample->data_.Reset();
+      sample->data_.set_pinned(pinned);
+    }
+  }
+
+  // group the samples by the video, keeping the order of the first occurrence
+  std::vector<std::vector<VideoSampleCpu *>> groups;
+  std::unordered_map<FramesDecoder *, size_t> group_idx;
+  for (auto *sample : samples) {
+    auto it = group_idx.emplace(sample->video_file_, groups.size()).first;
+    if (it->second == groups.size())
+      groups.emplace_back();
+    groups[it->second].push_back(sample);
+  }
+
+  int num_threads = std::min<int>(num_parallel_decoders_, groups.size());
+  if (num_threads <= 1) {
+    for (auto *sample : samples)
+      sample->Decode();
+    return;
+  }
+
+  if (!decode_thread_pool_) {
+    decode_thread_pool_ = std::make_unique<ThreadPool>(num_parallel_decoders_, CPU_ONLY_DEVICE_ID,
+                                                       false, "Video decoding");
+  }
+  for (auto &group : groups) {
+    decode_thread_pool_->AddWork([&group](int) {
+      for (auto *sample : group)
+        sample->Decode();
+    }, group.size());
+  }
+  decode_thread_pool_->RunAll();
+}
+
+void VideoLoaderDecoderCpu::PrepareEmpty(VideoSampleCpu &sample) {
   sample = {};
   sample.data_.set_pinned(false);
-  sample.data_.SetLayout("FHWC");
 }
 
-void VideoLoaderDecoderCpu::ReadSample(VideoSample<CPUBackend> &sample) {
+void VideoLoaderDecoderCpu::ReadSample(VideoSampleCpu &sample) {
   auto &sample_span = sample_spans_[current_index_];
-  auto &video_file = video_files_[sample_span.video_idx_];
+
+  // Bind sample to the video and span, so it can be decoded later
+  sample.span_ = &sample_span;
+  sample.video_file_ = &video_files_[sample_span.video_idx_];
+  sample.sequence_len_ = sequence_len_;
 
   ++current_index_;
   MoveToNextShard(current_index_);
 
-  sample.data_.Resize(
-    TensorShape<4>{sequence_len_, video_file.Height(), video_file.Width(), video_file.Channels()},
-    DALIDataType::DALI_UINT8);
-
-  auto data = sample.data_.mutable_data<uint8_t>();
-
-  // TODO(awolant): Extract decoding outside of ReadSample (ReaderDecoder abstraction)
-  for (int i = 0; i < sequence_len_; ++i) {
-    // TODO(awolant): This seek can be optimized - for consecutive frames not needed etc.
-    video_file.SeekFrame(sample_span.start_ + i * sample_span.stride_);
-    video_file.ReadNextFrame(data + i * video_file.FrameSize());
-  }
-
   if (has_labels_) {
     sample.label_ = labels_[sample_span.video_idx_];
   }
@@ -53,7 +102,7 @@ Index VideoLoaderDecoderCpu::SizeImpl() {
 void VideoLoaderDecoderCpu::PrepareMetadataImpl() {
   video_files_.reserve(filenames_.size());
   for (auto &filename : filenames_) {
-    video_files_.emplace_back(filename);
+    video_files_.emplace_back(filename, frame_index_dir_, threads_per_decoder_);
   }
 
   for (size_t video_idx = 0; video_idx < video_files_.size(); ++video_idx) {
@@ -15,25 +15,69 @@
 #ifndef DALI_OPERATORS_READER_LOADER_VIDEO_VIDEO_LOADER_DECODER_CPU_H_
 #define DALI_OPERATORS_READER_LOADER_VIDEO_VIDEO_LOADER_DECODER_CPU_H_
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "dali/operators/reader/loader/loader.h"
 #include "dali/operators/reader/loader/video/frames_decoder.h"
 #include "dali/operators/reader/loader/video/video_loader_decoder_base.h"
+#include "dali/pipeline/util/thread_pool.h"
 
 
 namespace dali {
-using VideoSampleCpu = VideoSample<CPUBackend>;
+class VideoSampleCpu {
+ public:
+  /**
+   * @brief Decodes the sequence
+   */
+  void Decode();
+
+  FramesDecoder *video_file_ = nullptr;
+  VideoSampleDesc *span_ = nullptr;
+  int sequence_len_ = 0;
+  Tensor<CPUBackend> data_;
+  int label_ = -1;
+};
 
 class VideoLoaderDecoderCpu : public Loader<CPUBackend, VideoSampleCpu>, VideoLoaderDecoderBase {
  public:
   explicit inline VideoLoaderDecoderCpu(const OpSpec &spec) :
     Loader<CPUBackend, VideoSampleCpu>(spec),
-    VideoLoaderDecoderBase(spec) { }
+    VideoLoaderDecoderBase(spec),
+    num_parallel_decoders_(spec.GetArgument<int>("num_parallel_decoders")),
+    threads_per_decoder_(spec.GetArgument<int>("threads_per_decoder")) {
+    if (num_parallel_decoders_ <= 0)
+      num_parallel_decoders_ = spec.GetArgument<int>("num_threads");
+    DALI_ENFORCE(threads_per_decoder_ >= 0, make_string(
+        "``threads_per_decoder`` must not be negative, got ", threads_per_decoder_, "."));
+  }
 
   void ReadSample(VideoSampleCpu &sample) override;
 
+  /**
+   * @brief Decodes the samples of a batch
+   *
+   * The samples from different videos are decoded concurrently, by up to
+   * `num_parallel_decoders` threads. The samples from the same video are decoded one after
+   * another, as they share the decoder, which can use `threads_per_decoder` threads of its own.
+   *
+   * The frames are decoded to pinned memory if requested with `SetDecodeToPinned`.
+   */
+  void DecodeSamples(const std::vector<VideoSampleCpu *> &samples);
+
+  /**
+   * @brief Sets whether the following samples are decoded to pinned memory
+   *
+   * The reader requests it when its outputs are pinned, i.e. copied to the GPU, so that
+   * the decoded sequences can be passed to the outputs and copied from there without staging.
+   * Can be called concurrently with the decoding; it affects the samples decoded later.
+   */
+  void SetDecodeToPinned(bool pinned) {
+    decode_to_pinned_.store(pinned, std::memory_order_relaxed);
+  }
+
   void PrepareEmpty(VideoSampleCpu &sample) override;
 
  protected:
@@ -45,6 +89,11 @@ class VideoLoaderDecoderCpu : public Loader<CPUBackend, VideoSampleCpu>, VideoLo
   void Reset(bool wrap_to_shard) override;
 
   std::vector<FramesDecoder> video_files_;
+
+  int num_parallel_decoders_;
+  int threads_per_decoder_;
+  std::unique_ptr<ThreadPool> decode_thread_pool_;
+  std::atomic<bool> decode_to_pinned_{false};
 };
 
 }  // namespace dali
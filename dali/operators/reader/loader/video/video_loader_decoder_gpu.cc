@@ -14,29 +14,122 @@
 
 #include "dali/operators/reader/loader/video/video_loader_decoder_gpu.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 #include "dali/util/nvml.h"
 
 namespace dali {
-void VideoSampleGpu::Decode() {
-  TensorShape<4> shape = {
-    sequence_len_,
-    video_file_->Height(),
-    video_file_->Width(),
-    video_file_->Channels()};
 
-  data_.Resize(
-    shape,
-    DALIDataType::DALI_UINT8);
+namespace {
+
+/**
+ * @brief The number of the hardware video decoders (NVDEC engines) of the GPU
+ *
+ * There's no API to query it, so it's looked up by the architecture; the GPUs of the same
+ * architecture may differ, so it's an estimate.
+ */
+int NumNvdecEngines(int device_id) {
+  int major = 0, minor = 0;
+  CUDA_CALL(cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, device_id));
+  CUDA_CALL(cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, device_id));
+  switch (major * 10 + minor) {
+    case 75:  // Turing, e.g. T4
+    case 86:  // Ampere, e.g. A10, A40
+      return 2;
+    case 89:  // Ada, e.g. L4, L40
+      return 3;
+    case 80:  // A100, A30
+      return 5;
+    case 90:  // H100
+      return 7;
+    default:
+      return 1;
+  }
+}
+
+}  // namespace
+
+void VideoSampleGpu::Decode(cudaStream_t stream) {
+  video_file_->SetStream(stream);
+
+  int64_t F = sequence_len_;
+  int64_t H = video_file_->Height();
+  int64_t W = video_file_->Width();
+  int64_t C = video_file_->Channels();
+
+  // the frames are stored in the layout by the color conversion
+  FrameOutputDesc output = output_format_;
+  TensorShape<4> shape;
+  int64_t frame_stride;
+  if (layout_ == "FCHW") {
+    shape = {F, C, H, W};
+    frame_stride = C * H * W;
+    output.row_stride = W;
+    output.pixel_stride = 1;
+    output.channel_stride = H * W;
+  } else if (layout_ == "CFHW") {
+    shape = {C, F, H, W};
+    frame_stride = H * W;
+    output.row_stride = W;
+    output.pixel_stride = 1;
+    output.channel_stride = F * H * W;
+  } else {
+    shape = {F, H, W, C};
+    frame_stride = H * W * C;
+    output.row_stride = W * C;
+    output.pixel_stride = C;
+    output.channel_stride = 1;
+  }
+
+  data_.Resize(shape, output.dtype);
 
+  auto *data = static_cast<uint8_t *>(data_.raw_mutable_data());
+  int64_t frame_bytes = frame_stride * TypeTable::GetTypeInfo(output.dtype).size();
   for (int i = 0; i < sequence_len_; ++i) {
     int frame_id = span_->start_ + i * span_->stride_;
     video_file_->SeekFrame(frame_id);
-    video_file_->ReadNextFrame(
-      static_cast<uint8_t *>(data_.raw_mutable_data()) + i * video_file_->FrameSize());
+    output.data = data + i * frame_bytes;
+    video_file_->ReadNextFrame(output);
+  }
+}
+
+void VideoLoaderDecoderGpu::InitOutputFormat(const OpSpec &spec) {
+  output_format_.dtype = spec.GetArgument<DALIDataType>("dtype");
+  DALI_ENFORCE(output_format_.dtype == DALI_UINT8 || output_format_.dtype == DALI_FLOAT ||
+               output_format_.dtype == DALI_FLOAT16,
+               make_string("Unsupported output type: ", output_format_.dtype,
+                           ". Supported types are uint8, float and float16."));
+
+  layout_ = spec.GetArgument<TensorLayout>("output_layout");
+  DALI_ENFORCE(layout_ == "FHWC" || layout_ == "FCHW" || layout_ == "CFHW",
+               make_string("Unsupported output layout: \"", layout_,
+                           "\". Supported layouts are FHWC, FCHW and CFHW."));
+
+  std::vector<float> mean, stddev;
+  bool has_mean = spec.TryGetRepeatedArgument(mean, "mean");
+  bool has_std = spec.TryGetRepeatedArgument(stddev, "std");
+  output_format_.normalize = has_mean || has_std;
+  auto get_channel = [](const std::vector<float> &values, int c, float default_value) {
+    return values.empty() ? default_value : values[values.size() == 1 ? 0 : c];
+  };
+  for (auto *values : {&mean, &stddev}) {
+    DALI_ENFORCE(values->size() <= 1 || values->size() == 3,
+                 make_string("``mean`` and ``std`` must have 1 or 3 values, got ",
+                             values->size(), "."));
+  }
+  for (int c = 0; c < 3; c++) {
+    output_format_.mean[c] = get_channel(mean, c, 0.f);
+    float s = get_channel(stddev, c, 1.f);
+    DALI_ENFORCE(s != 0, "``std`` must not be 0.");
+    output_format_.inv_std[c] = 1.f / s;
   }
 }
 
-void VideoLoaderDecoderGpu::InitCudaStream() {
+void VideoLoaderDecoderGpu::InitCudaStreams(int priority) {
+  if (num_parallel_decoders_ <= 0)
+    num_parallel_decoders_ = NumNvdecEngines(device_id_);
+
   #if NVML_ENABLED
   {
     nvml::Init();
@@ -57,8 +150,39 @@ void VideoLoaderDecoderGpu::InitCudaStream() {
   }
   #endif
 
-  // TODO(awolant): Check per decoder stream
-  cuda_stream_ = CUDAStreamPool::instance().Get(device_id_);
+  for (int i = 0; i < num_parallel_decoders_; i++)
+    decode_streams_.push_back(CUDAStreamPool::instance().Get(device_id_, priority));
+}
+
+void VideoLoaderDecoderGpu::DecodeSamples(const std::vector<VideoSampleGpu *> &samples) {
+  // group the samples by the video, keeping the order of the first occurrence
+  std::vector<std::vector<VideoSampleGpu *>> groups;
+  std::unordered_map<FramesDecoderGpu *, size_t> group_idx;
+  for (auto *sample : samples) {
+    auto it = group_idx.emplace(sample->video_file_, groups.size()).first;
+    if (it->second == groups.size())
+      groups.emplace_back();
+    groups[it->second].push_back(sample);
+  }
+
+  int num_threads = std::min<int>(num_parallel_decoders_, groups.size());
+  if (num_threads <= 1) {
+    for (auto *sample : samples)
+      sample->Decode(DecodeStream(0));
+    return;
+  }
+
+  if (!decode_thread_pool_) {
+    decode_thread_pool_ = std::make_unique<ThreadPool>(num_parallel_decoders_, device_id_, false,
+                                                       "Video decoding");
+  }
+  for (auto &group : groups) {
+    decode_thread_pool_->AddWork([this, &group](int thread_id) {
+      for (auto *sample : group)
+        sample->Decode(DecodeStream(thread_id));
+    }, group.size());
+  }
+  decode_thread_pool_->RunAll();
 }
 
 void VideoLoaderDecoderGpu::PrepareEmpty(VideoSampleGpu &sample) {
@@ -72,6 +196,8 @@ void VideoLoaderDecoderGpu::ReadSample(VideoSampleGpu &sample) {
   sample.span_ = &sample_span;
   sample.video_file_ = &video_files_[sample_span.video_idx_];
   sample.sequence_len_ = sequence_len_;
+  sample.output_format_ = output_format_;
+  sample.layout_ = layout_;
 
   if (has_labels_) {
     sample.label_ = labels_[sample_span.video_idx_];
@@ -88,7 +214,7 @@ Index VideoLoaderDecoderGpu::SizeImpl() {
 void VideoLoaderDecoderGpu::PrepareMetadataImpl() {
   video_files_.reserve(filenames_.size());
   for (auto &filename : filenames_) {
-    video_files_.emplace_back(filename, cuda_stream_);
+    video_files_.emplace_back(filename, DecodeStream(0), frame_index_dir_);
   }
 
   for (size_t video_idx = 0; video_idx < video_files_.size(); ++video_idx) {
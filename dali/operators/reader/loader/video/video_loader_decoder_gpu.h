@@ -15,10 +15,12 @@
 #ifndef DALI_OPERATORS_READER_LOADER_VIDEO_VIDEO_LOADER_DECODER_GPU_H_
 #define DALI_OPERATORS_READER_LOADER_VIDEO_VIDEO_LOADER_DECODER_GPU_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "dali/core/cuda_stream_pool.h"
+#include "dali/pipeline/util/thread_pool.h"
 #include "dali/operators/reader/loader/loader.h"
 #include "dali/operators/reader/loader/video/video_loader_decoder_base.h"
 #include "dali/operators/reader/loader/video/video_loader_decoder_cpu.h"
@@ -27,11 +29,17 @@
 namespace dali {
 class VideoSampleGpu {
  public:
-  void Decode();
+  /**
+   * @brief Decodes the sequence, processing the frames in the given stream
+   */
+  void Decode(cudaStream_t stream);
 
   FramesDecoderGpu *video_file_ = nullptr;
   VideoSampleDesc *span_ = nullptr;
   int sequence_len_ = 0;
+  // the type and normalization of the frames, the data pointer and strides are set by Decode
+  FrameOutputDesc output_format_;
+  TensorLayout layout_ = "FHWC";
   Tensor<GPUBackend> data_;
   int label_ = -1;
 };
@@ -41,14 +49,33 @@ class VideoLoaderDecoderGpu : public Loader<GPUBackend, VideoSampleGpu>, VideoLo
  public:
   explicit inline VideoLoaderDecoderGpu(const OpSpec &spec) :
     Loader<GPUBackend, VideoSampleGpu>(spec),
-    VideoLoaderDecoderBase(spec) {
-    InitCudaStream();
+    VideoLoaderDecoderBase(spec),
+    num_parallel_decoders_(spec.GetArgument<int>("num_parallel_decoders")) {
+    InitOutputFormat(spec);
+    InitCudaStreams(spec.GetArgument<int>("default_cuda_stream_priority"));
   }
 
   void ReadSample(VideoSampleGpu &sample) override;
 
+  /**
+   * @brief Decodes the samples of a batch
+   *
+   * The samples from different videos are decoded concurrently, by up to
+   * `num_parallel_decoders` threads, each with its own stream. The samples from the same video
+   * are decoded one after another, as they share the decoder.
+   */
+  void DecodeSamples(const std::vector<VideoSampleGpu *> &samples);
+
   void PrepareEmpty(VideoSampleGpu &sample) override;
 
+  DALIDataType OutputType() const {
+    return output_format_.dtype;
+  }
+
+  const TensorLayout &OutputLayout() const {
+    return layout_;
+  }
+
  protected:
   Index SizeImpl() override;
 
@@ -57,11 +84,23 @@ class VideoLoaderDecoderGpu : public Loader<GPUBackend, VideoSampleGpu>, VideoLo
  private:
   void Reset(bool wrap_to_shard) override;
 
-  void InitCudaStream();
+  void InitOutputFormat(const OpSpec &spec);
+
+  void InitCudaStreams(int priority);
+
+  cudaStream_t DecodeStream(int idx) const {
+    return decode_streams_.empty() ? 0 : static_cast<cudaStream_t>(decode_streams_[idx]);
+  }
 
   std::vector<FramesDecoderGpu> video_files_;
 
-  CUDAStreamLease cuda_stream_;
+  int num_parallel_decoders_;
+  // one per parallel decoder; empty, if decoding on the default stream
+  std::vector<CUDAStreamLease> decode_streams_;
+  std::unique_ptr<ThreadPool> decode_thread_pool_;
+
+  FrameOutputDesc output_format_;
+  TensorLayout layout_;
 };
 
 }  // namespace dali
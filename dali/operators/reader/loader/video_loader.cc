@@ -23,6 +23,9 @@
 #include <fstream>
 #include <limits>
 #include <sstream>
+#include <vector>
+
+#include "dali/core/device_guard.h"
 
 
 inline int gcd(int a, int b) {
@@ -746,6 +749,45 @@ void VideoLoader::receive_frames(SequenceWrapper& sequence) {
   }
 }
 
+void VideoLoader::read_cached_sequence(SequenceWrapper& sequence, const std::string &filename,
+                                       int frame) {
+  DeviceGuard g(device_id_);
+  size_t frame_size = volume(sequence.frame_shape()) *
+                      TypeTable::GetTypeInfo(sequence.dtype).size();
+  auto *data = static_cast<uint8_t *>(sequence.sequence.raw_mutable_data());
+
+  // All the cached frames are copied first, so that they are not evicted by the decoded ones.
+  // The cached frames between the missing ones are decoded again anyway, as the decoder
+  // needs a contiguous range.
+  std::vector<double> timestamps(sequence.count);
+  int first_missing = sequence.count, last_missing = -1;
+  for (int i = 0; i < sequence.count; i++) {
+    if (!frame_cache_->Read(filename, frame + i * stride_, data + i * frame_size, frame_size,
+                            timestamps[i])) {
+      first_missing = std::min(first_missing, i);
+      last_missing = i;
+    }
+  }
+
+  if (last_missing >= first_missing) {
+    int missing_count = last_missing - first_missing + 1;
+    push_sequence_to_read(filename, frame + first_missing * stride_, missing_count);
+    vid_decoder_->receive_frames(sequence, first_missing, missing_count);
+    if (sequence.timestamps.size() < static_cast<size_t>(missing_count))
+      return;  // the decoder is being shut down
+    for (int i = 0; i < missing_count; i++) {
+      int idx = first_missing + i;
+      timestamps[idx] = sequence.timestamps[i];
+      frame_cache_->Add(filename, frame + idx * stride_, data + idx * frame_size, frame_size,
+                        timestamps[idx]);
+    }
+  }
+  sequence.timestamps = std::move(timestamps);
+  vid_decoder_->finish_sequence(sequence);
+
+  stats_.frames_used += sequence.count;
+}
+
 void VideoLoader::PrepareEmpty(SequenceWrapper &tensor) {}
 
 void VideoLoader::ReadSample(SequenceWrapper& tensor) {
@@ -756,8 +798,12 @@ void VideoLoader::ReadSample(SequenceWrapper& tensor) {
     tensor.read_sample_f = [this,
                             file_name = file_info_[seq_meta.filename_idx].video_file,
                             index = seq_meta.frame_idx, count = seq_meta.length, &tensor] () {
-      push_sequence_to_read(file_name, index, count);
-      receive_frames(tensor);
+      if (frame_cache_) {
+        read_cached_sequence(tensor, file_name, index);
+      } else {
+        push_sequence_to_read(file_name, index, count);
+        receive_frames(tensor);
+      }
     };
     ++current_frame_idx_;
 
@@ -38,6 +38,7 @@ extern "C" {
 #include "dali/operators/reader/loader/loader.h"
 #include "dali/operators/reader/nvdecoder/nvdecoder.h"
 #include "dali/operators/reader/nvdecoder/sequencewrapper.h"
+#include "dali/operators/reader/nvdecoder/video_frame_cache.h"
 
 template<typename T>
 using av_unique_ptr = std::unique_ptr<T, std::function<void(T*)>>;
@@ -146,8 +147,14 @@ struct sequence_meta {
 
 class VideoLoader : public Loader<GPUBackend, SequenceWrapper> {
  public:
+  /**
+   * @param output_size the (height, width) to which the frames are scaled by the hardware decoder;
+   *                    {0, 0} keeps the size of the videos. The frames are not scaled (and the
+   *                    output size is ignored) when any of the videos is smaller than that.
+   */
   explicit inline VideoLoader(const OpSpec& spec,
-    const std::vector<std::string>& filenames)
+    const std::vector<std::string>& filenames,
+    TensorShape<2> output_size = {0, 0})
     : Loader<GPUBackend, SequenceWrapper>(spec),
       file_root_(spec.GetArgument<std::string>("file_root")),
       file_list_(spec.GetArgument<std::string>("file_list")),
@@ -167,10 +174,13 @@ class VideoLoader : public Loader<GPUBackend, SequenceWrapper> {
       file_list_include_preceding_frame_(
         spec.GetArgument<bool>("file_list_include_preceding_frame")),
       pad_sequences_(spec.GetArgument<bool>("pad_sequences")),
+      frame_cache_size_(spec.GetArgument<int>("frame_cache_size")),
+      output_size_(output_size),
       stats_({0, 0, 0, 0, 0}),
       current_frame_idx_(-1),
       stop_(false) {
     DALI_ENFORCE(stride_ > 0, "Stride should be > 0");
+    DALI_ENFORCE(frame_cache_size_ >= 0, "frame_cache_size must not be negative");
     if (step_ < 0)
       step_ = count_ * stride_;
     if (!file_list_include_preceding_frame_) {
@@ -217,6 +227,12 @@ class VideoLoader : public Loader<GPUBackend, SequenceWrapper> {
   void push_sequence_to_read(std::string filename, int frame, int count);
   void receive_frames(SequenceWrapper& sequence);
 
+  /**
+   * @brief Reads the sequence through the frame cache - only the range of the frames
+   *        which are not cached is decoded
+   */
+  void read_cached_sequence(SequenceWrapper& sequence, const std::string &filename, int frame);
+
  protected:
   Index SizeImpl() override;
 
@@ -311,6 +327,23 @@ class VideoLoader : public Loader<GPUBackend, SequenceWrapper> {
                  "dataset, check the length of the available videos and the requested sequence "
                  "length.");
 
+    if (output_size_[0] > 0 && output_size_[1] > 0) {
+      // the decoder is only asked to downscale, so that the result matches the generic resize
+      bool can_scale = std::all_of(frame_starts_.begin(), frame_starts_.end(),
+        [&](const sequence_meta &meta) {
+          return meta.height >= output_size_[0] && meta.width >= output_size_[1];
+        });
+      if (can_scale) {
+        for (auto &meta : frame_starts_) {
+          meta.height = output_size_[0];
+          meta.width = output_size_[1];
+        }
+      } else {
+        output_size_ = {0, 0};
+      }
+    } else {
+      output_size_ = {0, 0};
+    }
 
     const auto& file = get_or_open_file(file_info_[0].video_file);
     auto stream = file.fmt_ctx_->streams[file.vid_stream_idx_];
@@ -322,7 +355,13 @@ class VideoLoader : public Loader<GPUBackend, SequenceWrapper> {
                                                normalized_,
                                                ALIGN16(max_height_),
                                                ALIGN16(max_width_),
-                                               additional_decode_surfaces_);
+                                               additional_decode_surfaces_,
+                                               output_size_[0],
+                                               output_size_[1]);
+    if (frame_cache_size_ > 0) {
+      frame_cache_ = std::make_unique<VideoFrameCache>(
+          static_cast<size_t>(frame_cache_size_) << 20, vid_decoder_->stream());
+    }
 
     if (shuffle_) {
       // TODO(spanev) decide of a policy for multi-gpu here and SequenceLoader
@@ -369,11 +408,14 @@ class VideoLoader : public Loader<GPUBackend, SequenceWrapper> {
   bool file_list_frame_num_;
   bool file_list_include_preceding_frame_;
   bool pad_sequences_;
+  int frame_cache_size_;  // in MB
+  TensorShape<2> output_size_;  // of the frames scaled by the decoder, {0, 0} if not scaled
   VideoLoaderStats stats_;
 
   std::unordered_map<std::string, VideoFile> open_files_;
   std::string last_opened_;
   std::unique_ptr<NvDecoder> vid_decoder_;
+  std::unique_ptr<VideoFrameCache> frame_cache_;
 
   ThreadSafeQueue<FrameReq> send_queue_;
 
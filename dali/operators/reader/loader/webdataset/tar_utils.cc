@@ -14,6 +14,7 @@
 
 #include "dali/operators/reader/loader/webdataset/tar_utils.h"
 #include <algorithm>
+#include <atomic>
 #include <cstdarg>
 #include <cstdlib>
 #include <cstring>
@@ -39,7 +40,9 @@ constexpr uint64_t kTarArchiveBufferInitSize = 1;
 std::mutex instances_mutex;
 std::list<std::vector<TarArchive*>> instances_registry = {
     std::vector<TarArchive*>(kTarArchiveBufferInitSize)};
-TarArchive** instances = instances_registry.back().data();
+// read without the lock - the previous arrays are kept alive, so that the archives registered
+// before the array grew can still be found through a stale pointer
+std::atomic<TarArchive**> instances{instances_registry.back().data()};
 
 int Register(TarArchive* archive) {
   std::lock_guard<std::mutex> instances_lock(instances_mutex);
@@ -62,6 +65,7 @@ int Register(TarArchive* archive) {
 }
 
 inline void Unregister(int instance_handle_) {
+  std::lock_guard<std::mutex> instances_lock(instances_mutex);
   instances[instance_handle_] = nullptr;
 }
 
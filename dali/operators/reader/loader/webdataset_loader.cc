@@ -13,8 +13,18 @@
 // limitations under the License.
 
 #include "dali/operators/reader/loader/webdataset_loader.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
 #include <cstddef>
+#include <cstdio>
 #include <cstring>
+#include <ctime>
 #include <limits>
 #include <memory>
 #include <tuple>
@@ -183,6 +193,190 @@ inline void ParseTarFile(std::vector<SampleDesc>& samples_container,
   tar_file = tar_archive.Release();
 }
 
+/*
+ * The layout of the binary index of an archive:
+ *   BinaryIndexHeader
+ *   BinaryIndexSample[num_samples]
+ *   BinaryIndexComponent[num_components]
+ *   char[strings_size]     - the file names of the components
+ *
+ * All the structures are 8-byte aligned, so the entries can be accessed in the mapped file
+ * directly.
+ */
+constexpr char kBinaryIndexMagic[8] = { 'D', 'A', 'L', 'I', 'W', 'D', 'S', 'I' };
+constexpr uint32_t kBinaryIndexVersion = 1;
+
+struct ArchiveStamp {
+  int64_t size, mtime_sec, mtime_nsec;
+};
+
+struct BinaryIndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  ArchiveStamp archive;
+  uint64_t num_samples, num_components, strings_size;
+};
+
+struct BinaryIndexSample {
+  uint64_t first_component, num_components;
+};
+
+struct BinaryIndexComponent {
+  int64_t offset;
+  uint64_t size;
+  uint64_t name_offset, name_size;
+};
+
+static_assert(sizeof(BinaryIndexHeader) % 8 == 0 && sizeof(BinaryIndexSample) % 8 == 0 &&
+              sizeof(BinaryIndexComponent) % 8 == 0, "The entries must be 8-byte aligned");
+
+/**
+ * @brief Gets the size and the modification time of a local archive
+ *
+ * @return false, if the archive is not a local file or it was modified too recently to tell
+ *         the following modifications apart by the timestamp
+ */
+inline bool GetArchiveStamp(const std::string& archive_path, ArchiveStamp& stamp) {
+  struct stat s;
+  if (stat(archive_path.c_str(), &s) != 0 || !S_ISREG(s.st_mode) ||
+      s.st_mtim.tv_sec + 1 >= time(nullptr))
+    return false;
+  stamp = { s.st_size, s.st_mtim.tv_sec, s.st_mtim.tv_nsec };
+  return true;
+}
+
+inline std::string BinaryIndexPath(const std::string& cache_dir,
+                                   const std::string& archive_path) {
+  char resolved[PATH_MAX];
+  std::string key = realpath(archive_path.c_str(), resolved) ? resolved : archive_path;
+  // 64-bit FNV-1a - it must not change between runs and builds
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (unsigned char c : key) {
+    h ^= c;
+    h *= 0x100000001b3ull;
+  }
+  char name[32];
+  snprintf(name, sizeof(name), "wds_index_%016llx.bin",
+           static_cast<unsigned long long>(h));  // NOLINT(runtime/int)
+  return cache_dir + "/" + name;
+}
+
+/**
+ * @brief Reads the binary index of an archive, stored by an earlier run
+ *
+ * @return false, if there's no valid index for the archive in its current state
+ */
+inline bool LoadBinaryIndex(std::vector<SampleDesc>& samples_container,
+                            std::vector<ComponentDesc>& components_container,
+                            const std::string& index_path, const ArchiveStamp& stamp) {
+  int fd = open(index_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat s;
+  void* mapping = MAP_FAILED;
+  if (fstat(fd, &s) == 0 && static_cast<size_t>(s.st_size) >= sizeof(BinaryIndexHeader))
+    mapping = mmap(nullptr, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return false;
+  std::unique_ptr<void, std::function<void(void*)>> unmap(
+      mapping, [size = s.st_size](void* p) { munmap(p, size); });
+
+  auto* hdr = static_cast<const BinaryIndexHeader*>(mapping);
+  size_t size = s.st_size - sizeof(BinaryIndexHeader);
+  if (memcmp(hdr->magic, kBinaryIndexMagic, sizeof(kBinaryIndexMagic)) != 0 ||
+      hdr->version != kBinaryIndexVersion || hdr->archive.size != stamp.size ||
+      hdr->archive.mtime_sec != stamp.mtime_sec || hdr->archive.mtime_nsec != stamp.mtime_nsec ||
+      hdr->num_samples > size / sizeof(BinaryIndexSample))
+    return false;
+  size -= hdr->num_samples * sizeof(BinaryIndexSample);
+  if (hdr->num_components > size / sizeof(BinaryIndexComponent) ||
+      size - hdr->num_components * sizeof(BinaryIndexComponent) != hdr->strings_size)
+    return false;
+  auto* samples = reinterpret_cast<const BinaryIndexSample*>(hdr + 1);
+  auto* components = reinterpret_cast<const BinaryIndexComponent*>(samples + hdr->num_samples);
+  auto* strings = reinterpret_cast<const char*>(components + hdr->num_components);
+
+  size_t first_sample = samples_container.size(), first_component = components_container.size();
+  samples_container.reserve(first_sample + hdr->num_samples);
+  components_container.reserve(first_component + hdr->num_components);
+  for (uint64_t i = 0; i < hdr->num_components; i++) {
+    auto& c = components[i];
+    if (c.name_offset > hdr->strings_size || c.name_size > hdr->strings_size - c.name_offset ||
+        c.offset % kBlockSize != 0)
+      return false;
+    components_container.emplace_back();
+    auto& component = components_container.back();
+    component.offset = c.offset;
+    component.size = c.size;
+    component.filename.assign(strings + c.name_offset, c.name_size);
+    std::tie(std::ignore, component.ext) = split_name(component.filename);
+  }
+  for (uint64_t i = 0; i < hdr->num_samples; i++) {
+    auto& sample = samples[i];
+    if (sample.first_component > hdr->num_components ||
+        sample.num_components > hdr->num_components - sample.first_component)
+      return false;
+    samples_container.emplace_back();
+    samples_container.back().components = VectorRange<ComponentDesc>(
+        components_container, first_component + sample.first_component, sample.num_components);
+  }
+  return true;
+}
+
+/**
+ * @brief Stores the index of an archive, so that the following runs don't need to read
+ *        the archive to infer it
+ */
+inline void SaveBinaryIndex(std::vector<SampleDesc>& samples_container,
+                            std::vector<ComponentDesc>& components_container,
+                            const std::string& index_path, const ArchiveStamp& stamp) {
+  BinaryIndexHeader hdr = {};
+  memcpy(hdr.magic, kBinaryIndexMagic, sizeof(kBinaryIndexMagic));
+  hdr.version = kBinaryIndexVersion;
+  hdr.archive = stamp;
+  hdr.num_samples = samples_container.size();
+  hdr.num_components = components_container.size();
+
+  std::vector<BinaryIndexSample> samples;
+  std::vector<BinaryIndexComponent> components;
+  samples.reserve(samples_container.size());
+  components.reserve(components_container.size());
+  for (auto& sample : samples_container)
+    samples.push_back({ sample.components.start, sample.components.num });
+  uint64_t strings_size = 0;
+  for (auto& component : components_container) {
+    components.push_back({ component.offset, component.size, strings_size,
+                           component.filename.size() });
+    strings_size += component.filename.size();
+  }
+  hdr.strings_size = strings_size;
+
+  // Several processes may write the index at once - each writes its own file and atomically
+  // replaces the index with it.
+  std::string tmp_path = make_string(index_path, ".tmp.", getpid());
+  FILE* f = fopen(tmp_path.c_str(), "wb");
+  if (!f) {
+    DALI_WARN("Cannot write the webdataset index ", tmp_path, ": ", strerror(errno));
+    return;
+  }
+  bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+  ok = ok && fwrite(samples.data(), sizeof(BinaryIndexSample), samples.size(), f) ==
+             samples.size();
+  ok = ok && fwrite(components.data(), sizeof(BinaryIndexComponent), components.size(), f) ==
+             components.size();
+  for (size_t i = 0; ok && i < components_container.size(); i++) {
+    auto& name = components_container[i].filename;
+    ok = fwrite(name.data(), 1, name.size(), f) == name.size();
+  }
+  ok = (fclose(f) == 0) && ok;
+  if (!ok || rename(tmp_path.c_str(), index_path.c_str()) != 0) {
+    DALI_WARN("Cannot write the webdataset index ", index_path, ": ", strerror(errno));
+    remove(tmp_path.c_str());
+  }
+}
+
 }  // namespace wds
 }  // namespace detail
 
@@ -200,7 +394,9 @@ WebdatasetLoader::WebdatasetLoader(const OpSpec& spec)
       paths_(spec.GetRepeatedArgument<std::string>("paths")),
       index_paths_(spec.GetRepeatedArgument<std::string>("index_paths")),
       missing_component_behavior_(detail::wds::ParseMissingExtBehavior(
-          spec.GetArgument<std::string>("missing_component_behavior"))) {
+          spec.GetArgument<std::string>("missing_component_behavior"))),
+      index_threads_(std::max(num_io_threads_, spec.GetArgument<int>("num_threads"))) {
+  spec.TryGetArgument(index_cache_dir_, "index_cache_dir");
   DALI_ENFORCE(paths_.size() == index_paths_.size() || index_paths_.size() == 0,
                make_string("The number of index files, if any, must match the number of archives ",
                "in the dataset"));
@@ -260,9 +456,17 @@ std::string WebdatasetLoader::GetSampleSource(const detail::wds::SampleDesc& sam
 
 void WebdatasetLoader::ReadSample(vector<Tensor<CPUBackend>>& sample) {
   MoveToNextShard(sample_index_);
-  detail::wds::SampleDesc& current_sample = samples_[sample_index_];
+  detail::wds::SampleDesc& current_sample = samples_[GlobalSampleIndex(sample_index_)];
   auto& current_wds_shard = wds_shards_[current_sample.wds_shard_index];
 
+  // The components of a sample are usually adjacent in the archive, separated only by the tar
+  // headers - then the whole span of the sample is read with a single request and the outputs
+  // are views to it.
+  std::shared_ptr<uint8_t> span_data;
+  int64_t span_begin = 0;
+  if (copy_read_data_)
+    span_data = ReadSampleSpan(current_sample, span_begin);
+
   for (auto& component : current_sample.components) {
     // Checking if the component data from the index file agrees with reality
     DALI_ENFORCE(
@@ -270,7 +474,8 @@ void WebdatasetLoader::ReadSample(vector<Tensor<CPUBackend>>& sample) {
         IndexFileErrMsg(index_paths_[current_sample.wds_shard_index], current_sample.line_number,
                         "offset is outside of the archive file"));
 
-    current_wds_shard->Seek(component.offset);
+    if (!span_data)
+      current_wds_shard->Seek(component.offset);
 
     // Skipping cached samples
     const std::string sample_key = make_string_delim(':', paths_[current_sample.wds_shard_index],
@@ -288,7 +493,16 @@ void WebdatasetLoader::ReadSample(vector<Tensor<CPUBackend>>& sample) {
       continue;
     }
     // Reading Data
-    if (copy_read_data_) {
+    if (span_data) {
+      std::shared_ptr<void> data(span_data, span_data.get() + (component.offset - span_begin));
+      for (auto& output : component.outputs) {
+        sample[output].SetMeta(meta);
+        sample[output].ShareData(
+            data, component.size, false,
+            {static_cast<int64_t>(component.size / sample[output].type_info().size())},
+            sample[output].type());
+      }
+    } else if (copy_read_data_) {
       uint8_t* shared_tensor_data = nullptr;
       bool shared_tensor_is_pinned = false;
       for (auto& output : component.outputs) {
@@ -330,6 +544,33 @@ void WebdatasetLoader::ReadSample(vector<Tensor<CPUBackend>>& sample) {
   sample_index_++;
 }
 
+std::shared_ptr<uint8_t> WebdatasetLoader::ReadSampleSpan(
+    detail::wds::SampleDesc& sample, int64_t& span_begin) {
+  if (sample.components.num == 0)
+    return nullptr;
+  auto& wds_shard = wds_shards_[sample.wds_shard_index];
+  int64_t span_end = 0;
+  size_t payload = 0;
+  span_begin = std::numeric_limits<int64_t>::max();
+  for (auto& component : sample.components) {
+    span_begin = std::min(span_begin, component.offset);
+    span_end = std::max(span_end, component.offset + static_cast<int64_t>(component.size));
+    payload += component.size;
+  }
+  // the components are scattered over the archive, or the index is broken - read them one by one
+  if (span_end > static_cast<int64_t>(wds_shard->Size()) ||
+      static_cast<size_t>(span_end - span_begin) >
+          payload + sample.components.num * kMaxComponentGap)
+    return nullptr;
+
+  size_t span_size = span_end - span_begin;
+  std::shared_ptr<uint8_t> span_data(new uint8_t[span_size], std::default_delete<uint8_t[]>());
+  wds_shard->Seek(span_begin);
+  DALI_ENFORCE(wds_shard->Read(span_data.get(), span_size) == span_size,
+               "Error reading from a file " + paths_[sample.wds_shard_index]);
+  return span_data;
+}
+
 Index WebdatasetLoader::SizeImpl() {
   return samples_.size();
 }
@@ -348,7 +589,7 @@ void WebdatasetLoader::PrepareMetadataImpl() {
   // initializing all the readers
   wds_shards_.reserve(paths_.size());
   for (auto& uri : paths_) {
-    wds_shards_.emplace_back(FileStream::Open(uri, read_ahead_, !copy_read_data_));
+    wds_shards_.emplace_back(OpenStream(uri, read_ahead_, !copy_read_data_));
   }
 
   // preparing the map from extensions to outputs
@@ -360,8 +601,6 @@ void WebdatasetLoader::PrepareMetadataImpl() {
   }
 
   // collecting and filtering the index files
-  std::vector<detail::wds::SampleDesc> unfiltered_samples;
-  std::vector<detail::wds::ComponentDesc> unfiltered_components;
   bitmask was_output_set;
   was_output_set.resize(ext_.size(), false);
   output_indicies_.reserve(ext_.size());
@@ -371,17 +610,45 @@ void WebdatasetLoader::PrepareMetadataImpl() {
     dtype_sizes_[i] = TypeTable::GetTypeInfo(dtypes_[i]).size();
   }
 
-  for (size_t wds_shard_index = 0; wds_shard_index < paths_.size(); wds_shard_index++) {
-    unfiltered_samples.resize(0);
-    unfiltered_components.resize(0);
-    if (generate_index_) {
-      detail::wds::ParseTarFile(unfiltered_samples, unfiltered_components,
-                                wds_shards_[wds_shard_index]);
-    } else {
-      detail::wds::ParseIndexFile(unfiltered_samples, unfiltered_components,
-                                  index_paths_[wds_shard_index]);
+  // reading the indices of the archives, in parallel
+  struct ShardIndex {
+    std::vector<detail::wds::SampleDesc> samples;
+    std::vector<detail::wds::ComponentDesc> components;
+  };
+  std::vector<ShardIndex> shard_indices(paths_.size());
+  auto read_index = [&](size_t wds_shard_index) {
+    auto& shard = shard_indices[wds_shard_index];
+    if (!generate_index_) {
+      detail::wds::ParseIndexFile(shard.samples, shard.components, index_paths_[wds_shard_index]);
+      return;
     }
+    std::string binary_index_path;
+    detail::wds::ArchiveStamp stamp;
+    if (!index_cache_dir_.empty() &&
+        detail::wds::GetArchiveStamp(paths_[wds_shard_index], stamp)) {
+      binary_index_path = detail::wds::BinaryIndexPath(index_cache_dir_, paths_[wds_shard_index]);
+      if (detail::wds::LoadBinaryIndex(shard.samples, shard.components, binary_index_path, stamp))
+        return;
+      shard = {};
+    }
+    detail::wds::ParseTarFile(shard.samples, shard.components, wds_shards_[wds_shard_index]);
+    if (!binary_index_path.empty())
+      detail::wds::SaveBinaryIndex(shard.samples, shard.components, binary_index_path, stamp);
+  };
+  int num_index_threads = std::min<size_t>(index_threads_, paths_.size());
+  if (num_index_threads > 1) {
+    ThreadPool index_thread_pool(num_index_threads, CPU_ONLY_DEVICE_ID, false,
+                                 "Webdataset index");
+    for (size_t wds_shard_index = 0; wds_shard_index < paths_.size(); wds_shard_index++)
+      index_thread_pool.AddWork([&, wds_shard_index](int) { read_index(wds_shard_index); });
+    index_thread_pool.RunAll();
+  } else {
+    for (size_t wds_shard_index = 0; wds_shard_index < paths_.size(); wds_shard_index++)
+      read_index(wds_shard_index);
+  }
 
+  for (size_t wds_shard_index = 0; wds_shard_index < paths_.size(); wds_shard_index++) {
+    auto& unfiltered_samples = shard_indices[wds_shard_index].samples;
     for (auto& sample : unfiltered_samples) {
       detail::wds::SampleDesc new_sample{
           detail::wds::VectorRange<detail::wds::ComponentDesc>(components_, components_.size()),
@@ -440,12 +707,15 @@ void WebdatasetLoader::PrepareMetadataImpl() {
       }
       was_output_set.fill(false);
     }
+    shard_indices[wds_shard_index] = {};
   }
   sample_index_ = start_index(shard_id_, num_shards_, samples_.size());
+  ShuffleGlobally();
 }
 
 void WebdatasetLoader::Reset(bool wrap_to_shard) {
   sample_index_ = wrap_to_shard ? start_index(shard_id_, num_shards_, samples_.size()) : 0;
+  ShuffleGlobally();
 }
 
 }  // namespace dali
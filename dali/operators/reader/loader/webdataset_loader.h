@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -105,6 +105,10 @@ class DLL_PUBLIC WebdatasetLoader : public Loader<CPUBackend, vector<Tensor<CPUB
   std::vector<std::set<std::string>> ext_;
   std::vector<DALIDataType> dtypes_;
   detail::wds::MissingExtBehavior missing_component_behavior_;
+  // the number of threads reading the indices of the archives
+  int index_threads_;
+  // where the indices inferred from the archives are stored for the following runs
+  std::string index_cache_dir_;
 
  private:
   std::vector<detail::wds::SampleDesc> samples_;        // data from the index files
@@ -120,6 +124,24 @@ class DLL_PUBLIC WebdatasetLoader : public Loader<CPUBackend, vector<Tensor<CPUB
 
   bool generate_index_ = true;
   std::string GetSampleSource(const detail::wds::SampleDesc& sample);
+
+  /**
+   * @brief The maximum number of bytes between the components, per component, for which
+   *        the components of a sample are read together
+   *
+   * Covers the tar headers (including the extended ones) and the padding of the members.
+   */
+  static constexpr size_t kMaxComponentGap = 4096;
+
+  /**
+   * @brief Reads the byte span of the archive containing all the components of the sample
+   *
+   * @param span_begin the archive offset of the returned data
+   * @return The data of the span or nullptr, if the components are not adjacent enough
+   *         to be read together
+   */
+  std::shared_ptr<uint8_t> ReadSampleSpan(detail::wds::SampleDesc& sample,
+                                          int64_t& span_begin);
 };
 
 }  // namespace dali
@@ -0,0 +1,373 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if BLOSC_ENABLED
+#include <blosc.h>
+#endif
+#if ZSTD_ENABLED
+#include <zstd.h>
+#endif
+#if LZ4_ENABLED
+#include <lz4.h>
+#endif
+
+#include "dali/core/convert.h"
+#include "dali/core/static_switch.h"
+#include "dali/operators/reader/loader/zarr_loader.h"
+#include "dali/pipeline/util/lookahead_parser.h"
+
+namespace dali {
+
+namespace detail {
+
+namespace {
+
+constexpr char kMetadataFile[] = ".zarray";
+
+int64_t GetInteger(LookaheadParser &parser, const char *what) {
+  DALI_ENFORCE(parser.PeekType() == rapidjson::kNumberType,
+               make_string("Expected a number in \"", what, "\""));
+  double value = parser.GetDouble();
+  DALI_ENFORCE(value >= 0 && value == std::floor(value) && value < (1ll << 53),
+               make_string("Expected a non-negative integer in \"", what, "\"; got ", value));
+  return static_cast<int64_t>(value);
+}
+
+TensorShape<> GetShape(LookaheadParser &parser, const char *what) {
+  TensorShape<> shape;
+  DALI_ENFORCE(parser.EnterArray(), make_string("Expected an array in \"", what, "\""));
+  while (parser.NextArrayValue())
+    shape.shape.push_back(GetInteger(parser, what));
+  return shape;
+}
+
+double GetFillValue(LookaheadParser &parser) {
+  switch (parser.PeekType()) {
+    case rapidjson::kNullType:
+      parser.GetNull();
+      return 0;  // undefined - use zeros
+    case rapidjson::kNumberType:
+      return parser.GetDouble();
+    case rapidjson::kStringType: {
+      std::string value = parser.GetString();
+      if (value == "NaN")
+        return std::numeric_limits<double>::quiet_NaN();
+      if (value == "Infinity")
+        return std::numeric_limits<double>::infinity();
+      if (value == "-Infinity")
+        return -std::numeric_limits<double>::infinity();
+      DALI_FAIL(make_string("Unsupported fill value: \"", value, "\""));
+    }
+    default:
+      DALI_FAIL("Unsupported fill value.");
+  }
+}
+
+ZarrArrayMeta::Compressor GetCompressor(LookaheadParser &parser) {
+  if (parser.PeekType() == rapidjson::kNullType) {
+    parser.GetNull();
+    return ZarrArrayMeta::kNone;
+  }
+  DALI_ENFORCE(parser.EnterObject(), "Expected an object or null in \"compressor\"");
+  std::string id;
+  while (const char *key = parser.NextObjectKey()) {
+    if (0 == std::strcmp(key, "id")) {
+      DALI_ENFORCE(parser.PeekType() == rapidjson::kStringType,
+                   "Expected a string in \"compressor.id\"");
+      id = parser.GetString();
+    } else {
+      // the decompression doesn't depend on the other parameters
+      parser.SkipValue();
+    }
+  }
+  if (id == "blosc")
+    return ZarrArrayMeta::kBlosc;
+  if (id == "zstd")
+    return ZarrArrayMeta::kZstd;
+  if (id == "lz4")
+    return ZarrArrayMeta::kLz4;
+  DALI_FAIL(make_string("Unsupported compressor: \"", id, "\". "
+                        "Supported compressors are: blosc, zstd and lz4."));
+}
+
+void SkipFilters(LookaheadParser &parser) {
+  if (parser.PeekType() == rapidjson::kNullType) {
+    parser.GetNull();
+    return;
+  }
+  DALI_ENFORCE(parser.EnterArray(), "Expected an array or null in \"filters\"");
+  DALI_ENFORCE(!parser.NextArrayValue(), "Filters are not supported.");
+}
+
+}  // namespace
+
+void ParseZarrMetadata(ZarrArrayMeta &target, std::string json) {
+  target = {};
+  TensorShape<> shape, chunk_shape;
+  bool has_shape = false, has_chunks = false, has_dtype = false;
+  int64_t zarr_format = 0;
+  double fill_value = 0;
+  std::string order = "C";
+
+  LookaheadParser parser(&json[0]);
+  DALI_ENFORCE(parser.PeekType() == rapidjson::kObjectType, "Expected a JSON object.");
+  parser.EnterObject();
+  while (const char *key = parser.NextObjectKey()) {
+    if (0 == std::strcmp(key, "zarr_format")) {
+      zarr_format = GetInteger(parser, key);
+    } else if (0 == std::strcmp(key, "shape")) {
+      shape = GetShape(parser, key);
+      has_shape = true;
+    } else if (0 == std::strcmp(key, "chunks")) {
+      chunk_shape = GetShape(parser, key);
+      has_chunks = true;
+    } else if (0 == std::strcmp(key, "dtype")) {
+      DALI_ENFORCE(parser.PeekType() == rapidjson::kStringType,
+                   "Expected a string in \"dtype\"");
+      std::string typestr = parser.GetString();
+      // < means LE, | means N/A, = means native. In all those cases, we can read
+      DALI_ENFORCE(!typestr.empty() &&
+                   (typestr[0] == '<' || typestr[0] == '|' || typestr[0] == '='),
+                   make_string("Unsupported data type: \"", typestr, "\". "
+                               "Big Endian and structured data types are not supported."));
+      target.header.type_info = &TypeFromNumpyStr(typestr.substr(1));
+      has_dtype = true;
+    } else if (0 == std::strcmp(key, "order")) {
+      DALI_ENFORCE(parser.PeekType() == rapidjson::kStringType,
+                   "Expected a string in \"order\"");
+      order = parser.GetString();
+    } else if (0 == std::strcmp(key, "fill_value")) {
+      fill_value = GetFillValue(parser);
+    } else if (0 == std::strcmp(key, "compressor")) {
+      target.compressor = GetCompressor(parser);
+    } else if (0 == std::strcmp(key, "filters")) {
+      SkipFilters(parser);
+    } else if (0 == std::strcmp(key, "dimension_separator")) {
+      DALI_ENFORCE(parser.PeekType() == rapidjson::kStringType,
+                   "Expected a string in \"dimension_separator\"");
+      std::string sep = parser.GetString();
+      DALI_ENFORCE(sep == "." || sep == "/",
+                   make_string("Invalid dimension separator: \"", sep, "\""));
+      target.dimension_separator = sep[0];
+    } else {
+      parser.SkipValue();
+    }
+  }
+  DALI_ENFORCE(parser.IsValid(), "Invalid JSON.");
+  DALI_ENFORCE(zarr_format == 2, make_string("Unsupported Zarr format version: ", zarr_format,
+                                             ". Only version 2 is supported."));
+  DALI_ENFORCE(has_shape && has_chunks && has_dtype,
+               "The metadata must contain \"shape\", \"chunks\" and \"dtype\".");
+  DALI_ENFORCE(shape.sample_dim() == chunk_shape.sample_dim(),
+               make_string("The chunks ", chunk_shape, " don't match the shape of the array ",
+                           shape));
+  for (int d = 0; d < chunk_shape.sample_dim(); d++)
+    DALI_ENFORCE(chunk_shape[d] > 0, make_string("Invalid chunk shape: ", chunk_shape));
+  DALI_ENFORCE(order == "C" || order == "F", make_string("Invalid order: \"", order, "\""));
+
+  target.header.fortran_order = order == "F";
+  if (target.header.fortran_order) {
+    // the chunks are stored in Fortran order - they're C-order arrays with reversed dimensions
+    std::reverse(shape.begin(), shape.end());
+    std::reverse(chunk_shape.begin(), chunk_shape.end());
+  }
+  target.header.shape = std::move(shape);
+  target.chunk_shape = std::move(chunk_shape);
+
+  auto &type = *target.header.type_info;
+  target.fill_value.resize(type.size());
+  TYPE_SWITCH(type.id(), type2id, T, (uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t,
+                                      int32_t, int64_t, float16, float, double), (
+    T value = std::isnan(fill_value) && std::is_integral<T>::value
+            ? T() : ConvertSat<T>(fill_value);
+    std::memcpy(target.fill_value.data(), &value, sizeof(T));
+  ), DALI_FAIL(make_string("Unsupported data type: ", type.id())));  // NOLINT
+}
+
+std::string ZarrChunkPath(const std::string &array_path, const ZarrArrayMeta &array,
+                          const TensorShape<> &chunk_pos) {
+  int ndim = chunk_pos.sample_dim();
+  if (ndim == 0)
+    return filesystem::join_path(array_path, "0");
+  std::string key;
+  for (int i = 0; i < ndim; i++) {
+    // the key lists the positions in the order of the dimensions of the array
+    int d = array.header.fortran_order ? ndim - 1 - i : i;
+    if (i > 0)
+      key += array.dimension_separator;
+    key += std::to_string(chunk_pos[d]);
+  }
+  return filesystem::join_path(array_path, key);
+}
+
+void DecompressZarrChunk(const ZarrArrayMeta &array, uint8_t *dst,
+                         const uint8_t *src, size_t src_size) {
+  int64_t nbytes = array.chunk_nbytes();
+  switch (array.compressor) {
+    case ZarrArrayMeta::kNone:
+      DALI_ENFORCE(static_cast<int64_t>(src_size) == nbytes,
+                   make_string("Unexpected size of an uncompressed chunk: ", src_size,
+                               " bytes; expected ", nbytes, " bytes."));
+      std::memcpy(dst, src, nbytes);
+      return;
+    case ZarrArrayMeta::kBlosc: {
+#if BLOSC_ENABLED
+      int ret = blosc_decompress_ctx(src, dst, nbytes, 1);
+      DALI_ENFORCE(ret == nbytes, make_string("Blosc decompression failed (", ret, ")."));
+      return;
+#else
+      DALI_FAIL("DALI was built without blosc support.");
+#endif
+    }
+    case ZarrArrayMeta::kZstd: {
+#if ZSTD_ENABLED
+      size_t ret = ZSTD_decompress(dst, nbytes, src, src_size);
+      DALI_ENFORCE(!ZSTD_isError(ret) && static_cast<int64_t>(ret) == nbytes,
+                   make_string("Zstd decompression failed: ",
+                               ZSTD_isError(ret) ? ZSTD_getErrorName(ret) : "unexpected size"));
+      return;
+#else
+      DALI_FAIL("DALI was built without zstd support.");
+#endif
+    }
+    case ZarrArrayMeta::kLz4: {
+#if LZ4_ENABLED
+      // numcodecs stores the uncompressed size (32-bit, little-endian) before the LZ4 block
+      DALI_ENFORCE(src_size >= 4 && src_size - 4 <= std::numeric_limits<int>::max(),
+                   "Invalid LZ4 chunk.");
+      uint32_t size = src[0] | (src[1] << 8) | (src[2] << 16) |
+                      (static_cast<uint32_t>(src[3]) << 24);
+      DALI_ENFORCE(size == nbytes, make_string("Unexpected size of a decompressed chunk: ", size,
+                                               " bytes; expected ", nbytes, " bytes."));
+      int ret = LZ4_decompress_safe(reinterpret_cast<const char *>(src + 4),
+                                    reinterpret_cast<char *>(dst), src_size - 4, nbytes);
+      DALI_ENFORCE(ret == nbytes, make_string("LZ4 decompression failed (", ret, ")."));
+      return;
+#else
+      DALI_FAIL("DALI was built without lz4 support.");
+#endif
+    }
+    default:
+      DALI_FAIL("Unknown compressor.");
+  }
+}
+
+void CopyBox(uint8_t *dst, const TensorShape<> &dst_shape,
+             const TensorShape<> &dst_anchor, const uint8_t *src,
+             const TensorShape<> &src_shape, const TensorShape<> &src_anchor,
+             const TensorShape<> &box_shape, const std::vector<uint8_t> &fill_value) {
+  int ndim = box_shape.sample_dim();
+  if (volume(box_shape) == 0)
+    return;
+  int64_t elem_size = fill_value.size();
+
+  // The dimensions that the box spans entirely in both arrays are copied with the rows.
+  int outer_dims = std::max(ndim - 1, 0);
+  int64_t row_size = elem_size * (ndim > 0 ? box_shape[ndim - 1] : 1);
+  while (outer_dims > 0 && box_shape[outer_dims] == dst_shape[outer_dims] &&
+         (!src || box_shape[outer_dims] == src_shape[outer_dims])) {
+    outer_dims--;
+    row_size *= box_shape[outer_dims];
+  }
+
+  SmallVector<int64_t, 6> dst_strides, src_strides;
+  dst_strides.resize(ndim);
+  src_strides.resize(ndim);
+  int64_t dst_stride = elem_size, src_stride = elem_size;
+  for (int d = ndim - 1; d >= 0; d--) {
+    dst_strides[d] = dst_stride;
+    src_strides[d] = src_stride;
+    dst_stride *= dst_shape[d];
+    if (src)
+      src_stride *= src_shape[d];
+  }
+
+  SmallVector<int64_t, 6> pos;
+  pos.resize(outer_dims, 0);
+  int64_t num_rows = volume(box_shape.begin(), box_shape.begin() + outer_dims);
+  for (int64_t r = 0; r < num_rows; r++) {
+    int64_t dst_offset = 0, src_offset = 0;
+    for (int d = 0; d < ndim; d++) {
+      int64_t p = d < outer_dims ? pos[d] : 0;
+      dst_offset += (dst_anchor[d] + p) * dst_strides[d];
+      if (src)
+        src_offset += (src_anchor[d] + p) * src_strides[d];
+    }
+    if (src) {
+      std::memcpy(dst + dst_offset, src + src_offset, row_size);
+    } else {
+      for (int64_t i = 0; i < row_size; i += elem_size)
+        std::memcpy(dst + dst_offset + i, fill_value.data(), elem_size);
+    }
+    // next row, in C order
+    for (int d = outer_dims - 1; d >= 0; d--) {
+      if (++pos[d] < box_shape[d])
+        break;
+      pos[d] = 0;
+    }
+  }
+}
+
+}  // namespace detail
+
+void ZarrLoader::ReadSample(ZarrArrayWrapper &target) {
+  auto filename = files_[GlobalSampleIndex(current_index_++)];
+
+  // handle wrap-around
+  MoveToNextShard(current_index_);
+
+  // The arrays can be given by their directories or by their metadata files - as they're found
+  // when listing the `file_root`.
+  size_t name_len = sizeof(detail::kMetadataFile) - 1;
+  if (filename.size() >= name_len &&
+      filename.compare(filename.size() - name_len, name_len, detail::kMetadataFile) == 0) {
+    filename.resize(filename.size() - name_len);
+    while (filename.size() > 1 && filename.back() == filesystem::dir_sep)
+      filename.pop_back();
+    if (filename.empty())
+      filename = ".";
+  }
+
+  DALIMeta meta;
+  meta.SetSourceInfo(filename);
+  meta.SetSkipSample(false);
+
+  auto path = filesystem::join_path(file_root_, filename);
+  auto metadata_path = filesystem::join_path(path, detail::kMetadataFile);
+  auto file = OpenStream(metadata_path, false, false);
+  std::string json(file->Size(), '\0');
+  DALI_ENFORCE(file->Read(reinterpret_cast<uint8_t *>(&json[0]), json.size()) == json.size(),
+               make_string("Failed to read file: ", metadata_path));
+  file->Close();
+
+  try {
+    detail::ParseZarrMetadata(target, std::move(json));
+  } catch (const std::runtime_error &e) {
+    DALI_FAIL(e.what() + ". File: " + metadata_path);
+  }
+  target.filename = std::move(path);
+  target.fortran_order = target.header.fortran_order;
+  target.meta = meta;
+}
+
+}  // namespace dali
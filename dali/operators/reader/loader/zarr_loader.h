@@ -0,0 +1,122 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_LOADER_ZARR_LOADER_H_
+#define DALI_OPERATORS_READER_LOADER_ZARR_LOADER_H_
+
+#include <string>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/operators/reader/loader/file_loader.h"
+#include "dali/operators/reader/loader/numpy_loader.h"
+
+namespace dali {
+
+/**
+ * @brief The metadata of a chunked array, stored in the Zarr (v2) format.
+ *
+ * The shapes are given in the layout of the data in the chunks: for Fortran-order arrays,
+ * the dimensions are reversed, as in NumpyHeaderMeta.
+ */
+struct ZarrArrayMeta {
+  enum Compressor {
+    kNone,
+    kBlosc,
+    kZstd,
+    kLz4,
+  };
+
+  NumpyHeaderMeta header;  // shape, type and order of the whole array
+  TensorShape<> chunk_shape;
+  Compressor compressor = kNone;
+  /// The value of a single element, used for the chunks which are not stored
+  std::vector<uint8_t> fill_value;
+  char dimension_separator = '.';
+
+  int64_t chunk_nbytes() const {
+    return volume(chunk_shape) * header.type_info->size();
+  }
+};
+
+struct ZarrArrayWrapper : ZarrArrayMeta {
+  std::string filename;  // the directory of the array
+  bool fortran_order = false;
+  DALIMeta meta;
+
+  DALIDataType get_type() const {
+    return header.type();
+  }
+
+  const TensorShape<>& get_shape() const {
+    return header.shape;
+  }
+
+  const DALIMeta& get_meta() const {
+    return meta;
+  }
+};
+
+namespace detail {
+
+/**
+ * @brief Parses the `.zarray` metadata of an array
+ */
+DLL_PUBLIC void ParseZarrMetadata(ZarrArrayMeta &target, std::string json);
+
+/**
+ * @brief Returns the path of the chunk with the given position in the chunk grid
+ *
+ * The position is given in the layout of the data in the chunks.
+ */
+DLL_PUBLIC std::string ZarrChunkPath(const std::string &array_path, const ZarrArrayMeta &array,
+                                     const TensorShape<> &chunk_pos);
+
+/**
+ * @brief Decompresses a chunk to `dst`, which has the size of an uncompressed chunk.
+ */
+DLL_PUBLIC void DecompressZarrChunk(const ZarrArrayMeta &array, uint8_t *dst,
+                                    const uint8_t *src, size_t src_size);
+
+/**
+ * @brief Copies a box between two dense C-order arrays.
+ *
+ * The box lies at `src_anchor` in the source and at `dst_anchor` in the destination.
+ * If `src` is null, the box is filled with copies of the `fill_value` element.
+ */
+DLL_PUBLIC void CopyBox(uint8_t *dst, const TensorShape<> &dst_shape,
+                        const TensorShape<> &dst_anchor, const uint8_t *src,
+                        const TensorShape<> &src_shape, const TensorShape<> &src_anchor,
+                        const TensorShape<> &box_shape, const std::vector<uint8_t> &fill_value);
+
+}  // namespace detail
+
+/**
+ * @brief Lists the arrays and reads their metadata; the chunks are read by the operator, once the
+ *        region of interest is known.
+ */
+class ZarrLoader : public FileLoader<CPUBackend, ZarrArrayWrapper> {
+ public:
+  using FileLoader<CPUBackend, ZarrArrayWrapper>::FileLoader;
+
+  void PrepareEmpty(ZarrArrayWrapper &target) override {
+    target = {};
+  }
+
+  void ReadSample(ZarrArrayWrapper &target) override;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_LOADER_ZARR_LOADER_H_
@@ -0,0 +1,138 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "dali/operators/reader/loader/zarr_loader.h"
+
+namespace dali {
+
+TEST(ZarrLoaderTest, ParseMetadata) {
+  {
+    ZarrArrayMeta target;
+    detail::ParseZarrMetadata(target, R"({
+        "chunks": [10, 20], "compressor": null, "dtype": "<i2", "fill_value": 7,
+        "filters": null, "order": "C", "shape": [25, 30], "zarr_format": 2})");
+    EXPECT_EQ(target.header.type(), DALI_INT16);
+    EXPECT_FALSE(target.header.fortran_order);
+    EXPECT_EQ(target.header.shape, (TensorShape<>{25, 30}));
+    EXPECT_EQ(target.chunk_shape, (TensorShape<>{10, 20}));
+    EXPECT_EQ(target.compressor, ZarrArrayMeta::kNone);
+    EXPECT_EQ(target.dimension_separator, '.');
+    EXPECT_EQ(target.chunk_nbytes(), 10 * 20 * 2);
+    ASSERT_EQ(target.fill_value.size(), 2u);
+    int16_t fill;
+    std::memcpy(&fill, target.fill_value.data(), sizeof(fill));
+    EXPECT_EQ(fill, 7);
+  }
+  {
+    ZarrArrayMeta target;
+    detail::ParseZarrMetadata(target, R"({
+        "zarr_format": 2, "shape": [4, 5, 6], "chunks": [2, 3, 4], "dtype": "<f4",
+        "order": "F", "fill_value": "NaN", "dimension_separator": "/",
+        "compressor": {"id": "blosc", "cname": "lz4", "clevel": 5, "shuffle": 1}})");
+    EXPECT_EQ(target.header.type(), DALI_FLOAT);
+    EXPECT_TRUE(target.header.fortran_order);
+    EXPECT_EQ(target.header.shape, (TensorShape<>{6, 5, 4}));
+    EXPECT_EQ(target.chunk_shape, (TensorShape<>{4, 3, 2}));
+    EXPECT_EQ(target.compressor, ZarrArrayMeta::kBlosc);
+    EXPECT_EQ(target.dimension_separator, '/');
+    float fill;
+    std::memcpy(&fill, target.fill_value.data(), sizeof(fill));
+    EXPECT_TRUE(std::isnan(fill));
+  }
+  {
+    ZarrArrayMeta target;
+    detail::ParseZarrMetadata(target, R"({
+        "zarr_format": 2, "shape": [], "chunks": [], "dtype": "|u1", "fill_value": null,
+        "compressor": {"id": "zstd", "level": 1}})");
+    EXPECT_EQ(target.header.type(), DALI_UINT8);
+    EXPECT_EQ(target.header.shape, TensorShape<>{});
+    EXPECT_EQ(target.compressor, ZarrArrayMeta::kZstd);
+    EXPECT_EQ(target.fill_value, std::vector<uint8_t>{0});
+  }
+}
+
+TEST(ZarrLoaderTest, ParseMetadataErrors) {
+  ZarrArrayMeta target;
+  const char *invalid[] = {
+    // v3
+    R"({"zarr_format": 3, "shape": [4], "chunks": [2], "dtype": "<i4"})",
+    // big endian
+    R"({"zarr_format": 2, "shape": [4], "chunks": [2], "dtype": ">i4"})",
+    // missing chunks
+    R"({"zarr_format": 2, "shape": [4], "dtype": "<i4"})",
+    // chunk rank mismatch
+    R"({"zarr_format": 2, "shape": [4, 4], "chunks": [2], "dtype": "<i4"})",
+    // empty chunk
+    R"({"zarr_format": 2, "shape": [4], "chunks": [0], "dtype": "<i4"})",
+    // unsupported compressor
+    R"({"zarr_format": 2, "shape": [4], "chunks": [2], "dtype": "<i4",
+        "compressor": {"id": "gzip"}})",
+    // filters
+    R"({"zarr_format": 2, "shape": [4], "chunks": [2], "dtype": "<i4",
+        "filters": [{"id": "delta", "dtype": "<i4"}]})",
+    // invalid order
+    R"({"zarr_format": 2, "shape": [4], "chunks": [2], "dtype": "<i4", "order": "X"})",
+  };
+  for (const char *json : invalid) {
+    SCOPED_TRACE(json);
+    EXPECT_THROW(detail::ParseZarrMetadata(target, json), std::exception);
+  }
+}
+
+TEST(ZarrLoaderTest, ChunkPath) {
+  ZarrArrayMeta array;
+  array.header.shape = {10, 20, 30};
+  EXPECT_EQ(detail::ZarrChunkPath("/data/arr", array, {1, 0, 2}), "/data/arr/1.0.2");
+  array.dimension_separator = '/';
+  EXPECT_EQ(detail::ZarrChunkPath("/data/arr", array, {1, 0, 2}), "/data/arr/1/0/2");
+  // the position is given in the storage layout - reversed for the Fortran order
+  array.header.fortran_order = true;
+  EXPECT_EQ(detail::ZarrChunkPath("/data/arr", array, {1, 0, 2}), "/data/arr/2/0/1");
+  array.header.shape = {};
+  EXPECT_EQ(detail::ZarrChunkPath("/data/arr", array, {}), "/data/arr/0");
+}
+
+TEST(ZarrLoaderTest, CopyBox) {
+  // a 4x5 chunk with values 0..19
+  TensorShape<> src_shape{4, 5};
+  std::vector<uint8_t> src(20);
+  for (int i = 0; i < 20; i++)
+    src[i] = i;
+  std::vector<uint8_t> fill = {255};
+
+  TensorShape<> dst_shape{3, 6};
+  std::vector<uint8_t> dst(18, 0);
+  // copy src[1:3, 2:5] to dst[1:3, 0:3]
+  detail::CopyBox(dst.data(), dst_shape, {1, 0}, src.data(), src_shape, {1, 2}, {2, 3}, fill);
+  // fill dst[0:3, 3:6]
+  detail::CopyBox(dst.data(), dst_shape, {0, 3}, nullptr, src_shape, {0, 0}, {3, 3}, fill);
+  std::vector<uint8_t> expected = {
+     0,  0,  0, 255, 255, 255,
+     7,  8,  9, 255, 255, 255,
+    12, 13, 14, 255, 255, 255,
+  };
+  EXPECT_EQ(dst, expected);
+
+  // whole rows are copied at once
+  std::vector<uint8_t> rows(10, 0);
+  detail::CopyBox(rows.data(), {2, 5}, {0, 0}, src.data(), src_shape, {2, 0}, {2, 5}, fill);
+  EXPECT_EQ(rows, std::vector<uint8_t>(src.begin() + 10, src.end()));
+}
+
+}  // namespace dali
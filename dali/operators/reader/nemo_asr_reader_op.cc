@@ -102,6 +102,17 @@ in seconds, of the audio samples.
 
 Samples with a duration longer than this value will be ignored.)code",
     0.0f)
+  .AddOptionalArg("bucket_batches",
+    R"code(If a value greater than 0 is provided, the samples are grouped into batches of
+similar durations, which reduces the padding needed by the batched processing of the audio.
+
+The consecutive samples of each shard are split into buckets of ``bucket_batches`` batches.
+The samples in a bucket are sorted by the duration and the resulting batches are shuffled.
+With ``shuffle_after_epoch``, it is repeated in every epoch, after the dataset is shuffled.
+
+This option requires the ``duration`` field for all the samples in the manifest
+and can't be used with ``random_shuffle``.)code",
+    0)
   .AddOptionalArg<bool>("normalize_text", "Normalize text.", nullptr)
   .DeprecateArg("normalize_text")  // deprecated since 0.28dev
   .AdditionalOutputsFn(NemoAsrReaderOutputFn)
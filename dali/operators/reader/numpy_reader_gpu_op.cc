@@ -31,7 +31,7 @@ NumpyReaderGPU::NumpyReaderGPU(const OpSpec& spec)
   // make the device current
   DeviceGuard g(device_id_);
 
-  staging_stream_ = CUDAStreamPool::instance().Get();
+  staging_stream_ = CUDAStreamPool::instance().Get(-1, default_cuda_stream_priority_);
   staging_ready_ = CUDAEventPool::instance().Get();
   staging_.set_stream(staging_stream_);
 
@@ -40,6 +40,9 @@ NumpyReaderGPU::NumpyReaderGPU(const OpSpec& spec)
   loader_ = InitLoader<NumpyLoaderGPU>(spec, std::vector<string>(), shuffle_after_epoch);
 
   kmgr_transpose_.Resize<TransposeKernel>(1);
+
+  // when available, the reads of the whole batch are submitted together
+  batch_io_ = CUFileBatchIO::Create(kMaxBatchedReads);
 }
 
 void NumpyReaderGPU::Prefetch() {
@@ -90,9 +93,15 @@ void NumpyReaderGPU::Prefetch() {
     SampleView<GPUBackend> sample(curr_tensor_list.raw_mutable_tensor(data_idx),
                                   curr_tensor_list.tensor_shape(data_idx),
                                   curr_tensor_list.type());
-    ScheduleChunkedRead(sample, *curr_batch[data_idx]);
+    if (batch_io_)
+      AddBatchedRead(sample, *curr_batch[data_idx]);
+    else
+      ScheduleChunkedRead(sample, *curr_batch[data_idx]);
   }
-  thread_pool_.RunAll();
+  if (batch_io_)
+    RunBatchedReads();
+  else
+    thread_pool_.RunAll();
   staging_.commit();
   CUDA_CALL(cudaEventRecord(staging_ready_, staging_stream_));
 
@@ -101,8 +110,9 @@ void NumpyReaderGPU::Prefetch() {
   }
 }
 
-void NumpyReaderGPU::ScheduleChunkedRead(SampleView<GPUBackend> &out_sample,
-                                         NumpyFileWrapperGPU &load_target) {
+template <typename ChunkFn>
+void NumpyReaderGPU::ForEachChunk(SampleView<GPUBackend> &out_sample,
+                                  NumpyFileWrapperGPU &load_target, ChunkFn &&chunk_fn) {
   // TODO(michalz): add nbytes and num_elements to SampleView.
   size_t data_bytes = out_sample.shape().num_elements() *
                       TypeTable::GetTypeInfo(out_sample.type()).size();
@@ -120,12 +130,8 @@ void NumpyReaderGPU::ScheduleChunkedRead(SampleView<GPUBackend> &out_sample,
     ssize_t copy_skip = copy_start - file_offset;
     ssize_t copy_end = file_offset + chunk_read_length;
     ssize_t chunk_copy_length = copy_end - copy_start;
-    thread_pool_.AddWork([=, &load_target](int tid) {
-      auto buffer = staging_.get_staging_buffer();
-      load_target.ReadRawChunk(buffer.at(0), chunk_read_length, 0, file_offset);
-      assert(dst_ptr >= base_ptr && dst_ptr + chunk_copy_length <= base_ptr + data_bytes);
-      staging_.copy_to_client(dst_ptr, chunk_copy_length, std::move(buffer), copy_skip);
-    });
+    assert(dst_ptr >= base_ptr && dst_ptr + chunk_copy_length <= base_ptr + data_bytes);
+    chunk_fn(dst_ptr, chunk_read_length, file_offset, chunk_copy_length, copy_skip);
 
     // update addresses
     dst_ptr += chunk_copy_length;
@@ -135,6 +141,47 @@ void NumpyReaderGPU::ScheduleChunkedRead(SampleView<GPUBackend> &out_sample,
   assert(dst_ptr == base_ptr + data_bytes);
 }
 
+void NumpyReaderGPU::ScheduleChunkedRead(SampleView<GPUBackend> &out_sample,
+                                         NumpyFileWrapperGPU &load_target) {
+  ForEachChunk(out_sample, load_target,
+      [&](uint8_t *dst_ptr, ssize_t chunk_read_length, ssize_t file_offset,
+          ssize_t chunk_copy_length, ssize_t copy_skip) {
+    thread_pool_.AddWork([=, &load_target](int tid) {
+      auto buffer = staging_.get_staging_buffer();
+      load_target.ReadRawChunk(buffer.at(0), chunk_read_length, 0, file_offset);
+      staging_.copy_to_client(dst_ptr, chunk_copy_length, std::move(buffer), copy_skip);
+    });
+  });
+}
+
+void NumpyReaderGPU::AddBatchedRead(SampleView<GPUBackend> &out_sample,
+                                     NumpyFileWrapperGPU &load_target) {
+  ForEachChunk(out_sample, load_target,
+      [&](uint8_t *dst_ptr, ssize_t chunk_read_length, ssize_t file_offset,
+          ssize_t chunk_copy_length, ssize_t copy_skip) {
+    if (batch_io_->full())
+      RunBatchedReads();
+    auto buffer = staging_.get_staging_buffer();
+    batch_io_->AddRead(*load_target.file_stream, static_cast<uint8_t *>(buffer.at(0)), 0,
+                       file_offset, chunk_read_length);
+    batched_copies_.push_back({ dst_ptr, chunk_copy_length, std::move(buffer), copy_skip });
+  });
+}
+
+void NumpyReaderGPU::RunBatchedReads() {
+  try {
+    batch_io_->Run();
+  } catch (...) {
+    for (auto &copy : batched_copies_)
+      staging_.return_unused(std::move(copy.buffer));
+    batched_copies_.clear();
+    throw;
+  }
+  for (auto &copy : batched_copies_)
+    staging_.copy_to_client(copy.dst, copy.length, std::move(copy.buffer), copy.skip);
+  batched_copies_.clear();
+}
+
 DALI_REGISTER_OPERATOR(readers__Numpy, NumpyReaderGPU, GPU);
 
 // Deprecated alias
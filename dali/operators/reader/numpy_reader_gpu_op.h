@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_READER_NUMPY_READER_GPU_OP_H_
 #define DALI_OPERATORS_READER_NUMPY_READER_GPU_OP_H_
 
+#include <memory>
 #include <utility>
 #include <string>
 #include <vector>
@@ -27,6 +28,7 @@
 #include "dali/operators/reader/loader/numpy_loader_gpu.h"
 #include "dali/operators/reader/numpy_reader_op.h"
 #include "dali/operators/reader/reader_op.h"
+#include "dali/util/cufile_batch.h"
 
 namespace dali {
 
@@ -74,8 +76,40 @@ class NumpyReaderGPU : public NumpyReader<GPUBackend, NumpyFileWrapperGPU> {
   TensorListShape<> tmp_buf_sh_;
   TensorList<GPUBackend> tmp_buf_;
 
+  /**
+   * @brief Calls `chunk_fn(dst_ptr, read_length, file_offset, copy_length, copy_skip)` for each
+   *        chunk of the data of the sample, read at a GDS-aligned offset
+   */
+  template <typename ChunkFn>
+  void ForEachChunk(SampleView<GPUBackend> &out_sample, NumpyFileWrapperGPU &target,
+                    ChunkFn &&chunk_fn);
+
   void ScheduleChunkedRead(SampleView<GPUBackend> &out_sample, NumpyFileWrapperGPU &target);
 
+  /**
+   * @brief Adds the chunks of the sample to the batch of cuFile reads, submitting the batch
+   *        whenever it's full
+   */
+  void AddBatchedRead(SampleView<GPUBackend> &out_sample, NumpyFileWrapperGPU &target);
+
+  /**
+   * @brief Runs the batch of cuFile reads and schedules the copies from the staging buffers
+   */
+  void RunBatchedReads();
+
+  // The batch can't hold more staging buffers than the staging engine commits at once,
+  // or the engine could run out of them
+  static constexpr int kMaxBatchedReads = 32;
+  std::unique_ptr<CUFileBatchIO> batch_io_;
+
+  struct BatchedCopy {
+    uint8_t *dst;
+    ssize_t length;
+    gds::GDSStagingBuffer buffer;
+    ssize_t skip;
+  };
+  std::vector<BatchedCopy> batched_copies_;
+
   size_t chunk_size_ = gds::GetGDSChunkSize();
   detail::NumpyHeaderCache header_cache_;
   gds::GDSStagingEngine staging_;
@@ -15,6 +15,7 @@
 #include <string>
 
 #include "dali/core/backend_tags.h"
+#include "dali/core/math_util.h"
 #include "dali/kernels/slice/slice_cpu.h"
 #include "dali/kernels/slice/slice_flip_normalize_permute_pad_cpu.h"
 #include "dali/kernels/transpose/transpose.h"
@@ -102,6 +103,98 @@ static void SlicePermuteHelper(SampleView<CPUBackend> output, ConstSampleView<CP
   ), DALI_FAIL(make_string("Unsupported number of dimensions: ", ndim)););  // NOLINT
 }
 
+namespace detail {
+
+bool ClipRoi(TensorShape<> &anchor, TensorShape<> &shape, const CropWindow &roi,
+             const TensorShape<> &array_shape) {
+  int ndim = array_shape.sample_dim();
+  anchor.resize(ndim);
+  shape.resize(ndim);
+  bool in_bounds = true;
+  for (int d = 0; d < ndim; d++) {
+    int64_t begin = clamp<int64_t>(roi.anchor[d], 0, array_shape[d]);
+    int64_t end = clamp<int64_t>(roi.anchor[d] + roi.shape[d], 0, array_shape[d]);
+    anchor[d] = begin;
+    shape[d] = std::max<int64_t>(end - begin, 0);
+    in_bounds = in_bounds && anchor[d] == roi.anchor[d] && shape[d] == roi.shape[d];
+  }
+  return in_bounds;
+}
+
+void ScheduleClippedRoiCopy(SampleView<CPUBackend> output, ConstSampleView<CPUBackend> clipped,
+                            CropWindow roi, const TensorShape<> &array_shape, bool transpose,
+                            float fill_value, ThreadPool &thread_pool, int min_blk_sz,
+                            int req_nblocks) {
+  // the clipped region starts at the first element of the region within the array
+  for (int d = 0; d < roi.anchor.sample_dim(); d++)
+    roi.anchor[d] -= clamp<int64_t>(roi.anchor[d], 0, array_shape[d]);
+  if (transpose) {
+    SlicePermuteHelper(output, clipped, roi, fill_value, thread_pool, min_blk_sz, req_nblocks);
+  } else {
+    SliceHelper(output, clipped, roi, fill_value, thread_pool, min_blk_sz, req_nblocks);
+  }
+}
+
+}  // namespace detail
+
+// The region of interest arguments, common to the array readers
+DALI_SCHEMA(ArrayReaderRoiAttr)
+  .AddOptionalArg<std::vector<int>>("roi_start",
+      R"code(Start of the region-of-interest, in absolute coordinates.
+
+This argument is incompatible with "rel_roi_start".
+)code",
+      nullptr, true)
+  .AddOptionalArg<std::vector<float>>("rel_roi_start",
+      R"code(Start of the region-of-interest, in relative coordinates (range [0.0 - 1.0]).
+
+This argument is incompatible with "roi_start".
+)code",
+      nullptr, true)
+  .AddOptionalArg<std::vector<int>>("roi_end",
+      R"code(End of the region-of-interest, in absolute coordinates.
+
+This argument is incompatible with "rel_roi_end", "roi_shape" and "rel_roi_shape".
+)code",
+      nullptr, true)
+  .AddOptionalArg<std::vector<float>>("rel_roi_end",
+      R"code(End of the region-of-interest, in relative coordinates (range [0.0 - 1.0]).
+
+This argument is incompatible with "roi_end", "roi_shape" and "rel_roi_shape".
+)code",
+      nullptr, true)
+  .AddOptionalArg<std::vector<int>>("roi_shape",
+      R"code(Shape of the region-of-interest, in absolute coordinates.
+
+This argument is incompatible with "rel_roi_shape", "roi_end" and "rel_roi_end".
+)code",
+      nullptr, true)
+  .AddOptionalArg<std::vector<float>>("rel_roi_shape",
+      R"code(Shape of the region-of-interest, in relative coordinates (range [0.0 - 1.0]).
+
+This argument is incompatible with "roi_shape", "roi_end" and "rel_roi_end".
+)code",
+      nullptr, true)
+  .AddOptionalArg("roi_axes",
+      R"code(Order of dimensions used for the ROI anchor and shape argumens, as dimension indices.
+
+If not provided, all the dimensions should be specified in the ROI arguments.
+)code",
+      std::vector<int>{})
+  .AddOptionalArg("out_of_bounds_policy",
+      R"code(Determines the policy when reading outside of the bounds of the array.
+
+Here is a list of the supported values:
+
+- ``"error"`` (default): Attempting to read outside of the bounds of the image will produce an error.
+- ``"pad"``: The array will be padded as needed with zeros or any other value that is specified
+  with the ``fill_value`` argument.
+- ``"trim_to_shape"``: The ROI will be cut to the bounds of the array.)code",
+      "error")
+  .AddOptionalArg("fill_value",
+      R"code(Determines the padding value when ``out_of_bounds_policy`` is set to “pad”.)code",
+      0.f);
+
 DALI_REGISTER_OPERATOR(readers__Numpy, NumpyReaderCPU, CPU);
 
 DALI_SCHEMA(readers__Numpy)
@@ -122,6 +215,9 @@ This operator can be used in the following modes:
   process-wide with an environment variable ``DALI_GDS_CHUNK_SIZE``. Valid values are powers of 2
   between 4096 and 16M, with the default being 2M. For convenience, the value can be specified
   with a k or M suffix, applying a multiplier of 1024 and 2^20, respectively.
+
+When a region of interest is specified, the ``cpu`` reader reads from the files only the part of
+the array within the region.
 )")
   .NumInput(0)
   .NumOutput(1)  // (Arrays)
@@ -164,62 +260,8 @@ sizes vary a lot.)code", true)
       R"code(If set to True, the header information for each file is cached, improving access
 speed.)code",
       false)
-    .AddOptionalArg<std::vector<int>>("roi_start",
-        R"code(Start of the region-of-interest, in absolute coordinates.
-
-This argument is incompatible with "rel_roi_start".
-)code",
-        nullptr, true)
-    .AddOptionalArg<std::vector<float>>("rel_roi_start",
-        R"code(Start of the region-of-interest, in relative coordinates (range [0.0 - 1.0]).
-
-This argument is incompatible with "roi_start".
-)code",
-        nullptr, true)
-    .AddOptionalArg<std::vector<int>>("roi_end",
-        R"code(End of the region-of-interest, in absolute coordinates.
-
-This argument is incompatible with "rel_roi_end", "roi_shape" and "rel_roi_shape".
-)code",
-        nullptr, true)
-    .AddOptionalArg<std::vector<float>>("rel_roi_end",
-        R"code(End of the region-of-interest, in relative coordinates (range [0.0 - 1.0]).
-
-This argument is incompatible with "roi_end", "roi_shape" and "rel_roi_shape".
-)code",
-        nullptr, true)
-    .AddOptionalArg<std::vector<int>>("roi_shape",
-        R"code(Shape of the region-of-interest, in absolute coordinates.
-
-This argument is incompatible with "rel_roi_shape", "roi_end" and "rel_roi_end".
-)code",
-        nullptr, true)
-    .AddOptionalArg<std::vector<float>>("rel_roi_shape",
-        R"code(Shape of the region-of-interest, in relative coordinates (range [0.0 - 1.0]).
-
-This argument is incompatible with "roi_shape", "roi_end" and "rel_roi_end".
-)code",
-        nullptr, true)
-    .AddOptionalArg("roi_axes",
-        R"code(Order of dimensions used for the ROI anchor and shape argumens, as dimension indices.
-
-If not provided, all the dimensions should be specified in the ROI arguments.
-)code",
-        std::vector<int>{})
-    .AddOptionalArg("out_of_bounds_policy",
-        R"code(Determines the policy when reading outside of the bounds of the numpy array.
-
-Here is a list of the supported values:
-
-- ``"error"`` (default): Attempting to read outside of the bounds of the image will produce an error.
-- ``"pad"``: The array will be padded as needed with zeros or any other value that is specified
-  with the ``fill_value`` argument.
-- ``"trim_to_shape"``: The ROI will be cut to the bounds of the array.)code",
-        "error")
-    .AddOptionalArg("fill_value",
-        R"code(Determines the padding value when ``out_of_bounds_policy`` is set to “pad”.)code",
-        0.f)
-  .AddParent("LoaderBase");
+  .AddParent("LoaderBase")
+  .AddParent("ArrayReaderRoiAttr");
 
 
 // Deprecated alias
@@ -237,6 +279,22 @@ DALI_SCHEMA(NumpyReader)
 submodule and renamed to follow a common pattern. This is a placeholder operator with identical
 functionality to allow for backward compatibility.)code");  // Deprecated in 1.0;
 
+void NumpyReaderCPU::ScheduleBoxRead(NumpyFileWrapper &sample, uint8_t *dst,
+                                     const TensorShape<> &anchor, const TensorShape<> &shape,
+                                     ThreadPool &thread_pool) {
+  int64_t nbytes = volume(shape) * sample.header.type_info->size();
+  thread_pool.AddWork([&sample, dst, anchor, shape](int tid) {
+    std::vector<FileStream::ReadRequest> reads;
+    detail::GetRoiReads(reads, sample.file_stream.get(), dst, sample.header, anchor, shape);
+    FileStream::ReadBatch(make_span(reads));
+    for (auto &req : reads) {
+      DALI_ENFORCE(req.bytes_read == req.n_bytes,
+                   make_string("Failed to read file: ", sample.filename));
+    }
+    sample.file_stream->Close();
+  }, nbytes);
+}
+
 void NumpyReaderCPU::RunImpl(HostWorkspace &ws) {
   auto &output = ws.Output<CPUBackend>(0);
   const auto &out_sh = output.shape();
@@ -248,8 +306,14 @@ void NumpyReaderCPU::RunImpl(HostWorkspace &ws) {
   int blocks_per_sample = std::max(1, 10 * nthreads / nsamples);
   constexpr int kThreshold = kernels::kSliceMinBlockSize;  // smaller samples will not be subdivided
 
+  std::vector<int> buffered;
   for (int i = 0; i < nsamples; i++) {
     const auto& file_i = GetSample(i);
+    if (file_i.file_stream) {
+      if (ScheduleRoiRead(output[i], i, thread_pool))
+        buffered.push_back(i);
+      continue;
+    }
     const auto& file_sh = file_i.get_shape();
     int64_t sample_sz = volume(file_i.get_shape());
     auto input_sample = const_sample_view(file_i.data);
@@ -269,6 +333,13 @@ void NumpyReaderCPU::RunImpl(HostWorkspace &ws) {
     }
   }
   thread_pool.RunAll();
+
+  if (buffered.empty())
+    return;
+  // pad and/or transpose the parts of the arrays that were read
+  for (int i : buffered)
+    FinishRoiRead(output[i], i, thread_pool, kThreshold, blocks_per_sample);
+  thread_pool.RunAll();
 }
 
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -145,6 +145,19 @@ class NumpyReader : public DataReader<Backend, Target> {
     return true;
   }
 
+  /**
+   * @brief The region of interest of the sample, in the layout of the data in the file;
+   *        the whole array, if no region was specified.
+   */
+  CropWindow GetFileRoi(int sample_idx, const TensorShape<> &file_shape) const {
+    if (!rois_.empty())
+      return rois_[sample_idx];
+    CropWindow roi;
+    roi.anchor.resize(file_shape.sample_dim());  // zeros
+    roi.shape = file_shape;
+    return roi;
+  }
+
   NamedSliceAttr slice_attr_;
   std::vector<CropWindow> rois_;
   OutOfBoundsPolicy out_of_bounds_policy_ = OutOfBoundsPolicy::Error;
@@ -154,9 +167,92 @@ class NumpyReader : public DataReader<Backend, Target> {
   std::vector<bool> need_slice_;
 };
 
-class NumpyReaderCPU : public NumpyReader<CPUBackend, NumpyFileWrapper> {
+namespace detail {
+
+/**
+ * @brief Computes the part of the region of interest within the array
+ *
+ * @return true, if the whole region lies within the array
+ */
+DLL_PUBLIC bool ClipRoi(TensorShape<> &anchor, TensorShape<> &shape, const CropWindow &roi,
+                        const TensorShape<> &array_shape);
+
+/**
+ * @brief Schedules padding and/or transposing the part of the region of interest within the
+ *        array, stored in `clipped`, to the output.
+ */
+void ScheduleClippedRoiCopy(SampleView<CPUBackend> output, ConstSampleView<CPUBackend> clipped,
+                            CropWindow roi, const TensorShape<> &array_shape, bool transpose,
+                            float fill_value, ThreadPool &thread_pool, int min_blk_sz,
+                            int req_nblocks);
+
+}  // namespace detail
+
+/**
+ * @brief A CPU reader which reads only the region of interest of the arrays.
+ *
+ * The data is read in RunImpl, when the region is known. The Target must describe the array in
+ * the layout of the data in the file with a NumpyHeaderMeta `header`.
+ */
+template <typename Target>
+class ArrayRoiReaderCPU : public NumpyReader<CPUBackend, Target> {
+ public:
+  using NumpyReader<CPUBackend, Target>::NumpyReader;
+
+ protected:
+  /**
+   * @brief Schedules reading the box given by `anchor` and `shape` (within the array, in the
+   *        layout of the file) to a dense buffer.
+   */
+  virtual void ScheduleBoxRead(Target &sample, uint8_t *dst, const TensorShape<> &anchor,
+                               const TensorShape<> &shape, ThreadPool &thread_pool) = 0;
+
+  /**
+   * @brief Schedules reading the region of interest of the sample.
+   *
+   * When the region lies within the array and no transposition is needed, the data is read
+   * directly to the output; otherwise, it's read to `roi_buffers_[sample_idx]` and the function
+   * returns true - the sample must be completed with FinishRoiRead, once the data is read.
+   */
+  bool ScheduleRoiRead(SampleView<CPUBackend> output, int sample_idx, ThreadPool &thread_pool) {
+    auto &sample = this->GetSample(sample_idx);
+    const auto &file_sh = sample.header.shape;
+    CropWindow roi = this->GetFileRoi(sample_idx, file_sh);
+    TensorShape<> anchor, shape;
+    bool in_bounds = detail::ClipRoi(anchor, shape, roi, file_sh);
+
+    bool direct = in_bounds && !this->need_transpose_[sample_idx];
+    uint8_t *dst;
+    if (direct) {
+      dst = static_cast<uint8_t *>(output.raw_mutable_data());
+    } else {
+      while (roi_buffers_.size() <= static_cast<size_t>(sample_idx)) {
+        roi_buffers_.emplace_back();
+        roi_buffers_.back().set_pinned(false);
+      }
+      auto &buffer = roi_buffers_[sample_idx];
+      buffer.Resize(shape, sample.header.type());
+      dst = static_cast<uint8_t *>(buffer.raw_mutable_data());
+    }
+    ScheduleBoxRead(sample, dst, anchor, shape, thread_pool);
+    return !direct;
+  }
+
+  void FinishRoiRead(SampleView<CPUBackend> output, int sample_idx, ThreadPool &thread_pool,
+                     int min_blk_sz, int req_nblocks) {
+    const auto &file_sh = this->GetSample(sample_idx).header.shape;
+    detail::ScheduleClippedRoiCopy(output, const_sample_view(roi_buffers_[sample_idx]),
+                                   this->GetFileRoi(sample_idx, file_sh), file_sh,
+                                   this->need_transpose_[sample_idx], this->fill_value_,
+                                   thread_pool, min_blk_sz, req_nblocks);
+  }
+
+  std::vector<Tensor<CPUBackend>> roi_buffers_;
+};
+
+class NumpyReaderCPU : public ArrayRoiReaderCPU<NumpyFileWrapper> {
  public:
-  explicit NumpyReaderCPU(const OpSpec& spec) : NumpyReader<CPUBackend, NumpyFileWrapper>(spec) {
+  explicit NumpyReaderCPU(const OpSpec& spec) : ArrayRoiReaderCPU<NumpyFileWrapper>(spec) {
     bool shuffle_after_epoch = spec.GetArgument<bool>("shuffle_after_epoch");
     loader_ = InitLoader<NumpyLoader>(spec, shuffle_after_epoch);
   }
@@ -165,6 +261,9 @@ class NumpyReaderCPU : public NumpyReader<CPUBackend, NumpyFileWrapper> {
   void RunImpl(HostWorkspace &ws) override;
   using Operator<CPUBackend>::RunImpl;
 
+  void ScheduleBoxRead(NumpyFileWrapper &sample, uint8_t *dst, const TensorShape<> &anchor,
+                       const TensorShape<> &shape, ThreadPool &thread_pool) override;
+
  private:
   USE_READER_OPERATOR_MEMBERS(CPUBackend, NumpyFileWrapper);
 };
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -78,10 +78,12 @@ const char* GetVideoChromaFormatString(cudaVideoChromaFormat eChromaFormat) {
 
 }  // namespace
 
-CUVideoDecoder::CUVideoDecoder(int max_height, int max_width, int additional_decode_surfaces)
+CUVideoDecoder::CUVideoDecoder(int max_height, int max_width, int additional_decode_surfaces,
+                               int target_height, int target_width)
                               : decoder_{0}, decoder_info_{}, caps_{},
                                 max_height_{max_height}, max_width_{max_width},
-                                additional_decode_surfaces_{additional_decode_surfaces} {
+                                additional_decode_surfaces_{additional_decode_surfaces},
+                                target_height_{target_height}, target_width_{target_width} {
 }
 
 CUVideoDecoder::CUVideoDecoder() : CUVideoDecoder(0, 0, 0) {
@@ -101,7 +103,8 @@ CUVideoDecoder::~CUVideoDecoder() {
 CUVideoDecoder::CUVideoDecoder(CUVideoDecoder&& other)
     : decoder_{other.decoder_}, decoder_info_{other.decoder_info_},
       caps_{other.caps_}, max_height_{other.max_height_}, max_width_{other.max_width_},
-      additional_decode_surfaces_{other.additional_decode_surfaces_} {
+      additional_decode_surfaces_{other.additional_decode_surfaces_},
+      target_height_{other.target_height_}, target_width_{other.target_width_} {
     other.decoder_ = 0;
     other.max_height_ = 0;
     other.max_width_ = 0;
@@ -114,6 +117,8 @@ CUVideoDecoder& CUVideoDecoder::operator=(CUVideoDecoder&& other) {
     decoder_ = other.decoder_;
     max_height_ = other.max_height_;
     max_width_ = other.max_width_;
+    target_height_ = other.target_height_;
+    target_width_ = other.target_width_;
     other.decoder_ = 0;
     other.max_height_ = 0;
     other.max_width_ = 0;
@@ -148,11 +153,13 @@ void CUVideoDecoder::reconfigure(unsigned int height, unsigned int width) {
     reconfigParams.display_area.left = 0;
     reconfigParams.display_area.right = decoder_info_.display_area.right = width;
 
-    decoder_info_.ulTargetWidth = decoder_info_.ulWidth = width;
-    reconfigParams.ulTargetWidth = reconfigParams.ulWidth = width;
+    decoder_info_.ulWidth = reconfigParams.ulWidth = width;
+    decoder_info_.ulTargetWidth = reconfigParams.ulTargetWidth =
+        target_width_ > 0 ? target_width_ : width;
 
-    decoder_info_.ulTargetHeight = decoder_info_.ulHeight = height;
-    reconfigParams.ulTargetHeight = reconfigParams.ulHeight = height;
+    decoder_info_.ulHeight = reconfigParams.ulHeight = height;
+    decoder_info_.ulTargetHeight = reconfigParams.ulTargetHeight =
+        target_height_ > 0 ? target_height_ : height;
 
     reconfigParams.ulNumDecodeSurfaces = decoder_info_.ulNumDecodeSurfaces;
 
@@ -241,8 +248,13 @@ int CUVideoDecoder::initialize(CUVIDEOFORMAT* format) {
     decoder_info_.OutputFormat = cudaVideoSurfaceFormat_NV12;
     decoder_info_.bitDepthMinus8 = format->bit_depth_luma_minus8;
     decoder_info_.DeinterlaceMode = cudaVideoDeinterlaceMode_Adaptive;
-    decoder_info_.ulTargetWidth = format->display_area.right - format->display_area.left;
-    decoder_info_.ulTargetHeight = format->display_area.bottom - format->display_area.top;
+    // the frames are scaled by the decoder, if a target size is given
+    decoder_info_.ulTargetWidth = target_width_ > 0
+        ? target_width_
+        : format->display_area.right - format->display_area.left;
+    decoder_info_.ulTargetHeight = target_height_ > 0
+        ? target_height_
+        : format->display_area.bottom - format->display_area.top;
     decoder_info_.ulMaxWidth = static_cast<unsigned long>(max_width_);  // NOLINT
     decoder_info_.ulMaxHeight = static_cast<unsigned long>(max_height_);  // NOLINT
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -23,7 +23,12 @@ namespace dali {
 class CUVideoDecoder {
  public:
   CUVideoDecoder();
-  CUVideoDecoder(int, int, int);
+  /**
+   * @param target_height, target_width the size of the decoded frames, if they should be scaled
+   *                                     by the decoder; 0 keeps the size of the video
+   */
+  CUVideoDecoder(int max_height, int max_width, int additional_decode_surfaces,
+                 int target_height = 0, int target_width = 0);
   explicit CUVideoDecoder(CUvideodecoder);
   ~CUVideoDecoder();
 
@@ -51,6 +56,8 @@ class CUVideoDecoder {
   int max_height_;
   int max_width_;
   int additional_decode_surfaces_;
+  int target_height_;
+  int target_width_;
 };
 
 }  // namespace dali
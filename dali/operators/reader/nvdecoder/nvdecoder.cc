@@ -46,10 +46,13 @@ NvDecoder::NvDecoder(int device_id,
                      bool normalized,
                      int max_height,
                      int max_width,
-                     int additional_decode_surfaces)
+                     int additional_decode_surfaces,
+                     int output_height,
+                     int output_width)
     : device_id_(device_id),
       rgb_(image_type == DALI_RGB), dtype_(dtype), normalized_(normalized),
-      device_(), parser_(), decoder_(max_height, max_width, additional_decode_surfaces),
+      device_(), parser_(),
+      decoder_(max_height, max_width, additional_decode_surfaces, output_height, output_width),
       frame_in_use_(32),  // 32 is cuvid's max number of decode surfaces
       recv_queue_(), frame_queue_(),
       current_recv_(), req_ready_(VidReqStatus::REQ_READY), textures_(), stop_(false) {
@@ -122,6 +125,8 @@ NvDecoder::NvDecoder(int device_id,
       return;
   }
 
+  skip_non_reference_ = codec == Codec::H264 || codec == Codec::HEVC;
+
   parser_.init(codec, this, 20, codecpar->extradata,
                       codecpar->extradata_size);
   if (!parser_.initialized()) {
@@ -151,6 +156,7 @@ VidReqStatus NvDecoder::decode_av_packet(AVPacket* avpkt, int64_t start_time,
 
   DeviceGuard g(device_id_);
 
+  packet_frame_ = -1;
   if (avpkt && avpkt->size) {
       cupkt.payload_size = avpkt->size;
       cupkt.payload = avpkt->data;
@@ -161,6 +167,14 @@ VidReqStatus NvDecoder::decode_av_packet(AVPacket* avpkt, int64_t start_time,
         } else {
           cupkt.timestamp = avpkt->pts - start_time;
         }
+        if (skip_non_reference_ && decode_req_.frame_base.num && decode_req_.frame_base.den) {
+          // the same conversion as in handle_display_
+          packet_frame_ = av_rescale_q(cupkt.timestamp, nv_time_base_, decode_req_.frame_base);
+        }
+      }
+      if (skip_non_reference_) {
+        // the picture is decoded while its packet is parsed, so we know its frame number
+        cupkt.flags |= CUVID_PKT_ENDOFPICTURE;
       }
   } else {
       cupkt.flags = CUVID_PKT_ENDOFSTREAM;
@@ -218,6 +232,15 @@ int NvDecoder::handle_decode_(CUVIDPICPARAMS* pic_params) {
   // If something went wrong during init we exit directly
   if (stop_) return kNvcuvid_failure;
 
+  // A picture which is not a reference for other pictures and which is not displayed doesn't
+  // need to be decoded - with a large stride (or a keyframe far before the sequence)
+  // it's most of the B-frames. handle_display_ ditches it without mapping.
+  if (skip_non_reference_ && !pic_params->ref_pic_flag && packet_frame_ >= 0 &&
+      !is_requested_(packet_frame_)) {
+    LOG_LINE << "Skipping non-reference frame " << packet_frame_ << std::endl;
+    return kNvcuvid_success;
+  }
+
   while (frame_in_use_[pic_params->CurrPicIdx]) {
     if (enable_timeout &&
       total_wait++ > timeout_sec * 1000000 / sleep_period) {
@@ -401,14 +424,26 @@ VidReqStatus NvDecoder::decode_packet(AVPacket* pkt, int64_t start_time, AVRatio
 
 void NvDecoder::push_req(FrameReq req) {
   req_ready_ = VidReqStatus::REQ_NOT_STARTED;
+  // the packets of the request are parsed next, in the same thread
+  decode_req_ = req;
   recv_queue_.push(std::move(req));
 }
 
+bool NvDecoder::is_requested_(int64_t frame) const {
+  int64_t offset = frame - decode_req_.frame;
+  return offset >= 0 && offset < decode_req_.count && offset % decode_req_.stride == 0;
+}
+
 void NvDecoder::receive_frames(SequenceWrapper& sequence) {
-  LOG_LINE << "Sequence pushed with " << sequence.count << " frames" << std::endl;
+  receive_frames(sequence, 0, sequence.count);
+  finish_sequence(sequence);
+}
+
+void NvDecoder::receive_frames(SequenceWrapper& sequence, int first, int count) {
+  LOG_LINE << "Sequence pushed with " << count << " frames" << std::endl;
 
   DeviceGuard g(device_id_);
-  for (int i = 0; i < sequence.count; ++i) {
+  for (int i = first; i < first + count; ++i) {
       LOG_LINE << "popping frame (" << i << "/" << sequence.count << ") "
                << frame_queue_.size() << " reqs left" << std::endl;
 
@@ -422,6 +457,10 @@ void NvDecoder::receive_frames(SequenceWrapper& sequence) {
   }
   if (captured_exception_)
     std::rethrow_exception(captured_exception_);
+}
+
+void NvDecoder::finish_sequence(SequenceWrapper& sequence) {
+  DeviceGuard g(device_id_);
   if (sequence.count < sequence.max_count) {
     auto data_size = sequence.count * volume(sequence.frame_shape());
     auto pad_size = (sequence.max_count - sequence.count) * volume(sequence.frame_shape()) *
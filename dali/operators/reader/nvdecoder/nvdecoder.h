@@ -82,6 +82,10 @@ enum class VidReqStatus {
 
 class NvDecoder {
  public:
+  /**
+   * @param output_height, output_width the size of the output frames, if they should be scaled
+   *                                     by the hardware decoder; 0 keeps the size of the video
+   */
   NvDecoder(int device_id,
             const CodecParameters* codecpar,
             DALIImageType image_type,
@@ -89,7 +93,9 @@ class NvDecoder {
             bool normalized,
             int max_height,
             int max_width,
-            int additional_decode_surfaces);
+            int additional_decode_surfaces,
+            int output_height = 0,
+            int output_width = 0);
 
   // Some of the members are non-movable or non-copyable so the constructors below still end up
   // implicitly deleted, thus marking them explicitly deleted as this class in managed through
@@ -113,7 +119,24 @@ class NvDecoder {
 
   void push_req(FrameReq req);
 
-  void receive_frames(SequenceWrapper& batch);
+  void receive_frames(SequenceWrapper& sequence);
+
+  /**
+   * @brief Receives `count` frames of the sequence, starting with the frame `first`, without
+   *        finishing the sequence (see finish_sequence)
+   */
+  void receive_frames(SequenceWrapper& sequence, int first, int count);
+
+  /**
+   * @brief Pads the sequence, if it's shorter than max_count, and marks it as ready, once
+   *        the work issued in the decoder's stream completes
+   */
+  void finish_sequence(SequenceWrapper& sequence);
+
+  /// @brief The stream where the frames are converted to the output sequences
+  cudaStream_t stream() const noexcept {
+    return stream_;
+  }
 
   void finish();
 
@@ -122,6 +145,9 @@ class NvDecoder {
 
   void record_sequence_event_(SequenceWrapper& sequence);
 
+  /// @brief Whether the frame is displayed in the request, which is currently decoded
+  bool is_requested_(int64_t frame) const;
+
   // implem functions called in the callback
   int handle_sequence_(CUVIDEOFORMAT* format);
   int handle_decode_(CUVIDPICPARAMS* pic_params);
@@ -198,6 +224,13 @@ class NvDecoder {
   FrameReq current_recv_;
   VidReqStatus req_ready_;
 
+  // The request whose packets are being parsed and the frame number of the current packet
+  // (-1 if it has no timestamp) - used to skip the non-reference pictures, which are not
+  // displayed. It's enabled for the codecs where each packet is exactly one picture.
+  FrameReq decode_req_{};
+  int64_t packet_frame_ = -1;
+  bool skip_non_reference_ = false;
+
   using TexID = std::tuple<uint8_t*, ScaleMethod, uint16_t, uint16_t, unsigned int>;
 
   struct tex_hash {
@@ -0,0 +1,84 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/reader/nvdecoder/video_frame_cache.h"
+#include <string>
+#include <utility>
+#include "dali/core/cuda_error.h"
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+VideoFrameCache::VideoFrameCache(std::size_t capacity, cudaStream_t stream)
+: capacity_(capacity), stream_(stream) {
+  DALI_ENFORCE(capacity_ > 0, "The capacity of the frame cache must be positive");
+}
+
+bool VideoFrameCache::Read(const std::string &file, int frame, void *dst, std::size_t size,
+                           double &timestamp) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = cache_.find(Key{file, frame});
+  if (it == cache_.end() || it->second.size != size) {
+    stats_.misses++;
+    return false;
+  }
+  auto &entry = it->second;
+  lru_.splice(lru_.begin(), lru_, entry.lru_it);
+  CUDA_CALL(cudaMemcpyAsync(dst, entry.data.get(), size, cudaMemcpyDeviceToDevice, stream_));
+  timestamp = entry.timestamp;
+  stats_.hits++;
+  return true;
+}
+
+void VideoFrameCache::Add(const std::string &file, int frame, const void *src, std::size_t size,
+                          double timestamp) {
+  if (size > capacity_)
+    return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  Key key{file, frame};
+  auto it = cache_.find(key);
+  if (it != cache_.end())
+    Erase(it);
+
+  // the memory of the evicted frames is released in stream order, so it doesn't need to wait
+  // for the pending copies
+  while (stats_.size + size > capacity_) {
+    Erase(cache_.find(lru_.back()));
+    stats_.evictions++;
+  }
+
+  Entry entry;
+  entry.data = mm::alloc_raw_async_unique<uint8_t, mm::memory_kind::device>(size, stream_,
+                                                                              stream_);
+  entry.size = size;
+  entry.timestamp = timestamp;
+  CUDA_CALL(cudaMemcpyAsync(entry.data.get(), src, size, cudaMemcpyDeviceToDevice, stream_));
+  lru_.push_front(key);
+  entry.lru_it = lru_.begin();
+  cache_.emplace(std::move(key), std::move(entry));
+  stats_.size += size;
+}
+
+void VideoFrameCache::Erase(EntryMap::iterator it) {
+  stats_.size -= it->second.size;
+  lru_.erase(it->second.lru_it);
+  cache_.erase(it);
+}
+
+VideoFrameCache::Stats VideoFrameCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace dali
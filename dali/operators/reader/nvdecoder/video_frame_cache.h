@@ -0,0 +1,122 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_NVDECODER_VIDEO_FRAME_CACHE_H_
+#define DALI_OPERATORS_READER_NVDECODER_VIDEO_FRAME_CACHE_H_
+
+#include <cuda_runtime_api.h>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "dali/core/common.h"
+#include "dali/core/mm/memory.h"
+
+namespace dali {
+
+/**
+ * @brief A GPU cache of the decoded (and converted) video frames, identified by the file name
+ *        and the frame index
+ *
+ * It lets the video loader skip decoding the frames shared by overlapping sequences
+ * (when `step` is smaller than the span of a sequence) and the ones seen in the previous epochs.
+ * The least recently used frames are evicted when the total size of the frames exceeds
+ * the capacity.
+ *
+ * All the copies to and from the cache are issued in the stream given to the constructor, which
+ * must be the stream where the frames are decoded and consumed - so is the memory of the evicted
+ * frames released. The methods can be called concurrently.
+ */
+class DLL_PUBLIC VideoFrameCache {
+ public:
+  struct Stats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::size_t size = 0;  ///< the total size of the cached frames, in bytes
+  };
+
+  /**
+   * @param capacity the maximum total size of the cached frames, in bytes
+   * @param stream   the stream, in which the frames are copied
+   */
+  DLL_PUBLIC VideoFrameCache(std::size_t capacity, cudaStream_t stream);
+
+  DISABLE_COPY_MOVE_ASSIGN(VideoFrameCache);
+
+  /**
+   * @brief Copies the cached frame to `dst`
+   *
+   * @param size the expected size of the frame
+   * @param timestamp receives the timestamp of the frame
+   * @return false, if the frame is not cached or its size differs
+   */
+  DLL_PUBLIC bool Read(const std::string &file, int frame, void *dst, std::size_t size,
+                       double &timestamp);
+
+  /**
+   * @brief Copies a frame from the device memory `src` to the cache, evicting the least recently
+   *        used frames, if needed
+   *
+   * Frames larger than the capacity are not cached. A frame that is already cached is replaced.
+   */
+  DLL_PUBLIC void Add(const std::string &file, int frame, const void *src, std::size_t size,
+                      double timestamp);
+
+  DLL_PUBLIC Stats GetStats() const;
+
+  std::size_t capacity() const noexcept { return capacity_; }
+
+ private:
+  struct Key {
+    std::string file;
+    int frame;
+
+    bool operator==(const Key &other) const {
+      return frame == other.frame && file == other.file;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key &key) const {
+      return std::hash<std::string>()(key.file) * 0x9e3779b97f4a7c15ull ^
+             std::hash<int>()(key.frame);
+    }
+  };
+
+  struct Entry {
+    mm::async_uptr<uint8_t> data;
+    std::size_t size;
+    double timestamp;
+    std::list<Key>::iterator lru_it;
+  };
+
+  using EntryMap = std::unordered_map<Key, Entry, KeyHash>;
+
+  /// @brief Removes the frame from the cache; requires mutex_ to be held
+  void Erase(EntryMap::iterator it);
+
+  std::size_t capacity_;
+  cudaStream_t stream_;
+  mutable std::mutex mutex_;
+  EntryMap cache_;
+  std::list<Key> lru_;  // the most recently used first
+  Stats stats_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_NVDECODER_VIDEO_FRAME_CACHE_H_
@@ -0,0 +1,106 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "dali/core/cuda_error.h"
+#include "dali/core/cuda_stream.h"
+#include "dali/core/mm/memory.h"
+#include "dali/operators/reader/nvdecoder/video_frame_cache.h"
+
+namespace dali {
+
+class VideoFrameCacheTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kFrameSize = 1000;
+
+  void SetUp() override {
+    stream_ = CUDAStream::Create(true);
+    frame_ = mm::alloc_raw_unique<uint8_t, mm::memory_kind::device>(kFrameSize);
+    out_ = mm::alloc_raw_unique<uint8_t, mm::memory_kind::device>(kFrameSize);
+  }
+
+  /// @brief Fills the device buffer with `value` and adds it to the cache as the given frame
+  void AddFrame(VideoFrameCache &cache, const std::string &file, int frame, uint8_t value) {
+    CUDA_CALL(cudaMemsetAsync(frame_.get(), value, kFrameSize, stream_));
+    cache.Add(file, frame, frame_.get(), kFrameSize, frame * 0.5);
+  }
+
+  /// @return the first byte of the cached frame or -1, if it's not cached
+  int ReadFrame(VideoFrameCache &cache, const std::string &file, int frame) {
+    double timestamp = -1;
+    if (!cache.Read(file, frame, out_.get(), kFrameSize, timestamp))
+      return -1;
+    EXPECT_EQ(timestamp, frame * 0.5);
+    std::vector<uint8_t> host(kFrameSize);
+    CUDA_CALL(cudaMemcpyAsync(host.data(), out_.get(), kFrameSize, cudaMemcpyDeviceToHost,
+                              stream_));
+    CUDA_CALL(cudaStreamSynchronize(stream_));
+    for (auto x : host)
+      EXPECT_EQ(x, host[0]);
+    return host[0];
+  }
+
+  CUDAStream stream_;
+  mm::uptr<uint8_t> frame_, out_;
+};
+
+TEST_F(VideoFrameCacheTest, HitsAndMisses) {
+  VideoFrameCache cache(10 * kFrameSize, stream_);
+  AddFrame(cache, "a.mp4", 0, 1);
+  AddFrame(cache, "a.mp4", 1, 2);
+  AddFrame(cache, "b.mp4", 0, 3);
+  EXPECT_EQ(ReadFrame(cache, "a.mp4", 0), 1);
+  EXPECT_EQ(ReadFrame(cache, "a.mp4", 1), 2);
+  EXPECT_EQ(ReadFrame(cache, "b.mp4", 0), 3);
+  EXPECT_EQ(ReadFrame(cache, "b.mp4", 1), -1);
+
+  double timestamp;
+  // the size must match
+  EXPECT_FALSE(cache.Read("a.mp4", 0, out_.get(), kFrameSize / 2, timestamp));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 3u);
+  EXPECT_EQ(stats.misses, 2u);
+  EXPECT_EQ(stats.size, 3 * kFrameSize);
+
+  // replacing a frame doesn't change the size
+  AddFrame(cache, "a.mp4", 0, 4);
+  EXPECT_EQ(ReadFrame(cache, "a.mp4", 0), 4);
+  EXPECT_EQ(cache.GetStats().size, 3 * kFrameSize);
+}
+
+TEST_F(VideoFrameCacheTest, Eviction) {
+  VideoFrameCache cache(3 * kFrameSize, stream_);
+  AddFrame(cache, "a.mp4", 0, 10);
+  AddFrame(cache, "a.mp4", 1, 11);
+  AddFrame(cache, "a.mp4", 2, 12);
+  EXPECT_EQ(ReadFrame(cache, "a.mp4", 0), 10);  // frame 1 is now the least recently used
+  AddFrame(cache, "a.mp4", 3, 13);
+  EXPECT_EQ(ReadFrame(cache, "a.mp4", 1), -1);
+  EXPECT_EQ(ReadFrame(cache, "a.mp4", 0), 10);
+  EXPECT_EQ(ReadFrame(cache, "a.mp4", 2), 12);
+  EXPECT_EQ(ReadFrame(cache, "a.mp4", 3), 13);
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_EQ(stats.size, 3 * kFrameSize);
+
+  // too large to be cached at all
+  auto big = mm::alloc_raw_unique<uint8_t, mm::memory_kind::device>(4 * kFrameSize);
+  cache.Add("b.mp4", 0, big.get(), 4 * kFrameSize, 0);
+  EXPECT_EQ(cache.GetStats().evictions, 1u);
+  CUDA_CALL(cudaStreamSynchronize(stream_));
+}
+
+}  // namespace dali
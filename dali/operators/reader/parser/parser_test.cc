@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <cstring>
 #include <memory>
 #include <vector>
 
@@ -23,6 +24,7 @@
 #include "dali/test/dali_test.h"
 #include "dali/pipeline/workspace/sample_workspace.h"
 #include "dali/operators/reader/parser/parser.h"
+#include "dali/operators/reader/parser/recordio_parser.h"
 
 namespace dali {
 
@@ -85,5 +87,99 @@ TYPED_TEST(ParserTest, BasicTest) {
   parser.Parse(ia_wrapper, &ws);
 }
 
+namespace {
+
+constexpr uint32_t kRecordIOMagic = 0xced7230a;
+
+template <typename T>
+void AppendBytes(std::vector<uint8_t> &out, const T *data, size_t size) {
+  auto *bytes = reinterpret_cast<const uint8_t *>(data);
+  out.insert(out.end(), bytes, bytes + size);
+}
+
+void AppendRecordPart(std::vector<uint8_t> &record, uint32_t cflag,
+                      const std::vector<uint8_t> &data) {
+  uint32_t length_flag = (cflag << 29U) | static_cast<uint32_t>(data.size());
+  AppendBytes(record, &kRecordIOMagic, sizeof(kRecordIOMagic));
+  AppendBytes(record, &length_flag, sizeof(length_flag));
+  AppendBytes(record, data.data(), data.size());
+  record.resize(align_up(record.size(), 4), 0);
+}
+
+void ParseRecordIO(const std::vector<uint8_t> &record, Tensor<CPUBackend> &image,
+                   Tensor<CPUBackend> &label) {
+  HostWorkspace workspace;
+  SampleWorkspace ws;
+  MakeSampleView(ws, workspace, 0, 0);
+  ws.AddOutput(&image);
+  ws.AddOutput(&label);
+
+  Tensor<CPUBackend> data;
+  data.Resize({static_cast<int64_t>(record.size())}, DALI_UINT8);
+  std::memcpy(data.mutable_data<uint8_t>(), record.data(), record.size());
+  RecordIOParser parser(OpSpec("temp"));
+  parser.Parse(data, &ws);
+}
+
+}  // namespace
+
+TEST(RecordIOParserTest, SinglePartRecord) {
+  ImageRecordIOHeader hdr = {0, 7.0f, {0, 0}};
+  std::vector<uint8_t> payload;
+  AppendBytes(payload, &hdr, sizeof(hdr));
+  std::vector<uint8_t> image_data = {1, 2, 3, 4, 5};
+  payload.insert(payload.end(), image_data.begin(), image_data.end());
+  std::vector<uint8_t> record;
+  AppendRecordPart(record, 0, payload);
+
+  Tensor<CPUBackend> image, label;
+  ParseRecordIO(record, image, label);
+  ASSERT_EQ(label.shape(), TensorShape<>(1));
+  EXPECT_EQ(label.data<float>()[0], 7.0f);
+  ASSERT_EQ(image.shape(), TensorShape<>(static_cast<int64_t>(image_data.size())));
+  EXPECT_EQ(std::memcmp(image.data<uint8_t>(), image_data.data(), image_data.size()), 0);
+}
+
+TEST(RecordIOParserTest, MultiPartRecord) {
+  // the writer splits the record at the occurrences of the magic number and drops them
+  ImageRecordIOHeader hdr = {2, 0.0f, {0, 0}};
+  float labels[2] = {1.5f, 2.5f};
+  std::vector<uint8_t> first;
+  AppendBytes(first, &hdr, sizeof(hdr));
+  AppendBytes(first, labels, sizeof(labels));
+  first.insert(first.end(), {1, 2, 3, 4, 5});
+  std::vector<uint8_t> middle = {6, 7};
+  std::vector<uint8_t> last = {8, 9, 10};
+  std::vector<uint8_t> record;
+  AppendRecordPart(record, 1, first);
+  AppendRecordPart(record, 2, middle);
+  AppendRecordPart(record, 3, last);
+
+  std::vector<uint8_t> ref = {1, 2, 3, 4, 5};
+  AppendBytes(ref, &kRecordIOMagic, sizeof(kRecordIOMagic));
+  ref.insert(ref.end(), middle.begin(), middle.end());
+  AppendBytes(ref, &kRecordIOMagic, sizeof(kRecordIOMagic));
+  ref.insert(ref.end(), last.begin(), last.end());
+
+  Tensor<CPUBackend> image, label;
+  ParseRecordIO(record, image, label);
+  ASSERT_EQ(label.shape(), TensorShape<>(2));
+  EXPECT_EQ(label.data<float>()[0], labels[0]);
+  EXPECT_EQ(label.data<float>()[1], labels[1]);
+  ASSERT_EQ(image.shape(), TensorShape<>(static_cast<int64_t>(ref.size())));
+  EXPECT_EQ(std::memcmp(image.data<uint8_t>(), ref.data(), ref.size()), 0);
+}
+
+TEST(RecordIOParserTest, TruncatedRecord) {
+  ImageRecordIOHeader hdr = {0, 0.0f, {0, 0}};
+  std::vector<uint8_t> payload;
+  AppendBytes(payload, &hdr, sizeof(hdr));
+  std::vector<uint8_t> record;
+  AppendRecordPart(record, 1, payload);
+
+  Tensor<CPUBackend> image, label;
+  EXPECT_THROW(ParseRecordIO(record, image, label), std::runtime_error);
+}
+
 
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,9 +15,11 @@
 #ifndef DALI_OPERATORS_READER_PARSER_RECORDIO_PARSER_H_
 #define DALI_OPERATORS_READER_PARSER_RECORDIO_PARSER_H_
 
+#include <algorithm>
 #include <string>
-#include <vector>
 
+#include "dali/core/small_vector.h"
+#include "dali/core/util.h"
 #include "dali/operators/reader/parser/parser.h"
 
 namespace dali {
@@ -37,11 +39,21 @@ class RecordIOParser : public Parser<Tensor<CPUBackend>> {
   void Parse(const Tensor<CPUBackend>& data, SampleWorkspace* ws) override {
     auto& image = ws->Output<CPUBackend>(0);
     auto& label = ws->Output<CPUBackend>(1);
-    ReadSingleImageRecordIO(image, label, data.data<uint8_t>());
+    ReadSingleImageRecordIO(image, label, data.data<uint8_t>(), data.nbytes());
     image.SetSourceInfo(data.GetSourceInfo());
   }
 
  private:
+  static constexpr uint32_t kMagic = 0xced7230a;
+
+  /**
+   * @brief A part of a record - the data between the part headers, without the padding
+   */
+  struct RecordPart {
+    const uint8_t *data;
+    int64_t length;
+  };
+
   inline uint32_t DecodeFlag(uint32_t rec) {
     return (rec >> 29U) & 7U;
   }
@@ -56,71 +68,94 @@ class RecordIOParser : public Parser<Tensor<CPUBackend>> {
     *in += sizeof(T);
   }
 
+  /**
+   * @brief Walks the headers of the parts of the record, without touching their data
+   *
+   * A record which contains the magic number is split by the writer at each of its occurrences
+   * into a part with the flag 1, followed by the parts with the flag 2 and the last one with 3;
+   * a single-part record has the flag 0. Each part is padded to a multiple of 4 bytes.
+   */
+  template <typename Parts>
+  void LocateParts(Parts& parts, const uint8_t* input, int64_t size) {
+    int64_t offset = 0;
+    uint32_t cflag;
+    do {
+      DALI_ENFORCE(size - offset >= 2 * static_cast<int64_t>(sizeof(uint32_t)),
+                   "Invalid RecordIO: truncated record");
+      const uint8_t* header = input + offset;
+      uint32_t magic, length_flag;
+      ReadSingle(&header, &magic);
+      DALI_ENFORCE(magic == kMagic, "Invalid RecordIO: wrong magic number");
+      ReadSingle(&header, &length_flag);
+      cflag = DecodeFlag(length_flag);
+      int64_t clength = DecodeLength(length_flag);
+      offset += 2 * sizeof(uint32_t);
+      DALI_ENFORCE(clength <= size - offset, "Invalid RecordIO: truncated record");
+      DALI_ENFORCE(parts.empty() ? cflag == 0 || cflag == 1 : cflag == 2 || cflag == 3,
+                   "Invalid RecordIO: wrong order of the parts of a record");
+      parts.push_back({input + offset, clength});
+      offset += align_up(clength, 4);
+    } while (cflag == 1 || cflag == 2);
+  }
+
+  /**
+   * @brief Reassembles the record in one pass, directly to the label and the image outputs
+   *
+   * The total size is known from the part headers, so that the outputs are allocated once
+   * and the data of each part is copied only once.
+   */
   inline void ReadSingleImageRecordIO(Tensor<CPUBackend>& o_image,
                 Tensor<CPUBackend>& o_label,
-                const uint8_t* input) {
-    uint32_t magic;
-    const uint32_t kMagic = 0xced7230a;
-    ReadSingle<uint32_t>(&input, &magic);
-    DALI_ENFORCE(magic == kMagic, "Invalid RecordIO: wrong magic number");
-
-    uint32_t length_flag;
-    ReadSingle(&input, &length_flag);
-    uint32_t cflag = DecodeFlag(length_flag);
-    uint32_t clength = DecodeLength(length_flag);
+                const uint8_t* input, int64_t size) {
+    // the records are parsed in parallel, so the list of the parts is kept on the stack
+    SmallVector<RecordPart, 4> parts;
+    LocateParts(parts, input, size);
+
+    DALI_ENFORCE(parts[0].length >= static_cast<int64_t>(sizeof(ImageRecordIOHeader)),
+                 "Invalid RecordIO: the record is too short to contain the header");
     ImageRecordIOHeader hdr;
-    ReadSingle(&input, &hdr);
+    const uint8_t* first = parts[0].data;
+    ReadSingle(&first, &hdr);
+
+    // the magic numbers removed by the writer are put back between the parts
+    int64_t data_size = -static_cast<int64_t>(sizeof(ImageRecordIOHeader));
+    for (auto& part : parts)
+      data_size += part.length;
+    data_size += (parts.size() - 1) * sizeof(kMagic);
+    int64_t label_size = hdr.flag * sizeof(float);
+    DALI_ENFORCE(label_size <= data_size,
+                 "Invalid RecordIO: the record is too short to contain the labels");
+    int64_t image_size = data_size - label_size;
 
+    uint8_t* label = nullptr;
     if (hdr.flag == 0) {
       o_label.Resize({1}, DALI_FLOAT);
       o_label.mutable_data<float>()[0] = hdr.label;
     } else {
       o_label.Resize({hdr.flag}, DALI_FLOAT);
+      label = reinterpret_cast<uint8_t*>(o_label.mutable_data<float>());
     }
-
-    int64_t data_size = clength - sizeof(ImageRecordIOHeader);
-    int64_t label_size = hdr.flag * sizeof(float);
-    int64_t image_size = data_size - label_size;
-    if (cflag == 0) {
-      o_image.Resize({image_size}, DALI_UINT8);
-      uint8_t* data = o_image.mutable_data<uint8_t>();
-      memcpy(data, input + label_size, image_size);
-      if (hdr.flag > 0) {
-        float * label = o_label.mutable_data<float>();
-        memcpy(label, input, label_size);
-      }
-    } else {
-      std::vector<uint8_t> temp_vec(data_size);
-      memcpy(&temp_vec[0], input, data_size);
-      input += data_size;
-
-      while (true) {
-        size_t pad = clength - (((clength + 3U) >> 2U) << 2U);
-        input += pad;
-
-        if (cflag != 3) {
-          size_t s = temp_vec.size();
-          temp_vec.resize(static_cast<int64_t>(s + sizeof(kMagic)));
-          memcpy(&temp_vec[s], &kMagic, sizeof(kMagic));
-        } else {
-          break;
-        }
-        ReadSingle(&input, &magic);
-        ReadSingle(&input, &length_flag);
-        cflag = DecodeFlag(length_flag);
-        clength = DecodeLength(length_flag);
-        size_t s = temp_vec.size();
-        temp_vec.resize(static_cast<int64_t>(s + clength));
-        memcpy(&temp_vec[s], input, clength);
-        input += clength;
-      }
-      o_image.Resize({static_cast<Index>(temp_vec.size() - label_size)}, DALI_UINT8);
-      uint8_t* data = o_image.mutable_data<uint8_t>();
-      memcpy(data, (&temp_vec[0]) + label_size, temp_vec.size() - label_size);
-      if (hdr.flag > 0) {
-        float * label = o_label.mutable_data<float>();
-        memcpy(label, &temp_vec[0], label_size);
+    o_image.Resize({image_size}, DALI_UINT8);
+    uint8_t* image = o_image.mutable_data<uint8_t>();
+
+    // the labels come first, followed by the image
+    int64_t pos = 0;
+    auto emit = [&](const uint8_t* src, int64_t n) {
+      if (pos < label_size) {
+        int64_t k = std::min(n, label_size - pos);
+        memcpy(label + pos, src, k);
+        src += k;
+        n -= k;
+        pos += k;
       }
+      memcpy(image + pos - label_size, src, n);
+      pos += n;
+    };
+    const uint32_t magic = kMagic;
+    emit(first, parts[0].length - sizeof(ImageRecordIOHeader));
+    for (size_t i = 1; i < parts.size(); i++) {
+      emit(reinterpret_cast<const uint8_t*>(&magic), sizeof(magic));
+      emit(parts[i].data, parts[i].length);
     }
   }
 };
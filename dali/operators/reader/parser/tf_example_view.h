@@ -0,0 +1,386 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_PARSER_TF_EXAMPLE_VIEW_H_
+#define DALI_OPERATORS_READER_PARSER_TF_EXAMPLE_VIEW_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "dali/core/small_vector.h"
+#include "dali/core/span.h"
+
+namespace dali {
+namespace TFUtil {
+
+/**
+ * @brief Reads the features of a serialized `tensorflow.Example` directly from the protobuf
+ *        wire format, without building the message.
+ *
+ * Only the requested features are looked up; their values are referenced in the serialized
+ * data (which must outlive the view) and decoded only when copied to the output.
+ *
+ * The relevant parts of the schema are:
+ * ```
+ * message Example { Features features = 1; }
+ * message Features { map<string, Feature> feature = 1; }
+ * message Feature {
+ *   oneof kind { BytesList bytes_list = 1; FloatList float_list = 2; Int64List int64_list = 3; }
+ * }
+ * message BytesList { repeated bytes value = 1; }
+ * message FloatList { repeated float value = 1 [packed = true]; }
+ * message Int64List { repeated int64 value = 1 [packed = true]; }
+ * ```
+ * The parser follows the protobuf rules for repeated occurrences: the last map entry with a given
+ * key wins, the occurrences of a list of the same kind are concatenated and a list of another
+ * kind replaces the previous ones.
+ */
+class ExampleView {
+ public:
+  enum ListKind : uint8_t {
+    kNone = 0,
+    kBytes = 1,
+    kFloat = 2,
+    kInt64 = 3,
+  };
+
+  class FeatureView {
+   public:
+    bool found() const noexcept {
+      return found_;
+    }
+
+    ListKind kind() const noexcept {
+      return kind_;
+    }
+
+    /// The number of int64 values; 0 if the feature is not an int64 list
+    int64_t int64_count() const {
+      int64_t n = 0;
+      ForEachValue(kInt64, [&](int wire_type, span<const uint8_t> value) {
+        n += wire_type == kLengthDelimited ? CountVarints(value) : 1;
+      });
+      return n;
+    }
+
+    /// The number of float values; 0 if the feature is not a float list
+    int64_t float_count() const {
+      int64_t n = 0;
+      ForEachValue(kFloat, [&](int wire_type, span<const uint8_t> value) {
+        n += value.size() / sizeof(float);
+      });
+      return n;
+    }
+
+    /// The number of byte strings; 0 if the feature is not a bytes list
+    int64_t bytes_count() const {
+      int64_t n = 0;
+      ForEachValue(kBytes, [&](int, span<const uint8_t>) { n++; });
+      return n;
+    }
+
+    /// Decodes the int64 values to `out`, which must hold at least int64_count() elements
+    void CopyInt64(int64_t *out) const {
+      ForEachValue(kInt64, [&](int wire_type, span<const uint8_t> value) {
+        const uint8_t *p = value.data(), *end = p + value.size();
+        uint64_t v;
+        while (p < end && ReadVarint(p, end, v))
+          *out++ = static_cast<int64_t>(v);
+      });
+    }
+
+    /// Copies the float values to `out`, which must hold at least float_count() elements
+    void CopyFloat(float *out) const {
+      ForEachValue(kFloat, [&](int, span<const uint8_t> value) {
+        std::memcpy(out, value.data(), value.size());  // the wire format is little-endian
+        out += value.size() / sizeof(float);
+      });
+    }
+
+    /// Returns the i-th byte string, referenced in the serialized example
+    span<const uint8_t> bytes(int64_t i) const {
+      span<const uint8_t> ret;
+      ForEachValue(kBytes, [&](int, span<const uint8_t> value) {
+        if (i-- == 0)
+          ret = value;
+      });
+      return ret;
+    }
+
+   private:
+    friend class ExampleView;
+
+    void Reset() {
+      found_ = false;
+      kind_ = kNone;
+      lists_.clear();
+    }
+
+    void AddList(ListKind kind, span<const uint8_t> list) {
+      if (kind != kind_)
+        lists_.clear();
+      kind_ = kind;
+      lists_.push_back(list);
+    }
+
+    /**
+     * @brief Calls `fn(wire_type, value)` for each value field of the lists, if they have
+     *        the requested kind.
+     *
+     * The lists were validated when the example was parsed.
+     */
+    template <typename Fn>
+    void ForEachValue(ListKind kind, Fn &&fn) const {
+      if (kind != kind_)
+        return;
+      for (auto list : lists_) {
+        const uint8_t *p = list.data(), *end = p + list.size();
+        while (p < end) {
+          Field field;
+          ReadField(p, end, field);
+          if (field.number == 1)
+            fn(field.wire_type, field.value);
+        }
+      }
+    }
+
+    bool found_ = false;
+    ListKind kind_ = kNone;
+    SmallVector<span<const uint8_t>, 1> lists_;
+  };
+
+  /**
+   * @brief Finds the features with the given names in a serialized Example.
+   *
+   * @return false, if the data is not a valid serialized Example
+   */
+  bool Parse(const uint8_t *data, size_t size, const std::vector<std::string> &names) {
+    features_.resize(names.size());
+    for (auto &f : features_)
+      f.Reset();
+    const uint8_t *end = data + size;
+    // Example
+    while (data < end) {
+      Field features;
+      if (!ReadField(data, end, features))
+        return false;
+      if (features.number != 1)
+        continue;
+      if (features.wire_type != kLengthDelimited)
+        return false;
+      // Features
+      const uint8_t *p = features.value.data(), *features_end = p + features.value.size();
+      while (p < features_end) {
+        Field entry;
+        if (!ReadField(p, features_end, entry))
+          return false;
+        if (entry.number != 1)
+          continue;
+        if (entry.wire_type != kLengthDelimited || !ParseEntry(entry.value, names))
+          return false;
+      }
+    }
+    return true;
+  }
+
+  const FeatureView &feature(int idx) const {
+    return features_[idx];
+  }
+
+ private:
+  static constexpr int kVarint = 0;
+  static constexpr int kFixed64 = 1;
+  static constexpr int kLengthDelimited = 2;
+  static constexpr int kFixed32 = 5;
+
+  struct Field {
+    uint32_t number = 0;
+    int wire_type = 0;
+    span<const uint8_t> value;  // for varints - the encoded varint
+  };
+
+  /**
+   * @brief Reads a varint and advances `p` past it.
+   *
+   * @return false, if the varint is malformed or doesn't fit in the data
+   */
+  static bool ReadVarint(const uint8_t *&p, const uint8_t *end, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+      uint8_t byte = *p++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  static int64_t CountVarints(span<const uint8_t> data) {
+    int64_t n = 0;
+    for (uint8_t byte : data)
+      n += !(byte & 0x80);
+    return n;
+  }
+
+  /**
+   * @brief Reads a field and advances `p` past it.
+   *
+   * @return false, if the field is malformed or doesn't fit in the data
+   */
+  static bool ReadField(const uint8_t *&p, const uint8_t *end, Field &field) {
+    uint64_t tag, length;
+    if (!ReadVarint(p, end, tag))
+      return false;
+    field.number = tag >> 3;
+    field.wire_type = tag & 7;
+    const uint8_t *start = p;
+    switch (field.wire_type) {
+      case kVarint:
+        if (!ReadVarint(p, end, length))
+          return false;
+        length = p - start;
+        break;
+      case kFixed64:
+        length = 8;
+        break;
+      case kLengthDelimited:
+        if (!ReadVarint(p, end, length))
+          return false;
+        start = p;
+        break;
+      case kFixed32:
+        length = 4;
+        break;
+      default:
+        return false;  // groups are not used by the Example schema
+    }
+    if (length > static_cast<uint64_t>(end - start))
+      return false;
+    field.value = make_span(start, length);
+    p = start + length;
+    return true;
+  }
+
+  /**
+   * @brief Checks that all the value fields of a list are well formed.
+   */
+  static bool ValidateList(ListKind kind, span<const uint8_t> list) {
+    const uint8_t *p = list.data(), *end = p + list.size();
+    while (p < end) {
+      Field field;
+      if (!ReadField(p, end, field))
+        return false;
+      if (field.number != 1)
+        continue;
+      switch (kind) {
+        case kBytes:
+          if (field.wire_type != kLengthDelimited)
+            return false;
+          break;
+        case kFloat:
+          if (field.wire_type == kLengthDelimited) {
+            if (field.value.size() % sizeof(float))
+              return false;
+          } else if (field.wire_type != kFixed32) {
+            return false;
+          }
+          break;
+        case kInt64:
+          if (field.wire_type == kLengthDelimited) {
+            // the packed list must consist of valid varints only
+            const uint8_t *vp = field.value.data(), *vend = vp + field.value.size();
+            uint64_t v;
+            while (vp < vend) {
+              if (!ReadVarint(vp, vend, v))
+                return false;
+            }
+          } else if (field.wire_type != kVarint) {
+            return false;
+          }
+          break;
+        default:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Parses a `map<string, Feature>` entry; if the key is one of the requested names,
+   *        stores its lists.
+   */
+  bool ParseEntry(span<const uint8_t> entry, const std::vector<std::string> &names) {
+    span<const uint8_t> key;
+    SmallVector<span<const uint8_t>, 1> values;
+    const uint8_t *p = entry.data(), *end = p + entry.size();
+    while (p < end) {
+      Field field;
+      if (!ReadField(p, end, field))
+        return false;
+      if (field.number == 1 || field.number == 2) {
+        if (field.wire_type != kLengthDelimited)
+          return false;
+        if (field.number == 1)
+          key = field.value;
+        else
+          values.push_back(field.value);
+      }
+    }
+
+    int idx = -1;
+    for (int i = 0, n = names.size(); i < n; i++) {
+      if (names[i].size() == static_cast<size_t>(key.size()) &&
+          std::memcmp(names[i].data(), key.data(), key.size()) == 0) {
+        idx = i;
+        break;
+      }
+    }
+    if (idx < 0)
+      return true;  // not requested - skip without looking into the value
+
+    // a repeated entry replaces the previous one
+    FeatureView &feature = features_[idx];
+    feature.Reset();
+    feature.found_ = true;
+    for (auto value : values) {
+      // Feature
+      const uint8_t *vp = value.data(), *vend = vp + value.size();
+      while (vp < vend) {
+        Field list;
+        if (!ReadField(vp, vend, list))
+          return false;
+        if (list.number < kBytes || list.number > kInt64)
+          continue;
+        auto kind = static_cast<ListKind>(list.number);
+        if (list.wire_type != kLengthDelimited || !ValidateList(kind, list.value))
+          return false;
+        feature.AddList(kind, list.value);
+      }
+    }
+    // the same feature may be requested more than once
+    for (int i = idx + 1, n = names.size(); i < n; i++) {
+      if (names[i] == names[idx])
+        features_[i] = feature;
+    }
+    return true;
+  }
+
+  std::vector<FeatureView> features_;
+};
+
+}  // namespace TFUtil
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_PARSER_TF_EXAMPLE_VIEW_H_
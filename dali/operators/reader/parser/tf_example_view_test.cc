@@ -0,0 +1,183 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/reader/parser/tf_example_view.h"  // NOLINT
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace dali {
+namespace TFUtil {
+namespace test {
+
+namespace {
+
+/**
+ * @brief A minimal encoder of the protobuf wire format, used to build the test examples.
+ */
+struct Encoder {
+  std::string buf;
+
+  Encoder &Varint(uint64_t v) {
+    do {
+      uint8_t byte = v & 0x7f;
+      v >>= 7;
+      buf += static_cast<char>(v ? byte | 0x80 : byte);
+    } while (v);
+    return *this;
+  }
+
+  Encoder &Tag(int number, int wire_type) {
+    return Varint(number << 3 | wire_type);
+  }
+
+  Encoder &Bytes(int number, const std::string &data) {
+    Tag(number, 2).Varint(data.size());
+    buf += data;
+    return *this;
+  }
+
+  Encoder &Fixed32(int number, float f) {
+    Tag(number, 5);
+    char raw[4];
+    std::memcpy(raw, &f, 4);
+    buf.append(raw, 4);
+    return *this;
+  }
+};
+
+std::string PackedInt64(const std::vector<int64_t> &values) {
+  Encoder packed;
+  for (auto v : values)
+    packed.Varint(static_cast<uint64_t>(v));
+  return Encoder().Bytes(1, packed.buf).buf;
+}
+
+std::string PackedFloat(const std::vector<float> &values) {
+  std::string packed(values.size() * sizeof(float), '\0');
+  std::memcpy(&packed[0], values.data(), packed.size());
+  return Encoder().Bytes(1, packed).buf;
+}
+
+/// A map entry of `Features.feature` with a list of given kind
+std::string Entry(const std::string &key, int kind, const std::string &list) {
+  std::string feature = Encoder().Bytes(kind, list).buf;
+  return Encoder().Bytes(1, key).Bytes(2, feature).buf;
+}
+
+std::string MakeExample(const std::vector<std::string> &entries) {
+  Encoder features;
+  for (auto &e : entries)
+    features.Bytes(1, e);
+  return Encoder().Bytes(1, features.buf).buf;
+}
+
+bool Parse(ExampleView &view, const std::string &data, const std::vector<std::string> &names) {
+  return view.Parse(reinterpret_cast<const uint8_t *>(data.data()), data.size(), names);
+}
+
+}  // namespace
+
+TEST(TFExampleView, Features) {
+  std::string image(200000, 'x');
+  image[12345] = 'y';
+  std::string data = MakeExample({
+    Entry("image/encoded", ExampleView::kBytes, Encoder().Bytes(1, image).buf),
+    Entry("unused", ExampleView::kInt64, PackedInt64({ 1, 2, 3 })),
+    Entry("label", ExampleView::kInt64, PackedInt64({ 7, -1, 1LL << 40 })),
+    Entry("bbox", ExampleView::kFloat, PackedFloat({ 0.25f, 0.5f, 0.75f, 1.0f })),
+  });
+
+  ExampleView view;
+  ASSERT_TRUE(Parse(view, data, { "label", "image/encoded", "missing", "bbox" }));
+
+  auto &label = view.feature(0);
+  ASSERT_TRUE(label.found());
+  EXPECT_EQ(label.kind(), ExampleView::kInt64);
+  ASSERT_EQ(label.int64_count(), 3);
+  EXPECT_EQ(label.float_count(), 0) << "The feature is not a float list";
+  int64_t labels[3];
+  label.CopyInt64(labels);
+  EXPECT_EQ(labels[0], 7);
+  EXPECT_EQ(labels[1], -1);
+  EXPECT_EQ(labels[2], 1LL << 40);
+
+  auto &encoded = view.feature(1);
+  ASSERT_EQ(encoded.bytes_count(), 1);
+  auto bytes = encoded.bytes(0);
+  ASSERT_EQ(static_cast<size_t>(bytes.size()), image.size());
+  EXPECT_EQ(std::string(reinterpret_cast<const char *>(bytes.data()), bytes.size()), image);
+  EXPECT_GE(reinterpret_cast<const char *>(bytes.data()), data.data())
+      << "The value should point into the serialized data";
+  EXPECT_LT(reinterpret_cast<const char *>(bytes.data()), data.data() + data.size());
+
+  EXPECT_FALSE(view.feature(2).found());
+
+  auto &bbox = view.feature(3);
+  ASSERT_EQ(bbox.float_count(), 4);
+  float box[4];
+  bbox.CopyFloat(box);
+  EXPECT_EQ(box[0], 0.25f);
+  EXPECT_EQ(box[3], 1.0f);
+}
+
+TEST(TFExampleView, UnpackedAndRepeated) {
+  std::string unpacked_ints = Encoder().Tag(1, 0).Varint(5).Tag(1, 0).Varint(6).buf;
+  std::string unpacked_floats = Encoder().Fixed32(1, 1.5f).Fixed32(1, 2.5f).buf;
+  std::string data = MakeExample({
+    Entry("ints", ExampleView::kInt64, unpacked_ints),
+    Entry("floats", ExampleView::kFloat, unpacked_floats),
+    Entry("replaced", ExampleView::kInt64, PackedInt64({ 1 })),
+    Entry("replaced", ExampleView::kFloat, PackedFloat({ 3.0f })),
+  });
+
+  ExampleView view;
+  ASSERT_TRUE(Parse(view, data, { "ints", "floats", "replaced", "ints" }));
+  int64_t ints[2];
+  ASSERT_EQ(view.feature(0).int64_count(), 2);
+  view.feature(0).CopyInt64(ints);
+  EXPECT_EQ(ints[0], 5);
+  EXPECT_EQ(ints[1], 6);
+  EXPECT_EQ(view.feature(3).int64_count(), 2) << "A feature can be requested more than once";
+
+  float floats[2];
+  ASSERT_EQ(view.feature(1).float_count(), 2);
+  view.feature(1).CopyFloat(floats);
+  EXPECT_EQ(floats[0], 1.5f);
+  EXPECT_EQ(floats[1], 2.5f);
+
+  EXPECT_EQ(view.feature(2).kind(), ExampleView::kFloat) << "The last entry should win";
+  EXPECT_EQ(view.feature(2).float_count(), 1);
+  EXPECT_EQ(view.feature(2).int64_count(), 0);
+}
+
+TEST(TFExampleView, Malformed) {
+  std::string data = MakeExample({
+    Entry("label", ExampleView::kInt64, PackedInt64({ 1, 2 })),
+  });
+  ExampleView view;
+  for (size_t len = 1; len < data.size(); len++)
+    EXPECT_FALSE(Parse(view, data.substr(0, len), { "label" })) << "truncated to " << len;
+
+  std::string bad_float = Encoder().Bytes(1, "abc").buf;  // not a multiple of 4 bytes
+  EXPECT_FALSE(Parse(view, MakeExample({ Entry("f", ExampleView::kFloat, bad_float) }), { "f" }));
+
+  EXPECT_TRUE(Parse(view, "", { "label" }));
+  EXPECT_FALSE(view.feature(0).found());
+}
+
+}  // namespace test
+}  // namespace TFUtil
+}  // namespace dali
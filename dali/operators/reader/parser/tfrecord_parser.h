@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -26,8 +26,8 @@
 #include "dali/pipeline/operator/argument.h"
 #include "dali/pipeline/operator/op_spec.h"
 #include "dali/operators/reader/parser/parser.h"
+#include "dali/operators/reader/parser/tf_example_view.h"
 #include "dali/operators/reader/parser/tf_feature.h"
-#include "dali/operators/reader/parser/example.pb.h"
 
 namespace dali {
 
@@ -47,27 +47,30 @@ class TFRecordParser : public Parser<Tensor<CPUBackend>> {
   }
 
   void Parse(const Tensor<CPUBackend>& data, SampleWorkspace* ws) override {
-    tensorflow::Example example;
-
+    // The features are read directly from the serialized record - the samples are parsed
+    // in parallel, so each call needs its own view.
+    TFUtil::ExampleView example;
     uint64_t length;
     uint32_t crc;
 
     const uint8_t* raw_data = data.data<uint8_t>();
+    DALI_ENFORCE(static_cast<size_t>(data.size()) >= sizeof(length) + sizeof(crc),
+      make_string("Error while parsing TFRecord file: ", data.GetSourceInfo(),
+                  " (the record is truncated)."));
 
     std::memcpy(&length, raw_data, sizeof(length));
 
     // Omit length and crc
     raw_data = raw_data + sizeof(length) + sizeof(crc);
-    DALI_ENFORCE(example.ParseFromArray(raw_data, length),
+    DALI_ENFORCE(length <= data.size() - sizeof(length) - sizeof(crc) &&
+                 example.Parse(raw_data, length, feature_names_),
       make_string("Error while parsing TFRecord file: ", data.GetSourceInfo(),
                   " (raw data length: ", length, "bytes)."));
 
     for (size_t i = 0; i < features_.size(); ++i) {
       auto& output = ws->Output<CPUBackend>(i);
       Feature& f = features_[i];
-      std::string& name = feature_names_[i];
-      auto& feature = example.features().feature();
-      auto it = feature.find(name);
+      auto& encoded_feature = example.feature(i);
       // set type
       switch (f.GetType()) {
         case FeatureType::int64:
@@ -80,12 +83,11 @@ class TFRecordParser : public Parser<Tensor<CPUBackend>> {
             output.set_type(DALI_FLOAT);
           break;
       }
-      if (it == feature.end()) {
+      if (!encoded_feature.found()) {
         output.Resize({0});
         output.SetSourceInfo(data.GetSourceInfo());
         continue;
       }
-      auto& encoded_feature = it->second;
       if (f.HasShape() && f.GetType() != FeatureType::string) {
         if (f.Shape().empty()) {
           output.Resize({1});
@@ -96,37 +98,35 @@ class TFRecordParser : public Parser<Tensor<CPUBackend>> {
       ssize_t number_of_elms = 0;
       switch (f.GetType()) {
         case FeatureType::int64:
-          number_of_elms = encoded_feature.int64_list().value().size();
+          number_of_elms = encoded_feature.int64_count();
           if (!f.HasShape()) {
             output.Resize(InferShape(f, number_of_elms));
           }
           DALI_ENFORCE(number_of_elms <= output.size(), make_string("Output tensor shape is too "
                        "small: [", output.shape(), "]. Expected at least ", number_of_elms,
                        " elements."));
-          std::memcpy(output.mutable_data<int64_t>(),
-              encoded_feature.int64_list().value().data(),
-              encoded_feature.int64_list().value().size()*sizeof(int64_t));
+          encoded_feature.CopyInt64(output.mutable_data<int64_t>());
           break;
-        case FeatureType::string:
+        case FeatureType::string: {
           if (!f.HasShape() || volume(f.Shape()) > 1) {
             DALI_FAIL("Tensors of strings are not supported.");
           }
-          output.Resize({static_cast<Index>(encoded_feature.bytes_list().value(0).size())});
-          std::memcpy(output.mutable_data<uint8_t>(),
-              encoded_feature.bytes_list().value(0).c_str(),
-              encoded_feature.bytes_list().value(0).size()*sizeof(uint8_t));
+          // the payload is copied straight from the record
+          auto bytes = encoded_feature.bytes(0);
+          output.Resize({static_cast<Index>(bytes.size())});
+          if (bytes.size() > 0)
+            std::memcpy(output.mutable_data<uint8_t>(), bytes.data(), bytes.size());
           break;
+        }
         case FeatureType::float32:
-          number_of_elms = encoded_feature.float_list().value().size();
+          number_of_elms = encoded_feature.float_count();
           if (!f.HasShape()) {
             output.Resize(InferShape(f, number_of_elms));
           }
           DALI_ENFORCE(number_of_elms <= output.size(), make_string("Output tensor shape is too "
                        "small: [", output.shape(), "]. Expected at least ", number_of_elms,
                        " elements."));
-          std::memcpy(output.mutable_data<float>(),
-              encoded_feature.float_list().value().data(),
-              number_of_elms * sizeof(float));
+          encoded_feature.CopyFloat(output.mutable_data<float>());
           break;
       }
       output.SetSourceInfo(data.GetSourceInfo());
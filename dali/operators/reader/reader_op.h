@@ -27,6 +27,7 @@
 #include "dali/core/nvtx.h"
 #include "dali/operators/reader/loader/loader.h"
 #include "dali/operators/reader/parser/parser.h"
+#include "dali/pipeline/operator/checkpointing.h"
 #include "dali/pipeline/operator/operator.h"
 
 namespace dali {
@@ -89,6 +90,8 @@ class DataReader : public Operator<Backend> {
     for (int i = 0; i < max_batch_size_; ++i) {
       curr_batch.push_back(loader_->ReadOne(i == 0));
     }
+    // samples from the batch may be still read by the loader's I/O threads
+    loader_->WaitForPendingReads();
   }
 
   // Main prefetch work loop
@@ -187,6 +190,58 @@ class DataReader : public Operator<Backend> {
     ConsumerAdvanceQueue();
   }
 
+  /**
+   * @brief The state of the reader is the number of batches consumed; the loader is
+   *        fast-forwarded by as many samples on restore.
+   *
+   * The state also holds the sharding, so that a reader with ``global_shuffle`` can be restored
+   * with a different number of shards; the samples of the epoch, which none of the old shards
+   * read, are then split between the new ones (see Loader::Reshard).
+   */
+  std::string SaveState() override {
+    std::string state;
+    AppendOpState(state, consumed_batches_);
+    AppendOpState(state, max_batch_size_);
+    int num_shards = loader_ ? loader_->GetNumShards() : 1;
+    int64_t first_epoch = loader_ ? loader_->FirstEpoch() : 0;
+    AppendOpState(state, num_shards);
+    AppendOpState(state, first_epoch);
+    int64_t num_ranges = loader_ ? loader_->LeftoverRanges().size() : 0;
+    AppendOpState(state, num_ranges);
+    for (int64_t i = 0; i < num_ranges; i++)
+      AppendOpState(state, loader_->LeftoverRanges()[i]);
+    return state;
+  }
+
+  void RestoreState(const std::string &state) override {
+    size_t offset = 0;
+    int64_t batches = 0, first_epoch = 0, num_ranges = 0;
+    int samples_per_batch = 0, num_shards = 0;
+    ReadOpState(batches, state, offset);
+    ReadOpState(samples_per_batch, state, offset);
+    ReadOpState(num_shards, state, offset);
+    ReadOpState(first_epoch, state, offset);
+    ReadOpState(num_ranges, state, offset);
+    DALI_ENFORCE(num_ranges >= 0, "The reader state in the checkpoint is invalid.");
+    std::vector<EpochRange> ranges(num_ranges);
+    for (auto &range : ranges)
+      ReadOpState(range, state, offset);
+    CheckOpStateEnd(state, offset);
+    DALI_ENFORCE(!prefetch_thread_.joinable(),
+                 "The reader state can only be restored before the reader is run.");
+    DALI_ENFORCE(loader_ != nullptr,
+                 make_string("The reader \"", spec_.name(), "\" doesn't support checkpoints."));
+    if (num_shards != loader_->GetNumShards()) {
+      loader_->Reshard(ranges, first_epoch, num_shards, batches * samples_per_batch);
+      consumed_batches_ = 0;
+      return;
+    }
+    if (!ranges.empty() || first_epoch != 0)
+      loader_->RestoreEpochRanges(std::move(ranges), first_epoch);
+    loader_->FastForward(batches * samples_per_batch, samples_per_batch);
+    consumed_batches_ = batches;
+  }
+
   ReaderMeta GetReaderMeta() const override {
     ReaderMeta ret;
     ret.epoch_size = loader_->Size(false);
@@ -306,6 +361,7 @@ class DataReader : public Operator<Backend> {
       std::lock_guard<std::mutex> lock(prefetch_access_mutex_);
       AdvanceIndex(curr_batch_consumer_, consumer_cycle_);
     }
+    consumed_batches_++;
     producer_.notify_one();
   }
 
@@ -349,6 +405,10 @@ class DataReader : public Operator<Backend> {
   // keep track of how many samples have been processed over all threads.
   std::atomic<int> samples_processed_;
 
+  // the number of batches consumed since the start (or the restored checkpoint), or since
+  // the loader was resharded
+  int64_t consumed_batches_ = 0;
+
   // stores any catched exceptions in the prefetch worker
   std::exception_ptr prefetch_error_;
 
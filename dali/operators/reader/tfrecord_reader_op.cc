@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -45,7 +45,19 @@ DALI_SCHEMA(readers___TFRecordBase)
 
 The index files can be obtained from TFRecord files by using the ``tfrecord2idx`` script
 that is distributed with DALI.)code",
-      DALI_STRING_VEC);
+      DALI_STRING_VEC)
+  .AddOptionalArg("interleave_files",
+      R"code(If greater than 0, the files are read sequentially, this many at a time, and the
+samples of the open files are interleaved.
+
+When ``random_shuffle`` is set, the files are visited in random order, which changes every epoch,
+and each sample is taken from a randomly chosen one of the open files; otherwise, the files are
+visited in order and the samples are taken from the open files in turn. Each file is read with
+a large read-ahead, so this mode gives a good quality of shuffling while keeping the accesses
+sequential, which is much faster on network and object storage.
+
+Only the files (or their parts) within the reader's shard are read, as usual.)code",
+      0);
 
 // Internal readers._tfrecord schema.
 DALI_SCHEMA(readers___TFRecord)
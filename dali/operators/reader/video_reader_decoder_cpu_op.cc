@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -21,14 +21,42 @@ namespace dali {
 VideoReaderDecoderCpu::VideoReaderDecoderCpu(const OpSpec &spec)
     : DataReader<CPUBackend, VideoSampleCpu>(spec),
       has_labels_(spec.HasArgument("labels")) {
+      DALI_ENFORCE(spec.GetArgument<DALIDataType>("dtype") == DALI_UINT8 &&
+                   !spec.HasArgument("mean") && !spec.HasArgument("std") &&
+                   spec.GetArgument<TensorLayout>("output_layout") == "FHWC",
+                   "The ``dtype``, ``mean``, ``std`` and ``output_layout`` arguments are "
+                   "supported only by the GPU operator.");
       loader_ = InitLoader<VideoLoaderDecoderCpu>(spec);
 }
 
+void VideoReaderDecoderCpu::Prefetch() {
+  DataReader<CPUBackend, VideoSampleCpu>::Prefetch();
+
+  auto &current_batch = prefetched_batch_queue_[curr_batch_producer_];
+  std::vector<VideoSampleCpu *> samples;
+  samples.reserve(current_batch.size());
+  for (auto &sample : current_batch) {
+    samples.push_back(sample.get());
+  }
+  LoaderImpl().DecodeSamples(samples);
+}
+
 void VideoReaderDecoderCpu::RunImpl(SampleWorkspace &ws) {
-  const auto &sample = GetSample(ws.data_idx());
+  auto &sample = GetSample(ws.data_idx());
   auto &video_output = ws.template Output<CPUBackend>(0);
 
-  video_output.Copy(sample.data_);
+  // The output is pinned when it's copied to the GPU - the following samples are then decoded
+  // to pinned memory, which is passed to the output without copying
+  LoaderImpl().SetDecodeToPinned(video_output.is_pinned());
+  if (sample.data_.is_pinned() && video_output.is_pinned()) {
+    video_output.ShareData(sample.data_);
+    // the sample is recycled by the loader, so it has to decode the next sequence elsewhere
+    sample.data_.Reset();
+  } else {
+    if (video_output.shares_data())
+      video_output.Reset();
+    video_output.Copy(sample.data_);
+  }
 
   if (has_labels_) {
     auto &label_output = ws.Output<CPUBackend>(1);
@@ -55,7 +83,8 @@ containers and returns a batch of sequences of ``sequence_length`` frames with s
 .. note::
   Containers which do not support indexing, like MPEG, require DALI to build the index.
 DALI will go through the video and mark keyframes to be able to seek effectively,
-even in the variable frame rate scenario.)code")
+even in the variable frame rate scenario. To do it only once, point ``frame_index_dir`` to
+a persistent directory.)code")
   .NumInput(0)
   .OutputFn(detail::VideoReaderDecoderOutputFn)
   .AddOptionalArg("filenames",
@@ -73,6 +102,53 @@ When the value is less than 0, ``step`` is set to ``sequence_length``.)code",
       -1)
   .AddOptionalArg("stride",
       R"code(Distance between consecutive frames in the sequence.)code", 1u, false)
+  .AddOptionalArg("frame_index_dir",
+      R"code(A directory where the indices of the frames and keyframes of the videos are stored.
+
+Building the index requires reading the whole video, so, when the index of a video is found in
+the directory, it's loaded instead. The missing indices are built and stored there, so that
+the following runs can start right away. The directory can be shared by multiple processes
+and can be, for example, the directory of the dataset. An index is rebuilt when the size or
+the modification time of its video changes.
+
+If empty, the indices are built every time.)code", std::string())
+  .AddOptionalArg("num_parallel_decoders",
+      R"code(The maximum number of the videos decoded concurrently.
+
+The sequences of a batch which come from different videos are decoded in parallel. The GPU
+operator decodes them on separate hardware decoder sessions and CUDA streams, which helps
+to saturate the hardware decoders (NVDEC) when the sequences are short. The CPU operator decodes
+them on separate threads.
+
+If 0 or negative, the number of decoding engines of the GPU is used by the GPU operator and
+``num_threads`` of the pipeline by the CPU operator.)code", -1)
+  .AddOptionalArg("threads_per_decoder",
+      R"code(The number of threads used by FFmpeg to decode each of the videos, with frame and
+slice threading. Used only by the CPU operator.
+
+Up to ``num_parallel_decoders * threads_per_decoder`` threads decode the videos. Use more
+parallel decoders when the batch contains sequences from many videos and more threads per
+decoder when they come from few, long or high resolution videos. If 0, FFmpeg chooses the number
+of threads.)code", 1)
+  .AddOptionalArg("dtype",
+      R"code(The type of the output frames: ``uint8``, ``float`` or ``float16``.
+
+The conversion is done together with the conversion of the decoded frames to RGB.
+Supported only by the GPU operator.)code", DALI_UINT8)
+  .AddOptionalArg<std::vector<float>>("mean",
+      R"code(If set, the RGB values in the range [0, 255] are normalized as
+``(value - mean) / std``. One value or one per channel.
+
+It's done together with the conversion of the decoded frames to RGB, so a floating point
+``dtype`` is usually used with it. Supported only by the GPU operator.)code", nullptr)
+  .AddOptionalArg<std::vector<float>>("std",
+      R"code(The standard deviation used for the normalization, see ``mean``.
+One value or one per channel. Supported only by the GPU operator.)code", nullptr)
+  .AddOptionalArg("output_layout",
+      R"code(The layout of the output sequences: ``"FHWC"``, ``"FCHW"`` or ``"CFHW"``.
+
+The frames are stored in the layout by the color conversion, without a separate
+transposition. Supported only by the GPU operator.)code", TensorLayout("FHWC"))
   .AddParent("LoaderBase");
 
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,18 +15,26 @@
 #ifndef DALI_OPERATORS_READER_VIDEO_READER_DECODER_CPU_OP_H_
 #define DALI_OPERATORS_READER_VIDEO_READER_DECODER_CPU_OP_H_
 
+#include <vector>
+
 #include "dali/operators/reader/reader_op.h"
 #include "dali/operators/reader/loader/video/video_loader_decoder_cpu.h"
 
 namespace dali {
-class VideoReaderDecoderCpu : public DataReader<CPUBackend, VideoSample<CPUBackend>> {
+class VideoReaderDecoderCpu : public DataReader<CPUBackend, VideoSampleCpu> {
  public:
   explicit VideoReaderDecoderCpu(const OpSpec &spec);
 
+  void Prefetch() override;
+
  protected:
   void RunImpl(SampleWorkspace &ws) override;
 
  private:
+  VideoLoaderDecoderCpu &LoaderImpl() {
+    return dynamic_cast<VideoLoaderDecoderCpu &>(*loader_);
+  }
+
   bool has_labels_ = false;
 };
 
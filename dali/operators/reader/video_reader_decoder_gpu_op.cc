@@ -28,9 +28,12 @@ void VideoReaderDecoderGpu::Prefetch() {
   DataReader<GPUBackend, VideoSampleGpu>::Prefetch();
 
   auto &current_batch = prefetched_batch_queue_[curr_batch_producer_];
+  std::vector<VideoSampleGpu *> samples;
+  samples.reserve(current_batch.size());
   for (auto &sample : current_batch) {
-    sample->Decode();
+    samples.push_back(sample.get());
   }
+  LoaderImpl().DecodeSamples(samples);
 }
 
 bool VideoReaderDecoderGpu::SetupImpl(
@@ -47,7 +50,7 @@ bool VideoReaderDecoderGpu::SetupImpl(
     video_shape.set_tensor_shape(sample_id, sample.data_.shape());
   }
 
-  output_desc[0] = { video_shape, DALI_UINT8 };
+  output_desc[0] = { video_shape, LoaderImpl().OutputType() };
 
   if (!has_labels_) {
     return true;
@@ -65,7 +68,7 @@ void VideoReaderDecoderGpu::RunImpl(DeviceWorkspace &ws) {
   auto &video_output = ws.Output<GPUBackend>(0);
   int batch_size = GetCurrBatchSize();
 
-  video_output.SetLayout("FHWC");
+  video_output.SetLayout(LoaderImpl().OutputLayout());
 
   // TODO(awolant): Would struct of arrays work better?
   for (int sample_id = 0; sample_id < batch_size; ++sample_id) {
@@ -74,7 +77,7 @@ void VideoReaderDecoderGpu::RunImpl(DeviceWorkspace &ws) {
     MemCopy(
       video_output.raw_mutable_tensor(sample_id),
       sample.data_.raw_data(),
-      sample.data_.size(),
+      sample.data_.nbytes(),
       ws.stream());
   }
 
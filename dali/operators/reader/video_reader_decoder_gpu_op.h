@@ -34,6 +34,10 @@ class VideoReaderDecoderGpu : public DataReader<GPUBackend, VideoSampleGpu> {
   void Prefetch() override;
 
  private:
+  VideoLoaderDecoderGpu &LoaderImpl() {
+    return dynamic_cast<VideoLoaderDecoderGpu &>(*loader_);
+  }
+
   bool has_labels_ = false;
 };
 
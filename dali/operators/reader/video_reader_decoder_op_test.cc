@@ -30,11 +30,23 @@ class VideoReaderDecoderBaseTest : public VideoTestBase {
   template<typename Backend>
   void RunTest(
     std::vector<std::string> &videos_paths,
-    std::vector<TestVideo> &ground_truth_videos);
+    std::vector<TestVideo> &ground_truth_videos,
+    int num_parallel_decoders = -1,
+    int threads_per_decoder = 1);
 
   template<typename Backend>
   void RunShuffleTest();
 
+  /**
+   * @brief Runs the CPU operator with the outputs copied to the GPU
+   */
+  void RunCpuDecoderGpuOutputTest(
+      std::vector<std::string> &videos_paths,
+      std::vector<TestVideo> &ground_truth_videos) {
+    RunTestImpl<dali::GPUBackend>(
+      videos_paths, ground_truth_videos, "cpu", 0, -1, 1, "gpu");
+  }
+
   virtual void AssertLabel(const int *label, int ground_truth_label) = 0;
 
   virtual void AssertFrame(
@@ -46,7 +58,10 @@ class VideoReaderDecoderBaseTest : public VideoTestBase {
     std::vector<std::string> &videos_paths,
     std::vector<TestVideo> &ground_truth_videos,
     std::string backend,
-    int device_id) {
+    int device_id,
+    int num_parallel_decoders,
+    int threads_per_decoder,
+    std::string output_backend = "") {
     const int batch_size = 4;
     const int sequence_length = 6;
     const int stride = 3;
@@ -63,10 +78,14 @@ class VideoReaderDecoderBaseTest : public VideoTestBase {
         "filenames",
         videos_paths)
       .AddArg("labels", std::vector<int>{0, 1})
+      .AddArg("num_parallel_decoders", num_parallel_decoders)
+      .AddArg("threads_per_decoder", threads_per_decoder)
       .AddOutput("frames", backend)
       .AddOutput("labels", backend));
 
-    pipe.Build({{"frames", backend}, {"labels", backend}});
+    if (output_backend.empty())
+      output_backend = backend;
+    pipe.Build({{"frames", output_backend}, {"labels", output_backend}});
 
     int num_sequences = 20;
     int sequence_id = 0;
@@ -160,9 +179,12 @@ class VideoReaderDecoderBaseTest : public VideoTestBase {
 template<>
 void VideoReaderDecoderBaseTest::RunTest<dali::CPUBackend>(
   std::vector<std::string> &videos_paths,
-  std::vector<TestVideo> &ground_truth_videos) {
+  std::vector<TestVideo> &ground_truth_videos,
+  int num_parallel_decoders,
+  int threads_per_decoder) {
     RunTestImpl<dali::CPUBackend>(
-      videos_paths, ground_truth_videos, "cpu", dali::CPU_ONLY_DEVICE_ID);
+      videos_paths, ground_truth_videos, "cpu", dali::CPU_ONLY_DEVICE_ID, num_parallel_decoders,
+      threads_per_decoder);
 }
 
 template<>
@@ -173,9 +195,11 @@ void VideoReaderDecoderBaseTest::RunShuffleTest<dali::CPUBackend>() {
 template<>
 void VideoReaderDecoderBaseTest::RunTest<dali::GPUBackend>(
   std::vector<std::string> &videos_paths,
-  std::vector<TestVideo> &ground_truth_videos) {
+  std::vector<TestVideo> &ground_truth_videos,
+  int num_parallel_decoders,
+  int threads_per_decoder) {
     RunTestImpl<dali::GPUBackend>(
-      videos_paths, ground_truth_videos, "gpu", 0);
+      videos_paths, ground_truth_videos, "gpu", 0, num_parallel_decoders, threads_per_decoder);
 }
 
 template<>
@@ -225,6 +249,18 @@ TEST_F(VideoReaderDecoderCpuTest, VariableFrameRate_CpuOnlyTests) {
   RunTest<dali::CPUBackend>(vfr_videos_paths_, vfr_videos_);
 }
 
+TEST_F(VideoReaderDecoderCpuTest, ParallelDecoders_CpuOnlyTests) {
+  RunTest<dali::CPUBackend>(cfr_videos_paths_, cfr_videos_, 2);
+}
+
+TEST_F(VideoReaderDecoderCpuTest, DecoderThreads_CpuOnlyTests) {
+  RunTest<dali::CPUBackend>(vfr_videos_paths_, vfr_videos_, 1, 4);
+}
+
+TEST_F(VideoReaderDecoderCpuTest, AutoDecoderThreads_CpuOnlyTests) {
+  RunTest<dali::CPUBackend>(cfr_videos_paths_, cfr_videos_, 2, 0);
+}
+
 TEST_F(VideoReaderDecoderCpuTest, LabelMismatch_CpuOnlyTests) {
   std::vector<std::string> paths {cfr_hevc_videos_paths_[0]};
 
@@ -241,6 +277,18 @@ TEST_F(VideoReaderDecoderGpuTest, VariableFrameRate) {
   RunTest<dali::GPUBackend>(vfr_videos_paths_, vfr_videos_);
 }
 
+TEST_F(VideoReaderDecoderGpuTest, ParallelDecoders) {
+  RunTest<dali::GPUBackend>(cfr_videos_paths_, cfr_videos_, 2);
+}
+
+TEST_F(VideoReaderDecoderGpuTest, SingleDecoder) {
+  RunTest<dali::GPUBackend>(vfr_videos_paths_, vfr_videos_, 1);
+}
+
+TEST_F(VideoReaderDecoderGpuTest, CpuDecoderGpuOutput) {
+  RunCpuDecoderGpuOutputTest(cfr_videos_paths_, cfr_videos_);
+}
+
 TEST_F(VideoReaderDecoderCpuTest, RandomShuffle_CpuOnlyTests) {
   RunShuffleTest<dali::CPUBackend>();
 }
@@ -191,6 +191,15 @@ timestamps are correlated with displayed video frames.
 of frames at the very end of the video.
 
 Redundant frames are zeroed. Corresponding time stamps and frame numbers are set to -1.)code", false)
+  .AddOptionalArg("frame_cache_size",
+      R"code(The size, in MB, of the GPU cache of the decoded frames.
+
+The frames are identified by the file and the frame number, so the frames shared by overlapping
+sequences (when ``step`` is smaller than the span of a sequence) and the ones seen in the previous
+epochs are decoded only once, as long as they stay in the cache. The least recently used frames
+are evicted, when the cache is full.
+
+If 0, the frames are not cached.)code", 0)
   .AddParent("LoaderBase");
 
 
@@ -46,7 +46,11 @@ inline int VideoReaderOutputFn(const OpSpec &spec) {
 
 class VideoReader : public DataReader<GPUBackend, SequenceWrapper> {
  public:
-  explicit VideoReader(const OpSpec &spec)
+  /**
+   * @param decoder_output_size the size to which the frames are scaled by the decoder, if possible
+   *                            (see VideoLoader); {0, 0} keeps the size of the videos
+   */
+  explicit VideoReader(const OpSpec &spec, TensorShape<2> decoder_output_size = {0, 0})
       : DataReader<GPUBackend, SequenceWrapper>(spec),
         filenames_(spec.GetRepeatedArgument<std::string>("filenames")),
         file_root_(spec.GetArgument<std::string>("file_root")),
@@ -94,7 +98,7 @@ class VideoReader : public DataReader<GPUBackend, SequenceWrapper> {
     output_labels_ = has_labels_arg || !file_list_.empty() || !file_root_.empty();
 
     // TODO(spanev): Factor out the constructor body to make VideoReader compatible with lazy_init.
-    loader_ = InitLoader<VideoLoader>(spec, filenames_);
+    loader_ = InitLoader<VideoLoader>(spec, filenames_, decoder_output_size);
 
     label_shape_ = uniform_list_shape(max_batch_size_, {1});
 
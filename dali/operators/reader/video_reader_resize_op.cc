@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cmath>
+#include <string>
 #include <vector>
 
 #include "dali/core/common.h"
@@ -24,6 +26,64 @@
 
 namespace dali {
 
+namespace {
+
+bool IsLinearFilter(DALIInterpType interp) {
+  return interp == DALI_INTERP_LINEAR || interp == DALI_INTERP_TRIANGULAR;
+}
+
+}  // namespace
+
+TensorShape<2> VideoReaderResize::DecoderResizeShape(const OpSpec &spec) {
+  TensorShape<2> none = {0, 0};
+  if (!spec.GetArgument<bool>("hw_resize"))
+    return none;
+
+  for (const char *arg : {"resize_shorter", "resize_longer", "resize_z", "max_size",
+                          "roi_start", "roi_end"}) {
+    if (spec.ArgumentDefined(arg))
+      return none;
+  }
+  for (const char *arg : {"resize_x", "resize_y", "size",
+                          "interp_type", "min_filter", "mag_filter"}) {
+    if (spec.HasTensorArgument(arg))
+      return none;
+  }
+  if (spec.HasArgument("mode")) {
+    auto mode = ParseResizeMode(spec.GetArgument<std::string>("mode"));
+    if (mode != ResizeMode::Default && mode != ResizeMode::Stretch)
+      return none;
+  }
+
+  DALIInterpType min_filter = DALI_INTERP_TRIANGULAR, mag_filter = DALI_INTERP_LINEAR;
+  if (spec.HasArgument("interp_type"))
+    min_filter = mag_filter = spec.GetArgument<DALIInterpType>("interp_type");
+  if (spec.HasArgument("min_filter"))
+    min_filter = spec.GetArgument<DALIInterpType>("min_filter");
+  if (spec.HasArgument("mag_filter"))
+    mag_filter = spec.GetArgument<DALIInterpType>("mag_filter");
+  if (!IsLinearFilter(min_filter) || !IsLinearFilter(mag_filter))
+    return none;
+
+  float height = 0, width = 0;
+  if (spec.HasArgument("size")) {
+    std::vector<float> size;
+    GetSingleOrRepeatedArg(spec, size, "size", 2);
+    if (size.size() != 2)
+      return none;
+    height = size[0];
+    width = size[1];
+  } else if (spec.HasArgument("resize_x") && spec.HasArgument("resize_y")) {
+    height = spec.GetArgument<float>("resize_y");
+    width = spec.GetArgument<float>("resize_x");
+  }
+  TensorShape<2> shape = {std::lround(height), std::lround(width)};
+  // NVDEC requires the output size to be even
+  if (shape[0] <= 0 || shape[1] <= 0 || shape[0] % 2 || shape[1] % 2)
+    return none;
+  return shape;
+}
+
 DALI_REGISTER_OPERATOR(readers__VideoResize, VideoReaderResize, GPU);
 
 DALI_SCHEMA(readers__VideoResize)
@@ -41,6 +101,16 @@ This operator combines the features of :meth:`nvidia.dali.fn.video_reader` and :
 )code")
   .NumInput(0)
   .OutputFn(detail::VideoReaderOutputFn)
+  .AddOptionalArg("hw_resize",
+      R"code(If set to True, the frames are scaled by the hardware decoder, when it's possible.
+
+The decoder is used when the output size is given with both ``resize_x`` and ``resize_y``
+or with ``size`` (as constants, which are even numbers), with the default or ``"stretch"`` mode,
+no ROI and linear filters, and when none of the videos is smaller than the output.
+Otherwise, the full size frames are decoded and resized on the GPU. Scaling in the decoder
+saves the memory and the bandwidth needed for the full size frames, but its results
+differ slightly from the ones of the generic resize.)code",
+      true)
   .AddParent("VideoReader")
   .AddParent("ResizeAttr")
   .AddParent("ResamplingFilterAttr");
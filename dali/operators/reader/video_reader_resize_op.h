@@ -31,8 +31,9 @@ class VideoReaderResize : public VideoReader,
                           protected ResizeBase<GPUBackend> {
  public:
   explicit VideoReaderResize(const OpSpec &spec)
-      : VideoReader(spec),
-        ResizeBase(spec) {
+      : VideoReader(spec, DecoderResizeShape(spec)),
+        ResizeBase(spec),
+        decoder_resize_shape_(DecoderResizeShape(spec)) {
     ResizeBase::InitializeGPU(spec_.GetArgument<int>("minibatch_size"),
                               spec_.GetArgument<int64_t>("temp_buffer_hint"));
   }
@@ -40,9 +41,29 @@ class VideoReaderResize : public VideoReader,
   inline ~VideoReaderResize() override = default;
 
  protected:
+  /**
+   * @brief Returns the (height, width) to which the frames can be scaled by the hardware decoder
+   *        instead of the generic resize, or {0, 0}
+   *
+   * The decoder is used only when the output size is fixed and the filters are linear.
+   */
+  static TensorShape<2> DecoderResizeShape(const OpSpec &spec);
+
   void SetOutputShapeType(TensorList<GPUBackend> &output, DeviceWorkspace &ws) override {
     input_shape_ = prefetched_batch_tensors_[curr_batch_consumer_].shape();
 
+    // the loader falls back to the full size frames, when some of the videos can't be scaled
+    resized_by_decoder_ = decoder_resize_shape_[0] > 0;
+    for (int i = 0; i < input_shape_.num_samples() && resized_by_decoder_; i++) {
+      auto sample_shape = input_shape_.tensor_shape_span(i);
+      resized_by_decoder_ = sample_shape[1] == decoder_resize_shape_[0] &&
+                            sample_shape[2] == decoder_resize_shape_[1];
+    }
+    if (resized_by_decoder_) {
+      VideoReader::SetOutputShapeType(output, ws);
+      return;
+    }
+
     resize_attr_.PrepareResizeParams(spec_, ws, input_shape_, "FHWC");
     resampling_attr_.PrepareFilterParams(spec_, ws, max_batch_size_);
     resample_params_.resize(resize_attr_.params_.size());
@@ -66,6 +87,10 @@ class VideoReaderResize : public VideoReader,
     TensorList<GPUBackend> &video_output,
     TensorList<GPUBackend> &video_batch,
     DeviceWorkspace &ws) override {
+    if (resized_by_decoder_) {
+      VideoReader::ProcessVideo(video_output, video_batch, ws);
+      return;
+    }
     TensorListShape<> input_shape(1, sequence_dim);
     for (int data_idx = 0; data_idx < video_batch.num_samples(); ++data_idx) {
       TensorList<GPUBackend> input;
@@ -91,6 +116,8 @@ class VideoReaderResize : public VideoReader,
  private:
   std::vector<kernels::ResamplingParams2D> resample_params_;
   TensorListShape<> input_shape_, output_shape_;
+  TensorShape<2> decoder_resize_shape_;
+  bool resized_by_decoder_ = false;
 };
 
 }  // namespace dali
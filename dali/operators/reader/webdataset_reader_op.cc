@@ -127,8 +127,19 @@ Example: "left.png;right.jpg")code",
             R"code(The list of the index files corresponding to the respective webdataset archives.
 
 Has to be the same length as the ``paths`` argument. In case it is not provided,
-it will be inferred automatically from the webdataset archive.)code",
+it will be inferred automatically from the webdataset archive. The indices of different archives
+are inferred in parallel.)code",
             std::vector<std::string>())
+    .AddOptionalArg("index_cache_dir",
+            R"code(A directory where the indices inferred from the archives are stored.
+
+When ``index_paths`` is not provided, the reader stores the index of each archive in a compact
+binary file in this directory and, in the following runs, maps it instead of reading the archive
+again. An index is reused only if the archive has not changed (its size and modification time
+are the same).
+
+If empty, the indices are inferred in every run.)code",
+            std::string())
     .AddOptionalArg(
         "missing_component_behavior",
         R"code(Specifies what to do in case there is not any file in a sample corresponding to a certain output.
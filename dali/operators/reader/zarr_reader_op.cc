@@ -0,0 +1,172 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "dali/kernels/slice/slice_cpu.h"
+#include "dali/operators/reader/zarr_reader_op.h"
+
+namespace dali {
+
+DALI_REGISTER_OPERATOR(readers__Zarr, ZarrReaderCPU, CPU);
+
+DALI_SCHEMA(readers__Zarr)
+  .DocStr(R"(Reads chunked, compressed arrays stored in the Zarr (version 2) format.
+
+Each array is a directory with a ``.zarray`` metadata file and the chunks of the array, each in
+a separate file. Only the chunks which overlap the region of interest (see ``roi_start``
+and related arguments) are read; they are decompressed in parallel. The chunks which are not stored
+are filled with the fill value of the array.
+
+This operator can be used in the following modes:
+
+1. Read all arrays from the subdirectories of ``file_root``. The arrays are found by their
+   metadata files, as matched by ``file_filter``.
+2. Read the array paths from a text file indicated in ``file_list`` argument.
+3. Read the arrays listed in ``files`` argument.
+
+The supported compressors are blosc, zstd and lz4, depending on the libraries DALI was built with.
+Filters are not supported.
+)")
+  .NumInput(0)
+  .NumOutput(1)  // (Arrays)
+  .AddOptionalArg<string>("file_root",
+      R"(Path to a directory that contains the arrays.
+
+If not using ``file_list`` or ``files``, this directory is traversed to discover the arrays.
+``file_root`` is required in this mode of operation.)",
+      nullptr)
+  .AddOptionalArg("file_filter",
+      R"(A glob string matching the metadata files of the arrays in the sub-directories of
+the ``file_root``.
+
+This argument is ignored when array paths are taken from ``file_list`` or ``files``.)", ".zarray")
+  .AddOptionalArg<string>("file_list",
+      R"(Path to a text file that contains the paths of the arrays (one per line), relative to
+the location of that file or to ``file_root``, if specified.
+
+This argument is mutually exclusive with ``files``.)", nullptr)
+  .AddOptionalArg("shuffle_after_epoch",
+      R"(If set to True, the reader shuffles the entire dataset after each epoch.
+
+``stick_to_shard`` and ``random_shuffle`` cannot be used when this argument is set to True.)",
+      false)
+  .AddOptionalArg<vector<string>>("files", R"(A list of paths of the arrays to read.
+
+The paths can point to the directories of the arrays or to their ``.zarray`` files.
+If ``file_root`` is provided, the paths are treated as being relative to it.
+
+This argument is mutually exclusive with ``file_list``.)", nullptr)
+  .AddParent("LoaderBase")
+  .AddParent("ArrayReaderRoiAttr");
+
+void ZarrReaderCPU::ScheduleBoxRead(ZarrArrayWrapper &sample, uint8_t *dst,
+                                    const TensorShape<> &anchor, const TensorShape<> &shape,
+                                    ThreadPool &thread_pool) {
+  int ndim = shape.sample_dim();
+  if (volume(shape) == 0)
+    return;
+  const auto &chunk_shape = sample.chunk_shape;
+  TensorShape<> first, last;
+  first.resize(ndim);
+  last.resize(ndim);
+  for (int d = 0; d < ndim; d++) {
+    first[d] = anchor[d] / chunk_shape[d];
+    last[d] = (anchor[d] + shape[d] - 1) / chunk_shape[d];
+  }
+
+  int64_t chunk_nbytes = sample.chunk_nbytes();
+  TensorShape<> pos = first;
+  for (;;) {
+    // the part of the box within the chunk
+    TensorShape<> dst_anchor, src_anchor, box;
+    dst_anchor.resize(ndim);
+    src_anchor.resize(ndim);
+    box.resize(ndim);
+    for (int d = 0; d < ndim; d++) {
+      int64_t origin = pos[d] * chunk_shape[d];
+      int64_t begin = std::max(anchor[d], origin);
+      int64_t end = std::min(anchor[d] + shape[d], origin + chunk_shape[d]);
+      dst_anchor[d] = begin - anchor[d];
+      src_anchor[d] = begin - origin;
+      box[d] = end - begin;
+    }
+    std::string path = detail::ZarrChunkPath(sample.filename, sample, pos);
+    thread_pool.AddWork([this, &sample, dst, shape, dst_anchor, src_anchor, box, path,
+                         chunk_nbytes](int tid) {
+      auto &buffers = chunk_buffers_[tid];
+      const uint8_t *chunk = nullptr;
+      struct stat s;
+      if (stat(path.c_str(), &s) == 0) {
+        auto file = FileStream::Open(path, false, false);
+        size_t size = file->Size();
+        buffers.compressed.resize(size);
+        DALI_ENFORCE(file->Read(buffers.compressed.data(), size) == size,
+                     make_string("Failed to read file: ", path));
+        file->Close();
+        buffers.decompressed.resize(chunk_nbytes);
+        try {
+          detail::DecompressZarrChunk(sample, buffers.decompressed.data(),
+                                      buffers.compressed.data(), size);
+        } catch (const std::runtime_error &e) {
+          DALI_FAIL(e.what() + ". File: " + path);
+        }
+        chunk = buffers.decompressed.data();
+      }  // otherwise, the chunk is not stored - it's filled with the fill value
+      detail::CopyBox(dst, shape, dst_anchor, chunk, sample.chunk_shape, src_anchor, box,
+                      sample.fill_value);
+    }, volume(box));
+
+    // next chunk, in C order
+    int d = ndim - 1;
+    for (; d >= 0; d--) {
+      if (++pos[d] <= last[d])
+        break;
+      pos[d] = first[d];
+    }
+    if (d < 0)
+      break;
+  }
+}
+
+void ZarrReaderCPU::RunImpl(HostWorkspace &ws) {
+  auto &output = ws.Output<CPUBackend>(0);
+  int nsamples = output.num_samples();
+  auto &thread_pool = ws.GetThreadPool();
+  int nthreads = thread_pool.NumThreads();
+  chunk_buffers_.resize(nthreads);
+
+  // From 1 to 10 blocks per sample depending on the nthreads/nsamples ratio
+  int blocks_per_sample = std::max(1, 10 * nthreads / nsamples);
+  constexpr int kThreshold = kernels::kSliceMinBlockSize;  // smaller samples will not be subdivided
+
+  std::vector<int> buffered;
+  for (int i = 0; i < nsamples; i++) {
+    if (ScheduleRoiRead(output[i], i, thread_pool))
+      buffered.push_back(i);
+  }
+  thread_pool.RunAll();
+
+  if (buffered.empty())
+    return;
+  // pad and/or transpose the parts of the arrays that were read
+  for (int i : buffered)
+    FinishRoiRead(output[i], i, thread_pool, kThreshold, blocks_per_sample);
+  thread_pool.RunAll();
+}
+
+}  // namespace dali
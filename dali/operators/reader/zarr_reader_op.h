@@ -0,0 +1,53 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_READER_ZARR_READER_OP_H_
+#define DALI_OPERATORS_READER_ZARR_READER_OP_H_
+
+#include <vector>
+
+#include "dali/operators/reader/loader/zarr_loader.h"
+#include "dali/operators/reader/numpy_reader_op.h"
+
+namespace dali {
+
+class ZarrReaderCPU : public ArrayRoiReaderCPU<ZarrArrayWrapper> {
+ public:
+  explicit ZarrReaderCPU(const OpSpec& spec) : ArrayRoiReaderCPU<ZarrArrayWrapper>(spec) {
+    bool shuffle_after_epoch = spec.GetArgument<bool>("shuffle_after_epoch");
+    loader_ = InitLoader<ZarrLoader>(spec, shuffle_after_epoch);
+  }
+
+ protected:
+  void RunImpl(HostWorkspace &ws) override;
+  using Operator<CPUBackend>::RunImpl;
+
+  /**
+   * @brief Schedules reading and decompressing the chunks which overlap the box, in parallel.
+   */
+  void ScheduleBoxRead(ZarrArrayWrapper &sample, uint8_t *dst, const TensorShape<> &anchor,
+                       const TensorShape<> &shape, ThreadPool &thread_pool) override;
+
+ private:
+  USE_READER_OPERATOR_MEMBERS(CPUBackend, ZarrArrayWrapper);
+
+  struct ChunkBuffers {
+    std::vector<uint8_t> compressed, decompressed;
+  };
+  std::vector<ChunkBuffers> chunk_buffers_;  // per thread
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_READER_ZARR_READER_OP_H_
@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,17 +13,14 @@
 // limitations under the License.
 
 #include <random>
+#include <string>
 #include <utility>
 #include "dali/core/static_switch.h"
-#include "dali/pipeline/operator/operator.h"
-#include "dali/pipeline/util/batch_rng.h"
+#include "dali/operators/segmentation/random_mask_pixel.h"
 #include "dali/operators/segmentation/utils/searchable_rle_mask.h"
 #include "dali/kernels/common/utils.h"
 #include "dali/core/boundary.h"
 
-#define MASK_SUPPORTED_TYPES (uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, \
-                              uint64_t, int64_t, float, bool)
-
 namespace dali {
 
 DALI_SCHEMA(segmentation__RandomMaskPixel)
@@ -33,6 +30,10 @@ Based on run-time argument ``foreground``, it returns either only foreground pix
 
 Pixels are classificed as foreground either when their value exceeds a given ``threshold`` or when
 it's equal to a specific ``value``.
+
+.. note::
+  The GPU implementation draws the random numbers differently, so for the same seed it selects
+  different pixels than the CPU implementation.
 )")
     .AddOptionalArg<int>("value",
       R"code(All pixels equal to this value are interpreted as foreground.
@@ -53,10 +54,12 @@ If 0, the pixel position is sampled uniformly from all available pixels.)code",
     .NumInput(1)
     .NumOutput(1);
 
-class RandomMaskPixelCPU : public Operator<CPUBackend> {
+class RandomMaskPixelCPU : public Operator<CPUBackend>, protected RandomMaskPixelAttr {
  public:
   explicit RandomMaskPixelCPU(const OpSpec &spec);
   bool CanInferOutputs() const override { return true; }
+  std::string SaveState() override { return rngs_.SaveState(); }
+  void RestoreState(const std::string &state) override { rngs_.RestoreState(state); }
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<CPUBackend> &ws) override;
   void RunImpl(workspace_t<CPUBackend> &ws) override;
 
@@ -64,48 +67,19 @@ class RandomMaskPixelCPU : public Operator<CPUBackend> {
   template <typename T>
   void RunImplTyped(workspace_t<CPUBackend> &ws);
 
-  BatchRNG<std::mt19937> rngs_;
   std::vector<SearchableRLEMask> rle_;
 
-  std::vector<int> foreground_;
-  std::vector<int> value_;
-  std::vector<float> threshold_;
-
-  bool has_value_ = false;
-
   USE_OPERATOR_MEMBERS();
 };
 
 RandomMaskPixelCPU::RandomMaskPixelCPU(const OpSpec &spec)
     : Operator<CPUBackend>(spec),
-      rngs_(spec.GetArgument<int64_t>("seed"), spec.GetArgument<int64_t>("max_batch_size")),
-      has_value_(spec.ArgumentDefined("value")) {
-  if (has_value_) {
-    DALI_ENFORCE(!spec.ArgumentDefined("threshold"),
-                 "Arguments ``value`` and ``threshold`` can not be provided together");
-  }
-}
+      RandomMaskPixelAttr(spec, spec.GetArgument<int64_t>("max_batch_size")) {}
 
 bool RandomMaskPixelCPU::SetupImpl(std::vector<OutputDesc> &output_desc,
                                     const workspace_t<CPUBackend> &ws) {
   const auto &in_masks = ws.template Input<CPUBackend>(0);
-  int nsamples = in_masks.num_samples();
-  auto in_masks_shape = in_masks.shape();
-  int ndim = in_masks_shape.sample_dim();
-  output_desc.resize(1);
-  output_desc[0].shape = uniform_list_shape(nsamples, {ndim});
-  output_desc[0].type = DALI_INT64;
-
-  foreground_.resize(nsamples);
-  value_.clear();
-  threshold_.clear();
-
-  GetPerSampleArgument(foreground_, "foreground", ws, nsamples);
-  if (spec_.ArgumentDefined("value")) {
-    GetPerSampleArgument(value_, "value", ws, nsamples);
-  } else {
-    GetPerSampleArgument(threshold_, "threshold", ws, nsamples);
-  }
+  SetupOutputs(output_desc, spec_, ws, in_masks.num_samples(), in_masks.sample_dim());
   return true;
 }
 
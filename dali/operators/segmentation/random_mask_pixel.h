@@ -0,0 +1,76 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_SEGMENTATION_RANDOM_MASK_PIXEL_H_
+#define DALI_OPERATORS_SEGMENTATION_RANDOM_MASK_PIXEL_H_
+
+#include <random>
+#include <vector>
+#include "dali/pipeline/operator/common.h"
+#include "dali/pipeline/operator/operator.h"
+#include "dali/pipeline/util/batch_rng.h"
+
+#define MASK_SUPPORTED_TYPES (uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, \
+                              uint64_t, int64_t, float, bool)
+
+namespace dali {
+
+/**
+ * @brief The arguments of RandomMaskPixel, common to the CPU and GPU implementations.
+ */
+class RandomMaskPixelAttr {
+ public:
+  RandomMaskPixelAttr(const OpSpec &spec, int max_batch_size)
+      : rngs_(spec.GetArgument<int64_t>("seed"), max_batch_size),
+        has_value_(spec.ArgumentDefined("value")) {
+    if (has_value_) {
+      DALI_ENFORCE(!spec.ArgumentDefined("threshold"),
+                   "Arguments ``value`` and ``threshold`` can not be provided together");
+    }
+  }
+
+ protected:
+  /**
+   * @brief Reads the per-sample arguments and describes the output - the pixel coordinates
+   */
+  void SetupOutputs(std::vector<OutputDesc> &output_desc, const OpSpec &spec,
+                    const ArgumentWorkspace &ws, int nsamples, int ndim) {
+    output_desc.resize(1);
+    output_desc[0].shape = uniform_list_shape(nsamples, {ndim});
+    output_desc[0].type = DALI_INT64;
+
+    foreground_.resize(nsamples);
+    value_.clear();
+    threshold_.clear();
+
+    GetPerSampleArgument(foreground_, "foreground", spec, ws, nsamples);
+    if (has_value_) {
+      GetPerSampleArgument(value_, "value", spec, ws, nsamples);
+    } else {
+      GetPerSampleArgument(threshold_, "threshold", spec, ws, nsamples);
+    }
+  }
+
+  BatchRNG<std::mt19937> rngs_;
+
+  std::vector<int> foreground_;
+  std::vector<int> value_;
+  std::vector<float> threshold_;
+
+  bool has_value_ = false;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_SEGMENTATION_RANDOM_MASK_PIXEL_H_
@@ -0,0 +1,301 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "dali/core/cuda_error.h"
+#include "dali/core/cuda_utils.h"
+#include "dali/core/static_switch.h"
+#include "dali/core/util.h"
+#include "dali/kernels/common/utils.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/operators/segmentation/random_mask_pixel.h"
+#include "dali/pipeline/data/views.h"
+
+namespace dali {
+
+namespace random_mask_pixel {
+
+constexpr int kMaxNdim = 6;
+constexpr int kBlockWidth = 32;
+constexpr int kBlockHeight = 8;
+constexpr int kBlockSize = kBlockWidth * kBlockHeight;
+constexpr int kTileSize = kBlockSize * 16;
+
+template <typename T>
+struct SampleDesc {
+  const T *mask;
+  int64_t *pixel_pos;
+  int64_t size;
+  int ndim;
+  int64_t strides[kMaxNdim];
+  bool has_value;
+  T value;
+  float threshold;
+  /// The foreground pixel is picked at the position `u * count` among all the foreground pixels
+  double u;
+  /// The pixel taken when a foreground one is not requested or there are none
+  int64_t fallback_idx;
+  /// The tiles of the mask, whose foreground pixels are counted; 0 if foreground is not requested
+  int num_tiles;
+  int64_t tile_offset;
+};
+
+template <typename T>
+__device__ __forceinline__ bool IsForeground(const SampleDesc<T> &sample, int64_t idx) {
+  T x = sample.mask[idx];
+  return sample.has_value ? x == sample.value : x > sample.threshold;
+}
+
+/**
+ * @brief Computes the exclusive prefix sum of `val` over the block and returns the total
+ *
+ * @remarks blockDim must be (32, kBlockHeight); it must be called by all the threads of the block
+ */
+template <typename T>
+__device__ T BlockExclusiveScan(T &val) {
+  constexpr unsigned kFullMask = 0xffffffffu;
+  __shared__ T warp_totals[kBlockWidth];
+  T x = val;
+  for (int offset = 1; offset < kBlockWidth; offset <<= 1) {
+    T y = __shfl_up_sync(kFullMask, x, offset);
+    if (threadIdx.x >= offset)
+      x += y;
+  }
+  if (threadIdx.x == kBlockWidth - 1)
+    warp_totals[threadIdx.y] = x;
+  __syncthreads();
+  if (threadIdx.y == 0) {
+    T w = threadIdx.x < blockDim.y ? warp_totals[threadIdx.x] : T(0);
+    for (int offset = 1; offset < kBlockWidth; offset <<= 1) {
+      T y = __shfl_up_sync(kFullMask, w, offset);
+      if (threadIdx.x >= offset)
+        w += y;
+    }
+    warp_totals[threadIdx.x] = w;
+  }
+  __syncthreads();
+  T warp_prefix = threadIdx.y > 0 ? warp_totals[threadIdx.y - 1] : T(0);
+  T total = warp_totals[blockDim.y - 1];
+  val = warp_prefix + x - val;
+  __syncthreads();  // the shared memory is reused by the next call
+  return total;
+}
+
+/**
+ * @brief Counts the foreground pixels in the tiles of the masks; the grid is (tiles x samples)
+ */
+template <typename T>
+__global__ void CountForeground(const SampleDesc<T> *samples, int *tile_counts) {
+  const auto &sample = samples[blockIdx.y];
+  if (static_cast<int>(blockIdx.x) >= sample.num_tiles)
+    return;
+  const int tid = threadIdx.y * blockDim.x + threadIdx.x;
+  const int64_t tile_start = static_cast<int64_t>(blockIdx.x) * kTileSize;
+  const int64_t tile_end = cuda_min(tile_start + kTileSize, sample.size);
+  int count = 0;
+  for (int64_t idx = tile_start + tid; idx < tile_end; idx += kBlockSize)
+    count += IsForeground(sample, idx);
+  int total = BlockExclusiveScan(count);
+  if (tid == 0)
+    tile_counts[sample.tile_offset + blockIdx.x] = total;
+}
+
+/**
+ * @brief Selects the pixel of each sample and writes its coordinates; one block per sample
+ *
+ * The k-th foreground pixel (in the raster order) is located by a prefix sum of the tile counts
+ * and then by a prefix sum of the foreground flags within the tile which contains it.
+ */
+template <typename T>
+__global__ void SelectPixel(const SampleDesc<T> *samples, const int *tile_counts) {
+  const auto &sample = samples[blockIdx.x];
+  const int tid = threadIdx.y * blockDim.x + threadIdx.x;
+  __shared__ int64_t selected_idx;
+  __shared__ int selected_tile;
+  __shared__ int64_t selected_rank;
+  if (tid == 0)
+    selected_idx = sample.fallback_idx;
+  __syncthreads();
+
+  if (sample.num_tiles > 0) {
+    const int *counts = tile_counts + sample.tile_offset;
+    int64_t count = 0;
+    for (int t = tid; t < sample.num_tiles; t += kBlockSize)
+      count += counts[t];
+    int64_t total = BlockExclusiveScan(count);
+
+    if (total > 0) {
+      const int64_t k = cuda_min(static_cast<int64_t>(sample.u * total), total - 1);
+
+      int64_t base = 0;
+      for (int tiles_start = 0; tiles_start < sample.num_tiles; tiles_start += kBlockSize) {
+        int t = tiles_start + tid;
+        int64_t tile_count = t < sample.num_tiles ? counts[t] : 0;
+        int64_t prefix = tile_count;
+        int64_t chunk_total = BlockExclusiveScan(prefix);
+        prefix += base;
+        if (tile_count > 0 && k >= prefix && k < prefix + tile_count) {
+          selected_tile = t;
+          selected_rank = k - prefix;
+        }
+        base += chunk_total;
+        if (base > k)
+          break;
+      }
+      __syncthreads();
+
+      const int64_t rank = selected_rank;
+      const int64_t tile_start = static_cast<int64_t>(selected_tile) * kTileSize;
+      const int64_t tile_end = cuda_min(tile_start + kTileSize, sample.size);
+      int64_t seen = 0;
+      for (int64_t start = tile_start; start < tile_end; start += kBlockSize) {
+        int64_t idx = start + tid;
+        int fg = idx < tile_end && IsForeground(sample, idx);
+        int prefix = fg;
+        int chunk_total = BlockExclusiveScan(prefix);
+        if (fg && seen + prefix == rank)
+          selected_idx = idx;
+        seen += chunk_total;
+        if (seen > rank)
+          break;
+      }
+    }
+  }
+  __syncthreads();
+
+  if (tid == 0) {
+    int64_t flat_idx = selected_idx;
+    for (int d = 0; d < sample.ndim - 1; d++) {
+      sample.pixel_pos[d] = flat_idx / sample.strides[d];
+      flat_idx = flat_idx % sample.strides[d];
+    }
+    sample.pixel_pos[sample.ndim - 1] = flat_idx;
+  }
+}
+
+}  // namespace random_mask_pixel
+
+/**
+ * @brief GPU implementation of RandomMaskPixel
+ *
+ * The random numbers are drawn on the host, before the foreground pixels are counted, so the
+ * whole selection runs on the device, without synchronization.
+ */
+class RandomMaskPixelGPU : public Operator<GPUBackend>, protected RandomMaskPixelAttr {
+ public:
+  explicit RandomMaskPixelGPU(const OpSpec &spec)
+      : Operator<GPUBackend>(spec), RandomMaskPixelAttr(spec, max_batch_size_) {}
+
+  bool CanInferOutputs() const override { return true; }
+  std::string SaveState() override { return rngs_.SaveState(); }
+  void RestoreState(const std::string &state) override { rngs_.RestoreState(state); }
+
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const DeviceWorkspace &ws) override {
+    const auto &in_masks = ws.Input<GPUBackend>(0);
+    int ndim = in_masks.sample_dim();
+    DALI_ENFORCE(ndim >= 1 && ndim <= random_mask_pixel::kMaxNdim,
+                 make_string("Unsupported number of dimensions: ", ndim, "; must be 1..",
+                             random_mask_pixel::kMaxNdim));
+    SetupOutputs(output_desc, spec_, ws, in_masks.num_samples(), ndim);
+    return true;
+  }
+
+  void RunImpl(DeviceWorkspace &ws) override {
+    const auto &in_masks = ws.Input<GPUBackend>(0);
+    TYPE_SWITCH(in_masks.type(), type2id, T, MASK_SUPPORTED_TYPES, (
+      RunImplTyped<T>(ws);
+    ), (  // NOLINT
+      DALI_FAIL(make_string("Unexpected data type: ", in_masks.type()));
+    ));  // NOLINT
+  }
+
+ private:
+  template <typename T>
+  void RunImplTyped(DeviceWorkspace &ws);
+};
+
+template <typename T>
+void RandomMaskPixelGPU::RunImplTyped(DeviceWorkspace &ws) {
+  using namespace random_mask_pixel;  // NOLINT
+  const auto &in_masks = ws.Input<GPUBackend>(0);
+  auto &out_pixel_pos = ws.Output<GPUBackend>(0);
+  int nsamples = in_masks.num_samples();
+  if (nsamples == 0)
+    return;
+  int ndim = in_masks.sample_dim();
+  auto masks_view = view<const T>(in_masks);
+  auto pixel_pos_view = view<int64_t>(out_pixel_pos);
+  auto stream = ws.stream();
+  kernels::DynamicScratchpad scratchpad({}, stream);
+
+  std::vector<SampleDesc<T>> samples(nsamples);
+  int64_t total_tiles = 0;
+  int max_tiles = 0;
+  for (int i = 0; i < nsamples; i++) {
+    auto &sample = samples[i];
+    auto &rng = rngs_[i];
+    const auto &mask_sh = masks_view.shape[i];
+    auto mask_strides = kernels::GetStrides(mask_sh);
+    sample.mask = masks_view.data[i];
+    sample.pixel_pos = pixel_pos_view.data[i];
+    sample.size = volume(mask_sh);
+    sample.ndim = ndim;
+    for (int d = 0; d < ndim; d++)
+      sample.strides[d] = mask_strides[d];
+
+    bool foreground = foreground_[i] && sample.size > 0;
+    sample.has_value = has_value_;
+    sample.value = T();
+    sample.threshold = 0;
+    if (has_value_) {
+      sample.value = static_cast<T>(value_[i]);
+      // as on the CPU, a value which is not representable by T doesn't match any pixel
+      if (static_cast<int>(sample.value) != value_[i])
+        foreground = false;
+    } else {
+      sample.threshold = threshold_[i];
+    }
+
+    sample.u = std::uniform_real_distribution<double>(0, 1)(rng);
+    sample.fallback_idx = 0;
+    for (int d = 0; d < ndim; d++) {
+      if (mask_sh[d] > 0)
+        sample.fallback_idx +=
+            std::uniform_int_distribution<int64_t>(0, mask_sh[d] - 1)(rng) * mask_strides[d];
+    }
+
+    sample.num_tiles = foreground ? div_ceil(sample.size, kTileSize) : 0;
+    sample.tile_offset = total_tiles;
+    total_tiles += sample.num_tiles;
+    max_tiles = std::max(max_tiles, sample.num_tiles);
+  }
+
+  auto *samples_gpu = scratchpad.ToGPU(stream, samples);
+  int *tile_counts = nullptr;
+  dim3 block(kBlockWidth, kBlockHeight);
+  if (max_tiles > 0) {
+    tile_counts = scratchpad.AllocateGPU<int>(total_tiles);
+    CountForeground<<<dim3(max_tiles, nsamples), block, 0, stream>>>(samples_gpu, tile_counts);
+    CUDA_CALL(cudaGetLastError());
+  }
+  SelectPixel<<<nsamples, block, 0, stream>>>(samples_gpu, tile_counts);
+  CUDA_CALL(cudaGetLastError());
+}
+
+DALI_REGISTER_OPERATOR(segmentation__RandomMaskPixel, RandomMaskPixelGPU, GPU);
+
+}  // namespace dali
@@ -28,8 +28,6 @@
 namespace dali {
 
 using dali::kernels::OutTensorCPU;
-using dali::kernels::InTensorCPU;
-using dali::kernels::OutListCPU;
 using dali::kernels::InListCPU;
 
 using kernels::connected_components::LabelConnectedRegions;
@@ -109,17 +107,17 @@ of finding object blobs in previously seen inputs.
 Searching for blobs of connected pixels and finding boxes can take a long time. When the dataset
 has few items, but item size is big, you can use caching to save the boxes and reuse them when
 the same input is seen again. The inputs are compared based on 256-bit hash, which is much faster
-to compute than to recalculate the object boxes.)", false);
+to compute than to recalculate the object boxes.
 
-bool RandomObjectBBox::SetupImpl(vector<OutputDesc> &out_descs, const HostWorkspace &ws) {
-  out_descs.resize(spec_.NumOutput());
-  auto &input = ws.Input<CPUBackend>(0);
-  int ndim = input.sample_dim();
-  int N = input.num_samples();
+.. note::
+  Caching is not supported by the GPU operator.)", false);
 
+void RandomObjectBBoxAttr::SetupOutputs(vector<OutputDesc> &out_descs, const OpSpec &spec,
+                                        const ArgumentWorkspace &ws, int N, int ndim) {
+  out_descs.resize(spec.NumOutput());
   DALI_ENFORCE(N == 0 || (ndim >= 1 && ndim <= 6),
       make_string("Unsuported number of dimensions ", ndim, "; must be 1..6"));
-  AcquireArgs(ws, N, ndim);
+  AcquireArgs(spec, ws, N, ndim);
   out_descs[0].type = DALI_INT32;
   out_descs[0].shape = uniform_list_shape<DynamicDimensions>(
       N, TensorShape<1>{ format_ == Out_Box ? 2*ndim : ndim });
@@ -129,19 +127,24 @@ bool RandomObjectBBox::SetupImpl(vector<OutputDesc> &out_descs, const HostWorksp
     out_descs[class_output_idx_].type = DALI_INT32;
     out_descs[class_output_idx_].shape.resize(N, 0);
   }
+}
 
+bool RandomObjectBBox::SetupImpl(vector<OutputDesc> &out_descs, const HostWorkspace &ws) {
+  auto &input = ws.Input<CPUBackend>(0);
+  SetupOutputs(out_descs, spec_, ws, input.num_samples(), input.sample_dim());
   return true;
 }
 
-void RandomObjectBBox::AcquireArgs(const HostWorkspace &ws, int N, int ndim) {
-  background_.Acquire(spec_, ws, N);
+void RandomObjectBBoxAttr::AcquireArgs(const OpSpec &spec, const ArgumentWorkspace &ws,
+                                       int N, int ndim) {
+  background_.Acquire(spec, ws, N);
   if (classes_.HasExplicitValue())
-    classes_.Acquire(spec_, ws, N);
-  foreground_prob_.Acquire(spec_, ws, N);
+    classes_.Acquire(spec, ws, N);
+  foreground_prob_.Acquire(spec, ws, N);
   if (weights_.HasExplicitValue())
-    weights_.Acquire(spec_, ws, N);
+    weights_.Acquire(spec, ws, N);
   if (threshold_.HasExplicitValue())
-    threshold_.Acquire(spec_, ws, N, TensorShape<1>{ndim});
+    threshold_.Acquire(spec, ws, N, TensorShape<1>{ndim});
 
   if (weights_.HasExplicitValue() && classes_.HasExplicitValue()) {
     DALI_ENFORCE(weights_.get().shape == classes_.get().shape, make_string(
@@ -236,46 +239,7 @@ void FilterByLabel(ThreadPool *tp,
 }
 
 
-template <typename Lo, typename Hi>
-void StoreBox(const OutListCPU<int, 1> &out1,
-              const OutListCPU<int, 1> &out2,
-              RandomObjectBBox::OutputFormat format,
-              int sample_idx, Lo &&start, Hi &&end) {
-  assert(dali::size(start) == dali::size(end));
-  int ndim = dali::size(start);
-  switch (format) {
-    case RandomObjectBBox::Out_Box:
-      for (int i = 0; i < ndim; i++) {
-        out1.data[sample_idx][i] = start[i];
-        out1.data[sample_idx][i + ndim] = end[i];
-      }
-      break;
-    case RandomObjectBBox::Out_AnchorShape:
-      for (int i = 0; i < ndim; i++) {
-        out1.data[sample_idx][i] = start[i];
-        out2.data[sample_idx][i] = end[i] - start[i];
-      }
-      break;
-    case RandomObjectBBox::Out_StartEnd:
-      for (int i = 0; i < ndim; i++) {
-        out1.data[sample_idx][i] = start[i];
-        out2.data[sample_idx][i] = end[i];
-      }
-      break;
-    default:
-      assert(!"Unreachable code");
-  }
-}
-
-template <typename Box>
-void StoreBox(const OutListCPU<int, 1> &out1,
-              const OutListCPU<int, 1> &out2,
-              RandomObjectBBox::OutputFormat format,
-              int sample_idx, Box &&box) {
-  StoreBox(out1, out2, format, sample_idx, box.lo, box.hi);
-}
-
-void RandomObjectBBox::ClassInfo::Init(const int *bg_ptr,
+void RandomObjectBBoxAttr::ClassInfo::Init(const int *bg_ptr,
                                        const InTensorCPU<int, 1> &cls_tv,
                                        const InTensorCPU<float, 1> &weight_tv) {
   Reset();
@@ -340,7 +304,7 @@ void RandomObjectBBox::ClassInfo::Init(const int *bg_ptr,
   }
 }
 
-void RandomObjectBBox::InitClassInfo(int sample_idx) {
+void RandomObjectBBoxAttr::InitClassInfo(int sample_idx) {
   const int *bg = background_.HasExplicitValue() ? background_[sample_idx].data : nullptr;
   InTensorCPU<int, 1> class_tv;
   InTensorCPU<float, 1> weight_tv;
@@ -349,39 +313,6 @@ void RandomObjectBBox::InitClassInfo(int sample_idx) {
   class_info_.Init(bg, class_tv, weight_tv);
 }
 
-template <int ndim>
-int RandomObjectBBox::PickBox(span<Box<ndim, int>> boxes, int sample_idx) {
-  auto beg = boxes.begin();
-  auto end = boxes.end();
-  if (threshold_.HasExplicitValue()) {
-    vec<ndim, int> threshold;
-    const int *thresh = threshold_[sample_idx].data;
-    assert(threshold_.get().shape[sample_idx] == TensorShape<1>{ ndim });
-    for (int i = 0; i < ndim; i++)
-      threshold[i] = thresh[i];
-    end = std::remove_if(beg, end, [threshold](const Box<ndim, int> &box) {
-      return any_coord(box.extent() < threshold);
-    });
-  }
-  int n = end - beg;
-  if (n <= 0)
-    return -1;
-
-  if (k_largest_ > 0 && k_largest_ < n) {
-    SmallVector<std::pair<int64_t, int>, 32> vol_idx;
-    vol_idx.resize(n);
-    for (int i = 0; i < n; i++) {
-      vol_idx[i] = { -volume(boxes[i]), i };
-    }
-    std::sort(vol_idx.begin(), vol_idx.end());
-    std::uniform_int_distribution<int> dist(0, std::min(n, k_largest_)-1);
-    return vol_idx[dist(rngs_[sample_idx])].second;
-  } else {
-    std::uniform_int_distribution<int> dist(0, n-1);
-    return dist(rngs_[sample_idx]);
-  }
-}
-
 template <typename BlobLabel>
 void RandomObjectBBox::GetBoxes(SampleContext<BlobLabel> &ctx, int nblobs) {
   ctx.box_data.clear();
@@ -426,13 +357,13 @@ bool RandomObjectBBox::PickBox(SampleContext<BlobLabel> &ctx) {
   return false;
 }
 
-void RandomObjectBBox::ClassInfo::Reset() {
+void RandomObjectBBoxAttr::ClassInfo::Reset() {
   classes.clear();
   weights.clear();
   cdf.clear();
 }
 
-void RandomObjectBBox::ClassInfo::FromLabels(const LabelSet &labels) {
+void RandomObjectBBoxAttr::ClassInfo::FromLabels(const LabelSet &labels) {
   classes.clear();
   weights.clear();
   for (auto cls : labels) {
@@ -446,7 +377,7 @@ void RandomObjectBBox::ClassInfo::FromLabels(const LabelSet &labels) {
   std::sort(classes.begin(), classes.end());
 }
 
-void RandomObjectBBox::ClassInfo::DisableAbsentClasses(const LabelSet &labels) {
+void RandomObjectBBoxAttr::ClassInfo::DisableAbsentClasses(const LabelSet &labels) {
   for (int i = 0; i < static_cast<int>(classes.size()); i++) {
     if (!labels.count(classes[i]))
       weights[i] = 0;  // label not present - reduce its weight to 0
@@ -17,6 +17,7 @@
 #define DALI_OPERATORS_SEGMENTATION_RANDOM_OBJECT_BBOX_H_
 
 #include <algorithm>
+#include <cassert>
 #include <string>
 #include <random>
 #include <unordered_set>
@@ -28,12 +29,18 @@
 #include "dali/pipeline/util/batch_rng.h"
 #include "dali/kernels/kernel_params.h"
 #include "dali/kernels/common/fast_hash.h"
+#include "dali/core/geom/box.h"
 
 namespace dali {
 
 using kernels::InTensorCPU;
+using kernels::OutListCPU;
 
-class RandomObjectBBox : public Operator<CPUBackend> {
+/**
+ * @brief The arguments of RandomObjectBBox and the random selection of the class and the box,
+ *        common to the CPU and GPU implementations.
+ */
+class RandomObjectBBoxAttr {
  public:
   enum OutputFormat {
     Out_AnchorShape,
@@ -41,10 +48,21 @@ class RandomObjectBBox : public Operator<CPUBackend> {
     Out_Box
   };
 
-  using hash_t = kernels::fast_hash_t;
+  static OutputFormat ParseOutputFormat(const std::string &format)  {
+    if (format == "anchor_shape")
+      return Out_AnchorShape;
+    else if (format == "start_end")
+      return Out_StartEnd;
+    else if (format == "box")
+      return Out_Box;
+
+    DALI_FAIL(make_string("Invalid output format: \"", format, "\"\n"
+      "Possible values: \"anchor_shape\", \"start_end\" and \"box\"."));
+  }
 
-  explicit RandomObjectBBox(const OpSpec &spec) : Operator<CPUBackend>(spec),
-        rngs_(spec.GetArgument<int>("seed"), max_batch_size_),
+ protected:
+  RandomObjectBBoxAttr(const OpSpec &spec, int max_batch_size)
+      : rngs_(spec.GetArgument<int>("seed"), max_batch_size),
         background_("background", spec),
         classes_("classes", spec),
         foreground_prob_("foreground_prob", spec),
@@ -70,32 +88,12 @@ class RandomObjectBBox : public Operator<CPUBackend> {
       DALI_ENFORCE(k_largest_ >= 1, make_string(
                    "``k_largest`` must be at least 1; got ", k_largest_));
     }
-
-    tmp_blob_storage_.set_pinned(false);
-    tmp_filtered_storage_.set_pinned(false);
-  }
-
-  static OutputFormat ParseOutputFormat(const std::string &format)  {
-    if (format == "anchor_shape")
-      return Out_AnchorShape;
-    else if (format == "start_end")
-      return Out_StartEnd;
-    else if (format == "box")
-      return Out_Box;
-
-    DALI_FAIL(make_string("Invalid output format: \"", format, "\"\n"
-      "Possible values: \"anchor_shape\", \"start_end\" and \"box\"."));
-  }
-
-  bool CanInferOutputs() const override {
-    return true;
   }
 
-  bool SetupImpl(vector<OutputDesc> &out_descs, const HostWorkspace &ws) override;
-  void RunImpl(HostWorkspace &ws) override;
+  void SetupOutputs(vector<OutputDesc> &out_descs, const OpSpec &spec,
+                    const ArgumentWorkspace &ws, int N, int ndim);
 
- private:
-  void AcquireArgs(const HostWorkspace &ws, int N, int ndim);
+  void AcquireArgs(const OpSpec &spec, const ArgumentWorkspace &ws, int N, int ndim);
 
   bool HasClassLabelOutput() const {
     return class_output_idx_ >= 0;
@@ -169,8 +167,124 @@ class RandomObjectBBox : public Operator<CPUBackend> {
 
   void InitClassInfo(int sample_idx);
 
-  void GetBgFgAndWeights(ClassVec &classes, WeightVec &weights, int &background, int sample_idx);
+  /**
+   * @brief Picks one of the `boxes` which satisfy the ``threshold`` and ``k_largest`` criteria.
+   *
+   * The boxes meeting the threshold are moved to the front of `boxes`, in their original order.
+   *
+   * @return The index of the selected box or -1, if there's none.
+   */
+  template <int ndim>
+  int PickBox(span<Box<ndim, int>> boxes, int sample_idx) {
+    auto beg = boxes.begin();
+    auto end = boxes.end();
+    if (threshold_.HasExplicitValue()) {
+      vec<ndim, int> threshold;
+      const int *thresh = threshold_[sample_idx].data;
+      assert(threshold_.get().shape[sample_idx] == TensorShape<1>{ ndim });
+      for (int i = 0; i < ndim; i++)
+        threshold[i] = thresh[i];
+      end = std::remove_if(beg, end, [threshold](const Box<ndim, int> &box) {
+        return any_coord(box.extent() < threshold);
+      });
+    }
+    int n = end - beg;
+    if (n <= 0)
+      return -1;
+
+    if (k_largest_ > 0 && k_largest_ < n) {
+      SmallVector<std::pair<int64_t, int>, 32> vol_idx;
+      vol_idx.resize(n);
+      for (int i = 0; i < n; i++) {
+        vol_idx[i] = { -volume(boxes[i]), i };
+      }
+      std::sort(vol_idx.begin(), vol_idx.end());
+      std::uniform_int_distribution<int> dist(0, std::min(n, k_largest_)-1);
+      return vol_idx[dist(rngs_[sample_idx])].second;
+    } else {
+      std::uniform_int_distribution<int> dist(0, n-1);
+      return dist(rngs_[sample_idx]);
+    }
+  }
 
+  template <typename Lo, typename Hi>
+  static void StoreBox(const OutListCPU<int, 1> &out1,
+                       const OutListCPU<int, 1> &out2,
+                       OutputFormat format,
+                       int sample_idx, Lo &&start, Hi &&end) {
+    assert(dali::size(start) == dali::size(end));
+    int ndim = dali::size(start);
+    switch (format) {
+      case Out_Box:
+        for (int i = 0; i < ndim; i++) {
+          out1.data[sample_idx][i] = start[i];
+          out1.data[sample_idx][i + ndim] = end[i];
+        }
+        break;
+      case Out_AnchorShape:
+        for (int i = 0; i < ndim; i++) {
+          out1.data[sample_idx][i] = start[i];
+          out2.data[sample_idx][i] = end[i] - start[i];
+        }
+        break;
+      case Out_StartEnd:
+        for (int i = 0; i < ndim; i++) {
+          out1.data[sample_idx][i] = start[i];
+          out2.data[sample_idx][i] = end[i];
+        }
+        break;
+      default:
+        assert(!"Unreachable code");
+    }
+  }
+
+  template <typename Box>
+  static void StoreBox(const OutListCPU<int, 1> &out1,
+                       const OutListCPU<int, 1> &out2,
+                       OutputFormat format,
+                       int sample_idx, Box &&box) {
+    StoreBox(out1, out2, format, sample_idx, box.lo, box.hi);
+  }
+
+  bool  ignore_class_ = false;
+  int   k_largest_ = -1;          // -1 means no k largest
+  int   class_output_idx_ = -1;   // -1 means no class output
+  BatchRNG<> rngs_;
+  ArgValue<int> background_;
+  ArgValue<int, 1> classes_;
+  ArgValue<float> foreground_prob_;
+  ArgValue<float, 1> weights_;
+  ArgValue<int, 1> threshold_;
+  OutputFormat format_;
+  bool use_cache_ = false;
+};
+
+class RandomObjectBBox : public Operator<CPUBackend>, protected RandomObjectBBoxAttr {
+ public:
+  using hash_t = kernels::fast_hash_t;
+
+  explicit RandomObjectBBox(const OpSpec &spec)
+      : Operator<CPUBackend>(spec), RandomObjectBBoxAttr(spec, max_batch_size_) {
+    tmp_blob_storage_.set_pinned(false);
+    tmp_filtered_storage_.set_pinned(false);
+  }
+
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
+  std::string SaveState() override {
+    return rngs_.SaveState();
+  }
+
+  void RestoreState(const std::string &state) override {
+    rngs_.RestoreState(state);
+  }
+
+  bool SetupImpl(vector<OutputDesc> &out_descs, const HostWorkspace &ws) override;
+  void RunImpl(HostWorkspace &ws) override;
+
+ private:
   void AllocateTempStorage(const TensorVector<CPUBackend> &tls);
 
   template <typename BlobLabel>
@@ -249,24 +363,11 @@ class RandomObjectBBox : public Operator<CPUBackend> {
   template <typename BlobLabel>
   void GetBoxes(SampleContext<BlobLabel> &ctx, int nblobs);
 
+  using RandomObjectBBoxAttr::PickBox;
+
   template <typename BlobLabel>
   bool PickBox(SampleContext<BlobLabel> &ctx);
 
-  template <int ndim>
-  int PickBox(span<Box<ndim, int>> boxes, int sample_idx);
-
-  bool  ignore_class_ = false;
-  int   k_largest_ = -1;          // -1 means no k largest
-  int   class_output_idx_ = -1;   // -1 means no class output
-  BatchRNG<> rngs_;
-  ArgValue<int> background_;
-  ArgValue<int, 1> classes_;
-  ArgValue<float> foreground_prob_;
-  ArgValue<float, 1> weights_;
-  ArgValue<int, 1> threshold_;
-  OutputFormat format_;
-
-  bool use_cache_ = false;
   struct CacheEntry {
     LabelSet labels;
     std::unordered_map<int, vector<int>> class_boxes;
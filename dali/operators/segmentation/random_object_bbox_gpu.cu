@@ -0,0 +1,322 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "dali/core/static_switch.h"
+#include "dali/kernels/common/copy.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/kernels/imgproc/structure/connected_components_gpu.cuh"
+#include "dali/operators/segmentation/random_object_bbox.h"
+#include "dali/pipeline/data/views.h"
+
+namespace dali {
+
+using kernels::connected_components::BlobInfo;
+using kernels::connected_components::LabelConnectedRegionsGPU;
+using kernels::connected_components::GetBlobsGPU;
+
+#define INPUT_TYPES (bool, uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t)
+
+/**
+ * @brief GPU implementation of RandomObjectBBox
+ *
+ * The blobs and their bounding boxes are found on the device; only their summaries (BlobInfo)
+ * are copied to the host, where a box is selected exactly like in the CPU implementation,
+ * so both produce the same results for the same seed.
+ */
+class RandomObjectBBoxGPU : public Operator<GPUBackend>, protected RandomObjectBBoxAttr {
+ public:
+  explicit RandomObjectBBoxGPU(const OpSpec &spec)
+      : Operator<GPUBackend>(spec), RandomObjectBBoxAttr(spec, max_batch_size_) {
+    DALI_ENFORCE(!use_cache_, "``cache_objects`` is not supported by the GPU operator.");
+  }
+
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
+  bool SetupImpl(vector<OutputDesc> &out_descs, const DeviceWorkspace &ws) override {
+    auto &input = ws.Input<GPUBackend>(0);
+    SetupOutputs(out_descs, spec_, ws, input.num_samples(), input.sample_dim());
+    return true;
+  }
+
+  void RunImpl(DeviceWorkspace &ws) override;
+
+ private:
+  template <typename T>
+  void FindBlobs(kernels::DynamicScratchpad &scratchpad, const TensorList<GPUBackend> &input,
+                 cudaStream_t stream);
+
+  template <typename BlobLabel, typename T>
+  void LabelSample(kernels::DynamicScratchpad &scratchpad, const T *in,
+                   const TensorShape<> &shape, int sample_idx, cudaStream_t stream);
+
+  template <typename BlobLabel, typename T>
+  void GetSampleBlobs(const T *in, const TensorShape<> &shape, int sample_idx,
+                      cudaStream_t stream);
+
+  template <int ndim>
+  bool PickForegroundBox(span<BlobInfo> blobs, int sample_idx, Box<ndim, int> &box,
+                         int &class_label);
+
+  bool PickForegroundBox(span<BlobInfo> blobs, int sample_idx, int ndim,
+                         SmallVector<int, 12> &box, int &class_label);
+
+  vector<bool> foreground_;
+  vector<int> sample_bg_;
+  vector<void *> sample_labels_;
+  vector<int64_t> blob_offsets_;
+  int *counters_ = nullptr;  // pinned host: per sample, the number of blobs
+  int *counters_dev_ = nullptr;  // device: per sample, the number of blobs and the blob counter
+  BlobInfo *blobs_dev_ = nullptr;
+  BlobInfo *blobs_ = nullptr;  // pinned host: the blobs of all samples, sorted
+  vector<int> box_data_;
+};
+
+template <typename BlobLabel, typename T>
+void RandomObjectBBoxGPU::LabelSample(kernels::DynamicScratchpad &scratchpad, const T *in,
+                                      const TensorShape<> &shape, int sample_idx,
+                                      cudaStream_t stream) {
+  auto *labels = scratchpad.AllocateGPU<BlobLabel>(volume(shape));
+  sample_labels_[sample_idx] = labels;
+  LabelConnectedRegionsGPU(labels, in, shape, static_cast<T>(sample_bg_[sample_idx]),
+                           counters_dev_ + 2 * sample_idx, stream);
+}
+
+template <typename BlobLabel, typename T>
+void RandomObjectBBoxGPU::GetSampleBlobs(const T *in, const TensorShape<> &shape,
+                                         int sample_idx, cudaStream_t stream) {
+  GetBlobsGPU(blobs_dev_ + blob_offsets_[sample_idx],
+              static_cast<BlobLabel *>(sample_labels_[sample_idx]), in, shape,
+              counters_dev_ + 2 * sample_idx + 1, stream);
+}
+
+template <typename T>
+void RandomObjectBBoxGPU::FindBlobs(kernels::DynamicScratchpad &scratchpad,
+                                    const TensorList<GPUBackend> &input, cudaStream_t stream) {
+  int N = input.num_samples();
+  auto in_view = view<const T>(input);
+  // As on the CPU, the labels are 32-bit, unless the flat indices don't fit
+  auto is_huge = [&](int i) {
+    return in_view.shape[i].num_elements() > 0x80000000;
+  };
+
+  counters_ = scratchpad.AllocatePinned<int>(N);
+  counters_dev_ = scratchpad.AllocateGPU<int>(2 * N);
+  CUDA_CALL(cudaMemsetAsync(counters_dev_, 0, 2 * N * sizeof(int), stream));
+  for (int i = 0; i < N; i++) {
+    if (!foreground_[i])
+      continue;
+    if (is_huge(i))
+      LabelSample<int64_t>(scratchpad, in_view.data[i], in_view.shape[i], i, stream);
+    else
+      LabelSample<int32_t>(scratchpad, in_view.data[i], in_view.shape[i], i, stream);
+  }
+  CUDA_CALL(cudaMemcpy2DAsync(counters_, sizeof(int), counters_dev_, 2 * sizeof(int),
+                              sizeof(int), N, cudaMemcpyDeviceToHost, stream));
+  CUDA_CALL(cudaStreamSynchronize(stream));
+
+  blob_offsets_.resize(N + 1);
+  blob_offsets_[0] = 0;
+  for (int i = 0; i < N; i++)
+    blob_offsets_[i + 1] = blob_offsets_[i] + (foreground_[i] ? counters_[i] : 0);
+  int64_t total_blobs = blob_offsets_[N];
+  blobs_ = nullptr;
+  if (total_blobs == 0)
+    return;
+
+  blobs_dev_ = scratchpad.AllocateGPU<BlobInfo>(total_blobs);
+  for (int i = 0; i < N; i++) {
+    if (!foreground_[i] || blob_offsets_[i + 1] == blob_offsets_[i])
+      continue;
+    if (is_huge(i))
+      GetSampleBlobs<int64_t>(in_view.data[i], in_view.shape[i], i, stream);
+    else
+      GetSampleBlobs<int32_t>(in_view.data[i], in_view.shape[i], i, stream);
+  }
+  blobs_ = scratchpad.AllocatePinned<BlobInfo>(total_blobs);
+  CUDA_CALL(cudaMemcpyAsync(blobs_, blobs_dev_, total_blobs * sizeof(BlobInfo),
+                            cudaMemcpyDeviceToHost, stream));
+  CUDA_CALL(cudaStreamSynchronize(stream));
+  // The blobs are produced in an arbitrary order - sort them in the order of their first elements,
+  // which is the order of the labels assigned by the CPU implementation.
+  for (int i = 0; i < N; i++) {
+    auto *beg = blobs_ + blob_offsets_[i];
+    auto *end = blobs_ + blob_offsets_[i + 1];
+    std::sort(beg, end, [](const BlobInfo &a, const BlobInfo &b) {
+      return a.first < b.first;
+    });
+  }
+}
+
+template <int ndim>
+bool RandomObjectBBoxGPU::PickForegroundBox(span<BlobInfo> blobs, int sample_idx,
+                                            Box<ndim, int> &box, int &class_label) {
+  InitClassInfo(sample_idx);
+  class_label = class_info_.background;
+
+  auto get_box = [](const BlobInfo &blob) {
+    Box<ndim, int> box;
+    for (int d = 0; d < ndim; d++) {
+      box.lo[d] = blob.lo[d];
+      box.hi[d] = blob.hi[d];
+    }
+    return box;
+  };
+  box_data_.resize(2 * ndim * blobs.size());
+  auto *box_data = reinterpret_cast<Box<ndim, int> *>(box_data_.data());
+
+  if (ignore_class_) {
+    int nblobs = blobs.size();
+    for (int i = 0; i < nblobs; i++)
+      box_data[i] = get_box(blobs[i]);
+    int box_idx = PickBox(make_span(box_data, nblobs), sample_idx);
+    if (box_idx < 0)
+      return false;
+    box = box_data[box_idx];
+    return true;
+  }
+
+  LabelSet labels;
+  for (auto &blob : blobs)
+    labels.insert(blob.label);
+
+  if (!classes_.HasExplicitValue() && !weights_.HasExplicitValue()) {
+    class_info_.FromLabels(labels);
+  } else {
+    class_info_.DisableAbsentClasses(labels);
+  }
+
+  while (class_info_.CalculateCDF()) {
+    int class_idx;
+    std::tie(class_idx, class_label) = class_info_.PickClassLabel(rngs_[sample_idx]);
+    if (class_idx < 0)
+      return false;
+
+    assert(class_label != class_info_.background);
+    int nblobs = 0;
+    for (auto &blob : blobs) {
+      if (blob.label == class_label)
+        box_data[nblobs++] = get_box(blob);
+    }
+
+    int box_idx = PickBox(make_span(box_data, nblobs), sample_idx);
+    if (box_idx >= 0) {
+      box = box_data[box_idx];
+      return true;
+    }
+
+    // we couldn't find a satisfactory blob in this class, so let's exclude it and try again
+    class_info_.weights[class_idx] = 0;
+    class_label = class_info_.background;
+  }
+  // we've run out of classes and still there's no good blob
+  return false;
+}
+
+bool RandomObjectBBoxGPU::PickForegroundBox(span<BlobInfo> blobs, int sample_idx, int ndim,
+                                            SmallVector<int, 12> &box, int &class_label) {
+  bool ret = false;
+  box.resize(2 * ndim);
+  VALUE_SWITCH(ndim, static_ndim, (1, 2, 3, 4, 5, 6),
+    (
+      Box<static_ndim, int> selected;
+      ret = PickForegroundBox(blobs, sample_idx, selected, class_label);
+      if (ret) {
+        for (int d = 0; d < static_ndim; d++) {
+          box[d] = selected.lo[d];
+          box[d + static_ndim] = selected.hi[d];
+        }
+      }
+    ), (  // NOLINT
+      DALI_FAIL(make_string("Unsupported number of dimensions: ", ndim, "; must be 1..6"));
+    )  // NOLINT
+  );  // NOLINT
+  return ret;
+}
+
+void RandomObjectBBoxGPU::RunImpl(DeviceWorkspace &ws) {
+  auto &input = ws.Input<GPUBackend>(0);
+  int N = input.num_samples();
+  if (N == 0)
+    return;
+
+  int ndim = input.sample_dim();
+  auto stream = ws.stream();
+  kernels::DynamicScratchpad scratchpad({}, stream);
+
+  // The foreground decisions are drawn first, so that the connected components are only found
+  // in the samples which need them. Each sample has its own generator, so this doesn't change
+  // the outcome compared to the CPU operator.
+  std::uniform_real_distribution<> foreground(0, 1);
+  foreground_.resize(N);
+  sample_bg_.resize(N);
+  sample_labels_.resize(N);
+  for (int i = 0; i < N; i++) {
+    foreground_[i] = foreground(rngs_[i]) < foreground_prob_[i].data[0];
+    InitClassInfo(i);
+    sample_bg_[i] = class_info_.background;
+  }
+
+  TYPE_SWITCH(input.type(), type2id, T, INPUT_TYPES,
+    (FindBlobs<T>(scratchpad, input, stream);),
+    (DALI_FAIL(make_string("Unsupported input type: ", input.type())))
+  );  // NOLINT
+
+  // The outputs are computed on the host and then copied to the device
+  auto out_shape = ws.Output<GPUBackend>(0).shape();
+  int out_size = out_shape.num_elements();
+  OutListCPU<int, 1> out1 = make_tensor_list_cpu(scratchpad.AllocatePinned<int>(out_size),
+                                                 out_shape.to_static<1>());
+  OutListCPU<int, 1> out2;
+  if (format_ != Out_Box)
+    out2 = make_tensor_list_cpu(scratchpad.AllocatePinned<int>(out_size),
+                                out_shape.to_static<1>());
+  OutListCPU<int, 0> class_label_out;
+  if (HasClassLabelOutput())
+    class_label_out = make_tensor_list_cpu(scratchpad.AllocatePinned<int>(N),
+                                           uniform_list_shape<0>(N, TensorShape<0>()));
+
+  TensorShape<> default_anchor;
+  default_anchor.resize(ndim);
+  SmallVector<int, 12> box;
+
+  for (int i = 0; i < N; i++) {
+    int class_label = sample_bg_[i];
+    auto blobs = make_span(blobs_ + blob_offsets_[i],
+                           blob_offsets_[i + 1] - blob_offsets_[i]);
+    if (foreground_[i] && PickForegroundBox(blobs, i, ndim, box, class_label)) {
+      assert(class_label != class_info_.background || ignore_class_);
+      StoreBox(out1, out2, format_, i, make_span(&box[0], ndim), make_span(&box[ndim], ndim));
+    } else {
+      StoreBox(out1, out2, format_, i, default_anchor, input.tensor_shape(i));
+    }
+    if (HasClassLabelOutput())
+      class_label_out.data[i][0] = class_label;
+  }
+
+  kernels::copy(view<int, 1>(ws.Output<GPUBackend>(0)), out1, stream);
+  if (format_ != Out_Box)
+    kernels::copy(view<int, 1>(ws.Output<GPUBackend>(1)), out2, stream);
+  if (HasClassLabelOutput())
+    kernels::copy(view<int, 0>(ws.Output<GPUBackend>(class_output_idx_)), class_label_out,
+                  stream);
+}
+
+DALI_REGISTER_OPERATOR(segmentation__RandomObjectBBox, RandomObjectBBoxGPU, GPU);
+
+}  // namespace dali
@@ -0,0 +1,321 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "dali/core/cuda_utils.h"
+#include "dali/core/format.h"
+#include "dali/core/geom/vec.h"
+#include "dali/core/util.h"
+#include "dali/kernels/common/flat_batch.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/pipeline/operator/arg_helper.h"
+#include "dali/pipeline/operator/operator.h"
+
+namespace dali {
+
+DALI_SCHEMA(segmentation__RasterizePolygons)
+  .DocStr(R"code(Rasterizes segmentation mask polygons into pixelwise masks.
+
+The polygons are given in the format produced by :meth:`nvidia.dali.fn.readers.coco` with
+``polygon_masks=True``. Since the polygons are cheap to transform (e.g. with
+:meth:`nvidia.dali.fn.coord_transform`), the masks can be rasterized only after the
+augmentations, directly at the final resolution, instead of decoding full-resolution masks
+on the CPU and transforming them together with the images.
+
+A pixel belongs to a polygon if its center lies inside the polygon (by the even-odd rule).
+Its value is the label of the mask to which the polygon belongs or, if the ``labels`` are not
+provided, the mask id increased by 1. If the pixel belongs to the polygons of several masks,
+the value is taken from the polygon which appears last in ``polygons``. The pixels which
+don't belong to any polygon are set to 0.
+
+The output is an ``int32`` tensor of shape ``(height, width, 1)``, with the layout ``HWC``,
+like the ``pixelwise_masks`` of :meth:`nvidia.dali.fn.readers.coco`.)code")
+  .NumInput(2, 3)
+  .InputDevice(0, 3, InputDevice::CPU)
+  .NumOutput(1)
+  .InputDox(0, "polygons", "2D TensorList of int",
+            R"code(Polygons, described by 3 columns::
+
+    [[mask_id0, start_vertex_idx0, end_vertex_idx0],
+     [mask_id1, start_vertex_idx1, end_vertex_idx1],
+     ...,
+     [mask_idn, start_vertex_idxn, end_vertex_idxn],]
+
+with ``mask_id`` being the identifier of the mask this polygon belongs to, and
+``[start_vertex_idx, end_vertex_idx)`` describing the range of indices from ``vertices`` that belong to
+this polygon.)code")
+  .InputDox(1, "vertices", "2D TensorList of float",
+            R"code(Vertex coordinates, as ``[[x0, y0], [x1, y1], ...]``.)code")
+  .InputDox(2, "labels", "1D TensorList of int",
+            R"code((Optional) The labels of the masks, indexed by the mask ids.)code")
+  .AddArg("shape", R"code(The size of the output masks, as ``(height, width)``.)code",
+          DALI_INT_VEC, true)
+  .AddOptionalArg("normalized",
+      R"code(If set to True, the vertex coordinates are relative to the size of the mask, in the
+range [0, 1]; otherwise, they're expressed in pixels.)code", false);
+
+namespace {
+
+// The output is processed in tiles of kTileSize x kTileSize pixels; each CUDA block fills one
+constexpr int kTileSize = 32;
+constexpr int kBlockHeight = 8;
+// The number of polygons (overlapping a tile) cached in shared memory
+constexpr int kMaxTilePolygons = 256;
+
+struct RasterPolygon {
+  int value;
+  int vertex_start, num_vertices;  // in the vertices of the whole batch
+  vec2 lo, hi;                     // bounding box, in pixels
+};
+
+struct RasterSampleDesc {
+  int32_t *out;
+  int height, width, tiles_x;
+  int polygon_start, num_polygons;
+};
+
+/**
+ * @brief Tells whether the point lies inside the polygon, by the even-odd rule
+ */
+__device__ bool PointInPolygon(const vec2 *v, int n, vec2 p) {
+  bool inside = false;
+  for (int i = 0, j = n - 1; i < n; j = i++) {
+    if ((v[i].y > p.y) != (v[j].y > p.y) &&
+        p.x < (v[j].x - v[i].x) * (p.y - v[i].y) / (v[j].y - v[i].y) + v[i].x)
+      inside = !inside;
+  }
+  return inside;
+}
+
+/**
+ * @brief Rasterizes the polygons of a batch of samples; each CUDA block fills one tile
+ *
+ * The tile of a block is found in `first_tile`, the prefix sum of the number of tiles of each
+ * sample (nsamples + 1 entries). The first warp gathers the polygons whose bounding boxes overlap
+ * the tile, in their original order, so that each pixel tests only those - starting from the last.
+ */
+__global__ void RasterizePolygonsKernel(const RasterSampleDesc *samples,
+                                        const RasterPolygon *polygons, const vec2 *vertices,
+                                        const int64_t *first_tile, int nsamples) {
+  __shared__ int tile_polygons[kMaxTilePolygons];
+  __shared__ int tile_polygon_count;
+
+  int sample_idx = kernels::FlatSampleIdx(first_tile, nsamples, blockIdx.x);
+  const auto &sample = samples[sample_idx];
+  int tile = blockIdx.x - first_tile[sample_idx];
+  int x0 = tile % sample.tiles_x * kTileSize;
+  int y0 = tile / sample.tiles_x * kTileSize;
+  int x1 = cuda_min(x0 + kTileSize, sample.width);
+  int y1 = cuda_min(y0 + kTileSize, sample.height);
+  const auto *sample_polygons = polygons + sample.polygon_start;
+
+  if (threadIdx.y == 0) {
+    int count = 0;
+    for (int base = 0; base < sample.num_polygons; base += 32) {
+      int i = base + threadIdx.x;
+      bool overlaps = false;
+      if (i < sample.num_polygons) {
+        // the pixel centers of the tile span [x0 + 0.5, x1 - 0.5] x [y0 + 0.5, y1 - 0.5]
+        const auto &p = sample_polygons[i];
+        overlaps = p.lo.x <= x1 - 0.5f && p.hi.x >= x0 + 0.5f &&
+                   p.lo.y <= y1 - 0.5f && p.hi.y >= y0 + 0.5f;
+      }
+      unsigned mask = __ballot_sync(0xffffffffu, overlaps);
+      int pos = count + __popc(mask & ((1u << threadIdx.x) - 1));
+      if (overlaps && pos < kMaxTilePolygons)
+        tile_polygons[pos] = i;
+      count += __popc(mask);
+    }
+    if (threadIdx.x == 0)
+      tile_polygon_count = count;
+  }
+  __syncthreads();
+
+  // If the overlapping polygons don't fit in the shared memory, all the polygons are checked
+  int count = tile_polygon_count;
+  bool cached = count <= kMaxTilePolygons;
+  int n = cached ? count : sample.num_polygons;
+
+  for (int y = y0 + threadIdx.y; y < y1; y += blockDim.y) {
+    for (int x = x0 + threadIdx.x; x < x1; x += blockDim.x) {
+      vec2 center(x + 0.5f, y + 0.5f);
+      int value = 0;
+      for (int k = n - 1; k >= 0; k--) {
+        const auto &p = sample_polygons[cached ? tile_polygons[k] : k];
+        if (center.x < p.lo.x || center.x > p.hi.x || center.y < p.lo.y || center.y > p.hi.y)
+          continue;
+        if (PointInPolygon(vertices + p.vertex_start, p.num_vertices, center)) {
+          value = p.value;
+          break;
+        }
+      }
+      sample.out[static_cast<int64_t>(y) * sample.width + x] = value;
+    }
+  }
+}
+
+}  // namespace
+
+class RasterizePolygonsGPU : public Operator<GPUBackend> {
+ public:
+  explicit RasterizePolygonsGPU(const OpSpec &spec)
+      : Operator<GPUBackend>(spec),
+        shape_("shape", spec),
+        normalized_(spec.GetArgument<bool>("normalized")) {}
+
+ protected:
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
+  bool SetupImpl(std::vector<OutputDesc> &output_descs, const DeviceWorkspace &ws) override {
+    const auto &polygons = ws.Input<CPUBackend>(0);
+    const auto &vertices = ws.Input<CPUBackend>(1);
+    int nsamples = polygons.num_samples();
+    DALI_ENFORCE(polygons.type() == DALI_INT32, make_string(
+        "``polygons`` input is expected to be int32. Got: ", polygons.type()));
+    DALI_ENFORCE(vertices.type() == DALI_FLOAT, make_string(
+        "``vertices`` input is expected to be float. Got: ", vertices.type()));
+    DALI_ENFORCE(vertices.num_samples() == nsamples, make_string(
+        "All the inputs should have the same number of samples. Got: ", nsamples, " and ",
+        vertices.num_samples()));
+    for (int i = 0; i < nsamples; i++) {
+      auto poly_shape = polygons.tensor_shape(i);
+      auto vert_shape = vertices.tensor_shape(i);
+      DALI_ENFORCE(poly_shape.sample_dim() == 2 && poly_shape[1] == 3, make_string(
+          "``polygons`` are expected to be a 2D tensor with 3 columns. Got shape ", poly_shape,
+          " for sample ", i, "."));
+      DALI_ENFORCE(vert_shape.sample_dim() == 2 && vert_shape[1] == 2, make_string(
+          "``vertices`` are expected to be a 2D tensor with 2 columns. Got shape ", vert_shape,
+          " for sample ", i, "."));
+    }
+    if (ws.NumInput() > 2) {
+      const auto &labels = ws.Input<CPUBackend>(2);
+      DALI_ENFORCE(labels.type() == DALI_INT32, make_string(
+          "``labels`` input is expected to be int32. Got: ", labels.type()));
+      DALI_ENFORCE(labels.num_samples() == nsamples, make_string(
+          "All the inputs should have the same number of samples. Got: ", nsamples, " and ",
+          labels.num_samples()));
+    }
+
+    shape_.Acquire(spec_, ws, nsamples, TensorShape<1>{2});
+    output_descs.resize(1);
+    output_descs[0].type = DALI_INT32;
+    auto &out_shape = output_descs[0].shape;
+    out_shape.resize(nsamples, 3);
+    for (int i = 0; i < nsamples; i++) {
+      int h = shape_[i].data[0], w = shape_[i].data[1];
+      DALI_ENFORCE(h >= 0 && w >= 0, make_string(
+          "The ``shape`` must not be negative. Got (", h, ", ", w, ") for sample ", i, "."));
+      out_shape.set_tensor_shape(i, TensorShape<3>{h, w, 1});
+    }
+    return true;
+  }
+
+  void RunImpl(DeviceWorkspace &ws) override {
+    const auto &polygons = ws.Input<CPUBackend>(0);
+    const auto &vertices = ws.Input<CPUBackend>(1);
+    const auto *labels = ws.NumInput() > 2 ? &ws.Input<CPUBackend>(2) : nullptr;
+    auto &output = ws.Output<GPUBackend>(0);
+    output.SetLayout("HWC");
+    int nsamples = polygons.num_samples();
+
+    samples_.resize(nsamples);
+    first_tile_.resize(nsamples + 1);
+    first_tile_[0] = 0;
+    polygons_.clear();
+    vertices_.clear();
+    for (int i = 0; i < nsamples; i++) {
+      auto &sample = samples_[i];
+      sample.out = output.mutable_tensor<int32_t>(i);
+      sample.height = shape_[i].data[0];
+      sample.width = shape_[i].data[1];
+      sample.tiles_x = div_ceil(sample.width, kTileSize);
+      sample.polygon_start = polygons_.size();
+      vec2 scale(1.0f, 1.0f);
+      if (normalized_)
+        scale = vec2(static_cast<float>(sample.width), static_cast<float>(sample.height));
+
+      int vertex_start = vertices_.size();
+      int nvertices = vertices.tensor_shape(i)[0];
+      const auto *in_vertices = reinterpret_cast<const vec2 *>(vertices.tensor<float>(i));
+      for (int v = 0; v < nvertices; v++)
+        vertices_.push_back(in_vertices[v] * scale);
+
+      int npolygons = polygons.tensor_shape(i)[0];
+      const int *in_polygons = polygons.tensor<int>(i);
+      int nlabels = labels ? volume(labels->tensor_shape(i)) : 0;
+      for (int k = 0; k < npolygons; k++) {
+        int mask_id = in_polygons[3 * k], start = in_polygons[3 * k + 1],
+            end = in_polygons[3 * k + 2];
+        DALI_ENFORCE(0 <= start && start <= end && end <= nvertices, make_string(
+            "The vertex range [", start, ", ", end, ") of the polygon ", k, " of sample ", i,
+            " is out of the range of the ", nvertices, " vertices."));
+        DALI_ENFORCE(mask_id >= 0 && (!labels || mask_id < nlabels), make_string(
+            "Invalid mask id ", mask_id, " of the polygon ", k, " of sample ", i,
+            labels ? make_string("; there are ", nlabels, " labels.") : std::string(".")));
+        if (end - start < 3)  // a degenerate polygon doesn't contain any pixel center
+          continue;
+        RasterPolygon p;
+        p.value = labels ? labels->tensor<int>(i)[mask_id] : mask_id + 1;
+        p.vertex_start = vertex_start + start;
+        p.num_vertices = end - start;
+        p.lo = p.hi = vertices_[p.vertex_start];
+        for (int v = p.vertex_start + 1; v < p.vertex_start + p.num_vertices; v++) {
+          p.lo = min(p.lo, vertices_[v]);
+          p.hi = max(p.hi, vertices_[v]);
+        }
+        polygons_.push_back(p);
+      }
+      sample.num_polygons = polygons_.size() - sample.polygon_start;
+
+      int64_t tiles = sample.height > 0 && sample.width > 0
+                    ? div_ceil(sample.height, kTileSize) * sample.tiles_x
+                    : 0;
+      first_tile_[i + 1] = first_tile_[i] + tiles;
+    }
+    int64_t num_tiles = first_tile_[nsamples];
+    if (num_tiles == 0)
+      return;
+
+    auto stream = ws.stream();
+    kernels::DynamicScratchpad scratchpad({}, stream);
+    RasterSampleDesc *samples_dev;
+    RasterPolygon *polygons_dev;
+    vec2 *vertices_dev;
+    int64_t *first_tile_dev;
+    std::tie(samples_dev, polygons_dev, vertices_dev, first_tile_dev) =
+        scratchpad.ToContiguousGPU(stream, samples_, polygons_, vertices_, first_tile_);
+
+    dim3 block(32, kBlockHeight);
+    RasterizePolygonsKernel<<<num_tiles, block, 0, stream>>>(
+        samples_dev, polygons_dev, vertices_dev, first_tile_dev, nsamples);
+    CUDA_CALL(cudaGetLastError());
+  }
+
+ private:
+  ArgValue<int, 1> shape_;
+  const bool normalized_;
+  std::vector<RasterSampleDesc> samples_;
+  std::vector<RasterPolygon> polygons_;
+  std::vector<vec2> vertices_;
+  std::vector<int64_t> first_tile_;
+};
+
+DALI_REGISTER_OPERATOR(segmentation__RasterizePolygons, RasterizePolygonsGPU, GPU);
+
+}  // namespace dali
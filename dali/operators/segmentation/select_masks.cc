@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -58,6 +58,7 @@ they appeared in ``mask_ids`` input::
 )")
     .NumInput(3)
     .NumOutput(2)
+    .InputDevice(0, 2, InputDevice::CPU)
     .InputDox(0, "mask_ids", "1D TensorList of int",
               R"code(List of identifiers of the masks to be selected. The list should not contain duplicates.)code")
     .InputDox(1, "polygons", "2D TensorList of int",
@@ -79,14 +80,18 @@ this polygon.)code")
      ... ,
      [xn, yn, ...]]
 
-The operator accepts vertices with arbitrary number of coordinates.)code")
+The operator accepts vertices with arbitrary number of coordinates.
+
+When the vertices are a GPU input, the vertex data is gathered on the device, while ``mask_ids``
+and ``polygons`` are still expected to be CPU inputs.)code")
     .AddOptionalArg<bool>("reindex_masks",
       R"code(If set to True, the output mask ids are replaced with the indices at which they appeared
 in ``mask_ids`` input.)code",
       false);
 
-bool SelectMasksCPU::SetupImpl(std::vector<OutputDesc> &output_desc,
-                              const workspace_t<CPUBackend> &ws) {
+template <typename Backend>
+bool SelectMasks<Backend>::SetupImpl(std::vector<OutputDesc> &output_desc,
+                                     const workspace_t<Backend> &ws) {
   const auto &in_mask_ids = ws.template Input<CPUBackend>(0);
   auto in_mask_ids_shape = in_mask_ids.shape();
   DALI_ENFORCE(in_mask_ids.type() == DALI_INT32, "``mask_ids`` input is expected to be int32");
@@ -100,7 +105,7 @@ bool SelectMasksCPU::SetupImpl(std::vector<OutputDesc> &output_desc,
                make_string("``polygons`` input is expected to be 2D. Got ",
                            in_polygons_shape.sample_dim(), "D"));
 
-  const auto &in_vertices = ws.template Input<CPUBackend>(2);
+  const auto &in_vertices = ws.template Input<Backend>(2);
   auto in_vertices_shape = in_vertices.shape();
   DALI_ENFORCE(in_vertices_shape.sample_dim() == 2,
                make_string("``vertices`` input is expected to be 2D. Got ",
@@ -191,11 +196,12 @@ bool SelectMasksCPU::SetupImpl(std::vector<OutputDesc> &output_desc,
   return true;
 }
 
+template class SelectMasks<CPUBackend>;
+template class SelectMasks<GPUBackend>;
+
 template <typename T>
 void SelectMasksCPU::RunImplTyped(workspace_t<CPUBackend> &ws) {
   // Inputs were already validated and input 0 was already parsed in SetupImpl
-  const auto &in_polygons = ws.template Input<CPUBackend>(1);
-  const auto &in_polygons_view = view<const int32_t, 2>(in_polygons);
   auto &out_polygons = ws.template Output<CPUBackend>(0);
   const auto &out_polygons_view = view<int32_t, 2>(out_polygons);
 
@@ -204,29 +210,20 @@ void SelectMasksCPU::RunImplTyped(workspace_t<CPUBackend> &ws) {
   auto &out_vertices = ws.template Output<CPUBackend>(1);
   const auto &out_vertices_view = reinterpret_view<T, 2>(out_vertices);
 
-  for (int i = 0; i < in_polygons_view.num_samples(); i++) {
-    const auto &selected_masks = samples_[i].selected_masks;
-    const auto &polygons = samples_[i].polygons;
+  for (int i = 0; i < out_polygons_view.num_samples(); i++) {
     auto *out_polygons_data = out_polygons_view.tensor_data(i);
     auto *out_vertices_data = out_vertices_view.tensor_data(i);
-    auto out_vertices_shape = out_vertices_view.tensor_shape_span(i);
+    auto vertex_ndim = out_vertices_view.tensor_shape_span(i)[1];
     const auto *in_vertices_data = in_vertices_view.tensor_data(i);
-    int64_t out_vertex_i = 0;
-    for (int64_t k = 0; k < selected_masks.size(); k++) {
-      int mask_id = selected_masks[k];
-      auto it = polygons.find(mask_id);
-      assert(it != polygons.end());
-      const auto &poly = it->second;
+    ForEachSelectedPolygon(i, [&](const PolygonDesc &poly, int64_t out_vertex_i) {
       int64_t nvertices = poly.end_vertex - poly.start_vertex;
       *out_polygons_data++ = poly.new_mask_id;
       *out_polygons_data++ = out_vertex_i;  // start vertex
       *out_polygons_data++ = out_vertex_i + nvertices;  // end vertex
-      auto vertex_ndim = out_vertices_shape[1];
       auto *in_vertex_data = in_vertices_data + poly.start_vertex * vertex_ndim;
       for (int64_t j = 0; j < nvertices * vertex_ndim; j++)
         *out_vertices_data++ = in_vertex_data[j];
-      out_vertex_i += nvertices;
-    }
+    });
   }
 }
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -21,30 +21,31 @@
 #include "dali/core/common.h"
 #include "dali/core/span.h"
 #include "dali/core/tensor_shape.h"
+#include "dali/kernels/common/scatter_gather.h"
 #include "dali/pipeline/operator/operator.h"
 
 namespace dali {
 
-
-class SelectMasksCPU : public Operator<CPUBackend> {
+/**
+ * @brief Selects the polygons of the masks - common to the CPU and GPU implementations
+ *
+ * The mask ids and the polygons are always CPU inputs; only the vertices may reside on the GPU.
+ */
+template <typename Backend>
+class SelectMasks : public Operator<Backend> {
  public:
-  explicit SelectMasksCPU(const OpSpec &spec)
-      : Operator<CPUBackend>(spec), reindex_masks_(spec.GetArgument<bool>("reindex_masks")) {}
+  explicit SelectMasks(const OpSpec &spec)
+      : Operator<Backend>(spec), reindex_masks_(spec.GetArgument<bool>("reindex_masks")) {}
 
-  ~SelectMasksCPU() override = default;
-  DISABLE_COPY_MOVE_ASSIGN(SelectMasksCPU);
+  ~SelectMasks() override = default;
+  DISABLE_COPY_MOVE_ASSIGN(SelectMasks);
 
  protected:
   bool CanInferOutputs() const override {
     return true;
   }
 
-  bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<CPUBackend> &ws) override;
-  void RunImpl(workspace_t<CPUBackend> &ws) override;
-
- private:
-  template <typename T>
-  void RunImplTyped(workspace_t<CPUBackend> &ws);
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override;
 
   struct PolygonDesc {
     int new_mask_id = -1;
@@ -60,11 +61,56 @@ class SelectMasksCPU : public Operator<CPUBackend> {
       polygons.clear();
     }
   };
+
+  /**
+   * @brief Calls `fn(poly, out_start_vertex)` for the selected polygons of a sample,
+   *        in the output order
+   */
+  template <typename Fn>
+  void ForEachSelectedPolygon(int sample_idx, Fn &&fn) const {
+    const auto &selected_masks = samples_[sample_idx].selected_masks;
+    const auto &polygons = samples_[sample_idx].polygons;
+    int64_t out_vertex_i = 0;
+    for (int64_t k = 0; k < selected_masks.size(); k++) {
+      auto it = polygons.find(selected_masks[k]);
+      assert(it != polygons.end());
+      const auto &poly = it->second;
+      fn(poly, out_vertex_i);
+      out_vertex_i += poly.end_vertex - poly.start_vertex;
+    }
+  }
+
   std::vector<SampleDesc> samples_;
 
   bool reindex_masks_;
 };
 
+class SelectMasksCPU : public SelectMasks<CPUBackend> {
+ public:
+  explicit SelectMasksCPU(const OpSpec &spec) : SelectMasks<CPUBackend>(spec) {}
+
+ protected:
+  void RunImpl(workspace_t<CPUBackend> &ws) override;
+
+ private:
+  template <typename T>
+  void RunImplTyped(workspace_t<CPUBackend> &ws);
+};
+
+/**
+ * @brief Writes the output polygons on the host and gathers the selected vertices on the device
+ */
+class SelectMasksGPU : public SelectMasks<GPUBackend> {
+ public:
+  explicit SelectMasksGPU(const OpSpec &spec) : SelectMasks<GPUBackend>(spec) {}
+
+ protected:
+  void RunImpl(workspace_t<GPUBackend> &ws) override;
+
+ private:
+  kernels::ScatterGatherGPU sg_;
+};
+
 }  // namespace dali
 
 #endif  // DALI_OPERATORS_SEGMENTATION_SELECT_MASKS_H_
@@ -0,0 +1,58 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/operators/segmentation/select_masks.h"
+#include "dali/kernels/common/copy.h"
+#include "dali/kernels/dynamic_scratchpad.h"
+#include "dali/pipeline/data/views.h"
+
+namespace dali {
+
+void SelectMasksGPU::RunImpl(workspace_t<GPUBackend> &ws) {
+  // Inputs were already validated and input 0 was already parsed in SetupImpl
+  const auto &in_vertices = ws.Input<GPUBackend>(2);
+  auto &out_polygons = ws.Output<GPUBackend>(0);
+  auto &out_vertices = ws.Output<GPUBackend>(1);
+  auto stream = ws.stream();
+  kernels::DynamicScratchpad scratchpad({}, stream);
+
+  // The polygons are computed on the host and then copied to the device
+  auto out_polygons_shape = out_polygons.shape().to_static<2>();
+  auto out_polygons_cpu = make_tensor_list_cpu(
+      scratchpad.AllocatePinned<int32_t>(out_polygons_shape.num_elements()), out_polygons_shape);
+
+  size_t element_size = in_vertices.type_info().size();
+  for (int i = 0; i < out_polygons_cpu.num_samples(); i++) {
+    auto *out_polygons_data = out_polygons_cpu.tensor_data(i);
+    size_t vertex_size = in_vertices.tensor_shape_span(i)[1] * element_size;
+    auto *out_vertices_data = static_cast<uint8_t *>(out_vertices.raw_mutable_tensor(i));
+    const auto *in_vertices_data = static_cast<const uint8_t *>(in_vertices.raw_tensor(i));
+    ForEachSelectedPolygon(i, [&](const PolygonDesc &poly, int64_t out_vertex_i) {
+      int64_t nvertices = poly.end_vertex - poly.start_vertex;
+      *out_polygons_data++ = poly.new_mask_id;
+      *out_polygons_data++ = out_vertex_i;  // start vertex
+      *out_polygons_data++ = out_vertex_i + nvertices;  // end vertex
+      if (nvertices > 0)
+        sg_.AddCopy(out_vertices_data + out_vertex_i * vertex_size,
+                    in_vertices_data + poly.start_vertex * vertex_size, nvertices * vertex_size);
+    });
+  }
+
+  kernels::copy(view<int32_t, 2>(out_polygons), out_polygons_cpu, stream);
+  sg_.Run(stream);
+}
+
+DALI_REGISTER_OPERATOR(segmentation__SelectMasks, SelectMasksGPU, GPU);
+
+}  // namespace dali
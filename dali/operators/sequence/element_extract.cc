@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
 #include "dali/operators/sequence/element_extract.h"
 #include "dali/core/error_handling.h"
 
@@ -28,10 +29,13 @@ For example, for ``element_map = [2, 0, 3]`` there will be three outputs, contai
 
 The input layout, if provided, must begin with ``F`` dimension. The outputs will have one less
 dimension than the input, that is for ``FHWC`` inputs, the outputs will be ``HWC`` elements.
+
+The CPU operator doesn't copy the data - the outputs reference the elements in the input buffer.
 )code")
     .NumInput(1)
     .NumOutput(1)
     .SequenceOperator()
+    .PassThroughToAllOutputs(0)
     .AddArg("element_map",
         R"code(Indices of the elements to extract.)code",
         DALI_INT_VEC)
@@ -45,8 +49,36 @@ dimension than the input, that is for ``FHWC`` inputs, the outputs will be ``HWC
 
 
 template <>
-void ElementExtract<CPUBackend>::RunCopies(HostWorkspace &ws) {
-  scatter_gather_.Run(ws.GetThreadPool(), true);
+void ElementExtract<CPUBackend>::RunImpl(HostWorkspace &ws) {
+  const auto &input = ws.Input<CPUBackend>(0);
+  auto element_layout = VideoLayoutInfo::GetFrameLayout(input.GetLayout());
+  int nsamples = input.num_samples();
+  auto type = input.type();
+  auto type_size = input.type_info().size();
+  for (int k = 0; k < static_cast<int>(element_map_.size()); k++) {
+    int element = element_map_[k];
+    auto &output = ws.Output<CPUBackend>(k);
+    // The elements are contiguous slices of the input samples - share them instead of copying
+    output.Reset();
+    output.set_type(type);
+    output.set_sample_dim(input.sample_dim() - 1);
+    output.set_order(input.order());
+    output.set_pinned(input.is_pinned());
+    output.SetSize(nsamples);
+    if (nsamples == 0)
+      continue;
+    output.SetLayout(element_layout);
+    for (int i = 0; i < nsamples; i++) {
+      auto sample_shape = input.tensor_shape(i);
+      auto element_shape = sample_shape.last(sample_shape.sample_dim() - 1);
+      size_t element_bytes = volume(element_shape) * type_size;
+      auto owner = unsafe_sample_owner(input, i);
+      shared_ptr<void> element_ptr(owner, static_cast<uint8_t *>(owner.get()) +
+                                              element * element_bytes);
+      output.UnsafeSetSample(i, element_ptr, element_bytes, input.is_pinned(), element_shape,
+                             type, input.order(), element_layout);
+    }
+  }
 }
 
 DALI_REGISTER_OPERATOR(ElementExtract, ElementExtract<CPUBackend>, CPU);
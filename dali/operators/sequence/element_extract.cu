@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -19,7 +19,25 @@
 namespace dali {
 
 template <>
-void ElementExtract<GPUBackend>::RunCopies(DeviceWorkspace &ws) {
+void ElementExtract<GPUBackend>::RunImpl(DeviceWorkspace &ws) {
+  const auto &input = ws.Input<GPUBackend>(0);
+  auto element_layout = VideoLayoutInfo::GetFrameLayout(input.GetLayout());
+  int elements_per_sample = element_map_.size();
+  auto element_type_size = input.type_info().size();
+  for (int k = 0; k < elements_per_sample; k++) {
+    int element = element_map_[k];
+    auto &output = ws.Output<GPUBackend>(k);
+    for (int i = 0; i < input.num_samples(); i++) {
+      auto tensor_shape = input.tensor_shape(i);
+      auto element_size = volume(tensor_shape.begin() + 1, tensor_shape.end());
+      auto input_offset_bytes = element * element_size * element_type_size;
+      scatter_gather_.AddCopy(
+          output.raw_mutable_tensor(i),
+          static_cast<const uint8_t *>(input.raw_tensor(i)) + input_offset_bytes,
+          element_size * element_type_size);
+    }
+    output.SetLayout(element_layout);
+  }
   scatter_gather_.Run(ws.stream(), true);
 }
 
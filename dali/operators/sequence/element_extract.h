@@ -83,7 +83,8 @@ class ElementExtract : public Operator<Backend> {
 
  protected:
   bool CanInferOutputs() const override {
-    return true;
+    // On the CPU, the outputs are views of the input frames, so they are not allocated upfront
+    return !std::is_same<Backend, CPUBackend>::value;
   }
 
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override {
@@ -94,32 +95,10 @@ class ElementExtract : public Operator<Backend> {
       desc.shape = output_shape;
       desc.type = input.type();
     }
-    return true;
+    return CanInferOutputs();
   }
 
-  void RunImpl(workspace_t<Backend> &ws) override {
-    auto &input = ws.template Input<Backend>(0);
-    auto element_layout = VideoLayoutInfo::GetFrameLayout(input.GetLayout());
-    int elements_per_sample = element_map_.size();
-    auto data_type = input.type_info();
-    for (int k = 0; k < elements_per_sample; k++) {
-      int element = element_map_[k];
-      auto &output = ws.template Output<Backend>(k);
-      for (int i = 0; i < input.num_samples(); i++) {
-        auto tensor_shape = input.tensor_shape(i);
-        auto element_size = volume(tensor_shape.begin() + 1, tensor_shape.end());
-        auto input_offset_bytes = element * element_size * data_type.size();
-        scatter_gather_.AddCopy(
-            output.raw_mutable_tensor(i),
-            static_cast<const uint8_t *>(input.raw_tensor(i)) + input_offset_bytes,
-            element_size * data_type.size());
-      }
-      output.SetLayout(element_layout);
-    }
-    RunCopies(ws);
-  }
-
-  void RunCopies(workspace_t<Backend> &ws);
+  void RunImpl(workspace_t<Backend> &ws) override;
 
   USE_OPERATOR_MEMBERS();
   using Operator<Backend>::RunImpl;
@@ -127,13 +106,10 @@ class ElementExtract : public Operator<Backend> {
  private:
   std::vector<int> element_map_;
 
-  std::conditional_t<
-      std::is_same<Backend, CPUBackend>::value,
-      kernels::ScatterGatherCPU,
-      kernels::ScatterGatherGPU> scatter_gather_;
-  // 256 kB per block for GPU
-  static constexpr size_t kMaxSizePerBlock =
-      std::is_same<Backend, CPUBackend>::value ? kernels::ScatterGatherCPU::kAnyBlockSize : 1 << 18;
+  // used only by the GPU operator - the CPU one doesn't copy the data
+  kernels::ScatterGatherGPU scatter_gather_;
+  // 256 kB per block
+  static constexpr size_t kMaxSizePerBlock = 1 << 18;
 };
 
 }  // namespace dali
@@ -83,6 +83,15 @@ come from an external source. When this option is enabled, the operator requires
                 .AddOptionalArg(detail::kImageTypeArgName,
                                 R"code(Input color space (RGB, BGR or GRAY).)code", DALI_RGB,
                                 false)
+                .AddOptionalArg(detail::kNumSessionsArgName,
+                                R"code(The number of optical flow sessions, which process
+different sequences of the batch concurrently.
+
+Each session has its own CUDA stream, so the sessions can use several optical flow engines of
+the GPU, if it has them. The sequences are divided between the sessions by size, so that a session
+is reconfigured only when the size of its next sequence changes. The additional sessions are
+created when there are enough sequences to use them.
+)code", 1, false)
                 .AllowSequences();
 
 
@@ -115,60 +124,79 @@ void OpticalFlow<GPUBackend>::RunImpl(Workspace<GPUBackend> &ws) {
                    "Performance may be affected.");
   }
 
-  if (of_stream != ws.stream()) {
-    CUDA_CALL(cudaEventRecord(sync_, ws.stream()));
-    CUDA_CALL(cudaStreamWaitEvent(of_stream, sync_, 0));
-  }
   const auto &input = ws.Input<GPUBackend>(0);
   auto &output = ws.Output<GPUBackend>(0);
   output.SetLayout("FHWC");  // Channels represent the two flow vector components (x and y)
 
   auto input_sh = input.shape();
 
+  // Prepare input and output TensorViews
+  auto tvlin = view<const uint8_t, kNInputDims>(input);
+  auto tvlout = view<float, kNInputDims>(output);
+  TensorListView<StorageGPU, const float, kNInputDims> tvlhints;
   if (enable_external_hints_) {
-    const auto &hints = ws.Input<GPUBackend>(1);
-
-    // Prepare input and output TensorViews
-    auto tvlin = view<const uint8_t, kNInputDims>(input);
-    auto tvlout = view<float, kNInputDims>(output);
-    auto tvlhints = view<const float, kNInputDims>(hints);
+    tvlhints = view<const float, kNInputDims>(ws.Input<GPUBackend>(1));
     DALI_ENFORCE(tvlhints.size() == nsequences_,
                  "Number of tensors for hints and inputs doesn't match");
-    for (int j = 0; j < nsequences_; j++) {
-      int sequence_idx = processing_order_[j].idx;
-      auto sequence_tv = tvlin[sequence_idx];
-      auto output_tv = tvlout[sequence_idx];
-      auto hints_tv = tvlhints[sequence_idx];
-
-      for (int i = 1; i < sequence_tv.shape[0]; i++) {
-        auto ref = subtensor(sequence_tv, i - 1);
-        auto in = subtensor(sequence_tv, i);
-        auto h = subtensor(hints_tv, i);
-        auto out = subtensor(output_tv, i - 1);
-
-        optical_flow_->Prepare(input_sh[sequence_idx][2], input_sh[sequence_idx][1]);
-        optical_flow_->CalcOpticalFlow(ref, in, out, h);
+  }
+
+  bool extra_sessions = false;
+  for (size_t s = 1; s < sessions_.size(); s++) {
+    if (sessions_[s].sequences.empty())
+      continue;
+    int first = sessions_[s].sequences[0];
+    LazyInitSession(s, input_sh[first][2], input_sh[first][1]);
+    extra_sessions = true;
+  }
+
+  if (of_stream != ws.stream() || extra_sessions) {
+    CUDA_CALL(cudaEventRecord(sync_, ws.stream()));
+  }
+  if (of_stream != ws.stream()) {
+    CUDA_CALL(cudaStreamWaitEvent(of_stream, sync_, 0));
+  }
+  for (size_t s = 1; s < sessions_.size(); s++) {
+    if (!sessions_[s].sequences.empty())
+      CUDA_CALL(cudaStreamWaitEvent(sessions_[s].stream, sync_, 0));
+  }
+
+  auto calc_sequence = [&](optical_flow::OpticalFlowAdapter<ComputeGPU> &optical_flow,
+                           int sequence_idx) {
+    auto sequence_tv = tvlin[sequence_idx];
+    auto output_tv = tvlout[sequence_idx];
+    for (int i = 1; i < sequence_tv.shape[0]; i++) {
+      auto ref = subtensor(sequence_tv, i - 1);
+      auto in = subtensor(sequence_tv, i);
+      auto out = subtensor(output_tv, i - 1);
+
+      optical_flow.Prepare(input_sh[sequence_idx][2], input_sh[sequence_idx][1]);
+      if (enable_external_hints_) {
+        auto h = subtensor(tvlhints[sequence_idx], i);
+        optical_flow.CalcOpticalFlow(ref, in, out, h);
+      } else {
+        optical_flow.CalcOpticalFlow(ref, in, out);
       }
     }
-  } else {
-    // Prepare input and output TensorViews
-    auto tvlin = view<const uint8_t, kNInputDims>(input);
-    auto tvlout = view<float, kNInputDims>(output);
-
-    for (int j = 0; j < nsequences_; j++) {
-      int sequence_idx = processing_order_[j].idx;
-      auto sequence_tv = tvlin[sequence_idx];
-      auto output_tv = tvlout[sequence_idx];
-
-      for (int i = 1; i < sequence_tv.shape[0]; i++) {
-        auto ref = subtensor(sequence_tv, i - 1);
-        auto in = subtensor(sequence_tv, i);
-        auto out = subtensor(output_tv, i - 1);
-
-        optical_flow_->Prepare(input_sh[sequence_idx][2], input_sh[sequence_idx][1]);
-        optical_flow_->CalcOpticalFlow(ref, in, out);
-      }
+  };
+
+  // The sessions get their sequences in turns, so that they all start computing early
+  for (size_t k = 0;; k++) {
+    bool submitted = false;
+    for (auto &session : sessions_) {
+      if (k >= session.sequences.size())
+        continue;
+      calc_sequence(*session.optical_flow, session.sequences[k]);
+      submitted = true;
     }
+    if (!submitted)
+      break;
+  }
+
+  for (size_t s = 1; s < sessions_.size(); s++) {
+    if (sessions_[s].sequences.empty())
+      continue;
+    CUDA_CALL(cudaEventRecord(sessions_[s].done, sessions_[s].stream));
+    CUDA_CALL(cudaStreamWaitEvent(ws.stream(), sessions_[s].done, 0));
   }
   if (of_stream != ws.stream()) {
     CUDA_CALL(cudaEventRecord(sync_, of_stream));
@@ -15,10 +15,12 @@
 #ifndef DALI_OPERATORS_SEQUENCE_OPTICAL_FLOW_OPTICAL_FLOW_H_
 #define DALI_OPERATORS_SEQUENCE_OPTICAL_FLOW_OPTICAL_FLOW_H_
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
 #include "dali/core/cuda_event.h"
+#include "dali/core/cuda_stream_pool.h"
 #include "dali/operators/sequence/optical_flow/optical_flow_adapter/optical_flow_stub.h"
 #include "dali/operators/sequence/optical_flow/optical_flow_impl/optical_flow_impl.h"
 #include "dali/pipeline/data/backend.h"
@@ -46,6 +48,7 @@ static const std::string kHintGridArgName = "hint_grid";
 static const std::string kEnableTemporalHintsArgName = "enable_temporal_hints";   // NOLINT
 static const std::string kEnableExternalHintsArgName = "enable_external_hints";   // NOLINT
 static const std::string kImageTypeArgName = "image_type";                        // NOLINT
+static const std::string kNumSessionsArgName = "num_sessions";                    // NOLINT
 
 }  // namespace detail
 
@@ -63,14 +66,17 @@ class OpticalFlow : public Operator<Backend> {
         enable_external_hints_(spec.GetArgument<bool>(detail::kEnableExternalHintsArgName)),
         of_params_({quality_factor_, out_grid_size_, hint_grid_size_, enable_temporal_hints_,
                     enable_external_hints_}),
-        optical_flow_(std::unique_ptr<optical_flow::OpticalFlowAdapter<ComputeBackend>>(
-            new optical_flow::OpticalFlowStub<ComputeBackend>(of_params_))),
+        num_sessions_(spec.GetArgument<int>(detail::kNumSessionsArgName)),
         image_type_(spec.GetArgument<DALIImageType>(detail::kImageTypeArgName)),
         device_id_(spec.GetArgument<int>("device_id")) {
     // In case external hints are enabled, we need 2 inputs
     DALI_ENFORCE((enable_external_hints_ && spec.NumInput() == 2) || !enable_external_hints_,
                  "Incorrect number of inputs. Expected: 2, Obtained: " +
                  std::to_string(spec.NumInput()));
+    DALI_ENFORCE(num_sessions_ >= 1, make_string(
+        "The number of optical flow sessions must be positive. Got: ", num_sessions_));
+    sessions_.resize(num_sessions_);
+    sessions_[0].optical_flow.reset(new optical_flow::OpticalFlowStub<ComputeBackend>(of_params_));
     sync_ = CUDAEvent::Create(device_id_);
 #if NVML_ENABLED
     nvml::Init();
@@ -119,10 +125,12 @@ class OpticalFlow : public Operator<Backend> {
     std::sort(processing_order_.begin(), processing_order_.end());
 
     of_lazy_init(input_sh[0][2], input_sh[0][1], depth_, image_type_, device_id_, of_stream);
+    // the sessions on separate streams would be serialized on the default stream anyway
+    AssignSessions(of_stream == ws.stream() ? num_sessions_ : 1);
 
     TensorListShape<> new_sizes(nsequences_, 4);
     for (int i = 0; i < nsequences_; i++) {
-      auto out_shape = optical_flow_->CalcOutputShape(input_sh[i][1], input_sh[i][2]);
+      auto out_shape = sessions_[0].optical_flow->CalcOutputShape(input_sh[i][1], input_sh[i][2]);
       auto shape = shape_cat(sequence_sizes_[i] - 1, out_shape);
       new_sizes.set_tensor_shape(i, shape);
     }
@@ -145,6 +153,7 @@ class OpticalFlow : public Operator<Backend> {
                     int device_id, cudaStream_t stream) {
     std::call_once(of_initialized_,
                    [&]() {
+                       auto &optical_flow_ = sessions_[0].optical_flow;
                        optical_flow_.reset(
                                new optical_flow::OpticalFlowImpl(of_params_,
                                                                  width,
@@ -166,7 +175,7 @@ class OpticalFlow : public Operator<Backend> {
     nsequences_ = shape.size();
     DALI_ENFORCE(shape.sample_dim() == 4, "Input for Optical Flow must be a sequence of frames.");
     depth_ = shape[0][3];
-    sequence_sizes_.reserve(nsequences_);
+    sequence_sizes_.resize(nsequences_);
     for (int i = 0; i < nsequences_; i++) {
       sequence_sizes_[i] = shape[i][0];
     }
@@ -202,6 +211,58 @@ class OpticalFlow : public Operator<Backend> {
                  "Width, height and depth must be equal for all hints");
   }
 
+  /**
+   * @brief Splits the sequences, in the processing order, into contiguous ranges with similar
+   *        numbers of frame pairs - one range for each of the first `nsessions` sessions.
+   *
+   * The ranges follow the order of the sizes, so each session is reconfigured only when its next
+   * sequence has a different size, as with a single session. A whole sequence is processed by one
+   * session, which keeps the temporal hints valid.
+   */
+  void AssignSessions(int nsessions) {
+    int64_t total_pairs = 0;
+    for (int i = 0; i < nsequences_; i++)
+      total_pairs += sequence_sizes_[i] - 1;
+    for (auto &session : sessions_)
+      session.sequences.clear();
+    int64_t assigned_pairs = 0;
+    int session_idx = 0;
+    for (auto &seq : processing_order_) {
+      // move on to the next session when this one got its share of the work
+      while (session_idx + 1 < nsessions &&
+             assigned_pairs * nsessions >= total_pairs * (session_idx + 1))
+        session_idx++;
+      sessions_[session_idx].sequences.push_back(seq.idx);
+      assigned_pairs += sequence_sizes_[seq.idx] - 1;
+    }
+  }
+
+  /**
+   * @brief Creates the optical flow of an additional session, with its own stream, when
+   *        the session gets its first work.
+   */
+  void LazyInitSession(int session_idx, size_t width, size_t height) {
+    auto &session = sessions_[session_idx];
+    if (session.optical_flow)
+      return;
+    session.stream = CUDAStreamPool::instance().Get(device_id_,
+                                                    this->default_cuda_stream_priority_);
+    session.done = CUDAEvent::Create(device_id_);
+    session.optical_flow.reset(new optical_flow::OpticalFlowImpl(of_params_, width, height,
+                                                                 depth_, image_type_, device_id_,
+                                                                 session.stream));
+    session.optical_flow->Init(of_params_);
+  }
+
+  struct Session {
+    std::unique_ptr<optical_flow::OpticalFlowAdapter<ComputeBackend>> optical_flow;
+    /// The stream of an additional session; the first one uses the stream of the operator
+    CUDAStreamLease stream;
+    CUDAEvent done;
+    /// The indices of the sequences of the current batch processed by this session
+    std::vector<int> sequences;
+  };
+
   struct DimsOrder {
     std::pair<int, int> dims;
     int idx;
@@ -217,7 +278,8 @@ class OpticalFlow : public Operator<Backend> {
   const bool enable_external_hints_;
   std::once_flag of_initialized_;
   optical_flow::OpticalFlowParams of_params_;
-  std::unique_ptr<optical_flow::OpticalFlowAdapter<ComputeBackend>> optical_flow_;
+  int num_sessions_;
+  std::vector<Session> sessions_;
   DALIImageType image_type_;
   int device_id_;
   int frames_width_ = -1, frames_height_ = -1, depth_ = -1, nsequences_ = -1;
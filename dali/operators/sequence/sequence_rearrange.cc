@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
 #include <vector>
 
 #include "dali/operators/sequence/sequence_rearrange.h"
@@ -22,10 +23,14 @@ DALI_SCHEMA(SequenceRearrange)
     .DocStr(R"code(Rearranges frames in a sequence.
 
 Assumes that the outermost dimension represents the frame index in the sequence.
-If the input has a non-empty layout description, it must start with ``F`` (frame).)code")
+If the input has a non-empty layout description, it must start with ``F`` (frame).
+
+If, for every sample, ``new_order`` selects a range of consecutive elements in their original
+order, the CPU operator doesn't copy the data - the output references the input buffer.)code")
     .NumInput(1)
     .NumOutput(1)
     .AllowSequences()
+    .PassThrough({{0, 0}})
     .AddArg("new_order", R"code(List that describes the new order for the elements in each sample.
 
 Output sequence at position ``i`` will contain element ``new_order[i]`` from input sequence::
@@ -68,14 +73,53 @@ copy_desc GetCopyDesc(char *output_sample, const char *input_sample, int out_ele
   return result;
 }
 
+bool IsSeqRange(const TensorView<StorageCPU, const int, 1> &new_order) {
+  for (int i = 1; i < new_order.num_elements(); i++) {
+    if (new_order.data[i] != new_order.data[0] + i)
+      return false;
+  }
+  return true;
+}
+
 template <>
 void SequenceRearrange<CPUBackend>::RunImpl(workspace_t<CPUBackend> &ws) {
   const auto &input = ws.Input<CPUBackend>(0);
   auto &output = ws.Output<CPUBackend>(0);
   auto &thread_pool = ws.GetThreadPool();
-  auto out_shape = output.shape();
   auto curr_batch_size = ws.GetInputBatchSize(0);
+  const TypeInfo &type = input.type_info();
+
+  bool share = true;
+  for (int sample_idx = 0; sample_idx < curr_batch_size && share; ++sample_idx)
+    share = IsSeqRange(GetNewOrder(ws, sample_idx));
+
+  output.Reset();
+  if (share) {
+    // Each output sequence is a contiguous part of the input one - reference it
+    output.set_type(type.id());
+    output.set_sample_dim(input.sample_dim());
+    output.set_order(input.order());
+    output.set_pinned(input.is_pinned());
+    output.SetSize(curr_batch_size);
+    if (curr_batch_size == 0)
+      return;
+    output.SetLayout(input.GetLayout());
+    for (int sample_idx = 0; sample_idx < curr_batch_size; ++sample_idx) {
+      const auto &in_shape = input.tensor_shape(sample_idx);
+      auto element_sizeof = volume(in_shape.last(in_shape.sample_dim() - 1)) * type.size();
+      auto out_shape = output_shape_[sample_idx];
+      auto owner = unsafe_sample_owner(input, sample_idx);
+      shared_ptr<void> out_sample(owner, static_cast<char *>(owner.get()) +
+                                             GetNewOrder(ws, sample_idx).data[0] * element_sizeof);
+      output.UnsafeSetSample(sample_idx, out_sample, out_shape[0] * element_sizeof,
+                             input.is_pinned(), out_shape, type.id(), input.order(),
+                             input.GetLayout());
+    }
+    return;
+  }
 
+  output.SetContiguous(true);
+  output.Resize(output_shape_, type.id());
   for (int sample_idx = 0; sample_idx < curr_batch_size; ++sample_idx) {
     thread_pool.AddWork([this, &ws, &input, &output, sample_idx](int tid) {
       const TypeInfo &type = input.type_info();
@@ -83,21 +127,12 @@ void SequenceRearrange<CPUBackend>::RunImpl(workspace_t<CPUBackend> &ws) {
       auto *out_sample = reinterpret_cast<char *>(output.raw_mutable_tensor(sample_idx));
       const auto &in_shape = input.tensor_shape(sample_idx);
       auto element_sizeof = volume(in_shape.last(in_shape.sample_dim() - 1)) * type.size();
-
-      TensorView<StorageCPU, const int, 1> new_order = {};
-
-      if (single_order_) {
-        new_order = TensorView<StorageCPU, const int, 1>(new_order_.data(),
-                                                         TensorShape<1>(new_order_.size()));
-      } else {
-        auto &new_orders = ws.ArgumentInput("new_order");
-        new_order = view<const int, 1>(new_orders[sample_idx]);
-      }
+      auto new_order = GetNewOrder(ws, sample_idx);
       for (int i = 0; i < new_order.shape.num_elements(); i++) {
         auto copy_desc = GetCopyDesc(out_sample, in_sample, i, new_order.data[i], element_sizeof);
         memcpy(copy_desc.to, copy_desc.from, copy_desc.size);
       }
-    }, out_shape.tensor_size(sample_idx));
+    }, output_shape_.tensor_size(sample_idx));
   }
   thread_pool.RunAll();
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,7 @@
 #define DALI_OPERATORS_SEQUENCE_SEQUENCE_REARRANGE_H_
 
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include "dali/core/format.h"
@@ -37,6 +38,12 @@ void ValidateSeqRearrange(const TensorShape<>& in_sample_shape,
 TensorShape<> GetSeqRearrangedShape(const TensorShape<>& in_sample_shape,
                                     const TensorView<StorageCPU, const int, 1>& new_order);
 
+/**
+ * @brief Tells whether `new_order` selects a consecutive range of the elements of the sequence,
+ *        in their original order - so that the output is a contiguous part of the input.
+ */
+bool IsSeqRange(const TensorView<StorageCPU, const int, 1>& new_order);
+
 struct copy_desc {
   const void* from;
   void* to;
@@ -62,7 +69,8 @@ class SequenceRearrange : public Operator<Backend> {
 
  protected:
   bool CanInferOutputs() const override {
-    return true;
+    // The CPU operator allocates the output only if it can't reference the input
+    return !std::is_same<Backend, CPUBackend>::value;
   }
 
   bool SetupImpl(std::vector<OutputDesc>& output_desc, const workspace_t<Backend>& ws) override {
@@ -95,15 +103,24 @@ class SequenceRearrange : public Operator<Backend> {
                              "frames dimension `F`, got data with layout = \"",
                              layout, "\"."));
 
-    return true;
+    output_shape_ = output_desc[0].shape;
+    return CanInferOutputs();
   }
 
   void RunImpl(workspace_t<Backend>& ws) override;
 
+  TensorView<StorageCPU, const int, 1> GetNewOrder(const workspace_t<Backend>& ws,
+                                                   int sample_idx) const {
+    if (single_order_)
+      return {new_order_.data(), TensorShape<1>(new_order_.size())};
+    return view<const int, 1>(ws.ArgumentInput("new_order")[sample_idx]);
+  }
+
  private:
   USE_OPERATOR_MEMBERS();
   bool single_order_ = false;
   std::vector<int> new_order_;
+  TensorListShape<> output_shape_;
   kernels::ScatterGatherGPU scatter_gather_;
   static constexpr size_t kMaxSizePerBlock = 1 << 18;  // 256 kB per block
 };
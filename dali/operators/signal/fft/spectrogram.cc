@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
@@ -98,11 +100,20 @@ struct SpectrogramImplCpu : OpImplBase<CPUBackend> {
   static constexpr int transform_dim = time_major ? 1 : 0;
   using FftKernel = kernels::signal::fft::Fft1DCpu<OutputType, InputType, WindowsDims>;
 
+  /// @brief The minimum number of windows processed in one task
+  static constexpr int64_t kMinWindowsPerTask = 64;
+  /// @brief The number of tasks per thread, which long signals are split into
+  static constexpr int kTasksPerThread = 4;
+
   explicit SpectrogramImplCpu(const OpSpec & spec);
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<CPUBackend> &ws) override;
   void RunImpl(workspace_t<CPUBackend> &ws) override;
 
  private:
+  int64_t NumWindows(int sample_idx) const {
+    return window_out_desc_[0].shape.tensor_shape_span(sample_idx)[time_major ? 0 : 1];
+  }
+
   int window_length_ = -1;
   int window_step_ = -1;
   int power_ = -1;
@@ -118,8 +129,11 @@ struct SpectrogramImplCpu : OpImplBase<CPUBackend> {
   kernels::signal::ExtractWindowsArgs window_args_;
 
   std::vector<OutputDesc> window_out_desc_;
+  // Per-thread buffers for the extracted windows and the spectra of partial samples (freq major)
   std::vector<Tensor<CPUBackend>> window_out_;
+  std::vector<Tensor<CPUBackend>> fft_out_;
 
+  // One FFT kernel (and plan) per thread
   kernels::KernelManager kmgr_fft_;
   kernels::signal::fft::FftArgs fft_args_;
 };
@@ -200,9 +214,13 @@ bool SpectrogramImplCpu<time_major>::SetupImpl(std::vector<OutputDesc> &out_desc
 
   // Intermediate output buffers
   window_out_.resize(nthreads);
+  fft_out_.resize(nthreads);
   for (auto &w : window_out_) {
     if (!w.raw_data()) w.set_pinned(false);
   }
+  for (auto &f : fft_out_) {
+    if (!f.raw_data()) f.set_pinned(false);
+  }
 
   kmgr_window_.Resize<WindowKernel>(nsamples);
   constexpr int axis = 0;
@@ -214,7 +232,7 @@ bool SpectrogramImplCpu<time_major>::SetupImpl(std::vector<OutputDesc> &out_desc
       make_string("Signal is too short (", signal_length, ") for sample ", sample_id));
   }
 
-  kmgr_fft_.Resize<FftKernel>(nsamples);
+  kmgr_fft_.Resize<FftKernel>(nthreads);
   FillFftArgs(fft_args_, power_, window_length_, nfft_, transform_dim);
 
   window_out_desc_.resize(1);
@@ -242,7 +260,7 @@ bool SpectrogramImplCpu<time_major>::SetupImpl(std::vector<OutputDesc> &out_desc
     auto dummy_win_view = make_tensor_cpu<WindowsDims, InputType>(nullptr, windows_shape);
     auto &out_req =
       kmgr_fft_.Setup<FftKernel>(
-        i, ctx,
+        0, ctx,
         dummy_win_view,
         fft_args_);
     out_desc[0].shape.set_tensor_shape(i, out_req.output_shapes[0][0].shape);
@@ -260,30 +278,63 @@ void SpectrogramImplCpu<time_major>::RunImpl(workspace_t<CPUBackend> &ws) {
   auto view_window_fn = make_tensor_cpu<1>(window_fn_.data(), window_length_);
   output.SetLayout(layout_);
 
+  // Long signals are split into chunks of windows, so that the work is balanced across the threads
+  // even if there are fewer samples than threads
+  int64_t total_windows = 0;
+  for (int i = 0; i < nsamples; i++)
+    total_windows += NumWindows(i);
+  uint64_t num_tasks = static_cast<uint64_t>(thread_pool.NumThreads()) * kTasksPerThread;
+  int64_t windows_per_task = std::max(kMinWindowsPerTask, div_ceil(total_windows, num_tasks));
+
   for (int i = 0; i < nsamples; i++) {
-    thread_pool.AddWork(
-      [this, &input, &output, view_window_fn, i](int thread_id) {
-        kernels::KernelContext ctx;
-
-        auto &win_out = window_out_[thread_id];
-        win_out.set_type<InputType>();
-        win_out.Resize(window_out_desc_[0].shape.tensor_shape(i));
-
-        auto view_signal_1d = make_tensor_cpu<1>(input.tensor<const InputType>(i),
-                                                 {input.tensor_shape(i).num_elements()});
-        kmgr_window_.Run<WindowKernel>(
-          i, ctx,
-          view<InputType, WindowsDims>(win_out),
-          view_signal_1d,
-          view_window_fn,
-          window_args_);
-
-        kmgr_fft_.Run<FftKernel>(
-          i, ctx,
-          view<OutputType, WindowsDims>(output[i]),
-          view<const InputType, WindowsDims>(win_out),
-          fft_args_);
-    }, out_shape.tensor_size(i));
+    int64_t nwindows = NumWindows(i);
+    int64_t nfreq = out_shape.tensor_shape_span(i)[time_major ? 1 : 0];
+    for (int64_t first = 0; first < nwindows; first += windows_per_task) {
+      int64_t count = std::min(windows_per_task, nwindows - first);
+      thread_pool.AddWork(
+        [this, &input, &output, view_window_fn, i, nwindows, nfreq, first, count](int thread_id) {
+          kernels::KernelContext ctx;
+
+          auto &win_out = window_out_[thread_id];
+          win_out.set_type<InputType>();
+          if (time_major)
+            win_out.Resize(TensorShape<>{count, window_length_});
+          else
+            win_out.Resize(TensorShape<>{window_length_, count});
+
+          auto view_signal_1d = make_tensor_cpu<1>(input.tensor<const InputType>(i),
+                                                   {input.tensor_shape(i).num_elements()});
+          kmgr_window_.Get<WindowKernel>(i).RunWindows(
+            ctx,
+            view<InputType, WindowsDims>(win_out),
+            view_signal_1d,
+            view_window_fn,
+            window_args_,
+            first);
+
+          auto win_view = view<const InputType, WindowsDims>(win_out);
+          kmgr_fft_.Setup<FftKernel>(thread_id, ctx, win_view, fft_args_);
+          auto out_view = view<OutputType, WindowsDims>(output[i]);
+          if (count == nwindows) {
+            kmgr_fft_.Run<FftKernel>(thread_id, ctx, out_view, win_view, fft_args_);
+          } else if (time_major) {
+            // the spectra of consecutive windows are contiguous in the output
+            auto chunk_view = make_tensor_cpu<WindowsDims>(out_view.data + first * nfreq,
+                                                           {count, nfreq});
+            kmgr_fft_.Run<FftKernel>(thread_id, ctx, chunk_view, win_view, fft_args_);
+          } else {
+            auto &fft_out = fft_out_[thread_id];
+            fft_out.set_type<OutputType>();
+            fft_out.Resize(TensorShape<>{nfreq, count});
+            auto chunk_view = view<OutputType, WindowsDims>(fft_out);
+            kmgr_fft_.Run<FftKernel>(thread_id, ctx, chunk_view, win_view, fft_args_);
+            for (int64_t f = 0; f < nfreq; f++) {
+              std::memcpy(out_view.data + f * nwindows + first, chunk_view.data + f * count,
+                          count * sizeof(OutputType));
+            }
+          }
+      }, count * nfreq);
+    }
   }
 
   thread_pool.RunAll();
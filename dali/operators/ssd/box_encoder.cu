@@ -14,8 +14,10 @@
 
 #include "dali/operators/ssd/box_encoder.cuh"
 #include <cuda.h>
+#include <cstdint>
 #include <vector>
 #include <utility>
+#include "dali/core/util.h"
 
 namespace dali {
 __host__ __device__ inline float4 ToCenterWidthHeight(const float4 &box) {
@@ -65,22 +67,6 @@ __device__ __forceinline__ float CalculateIou(const float4 &b1, const float4 &b2
   return intersection / (area1 + area2 - intersection);
 }
 
-__device__ inline void FindBestMatch(const int N, volatile float *vals, volatile int *idx) {
-  for (unsigned int stride = blockDim.x / 2; stride > 0; stride >>= 1) {
-    if (threadIdx.x < stride) {
-      if (vals[threadIdx.x] <= vals[threadIdx.x + stride]) {
-        if (vals[threadIdx.x] == vals[threadIdx.x + stride]) {
-          idx[threadIdx.x] = cuda_max(idx[threadIdx.x], idx[threadIdx.x + stride]);
-        } else {
-          vals[threadIdx.x] = vals[threadIdx.x + stride];
-          idx[threadIdx.x] = idx[threadIdx.x + stride];
-        }
-      }
-    }
-    __syncthreads();
-  }
-}
-
 // Scale argument is used to maintain numerical consistency with reference implementation:
 // https://github.com/mlcommons/training/blob/master/single_stage_detector/ssd/utils.py
 __device__ float4 MatchOffsets(
@@ -96,118 +82,154 @@ __device__ float4 MatchOffsets(
   return {x, y, z, w};
 }
 
-__device__ void WriteMatchesToOutput(
-  unsigned int anchor_count, float criteria, int *labels_out, const int *labels_in,
-  float4 *boxes_out, const float4 *boxes_in,
-  volatile int *best_box_idx, volatile float *best_box_iou, bool offset,
-  const float* means, const float* stds, float scale, const float4 *anchors_as_cwh) {
-  for (unsigned int anchor = threadIdx.x; anchor < anchor_count; anchor += blockDim.x) {
-    if (best_box_iou[anchor] > criteria) {
-      int box_idx = best_box_idx[anchor];
-      labels_out[anchor] = labels_in[box_idx];
-      float4 box = boxes_in[box_idx];
-
-      if (!offset)
-        boxes_out[anchor] = ToCenterWidthHeight(box);
-      else
-        boxes_out[anchor] = MatchOffsets(
-          ToCenterWidthHeight(box), anchors_as_cwh[anchor], means, stds, scale);
-    }
+/**
+ * @brief The key of a box-anchor match; the larger key is the better match
+ *
+ * The IoU is in the high bits, transformed so that the order of the keys follows the order of
+ * the values, and the anchor index is in the low bits - of the equally good matches, the one with
+ * the largest anchor index wins, as in the sequential reduction. The matches worse than -1
+ * (and NaNs) are never selected; 0 means no match.
+ */
+__device__ __forceinline__ uint64_t AnchorMatchKey(float iou, int anchor) {
+  if (!(iou >= -1.0f))
+    return 0;
+  uint32_t bits = __float_as_uint(iou);
+  if (bits == 0x80000000u)  // -0 == 0
+    bits = 0;
+  bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  return (static_cast<uint64_t>(bits) << 32) | static_cast<uint32_t>(anchor);
+}
+
+__device__ __forceinline__ uint64_t WarpMax(uint64_t key) {
+  for (int offset = 16; offset > 0; offset >>= 1) {
+    uint64_t other = __shfl_down_sync(0xffffffffu, key, offset);
+    key = cuda_max(key, other);
   }
+  return key;
 }
 
-__device__ void MatchBoxWithAnchors(
-  const float4 &box, const int box_idx, unsigned int anchor_count, const float4 *anchors,
-  volatile int *best_anchor_idx_tmp, volatile float *best_anchor_iou_tmp,
-  volatile int *best_box_idx, volatile float *best_box_iou) {
-  float best_anchor_iou = -1.0f;
-  int best_anchor_idx = -1;
+/**
+ * @brief Matches the boxes of a sample with a tile of BLOCK_SIZE anchors, one anchor per thread
+ *
+ * The grid is (anchor tiles x samples), so that large anchor sets are spread over many blocks.
+ * The boxes are staged in shared memory in chunks of BLOCK_SIZE. For its anchor, each thread
+ * finds the best box (the last one with the largest IoU), written to the buffers. The best anchor
+ * of each box is reduced within the warps and the block and then combined over the tiles with
+ * an atomic max of the match keys in `sample.best_anchors`.
+ */
+template <int BLOCK_SIZE>
+__global__ void MatchAnchorTiles(const BoxEncoderSampleDesc *samples, const int anchor_count,
+                                 const float4 *anchors, int *box_idx_buffer,
+                                 float *box_iou_buffer) {
+  const int sample_idx = blockIdx.y;
+  const auto &sample = samples[sample_idx];
+  const int anchor = blockIdx.x * BLOCK_SIZE + threadIdx.x;
+  const bool valid = anchor < anchor_count;
+
+  __shared__ float4 boxes[BLOCK_SIZE];
+  __shared__ uint64_t best_anchors[BLOCK_SIZE];
 
-  for (unsigned int anchor = threadIdx.x; anchor < anchor_count; anchor += blockDim.x) {
-    float new_val = CalculateIou(box, anchors[anchor]);
+  const float4 anchor_box = valid ? anchors[anchor] : float4{0, 0, 0, 0};
+  float best_box_iou = 0.0f;
+  int best_box_idx = 0;
 
-    if (new_val >= best_anchor_iou) {
-        best_anchor_iou = new_val;
-        best_anchor_idx = anchor;
+  for (int chunk_start = 0; chunk_start < sample.in_box_count; chunk_start += BLOCK_SIZE) {
+    const int chunk_size = cuda_min(BLOCK_SIZE, sample.in_box_count - chunk_start);
+    __syncthreads();
+    if (threadIdx.x < chunk_size) {
+      boxes[threadIdx.x] = sample.boxes_in[chunk_start + threadIdx.x];
+      best_anchors[threadIdx.x] = 0;
     }
+    __syncthreads();
 
-    if (new_val >= best_box_iou[anchor]) {
-        best_box_iou[anchor] = new_val;
-        best_box_idx[anchor] = box_idx;
+    for (int i = 0; i < chunk_size; i++) {
+      uint64_t key = 0;
+      if (valid) {
+        float iou = CalculateIou(boxes[i], anchor_box);
+        if (iou >= best_box_iou) {
+          best_box_iou = iou;
+          best_box_idx = chunk_start + i;
+        }
+        key = AnchorMatchKey(iou, anchor);
+      }
+      key = WarpMax(key);
+      if (threadIdx.x % 32 == 0 && key)
+        atomicMax(reinterpret_cast<unsigned long long *>(&best_anchors[i]), key);  // NOLINT
     }
+    __syncthreads();
+
+    if (threadIdx.x < chunk_size && best_anchors[threadIdx.x])
+      atomicMax(reinterpret_cast<unsigned long long *>(  // NOLINT
+                  &sample.best_anchors[chunk_start + threadIdx.x]),
+                best_anchors[threadIdx.x]);
   }
 
-  best_anchor_iou_tmp[threadIdx.x] = best_anchor_iou;
-  best_anchor_idx_tmp[threadIdx.x] = best_anchor_idx;
+  if (valid) {
+    box_idx_buffer[sample_idx * anchor_count + anchor] = best_box_idx;
+    box_iou_buffer[sample_idx * anchor_count + anchor] = best_box_iou;
+  }
 }
 
+/**
+ * @brief Writes the matches of a tile of BLOCK_SIZE anchors to the output
+ *
+ * The best anchor of each box is matched with it regardless of the IoU - if it's the best anchor
+ * of more than one box, the last of them is taken - the other anchors take their best boxes,
+ * if the IoU is above the criteria.
+ */
 template <int BLOCK_SIZE>
-__global__ void Encode(const BoxEncoderSampleDesc *samples, const int anchor_count,
-                       const float4 *anchors, const float criteria, int *box_idx_buffer,
-                       float *box_iou_buffer, bool offset, const float *means, const float *stds,
-                       float scale, const float4 *anchors_as_cwh) {
-  const int sample_idx = blockIdx.x;
+__global__ void WriteMatches(const BoxEncoderSampleDesc *samples, const int anchor_count,
+                             const float criteria, const int *box_idx_buffer,
+                             const float *box_iou_buffer, bool offset, const float *means,
+                             const float *stds, float scale, const float4 *anchors_as_cwh) {
+  const int sample_idx = blockIdx.y;
   const auto &sample = samples[sample_idx];
+  const int tile_start = blockIdx.x * BLOCK_SIZE;
 
-  // Remark: This algorithm is very fragile to floating point arithmetic effects.
-  // For now, excessive use of volatile in this code,
-  // makes it conform to reference solution in terms of resulting encoding.
-
-  __shared__ volatile int best_anchor_idx_tmp[BLOCK_SIZE];
-  __shared__ volatile float best_anchor_iou_tmp[BLOCK_SIZE];
+  __shared__ int forced_box_idx[BLOCK_SIZE];
+  forced_box_idx[threadIdx.x] = -1;
+  __syncthreads();
 
-  volatile int *best_box_idx = box_idx_buffer + sample_idx * anchor_count;
-  volatile float *best_box_iou = box_iou_buffer + sample_idx * anchor_count;
+  for (int box_idx = threadIdx.x; box_idx < sample.in_box_count; box_idx += BLOCK_SIZE) {
+    uint64_t key = sample.best_anchors[box_idx];
+    if (!key)
+      continue;
+    int tile_offset = static_cast<int>(key & 0xffffffffu) - tile_start;
+    if (tile_offset >= 0 && tile_offset < BLOCK_SIZE)
+      atomicMax(&forced_box_idx[tile_offset], box_idx);
+  }
+  __syncthreads();
 
-  for (int box_idx = 0; box_idx < sample.in_box_count; ++box_idx) {
-    MatchBoxWithAnchors(
-      sample.boxes_in[box_idx],
-      box_idx,
-      anchor_count,
-      anchors,
-      best_anchor_idx_tmp,
-      best_anchor_iou_tmp,
-      best_box_idx,
-      best_box_iou);
+  const int anchor = tile_start + threadIdx.x;
+  if (anchor >= anchor_count)
+    return;
 
-    __syncthreads();
+  int box_idx = forced_box_idx[threadIdx.x];
+  float iou = 2.0f;
+  if (box_idx < 0) {
+    box_idx = box_idx_buffer[sample_idx * anchor_count + anchor];
+    iou = box_iou_buffer[sample_idx * anchor_count + anchor];
+  }
 
-    FindBestMatch(blockDim.x, best_anchor_iou_tmp, best_anchor_idx_tmp);
-    __syncthreads();
+  if (iou > criteria) {
+    sample.labels_out[anchor] = sample.labels_in[box_idx];
+    float4 box = sample.boxes_in[box_idx];
 
-    if (threadIdx.x == 0) {
-      int idx = best_anchor_idx_tmp[0];
-      best_box_idx[idx] = box_idx;
-      best_box_iou[idx] = 2.f;
-    }
-    __syncthreads();
+    if (!offset)
+      sample.boxes_out[anchor] = ToCenterWidthHeight(box);
+    else
+      sample.boxes_out[anchor] = MatchOffsets(
+        ToCenterWidthHeight(box), anchors_as_cwh[anchor], means, stds, scale);
   }
-  __syncthreads();
-
-  WriteMatchesToOutput(
-    anchor_count,
-    criteria,
-    sample.labels_out,
-    sample.labels_in,
-    sample.boxes_out,
-    sample.boxes_in,
-    best_box_idx,
-    best_box_iou,
-    offset,
-    means,
-    stds,
-    scale,
-    anchors_as_cwh);
 }
 
 std::pair<int *, float *> BoxEncoder<GPUBackend>::ClearBuffers(const cudaStream_t &stream) {
   auto best_box_idx_data = best_box_idx_.mutable_data<int>();
   auto best_box_iou_data = best_box_iou_.mutable_data<float>();
 
-  CUDA_CALL(cudaMemsetAsync(
-    best_box_idx_data, 0, curr_batch_size_ * anchor_count_ * sizeof(int), stream));
-  CUDA_CALL(cudaMemsetAsync(
-    best_box_iou_data, 0, curr_batch_size_ * anchor_count_ * sizeof(float), stream));
+  // the best boxes are written for all the anchors, only the keys of the matches are accumulated
+  CUDA_CALL(cudaMemsetAsync(best_anchor_keys_.mutable_data<uint64_t>(), 0,
+                            best_anchor_keys_.nbytes(), stream));
 
   return {best_box_idx_data, best_box_iou_data};
 }
@@ -281,6 +303,7 @@ void BoxEncoder<GPUBackend>::RunImpl(Workspace<GPUBackend> &ws) {
   auto &labels_output = ws.Output<GPUBackend>(kLabelsOutId);
   labels_output.Resize(dims.second, labels_input.type());
 
+  auto *best_anchor_keys = best_anchor_keys_.mutable_data<uint64_t>();
   samples.resize(curr_batch_size_);
   for (int sample_idx = 0; sample_idx < curr_batch_size_; sample_idx++) {
     auto &sample = samples[sample_idx];
@@ -289,6 +312,8 @@ void BoxEncoder<GPUBackend>::RunImpl(Workspace<GPUBackend> &ws) {
     sample.boxes_in = reinterpret_cast<const float4 *>(boxes_input.tensor<float>(sample_idx));
     sample.labels_in = labels_input.tensor<int>(sample_idx);
     sample.in_box_count = boxes_input.shape().tensor_shape_span(sample_idx)[0];
+    sample.best_anchors = best_anchor_keys;
+    best_anchor_keys += sample.in_box_count;
   }
 
   const auto means_data = means_.data<float>();
@@ -303,10 +328,21 @@ void BoxEncoder<GPUBackend>::RunImpl(Workspace<GPUBackend> &ws) {
 
   samples_dev.from_host(samples, ws.stream());
 
-  Encode<BlockSize><<<curr_batch_size, BlockSize, 0, ws.stream()>>>(
+  if (curr_batch_size == 0 || anchor_count_ == 0)
+    return;
+
+  dim3 grid(div_ceil(anchor_count_, BlockSize), curr_batch_size);
+  MatchAnchorTiles<BlockSize><<<grid, BlockSize, 0, ws.stream()>>>(
     samples_dev.data(),
     anchor_count_,
     anchors_data,
+    buffers.first,
+    buffers.second);
+  CUDA_CALL(cudaGetLastError());
+
+  WriteMatches<BlockSize><<<grid, BlockSize, 0, ws.stream()>>>(
+    samples_dev.data(),
+    anchor_count_,
     criteria_,
     buffers.first,
     buffers.second,
@@ -315,6 +351,7 @@ void BoxEncoder<GPUBackend>::RunImpl(Workspace<GPUBackend> &ws) {
     stds_data,
     scale_,
     anchors_as_cwh_data);
+  CUDA_CALL(cudaGetLastError());
 }
 
 DALI_REGISTER_OPERATOR(BoxEncoder, BoxEncoder<GPUBackend>, GPU);
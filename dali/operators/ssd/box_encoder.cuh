@@ -15,6 +15,7 @@
 #ifndef DALI_OPERATORS_SSD_BOX_ENCODER_CUH_
 #define DALI_OPERATORS_SSD_BOX_ENCODER_CUH_
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -31,6 +32,8 @@ struct BoxEncoderSampleDesc {
   const float4 *boxes_in;
   const int *labels_in;
   int in_box_count;
+  /// The keys of the best anchor matches of the boxes, accumulated over the anchor tiles
+  uint64_t *best_anchors;
 };
 
 template <>
@@ -81,6 +84,12 @@ class BoxEncoder<GPUBackend> : public Operator<GPUBackend> {
 
     best_box_idx_.Resize({curr_batch_size_ * anchor_count_}, DALI_INT32);
     best_box_iou_.Resize({curr_batch_size_ * anchor_count_}, DALI_FLOAT);
+
+    int64_t total_box_count = 0;
+    const auto &boxes_shape = ws.GetInputShape(kBoxesInId);
+    for (int i = 0; i < boxes_shape.num_samples(); i++)
+      total_box_count += boxes_shape.tensor_shape_span(i)[0];
+    best_anchor_keys_.Resize({total_box_count}, DALI_UINT64);
     return false;
   }
 
@@ -96,6 +105,7 @@ class BoxEncoder<GPUBackend> : public Operator<GPUBackend> {
   Tensor<GPUBackend> anchors_as_center_wh_;
   Tensor<GPUBackend> best_box_idx_;
   Tensor<GPUBackend> best_box_iou_;
+  Tensor<GPUBackend> best_anchor_keys_;
 
   std::vector<BoxEncoderSampleDesc> samples;
   DeviceBuffer<BoxEncoderSampleDesc> samples_dev;
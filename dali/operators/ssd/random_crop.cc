@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -17,6 +17,7 @@
 #include <random>
 #include <utility>
 #include <algorithm>
+#include <cassert>
 
 #include "dali/operators/ssd/random_crop.h"
 #include "dali/pipeline/operator/common.h"
@@ -72,85 +73,70 @@ cropped and valid bounding boxes and valid labels are returned.)code")
 
 namespace detail {
 
-// input in ltrb format
-// box1 is [N, 4], box2 is [M, 4]
-// calculate IoU of every box1 vs. every box2 : O(N^2)
-Tensor<CPUBackend> cpu_iou(const Tensor<CPUBackend>& box1,
-                           const Tensor<CPUBackend>& box2) {
-  Tensor<CPUBackend> ious;
-  ious.set_pinned(false);
-
-  int N = box1.dim(0);
-  // Note: We know M=1 in this use-case
-  // int M = box2.dim(0);
-  const int M = 1;
-
-  const float* box1_data = box1.data<float>();
-  const float* box2_data = box2.data<float>();
-
-  ious.Resize({N, 1}, DALI_FLOAT);
-  float *ious_data = ious.mutable_data<float>();
-
-  std::vector<std::pair<float, float>> lt, rb;
-
-  /*
-   * # Left Top & Right Bottom
-   * lt = torch.max(be1[:,:,:2], be2[:,:,:2])
-   * rb = torch.min(be1[:,:,2:], be2[:,:,2:])
-   */
-  for (int i = 0; i < N; ++i) {
-    const float *b1 = box1_data + i * box1.dim(1);
-    const float *b2 = box2_data;
-
-    // want the maximum top, left
-    float l = std::max(b1[0], b2[0]);
-    float t = std::max(b1[1], b2[1]);
-
-    // minimum bottom, right
-    float r = std::min(b1[2], b2[2]);
-    float b = std::min(b1[3], b2[3]);
-
-    lt.emplace_back(l, t);
-    rb.emplace_back(r, b);
-  }
-
-  // delta = rb - lt
-  // delta[delta < 0] = 0
-  // intersect = delta[:,:,0] * delta[:,:, 1]
-  vector<float> intersect(N);
-  for (int i = 0; i < N; ++i) {
-    float first_elem = rb[i].first - lt[i].first;
-    float second_elem = rb[i].second - lt[i].second;
-
-    // delta[delta < 0] = 0
-    first_elem = (first_elem < 0) ? 0 : first_elem;
-    second_elem = (second_elem < 0) ? 0 : second_elem;
-    float inter = first_elem * second_elem;
-
-    intersect[i] = inter;
+/**
+ * @brief Finds the first crop for which the IoU with each of the boxes is at least `min_iou`
+ *        and which contains the center of at least one box.
+ *
+ * The IoU is calculated like in `calc_iou_tensor` above, for all the crops at once - the crops
+ * are stored as structure of arrays, so that the inner loop can be vectorized.
+ *
+ * @param crops     ltrb coordinates of the crops, `crops[k][i]` is the k-th coordinate of crop i
+ * @param min_iou   the IoU threshold for each crop
+ * @param bbox_data N boxes, in ltrb format
+ * @return The index of the crop or -1 if none is valid.
+ */
+template <int kMaxCrops>
+int FindValidCrop(const float (&crops)[4][kMaxCrops], const double (&crops_dbl)[4][kMaxCrops],
+                  const float *min_iou, int num_crops, const float *bbox_data, int N) {
+  float area2[kMaxCrops];
+  uint8_t ok[kMaxCrops];
+  for (int i = 0; i < num_crops; i++) {
+    area2[i] = (crops[3][i] - crops[1][i]) * (crops[2][i] - crops[0][i]);
+    ok[i] = 1;
   }
 
-  // delta1 = be1[:, :, 2:] - be1[:, :, :2]
-  // area1 = delta1[:, :, 0] * delta[:, :, 1]
-  vector<float> area1(N);
-  for (int i = 0; i < N; ++i) {
-    const float* box = box1_data + i * 4;
+  for (int j = 0; j < N; j++) {
+    const float *b1 = bbox_data + j * 4;
     // area is (b-t) * (r-l)
-    area1[i] = (box[3] - box[1]) * (box[2] - box[0]);
+    float area1 = (b1[3] - b1[1]) * (b1[2] - b1[0]);
+    for (int i = 0; i < num_crops; i++) {
+      // want the maximum top, left and the minimum bottom, right
+      float l = std::max(b1[0], crops[0][i]);
+      float t = std::max(b1[1], crops[1][i]);
+      float r = std::min(b1[2], crops[2][i]);
+      float b = std::min(b1[3], crops[3][i]);
+      float dx = r - l;
+      float dy = b - t;
+      dx = dx < 0 ? 0 : dx;
+      dy = dy < 0 ? 0 : dy;
+      float intersect = dx * dy;
+      float iou = intersect / (area1 + area2[i] - intersect);
+      ok[i] &= !(iou < min_iou[i]);
+    }
+    // stop early if all the crops are already rejected
+    if ((j & 15) == 15) {
+      int any = 0;
+      for (int i = 0; i < num_crops; i++)
+        any |= ok[i];
+      if (!any)
+        return -1;
+    }
   }
-  // delta2 = be2[:, :, 2:] - be2[:, :, :2]
-  // area2 = delta2[:, :, 0] * delta[:, :, 2]
-  const float* box = box2_data;
-  // area is (b-t) * (r-l)
-  auto area2 = (box[3] - box[1]) * (box[2] - box[0]);
-
-  // iou = intersect / (area1 + area2 - intersect)
-  for (int i = 0; i < N; ++i) {
-    // index into N*M arrays
-    auto idx = i;
-    ious_data[idx] = intersect[idx] / (area1[i] + area2 - intersect[idx]);
+
+  for (int i = 0; i < num_crops; i++) {
+    if (!ok[i])
+      continue;
+    // the crop is valid if it contains the center of any of the boxes
+    for (int j = 0; j < N; ++j) {
+      const auto* bbox = bbox_data + j * 4;
+      auto xc = 0.5*(bbox[0] + bbox[2]);
+      auto yc = 0.5*(bbox[1] + bbox[3]);
+      if ((xc >= crops_dbl[0][i]) && (xc <= crops_dbl[2][i]) &&
+          (yc >= crops_dbl[1][i]) && (yc <= crops_dbl[3][i]))
+        return i;
+    }
   }
-  return ious;
+  return -1;
 }
 
 // img is [H, W, C], bounds [l, t, r, b]
@@ -176,6 +162,40 @@ void crop(const Tensor<CPUBackend>& img, vector<int> bounds, Tensor<CPUBackend>&
 
 }  // namespace detail
 
+template <>
+typename SSDRandomCrop<CPUBackend>::DrawResult
+SSDRandomCrop<CPUBackend>::DrawCandidate(std::mt19937 &rng, AttemptState &state,
+                                         CropCandidate &candidate) {
+  while (state.attempts_left <= 0) {
+    auto option = sample_options_[int_dis_(rng)];
+    if (option.no_crop())
+      return DrawResult::NoCrop;
+    state.min_iou = option.min_iou();
+    state.attempts_left = num_attempts_;
+  }
+  state.attempts_left--;
+
+  auto w = float_dis_(rng);
+  auto h = float_dis_(rng);
+  // aspect ratio check
+  if ((w / h < 0.5) || (w / h > 2.))
+    return DrawResult::Rejected;
+
+  // need RNG generators for left, top
+  std::uniform_real_distribution<float> l_dis(0., 1. - w), t_dis(0., 1. - h);
+  double left = l_dis(rng);
+  double top = t_dis(rng);
+
+  candidate.left = left;
+  candidate.top = top;
+  candidate.right = left + w;
+  candidate.bottom = top + h;
+  candidate.w = w;
+  candidate.h = h;
+  candidate.min_iou = state.min_iou;
+  return DrawResult::Candidate;
+}
+
 template <>
 void SSDRandomCrop<CPUBackend>::RunImpl(SampleWorkspace &ws) {
   // [H, W, C], dtype=uint8_t
@@ -190,135 +210,123 @@ void SSDRandomCrop<CPUBackend>::RunImpl(SampleWorkspace &ws) {
 
   const int* label_data = labels.data<int>();
 
-  // [1x4]
-  Tensor<CPUBackend> crop_attempt;
-  crop_attempt.set_pinned(false);
-  crop_attempt.Resize({1, 4}, DALI_FLOAT);
-  float *crop_ptr = crop_attempt.mutable_data<float>();
-  // iterate until a suitable crop has been found
-  while (true) {
-    auto opt_idx = int_dis_(rngs_[sample]);
-    auto option = sample_options_[opt_idx];
-
-    if (option.no_crop()) {
+  auto &rng = rngs_[sample];
+  AttemptState state;
+  CropCandidate candidates[kCandidateBlock];
+  float crops[4][kCandidateBlock];
+  double crops_dbl[4][kCandidateBlock];
+  float min_iou[kCandidateBlock];
+
+  // The attempts are drawn in blocks and evaluated together. Each block ends when the option
+  // is not to crop at all - any valid crop in the block takes precedence over that.
+  int idx = -1;
+  while (idx < 0) {
+    auto rng_start = rng;
+    auto state_start = state;
+    int num_candidates = 0, num_draws = 0;
+    bool no_crop = false;
+    while (num_candidates < kCandidateBlock) {
+      auto &candidate = candidates[num_candidates];
+      auto result = DrawCandidate(rng, state, candidate);
+      num_draws++;
+      if (result == DrawResult::NoCrop) {
+        no_crop = true;
+        break;
+      }
+      if (result == DrawResult::Candidate) {
+        candidate.num_draws = num_draws;
+        double coords[4] = { candidate.left, candidate.top, candidate.right, candidate.bottom };
+        for (int k = 0; k < 4; k++) {
+          crops[k][num_candidates] = coords[k];
+          crops_dbl[k][num_candidates] = coords[k];
+        }
+        min_iou[num_candidates] = candidate.min_iou;
+        num_candidates++;
+      }
+    }
+
+    idx = detail::FindValidCrop(crops, crops_dbl, min_iou, num_candidates, bbox_data, N);
+    if (idx >= 0) {
+      // Rewind the generator to the selected attempt, so that its state is the same as if
+      // the attempts were evaluated one by one.
+      rng = rng_start;
+      state = state_start;
+      CropCandidate tmp;
+      for (int i = 0; i < candidates[idx].num_draws; i++)
+        DrawCandidate(rng, state, tmp);
+    } else if (no_crop) {
       // copy directly to output without modification
       ws.Output<CPUBackend>(0).Copy(img);
       ws.Output<CPUBackend>(1).Copy(bboxes);
       ws.Output<CPUBackend>(2).Copy(labels);
       return;
     }
+  }
 
-    // input is HWC ordering
-    auto htot = img.dim(0);
-    auto wtot = img.dim(1);
-
-    auto min_iou = option.min_iou();
-
-    // make num_attempts_ tries to get a valid crop
-    for (int i = 0; i < num_attempts_; ++i) {
-      auto w = float_dis_(rngs_[sample]);
-      auto h = float_dis_(rngs_[sample]);
-      // aspect ratio check
-      if ((w / h < 0.5) || (w / h > 2.)) {
-        continue;
-      }
-
-      // need RNG generators for left, top
-      std::uniform_real_distribution<float> l_dis(0., 1. - w), t_dis(0., 1. - h);
-      double left = l_dis(rngs_[sample]);
-      double top = t_dis(rngs_[sample]);
-
-      double right = left + w;
-      double bottom = top + h;
-
-      crop_ptr[0] = left;
-      crop_ptr[1] = top;
-      crop_ptr[2] = right;
-      crop_ptr[3] = bottom;
-
-      // returns ious : [N, M]
+  const auto &crop = candidates[idx];
+  double left = crop.left, top = crop.top, right = crop.right, bottom = crop.bottom;
+  double w = crop.w, h = crop.h;
 
-      Tensor<CPUBackend> ious = detail::cpu_iou(bboxes, crop_attempt);
-      const float *ious_data = ious.data<float>();
+  // discard any bboxes whose center is not in the cropped image
+  std::vector<int> mask;
+  for (int j = 0; j < N; ++j) {
+    const auto* bbox = bbox_data + j * 4;
+    auto xc = 0.5*(bbox[0] + bbox[2]);
+    auto yc = 0.5*(bbox[1] + bbox[3]);
 
-      // make sure all the calculated IoUs are in the range (min_iou, max_iou)
-      // Note: ious has size N*M, but M = 1 in this case
-      bool fail = false;
-      for (int j = 0; j < N * 1; ++j) {
-        if (ious_data[j] < min_iou) fail = true;
-      }
-      // generate a new crop
-      if (fail) {
-        continue;
-      }
-
-      // discard any bboxes whose center is not in the cropped image
-      int valid_bboxes = 0;
-      std::vector<int> mask;
-      for (int j = 0; j < N; ++j) {
-        const auto* bbox = bbox_data + j * 4;
-        auto xc = 0.5*(bbox[0] + bbox[2]);
-        auto yc = 0.5*(bbox[1] + bbox[3]);
-
-        bool valid = (xc >= left) && (xc <= right) && (yc >= top) && (yc <= bottom);
-        if (valid) {
-          mask.push_back(j);
-          valid_bboxes += 1;
-        }
-      }
-      // If we don't have any valid boxes, generate a new crop
-      if (!valid_bboxes) {
-        continue;
-      }
-
-      // now we know how many output bboxes there will be, we can allocate
-      // the output.
-      auto &img_out = ws.Output<CPUBackend>(0);
-      img_out.SetLayout(img.GetLayout());
-      auto &bbox_out = ws.Output<CPUBackend>(1);
-      auto &label_out = ws.Output<CPUBackend>(2);
-
-      bbox_out.Resize({valid_bboxes, 4}, DALI_FLOAT);
-      auto *bbox_out_data = bbox_out.mutable_data<float>();
-
-      label_out.Resize({valid_bboxes}, DALI_INT32);
-      auto *label_out_data = label_out.mutable_data<int>();
-
-      // copy valid bboxes to output and transform them
-      for (int j = 0; j < valid_bboxes; ++j) {
-        int idx = mask[j];
-
-        // this bbox is being preserved
-        const auto *bbox_i = bbox_data + idx * 4;
-        auto *bbox_o = bbox_out_data + j * 4;
-
-        // bbox_o[4] = bbox_i[4];
-        label_out_data[j] = label_data[idx];
-
-        // scaling
-        double minus[] = {left, top, left, top};
-        double scale[] = {w, h, w, h};
-        for (int k = 0; k < 4; ++k) {
-          // scale and translate the input box
-          double coord = (bbox_i[k] - minus[k]) / scale[k];;
-          // ..and clamp it to 0..1 range
-          bbox_o[k] = std::min(std::max(coord, 0.0), 1.0);
-        }
-      }  // end bbox copy
+    bool valid = (xc >= left) && (xc <= right) && (yc >= top) && (yc <= bottom);
+    if (valid)
+      mask.push_back(j);
+  }
+  int valid_bboxes = mask.size();
+  assert(valid_bboxes > 0);
+
+  // now we know how many output bboxes there will be, we can allocate
+  // the output.
+  auto &img_out = ws.Output<CPUBackend>(0);
+  img_out.SetLayout(img.GetLayout());
+  auto &bbox_out = ws.Output<CPUBackend>(1);
+  auto &label_out = ws.Output<CPUBackend>(2);
+
+  bbox_out.Resize({valid_bboxes, 4}, DALI_FLOAT);
+  auto *bbox_out_data = bbox_out.mutable_data<float>();
+
+  label_out.Resize({valid_bboxes}, DALI_INT32);
+  auto *label_out_data = label_out.mutable_data<int>();
+
+  // copy valid bboxes to output and transform them
+  for (int j = 0; j < valid_bboxes; ++j) {
+    int box_idx = mask[j];
+
+    // this bbox is being preserved
+    const auto *bbox_i = bbox_data + box_idx * 4;
+    auto *bbox_o = bbox_out_data + j * 4;
+
+    label_out_data[j] = label_data[box_idx];
+
+    // scaling
+    double minus[] = {left, top, left, top};
+    double scale[] = {w, h, w, h};
+    for (int k = 0; k < 4; ++k) {
+      // scale and translate the input box
+      double coord = (bbox_i[k] - minus[k]) / scale[k];
+      // ..and clamp it to 0..1 range
+      bbox_o[k] = std::min(std::max(coord, 0.0), 1.0);
+    }
+  }  // end bbox copy
 
-      // everything is good, generate the crop parameters
-      const int left_idx = std::llround(left * wtot);
-      const int top_idx = std::llround(top * htot);
-      const int right_idx = std::llround(right * wtot);
-      const int bottom_idx = std::llround(bottom * htot);
+  // input is HWC ordering
+  auto htot = img.dim(0);
+  auto wtot = img.dim(1);
 
-      // perform the crop
-      detail::crop(img, {left_idx, top_idx, right_idx, bottom_idx},
-                   img_out);
+  // everything is good, generate the crop parameters
+  const int left_idx = std::llround(left * wtot);
+  const int top_idx = std::llround(top * htot);
+  const int right_idx = std::llround(right * wtot);
+  const int bottom_idx = std::llround(bottom * htot);
 
-      return;
-    }  // end num_attempts loop
-  }  // end sample loop
+  // perform the crop
+  detail::crop(img, {left_idx, top_idx, right_idx, bottom_idx}, img_out);
 }
 
 template <>
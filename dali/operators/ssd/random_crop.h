@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -18,6 +18,7 @@
 #include <cfloat>
 #include <vector>
 #include <random>
+#include <string>
 #include <memory>
 #include <utility>
 
@@ -49,6 +50,14 @@ class SSDRandomCrop : public Operator<Backend> {
 
   inline ~SSDRandomCrop() override = default;
 
+  std::string SaveState() override {
+    return rngs_.SaveState();
+  }
+
+  void RestoreState(const std::string &state) override {
+    rngs_.RestoreState(state);
+  }
+
   DISABLE_COPY_MOVE_ASSIGN(SSDRandomCrop);
 
   USE_OPERATOR_MEMBERS();
@@ -85,6 +94,37 @@ class SSDRandomCrop : public Operator<Backend> {
 
   std::vector<SampleOption> sample_options_;
 
+  struct CropCandidate {
+    double left, top, right, bottom;
+    float w, h;
+    float min_iou;
+    int num_draws;  // the number of calls to DrawCandidate which produced this candidate
+  };
+
+  /**
+   * @brief The position in the sequence of sample options and crop attempts
+   */
+  struct AttemptState {
+    int attempts_left = 0;
+    float min_iou = 0;
+  };
+
+  enum class DrawResult {
+    NoCrop,     // the sample option is to not crop at all
+    Rejected,   // the crop has an invalid aspect ratio
+    Candidate   // the crop needs to be checked against the boxes
+  };
+
+  /**
+   * @brief Draws the next crop attempt
+   *
+   * The sequence of the attempts depends only on the generator, so they can be drawn ahead
+   * and evaluated in blocks.
+   */
+  DrawResult DrawCandidate(std::mt19937 &rng, AttemptState &state, CropCandidate &candidate);
+
+  static constexpr int kCandidateBlock = 32;
+
   int num_attempts_;
 
   // RNG stuff
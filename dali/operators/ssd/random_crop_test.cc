@@ -0,0 +1,274 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "dali/pipeline/pipeline.h"
+#include "dali/pipeline/util/batch_rng.h"
+
+namespace dali {
+
+namespace {
+
+// the size of the blocks in which SSDRandomCrop evaluates the crop attempts
+constexpr int kCandidateBlock = 32;
+
+struct RefCrop {
+  bool no_crop;
+  double left, top, right, bottom;
+  float w, h;
+};
+
+/**
+ * @brief The crop selection of SSDRandomCrop from before the attempts were evaluated in blocks:
+ *        the sample options and the attempts are drawn and checked one at a time.
+ *
+ * @return the number of the attempts with a valid aspect ratio, including the selected one
+ */
+int ReferenceSelectCrop(std::mt19937 &rng, int num_attempts, const float *bbox_data, int N,
+                        RefCrop &crop) {
+  // the IoU thresholds of the sample options; the last option is to not crop at all
+  const float min_ious[] = { -1.f, 0.1f, 0.3f, 0.5f, 0.7f, 0.9f };
+  const int kNoCrop = 6;
+  std::uniform_int_distribution<> int_dis(0, 6);
+  std::uniform_real_distribution<float> float_dis(0.3, 1.);
+
+  int num_candidates = 0;
+  while (true) {
+    int opt_idx = int_dis(rng);
+    if (opt_idx == kNoCrop) {
+      crop.no_crop = true;
+      return num_candidates;
+    }
+    float min_iou = min_ious[opt_idx];
+
+    for (int i = 0; i < num_attempts; ++i) {
+      auto w = float_dis(rng);
+      auto h = float_dis(rng);
+      if ((w / h < 0.5) || (w / h > 2.))
+        continue;
+
+      std::uniform_real_distribution<float> l_dis(0., 1. - w), t_dis(0., 1. - h);
+      double left = l_dis(rng);
+      double top = t_dis(rng);
+      double right = left + w;
+      double bottom = top + h;
+      num_candidates++;
+
+      float c[4] = { static_cast<float>(left), static_cast<float>(top),
+                     static_cast<float>(right), static_cast<float>(bottom) };
+      float area2 = (c[3] - c[1]) * (c[2] - c[0]);
+      bool fail = false;
+      for (int j = 0; j < N; ++j) {
+        const float *b = bbox_data + j * 4;
+        float dx = std::min(b[2], c[2]) - std::max(b[0], c[0]);
+        float dy = std::min(b[3], c[3]) - std::max(b[1], c[1]);
+        dx = dx < 0 ? 0 : dx;
+        dy = dy < 0 ? 0 : dy;
+        float intersect = dx * dy;
+        float area1 = (b[3] - b[1]) * (b[2] - b[0]);
+        if (intersect / (area1 + area2 - intersect) < min_iou)
+          fail = true;
+      }
+      if (fail)
+        continue;
+
+      bool any_center = false;
+      for (int j = 0; j < N; ++j) {
+        const float *b = bbox_data + j * 4;
+        auto xc = 0.5 * (b[0] + b[2]);
+        auto yc = 0.5 * (b[1] + b[3]);
+        any_center |= (xc >= left) && (xc <= right) && (yc >= top) && (yc <= bottom);
+      }
+      if (!any_center)
+        continue;
+
+      crop = { false, left, top, right, bottom, w, h };
+      return num_candidates;
+    }
+  }
+}
+
+void MakeInputs(std::mt19937 &gen, int batch_size, TensorList<CPUBackend> &images,
+                TensorList<CPUBackend> &boxes, TensorList<CPUBackend> &labels) {
+  std::uniform_int_distribution<> size_dis(16, 64), num_boxes_dis(1, 8), label_dis(1, 80);
+  std::uniform_real_distribution<float> pos_dis(0, 0.9), extent_dis(0.05, 0.6);
+
+  TensorListShape<> images_shape(batch_size, 3), boxes_shape(batch_size, 2),
+                    labels_shape(batch_size, 1);
+  for (int i = 0; i < batch_size; i++) {
+    int num_boxes = num_boxes_dis(gen);
+    images_shape.set_tensor_shape(i, {size_dis(gen), size_dis(gen), 3});
+    boxes_shape.set_tensor_shape(i, {num_boxes, 4});
+    labels_shape.set_tensor_shape(i, {num_boxes});
+  }
+  images.Resize(images_shape, DALI_UINT8);
+  images.SetLayout("HWC");
+  boxes.Resize(boxes_shape, DALI_FLOAT);
+  labels.Resize(labels_shape, DALI_INT32);
+
+  for (int i = 0; i < batch_size; i++) {
+    auto *img = images.mutable_tensor<uint8_t>(i);
+    for (int64_t k = 0, n = volume(images_shape[i]); k < n; k++)
+      img[k] = gen();
+    auto *b = boxes.mutable_tensor<float>(i);
+    auto *l = labels.mutable_tensor<int>(i);
+    for (int j = 0; j < boxes_shape[i][0]; j++) {
+      float x = pos_dis(gen), y = pos_dis(gen);
+      b[j * 4 + 0] = x;
+      b[j * 4 + 1] = y;
+      b[j * 4 + 2] = std::min(x + extent_dis(gen), 1.f);
+      b[j * 4 + 3] = std::min(y + extent_dis(gen), 1.f);
+      l[j] = label_dis(gen);
+    }
+  }
+}
+
+void CheckNoCrop(const TensorList<CPUBackend> &in, const TensorList<CPUBackend> &out, int i) {
+  ASSERT_EQ(out.tensor_shape(i), in.tensor_shape(i));
+  EXPECT_EQ(std::memcmp(out.raw_tensor(i), in.raw_tensor(i),
+                        volume(in.tensor_shape(i)) * in.type_info().size()), 0);
+}
+
+void CheckCrop(const RefCrop &crop, const TensorList<CPUBackend> &images,
+               const TensorList<CPUBackend> &boxes, const TensorList<CPUBackend> &labels,
+               DeviceWorkspace &ws, int i) {
+  const float *bbox_data = boxes.tensor<float>(i);
+  const int *label_data = labels.tensor<int>(i);
+  std::vector<float> ref_boxes;
+  std::vector<int> ref_labels;
+  for (int j = 0; j < boxes.tensor_shape(i)[0]; j++) {
+    const float *b = bbox_data + j * 4;
+    auto xc = 0.5 * (b[0] + b[2]);
+    auto yc = 0.5 * (b[1] + b[3]);
+    if (!((xc >= crop.left) && (xc <= crop.right) && (yc >= crop.top) && (yc <= crop.bottom)))
+      continue;
+    double minus[] = { crop.left, crop.top, crop.left, crop.top };
+    double scale[] = { crop.w, crop.h, crop.w, crop.h };
+    for (int k = 0; k < 4; k++)
+      ref_boxes.push_back(std::min(std::max((b[k] - minus[k]) / scale[k], 0.0), 1.0));
+    ref_labels.push_back(label_data[j]);
+  }
+
+  auto &out_boxes = ws.Output<CPUBackend>(1);
+  auto &out_labels = ws.Output<CPUBackend>(2);
+  int num_boxes = ref_labels.size();
+  ASSERT_EQ(out_boxes.tensor_shape(i), TensorShape<>(num_boxes, 4));
+  ASSERT_EQ(out_labels.tensor_shape(i), TensorShape<>(num_boxes));
+  for (int j = 0; j < num_boxes * 4; j++)
+    EXPECT_EQ(out_boxes.tensor<float>(i)[j], ref_boxes[j]) << "sample " << i << ", box " << j / 4;
+  for (int j = 0; j < num_boxes; j++)
+    EXPECT_EQ(out_labels.tensor<int>(i)[j], ref_labels[j]) << "sample " << i << ", box " << j;
+
+  auto img_shape = images.tensor_shape(i);
+  int H = img_shape[0], W = img_shape[1], C = img_shape[2];
+  int l = std::llround(crop.left * W), t = std::llround(crop.top * H);
+  int r = std::llround(crop.right * W), b = std::llround(crop.bottom * H);
+  auto &out_images = ws.Output<CPUBackend>(0);
+  ASSERT_EQ(out_images.tensor_shape(i), TensorShape<>(b - t, r - l, C));
+  const uint8_t *in = images.tensor<uint8_t>(i);
+  const uint8_t *out = out_images.tensor<uint8_t>(i);
+  for (int y = t; y < b; y++, out += (r - l) * C)
+    EXPECT_EQ(std::memcmp(out, in + (y * W + l) * C, (r - l) * C), 0) << "sample " << i;
+}
+
+/**
+ * @brief Runs SSDRandomCrop with several seeds and compares the crops, boxes and labels
+ *        with the ones selected by drawing and checking the attempts one at a time.
+ *
+ * @return the number of the samples for which the no-crop option was drawn in the same block
+ *         of the attempts as the selected crop
+ */
+int CompareWithReference(int num_attempts) {
+  const int batch_size = 16;
+  const int num_seeds = 20;
+  const int num_iters = 4;
+  std::mt19937 gen(12345);
+  int mixed_blocks = 0;
+
+  for (int64_t seed = 1; seed <= num_seeds; seed++) {
+    Pipeline pipe(batch_size, 1, 0);
+    pipe.AddExternalInput("images");
+    pipe.AddExternalInput("boxes");
+    pipe.AddExternalInput("labels");
+    pipe.AddOperator(OpSpec("SSDRandomCrop")
+                         .AddArg("device", "cpu")
+                         .AddArg("num_attempts", num_attempts)
+                         .AddArg("seed", seed)
+                         .AddInput("images", "cpu")
+                         .AddInput("boxes", "cpu")
+                         .AddInput("labels", "cpu")
+                         .AddOutput("crop_images", "cpu")
+                         .AddOutput("crop_boxes", "cpu")
+                         .AddOutput("crop_labels", "cpu"));
+    pipe.Build({{"crop_images", "cpu"}, {"crop_boxes", "cpu"}, {"crop_labels", "cpu"}});
+
+    // the generator state carries over between the iterations
+    BatchRNG<std::mt19937> ref_rngs(seed, batch_size);
+    for (int iter = 0; iter < num_iters; iter++) {
+      TensorList<CPUBackend> images, boxes, labels;
+      MakeInputs(gen, batch_size, images, boxes, labels);
+      pipe.SetExternalInput("images", images);
+      pipe.SetExternalInput("boxes", boxes);
+      pipe.SetExternalInput("labels", labels);
+      pipe.RunCPU();
+      pipe.RunGPU();
+      DeviceWorkspace ws;
+      pipe.Outputs(&ws);
+
+      for (int i = 0; i < batch_size; i++) {
+        RefCrop crop;
+        auto &rng = ref_rngs[i];
+        int n = ReferenceSelectCrop(rng, num_attempts, boxes.tensor<float>(i),
+                                    boxes.tensor_shape(i)[0], crop);
+        if (crop.no_crop) {
+          CheckNoCrop(images, ws.Output<CPUBackend>(0), i);
+          CheckNoCrop(boxes, ws.Output<CPUBackend>(1), i);
+          CheckNoCrop(labels, ws.Output<CPUBackend>(2), i);
+          continue;
+        }
+        CheckCrop(crop, images, boxes, labels, ws, i);
+
+        if (num_attempts == 1) {
+          // With one attempt per option, the attempts following the selected one are drawn
+          // as if from the beginning; without any boxes, only the no-crop option ends them.
+          auto lookahead = rng;
+          RefCrop tmp;
+          int more = ReferenceSelectCrop(lookahead, num_attempts, nullptr, 0, tmp);
+          if ((n - 1) % kCandidateBlock + 1 + more < kCandidateBlock)
+            mixed_blocks++;
+        }
+      }
+    }
+  }
+  return mixed_blocks;
+}
+
+}  // namespace
+
+TEST(SSDRandomCropTest, MatchesSequentialAttempts) {
+  EXPECT_GT(CompareWithReference(1), 0);
+}
+
+TEST(SSDRandomCropTest, MatchesSequentialAttemptsMulti) {
+  CompareWithReference(5);
+}
+
+}  // namespace dali
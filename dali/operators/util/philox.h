@@ -0,0 +1,146 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_OPERATORS_UTIL_PHILOX_H_
+#define DALI_OPERATORS_UTIL_PHILOX_H_
+
+#include <cstdint>
+#include "dali/core/host_dev.h"
+
+namespace dali {
+
+/**
+ * @brief Counter-based Philox4x32-10 random bit generator
+ *
+ * The generator is fully described by a 64-bit key and a 128-bit counter, so it can be placed
+ * at any position of any of its streams in constant time. The streams are the same as those of
+ * `curandStatePhilox4_32_10_t` initialized with `curand_init(key, sequence, offset, &state)`.
+ *
+ * Satisfies the UniformRandomBitGenerator requirements, so that it can be used with the standard
+ * library distributions.
+ */
+class Philox4x32_10 {
+ public:
+  using result_type = uint32_t;
+
+  DALI_HOST_DEV Philox4x32_10() {
+    init(0, 0, 0);
+  }
+
+  DALI_HOST_DEV Philox4x32_10(uint64_t key, uint64_t sequence, uint64_t offset) {
+    init(key, sequence, offset);
+  }
+
+  /**
+   * @brief Places the generator at `offset` in the stream `sequence` of the given key
+   */
+  DALI_HOST_DEV void init(uint64_t key, uint64_t sequence, uint64_t offset) {
+    key_[0] = static_cast<uint32_t>(key);
+    key_[1] = static_cast<uint32_t>(key >> 32);
+    ctr_[0] = ctr_[1] = 0;
+    ctr_[2] = static_cast<uint32_t>(sequence);
+    ctr_[3] = static_cast<uint32_t>(sequence >> 32);
+    phase_ = 0;
+    skipahead(offset);
+  }
+
+  /**
+   * @brief Skips `n` values in the current stream
+   */
+  DALI_HOST_DEV void skipahead(uint64_t n) {
+    uint64_t blocks = n >> 2;
+    phase_ += n & 3;
+    if (phase_ > 3) {
+      phase_ -= 4;
+      blocks++;
+    }
+    incr(blocks);
+    generate_block();
+  }
+
+  void discard(unsigned long long n) {  // NOLINT(runtime/int)
+    skipahead(n);
+  }
+
+  DALI_HOST_DEV result_type operator()() {
+    result_type ret = out_[phase_];
+    if (++phase_ == 4) {
+      phase_ = 0;
+      incr(1);
+      generate_block();
+    }
+    return ret;
+  }
+
+  static constexpr result_type min() {
+    return 0;
+  }
+
+  static constexpr result_type max() {
+    return 0xffffffffu;
+  }
+
+ private:
+  static constexpr uint32_t kM0 = 0xD2511F53u;
+  static constexpr uint32_t kM1 = 0xCD9E8D57u;
+  static constexpr uint32_t kW0 = 0x9E3779B9u;
+  static constexpr uint32_t kW1 = 0xBB67AE85u;
+
+  DALI_HOST_DEV static inline uint32_t mulhi(uint32_t a, uint32_t b) {
+  #ifdef __CUDA_ARCH__
+    return __umulhi(a, b);
+  #else
+    return static_cast<uint32_t>((static_cast<uint64_t>(a) * b) >> 32);
+  #endif
+  }
+
+  /**
+   * @brief Advances the 128-bit counter by `n` blocks
+   */
+  DALI_HOST_DEV void incr(uint64_t n) {
+    uint64_t lo = (static_cast<uint64_t>(ctr_[1]) << 32 | ctr_[0]) + n;
+    bool carry = lo < n;
+    ctr_[0] = static_cast<uint32_t>(lo);
+    ctr_[1] = static_cast<uint32_t>(lo >> 32);
+    if (carry && ++ctr_[2] == 0)
+      ++ctr_[3];
+  }
+
+  DALI_HOST_DEV void generate_block() {
+    uint32_t c[4] = { ctr_[0], ctr_[1], ctr_[2], ctr_[3] };
+    uint32_t k0 = key_[0], k1 = key_[1];
+    #pragma unroll
+    for (int r = 0; r < 10; r++) {
+      uint32_t hi0 = mulhi(kM0, c[0]), lo0 = kM0 * c[0];
+      uint32_t hi1 = mulhi(kM1, c[2]), lo1 = kM1 * c[2];
+      c[0] = hi1 ^ c[1] ^ k0;
+      c[1] = lo1;
+      c[2] = hi0 ^ c[3] ^ k1;
+      c[3] = lo0;
+      k0 += kW0;
+      k1 += kW1;
+    }
+    for (int i = 0; i < 4; i++)
+      out_[i] = c[i];
+  }
+
+  uint32_t key_[2];
+  uint32_t ctr_[4];
+  uint32_t out_[4];
+  int phase_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_OPERATORS_UTIL_PHILOX_H_
@@ -0,0 +1,113 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <curand_kernel.h>  // NOLINT
+#include <vector>
+#include "dali/core/cuda_error.h"
+#include "dali/core/dev_buffer.h"
+#include "dali/operators/util/philox.h"
+
+namespace dali {
+namespace test {
+
+namespace {
+
+constexpr int kNumStreams = 256;
+constexpr int kNumDraws = 37;
+
+__device__ __host__ void GetStreamParams(int idx, uint64_t &key, uint64_t &seq, uint64_t &ofs) {
+  key = 0x123456789abcdefull * (idx % 7 + 1);
+  seq = idx % 2 ? idx : 0xffffffffffffffffull - idx;
+  ofs = idx % 3 ? idx * 5 : 0xfffffffffffffff0ull;
+}
+
+__global__ void CurandPhilox(uint32_t *out) {
+  int idx = blockIdx.x * blockDim.x + threadIdx.x;
+  uint64_t key, seq, ofs;
+  GetStreamParams(idx, key, seq, ofs);
+  curandStatePhilox4_32_10_t state;
+  curand_init(key, seq, ofs, &state);
+  for (int i = 0; i < kNumDraws; i++)
+    out[idx * kNumDraws + i] = curand(&state);
+}
+
+__global__ void DevicePhilox(uint32_t *out) {
+  int idx = blockIdx.x * blockDim.x + threadIdx.x;
+  uint64_t key, seq, ofs;
+  GetStreamParams(idx, key, seq, ofs);
+  Philox4x32_10 rng(key, seq, ofs);
+  for (int i = 0; i < kNumDraws; i++)
+    out[idx * kNumDraws + i] = rng();
+}
+
+}  // namespace
+
+TEST(Philox4x32_10, KnownAnswer) {
+  // Test vectors of the reference implementation (Random123)
+  Philox4x32_10 zero(0, 0, 0);
+  EXPECT_EQ(zero(), 0x6627e8d5u);
+  EXPECT_EQ(zero(), 0xe169c58du);
+  EXPECT_EQ(zero(), 0xbc57ac4cu);
+  EXPECT_EQ(zero(), 0x9b00dbd8u);
+
+  // counter = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}
+  Philox4x32_10 pi(0x299f31d0a4093822ull, 0x0370734413198a2eull, 0);
+  for (int i = 0; i < 4; i++)
+    pi.skipahead(0x85a308d3243f6a88ull);
+  EXPECT_EQ(pi(), 0xd16cfe09u);
+  EXPECT_EQ(pi(), 0x94fdccebu);
+  EXPECT_EQ(pi(), 0x5001e420u);
+  EXPECT_EQ(pi(), 0x24126ea1u);
+}
+
+TEST(Philox4x32_10, SkipAhead) {
+  Philox4x32_10 seq(42, 7, 3), skip(42, 7, 0);
+  skip.skipahead(1);
+  skip.skipahead(2);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(seq(), skip());
+    skip.discard(i);
+    for (int j = 0; j < i; j++)
+      seq();
+  }
+}
+
+TEST(Philox4x32_10, MatchesCurand) {
+  const int n = kNumStreams * kNumDraws;
+  DeviceBuffer<uint32_t> curand_out, device_out;
+  curand_out.resize(n);
+  device_out.resize(n);
+  CurandPhilox<<<kNumStreams / 64, 64>>>(curand_out.data());
+  DevicePhilox<<<kNumStreams / 64, 64>>>(device_out.data());
+  CUDA_CALL(cudaGetLastError());
+  std::vector<uint32_t> ref(n), dev(n);
+  copyD2H(ref.data(), curand_out.data(), n);
+  copyD2H(dev.data(), device_out.data(), n);
+  CUDA_CALL(cudaDeviceSynchronize());
+
+  for (int idx = 0; idx < kNumStreams; idx++) {
+    uint64_t key, seq, ofs;
+    GetStreamParams(idx, key, seq, ofs);
+    Philox4x32_10 host(key, seq, ofs);
+    for (int i = 0; i < kNumDraws; i++) {
+      ASSERT_EQ(dev[idx * kNumDraws + i], ref[idx * kNumDraws + i])
+          << "stream " << idx << ", draw " << i;
+      ASSERT_EQ(host(), ref[idx * kNumDraws + i]) << "stream " << idx << ", draw " << i;
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace dali
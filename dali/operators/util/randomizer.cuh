@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -41,6 +41,9 @@ struct curand_states {
   curandState* states_;  // std::shared_ptr::get can't be called from __device__ functions
 };
 
+// The distributions below accept any curand generator state, e.g. `curandState` or
+// `curandStatePhilox4_32_10_t`.
+
 template <typename T>
 struct curand_normal_dist;
 
@@ -48,7 +51,8 @@ template <>
 struct curand_normal_dist<float> {
   float mean = 0.0f, stddev = 1.0f;
 
-  __device__ inline float operator()(curandState *state) const {
+  template <typename State>
+  __device__ inline float operator()(State *state) const {
     return mean + curand_normal(state) * stddev;
   }
 };
@@ -57,7 +61,8 @@ template <>
 struct curand_normal_dist<double> {
   double mean = 0.0f, stddev = 1.0f;
 
-  __device__ inline double operator()(curandState *state) const {
+  template <typename State>
+  __device__ inline double operator()(State *state) const {
     return mean + curand_normal_double(state) * stddev;
   }
 };
@@ -74,7 +79,8 @@ struct curand_uniform_dist {
     assert(end > start);
   }
 
-  __device__ inline T operator()(curandState *state) const {
+  template <typename State>
+  __device__ inline T operator()(State *state) const {
     T val;
     if (std::is_same<T, double>::value) {
       do {
@@ -98,7 +104,8 @@ struct curand_uniform_int_range_dist {
     assert(end > start);
   }
 
-  __device__ inline int operator()(curandState *state) const {
+  template <typename State>
+  __device__ inline int operator()(State *state) const {
     return range_start_ + (curand(state) % range_size_);
   }
 
@@ -118,7 +125,8 @@ struct curand_uniform_int_values_dist {
   DALI_HOST_DEV curand_uniform_int_values_dist(const T *values, int64_t nvalues)
     : values_(values), nvalues_(nvalues) {}
 
-  __device__ inline double operator()(curandState *state) const {
+  template <typename State>
+  __device__ inline double operator()(State *state) const {
     return values_[curand(state) % nvalues_];
   }
 
@@ -132,7 +140,8 @@ struct curand_bernoulli_dist {
   explicit DALI_HOST_DEV curand_bernoulli_dist(float probability = 0.5f)
     : probability_(probability) {}
 
-  __device__ inline bool operator()(curandState *state) const {
+  template <typename State>
+  __device__ inline bool operator()(State *state) const {
     return curand_uniform(state) <= probability_;
   }
 
@@ -145,7 +154,8 @@ struct curand_poisson_dist {
   explicit DALI_HOST_DEV curand_poisson_dist(float lambda)
     : lambda_(lambda) {}
 
-  __device__ inline unsigned int operator()(curandState *state) const {
+  template <typename State>
+  __device__ inline unsigned int operator()(State *state) const {
     return curand_poisson(state, lambda_);
   }
 
@@ -12,27 +12,151 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <memory>
 #include "dali/pipeline/data/buffer.h"
 #include "dali/pipeline/data/backend.h"
 #include "dali/core/mm/memory.h"
+#include "dali/core/mm/cu_vm.h"
 
 namespace dali {
 
+namespace {
+
+struct DeviceMemoryQuota {
+  mm::device_quota_resource *quota = nullptr;
+  int device_id = CPU_ONLY_DEVICE_ID;
+};
+
+thread_local DeviceMemoryQuota tls_device_quota;
+
+#if DALI_USE_CUDA_VM_MAP
+
+/**
+ * @brief Destroys the mapping of a growable buffer, once the work in the release order
+ *        has completed.
+ *
+ * Unmapping doesn't follow the stream order, hence the host waits for the stream.
+ */
+struct GrowableDeleter {
+  mm::cuvm::GrowableMapping *mapping;
+  cudaStream_t release_on_stream;
+
+  void operator()(void *) const {
+    if (release_on_stream != AccessOrder::host_sync_stream())
+      CUDA_DTOR_CALL(cudaStreamSynchronize(release_on_stream));
+    delete mapping;
+  }
+};
+
+#endif  // DALI_USE_CUDA_VM_MAP
+
+}  // namespace
+
+DeviceMemoryQuotaScope::DeviceMemoryQuotaScope(mm::device_quota_resource *quota, int device_id)
+: prev_quota_(tls_device_quota.quota), prev_device_id_(tls_device_quota.device_id) {
+  tls_device_quota.quota = quota;
+  tls_device_quota.device_id = device_id;
+}
+
+DeviceMemoryQuotaScope::~DeviceMemoryQuotaScope() {
+  tls_device_quota.quota = prev_quota_;
+  tls_device_quota.device_id = prev_device_id_;
+}
+
+DLL_PUBLIC bool DeviceMemoryOverSoftLimit() {
+  return tls_device_quota.quota && tls_device_quota.quota->over_soft_limit();
+}
+
+DLL_PUBLIC bool GrowableBuffersSupported() {
+#if DALI_USE_CUDA_VM_MAP
+  return mm::cuvm::IsSupported();
+#else
+  return false;
+#endif
+}
+
+DLL_PUBLIC shared_ptr<uint8_t> AllocGrowableBuffer(size_t bytes, int device_id,
+                                                   AccessOrder order) {
+#if DALI_USE_CUDA_VM_MAP
+  DALI_ENFORCE(GrowableBuffersSupported(),
+               "The CUDA virtual memory management API is not supported on this machine.");
+  DeviceGuard dg(device_id);
+  size_t free_mem = 0, total_mem = 0;
+  CUDA_CALL(cudaMemGetInfo(&free_mem, &total_mem));
+  // The address space is plentiful - reserve enough to never run out of it before running out
+  // of the device memory.
+  auto mapping = std::make_unique<mm::cuvm::GrowableMapping>(std::max(bytes, total_mem),
+                                                             device_id);
+  mapping->resize(bytes);
+  cudaStream_t s = order.has_value() ? order.get() : AccessOrder::host_sync_stream();
+  auto *base = static_cast<uint8_t *>(mapping->ptr());
+  return shared_ptr<uint8_t>(base, GrowableDeleter{ mapping.release(), s });
+#else
+  (void)bytes;
+  (void)device_id;
+  (void)order;
+  DALI_FAIL("Growable buffers require CUDA 10.2 or newer.");
+#endif
+}
+
+DLL_PUBLIC size_t ResizeGrowableBuffer(const shared_ptr<void> &ptr, size_t bytes,
+                                       AccessOrder order) {
+#if DALI_USE_CUDA_VM_MAP
+  auto *del = std::get_deleter<GrowableDeleter>(ptr);
+  if (!del)
+    return 0;
+  auto &mapping = *del->mapping;
+  if (bytes > mapping.max_size())
+    return 0;
+  if (mapping.would_unmap(bytes)) {
+    if (ptr.use_count() != 1)
+      return 0;
+    AccessOrder::host().wait(order);
+  }
+  mapping.resize(bytes);
+  return mapping.size();
+#else
+  (void)ptr;
+  (void)bytes;
+  (void)order;
+  return 0;
+#endif
+}
+
 DLL_PUBLIC AccessOrder get_deletion_order(const std::shared_ptr<void> &ptr) {
   if (auto *del = std::get_deleter<mm::AsyncDeleter>(ptr))
     return AccessOrder(del->release_on_stream);
-  else
-    return {};
+#if DALI_USE_CUDA_VM_MAP
+  if (auto *del = std::get_deleter<GrowableDeleter>(ptr))
+    return AccessOrder(del->release_on_stream);
+#endif
+  return {};
 }
 
+namespace {
+
+template <typename Deleter>
+bool try_set_deletion_order(const std::shared_ptr<void> &ptr, AccessOrder order) {
+  if (auto *del = std::get_deleter<Deleter>(ptr)) {
+    del->release_on_stream = order.get();
+    if (ptr.use_count() != 1)
+      throw std::logic_error("Race condition detected - the pointer is no longer unique.");
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
 DLL_PUBLIC bool set_deletion_order(const std::shared_ptr<void> &ptr, AccessOrder order) {
   if (ptr.use_count() == 1 && order.has_value()) {
-    if (auto *del = std::get_deleter<mm::AsyncDeleter>(ptr)) {
-      del->release_on_stream = order.get();
-      if (ptr.use_count() != 1)
-        throw std::logic_error("Race condition detected - the pointer is no longer unique.");
+    if (try_set_deletion_order<mm::AsyncDeleter>(ptr, order))
       return true;
-    }
+#if DALI_USE_CUDA_VM_MAP
+    if (try_set_deletion_order<GrowableDeleter>(ptr, order))
+      return true;
+#endif
   }
   return false;
 }
@@ -44,19 +168,22 @@ DLL_PUBLIC shared_ptr<uint8_t> AllocBuffer(size_t bytes, bool /* device_ordinal
                                            GPUBackend *) {
   const size_t kDevAlignment = 256;  // warp alignment for 32x64-bit
   cudaStream_t s = order.has_value() ? order.get() : AccessOrder::host_sync_stream();
-  auto *rsrc = mm::GetDefaultDeviceResource(device_id);
+  mm::device_async_resource *rsrc = tls_device_quota.quota;
+  if (!rsrc || tls_device_quota.device_id != device_id)
+    rsrc = mm::GetDefaultDeviceResource(device_id);
   return mm::alloc_raw_async_shared<uint8_t>(rsrc, bytes, s, s, kDevAlignment);
 }
 
 DLL_PUBLIC shared_ptr<uint8_t> AllocBuffer(size_t bytes, bool pinned,
-                                           int /* device_ordinal */,
+                                           int device_id,
                                            AccessOrder order,
                                            CPUBackend *) {
   const size_t kHostAlignment = 64;  // cache alignment
   if (pinned) {
     cudaStream_t s = order.has_value() ? order.get() : AccessOrder::host_sync_stream();
-    return mm::alloc_raw_async_shared<uint8_t, mm::memory_kind::pinned>(
-      bytes, s, s, kHostAlignment);
+    // use the memory local to the NUMA node of the device which will consume the buffer
+    auto *rsrc = mm::GetDefaultPinnedResource(device_id);
+    return mm::alloc_raw_async_shared<uint8_t>(rsrc, bytes, s, s, kHostAlignment);
   } else {
     return mm::alloc_raw_shared<uint8_t, mm::memory_kind::host>(bytes, kHostAlignment);
   }
@@ -15,9 +15,11 @@
 #ifndef DALI_PIPELINE_DATA_BUFFER_H_
 #define DALI_PIPELINE_DATA_BUFFER_H_
 
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <new>
 #include <numeric>
 #include <string>
 #include <type_traits>
@@ -27,6 +29,7 @@
 #include "dali/core/common.h"
 #include "dali/core/device_guard.h"
 #include "dali/core/error_handling.h"
+#include "dali/core/mm/quota_resource.h"
 #include "dali/core/util.h"
 #include "dali/pipeline/data/types.h"
 #include "dali/core/format.h"
@@ -52,6 +55,29 @@ DLL_PUBLIC shared_ptr<uint8_t> AllocBuffer(size_t bytes,
  */
 DLL_PUBLIC bool RestrictPinnedMemUsage();
 
+/**
+ * @brief Makes the GPU buffers allocated by the calling thread on given device use the memory
+ *        quota, for the lifetime of the object.
+ *
+ * The scopes can be nested; a null quota disables the accounting within the scope.
+ */
+class DLL_PUBLIC DeviceMemoryQuotaScope {
+ public:
+  DeviceMemoryQuotaScope(mm::device_quota_resource *quota, int device_id);
+  ~DeviceMemoryQuotaScope();
+  DISABLE_COPY_MOVE_ASSIGN(DeviceMemoryQuotaScope);
+
+ private:
+  mm::device_quota_resource *prev_quota_;
+  int prev_device_id_;
+};
+
+/**
+ * @brief Indicates whether the device memory quota of the calling thread (if any) is above
+ *        its soft limit.
+ */
+DLL_PUBLIC bool DeviceMemoryOverSoftLimit();
+
 template <typename Backend>
 inline shared_ptr<uint8_t> AllocBuffer(size_t bytes,
                                        bool pinned, int device_id = -1,
@@ -59,6 +85,39 @@ inline shared_ptr<uint8_t> AllocBuffer(size_t bytes,
   return AllocBuffer(bytes, pinned, device_id, order, static_cast<Backend*>(nullptr));
 }
 
+/**
+ * @brief Indicates whether the growable GPU buffers (backed by the CUDA virtual memory
+ *        management API) can be used on this machine.
+ */
+DLL_PUBLIC bool GrowableBuffersSupported();
+
+/**
+ * @brief Allocates a GPU buffer which can be grown in place and shrunk by remapping its
+ *        physical memory.
+ *
+ * The buffer occupies a virtual address range large enough to accommodate the whole memory of
+ * the device; the physical memory is mapped only for the first `bytes` bytes (rounded up to
+ * the allocation granularity). The memory doesn't come from the memory pool.
+ *
+ * @param order The order in which the buffer is used - the buffer is released after
+ *              the work scheduled in this order completes.
+ */
+DLL_PUBLIC shared_ptr<uint8_t> AllocGrowableBuffer(size_t bytes, int device_id,
+                                                   AccessOrder order);
+
+/**
+ * @brief Maps or unmaps the physical memory of a buffer allocated with AllocGrowableBuffer,
+ *        without changing its address or the contents of the first `bytes` bytes.
+ *
+ * Before the memory is unmapped, the host waits for `order`. The memory is not unmapped if
+ * the buffer is shared.
+ *
+ * @return The capacity of the buffer after the operation or 0, if `ptr` is not a growable buffer
+ *         or it cannot be resized in place.
+ */
+DLL_PUBLIC size_t ResizeGrowableBuffer(const shared_ptr<void> &ptr, size_t bytes,
+                                       AccessOrder order);
+
 DLL_PUBLIC AccessOrder get_deletion_order(const std::shared_ptr<void> &ptr);
 DLL_PUBLIC bool set_deletion_order(const std::shared_ptr<void> &ptr, AccessOrder order);
 
@@ -249,6 +308,30 @@ class DLL_PUBLIC Buffer {
     return pinned_;
   }
 
+  /**
+   * @brief Makes a GPU buffer grow in place - the physical memory is mapped at the end of
+   *        the allocation, so the address and the contents are preserved and no copy is made.
+   *        Shrinking unmaps the memory past the new size and returns it to the device.
+   *
+   * Requires the support for the CUDA virtual memory management; see GrowableBuffersSupported.
+   */
+  inline void set_growable(bool growable) {
+    DALI_ENFORCE(!has_data(), "Can only set allocation mode before first allocation");
+    DALI_ENFORCE(!allocate_, "Cannot set allocation mode when a custom allocator is used.");
+    if (growable) {
+      DALI_ENFORCE((std::is_same<Backend, GPUBackend>::value),
+                   "Only the GPU buffers can be growable.");
+      DALI_ENFORCE(GrowableBuffersSupported(),
+                   "Growable buffers require the CUDA virtual memory management API, "
+                   "which is not supported on this machine.");
+    }
+    growable_ = growable;
+  }
+
+  inline bool is_growable() const {
+    return growable_;
+  }
+
   /**
    * @brief Returns a device this buffer was allocated on
    * If the backend is CPUBackend, return -1
@@ -372,6 +455,14 @@ class DLL_PUBLIC Buffer {
       return;
     }
 
+    if (growable_ && data_) {
+      set_order(order);
+      if (size_t capacity = ResizeGrowableBuffer(data_, new_num_bytes, order_)) {
+        num_bytes_ = capacity;
+        return;
+      }
+    }
+
     free_storage();
     if (order) {
       set_order(order);
@@ -394,8 +485,23 @@ class DLL_PUBLIC Buffer {
       }
     }
 
-    data_ = allocate_ ? allocate_(new_num_bytes)
-                      : AllocBuffer<Backend>(new_num_bytes, pinned_, device_, order_);
+    if (allocate_) {
+      data_ = allocate_(new_num_bytes);
+    } else if (growable_) {
+      data_ = AllocGrowableBuffer(new_num_bytes, device_, order_);
+    } else {
+      try {
+        data_ = AllocBuffer<Backend>(new_num_bytes, pinned_, device_, order_);
+      } catch (const std::bad_alloc &) {
+        if (!std::is_same<Backend, CPUBackend>::value || !pinned_)
+          throw;
+        // Out of pinned memory or over DALI_PINNED_MEM_LIMIT - the copies from pageable memory
+        // are slower, but they work.
+        DALI_WARN_ONCE("Cannot allocate pinned memory - falling back to pageable memory.");
+        pinned_ = false;
+        data_ = AllocBuffer<Backend>(new_num_bytes, pinned_, device_, order_);
+      }
+    }
 
     num_bytes_ = new_num_bytes;
   }
@@ -431,6 +537,7 @@ class DLL_PUBLIC Buffer {
     std::swap(device_, buffer.device_);
     std::swap(shares_data_, buffer.shares_data_);
     std::swap(pinned_, buffer.pinned_);
+    std::swap(growable_, buffer.growable_);
     std::swap(order_, buffer.order_);
   }
 
@@ -544,7 +651,15 @@ class DLL_PUBLIC Buffer {
       size_t grow = num_bytes_ * growth_factor_;
       if (grow > new_num_bytes) new_num_bytes = grow;
       reserve(new_num_bytes);
-    } else if (!is_pinned() && new_num_bytes < num_bytes_ * shrink_threshold_) {
+    } else if ((std::is_same<Backend, GPUBackend>::value || !is_pinned()) &&
+               new_num_bytes < num_bytes_ * current_shrink_threshold()) {
+      if (growable_) {
+        // unmap the excess memory in place, if the buffer is not shared
+        if (size_t capacity = ResizeGrowableBuffer(data_, new_num_bytes, order_)) {
+          num_bytes_ = capacity;
+          return;
+        }
+      }
       free_storage();
       reserve(new_num_bytes);
     }
@@ -567,6 +682,19 @@ class DLL_PUBLIC Buffer {
     num_bytes_ = 0;
   }
 
+  /**
+   * @brief The shrink threshold in effect - above the soft limit of the device memory quota,
+   *        the GPU buffers release the excess memory, so that it can be used by other clients
+   *        of the memory pool.
+   */
+  static double current_shrink_threshold() {
+    if (std::is_same<Backend, GPUBackend>::value && DeviceMemoryOverSoftLimit())
+      return std::max(shrink_threshold_, kSoftLimitShrinkThreshold);
+    return shrink_threshold_;
+  }
+
+  static constexpr double kSoftLimitShrinkThreshold = 0.5;
+
   template <typename>
   friend class TensorList;
 
@@ -584,6 +712,7 @@ class DLL_PUBLIC Buffer {
   AccessOrder order_;                // The order of memory access (host or device)
   bool shares_data_ = false;         // Whether we aren't using our own allocation
   bool pinned_ = !RestrictPinnedMemUsage();  // Whether the allocation uses pinned memory
+  bool growable_ = false;            // Whether the GPU allocation is grown by remapping
 };
 
 template <typename Backend>
@@ -596,6 +725,9 @@ DLL_PUBLIC double Buffer<Backend>::shrink_threshold_ =
 template <typename Backend>
 constexpr double Buffer<Backend>::kMaxGrowthFactor;
 
+template <typename Backend>
+constexpr double Buffer<Backend>::kSoftLimitShrinkThreshold;
+
 
 // Macro so we don't have to list these in all
 // classes that derive from Buffer
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,7 @@
 #define DALI_PIPELINE_DATA_META_H_
 
 #include <string>
+#include "dali/image/image_info.h"
 #include "dali/pipeline/data/types.h"
 
 namespace dali {
@@ -51,10 +52,25 @@ class DALIMeta {
     return skip_sample_;
   }
 
+  /**
+   * @brief The header info of an encoded image, parsed by the operator producing the sample
+   *
+   * The info is valid only if it was parsed from the data of the sample (see
+   * ImageInfo::IsValidFor), otherwise the consumers should parse the header themselves.
+   */
+  inline const ImageInfo &GetImageInfo() const {
+    return image_info_;
+  }
+
+  inline void SetImageInfo(const ImageInfo &image_info) {
+    image_info_ = image_info;
+  }
+
  private:
   TensorLayout layout_;
   std::string source_info_;
   bool skip_sample_ = false;
+  ImageInfo image_info_;
 };
 
 }  // namespace dali
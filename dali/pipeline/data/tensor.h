@@ -454,6 +454,14 @@ class Tensor : public Buffer<Backend> {
     return meta_.ShouldSkipSample();
   }
 
+  inline const ImageInfo &GetImageInfo() const {
+    return meta_.GetImageInfo();
+  }
+
+  inline void SetImageInfo(const ImageInfo &image_info) {
+    meta_.SetImageInfo(image_info);
+  }
+
  protected:
   TensorShape<> shape_ = { 0 };
   DALIMeta meta_;
@@ -143,15 +143,20 @@ class DLL_PUBLIC TensorList {
     dsts.reserve(nsamples);
     SmallVector<Index, 256> sizes;
     sizes.reserve(nsamples);
+    Index total_elements = 0;
     for (int i = 0; i < nsamples; i++) {
       dsts.emplace_back(this->raw_mutable_tensor(i));
       srcs.emplace_back(other[i].raw_data());
       sizes.emplace_back(other[i].shape().num_elements());
+      total_elements += sizes.back();
       this->meta_[i] = other.GetMeta(i);
     }
 
-    use_copy_kernel &= (std::is_same<SrcBackend, GPUBackend>::value || other.is_pinned()) &&
-                       (std::is_same<Backend, GPUBackend>::value || is_pinned());
+    bool device_access = (std::is_same<SrcBackend, GPUBackend>::value || other.is_pinned()) &&
+                         (std::is_same<Backend, GPUBackend>::value || is_pinned());
+    // scattered small samples are gathered with one kernel rather than a memcpy per sample
+    use_copy_kernel = device_access && (use_copy_kernel ||
+        detail::PreferCopyKernel(nsamples, total_elements * type_info().size()));
     type_info().template Copy<SrcBackend, Backend>(dsts.data(), srcs.data(), sizes.data(),
                                                    nsamples, order.stream(), use_copy_kernel);
     this->order().wait(order);
@@ -244,6 +249,40 @@ class DLL_PUBLIC TensorList {
     tensor_views_.clear();
   }
 
+  /**
+   * @brief Wraps the parts of the allocation of the input TensorList as the samples
+   * of the given shape.
+   *
+   * The samples start at the given offsets (in elements) in the allocation of `other` and,
+   * unlike the samples of a TensorList allocated with Resize, they don't have to be densely
+   * packed - e.g. this TensorList can hold one of the inputs joined in `other`.
+   * The type and the order are taken from `other`; the layout is kept, if it matches
+   * the new number of dimensions.
+   */
+  inline void ShareSubregions(const TensorList<Backend> &other, const TensorListShape<> &shape,
+                              span<const Index> offsets) {
+    DALI_ENFORCE(IsValidType(other.type()), "To share data, "
+        "the input TensorList must have a valid data type");
+    DALI_ENFORCE(offsets.size() == shape.num_samples(), make_string(
+        "Got ", offsets.size(), " offsets for ", shape.num_samples(), " samples."));
+    for (int i = 0; i < shape.num_samples(); i++) {
+      DALI_ENFORCE(offsets[i] >= 0 && offsets[i] + volume(shape[i]) <= other._num_elements(),
+                   make_string("Sample ", i, " doesn't fit in the shared allocation."));
+    }
+
+    data_.ShareData(other.data_);
+
+    shape_ = shape;
+    offsets_.assign(offsets.begin(), offsets.end());
+    if (layout_.size() != shape.sample_dim())
+      layout_ = {};
+    meta_.clear();
+    meta_.resize(shape.num_samples(), DALIMeta(layout_));
+
+    // Tensor views of this TensorList is no longer valid
+    tensor_views_.clear();
+  }
+
   /**
    * @brief Interprets a raw allocation as a tensor list with given shape.
    *
@@ -695,6 +734,18 @@ class DLL_PUBLIC TensorList {
     return data_.is_pinned();
   }
 
+  /**
+   * @brief Makes the GPU TensorList grow in place, by mapping more physical memory at the end
+   *        of the allocation; see Buffer::set_growable
+   */
+  inline void set_growable(bool growable) {
+    data_.set_growable(growable);
+  }
+
+  bool is_growable() const {
+    return data_.is_growable();
+  }
+
    /**
    * @brief Returns a device this TensorList was allocated on
    * If the backend is CPUBackend, return -1
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <string>
 #include "dali/pipeline/data/tensor_vector.h"
 #include "dali/core/common.h"
@@ -21,13 +22,12 @@ namespace dali {
 
 template <typename Backend>
 TensorVector<Backend>::TensorVector()
-    : views_count_(0), curr_num_tensors_(0), tl_(std::make_shared<TensorList<Backend>>()) {}
+    : curr_num_tensors_(0), tl_(std::make_shared<TensorList<Backend>>()) {}
 
 
 template <typename Backend>
 TensorVector<Backend>::TensorVector(int batch_size)
-    : views_count_(0),
-      curr_num_tensors_(0),
+    : curr_num_tensors_(0),
       tl_(std::make_shared<TensorList<Backend>>(batch_size)) {
   resize_tensors(batch_size);
 }
@@ -35,7 +35,7 @@ TensorVector<Backend>::TensorVector(int batch_size)
 
 template <typename Backend>
 TensorVector<Backend>::TensorVector(std::shared_ptr<TensorList<Backend>> tl)
-    : views_count_(0), curr_num_tensors_(0), tl_(std::move(tl)) {
+    : curr_num_tensors_(0), tl_(std::move(tl)) {
   assert(tl_ && "Construction with null TensorList is illegal");
   pinned_ = tl_->is_pinned();
   type_ = tl_->type_info();
@@ -55,17 +55,14 @@ TensorVector<Backend>::TensorVector(TensorVector<Backend> &&other) noexcept {
   tl_ = std::move(other.tl_);
   type_ = std::move(other.type_);
   sample_dim_ = other.sample_dim_;
-  views_count_ = other.views_count_.load();
   tensors_ = std::move(other.tensors_);
-  for (auto &t : tensors_) {
-    if (t) {
-      if (auto *del = std::get_deleter<ViewRefDeleter>(t->data_)) del->ref = &views_count_;
-    }
-  }
+  view_pending_ = std::move(other.view_pending_);
+  num_pending_views_ = other.num_pending_views_.load();
 
-  other.views_count_ = 0;
   other.curr_num_tensors_ = 0;
   other.tensors_.clear();
+  other.view_pending_.clear();
+  other.num_pending_views_ = 0;
   other.sample_dim_ = -1;
 }
 
@@ -97,7 +94,13 @@ void TensorVector<Backend>::UnsafeSetSample(int sample_idx, const TensorVector<B
   SetContiguous(false);
   // Setting a new share overwrites the previous one - so we can safely assume that even if
   // we had a sample sharing into TL, it will be overwritten
-  tensors_[sample_idx]->ShareData(*src.tensors_[src_sample_idx]);
+  if (src.view_pending_[src_sample_idx]) {
+    Tensor<Backend> src_view;
+    src.make_view(src_view, src_sample_idx);
+    tensors_[sample_idx]->ShareData(src_view);
+  } else {
+    tensors_[sample_idx]->ShareData(*src.tensors_[src_sample_idx]);
+  }
   tl_->Reset();
 }
 
@@ -175,8 +178,9 @@ void TensorVector<Backend>::UnsafeCopySample(int sample_idx, const TensorVector<
       make_string("Sample must have the same layout as a target batch current: ", GetLayout(),
                   " new: ", src.GetLayout(), " for ", sample_idx, " <- ", src_sample_idx, "."));
 
+  ensure_view(sample_idx);
   // Either the shape matches and we can copy data as is or the target is just an individual sample
-  bool can_copy = tensors_[sample_idx]->shape() == src.tensors_[src_sample_idx]->shape() ||
+  bool can_copy = tensors_[sample_idx]->shape() == src.tensor_shape(src_sample_idx) ||
                   (!tl_->has_data() && state_ == State::noncontiguous);
 
   DALI_ENFORCE(
@@ -185,7 +189,13 @@ void TensorVector<Backend>::UnsafeCopySample(int sample_idx, const TensorVector<
       "TensorVector is truly non contiguous. Either Resize first to the desired shape or reset the "
       "TensorVector and SetSize for desired number of samples in non-contiguous mode.");
 
-  tensors_[sample_idx]->Copy(*src.tensors_[src_sample_idx], order);
+  if (src.view_pending_[src_sample_idx]) {
+    Tensor<Backend> src_view;
+    src.make_view(src_view, src_sample_idx);
+    tensors_[sample_idx]->Copy(src_view, order);
+  } else {
+    tensors_[sample_idx]->Copy(*src.tensors_[src_sample_idx], order);
+  }
 }
 
 template <typename Backend>
@@ -374,13 +384,19 @@ void TensorVector<Backend>::SetLayout(const TensorLayout &layout) {
 
 template <typename Backend>
 void TensorVector<Backend>::SetSkipSample(int idx, bool skip_sample) {
-  tensors_[idx]->SetSkipSample(skip_sample);
+  if (view_pending_[idx])
+    tl_->SetSkipSample(idx, skip_sample);
+  else
+    tensors_[idx]->SetSkipSample(skip_sample);
 }
 
 
 template <typename Backend>
 void TensorVector<Backend>::SetSourceInfo(int idx, const std::string& source_info) {
-  tensors_[idx]->SetSourceInfo(source_info);
+  if (view_pending_[idx])
+    tl_->SetSourceInfo(idx, source_info);
+  else
+    tensors_[idx]->SetSourceInfo(source_info);
 }
 
 
@@ -388,7 +404,7 @@ template <typename Backend>
 TensorLayout TensorVector<Backend>::GetLayout() const {
   if (state_ == State::contiguous) {
     auto layout = tl_->GetLayout();
-    if (!layout.empty()) return layout;
+    if (!layout.empty() || (curr_num_tensors_ > 0 && view_pending_[0])) return layout;
   }
   if (curr_num_tensors_ > 0) {
     auto layout = tensors_[0]->GetLayout();
@@ -402,6 +418,8 @@ TensorLayout TensorVector<Backend>::GetLayout() const {
 template <typename Backend>
 const DALIMeta &TensorVector<Backend>::GetMeta(int idx) const {
   assert(idx < curr_num_tensors_);
+  if (view_pending_[idx])
+    return tl_->GetMeta(idx);
   return tensors_[idx]->GetMeta();
 }
 
@@ -409,7 +427,10 @@ const DALIMeta &TensorVector<Backend>::GetMeta(int idx) const {
 template <typename Backend>
 void TensorVector<Backend>::SetMeta(int idx, const DALIMeta &meta) {
   assert(idx < curr_num_tensors_);
-  tensors_[idx]->SetMeta(meta);
+  if (view_pending_[idx])
+    tl_->SetMeta(idx, meta);
+  else
+    tensors_[idx]->SetMeta(meta);
 }
 
 
@@ -432,7 +453,7 @@ bool TensorVector<Backend>::is_pinned() const {
 
 template <typename Backend>
 int TensorVector<Backend>::device_id() const {
-  if (IsContiguous()) {
+  if (IsContiguous() || (curr_num_tensors_ > 0 && view_pending_[0])) {
     return tl_->device_id();
   } else if (!tensors_.empty()) {
     return tensors_[0]->device_id();
@@ -456,7 +477,7 @@ void TensorVector<Backend>::reserve(size_t total_bytes) {
 template <typename Backend>
 void TensorVector<Backend>::reserve(size_t bytes_per_sample, int batch_size) {
   assert(batch_size > 0);
-  state_ = State::noncontiguous;
+  SetContiguous(false);
   resize_tensors(batch_size);
   for (int i = 0; i < curr_num_tensors_; i++) {
     tensors_[i]->reserve(bytes_per_sample);
@@ -466,7 +487,28 @@ void TensorVector<Backend>::reserve(size_t bytes_per_sample, int batch_size) {
 
 template <typename Backend>
 bool TensorVector<Backend>::IsContiguous() const noexcept {
-  return state_ == State::contiguous && views_count_ == num_samples();
+  if (state_ != State::contiguous || curr_num_tensors_ != tl_->num_samples())
+    return false;
+  if (num_pending_views_ == curr_num_tensors_)
+    return true;
+  // the samples that were accessed as Tensors might have been reallocated or replaced
+  for (int i = 0; i < curr_num_tensors_; i++) {
+    if (!view_pending_[i] && tensors_[i]->raw_data() != tl_->raw_tensor(i))
+      return false;
+  }
+  return true;
+}
+
+
+template <typename Backend>
+bool TensorVector<Backend>::shares_data() const {
+  if (state_ == State::contiguous)
+    return tl_->shares_data();
+  for (int i = 0; i < curr_num_tensors_; i++) {
+    if (tensors_[i]->shares_data())
+      return true;
+  }
+  return false;
 }
 
 
@@ -475,6 +517,8 @@ void TensorVector<Backend>::SetContiguous(bool contiguous) {
   if (contiguous) {
     state_ = State::contiguous;
   } else {
+    // the samples are going to be handled individually - they need their views
+    ensure_views();
     state_ = State::noncontiguous;
   }
 }
@@ -482,12 +526,14 @@ void TensorVector<Backend>::SetContiguous(bool contiguous) {
 
 template <typename Backend>
 void TensorVector<Backend>::Reset() {
+  bool contiguous = IsContiguous();
   tensors_.clear();
+  view_pending_.clear();
+  num_pending_views_ = 0;
   curr_num_tensors_ = 0;
   type_ = {};
   sample_dim_ = -1;
-  if (IsContiguous()) {
-    views_count_ = 0;
+  if (contiguous) {
     tl_->Reset();
   }
 }
@@ -537,15 +583,17 @@ void TensorVector<Backend>::ShareData(const TensorVector<Backend> &tv) {
   sample_dim_ = tv.sample_dim_;
   state_ = tv.state_;
   pinned_ = tv.is_pinned();
-  views_count_ = 0;
   if (tv.state_ == State::contiguous) {
     ShareData(*tv.tl_);
   } else {
     state_ = State::noncontiguous;
     tl_->Reset();
     int batch_size = tv.num_samples();
+    resize_tensors(batch_size);
+    // all the samples are replaced, there's no need to create their views
+    std::fill(view_pending_.begin(), view_pending_.end(), false);
+    num_pending_views_ = 0;
     for (int i = 0; i < batch_size; i++) {
-      resize_tensors(batch_size);
       tensors_[i]->ShareData(*(tv.tensors_[i]));
     }
   }
@@ -562,17 +610,14 @@ TensorVector<Backend> &TensorVector<Backend>::operator=(TensorVector<Backend> &&
     tl_ = std::move(other.tl_);
     type_ = other.type_;
     sample_dim_ = other.sample_dim_;
-    views_count_ = other.views_count_.load();
     tensors_ = std::move(other.tensors_);
-    for (auto &t : tensors_) {
-      if (t) {
-        if (auto *del = std::get_deleter<ViewRefDeleter>(t->data_)) del->ref = &views_count_;
-      }
-    }
+    view_pending_ = std::move(other.view_pending_);
+    num_pending_views_ = other.num_pending_views_.load();
 
-    other.views_count_ = 0;
     other.curr_num_tensors_ = 0;
     other.tensors_.clear();
+    other.view_pending_.clear();
+    other.num_pending_views_ = 0;
   }
   return *this;
 }
@@ -588,10 +633,17 @@ void TensorVector<Backend>::UpdateViews() {
 
   assert(curr_num_tensors_ == tl_->num_samples());
 
-  views_count_ = curr_num_tensors_;
+  if (num_pending_views_ == curr_num_tensors_)
+    return;
+  // The views are created when the samples are accessed as Tensors (see ensure_view),
+  // until then the samples are accessed directly in tl_.
   for (int i = 0; i < curr_num_tensors_; i++) {
-    update_view(i);
+    if (!view_pending_[i]) {
+      tensors_[i]->Reset();  // drop the previous view or the sample's own allocation
+      view_pending_[i] = true;
+    }
   }
+  num_pending_views_ = curr_num_tensors_;
 }
 
 
@@ -602,7 +654,8 @@ std::shared_ptr<TensorList<Backend>> TensorVector<Backend>::AsTensorList(bool ch
   // Update the metadata when we are exposing the TensorList to the outside, as it might have been
   // kept in the individual tensors
   for (int idx = 0; idx < curr_num_tensors_; idx++) {
-    tl_->SetMeta(idx, tensors_[idx]->GetMeta());
+    if (!view_pending_[idx])
+      tl_->SetMeta(idx, tensors_[idx]->GetMeta());
   }
   return tl_;
 }
@@ -613,6 +666,7 @@ void TensorVector<Backend>::resize_tensors(int new_size) {
   if (static_cast<size_t>(new_size) > tensors_.size()) {
     auto old_size = curr_num_tensors_;
     tensors_.resize(new_size);
+    view_pending_.resize(new_size, false);
     for (int i = old_size; i < new_size; i++) {
       if (!tensors_[i]) {
         tensors_[i] = std::make_shared<Tensor<Backend>>();
@@ -622,7 +676,10 @@ void TensorVector<Backend>::resize_tensors(int new_size) {
     }
   } else if (new_size < curr_num_tensors_) {
     for (int i = new_size; i < curr_num_tensors_; i++) {
-      if (tensors_[i]->shares_data()) {
+      if (view_pending_[i]) {
+        view_pending_[i] = false;
+        --num_pending_views_;
+      } else if (tensors_[i]->shares_data()) {
         tensors_[i]->Reset();
       }
     }
@@ -638,6 +695,7 @@ void TensorVector<Backend>::UpdatePropertiesFromSamples(bool contiguous) {
   // TODO(klecki): This is mostly simple consistency check, but most of the metadata will be moved
   // to the batch object for consitency and easier use in checks. It should allow for shape()
   // to be ready to use as well as easy verification for SetSample/CopySample.
+  ensure_views();
   SetContiguous(contiguous);
   // assume that the curr_num_tensors_ is valid
   DALI_ENFORCE(curr_num_tensors_ > 0, "Unexpected empty output of operator. Internal DALI error.");
@@ -677,27 +735,30 @@ bool TensorVector<Backend>::has_data() const {
 }
 
 template <typename Backend>
-void TensorVector<Backend>::update_view(int idx) {
-  assert(idx < curr_num_tensors_);
+void TensorVector<Backend>::make_view(Tensor<Backend> &view, int idx) const {
   assert(idx < tl_->num_samples());
 
-  auto *ptr = tl_->raw_mutable_tensor(idx);
-
+  auto *ptr = const_cast<void *>(tl_->raw_tensor(idx));
   TensorShape<> shape = tl_->tensor_shape(idx);
 
-  tensors_[idx]->Reset();
-  // TODO(klecki): deleter that reduces views_count or just noop sharing?
-  // tensors_[i]->ShareData(tl_.get(), static_cast<int>(idx));
-  if (tensors_[idx]->raw_data() != ptr || tensors_[idx]->shape() != shape) {
-    tensors_[idx]->ShareData(std::shared_ptr<void>(ptr, ViewRefDeleter{&views_count_}),
-                             volume(tl_->tensor_shape(idx)) * tl_->type_info().size(),
-                             tl_->is_pinned(),
-                             shape, tl_->type(),
-                             order());
-  } else if (IsValidType(tl_->type())) {
-    tensors_[idx]->set_type(tl_->type());
-  }
-  tensors_[idx]->SetMeta(tl_->GetMeta(idx));
+  view.Reset();
+  // A non-owning pointer (aliasing an empty shared_ptr) - it doesn't allocate a control block.
+  // The memory is owned by tl_.
+  view.ShareData(std::shared_ptr<void>(std::shared_ptr<void>(), ptr),
+                 volume(shape) * tl_->type_info().size(),
+                 tl_->is_pinned(),
+                 shape, tl_->type(),
+                 order());
+  view.SetMeta(tl_->GetMeta(idx));
+}
+
+
+template <typename Backend>
+void TensorVector<Backend>::ensure_views() {
+  if (num_pending_views_ == 0)
+    return;
+  for (int i = 0; i < curr_num_tensors_; i++)
+    ensure_view(i);
 }
 
 
@@ -38,9 +38,14 @@ namespace dali {
  *
  * Propagates Buffer calls to every tensor uniformly
  *
+ * When contiguous, the batch metadata (shape, type, layout and the per-sample meta) is kept only
+ * in the underlying TensorList. The per-sample Tensor views of it are created lazily, when a sample
+ * is accessed as a Tensor object (e.g. in a SampleWorkspace) - until then, the samples are
+ * accessed directly in the TensorList.
+ *
  * TODO(klecki): Expected improvements to TensorVector
  * 1. Remove superfluous indirection via shared_ptr to samples.
- * 2. Keep metadata (shape, sample_dim, layout, order) at batch level like we already do with type
+ * 2. Keep metadata (shape, sample_dim, layout, order) at batch level also when not contiguous
  * 3. Detect and convert between contiguous and non-contiguous when possible:
  *    a. CopySample of bigger size
  *    b. Resize with coalesce option
@@ -89,10 +94,14 @@ class DLL_PUBLIC TensorVector {
   void set_order(AccessOrder order, bool synchronize = true);
 
   SampleView<Backend> operator[](size_t pos) {
+    if (view_pending_[pos])
+      return {tl_->raw_mutable_tensor(pos), tl_->tensor_shape(pos), tl_->type()};
     return {tensors_[pos]->raw_mutable_data(), tensors_[pos]->shape(), tensors_[pos]->type()};
   }
 
   ConstSampleView<Backend> operator[](size_t pos) const {
+    if (view_pending_[pos])
+      return {tl_->raw_tensor(pos), tl_->tensor_shape(pos), tl_->type()};
     return {tensors_[pos]->raw_data(), tensors_[pos]->shape(), tensors_[pos]->type()};
   }
 
@@ -124,7 +133,9 @@ class DLL_PUBLIC TensorVector {
 
   TensorListShape<> shape() const;
 
-  const TensorShape<> &tensor_shape(int idx) const {
+  TensorShape<> tensor_shape(int idx) const {
+    if (view_pending_[idx])
+      return tl_->tensor_shape(idx);
     return tensors_[idx]->shape();
   }
 
@@ -133,6 +144,8 @@ class DLL_PUBLIC TensorVector {
    */
   template <typename T>
   DLL_PUBLIC inline T* mutable_tensor(int idx) {
+    if (view_pending_[idx])
+      return tl_->template mutable_tensor<T>(idx);
     return tensors_[idx]->template mutable_data<T>();
   }
 
@@ -141,6 +154,8 @@ class DLL_PUBLIC TensorVector {
    */
   template <typename T>
   DLL_PUBLIC inline const T* tensor(int idx) const {
+    if (view_pending_[idx])
+      return tl_->template tensor<T>(idx);
     return tensors_[idx]->template data<T>();
   }
 
@@ -148,6 +163,8 @@ class DLL_PUBLIC TensorVector {
    * @brief Returns a raw pointer to the tensor with the given index.
    */
   DLL_PUBLIC inline void* raw_mutable_tensor(int idx) {
+    if (view_pending_[idx])
+      return tl_->raw_mutable_tensor(idx);
     return tensors_[idx]->raw_mutable_data();
   }
 
@@ -155,7 +172,9 @@ class DLL_PUBLIC TensorVector {
    * @brief Returns a const raw pointer to the tensor with the given index.
    */
   DLL_PUBLIC inline const void* raw_tensor(int idx) const {
-    return  tensors_[idx]->raw_data();
+    if (view_pending_[idx])
+      return tl_->raw_tensor(idx);
+    return tensors_[idx]->raw_data();
   }
 
   /**
@@ -195,6 +214,19 @@ class DLL_PUBLIC TensorVector {
                                   bool pinned, const TensorShape<> &shape, DALIDataType type,
                                   AccessOrder order = {}, const TensorLayout &layout = "");
 
+  /**
+   * @brief Returns a pointer to the sample, which shares the ownership of its allocation.
+   *
+   * Together with the UnsafeSetSample(int, const shared_ptr<void>&, ...) it allows other
+   * batches to reference (parts of) the sample without copying it.
+   */
+  friend shared_ptr<void> unsafe_sample_owner(const TensorVector<Backend> &tv, int sample_idx) {
+    assert(sample_idx >= 0 && sample_idx < tv.curr_num_tensors_);
+    if (tv.state_ == State::contiguous)
+      return unsafe_sample_owner(*tv.tl_, sample_idx);
+    return tv.tensors_[sample_idx]->get_data_ptr();
+  }
+
   /**
    * @brief Analogue of TensorVector[sample_idx].Copy(src[src_sample_idx]);
    *
@@ -293,6 +325,11 @@ class DLL_PUBLIC TensorVector {
    */
   bool IsContiguous() const noexcept;
 
+  /**
+   * @brief If the samples use memory owned by another object (e.g. provided by the user)
+   */
+  bool shares_data() const;
+
   /**
    * @brief Set the current state if further calls like Resize() or set_type
    *        should use TensorList or std::vector<Tensor> as backing memory
@@ -325,11 +362,13 @@ class DLL_PUBLIC TensorVector {
                              int data_idx, int thread_idx);
   friend void FixBatchPropertiesConsistency(class HostWorkspace &ws, bool contiguous);
 
+  /**
+   * @brief Returns the sample as a Tensor object, creating its view if it's still pending
+   *
+   * Different samples can be obtained concurrently.
+   */
   auto tensor_handle(size_t pos) {
-    return tensors_[pos];
-  }
-
-  auto tensor_handle(size_t pos) const {
+    ensure_view(pos);
     return tensors_[pos];
   }
 
@@ -356,17 +395,31 @@ class DLL_PUBLIC TensorVector {
 
   bool has_data() const;
 
-  struct ViewRefDeleter {
-    void operator()(void*) { --*ref; }
-    std::atomic<int> *ref;
-  };
-
   void resize_tensors(int size);
 
-  void update_view(int idx);
+  /**
+   * @brief Makes `view` a non-owning view of the sample `idx` of the underlying TensorList
+   */
+  void make_view(Tensor<Backend> &view, int idx) const;
+
+  /**
+   * @brief Creates the view of the sample in tensors_, if it's pending
+   */
+  void ensure_view(int idx) {
+    if (view_pending_[idx]) {
+      make_view(*tensors_[idx], idx);
+      view_pending_[idx] = false;
+      --num_pending_views_;
+    }
+  }
+
+  void ensure_views();
 
-  std::atomic<int> views_count_;
   std::vector<std::shared_ptr<Tensor<Backend>>> tensors_;
+  // Samples of the contiguous batch, whose views in tensors_ were not created yet - they
+  // are accessed directly in tl_. Kept as bytes, so that the samples can be updated concurrently.
+  std::vector<uint8_t> view_pending_;
+  std::atomic<int> num_pending_views_{0};
   int curr_num_tensors_;
   std::shared_ptr<TensorList<Backend>> tl_;
   State state_ = State::noncontiguous;
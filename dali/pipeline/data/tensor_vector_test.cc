@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 #include <string>
 
+#include "dali/core/cuda_error.h"
 #include "dali/core/format.h"
 #include "dali/core/tensor_shape.h"
 #include "dali/pipeline/data/tensor_vector.h"
@@ -184,6 +185,44 @@ TYPED_TEST(TensorVectorSuite, EmptyShareNonContiguous) {
   }
 }
 
+TYPED_TEST(TensorVectorSuite, ContiguousSampleAccess) {
+  TensorVector<TypeParam> tv;
+  tv.SetContiguous(true);
+  TensorListShape<> shape = {{2, 3}, {4, 5}, {1, 1}};
+  // the sample views are created lazily - repeated resizing must keep them consistent
+  for (int iter = 0; iter < 3; iter++) {
+    tv.Resize(shape, DALI_INT32);
+    ASSERT_TRUE(tv.IsContiguous());
+    auto *base = static_cast<const int32_t *>(tv.raw_tensor(0));
+    int64_t offset = 0;
+    for (int i = 0; i < shape.num_samples(); i++) {
+      EXPECT_EQ(tv.raw_tensor(i), base + offset);
+      EXPECT_EQ(tv.tensor_shape(i), shape[i]);
+      EXPECT_EQ(tv[i].shape(), shape[i]);
+      offset += volume(shape[i]);
+    }
+  }
+  tv.SetSourceInfo(1, "sample1");
+  EXPECT_EQ(tv.GetMeta(1).GetSourceInfo(), "sample1");
+  EXPECT_EQ(tv.AsTensorList()->GetMeta(1).GetSourceInfo(), "sample1");
+
+  TensorVector<TypeParam> target;
+  target.SetContiguous(true);
+  target.Resize(shape, DALI_INT32);
+  target.UnsafeCopySample(1, tv, 1);
+  EXPECT_TRUE(target.IsContiguous());
+  EXPECT_EQ(target.tensor_shape(1), shape[1]);
+  EXPECT_EQ(target.GetMeta(1).GetSourceInfo(), "sample1");
+
+  // the samples are kept when the batch is converted to non-contiguous
+  const void *ptr = tv.raw_tensor(1);
+  tv.SetContiguous(false);
+  EXPECT_FALSE(tv.IsContiguous());
+  EXPECT_EQ(tv.raw_tensor(1), ptr);
+  EXPECT_EQ(tv.tensor_shape(1), shape[1]);
+  EXPECT_EQ(tv.GetMeta(1).GetSourceInfo(), "sample1");
+}
+
 template <typename Backend, typename F>
 void test_moving_props(const bool is_pinned, const TensorLayout layout,
                        const TensorListShape<> shape, const int sample_dim, const DALIDataType type,
@@ -355,5 +394,34 @@ TEST_F(TensorVectorVariableBatchSizeTest, TlCopyWithResizeDown) {
   EXPECT_PRED_FORMAT2(Compare, test_tl_, tv);
 }
 
+TEST(TensorVectorCopy, ScatteredSamplesToGPU) {
+  // many small, non-contiguous samples - with pinned memory, they're gathered with a kernel
+  const int N = 64;
+  for (bool pinned : {false, true}) {
+    TensorVector<CPUBackend> tv;
+    tv.set_pinned(pinned);
+    tv.reserve(1024, N);
+    tv.set_type<int32_t>();
+    TensorListShape<> shape(N, 1);
+    for (int i = 0; i < N; i++)
+      shape.set_tensor_shape(i, {i % 7 + 1});
+    tv.Resize(shape);
+    ASSERT_FALSE(tv.IsContiguous());
+    for (int i = 0; i < N; i++)
+      for (int j = 0; j < shape[i][0]; j++)
+        tv.mutable_tensor<int32_t>(i)[j] = i * 1000 + j;
+
+    TensorList<GPUBackend> gpu;
+    gpu.Copy(tv, cuda_stream);
+    TensorList<CPUBackend> back;
+    back.Copy(gpu, cuda_stream);
+    CUDA_CALL(cudaStreamSynchronize(cuda_stream));
+    ASSERT_EQ(back.shape(), shape);
+    for (int i = 0; i < N; i++)
+      for (int j = 0; j < shape[i][0]; j++)
+        ASSERT_EQ(back.tensor<int32_t>(i)[j], i * 1000 + j) << "pinned: " << pinned;
+  }
+}
+
 }  // namespace test
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -56,6 +56,20 @@ namespace detail {
 
 void LaunchCopyKernel(void *dst, const void *src, int64_t nbytes, cudaStream_t stream);
 
+/**
+ * @brief Tells whether a batch of `n` copies, `total_bytes` in total, is better done by
+ *        the scatter-gather kernel than by a cudaMemcpyAsync per sample
+ *
+ * For many small samples, the overhead of issuing the copies dominates - one kernel, which reads
+ * all the (device-accessible) sources directly, is faster. Large samples are left to the copy
+ * engines.
+ */
+inline bool PreferCopyKernel(int n, size_t total_bytes) {
+  constexpr int kMinSamples = 16;
+  constexpr size_t kMaxAvgSampleBytes = 64 << 10;
+  return n >= kMinSamples && total_bytes <= n * kMaxAvgSampleBytes;
+}
+
 typedef void (*Copier)(void *, const void*, Index);
 
 template <typename T>
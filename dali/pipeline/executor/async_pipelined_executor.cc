@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -50,11 +50,14 @@ void AsyncPipelinedExecutor::RunMixed() {
   CheckForErrors();
   mixed_thread_.DoWork([this]() {
         // Block until there is mixed work to do
+        auto start = TimingCollector::Clock::now();
         std::unique_lock<std::mutex> lock(GetReadyMutex());
         while (mixed_work_counter_ == 0 && !exec_error_ && !IsStopSignaled()) {
           mixed_work_cv_.wait(lock);
         }
         --mixed_work_counter_;
+        // the stages are handed the work here and not in the uniform queue policy
+        queue_waits_.AddConsumerWait(OpType::CPU, TimingCollector::Seconds(start));
         if (exec_error_ || IsStopSignaled()) {
           gpu_work_cv_.notify_all();
           return;
@@ -76,11 +79,13 @@ void AsyncPipelinedExecutor::RunGPU() {
   CheckForErrors();
   gpu_thread_.DoWork([this]() {
         // Block until there is gpu work to do
+        auto start = TimingCollector::Clock::now();
         std::unique_lock<std::mutex> lock(GetReadyMutex());
         while (gpu_work_counter_ == 0 && !exec_error_ && !IsStopSignaled()) {
           gpu_work_cv_.wait(lock);
         }
         --gpu_work_counter_;
+        queue_waits_.AddConsumerWait(OpType::MIXED, TimingCollector::Seconds(start));
         lock.unlock();
         if (exec_error_ || IsStopSignaled())
           return;
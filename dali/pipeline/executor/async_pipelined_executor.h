@@ -108,6 +108,12 @@ class DLL_PUBLIC AsyncPipelinedExecutor : public PipelinedExecutor {
     }
   }
 
+  DLL_PUBLIC bool TryShareOutputs(DeviceWorkspace *ws) override {
+    // the caller doesn't wait for the outputs, so the errors of the workers are checked here
+    CheckForErrors();
+    return PipelinedExecutor::TryShareOutputs(ws);
+  }
+
  protected:
   void CheckForErrors() {
     cpu_thread_.CheckForErrors();
@@ -97,6 +97,12 @@ class DLL_PUBLIC AsyncSeparatedPipelinedExecutor : public SeparatedPipelinedExec
     }
   }
 
+  DLL_PUBLIC bool TryShareOutputs(DeviceWorkspace *ws) override {
+    // the caller doesn't wait for the outputs, so the errors of the workers are checked here
+    CheckForErrors();
+    return SeparatedPipelinedExecutor::TryShareOutputs(ws);
+  }
+
  protected:
   void CheckForErrors() {
     cpu_thread_.CheckForErrors();
@@ -0,0 +1,73 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utility>
+
+#include "dali/pipeline/executor/checkpoint.h"
+
+namespace dali {
+
+void CheckpointRecorder::Reset(int num_ops, int64_t iteration) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  consumed_ = iteration;
+  ops_.clear();
+  ops_.resize(num_ops);
+  for (auto &op : ops_)
+    op.runs = iteration;
+}
+
+void CheckpointRecorder::RecordRun(int op_id, const std::string &operator_name,
+                                   std::string state) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto &op = ops_[op_id];
+  op.runs++;
+  if (state.empty())
+    return;
+  op.operator_name = operator_name;
+  op.states.emplace_back(op.runs, std::move(state));
+}
+
+void CheckpointRecorder::RecordRestoredState(int op_id, const std::string &operator_name,
+                                             std::string state) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto &op = ops_[op_id];
+  op.operator_name = operator_name;
+  op.states.clear();
+  if (!state.empty())
+    op.states.emplace_back(op.runs, std::move(state));
+}
+
+void CheckpointRecorder::ConsumeIteration() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  consumed_++;
+  for (auto &op : ops_) {
+    while (!op.states.empty() && op.states.front().first < consumed_)
+      op.states.pop_front();
+  }
+}
+
+Checkpoint CheckpointRecorder::GetCheckpoint() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  Checkpoint cpt;
+  cpt.iteration = consumed_;
+  for (int op_id = 0; op_id < static_cast<int>(ops_.size()); op_id++) {
+    auto &op = ops_[op_id];
+    if (op.states.empty() || op.states.front().first != consumed_)
+      continue;  // stateless
+    cpt.operators.push_back({ op_id, op.operator_name, op.states.front().second });
+  }
+  return cpt;
+}
+
+}  // namespace dali
@@ -0,0 +1,102 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_EXECUTOR_CHECKPOINT_H_
+#define DALI_PIPELINE_EXECUTOR_CHECKPOINT_H_
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/core/api_helper.h"
+
+namespace dali {
+
+/**
+ * @brief The state of a stateful operator, see OperatorBase::SaveState
+ */
+struct DLL_PUBLIC OpCheckpoint {
+  /// the id of the operator in the graph; the same for the pipelines of the same definition
+  int operator_id;
+  /// the name of the operator (not the instance name), to validate the checkpoint
+  std::string operator_name;
+  std::string state;
+};
+
+/**
+ * @brief The state of a pipeline after the outputs of `iteration` iterations were consumed
+ *
+ * Only the operators with a non-empty state are listed.
+ */
+struct DLL_PUBLIC Checkpoint {
+  int64_t iteration = 0;
+  std::vector<OpCheckpoint> operators;
+};
+
+/**
+ * @brief Keeps the states of the operators after their recent runs, so that a checkpoint
+ * matching the iterations consumed by the user can be taken.
+ *
+ * The stages of the executor run ahead of the user by up to the prefetch queue depth, so
+ * the state of an operator is kept for each run, which wasn't consumed yet, and dropped
+ * when the user takes the outputs of the iteration following it.
+ */
+class DLL_PUBLIC CheckpointRecorder {
+ public:
+  /**
+   * @brief Prepares the recorder for a graph of `num_ops` operators, starting at `iteration`
+   */
+  void Reset(int num_ops, int64_t iteration = 0);
+
+  /**
+   * @brief Records a run of the operator `op_id`, with the state after the run
+   *
+   * An empty state (a stateless operator) is not stored.
+   */
+  void RecordRun(int op_id, const std::string &operator_name, std::string state);
+
+  /**
+   * @brief Records the state, which the operator `op_id` was restored to, before it runs
+   */
+  void RecordRestoredState(int op_id, const std::string &operator_name, std::string state);
+
+  /**
+   * @brief Marks the outputs of the next iteration as consumed
+   */
+  void ConsumeIteration();
+
+  /**
+   * @brief Returns the states of the operators after the consumed iterations
+   */
+  Checkpoint GetCheckpoint() const;
+
+ private:
+  struct OpStates {
+    std::string operator_name;
+    int64_t runs = 0;
+    /// States after the runs, which weren't consumed yet, as (run count, state)
+    std::deque<std::pair<int64_t, std::string>> states;
+  };
+
+  mutable std::mutex mtx_;
+  int64_t consumed_ = 0;
+  std::vector<OpStates> ops_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_EXECUTOR_CHECKPOINT_H_
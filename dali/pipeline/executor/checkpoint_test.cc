@@ -0,0 +1,78 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include "dali/pipeline/executor/checkpoint.h"
+
+namespace dali {
+namespace test {
+
+TEST(CheckpointRecorder, RunAhead) {
+  CheckpointRecorder rec;
+  rec.Reset(3);
+  // op 0 is stateful, op 1 is stateless, op 2 is stateful; the stages run 3 iterations ahead
+  for (int run = 1; run <= 3; run++) {
+    rec.RecordRun(0, "reader", "r" + std::to_string(run));
+    rec.RecordRun(1, "resize", "");
+    rec.RecordRun(2, "rng", "g" + std::to_string(run));
+  }
+  auto cpt = rec.GetCheckpoint();
+  EXPECT_EQ(cpt.iteration, 0);
+  EXPECT_TRUE(cpt.operators.empty());
+
+  rec.ConsumeIteration();
+  rec.ConsumeIteration();
+  cpt = rec.GetCheckpoint();
+  EXPECT_EQ(cpt.iteration, 2);
+  ASSERT_EQ(cpt.operators.size(), 2u);
+  EXPECT_EQ(cpt.operators[0].operator_id, 0);
+  EXPECT_EQ(cpt.operators[0].operator_name, "reader");
+  EXPECT_EQ(cpt.operators[0].state, "r2");
+  EXPECT_EQ(cpt.operators[1].operator_id, 2);
+  EXPECT_EQ(cpt.operators[1].operator_name, "rng");
+  EXPECT_EQ(cpt.operators[1].state, "g2");
+
+  rec.RecordRun(0, "reader", "r4");
+  rec.RecordRun(1, "resize", "");
+  rec.RecordRun(2, "rng", "g4");
+  rec.ConsumeIteration();
+  cpt = rec.GetCheckpoint();
+  EXPECT_EQ(cpt.iteration, 3);
+  ASSERT_EQ(cpt.operators.size(), 2u);
+  EXPECT_EQ(cpt.operators[0].state, "r3");
+  EXPECT_EQ(cpt.operators[1].state, "g3");
+}
+
+TEST(CheckpointRecorder, Restored) {
+  CheckpointRecorder rec;
+  rec.Reset(2, 10);
+  rec.RecordRestoredState(0, "reader", "r10");
+  rec.RecordRestoredState(1, "resize", "");
+  auto cpt = rec.GetCheckpoint();
+  EXPECT_EQ(cpt.iteration, 10);
+  ASSERT_EQ(cpt.operators.size(), 1u);
+  EXPECT_EQ(cpt.operators[0].state, "r10");
+
+  rec.RecordRun(0, "reader", "r11");
+  rec.RecordRun(1, "resize", "");
+  rec.ConsumeIteration();
+  cpt = rec.GetCheckpoint();
+  EXPECT_EQ(cpt.iteration, 11);
+  ASSERT_EQ(cpt.operators.size(), 1u);
+  EXPECT_EQ(cpt.operators[0].state, "r11");
+}
+
+}  // namespace test
+}  // namespace dali
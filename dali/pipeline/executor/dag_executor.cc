@@ -0,0 +1,283 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/pipeline/executor/dag_executor.h"
+
+namespace dali {
+
+void DagExecutor::Build(OpGraph *graph, vector<string> output_names) {
+  PipelinedExecutor::Build(graph, std::move(output_names));
+
+  num_parents_.resize(graph_->NumOp());
+  for (int i = 0; i < graph_->NumOp(); i++) {
+    num_parents_[i] = graph_->Node(i).parents.size();
+  }
+
+  AssignGPUStreams();
+}
+
+void DagExecutor::AssignGPUStreams() {
+  int num_gpu_ops = graph_->NumOp(OpType::GPU);
+  gpu_op_streams_.assign(num_gpu_ops, gpu_op_stream_);
+  if (device_id_ == CPU_ONLY_DEVICE_ID || num_gpu_ops == 0)
+    return;
+
+  DeviceGuard g(device_id_);
+  std::vector<cudaStream_t> streams = { gpu_op_stream_ };
+  // whether the stream of given GPU operator was already passed on to one of its children
+  std::vector<bool> inherited(num_gpu_ops, false);
+  bool main_stream_used = false;
+  int next_reused = 0;
+
+  // The partition is topologically sorted, so the parents are always assigned first
+  for (int i = 0; i < num_gpu_ops; i++) {
+    auto &node = graph_->Node(OpType::GPU, i);
+    cudaStream_t stream = nullptr;
+    bool assigned = false;
+    // Continue the stream of the first GPU parent which didn't pass it on yet
+    for (auto parent_id : node.parents) {
+      if (graph_->NodeType(parent_id) != OpType::GPU)
+        continue;
+      auto parent_idx = graph_->Node(parent_id).partition_index;
+      if (!inherited[parent_idx]) {
+        inherited[parent_idx] = true;
+        stream = gpu_op_streams_[parent_idx];
+        assigned = true;
+        break;
+      }
+    }
+    if (!assigned) {
+      if (!main_stream_used) {
+        stream = gpu_op_stream_;
+        main_stream_used = true;
+      } else if (max_num_stream_ <= 0 || static_cast<int>(streams.size()) < max_num_stream_) {
+        extra_streams_.push_back(
+            CUDAStreamPool::instance().Get(device_id_, default_cuda_stream_priority_));
+        join_events_.push_back(event_pool_.GetEvent());
+        stream = extra_streams_.back();
+        streams.push_back(stream);
+      } else {
+        stream = streams[next_reused++ % streams.size()];
+      }
+    }
+    gpu_op_streams_[i] = stream;
+    gpu_op_events_.push_back(event_pool_.GetEvent());
+  }
+
+  for (int q = 0; q < stage_queue_depths_[OpType::GPU]; q++) {
+    for (int i = 0; i < num_gpu_ops; i++) {
+      auto &ws = ws_policy_.template GetWorkspace<OpType::GPU>(QueueIdxs{q}, *graph_, i);
+      ws.set_stream(gpu_op_streams_[i]);
+    }
+  }
+}
+
+void DagExecutor::Shutdown() {
+  ShutdownQueue();
+  device_thread_.ForceStop();
+  dag_cv_.notify_all();
+  device_thread_.Shutdown();
+  if (device_id_ != CPU_ONLY_DEVICE_ID) {
+    DeviceGuard dg(device_id_);
+    for (auto &stream : extra_streams_)
+      CUDA_DTOR_CALL(cudaStreamSynchronize(stream));
+  }
+  PipelinedExecutor::Shutdown();
+}
+
+void DagExecutor::RunCPU() {
+  try {
+    RunIteration();
+  } catch (std::exception &e) {
+    HandleError(make_string("Exception in DAG executor: ", e.what()));
+  } catch (...) {
+    HandleError("Unknown error in DAG executor.");
+  }
+}
+
+void DagExecutor::RunIteration() {
+  if (device_id_ < 0) {
+    DALI_ENFORCE(device_id_ == CPU_ONLY_DEVICE_ID,
+                 "Wrong device_id provided, it should be >= 0, "
+                 "or equal to CPU_ONLY_DEVICE_ID.");
+    DALI_ENFORCE(graph_->NumOp(OpType::GPU) == 0 && graph_->NumOp(OpType::MIXED) == 0,
+                 "Cannot run a pipeline with Mixed/GPU ops in CPU-only mode. Please provide "
+                 "valid device id or change the operators' device.");
+  }
+
+  DomainTimeRange tr("[DALI][DagExecutor] Run");
+  DeviceGuard g(device_id_);
+
+  // The same buffers are used by all the stages of the iteration
+  auto idxs = AcquireIdxs(OpType::CPU);
+  if (exec_error_ || IsStopSignaled() || !AreValid<OpType::CPU>(idxs)) {
+    return;
+  }
+
+  int batch_size = InferBatchSize(batch_size_providers_);
+
+  {
+    std::lock_guard<std::mutex> lock(dag_mutex_);
+    remaining_parents_ = num_parents_;
+    cpu_pending_ = graph_->NumOp(OpType::CPU);
+    device_pending_ = graph_->NumOp(OpType::MIXED) + graph_->NumOp(OpType::GPU);
+    for (int i = 0; i < graph_->NumOp(); i++) {
+      if (remaining_parents_[i] == 0) {
+        auto &queue = graph_->NodeType(i) == OpType::CPU ? cpu_ready_ : device_ready_;
+        queue.push(i);
+      }
+    }
+  }
+
+  bool has_device_ops = device_pending_ > 0;
+  if (has_device_ops) {
+    device_thread_.DoWork([this, idxs, batch_size]() {
+      try {
+        // Enforce our assumed dependency between consecutive iterations
+        CUDA_CALL(cudaEventSynchronize(mixed_stage_event_));
+        CUDA_CALL(cudaEventSynchronize(gpu_stage_event_));
+      } catch (std::exception &e) {
+        HandleError(make_string("Exception in DAG executor: ", e.what()));
+        dag_cv_.notify_all();
+      }
+      RunReadyOps(device_ready_, device_pending_, idxs, batch_size);
+    });
+  }
+  RunReadyOps(cpu_ready_, cpu_pending_, idxs, batch_size);
+  if (has_device_ops) {
+    device_thread_.WaitForWork();
+  }
+
+  FinishIteration(idxs);
+}
+
+void DagExecutor::RunReadyOps(std::queue<OpNodeId> &ready, int &pending, QueueIdxs idxs,
+                              int batch_size) {
+  while (true) {
+    OpNodeId op_id;
+    {
+      std::unique_lock<std::mutex> lock(dag_mutex_);
+      dag_cv_.wait(lock, [&]() {
+        return !ready.empty() || pending == 0 || exec_error_ || IsStopSignaled();
+      });
+      if (pending == 0 || exec_error_ || IsStopSignaled()) {
+        std::queue<OpNodeId>().swap(ready);
+        return;
+      }
+      op_id = ready.front();
+      ready.pop();
+    }
+
+    auto &op_node = graph_->Node(op_id);
+    RunOp(op_node, idxs, batch_size);
+
+    {
+      std::lock_guard<std::mutex> lock(dag_mutex_);
+      pending--;
+      for (auto child_id : op_node.children) {
+        if (--remaining_parents_[child_id] == 0) {
+          auto &queue = graph_->NodeType(child_id) == OpType::CPU ? cpu_ready_ : device_ready_;
+          queue.push(child_id);
+        }
+      }
+    }
+    dag_cv_.notify_all();
+  }
+}
+
+void DagExecutor::RunOp(OpNode &op_node, QueueIdxs idxs, int batch_size) {
+  switch (op_node.op_type) {
+    case OpType::CPU:
+      RunCPUOp(op_node, idxs, batch_size);
+      break;
+    case OpType::MIXED:
+      RunMixedOp(op_node, idxs, batch_size);
+      break;
+    case OpType::GPU: {
+      int idx = op_node.partition_index;
+      cudaStream_t stream = gpu_op_streams_[idx];
+      try {
+        for (auto parent_id : op_node.parents) {
+          if (graph_->NodeType(parent_id) != OpType::GPU)
+            continue;
+          auto parent_idx = graph_->Node(parent_id).partition_index;
+          if (gpu_op_streams_[parent_idx] != stream)
+            CUDA_CALL(cudaStreamWaitEvent(stream, gpu_op_events_[parent_idx], 0));
+        }
+      } catch (std::exception &e) {
+        HandleError("GPU", op_node, e.what());
+        return;
+      }
+      RunGPUOp(op_node, idxs, batch_size);
+      try {
+        CUDA_CALL(cudaEventRecord(gpu_op_events_[idx], stream));
+      } catch (std::exception &e) {
+        HandleError("GPU", op_node, e.what());
+      }
+      break;
+    }
+    default:
+      DALI_FAIL("Invalid op type");
+  }
+}
+
+void DagExecutor::FinishIteration(QueueIdxs idxs) {
+  // short path for pure CPU pipeline
+  if (device_id_ == CPU_ONLY_DEVICE_ID) {
+    QueueOutputIdxs(idxs, gpu_op_stream_);
+    if (callback_) {
+      callback_();
+    }
+    return;
+  }
+
+  // All the work of this iteration is now ordered before the work in gpu_op_stream_
+  for (size_t i = 0; i < extra_streams_.size(); i++) {
+    CUDA_CALL(cudaEventRecord(join_events_[i], extra_streams_[i]));
+    CUDA_CALL(cudaStreamWaitEvent(gpu_op_stream_, join_events_[i], 0));
+  }
+
+  if (callback_) {
+    CUDA_CALL(cudaEventRecord(mixed_callback_events_[idxs[OpType::MIXED]], mixed_op_stream_));
+  }
+  if (!mixed_output_events_.empty()) {
+    int queue_id = idxs[OpType::MIXED];
+    CUDA_CALL(cudaEventRecord(mixed_output_events_.GetEvent(queue_id), mixed_op_stream_));
+  }
+  CUDA_CALL(cudaEventRecord(mixed_stage_event_, mixed_op_stream_));
+
+  if (!gpu_output_events_.empty()) {
+    int queue_id = idxs[OpType::GPU];
+    CUDA_CALL(cudaEventRecord(gpu_output_events_.GetEvent(queue_id), gpu_op_stream_));
+  }
+  if (callback_) {
+    CUDA_CALL(
+        cudaStreamWaitEvent(gpu_op_stream_, mixed_callback_events_[idxs[OpType::MIXED]], 0));
+  }
+  CUDA_CALL(cudaEventRecord(gpu_stage_event_, gpu_op_stream_));
+
+  QueueOutputIdxs(idxs, gpu_op_stream_);
+
+  // scheduled after the outputs are queued, so that they can be shared when it's called
+  if (callback_) {
+    CUDA_CALL(cudaStreamAddCallback(gpu_op_stream_, &detail::gpu_finished_callback,
+                                    static_cast<void *>(&callback_), 0));
+  }
+}
+
+}  // namespace dali
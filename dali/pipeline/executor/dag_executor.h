@@ -0,0 +1,149 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_EXECUTOR_DAG_EXECUTOR_H_
+#define DALI_PIPELINE_EXECUTOR_DAG_EXECUTOR_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/core/cuda_stream_pool.h"
+#include "dali/core/error_handling.h"
+#include "dali/pipeline/executor/pipelined_executor.h"
+#include "dali/pipeline/util/worker_thread.h"
+
+namespace dali {
+
+/**
+ * @brief Executor which runs the OpGraph as a dependency DAG instead of three
+ * consecutive stages.
+ *
+ * Each operator is started as soon as all of its parents are done, regardless of the stage
+ * it belongs to. The CPU operators are run by the thread calling RunCPU (one at a time, since
+ * they share the executor's thread pool), while the Mixed and GPU operators are issued
+ * concurrently by a separate worker thread - this way, e.g. a decoder can already work on the
+ * image branch of the graph while the CPU operators of the label branch are still running.
+ *
+ * GPU operators on independent branches are issued to separate CUDA streams (up to
+ * `max_num_stream`, if positive), with events introducing the dependencies between the streams.
+ * A linear chain of GPU operators stays on a single stream.
+ *
+ * The whole iteration is run by RunCPU; RunMixed and RunGPU are no-ops.
+ */
+class DLL_PUBLIC DagExecutor : public PipelinedExecutor {
+ public:
+  DLL_PUBLIC inline DagExecutor(int batch_size, int num_thread, int device_id,
+                                size_t bytes_per_sample_hint, bool set_affinity = false,
+                                int max_num_stream = -1, int default_cuda_stream_priority = 0,
+                                QueueSizes prefetch_queue_depth = QueueSizes{2, 2})
+      : PipelinedExecutor(batch_size, num_thread, device_id, bytes_per_sample_hint, set_affinity,
+                          max_num_stream, default_cuda_stream_priority, prefetch_queue_depth),
+        max_num_stream_(max_num_stream),
+        device_thread_(device_id, set_affinity, "DAG device executor") {}
+
+  DLL_PUBLIC ~DagExecutor() override {
+    Shutdown();
+  }
+
+  DLL_PUBLIC void Build(OpGraph *graph, vector<string> output_names) override;
+
+  DLL_PUBLIC void Init() override {
+    if (!device_thread_.WaitForInit()) {
+      device_thread_.ForceStop();
+      std::string error = "Failed to init pipeline on device " + std::to_string(device_id_);
+      throw std::runtime_error(error);
+    }
+  }
+
+  DLL_PUBLIC void RunCPU() override;
+
+  DLL_PUBLIC void RunMixed() override {}
+
+  DLL_PUBLIC void RunGPU() override {}
+
+  DLL_PUBLIC void Shutdown() override;
+
+  /**
+   * @brief Returns the number of distinct CUDA streams used by the GPU operators
+   */
+  DLL_PUBLIC int NumGPUStreams() const {
+    return gpu_op_stream_ ? 1 + extra_streams_.size() : 0;
+  }
+
+  /**
+   * @brief Returns the stream used by the GPU operator with given partition index
+   */
+  DLL_PUBLIC cudaStream_t GPUOpStream(OpPartitionId partition_idx) const {
+    return gpu_op_streams_[partition_idx];
+  }
+
+  DISABLE_COPY_MOVE_ASSIGN(DagExecutor);
+
+ protected:
+  void RunIteration();
+
+  // the operators of a stage run concurrently
+  bool SupportsBufferReuse() const override {
+    return false;
+  }
+
+  /**
+   * @brief Assigns the streams to the GPU operators and updates their workspaces
+   */
+  void AssignGPUStreams();
+
+  /**
+   * @brief Runs the operators from `ready` until all `pending` ones are done
+   *
+   * Both `ready` and `pending` are guarded by dag_mutex_.
+   */
+  void RunReadyOps(std::queue<OpNodeId> &ready, int &pending, QueueIdxs idxs, int batch_size);
+
+  void RunOp(OpNode &op_node, QueueIdxs idxs, int batch_size);
+
+  /**
+   * @brief Joins the GPU streams, records the output events and makes the outputs available
+   */
+  void FinishIteration(QueueIdxs idxs);
+
+  int max_num_stream_;
+
+  // OpNodeId -> number of parents
+  std::vector<int> num_parents_;
+
+  // GPU partition index -> stream and the event recorded after the operator was issued
+  std::vector<cudaStream_t> gpu_op_streams_;
+  std::vector<cudaEvent_t> gpu_op_events_;
+
+  // streams used by GPU operators in addition to gpu_op_stream_ and the events used to join
+  // them back at the end of the iteration
+  std::vector<CUDAStreamLease> extra_streams_;
+  std::vector<cudaEvent_t> join_events_;
+
+  std::mutex dag_mutex_;
+  std::condition_variable dag_cv_;
+  std::vector<int> remaining_parents_;
+  std::queue<OpNodeId> cpu_ready_, device_ready_;
+  int cpu_pending_ = 0, device_pending_ = 0;
+
+  WorkerThread device_thread_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_EXECUTOR_DAG_EXECUTOR_H_
@@ -20,6 +20,8 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "dali/core/allocation_counter.h"
+#include "dali/core/tracer.h"
 #include "dali/pipeline/executor/executor.h"
 #include "dali/pipeline/executor/queue_metadata.h"
 #include "dali/pipeline/graph/op_graph_storage.h"
@@ -28,6 +30,137 @@
 
 namespace dali {
 
+namespace {
+
+/**
+ * @brief Makes `out` use the memory of `in`, for the in-place execution;
+ * possible only for the batches of the same kind.
+ */
+template <typename Batch>
+bool ShareInPlace(Batch &out, const Batch &in) {
+  out.ShareData(in);
+  return true;
+}
+
+template <typename OutBatch, typename InBatch>
+bool ShareInPlace(OutBatch &, const InBatch &) {
+  return false;
+}
+
+/**
+ * @brief Infers the batch size of an operator from its inputs
+ *
+ * The operators in a conditional branch process only the samples routed to that branch, so
+ * the batch size is taken from the first input or, if there are no regular inputs, from
+ * the first argument input. The operators which declare a non-uniform batch
+ * (see OpSchema::NonUniformBatch) take it from the argument inputs first. Only the operators
+ * without any inputs produce the full batch of the iteration.
+ */
+template <typename Workspace>
+int OpBatchSize(const Workspace &ws, const OpSchema &schema, int stage_batch_size) {
+  if (ws.NumInput() > 0 && !schema.IsNonUniformBatch())
+    return ws.GetInputBatchSize(0);
+  const ArgumentWorkspace &arg_ws = ws;
+  for (const auto &arg : arg_ws)
+    return ws.ArgumentInput(arg.second).num_samples();
+  return ws.NumInput() > 0 ? ws.GetInputBatchSize(0) : stage_batch_size;
+}
+
+/**
+ * @brief Tells whether the samples of the batch are stored one after another, without gaps
+ */
+template <typename Backend>
+bool IsDenselyPacked(const TensorList<Backend> &batch) {
+  Index offset = 0;
+  for (int i = 0; i < batch.num_samples(); i++) {
+    if (batch.tensor_offset(i) != offset)
+      return false;
+    offset += volume(batch.tensor_shape_span(i));
+  }
+  return true;
+}
+
+/**
+ * @brief Returns a batch which views the samples [begin, end) of the densely packed `batch`
+ *
+ * The view is densely packed as well, so it can be used by the code which accesses
+ * the whole allocation of a batch.
+ */
+template <typename Backend>
+shared_ptr<TensorList<Backend>> SubBatch(TensorList<Backend> &batch, int begin, int end) {
+  int nsamples = end - begin;
+  TensorListShape<> shape(nsamples, batch.sample_dim());
+  for (int i = 0; i < nsamples; i++)
+    shape.set_tensor_shape(i, batch.tensor_shape(begin + i));
+  auto sub = std::make_shared<TensorList<Backend>>();
+  sub->ShareData(unsafe_sample_owner(batch, begin), shape.num_elements() * batch.type_info().size(),
+                 batch.is_pinned(), shape, batch.type(), batch.order());
+  sub->SetLayout(batch.GetLayout());
+  for (int i = 0; i < nsamples; i++)
+    sub->SetMeta(i, batch.GetMeta(begin + i));
+  return sub;
+}
+
+shared_ptr<TensorVector<CPUBackend>> SubBatch(const TensorVector<CPUBackend> &batch, int begin,
+                                              int end) {
+  auto sub = std::make_shared<TensorVector<CPUBackend>>();
+  sub->SetupLike(batch);
+  sub->SetSize(end - begin);
+  for (int i = begin; i < end; i++)
+    sub->UnsafeSetSample(i - begin, batch, i);
+  return sub;
+}
+
+/**
+ * @brief Gives back the scratch buffer of the stage and waits for the work in flight, so that
+ * the memory freed in stream order becomes available.
+ */
+template <typename Workspace>
+void ReleaseCachedMemory(Workspace &ws, kernels::ScratchArena *arena) {
+  if (arena)
+    arena->Release();
+  if (ws.has_stream())
+    CUDA_CALL(cudaStreamSynchronize(ws.stream()));
+}
+
+/**
+ * @brief Makes all the outputs of the workspace empty batches, keeping their allocations
+ *
+ * Used instead of running an operator of a conditional branch to which no samples were routed.
+ */
+template <typename Workspace>
+void ClearOutputs(Workspace &ws) {
+  auto clear = [](auto &out) {
+    int ndim = out.shape().sample_dim();
+    if (IsValidType(out.type()) && ndim >= 0)
+      out.Resize(TensorListShape<>(0, ndim), out.type());
+    else
+      out.Reset();
+  };
+  for (int i = 0; i < ws.NumOutput(); i++) {
+    if (ws.template OutputIsType<CPUBackend>(i))
+      clear(ws.template Output<CPUBackend>(i));
+    else
+      clear(ws.template Output<GPUBackend>(i));
+  }
+}
+
+/**
+ * @brief Appends the type, the shape and the sample addresses of the batch to the signature
+ */
+template <typename Batch>
+void AppendSignature(std::vector<intptr_t> &signature, const Batch &batch) {
+  const auto &shape = batch.shape();
+  signature.push_back(batch.type());
+  signature.push_back(shape.num_samples());
+  signature.push_back(shape.sample_dim());
+  signature.insert(signature.end(), shape.shapes.begin(), shape.shapes.end());
+  for (int i = 0; i < shape.num_samples(); i++)
+    signature.push_back(reinterpret_cast<intptr_t>(batch.raw_tensor(i)));
+}
+
+}  // namespace
+
 template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::PreRun() {
   auto batch_size = InferBatchSize(batch_size_providers_);
@@ -79,7 +212,12 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunCPUImpl() {
 
   DeviceGuard g(device_id_);
 
+  bool timed = enable_operator_timing_;
+  auto start = TimingCollector::Clock::now();
   auto cpu_idxs = QueuePolicy::AcquireIdxs(OpType::CPU);
+  auto acquired = TimingCollector::Clock::now();
+  AllocationCounter allocations;
+  int64_t pool_allocations = thread_pool_->NumAllocations();
   if (exec_error_ || QueuePolicy::IsStopSignaled() ||
       !QueuePolicy::template AreValid<OpType::CPU>(cpu_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::CPU, cpu_idxs);
@@ -89,24 +227,31 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunCPUImpl() {
   auto batch_size = batch_sizes_cpu_.front();
   batch_sizes_cpu_.pop();
 
+  // The buffers might have been read asynchronously by the consumer of the previous outputs
+  WaitForOutputRelease(OpType::CPU, cpu_idxs[OpType::CPU]);
+
   // Run the cpu-ops in the thread
   // Process each CPU Op in batch
-  for (int cpu_op_id = 0; cpu_op_id < graph_->NumOp(OpType::CPU) && !exec_error_; ++cpu_op_id) {
-    OpNode &op_node = graph_->Node(OpType::CPU, cpu_op_id);
-    auto ws = ws_policy_.template GetWorkspace<OpType::CPU>(cpu_idxs, *graph_, cpu_op_id);
-
-    ws.SetBatchSizes(batch_size);
+  for (int cpu_op_id = 0; cpu_op_id < graph_->NumOp(OpType::CPU) && !exec_error_;) {
+    if (!cpu_chain_len_.empty() && cpu_chain_len_[cpu_op_id] > 1) {
+      cpu_op_id += RunCPUChain(cpu_op_id, cpu_idxs, batch_size);
+      continue;
+    }
+    RunCPUOp(graph_->Node(OpType::CPU, cpu_op_id), cpu_idxs, batch_size);
+    ++cpu_op_id;
+  }
 
-    DomainTimeRange tr("[DALI][CPU op] " + op_node.instance_name, DomainTimeRange::kBlue1);
+  if (adaptive_queue_depth_) {
+    QueuePolicy::SetSlotBytes(OpType::CPU, QueueSlotBytes(OpType::CPU, cpu_idxs[OpType::CPU]));
+  }
 
-    try {
-      RunHelper(op_node, ws);
-      FillStats(cpu_memory_stats_, ws, "CPU_" + op_node.instance_name, cpu_memory_stats_mutex_);
-    } catch (std::exception &e) {
-      HandleError("CPU", op_node, e.what());
-    } catch (...) {
-      HandleError();
-    }
+  // Recorded before the release, so that the batch is never consumed before it's counted
+  if (timed) {
+    timing_.AddStageIteration(OpType::CPU, batch_size, start, acquired);
+    // the jobs of the thread pool are issued by the CPU operators
+    if (AllocationCountingEnabled())
+      timing_.AddStageAllocations(OpType::CPU, allocations.count() +
+                                               thread_pool_->NumAllocations() - pool_allocations);
   }
 
   // Pass the work to the mixed stage
@@ -119,50 +264,43 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunMixedImpl() {
   DomainTimeRange tr("[DALI][Executor] RunMixed");
   DeviceGuard g(device_id_);
 
+  bool timed = enable_operator_timing_;
+  auto start = TimingCollector::Clock::now();
   auto mixed_idxs = QueuePolicy::AcquireIdxs(OpType::MIXED);
+  auto acquired = TimingCollector::Clock::now();
+  AllocationCounter allocations;
   if (exec_error_ || QueuePolicy::IsStopSignaled() ||
      !QueuePolicy::template AreValid<OpType::MIXED>(mixed_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::MIXED, mixed_idxs);
     return;
   }
+  if (timed)
+    timing_.ConsumeStageOutput(OpType::CPU);
 
   // short path for pure CPU pipeline
   if (device_id_ == CPU_ONLY_DEVICE_ID) {
-    if (callback_) {
-      callback_();
-    }
     // We do not release, but handle to used outputs
     QueuePolicy::ReleaseIdxs(OpType::MIXED, mixed_idxs, mixed_op_stream_);
     return;
   }
 
   // Enforce our assumed dependency between consecutive
-  // iterations of a stage of the pipeline.
-
-  CUDA_CALL(cudaEventSynchronize(mixed_stage_event_));
+  // iterations of a stage of the pipeline. With the iteration overlap, the GPU work
+  // of the previous iteration may be still in progress, but not the one before it.
+  CUDA_CALL(cudaEventSynchronize(mixed_iteration_overlap_ ? prev_mixed_stage_event_
+                                                          : mixed_stage_event_));
+  WaitForOutputRelease(OpType::MIXED, mixed_idxs[OpType::MIXED]);
 
   auto batch_size = batch_sizes_mixed_.front();
   batch_sizes_mixed_.pop();
 
-  for (int i = 0; i < graph_->NumOp(OpType::MIXED) && !exec_error_; ++i) {
-    OpNode &op_node = graph_->Node(OpType::MIXED, i);
-    try {
-      auto ws = ws_policy_.template GetWorkspace<OpType::MIXED>(mixed_idxs, *graph_, i);
-
-      ws.SetBatchSizes(batch_size);
-
-      DomainTimeRange tr("[DALI][Mixed op] " + op_node.instance_name, DomainTimeRange::kOrange);
-      RunHelper(op_node, ws);
-      FillStats(mixed_memory_stats_, ws, "MIXED_" + op_node.instance_name,
-                mixed_memory_stats_mutex_);
-      if (ws.has_stream() && ws.has_event()) {
-        CUDA_CALL(cudaEventRecord(ws.event(), ws.stream()));
-      }
-      CUDA_CALL(cudaGetLastError());
-    } catch (std::exception &e) {
-      HandleError("Mixed", op_node, e.what());
-    } catch (...) {
-      HandleError();
+  {
+    // The operators of a stage run one after another in the stage's stream - the scratch memory
+    // used by one of them can be reused by the next one without waiting
+    kernels::ScratchArenaScope arena_scope(mixed_scratch_arena_.get());
+    for (int i = 0; i < graph_->NumOp(OpType::MIXED) && !exec_error_; ++i) {
+      RunMixedOp(graph_->Node(OpType::MIXED, i), mixed_idxs, batch_size);
+      mixed_scratch_arena_->Reset();
     }
   }
 
@@ -178,8 +316,16 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunMixedImpl() {
   }
 
   // We know that this is the proper stream, we do not need to look it up in any workspace
+  if (mixed_iteration_overlap_)
+    std::swap(prev_mixed_stage_event_, mixed_stage_event_);
   CUDA_CALL(cudaEventRecord(mixed_stage_event_, mixed_op_stream_));
 
+  if (timed) {
+    timing_.AddStageIteration(OpType::MIXED, batch_size, start, acquired);
+    if (AllocationCountingEnabled())
+      timing_.AddStageAllocations(OpType::MIXED, allocations.count());
+  }
+
   // Pass the work to the gpu stage
   QueuePolicy::ReleaseIdxs(OpType::MIXED, mixed_idxs, mixed_op_stream_);
 }
@@ -189,17 +335,26 @@ template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::RunGPUImpl() {
   DomainTimeRange tr("[DALI][Executor] RunGPU");
 
+  bool timed = enable_operator_timing_;
+  auto start = TimingCollector::Clock::now();
   auto gpu_idxs = QueuePolicy::AcquireIdxs(OpType::GPU);
+  auto acquired = TimingCollector::Clock::now();
+  AllocationCounter allocations;
   if (exec_error_ || QueuePolicy::IsStopSignaled() ||
       !QueuePolicy::template AreValid<OpType::GPU>(gpu_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::GPU, gpu_idxs);
     return;
   }
+  if (timed)
+    timing_.ConsumeStageOutput(OpType::MIXED);
 
   // short path for pure CPU pipeline
   if (device_id_ == CPU_ONLY_DEVICE_ID) {
     // We do not release, but handle to used outputs
     QueuePolicy::QueueOutputIdxs(gpu_idxs, gpu_op_stream_);
+    if (callback_) {
+      callback_();
+    }
     return;
   }
   DeviceGuard g(device_id_);
@@ -207,35 +362,17 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunGPUImpl() {
   // Enforce our assumed dependency between consecutive
   // iterations of a stage of the pipeline.
   CUDA_CALL(cudaEventSynchronize(gpu_stage_event_));
+  WaitForOutputRelease(OpType::GPU, gpu_idxs[OpType::GPU]);
 
   auto batch_size = batch_sizes_gpu_.front();
   batch_sizes_gpu_.pop();
 
-  for (int i = 0; i < graph_->NumOp(OpType::GPU) && !exec_error_; ++i) {
-    OpNode &op_node = graph_->Node(OpType::GPU, i);
-    try {
-      auto ws = ws_policy_.template GetWorkspace<OpType::GPU>(gpu_idxs, *graph_, i);
-
-      ws.SetBatchSizes(batch_size);
-
-      auto parent_events = ws.ParentEvents();
-
-      for (auto &event : parent_events) {
-        CUDA_CALL(cudaStreamWaitEvent(ws.stream(), event, 0));
-      }
-
-      DomainTimeRange tr("[DALI][GPU op] " + op_node.instance_name, DomainTimeRange::knvGreen);
-      RunHelper(op_node, ws);
-      FillStats(gpu_memory_stats_, ws, "GPU_" + op_node.instance_name, gpu_memory_stats_mutex_);
-      if (ws.has_event()) {
-        CUDA_CALL(cudaEventRecord(ws.event(), ws.stream()));
-      }
-      CUDA_CALL(cudaGetLastError());
-    } catch (std::exception &e) {
-      HandleError("GPU", op_node, e.what());
-    } catch (...) {
-      HandleError();
-    }
+  {
+    kernels::ScratchArenaScope arena_scope(gpu_scratch_arena_.get());
+    if (gpu_stage_capturable_)
+      RunGPUStageGraph(gpu_idxs, batch_size);
+    else
+      RunGPUStageEager(gpu_idxs, batch_size);
   }
 
   // Update the ready queue to signal that all the work
@@ -248,19 +385,456 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunGPUImpl() {
     CUDA_CALL(cudaEventRecord(gpu_output_events_.GetEvent(queue_id), gpu_op_stream_));
   }
 
-  // Schedule the call to any callback registered previously
   if (callback_) {
     CUDA_CALL(
         cudaStreamWaitEvent(gpu_op_stream_, mixed_callback_events_[gpu_idxs[OpType::MIXED]], 0));
-    CUDA_CALL(cudaStreamAddCallback(gpu_op_stream_, &detail::gpu_finished_callback,
-                                    static_cast<void *>(&callback_), 0));
   }
 
   // We know that this is the proper stream, we do not need to look it up in any workspace
   CUDA_CALL(cudaEventRecord(gpu_stage_event_, gpu_op_stream_));
 
+  if (adaptive_queue_depth_) {
+    QueuePolicy::SetSlotBytes(OpType::GPU, QueueSlotBytes(OpType::MIXED, gpu_idxs[OpType::MIXED]) +
+                                           QueueSlotBytes(OpType::GPU, gpu_idxs[OpType::GPU]));
+  }
+
+  if (timed) {
+    timing_.AddStageIteration(OpType::GPU, batch_size, start, acquired);
+    if (AllocationCountingEnabled())
+      timing_.AddStageAllocations(OpType::GPU, allocations.count());
+  }
+
   // We do not release, but handle to used outputs
   QueuePolicy::QueueOutputIdxs(gpu_idxs, gpu_op_stream_);
+
+  // Schedule the call to any callback registered previously; it's scheduled after the outputs
+  // are queued, so that they can be shared without waiting when it's called
+  if (callback_) {
+    CUDA_CALL(cudaStreamAddCallback(gpu_op_stream_, &detail::gpu_finished_callback,
+                                    static_cast<void *>(&callback_), 0));
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunGPUStageEager(QueueIdxs idxs, int batch_size) {
+  for (int i = 0; i < graph_->NumOp(OpType::GPU) && !exec_error_; ++i) {
+    RunGPUOp(graph_->Node(OpType::GPU, i), idxs, batch_size);
+    gpu_scratch_arena_->Reset();
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunGPUStageGraph(QueueIdxs idxs, int batch_size) {
+  // the batch sizes other than the buckets share a graph, which is captured again as they change
+  int bucket =
+      std::binary_search(batch_size_buckets_.begin(), batch_size_buckets_.end(), batch_size)
+          ? batch_size : 0;
+  auto &stage = gpu_stage_graphs_[std::make_tuple(idxs[OpType::MIXED], idxs[OpType::GPU], bucket)];
+  int num_ops = graph_->NumOp(OpType::GPU);
+  auto &signature = gpu_stage_signature_;
+  try {
+    // The dependencies on the mixed stage are not a part of the graph
+    for (int i = 0; i < num_ops; i++) {
+      auto &ws = ws_policy_.template GetWorkspace<OpType::GPU>(idxs, *graph_,
+                                                                graph_->Node(OpType::GPU, i));
+      for (auto &event : ws.ParentEvents())
+        CUDA_CALL(cudaStreamWaitEvent(gpu_op_stream_, event, 0));
+    }
+
+    if (stage.exec) {
+      // The operators are set up (which resizes their outputs), but their work is replayed
+      for (int i = 0; i < num_ops; i++) {
+        RunGPUOpImpl(graph_->Node(OpType::GPU, i), idxs, batch_size, false,
+                     OpRunSteps::SetupOnly, &stage.layouts[i]);
+      }
+      GetGPUStageSignature(signature, idxs);
+      if (signature == stage.signature) {
+        CUDA_CALL(cudaGraphLaunch(stage.exec, gpu_op_stream_));
+        if (enable_operator_timing_)
+          timing_.AddGraphLaunch(OpType::GPU, false);
+        return;
+      }
+      // The graph refers to other memory or shapes - it's captured again when the new
+      // signature proves stable
+      CUDA_CALL(cudaStreamSynchronize(gpu_op_stream_));
+      stage.Reset();
+    } else if (stage.stable_runs >= kCudaGraphWarmupRuns) {
+      // The operators are set up (which allocates their outputs) before the capture, so that
+      // only their work is captured - and only if this iteration has the stable signature, too.
+      // Otherwise, they run eagerly, where they can be retried when out of memory.
+      bool stable = true;
+      try {
+        for (int i = 0; i < num_ops; i++) {
+          RunGPUOpImpl(graph_->Node(OpType::GPU, i), idxs, batch_size, false,
+                       OpRunSteps::SetupOnly);
+        }
+        GetGPUStageSignature(signature, idxs);
+        stable = signature == stage.signature;
+      } catch (const CUDABadAlloc &) {
+        stable = false;
+      }
+      if (stable) {
+        cudaGraph_t graph = nullptr;
+        std::string error;
+        bool captured =
+            cudaStreamBeginCapture(gpu_op_stream_, cudaStreamCaptureModeRelaxed) == cudaSuccess;
+        if (captured) {
+          try {
+            kernels::ScratchCaptureScope capture_scope(&stage.scratch);
+            for (int i = 0; i < num_ops; i++) {
+              RunGPUOpImpl(graph_->Node(OpType::GPU, i), idxs, batch_size, false,
+                           OpRunSteps::RunOnly);
+            }
+          } catch (std::exception &e) {
+            error = e.what();
+            captured = false;
+          }
+          // the capture must end, even if it failed
+          captured = cudaStreamEndCapture(gpu_op_stream_, &graph) == cudaSuccess && captured;
+        }
+        if (captured) {
+          captured = cudaGraphInstantiate(&stage.exec, graph, nullptr, nullptr, 0) == cudaSuccess;
+        }
+        if (graph)
+          CUDA_CALL(cudaGraphDestroy(graph));
+        if (captured) {
+          GetGPUStageLayouts(stage.layouts, idxs);
+          CUDA_CALL(cudaGraphLaunch(stage.exec, gpu_op_stream_));
+          if (enable_operator_timing_)
+            timing_.AddGraphLaunch(OpType::GPU, true);
+          return;
+        }
+        // The work wasn't issued - it's run without the graph; no capture is attempted again
+        (void)cudaGetLastError();
+        DALI_WARN("The GPU stage couldn't be captured in a CUDA graph - CUDA graphs are "
+                  "disabled. ", error);
+        stage.Reset();
+        gpu_stage_capturable_ = false;
+      }
+    }
+  } catch (std::exception &e) {
+    HandleError(make_string("Error when running the GPU stage in a CUDA graph:\n", e.what()));
+    return;
+  }
+
+  RunGPUStageEager(idxs, batch_size);
+  if (exec_error_ || !gpu_stage_capturable_)
+    return;
+  GetGPUStageSignature(signature, idxs);
+  if (signature == stage.signature) {
+    stage.stable_runs++;
+  } else {
+    stage.signature.swap(signature);
+    stage.stable_runs = 0;
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::GetGPUStageSignature(
+    std::vector<intptr_t> &signature, QueueIdxs idxs) {
+  signature.clear();
+  for (int i = 0; i < graph_->NumOp(OpType::GPU); i++) {
+    auto &ws = ws_policy_.template GetWorkspace<OpType::GPU>(idxs, *graph_,
+                                                              graph_->Node(OpType::GPU, i));
+    // the capturable stage has only GPU inputs and outputs
+    for (int in = 0; in < ws.NumInput(); in++)
+      AppendSignature(signature, ws.template Input<GPUBackend>(in));
+    for (int out = 0; out < ws.NumOutput(); out++)
+      AppendSignature(signature, ws.template Output<GPUBackend>(out));
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::GetGPUStageLayouts(
+    std::vector<SmallVector<TensorLayout, 4>> &layouts, QueueIdxs idxs) {
+  int num_ops = graph_->NumOp(OpType::GPU);
+  layouts.resize(num_ops);
+  for (int i = 0; i < num_ops; i++) {
+    auto &ws = ws_policy_.template GetWorkspace<OpType::GPU>(idxs, *graph_,
+                                                              graph_->Node(OpType::GPU, i));
+    layouts[i].clear();
+    for (int out = 0; out < ws.NumOutput(); out++)
+      layouts[i].push_back(ws.template Output<GPUBackend>(out).GetLayout());
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+bool Executor<WorkspacePolicy, QueuePolicy>::CanOverlapMixedIterations() const {
+  if (graph_->NumOp(OpType::MIXED) == 0 || stage_queue_depths_[OpType::MIXED] < 2)
+    return false;
+  for (int i = 0; i < graph_->NumOp(OpType::MIXED); i++) {
+    if (!graph_->Node(OpType::MIXED, i).spec.GetSchema().SupportsIterationOverlap())
+      return false;
+  }
+  return true;
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+bool Executor<WorkspacePolicy, QueuePolicy>::CanCaptureGPUStage() const {
+  if (device_id_ == CPU_ONLY_DEVICE_ID || graph_->NumOp(OpType::GPU) == 0)
+    return false;
+  for (int i = 0; i < graph_->NumOp(OpType::GPU); i++) {
+    auto &node = graph_->Node(OpType::GPU, i);
+    if (!node.spec.GetSchema().IsCudaGraphCapturable() || !node.op->CanInferOutputs() ||
+        node.spec.NumArgumentInput() > 0)
+      return false;
+    for (auto tid : node.parent_tensors) {
+      if (graph_->Tensor(tid).producer.storage_device != StorageDevice::GPU)
+        return false;
+    }
+    for (auto tid : node.children_tensors) {
+      if (graph_->Tensor(tid).producer.storage_device != StorageDevice::GPU)
+        return false;
+    }
+  }
+  return true;
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunCPUOp(OpNode &op_node, QueueIdxs idxs,
+                                                     int batch_size) {
+  auto &ws = ws_policy_.template GetWorkspace<OpType::CPU>(idxs, *graph_, op_node);
+
+  auto &names = node_names_[op_node.id];
+  DomainTimeRange tr(names.range_name, DomainTimeRange::kBlue1);
+
+  try {
+    batch_size = OpBatchSize(ws, op_node.spec.GetSchema(), batch_size);
+    ws.SetBatchSizes(batch_size);
+    if (batch_size == 0) {
+      ClearOutputs(ws);
+      RecordOpState(op_node);
+      return;
+    }
+    auto start = TimingCollector::Clock::now();
+    RunHelper(op_node, ws);
+    if (enable_operator_timing_) {
+      timing_.AddOperatorRun(names.meta_key, batch_size, TimingCollector::Seconds(start));
+    }
+    RecordOpState(op_node);
+    FillStats(cpu_memory_stats_, ws, names.meta_key, cpu_memory_stats_mutex_);
+  } catch (std::exception &e) {
+    HandleError("CPU", op_node, e.what());
+  } catch (...) {
+    HandleError();
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+int Executor<WorkspacePolicy, QueuePolicy>::RunCPUChain(int first_op, QueueIdxs idxs,
+                                                       int batch_size) {
+  struct ChainLink {
+    OpNode *node;
+    HostWorkspace *ws;
+    Operator<CPUBackend> *op;
+  };
+  int chain_len = cpu_chain_len_[first_op];
+  SmallVector<ChainLink, 8> chain;
+  // the operator run outside of the per-sample jobs, for the error message
+  OpNode *current = nullptr;
+  // the first operator of the chain which failed in the per-sample jobs
+  std::atomic<int> failed_link{chain_len};
+
+  DomainTimeRange tr("[DALI][Executor] CPU chain", DomainTimeRange::kBlue1);
+
+  try {
+    auto start = TimingCollector::Clock::now();
+    int chain_batch_size = -1;
+    for (int k = 0; k < chain_len; k++) {
+      auto &node = graph_->Node(OpType::CPU, first_op + k);
+      auto &ws = ws_policy_.template GetWorkspace<OpType::CPU>(idxs, *graph_, node);
+      int op_batch_size = OpBatchSize(ws, node.spec.GetSchema(), batch_size);
+      // an empty batch is handled by RunCPUOp
+      if (k == 0 ? op_batch_size == 0 : op_batch_size != chain_batch_size)
+        break;
+      chain_batch_size = op_batch_size;
+      current = &node;
+      ws.SetBatchSizes(op_batch_size);
+      DALI_ENFORCE(op_batch_size <= max_batch_size_,
+                   make_string("Expected batch size lower or equal to max batch size. Expected "
+                               "at most: ", max_batch_size_, ", got: ", op_batch_size));
+      SetOutputsOrder(ws);
+      auto *op = static_cast<Operator<CPUBackend> *>(node.op.get());
+      op->BeginSampleRun(ws);
+      chain.push_back({ &node, &ws, op });
+    }
+    current = nullptr;
+    if (chain.empty()) {
+      RunCPUOp(graph_->Node(OpType::CPU, first_op), idxs, batch_size);
+      return 1;
+    }
+
+    int num_links = chain.size();
+    auto &thread_pool = chain[0].ws->GetThreadPool();
+    for (int data_idx = 0; data_idx < chain_batch_size; data_idx++) {
+      thread_pool.AddWork([&, data_idx](int tid) {
+        for (int k = 0; k < num_links; k++) {
+          try {
+            chain[k].op->RunSample(*chain[k].ws, data_idx, tid);
+          } catch (...) {
+            int prev = failed_link.load();
+            while (k < prev && !failed_link.compare_exchange_weak(prev, k)) {}
+            throw;
+          }
+        }
+      }, -data_idx);  // -data_idx for FIFO order
+    }
+    thread_pool.RunAll();
+
+    for (auto &link : chain) {
+      current = link.node;
+      link.op->EndSampleRun(*link.ws);
+    }
+    current = nullptr;
+
+    // the operators run interleaved, so each of them is charged with the time of the chain
+    double seconds = TimingCollector::Seconds(start);
+    for (auto &link : chain) {
+      auto &names = node_names_[link.node->id];
+      if (enable_operator_timing_)
+        timing_.AddOperatorRun(names.meta_key, chain_batch_size, seconds);
+      RecordOpState(*link.node);
+      FillStats(cpu_memory_stats_, *link.ws, names.meta_key, cpu_memory_stats_mutex_);
+    }
+    return num_links;
+  } catch (std::exception &e) {
+    int failed = failed_link;
+    OpNode *failed_node = failed < static_cast<int>(chain.size()) ? chain[failed].node
+                        : current ? current : &graph_->Node(OpType::CPU, first_op);
+    HandleError("CPU", *failed_node, e.what());
+  } catch (...) {
+    HandleError();
+  }
+  return chain_len;
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunMixedOp(OpNode &op_node, QueueIdxs idxs,
+                                                       int batch_size) {
+  DeviceMemoryQuotaScope quota_scope(device_quota_.get(), device_id_);
+  try {
+    auto &ws = ws_policy_.template GetWorkspace<OpType::MIXED>(idxs, *graph_, op_node);
+
+    batch_size = OpBatchSize(ws, op_node.spec.GetSchema(), batch_size);
+    ws.SetBatchSizes(batch_size);
+
+    auto &names = node_names_[op_node.id];
+    DomainTimeRange tr(names.range_name, DomainTimeRange::kOrange);
+    if (batch_size == 0) {
+      ClearOutputs(ws);
+      RecordOpState(op_node);
+      if (ws.has_stream() && ws.has_event())
+        CUDA_CALL(cudaEventRecord(ws.event(), ws.stream()));
+      return;
+    }
+    bool timed = enable_operator_timing_;
+    auto start = TimingCollector::Clock::now();
+    TimingCollector::GPURange range;
+    if (timed && ws.has_stream())
+      range = timing_.BeginGPURun(ws.stream());
+    auto &tracer = Tracer::instance();
+    Tracer::GPUSpan gpu_span;
+    if (tracer.enabled() && ws.has_stream())
+      gpu_span = tracer.BeginGPUSpan(ws.stream());
+    RunHelperRetryOnOOM(op_node, ws, mixed_scratch_arena_.get());
+    if (gpu_span.start)
+      tracer.EndGPUSpan(names.range_name, std::move(gpu_span), ws.stream());
+    if (timed) {
+      if (ws.has_stream())
+        timing_.EndGPURun(names.meta_key, std::move(range), ws.stream());
+      timing_.AddOperatorRun(names.meta_key, batch_size, TimingCollector::Seconds(start));
+    }
+    RecordOpState(op_node);
+    FillStats(mixed_memory_stats_, ws, names.meta_key, mixed_memory_stats_mutex_);
+    if (ws.has_stream() && ws.has_event()) {
+      CUDA_CALL(cudaEventRecord(ws.event(), ws.stream()));
+    }
+    CUDA_CALL(cudaGetLastError());
+  } catch (std::exception &e) {
+    HandleError("Mixed", op_node, e.what());
+  } catch (...) {
+    HandleError();
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunGPUOpImpl(
+    OpNode &op_node, QueueIdxs idxs, int batch_size, bool wait_for_parents, OpRunSteps steps,
+    const SmallVector<TensorLayout, 4> *replay_layouts) {
+  DeviceMemoryQuotaScope quota_scope(device_quota_.get(), device_id_);
+  auto &ws = ws_policy_.template GetWorkspace<OpType::GPU>(idxs, *graph_, op_node);
+  if (steps != OpRunSteps::RunOnly)
+    SetJoinedOutput(op_node, idxs);
+
+  batch_size = OpBatchSize(ws, op_node.spec.GetSchema(), batch_size);
+  ws.SetBatchSizes(batch_size);
+
+  if (wait_for_parents) {
+    for (auto &event : ws.ParentEvents()) {
+      CUDA_CALL(cudaStreamWaitEvent(ws.stream(), event, 0));
+    }
+  }
+
+  auto &names = node_names_[op_node.id];
+  DomainTimeRange tr(names.range_name, DomainTimeRange::knvGreen);
+  // The operator which is captured is finished in the RunOnly step; the work of the replayed one
+  // is issued by the graph
+  bool finished = steps != OpRunSteps::SetupOnly || replay_layouts;
+  if (batch_size == 0) {
+    if (steps != OpRunSteps::RunOnly)
+      ClearOutputs(ws);
+    if (finished) {
+      RecordOpState(op_node);
+      if (ws.has_event())
+        CUDA_CALL(cudaEventRecord(ws.event(), ws.stream()));
+    }
+    return;
+  }
+  if (steps == OpRunSteps::SetupOnly) {
+    RunHelper(op_node, ws, steps, replay_layouts);
+    if (finished)
+      RecordOpState(op_node);
+    return;
+  }
+  // The operators are timed only when run eagerly - not when captured in a CUDA graph
+  bool timed = enable_operator_timing_ && wait_for_parents;
+  auto start = TimingCollector::Clock::now();
+  TimingCollector::GPURange range;
+  if (timed)
+    range = timing_.BeginGPURun(ws.stream());
+  auto &tracer = Tracer::instance();
+  Tracer::GPUSpan gpu_span;
+  if (tracer.enabled())
+    gpu_span = tracer.BeginGPUSpan(ws.stream());
+  // The retry isn't captured - it may synchronize the stream
+  if (steps == OpRunSteps::RunOnly)
+    RunHelper(op_node, ws, steps);
+  else
+    RunHelperRetryOnOOM(op_node, ws, gpu_scratch_arena_.get());
+  if (gpu_span.start)
+    tracer.EndGPUSpan(names.range_name, std::move(gpu_span), ws.stream());
+  if (timed) {
+    timing_.EndGPURun(names.meta_key, std::move(range), ws.stream());
+    timing_.AddOperatorRun(names.meta_key, batch_size, TimingCollector::Seconds(start));
+  }
+  RecordOpState(op_node);
+  FillStats(gpu_memory_stats_, ws, names.meta_key, gpu_memory_stats_mutex_);
+  if (ws.has_event()) {
+    CUDA_CALL(cudaEventRecord(ws.event(), ws.stream()));
+  }
+  CUDA_CALL(cudaGetLastError());
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunGPUOp(OpNode &op_node, QueueIdxs idxs,
+                                                     int batch_size) {
+  try {
+    RunGPUOpImpl(op_node, idxs, batch_size, true);
+  } catch (std::exception &e) {
+    HandleError("GPU", op_node, e.what());
+  } catch (...) {
+    HandleError();
+  }
 }
 
 template <typename WorkspacePolicy, typename QueuePolicy>
@@ -298,14 +872,184 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunGPU() {
 
 template <typename WorkspacePolicy, typename QueuePolicy>
 template <typename Workspace>
-void Executor<WorkspacePolicy, QueuePolicy>::RunHelper(OpNode &op_node, Workspace &ws) {
+void Executor<WorkspacePolicy, QueuePolicy>::RunHelperRetryOnOOM(OpNode &op_node, Workspace &ws,
+                                                                 kernels::ScratchArena *arena) {
+  try {
+    RunHelper(op_node, ws);
+    return;
+  } catch (const CUDABadAlloc &) {
+    // An operator working in place may have overwritten its input - it cannot be run again.
+    bool in_place = !buffer_reuse_state_.empty() && buffer_reuse_state_[op_node.id].in_place;
+    if (in_place)
+      throw;
+  }
+  DALI_WARN("Operator \"", op_node.instance_name, "\" ran out of device memory - releasing "
+            "the cached memory and running it again.");
+  ReleaseCachedMemory(ws, arena);
+  if constexpr (std::is_same<Workspace, DeviceWorkspace>::value) {
+    if (CanRunInSubBatches(op_node, ws)) {
+      try {
+        RunHelper(op_node, ws);
+        return;
+      } catch (const CUDABadAlloc &) {}
+      DALI_WARN("Operator \"", op_node.instance_name, "\" ran out of device memory again - "
+                "running it on parts of the batch.");
+      ReleaseCachedMemory(ws, arena);
+      RunInSubBatches(op_node, ws, arena);
+      return;
+    }
+  }
+  RunHelper(op_node, ws);
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+bool Executor<WorkspacePolicy, QueuePolicy>::CanRunInSubBatches(const OpNode &op_node,
+                                                                const DeviceWorkspace &ws) const {
+  if (!op_node.spec.GetSchema().IsBatchSplittable() || !op_node.op->CanInferOutputs() ||
+      ws.HasGPUArgumentInputs() || ws.NumOutput() == 0)
+    return false;
+  if (!buffer_reuse_state_.empty()) {
+    // The executor places such outputs in other buffers as whole batches
+    auto &reuse = buffer_reuse_state_[op_node.id];
+    if (reuse.in_place || reuse.joins >= 0 || reuse.joined >= 0)
+      return false;
+  }
+  int batch_size = ws.GetRequestedBatchSize(0);
+  if (batch_size < 2)
+    return false;
+  for (int i = 0; i < ws.NumInput(); i++) {
+    if (ws.GetInputBatchSize(i) != batch_size)
+      return false;
+    bool dense = ws.InputIsType<CPUBackend>(i) ? IsDenselyPacked(ws.Input<CPUBackend>(i))
+                                               : IsDenselyPacked(ws.Input<GPUBackend>(i));
+    if (!dense)
+      return false;
+  }
+  const ArgumentWorkspace &arg_ws = ws;
+  for (const auto &arg : arg_ws) {
+    if (ws.ArgumentInput(arg.second).num_samples() != batch_size)
+      return false;
+  }
+  return true;
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunInSubBatches(OpNode &op_node, DeviceWorkspace &ws,
+                                                             kernels::ScratchArena *arena) {
   auto &output_desc = op_node.output_desc;
   auto &op = *op_node.op;
+  auto &names = node_names_[op_node.id];
+  auto *reuse = buffer_reuse_state_.empty() ? nullptr : &buffer_reuse_state_[op_node.id];
+
+  // The outputs are allocated for the whole batch and the sub-batches view their samples
   output_desc.clear();
-  const auto &spec = op.GetSpec();
-  const auto &schema = spec.GetSchema();
-  SmallVector<int, 16> empty_layout_in_idxs;
+  {
+    DomainTimeRange tr(names.setup_range_name, DomainTimeRange::kYellow);
+    op.Setup(output_desc, ws);
+  }
+  for (int i = 0; i < ws.NumOutput(); i++) {
+    auto &desc = output_desc[i];
+    if (ws.OutputIsType<CPUBackend>(i)) {
+      ws.Output<CPUBackend>(i).Resize(desc.shape, desc.type);
+    } else {
+      ws.Output<GPUBackend>(i).Resize(desc.shape, desc.type);
+    }
+  }
+  if (reuse) {
+    ForEachReusedOutput(*reuse, [&](int i) {
+      const auto &layout = reuse->layouts[i];
+      auto restore_layout = [&](auto &out) {
+        out.SetLayout(layout.size() == out.sample_dim() ? layout : TensorLayout());
+      };
+      if (ws.OutputIsType<CPUBackend>(i))
+        restore_layout(ws.Output<CPUBackend>(i));
+      else
+        restore_layout(ws.Output<GPUBackend>(i));
+    });
+  }
 
+  auto run_sub_batch = [&](int begin, int end) {
+    DeviceWorkspace sub_ws = ws;
+    for (int i = 0; i < ws.NumInput(); i++) {
+      if (ws.InputIsType<CPUBackend>(i))
+        sub_ws.SetInput(i, SubBatch(ws.UnsafeMutableInput<CPUBackend>(i), begin, end));
+      else
+        sub_ws.SetInput(i, SubBatch(ws.UnsafeMutableInput<GPUBackend>(i), begin, end));
+    }
+    for (int i = 0; i < ws.NumOutput(); i++) {
+      if (ws.OutputIsType<CPUBackend>(i))
+        sub_ws.SetOutput(i, SubBatch(ws.Output<CPUBackend>(i), begin, end));
+      else
+        sub_ws.SetOutput(i, SubBatch(ws.Output<GPUBackend>(i), begin, end));
+    }
+    const ArgumentWorkspace &arg_ws = ws;
+    for (const auto &arg : arg_ws)
+      sub_ws.AddArgumentInput(arg.first, SubBatch(ws.ArgumentInput(arg.second), begin, end));
+    sub_ws.SetBatchSizes(end - begin);
+
+    std::vector<OutputDesc> sub_desc;
+    {
+      DomainTimeRange tr(names.setup_range_name, DomainTimeRange::kYellow);
+      op.Setup(sub_desc, sub_ws);
+    }
+    for (int i = 0; i < ws.NumOutput(); i++) {
+      const auto &sub_shape = ws.OutputIsType<CPUBackend>(i) ? sub_ws.Output<CPUBackend>(i).shape()
+                                                             : sub_ws.Output<GPUBackend>(i).shape();
+      DALI_ENFORCE(sub_desc[i].type == output_desc[i].type && sub_desc[i].shape == sub_shape,
+                   make_string("Operator \"", op_node.instance_name, "\" can't be run on parts "
+                               "of the batch - the shapes of its outputs differ from the ones "
+                               "inferred for the whole batch."));
+    }
+    {
+      DomainTimeRange tr(names.run_range_name, DomainTimeRange::kCyan);
+      op.Run(sub_ws);
+    }
+    auto copy_meta = [&](auto &out, const auto &sub_out) {
+      for (int s = begin; s < end; s++) {
+        DALI_ENFORCE(sub_out.raw_tensor(s - begin) == out.raw_tensor(s), make_string(
+                     "Operator \"", op_node.instance_name, "\" reallocated its outputs - "
+                     "it can't be run on parts of the batch."));
+        out.SetMeta(s, sub_out.GetMeta(s - begin));
+      }
+      out.SetLayout(sub_out.GetLayout());
+    };
+    for (int i = 0; i < ws.NumOutput(); i++) {
+      if (ws.OutputIsType<CPUBackend>(i))
+        copy_meta(ws.Output<CPUBackend>(i), sub_ws.Output<CPUBackend>(i));
+      else
+        copy_meta(ws.Output<GPUBackend>(i), sub_ws.Output<GPUBackend>(i));
+    }
+  };
+
+  int batch_size = ws.GetRequestedBatchSize(0);
+  int sub_batch_size = (batch_size + 1) / 2;
+  for (int begin = 0; begin < batch_size;) {
+    int end = std::min(begin + sub_batch_size, batch_size);
+    try {
+      run_sub_batch(begin, end);
+    } catch (const CUDABadAlloc &) {
+      if (sub_batch_size == 1)
+        throw;
+      // run the samples which are left in smaller parts
+      sub_batch_size = (sub_batch_size + 1) / 2;
+      ReleaseCachedMemory(ws, arena);
+      continue;
+    }
+    begin = end;
+  }
+
+  if (reuse) {
+    ForEachReusedOutput(*reuse, [&](int i) {
+      reuse->layouts[i] = ws.OutputIsType<CPUBackend>(i)
+                              ? ws.Output<CPUBackend>(i).GetLayout()
+                              : ws.Output<GPUBackend>(i).GetLayout();
+    });
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+template <typename Workspace>
+void Executor<WorkspacePolicy, QueuePolicy>::SetOutputsOrder(Workspace &ws) {
   cudaStream_t prev_stage_stream = ws.has_stream() && ws.stream() == gpu_op_stream_
     ? mixed_op_stream_ : gpu_op_stream_;
 
@@ -323,6 +1067,105 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunHelper(OpNode &op_node, Workspac
       set_order(ws.template Output<GPUBackend>(i));
     }
   }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+template <typename Workspace>
+void Executor<WorkspacePolicy, QueuePolicy>::SetupHelper(OpNode &op_node, Workspace &ws) {
+  auto &output_desc = op_node.output_desc;
+  auto &op = *op_node.op;
+  output_desc.clear();
+  auto *reuse = buffer_reuse_state_.empty() ? nullptr : &buffer_reuse_state_[op_node.id];
+
+  auto &names = node_names_[op_node.id];
+  bool can_infer_outputs;
+  {
+    DomainTimeRange tr(names.setup_range_name, DomainTimeRange::kYellow);
+    can_infer_outputs = op.Setup(output_desc, ws);
+  }
+  if (can_infer_outputs) {
+    DALI_ENFORCE(
+        static_cast<size_t>(ws.NumOutput()) == output_desc.size(),
+        "Operator::Setup returned shape and type information for mismatched number of outputs");
+    DALI_ENFORCE(op.CanInferOutputs(),
+                 "Operator::Setup returned true indicating that it successfully calculated shape "
+                 "and type information for Operator outputs. In that case CanInferOutputs should "
+                 "always return true.");
+    if (reuse && reuse->in_place) {
+      auto share_input = [&](auto &out, const auto &in) {
+        bool in_place = in.shape() == output_desc[0].shape && in.type() == output_desc[0].type &&
+                        ShareInPlace(out, in);
+        if (!in_place && reuse->ran_in_place) {
+          // stop sharing, the output needs its own memory
+          out.Reset();
+          out.SetContiguous(true);
+        }
+        reuse->ran_in_place = in_place;
+      };
+      if (ws.template OutputIsType<CPUBackend>(0)) {
+        auto &out = ws.template Output<CPUBackend>(0);
+        if (ws.template InputIsType<CPUBackend>(0))
+          share_input(out, ws.template Input<CPUBackend>(0));
+        else
+          share_input(out, ws.template Input<GPUBackend>(0));
+      } else {
+        auto &out = ws.template Output<GPUBackend>(0);
+        if (ws.template InputIsType<CPUBackend>(0))
+          share_input(out, ws.template Input<CPUBackend>(0));
+        else
+          share_input(out, ws.template Input<GPUBackend>(0));
+      }
+    }
+    int placed_output = -1;
+    if constexpr (std::is_same<Workspace, DeviceWorkspace>::value) {
+      if (reuse && reuse->joined >= 0 && PlaceJoinedInput(*reuse, ws, output_desc))
+        placed_output = reuse->joined_output;
+      if (reuse && reuse->joins >= 0)
+        FinishJoinedInputs(*reuse, ws, output_desc);
+    }
+    for (int i = 0; i < ws.NumOutput(); i++) {
+      auto &desc = output_desc[i];
+      if (i == placed_output)
+        continue;  // already shares the memory of the joined output
+      if (ws.template OutputIsType<CPUBackend>(i)) {
+        ws.template Output<CPUBackend>(i).Resize(desc.shape, desc.type);
+      } else {
+        ws.template Output<GPUBackend>(i).Resize(desc.shape, desc.type);
+      }
+    }
+    if (reuse) {
+      // The memory comes from another tensor, along with its layout
+      auto restore_layout = [&](auto &out, int i) {
+        const auto &layout = reuse->layouts[i];
+        out.SetLayout(layout.size() == out.sample_dim() ? layout : TensorLayout());
+      };
+      ForEachReusedOutput(*reuse, [&](int i) {
+        if (ws.template OutputIsType<CPUBackend>(i))
+          restore_layout(ws.template Output<CPUBackend>(i), i);
+        else
+          restore_layout(ws.template Output<GPUBackend>(i), i);
+      });
+    }
+  } else {
+    DALI_ENFORCE(!op.CanInferOutputs(),
+                 "Operator::Setup returned false indicating that it cannot calculate shape and "
+                 "type information for Operator outputs. In that case CanInferOutputs should "
+                 "always return false.");
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+template <typename Workspace>
+void Executor<WorkspacePolicy, QueuePolicy>::RunHelper(
+    OpNode &op_node, Workspace &ws, OpRunSteps steps,
+    const SmallVector<TensorLayout, 4> *replay_layouts) {
+  auto &op = *op_node.op;
+  const auto &spec = op.GetSpec();
+  const auto &schema = spec.GetSchema();
+  SmallVector<int, 16> empty_layout_in_idxs;
+  auto *reuse = buffer_reuse_state_.empty() ? nullptr : &buffer_reuse_state_[op_node.id];
+
+  SetOutputsOrder(ws);
 
   for (int i = 0; i < ws.NumInput(); i++) {
     DALI_ENFORCE(
@@ -348,30 +1191,31 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunHelper(OpNode &op_node, Workspac
     if (had_empty_layout) empty_layout_in_idxs.push_back(i);
   }
 
-  if (op.Setup(output_desc, ws)) {
-    DALI_ENFORCE(
-        static_cast<size_t>(ws.NumOutput()) == output_desc.size(),
-        "Operator::Setup returned shape and type information for mismatched number of outputs");
-    DALI_ENFORCE(op.CanInferOutputs(),
-                 "Operator::Setup returned true indicating that it successfully calculated shape "
-                 "and type information for Operator outputs. In that case CanInferOutputs should "
-                 "always return true.");
-    for (int i = 0; i < ws.NumOutput(); i++) {
-      auto &desc = output_desc[i];
-      if (ws.template OutputIsType<CPUBackend>(i)) {
-        ws.template Output<CPUBackend>(i).Resize(desc.shape, desc.type);
-      } else {
-        ws.template Output<GPUBackend>(i).Resize(desc.shape, desc.type);
+  if (steps != OpRunSteps::RunOnly)
+    SetupHelper(op_node, ws);
+
+  if (steps == OpRunSteps::SetupOnly) {
+    if (replay_layouts) {
+      for (int i = 0; i < ws.NumOutput(); i++) {
+        if (ws.template OutputIsType<CPUBackend>(i))
+          ws.template Output<CPUBackend>(i).SetLayout((*replay_layouts)[i]);
+        else
+          ws.template Output<GPUBackend>(i).SetLayout((*replay_layouts)[i]);
       }
     }
   } else {
-    DALI_ENFORCE(!op.CanInferOutputs(),
-                 "Operator::Setup returned false indicating that it cannot calculate shape and "
-                 "type information for Operator outputs. In that case CanInferOutputs should "
-                 "always return false.");
+    auto &names = node_names_[op_node.id];
+    DomainTimeRange tr(names.run_range_name, DomainTimeRange::kCyan);
+    op.Run(ws);
   }
 
-  op.Run(ws);
+  if (reuse) {
+    ForEachReusedOutput(*reuse, [&](int i) {
+      reuse->layouts[i] = ws.template OutputIsType<CPUBackend>(i)
+                              ? ws.template Output<CPUBackend>(i).GetLayout()
+                              : ws.template Output<GPUBackend>(i).GetLayout();
+    });
+  }
 
   for (int i : empty_layout_in_idxs) {
     if (ws.template InputIsType<CPUBackend>(i)) {
@@ -385,6 +1229,84 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunHelper(OpNode &op_node, Workspac
 }
 
 
+template <typename WorkspacePolicy, typename QueuePolicy>
+bool Executor<WorkspacePolicy, QueuePolicy>::PlaceJoinedInput(
+    const NodeBufferReuse &reuse, DeviceWorkspace &ws, const std::vector<OutputDesc> &output_desc) {
+  auto &joined = joined_inputs_[reuse.joined];
+  int input = reuse.joined_input;
+  if (input == joined.first_input) {
+    // The first producer computes the placement of all the inputs from their previous shapes
+    joined.sample_volumes.clear();
+    int ninputs = joined.shapes.size();
+    int nsamples = ninputs > 0 ? joined.shapes[0].num_samples() : 0;
+    bool uniform = ninputs > 0 && joined.output;
+    for (auto &shape : joined.shapes)
+      uniform = uniform && shape.num_samples() == nsamples;
+    if (uniform) {
+      joined.offsets.resize(ninputs);
+      joined.sample_volumes.resize(nsamples, 0);
+      Index offset = 0;
+      for (int s = 0; s < nsamples; s++) {
+        for (int i = 0; i < ninputs; i++) {
+          joined.offsets[i].resize(nsamples);
+          joined.offsets[i][s] = offset;
+          auto v = volume(joined.shapes[i].tensor_shape_span(s));
+          joined.sample_volumes[s] += v;
+          offset += v;
+        }
+      }
+      TensorListShape<> flat(nsamples, 1);
+      for (int s = 0; s < nsamples; s++)
+        flat.set_tensor_shape(s, TensorShape<>(joined.sample_volumes[s]));
+      joined.output->Resize(flat, joined.type);
+    }
+  }
+
+  auto &out = ws.Output<GPUBackend>(reuse.joined_output);
+  const auto &desc = output_desc[reuse.joined_output];
+  bool place = !joined.sample_volumes.empty() && desc.type == joined.type &&
+               desc.shape == joined.shapes[input];
+  if (place) {
+    out.ShareSubregions(*joined.output, desc.shape, make_cspan(joined.offsets[input]));
+  } else if (out.shares_data()) {
+    out.Reset();  // the output needs its own memory again
+  }
+  joined.placed[input] = place;
+  return place;
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::FinishJoinedInputs(
+    const NodeBufferReuse &reuse, DeviceWorkspace &ws, const std::vector<OutputDesc> &output_desc) {
+  auto &joined = joined_inputs_[reuse.joins];
+  const auto &desc = output_desc[0];
+  bool any_placed = false, all_placed = true;
+  for (bool placed : joined.placed) {
+    any_placed = any_placed || placed;
+    all_placed = all_placed && placed;
+  }
+  // The inputs make up the output only if the samples of the output have the expected sizes
+  bool joined_in_place = all_placed && desc.type == joined.type &&
+                         desc.shape.num_samples() ==
+                             static_cast<int>(joined.sample_volumes.size());
+  for (int s = 0; joined_in_place && s < desc.shape.num_samples(); s++)
+    joined_in_place = volume(desc.shape.tensor_shape_span(s)) == joined.sample_volumes[s];
+  if (any_placed && !joined_in_place) {
+    // the placed inputs keep the memory, the output is allocated anew
+    ws.Output<GPUBackend>(0).Reset();
+  }
+
+  // The shapes of the inputs are used to place them in the next iteration
+  int ninputs = joined.placed.size();
+  joined.shapes.resize(ninputs);
+  for (int i = 0; i < ninputs; i++)
+    joined.shapes[i] = ws.Input<GPUBackend>(i).shape();
+  joined.type = ninputs > 0 ? ws.Input<GPUBackend>(0).type() : DALI_NO_TYPE;
+  std::fill(joined.placed.begin(), joined.placed.end(), false);
+  // nothing is placed until the first producer runs again
+  joined.sample_volumes.clear();
+}
+
 template <typename WorkspacePolicy, typename QueuePolicy>
 int Executor<WorkspacePolicy, QueuePolicy>::InferBatchSize(
     const std::vector<BatchSizeProvider *> &bsps) const {
@@ -15,11 +15,16 @@
 #ifndef DALI_PIPELINE_EXECUTOR_EXECUTOR_H_
 #define DALI_PIPELINE_EXECUTOR_EXECUTOR_H_
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <queue>
+#include <set>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 #include <unordered_map>
@@ -28,11 +33,19 @@
 #include "dali/core/common.h"
 #include "dali/core/cuda_stream_pool.h"
 #include "dali/core/error_handling.h"
+#include "dali/core/mm/quota_resource.h"
 #include "dali/core/nvtx.h"
+#include "dali/core/small_vector.h"
+#include "dali/kernels/scratch_arena.h"
 #include "dali/pipeline/data/backend.h"
+#include "dali/pipeline/data/buffer.h"
+#include "dali/pipeline/executor/checkpoint.h"
+#include "dali/pipeline/executor/memory_profile.h"
+#include "dali/pipeline/executor/operator_timing.h"
 #include "dali/pipeline/executor/queue_metadata.h"
 #include "dali/pipeline/executor/queue_policy.h"
 #include "dali/pipeline/executor/workspace_policy.h"
+#include "dali/pipeline/graph/buffer_reuse.h"
 #include "dali/pipeline/graph/op_graph.h"
 #include "dali/pipeline/graph/op_graph_storage.h"
 #include "dali/pipeline/graph/op_graph_verifier.h"
@@ -49,14 +62,6 @@
 
 namespace dali {
 
-struct DLL_PUBLIC ExecutorMeta {
-  size_t real_size;
-  size_t max_real_size;
-  size_t reserved;
-  size_t max_reserved;
-};
-using ExecutorMetaMap = std::unordered_map<std::string, std::vector<ExecutorMeta>>;
-
 namespace detail {
 // This is stream callback used on GPU stream to indicate that GPU work for this
 // pipeline run is finished
@@ -67,6 +72,16 @@ static void AppendToMap(ExecutorMetaMap &ret, ExecutorMetaMap &in_stats, std::mu
 
 }  // namespace detail
 
+/**
+ * @brief Allocates the memory for a GPU output of the pipeline.
+ *
+ * The arguments are: the index of the pipeline output, the number of bytes and the stream in
+ * which the executor writes to the memory. The pointer returned has a deleter which gives
+ * the memory back to the allocator.
+ */
+using OutputAllocFunc =
+    std::function<std::shared_ptr<uint8_t>(int output_idx, size_t bytes, cudaStream_t stream)>;
+
 class DLL_PUBLIC ExecutorBase {
  public:
   using ExecutorCallback = std::function<void(void)>;
@@ -78,11 +93,31 @@ class DLL_PUBLIC ExecutorBase {
   DLL_PUBLIC virtual void RunGPU() = 0;
   DLL_PUBLIC virtual void Outputs(DeviceWorkspace *ws) = 0;
   DLL_PUBLIC virtual void ShareOutputs(DeviceWorkspace *ws) = 0;
+  DLL_PUBLIC virtual bool TryShareOutputs(DeviceWorkspace *ws) = 0;
   DLL_PUBLIC virtual void ReleaseOutputs() = 0;
   DLL_PUBLIC virtual void SetCompletionCallback(ExecutorCallback cb) = 0;
   DLL_PUBLIC virtual void EnableMemoryStats(bool enable_memory_stats = false) = 0;
   DLL_PUBLIC virtual ExecutorMetaMap GetExecutorMeta() = 0;
+  DLL_PUBLIC virtual void EnableOperatorTiming(bool enable = true) = 0;
+  DLL_PUBLIC virtual ExecutorTiming GetOperatorTiming() = 0;
   DLL_PUBLIC virtual void Shutdown() = 0;
+  DLL_PUBLIC virtual void EnableAdaptiveQueueDepth(const AdaptiveQueueDepthParams &params) = 0;
+  DLL_PUBLIC virtual QueueSizes ActiveQueueSizes() const = 0;
+  DLL_PUBLIC virtual void EnableBufferReuse(bool enable = true) = 0;
+  DLL_PUBLIC virtual void SetMemoryProfile(ExecutorMetaMap profile) = 0;
+  DLL_PUBLIC virtual void SetDeviceMemoryQuota(
+      std::shared_ptr<mm::device_quota_resource> quota) = 0;
+  DLL_PUBLIC virtual void EnableGrowableBuffers(bool enable = true) = 0;
+  DLL_PUBLIC virtual void EnableCudaGraphs(bool enable = true) = 0;
+  DLL_PUBLIC virtual void EnableLowLatency(bool enable = true) = 0;
+  DLL_PUBLIC virtual void EnableSampleChaining(bool enable = true) = 0;
+  DLL_PUBLIC virtual void EnableSharedThreadPool(bool enable = true, int priority = 0) = 0;
+  DLL_PUBLIC virtual void EnableWorkStealingThreadPool(bool enable = true) = 0;
+  DLL_PUBLIC virtual void SetBatchSizeBuckets(std::vector<int> buckets) = 0;
+  DLL_PUBLIC virtual void SetOutputAllocator(OutputAllocFunc alloc) = 0;
+  DLL_PUBLIC virtual void EnableCheckpointing(bool enable = true) = 0;
+  DLL_PUBLIC virtual Checkpoint GetCheckpoint() = 0;
+  DLL_PUBLIC virtual void RestoreCheckpoint(const Checkpoint &cpt) = 0;
 
  protected:
   // virtual to allow the TestPruneWholeGraph test in gcc
@@ -108,9 +143,12 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
       : max_batch_size_(max_batch_size),
         device_id_(device_id),
         bytes_per_sample_hint_(bytes_per_sample_hint),
+        default_cuda_stream_priority_(default_cuda_stream_priority),
         callback_(nullptr),
         event_pool_(),
-        thread_pool_(num_thread, device_id, set_affinity, "Executor"),
+        num_thread_(num_thread),
+        set_affinity_(set_affinity),
+        thread_pool_(std::make_unique<ThreadPool>(num_thread, device_id, set_affinity, "Executor")),
         exec_error_(false),
         queue_sizes_(prefetch_queue_depth),
         enable_memory_stats_(false) {
@@ -130,12 +168,219 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
   DLL_PUBLIC void RunMixed() override;
   DLL_PUBLIC void RunGPU() override;
   DLL_PUBLIC void Outputs(DeviceWorkspace *ws) override;
+  /**
+   * @brief Fills `ws` with the outputs of the oldest iteration, without releasing the previous ones
+   *
+   * If the stream of `ws` is set, the GPU outputs are ready for the work issued to that stream
+   * and the host doesn't wait for them; their buffers are reused by the pipeline only after
+   * the work issued to the stream before ReleaseOutputs completes.
+   * Otherwise, the outputs are ready for the host and any stream when the function returns.
+   */
   DLL_PUBLIC void ShareOutputs(DeviceWorkspace *ws) override;
+  /**
+   * @brief Shares the oldest ready outputs, like ShareOutputs, if their computation is complete
+   *
+   * Doesn't wait: returns false, if there are no such outputs.
+   */
+  DLL_PUBLIC bool TryShareOutputs(DeviceWorkspace *ws) override;
   DLL_PUBLIC void ReleaseOutputs() override;
   DLL_PUBLIC void SetCompletionCallback(ExecutorCallback cb) override;
   DLL_PUBLIC ExecutorMetaMap GetExecutorMeta() override;
   DLL_PUBLIC void Shutdown() override;
 
+  /**
+   * @brief Makes the executor measure the time of the operators and the stages
+   * and the occupancy of the queues, see GetOperatorTiming
+   *
+   * The device time of the operators is measured with CUDA events; the work of the GPU stage
+   * replayed as a CUDA graph is not timed.
+   */
+  DLL_PUBLIC void EnableOperatorTiming(bool enable = true) override {
+    enable_operator_timing_ = enable;
+    QueuePolicy::EnableWaitTiming(enable);
+  }
+
+  /**
+   * @brief Returns the timing gathered since it was enabled with EnableOperatorTiming
+   */
+  DLL_PUBLIC ExecutorTiming GetOperatorTiming() override;
+
+  /**
+   * @brief Lets the queue policy adjust the prefetch queue depth at runtime
+   *
+   * The buffers are prepared for the maximum depth, but only the ones in circulation are
+   * allocated; the memory of the buffers taken out of circulation is freed.
+   * Must be called before Build.
+   */
+  DLL_PUBLIC void EnableAdaptiveQueueDepth(const AdaptiveQueueDepthParams &params) override;
+
+  DLL_PUBLIC QueueSizes ActiveQueueSizes() const override {
+    return QueuePolicy::ActiveQueueSizes();
+  }
+
+  /**
+   * @brief Lets the stage-local intermediate tensors share the buffers and the operators
+   * supporting it run in place. Ignored by the executors that don't run the operators of
+   * a stage one by one. Must be called before Build.
+   */
+  DLL_PUBLIC void EnableBufferReuse(bool enable = true) override {
+    DALI_ENFORCE(graph_ == nullptr, "Buffer reuse must be set before the executor is built.");
+    buffer_reuse_ = enable;
+  }
+
+  /**
+   * @brief Sets the output sizes, recorded with the memory statistics in a previous run,
+   * which are used to reserve the buffers when the executor is built. Must be called before Build.
+   */
+  DLL_PUBLIC void SetMemoryProfile(ExecutorMetaMap profile) override {
+    DALI_ENFORCE(graph_ == nullptr, "Memory profile must be set before the executor is built.");
+    memory_profile_ = std::move(profile);
+  }
+
+  /**
+   * @brief Makes the GPU buffers of the operators (including the buffers allocated when the
+   * executor is built) use the memory quota. Must be called before Build.
+   */
+  DLL_PUBLIC void SetDeviceMemoryQuota(std::shared_ptr<mm::device_quota_resource> quota) override {
+    DALI_ENFORCE(graph_ == nullptr, "Memory quota must be set before the executor is built.");
+    device_quota_ = std::move(quota);
+  }
+
+  /**
+   * @brief Makes the GPU output buffers of the operators grow in place, by mapping more
+   * physical memory, instead of being reallocated. Ignored (with a warning) if the CUDA virtual
+   * memory management is not supported. Must be called before Build.
+   */
+  DLL_PUBLIC void EnableGrowableBuffers(bool enable = true) override {
+    DALI_ENFORCE(graph_ == nullptr, "Growable buffers must be set before the executor is built.");
+    growable_buffers_ = enable;
+  }
+
+  /**
+   * @brief Lets the executor capture the work of the GPU stage in a CUDA graph and replay it,
+   * as long as the inputs and outputs of the GPU operators stay the same.
+   *
+   * The stage is captured after it ran a few times with the same inputs and outputs
+   * and captured again when they change. Used only if all the GPU operators are capturable
+   * (see OpSchema::CudaGraphCapturable) and have neither CPU nor argument inputs; ignored by
+   * the executors that don't run the GPU stage as a whole. Must be called before Build.
+   */
+  DLL_PUBLIC void EnableCudaGraphs(bool enable = true) override {
+    DALI_ENFORCE(graph_ == nullptr, "CUDA graphs must be set before the executor is built.");
+    cuda_graphs_ = enable;
+  }
+
+  /**
+   * @brief Runs the work of the CPU operators in the calling thread, when they issue a single
+   * job to the thread pool (e.g. for a batch of one sample), see ThreadPool::SetInlineSingleWork
+   */
+  DLL_PUBLIC void EnableLowLatency(bool enable = true) override {
+    low_latency_ = enable;
+    thread_pool_->SetInlineSingleWork(enable);
+  }
+
+  /**
+   * @brief Runs the consecutive CPU operators marked with OpSchema::SampleChainable as one task
+   * per sample, instead of waiting for the whole batch after each of them. Ignored by
+   * the executors that don't run the operators of a stage one by one. Must be called before Build.
+   */
+  DLL_PUBLIC void EnableSampleChaining(bool enable = true) override {
+    DALI_ENFORCE(graph_ == nullptr, "Sample chaining must be set before the executor is built.");
+    sample_chaining_ = enable;
+  }
+
+  /**
+   * @brief Runs the work of the CPU operators on the worker threads shared by the process
+   * (see ThreadPool::Shared) instead of the threads of the executor. Must be called before Build.
+   *
+   * @param priority the executors with a higher priority get the free shared threads first
+   */
+  DLL_PUBLIC void EnableSharedThreadPool(bool enable = true, int priority = 0) override {
+    DALI_ENFORCE(graph_ == nullptr,
+                 "The shared thread pool must be set before the executor is built.");
+    shared_thread_pool_ = enable;
+    thread_pool_priority_ = priority;
+    ResetThreadPool();
+  }
+
+  /**
+   * @brief Runs the work of the CPU operators with a thread pool with per-thread work queues and
+   * work stealing (see ThreadPool::WorkStealing). Must be called before Build.
+   *
+   * The operators use the pool as before; it can't be combined with the shared thread pool.
+   */
+  DLL_PUBLIC void EnableWorkStealingThreadPool(bool enable = true) override {
+    DALI_ENFORCE(graph_ == nullptr,
+                 "The work-stealing thread pool must be set before the executor is built.");
+    if (enable == work_stealing_thread_pool_)
+      return;
+    work_stealing_thread_pool_ = enable;
+    ResetThreadPool();
+  }
+
+  /**
+   * @brief Sets the batch sizes the iterations should preferably have, e.g. for the serving
+   * pipelines, which gather the batches from the requests of varying sizes.
+   *
+   * The buckets are passed to the batch size providers (see
+   * BatchSizeProvider::SetBatchSizeBuckets); the maximum batch size is always a bucket.
+   * With CUDA graphs, the GPU stage is captured separately for each bucket, so that
+   * the iterations alternating between the buckets replay their graphs instead of capturing
+   * them again. Must be called before Build.
+   */
+  DLL_PUBLIC void SetBatchSizeBuckets(std::vector<int> buckets) override {
+    DALI_ENFORCE(graph_ == nullptr,
+                 "Batch size buckets must be set before the executor is built.");
+    for (int bucket : buckets) {
+      DALI_ENFORCE(bucket > 0 && bucket <= max_batch_size_,
+                   make_string("The batch size buckets must be in the range [1, ",
+                               max_batch_size_, "], got ", bucket, "."));
+    }
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+    if (!buckets.empty() && buckets.back() != max_batch_size_)
+      buckets.push_back(max_batch_size_);
+    batch_size_buckets_ = std::move(buckets);
+  }
+
+  /**
+   * @brief Makes the GPU outputs of the pipeline use the memory obtained from `alloc`.
+   *
+   * The buffers handed out as the outputs are not reused - when the outputs are released,
+   * the executor drops its reference to the memory, so whoever took the memory over (e.g.
+   * a tensor of a framework) can keep it for as long as necessary. The next iteration gets
+   * new memory from `alloc`. An empty function restores the regular allocations.
+   * Can be called after Build, but not after the executor is run.
+   */
+  DLL_PUBLIC void SetOutputAllocator(OutputAllocFunc alloc) override {
+    output_alloc_ = std::move(alloc);
+    if (graph_)
+      SetupOutputAllocator();
+  }
+
+  /**
+   * @brief Makes the executor keep the states of the stateful operators (see
+   * OperatorBase::SaveState) after their runs, so that GetCheckpoint can return the state of
+   * the pipeline after the consumed iterations. Must be called before Build.
+   */
+  DLL_PUBLIC void EnableCheckpointing(bool enable = true) override {
+    DALI_ENFORCE(graph_ == nullptr, "Checkpointing must be set before the executor is built.");
+    checkpointing_ = enable;
+  }
+
+  /**
+   * @brief Returns the state of the pipeline after the iterations, whose outputs were consumed
+   *
+   * The operators which already ran ahead (prefetching) are not affected.
+   */
+  DLL_PUBLIC Checkpoint GetCheckpoint() override;
+
+  /**
+   * @brief Restores the states of the operators from a checkpoint.
+   * Must be called after Build and before the executor is run.
+   */
+  DLL_PUBLIC void RestoreCheckpoint(const Checkpoint &cpt) override;
+
   DLL_PUBLIC void ShutdownQueue() {
     QueuePolicy::SignalStop();
   }
@@ -143,11 +388,121 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
   DISABLE_COPY_MOVE_ASSIGN(Executor);
 
  protected:
+  /**
+   * @brief Creates the thread pool of the CPU stage, as selected by EnableSharedThreadPool and
+   * EnableWorkStealingThreadPool
+   */
+  void ResetThreadPool() {
+    DALI_ENFORCE(!(shared_thread_pool_ && work_stealing_thread_pool_),
+                 "The shared thread pool and the work-stealing thread pool can't be used "
+                 "together.");
+    if (shared_thread_pool_) {
+      thread_pool_ = std::make_unique<ThreadPool>(num_thread_, device_id_, set_affinity_,
+                                                  "Executor",
+                                                  ThreadPool::Shared{thread_pool_priority_});
+    } else if (work_stealing_thread_pool_) {
+      thread_pool_ = std::make_unique<ThreadPool>(num_thread_, device_id_, set_affinity_,
+                                                  "Executor", ThreadPool::WorkStealing{});
+    } else if (thread_pool_->IsShared() || thread_pool_->IsWorkStealing()) {
+      thread_pool_ = std::make_unique<ThreadPool>(num_thread_, device_id_, set_affinity_,
+                                                  "Executor");
+    }
+    thread_pool_->SetInlineSingleWork(low_latency_);
+  }
+
   DLL_PUBLIC void RunCPUImpl();
   DLL_PUBLIC void RunMixedImpl();
   DLL_PUBLIC void RunGPUImpl();
   DLL_PUBLIC void SyncDevice();
 
+  /**
+   * @brief Runs a single operator of given stage for the iteration described by `idxs`
+   *
+   * Errors are reported through HandleError, the call doesn't throw.
+   */
+  DLL_PUBLIC void RunCPUOp(OpNode &op_node, QueueIdxs idxs, int batch_size);
+  DLL_PUBLIC void RunMixedOp(OpNode &op_node, QueueIdxs idxs, int batch_size);
+  DLL_PUBLIC void RunGPUOp(OpNode &op_node, QueueIdxs idxs, int batch_size);
+
+  /**
+   * @brief Runs the chain of CPU operators starting at `first_op`, see SetupCPUChains, as one
+   * thread pool job per sample
+   *
+   * The chain ends early at an operator whose batch size differs from the previous ones.
+   * Errors are reported through HandleError, the call doesn't throw.
+   *
+   * @return the number of the operators run
+   */
+  int RunCPUChain(int first_op, QueueIdxs idxs, int batch_size);
+
+  /**
+   * @brief Sets the order of the outputs of `ws` to the order of the workspace
+   */
+  template <typename Workspace>
+  void SetOutputsOrder(Workspace &ws);
+
+  /**
+   * @brief The parts of running an operator, see RunHelper
+   *
+   * The GPU stage captured in a CUDA graph is set up before the capture starts, so that
+   * the capture contains only the work issued by the operators.
+   */
+  enum class OpRunSteps {
+    SetupAndRun,
+    SetupOnly,  ///< the work is captured or replayed later
+    RunOnly,    ///< the operator has already been set up
+  };
+
+  /**
+   * @brief Runs a single GPU operator; throws on error.
+   *
+   * @param wait_for_parents  if false, the caller has already made the stream wait for
+   *                          the events of the parent operators
+   * @param steps             the parts to run; the operator is retried when it runs out of
+   *                          device memory only when it's set up and run at once
+   * @param replay_layouts    if not null, the outputs of the operator set up with
+   *                          OpRunSteps::SetupOnly get these layouts, see RunHelper
+   */
+  void RunGPUOpImpl(OpNode &op_node, QueueIdxs idxs, int batch_size, bool wait_for_parents,
+                    OpRunSteps steps = OpRunSteps::SetupAndRun,
+                    const SmallVector<TensorLayout, 4> *replay_layouts = nullptr);
+
+  /**
+   * @brief Checks whether the next iteration of the mixed stage can start before the GPU work
+   * of the previous one is complete, see OpSchema::IterationOverlap
+   *
+   * The iterations must also write to different output buffers.
+   */
+  bool CanOverlapMixedIterations() const;
+
+  /**
+   * @brief Checks whether the GPU stage of the graph can be captured in a CUDA graph
+   */
+  bool CanCaptureGPUStage() const;
+
+  /**
+   * @brief Runs the GPU stage, replaying or capturing its CUDA graph when possible
+   *
+   * Errors are reported through HandleError, the call doesn't throw.
+   */
+  void RunGPUStageGraph(QueueIdxs idxs, int batch_size);
+
+  /**
+   * @brief Runs the GPU operators one by one
+   */
+  void RunGPUStageEager(QueueIdxs idxs, int batch_size);
+
+  /**
+   * @brief Calculates the types, shapes and addresses of the inputs and outputs
+   *        of the GPU operators
+   */
+  void GetGPUStageSignature(std::vector<intptr_t> &signature, QueueIdxs idxs);
+
+  /**
+   * @brief Gets the layouts of the outputs of the GPU operators
+   */
+  void GetGPUStageLayouts(std::vector<SmallVector<TensorLayout, 4>> &layouts, QueueIdxs idxs);
+
   template <typename T>
   inline void GetMaxSizesCont(T &in, size_t &max_out_size, size_t &max_reserved_size) {
     auto out_size = in.nbytes();
@@ -188,7 +543,7 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
   }
 
   template <typename W>
-  inline void FillStats(ExecutorMetaMap &memory_stats, W &ws, std::string op_name,
+  inline void FillStats(ExecutorMetaMap &memory_stats, W &ws, const std::string &op_name,
                         std::mutex &write_mutex) {
     if (enable_memory_stats_) {
         size_t out_size = 0;
@@ -252,6 +607,9 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
     }
     exec_error_ = true;
     ShutdownQueue();
+    // wake up the users waiting for the outputs - they get the error when trying to share them
+    if (callback_)
+      callback_();
   }
 
   void PruneUnusedGraphNodes() override;
@@ -262,14 +620,127 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
 
   std::vector<int> GetMemoryHints(const OpNode &node);
 
+  /**
+   * @brief Returns the per-sample sizes of the outputs of the operator from the memory profile;
+   * 0 if the profile has no entry for the output
+   */
+  std::vector<Index> GetProfiledSizes(const OpNode &node);
+
   void PrepinData(std::vector<tensor_data_store_queue_t> &tensor_to_store_queue,
                   const OpGraph &graph);
 
   void PresizeData(std::vector<tensor_data_store_queue_t> &tensor_to_store_queue,
                    const OpGraph &graph);
 
+  void SetupGrowableBuffers(std::vector<tensor_data_store_queue_t> &tensor_to_store_queue,
+                            const OpGraph &graph);
+
+  void SetupOutputAllocator();
+
+  /**
+   * @brief Frees the memory of the GPU outputs in the given queue slots and makes them
+   *        allocate new memory with the output allocator.
+   */
+  void DetachOutputs(OutputIdxs idxs);
+
+  /**
+   * @brief Clears the workspace receiving the outputs, keeping its stream
+   */
+  void ClearOutputWorkspace(DeviceWorkspace *ws);
+
+  /**
+   * @brief Fills the workspace with the outputs stored under idxs, which are in use by the user
+   */
+  void ShareOutputIdxs(DeviceWorkspace *ws, OutputIdxs idxs);
+
+  /**
+   * @brief Records the release of the outputs stored under idxs in the stream of their consumer
+   */
+  void RecordOutputRelease(OutputIdxs idxs, cudaStream_t consumer_stream);
+
+  /**
+   * @brief Makes the work of `stage` wait until the consumer of the outputs previously stored
+   *        in the buffers with given index is done with them
+   *
+   * The GPU stages wait in their streams; only the CPU stage, which writes its buffers on
+   * the host, has to block.
+   */
+  void WaitForOutputRelease(OpType stage, int queue_idx);
+
+  /**
+   * @brief Calls fn(output_idx, op_type, queue) for the outputs of the pipeline stored on GPU
+   */
+  template <typename Fn>
+  void ForEachGPUOutputQueue(Fn &&fn);
+
+  template <typename Backend>
+  void SetOutputAllocFunc(TensorList<Backend> &tensor, int output_idx, OpType op_type);
+
   void SetupOutputQueuesForGraph();
 
+  /**
+   * @brief Whether the operators of a stage run sequentially in the order of their
+   * partition indices, which is required to share the buffers between them
+   */
+  virtual bool SupportsBufferReuse() const {
+    return true;
+  }
+
+  /**
+   * @brief Assigns the shared buffers to the stage-local tensors, see PlanBufferReuse
+   */
+  void SetupBufferReuse(const std::vector<int> &queue_sizes);
+
+  /**
+   * @brief Finds the runs of consecutive CPU operators which can be run sample by sample
+   *
+   * An operator joins the chain of the previous one if both are marked with
+   * OpSchema::SampleChainable, neither has its outputs in the shared buffers (the tensors of
+   * a chain are alive at the same time) and its argument inputs are not produced in the chain
+   * (they're accessed for the whole batch).
+   */
+  void SetupCPUChains();
+
+  /**
+   * @brief Calls `fn` for the buffer with index `queue_idx` of every queued tensor
+   * produced by `stage`
+   */
+  template <typename Fn>
+  void ForEachQueuedBuffer(OpType stage, int queue_idx, Fn &&fn) {
+    for (int tid = 0; tid < graph_->NumTensor(); tid++) {
+      auto &tensor = graph_->Tensor(tid);
+      if (graph_->NodeType(tensor.producer.node) != stage)
+        continue;
+      VALUE_SWITCH(stage, stage_static, (OpType::CPU, OpType::MIXED, OpType::GPU),
+      (
+        VALUE_SWITCH(tensor.producer.storage_device, dev_static,
+            (StorageDevice::CPU, StorageDevice::GPU),
+        (
+          auto &queue = get_queue<stage_static, dev_static>(tensor_to_store_queue_[tid]);
+          if (queue.IsBuffered())
+            fn(queue[queue_idx]);
+        ), DALI_FAIL("Invalid storage device"));  // NOLINT(whitespace/parens)
+      ), DALI_FAIL("Invalid op type"));  // NOLINT(whitespace/parens)
+    }
+  }
+
+  /**
+   * @brief Returns the memory reserved by the queued buffers of `stage` with given index
+   */
+  size_t QueueSlotBytes(OpType stage, int queue_idx) {
+    size_t bytes = 0;
+    ForEachQueuedBuffer(stage, queue_idx, [&](auto &buffer) { bytes += buffer->capacity(); });
+    return bytes;
+  }
+
+  /**
+   * @brief Frees the memory of the queued buffers of `stage` with given index
+   */
+  void ReleaseQueueSlot(OpType stage, int queue_idx) {
+    DeviceGuard g(device_id_);
+    ForEachQueuedBuffer(stage, queue_idx, [](auto &buffer) { buffer->Reset(); });
+  }
+
   class EventList {
    public:
     inline EventList() = default;
@@ -291,12 +762,17 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
   };
   int max_batch_size_, device_id_;
   size_t bytes_per_sample_hint_;
+  // the priority of the CUDA streams of the executor
+  int default_cuda_stream_priority_;
 
   std::mutex cpu_memory_stats_mutex_;
   std::mutex mixed_memory_stats_mutex_;
   std::mutex gpu_memory_stats_mutex_;
 
   cudaEvent_t mixed_stage_event_ = {};
+  // the mixed stage event of the previous iteration, see CanOverlapMixedIterations
+  cudaEvent_t prev_mixed_stage_event_ = {};
+  bool mixed_iteration_overlap_ = false;
   cudaEvent_t gpu_stage_event_ = {};
 
   vector<string> output_names_;
@@ -337,13 +813,25 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
   OpGraph *graph_ = nullptr;
   ExecutorCallback callback_;
   EventPool event_pool_;
-  ThreadPool thread_pool_;
+  int num_thread_;
+  bool set_affinity_;
+  std::unique_ptr<ThreadPool> thread_pool_;
+  bool shared_thread_pool_ = false;
+  int thread_pool_priority_ = 0;
+  bool work_stealing_thread_pool_ = false;
+  bool low_latency_ = false;
+  bool sample_chaining_ = false;
+  // CPU op index -> the number of the operators run sample by sample from it, see SetupCPUChains
+  std::vector<int> cpu_chain_len_;
   std::vector<std::string> errors_;
   mutable std::mutex errors_mutex_;
   bool exec_error_;
   QueueSizes queue_sizes_;
   std::vector<tensor_data_store_queue_t> tensor_to_store_queue_;
   CUDAStreamLease mixed_op_stream_, gpu_op_stream_;
+  // The device memory for the scratchpads of the operators of the mixed and GPU stage;
+  // declared after the streams, because it's released in their order
+  std::unique_ptr<kernels::ScratchArena> mixed_scratch_arena_, gpu_scratch_arena_;
   // MixedOpId -> queue_idx -> cudaEvent_t
   // To introduce dependency from MIXED to GPU Ops
   MixedOpEventMap mixed_op_events_;
@@ -354,6 +842,183 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
 
   std::atomic<bool> enable_memory_stats_;
   ExecutorMetaMap cpu_memory_stats_, mixed_memory_stats_, gpu_memory_stats_;
+  std::atomic<bool> enable_operator_timing_{false};
+  TimingCollector timing_;
+  ExecutorMetaMap memory_profile_;
+  std::shared_ptr<mm::device_quota_resource> device_quota_;
+  bool growable_buffers_ = false;
+  OutputAllocFunc output_alloc_;
+
+  bool checkpointing_ = false;
+  CheckpointRecorder checkpoints_;
+
+  /**
+   * @brief Records the state of the operator after a run, if checkpointing is enabled
+   */
+  void RecordOpState(OpNode &op_node) {
+    if (checkpointing_)
+      checkpoints_.RecordRun(op_node.id, op_node.spec.name(), op_node.op->SaveState());
+  }
+
+  bool cuda_graphs_ = false;
+  // the GPU stage meets the requirements of the capture; set in Build
+  bool gpu_stage_capturable_ = false;
+  // the number of runs with the same signature, after which the GPU stage is captured
+  static constexpr int kCudaGraphWarmupRuns = 2;
+  /**
+   * @brief The GPU stage captured in a CUDA graph for a pair of mixed and GPU queue slots
+   */
+  struct GPUStageGraph {
+    GPUStageGraph() = default;
+    GPUStageGraph(const GPUStageGraph &) = delete;
+    GPUStageGraph &operator=(const GPUStageGraph &) = delete;
+    ~GPUStageGraph() {
+      Reset();
+    }
+
+    /**
+     * @brief Destroys the graph and frees its scratch memory; the graph must not be in flight
+     */
+    void Reset() {
+      if (exec) {
+        CUDA_DTOR_CALL(cudaGraphExecDestroy(exec));
+        exec = nullptr;
+      }
+      scratch.clear();
+    }
+
+    cudaGraphExec_t exec = nullptr;
+    // the scratch memory used by the captured work
+    kernels::ScratchCapture scratch;
+    // the signature of the stage (see GetGPUStageSignature) in the last run
+    std::vector<intptr_t> signature;
+    // the output layouts of the operators, which are set when they run
+    std::vector<SmallVector<TensorLayout, 4>> layouts;
+    // the number of consecutive runs with the same signature
+    int stable_runs = 0;
+  };
+  // (mixed queue idx, gpu queue idx, batch size bucket or 0) -> graph
+  std::map<std::tuple<int, int, int>, GPUStageGraph> gpu_stage_graphs_;
+  // the signature of the current iteration of the GPU stage; kept to reuse the storage
+  std::vector<intptr_t> gpu_stage_signature_;
+  // sorted; empty if not set
+  std::vector<int> batch_size_buckets_;
+  // the queue slots of the outputs shared with the user, when the output allocator is used
+  std::queue<OutputIdxs> shared_output_idxs_;
+  struct OutputConsumer {
+    OutputIdxs idxs;
+    AccessOrder order;
+  };
+  // the outputs shared with the user and the order in which the user waits for them
+  std::queue<OutputConsumer> output_consumers_;
+  std::mutex shared_outputs_mutex_;
+  // stage -> queue_idx -> the event recorded in the consumer's stream when the outputs
+  // are released; the stage which reuses the buffers waits for it instead of the host
+  std::array<EventList, static_cast<int>(OpType::COUNT)> release_events_;
+  // stage -> queue_idx -> whether the event above was recorded since the buffers were last used;
+  // accessed by the thread which owns the queue slot
+  std::array<std::vector<uint8_t>, static_cast<int>(OpType::COUNT)> release_pending_;
+
+  bool adaptive_queue_depth_ = false;
+  AdaptiveQueueDepthParams adaptive_queue_params_;
+  // the depths the adaptive queues start with
+  StageQueues initial_queue_depths_;
+
+  bool buffer_reuse_ = true;
+  /**
+   * @brief The state of the operator, whose outputs use the buffers shared with other tensors
+   */
+  struct NodeBufferReuse {
+    // output 0 is computed in place of the input 0, when possible
+    bool in_place = false;
+    // output 0 shared the input's data in the last iteration
+    bool ran_in_place = false;
+    // outputs stored in the buffers shared with other tensors
+    SmallVector<int, 4> shared_outputs;
+    // the layouts of the outputs set by the operator in the last iteration;
+    // the shared buffers may contain the layout of another tensor
+    SmallVector<TensorLayout, 4> layouts;
+    // the index in joined_inputs_ of the operator's inputs, if it concatenates them...
+    int joins = -1;
+    // ...or of the consumer concatenating its output `joined_output` as the input `joined_input`
+    int joined = -1, joined_output = -1, joined_input = -1;
+  };
+  // OpNodeId -> buffer reuse state; empty if no buffers are shared
+  std::vector<NodeBufferReuse> buffer_reuse_state_;
+
+  /**
+   * @brief The inputs of an operator concatenating them, which the producers write directly
+   * into its output, see BufferReusePlan::joins
+   *
+   * The final shape of the output is known only when all the inputs are computed, so the inputs
+   * are placed in the output according to their shapes in the previous iteration. If their
+   * shapes change, the consumer gets a new output buffer and copies the inputs as usual.
+   */
+  struct JoinedInputs {
+    OpNodeId consumer = -1;
+    // the output of the consumer in the current iteration
+    TensorList<GPUBackend> *output = nullptr;
+    // the type and the shapes of the inputs in the previous iteration
+    DALIDataType type = DALI_NO_TYPE;
+    std::vector<TensorListShape<>> shapes;
+    // the volumes of the output samples and the offsets of the input samples in the output
+    std::vector<Index> sample_volumes;
+    std::vector<std::vector<Index>> offsets;
+    // which inputs are placed in the output in the current iteration
+    std::vector<bool> placed;
+    // the input whose producer runs first
+    int first_input = 0;
+  };
+  std::vector<JoinedInputs> joined_inputs_;
+
+  /**
+   * @brief Sets the output of the consumer concatenating the inputs for the current iteration
+   */
+  void SetJoinedOutput(const OpNode &node, QueueIdxs idxs);
+
+  /**
+   * @brief Places the output of the producer in the output of the consumer concatenating it,
+   * if its shape is the same as in the previous iteration
+   *
+   * @return true if the output is placed and must not be resized
+   */
+  bool PlaceJoinedInput(const NodeBufferReuse &reuse, DeviceWorkspace &ws,
+                        const std::vector<OutputDesc> &output_desc);
+
+  /**
+   * @brief Checks if the inputs placed in the output of the consumer make up the whole output;
+   * otherwise the consumer gets a new output buffer.
+   */
+  void FinishJoinedInputs(const NodeBufferReuse &reuse, DeviceWorkspace &ws,
+                          const std::vector<OutputDesc> &output_desc);
+
+  /**
+   * @brief The names of an operator used in each iteration - built once, so that running
+   *        the operator doesn't allocate them
+   */
+  struct NodeNames {
+    // the key of the operator in the timing and the memory statistics, see ExecutorMetaKey
+    std::string meta_key;
+    // the name of the NVTX range of the operator's run
+    std::string range_name;
+    // the names of the ranges of the operator's Setup and Run, within range_name
+    std::string setup_range_name, run_range_name;
+  };
+  // OpNodeId -> names
+  std::vector<NodeNames> node_names_;
+
+  void SetupNodeNames();
+
+  template <typename Fn>
+  static void ForEachReusedOutput(const NodeBufferReuse &state, Fn &&fn) {
+    bool output0_shared = false;
+    for (int i : state.shared_outputs) {
+      fn(i);
+      output0_shared = output0_shared || i == 0;
+    }
+    if (state.in_place && !output0_shared)
+      fn(0);
+  }
 
 
   /// Graph nodes, which define batch size for the entire graph
@@ -361,9 +1026,45 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
 
   WorkspacePolicy ws_policy_;
 
+  int InferBatchSize(const std::vector<BatchSizeProvider *> &batch_size_providers) const;
+
  private:
+  /**
+   * @brief Sets up and runs the operator, or only does one of these, see OpRunSteps
+   *
+   * If `replay_layouts` is not null, the outputs of the operator which is only set up get
+   * the given layouts - its work is replayed from a CUDA graph.
+   */
   template <typename Workspace>
-  void RunHelper(OpNode &op_node, Workspace &ws);
+  void RunHelper(OpNode &op_node, Workspace &ws, OpRunSteps steps = OpRunSteps::SetupAndRun,
+                 const SmallVector<TensorLayout, 4> *replay_layouts = nullptr);
+
+  /**
+   * @brief Sets up the operator and resizes its outputs; a part of RunHelper
+   */
+  template <typename Workspace>
+  void SetupHelper(OpNode &op_node, Workspace &ws);
+
+  /**
+   * @brief Runs the operator; if it runs out of device memory, releases the memory cached
+   *        by the stage and runs the operator again.
+   *
+   * If that fails too, an operator which allows it is run on smaller parts of the batch.
+   */
+  template <typename Workspace>
+  void RunHelperRetryOnOOM(OpNode &op_node, Workspace &ws, kernels::ScratchArena *arena);
+
+  /**
+   * @brief Tells whether the operator can be run on parts of the batch, see
+   *        OpSchema::BatchSplittable
+   */
+  bool CanRunInSubBatches(const OpNode &op_node, const DeviceWorkspace &ws) const;
+
+  /**
+   * @brief Sets up the operator for the whole batch and runs it on the consecutive sub-batches,
+   *        halving them whenever it runs out of device memory.
+   */
+  void RunInSubBatches(OpNode &op_node, DeviceWorkspace &ws, kernels::ScratchArena *arena);
 
   void RethrowError() const {
     std::lock_guard<std::mutex> errors_lock(errors_mutex_);
@@ -383,12 +1084,12 @@ class DLL_PUBLIC Executor : public ExecutorBase, public QueuePolicy {
     for (Index i = 0; i < graph_->NumOp(); i++) {
       auto bsp = dynamic_cast<BatchSizeProvider *>(graph_->Node(i).op.get());
       if (!bsp) continue;
+      if (!batch_size_buckets_.empty())
+        bsp->SetBatchSizeBuckets(batch_size_buckets_);
       batch_size_providers_.emplace_back(bsp);
     }
   }
 
-  int InferBatchSize(const std::vector<BatchSizeProvider *> &batch_size_providers) const;
-
   void PreRun();
 };
 
@@ -404,6 +1105,31 @@ void Executor<WorkspacePolicy, QueuePolicy>::SetCompletionCallback(ExecutorCallb
   }
 }
 
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::EnableAdaptiveQueueDepth(
+    const AdaptiveQueueDepthParams &params) {
+  DALI_ENFORCE(QueuePolicy::kSupportsAdaptiveDepth,
+               "Adaptive prefetch queue depth requires separated queues.");
+  DALI_ENFORCE(graph_ == nullptr,
+               "Adaptive prefetch queue depth must be enabled before the executor is built.");
+  DALI_ENFORCE(params.max_sizes.cpu_size >= queue_sizes_.cpu_size &&
+               params.max_sizes.gpu_size >= queue_sizes_.gpu_size,
+               make_string("The maximum prefetch queue depth {", params.max_sizes.cpu_size, ", ",
+                           params.max_sizes.gpu_size, "} cannot be lower than the initial one {",
+                           queue_sizes_.cpu_size, ", ", queue_sizes_.gpu_size, "}."));
+  DALI_ENFORCE(params.window > 0, "The adaptation window must be positive.");
+  adaptive_queue_depth_ = true;
+  adaptive_queue_params_ = params;
+  initial_queue_depths_ = stage_queue_depths_;
+  queue_sizes_ = params.max_sizes;
+  stage_queue_depths_ = QueuePolicy::GetQueueSizes(queue_sizes_);
+  // The callback events are indexed with the mixed queue index
+  if (!mixed_callback_events_.empty()) {
+    while (static_cast<int>(mixed_callback_events_.size()) < stage_queue_depths_[OpType::MIXED])
+      mixed_callback_events_.push_back(event_pool_.GetEvent());
+  }
+}
+
 template <typename WorkspacePolicy, typename QueuePolicy>
 ExecutorMetaMap Executor<WorkspacePolicy, QueuePolicy>::GetExecutorMeta() {
   ExecutorMetaMap ret;
@@ -413,6 +1139,19 @@ ExecutorMetaMap Executor<WorkspacePolicy, QueuePolicy>::GetExecutorMeta() {
   return ret;
 }
 
+template <typename WorkspacePolicy, typename QueuePolicy>
+ExecutorTiming Executor<WorkspacePolicy, QueuePolicy>::GetOperatorTiming() {
+  DeviceGuard g(device_id_);
+  auto timing = timing_.GetTiming();
+  auto waits = QueuePolicy::GetWaitTiming();
+  for (int i = 0; i < static_cast<int>(OpType::COUNT); i++) {
+    timing.stages[i].producer_wait = waits[i].producer_wait;
+    timing.stages[i].consumer_wait = waits[i].consumer_wait;
+  }
+  timing.bottleneck = ComputeBottleneck(timing);
+  return timing;
+}
+
 template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::Build(OpGraph *graph, vector<string> output_names) {
   DALI_ENFORCE(graph != nullptr, "Input graph is nullptr.");
@@ -423,6 +1162,7 @@ void Executor<WorkspacePolicy, QueuePolicy>::Build(OpGraph *graph, vector<string
   graph_ = graph;
 
   DeviceGuard g(device_id_);
+  DeviceMemoryQuotaScope quota_scope(device_quota_.get(), device_id_);
 
   // Remove any node from the graph whose output
   // will not be used as an output or by another node
@@ -430,6 +1170,9 @@ void Executor<WorkspacePolicy, QueuePolicy>::Build(OpGraph *graph, vector<string
 
   // Check if graph is ok for execution
   CheckGraphConstraints(*graph_);
+  SetupNodeNames();
+  if (checkpointing_)
+    checkpoints_.Reset(graph_->NumOp());
   // Clear the old data
   tensor_to_store_queue_.clear();
 
@@ -441,21 +1184,41 @@ void Executor<WorkspacePolicy, QueuePolicy>::Build(OpGraph *graph, vector<string
   // Create corresponding storage type for TensorNodes in graph
   tensor_to_store_queue_ =
       CreateBackingStorageForTensorNodes(*graph_, max_batch_size_, queue_sizes);
+  // Let the stage-local tensors share the storage
+  SetupBufferReuse(queue_sizes);
+  SetupCPUChains();
   // Setup stream and events that will be used for execution
   if (device_id_ != CPU_ONLY_DEVICE_ID) {
     DeviceGuard g(device_id_);
-    mixed_op_stream_ = CUDAStreamPool::instance().Get(device_id_);
-    gpu_op_stream_ = CUDAStreamPool::instance().Get(device_id_);
+    mixed_op_stream_ = CUDAStreamPool::instance().Get(device_id_, default_cuda_stream_priority_);
+    gpu_op_stream_ = CUDAStreamPool::instance().Get(device_id_, default_cuda_stream_priority_);
+    mixed_scratch_arena_ = std::make_unique<kernels::ScratchArena>(
+        AccessOrder(mixed_op_stream_), device_quota_.get());
+    gpu_scratch_arena_ = std::make_unique<kernels::ScratchArena>(
+        AccessOrder(gpu_op_stream_), device_quota_.get());
     mixed_op_events_ =
         CreateEventsForMixedOps(event_pool_, *graph_, stage_queue_depths_[OpType::MIXED]);
 
     // Create events used to synchronize stages using gpu with themselves
     mixed_stage_event_ = event_pool_.GetEvent();
+    prev_mixed_stage_event_ = event_pool_.GetEvent();
     gpu_stage_event_ = event_pool_.GetEvent();
+    mixed_iteration_overlap_ = CanOverlapMixedIterations();
+
+    for (int stage = 0; stage < static_cast<int>(OpType::COUNT); stage++) {
+      int depth = stage_queue_depths_[static_cast<OpType>(stage)];
+      release_events_[stage] = EventList(depth, &event_pool_);
+      release_pending_[stage].assign(depth, false);
+    }
   }
 
   PrepinData(tensor_to_store_queue_, *graph_);
 
+  if (output_alloc_)
+    SetupOutputAllocator();
+
+  SetupGrowableBuffers(tensor_to_store_queue_, *graph_);
+
   // Presize the workspaces based on the hint
   PresizeData(tensor_to_store_queue_, *graph_);
 
@@ -465,7 +1228,7 @@ void Executor<WorkspacePolicy, QueuePolicy>::Build(OpGraph *graph, vector<string
   // workspaces so that nothing has to be altered
   // during execution (this is necessary for
   // asynchronous executors that can overlap work issue)
-  ws_policy_.InitializeWorkspaceStore(*graph_, tensor_to_store_queue_, &thread_pool_,
+  ws_policy_.InitializeWorkspaceStore(*graph_, tensor_to_store_queue_, thread_pool_.get(),
                                       mixed_op_stream_, gpu_op_stream_, mixed_op_events_,
                                       queue_sizes_);
 
@@ -473,25 +1236,220 @@ void Executor<WorkspacePolicy, QueuePolicy>::Build(OpGraph *graph, vector<string
   SetupOutputQueuesForGraph();
 
   DiscoverBatchSizeProviders();
+
+  gpu_stage_graphs_.clear();
+  gpu_stage_capturable_ = cuda_graphs_ && CanCaptureGPUStage();
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::SetupNodeNames() {
+  node_names_.clear();
+  node_names_.resize(graph_->NumOp());
+  for (int i = 0; i < graph_->NumOp(); i++) {
+    auto &node = graph_->Node(i);
+    auto &names = node_names_[i];
+    names.meta_key = ExecutorMetaKey(node.op_type, node.instance_name);
+    const char *kind = node.op_type == OpType::CPU ? "CPU" :
+                       node.op_type == OpType::MIXED ? "Mixed" : "GPU";
+    names.range_name = make_string("[DALI][", kind, " op] ", node.instance_name);
+    names.setup_range_name = names.range_name + " Setup";
+    names.run_range_name = names.range_name + " Run";
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::SetupBufferReuse(
+    const std::vector<int> &queue_sizes) {
+  buffer_reuse_state_.clear();
+  joined_inputs_.clear();
+  if (!buffer_reuse_ || !SupportsBufferReuse())
+    return;
+  // The buffered tensors are handed over to other stages or the user, so they are kept
+  auto preserved = graph_->GetOutputs(output_names_, true);
+  for (int tid = 0; tid < graph_->NumTensor(); tid++) {
+    if (queue_sizes[tid] != 1)
+      preserved.push_back(tid);
+  }
+  auto plan = PlanBufferReuse(*graph_, preserved);
+  if (plan.NumBuffers() == graph_->NumTensor() && plan.joins.empty() &&
+      std::none_of(plan.in_place.begin(), plan.in_place.end(), [](bool b) { return b; }))
+    return;
+  ShareBackingStorage(tensor_to_store_queue_, plan);
+
+  buffer_reuse_state_.resize(graph_->NumOp());
+  for (int op_id = 0; op_id < graph_->NumOp(); op_id++) {
+    auto &node = graph_->Node(op_id);
+    auto &state = buffer_reuse_state_[op_id];
+    state.in_place = plan.in_place[op_id];
+    for (size_t i = 0; i < node.children_tensors.size(); i++) {
+      if (plan.IsShared(node.children_tensors[i]))
+        state.shared_outputs.push_back(i);
+    }
+    state.layouts.resize(node.children_tensors.size());
+  }
+  for (auto &join : plan.joins) {
+    int idx = joined_inputs_.size();
+    joined_inputs_.emplace_back();
+    auto &joined = joined_inputs_.back();
+    joined.consumer = join.consumer;
+    joined.placed.resize(join.producers.size(), false);
+    buffer_reuse_state_[join.consumer].joins = idx;
+    for (size_t i = 0; i < join.producers.size(); i++) {
+      auto &producer = graph_->Node(join.producers[i].first);
+      auto &state = buffer_reuse_state_[producer.id];
+      state.joined = idx;
+      state.joined_output = join.producers[i].second;
+      state.joined_input = i;
+      auto &first = graph_->Node(join.producers[joined.first_input].first);
+      if (producer.partition_index < first.partition_index)
+        joined.first_input = i;
+    }
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::SetupCPUChains() {
+  cpu_chain_len_.clear();
+  if (!sample_chaining_ || !SupportsBufferReuse())
+    return;
+  int num_cpu = graph_->NumOp(OpType::CPU);
+  auto chainable = [&](const OpNode &node) {
+    const auto &schema = node.spec.GetSchema();
+    if (!schema.IsSampleChainable() || schema.IsNonUniformBatch() ||
+        !dynamic_cast<Operator<CPUBackend> *>(node.op.get()))
+      return false;
+    if (buffer_reuse_state_.empty())
+      return true;
+    const auto &reuse = buffer_reuse_state_[node.id];
+    return reuse.shared_outputs.empty() && !reuse.in_place && reuse.joins < 0 && reuse.joined < 0;
+  };
+  std::vector<bool> can_chain(num_cpu);
+  for (int i = 0; i < num_cpu; i++)
+    can_chain[i] = chainable(graph_->Node(OpType::CPU, i));
+
+  cpu_chain_len_.resize(num_cpu, 1);
+  for (int first = 0; first < num_cpu;) {
+    int end = first + 1;
+    if (can_chain[first]) {
+      std::set<OpNodeId> in_chain = { graph_->Node(OpType::CPU, first).id };
+      for (; end < num_cpu && can_chain[end]; end++) {
+        auto &node = graph_->Node(OpType::CPU, end);
+        bool args_ready = true;
+        for (size_t i = node.spec.NumRegularInput(); i < node.parent_tensors.size(); i++) {
+          if (in_chain.count(graph_->Tensor(node.parent_tensors[i]).producer.node))
+            args_ready = false;
+        }
+        if (!args_ready)
+          break;
+        in_chain.insert(node.id);
+      }
+    }
+    cpu_chain_len_[first] = end - first;
+    first = end;
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::SetJoinedOutput(const OpNode &node, QueueIdxs idxs) {
+  if (buffer_reuse_state_.empty())
+    return;
+  const auto &state = buffer_reuse_state_[node.id];
+  int idx = state.joins >= 0 ? state.joins : state.joined;
+  if (idx < 0)
+    return;
+  auto &joined = joined_inputs_[idx];
+  auto tid = graph_->Node(joined.consumer).children_tensors[0];
+  auto &queue = get_queue<OpType::GPU, StorageDevice::GPU>(tensor_to_store_queue_[tid]);
+  joined.output = queue[idxs[OpType::GPU]].get();
 }
 
 
 template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::ReleaseOutputs() {
+  {
+    // the outputs can be released by other threads than the one sharing them
+    std::lock_guard<std::mutex> lock(shared_outputs_mutex_);
+    if (!shared_output_idxs_.empty()) {
+      // The memory may still be used by the user - it must not be overwritten by the next
+      // iterations
+      DetachOutputs(shared_output_idxs_.front());
+      shared_output_idxs_.pop();
+    }
+    if (!output_consumers_.empty()) {
+      auto &consumer = output_consumers_.front();
+      // the work issued by the user to the stream may still read the outputs - the stages
+      // reusing the buffers wait for it without blocking the host
+      if (consumer.order.is_device())
+        RecordOutputRelease(consumer.idxs, consumer.order.stream());
+      output_consumers_.pop();
+    }
+  }
   QueuePolicy::ReleaseOutputIdxs();
 }
 
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RecordOutputRelease(OutputIdxs idxs,
+                                                                 cudaStream_t consumer_stream) {
+  if (device_id_ == CPU_ONLY_DEVICE_ID)
+    return;
+  DeviceGuard g(device_id_);
+  for (int stage = 0; stage < static_cast<int>(OpType::COUNT); stage++) {
+    if (release_events_[stage].empty())
+      continue;
+    int queue_idx = idxs[static_cast<OpType>(stage)];
+    CUDA_CALL(cudaEventRecord(release_events_[stage].GetEvent(queue_idx), consumer_stream));
+    release_pending_[stage][queue_idx] = true;
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::WaitForOutputRelease(OpType stage, int queue_idx) {
+  auto &pending = release_pending_[static_cast<int>(stage)];
+  if (pending.empty() || !pending[queue_idx])
+    return;
+  pending[queue_idx] = false;
+  cudaEvent_t event = release_events_[static_cast<int>(stage)].GetEvent(queue_idx);
+  if (stage == OpType::CPU) {
+    CUDA_CALL(cudaEventSynchronize(event));
+  } else {
+    cudaStream_t stream = stage == OpType::MIXED ? mixed_op_stream_ : gpu_op_stream_;
+    CUDA_CALL(cudaStreamWaitEvent(stream, event, 0));
+  }
+}
+
 template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::Outputs(DeviceWorkspace *ws) {
   ReleaseOutputs();
   ShareOutputs(ws);
 }
 
+template <typename WorkspacePolicy, typename QueuePolicy>
+Checkpoint Executor<WorkspacePolicy, QueuePolicy>::GetCheckpoint() {
+  DALI_ENFORCE(checkpointing_, "Checkpointing is not enabled.");
+  return checkpoints_.GetCheckpoint();
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RestoreCheckpoint(const Checkpoint &cpt) {
+  DALI_ENFORCE(checkpointing_, "Checkpointing is not enabled.");
+  DALI_ENFORCE(graph_ != nullptr, "The executor must be built before restoring a checkpoint.");
+  checkpoints_.Reset(graph_->NumOp(), cpt.iteration);
+  for (auto &op : cpt.operators) {
+    DALI_ENFORCE(op.operator_id >= 0 && op.operator_id < graph_->NumOp() &&
+                 graph_->Node(op.operator_id).spec.name() == op.operator_name,
+                 make_string("The checkpoint doesn't match the pipeline: the operator ",
+                             op.operator_id, " is not \"", op.operator_name, "\"."));
+    auto &node = graph_->Node(op.operator_id);
+    node.op->RestoreState(op.state);
+    checkpoints_.RecordRestoredState(op.operator_id, op.operator_name, op.state);
+  }
+}
+
 template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::ShareOutputs(DeviceWorkspace *ws) {
   DALI_ENFORCE(ws != nullptr, "Workspace is nullptr");
   DeviceGuard g(device_id_);
-  ws->Clear();
+  ClearOutputWorkspace(ws);
 
   if (exec_error_ || QueuePolicy::IsStopSignaled())
     RethrowError();
@@ -501,6 +1459,69 @@ void Executor<WorkspacePolicy, QueuePolicy>::ShareOutputs(DeviceWorkspace *ws) {
   if (exec_error_ || QueuePolicy::IsStopSignaled())
     RethrowError();
 
+  ShareOutputIdxs(ws, output_idx);
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+bool Executor<WorkspacePolicy, QueuePolicy>::TryShareOutputs(DeviceWorkspace *ws) {
+  DALI_ENFORCE(ws != nullptr, "Workspace is nullptr");
+  DeviceGuard g(device_id_);
+
+  if (exec_error_ || QueuePolicy::IsStopSignaled())
+    RethrowError();
+
+  auto is_complete = [](cudaEvent_t event) {
+    auto status = cudaEventQuery(event);
+    if (status == cudaErrorNotReady)
+      return false;
+    CUDA_CALL(status);
+    return true;
+  };
+  OutputIdxs output_idx{QueuePolicy::kInvalidIdx};
+  bool ready = QueuePolicy::TryUseOutputIdxs(output_idx, [&](const OutputIdxs &idxs) {
+    return (mixed_output_events_.empty() ||
+            is_complete(mixed_output_events_.GetEvent(idxs[OpType::MIXED]))) &&
+           (gpu_output_events_.empty() ||
+            is_complete(gpu_output_events_.GetEvent(idxs[OpType::GPU])));
+  });
+
+  if (exec_error_ || QueuePolicy::IsStopSignaled())
+    RethrowError();
+  if (!ready)
+    return false;
+
+  ClearOutputWorkspace(ws);
+  ShareOutputIdxs(ws, output_idx);
+  return true;
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::ClearOutputWorkspace(DeviceWorkspace *ws) {
+  // the stream in which the caller consumes the outputs is kept
+  bool has_stream = ws->has_stream();
+  cudaStream_t stream = has_stream ? ws->stream() : 0;
+  ws->Clear();
+  if (has_stream)
+    ws->set_stream(stream);
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::ShareOutputIdxs(DeviceWorkspace *ws,
+                                                             OutputIdxs output_idx) {
+  if (enable_operator_timing_)
+    timing_.ConsumeStageOutput(OpType::GPU);
+  if (checkpointing_)
+    checkpoints_.ConsumeIteration();
+
+  AccessOrder sync_order = ws->has_stream() ? AccessOrder(ws->stream()) : AccessOrder::host();
+
+  {
+    std::lock_guard<std::mutex> lock(shared_outputs_mutex_);
+    if (output_alloc_)
+      shared_output_idxs_.push(output_idx);
+    output_consumers_.push({ output_idx, sync_order });
+  }
+
   // We need to fill the output workspace with pointers to appropriate output buffers.
   for (size_t i = 0; i < pipeline_outputs_.size(); i++) {
     auto out_tensor_id = pipeline_outputs_[i];
@@ -521,9 +1542,6 @@ void Executor<WorkspacePolicy, QueuePolicy>::ShareOutputs(DeviceWorkspace *ws) {
   // We than need to wait for GPU outputs from Mixed & GPU stages that are computed asynchronously.
   // If the output event list is not empty, it means that there are outputs on GPU that we
   // have to wait for.
-
-  AccessOrder sync_order = ws->has_stream() ? AccessOrder(ws->stream()) : AccessOrder::host();
-
   if (!mixed_output_events_.empty()) {
     auto queue_idx = output_idx[OpType::MIXED];
     sync_order.wait(mixed_output_events_.GetEvent(queue_idx));
@@ -671,6 +1689,81 @@ void Executor<WorkspacePolicy, QueuePolicy>::PrepinData(
   }
 }
 
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::SetupGrowableBuffers(
+    std::vector<tensor_data_store_queue_t> &tensor_to_store_queue, const OpGraph &graph) {
+  if (!growable_buffers_ || device_id_ == CPU_ONLY_DEVICE_ID)
+    return;
+  if (!GrowableBuffersSupported()) {
+    DALI_WARN_ONCE("Growable buffers are not supported on this machine - "
+                   "using regular allocations.");
+    return;
+  }
+  auto set_growable = [&](auto op_type_tag, const OpNode &node) {
+    constexpr OpType op_type = decltype(op_type_tag)::value;
+    for (auto tid : node.children_tensors) {
+      if (graph.Tensor(tid).producer.storage_device != StorageDevice::GPU)
+        continue;
+      for (auto &tensor : get_queue<op_type, StorageDevice::GPU>(tensor_to_store_queue[tid])) {
+        // the buffers shared with other tensors may use a custom allocator
+        if (!tensor->has_data() && !tensor->alloc_func())
+          tensor->set_growable(true);
+      }
+    }
+  };
+  for (int i = 0; i < graph.NumOp(OpType::MIXED); i++)
+    set_growable(std::integral_constant<OpType, OpType::MIXED>(), graph.Node(OpType::MIXED, i));
+  for (int i = 0; i < graph.NumOp(OpType::GPU); i++)
+    set_growable(std::integral_constant<OpType, OpType::GPU>(), graph.Node(OpType::GPU, i));
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+template <typename Fn>
+void Executor<WorkspacePolicy, QueuePolicy>::ForEachGPUOutputQueue(Fn &&fn) {
+  for (int i = 0; i < static_cast<int>(pipeline_outputs_.size()); i++) {
+    auto tid = pipeline_outputs_[i];
+    auto &out_tensor = graph_->Tensor(tid);
+    if (out_tensor.producer.storage_device != StorageDevice::GPU)
+      continue;
+    auto op_type = graph_->Node(out_tensor.producer.node).op_type;
+    if (op_type == OpType::MIXED)
+      fn(i, op_type, get_queue<OpType::MIXED, StorageDevice::GPU>(tensor_to_store_queue_[tid]));
+    else if (op_type == OpType::GPU)
+      fn(i, op_type, get_queue<OpType::GPU, StorageDevice::GPU>(tensor_to_store_queue_[tid]));
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+template <typename Backend>
+void Executor<WorkspacePolicy, QueuePolicy>::SetOutputAllocFunc(TensorList<Backend> &tensor,
+                                                                int output_idx, OpType op_type) {
+  // also drops the allocation function
+  tensor.Reset();
+  if (output_alloc_) {
+    cudaStream_t stream = op_type == OpType::MIXED ? mixed_op_stream_ : gpu_op_stream_;
+    tensor.set_alloc_func([this, output_idx, stream](size_t bytes) {
+      return output_alloc_(output_idx, bytes, stream);
+    });
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::SetupOutputAllocator() {
+  if (device_id_ == CPU_ONLY_DEVICE_ID)
+    return;
+  ForEachGPUOutputQueue([&](int output_idx, OpType op_type, auto &queue) {
+    for (auto &tensor : queue)
+      SetOutputAllocFunc(*tensor, output_idx, op_type);
+  });
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::DetachOutputs(OutputIdxs idxs) {
+  ForEachGPUOutputQueue([&](int output_idx, OpType op_type, auto &queue) {
+    SetOutputAllocFunc(*queue[idxs[op_type]], output_idx, op_type);
+  });
+}
+
 // We apply hints to all of pinned CPU buffers and all GPU buffers
 template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::PresizeData(
@@ -699,6 +1792,9 @@ void Executor<WorkspacePolicy, QueuePolicy>::PresizeData(
   for (int i = 0; i < graph.NumOp(); i++) {
     auto &node = graph.Node(i);
     auto hints = GetMemoryHints(node);
+    // The profile covers all the buffers, the sizes observed in a previous run are reserved
+    // in one go, regardless of the memory kind
+    auto profile = GetProfiledSizes(node);
     VALUE_SWITCH(node.op_type, op_type_static,
         (OpType::CPU, OpType::MIXED, OpType::GPU),
     (
@@ -714,6 +1810,9 @@ void Executor<WorkspacePolicy, QueuePolicy>::PresizeData(
             if (should_reserve(storage, hint, dev_static)) {
               reserve_batch(storage, *node.op, hint, max_batch_size_);
             }
+            if (profile[j] > 0) {
+              reserve_batch(storage, *node.op, profile[j], max_batch_size_);
+            }
             if (node.op->CanInferOutputs()) {
               storage->SetContiguous(true);
             }
@@ -732,9 +1831,28 @@ std::vector<int> Executor<WorkspacePolicy, QueuePolicy>::GetMemoryHints(const Op
   return hints;
 }
 
+template <typename WorkspacePolicy, typename QueuePolicy>
+std::vector<Index> Executor<WorkspacePolicy, QueuePolicy>::GetProfiledSizes(const OpNode &node) {
+  std::vector<Index> sizes(node.children_tensors.size(), 0);
+  auto it = memory_profile_.find(ExecutorMetaKey(node.op_type, node.instance_name));
+  if (it == memory_profile_.end())
+    return sizes;
+  // The per-sample sizes don't depend on the batch size, which might differ from the one
+  // used when the profile was recorded
+  for (size_t i = 0; i < sizes.size() && i < it->second.size(); i++)
+    sizes[i] = it->second[i].max_real_size;
+  return sizes;
+}
+
 template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::SetupOutputQueuesForGraph() {
   QueuePolicy::InitializeQueues(stage_queue_depths_);
+  if (adaptive_queue_depth_) {
+    QueuePolicy::EnableAdaptiveDepth(initial_queue_depths_, adaptive_queue_params_,
+                                     [this](OpType stage, int idx) {
+                                       ReleaseQueueSlot(stage, idx);
+                                     });
+  }
 }
 
 using SimpleExecutor = Executor<AOT_WS_Policy<UniformQueuePolicy>, UniformQueuePolicy>;
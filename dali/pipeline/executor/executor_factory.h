@@ -21,13 +21,17 @@
 #include "dali/pipeline/executor/pipelined_executor.h"
 #include "dali/pipeline/executor/async_pipelined_executor.h"
 #include "dali/pipeline/executor/async_separated_pipelined_executor.h"
+#include "dali/pipeline/executor/dag_executor.h"
 
 namespace dali {
 
 template <typename... Ts>
 std::unique_ptr<ExecutorBase> GetExecutor(bool pipelined, bool separated, bool async,
-                                          Ts... args) {
-  if (async && separated && pipelined) {
+                                          bool dynamic, Ts... args) {
+  if (dynamic) {
+    DALI_ENFORCE(!separated, "Separated queues are not supported by the dynamic executor.");
+    return std::unique_ptr<ExecutorBase>{new DagExecutor(args...)};
+  } else if (async && separated && pipelined) {
     return std::unique_ptr<ExecutorBase>{new AsyncSeparatedPipelinedExecutor(args...)};
   } else if (async && !separated && pipelined) {
     return std::unique_ptr<ExecutorBase>{new AsyncPipelinedExecutor(args...)};
@@ -14,14 +14,18 @@
 
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <future>
+#include <thread>
 
 #include "dali/test/dali_test_decoder.h"
 #include "dali/pipeline/executor/executor.h"
 #include "dali/pipeline/executor/pipelined_executor.h"
 #include "dali/pipeline/executor/async_pipelined_executor.h"
 #include "dali/pipeline/executor/async_separated_pipelined_executor.h"
+#include "dali/pipeline/executor/dag_executor.h"
 #include "dali/test/dali_test_utils.h"
 #include "dali/test/tensor_test_utils.h"
 
@@ -77,7 +81,7 @@ class ExecutorTest : public GenericDecoderTest<RGB> {
 
 using ExecutorTypes =
     ::testing::Types<SimpleExecutor, PipelinedExecutor, SeparatedPipelinedExecutor,
-                     AsyncPipelinedExecutor, AsyncSeparatedPipelinedExecutor>;
+                     AsyncPipelinedExecutor, AsyncSeparatedPipelinedExecutor, DagExecutor>;
 
 TYPED_TEST_SUITE(ExecutorTest, ExecutorTypes);
 
@@ -85,7 +89,7 @@ template <typename ExecutorToTest>
 using ExecutorSyncTest = ExecutorTest<ExecutorToTest>;
 
 using ExecutorSyncTypes =
-    ::testing::Types<SimpleExecutor, PipelinedExecutor, SeparatedPipelinedExecutor>;
+    ::testing::Types<SimpleExecutor, PipelinedExecutor, SeparatedPipelinedExecutor, DagExecutor>;
 
 TYPED_TEST_SUITE(ExecutorSyncTest, ExecutorSyncTypes);
 
@@ -489,6 +493,57 @@ TYPED_TEST(ExecutorTest, TestRunBasicGraphWithCB) {
   ASSERT_TRUE(ws.OutputIsType<CPUBackend>(0));
 }
 
+TYPED_TEST(ExecutorTest, TestTryShareOutputs) {
+  auto exe = this->GetExecutor(this->batch_size_, this->num_threads_, 0, 1);
+  exe->Init();
+
+  OpGraph graph;
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("ExternalSource")
+          .AddArg("device", "cpu")
+          .AddArg("device_id", 0)
+          .AddOutput("data", "cpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("MakeContiguous")
+          .AddArg("device", "mixed")
+          .AddInput("data", "cpu")
+          .AddOutput("final_images", "gpu")), "");
+
+  vector<string> outputs = {"final_images_gpu"};
+  std::promise<void> completed;
+  auto completed_future = completed.get_future();
+  exe->SetCompletionCallback([&completed]() {
+    completed.set_value();
+  });
+
+  exe->Build(&graph, outputs);
+
+  auto *src_op =
+      dynamic_cast<ExternalSource<CPUBackend> *>(graph.Node(OpType::CPU, 0).op.get());
+  ASSERT_NE(src_op, nullptr);
+  TensorList<CPUBackend> tl;
+  test::MakeRandomBatch(tl, this->batch_size_);
+  src_op->SetDataSource(tl);
+
+  DeviceWorkspace ws;
+  EXPECT_FALSE(exe->TryShareOutputs(&ws)) << "Nothing was run yet";
+
+  exe->RunCPU();
+  exe->RunMixed();
+  exe->RunGPU();
+
+  auto status = completed_future.wait_for(std::chrono::seconds(5));
+  ASSERT_EQ(status, std::future_status::ready);
+  // the outputs are ready when the callback is called
+  ASSERT_TRUE(exe->TryShareOutputs(&ws));
+  ASSERT_EQ(ws.NumOutput(), 1);
+  ASSERT_TRUE(ws.OutputIsType<GPUBackend>(0));
+  EXPECT_EQ(ws.Output<GPUBackend>(0).num_samples(), this->batch_size_);
+  exe->ReleaseOutputs();
+  EXPECT_FALSE(exe->TryShareOutputs(&ws));
+}
+
 // This test does not work with Async Executors
 TYPED_TEST(ExecutorSyncTest, TestPrefetchedExecution) {
   int batch_size = this->batch_size_ / 2;
@@ -603,4 +658,412 @@ TYPED_TEST(ExecutorSyncTest, TestPrefetchedExecution) {
   test::CheckResults(ws, batch_size, 1, tl);
 }
 
+using DagExecutorTest = ExecutorTest<DagExecutor>;
+
+TEST_F(DagExecutorTest, TestIndependentBranches) {
+  auto exe = this->GetExecutor(this->batch_size_, this->num_threads_, 0, 1);
+  exe->Init();
+
+  // Two GPU branches consuming the output of the same mixed operator
+  OpGraph graph;
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("ExternalSource")
+          .AddArg("device", "cpu")
+          .AddArg("device_id", 0)
+          .AddOutput("data", "cpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("Copy")
+          .AddArg("device", "cpu")
+          .AddInput("data", "cpu")
+          .AddOutput("labels", "cpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("MakeContiguous")
+          .AddArg("device", "mixed")
+          .AddInput("data", "cpu")
+          .AddOutput("images", "gpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("Copy")
+          .AddArg("device", "gpu")
+          .AddInput("images", "gpu")
+          .AddOutput("branch1", "gpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("Copy")
+          .AddArg("device", "gpu")
+          .AddInput("images", "gpu")
+          .AddOutput("branch2", "gpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("Copy")
+          .AddArg("device", "gpu")
+          .AddInput("branch2", "gpu")
+          .AddOutput("branch2_final", "gpu")), "");
+
+  vector<string> outputs = {"branch1_gpu", "branch2_final_gpu", "labels_cpu"};
+  exe->Build(&graph, outputs);
+
+  ASSERT_EQ(graph.NumOp(OpType::GPU), 3);
+  EXPECT_EQ(exe->NumGPUStreams(), 2);
+  EXPECT_NE(exe->GPUOpStream(0), exe->GPUOpStream(1));
+  // a linear chain stays on one stream
+  EXPECT_EQ(exe->GPUOpStream(1), exe->GPUOpStream(2));
+
+  auto *src_op =
+      dynamic_cast<ExternalSource<CPUBackend> *>(graph.Node(OpType::CPU, 0).op.get());
+  ASSERT_NE(src_op, nullptr);
+  TensorList<CPUBackend> tl;
+  test::MakeRandomBatch(tl, this->batch_size_);
+  src_op->SetDataSource(tl);
+
+  exe->RunCPU();
+  exe->RunMixed();
+  exe->RunGPU();
+
+  DeviceWorkspace ws;
+  exe->Outputs(&ws);
+  ASSERT_EQ(ws.NumOutput(), 3);
+  ASSERT_TRUE(ws.OutputIsType<GPUBackend>(0));
+  ASSERT_TRUE(ws.OutputIsType<GPUBackend>(1));
+  ASSERT_TRUE(ws.OutputIsType<CPUBackend>(2));
+  for (int out = 0; out < 3; out++) {
+    if (ws.OutputIsType<GPUBackend>(out)) {
+      TensorList<CPUBackend> result;
+      result.Copy(ws.Output<GPUBackend>(out));
+      CUDA_CALL(cudaDeviceSynchronize());
+      for (int i = 0; i < this->batch_size_; i++) {
+        ASSERT_EQ(result.tensor_shape(i), tl.tensor_shape(i));
+        EXPECT_EQ(std::memcmp(result.template tensor<uint8>(i), tl.template tensor<uint8>(i),
+                              volume(tl.tensor_shape(i))), 0);
+      }
+    } else {
+      auto &result = ws.Output<CPUBackend>(out);
+      for (int i = 0; i < this->batch_size_; i++) {
+        ASSERT_EQ(result.tensor_shape(i), tl.tensor_shape(i));
+        EXPECT_EQ(std::memcmp(result.template tensor<uint8>(i), tl.template tensor<uint8>(i),
+                              volume(tl.tensor_shape(i))), 0);
+      }
+    }
+  }
+}
+
+using ExecutorChainTest = ExecutorTest<SimpleExecutor>;
+
+TEST_F(ExecutorChainTest, TestSampleChaining) {
+  TensorList<CPUBackend> jpegs;
+  this->MakeJPEGBatch(&jpegs, this->batch_size_);
+
+  auto run = [&](bool sample_chaining, TensorList<CPUBackend> &result) {
+    auto exe = this->GetExecutor(this->batch_size_, 3, 0, 1);
+    exe->EnableSampleChaining(sample_chaining);
+    exe->Init();
+
+    // The decoder and the fused resize-crop are run sample by sample
+    OpGraph graph;
+    graph.AddOp(this->PrepareSpec(
+            OpSpec("ExternalSource")
+            .AddArg("device", "cpu")
+            .AddArg("device_id", 0)
+            .AddOutput("jpegs", "cpu")), "");
+
+    graph.AddOp(this->PrepareSpec(
+            OpSpec("ImageDecoder")
+            .AddArg("device", "cpu")
+            .AddInput("jpegs", "cpu")
+            .AddOutput("images", "cpu")), "");
+
+    graph.AddOp(this->PrepareSpec(
+            OpSpec("ResizeCropMirror")
+            .AddArg("device", "cpu")
+            .AddArg("resize_shorter", 64.f)
+            .AddArg("crop", std::vector<float>{32.f, 48.f})
+            .AddInput("images", "cpu")
+            .AddOutput("cropped", "cpu")), "");
+
+    vector<string> outputs = {"cropped_cpu"};
+    exe->Build(&graph, outputs);
+
+    auto *src_op =
+        dynamic_cast<ExternalSource<CPUBackend> *>(graph.Node(OpType::CPU, 0).op.get());
+    ASSERT_NE(src_op, nullptr);
+    src_op->SetDataSource(jpegs);
+
+    exe->RunCPU();
+    exe->RunMixed();
+    exe->RunGPU();
+
+    DeviceWorkspace ws;
+    exe->Outputs(&ws);
+    ASSERT_EQ(ws.NumOutput(), 1);
+    ASSERT_TRUE(ws.OutputIsType<CPUBackend>(0));
+    result.Copy(ws.Output<CPUBackend>(0));
+  };
+
+  TensorList<CPUBackend> ref, chained;
+  run(false, ref);
+  run(true, chained);
+  ASSERT_EQ(chained.num_samples(), this->batch_size_);
+  ASSERT_EQ(chained.GetLayout(), ref.GetLayout());
+  for (int i = 0; i < this->batch_size_; i++) {
+    ASSERT_EQ(chained.tensor_shape(i), ref.tensor_shape(i));
+    EXPECT_EQ(std::memcmp(chained.tensor<uint8>(i), ref.tensor<uint8>(i),
+                          volume(ref.tensor_shape(i))), 0);
+  }
+}
+
+/**
+ * @brief Copies the input to the output; runs out of device memory for the batches larger than
+ *        `max_samples`
+ */
+class SubBatchTestOp : public Operator<GPUBackend> {
+ public:
+  explicit SubBatchTestOp(const OpSpec &spec)
+      : Operator<GPUBackend>(spec), max_samples_(spec.GetArgument<int>("max_samples")) {}
+
+  static std::vector<int> &RunBatchSizes() {
+    static std::vector<int> batch_sizes;
+    return batch_sizes;
+  }
+
+  bool CanInferOutputs() const override {
+    return true;
+  }
+
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const DeviceWorkspace &ws) override {
+    const auto &input = ws.Input<GPUBackend>(0);
+    output_desc.resize(1);
+    output_desc[0] = {input.shape(), input.type()};
+    return true;
+  }
+
+  void RunImpl(DeviceWorkspace &ws) override {
+    const auto &input = ws.Input<GPUBackend>(0);
+    auto &output = ws.Output<GPUBackend>(0);
+    RunBatchSizes().push_back(input.num_samples());
+    if (input.num_samples() > max_samples_)
+      throw CUDABadAlloc();
+    output.SetLayout(input.GetLayout());
+    for (int i = 0; i < input.num_samples(); i++) {
+      CUDA_CALL(cudaMemcpyAsync(output.raw_mutable_tensor(i), input.raw_tensor(i),
+                                volume(input.tensor_shape(i)) * input.type_info().size(),
+                                cudaMemcpyDeviceToDevice, ws.stream()));
+    }
+  }
+
+ private:
+  int max_samples_;
+};
+
+DALI_REGISTER_OPERATOR(SubBatchTestOp, SubBatchTestOp, GPU);
+
+DALI_SCHEMA(SubBatchTestOp)
+  .DocStr("Dummy op running out of memory for large batches")
+  .NumInput(1)
+  .NumOutput(1)
+  .BatchSplittable()
+  .AddArg("max_samples", "the largest batch which fits in the memory", DALI_INT32);
+
+TEST_F(ExecutorChainTest, TestRunInSubBatches) {
+  auto exe = this->GetExecutor(this->batch_size_, this->num_threads_, 0, 1);
+  exe->Init();
+
+  OpGraph graph;
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("ExternalSource")
+          .AddArg("device", "cpu")
+          .AddArg("device_id", 0)
+          .AddOutput("data", "cpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("MakeContiguous")
+          .AddArg("device", "mixed")
+          .AddInput("data", "cpu")
+          .AddOutput("images", "gpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("SubBatchTestOp")
+          .AddArg("device", "gpu")
+          .AddArg("max_samples", 2)
+          .AddInput("images", "gpu")
+          .AddOutput("copied", "gpu")), "");
+
+  vector<string> outputs = {"copied_gpu"};
+  exe->Build(&graph, outputs);
+
+  auto *src_op =
+      dynamic_cast<ExternalSource<CPUBackend> *>(graph.Node(OpType::CPU, 0).op.get());
+  ASSERT_NE(src_op, nullptr);
+  TensorList<CPUBackend> tl;
+  test::MakeRandomBatch(tl, this->batch_size_);
+  src_op->SetDataSource(tl);
+
+  auto &batch_sizes = SubBatchTestOp::RunBatchSizes();
+  batch_sizes.clear();
+  exe->RunCPU();
+  exe->RunMixed();
+  exe->RunGPU();
+
+  DeviceWorkspace ws;
+  exe->Outputs(&ws);
+  ASSERT_EQ(ws.NumOutput(), 1);
+  ASSERT_TRUE(ws.OutputIsType<GPUBackend>(0));
+  TensorList<CPUBackend> result;
+  result.Copy(ws.Output<GPUBackend>(0));
+  CUDA_CALL(cudaDeviceSynchronize());
+  ASSERT_EQ(result.num_samples(), this->batch_size_);
+  for (int i = 0; i < this->batch_size_; i++) {
+    ASSERT_EQ(result.tensor_shape(i), tl.tensor_shape(i));
+    EXPECT_EQ(std::memcmp(result.tensor<uint8>(i), tl.tensor<uint8>(i),
+                          volume(tl.tensor_shape(i))), 0);
+  }
+
+  // The whole batch is run twice, then the parts of the batch, halved until they fit
+  ASSERT_GE(batch_sizes.size(), 2u);
+  EXPECT_EQ(batch_sizes[0], this->batch_size_);
+  EXPECT_EQ(batch_sizes[1], this->batch_size_);
+  int processed = 0;
+  for (size_t i = 2; i < batch_sizes.size(); i++) {
+    if (batch_sizes[i] <= 2)
+      processed += batch_sizes[i];
+  }
+  EXPECT_EQ(processed, this->batch_size_);
+}
+
+/**
+ * @brief Copies the input to the device; the GPU work of each iteration is held in progress
+ *        until the next iteration starts
+ */
+class IterationOverlapTestOp : public Operator<MixedBackend> {
+ public:
+  explicit IterationOverlapTestOp(const OpSpec &spec) : Operator<MixedBackend>(spec) {}
+
+  struct Iteration {
+    std::atomic<bool> released{false};
+    std::atomic<bool> gpu_done{false};
+    // the state of the GPU work of the previous iterations when this one was started
+    bool prev_gpu_done = false;
+    bool prev_prev_gpu_done = false;
+  };
+
+  static std::deque<Iteration> &Iterations() {
+    static std::deque<Iteration> iterations;
+    return iterations;
+  }
+
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const MixedWorkspace &ws) override {
+    return false;
+  }
+
+  using Operator<MixedBackend>::Run;
+  void Run(MixedWorkspace &ws) override {
+    auto &iterations = Iterations();
+    int k = iterations.size();
+    auto &it = iterations.emplace_back();
+    if (k >= 2)
+      it.prev_prev_gpu_done = iterations[k - 2].gpu_done;
+    if (k >= 1) {
+      it.prev_gpu_done = iterations[k - 1].gpu_done;
+      iterations[k - 1].released = true;
+    }
+
+    const auto &input = ws.Input<CPUBackend>(0);
+    auto &output = ws.Output<GPUBackend>(0);
+    output.Resize(input.shape(), input.type());
+    output.SetLayout(input.GetLayout());
+    for (int i = 0; i < input.num_samples(); i++) {
+      CUDA_CALL(cudaMemcpyAsync(output.raw_mutable_tensor(i), input.raw_tensor(i),
+                                volume(input.tensor_shape(i)) * input.type_info().size(),
+                                cudaMemcpyHostToDevice, ws.stream()));
+    }
+    CUDA_CALL(cudaLaunchHostFunc(ws.stream(), WaitForRelease, &it));
+  }
+
+ private:
+  static void CUDART_CB WaitForRelease(void *arg) {
+    auto &it = *static_cast<Iteration *>(arg);
+    // don't hang the test if the next iteration can't start
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!it.released && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    it.gpu_done = true;
+  }
+};
+
+DALI_REGISTER_OPERATOR(IterationOverlapTestOp, IterationOverlapTestOp, Mixed);
+
+DALI_SCHEMA(IterationOverlapTestOp)
+  .DocStr("Dummy op holding the GPU work of an iteration until the next one starts")
+  .NumInput(1)
+  .NumOutput(1)
+  .IterationOverlap();
+
+TEST_F(ExecutorChainTest, TestMixedIterationOverlap) {
+  auto exe = this->GetExecutor(this->batch_size_, this->num_threads_, 0, 2);
+  exe->Init();
+
+  OpGraph graph;
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("ExternalSource")
+          .AddArg("device", "cpu")
+          .AddArg("device_id", 0)
+          .AddOutput("data", "cpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("IterationOverlapTestOp")
+          .AddArg("device", "mixed")
+          .AddInput("data", "cpu")
+          .AddOutput("held", "gpu")), "");
+
+  // inserted by the pipeline for every transfer to the GPU
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("MakeContiguous")
+          .AddArg("device", "mixed")
+          .AddInput("data", "cpu")
+          .AddOutput("images", "gpu")), "");
+
+  vector<string> outputs = {"held_gpu", "images_gpu"};
+  exe->Build(&graph, outputs);
+
+  auto *src_op =
+      dynamic_cast<ExternalSource<CPUBackend> *>(graph.Node(OpType::CPU, 0).op.get());
+  ASSERT_NE(src_op, nullptr);
+  TensorList<CPUBackend> tl;
+  test::MakeRandomBatch(tl, this->batch_size_);
+
+  auto &iterations = IterationOverlapTestOp::Iterations();
+  iterations.clear();
+  auto run = [&]() {
+    src_op->SetDataSource(tl);
+    exe->RunCPU();
+    exe->RunMixed();
+    exe->RunGPU();
+  };
+  auto check_outputs = [&]() {
+    DeviceWorkspace ws;
+    exe->Outputs(&ws);
+    ASSERT_EQ(ws.NumOutput(), 2);
+    test::CheckResults(ws, this->batch_size_, 0, tl, 0);
+    test::CheckResults(ws, this->batch_size_, 0, tl, 1);
+    // free the queue slot for the next iteration
+    exe->ReleaseOutputs();
+  };
+
+  run();
+  run();
+  check_outputs();
+  run();
+  iterations.back().released = true;
+  check_outputs();
+  check_outputs();
+
+  // Each iteration starts while the GPU work of the previous one is in progress, but only
+  // after the GPU work of the one before it is complete
+  ASSERT_EQ(iterations.size(), 3u);
+  EXPECT_FALSE(iterations[1].prev_gpu_done);
+  EXPECT_FALSE(iterations[2].prev_gpu_done);
+  EXPECT_TRUE(iterations[2].prev_prev_gpu_done);
+}
+
 }  // namespace dali
@@ -0,0 +1,114 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+#include "dali/core/format.h"
+#include "dali/pipeline/executor/memory_profile.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * The profile starts with the header line, followed by one line per operator output:
+ *   <output index> <real_size> <max_real_size> <reserved> <max_reserved> <operator key>
+ * The key is the rest of the line, so that it can contain any characters but a new line.
+ */
+constexpr const char kProfileHeader[] = "dali_memory_profile 1";
+
+}  // namespace
+
+std::string ExecutorMetaKey(OpType op_type, const std::string &instance_name) {
+  switch (op_type) {
+    case OpType::CPU:
+      return "CPU_" + instance_name;
+    case OpType::MIXED:
+      return "MIXED_" + instance_name;
+    case OpType::GPU:
+      return "GPU_" + instance_name;
+    default:
+      DALI_FAIL("Invalid op type");
+  }
+}
+
+void WriteMemoryProfile(std::ostream &os, const ExecutorMetaMap &profile) {
+  // sorted, so that the profiles of the same pipeline can be compared
+  std::vector<const ExecutorMetaMap::value_type *> entries;
+  for (auto &entry : profile)
+    entries.push_back(&entry);
+  std::sort(entries.begin(), entries.end(), [](auto *a, auto *b) {
+    return a->first < b->first;
+  });
+
+  os << kProfileHeader << "\n";
+  for (auto *entry : entries) {
+    DALI_ENFORCE(entry->first.find('\n') == std::string::npos,
+                 make_string("Invalid operator name in the memory profile: \"", entry->first,
+                             "\"."));
+    for (size_t i = 0; i < entry->second.size(); i++) {
+      auto &meta = entry->second[i];
+      os << i << " " << meta.real_size << " " << meta.max_real_size << " " << meta.reserved << " "
+         << meta.max_reserved << " " << entry->first << "\n";
+    }
+  }
+}
+
+ExecutorMetaMap ReadMemoryProfile(std::istream &is) {
+  std::string line;
+  DALI_ENFORCE(std::getline(is, line) && line == kProfileHeader,
+               "The memory profile is missing the header or has an unsupported version.");
+  ExecutorMetaMap profile;
+  for (int line_no = 2; std::getline(is, line); line_no++) {
+    if (line.empty())
+      continue;
+    std::istringstream ss(line);
+    size_t idx;
+    ExecutorMeta meta;
+    std::string key;
+    ss >> idx >> meta.real_size >> meta.max_real_size >> meta.reserved >> meta.max_reserved;
+    if (ss)
+      ss.get();  // the separator
+    std::getline(ss, key);
+    DALI_ENFORCE(ss && !key.empty(),
+                 make_string("Invalid entry in the memory profile at line ", line_no, ": \"",
+                             line, "\"."));
+    auto &outputs = profile[key];
+    if (outputs.size() <= idx)
+      outputs.resize(idx + 1, ExecutorMeta{0, 0, 0, 0});
+    outputs[idx] = meta;
+  }
+  return profile;
+}
+
+void SaveMemoryProfile(const std::string &path, const ExecutorMetaMap &profile) {
+  std::ofstream f(path);
+  DALI_ENFORCE(f.good(), make_string("Cannot open \"", path, "\" for writing."));
+  WriteMemoryProfile(f, profile);
+  f.close();
+  DALI_ENFORCE(f.good(), make_string("Failed to write the memory profile to \"", path, "\"."));
+}
+
+ExecutorMetaMap LoadMemoryProfile(const std::string &path) {
+  std::ifstream f(path);
+  DALI_ENFORCE(f.good(), make_string("Cannot open the memory profile \"", path, "\"."));
+  return ReadMemoryProfile(f);
+}
+
+}  // namespace dali
@@ -0,0 +1,60 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_EXECUTOR_MEMORY_PROFILE_H_
+#define DALI_PIPELINE_EXECUTOR_MEMORY_PROFILE_H_
+
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dali/core/api_helper.h"
+#include "dali/core/common.h"
+
+namespace dali {
+
+struct DLL_PUBLIC ExecutorMeta {
+  size_t real_size;
+  size_t max_real_size;
+  size_t reserved;
+  size_t max_reserved;
+};
+using ExecutorMetaMap = std::unordered_map<std::string, std::vector<ExecutorMeta>>;
+
+/**
+ * @brief Returns the key of the operator in the ExecutorMetaMap
+ */
+DLL_PUBLIC std::string ExecutorMetaKey(OpType op_type, const std::string &instance_name);
+
+/**
+ * @brief Writes the memory statistics of the operator outputs in a text form
+ *
+ * The profile gathered in one run of a pipeline can be used to reserve the buffers
+ * in the subsequent runs, see ReadMemoryProfile.
+ */
+DLL_PUBLIC void WriteMemoryProfile(std::ostream &os, const ExecutorMetaMap &profile);
+
+/**
+ * @brief Reads the memory statistics written with WriteMemoryProfile
+ */
+DLL_PUBLIC ExecutorMetaMap ReadMemoryProfile(std::istream &is);
+
+DLL_PUBLIC void SaveMemoryProfile(const std::string &path, const ExecutorMetaMap &profile);
+
+DLL_PUBLIC ExecutorMetaMap LoadMemoryProfile(const std::string &path);
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_EXECUTOR_MEMORY_PROFILE_H_
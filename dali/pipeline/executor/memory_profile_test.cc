@@ -0,0 +1,71 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "dali/core/error_handling.h"
+#include "dali/pipeline/executor/memory_profile.h"
+
+namespace dali {
+
+namespace {
+
+void ExpectEqual(const ExecutorMeta &a, const ExecutorMeta &b) {
+  EXPECT_EQ(a.real_size, b.real_size);
+  EXPECT_EQ(a.max_real_size, b.max_real_size);
+  EXPECT_EQ(a.reserved, b.reserved);
+  EXPECT_EQ(a.max_reserved, b.max_reserved);
+}
+
+}  // namespace
+
+TEST(MemoryProfile, RoundTrip) {
+  ExecutorMetaMap profile;
+  profile[ExecutorMetaKey(OpType::CPU, "decoder")] = {{1000, 100, 2000, 200}};
+  profile[ExecutorMetaKey(OpType::GPU, "resize with spaces")] = {
+    {10, 1, 20, 2}, {30, 3, 40, 4}
+  };
+  std::stringstream ss;
+  WriteMemoryProfile(ss, profile);
+  auto loaded = ReadMemoryProfile(ss);
+  ASSERT_EQ(loaded.size(), profile.size());
+  for (auto &entry : profile) {
+    auto it = loaded.find(entry.first);
+    ASSERT_TRUE(it != loaded.end());
+    ASSERT_EQ(it->second.size(), entry.second.size());
+    for (size_t i = 0; i < entry.second.size(); i++)
+      ExpectEqual(it->second[i], entry.second[i]);
+  }
+}
+
+TEST(MemoryProfile, Key) {
+  EXPECT_EQ(ExecutorMetaKey(OpType::CPU, "op"), "CPU_op");
+  EXPECT_EQ(ExecutorMetaKey(OpType::MIXED, "op"), "MIXED_op");
+  EXPECT_EQ(ExecutorMetaKey(OpType::GPU, "op"), "GPU_op");
+}
+
+TEST(MemoryProfile, InvalidInput) {
+  std::stringstream no_header("0 1 2 3 4 CPU_op\n");
+  EXPECT_THROW(ReadMemoryProfile(no_header), DALIException);
+
+  std::stringstream truncated("dali_memory_profile 1\n0 1 2 CPU_op\n");
+  EXPECT_THROW(ReadMemoryProfile(truncated), DALIException);
+
+  std::stringstream no_name("dali_memory_profile 1\n0 1 2 3 4\n");
+  EXPECT_THROW(ReadMemoryProfile(no_name), DALIException);
+}
+
+}  // namespace dali
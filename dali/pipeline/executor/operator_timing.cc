@@ -0,0 +1,148 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <utility>
+
+#include "dali/core/cuda_error.h"
+#include "dali/pipeline/executor/operator_timing.h"
+#include "dali/pipeline/executor/queue_metadata.h"
+
+namespace dali {
+
+void TimingCollector::AddOperatorRun(const std::string &key, int batch_size, double host_time) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto &op = timing_.operators[key];
+  op.num_runs++;
+  op.num_samples += batch_size;
+  op.host_time += host_time;
+}
+
+TimingCollector::GPURange TimingCollector::BeginGPURun(cudaStream_t stream) {
+  GPURange range;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    CollectGPURuns();
+    for (auto *event : { &range.start, &range.end }) {
+      if (free_events_.empty()) {
+        *event = CUDAEvent::CreateWithFlags(cudaEventDefault);
+      } else {
+        *event = std::move(free_events_.back());
+        free_events_.pop_back();
+      }
+    }
+  }
+  CUDA_CALL(cudaEventRecord(range.start, stream));
+  return range;
+}
+
+void TimingCollector::EndGPURun(const std::string &key, GPURange range, cudaStream_t stream) {
+  CUDA_CALL(cudaEventRecord(range.end, stream));
+  std::lock_guard<std::mutex> lock(mtx_);
+  pending_.push_back({ &timing_.operators[key], std::move(range) });
+}
+
+void TimingCollector::CollectGPURuns() {
+  while (!pending_.empty()) {
+    auto &run = pending_.front();
+    auto status = cudaEventQuery(run.range.end);
+    if (status == cudaErrorNotReady)
+      break;
+    CUDA_CALL(status);
+    float ms = 0;
+    CUDA_CALL(cudaEventElapsedTime(&ms, run.range.start, run.range.end));
+    run.op->num_gpu_runs++;
+    run.op->gpu_time += ms * 1e-3;
+    free_events_.push_back(std::move(run.range.start));
+    free_events_.push_back(std::move(run.range.end));
+    pending_.pop_front();
+  }
+}
+
+void TimingCollector::AddStageIteration(OpType stage, int batch_size, Clock::time_point start,
+                                        Clock::time_point acquired, Clock::time_point end) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  int s = static_cast<int>(stage);
+  auto &stats = timing_.stages[s];
+  stats.num_iterations++;
+  stats.num_samples += batch_size;
+  stats.wait_time += Seconds(start, acquired);
+  stats.host_time += Seconds(acquired, end);
+  produced_[s]++;
+  if (!started_ || start < first_start_)
+    first_start_ = start;
+  if (!started_ || end > last_end_)
+    last_end_ = end;
+  started_ = true;
+}
+
+void TimingCollector::AddStageAllocations(OpType stage, int64_t num_allocations) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto &stats = timing_.stages[static_cast<int>(stage)];
+  stats.num_allocations += num_allocations;
+  stats.last_allocations = num_allocations;
+}
+
+void TimingCollector::AddGraphLaunch(OpType stage, bool captured) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto &stats = timing_.stages[static_cast<int>(stage)];
+  if (captured)
+    stats.num_graph_captures++;
+  else
+    stats.num_graph_replays++;
+}
+
+void TimingCollector::ConsumeStageOutput(OpType stage) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  int s = static_cast<int>(stage);
+  auto &stats = timing_.stages[s];
+  // the batches produced before the timing was enabled aren't counted
+  int occupancy = std::max<int64_t>(produced_[s] - consumed_[s], 1);
+  consumed_[s] = std::min(consumed_[s] + 1, produced_[s]);
+  stats.num_queue_samples++;
+  stats.queue_occupancy_sum += occupancy;
+  stats.max_queue_occupancy = std::max(stats.max_queue_occupancy, occupancy);
+}
+
+BottleneckSummary ComputeBottleneck(const ExecutorTiming &timing) {
+  BottleneckSummary ret;
+  double elapsed = timing.elapsed_time;
+  if (elapsed <= 0)
+    return ret;
+  // the time in which the consumer of each queue was starved, nested in the starvation
+  // of the consumers further down the pipeline
+  double starved = std::min(timing.stages[static_cast<int>(OpType::GPU)].consumer_wait, elapsed);
+  ret.consumer = elapsed - starved;
+  for (auto stage : { OpType::GPU, OpType::MIXED }) {
+    const auto &input_queue = timing.stages[static_cast<int>(PreviousStage(stage))];
+    double upstream = std::min(starved, input_queue.consumer_wait);
+    ret.stages[static_cast<int>(stage)] = starved - upstream;
+    starved = upstream;
+  }
+  ret.stages[static_cast<int>(OpType::CPU)] = starved;
+  ret.consumer /= elapsed;
+  for (auto &s : ret.stages)
+    s /= elapsed;
+  return ret;
+}
+
+ExecutorTiming TimingCollector::GetTiming() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  CollectGPURuns();
+  ExecutorTiming ret = timing_;
+  ret.elapsed_time = started_ ? Seconds(first_start_, last_end_) : 0;
+  return ret;
+}
+
+}  // namespace dali
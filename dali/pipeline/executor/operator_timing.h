@@ -0,0 +1,254 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_EXECUTOR_OPERATOR_TIMING_H_
+#define DALI_PIPELINE_EXECUTOR_OPERATOR_TIMING_H_
+
+#include <cuda_runtime_api.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dali/core/api_helper.h"
+#include "dali/core/common.h"
+#include "dali/core/cuda_event.h"
+
+namespace dali {
+
+/**
+ * @brief Cumulative timing of an operator, since the timing was enabled
+ *
+ * The times are in seconds.
+ */
+struct DLL_PUBLIC OperatorTiming {
+  int64_t num_runs = 0;
+  int64_t num_samples = 0;
+  /// Wall time of the Setup and Run of the operator, measured in the thread issuing it
+  double host_time = 0;
+  /// The number of runs, for which the time of the work in the CUDA stream was measured
+  int64_t num_gpu_runs = 0;
+  /// Time between the start and the end of the operator's work in the stream
+  double gpu_time = 0;
+};
+
+/**
+ * @brief Cumulative timing of an executor stage and the occupancy of the queue after it
+ *
+ * The occupancy is sampled when the next stage (the user, for the last stage) takes a batch
+ * from the queue; it's the number of the batches ready at that moment, including the one taken.
+ * A queue which is usually full means that the consumer is the bottleneck, an occupancy of 1
+ * - that the consumer waits for the stage.
+ */
+struct DLL_PUBLIC StageTiming {
+  int64_t num_iterations = 0;
+  int64_t num_samples = 0;
+  /// Time spent on running the iterations, without waiting for the buffers
+  double host_time = 0;
+  /// Time spent waiting for the input batches and the free output buffers
+  double wait_time = 0;
+  /// Time the stage waited for a free buffer of its output queue, see QueueWaitRecorder
+  double producer_wait = 0;
+  /// Time the consumer of the output queue (the next stage or the user) waited for a batch
+  double consumer_wait = 0;
+  int64_t num_queue_samples = 0;
+  int64_t queue_occupancy_sum = 0;
+  int max_queue_occupancy = 0;
+  /// The heap allocations made in the iterations (see AllocationCounter) - only counted when
+  /// DALI is built with BUILD_ALLOCATION_COUNTING
+  int64_t num_allocations = 0;
+  /// The heap allocations made in the last iteration; 0 in the steady state of a pipeline, which
+  /// doesn't allocate
+  int64_t last_allocations = 0;
+  /// The iterations run as a CUDA graph captured in that iteration or replayed - only the GPU
+  /// stage, when the CUDA graphs are enabled
+  int64_t num_graph_captures = 0;
+  int64_t num_graph_replays = 0;
+};
+
+using OperatorTimingMap = std::unordered_map<std::string, OperatorTiming>;
+
+/**
+ * @brief The fractions of the elapsed time, for which each of the stages and the consumer of
+ *        the outputs limited the throughput of the pipeline; see ComputeBottleneck
+ */
+struct DLL_PUBLIC BottleneckSummary {
+  /// Indexed with OpType
+  std::array<double, static_cast<int>(OpType::COUNT)> stages{};
+  /// The user of the pipeline - the outputs were ready before it asked for them
+  double consumer = 0;
+};
+
+struct DLL_PUBLIC ExecutorTiming {
+  /// The operators, with the keys as in ExecutorMetaMap (see ExecutorMetaKey)
+  OperatorTimingMap operators;
+  /// Indexed with OpType
+  std::array<StageTiming, static_cast<int>(OpType::COUNT)> stages;
+  /// Time between the start of the first and the end of the last iteration of any stage
+  double elapsed_time = 0;
+  BottleneckSummary bottleneck;
+};
+
+/**
+ * @brief Attributes the time of the pipeline to the part that was the limiter, based on
+ *        the consumer waits of the stage queues
+ *
+ * The time the user didn't wait for the outputs is attributed to the user. The time it waited is
+ * attributed to the GPU stage, except for the part in which the GPU stage itself waited for
+ * the mixed stage - that part is attributed to the mixed stage, and so on, up to the CPU stage.
+ * The waits are assumed to overlap, which holds when the stages run in separate threads.
+ */
+DLL_PUBLIC BottleneckSummary ComputeBottleneck(const ExecutorTiming &timing);
+
+/**
+ * @brief Accumulates the time spent waiting on both sides of the stage queues; used by
+ *        the queue policies when the operator timing is enabled
+ *
+ * The queues are identified with the stage producing the batches. The producer waits for a free
+ * buffer, the consumer (the next stage or, for the GPU stage, the user) - for a ready batch.
+ */
+class DLL_PUBLIC QueueWaitRecorder {
+ public:
+  struct Waits {
+    double producer_wait = 0;
+    double consumer_wait = 0;
+  };
+  using WaitArray = std::array<Waits, static_cast<int>(OpType::COUNT)>;
+
+  void Enable(bool enable) {
+    enabled_ = enable;
+  }
+
+  bool IsEnabled() const {
+    return enabled_;
+  }
+
+  void AddProducerWait(OpType queue, double seconds) {
+    if (!enabled_)
+      return;
+    std::lock_guard<std::mutex> lock(mtx_);
+    waits_[static_cast<int>(queue)].producer_wait += seconds;
+  }
+
+  void AddConsumerWait(OpType queue, double seconds) {
+    if (!enabled_)
+      return;
+    std::lock_guard<std::mutex> lock(mtx_);
+    waits_[static_cast<int>(queue)].consumer_wait += seconds;
+  }
+
+  WaitArray Get() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return waits_;
+  }
+
+ private:
+  std::atomic<bool> enabled_{false};
+  mutable std::mutex mtx_;
+  WaitArray waits_{};
+};
+
+/**
+ * @brief Gathers the ExecutorTiming; used by the executor when the operator timing is enabled
+ *
+ * The device time of an operator is measured with a pair of CUDA events recorded around its
+ * work. The events are read when they're completed - when a later operator of the same stage
+ * is timed or when the timing is obtained - so that the stage threads never wait for the device.
+ * The methods can be called from any thread.
+ */
+class DLL_PUBLIC TimingCollector {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief The events around the work of an operator, see BeginGPURun
+  struct GPURange {
+    CUDAEvent start, end;
+  };
+
+  TimingCollector() = default;
+  TimingCollector(const TimingCollector &) = delete;
+  TimingCollector &operator=(const TimingCollector &) = delete;
+
+  static double Seconds(Clock::time_point start, Clock::time_point end = Clock::now()) {
+    return std::chrono::duration<double>(end - start).count();
+  }
+
+  void AddOperatorRun(const std::string &key, int batch_size, double host_time);
+
+  /**
+   * @brief Records the start of the work of an operator in the stream
+   */
+  GPURange BeginGPURun(cudaStream_t stream);
+
+  /**
+   * @brief Records the end of the work of an operator in the stream; the time between the events
+   *        is added to the operator's timing once they're completed
+   */
+  void EndGPURun(const std::string &key, GPURange range, cudaStream_t stream);
+
+  /**
+   * @brief Adds a finished iteration of a stage
+   *
+   * @param start     the time when the stage started waiting for the buffers
+   * @param acquired  the time when the buffers were acquired
+   */
+  void AddStageIteration(OpType stage, int batch_size, Clock::time_point start,
+                         Clock::time_point acquired, Clock::time_point end = Clock::now());
+
+  /**
+   * @brief Adds the heap allocations made in an iteration of a stage
+   */
+  void AddStageAllocations(OpType stage, int64_t num_allocations);
+
+  /**
+   * @brief Adds an iteration of a stage run as a CUDA graph
+   *
+   * @param captured  whether the graph was captured in this iteration or replayed
+   */
+  void AddGraphLaunch(OpType stage, bool captured);
+
+  /**
+   * @brief Marks a batch produced by the stage as taken out of its output queue
+   */
+  void ConsumeStageOutput(OpType stage);
+
+  ExecutorTiming GetTiming();
+
+ private:
+  struct PendingGPURun {
+    OperatorTiming *op;
+    GPURange range;
+  };
+
+  // must be called with mtx_ locked
+  void CollectGPURuns();
+
+  std::mutex mtx_;
+  ExecutorTiming timing_;
+  // the batches produced and taken out of the output queue of each stage
+  std::array<int64_t, static_cast<int>(OpType::COUNT)> produced_{}, consumed_{};
+  bool started_ = false;
+  Clock::time_point first_start_, last_end_;
+  std::deque<PendingGPURun> pending_;
+  std::vector<CUDAEvent> free_events_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_EXECUTOR_OPERATOR_TIMING_H_
@@ -0,0 +1,150 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <utility>
+#include "dali/core/cuda_error.h"
+#include "dali/core/cuda_stream.h"
+#include "dali/pipeline/executor/operator_timing.h"
+
+namespace dali {
+
+TEST(TimingCollector, OperatorRuns) {
+  TimingCollector collector;
+  collector.AddOperatorRun("op", 4, 0.5);
+  collector.AddOperatorRun("op", 2, 0.25);
+  collector.AddOperatorRun("other", 1, 1);
+  auto timing = collector.GetTiming();
+  ASSERT_EQ(timing.operators.size(), 2u);
+  auto &op = timing.operators["op"];
+  EXPECT_EQ(op.num_runs, 2);
+  EXPECT_EQ(op.num_samples, 6);
+  EXPECT_DOUBLE_EQ(op.host_time, 0.75);
+  EXPECT_EQ(op.num_gpu_runs, 0);
+  EXPECT_EQ(timing.elapsed_time, 0);
+}
+
+TEST(TimingCollector, StagesAndOccupancy) {
+  using Clock = TimingCollector::Clock;
+  TimingCollector collector;
+  auto t0 = Clock::now();
+  auto t1 = t0 + std::chrono::milliseconds(10);
+  auto t2 = t1 + std::chrono::milliseconds(30);
+  collector.AddStageIteration(OpType::CPU, 8, t0, t1, t2);
+  collector.AddStageIteration(OpType::CPU, 8, t2, t2, t2 + std::chrono::milliseconds(20));
+  // both batches are ready when the first one is taken
+  collector.ConsumeStageOutput(OpType::CPU);
+  collector.ConsumeStageOutput(OpType::CPU);
+  // the batches produced before the timing started are counted as one
+  collector.ConsumeStageOutput(OpType::GPU);
+
+  auto timing = collector.GetTiming();
+  auto &cpu = timing.stages[static_cast<int>(OpType::CPU)];
+  EXPECT_EQ(cpu.num_iterations, 2);
+  EXPECT_EQ(cpu.num_samples, 16);
+  EXPECT_NEAR(cpu.wait_time, 0.01, 1e-6);
+  EXPECT_NEAR(cpu.host_time, 0.05, 1e-6);
+  EXPECT_EQ(cpu.num_queue_samples, 2);
+  EXPECT_EQ(cpu.queue_occupancy_sum, 3);
+  EXPECT_EQ(cpu.max_queue_occupancy, 2);
+  auto &gpu = timing.stages[static_cast<int>(OpType::GPU)];
+  EXPECT_EQ(gpu.num_iterations, 0);
+  EXPECT_EQ(gpu.max_queue_occupancy, 1);
+  EXPECT_NEAR(timing.elapsed_time, 0.06, 1e-6);
+}
+
+TEST(TimingCollector, StageAllocations) {
+  TimingCollector collector;
+  collector.AddStageAllocations(OpType::CPU, 10);
+  collector.AddStageAllocations(OpType::CPU, 0);
+  collector.AddStageAllocations(OpType::GPU, 3);
+  auto timing = collector.GetTiming();
+  auto &cpu = timing.stages[static_cast<int>(OpType::CPU)];
+  EXPECT_EQ(cpu.num_allocations, 10);
+  EXPECT_EQ(cpu.last_allocations, 0);
+  auto &gpu = timing.stages[static_cast<int>(OpType::GPU)];
+  EXPECT_EQ(gpu.num_allocations, 3);
+  EXPECT_EQ(gpu.last_allocations, 3);
+  EXPECT_EQ(timing.stages[static_cast<int>(OpType::MIXED)].num_allocations, 0);
+}
+
+TEST(TimingCollector, GraphLaunches) {
+  TimingCollector collector;
+  collector.AddGraphLaunch(OpType::GPU, true);
+  collector.AddGraphLaunch(OpType::GPU, false);
+  collector.AddGraphLaunch(OpType::GPU, false);
+  auto timing = collector.GetTiming();
+  auto &gpu = timing.stages[static_cast<int>(OpType::GPU)];
+  EXPECT_EQ(gpu.num_graph_captures, 1);
+  EXPECT_EQ(gpu.num_graph_replays, 2);
+  EXPECT_EQ(timing.stages[static_cast<int>(OpType::MIXED)].num_graph_replays, 0);
+}
+
+TEST(TimingCollector, GPURuns) {
+  TimingCollector collector;
+  auto stream = CUDAStream::Create(true);
+  const int runs = 3;
+  for (int i = 0; i < runs; i++) {
+    auto range = collector.BeginGPURun(stream);
+    collector.EndGPURun("gpu_op", std::move(range), stream);
+  }
+  CUDA_CALL(cudaStreamSynchronize(stream));
+  auto timing = collector.GetTiming();
+  auto &op = timing.operators["gpu_op"];
+  EXPECT_EQ(op.num_gpu_runs, runs);
+  EXPECT_GE(op.gpu_time, 0);
+  // the host time is added separately
+  EXPECT_EQ(op.num_runs, 0);
+}
+
+TEST(TimingCollector, Bottleneck) {
+  ExecutorTiming timing;
+  timing.elapsed_time = 10;
+  // the user waited for 4s; the GPU stage for 3s, the mixed stage for 1s
+  timing.stages[static_cast<int>(OpType::GPU)].consumer_wait = 4;
+  timing.stages[static_cast<int>(OpType::MIXED)].consumer_wait = 3;
+  timing.stages[static_cast<int>(OpType::CPU)].consumer_wait = 1;
+  auto bottleneck = ComputeBottleneck(timing);
+  EXPECT_DOUBLE_EQ(bottleneck.consumer, 0.6);
+  EXPECT_DOUBLE_EQ(bottleneck.stages[static_cast<int>(OpType::GPU)], 0.1);
+  EXPECT_DOUBLE_EQ(bottleneck.stages[static_cast<int>(OpType::MIXED)], 0.2);
+  EXPECT_DOUBLE_EQ(bottleneck.stages[static_cast<int>(OpType::CPU)], 0.1);
+
+  // a stage can't be starved for longer than its consumer
+  timing.stages[static_cast<int>(OpType::MIXED)].consumer_wait = 6;
+  bottleneck = ComputeBottleneck(timing);
+  EXPECT_DOUBLE_EQ(bottleneck.stages[static_cast<int>(OpType::GPU)], 0);
+  EXPECT_DOUBLE_EQ(bottleneck.stages[static_cast<int>(OpType::MIXED)], 0.3);
+
+  timing.elapsed_time = 0;
+  bottleneck = ComputeBottleneck(timing);
+  EXPECT_EQ(bottleneck.consumer, 0);
+}
+
+TEST(QueueWaitRecorder, EnableAndAccumulate) {
+  QueueWaitRecorder recorder;
+  recorder.AddConsumerWait(OpType::GPU, 1);
+  EXPECT_EQ(recorder.Get()[static_cast<int>(OpType::GPU)].consumer_wait, 0);
+  recorder.Enable(true);
+  recorder.AddConsumerWait(OpType::GPU, 0.5);
+  recorder.AddConsumerWait(OpType::GPU, 0.25);
+  recorder.AddProducerWait(OpType::CPU, 2);
+  auto waits = recorder.Get();
+  EXPECT_DOUBLE_EQ(waits[static_cast<int>(OpType::GPU)].consumer_wait, 0.75);
+  EXPECT_EQ(waits[static_cast<int>(OpType::GPU)].producer_wait, 0);
+  EXPECT_DOUBLE_EQ(waits[static_cast<int>(OpType::CPU)].producer_wait, 2);
+}
+
+}  // namespace dali
@@ -0,0 +1,105 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_EXECUTOR_QUEUE_DEPTH_CONTROLLER_H_
+#define DALI_PIPELINE_EXECUTOR_QUEUE_DEPTH_CONTROLLER_H_
+
+#include <cstddef>
+
+namespace dali {
+
+/**
+ * @brief Decides when to change the depth of a prefetch queue, based on the stalls of the
+ * stages producing and consuming the queued buffers.
+ *
+ * If the consumer repeatedly has to wait for the data, the producer cannot keep up and
+ * a deeper queue can absorb the variation of its execution time. If the producer spends most
+ * of the iterations waiting for a free buffer while the consumer never waits, the queue is
+ * deeper than necessary and one buffer can be given back.
+ *
+ * The controller is not thread-safe.
+ */
+class QueueDepthController {
+ public:
+  QueueDepthController() = default;
+
+  QueueDepthController(int min_depth, int max_depth, int window, double min_wait)
+      : min_depth_(min_depth), max_depth_(max_depth), window_(window), min_wait_(min_wait) {}
+
+  /**
+   * @brief Records the time the producer waited for a free buffer in the current iteration
+   */
+  void RecordProducerWait(double seconds) {
+    if (seconds > min_wait_)
+      producer_stalls_++;
+  }
+
+  /**
+   * @brief Records the time the consumer waited for a ready buffer; finishes an iteration
+   */
+  void RecordConsumerWait(double seconds) {
+    if (seconds > min_wait_)
+      consumer_stalls_++;
+    iterations_++;
+  }
+
+  /**
+   * @brief Returns the suggested change of the depth: -1, 0 or 1
+   *
+   * @param depth         current depth of the queue
+   * @param slot_bytes    estimated memory of the buffers for one iteration
+   * @param memory_budget upper bound for the memory of the whole queue; 0 means no limit
+   *
+   * The observations are discarded when a decision is made.
+   */
+  int Decide(int depth, size_t slot_bytes, size_t memory_budget) {
+    bool limited = memory_budget > 0 && slot_bytes > 0;
+    if (limited && depth > min_depth_ && depth * slot_bytes > memory_budget) {
+      Reset();
+      return -1;
+    }
+    if (iterations_ < window_)
+      return 0;
+
+    int change = 0;
+    if (consumer_stalls_ * 4 >= iterations_) {
+      if (depth < max_depth_ && (!limited || (depth + 1) * slot_bytes <= memory_budget))
+        change = 1;
+    } else if (consumer_stalls_ == 0 && producer_stalls_ * 4 >= iterations_ * 3) {
+      if (depth > min_depth_)
+        change = -1;
+    }
+    Reset();
+    return change;
+  }
+
+  void Reset() {
+    iterations_ = 0;
+    producer_stalls_ = 0;
+    consumer_stalls_ = 0;
+  }
+
+ private:
+  int min_depth_ = 1, max_depth_ = 1;
+  int window_ = 16;
+  double min_wait_ = 0;
+
+  int iterations_ = 0;
+  int producer_stalls_ = 0;
+  int consumer_stalls_ = 0;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_EXECUTOR_QUEUE_DEPTH_CONTROLLER_H_
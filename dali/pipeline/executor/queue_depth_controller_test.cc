@@ -0,0 +1,84 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include "dali/pipeline/executor/queue_depth_controller.h"
+
+namespace dali {
+namespace test {
+
+namespace {
+
+constexpr double kStall = 1e-2;
+constexpr double kNoStall = 0;
+
+/**
+ * @brief Records `n` iterations with given waits and returns the decision
+ */
+int Simulate(QueueDepthController &ctrl, int n, double producer_wait, double consumer_wait,
+             int depth, size_t slot_bytes = 0, size_t budget = 0) {
+  int change = 0;
+  for (int i = 0; i < n; i++) {
+    ctrl.RecordProducerWait(producer_wait);
+    ctrl.RecordConsumerWait(consumer_wait);
+    change = ctrl.Decide(depth, slot_bytes, budget);
+    if (change != 0)
+      return change;
+  }
+  return change;
+}
+
+}  // namespace
+
+TEST(QueueDepthControllerTest, GrowsWhenConsumerStalls) {
+  QueueDepthController ctrl(1, 4, 8, 1e-4);
+  EXPECT_EQ(Simulate(ctrl, 7, kNoStall, kStall, 2), 0);
+  EXPECT_EQ(Simulate(ctrl, 1, kNoStall, kStall, 2), 1);
+}
+
+TEST(QueueDepthControllerTest, DoesNotExceedMaxDepth) {
+  QueueDepthController ctrl(1, 4, 8, 1e-4);
+  EXPECT_EQ(Simulate(ctrl, 32, kNoStall, kStall, 4), 0);
+}
+
+TEST(QueueDepthControllerTest, ShrinksWhenProducerStalls) {
+  QueueDepthController ctrl(1, 4, 8, 1e-4);
+  EXPECT_EQ(Simulate(ctrl, 8, kStall, kNoStall, 3), -1);
+  EXPECT_EQ(Simulate(ctrl, 32, kStall, kNoStall, 1), 0);
+}
+
+TEST(QueueDepthControllerTest, StableWhenBalanced) {
+  QueueDepthController ctrl(1, 4, 8, 1e-4);
+  EXPECT_EQ(Simulate(ctrl, 64, kNoStall, kNoStall, 2), 0);
+  // occasional stall of the consumer is not enough to grow the queue
+  for (int i = 0; i < 8; i++) {
+    ctrl.RecordProducerWait(kNoStall);
+    ctrl.RecordConsumerWait(i == 0 ? kStall : kNoStall);
+    EXPECT_EQ(ctrl.Decide(2, 0, 0), 0);
+  }
+}
+
+TEST(QueueDepthControllerTest, RespectsMemoryBudget) {
+  QueueDepthController ctrl(1, 4, 8, 1e-4);
+  // growing to 3 slots of 100 bytes would exceed the budget
+  EXPECT_EQ(Simulate(ctrl, 32, kNoStall, kStall, 2, 100, 250), 0);
+  // the buffers outgrew the budget - shrink immediately
+  ctrl.RecordConsumerWait(kStall);
+  EXPECT_EQ(ctrl.Decide(3, 100, 250), -1);
+  // but never below the minimum depth
+  EXPECT_EQ(ctrl.Decide(1, 1000, 250), 0);
+}
+
+}  // namespace test
+}  // namespace dali
@@ -53,6 +53,23 @@ struct QueueSizes {
   int cpu_size = 1, gpu_size = 1;
 };
 
+/**
+ * @brief Parameters of the adaptive prefetch queue depth
+ *
+ * The queues start with the depth given by `prefetch_queue_depth` and are grown or shrunk
+ * at runtime, based on observed stalls of the stages, up to `max_sizes`.
+ */
+struct AdaptiveQueueDepthParams {
+  // the buffers are prepared (but not allocated) for up to that many iterations
+  QueueSizes max_sizes;
+  // upper bound for the memory of the buffers of each queue, in bytes; 0 means no limit
+  size_t memory_budget = 0;
+  // the number of iterations observed before the depth of a queue is changed
+  int window = 16;
+  // waits shorter than that (in seconds) are not considered stalls
+  double min_wait = 1e-4;
+};
+
 struct OutputIdxs {
   explicit OutputIdxs(int queue_idx) : cpu(queue_idx),  mixed(queue_idx), gpu(queue_idx) {}
   OutputIdxs(int cpu, int mixed, int gpu) : cpu(cpu), mixed(mixed), gpu(gpu) {}
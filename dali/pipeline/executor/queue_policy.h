@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,15 +16,24 @@
 #define DALI_PIPELINE_EXECUTOR_QUEUE_POLICY_H_
 
 #include <cuda_runtime_api.h>
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdlib>
+#include <functional>
 #include <mutex>
 #include <queue>
+#include <utility>
 #include <vector>
 
 #include "dali/core/cuda_error.h"
+#include "dali/core/error_handling.h"
+#include "dali/pipeline/executor/queue_depth_controller.h"
+#include "dali/pipeline/executor/operator_timing.h"
 #include "dali/pipeline/executor/queue_metadata.h"
+#include "dali/pipeline/util/spsc_queue.h"
 
 namespace dali {
 
@@ -44,18 +53,36 @@ namespace dali {
 //   void QueueOutputIdxs(QueueIdxs idxs);
 //   // Get the indexes of ready outputs and mark them as in_use by the user
 //   OutputIdxs UseOutputIdxs();
+//   // Like UseOutputIdxs, but returns false instead of waiting, if no output is ready or
+//   // is_complete(idxs) is false for the oldest one
+//   bool TryUseOutputIdxs(OutputIdxs &idxs, IsComplete &&is_complete);
 //   // Release currently used output
 //   void ReleaseOutputIdxs();
 //   // Wake all waiting threads and skip further execution due to stop signaled
 //   void SignalStop();
 //   // Returns true if we signaled stop previously
 //   bool IsStopSignaled();
+//   // Let the policy change the number of buffers in use at runtime (if supported)
+//   void EnableAdaptiveDepth(const StageQueues &initial_depths,
+//                            const AdaptiveQueueDepthParams &params, ParkCallback on_park);
+//   // Report the memory used by the buffers of one iteration of the CPU or GPU queue
+//   void SetSlotBytes(OpType queue, size_t bytes);
+//   // Return the number of iterations currently allowed in the CPU and GPU queues
+//   QueueSizes ActiveQueueSizes() const;
+//   // Start or stop accumulating the time spent waiting on both sides of the queues
+//   void EnableWaitTiming(bool enable);
+//   // Return the accumulated waits, indexed with the stage producing the queue
+//   QueueWaitRecorder::WaitArray GetWaitTiming() const;
 // };
 
+// Called for a buffer index taken out of circulation by a policy with adaptive depth
+using ParkCallback = std::function<void(OpType stage, int idx)>;
+
 
 // Each stage requires ready buffers from previous stage and free buffers from current stage
 struct UniformQueuePolicy {
   static const int kInvalidIdx = -1;
+  static constexpr bool kSupportsAdaptiveDepth = false;
 
   static StageQueues GetQueueSizes(QueueSizes init_sizes) {
     DALI_ENFORCE(init_sizes.cpu_size == init_sizes.gpu_size,
@@ -73,11 +100,31 @@ struct UniformQueuePolicy {
     for (int i = 0; i < stage_queue_depths[OpType::CPU]; ++i) {
       free_queue_.push(i);
     }
+    depth_ = stage_queue_depths[OpType::CPU];
+  }
+
+  void EnableAdaptiveDepth(const StageQueues &, const AdaptiveQueueDepthParams &, ParkCallback) {
+    DALI_FAIL("Adaptive prefetch queue depth requires separated queues.");
+  }
+
+  void SetSlotBytes(OpType, size_t) {}
+
+  QueueSizes ActiveQueueSizes() const {
+    return QueueSizes(depth_);
+  }
+
+  void EnableWaitTiming(bool enable) {
+    queue_waits_.Enable(enable);
+  }
+
+  QueueWaitRecorder::WaitArray GetWaitTiming() const {
+    return queue_waits_.Get();
   }
 
   QueueIdxs AcquireIdxs(OpType stage) {
     if (!HasPreviousStage(stage)) {
       // Block until there is a free buffer to use
+      auto start = TimingCollector::Clock::now();
       std::unique_lock<std::mutex> lock(free_mutex_);
       free_cond_.wait(lock, [stage, this]() {
         return !free_queue_.empty() || stage_work_stop_[static_cast<int>(stage)];
@@ -87,6 +134,9 @@ struct UniformQueuePolicy {
       }
       int queue_idx = free_queue_.front();
       free_queue_.pop();
+      lock.unlock();
+      // the buffers go through all the stages, so the CPU stage waits for the whole pipeline
+      queue_waits_.AddProducerWait(stage, TimingCollector::Seconds(start));
       return QueueIdxs{queue_idx};
     }
 
@@ -135,6 +185,7 @@ struct UniformQueuePolicy {
   OutputIdxs UseOutputIdxs() {
     // Block until the work for a batch has been issued.
     // Move the queue id from ready to in_use
+    auto start = TimingCollector::Clock::now();
     std::unique_lock<std::mutex> lock(ready_mutex_);
     ready_cond_.wait(lock, [this]() {
       return !ready_queue_.empty() || ready_stop_;
@@ -144,22 +195,44 @@ struct UniformQueuePolicy {
     }
     int output_idx = ready_queue_.front();
     ready_queue_.pop();
-    in_use_queue_.push(output_idx);
     lock.unlock();
+    {
+      std::lock_guard<std::mutex> in_use_lock(in_use_mutex_);
+      in_use_queue_.push(output_idx);
+    }
+    queue_waits_.AddConsumerWait(OpType::GPU, TimingCollector::Seconds(start));
     return OutputIdxs{output_idx};
   }
 
+  template <typename IsComplete>
+  bool TryUseOutputIdxs(OutputIdxs &idxs, IsComplete &&is_complete) {
+    {
+      std::lock_guard<std::mutex> lock(ready_mutex_);
+      if (ready_stop_ || ready_queue_.empty() || !is_complete(OutputIdxs{ready_queue_.front()}))
+        return false;
+      idxs = OutputIdxs{ready_queue_.front()};
+      ready_queue_.pop();
+    }
+    {
+      std::lock_guard<std::mutex> in_use_lock(in_use_mutex_);
+      in_use_queue_.push(idxs.gpu);
+    }
+    queue_waits_.AddConsumerWait(OpType::GPU, 0);
+    return true;
+  }
+
   void ReleaseOutputIdxs() {
     // Mark the last in-use buffer as free and signal
-    // to waiting threads
-    // TODO(klecki): in_use_queue should be guarded, but we assume it is used only in synchronous
-    // python calls
+    // to waiting threads; the outputs can be released from other threads than the one using
+    // them, e.g. by the deleters of the DLPack tensors of the C API
+    std::unique_lock<std::mutex> in_use_lock(in_use_mutex_);
     if (!in_use_queue_.empty()) {
       {
         std::lock_guard<std::mutex> lock(free_mutex_);
         free_queue_.push(in_use_queue_.front());
         in_use_queue_.pop();
       }
+      in_use_lock.unlock();
       free_cond_.notify_one();
     }
   }
@@ -191,9 +264,12 @@ struct UniformQueuePolicy {
     return ready_stop_;
   }
 
+ protected:
+  QueueWaitRecorder queue_waits_;
+
  private:
   std::queue<int> ready_queue_, free_queue_, in_use_queue_;
-  std::mutex ready_mutex_, free_mutex_;
+  std::mutex ready_mutex_, free_mutex_, in_use_mutex_;
   std::condition_variable ready_cond_, free_cond_;
 
   static const int kOpCount = static_cast<int>(OpType::COUNT);
@@ -205,14 +281,20 @@ struct UniformQueuePolicy {
   std::array<bool, kOpCount> stage_work_stop_ = {{false, false, false}};
   // Used in IsStopSignaled with atomic access, an with mutex for ready_cond_
   std::atomic<bool> ready_stop_ = {false};
+  int depth_ = 0;
 };
 
 struct SeparateQueuePolicy;
 
 // Ready buffers from previous stage imply that we can process corresponding buffers from current
 // stage
+//
+// Each stage is run by a single thread, so the ready buffers are passed to the next stage through
+// lock-free single-producer single-consumer queues. The consumer polls the queue
+// DALI_STAGE_HANDOFF_SPIN times (0 by default) before it parks on a condition variable.
 struct SeparateQueuePolicy {
   static const int kInvalidIdx = -1;
+  static constexpr bool kSupportsAdaptiveDepth = true;
 
   static StageQueues GetQueueSizes(QueueSizes init_sizes) {
     StageQueues result;
@@ -229,7 +311,70 @@ struct SeparateQueuePolicy {
       for (int i = 0; i < stage_queue_depths[static_cast<OpType>(stage)]; i++) {
         stage_free_[stage].push(i);
       }
+      // every entry holds a distinct index of the stage
+      stage_ready_[stage].Reset(stage_queue_depths[static_cast<OpType>(stage)],
+                                HandoffSpinCount());
+    }
+    active_ = stage_queue_depths;
+  }
+
+  /**
+   * @brief Limits the number of buffers in circulation to `initial_depths` and lets the policy
+   * adjust it at runtime, up to the depths passed to InitializeQueues.
+   *
+   * The CPU queue and the Mixed/GPU queue are adjusted independently, depending on whether
+   * the stage consuming the queue or the one producing it stalls (see QueueDepthController).
+   * `on_park` is called, without holding any locks, with every buffer index that is taken out
+   * of circulation, so the executor can free the memory of the corresponding buffers.
+   */
+  void EnableAdaptiveDepth(const StageQueues &initial_depths,
+                           const AdaptiveQueueDepthParams &params, ParkCallback on_park) {
+    std::lock_guard<std::mutex> adaptive_lock(adaptive_mutex_);
+    StageQueues capacity;
+    for (int stage = 0; stage < static_cast<int>(OpType::COUNT); stage++) {
+      std::lock_guard<std::mutex> free_lock(stage_free_mutex_[stage]);
+      capacity[static_cast<OpType>(stage)] = stage_free_[stage].size();
+      int initial = initial_depths[static_cast<OpType>(stage)];
+      DALI_ENFORCE(initial >= 1 && initial <= static_cast<int>(stage_free_[stage].size()),
+                   "The initial queue depth must be between 1 and the maximum queue depth.");
+      std::queue<int> free;
+      for (int i = 0; i < initial; i++)
+        free.push(i);
+      stage_free_[stage].swap(free);
+      parked_[stage].clear();
+      for (int i = capacity[static_cast<OpType>(stage)] - 1; i >= initial; i--)
+        parked_[stage].push_back(i);
+      to_retire_[stage] = 0;
     }
+    active_ = initial_depths;
+    cpu_controller_ = QueueDepthController(1, capacity[OpType::CPU], params.window,
+                                           params.min_wait);
+    gpu_controller_ = QueueDepthController(1, capacity[OpType::GPU], params.window,
+                                           params.min_wait);
+    memory_budget_ = params.memory_budget;
+    on_park_ = std::move(on_park);
+    adaptive_ = true;
+  }
+
+  /**
+   * @brief Reports the memory of the buffers of one iteration of the CPU queue (OpType::CPU)
+   * or the Mixed/GPU queue (OpType::GPU)
+   */
+  void SetSlotBytes(OpType queue, size_t bytes) {
+    (queue == OpType::CPU ? cpu_slot_bytes_ : gpu_slot_bytes_) = bytes;
+  }
+
+  QueueSizes ActiveQueueSizes() const {
+    std::lock_guard<std::mutex> adaptive_lock(adaptive_mutex_);
+    return QueueSizes(active_[OpType::CPU], active_[OpType::GPU]);
+  }
+
+  void EnableWaitTiming(bool enable) {
+    queue_waits_.Enable(enable);
+  }
+
+  QueueWaitRecorder::WaitArray GetWaitTiming() const {
+    return queue_waits_.Get();
   }
 
   QueueIdxs AcquireIdxs(OpType stage) {
@@ -239,22 +384,21 @@ struct SeparateQueuePolicy {
     int current_stage = static_cast<int>(stage);
     // We actually have a previous stage
     int previous_stage = -1;
+    double ready_wait = 0, free_wait = 0;
+    bool timed = adaptive_ || queue_waits_.IsEnabled();
     if (HasPreviousStage(stage)) {
       previous_stage = static_cast<int>(PreviousStage(stage));
-      std::unique_lock<std::mutex> ready_previous_lock(stage_ready_mutex_[previous_stage]);
-      stage_ready_cv_[previous_stage].wait(ready_previous_lock, [previous_stage, this]() {
-        return !stage_ready_[previous_stage].empty() || stage_ready_stop_[previous_stage];
-      });
-      if (stage_ready_stop_[previous_stage]) {
+      auto start = Clock::now();
+      // We fill the information about all the previous stages here
+      if (!stage_ready_[previous_stage].Pop(result)) {
         return QueueIdxs{kInvalidIdx};
       }
-      // We fill the information about all the previous stages here
-      result = stage_ready_[previous_stage].front();
-      stage_ready_[previous_stage].pop();
-      // We are the only ones waiting for the lock, so we do not try to wake anyone
+      if (timed)
+        ready_wait = Seconds(start);
     }
     // There always is a current stage
     {
+      auto start = Clock::now();
       std::unique_lock<std::mutex> free_current_lock(stage_free_mutex_[current_stage]);
       stage_free_cv_[current_stage].wait(free_current_lock, [current_stage, this]() {
         return !stage_free_[current_stage].empty() || stage_free_stop_[current_stage];
@@ -265,21 +409,29 @@ struct SeparateQueuePolicy {
       // We add info about current stage
       result[stage] = stage_free_[current_stage].front();
       stage_free_[current_stage].pop();
+      if (timed)
+        free_wait = Seconds(start);
+    }
+    if (previous_stage >= 0)
+      queue_waits_.AddConsumerWait(PreviousStage(stage), ready_wait);
+    queue_waits_.AddProducerWait(stage, free_wait);
+    if (adaptive_ && stage == OpType::CPU) {
+      RecordProducerWait(OpType::CPU, free_wait);
+    } else if (adaptive_ && stage == OpType::MIXED) {
+      // The mixed stage consumes the CPU queue and produces the Mixed/GPU queue
+      RecordConsumerWait(OpType::CPU, ready_wait);
+      RecordProducerWait(OpType::GPU, free_wait);
     }
     return result;
   }
 
   void ReleaseIdxs(OpType stage, QueueIdxs idxs, cudaStream_t stage_stream = 0) {
-    if (idxs[stage] == kInvalidIdx) {
+    // The GPU stage has no consumer, its buffers are passed on through QueueOutputIdxs
+    if (idxs[stage] == kInvalidIdx || stage == OpType::GPU) {
       return;
     }
-    int current_stage = static_cast<int>(stage);
-    {
-      std::lock_guard<std::mutex> ready_current_lock(stage_ready_mutex_[current_stage]);
-      // Store the idxs up to the point of stage that we processed
-      stage_ready_[current_stage].push(idxs);
-    }
-    stage_ready_cv_[current_stage].notify_one();
+    // Store the idxs up to the point of stage that we processed
+    stage_ready_[static_cast<int>(stage)].Push(idxs);
   }
 
   template <OpType op_type>
@@ -304,6 +456,7 @@ struct SeparateQueuePolicy {
   OutputIdxs UseOutputIdxs() {
     // Block until the work for a batch has been issued.
     // Move the queue id from ready to in_use
+    auto start = Clock::now();
     std::unique_lock<std::mutex> ready_lock(ready_output_mutex_);
     ready_output_cv_.wait(ready_lock, [this]() {
       return !ready_output_queue_.empty() || ready_stop_;
@@ -313,21 +466,46 @@ struct SeparateQueuePolicy {
     }
     auto output_idx = ready_output_queue_.front();
     ready_output_queue_.pop();
-    // TODO(klecki): in_use_queue should be guarded, but we assume it is used only in synchronous
-    // python calls
-    in_use_queue_.push(output_idx);
     ready_lock.unlock();
+    {
+      std::lock_guard<std::mutex> in_use_lock(in_use_mutex_);
+      in_use_queue_.push(output_idx);
+    }
+    double wait = Seconds(start);
+    queue_waits_.AddConsumerWait(OpType::GPU, wait);
+    if (adaptive_)
+      RecordConsumerWait(OpType::GPU, wait);
     return output_idx;
   }
 
+  template <typename IsComplete>
+  bool TryUseOutputIdxs(OutputIdxs &idxs, IsComplete &&is_complete) {
+    {
+      std::lock_guard<std::mutex> ready_lock(ready_output_mutex_);
+      if (ready_stop_ || ready_output_queue_.empty() || !is_complete(ready_output_queue_.front()))
+        return false;
+      idxs = ready_output_queue_.front();
+      ready_output_queue_.pop();
+    }
+    {
+      std::lock_guard<std::mutex> in_use_lock(in_use_mutex_);
+      in_use_queue_.push(idxs);
+    }
+    // the output was ready, so the consumer didn't wait for it
+    queue_waits_.AddConsumerWait(OpType::GPU, 0);
+    if (adaptive_)
+      RecordConsumerWait(OpType::GPU, 0);
+    return true;
+  }
+
   void ReleaseOutputIdxs() {
     // Mark the last in-use buffer as free and signal
     // to waiting threads
+    std::unique_lock<std::mutex> in_use_lock(in_use_mutex_);
     if (!in_use_queue_.empty()) {
-      // TODO(klecki): in_use_queue should be guarded, but we assume it is used only in synchronous
-      // python calls
       auto processed = in_use_queue_.front();
       in_use_queue_.pop();
+      in_use_lock.unlock();
       ReleaseStageIdx(OpType::CPU, processed.cpu);
       ReleaseStageIdx(OpType::MIXED, processed.mixed);
       ReleaseStageIdx(OpType::GPU, processed.gpu);
@@ -338,7 +516,7 @@ struct SeparateQueuePolicy {
     ready_output_cv_.notify_all();
     free_cond_.notify_all();
     for (int i = 0; i < static_cast<int>(OpType::COUNT); ++i) {
-      stage_ready_cv_[i].notify_all();
+      stage_ready_[i].NotifyAll();
       stage_free_cv_[i].notify_all();
     }
   }
@@ -357,10 +535,7 @@ struct SeparateQueuePolicy {
         std::lock_guard<std::mutex> l(stage_free_mutex_[i]);
         stage_free_stop_[i] = true;
       }
-      {
-        std::lock_guard<std::mutex> l(stage_ready_mutex_[i]);
-        stage_ready_stop_[i] = true;
-      }
+      stage_ready_[i].Stop();
     }
     NotifyAll();
   }
@@ -371,35 +546,134 @@ struct SeparateQueuePolicy {
     return ready_stop_;
   }
 
+ protected:
+  QueueWaitRecorder queue_waits_;
+
  private:
+  using Clock = std::chrono::steady_clock;
+
+  static int HandoffSpinCount() {
+    static const int spin_count = []() {
+      const char *env = std::getenv("DALI_STAGE_HANDOFF_SPIN");
+      return env ? std::max(atoi(env), 0) : 0;
+    }();
+    return spin_count;
+  }
+
+  static double Seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
   void ReleaseStageIdx(OpType stage, int idx) {
     auto released_stage = static_cast<int>(stage);
+    bool park = false;
     // We release the consumed buffer
     {
       std::lock_guard<std::mutex> free_lock(stage_free_mutex_[released_stage]);
-      stage_free_[released_stage].push(idx);
+      if (to_retire_[released_stage] > 0) {
+        // the queue was shrunk while the buffer was in use
+        to_retire_[released_stage]--;
+        park = true;
+      } else {
+        stage_free_[released_stage].push(idx);
+      }
+    }
+    if (park) {
+      Park(released_stage, idx);
+      return;
     }
     // We freed buffer, so we notfiy the released stage it can continue it's work
     stage_free_cv_[released_stage].notify_one();
   }
 
+  void RecordProducerWait(OpType queue, double seconds) {
+    std::lock_guard<std::mutex> adaptive_lock(adaptive_mutex_);
+    (queue == OpType::CPU ? cpu_controller_ : gpu_controller_).RecordProducerWait(seconds);
+  }
+
+  void RecordConsumerWait(OpType queue, double seconds) {
+    int change;
+    {
+      std::lock_guard<std::mutex> adaptive_lock(adaptive_mutex_);
+      auto &controller = queue == OpType::CPU ? cpu_controller_ : gpu_controller_;
+      size_t slot_bytes = queue == OpType::CPU ? cpu_slot_bytes_ : gpu_slot_bytes_;
+      controller.RecordConsumerWait(seconds);
+      change = controller.Decide(active_[queue], slot_bytes, memory_budget_);
+    }
+    if (change == 0)
+      return;
+    auto apply = [&](OpType stage) {
+      if (change > 0)
+        GrowStage(static_cast<int>(stage));
+      else
+        ShrinkStage(static_cast<int>(stage));
+    };
+    if (queue == OpType::CPU) {
+      apply(OpType::CPU);
+    } else {
+      // Mixed and GPU are bound together due to being outputs
+      apply(OpType::MIXED);
+      apply(OpType::GPU);
+    }
+  }
+
+  void GrowStage(int stage) {
+    {
+      std::lock_guard<std::mutex> adaptive_lock(adaptive_mutex_);
+      std::lock_guard<std::mutex> free_lock(stage_free_mutex_[stage]);
+      if (to_retire_[stage] > 0) {
+        // a buffer which is still in use was going to be parked - keep it instead
+        to_retire_[stage]--;
+      } else if (!parked_[stage].empty()) {
+        stage_free_[stage].push(parked_[stage].back());
+        parked_[stage].pop_back();
+      } else {
+        return;
+      }
+      active_[static_cast<OpType>(stage)]++;
+    }
+    stage_free_cv_[stage].notify_one();
+  }
+
+  void ShrinkStage(int stage) {
+    int idx = kInvalidIdx;
+    {
+      std::lock_guard<std::mutex> adaptive_lock(adaptive_mutex_);
+      std::lock_guard<std::mutex> free_lock(stage_free_mutex_[stage]);
+      if (!stage_free_[stage].empty()) {
+        idx = stage_free_[stage].front();
+        stage_free_[stage].pop();
+      } else {
+        // all the buffers are in use - park the first one released
+        to_retire_[stage]++;
+      }
+      active_[static_cast<OpType>(stage)]--;
+    }
+    if (idx != kInvalidIdx)
+      Park(stage, idx);
+  }
+
+  void Park(int stage, int idx) {
+    if (on_park_)
+      on_park_(static_cast<OpType>(stage), idx);
+    std::lock_guard<std::mutex> adaptive_lock(adaptive_mutex_);
+    parked_[stage].push_back(idx);
+  }
+
   void ReleaseStageIdx(OpType stage, QueueIdxs idxs) {
     ReleaseStageIdx(stage, idxs[stage]);
   }
 
   static const int kOpCount = static_cast<int>(OpType::COUNT);
-  // For syncing free and ready buffers between stages
+  // For syncing free buffers between stages
   std::array<std::mutex, kOpCount> stage_free_mutex_;
-  std::array<std::mutex, kOpCount> stage_ready_mutex_;
   // We use a dedicated stop flag for every mutex & condition_varialbe pair,
   // so when using them in cond_var predicate,
   // we know the changes are propagated properly and we won't miss a notify.
   std::array<bool, kOpCount> stage_free_stop_ = {{false, false, false}};
-  std::array<bool, kOpCount> stage_ready_stop_ = {{false, false, false}};
   // Used in IsStopSignaled with atomic access, an with mutex for ready_output_cv_
   std::atomic<bool> ready_stop_ = {false};
   std::array<std::condition_variable, kOpCount> stage_free_cv_;
-  std::array<std::condition_variable, kOpCount> stage_ready_cv_;
 
   // Buffers are rotated between being 'free', where the
   // pipeline is ok to fill them with data, 'ready', where
@@ -409,14 +683,31 @@ struct SeparateQueuePolicy {
   // The buffer is then returned the the ready queue the
   // next time Ouputs() is called.
   std::array<std::queue<int>, kOpCount> stage_free_;
-  std::array<std::queue<QueueIdxs>, kOpCount> stage_ready_;
+  // Ready buffers are handed from the stage to the next one; the free buffers can be released
+  // by the user thread as well, so they are guarded by the mutexes
+  std::array<SpscHandoff<QueueIdxs>, kOpCount> stage_ready_;
 
   std::condition_variable ready_output_cv_, free_cond_;
   // Output ready and in_use mutexes and queues
-  std::mutex ready_output_mutex_;
+  std::mutex ready_output_mutex_, in_use_mutex_;
 
   std::queue<OutputIdxs> ready_output_queue_;
   std::queue<OutputIdxs> in_use_queue_;
+
+  // Adaptive queue depth; set up before the execution starts
+  bool adaptive_ = false;
+  ParkCallback on_park_;
+  size_t memory_budget_ = 0;
+  // Guards the controllers, active_ and parked_; when nested, locked before stage_free_mutex_
+  mutable std::mutex adaptive_mutex_;
+  QueueDepthController cpu_controller_, gpu_controller_;
+  // the number of buffer indices in circulation
+  StageQueues active_;
+  // indices taken out of circulation
+  std::array<std::vector<int>, kOpCount> parked_;
+  // the number of indices to park when released; guarded by stage_free_mutex_
+  std::array<int, kOpCount> to_retire_ = {{0, 0, 0}};
+  std::atomic<size_t> cpu_slot_bytes_{0}, gpu_slot_bytes_{0};
 };
 
 
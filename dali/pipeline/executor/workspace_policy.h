@@ -1,4 +1,4 @@
-// Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -140,13 +140,28 @@ void SetupInputOutput(op_type_to_workspace_t<op_type> &ws, const OpGraph &graph,
     auto parent_op_type = parent_node.op_type;
 
     auto tensor_device = graph.Tensor(tid).producer.storage_device;
-    DALI_ENFORCE(tensor_device == StorageDevice::CPU,
-      "Argument Inputs must be stored in CPU memory");
 
     auto add_arg_input = [&](auto &queue) {
       auto tensor = queue[idxs[parent_op_type]];
       ws.AddArgumentInput(arg_pair.first, tensor);
     };
+    if (tensor_device == StorageDevice::GPU) {
+      DALI_ENFORCE(node.op_type == OpType::GPU &&
+                   node.spec.GetSchema().ArgSupportsGPUInput(arg_pair.first),
+                   make_string("Argument input \"", arg_pair.first, "\" of \"", node.spec.name(),
+                               "\" must be stored in CPU memory"));
+      switch (parent_op_type) {
+        case OpType::GPU:
+          add_arg_input(get_queue<OpType::GPU, StorageDevice::GPU>(tensor_to_store_queue[tid]));
+          break;
+        case OpType::MIXED:
+          add_arg_input(get_queue<OpType::MIXED, StorageDevice::GPU>(tensor_to_store_queue[tid]));
+          break;
+        default:
+          DALI_FAIL("Unexpected source backend for GPU ArgumentInput");
+      }
+      continue;
+    }
     switch (parent_op_type) {
       case OpType::CPU:
         add_arg_input(get_queue<OpType::CPU, StorageDevice::CPU>(tensor_to_store_queue[tid]));
@@ -0,0 +1,279 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "dali/pipeline/graph/buffer_reuse.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief Groups of tensors sharing the memory, with the liveness of the whole group
+ */
+class AliasSets {
+ public:
+  struct Info {
+    // all the tensors are stage-local and not preserved
+    bool reusable = true;
+    // the first and the last position in the stage at which the memory is used
+    Index def = 0, last_use = 0;
+    // number of tensors in the group stored in the buffers allocated by the executor
+    int num_owners = 0;
+  };
+
+  explicit AliasSets(std::vector<Info> infos) : info_(std::move(infos)) {
+    parent_.resize(info_.size());
+    std::iota(parent_.begin(), parent_.end(), 0);
+  }
+
+  TensorNodeId Find(TensorNodeId id) {
+    while (parent_[id] != id) {
+      parent_[id] = parent_[parent_[id]];
+      id = parent_[id];
+    }
+    return id;
+  }
+
+  void Join(TensorNodeId a, TensorNodeId b) {
+    a = Find(a);
+    b = Find(b);
+    if (a == b)
+      return;
+    auto &ia = info_[a], &ib = info_[b];
+    ia.reusable = ia.reusable && ib.reusable;
+    ia.def = std::min(ia.def, ib.def);
+    ia.last_use = std::max(ia.last_use, ib.last_use);
+    ia.num_owners += ib.num_owners;
+    parent_[b] = a;
+  }
+
+  Info &operator[](TensorNodeId id) {
+    return info_[Find(id)];
+  }
+
+ private:
+  std::vector<TensorNodeId> parent_;
+  std::vector<Info> info_;
+};
+
+bool CanInferOutputs(const OpNode &node) {
+  return node.op && node.op->CanInferOutputs();
+}
+
+bool IsPassThroughOutput(const OpNode &node, int output_idx) {
+  const auto &schema = node.spec.GetSchema();
+  for (int i = 0; i < node.spec.NumRegularInput(); i++) {
+    if (schema.IsPassThrough(i, output_idx))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Joins the inputs with the outputs of the operator which can alias them
+ */
+void JoinAliases(AliasSets &sets, const OpNode &node) {
+  const auto &schema = node.spec.GetSchema();
+  if (!CanInferOutputs(node)) {
+    // The operator allocates its outputs on its own - it might as well share the inputs
+    for (auto in : node.parent_tensors) {
+      for (auto out : node.children_tensors)
+        sets.Join(in, out);
+    }
+  } else if (schema.HasPassThrough()) {
+    for (int i = 0; i < node.spec.NumRegularInput(); i++) {
+      for (int out_idx = 0; out_idx < node.spec.NumOutput(); out_idx++) {
+        if (schema.IsPassThrough(i, out_idx))
+          sets.Join(node.parent_tensors[i], node.children_tensors[out_idx]);
+      }
+    }
+  }
+}
+
+bool CanRunInPlace(const OpNode &node) {
+  const auto &schema = node.spec.GetSchema();
+  return CanInferOutputs(node) && node.spec.NumRegularInput() > 0 && node.spec.NumOutput() > 0 &&
+         !schema.HasPassThrough() && schema.SupportsInPlace(node.spec);
+}
+
+}  // namespace
+
+bool BufferReusePlan::IsShared(TensorNodeId id) const {
+  auto buffer = storage[id];
+  return std::count(storage.begin(), storage.end(), buffer) > 1;
+}
+
+int BufferReusePlan::NumBuffers() const {
+  int result = 0;
+  for (size_t i = 0; i < storage.size(); i++) {
+    if (storage[i] == static_cast<TensorNodeId>(i))
+      result++;
+  }
+  return result;
+}
+
+BufferReusePlan PlanBufferReuse(const OpGraph &graph,
+                                const std::vector<TensorNodeId> &preserved) {
+  int num_tensors = graph.NumTensor();
+  BufferReusePlan plan;
+  plan.storage.resize(num_tensors);
+  std::iota(plan.storage.begin(), plan.storage.end(), 0);
+  plan.in_place.resize(graph.NumOp(), false);
+
+  // Liveness of the individual tensors, within the stage of the producer
+  std::vector<AliasSets::Info> infos(num_tensors);
+  std::vector<bool> owner(num_tensors);
+  for (int id = 0; id < num_tensors; id++) {
+    const auto &tensor = graph.Tensor(id);
+    const auto &producer = graph.Node(tensor.producer.node);
+    auto &info = infos[id];
+    info.def = info.last_use = producer.partition_index;
+    for (auto &consumer_edge : tensor.consumers) {
+      const auto &consumer = graph.Node(consumer_edge.node);
+      if (consumer.op_type != producer.op_type)
+        info.reusable = false;
+      else
+        info.last_use = std::max<Index>(info.last_use, consumer.partition_index);
+    }
+    owner[id] = CanInferOutputs(producer) && !IsPassThroughOutput(producer, tensor.producer.index);
+    info.num_owners = owner[id];
+  }
+  for (auto id : preserved)
+    infos[id].reusable = false;
+
+  AliasSets sets(std::move(infos));
+  for (int i = 0; i < graph.NumOp(); i++)
+    JoinAliases(sets, graph.Node(i));
+
+  auto same_place = [&](TensorNodeId a, TensorNodeId b) {
+    const auto &ta = graph.Tensor(a), &tb = graph.Tensor(b);
+    return graph.Node(ta.producer.node).op_type == graph.Node(tb.producer.node).op_type &&
+           ta.producer.storage_device == tb.producer.storage_device;
+  };
+
+  // In-place execution: the output joins the memory of the input, when this is its last use.
+  // The stages are processed in the execution order, so that the chains of in-place operators
+  // see the extended liveness of the memory.
+  for (int stage = 0; stage < static_cast<int>(OpType::COUNT); stage++) {
+    for (int p = 0; p < graph.NumOp(static_cast<OpType>(stage)); p++) {
+      const auto &node = graph.Node(static_cast<OpType>(stage), p);
+      if (!CanRunInPlace(node))
+        continue;
+      auto in = node.parent_tensors[0];
+      auto out = node.children_tensors[0];
+      if (!owner[out] || !same_place(in, out) || sets.Find(in) == sets.Find(out))
+        continue;
+      const auto &in_info = sets[in];
+      const auto &out_info = sets[out];
+      if (!in_info.reusable || in_info.num_owners != 1 || in_info.last_use != p ||
+          !out_info.reusable || out_info.num_owners != 1)
+        continue;
+      // no other input can alias the memory written by the operator
+      bool other_alias = false;
+      for (size_t i = 1; i < node.parent_tensors.size(); i++)
+        other_alias = other_alias || sets.Find(node.parent_tensors[i]) == sets.Find(in);
+      if (other_alias)
+        continue;
+      plan.in_place[node.id] = true;
+      // The output's own buffer is used only when the operator can't run in place
+      owner[out] = false;
+      sets[out].num_owners--;
+      sets.Join(in, out);
+    }
+  }
+
+  // Assigns the buffers to the groups of the tensors, separately for each stage and device.
+  // Each group is stored in the buffer of its owner.
+  std::map<std::pair<int, StorageDevice>, std::vector<TensorNodeId>> groups;
+  for (int id = 0; id < num_tensors; id++) {
+    if (!owner[id])
+      continue;
+    const auto &info = sets[id];
+    if (!info.reusable || info.num_owners != 1)
+      continue;
+    const auto &tensor = graph.Tensor(id);
+    auto stage = static_cast<int>(graph.Node(tensor.producer.node).op_type);
+    groups[{stage, tensor.producer.storage_device}].push_back(id);
+  }
+  for (auto &group : groups) {
+    auto &owners = group.second;
+    std::stable_sort(owners.begin(), owners.end(), [&](TensorNodeId a, TensorNodeId b) {
+      return sets[a].def < sets[b].def;
+    });
+    // the tensors owning the buffers and the last uses of the buffers
+    std::vector<std::pair<TensorNodeId, Index>> buffers;
+    for (auto id : owners) {
+      const auto &info = sets[id];
+      auto it = std::find_if(buffers.begin(), buffers.end(), [&](const auto &buffer) {
+        return buffer.second < info.def;
+      });
+      if (it == buffers.end()) {
+        buffers.emplace_back(id, info.last_use);
+      } else {
+        plan.storage[id] = it->first;
+        it->second = info.last_use;
+      }
+    }
+  }
+
+  // The producers write into the output of the joining operator, if nothing else uses the memory
+  // of their outputs; each producer joins at most one of its outputs
+  std::vector<bool> joined_producer(graph.NumOp(), false);
+  for (int p = 0; p < graph.NumOp(OpType::GPU); p++) {
+    const auto &node = graph.Node(OpType::GPU, p);
+    if (!CanInferOutputs(node) || node.spec.NumOutput() != 1 || plan.in_place[node.id] ||
+        !node.spec.GetSchema().ConcatenatesInputs(node.spec))
+      continue;
+    auto out = node.children_tensors[0];
+    if (graph.Tensor(out).producer.storage_device != StorageDevice::GPU || plan.IsShared(out))
+      continue;
+    BufferReusePlan::JoinedInputs join{node.id, {}};
+    for (int i = 0; i < node.spec.NumRegularInput(); i++) {
+      auto in = node.parent_tensors[i];
+      const auto &tensor = graph.Tensor(in);
+      const auto &producer = graph.Node(tensor.producer.node);
+      if (producer.op_type != OpType::GPU || tensor.producer.storage_device != StorageDevice::GPU ||
+          tensor.consumers.size() != 1 || !owner[in] || !sets[in].reusable ||
+          plan.IsShared(in) || joined_producer[producer.id])
+        break;
+      join.producers.emplace_back(producer.id, tensor.producer.index);
+      joined_producer[producer.id] = true;
+    }
+    if (static_cast<int>(join.producers.size()) != node.spec.NumRegularInput()) {
+      for (auto &producer : join.producers)
+        joined_producer[producer.first] = false;
+      continue;
+    }
+    plan.joins.push_back(std::move(join));
+  }
+  return plan;
+}
+
+void ShareBackingStorage(std::vector<tensor_data_store_queue_t> &tensor_to_store_queue,
+                         const BufferReusePlan &plan) {
+  DALI_ENFORCE(tensor_to_store_queue.size() == plan.storage.size(),
+               "The buffer reuse plan doesn't match the graph.");
+  for (size_t id = 0; id < plan.storage.size(); id++) {
+    if (plan.storage[id] != static_cast<TensorNodeId>(id))
+      tensor_to_store_queue[id] = tensor_to_store_queue[plan.storage[id]];
+  }
+}
+
+}  // namespace dali
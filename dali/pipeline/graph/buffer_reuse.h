@@ -0,0 +1,112 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_GRAPH_BUFFER_REUSE_H_
+#define DALI_PIPELINE_GRAPH_BUFFER_REUSE_H_
+
+#include <utility>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/pipeline/graph/op_graph.h"
+#include "dali/pipeline/workspace/workspace_data_factory.h"
+
+namespace dali {
+
+/**
+ * @brief Describes which tensors of the OpGraph can be stored in the same buffers
+ */
+struct BufferReusePlan {
+  /**
+   * @brief For every tensor, the id of the tensor whose buffer it uses;
+   * the tensors using their own buffers point to themselves.
+   */
+  std::vector<TensorNodeId> storage;
+
+  /**
+   * @brief For every operator, whether its output 0 may be computed in place of the input 0
+   *
+   * The operator runs in place only if the shape and type of the output matches the input,
+   * which is checked by the executor after the operator's Setup.
+   */
+  std::vector<bool> in_place;
+
+  /**
+   * @brief An operator concatenating its inputs (see OpSchema::ConcatenatesInputsFn), whose
+   * producers can write their outputs directly into its output 0
+   */
+  struct JoinedInputs {
+    OpNodeId consumer;
+    /// The producer and the index of its output, for each regular input of the consumer
+    std::vector<std::pair<OpNodeId, int>> producers;
+  };
+
+  /**
+   * @brief The operators whose inputs can be placed in the output
+   *
+   * Only the GPU stage is considered - the inputs placed in the output are TensorLists
+   * referencing its parts.
+   */
+  std::vector<JoinedInputs> joins;
+
+  /**
+   * @brief Returns true if the buffer of the tensor is used by some other tensor as well
+   */
+  DLL_PUBLIC bool IsShared(TensorNodeId id) const;
+
+  /**
+   * @brief Number of distinct buffers needed for the tensors
+   */
+  DLL_PUBLIC int NumBuffers() const;
+};
+
+/**
+ * @brief Runs the liveness analysis of the tensors in the graph and assigns the buffers,
+ * so that the tensors which are not alive at the same time use the same memory.
+ *
+ * A tensor can reuse the buffer only if it is produced and consumed within one stage,
+ * where the operators run one by one, in the order of their partition indices. Its liveness
+ * spans from the producer to the last consumer. The outputs that nobody consumes (dead outputs)
+ * are alive only while the producer runs, so they can use the memory of any tensor that is
+ * dead by then.
+ *
+ * The outputs of the operators which can pass their inputs through (see OpSchema::PassThrough)
+ * or which allocate the outputs on their own (CanInferOutputs() returns false) may alias
+ * the inputs, so they extend the liveness of the inputs' buffers. For the same reason only
+ * the outputs allocated by the executor are assigned to the shared buffers.
+ *
+ * An operator declaring in-place support (see OpSchema::InPlaceFn) can compute the output 0
+ * in the memory of the input 0, if it's the last use of that memory.
+ *
+ * The inputs of an operator concatenating them (see OpSchema::ConcatenatesInputsFn) can be written
+ * directly into its output by their producers, if the operator is their only consumer and their
+ * memory is not shared otherwise.
+ *
+ * @param graph graph with instantiated operators
+ * @param preserved tensors which must not share the buffers, e.g. the pipeline outputs
+ */
+DLL_PUBLIC BufferReusePlan PlanBufferReuse(const OpGraph &graph,
+                                           const std::vector<TensorNodeId> &preserved);
+
+/**
+ * @brief Makes the tensors use the buffers assigned by the plan.
+ *
+ * The tensors which reuse the buffers are unbuffered (queue size 1), so the queue is shared.
+ */
+DLL_PUBLIC void ShareBackingStorage(std::vector<tensor_data_store_queue_t> &tensor_to_store_queue,
+                                    const BufferReusePlan &plan);
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_GRAPH_BUFFER_REUSE_H_
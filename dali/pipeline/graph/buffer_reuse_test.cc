@@ -0,0 +1,160 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "dali/pipeline/graph/buffer_reuse.h"
+#include "dali/test/dali_test.h"
+
+namespace dali {
+
+class BufferReuseTest : public DALITest {
+ public:
+  void AddOp(OpSpec spec) {
+    spec.AddArg("max_batch_size", 1)
+        .AddArg("num_threads", 1)
+        .AddArg("device_id", 0);
+    graph_.AddOp(spec, "");
+  }
+
+  void AddCopy(const std::string &input, const std::string &output) {
+    AddOp(OpSpec("Copy")
+              .AddArg("device", "cpu")
+              .AddInput(input, "cpu")
+              .AddOutput(output, "cpu"));
+  }
+
+  void AddArithmetic(const std::string &expr, const std::vector<std::string> &inputs,
+                     const std::string &output) {
+    OpSpec spec("ArithmeticGenericOp");
+    spec.AddArg("device", "cpu").AddArg("expression_desc", expr);
+    for (auto &input : inputs)
+      spec.AddInput(input, "cpu");
+    spec.AddOutput(output, "cpu");
+    AddOp(spec);
+  }
+
+  BufferReusePlan Plan(const std::vector<std::string> &outputs) {
+    graph_.InstantiateOperators();
+    std::vector<TensorNodeId> preserved;
+    for (auto &name : outputs)
+      preserved.push_back(graph_.TensorId(name + "_cpu"));
+    return PlanBufferReuse(graph_, preserved);
+  }
+
+  TensorNodeId Id(const std::string &name) const {
+    return graph_.TensorId(name + "_cpu");
+  }
+
+  OpGraph graph_;
+};
+
+TEST_F(BufferReuseTest, DeadTensorsShareBuffers) {
+  AddOp(OpSpec("ExternalSource").AddArg("device", "cpu").AddOutput("data", "cpu"));
+  AddCopy("data", "a");
+  AddCopy("a", "b");
+  AddCopy("b", "c");
+  AddCopy("c", "d");
+  auto plan = Plan({"d"});
+
+  // `a` is dead when `c` is produced
+  EXPECT_EQ(plan.storage[Id("c")], Id("a"));
+  EXPECT_EQ(plan.storage[Id("b")], Id("b"));
+  // the output of the external source isn't allocated by the executor
+  EXPECT_EQ(plan.storage[Id("data")], Id("data"));
+  // the pipeline output is preserved
+  EXPECT_EQ(plan.storage[Id("d")], Id("d"));
+  EXPECT_TRUE(plan.IsShared(Id("a")));
+  EXPECT_FALSE(plan.IsShared(Id("b")));
+  EXPECT_EQ(plan.NumBuffers(), 4);
+}
+
+TEST_F(BufferReuseTest, AliasesExtendLiveness) {
+  AddOp(OpSpec("ExternalSource").AddArg("device", "cpu").AddOutput("data", "cpu"));
+  AddCopy("data", "a");
+  // the output of Reshape shares the memory of `a`
+  AddOp(OpSpec("Reshape")
+            .AddArg("device", "cpu")
+            .AddArg("layout", TensorLayout("HWC"))
+            .AddInput("a", "cpu")
+            .AddOutput("r", "cpu"));
+  AddCopy("r", "b");
+  AddCopy("b", "c");
+  AddCopy("c", "d");
+  auto plan = Plan({"d"});
+
+  EXPECT_EQ(plan.storage[Id("b")], Id("b"));
+  EXPECT_EQ(plan.storage[Id("c")], Id("a"));
+  EXPECT_EQ(plan.storage[Id("r")], Id("r"));
+}
+
+TEST_F(BufferReuseTest, InPlace) {
+  AddOp(OpSpec("ExternalSource").AddArg("device", "cpu").AddOutput("data", "cpu"));
+  AddCopy("data", "a");
+  // `a` is used later, so it can't be overwritten
+  AddArithmetic("neg(&0)", {"a"}, "b");
+  AddArithmetic("add(&0 &1)", {"a", "b"}, "c");
+  // the producer of the input doesn't use the executor's buffer
+  AddArithmetic("neg(&0)", {"data"}, "e");
+  AddArithmetic("add(&0 &1)", {"c", "e"}, "f");
+  auto plan = Plan({"f"});
+
+  auto op_id = [&](const std::string &output) {
+    return graph_.Tensor(Id(output)).producer.node;
+  };
+  EXPECT_FALSE(plan.in_place[op_id("b")]);
+  EXPECT_TRUE(plan.in_place[op_id("c")]);
+  EXPECT_FALSE(plan.in_place[op_id("e")]);
+  // the pipeline output has to stay in its own buffer
+  EXPECT_FALSE(plan.in_place[op_id("f")]);
+}
+
+TEST_F(BufferReuseTest, JoinedInputs) {
+  AddOp(OpSpec("ExternalSource").AddArg("device", "cpu").AddOutput("data", "cpu"));
+  AddOp(OpSpec("MakeContiguous")
+            .AddArg("device", "mixed")
+            .AddInput("data", "cpu")
+            .AddOutput("g", "gpu"));
+  for (auto name : {"a", "b", "c"}) {
+    AddOp(OpSpec("Copy")
+              .AddArg("device", "gpu")
+              .AddInput("g", "gpu")
+              .AddOutput(name, "gpu"));
+  }
+  // `c` is also used by the second Stack, so it must stay in its own buffer
+  for (auto &s : std::vector<std::vector<std::string>>{{"a", "b"}, {"c", "c"}}) {
+    AddOp(OpSpec("Stack")
+              .AddArg("device", "gpu")
+              .AddInput(s[0], "gpu")
+              .AddInput(s[1], "gpu")
+              .AddOutput("stack_" + s[0], "gpu"));
+  }
+  graph_.InstantiateOperators();
+  auto gpu_id = [&](const std::string &name) {
+    return graph_.TensorId(name + "_gpu");
+  };
+  auto plan = PlanBufferReuse(graph_, {gpu_id("stack_a"), gpu_id("stack_c")});
+
+  ASSERT_EQ(plan.joins.size(), 1u);
+  auto &join = plan.joins[0];
+  EXPECT_EQ(join.consumer, graph_.Tensor(gpu_id("stack_a")).producer.node);
+  ASSERT_EQ(join.producers.size(), 2u);
+  EXPECT_EQ(join.producers[0].first, graph_.Tensor(gpu_id("a")).producer.node);
+  EXPECT_EQ(join.producers[1].first, graph_.Tensor(gpu_id("b")).producer.node);
+  EXPECT_EQ(join.producers[0].second, 0);
+}
+
+}  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,10 +13,13 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <exception>
+#include <vector>
 
 #include "dali/pipeline/graph/op_graph.h"
 
 #include "dali/pipeline/operator/op_schema.h"
+#include "dali/pipeline/util/thread_pool.h"
 
 namespace dali {
 
@@ -196,36 +199,71 @@ void OpGraph::AddOp(const OpSpec &spec, const std::string &op_name) {
   }
 }
 
-void OpGraph::InstantiateOperators() {
+void OpGraph::InstantiateOperators(int num_threads, int device_id) {
   // traverse devices by topological order (cpu, mixed, gpu)
   OpType order[] = {OpType::CPU, OpType::MIXED, OpType::GPU};
 
+  std::vector<OpNodeId> op_ids;
   for (auto op_type : order) {
     for (auto op_id : op_partitions_[static_cast<int>(op_type)]) {
-      try {
-        op_nodes_[op_id].InstantiateOperator();
-      } catch (std::exception &e) {
-        bool use_instance_name = false;
-        for (const auto& other_node : op_nodes_) {
-          if (op_id != other_node.id && op_nodes_[op_id].spec.name() == other_node.spec.name()) {
-            use_instance_name = true;
-            break;
-          }
-        }
-        if (use_instance_name) {
-          throw std::runtime_error(make_string(
-              "Critical error when building pipeline:\nError when constructing operator: ",
-              op_nodes_[op_id].spec.name(), ", instance name: \"", op_nodes_[op_id].instance_name,
-              "\", encountered:\n", e.what(), "\nCurrent pipeline object is no longer valid."));
-        } else {
-          throw std::runtime_error(make_string(
-              "Critical error when building pipeline:\nError when constructing operator: ",
-              op_nodes_[op_id].spec.name(), " encountered:\n", e.what(),
-              "\nCurrent pipeline object is no longer valid."));
+      if (!op_nodes_[op_id].op)
+        op_ids.push_back(op_id);
+    }
+  }
+
+  // The constructors are independent of each other - they can allocate the resources
+  // (CUDA streams, memory, library handles, thread pools) concurrently.
+  std::vector<std::exception_ptr> errors(op_nodes_.size());
+  auto instantiate = [&](OpNodeId op_id) {
+    try {
+      op_nodes_[op_id].InstantiateOperator();
+    } catch (...) {
+      errors[op_id] = std::current_exception();
+    }
+  };
+
+  if (num_threads > 1 && op_ids.size() > 1) {
+    ThreadPool tp(std::min<int>(num_threads, op_ids.size()), device_id, false,
+                  "operator construction");
+    for (auto op_id : op_ids) {
+      auto *schema = SchemaRegistry::TryGetSchema(op_nodes_[op_id].spec.name());
+      if (!schema || !schema->IsNoParallelConstruction())
+        tp.AddWork([&, op_id](int) { instantiate(op_id); });
+    }
+    tp.RunAll();
+  }
+  for (auto op_id : op_ids) {
+    if (!op_nodes_[op_id].op && !errors[op_id])
+      instantiate(op_id);
+  }
+
+  // report the first error, in the topological order
+  for (auto op_id : op_ids) {
+    if (!errors[op_id])
+      continue;
+    try {
+      std::rethrow_exception(errors[op_id]);
+    } catch (std::exception &e) {
+      bool use_instance_name = false;
+      for (const auto& other_node : op_nodes_) {
+        if (op_id != other_node.id && op_nodes_[op_id].spec.name() == other_node.spec.name()) {
+          use_instance_name = true;
+          break;
         }
-      } catch (...) {
-        throw std::runtime_error("Unknown critical error when building pipeline.");
       }
+      if (use_instance_name) {
+        throw std::runtime_error(make_string(
+            "Critical error when building pipeline:\nError when constructing operator: ",
+            op_nodes_[op_id].spec.name(), ", instance name: \"", op_nodes_[op_id].instance_name,
+            "\", encountered:\n", e.what(), "\nCurrent pipeline object is no longer valid."));
+      } else {
+        throw std::runtime_error(make_string(
+            "Critical error when building pipeline:\nError when constructing operator: ",
+            op_nodes_[op_id].spec.name(), " encountered:\n", e.what(),
+            "\nCurrent pipeline object is no longer valid."));
+      }
+    } catch (...) {
+      throw std::runtime_error("Unknown critical error when building pipeline.");
     }
   }
 }
@@ -561,7 +599,7 @@ std::vector<TensorNodeId> OpGraph::GetOutputs(const std::vector<string>& output_
         for (TensorNodeId parent_tid : Node(output.node).parent_tensors) {
           for (TensorMeta input : Tensor(parent_tid).consumers) {
             if (input.node == output.node &&
-                schema.GetPassThroughOutputIdx(input.index) == output.index) {
+                schema.IsPassThrough(input.index, output.index)) {
                 q.push_back(parent_tid);
             }
           }
@@ -580,9 +618,9 @@ bool OpGraph::HasConsumersInOtherStage(const TensorNode &tensor, OpType this_sta
       return true;
     }
     const OpSchema &schema = cons_op.spec.GetSchema();
-    int out_idx = schema.GetPassThroughOutputIdx(cons_edge.index);
-    if (out_idx >= 0) {
-      if (HasConsumersInOtherStage(Tensor(cons_op.children_tensors[out_idx]), this_stage))
+    for (int out_idx = 0; out_idx < cons_op.spec.NumOutput(); out_idx++) {
+      if (schema.IsPassThrough(cons_edge.index, out_idx) &&
+          HasConsumersInOtherStage(Tensor(cons_op.children_tensors[out_idx]), this_stage))
         return true;
     }
   }
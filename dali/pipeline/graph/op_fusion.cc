@@ -0,0 +1,580 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cctype>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/pipeline/data/tensor_vector.h"
+#include "dali/pipeline/data/views.h"
+#include "dali/pipeline/graph/op_fusion.h"
+#include "dali/pipeline/operator/operator.h"
+#include "dali/pipeline/util/thread_pool.h"
+#include "dali/pipeline/workspace/host_workspace.h"
+
+namespace dali {
+
+namespace {
+
+// The limit of the number of inputs in the ArithmeticGenericOp schema
+constexpr int kMaxArithmeticInputs = 64;
+
+const char kExpressionArg[] = "expression_desc";
+const char kIntegerConstantsArg[] = "integer_constants";
+const char kRealConstantsArg[] = "real_constants";
+
+const char kFusedStagesArg[] = "fused_stages";
+
+// The kinds of the fused color transform stages, see dali/operators/image/color/color_twist.h
+constexpr float kFusedColorTwist = 0;
+constexpr float kFusedBrightnessContrast = 1;
+
+std::string DeviceOf(const OpSpec &spec) {
+  return spec.HasArgument("device") ? spec.GetArgument<std::string>("device") : "cpu";
+}
+
+template <typename T>
+std::vector<T> ConstantsOf(const OpSpec &spec, const std::string &arg_name) {
+  return spec.HasArgument(arg_name) ? spec.GetRepeatedArgument<T>(arg_name) : std::vector<T>{};
+}
+
+bool IsRealConstantType(const std::string &type_name) {
+  return type_name.compare(0, 5, "float") == 0;
+}
+
+int ParseIndex(const std::string &expr, size_t &pos) {
+  size_t start = pos;
+  while (pos < expr.size() && std::isdigit(expr[pos]))
+    pos++;
+  DALI_ENFORCE(pos != start, make_string("Expected an index at position [", start, "] in: \"",
+                                         expr, "\"."));
+  return std::stoi(expr.substr(start, pos - start));
+}
+
+/**
+ * @brief Rewrites the references to the inputs and the constants in the expression
+ *
+ * @param input_fn returns the replacement for the reference to the given input
+ * @param integer_offset, real_offset added to the indices of the constants
+ */
+std::string RewriteExpression(const std::string &expr,
+                              const std::function<std::string(int)> &input_fn,
+                              int integer_offset, int real_offset) {
+  std::string result;
+  result.reserve(expr.size());
+  size_t pos = 0;
+  while (pos < expr.size()) {
+    char c = expr[pos];
+    if (c == '&') {
+      pos++;
+      result += input_fn(ParseIndex(expr, pos));
+    } else if (c == '$') {
+      pos++;
+      int idx = ParseIndex(expr, pos);
+      DALI_ENFORCE(pos < expr.size() && expr[pos] == ':',
+                   make_string("Expected \":\" at position [", pos, "] in: \"", expr, "\"."));
+      size_t type_start = ++pos;
+      while (pos < expr.size() && std::isalnum(expr[pos]))
+        pos++;
+      auto type_name = expr.substr(type_start, pos - type_start);
+      idx += IsRealConstantType(type_name) ? real_offset : integer_offset;
+      result += make_string("$", idx, ":", type_name);
+    } else {
+      result += c;
+      pos++;
+    }
+  }
+  return result;
+}
+
+int CountInputReferences(const std::string &expr, int input_idx) {
+  int count = 0;
+  RewriteExpression(expr, [&](int idx) {
+    if (idx == input_idx)
+      count++;
+    return std::string();
+  }, 0, 0);
+  return count;
+}
+
+bool IsPreserved(const OpSpec &spec) {
+  return spec.HasArgument("preserve") && spec.GetArgument<bool>("preserve");
+}
+
+/**
+ * @brief Returns the argument which can replace the `input_idx`-th input of `consumer`,
+ * if it's an affine transform matrix, or nullptr
+ */
+const char *MatrixArgument(const OpSpec &consumer, int input_idx) {
+  bool arg_input = consumer.IsArgumentInput(input_idx);
+  if (consumer.name() == "WarpAffine") {
+    if (arg_input ? consumer.ArgumentInputName(input_idx) == "matrix" : input_idx == 1)
+      return "matrix";
+  } else if (consumer.name() == "CoordTransform") {
+    if (arg_input && consumer.ArgumentInputName(input_idx) == "MT")
+      return "MT";
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Returns a copy of `spec` with its `input_idx`-th input replaced with the argument
+ * `arg_name`
+ */
+OpSpec ReplaceInputWithArgument(const OpSpec &spec, int input_idx, const std::string &arg_name,
+                                const std::vector<float> &value) {
+  OpSpec result(spec.name());
+  for (auto &arg : spec.Arguments())
+    result.SetInitializedArg(arg.first, arg.second);
+  for (int i = 0; i < spec.NumInput(); i++) {
+    if (i == input_idx)
+      continue;
+    if (spec.IsArgumentInput(i))
+      result.AddArgumentInput(spec.ArgumentInputName(i), spec.InputName(i), spec.InputDevice(i));
+    else
+      result.AddInput(spec.InputName(i), spec.InputDevice(i));
+  }
+  for (int i = 0; i < spec.NumOutput(); i++)
+    result.AddOutput(spec.OutputName(i), spec.OutputDevice(i));
+  result.SetArg(arg_name, value);
+  return result;
+}
+
+/**
+ * @brief Returns the elements of the (single sample) result of a transform
+ */
+std::vector<float> MatrixElements(const TensorVector<CPUBackend> &value) {
+  auto matrix = view<const float>(value)[0];
+  return std::vector<float>(matrix.data, matrix.data + volume(matrix.shape));
+}
+
+/**
+ * @brief Returns a Constant operator producing `value` as the output of `transform`
+ */
+OpSpec ConstantTransformSpec(const OpSpec &transform, const TensorVector<CPUBackend> &value) {
+  OpSpec result("Constant");
+  const auto &schema = SchemaRegistry::GetSchema("Constant");
+  // only the arguments common for all operators, like the batch size
+  for (auto &arg : transform.Arguments()) {
+    if (schema.HasArgument(arg.first, true))
+      result.SetInitializedArg(arg.first, arg.second);
+  }
+  auto shape = value.tensor_shape(0);
+  result.SetArg("fdata", MatrixElements(value));
+  result.SetArg("shape", std::vector<int>(shape.begin(), shape.end()));
+  result.SetArg("dtype", DALI_FLOAT);
+  result.AddOutput(transform.OutputName(0), transform.OutputDevice(0));
+  return result;
+}
+
+/**
+ * @brief Runs the transform operator for a single sample
+ */
+std::shared_ptr<TensorVector<CPUBackend>> EvaluateTransform(
+    const OpSpec &spec, const std::vector<std::shared_ptr<TensorVector<CPUBackend>>> &inputs,
+    ThreadPool &thread_pool) {
+  auto op = InstantiateOperator(spec);
+  HostWorkspace ws;
+  for (auto &input : inputs)
+    ws.AddInput(input);
+  auto output = std::make_shared<TensorVector<CPUBackend>>(1);
+  ws.AddOutput(output);
+  ws.SetBatchSizes(1);
+  ws.SetThreadPool(&thread_pool);
+  std::vector<OutputDesc> output_desc;
+  DALI_ENFORCE(op->Setup(output_desc, ws) && output_desc.size() == 1,
+               make_string("The transform \"", spec.name(), "\" didn't infer its output."));
+  output->Resize(output_desc[0].shape, output_desc[0].type);
+  op->Run(ws);
+  return output;
+}
+
+bool IsColorTwist(const OpSpec &spec) {
+  static const std::set<std::string> names = { "ColorTwist", "Hsv", "Hue", "Saturation" };
+  return names.count(spec.name()) > 0;
+}
+
+bool IsBrightnessContrast(const OpSpec &spec) {
+  static const std::set<std::string> names = { "Brightness", "BrightnessContrast", "Contrast" };
+  return names.count(spec.name()) > 0;
+}
+
+float FloatArgument(const OpSpec &spec, const std::string &name, float default_value) {
+  return spec.HasArgument(name) ? spec.GetArgument<float>(name) : default_value;
+}
+
+DALIDataType OutputTypeArgument(const OpSpec &spec) {
+  return spec.HasArgument("dtype") ? spec.GetArgument<DALIDataType>("dtype") : DALI_NO_TYPE;
+}
+
+/**
+ * @brief The value corresponding to the brightness shift of 1, as in BrightnessContrast
+ */
+float BrightnessRange(DALIDataType type) {
+  switch (type) {
+    case DALI_UINT8:
+      return std::numeric_limits<uint8_t>::max();
+    case DALI_INT16:
+      return std::numeric_limits<int16_t>::max();
+    case DALI_INT32:
+      return static_cast<float>(std::numeric_limits<int32_t>::max());
+    default:
+      return 1.0f;
+  }
+}
+
+/**
+ * @brief Returns the stages fused into the color transform `spec`, followed by the stage applied
+ * by the operator itself
+ *
+ * @param output_type the output type of the operator, which determines the brightness shift
+ */
+std::vector<float> ColorStagesOf(const OpSpec &spec, DALIDataType output_type) {
+  auto stages = ConstantsOf<float>(spec, kFusedStagesArg);
+  if (IsColorTwist(spec)) {
+    stages.insert(stages.end(), {
+      kFusedColorTwist,
+      FloatArgument(spec, "hue", 0.0f),
+      FloatArgument(spec, "saturation", 1.0f),
+      FloatArgument(spec, "value", 1.0f),
+      FloatArgument(spec, "brightness", 1.0f),
+      FloatArgument(spec, "contrast", 1.0f)
+    });
+  } else {
+    stages.insert(stages.end(), {
+      kFusedBrightnessContrast,
+      FloatArgument(spec, "brightness", 1.0f),
+      FloatArgument(spec, "brightness_shift", 0.0f) * BrightnessRange(output_type),
+      FloatArgument(spec, "contrast", 1.0f),
+      // NaN stands for the default, which depends on the input type
+      FloatArgument(spec, "contrast_center", std::nanf("")),
+      0.0f
+    });
+  }
+  return stages;
+}
+
+}  // namespace
+
+bool CanFuseArithmeticOps(const OpSpec &producer, const OpSpec &consumer, int input_idx) {
+  if (producer.name() != kArithmeticOpName || consumer.name() != kArithmeticOpName)
+    return false;
+  if (producer.NumOutput() != 1 || producer.NumArgumentInput() > 0 ||
+      consumer.NumArgumentInput() > 0)
+    return false;
+  if (DeviceOf(producer) != DeviceOf(consumer))
+    return false;
+  if (input_idx < 0 || input_idx >= consumer.NumRegularInput() ||
+      consumer.Input(input_idx) != producer.Output(0))
+    return false;
+  if (producer.HasArgument("preserve") && producer.GetArgument<bool>("preserve"))
+    return false;
+  if (consumer.NumRegularInput() - 1 + producer.NumRegularInput() > kMaxArithmeticInputs)
+    return false;
+  return CountInputReferences(consumer.GetArgument<std::string>(kExpressionArg), input_idx) == 1;
+}
+
+OpSpec FuseArithmeticOps(const OpSpec &producer, const OpSpec &consumer, int input_idx) {
+  DALI_ENFORCE(CanFuseArithmeticOps(producer, consumer, input_idx),
+               make_string("Cannot fuse the operator producing \"", producer.Output(0),
+                           "\" into its consumer."));
+  OpSpec fused(consumer.name());
+  for (auto &arg : consumer.Arguments()) {
+    if (arg.first != kExpressionArg && arg.first != kIntegerConstantsArg &&
+        arg.first != kRealConstantsArg)
+      fused.SetInitializedArg(arg.first, arg.second);
+  }
+
+  // The inputs of the consumer, without the inlined one, followed by the producer's ones
+  std::vector<int> consumer_input_map(consumer.NumRegularInput(), -1);
+  std::vector<std::pair<std::string, std::string>> inputs;
+  auto add_input = [&](const std::string &name, const std::string &device) {
+    for (size_t i = 0; i < inputs.size(); i++) {
+      if (inputs[i].first == name && inputs[i].second == device)
+        return static_cast<int>(i);
+    }
+    inputs.emplace_back(name, device);
+    return static_cast<int>(inputs.size()) - 1;
+  };
+  for (int i = 0; i < consumer.NumRegularInput(); i++) {
+    if (i != input_idx)
+      consumer_input_map[i] = add_input(consumer.InputName(i), consumer.InputDevice(i));
+  }
+  std::vector<int> producer_input_map(producer.NumRegularInput());
+  for (int i = 0; i < producer.NumRegularInput(); i++) {
+    producer_input_map[i] = add_input(producer.InputName(i), producer.InputDevice(i));
+  }
+
+  auto integers = ConstantsOf<int>(consumer, kIntegerConstantsArg);
+  auto reals = ConstantsOf<float>(consumer, kRealConstantsArg);
+  auto producer_integers = ConstantsOf<int>(producer, kIntegerConstantsArg);
+  auto producer_reals = ConstantsOf<float>(producer, kRealConstantsArg);
+
+  auto producer_expr = RewriteExpression(
+      producer.GetArgument<std::string>(kExpressionArg),
+      [&](int idx) {
+        DALI_ENFORCE(idx < static_cast<int>(producer_input_map.size()),
+                     make_string("Input index out of range: ", idx));
+        return make_string("&", producer_input_map[idx]);
+      },
+      integers.size(), reals.size());
+  auto expr = RewriteExpression(
+      consumer.GetArgument<std::string>(kExpressionArg),
+      [&](int idx) {
+        DALI_ENFORCE(idx < static_cast<int>(consumer_input_map.size()),
+                     make_string("Input index out of range: ", idx));
+        return idx == input_idx ? producer_expr : make_string("&", consumer_input_map[idx]);
+      },
+      0, 0);
+
+  integers.insert(integers.end(), producer_integers.begin(), producer_integers.end());
+  reals.insert(reals.end(), producer_reals.begin(), producer_reals.end());
+
+  fused.SetArg(kExpressionArg, expr);
+  if (!integers.empty())
+    fused.SetArg(kIntegerConstantsArg, integers);
+  if (!reals.empty())
+    fused.SetArg(kRealConstantsArg, reals);
+  for (auto &input : inputs)
+    fused.AddInput(input.first, input.second);
+  for (int i = 0; i < consumer.NumOutput(); i++)
+    fused.AddOutput(consumer.OutputName(i), consumer.OutputDevice(i));
+  return fused;
+}
+
+std::vector<bool> FuseArithmeticOps(std::vector<OpSpec> &specs,
+                                    const std::set<std::string> &preserved) {
+  std::vector<bool> removed(specs.size(), false);
+  // tensor name (without the device) -> number of uses as an input
+  std::map<std::string, int> num_uses;
+  // tensor name with the device -> index of the producing spec
+  std::map<std::string, int> producers;
+  for (size_t i = 0; i < specs.size(); i++) {
+    for (int in = 0; in < specs[i].NumInput(); in++)
+      num_uses[specs[i].InputName(in)]++;
+    for (int out = 0; out < specs[i].NumOutput(); out++)
+      producers[specs[i].Output(out)] = i;
+  }
+
+  // The specs are topologically sorted, so when we get to the consumer, all the chains
+  // leading to it are already fused
+  for (size_t i = 0; i < specs.size(); i++) {
+    bool fused_any = true;
+    while (fused_any) {
+      fused_any = false;
+      auto &consumer = specs[i];
+      for (int in = 0; in < consumer.NumRegularInput(); in++) {
+        auto it = producers.find(consumer.Input(in));
+        if (it == producers.end() || removed[it->second])
+          continue;
+        auto &producer = specs[it->second];
+        auto name = consumer.InputName(in);
+        if (num_uses[name] != 1 || preserved.count(name) ||
+            !CanFuseArithmeticOps(producer, consumer, in))
+          continue;
+        auto fused = FuseArithmeticOps(producer, consumer, in);
+        // The inputs passed to both operators are now used once
+        num_uses[name]--;
+        for (int p = 0; p < producer.NumInput(); p++)
+          num_uses[producer.InputName(p)]--;
+        for (int c = 0; c < consumer.NumInput(); c++) {
+          if (c != in)
+            num_uses[consumer.InputName(c)]--;
+        }
+        for (int f = 0; f < fused.NumInput(); f++)
+          num_uses[fused.InputName(f)]++;
+        removed[it->second] = true;
+        consumer = std::move(fused);
+        fused_any = true;
+        break;
+      }
+    }
+  }
+  return removed;
+}
+
+bool IsFoldableTransform(const OpSpec &spec) {
+  static const std::set<std::string> transforms = {
+    "transforms__Combine", "transforms__Crop", "transforms__Rotation",
+    "transforms__Scale", "transforms__Shear", "transforms__Translation"
+  };
+  return transforms.count(spec.name()) && DeviceOf(spec) == "cpu" && spec.NumOutput() == 1 &&
+         spec.NumArgumentInput() == 0 && !IsPreserved(spec);
+}
+
+std::vector<bool> FoldConstantTransforms(std::vector<OpSpec> &specs,
+                                         const std::set<std::string> &preserved) {
+  std::vector<bool> removed(specs.size(), false);
+  // tensor name with the device -> index of the producing spec
+  std::map<std::string, int> producers;
+  for (size_t i = 0; i < specs.size(); i++) {
+    for (int out = 0; out < specs[i].NumOutput(); out++)
+      producers[specs[i].Output(out)] = i;
+  }
+
+  // The values of the transforms which don't depend on the data, in topological order
+  std::vector<std::shared_ptr<TensorVector<CPUBackend>>> values(specs.size());
+  std::unique_ptr<ThreadPool> thread_pool;
+  for (size_t i = 0; i < specs.size(); i++) {
+    if (!IsFoldableTransform(specs[i]))
+      continue;
+    std::vector<std::shared_ptr<TensorVector<CPUBackend>>> inputs;
+    for (int in = 0; in < specs[i].NumRegularInput(); in++) {
+      auto it = producers.find(specs[i].Input(in));
+      if (it == producers.end() || !values[it->second])
+        break;
+      inputs.push_back(values[it->second]);
+    }
+    if (static_cast<int>(inputs.size()) != specs[i].NumRegularInput())
+      continue;
+    if (!thread_pool)
+      thread_pool = std::make_unique<ThreadPool>(1, CPU_ONLY_DEVICE_ID, false, "FoldTransforms");
+    values[i] = EvaluateTransform(specs[i], inputs, *thread_pool);
+  }
+
+  // The consumers, which can take the matrix as an argument, don't need the tensor
+  for (auto &spec : specs) {
+    for (int in = spec.NumInput() - 1; in >= 0; in--) {
+      auto it = producers.find(spec.Input(in));
+      const char *arg_name = MatrixArgument(spec, in);
+      if (it == producers.end() || !values[it->second] || !arg_name)
+        continue;
+      spec = ReplaceInputWithArgument(spec, in, arg_name, MatrixElements(*values[it->second]));
+    }
+  }
+
+  // The transforms still used by other operators are replaced with their constant result and
+  // the remaining ones are removed. A Constant has no inputs, so only the uses by the other
+  // operators are counted; the consumers come after the producers, so the counts are final
+  // when the producer is reached in reverse order.
+  std::map<std::string, int> num_uses;
+  for (int i = specs.size() - 1; i >= 0; i--) {
+    if (!values[i]) {
+      for (int in = 0; in < specs[i].NumInput(); in++)
+        num_uses[specs[i].InputName(in)]++;
+      continue;
+    }
+    auto name = specs[i].OutputName(0);
+    if (num_uses[name] > 0 || preserved.count(name))
+      specs[i] = ConstantTransformSpec(specs[i], *values[i]);
+    else
+      removed[i] = true;
+  }
+  return removed;
+}
+
+bool CanFuseColorTransforms(const OpSpec &producer, const OpSpec &consumer) {
+  if (!IsColorTwist(producer) && !IsBrightnessContrast(producer))
+    return false;
+  // A brightness and contrast adjustment can be replaced with a ColorTwist only if it's given
+  // RGB data - i.e. the output of a color twist.
+  bool replace_consumer = IsBrightnessContrast(consumer) && IsColorTwist(producer) &&
+                          consumer.NumArgumentInput() == 0;
+  if (!IsColorTwist(consumer) && !replace_consumer)
+    return false;
+  if (producer.NumOutput() != 1 || producer.NumArgumentInput() > 0 || IsPreserved(producer))
+    return false;
+  if (DeviceOf(producer) != DeviceOf(consumer))
+    return false;
+  if (consumer.NumRegularInput() != 1 || consumer.Input(0) != producer.Output(0))
+    return false;
+  return OutputTypeArgument(producer) == DALI_FLOAT;
+}
+
+OpSpec FuseColorTransforms(const OpSpec &producer, const OpSpec &consumer) {
+  DALI_ENFORCE(CanFuseColorTransforms(producer, consumer),
+               make_string("Cannot fuse the operator producing \"", producer.Output(0),
+                           "\" into its consumer."));
+  auto stages = ColorStagesOf(producer, DALI_FLOAT);
+  bool keep_consumer = IsColorTwist(consumer);
+  OpSpec fused(keep_consumer ? consumer.name() : std::string("ColorTwist"));
+  if (keep_consumer) {
+    for (auto &arg : consumer.Arguments()) {
+      if (arg.first != kFusedStagesArg)
+        fused.SetInitializedArg(arg.first, arg.second);
+    }
+    auto consumer_stages = ConstantsOf<float>(consumer, kFusedStagesArg);
+    stages.insert(stages.end(), consumer_stages.begin(), consumer_stages.end());
+  } else {
+    // The brightness and contrast adjustment becomes the last fused stage of a ColorTwist,
+    // which doesn't change the data by itself.
+    // Its input is float, so, unless given, the output type is float as well.
+    static const std::set<std::string> replaced_args = {
+      "brightness", "brightness_shift", "contrast", "contrast_center", "dtype"
+    };
+    for (auto &arg : consumer.Arguments()) {
+      if (!replaced_args.count(arg.first))
+        fused.SetInitializedArg(arg.first, arg.second);
+    }
+    auto output_type = OutputTypeArgument(consumer);
+    if (output_type == DALI_NO_TYPE)
+      output_type = DALI_FLOAT;
+    fused.SetArg("dtype", output_type);
+    auto consumer_stages = ColorStagesOf(consumer, output_type);
+    stages.insert(stages.end(), consumer_stages.begin(), consumer_stages.end());
+  }
+  fused.SetArg(kFusedStagesArg, stages);
+  fused.AddInput(producer.InputName(0), producer.InputDevice(0));
+  for (int i = consumer.NumRegularInput(); i < consumer.NumInput(); i++)
+    fused.AddArgumentInput(consumer.ArgumentInputName(i), consumer.InputName(i),
+                            consumer.InputDevice(i));
+  for (int i = 0; i < consumer.NumOutput(); i++)
+    fused.AddOutput(consumer.OutputName(i), consumer.OutputDevice(i));
+  return fused;
+}
+
+std::vector<bool> FuseColorTransforms(std::vector<OpSpec> &specs,
+                                      const std::set<std::string> &preserved) {
+  std::vector<bool> removed(specs.size(), false);
+  // tensor name (without the device) -> number of uses as an input
+  std::map<std::string, int> num_uses;
+  // tensor name with the device -> index of the producing spec
+  std::map<std::string, int> producers;
+  for (size_t i = 0; i < specs.size(); i++) {
+    for (int in = 0; in < specs[i].NumInput(); in++)
+      num_uses[specs[i].InputName(in)]++;
+    for (int out = 0; out < specs[i].NumOutput(); out++)
+      producers[specs[i].Output(out)] = i;
+  }
+
+  // The specs are topologically sorted, so when we get to the consumer, the chain leading to its
+  // producer is already fused. Replacing a brightness and contrast adjustment with a ColorTwist
+  // may allow fusing one more producer, hence the loop.
+  for (size_t i = 0; i < specs.size(); i++) {
+    auto &consumer = specs[i];
+    while (consumer.NumRegularInput() == 1) {
+      auto it = producers.find(consumer.Input(0));
+      if (it == producers.end() || removed[it->second])
+        break;
+      auto &producer = specs[it->second];
+      auto name = consumer.InputName(0);
+      if (num_uses[name] != 1 || preserved.count(name) ||
+          !CanFuseColorTransforms(producer, consumer))
+        break;
+      // the input of the producer is now used by the fused operator instead
+      consumer = FuseColorTransforms(producer, consumer);
+      removed[it->second] = true;
+    }
+  }
+  return removed;
+}
+
+}  // namespace dali
@@ -0,0 +1,134 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_GRAPH_OP_FUSION_H_
+#define DALI_PIPELINE_GRAPH_OP_FUSION_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/pipeline/operator/op_spec.h"
+
+namespace dali {
+
+/**
+ * @brief Name of the operator evaluating element-wise expressions, which can be fused
+ */
+constexpr const char kArithmeticOpName[] = "ArithmeticGenericOp";
+
+/**
+ * @brief Checks if the output of `producer` can be inlined into `consumer` as its
+ * `input_idx`-th input.
+ *
+ * Both have to be ArithmeticGenericOps on the same device, without argument inputs and
+ * the expression of `consumer` must refer to the input exactly once.
+ * The uses of the tensor by other operators are not checked.
+ */
+DLL_PUBLIC bool CanFuseArithmeticOps(const OpSpec &producer, const OpSpec &consumer,
+                                     int input_idx);
+
+/**
+ * @brief Merges two ArithmeticGenericOps into one, by substituting the expression of `producer`
+ * for the `input_idx`-th input of `consumer`.
+ *
+ * The inputs and constants of the producer are appended to the ones of the consumer (inputs
+ * used by both are passed only once). The resulting spec has the outputs and the remaining
+ * arguments of `consumer`. The result type of every subexpression stays the same, so the fused
+ * operator computes exactly the same values, without storing the intermediate tensor.
+ */
+DLL_PUBLIC OpSpec FuseArithmeticOps(const OpSpec &producer, const OpSpec &consumer,
+                                    int input_idx);
+
+/**
+ * @brief Fuses the chains of ArithmeticGenericOps in the pipeline, so that they are evaluated
+ * by a single kernel.
+ *
+ * An operator is merged with its consumer if its output is used only by that consumer and is not
+ * one of the `preserved` tensors (like the pipeline outputs).
+ *
+ * @param specs the specs of the operators, in topological order;
+ *              the consumers are replaced with the fused specs
+ * @param preserved names of the tensors which have to be kept
+ * @return a mask of the specs which were merged into their consumers and have to be removed
+ */
+DLL_PUBLIC std::vector<bool> FuseArithmeticOps(std::vector<OpSpec> &specs,
+                                               const std::set<std::string> &preserved);
+
+/**
+ * @brief Checks if `spec` is an affine transform operator (transforms.*), whose result doesn't
+ * depend on the data, provided that its inputs (the transforms to combine with) don't either.
+ */
+DLL_PUBLIC bool IsFoldableTransform(const OpSpec &spec);
+
+/**
+ * @brief Evaluates the chains of affine transform operators, which don't depend on the data,
+ * when building the pipeline.
+ *
+ * The transforms with no argument inputs, whose inputs are such transforms as well, produce
+ * the same matrix for every sample and iteration. The matrix is computed once and passed
+ * as the ``matrix`` argument of the WarpAffine or the ``MT`` argument of the CoordTransform
+ * operators using it; for the other consumers, the last transform of the chain is replaced with
+ * a Constant operator. The transforms no longer used are removed.
+ *
+ * @param specs the specs of the operators, in topological order, with the arguments
+ *              needed to instantiate them; the rewritten specs are replaced in place
+ * @param preserved names of the tensors which have to be kept
+ * @return a mask of the specs which are no longer used and have to be removed
+ */
+DLL_PUBLIC std::vector<bool> FoldConstantTransforms(std::vector<OpSpec> &specs,
+                                                    const std::set<std::string> &preserved);
+
+/**
+ * @brief Checks if the color transform `producer` (one of ColorTwist, Hsv, Hue, Saturation,
+ * Brightness, Contrast and BrightnessContrast) can be applied by its `consumer`, as one of its
+ * ``fused_stages``.
+ *
+ * The consumer has to be a color twist or, when the producer is a color twist, a brightness
+ * and contrast adjustment without argument inputs (it is replaced with a ColorTwist).
+ * Both have to be on the same device and the producer can't have argument inputs.
+ * The output of the producer must be explicitly requested as ``float`` - otherwise the rounding
+ * and the saturation of the intermediate result would be lost.
+ * The uses of the tensor by other operators are not checked.
+ */
+DLL_PUBLIC bool CanFuseColorTransforms(const OpSpec &producer, const OpSpec &consumer);
+
+/**
+ * @brief Merges two color transforms into one, which applies the producer's transform (and the
+ * ones already fused into it) before its own.
+ *
+ * The per-pixel affine transforms of all the stages are composed into a single 3x4 matrix
+ * per sample by the operator, so the data is processed in a single pass.
+ */
+DLL_PUBLIC OpSpec FuseColorTransforms(const OpSpec &producer, const OpSpec &consumer);
+
+/**
+ * @brief Fuses the chains of color transforms in the pipeline, so that each chain is applied
+ * by a single operator.
+ *
+ * An operator is merged with its consumer if its output is used only by that consumer and is not
+ * one of the `preserved` tensors (like the pipeline outputs).
+ *
+ * @param specs the specs of the operators, in topological order;
+ *              the consumers are replaced with the fused specs
+ * @param preserved names of the tensors which have to be kept
+ * @return a mask of the specs which were merged into their consumers and have to be removed
+ */
+DLL_PUBLIC std::vector<bool> FuseColorTransforms(std::vector<OpSpec> &specs,
+                                                 const std::set<std::string> &preserved);
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_GRAPH_OP_FUSION_H_
@@ -0,0 +1,223 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "dali/pipeline/graph/op_fusion.h"
+
+namespace dali {
+
+namespace test {
+
+namespace {
+
+OpSpec ArithmeticSpec(const std::string &expr, const std::vector<std::string> &inputs,
+                      const std::string &output, const std::string &device = "gpu") {
+  OpSpec spec(kArithmeticOpName);
+  spec.AddArg("device", device).AddArg("expression_desc", expr);
+  for (auto &input : inputs)
+    spec.AddInput(input, device);
+  spec.AddOutput(output, device);
+  return spec;
+}
+
+OpSpec CpuSpec(const std::string &name) {
+  OpSpec spec(name);
+  spec.AddArg("device", "cpu")
+      .AddArg("max_batch_size", 1)
+      .AddArg("num_threads", 1)
+      .AddArg("device_id", 0);
+  return spec;
+}
+
+void ExpectMatrix(const std::vector<float> &actual, const std::vector<float> &expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); i++)
+    EXPECT_NEAR(actual[i], expected[i], 1e-6) << "at index " << i;
+}
+
+}  // namespace
+
+TEST(OpFusion, InlineProducer) {
+  auto producer = ArithmeticSpec("mul(&0 $0:int32)", {"x"}, "a");
+  producer.AddArg("integer_constants", std::vector<int>{2});
+  auto consumer = ArithmeticSpec("add(&0 &1)", {"a", "y"}, "b");
+  ASSERT_TRUE(CanFuseArithmeticOps(producer, consumer, 0));
+
+  auto fused = FuseArithmeticOps(producer, consumer, 0);
+  EXPECT_EQ(fused.GetArgument<std::string>("expression_desc"), "add(mul(&1 $0:int32) &0)");
+  EXPECT_EQ(fused.GetRepeatedArgument<int>("integer_constants"), std::vector<int>{2});
+  ASSERT_EQ(fused.NumInput(), 2);
+  EXPECT_EQ(fused.Input(0), "y_gpu");
+  EXPECT_EQ(fused.Input(1), "x_gpu");
+  ASSERT_EQ(fused.NumOutput(), 1);
+  EXPECT_EQ(fused.Output(0), "b_gpu");
+  EXPECT_EQ(fused.GetArgument<std::string>("device"), "gpu");
+}
+
+TEST(OpFusion, ConstantsAreReindexed) {
+  auto producer = ArithmeticSpec("add(mul(&0 $0:float32) $0:int16)", {"x"}, "a", "cpu");
+  producer.AddArg("integer_constants", std::vector<int>{3});
+  producer.AddArg("real_constants", std::vector<float>{2.0f});
+  auto consumer = ArithmeticSpec("sub(&0 $0:float32)", {"a"}, "b", "cpu");
+  consumer.AddArg("real_constants", std::vector<float>{1.5f});
+
+  auto fused = FuseArithmeticOps(producer, consumer, 0);
+  EXPECT_EQ(fused.GetArgument<std::string>("expression_desc"),
+            "sub(add(mul(&0 $1:float32) $0:int16) $0:float32)");
+  EXPECT_EQ(fused.GetRepeatedArgument<int>("integer_constants"), std::vector<int>{3});
+  EXPECT_EQ(fused.GetRepeatedArgument<float>("real_constants"),
+            (std::vector<float>{1.5f, 2.0f}));
+  ASSERT_EQ(fused.NumInput(), 1);
+  EXPECT_EQ(fused.Input(0), "x_cpu");
+}
+
+TEST(OpFusion, SharedInputsArePassedOnce) {
+  auto producer = ArithmeticSpec("mul(&0 &1)", {"x", "y"}, "a");
+  auto consumer = ArithmeticSpec("sub(&1 &0)", {"a", "x"}, "b");
+  auto fused = FuseArithmeticOps(producer, consumer, 0);
+  EXPECT_EQ(fused.GetArgument<std::string>("expression_desc"), "sub(&0 mul(&0 &1))");
+  ASSERT_EQ(fused.NumInput(), 2);
+  EXPECT_EQ(fused.Input(0), "x_gpu");
+  EXPECT_EQ(fused.Input(1), "y_gpu");
+}
+
+TEST(OpFusion, CannotFuse) {
+  auto producer = ArithmeticSpec("mul(&0 &0)", {"x", "y"}, "a");
+  // used twice in the expression - the producer would be evaluated twice
+  EXPECT_FALSE(CanFuseArithmeticOps(producer, ArithmeticSpec("mul(&0 &0)", {"a"}, "b"), 0));
+  // different devices
+  EXPECT_FALSE(CanFuseArithmeticOps(producer, ArithmeticSpec("neg(&0)", {"a"}, "b", "cpu"), 0));
+  // not an output of the producer
+  EXPECT_FALSE(CanFuseArithmeticOps(producer, ArithmeticSpec("neg(&0)", {"x"}, "b"), 0));
+  // not an arithmetic operator
+  OpSpec other("Copy");
+  other.AddArg("device", "gpu").AddInput("a", "gpu").AddOutput("b", "gpu");
+  EXPECT_FALSE(CanFuseArithmeticOps(producer, other, 0));
+  EXPECT_TRUE(CanFuseArithmeticOps(producer, ArithmeticSpec("neg(&0)", {"a"}, "b"), 0));
+}
+
+TEST(OpFusion, FuseChains) {
+  std::vector<OpSpec> specs;
+  specs.push_back(ArithmeticSpec("neg(&0)", {"x"}, "a"));
+  specs.push_back(ArithmeticSpec("add(&0 &1)", {"a", "y"}, "b"));
+  specs.push_back(ArithmeticSpec("abs(&0)", {"b"}, "c"));
+  // `c` is used twice, so it's kept
+  specs.push_back(ArithmeticSpec("mul(&0 &1)", {"c", "c"}, "d"));
+  // `e` is a pipeline output
+  specs.push_back(ArithmeticSpec("neg(&0)", {"d"}, "e"));
+  specs.push_back(ArithmeticSpec("abs(&0)", {"e"}, "f"));
+
+  auto removed = FuseArithmeticOps(specs, {"e", "f"});
+  EXPECT_EQ(removed, (std::vector<bool>{true, true, false, true, false, false}));
+  EXPECT_EQ(specs[2].GetArgument<std::string>("expression_desc"), "abs(add(neg(&1) &0))");
+  ASSERT_EQ(specs[2].NumInput(), 2);
+  EXPECT_EQ(specs[2].Input(0), "y_gpu");
+  EXPECT_EQ(specs[2].Input(1), "x_gpu");
+  EXPECT_EQ(specs[4].GetArgument<std::string>("expression_desc"), "neg(mul(&0 &0))");
+  EXPECT_EQ(specs[4].Input(0), "c_gpu");
+  EXPECT_EQ(specs[5].GetArgument<std::string>("expression_desc"), "abs(&0)");
+}
+
+TEST(OpFusion, FoldConstantTransforms) {
+  std::vector<OpSpec> specs;
+  specs.push_back(CpuSpec("transforms__Rotation").AddArg("angle", 90.0f).AddOutput("r", "cpu"));
+  specs.push_back(CpuSpec("transforms__Translation")
+                      .AddArg("offset", std::vector<float>{1, 2})
+                      .AddInput("r", "cpu")
+                      .AddOutput("t", "cpu"));
+  specs.push_back(CpuSpec("ExternalSource").AddOutput("img", "cpu"));
+  specs.push_back(CpuSpec("WarpAffine")
+                      .AddInput("img", "cpu")
+                      .AddInput("t", "cpu")
+                      .AddOutput("warped", "cpu"));
+  specs.push_back(CpuSpec("transforms__Scale")
+                      .AddArg("scale", std::vector<float>{2, 3})
+                      .AddOutput("s", "cpu"));
+  specs.push_back(CpuSpec("Copy").AddInput("s", "cpu").AddOutput("s_copy", "cpu"));
+  // depends on the data, so it's kept as it is
+  specs.push_back(CpuSpec("transforms__Translation")
+                      .AddArgumentInput("offset", "img")
+                      .AddOutput("t_data", "cpu"));
+
+  auto removed = FoldConstantTransforms(specs, {"warped", "s_copy", "t_data"});
+  EXPECT_EQ(removed, (std::vector<bool>{true, true, false, false, false, false, false}));
+
+  // the composed matrix is passed as an argument
+  ASSERT_EQ(specs[3].NumInput(), 1);
+  EXPECT_EQ(specs[3].Input(0), "img_cpu");
+  ExpectMatrix(specs[3].GetRepeatedArgument<float>("matrix"), {0, -1, 1, 1, 0, 2});
+
+  // the other consumers get a constant
+  EXPECT_EQ(specs[4].name(), "Constant");
+  EXPECT_EQ(specs[4].Output(0), "s_cpu");
+  EXPECT_EQ(specs[4].GetRepeatedArgument<int>("shape"), (std::vector<int>{2, 3}));
+  ExpectMatrix(specs[4].GetRepeatedArgument<float>("fdata"), {2, 0, 0, 0, 3, 0});
+
+  EXPECT_EQ(specs[6].name(), "transforms__Translation");
+}
+
+TEST(OpFusion, FuseColorTransforms) {
+  auto gpu_spec = [](const std::string &name, const std::string &input,
+                     const std::string &output) {
+    OpSpec spec(name);
+    spec.AddArg("device", "gpu").AddInput(input, "gpu").AddOutput(output, "gpu");
+    return spec;
+  };
+  std::vector<OpSpec> specs;
+  specs.push_back(gpu_spec("BrightnessContrast", "img", "bc")
+                      .AddArg("brightness", 2.0f)
+                      .AddArg("dtype", DALI_FLOAT));
+  specs.push_back(gpu_spec("Hsv", "bc", "hsv")
+                      .AddArg("hue", 30.0f)
+                      .AddArg("value", 0.5f)
+                      .AddArg("dtype", DALI_FLOAT));
+  specs.push_back(gpu_spec("ColorTwist", "hsv", "twist")
+                      .AddArg("saturation", 0.25f)
+                      .AddArgumentInput("contrast", "c"));
+  // rounded to uint8 - the consumer can't apply it
+  specs.push_back(gpu_spec("Hue", "twist", "hue").AddArg("hue", 10.0f));
+  specs.push_back(gpu_spec("Contrast", "hue", "contrast").AddArg("contrast", 0.5f));
+
+  ASSERT_TRUE(CanFuseColorTransforms(specs[0], specs[1]));
+  EXPECT_FALSE(CanFuseColorTransforms(specs[3], specs[4]));
+  // a brightness and contrast adjustment may get other data than RGB
+  EXPECT_FALSE(CanFuseColorTransforms(specs[0], gpu_spec("Contrast", "bc", "c2")));
+
+  auto removed = FuseColorTransforms(specs, {"contrast"});
+  EXPECT_EQ(removed, (std::vector<bool>{true, true, false, false, false}));
+  auto &fused = specs[2];
+  EXPECT_EQ(fused.name(), "ColorTwist");
+  ASSERT_EQ(fused.NumRegularInput(), 1);
+  EXPECT_EQ(fused.Input(0), "img_gpu");
+  ASSERT_EQ(fused.NumArgumentInput(), 1);
+  EXPECT_EQ(fused.ArgumentInputName(1), "contrast");
+  EXPECT_EQ(fused.GetArgument<float>("saturation"), 0.25f);
+  auto stages = fused.GetRepeatedArgument<float>("fused_stages");
+  ASSERT_EQ(stages.size(), 12u);
+  EXPECT_EQ(stages[0], 1.0f);  // brightness and contrast
+  EXPECT_EQ(stages[1], 2.0f);
+  EXPECT_TRUE(std::isnan(stages[4]));
+  EXPECT_EQ(stages[6], 0.0f);  // color twist
+  EXPECT_EQ(stages[7], 30.0f);
+  EXPECT_EQ(stages[9], 0.5f);
+}
+
+}  // namespace test
+
+}  // namespace dali
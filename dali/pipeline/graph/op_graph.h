@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -314,8 +314,13 @@ class DLL_PUBLIC OpGraph {
 
   /**
    * @brief Instantiates the operators based on OpSpecs in nodes
+   *
+   * The operators are constructed concurrently by `num_threads` threads bound to `device_id`,
+   * except for the ones marked with OpSchema::NoParallelConstruction, which are constructed
+   * by the calling thread. The operators which already exist are skipped.
    */
-  DLL_PUBLIC void InstantiateOperators();
+  DLL_PUBLIC void InstantiateOperators(int num_threads = 1,
+                                       int device_id = CPU_ONLY_DEVICE_ID);
 
   /**
    * @brief Save graph in DOT directed graph format
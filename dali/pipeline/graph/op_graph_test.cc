@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,7 @@
 #include "dali/pipeline/graph/op_graph.h"
 
 #include <gtest/gtest.h>
+#include <string>
 
 #include "dali/test/dali_test.h"
 
@@ -588,4 +589,24 @@ TEST_F(OpGraphTest, TestFailureCircularOp) {
       std::runtime_error);
 }
 
+TEST_F(OpGraphTest, TestParallelInstantiation) {
+  OpGraph graph;
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("ExternalSource")
+          .AddArg("device", "cpu")
+          .AddOutput("external_data", "cpu")), "");
+  for (int i = 0; i < 8; i++) {
+    graph.AddOp(this->PrepareSpec(
+            OpSpec("Copy")
+            .AddArg("device", "cpu")
+            .AddInput("external_data", "cpu")
+            .AddOutput("copy_data" + std::to_string(i), "cpu")), "");
+  }
+
+  graph.InstantiateOperators(4, CPU_ONLY_DEVICE_ID);
+  for (int i = 0; i < graph.NumOp(); i++) {
+    EXPECT_NE(graph.Node(i).op, nullptr);
+  }
+}
+
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,8 @@
 #ifndef DALI_PIPELINE_OPERATOR_ARG_HELPER_H_
 #define DALI_PIPELINE_OPERATOR_ARG_HELPER_H_
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <utility>
@@ -26,6 +28,7 @@
 #include "dali/pipeline/data/views.h"
 #include "dali/pipeline/operator/argument.h"
 #include "dali/pipeline/operator/op_spec.h"
+#include "dali/pipeline/workspace/workspace.h"
 
 namespace dali {
 
@@ -60,6 +63,128 @@ struct ArgShapeFromSize<1> {
  */
 
 
+/**
+ * @brief Accesses an argument input without looking it up by name in every iteration
+ *
+ * The argument input is looked up in a workspace once and the result is reused for as long as
+ * the argument inputs of that workspace don't change. The operators usually cycle through a few
+ * workspaces (one per queue slot), so the last few of them are remembered.
+ */
+class ArgumentInputRef {
+ public:
+  explicit ArgumentInputRef(std::string arg_name) : arg_name_(std::move(arg_name)) {}
+
+  const TensorVector<CPUBackend> &Get(const ArgumentWorkspace &ws) {
+    uint64_t version = ws.ArgumentInputsVersion();
+    for (int i = 0; i < num_cached_; i++) {
+      auto &entry = cache_[i];
+      if (entry.ws == &ws) {
+        if (entry.version != version) {
+          entry.desc = &Find(ws);
+          entry.version = version;
+        }
+        return ws.ArgumentInput(*entry.desc);
+      }
+    }
+    auto &entry = cache_[next_slot_];
+    entry = { &ws, version, &Find(ws) };
+    next_slot_ = (next_slot_ + 1) % kMaxCachedWorkspaces;
+    num_cached_ = std::min(num_cached_ + 1, kMaxCachedWorkspaces);
+    return ws.ArgumentInput(*entry.desc);
+  }
+
+  const std::string &name() const {
+    return arg_name_;
+  }
+
+ private:
+  const ArgumentWorkspace::ArgumentInputDesc &Find(const ArgumentWorkspace &ws) const {
+    auto *desc = ws.FindArgumentInput(arg_name_);
+    DALI_ENFORCE(desc != nullptr, make_string("Argument \"", arg_name_, "\" not found."));
+    return *desc;
+  }
+
+  static constexpr int kMaxCachedWorkspaces = 4;
+
+  struct CacheEntry {
+    const ArgumentWorkspace *ws = nullptr;
+    uint64_t version = 0;
+    const ArgumentWorkspace::ArgumentInputDesc *desc = nullptr;
+  };
+
+  std::string arg_name_;
+  std::array<CacheEntry, kMaxCachedWorkspaces> cache_;
+  int num_cached_ = 0;
+  int next_slot_ = 0;
+};
+
+/**
+ * @brief Helper to access a scalar operator argument sample by sample, regardless of whether
+ *        it was provided as a build-time constant or a tensor input.
+ *
+ * It's a replacement of `spec.GetArgument<T>(name, &ws, sample_idx)` for the per-sample loops:
+ * the argument is resolved when the operator is constructed - the constant (or default) value is
+ * read once and the argument input is accessed without hashing the argument name for each sample.
+ *
+ * Getting the values is not thread-safe, so it's meant for the batch-level code rather than for
+ * the operators running sample by sample in the thread pool.
+ *
+ * @tparam T  The type of the argument, as it would be passed to OpSpec::GetArgument
+ */
+template <typename T>
+class ScalarArg {
+ public:
+  ScalarArg(std::string arg_name, const OpSpec &spec) : input_(std::move(arg_name)) {
+    has_arg_input_ = spec.HasTensorArgument(name());
+    if (!has_arg_input_) {
+      has_value_ = spec.TryGetArgument<T>(value_, name());
+      if (!has_value_ && spec.HasArgument(name()))
+        (void) spec.GetArgument<T>(name());  // the value has a wrong type - let it throw
+    }
+  }
+
+  /**
+   * @brief true if there is an argument input
+   */
+  bool HasArgumentInput() const {
+    return has_arg_input_;
+  }
+
+  /**
+   * @brief Gets the value of the argument for given sample
+   */
+  T Get(const ArgumentWorkspace &ws, int sample_idx) {
+    if (!has_arg_input_) {
+      DALI_ENFORCE(has_value_, make_string("Argument \"", name(),
+                   "\" is not specified and has no default value."));
+      return value_;
+    }
+    const auto &value = input_.Get(ws);
+    auto sample_shape = value.tensor_shape(sample_idx);
+    DALI_ENFORCE(volume(sample_shape) == 1,
+        make_string("Unexpected shape of argument \"", name(), "\". Expected a scalar or "
+                    "a tensor containing one element per sample. Got a tensor of shape ",
+                    sample_shape, " for sample ", sample_idx, "."));
+    DALI_ENFORCE(IsType<T>(value.type()), make_string(
+        "Unexpected type of argument \"", name(), "\". Expected ",
+        TypeTable::GetTypeName<T>(), " and got ", value.type()));
+    return value.template tensor<T>(sample_idx)[0];
+  }
+
+  /**
+   * @brief Argument name
+   */
+  const std::string &name() const {
+    return input_.name();
+  }
+
+ private:
+  ArgumentInputRef input_;
+  T value_{};
+  bool has_arg_input_ = false;
+  bool has_value_ = false;
+};
+
 /**
  * @brief ArgValue flags for acquire
  *
@@ -94,7 +219,7 @@ class ArgValue {
   using TV = TensorView<StorageCPU, const T, ndim>;
 
   ArgValue(std::string arg_name, const OpSpec &spec)
-      : arg_name_(std::move(arg_name)) {
+      : arg_name_(std::move(arg_name)), input_(arg_name_) {
     has_explicit_const_ = spec.HasArgument(arg_name_);
     has_arg_input_ = spec.HasTensorArgument(arg_name_);
     assert(!(has_explicit_const_ && has_arg_input_));
@@ -149,7 +274,7 @@ class ArgValue {
                ArgValueFlags flags = ArgValue_Default) {
     assert(!(flags & ArgValue_EnforceUniform) || is_uniform(expected_shape));
     if (has_arg_input_) {
-      view_ = view<const T, ndim>(ws.ArgumentInput(arg_name_));
+      view_ = view<const T, ndim>(input_.Get(ws));
       if (flags & ArgValue_AllowEmpty) {
         for (int i = 0; i < nsamples; i++) {
           auto sh_span = view_.shape.tensor_shape_span(i);
@@ -206,7 +331,7 @@ class ArgValue {
                const TensorShape<ndim> &expected_shape,
                ArgValueFlags flags = ArgValue_Default) {
     if (has_arg_input_) {
-      view_ = view<const T, ndim>(ws.ArgumentInput(arg_name_));
+      view_ = view<const T, ndim>(input_.Get(ws));
       span<const int64_t> expected_sh_span(&expected_shape[0], expected_shape.size());
       if (flags & ArgValue_AllowEmpty) {
         for (int i = 0; i < nsamples; i++) {
@@ -260,7 +385,7 @@ class ArgValue {
                ArgValueFlags flags = ArgValue_Default,
                ShapeFromSizeFn &&shape_from_size = {}) {
     if (has_arg_input_) {
-      view_ = view<const T, ndim>(ws.ArgumentInput(arg_name_));
+      view_ = view<const T, ndim>(input_.Get(ws));
       if (flags & ArgValue_EnforceUniform) {
         DALI_ENFORCE(is_uniform(view_.shape),
           make_string("Expected uniform shape for argument \"", arg_name_,
@@ -348,6 +473,7 @@ class ArgValue {
   }
 
   std::string arg_name_;
+  ArgumentInputRef input_;
 
   std::vector<T> data_;
   TLV view_;
@@ -27,7 +27,8 @@ DALI_SCHEMA(ArgHelperTestOp)
     true)
   .AddOptionalArg<float>("scalar", R"(dummy float argument)",
     nullptr,  // no default value
-    true);
+    true)
+  .AddOptionalArg<int>("int_scalar", R"(dummy int argument)", 42, true);
 
 
 static constexpr int kNumSamples = 5;
@@ -248,4 +249,78 @@ TEST(ArgValue, TensorInput_3D_ExpectedShape_AllowEmpty) {
 }
 
 
+TEST(ScalarArg, Constant) {
+  ArgumentWorkspace ws;
+  auto spec = OpSpec("ArgHelperTestOp").AddArg("scalar", 0.5f);
+  ScalarArg<float> arg("scalar", spec);
+  EXPECT_FALSE(arg.HasArgumentInput());
+  for (int i = 0; i < kNumSamples; i++)
+    EXPECT_EQ(0.5f, arg.Get(ws, i));
+
+  ScalarArg<int> def("int_scalar", spec);
+  EXPECT_EQ(42, def.Get(ws, 0));
+
+  OpSpec spec2("ArgHelperTestOp");
+  ScalarArg<float> no_value("scalar", spec2);
+  EXPECT_THROW(no_value.Get(ws, 0), std::runtime_error);
+}
+
+TEST(ScalarArg, TensorInput) {
+  OpSpec spec("ArgHelperTestOp");
+  spec.AddArgumentInput("scalar", "scalar");
+  ScalarArg<float> arg("scalar", spec);
+  ASSERT_TRUE(arg.HasArgumentInput());
+
+  // the operators use several workspaces, one per queue slot
+  ArgumentWorkspace ws[2];
+  std::shared_ptr<TensorVector<CPUBackend>> data[2];
+  for (int w = 0; w < 2; w++) {
+    data[w] = std::make_shared<TensorVector<CPUBackend>>();
+    SetupData(*data[w], uniform_list_shape(kNumSamples, TensorShape<0>{}));
+    data[w]->mutable_tensor<float>(0)[0] = -w;
+    ws[w].AddArgumentInput("scalar", data[w]);
+  }
+  for (int iter = 0; iter < 3; iter++) {
+    for (int w = 0; w < 2; w++) {
+      EXPECT_EQ(-w, arg.Get(ws[w], 0));
+      for (int i = 1; i < kNumSamples; i++)
+        EXPECT_EQ(100 * i, arg.Get(ws[w], i));
+    }
+  }
+
+  // replacing the argument inputs of the workspace invalidates the cached lookup
+  ws[0].Clear();
+  EXPECT_THROW(arg.Get(ws[0], 0), std::runtime_error);
+  ws[0].AddArgumentInput("scalar", data[1]);
+  EXPECT_EQ(-1, arg.Get(ws[0], 0));
+
+  // not a scalar
+  ArgumentWorkspace ws2;
+  auto vec_data = std::make_shared<TensorVector<CPUBackend>>();
+  SetupData(*vec_data, uniform_list_shape(kNumSamples, TensorShape<1>{2}));
+  ws2.AddArgumentInput("scalar", vec_data);
+  EXPECT_THROW(arg.Get(ws2, 0), std::runtime_error);
+
+  // wrong type
+  ScalarArg<int> int_arg("scalar", spec);
+  EXPECT_THROW(int_arg.Get(ws[1], 0), std::runtime_error);
+}
+
+TEST(ArgumentWorkspace, ArgumentInputsVersion) {
+  ArgumentWorkspace ws1, ws2;
+  EXPECT_NE(ws1.ArgumentInputsVersion(), ws2.ArgumentInputsVersion());
+  auto v = ws1.ArgumentInputsVersion();
+  auto data = std::make_shared<TensorVector<CPUBackend>>();
+  ws1.AddArgumentInput("arg", data);
+  EXPECT_NE(v, ws1.ArgumentInputsVersion());
+  auto *desc = ws1.FindArgumentInput("arg");
+  ASSERT_NE(nullptr, desc);
+  EXPECT_EQ(&ws1.ArgumentInput(*desc), data.get());
+  EXPECT_EQ(nullptr, ws1.FindArgumentInput("other"));
+
+  ArgumentWorkspace copy = ws1;
+  EXPECT_NE(ws1.ArgumentInputsVersion(), copy.ArgumentInputsVersion());
+  EXPECT_EQ(&copy.ArgumentInput("arg"), data.get());
+}
+
 }  // namespace dali
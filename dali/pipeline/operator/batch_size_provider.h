@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,6 +15,8 @@
 #ifndef DALI_PIPELINE_OPERATOR_BATCH_SIZE_PROVIDER_H_
 #define DALI_PIPELINE_OPERATOR_BATCH_SIZE_PROVIDER_H_
 
+#include <vector>
+
 namespace dali {
 
 /**
@@ -48,6 +50,16 @@ class BatchSizeProvider {
    * When there's no further data available, Advance() shall throw std::out_of_range
    */
   virtual void Advance() = 0;
+
+  /**
+   * Sets the batch sizes preferred by the executor, in the ascending order; the last one is
+   * the maximum batch size.
+   *
+   * A provider, which gathers a batch from several requests, may use them to decide how many
+   * requests to take, so that the iterations have few distinct batch sizes. By default, they
+   * are ignored.
+   */
+  virtual void SetBatchSizeBuckets(const std::vector<int> &/* buckets */) {}
 };
 
 }  // namespace dali
@@ -0,0 +1,105 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/operator/builtin/external_buffer_pool.h"
+#include <utility>
+#include "dali/core/device_guard.h"
+#include "dali/core/error_handling.h"
+#include "dali/core/format.h"
+
+namespace dali {
+
+ExternalBufferPool::ExternalBufferPool(int device_id, int num_buffers, size_t buffer_bytes,
+                                       ReleaseCallback on_release)
+    : state_(std::make_shared<State>()) {
+  DALI_ENFORCE(num_buffers > 0, make_string(
+    "The number of buffers must be positive, got ", num_buffers));
+  DALI_ENFORCE(buffer_bytes > 0, "The size of the buffers must be positive");
+  DeviceGuard dg(device_id);
+  state_->device_id = device_id;
+  state_->buffer_bytes = buffer_bytes;
+  state_->on_release = std::move(on_release);
+  state_->buffers.reserve(num_buffers);
+  for (int i = 0; i < num_buffers; i++) {
+    // each buffer is a separate allocation, so that it can be registered on its own
+    state_->buffers.push_back(mm::alloc_raw_unique<uint8_t, mm::memory_kind::device>(
+        buffer_bytes, 256));
+  }
+  // lower indices are handed out first
+  for (int i = num_buffers - 1; i >= 0; i--)
+    state_->free.push_back(i);
+  state_->acquired.resize(num_buffers, false);
+}
+
+int ExternalBufferPool::Acquire() {
+  std::unique_lock<std::mutex> lock(state_->mtx);
+  state_->cv.wait(lock, [&]() { return !state_->free.empty(); });
+  int idx = state_->free.back();
+  state_->free.pop_back();
+  state_->acquired[idx] = true;
+  return idx;
+}
+
+int ExternalBufferPool::TryAcquire() {
+  std::lock_guard<std::mutex> lock(state_->mtx);
+  if (state_->free.empty())
+    return -1;
+  int idx = state_->free.back();
+  state_->free.pop_back();
+  state_->acquired[idx] = true;
+  return idx;
+}
+
+void ExternalBufferPool::Wrap(TensorList<GPUBackend> &out, int idx,
+                              const TensorListShape<> &shape, DALIDataType type,
+                              const TensorLayout &layout) {
+  DALI_ENFORCE(idx >= 0 && idx < num_buffers(), make_string(
+    "Buffer index ", idx, " out of range [0, ", num_buffers(), ")."));
+  {
+    std::lock_guard<std::mutex> lock(state_->mtx);
+    DALI_ENFORCE(state_->acquired[idx], make_string(
+      "The buffer ", idx, " must be acquired before it's wrapped."));
+  }
+  size_t bytes = shape.num_elements() * TypeTable::GetTypeInfo(type).size();
+  DALI_ENFORCE(bytes <= buffer_bytes(), make_string(
+    "The batch of ", bytes, " bytes doesn't fit in a buffer of ", buffer_bytes(), " bytes."));
+  // The deleter keeps the memory alive, even if the pool is destroyed before the batch
+  auto state = state_;
+  std::shared_ptr<void> data(buffer(idx), [state, idx](void *) { state->Release(idx); });
+  out.Reset();
+  out.set_device_id(device_id());
+  out.ShareData(data, buffer_bytes(), false, shape, type);
+  out.SetLayout(layout);
+}
+
+void ExternalBufferPool::Release(int idx) {
+  DALI_ENFORCE(idx >= 0 && idx < num_buffers(), make_string(
+    "Buffer index ", idx, " out of range [0, ", num_buffers(), ")."));
+  state_->Release(idx);
+}
+
+void ExternalBufferPool::State::Release(int idx) {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!acquired[idx])
+      return;
+    acquired[idx] = false;
+    free.push_back(idx);
+  }
+  cv.notify_one();
+  if (on_release)
+    on_release(idx);
+}
+
+}  // namespace dali
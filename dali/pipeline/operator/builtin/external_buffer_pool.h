@@ -0,0 +1,118 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_OPERATOR_BUILTIN_EXTERNAL_BUFFER_POOL_H_
+#define DALI_PIPELINE_OPERATOR_BUILTIN_EXTERNAL_BUFFER_POOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "dali/core/api_helper.h"
+#include "dali/core/mm/memory.h"
+#include "dali/core/tensor_layout.h"
+#include "dali/pipeline/data/tensor.h"
+#include "dali/pipeline/data/tensor_list.h"
+
+namespace dali {
+
+/**
+ * @brief A fixed set of device buffers, which are filled outside of DALI and passed to
+ *        a GPU ExternalSource without a copy.
+ *
+ * The buffers are allocated once and keep their addresses for the lifetime of the pool, so they
+ * can be registered with a network stack (e.g. for GPU Direct RDMA) up front.
+ * A buffer is acquired, filled, wrapped in a TensorList with `Wrap` and fed to the ExternalSource
+ * with `no_copy`. When DALI no longer uses the data, the buffer returns to the pool and
+ * the release callback is called with its index - this happens in the thread which drops
+ * the last reference (usually the executor thread), so the callback should be lightweight.
+ *
+ * The memory stays valid until the pool and all the batches wrapping its buffers are destroyed.
+ */
+class DLL_PUBLIC ExternalBufferPool {
+ public:
+  using ReleaseCallback = std::function<void(int buffer_idx)>;
+
+  ExternalBufferPool(int device_id, int num_buffers, size_t buffer_bytes,
+                     ReleaseCallback on_release = {});
+
+  int device_id() const {
+    return state_->device_id;
+  }
+
+  int num_buffers() const {
+    return state_->buffers.size();
+  }
+
+  size_t buffer_bytes() const {
+    return state_->buffer_bytes;
+  }
+
+  /**
+   * @brief The device memory of the buffer `idx` - the address does not change
+   */
+  void *buffer(int idx) const {
+    return state_->buffers[idx].get();
+  }
+
+  /**
+   * @brief Takes a free buffer, waiting until one is released if necessary
+   *
+   * @return The index of the buffer
+   */
+  int Acquire();
+
+  /**
+   * @brief Takes a free buffer, if there's one
+   *
+   * @return The index of the buffer or -1, if all the buffers are in use
+   */
+  int TryAcquire();
+
+  /**
+   * @brief Makes `out` share the buffer `idx`, interpreted as a contiguous batch
+   *        of given shape and type.
+   *
+   * The buffer is released when `out` and all the TensorLists sharing its data are reset or
+   * destroyed. The buffer must not be wrapped more than once per acquisition.
+   */
+  void Wrap(TensorList<GPUBackend> &out, int idx, const TensorListShape<> &shape,
+            DALIDataType type, const TensorLayout &layout = {});
+
+  /**
+   * @brief Returns an acquired buffer to the pool without passing it to DALI
+   */
+  void Release(int idx);
+
+ private:
+  struct State {
+    int device_id;
+    size_t buffer_bytes;
+    std::vector<mm::uptr<uint8_t>> buffers;
+    std::vector<int> free;
+    std::vector<bool> acquired;
+    ReleaseCallback on_release;
+    std::mutex mtx;
+    std::condition_variable cv;
+
+    void Release(int idx);
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATOR_BUILTIN_EXTERNAL_BUFFER_POOL_H_
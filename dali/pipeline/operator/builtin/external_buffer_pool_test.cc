@@ -0,0 +1,108 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/operator/builtin/external_buffer_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "dali/core/cuda_error.h"
+#include "dali/pipeline/pipeline.h"
+
+namespace dali {
+
+TEST(ExternalBufferPool, AcquireRelease) {
+  std::vector<int> released;
+  ExternalBufferPool pool(0, 2, 1024, [&](int idx) { released.push_back(idx); });
+  EXPECT_EQ(pool.num_buffers(), 2);
+  EXPECT_EQ(pool.buffer_bytes(), 1024u);
+  EXPECT_NE(pool.buffer(0), pool.buffer(1));
+
+  int a = pool.Acquire();
+  int b = pool.TryAcquire();
+  EXPECT_NE(a, b);
+  EXPECT_EQ(pool.TryAcquire(), -1);
+
+  pool.Release(a);
+  EXPECT_EQ(released, std::vector<int>{ a });
+  EXPECT_EQ(pool.Acquire(), a);
+
+  {
+    TensorList<GPUBackend> tl;
+    pool.Wrap(tl, b, uniform_list_shape(4, { 16 }), DALI_FLOAT, "X");
+    EXPECT_EQ(tl.raw_tensor(0), pool.buffer(b));
+    EXPECT_EQ(tl.GetLayout(), "X");
+    EXPECT_TRUE(tl.shares_data());
+    // the buffer is still used by tl
+    EXPECT_EQ(pool.TryAcquire(), -1);
+    EXPECT_EQ(released.size(), 1u);
+  }
+  EXPECT_EQ(released.back(), b);
+  EXPECT_EQ(pool.TryAcquire(), b);
+}
+
+TEST(ExternalBufferPool, WrapErrors) {
+  ExternalBufferPool pool(0, 1, 64);
+  TensorList<GPUBackend> tl;
+  // not acquired
+  EXPECT_THROW(pool.Wrap(tl, 0, uniform_list_shape(1, { 4 }), DALI_INT32), std::exception);
+  int idx = pool.Acquire();
+  // too large
+  EXPECT_THROW(pool.Wrap(tl, idx, uniform_list_shape(2, { 16 }), DALI_INT32), std::exception);
+  EXPECT_THROW(pool.Wrap(tl, 1, uniform_list_shape(1, { 4 }), DALI_INT32), std::exception);
+}
+
+TEST(ExternalBufferPool, ReleasedByExternalSource) {
+  const int batch_size = 4, sample_size = 256, num_iters = 6;
+  std::atomic<int> num_released{0};
+  auto pool = std::make_unique<ExternalBufferPool>(
+      0, 3, batch_size * sample_size * sizeof(int32_t),
+      [&](int) { num_released++; });
+
+  Pipeline pipe(batch_size, 1, 0);
+  pipe.AddExternalInput("data", "gpu");
+  pipe.Build({{"data", "gpu"}});
+
+  for (int iter = 0; iter < num_iters; iter++) {
+    // the data fed in earlier iterations is released once consumed, so the buffers are reused
+    int idx = pool->TryAcquire();
+    ASSERT_GE(idx, 0) << "No free buffer in iteration " << iter;
+    CUDA_CALL(cudaMemset(pool->buffer(idx), iter, batch_size * sample_size * sizeof(int32_t)));
+    CUDA_CALL(cudaDeviceSynchronize());
+    TensorList<GPUBackend> batch;
+    pool->Wrap(batch, idx, uniform_list_shape(batch_size, { sample_size }), DALI_INT32);
+    pipe.SetExternalInput("data", batch, AccessOrder::host(), false, false,
+                          ExtSrcNoCopyMode::FORCE_NO_COPY);
+    pipe.RunCPU();
+    pipe.RunGPU();
+    DeviceWorkspace ws;
+    pipe.Outputs(&ws);
+
+    TensorList<CPUBackend> out;
+    auto &output = ws.Output<GPUBackend>(0);
+    out.Copy(output, output.order());
+    CUDA_CALL(cudaStreamSynchronize(output.order().stream()));
+    int32_t expected;
+    memset(&expected, iter, sizeof(expected));
+    for (int i = 0; i < batch_size; i++) {
+      const auto *data = out.tensor<int32_t>(i);
+      for (int j = 0; j < sample_size; j++)
+        ASSERT_EQ(data[j], expected);
+    }
+  }
+  EXPECT_GE(num_released, num_iters - 2);
+}
+
+}  // namespace dali
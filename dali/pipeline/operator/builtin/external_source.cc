@@ -17,11 +17,61 @@
 
 namespace dali {
 
+template <>
+void ExternalSource<CPUBackend>::RunCoalesced(HostWorkspace &ws, int num_requests) {
+  std::vector<std::list<uptr_tv_type>> elms(num_requests);
+  TensorListShape<> shape;
+  {
+    std::unique_lock<std::mutex> busy_lock(busy_m_);
+    shape = CoalescedShape(num_requests);
+    for (auto &elm : elms) {
+      elm = tv_data_.PopFront();
+      state_.pop_front();
+    }
+    batch_requests_.pop_front();
+  }
+  auto &output = ws.template Output<CPUBackend>(0);
+  // the output may hold the user's memory, shared with no_copy in an earlier iteration
+  if (output.shares_data())
+    output.Reset();
+  output.Resize(shape, elms[0].front()->type());
+  output.SetLayout(elms[0].front()->GetLayout());
+
+  auto &thread_pool = ws.GetThreadPool();
+  int out_idx = 0;
+  for (auto &elm : elms) {
+    auto &batch = *elm.front();
+    for (int sample_id = 0; sample_id < batch.num_samples(); sample_id++, out_idx++) {
+      thread_pool.AddWork(
+          [&output, out_idx, &batch, sample_id](int tid) {
+            output.UnsafeCopySample(out_idx, batch, sample_id, AccessOrder::host());
+            output.SetMeta(out_idx, batch.GetMeta(sample_id));
+          },
+          shape.tensor_size(out_idx));
+    }
+  }
+  thread_pool.RunAll();
+
+  for (auto &elm : elms) {
+    if (elm.front()->shares_data())
+      elm.front()->Reset();
+    RecycleBuffer(elm);
+  }
+}
+
 template <>
 void ExternalSource<CPUBackend>::RunImpl(HostWorkspace &ws) {
   std::list<uptr_tv_type> tensor_vector_elm;
   {
     std::unique_lock<std::mutex> busy_lock(busy_m_);
+    int num_requests = NumBatchRequests();
+    if (num_requests > 1) {
+      busy_lock.unlock();
+      RunCoalesced(ws, num_requests);
+      return;
+    }
+    if (!batch_requests_.empty())
+      batch_requests_.pop_front();
     tensor_vector_elm = tv_data_.PopFront();
     state_.pop_front();
   }
@@ -51,6 +101,11 @@ void ExternalSource<CPUBackend>::RunImpl(HostWorkspace &ws) {
     // swap output with tensor_vector_elm content
     std::swap(output, *tensor_vector_elm.front());
   }
+  // Drop the references to the user's memory shared with no_copy - either the batch which was just
+  // copied or the output of an earlier iteration - so that it's released as soon as possible.
+  // It's done outside of the lock, as it may call back the user's code.
+  if (tensor_vector_elm.front()->shares_data())
+    tensor_vector_elm.front()->Reset();
   RecycleBuffer(tensor_vector_elm);
 }
 
@@ -109,5 +164,20 @@ of dimensions in the layout.
 
 Specifying the input dimensionality will be required starting from DALI 2.0)code", nullptr)
   .AddOptionalArg<TensorLayout>("layout",
-    "If provided, sets the layout of the data.", nullptr);
+    "If provided, sets the layout of the data.", nullptr)
+  .AddOptionalArg<float>("max_batch_delay", R"code(If provided, the batches fed to the operator
+are requests, which are coalesced into the batches of the iterations.
+
+A batch is made of the consecutive requests, up to the maximum batch size of the pipeline.
+The iteration waits for more requests until the batch is full, but for no longer than
+``max_batch_delay`` seconds since the oldest of the pending requests was fed. With
+the ``batch_size_buckets`` of the pipeline, the batch is made of as many requests as give
+one of the bucket sizes, if possible.
+
+The requests are never split, so the outputs of an iteration are the outputs of
+the requests fed in its order - the first ``n`` samples belong to the first request of
+``n`` samples, and so on.
+
+Supported only by the CPU operator. When the pipeline has several inputs, only one of them
+should coalesce the requests.)code", nullptr);
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -45,6 +45,13 @@ void ExternalSource<GPUBackend>::RunImpl(DeviceWorkspace &ws) {
 
   std::swap(output, *tensor_list_elm.front());
 
+  // The element now holds the output of an earlier iteration, which is no longer used.
+  // If it's the user's memory shared with no_copy, drop the reference, so that the memory is
+  // released right away (e.g. returned to an ExternalBufferPool) instead of when the element
+  // is reused. It's done outside of the lock, as it may call back the user's code.
+  if (tensor_list_elm.front()->shares_data())
+    tensor_list_elm.front()->Reset();
+
   if (!state_info.no_copy || state_info.copied_shared_data) {
     RecycleBuffer(tensor_list_elm, &internal_copy_to_storage);
   } else {
@@ -15,8 +15,12 @@
 #ifndef DALI_PIPELINE_OPERATOR_BUILTIN_EXTERNAL_SOURCE_H_
 #define DALI_PIPELINE_OPERATOR_BUILTIN_EXTERNAL_SOURCE_H_
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -52,6 +56,7 @@ struct CudaEventWrapper : CUDAEvent {
  * - Recycle moves passed element to the free list
  * - PushBack moves element to the full list
  * - IsEmpty checks if the full list is empty
+ * - begin and end iterate over the full list
  * All functions operate on one element list as transferring elements between list is a very low
  * cost operation, which doesn't involve any memory allocation, while adding an element to the list
  * requires allocation of the memory for the storage in the list.
@@ -76,6 +81,17 @@ class CachingList {
     return full_data_.front();
   }
 
+  /**
+   * @brief Iterators over the full list, from the front
+   */
+  typename std::list<T>::const_iterator begin() const {
+    return full_data_.begin();
+  }
+
+  typename std::list<T>::const_iterator end() const {
+    return full_data_.end();
+  }
+
   std::list<T> PopFront() {
     assert(!full_data_.empty());  // Can't pop from an empty list
     std::list<T> tmp;
@@ -161,6 +177,44 @@ auto get_batch_size(const BatchContainer<Backend>& container) {
   return container.num_samples();
 }
 
+/**
+ * @brief Makes `out` share the data of `batch` through pointers which co-own `guard`
+ *
+ * The guard is released when all the references to the shared data are dropped.
+ */
+template <typename Backend>
+void ShareWithGuard(TensorList<Backend> &out, const TensorList<Backend> &batch,
+                    const std::shared_ptr<void> &guard) {
+  out.set_device_id(batch.device_id());
+  out.ShareData(std::shared_ptr<void>(guard, const_cast<void *>(unsafe_raw_data(batch))),
+                batch.nbytes(), batch.is_pinned(), batch.shape(), batch.type(), batch.order());
+  out.SetLayout(batch.GetLayout());
+  for (int i = 0; i < batch.num_samples(); i++)
+    out.SetMeta(i, batch.GetMeta(i));
+}
+
+template <typename Backend>
+void ShareWithGuard(TensorVector<Backend> &out, const TensorVector<Backend> &batch,
+                    const std::shared_ptr<void> &guard) {
+  if (batch.IsContiguous()) {
+    // keep it contiguous, so that the GPU ExternalSource doesn't need a copy
+    TensorList<Backend> tl;
+    ShareWithGuard(tl, *const_cast<TensorVector<Backend> &>(batch).AsTensorList(), guard);
+    out.ShareData(tl);
+    return;
+  }
+  int N = batch.num_samples();
+  out.SetSize(N);
+  const auto &type_info = batch.type_info();
+  for (int i = 0; i < N; i++) {
+    auto shape = batch.tensor_shape(i);
+    out.UnsafeSetSample(i, std::shared_ptr<void>(guard, const_cast<void *>(batch.raw_tensor(i))),
+                        volume(shape) * type_info.size(), batch.is_pinned(), shape,
+                        batch.type(), batch.order(), batch.GetLayout());
+    out.SetMeta(i, batch.GetMeta(i));
+  }
+}
+
 }  // namespace detail
 
 
@@ -198,6 +252,16 @@ struct ExtSrcSettingMode {
    *  override the mode of operation forcing the copy or no-copy
    */
   ExtSrcNoCopyMode no_copy_mode = ExtSrcNoCopyMode::DEFAULT;
+  /**
+   * @brief Called when DALI no longer references the provided data
+   *
+   * With no_copy, it's called once the pipeline has consumed the batch and dropped all
+   * the references to it - until then, the data must stay valid and unmodified. Otherwise it's
+   * called as soon as the data is copied.
+   * The callback may be invoked from an executor thread, so it should be lightweight and must
+   * not feed the ExternalSource.
+   */
+  std::function<void()> on_release;
 };
 
 /**
@@ -232,6 +296,18 @@ class ExternalSource : public Operator<Backend>, virtual public BatchSizeProvide
     }
     spec.TryGetArgument(layout_, "layout");
     InferNdim();
+    float max_batch_delay = 0;
+    if (spec.TryGetArgument(max_batch_delay, "max_batch_delay")) {
+      DALI_ENFORCE(max_batch_delay >= 0, make_string("The max_batch_delay can't be negative, got ",
+                   max_batch_delay, "."));
+      constexpr bool is_cpu = std::is_same<Backend, CPUBackend>::value;
+      DALI_ENFORCE(is_cpu,
+                   "The requests can be coalesced (max_batch_delay) only by the CPU "
+                   "ExternalSource.");
+      coalesce_ = true;
+      max_batch_delay_ = std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(max_batch_delay));
+    }
     output_name_ = spec.Output(0);
     sync_worker_.WaitForInit();
   }
@@ -297,13 +373,34 @@ class ExternalSource : public Operator<Backend>, virtual public BatchSizeProvide
   }
 
   int NextBatchSize() override {
-    std::lock_guard<std::mutex> busy_lock(busy_m_);
-    return GetStorage().PeekProphet()->num_samples();
+    std::unique_lock<std::mutex> busy_lock(busy_m_);
+    if (!coalesce_)
+      return GetStorage().PeekProphet()->num_samples();
+    if (next_batch_requests_ == 0)
+      CoalesceRequests(busy_lock);
+    return next_batch_samples_;
   }
 
   void Advance() override {
+    std::unique_lock<std::mutex> busy_lock(busy_m_);
+    if (!coalesce_) {
+      GetStorage().AdvanceProphet();
+      return;
+    }
+    if (next_batch_requests_ == 0)
+      CoalesceRequests(busy_lock);
+    for (int i = 0; i < next_batch_requests_; i++) {
+      GetStorage().AdvanceProphet();
+      pending_requests_.pop_front();
+    }
+    batch_requests_.push_back(next_batch_requests_);
+    next_batch_requests_ = 0;
+    next_batch_samples_ = 0;
+  }
+
+  void SetBatchSizeBuckets(const std::vector<int> &buckets) override {
     std::lock_guard<std::mutex> busy_lock(busy_m_);
-    GetStorage().AdvanceProphet();
+    batch_size_buckets_ = buckets;
   }
 
   DISABLE_COPY_MOVE_ASSIGN(ExternalSource);
@@ -340,6 +437,9 @@ class ExternalSource : public Operator<Backend>, virtual public BatchSizeProvide
     if (std::is_same<Backend, GPUBackend>::value) {
       output_desc[0].shape = tl_data_.PeekFront()->shape();
       output_desc[0].type = tl_data_.PeekFront()->type();
+    } else if (NumBatchRequests() > 1) {
+      output_desc[0].shape = CoalescedShape(NumBatchRequests());
+      output_desc[0].type = tv_data_.PeekFront()->type();
     } else {
       output_desc[0].shape = tv_data_.PeekFront()->shape();
       output_desc[0].type = tv_data_.PeekFront()->type();
@@ -363,6 +463,11 @@ class ExternalSource : public Operator<Backend>, virtual public BatchSizeProvide
 
   void RunImpl(workspace_t<Backend> &ws) override;
 
+  /**
+   * @brief Concatenates the batches of the coalesced requests in the output
+   */
+  void RunCoalesced(workspace_t<Backend> &ws, int num_requests);
+
   void RecycleBufferHelper(std::list<uptr_tl_type> &data) {
     tl_data_.Recycle(data);
   }
@@ -594,12 +699,112 @@ class ExternalSource : public Operator<Backend>, virtual public BatchSizeProvide
         break;
     }
 
-    if (actual_no_copy) {
+    auto &on_release = ext_src_setting_mode.on_release;
+    if (actual_no_copy && on_release) {
+      // The batch is shared through a guard - the callback is called when the last
+      // reference to the data held by DALI is gone.
+      std::shared_ptr<void> guard(nullptr, [cb = std::move(on_release)](void *) { cb(); });
+      SourceDataType<SrcBackend> guarded;
+      detail::ShareWithGuard(guarded, batch, guard);
+      guard.reset();
+      ShareUserData(guarded, order, ext_src_setting_mode.use_copy_kernel);
+      // A non-contiguous batch is still copied by the GPU ExternalSource
+      if (std::is_same<Backend, GPUBackend>::value && !guarded.IsContiguous())
+        AccessOrder::host().wait(order);
+    } else if (actual_no_copy) {
       ShareUserData(batch, order, ext_src_setting_mode.use_copy_kernel);
     } else {
-      CopyUserData(batch, order, ext_src_setting_mode.sync, ext_src_setting_mode.use_copy_kernel);
+      CopyUserData(batch, order, ext_src_setting_mode.sync || on_release,
+                   ext_src_setting_mode.use_copy_kernel);
+      if (on_release) {
+        AccessOrder::host().wait(order);
+        on_release();
+      }
+    }
+    if (coalesce_) {
+      std::lock_guard<std::mutex> busy_lock(busy_m_);
+      pending_requests_.push_back({static_cast<int>(batch.num_samples()), Clock::now()});
+    }
+    // both the executor (coalescing the requests) and the operator's Setup may be waiting
+    cv_.notify_all();
+  }
+
+  /**
+   * @brief The number of the requests gathered in the batch of the current iteration
+   */
+  int NumBatchRequests() const {
+    return batch_requests_.empty() ? 1 : batch_requests_.front();
+  }
+
+  /**
+   * @brief The shape of the concatenation of the first `num_requests` batches in the storage
+   */
+  TensorListShape<> CoalescedShape(int num_requests) {
+    auto end = std::next(tv_data_.begin(), num_requests);
+    int total = 0;
+    for (auto it = tv_data_.begin(); it != end; ++it)
+      total += (*it)->num_samples();
+    TensorListShape<> shape(total, tv_data_.PeekFront()->shape().sample_dim());
+    int idx = 0;
+    for (auto it = tv_data_.begin(); it != end; ++it) {
+      for (int i = 0; i < (*it)->num_samples(); i++)
+        shape.set_tensor_shape(idx++, (*it)->shape()[i]);
+    }
+    return shape;
+  }
+
+  /**
+   * @brief Checks if the pending requests can't grow the next batch anymore - they reach
+   *        the maximum batch size or the next one doesn't fit
+   */
+  bool NextBatchFull() const {
+    int total = 0;
+    for (auto &request : pending_requests_) {
+      if (total + request.num_samples > OperatorBase::max_batch_size_)
+        return true;
+      total += request.num_samples;
+    }
+    return total == OperatorBase::max_batch_size_;
+  }
+
+  /**
+   * @brief Decides which of the pending requests make the batch of the next iteration
+   *
+   * Waits until the batch is full, but no longer than max_batch_delay since the oldest of
+   * the requests was fed. Then it takes the longest run of requests whose total number of
+   * samples is one of the batch size buckets or, if there's none, the longest one that fits in
+   * the maximum batch size. The requests are never split.
+   */
+  void CoalesceRequests(std::unique_lock<std::mutex> &busy_lock) {
+    if (blocking_) {
+      cv_.wait(busy_lock, [&]() { return !pending_requests_.empty(); });
+      auto deadline = pending_requests_.front().fed_at + max_batch_delay_;
+      cv_.wait_until(busy_lock, deadline, [&]() { return NextBatchFull(); });
+    } else if (pending_requests_.empty()) {
+      throw std::out_of_range("No data was provided to the ExternalSource.");
+    }
+    int total = 0, num_requests = 0;
+    int fitting_total = 0, fitting_requests = 0;
+    int bucket_total = 0, bucket_requests = 0;
+    for (auto &request : pending_requests_) {
+      total += request.num_samples;
+      num_requests++;
+      if (total > OperatorBase::max_batch_size_)
+        break;
+      fitting_total = total;
+      fitting_requests = num_requests;
+      if (std::binary_search(batch_size_buckets_.begin(), batch_size_buckets_.end(), total)) {
+        bucket_total = total;
+        bucket_requests = num_requests;
+      }
+    }
+    if (bucket_requests > 0) {
+      next_batch_requests_ = bucket_requests;
+      next_batch_samples_ = bucket_total;
+    } else {
+      next_batch_requests_ = fitting_requests;
+      next_batch_samples_ = fitting_total;
     }
-    cv_.notify_one();
   }
 
   string output_name_;
@@ -645,6 +850,22 @@ class ExternalSource : public Operator<Backend>, virtual public BatchSizeProvide
 
   WorkerThread sync_worker_;
 
+  using Clock = std::chrono::steady_clock;
+  // the batches fed are coalesced into the batches of the iterations (see max_batch_delay)
+  bool coalesce_ = false;
+  Clock::duration max_batch_delay_{};
+  std::vector<int> batch_size_buckets_;
+  struct PendingRequest {
+    int num_samples;
+    Clock::time_point fed_at;
+  };
+  // the requests not yet assigned to an iteration - from the prophet on
+  std::deque<PendingRequest> pending_requests_;
+  // the requests and samples in the batch of the next iteration, once it's decided; 0 otherwise
+  int next_batch_requests_ = 0, next_batch_samples_ = 0;
+  // the number of the requests in the batches of the iterations which didn't run yet
+  std::deque<int> batch_requests_;
+
  private:
   using storage_t =
       std::conditional_t<std::is_same<Backend, GPUBackend>::value,
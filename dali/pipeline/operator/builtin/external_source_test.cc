@@ -651,6 +651,143 @@ TEST(ExternalSourceTest, SerializeDeserializeAddExternalInput) {
 }
 
 
+template <typename Backend>
+void TestReleaseCallback(const std::string &dev, bool no_copy) {
+  const int batch_size = 4, num_iters = 6;
+  std::vector<int> released(num_iters, 0);
+  std::vector<TensorList<Backend>> inputs(num_iters);
+  {
+    Pipeline pipe(batch_size, 1, 0);
+    pipe.AddExternalInput("es", dev);
+    pipe.Build({{"es", dev}});
+    for (int iter = 0; iter < num_iters; iter++) {
+      TensorList<CPUBackend> input_cpu;
+      input_cpu.Resize(uniform_list_shape(batch_size, {16}), DALI_INT32);
+      for (int i = 0; i < batch_size; i++)
+        for (int j = 0; j < 16; j++)
+          input_cpu.mutable_tensor<int>(i)[j] = iter;
+      inputs[iter].Copy(input_cpu, AccessOrder::host());
+      CUDA_CALL(cudaStreamSynchronize(0));
+      pipe.SetExternalInput("es", inputs[iter], AccessOrder::host(), false, false,
+                            no_copy ? ExtSrcNoCopyMode::FORCE_NO_COPY
+                                    : ExtSrcNoCopyMode::FORCE_COPY,
+                            [&released, iter]() { released[iter]++; });
+      if (!no_copy)
+        EXPECT_EQ(released[iter], 1) << "The copied data should be released right away";
+      pipe.RunCPU();
+      pipe.RunGPU();
+      DeviceWorkspace ws;
+      pipe.Outputs(&ws);
+      TensorList<CPUBackend> output_cpu;
+      if (dev == "cpu") {
+        output_cpu.Copy(ws.Output<CPUBackend>(0), AccessOrder::host());
+      } else {
+        auto &output = ws.Output<GPUBackend>(0);
+        output_cpu.Copy(output, output.order());
+        CUDA_CALL(cudaStreamSynchronize(output.order().stream()));
+      }
+      for (int i = 0; i < batch_size; i++)
+        ASSERT_EQ(output_cpu.tensor<int>(i)[15], iter);
+    }
+    // the data is released when the output of the iteration is overwritten
+    for (int iter = 0; iter < num_iters - 2; iter++)
+      EXPECT_EQ(released[iter], 1) << "Iteration " << iter << " was not released";
+  }
+  for (int iter = 0; iter < num_iters; iter++)
+    EXPECT_EQ(released[iter], 1) << "Iteration " << iter << " was not released exactly once";
+}
+
+TEST(ExternalSourceTest, ReleaseCallbackCPU) {
+  TestReleaseCallback<CPUBackend>("cpu", true);
+  TestReleaseCallback<CPUBackend>("cpu", false);
+}
+
+namespace {
+
+TensorList<CPUBackend> MakeRequest(int num_samples, int first_value) {
+  TensorList<CPUBackend> request;
+  request.Resize(uniform_list_shape(num_samples, {4}), DALI_INT32);
+  for (int i = 0; i < num_samples; i++)
+    for (int j = 0; j < 4; j++)
+      request.mutable_tensor<int>(i)[j] = first_value + i;
+  return request;
+}
+
+/**
+ * @brief Runs an iteration and returns the first value of each of the samples of the output
+ */
+std::vector<int> RunCoalescedIteration(Pipeline &pipe) {
+  pipe.RunCPU();
+  pipe.RunGPU();
+  DeviceWorkspace ws;
+  pipe.Outputs(&ws);
+  auto &output = ws.Output<CPUBackend>(0);
+  std::vector<int> values;
+  for (int i = 0; i < output.num_samples(); i++)
+    values.push_back(output.tensor<int>(i)[0]);
+  return values;
+}
+
+}  // namespace
+
+TEST(ExternalSourceTest, CoalesceRequests) {
+  Pipeline pipe(4, 2, 0, -1, false, 1, false);
+  pipe.AddOperator(OpSpec("ExternalSource")
+                       .AddArg("device", "cpu")
+                       .AddArg("name", "es")
+                       .AddArg("max_batch_delay", 0.0f)
+                       .AddOutput("es", "cpu"),
+                   "es");
+  pipe.Build({{"es", "cpu"}});
+
+  // the pending requests are taken as long as they fit, without waiting for more
+  pipe.SetExternalInput("es", MakeRequest(1, 0));
+  pipe.SetExternalInput("es", MakeRequest(2, 10));
+  pipe.SetExternalInput("es", MakeRequest(2, 20));
+  EXPECT_EQ(RunCoalescedIteration(pipe), std::vector<int>({0, 10, 11}));
+  EXPECT_EQ(RunCoalescedIteration(pipe), std::vector<int>({20, 21}));
+
+  // a full batch doesn't wait for the deadline
+  pipe.SetExternalInput("es", MakeRequest(3, 30));
+  pipe.SetExternalInput("es", MakeRequest(1, 40));
+  EXPECT_EQ(RunCoalescedIteration(pipe), std::vector<int>({30, 31, 32, 40}));
+}
+
+TEST(ExternalSourceTest, CoalesceRequestsBuckets) {
+  Pipeline pipe(8, 2, 0, -1, false, 1, false);
+  pipe.AddOperator(OpSpec("ExternalSource")
+                       .AddArg("device", "cpu")
+                       .AddArg("name", "es")
+                       .AddArg("max_batch_delay", 0.001f)
+                       .AddOutput("es", "cpu"),
+                   "es");
+  pipe.SetBatchSizeBuckets({2, 4});
+  pipe.Build({{"es", "cpu"}});
+
+  // 5 samples pending - the batch is cut at the largest bucket
+  for (int i = 0; i < 5; i++)
+    pipe.SetExternalInput("es", MakeRequest(1, i));
+  EXPECT_EQ(RunCoalescedIteration(pipe), std::vector<int>({0, 1, 2, 3}));
+  EXPECT_EQ(RunCoalescedIteration(pipe), std::vector<int>({4}));
+}
+
+TEST(ExternalSourceTest, CoalesceRequestsGPU) {
+  Pipeline pipe(4, 2, 0);
+  pipe.AddOperator(OpSpec("ExternalSource")
+                       .AddArg("device", "gpu")
+                       .AddArg("name", "es")
+                       .AddArg("max_batch_delay", 0.0f)
+                       .AddOutput("es", "gpu"),
+                   "es");
+  EXPECT_THROW(pipe.Build({{"es", "gpu"}}), std::exception);
+}
+
+TEST(ExternalSourceTest, ReleaseCallbackGPU) {
+  TestReleaseCallback<GPUBackend>("gpu", true);
+  TestReleaseCallback<GPUBackend>("gpu", false);
+}
+
+
 // Data for `DeserializeLegacyExternalSource` was generated with DALI 1.0.0 using the code below:
 // TEST(ExternalSourceGen, GeneratePipelines) {
 //   {
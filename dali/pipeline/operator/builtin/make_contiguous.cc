@@ -19,9 +19,19 @@ namespace dali {
 void MakeContiguousCPU::RunImpl(HostWorkspace &ws) {
   auto &input = ws.template Input<CPUBackend>(0);
   auto &output = ws.template Output<CPUBackend>(0);
+  if (input.IsContiguous()) {
+    output.ShareData(input);
+    output.SetLayout(input.GetLayout());
+    return;
+  }
+  // don't write to the memory of a batch passed through in a previous iteration
+  if (output.shares_data())
+    output.Reset();
+  output.SetContiguous(true);
   int batch_size = input.num_samples();
-  output.SetLayout(input.GetLayout());
   auto shapes = input.shape();
+  output.Resize(shapes, input.type());
+  output.SetLayout(input.GetLayout());
 
   auto &thread_pool = ws.GetThreadPool();
   for (int sample_id = 0; sample_id < batch_size; ++sample_id) {
@@ -38,6 +48,7 @@ DALI_SCHEMA(MakeContiguous)
   .DocStr(R"code(Move input batch to a contiguous representation, more suitable for execution on the GPU)code")
   .NumInput(1)
   .NumOutput(1)
+  .IterationOverlap()  // the staging buffer is released in the stream order
   .MakeInternal();
 
 }  // namespace dali
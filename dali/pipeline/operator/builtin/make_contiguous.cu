@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstring>
+#include "dali/core/cuda_error.h"
 #include "dali/core/nvtx.h"
 #include "dali/pipeline/operator/builtin/make_contiguous.h"
 
@@ -38,8 +40,42 @@ void MakeContiguousMixed::Run(MixedWorkspace &ws) {
   auto &output = ws.Output<GPUBackend>(0);
   if (coalesced) {
     DomainTimeRange tr("[DALI][MakeContiguousMixed] coalesced", DomainTimeRange::kBlue);
-    cpu_output_buff.Copy(input);
-    output.Copy(cpu_output_buff, ws.stream());
+    // The staging buffer may still be read by the copy issued in the previous iteration.
+    // Instead of waiting for that copy, the buffer is released in the stream order - the pinned
+    // memory pool reuses the memory once the copy completes - and a new one is allocated.
+    cpu_output_buff.Reset();
+    cpu_output_buff.set_order(AccessOrder::host());
+    cpu_output_buff.Resize(input.shape(), type);
+
+    output.Resize(input.shape(), type);
+    output.SetLayout(input.GetLayout());
+    // the copies below are issued on the stream - it must not overtake the output's uses
+    AccessOrder order = ws.stream();
+    order.wait(output.order());
+
+    // The samples are gathered in chunks and each chunk is uploaded as soon as it's complete,
+    // so that gathering the next chunk overlaps with the transfer of the previous one.
+    // Both buffers are contiguous and have the same shape, so a range of samples occupies
+    // the same, contiguous range of bytes in each of them.
+    int chunk_start = 0;
+    size_t chunk_bytes = 0;
+    for (int i = 0; i < static_cast<int>(batch_size); i++) {
+      size_t sample_bytes = input[i].shape().num_elements() * type_size;
+      std::memcpy(cpu_output_buff.raw_mutable_tensor(i), input[i].raw_data(), sample_bytes);
+      output.SetMeta(i, input.GetMeta(i));
+      chunk_bytes += sample_bytes;
+      if (chunk_bytes >= kStagingChunkBytes || i == static_cast<int>(batch_size) - 1) {
+        if (chunk_bytes > 0) {
+          CUDA_CALL(cudaMemcpyAsync(output.raw_mutable_tensor(chunk_start),
+                                    cpu_output_buff.raw_tensor(chunk_start), chunk_bytes,
+                                    cudaMemcpyHostToDevice, ws.stream()));
+        }
+        chunk_start = i + 1;
+        chunk_bytes = 0;
+      }
+    }
+    // the staging buffer is read by the copies above - it's released in the stream order
+    cpu_output_buff.set_order(ws.stream(), false);
   } else {
     DomainTimeRange tr("[DALI][MakeContiguousMixed] non coalesced", DomainTimeRange::kGreen);
       output.Copy(input, ws.stream());
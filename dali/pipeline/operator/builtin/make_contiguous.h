@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -71,13 +71,33 @@ class MakeContiguousMixed : public MakeContiguousBase<MixedBackend> {
   void Run(MixedWorkspace &ws) override;
 
   DISABLE_COPY_MOVE_ASSIGN(MakeContiguousMixed);
+
+ private:
+  /// @brief The size of the chunks of the coalesced batch, which are uploaded separately
+  static constexpr size_t kStagingChunkBytes = 256 << 10;
 };
 
+/**
+ * @brief Gathers the samples of a CPU batch into a contiguous allocation
+ *
+ * A batch which is already contiguous is passed through - the output shares it instead of
+ * copying it - so the copy is made only when it's actually needed. The output is therefore
+ * allocated by the operator itself (its shape is not reported by Setup), which also lets the
+ * buffer reuse planner treat the input and the output as aliases.
+ */
 class MakeContiguousCPU : public MakeContiguousBase<CPUBackend> {
  public:
   inline explicit MakeContiguousCPU(const OpSpec &spec) :
       MakeContiguousBase<CPUBackend>(spec) {}
 
+  bool CanInferOutputs() const override {
+    return false;
+  }
+
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) override {
+    return false;
+  }
+
   using Operator<CPUBackend>::RunImpl;
   void RunImpl(HostWorkspace &ws) override;
   DISABLE_COPY_MOVE_ASSIGN(MakeContiguousCPU);
@@ -0,0 +1,59 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_OPERATOR_CHECKPOINTING_H_
+#define DALI_PIPELINE_OPERATOR_CHECKPOINTING_H_
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+/**
+ * @brief Appends the binary representation of a trivially copyable value (e.g. a counter or
+ * a random engine) to the state of an operator, see OperatorBase::SaveState
+ */
+template <typename T>
+void AppendOpState(std::string &state, const T &value) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable values can be stored as binary state.");
+  state.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * @brief Reads a value stored with AppendOpState at `offset` and advances the offset
+ */
+template <typename T>
+void ReadOpState(T &value, const std::string &state, size_t &offset) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable values can be stored as binary state.");
+  DALI_ENFORCE(offset + sizeof(T) <= state.size(),
+               "The operator state in the checkpoint is too short.");
+  std::memcpy(&value, state.data() + offset, sizeof(T));
+  offset += sizeof(T);
+}
+
+/**
+ * @brief Checks that the whole state was read
+ */
+inline void CheckOpStateEnd(const std::string &state, size_t offset) {
+  DALI_ENFORCE(offset == state.size(),
+               "The operator state in the checkpoint doesn't match the operator.");
+}
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATOR_CHECKPOINTING_H_
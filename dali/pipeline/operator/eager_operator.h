@@ -16,6 +16,7 @@
 #define DALI_PIPELINE_OPERATOR_EAGER_OPERATOR_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -24,6 +25,7 @@
 
 #include "dali/core/cuda_stream_pool.h"
 #include "dali/core/nvtx.h"
+#include "dali/core/spinlock.h"
 #include "dali/pipeline/data/backend.h"
 #include "dali/pipeline/data/tensor_list.h"
 #include "dali/pipeline/operator/op_spec.h"
@@ -47,7 +49,9 @@ std::shared_ptr<TensorList<Backend>> AsTensorList(std::shared_ptr<TensorVector<B
     auto tl = in->AsTensorList(false);
     // Explicitly set layout (it could be empty in case of per-sample operators).
     tl->SetLayout(in->GetLayout());
-    return tl;
+    // The TensorList shares the ownership of the TensorVector, so that the vector isn't reused
+    // (see EagerOutputPool) as long as the TensorList is referenced.
+    return {std::move(in), tl.get()};
   }
 
   auto tl = std::make_shared<TensorList<Backend>>();
@@ -63,6 +67,76 @@ void MakeContiguous(std::shared_ptr<TensorVector<CPUBackend>> storage) {
   storage->SetContiguous(true);
 }
 
+/**
+ * @brief Whether the memory of the batch is referenced only by the batch itself (e.g. not by
+ *        the Tensors sharing the samples), so it can be overwritten.
+ */
+template <typename Backend>
+bool OwnsAllocation(TensorList<Backend> &tl) {
+  if (tl.shares_data())
+    return false;
+  if (tl.num_samples() == 0 || tl.capacity() == 0)
+    return true;
+  // the owner obtained here and the one of the TensorList
+  return unsafe_sample_owner(tl, 0).use_count() <= 2;
+}
+
+template <typename Backend>
+bool OwnsAllocation(TensorVector<Backend> &tv) {
+  return tv.IsContiguous() && OwnsAllocation(*tv.AsTensorList(false));
+}
+
+/**
+ * @brief The output batches of an EagerOperator, reused when they're no longer referenced
+ *
+ * The batch handed out by Get returns to the pool when the last reference to it is released
+ * (the pool can be destroyed before that). It's reused by a later Get for a batch of the same
+ * size, with its memory, unless the memory is still referenced from outside of the batch.
+ */
+template <typename Storage>
+class EagerOutputPool : public std::enable_shared_from_this<EagerOutputPool<Storage>> {
+ public:
+  explicit EagerOutputPool(size_t max_free) : max_free_(max_free) {}
+
+  std::shared_ptr<Storage> Get(int batch_size) {
+    std::unique_ptr<Storage> storage;
+    {
+      std::lock_guard<spinlock> g(lock_);
+      for (auto it = free_.begin(); it != free_.end(); ++it) {
+        if ((*it)->num_samples() == batch_size && OwnsAllocation(**it)) {
+          storage = std::move(*it);
+          free_.erase(it);
+          break;
+        }
+      }
+    }
+    bool reused = storage != nullptr;
+    if (!reused)
+      storage = std::make_unique<Storage>(batch_size);
+    std::weak_ptr<EagerOutputPool> weak_pool = this->shared_from_this();
+    std::shared_ptr<Storage> ret(storage.release(), [weak_pool](Storage *s) {
+      if (auto pool = weak_pool.lock())
+        pool->Put(std::unique_ptr<Storage>(s));
+      else
+        delete s;
+    });
+    if (!reused)
+      MakeContiguous(ret);
+    return ret;
+  }
+
+ private:
+  void Put(std::unique_ptr<Storage> storage) {
+    std::lock_guard<spinlock> g(lock_);
+    if (free_.size() < max_free_)
+      free_.push_back(std::move(storage));
+  }
+
+  size_t max_free_;
+  spinlock lock_;
+  std::vector<std::unique_ptr<Storage>> free_;
+};
+
 template <typename Backend>
 struct Backend2Types {};
 
@@ -121,6 +195,8 @@ class DLL_PUBLIC EagerOperator {
     op_ = InstantiateOperator(op_spec_);
     num_outputs_ = op_spec_.GetSchema().CalculateOutputs(op_spec_) +
                    op_spec_.GetSchema().CalculateAdditionalOutputs(op_spec_);
+    // enough to double-buffer the outputs
+    output_pool_ = std::make_shared<EagerOutputPool<WSOutputType>>(2 * num_outputs_);
   }
 
   // Runs operator using shared thread pool and shared CUDA stream.
@@ -129,6 +205,20 @@ class DLL_PUBLIC EagerOperator {
       const std::unordered_map<std::string, std::shared_ptr<TensorList<CPUBackend>>> &kwargs,
       int batch_size = -1);
 
+  /**
+   * @brief Runs operator using shared CUDA stream, optionally without waiting for the work
+   *        to complete.
+   *
+   * With `synchronize` = false, the outputs can only be passed to other operators running
+   * in the shared stream (the GPU and mixed eager operators) until SynchronizeSharedStream
+   * is called - that's how several operators are chained without a host synchronization
+   * after each of them.
+   */
+  DLL_PUBLIC std::vector<std::shared_ptr<TensorList<OutBackend>>> Run(
+      const std::vector<std::shared_ptr<TensorList<InBackend>>> &inputs,
+      const std::unordered_map<std::string, std::shared_ptr<TensorList<CPUBackend>>> &kwargs,
+      bool synchronize, int batch_size = -1);
+
   // Runs operator using specified thread pool.
   DLL_PUBLIC std::vector<std::shared_ptr<TensorList<OutBackend>>> Run(
       const std::vector<std::shared_ptr<TensorList<InBackend>>> &inputs,
@@ -139,11 +229,12 @@ class DLL_PUBLIC EagerOperator {
   DLL_PUBLIC std::vector<std::shared_ptr<TensorList<OutBackend>>> Run(
       const std::vector<std::shared_ptr<TensorList<InBackend>>> &inputs,
       const std::unordered_map<std::string, std::shared_ptr<TensorList<CPUBackend>>> &kwargs,
-      CUDAStreamLease &cuda_stream, int batch_size = -1);
+      CUDAStreamLease &cuda_stream, int batch_size = -1, bool synchronize = true);
 
   // Update shared thread pool used for all direct operators.
   DLL_PUBLIC inline static void UpdateThreadPool(int num_threads) {
-    shared_thread_pool = std::make_unique<ThreadPool>(num_threads, CPU_ONLY_DEVICE_ID, false);
+    shared_thread_pool = std::make_unique<ThreadPool>(num_threads, CPU_ONLY_DEVICE_ID, false,
+                                                      "EagerOperator");
   }
 
   // Update shared CUDA stream used for all direct operators.
@@ -154,6 +245,11 @@ class DLL_PUBLIC EagerOperator {
     }
   }
 
+  // Waits for the work issued to the shared CUDA stream, see Run with `synchronize`.
+  DLL_PUBLIC inline static void SynchronizeSharedStream() {
+    CUDA_CALL(cudaStreamSynchronize(shared_cuda_stream));
+  }
+
  private:
   std::vector<std::shared_ptr<TensorList<OutBackend>>> RunImpl(
       const std::vector<std::shared_ptr<TensorList<InBackend>>> &inputs,
@@ -173,6 +269,9 @@ class DLL_PUBLIC EagerOperator {
   int max_batch_size_;
   size_t num_outputs_;
   workspace_t<Backend> ws_;
+  // the wrappers of the inputs, kept between the runs
+  std::vector<std::shared_ptr<WSInputType>> ws_inputs_;
+  std::shared_ptr<EagerOutputPool<WSOutputType>> output_pool_;
   OpSpec op_spec_;
   std::string name_;
   std::unique_ptr<OperatorBase> op_;
@@ -190,6 +289,15 @@ EagerOperator<Backend>::Run(
   return Run(inputs, kwargs, shared_cuda_stream, batch_size);
 }
 
+template <typename Backend>
+std::vector<std::shared_ptr<TensorList<typename EagerOperator<Backend>::OutBackend>>>
+EagerOperator<Backend>::Run(
+    const std::vector<std::shared_ptr<TensorList<InBackend>>> &inputs,
+    const std::unordered_map<std::string, std::shared_ptr<TensorList<CPUBackend>>> &kwargs,
+    bool synchronize, int batch_size) {
+  return Run(inputs, kwargs, shared_cuda_stream, batch_size, synchronize);
+}
+
 template <>
 std::vector<std::shared_ptr<TensorList<CPUBackend>>> EagerOperator<CPUBackend>::Run(
     const std::vector<std::shared_ptr<TensorList<CPUBackend>>> &inputs,
@@ -221,14 +329,15 @@ std::vector<std::shared_ptr<TensorList<typename EagerOperator<Backend>::OutBacke
 EagerOperator<Backend>::Run(
     const std::vector<std::shared_ptr<TensorList<InBackend>>> &inputs,
     const std::unordered_map<std::string, std::shared_ptr<TensorList<CPUBackend>>> &kwargs,
-    CUDAStreamLease &cuda_stream, int batch_size) {
+    CUDAStreamLease &cuda_stream, int batch_size, bool synchronize) {
   try {
     DomainTimeRange tr("[DALI][" + std::string(Backend2Types<Backend>::name) + " op] " + name_,
                        DomainTimeRange::knvGreen);
     ws_.Clear();
     ws_.set_stream(cuda_stream);
     auto output = RunImpl(inputs, kwargs, batch_size);
-    CUDA_CALL(cudaStreamSynchronize(cuda_stream));
+    if (synchronize)
+      CUDA_CALL(cudaStreamSynchronize(cuda_stream));
     return output;
   } catch (std::exception &e) {
     throw std::runtime_error(ExtendErrorMsg(Backend2Types<Backend>::name, e.what()));
@@ -245,8 +354,12 @@ EagerOperator<Backend>::RunImpl(
                make_string("Expected batch size lower or equal to max batch size. Requested: ",
                            batch_size, " > ", max_batch_size_));
   // Convert and add inputs to the workspace.
+  if (ws_inputs_.size() < inputs.size())
+    ws_inputs_.resize(inputs.size());
   for (size_t in_idx = 0; in_idx < inputs.size(); ++in_idx) {
-    auto tensor_in = std::make_shared<WSInputType>();
+    auto &tensor_in = ws_inputs_[in_idx];
+    if (!tensor_in)
+      tensor_in = std::make_shared<WSInputType>();
     tensor_in->ShareData(*inputs[in_idx]);
     int cur_batch_size = tensor_in->num_samples();
 
@@ -278,9 +391,7 @@ EagerOperator<Backend>::RunImpl(
   std::vector<std::shared_ptr<TensorList<OutBackend>>> outputs(num_outputs_);
 
   for (size_t i = 0; i < num_outputs_; ++i) {
-    auto tensor_out = std::make_shared<WSOutputType>(batch_size);
-    MakeContiguous(tensor_out);
-    ws_.AddOutput(tensor_out);
+    ws_.AddOutput(output_pool_->Get(batch_size));
   }
 
   ws_.SetBatchSizes(batch_size);
@@ -15,7 +15,9 @@
 #include "dali/pipeline/operator/op_schema.h"
 
 #include <string>
+#include <vector>
 #include "dali/pipeline/operator/op_spec.h"
+#include "dali/plugin/plugin_manager.h"
 #include "dali/core/python_util.h"
 
 namespace dali {
@@ -37,19 +39,28 @@ OpSchema& SchemaRegistry::RegisterSchema(const std::string &name) {
 }
 
 const OpSchema& SchemaRegistry::GetSchema(const std::string &name) {
-  auto &schema_map = registry();
-  auto it = schema_map.find(name);
-  DALI_ENFORCE(it != schema_map.end(), "Schema for operator '" +
+  auto *schema = TryGetSchema(name);
+  DALI_ENFORCE(schema != nullptr, "Schema for operator '" +
       name + "' not registered");
-  return it->second;
+  return *schema;
 }
 
 const OpSchema* SchemaRegistry::TryGetSchema(const std::string &name) {
   auto &schema_map = registry();
   auto it = schema_map.find(name);
+  // the schema may come from an operator module, which is not loaded yet
+  if (it == schema_map.end() && PluginManager::LoadOperatorModule(name))
+    it = schema_map.find(name);
   return it != schema_map.end() ? &it->second : nullptr;
 }
 
+std::vector<std::string> SchemaRegistry::RegisteredSchemas() {
+  std::vector<std::string> names;
+  for (auto &entry : registry())
+    names.push_back(entry.first);
+  return names;
+}
+
 int OpSchema::CalculateOutputs(const OpSpec &spec) const {
   if (!output_fn_) {
     return num_output_;
@@ -304,4 +315,9 @@ bool OpSchema::ArgSupportsPerFrameInput(const std::string &arg_name) const {
   return arg_desc && arg_desc->supports_per_frame;
 }
 
+bool OpSchema::ArgSupportsGPUInput(const std::string &arg_name) const {
+  auto arg_desc = FindTensorArgument(arg_name);
+  return arg_desc && arg_desc->supports_gpu;
+}
+
 }  // namespace dali
@@ -55,6 +55,7 @@ struct DeprecatedArgDef {
 
 struct TensorArgDesc {
   bool supports_per_frame = false;
+  bool supports_gpu = false;
 };
 
 enum class InputDevice : uint8_t {
@@ -578,10 +579,27 @@ graph even if its outputs are not used.)code", false);
   /**
    * @brief Sets a function that infers whether the op can
    * be executed in-place depending on the ops specification.
+   *
+   * An operator supporting in-place execution must produce correct results when its output 0
+   * uses the memory of the input 0. The executor does that only when the shape and type
+   * of both are the same and the input is not used afterwards.
    */
   DLL_PUBLIC inline OpSchema& InPlaceFn(SpecFunc f) {
-    (void)f;
-    REPORT_FATAL_PROBLEM("In-place op support not yet implemented.");
+    in_place_fn_ = std::move(f);
+    return *this;
+  }
+
+  /**
+   * @brief Sets a function that infers whether the output 0 of the op consists of its regular
+   * inputs, joined along the outermost dimension.
+   *
+   * That is, each sample of the output contains the respective samples of the inputs, one after
+   * another. The executor can then make the producers write their outputs directly into the
+   * output of this op. The op must detect it (the inputs are already at their place in the output)
+   * and skip copying them.
+   */
+  DLL_PUBLIC inline OpSchema& ConcatenatesInputsFn(SpecFunc f) {
+    concatenates_inputs_fn_ = std::move(f);
     return *this;
   }
 
@@ -610,6 +628,141 @@ graph even if its outputs are not used.)code", false);
     return *this;
   }
 
+  /**
+   * @brief Notes that the inputs and the outputs of this operator can have different
+   *        batch sizes, e.g. because it routes a subset of the samples to each of its outputs.
+   *
+   * The executor doesn't enforce the uniform batch size for such an operator; its requested
+   * batch size is that of its first argument input (e.g. a per-sample predicate), if any.
+   */
+  DLL_PUBLIC inline OpSchema& NonUniformBatch() {
+    non_uniform_batch_ = true;
+    return *this;
+  }
+
+  /**
+   * @brief Notes that the GPU work of this operator can be captured in a CUDA graph
+   *        and replayed as long as the inputs and outputs stay the same.
+   *
+   * The executor can replay the captured work instead of running the operator, as long as
+   * the addresses, shapes and types of all inputs and outputs are the same as at the time of
+   * the capture. Only an operator which meets all of the following can be marked:
+   *  - the GPU work depends only on the inputs, outputs and constant (non-tensor) arguments,
+   *    without any per-iteration state (e.g. random numbers generated on the host),
+   *  - the temporary memory used by the GPU work comes from the kernel scratchpads,
+   *  - any other memory referred to by the GPU work stays valid and unchanged,
+   *  - it doesn't synchronize with the host or other streams.
+   */
+  DLL_PUBLIC inline OpSchema& CudaGraphCapturable() {
+    cuda_graph_capturable_ = true;
+    return *this;
+  }
+
+  /**
+   * @brief Notes that the result of the Setup of this operator can be reused in the following
+   *        iterations, as long as its inputs don't change in a way relevant to the Setup.
+   *
+   * The Setup is skipped when the batch size, the shapes, types and layouts of the inputs,
+   * the contents of the argument inputs and the contents of the inputs listed in `value_inputs`
+   * are the same as in the previous iteration. Only an operator which meets all of the following
+   * can be marked:
+   *  - its Setup depends only on the properties listed above and the constant arguments,
+   *  - its Run uses only the state computed in the last Setup and the current workspace
+   *    (it mustn't keep e.g. the views of the argument inputs obtained in the Setup).
+   *
+   * @param value_inputs the inputs whose contents (and not only the shapes) are used
+   *                     in the Setup; if any of them is a GPU input, the Setup is not cached.
+   */
+  DLL_PUBLIC inline OpSchema& CacheableSetup(std::vector<int> value_inputs = {}) {
+    cacheable_setup_ = true;
+    setup_cache_value_inputs_ = std::move(value_inputs);
+    return *this;
+  }
+
+  /**
+   * @brief Notes that the CPU implementation of this operator can be run sample by sample,
+   *        interleaved with the preceding and following operators marked with this flag.
+   *
+   * The executor may then run a chain of such operators as one task per sample, instead of
+   * waiting for the whole batch after each of them. Only an operator which meets all of
+   * the following can be marked:
+   *  - it's run with the default (per-sample) RunImpl(HostWorkspace&), it processes each sample
+   *    with RunImpl(SampleWorkspace&) and it doesn't infer the shapes of its outputs,
+   *  - its batch-level SetupSharedSampleParams doesn't access the inputs, which may be still
+   *    being computed,
+   *  - its inputs are accepted with the layouts as produced - the layouts are verified, but not
+   *    defaulted, after the batch is complete.
+   */
+  DLL_PUBLIC inline OpSchema& SampleChainable() {
+    sample_chainable_ = true;
+    return *this;
+  }
+
+  /**
+   * @brief Notes that the mixed implementation of this operator may start an iteration while
+   *        the GPU work of its previous iteration is still in progress.
+   *
+   * By default, the mixed stage waits for the GPU work of the previous iteration before
+   * it runs the next one. When all its operators are marked, it only waits for the iteration
+   * before the previous one, so that e.g. the host decoding of an iteration overlaps with
+   * the GPU decoding of the previous one. Only an operator which itself waits for the GPU work
+   * using the memory it reuses between iterations (e.g. the pinned staging buffers) before
+   * overwriting it, or releases that memory in the stream order, can be marked.
+   */
+  DLL_PUBLIC inline OpSchema& IterationOverlap() {
+    iteration_overlap_ = true;
+    return *this;
+  }
+
+  /**
+   * @brief Notes that the GPU implementation of this operator can be run on parts of the batch,
+   *        when the whole batch doesn't fit in the device memory.
+   *
+   * When the operator runs out of device memory even after the cached memory is released,
+   * the executor sets it up for the whole batch, allocates the outputs and runs it on the
+   * consecutive sub-batches, which view the respective samples of the inputs, the argument inputs
+   * and the outputs. Only an operator which meets all of the following can be marked:
+   *  - it infers the shapes of its outputs (CanInferOutputs) and its Run doesn't resize them,
+   *  - each output sample depends only on the respective samples of the inputs and argument
+   *    inputs and on the constant arguments,
+   *  - it doesn't keep any state between the iterations (e.g. a random number generator),
+   *    so that running it twice on the same batch gives the same results.
+   */
+  DLL_PUBLIC inline OpSchema& BatchSplittable() {
+    batch_splittable_ = true;
+    return *this;
+  }
+
+  /**
+   * @brief Notes that the GPU implementation of this operator accepts the argument input
+   *        `arg_name` in the GPU memory.
+   *
+   * Such an argument input is consumed where it was produced (or copied to the GPU once) instead
+   * of being copied back to the host in every iteration. The operator must check the placement
+   * with `ArgumentWorkspace::ArgumentInputIsGPU` and read the GPU ones without
+   * accessing their data on the host. The argument must be already added to this schema
+   * as a tensor argument.
+   */
+  DLL_PUBLIC inline OpSchema& AllowGPUArgumentInput(const std::string &arg_name) {
+    auto it = tensor_arguments_.find(arg_name);
+    DALI_ENFORCE(it != tensor_arguments_.end(), make_string("Argument \"", arg_name,
+                 "\" is not a tensor argument of the schema \"", name(), "\"."));
+    it->second.supports_gpu = true;
+    return *this;
+  }
+
+  /**
+   * @brief Notes that the operator must be constructed in the thread that builds the pipeline.
+   *
+   * The operators are constructed in parallel when the pipeline is built. An operator whose
+   * constructor is not thread-safe (e.g. because it accesses the Python objects, which requires
+   * the GIL held by the building thread) should be marked with this flag.
+   */
+  DLL_PUBLIC inline OpSchema& NoParallelConstruction() {
+    no_parallel_construction_ = true;
+    return *this;
+  }
+
   /**
    * @brief Informs that the data passes though this operator unchanged, only
    *        the metadata is affected.
@@ -631,6 +784,17 @@ graph even if its outputs are not used.)code", false);
     return *this;
   }
 
+  /**
+   * @brief Notes that the input can be passed through to every output of the operator
+   *
+   * This is the case of the operators, which return different parts of one input
+   * as separate outputs, without copying the data (e.g. ElementExtract).
+   */
+  DLL_PUBLIC inline OpSchema &PassThroughToAllOutputs(int input_idx) {
+    passthrough_to_all_.insert(input_idx);
+    return *this;
+  }
+
   DLL_PUBLIC inline const vector<std::string>& GetParents() const {
     return parents_;
   }
@@ -786,6 +950,38 @@ graph even if its outputs are not used.)code", false);
     return no_prune_;
   }
 
+  DLL_PUBLIC inline bool IsNonUniformBatch() const {
+    return non_uniform_batch_;
+  }
+
+  DLL_PUBLIC inline bool IsCudaGraphCapturable() const {
+    return cuda_graph_capturable_;
+  }
+
+  DLL_PUBLIC inline bool IsSetupCacheable() const {
+    return cacheable_setup_;
+  }
+
+  DLL_PUBLIC inline const std::vector<int> &SetupCacheValueInputs() const {
+    return setup_cache_value_inputs_;
+  }
+
+  DLL_PUBLIC inline bool IsSampleChainable() const {
+    return sample_chainable_;
+  }
+
+  DLL_PUBLIC inline bool SupportsIterationOverlap() const {
+    return iteration_overlap_;
+  }
+
+  DLL_PUBLIC inline bool IsBatchSplittable() const {
+    return batch_splittable_;
+  }
+
+  DLL_PUBLIC inline bool IsNoParallelConstruction() const {
+    return no_parallel_construction_;
+  }
+
   DLL_PUBLIC inline bool IsSerializable() const {
     return serializable_;
   }
@@ -802,7 +998,15 @@ graph even if its outputs are not used.)code", false);
   }
 
   DLL_PUBLIC inline bool HasPassThrough() const {
-    return !passthrough_map_.empty();
+    return !passthrough_map_.empty() || !passthrough_to_all_.empty();
+  }
+
+  /**
+   * @brief Tells whether the input can be passed through to the given output.
+   */
+  DLL_PUBLIC inline bool IsPassThrough(int input_idx, int output_idx) const {
+    return passthrough_to_all_.count(input_idx) > 0 ||
+           GetPassThroughOutputIdx(input_idx) == output_idx;
   }
 
   DLL_PUBLIC int CalculateOutputs(const OpSpec &spec) const;
@@ -817,6 +1021,11 @@ graph even if its outputs are not used.)code", false);
     return in_place_fn_(spec);
   }
 
+  DLL_PUBLIC inline bool ConcatenatesInputs(const OpSpec &spec) const {
+    if (!concatenates_inputs_fn_) return false;
+    return concatenates_inputs_fn_(spec);
+  }
+
   DLL_PUBLIC void CheckArgs(const OpSpec &spec) const;
 
   /**
@@ -874,6 +1083,7 @@ graph even if its outputs are not used.)code", false);
   DLL_PUBLIC std::vector<std::string> GetArgumentNames() const;
   DLL_PUBLIC bool IsTensorArgument(const std::string &name) const;
   DLL_PUBLIC bool ArgSupportsPerFrameInput(const std::string &arg_name) const;
+  DLL_PUBLIC bool ArgSupportsGPUInput(const std::string &arg_name) const;
 
  private:
   const TensorArgDesc* FindTensorArgument(const std::string &name) const;
@@ -941,7 +1151,7 @@ graph even if its outputs are not used.)code", false);
   // can be turned on for call_dox_ specified manually
   bool append_kwargs_section_ = false;
 
-  SpecFunc output_fn_, in_place_fn_, additional_outputs_fn_;
+  SpecFunc output_fn_, in_place_fn_, concatenates_inputs_fn_, additional_outputs_fn_;
 
   int min_num_input_ = 0, max_num_input_ = 0;
   int num_output_ = 0;
@@ -960,9 +1170,25 @@ graph even if its outputs are not used.)code", false);
 
   bool no_prune_ = false;
 
+  bool non_uniform_batch_ = false;
+
+  bool cuda_graph_capturable_ = false;
+
+  bool no_parallel_construction_ = false;
+
+  bool cacheable_setup_ = false;
+  std::vector<int> setup_cache_value_inputs_;
+
+  bool sample_chainable_ = false;
+
+  bool iteration_overlap_ = false;
+
+  bool batch_splittable_ = false;
+
   bool serializable_ = true;
 
   std::map<int, int> passthrough_map_;
+  std::set<int> passthrough_to_all_;
 
   bool is_deprecated_ = false;
   std::string deprecated_in_favor_of_;
@@ -986,6 +1212,13 @@ class SchemaRegistry {
   DLL_PUBLIC static const OpSchema& GetSchema(const std::string &name);
   DLL_PUBLIC static const OpSchema* TryGetSchema(const std::string &name);
 
+  /**
+   * @brief Returns the names of all the schemas registered so far
+   *
+   * The schemas of the operator modules, which are not loaded yet, are not included.
+   */
+  DLL_PUBLIC static std::vector<std::string> RegisteredSchemas();
+
  private:
   inline SchemaRegistry() {}
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2018, 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -48,7 +48,8 @@ OpSpec& OpSpec::AddOutput(const string &name, const string &device) {
   return *this;
 }
 
-OpSpec& OpSpec::AddArgumentInput(const string &arg_name, const string &inp_name) {
+OpSpec& OpSpec::AddArgumentInput(const string &arg_name, const string &inp_name,
+                                 const string &device) {
   DALI_ENFORCE(!this->HasArgument(arg_name), make_string(
       "Argument ", arg_name, " is already specified."));
   const OpSchema& schema = GetSchema();
@@ -58,7 +59,7 @@ OpSpec& OpSpec::AddArgumentInput(const string &arg_name, const string &inp_name)
       "Argument `", arg_name, "` in operator `", schema.name(), "` is not a a tensor argument."));
   argument_inputs_[arg_name] = inputs_.size();
   argument_inputs_indexes_.insert(inputs_.size());
-  AddInput(inp_name, "cpu", false);
+  AddInput(inp_name, device, false);
   return *this;
 }
 
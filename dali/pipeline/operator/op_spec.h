@@ -208,8 +208,11 @@ class DLL_PUBLIC OpSpec {
    * Argument inputs are named inputs that are treated as
    * per-iteration arguments. The input may be added only if
    * corresponding argument exists in the schema.
+   * The input may be stored in the GPU memory only if the schema allows it
+   * (see OpSchema::AllowGPUArgumentInput).
    */
-  DLL_PUBLIC OpSpec& AddArgumentInput(const string &arg_name, const string &inp_name);
+  DLL_PUBLIC OpSpec& AddArgumentInput(const string &arg_name, const string &inp_name,
+                                      const string &device = "cpu");
 
   /**
    * @brief Specifies the name and device (cpu or gpu) of an
@@ -427,30 +430,25 @@ class DLL_PUBLIC OpSpec {
   inline T GetArgumentImpl(const string &name, const ArgumentWorkspace *ws, Index idx) const;
 
   /**
-   * @brief Check if the ArgumentInput of given shape can be used with GetArgument(),
-   *        representing a batch of scalars
+   * @brief Check if a sample of the ArgumentInput can be used with GetArgument(),
+   *        representing a scalar
+   *
+   * The arguments are obtained sample by sample, so only the requested sample is checked -
+   * without building the shape of the whole batch.
    *
    * @argument should_throw whether this function should throw an error if the shape doesn't match
    * @return true iff the shape is allowed to be used as Argument
    */
-  bool CheckScalarArgumentShape(const TensorListShape<> &shape, int batch_size,
-                          const std::string &name, bool should_throw = false) const {
-    DALI_ENFORCE(is_uniform(shape),
-                 "Arguments should be passed as uniform TensorLists. Argument \"" + name +
-                     "\" is not uniform. To access non-uniform argument inputs use "
-                     "ArgumentWorkspace::ArgumentInput method directly.");
-
-    bool valid_shape = true;
-    for (int i = 0; i < shape.num_samples() && valid_shape; i++) {
-      valid_shape = volume(shape[i]) == 1 || shape[i].empty();
-    }
-
+  bool CheckScalarArgumentShape(const TensorShape<> &sample_shape, Index idx,
+                                const std::string &name, bool should_throw = false) const {
+    // a scalar or a tensor with one element
+    bool valid_shape = volume(sample_shape) == 1;
     if (should_throw) {
       DALI_ENFORCE(
           valid_shape,
-          make_string(
-              "Unexpected shape of argument \"", name, "\". Expected batch of ", batch_size,
-              " scalars or a batch of tensors containing one element per sample. Got:\n", shape));
+          make_string("Unexpected shape of argument \"", name, "\". Expected a scalar or "
+                      "a tensor containing one element per sample. Got a tensor of shape ",
+                      sample_shape, " for sample ", idx, "."));
     }
     return valid_shape;
   }
@@ -490,7 +488,7 @@ inline T OpSpec::GetArgumentImpl(
   if (this->HasTensorArgument(name)) {
     DALI_ENFORCE(ws != nullptr, "Tensor value is unexpected for argument \"" + name + "\".");
     const auto &value = ws->ArgumentInput(name);
-    CheckScalarArgumentShape(value.shape(), GetArgument<int>("max_batch_size"), name, true);
+    CheckScalarArgumentShape(value.tensor_shape(idx), idx, name, true);
     DALI_ENFORCE(IsType<T>(value.type()), make_string(
         "Unexpected type of argument \"", name, "\". Expected ",
         TypeTable::GetTypeName<T>(), " and got ", value.type()));
@@ -519,7 +517,7 @@ inline bool OpSpec::TryGetArgumentImpl(
     if (ws == nullptr)
       return false;
     const auto& value = ws->ArgumentInput(name);
-    if (!CheckScalarArgumentShape(value.shape(), GetArgument<int>("max_batch_size"), name, false)) {
+    if (!CheckScalarArgumentShape(value.tensor_shape(idx), idx, name, false)) {
       return false;
     }
     if (!IsType<T>(value.type()))
@@ -16,6 +16,8 @@
 #define DALI_PIPELINE_OPERATOR_OPERATOR_H_
 
 #include <algorithm>
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -33,6 +35,7 @@
 #include "dali/pipeline/operator/op_schema.h"
 #include "dali/pipeline/operator/op_spec.h"
 #include "dali/pipeline/operator/operator_factory.h"
+#include "dali/pipeline/operator/setup_cache.h"
 #include "dali/pipeline/util/batch_utils.h"
 #include "dali/pipeline/util/backend2workspace_map.h"
 #include "dali/pipeline/workspace/device_workspace.h"
@@ -76,6 +79,10 @@ class DLL_PUBLIC OperatorBase {
         default_cuda_stream_priority_(spec.GetArgument<int>("default_cuda_stream_priority")) {
     DALI_ENFORCE(num_threads_ > 0, "Invalid value for argument num_threads.");
     DALI_ENFORCE(max_batch_size_ > 0, "Invalid value for argument max_batch_size.");
+    auto *schema = SchemaRegistry::TryGetSchema(spec.name());
+    non_uniform_batch_ = schema && schema->IsNonUniformBatch();
+    if (schema && schema->IsSetupCacheable())
+      setup_cache_ = std::make_unique<SetupCache>(schema->SetupCacheValueInputs());
   }
 
   DLL_PUBLIC virtual inline ~OperatorBase() {}
@@ -140,6 +147,28 @@ class DLL_PUBLIC OperatorBase {
     return {};
   }
 
+  /**
+   * @brief Returns the state of the operator after its last run, for pipeline checkpoints
+   *
+   * Operators whose outputs depend on the previous iterations (readers, random generators)
+   * override this, so that a pipeline can be resumed exactly from a checkpoint.
+   * The state is an opaque blob, passed back to RestoreState. The default (empty) state
+   * means that the operator is stateless.
+   */
+  DLL_PUBLIC virtual std::string SaveState() {
+    return {};
+  }
+
+  /**
+   * @brief Restores the state returned by SaveState
+   *
+   * Called after the pipeline is built and before its first run.
+   */
+  DLL_PUBLIC virtual void RestoreState(const std::string &state) {
+    DALI_ENFORCE(state.empty(), make_string("Operator \"", spec_.name(),
+                 "\" is stateless and cannot restore a non-empty checkpoint state."));
+  }
+
   DLL_PUBLIC const OpSpec& GetSpec() const {
     return spec_;
   }
@@ -173,9 +202,28 @@ class DLL_PUBLIC OperatorBase {
     using namespace std;  // NOLINT
     static_assert(is_arithmetic_or_half<remove_reference_t<T>>::value || is_enum<T>::value,
                   "The eligible diagnostic entry types are arithmetic types or enum");
-    if (!diagnostics_.emplace(move(name), val).second) {
+    if (!diagnostics_.emplace(name, val).second) {
       DALI_FAIL("Diagnostic with given name already exists");
     }
+    diagnostic_values_.emplace(move(name), [val]() {
+      if constexpr (is_enum<T>::value)
+        return static_cast<double>(static_cast<underlying_type_t<T>>(*val));
+      else
+        return static_cast<double>(*val);
+    });
+  }
+
+  /**
+   * @brief Returns the current values of all the registered diagnostics, converted to double
+   *
+   * Used for monitoring - it can be called while the operator runs in another thread, so
+   * the values of different diagnostics may come from different iterations.
+   */
+  std::map<std::string, double> GetDiagnostics() const {
+    std::map<std::string, double> ret;
+    for (auto &entry : diagnostic_values_)
+      ret.emplace(entry.first, entry.second());
+    return ret;
   }
 
 
@@ -199,6 +247,24 @@ class DLL_PUBLIC OperatorBase {
     dali::GetPerSampleArgument(output, argument_name, spec_, ws, batch_size);
   }
 
+  /**
+   * @brief Runs `setup`, unless the operator's schema allows to reuse the result of the previous
+   *        Setup and the inputs didn't change since then
+   */
+  template <typename Workspace, typename SetupFunc>
+  bool CachedSetup(std::vector<OutputDesc> &output_desc, const Workspace &ws, SetupFunc &&setup) {
+    if (!setup_cache_)
+      return setup();
+    bool result;
+    if (setup_cache_->Lookup(output_desc, result, ws, spec_))
+      return result;
+    // the state of the operator is unknown if the setup throws
+    setup_cache_->Invalidate();
+    result = setup();
+    setup_cache_->Store(output_desc, result);
+    return result;
+  }
+
   // TODO(mszolucha): remove these two to allow i2i variable batch size, when all ops are ready
   template <typename Backend>
   DLL_PUBLIC void EnforceUniformInputBatchSize(const workspace_t<Backend> &ws) const;
@@ -210,8 +276,11 @@ class DLL_PUBLIC OperatorBase {
   int num_threads_;
   int max_batch_size_;
   int default_cuda_stream_priority_;
+  bool non_uniform_batch_ = false;
+  std::unique_ptr<SetupCache> setup_cache_;
 
   std::unordered_map<std::string, any> diagnostics_;
+  std::unordered_map<std::string, std::function<double()>> diagnostic_values_;
 };
 
 #define USE_OPERATOR_MEMBERS()                       \
@@ -270,7 +339,7 @@ class Operator<CPUBackend> : public OperatorBase {
   bool Setup(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) override {
     EnforceUniformInputBatchSize<CPUBackend>(ws);
     CheckInputLayouts(ws, spec_);
-    return SetupImpl(output_desc, ws);
+    return CachedSetup(output_desc, ws, [&]() { return SetupImpl(output_desc, ws); });
   }
 
   void Run(HostWorkspace &ws) override {
@@ -304,25 +373,57 @@ class Operator<CPUBackend> : public OperatorBase {
     // This is implemented, as a default, using the RunImpl that accepts SampleWorkspace,
     // allowing for fallback to old per-sample implementations.
 
-    auto curr_batch_size = ws.NumInput() > 0 ? ws.GetInputBatchSize(0) : max_batch_size_;
-    for (int i = 0; i < ws.NumOutput(); i++) {
-      auto &output = ws.Output<CPUBackend>(i);
-      output.SetSize(curr_batch_size);
-    }
+    int curr_batch_size = PrepareSampleOutputs(ws);
     auto &thread_pool = ws.GetThreadPool();
     for (int data_idx = 0; data_idx < curr_batch_size; ++data_idx) {
       thread_pool.AddWork([this, &ws, data_idx](int tid) {
-        SampleWorkspace sample;
-        MakeSampleView(sample, ws, data_idx, tid);
-        this->SetupSharedSampleParams(sample);
-        this->RunImpl(sample);
+        this->RunSample(ws, data_idx, tid);
       }, -data_idx);  // -data_idx for FIFO order
     }
     // Run all tasks and wait for them to finish
     thread_pool.RunAll();
-    // Propagate metadata from individual samples to the whole batch as working with SampleWorkspace
-    // breaks metadata consistency - it sets it only to samples
-    FixBatchPropertiesConsistency(ws, CanInferOutputs());
+    FinishSampleOutputs(ws);
+  }
+
+  /**
+   * @brief Starts a run of an operator marked with OpSchema::SampleChainable, whose samples
+   *        are then run with RunSample
+   *
+   * Unlike Setup and Run, it doesn't look at the inputs, which may still be computed
+   * (sample by sample) by the preceding operators - the batch properties of the inputs are
+   * verified by EndSampleRun.
+   *
+   * @return the batch size
+   */
+  int BeginSampleRun(HostWorkspace &ws) {
+    std::vector<OutputDesc> output_desc;
+    DALI_ENFORCE(!SetupImpl(output_desc, ws), make_string("The operator \"", spec_.name(),
+                 "\" is marked as sample-chainable, but it infers the shapes of its outputs."));
+    SetupSharedSampleParams(ws);
+    return PrepareSampleOutputs(ws);
+  }
+
+  /**
+   * @brief Runs the sample `data_idx` of an operator started with BeginSampleRun
+   *
+   * The same sample of the inputs must be already computed.
+   */
+  void RunSample(HostWorkspace &ws, int data_idx, int thread_idx) {
+    SampleWorkspace sample;
+    MakeSampleView(sample, ws, data_idx, thread_idx);
+    SetupSharedSampleParams(sample);
+    RunImpl(sample);
+  }
+
+  /**
+   * @brief Finishes a run of an operator started with BeginSampleRun, when all its samples
+   *        are computed
+   */
+  void EndSampleRun(HostWorkspace &ws) {
+    FinishSampleOutputs(ws);
+    EnforceUniformInputBatchSize<CPUBackend>(ws);
+    CheckInputLayouts(ws, spec_);
+    EnforceUniformOutputBatchSize<CPUBackend>(ws);
   }
 
   /**
@@ -340,6 +441,22 @@ class Operator<CPUBackend> : public OperatorBase {
    * should be used instead.
    */
   virtual void SetupSharedSampleParams(HostWorkspace &ws) {}
+
+ private:
+  int PrepareSampleOutputs(HostWorkspace &ws) {
+    int curr_batch_size = ws.NumInput() > 0 ? ws.GetInputBatchSize(0) : max_batch_size_;
+    for (int i = 0; i < ws.NumOutput(); i++) {
+      auto &output = ws.Output<CPUBackend>(i);
+      output.SetSize(curr_batch_size);
+    }
+    return curr_batch_size;
+  }
+
+  void FinishSampleOutputs(HostWorkspace &ws) {
+    // Propagate metadata from individual samples to the whole batch as working with SampleWorkspace
+    // breaks metadata consistency - it sets it only to samples
+    FixBatchPropertiesConsistency(ws, CanInferOutputs());
+  }
 };
 
 template <>
@@ -355,7 +472,7 @@ class Operator<GPUBackend> : public OperatorBase {
   bool Setup(std::vector<OutputDesc> &output_desc, const DeviceWorkspace &ws) override {
     EnforceUniformInputBatchSize<GPUBackend>(ws);
     CheckInputLayouts(ws, spec_);
-    return SetupImpl(output_desc, ws);
+    return CachedSetup(output_desc, ws, [&]() { return SetupImpl(output_desc, ws); });
   }
 
   void Run(DeviceWorkspace &ws) override {
@@ -397,7 +514,7 @@ class Operator<MixedBackend> : public OperatorBase {
 
   bool Setup(std::vector<OutputDesc> &output_desc, const MixedWorkspace &ws) override {
     EnforceUniformInputBatchSize<MixedBackend>(ws);
-    return SetupImpl(output_desc, ws);
+    return CachedSetup(output_desc, ws, [&]() { return SetupImpl(output_desc, ws); });
   }
 
   /**
@@ -105,6 +105,17 @@ TYPED_TEST(OperatorDiagnosticsTest, IncorrectTypeTest) {
 }
 
 
+TYPED_TEST(OperatorDiagnosticsTest, AllDiagnosticsTest) {
+  (this->operator_)->RegisterDiagnostic(this->value_name_, &this->value_);
+  auto diagnostics = this->operator_->GetDiagnostics();
+  ASSERT_EQ(diagnostics.size(), 1u);
+  EXPECT_EQ(diagnostics[this->value_name_], static_cast<double>(this->value_));
+  // the current value is read
+  this->value_ = TypeParam{};
+  EXPECT_EQ(this->operator_->GetDiagnostics()[this->value_name_], 0);
+}
+
+
 TYPED_TEST(OperatorDiagnosticsTest, NonexistingParameterTest) {
   EXPECT_THROW(this->operator_->template GetDiagnostic<TypeParam>(this->value_name_),
                std::runtime_error);
@@ -330,6 +330,9 @@ class SequenceOperator : public Operator<Backend> {
   }
 
   void ExpandArguments(const ArgumentWorkspace &ws) {
+    DALI_ENFORCE(!ws.HasGPUArgumentInputs(), make_string(
+        "The argument inputs stored in the GPU memory are not supported when operator `",
+        spec_.name(), "` processes the frames of sequences as separate samples."));
     for (const auto &arg_input : ws) {
       auto &shared_tvec = arg_input.second.tvec;
       assert(shared_tvec);
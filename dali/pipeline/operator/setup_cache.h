@@ -0,0 +1,168 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_OPERATOR_SETUP_CACHE_H_
+#define DALI_PIPELINE_OPERATOR_SETUP_CACHE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/pipeline/data/backend.h"
+#include "dali/pipeline/data/types.h"
+#include "dali/pipeline/operator/op_spec.h"
+#include "dali/pipeline/workspace/workspace.h"
+
+namespace dali {
+
+/**
+ * @brief Remembers the result of the last Setup of an operator
+ *
+ * The result is identified by a key made of everything the Setup of a cacheable operator
+ * may depend on: the batch size, the shapes, types and layouts of the inputs, the complete
+ * argument inputs and the contents of the selected (value) inputs. When the key of the current
+ * iteration is the same as the stored one, the stored output descriptors are returned and
+ * the Setup of the operator can be skipped.
+ *
+ * Only one entry is kept: the state which the operator keeps between its Setup and Run
+ * (e.g. the kernel requirements) reflects only its last Setup.
+ */
+class SetupCache {
+ public:
+  explicit SetupCache(std::vector<int> value_inputs = {})
+  : value_inputs_(std::move(value_inputs)) {}
+
+  /**
+   * @brief Builds the key of `ws` and checks whether the stored result matches it
+   *
+   * @return true, if `output_desc` and `result` were set to the stored ones
+   */
+  template <typename Workspace>
+  bool Lookup(std::vector<OutputDesc> &output_desc, bool &result,
+              const Workspace &ws, const OpSpec &spec) {
+    key_valid_ = BuildKey(key_, ws, spec);
+    if (!key_valid_ || !stored_ || key_ != stored_key_)
+      return false;
+    output_desc = output_desc_;
+    result = result_;
+    return true;
+  }
+
+  /**
+   * @brief Stores the result of the Setup run for the key built by the last `Lookup`
+   */
+  void Store(const std::vector<OutputDesc> &output_desc, bool result) {
+    stored_ = key_valid_;
+    if (!stored_)
+      return;
+    std::swap(stored_key_, key_);
+    output_desc_ = output_desc;
+    result_ = result;
+  }
+
+  /**
+   * @brief Forgets the stored result, e.g. after a failed Setup
+   */
+  void Invalidate() {
+    stored_ = false;
+  }
+
+ private:
+  template <typename T>
+  static void Append(std::vector<uint8_t> &key, const T &value) {
+    Append(key, &value, sizeof(T));
+  }
+
+  static void Append(std::vector<uint8_t> &key, const void *data, size_t bytes) {
+    auto *begin = static_cast<const uint8_t *>(data);
+    key.insert(key.end(), begin, begin + bytes);
+  }
+
+  template <typename Batch>
+  static void AppendMeta(std::vector<uint8_t> &key, const Batch &batch) {
+    Append(key, batch.type());
+    auto layout = batch.GetLayout();
+    Append(key, layout.size());
+    Append(key, layout.c_str(), layout.size());
+    const auto &shape = batch.shape();
+    Append(key, shape.sample_dim());
+    Append(key, shape.num_samples());
+    Append(key, shape.shapes.data(), shape.shapes.size() * sizeof(shape.shapes[0]));
+  }
+
+  template <typename Batch>
+  static void AppendData(std::vector<uint8_t> &key, const Batch &batch) {
+    size_t element_size = TypeTable::GetTypeInfo(batch.type()).size();
+    const auto &shape = batch.shape();
+    for (int s = 0; s < shape.num_samples(); s++)
+      Append(key, batch.raw_tensor(s), shape.tensor_size(s) * element_size);
+  }
+
+  bool IsValueInput(int idx) const {
+    return std::find(value_inputs_.begin(), value_inputs_.end(), idx) != value_inputs_.end();
+  }
+
+  /**
+   * @return false, if the key can't be built, because a value input or an argument input
+   *         is not accessible from the host
+   */
+  template <typename Workspace>
+  bool BuildKey(std::vector<uint8_t> &key, const Workspace &ws, const OpSpec &spec) const {
+    key.clear();
+    int num_outputs = ws.NumOutput();
+    Append(key, num_outputs);
+    for (int o = 0; o < num_outputs; o++)
+      Append(key, ws.GetRequestedBatchSize(o));
+    int num_inputs = ws.NumInput();
+    Append(key, num_inputs);
+    for (int i = 0; i < num_inputs; i++) {
+      if (ws.template InputIsType<CPUBackend>(i)) {
+        auto &in = ws.template Input<CPUBackend>(i);
+        Append(key, uint8_t{0});
+        AppendMeta(key, in);
+        if (IsValueInput(i))
+          AppendData(key, in);
+      } else {
+        if (IsValueInput(i))
+          return false;
+        auto &in = ws.template Input<GPUBackend>(i);
+        Append(key, uint8_t{1});
+        AppendMeta(key, in);
+      }
+    }
+    // the order of the iteration is fixed for the given spec
+    for (auto &arg : spec.ArgumentInputs()) {
+      if (ws.ArgumentInputIsGPU(arg.first))
+        return false;
+      auto &arg_input = ws.ArgumentInput(arg.first);
+      AppendMeta(key, arg_input);
+      AppendData(key, arg_input);
+    }
+    return true;
+  }
+
+  std::vector<int> value_inputs_;
+  std::vector<uint8_t> key_, stored_key_;
+  bool key_valid_ = false;
+  bool stored_ = false;
+  std::vector<OutputDesc> output_desc_;
+  bool result_ = false;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATOR_SETUP_CACHE_H_
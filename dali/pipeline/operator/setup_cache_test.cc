@@ -0,0 +1,117 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "dali/pipeline/operator/op_schema.h"
+#include "dali/pipeline/operator/setup_cache.h"
+#include "dali/pipeline/workspace/host_workspace.h"
+
+namespace dali {
+
+DALI_SCHEMA(SetupCacheTestOp)
+  .DocStr(R"(Dummy op schema)")
+  .NumInput(1, 2)
+  .NumOutput(1)
+  .AddOptionalArg<int>("arg", R"(dummy int argument)", 0, true);
+
+namespace testing {
+
+namespace {
+
+std::shared_ptr<TensorVector<CPUBackend>> MakeBatch(const TensorListShape<> &shape,
+                                                    int value = 0) {
+  auto batch = std::make_shared<TensorVector<CPUBackend>>();
+  batch->set_pinned(false);
+  batch->Resize(shape, DALI_INT32);
+  for (int i = 0; i < batch->num_samples(); i++) {
+    int *data = batch->mutable_tensor<int>(i);
+    for (int j = 0; j < shape.tensor_size(i); j++)
+      data[j] = value;
+  }
+  return batch;
+}
+
+}  // namespace
+
+TEST(SetupCacheTest, ReusesResultForSameShapes) {
+  OpSpec spec("SetupCacheTestOp");
+  SetupCache cache({1});
+  std::vector<OutputDesc> desc(1), cached;
+  desc[0] = { uniform_list_shape(2, {3, 4}), DALI_INT32 };
+  bool result = false;
+
+  auto data = MakeBatch(uniform_list_shape(2, {3, 4}));
+  auto value = MakeBatch(uniform_list_shape(2, {1}), 5);
+  HostWorkspace ws;
+  ws.AddInput(data);
+  ws.AddInput(value);
+  ws.AddOutput(std::make_shared<TensorVector<CPUBackend>>());
+  ws.SetBatchSizes(2);
+
+  EXPECT_FALSE(cache.Lookup(cached, result, ws, spec));
+  cache.Store(desc, true);
+  ASSERT_TRUE(cache.Lookup(cached, result, ws, spec));
+  EXPECT_TRUE(result);
+  ASSERT_EQ(cached.size(), 1u);
+  EXPECT_EQ(cached[0].shape, desc[0].shape);
+  EXPECT_EQ(cached[0].type, DALI_INT32);
+
+  // the contents of a data input don't matter
+  data->mutable_tensor<int>(0)[0] = 42;
+  EXPECT_TRUE(cache.Lookup(cached, result, ws, spec));
+
+  // the contents of a value input do
+  value->mutable_tensor<int>(1)[0] = 42;
+  EXPECT_FALSE(cache.Lookup(cached, result, ws, spec));
+  cache.Store(desc, true);
+  EXPECT_TRUE(cache.Lookup(cached, result, ws, spec));
+
+  // a different shape
+  data->Resize(uniform_list_shape(2, {4, 3}), DALI_INT32);
+  EXPECT_FALSE(cache.Lookup(cached, result, ws, spec));
+
+  cache.Store(desc, true);
+  EXPECT_TRUE(cache.Lookup(cached, result, ws, spec));
+  cache.Invalidate();
+  EXPECT_FALSE(cache.Lookup(cached, result, ws, spec));
+}
+
+TEST(SetupCacheTest, ArgumentInputValues) {
+  OpSpec spec("SetupCacheTestOp");
+  spec.AddArgumentInput("arg", "arg_input");
+  SetupCache cache;
+  std::vector<OutputDesc> desc(1), cached;
+  desc[0] = { uniform_list_shape(2, {3}), DALI_INT32 };
+  bool result = false;
+
+  auto arg = MakeBatch(uniform_list_shape(2, {2}), 1);
+  HostWorkspace ws;
+  ws.AddInput(MakeBatch(uniform_list_shape(2, {3})));
+  ws.AddOutput(std::make_shared<TensorVector<CPUBackend>>());
+  ws.SetBatchSizes(2);
+  ws.AddArgumentInput("arg", arg);
+
+  EXPECT_FALSE(cache.Lookup(cached, result, ws, spec));
+  cache.Store(desc, false);
+  EXPECT_TRUE(cache.Lookup(cached, result, ws, spec));
+  EXPECT_FALSE(result);
+
+  arg->mutable_tensor<int>(0)[1] = 2;
+  EXPECT_FALSE(cache.Lookup(cached, result, ws, spec));
+}
+
+}  // namespace testing
+}  // namespace dali
@@ -25,10 +25,13 @@
 #include "dali/pipeline/executor/async_separated_pipelined_executor.h"
 #include "dali/pipeline/executor/executor_factory.h"
 #include "dali/pipeline/executor/pipelined_executor.h"
+#include "dali/pipeline/graph/op_fusion.h"
 
 #include "dali/pipeline/operator/argument.h"
 #include "dali/pipeline/operator/common.h"
 #include "dali/core/device_guard.h"
+#include "dali/core/util.h"
+#include "dali/core/mm/default_resources.h"
 #include "dali/pipeline/dali.pb.h"
 
 namespace dali {
@@ -48,6 +51,44 @@ bool DeserializePipeline(const std::string &serialized_pipeline,
 }
 
 
+/**
+ * @brief Returns a batch made of the samples [begin, end) of `batch`, sharing its memory
+ */
+template <typename Backend>
+std::shared_ptr<TensorList<Backend>> SliceBatch(TensorList<Backend> &batch, int begin, int end) {
+  auto slice = std::make_shared<TensorList<Backend>>();
+  const auto &shape = batch.shape();
+  TensorListShape<> slice_shape(end - begin, shape.sample_dim());
+  for (int i = begin; i < end; i++)
+    slice_shape.set_tensor_shape(i - begin, shape[i]);
+  slice->set_device_id(batch.device_id());
+  if (slice_shape.num_elements() > 0) {
+    size_t bytes = slice_shape.num_elements() * TypeTable::GetTypeInfo(batch.type()).size();
+    slice->ShareData(unsafe_sample_owner(batch, begin), bytes, batch.is_pinned(), slice_shape,
+                     batch.type(), batch.order());
+  } else {
+    slice->set_pinned(batch.is_pinned());
+    slice->Resize(slice_shape, batch.type());
+  }
+  slice->SetLayout(batch.GetLayout());
+  for (int i = begin; i < end; i++)
+    slice->SetMeta(i - begin, batch.GetMeta(i));
+  return slice;
+}
+
+int MaxOutputBatchSize(const DeviceWorkspace &ws) {
+  int batch_size = 0;
+  for (int i = 0; i < ws.NumOutput(); i++) {
+    int output_batch_size = ws.OutputIsType<CPUBackend>(i) ?
+                            ws.Output<CPUBackend>(i).num_samples() :
+                            ws.Output<GPUBackend>(i).num_samples();
+    batch_size = std::max(batch_size, output_batch_size);
+  }
+  return batch_size;
+}
+
+
+
 void DeserializeOpSpec(const dali_proto::OpDef &def, OpSpec *spec) {
   std::string name = def.name();
 
@@ -78,7 +119,7 @@ void DeserializeOpSpec(const dali_proto::OpDef &def, OpSpec *spec) {
 
   for (int i = 0; i < def.input_size(); ++i) {
     if (def.input(i).is_argument_input()) {
-      spec->AddArgumentInput(def.input(i).arg_name(), def.input(i).name());
+      spec->AddArgumentInput(def.input(i).arg_name(), def.input(i).name(), def.input(i).device());
     }
   }
 
@@ -315,6 +356,17 @@ int Pipeline::AddOperator(const OpSpec &const_spec, const std::string& inst_name
     string error_str = "(op: '" + spec.name() + "', input: '" +
       input_name + "')";
 
+    const std::string &arg_name = spec.ArgumentInputName(input_idx);
+    if (spec.InputDevice(input_idx) == "gpu") {
+      DALI_ENFORCE(device == "gpu" && spec.GetSchema().ArgSupportsGPUInput(arg_name),
+          make_string("Named arguments inputs to operators must be CPU data nodes, unless "
+                      "the GPU operator accepts the argument in the GPU memory. The argument \"",
+                      arg_name, "\" doesn't accept a GPU data node (op: '", spec.name(),
+                      "', input: '", input_name, "')"));
+      SetupGPUInput(it);
+      continue;
+    }
+
     if (!it->second.has_cpu) {
       DALI_FAIL(make_string(
           "Named arguments inputs to operators must be CPU data nodes. However, a GPU ",
@@ -441,19 +493,67 @@ void Pipeline::Build(std::vector<PipelineOutputDesc> output_descs) {
   auto num_outputs = output_descs_.size();
   DALI_ENFORCE(num_outputs > 0,
                make_string("User specified incorrect number of outputs (", num_outputs, ")."));
+  DALI_ENFORCE(!low_latency_ ||
+               (!pipelined_execution_ && !async_execution_ && !dynamic_execution_),
+               "The low latency mode requires the synchronous, non-pipelined execution.");
+  DALI_ENFORCE(coalesce_iterations_ == 1 || !checkpointing_,
+               "The iteration coalescing can't be used with checkpointing.");
 
   executor_ =
-      GetExecutor(pipelined_execution_, separated_execution_, async_execution_, max_batch_size_,
-                  num_threads_, device_id_, bytes_per_sample_hint_, set_affinity_, max_num_stream_,
-                  default_cuda_stream_priority_, prefetch_queue_depth_);
+      GetExecutor(pipelined_execution_, separated_execution_, async_execution_, dynamic_execution_,
+                  coalesced_batch_size(), num_threads_, device_id_, bytes_per_sample_hint_,
+                  set_affinity_,
+                  max_num_stream_, default_cuda_stream_priority_, prefetch_queue_depth_);
   executor_->EnableMemoryStats(enable_memory_stats_);
+  executor_->EnableOperatorTiming(enable_operator_timing_);
+  executor_->EnableBufferReuse(buffer_reuse_);
+  executor_->SetMemoryProfile(memory_profile_);
+  executor_->EnableGrowableBuffers(growable_buffers_);
+  executor_->EnableCudaGraphs(cuda_graphs_);
+  executor_->EnableCheckpointing(checkpointing_);
+  executor_->EnableSharedThreadPool(shared_thread_pool_, thread_pool_priority_);
+  executor_->EnableWorkStealingThreadPool(work_stealing_thread_pool_);
+  executor_->EnableLowLatency(low_latency_);
+  executor_->EnableSampleChaining(sample_chaining_);
+  executor_->SetBatchSizeBuckets(batch_size_buckets_);
+  if (output_alloc_)
+    executor_->SetOutputAllocator(output_alloc_);
+  if (device_id_ != CPU_ONLY_DEVICE_ID &&
+      (device_memory_soft_limit_ || device_memory_hard_limit_)) {
+    device_quota_ = mm::CreateDeviceQuotaResource(device_id_, device_memory_soft_limit_,
+                                                  device_memory_hard_limit_);
+    executor_->SetDeviceMemoryQuota(device_quota_);
+  }
+  if (adaptive_prefetch_) {
+    executor_->EnableAdaptiveQueueDepth(adaptive_prefetch_params_);
+  }
   executor_->Init();
 
   // Creating the graph
+  std::vector<OpSpec> specs;
+  specs.reserve(op_specs_.size());
   for (auto& name_op_spec : op_specs_) {
-    string& inst_name = name_op_spec.instance_name;
-    OpSpec op_spec = name_op_spec.spec;
-    PrepareOpSpec(&op_spec, name_op_spec.logical_id);
+    specs.push_back(name_op_spec.spec);
+    PrepareOpSpec(&specs.back(), name_op_spec.logical_id);
+  }
+  std::vector<bool> fused(specs.size(), false);
+  if (op_fusion_) {
+    std::set<std::string> preserved;
+    for (const auto &out_desc : output_descs_)
+      preserved.insert(out_desc.name);
+    auto folded = FoldConstantTransforms(specs, preserved);
+    fused = FuseArithmeticOps(specs, preserved);
+    auto color_fused = FuseColorTransforms(specs, preserved);
+    for (size_t i = 0; i < specs.size(); i++)
+      fused[i] = fused[i] || folded[i] || color_fused[i];
+  }
+
+  for (size_t i = 0; i < op_specs_.size(); i++) {
+    // merged into its consumer
+    if (fused[i])
+      continue;
+    string& inst_name = op_specs_[i].instance_name;
+    OpSpec &op_spec = specs[i];
     try {
       graph_.AddOp(op_spec, inst_name);
     } catch (std::exception &e) {
@@ -541,7 +641,7 @@ void Pipeline::Build(std::vector<PipelineOutputDesc> output_descs) {
     }
   }
 
-  graph_.InstantiateOperators();
+  graph_.InstantiateOperators(num_threads_, device_id_);
 
   // Load the final graph into the executor
   executor_->Build(&graph_, outputs);
@@ -568,16 +668,103 @@ void Pipeline::SetOutputDescs(std::vector<PipelineOutputDesc> output_descs) {
 void Pipeline::RunCPU() {
   DALI_ENFORCE(built_,
       "\"Build()\" must be called prior to executing the pipeline.");
+  started_ = true;
+  if (coalesce_iterations_ > 1) {
+    std::lock_guard<std::mutex> g(coalesced_run_mutex_);
+    // the stage is run for the first of the coalesced iterations
+    if (coalesced_cpu_slots_-- > 0)
+      return;
+    coalesced_cpu_slots_ += coalesce_iterations_;
+  }
   executor_->RunCPU();
 }
 
 void Pipeline::RunGPU() {
   DALI_ENFORCE(built_,
       "\"Build()\" must be called prior to executing the pipeline.");
+  if (coalesce_iterations_ > 1) {
+    std::lock_guard<std::mutex> g(coalesced_run_mutex_);
+    if (coalesced_gpu_slots_-- > 0)
+      return;
+    coalesced_gpu_slots_ += coalesce_iterations_;
+  }
   executor_->RunMixed();
   executor_->RunGPU();
 }
 
+void Pipeline::RunMissingCoalescedIterations(int missing_slots) {
+  std::lock_guard<std::mutex> g(coalesced_run_mutex_);
+  coalesced_cpu_slots_ -= missing_slots;
+  coalesced_gpu_slots_ -= missing_slots;
+  // the iterations already requested by the user, which the short batch didn't provide
+  for (; coalesced_cpu_slots_ < 0; coalesced_cpu_slots_ += coalesce_iterations_)
+    executor_->RunCPU();
+  for (; coalesced_gpu_slots_ < 0; coalesced_gpu_slots_ += coalesce_iterations_) {
+    executor_->RunMixed();
+    executor_->RunGPU();
+  }
+}
+
+bool Pipeline::ShareCoalescedOutputs(DeviceWorkspace *ws, bool blocking) {
+  std::lock_guard<std::mutex> g(coalesced_outputs_mutex_);
+  if (coalesced_outputs_.empty() ||
+      coalesced_outputs_.back().shared == coalesced_outputs_.back().num_slots) {
+    coalesced_outputs_.emplace_back();
+    auto &coalesced = coalesced_outputs_.back();
+    if (ws->has_stream())
+      coalesced.ws.set_stream(ws->stream());
+    try {
+      if (blocking) {
+        executor_->ShareOutputs(&coalesced.ws);
+      } else if (!executor_->TryShareOutputs(&coalesced.ws)) {
+        coalesced_outputs_.pop_back();
+        return false;
+      }
+    } catch (...) {
+      coalesced_outputs_.pop_back();
+      throw;
+    }
+    int batch_size = MaxOutputBatchSize(coalesced.ws);
+    // an empty batch is returned as such
+    coalesced.num_slots = std::max(div_ceil(batch_size, max_batch_size_), 1);
+    if (coalesced.num_slots < coalesce_iterations_)
+      RunMissingCoalescedIterations(coalesce_iterations_ - coalesced.num_slots);
+  }
+
+  auto &coalesced = coalesced_outputs_.back();
+  int begin = coalesced.shared * max_batch_size_;
+  coalesced.shared++;
+  ws->Clear();
+  if (coalesced.ws.has_stream())
+    ws->set_stream(coalesced.ws.stream());
+  for (int i = 0; i < coalesced.ws.NumOutput(); i++) {
+    if (coalesced.ws.OutputIsType<CPUBackend>(i)) {
+      auto &out = coalesced.ws.Output<CPUBackend>(i);
+      int end = std::min(begin + max_batch_size_, out.num_samples());
+      ws->AddOutput(SliceBatch(out, std::min(begin, end), end));
+    } else {
+      auto &out = coalesced.ws.Output<GPUBackend>(i);
+      int end = std::min(begin + max_batch_size_, out.num_samples());
+      ws->AddOutput(SliceBatch(out, std::min(begin, end), end));
+    }
+  }
+  return true;
+}
+
+void Pipeline::ReleaseCoalescedOutputs() {
+  std::lock_guard<std::mutex> g(coalesced_outputs_mutex_);
+  if (coalesced_outputs_.empty())
+    return;
+  auto &coalesced = coalesced_outputs_.front();
+  if (coalesced.released == coalesced.shared)
+    return;
+  // the coalesced iteration is released by the executor, when all its parts are
+  if (++coalesced.released == coalesced.num_slots) {
+    coalesced_outputs_.pop_front();
+    executor_->ReleaseOutputs();
+  }
+}
+
 void Pipeline::SetCompletionCallback(ExecutorBase::ExecutorCallback cb) {
   executor_->SetCompletionCallback(std::move(cb));
 }
@@ -602,7 +789,12 @@ bool Pipeline::ValidateOutputs(const DeviceWorkspace &ws) const {
 void Pipeline::Outputs(DeviceWorkspace *ws) {
   DALI_ENFORCE(built_, "\"Build()\" must be called prior to executing the pipeline.");
   try {
-    executor_->Outputs(ws);
+    if (coalesce_iterations_ > 1) {
+      ReleaseCoalescedOutputs();
+      ShareCoalescedOutputs(ws, true);
+    } else {
+      executor_->Outputs(ws);
+    }
   } catch (std::exception &e) {
     throw std::runtime_error(make_string("Critical error in pipeline:\n", std::string(e.what()),
                                          "\nCurrent pipeline object is no longer valid."));
@@ -616,7 +808,10 @@ void Pipeline::Outputs(DeviceWorkspace *ws) {
 void Pipeline::ShareOutputs(DeviceWorkspace *ws) {
   DALI_ENFORCE(built_, "\"Build()\" must be called prior to executing the pipeline.");
   try {
-    executor_->ShareOutputs(ws);
+    if (coalesce_iterations_ > 1)
+      ShareCoalescedOutputs(ws, true);
+    else
+      executor_->ShareOutputs(ws);
   } catch (std::exception &e) {
     throw std::runtime_error(make_string("Critical error in pipeline:\n", std::string(e.what()),
                                          "\nCurrent pipeline object is no longer valid."));
@@ -627,11 +822,34 @@ void Pipeline::ShareOutputs(DeviceWorkspace *ws) {
   ValidateOutputs(*ws);
 }
 
+bool Pipeline::TryShareOutputs(DeviceWorkspace *ws) {
+  DALI_ENFORCE(built_, "\"Build()\" must be called prior to executing the pipeline.");
+  bool shared = false;
+  try {
+    if (coalesce_iterations_ > 1)
+      shared = ShareCoalescedOutputs(ws, false);
+    else
+      shared = executor_->TryShareOutputs(ws);
+  } catch (std::exception &e) {
+    throw std::runtime_error(make_string("Critical error in pipeline:\n", std::string(e.what()),
+                                         "\nCurrent pipeline object is no longer valid."));
+  } catch (...) {
+    throw std::runtime_error("Unknown critical error in pipeline.");
+  }
+
+  if (shared)
+    ValidateOutputs(*ws);
+  return shared;
+}
+
 void Pipeline::ReleaseOutputs() {
   DALI_ENFORCE(built_,
       "\"Build()\" must be called prior to executing the pipeline.");
     try {
-      executor_->ReleaseOutputs();
+      if (coalesce_iterations_ > 1)
+        ReleaseCoalescedOutputs();
+      else
+        executor_->ReleaseOutputs();
     } catch (std::exception &e) {
       throw std::runtime_error("Critical error in pipeline:\n"
           + std::string(e.what())
@@ -677,7 +895,7 @@ void Pipeline::PrepareOpSpec(OpSpec *spec, int logical_id) {
   if (logical_id_to_seed_.find(logical_id) == logical_id_to_seed_.end()) {
     logical_id_to_seed_[logical_id] = seed_[current_seed_];
   }
-  spec->AddArg("max_batch_size", max_batch_size_)
+  spec->AddArg("max_batch_size", coalesced_batch_size())
     .AddArg("num_threads", num_threads_)
     .AddArg("device_id", device_id_)
     .AddArgIfNotExisting("seed", logical_id_to_seed_[logical_id]);
@@ -768,6 +986,35 @@ string Pipeline::SerializeToProtobuf() const {
   return output;
 }
 
+string Pipeline::GetSerializedCheckpoint() const {
+  DALI_ENFORCE(built_, "\"Build()\" must be called before taking a checkpoint.");
+  DALI_ENFORCE(checkpointing_, "Checkpointing is not enabled for this pipeline.");
+  auto cpt = executor_->GetCheckpoint();
+  dali_proto::Checkpoint proto;
+  proto.set_iteration(cpt.iteration);
+  for (auto &op : cpt.operators) {
+    auto *op_proto = proto.add_operators();
+    op_proto->set_operator_id(op.operator_id);
+    op_proto->set_operator_name(op.operator_name);
+    op_proto->set_state(op.state);
+  }
+  return proto.SerializeAsString();
+}
+
+void Pipeline::RestoreFromSerializedCheckpoint(const std::string &checkpoint) {
+  DALI_ENFORCE(built_, "\"Build()\" must be called before restoring a checkpoint.");
+  DALI_ENFORCE(checkpointing_, "Checkpointing is not enabled for this pipeline.");
+  DALI_ENFORCE(!started_, "A checkpoint cannot be restored after the pipeline was run.");
+  dali_proto::Checkpoint proto;
+  DALI_ENFORCE(proto.ParseFromString(checkpoint), "Invalid pipeline checkpoint.");
+  Checkpoint cpt;
+  cpt.iteration = proto.iteration();
+  for (auto &op_proto : proto.operators())
+    cpt.operators.push_back({op_proto.operator_id(), op_proto.operator_name(), op_proto.state()});
+  DeviceGuard d(device_id_);
+  executor_->RestoreCheckpoint(cpt);
+}
+
 OpNode * Pipeline::GetOperatorNode(const std::string& name) {
   return &(graph_.Node(name));
 }
@@ -796,6 +1043,17 @@ ReaderMeta Pipeline::GetReaderMeta(std::string name) {
   return meta;
 }
 
+std::map<std::string, std::map<std::string, double>> Pipeline::GetOperatorDiagnostics() {
+  std::map<std::string, std::map<std::string, double>> ret;
+  for (Index i = 0; i < graph_.NumOp(); ++i) {
+    const OpNode &current = graph_.Node(i);
+    auto diagnostics = current.op->GetDiagnostics();
+    if (!diagnostics.empty())
+      ret.emplace(current.instance_name, std::move(diagnostics));
+  }
+  return ret;
+}
+
 const TensorLayout& Pipeline::GetInputLayout(const std::string &name) {
   const auto *node = GetOperatorNode(name);
   if (node->op_type == OpType::CPU) {
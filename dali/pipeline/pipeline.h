@@ -16,9 +16,12 @@
 #define DALI_PIPELINE_PIPELINE_H_
 
 #include <chrono>
+#include <deque>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <set>
 #include <string>
@@ -27,10 +30,13 @@
 #include <vector>
 
 #include "dali/core/common.h"
+#include "dali/core/mm/quota_resource.h"
 #include "dali/pipeline/data/backend.h"
 #include "dali/pipeline/data/tensor.h"
 #include "dali/pipeline/data/tensor_list.h"
 #include "dali/pipeline/executor/executor.h"
+#include "dali/pipeline/executor/memory_profile.h"
+#include "dali/pipeline/executor/operator_timing.h"
 #include "dali/pipeline/graph/op_graph.h"
 #include "dali/pipeline/pipeline_output_desc.h"
 #include "dali/pipeline/operator/builtin/external_source.h"
@@ -190,12 +196,16 @@ class DLL_PUBLIC Pipeline {
    *             to the internal buffer
    * @param no_copy_mode Select whether to use the parameter defined in the External Source or
    *                     override the mode of operation forcing the copy or no-copy
+   * @param on_release Called when the pipeline no longer references the data,
+   *                   see ExtSrcSettingMode::on_release
    */
   template <typename Backend>
   DLL_PUBLIC inline void SetExternalInput(
       const string &name, const TensorList<Backend> &tl, AccessOrder order = {}, bool sync = false,
-      bool use_copy_kernel = false, ExtSrcNoCopyMode no_copy_mode = ExtSrcNoCopyMode::DEFAULT) {
-    SetExternalInputHelper(name, tl, order, {sync, use_copy_kernel, no_copy_mode});
+      bool use_copy_kernel = false, ExtSrcNoCopyMode no_copy_mode = ExtSrcNoCopyMode::DEFAULT,
+      std::function<void()> on_release = {}) {
+    SetExternalInputHelper(name, tl, order,
+                           {sync, use_copy_kernel, no_copy_mode, std::move(on_release)});
   }
 
 
@@ -209,13 +219,17 @@ class DLL_PUBLIC Pipeline {
    *             to the internal buffer
    * @param no_copy_mode Select whether to use the parameter defined in the External Source or
    *                     override the mode of operation forcing the copy or no-copy
+   * @param on_release Called when the pipeline no longer references the data,
+   *                   see ExtSrcSettingMode::on_release
    */
   template <typename Backend>
   DLL_PUBLIC inline void SetExternalInput(
       const string &name, const TensorVector<Backend> &tv, AccessOrder order = {},
       bool sync = false, bool use_copy_kernel = false,
-      ExtSrcNoCopyMode no_copy_mode = ExtSrcNoCopyMode::DEFAULT) {
-    SetExternalInputHelper(name, tv, order, {sync, use_copy_kernel, no_copy_mode});
+      ExtSrcNoCopyMode no_copy_mode = ExtSrcNoCopyMode::DEFAULT,
+      std::function<void()> on_release = {}) {
+    SetExternalInputHelper(name, tv, order,
+                           {sync, use_copy_kernel, no_copy_mode, std::move(on_release)});
   }
 
   /**
@@ -281,14 +295,17 @@ class DLL_PUBLIC Pipeline {
    * @param pipelined_execution Use pipelined execution
    * @param separated_execution Use separated queues
    * @param async_execution Use worker threads for RunX() functions
+   * @param dynamic_execution Schedule the operators as a dependency graph instead of stages
    */
   DLL_PUBLIC void SetExecutionTypes(bool pipelined_execution = true,
-                                    bool separated_execution = false, bool async_execution = true) {
+                                    bool separated_execution = false, bool async_execution = true,
+                                    bool dynamic_execution = false) {
     DALI_ENFORCE(!built_, "Alterations to the pipeline after "
         "\"Build()\" has been called are not allowed - cannot change execution type.");
     pipelined_execution_ = pipelined_execution;
     separated_execution_ = separated_execution;
     async_execution_ = async_execution;
+    dynamic_execution_ = dynamic_execution;
   }
 
   /**
@@ -304,6 +321,82 @@ class DLL_PUBLIC Pipeline {
     }
   }
 
+  /**
+   * @brief Set if the executor should measure the time of the operators and the stages and
+   * the occupancy of the stage queues (see GetOperatorTiming)
+   *
+   * The overhead is a few clock reads and a pair of CUDA events per operator and iteration.
+   */
+  DLL_PUBLIC void EnableOperatorTiming(bool enable = true) {
+    enable_operator_timing_ = enable;
+    if (executor_) {
+      executor_->EnableOperatorTiming(enable_operator_timing_);
+    }
+  }
+
+  /**
+   * @brief Obtains the cumulative timing gathered since EnableOperatorTiming was called
+   */
+  DLL_PUBLIC ExecutorTiming GetOperatorTiming() {
+    if (executor_) {
+      return executor_->GetOperatorTiming();
+    } else {
+      return {};
+    }
+  }
+
+  /**
+   * @brief Set if the chains of element-wise arithmetic operators should be fused into single
+   * operators and the affine transforms which don't depend on the data evaluated when
+   * the pipeline is built (enabled by default)
+   *
+   * Must be called before Build()
+   */
+  DLL_PUBLIC void EnableOperatorFusion(bool enable = true) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after "
+                 "\"Build()\" has been called are not allowed - cannot change operator fusion.");
+    op_fusion_ = enable;
+  }
+
+  /**
+   * @brief Set if the intermediate tensors used within a single stage should reuse the memory
+   * of the tensors that are no longer needed (enabled by default)
+   *
+   * The operators supporting it also compute their outputs in place of their inputs.
+   * Not supported by the dynamic (DAG) executor. Must be called before Build()
+   */
+  DLL_PUBLIC void EnableBufferReuse(bool enable = true) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after "
+                 "\"Build()\" has been called are not allowed - cannot change buffer reuse.");
+    buffer_reuse_ = enable;
+  }
+
+  /**
+   * @brief Loads the output sizes recorded with SaveMemoryProfile in a previous run; the buffers
+   * are reserved accordingly when the pipeline is built.
+   *
+   * Must be called before Build()
+   */
+  DLL_PUBLIC void LoadMemoryProfile(const std::string &path) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after "
+                 "\"Build()\" has been called are not allowed - cannot load memory profile.");
+    memory_profile_ = dali::LoadMemoryProfile(path);
+  }
+
+  /**
+   * @brief Saves the peak output sizes gathered so far by the executor statistics
+   *        (see EnableExecutorMemoryStats), typically after a few warm-up iterations
+   */
+  DLL_PUBLIC void SaveMemoryProfile(const std::string &path) {
+    DALI_ENFORCE(built_ && enable_memory_stats_,
+                 "The memory profile requires a built pipeline with the executor memory "
+                 "statistics enabled.");
+    dali::SaveMemoryProfile(path, GetExecutorMeta());
+  }
+
   /**
    * @brief Obtains the executor statistics
    */
@@ -333,6 +426,242 @@ class DLL_PUBLIC Pipeline {
     prefetch_queue_depth_ = QueueSizes(cpu_size, gpu_size);
   }
 
+  /**
+   * @brief Lets the executor adjust the prefetch queue depth at runtime, based on the observed
+   * stage timings
+   *
+   * The queues start with the depth set by SetQueueSizes and change within [1, max size].
+   * Requires separated execution. Must be called before Build()
+   *
+   * @param max_cpu_size maximum depth of the CPU queue
+   * @param max_gpu_size maximum depth of the GPU queue
+   * @param memory_budget maximum memory of the buffers of one queue, in bytes; 0 means no limit
+   */
+  DLL_PUBLIC void EnableAdaptivePrefetch(int max_cpu_size, int max_gpu_size,
+                                         size_t memory_budget = 0) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after "
+                 "\"Build()\" has been called are not allowed - cannot enable adaptive prefetch.");
+    DALI_ENFORCE(separated_execution_, "Adaptive prefetch requires separated execution.");
+    DALI_ENFORCE(max_cpu_size > 0 && max_gpu_size > 0, "Only positive queue sizes allowed");
+    adaptive_prefetch_ = true;
+    adaptive_prefetch_params_.max_sizes = QueueSizes(max_cpu_size, max_gpu_size);
+    adaptive_prefetch_params_.memory_budget = memory_budget;
+  }
+
+  /**
+   * @brief Sets the limits of the device memory used by the buffers of this pipeline.
+   *
+   * The pipelines running on the same device share the device memory pool - the memory freed
+   * by one of them can be reused by the others. When this pipeline uses more than
+   * `soft_limit`, its GPU buffers release the memory they hold in excess, instead of keeping
+   * their high-water mark. The allocations that would exceed `hard_limit` fail.
+   * 0 means no limit. Must be called before Build()
+   */
+  DLL_PUBLIC void SetDeviceMemoryLimits(size_t soft_limit, size_t hard_limit = 0) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after "
+                 "\"Build()\" has been called are not allowed - cannot set memory limits.");
+    DALI_ENFORCE(!hard_limit || !soft_limit || soft_limit <= hard_limit,
+                 "The soft memory limit cannot exceed the hard limit.");
+    device_memory_soft_limit_ = soft_limit;
+    device_memory_hard_limit_ = hard_limit;
+  }
+
+  /**
+   * @brief Set if the GPU output buffers of the operators should grow in place, by mapping more
+   * physical memory at the end of the allocation, instead of being reallocated (disabled by
+   * default)
+   *
+   * The buffers don't change their address when growing and return the unmapped memory to
+   * the device when shrinking. The memory doesn't come from the memory pool and is not counted
+   * against the device memory limits. Requires the CUDA virtual memory management API; ignored
+   * if it is not supported. Must be called before Build()
+   */
+  DLL_PUBLIC void EnableGrowableBuffers(bool enable = true) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after "
+                 "\"Build()\" has been called are not allowed - cannot enable growable buffers.");
+    growable_buffers_ = enable;
+  }
+
+  /**
+   * @brief Lets the executor capture the work of the GPU stage in a CUDA graph and replay it
+   * while the inputs and outputs of the GPU operators stay the same (disabled by default)
+   *
+   * Used only if all the GPU operators are CUDA graph capturable and have neither CPU nor
+   * argument inputs. Must be called before Build()
+   */
+  DLL_PUBLIC void EnableCudaGraphs(bool enable = true) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after "
+                 "\"Build()\" has been called are not allowed - cannot enable CUDA graphs.");
+    cuda_graphs_ = enable;
+  }
+
+  /**
+   * @brief Makes the pipeline keep the state of its readers and random operators, so that
+   * a checkpoint can be taken with GetSerializedCheckpoint (disabled by default)
+   *
+   * Must be called before Build()
+   */
+  DLL_PUBLIC void EnableCheckpointing(bool enable = true) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after "
+                 "\"Build()\" has been called are not allowed - cannot enable checkpointing.");
+    checkpointing_ = enable;
+  }
+
+  /**
+   * @brief Returns the state of the pipeline after the iterations whose outputs were taken
+   *
+   * A pipeline of the same definition restored from the checkpoint (see
+   * RestoreFromSerializedCheckpoint) returns the same outputs as this pipeline in the following
+   * iterations. Requires EnableCheckpointing.
+   */
+  DLL_PUBLIC std::string GetSerializedCheckpoint() const;
+
+  /**
+   * @brief Restores the state of the pipeline from a checkpoint returned by
+   * GetSerializedCheckpoint
+   *
+   * The readers skip to the restored position without reading the samples of the skipped
+   * iterations. Must be called after Build() and before the pipeline is run.
+   */
+  DLL_PUBLIC void RestoreFromSerializedCheckpoint(const std::string &checkpoint);
+
+  /**
+   * @brief Makes the pipeline run each iteration with the lowest latency, e.g. for online
+   * inference with batches of one sample (disabled by default)
+   *
+   * Requires the synchronous, non-pipelined execution - the stages run in the thread calling
+   * RunCPU/RunGPU, without prefetching - and runs the work the CPU operators issue as a single
+   * job in that thread too, instead of handing it to the thread pool. Must be called before
+   * Build()
+   */
+  DLL_PUBLIC void SetLowLatency(bool low_latency = true) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after "
+                 "\"Build()\" has been called are not allowed - cannot set the low latency mode.");
+    low_latency_ = low_latency;
+  }
+
+  /**
+   * @brief Makes the pipeline run the consecutive per-sample CPU operators (e.g. a decoder
+   * followed by a fused resize and crop) sample by sample, as one job per sample, so that
+   * the work of an operator doesn't wait for the slowest sample of the previous one
+   * (disabled by default)
+   *
+   * Only the operators marked with OpSchema::SampleChainable are chained. Not supported by
+   * the dynamic (DAG) executor. Must be called before Build()
+   */
+  DLL_PUBLIC void EnableSampleChaining(bool enable = true) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after "
+                 "\"Build()\" has been called are not allowed - cannot set sample chaining.");
+    sample_chaining_ = enable;
+  }
+
+  /**
+   * @brief Makes the pipeline run the work of its CPU operators on the worker threads shared by
+   * all the pipelines in the process which enable it (disabled by default)
+   *
+   * The shared threads are as many as the `num_threads` of the largest of these pipelines,
+   * so many pipelines in one process (e.g. on a serving host) don't oversubscribe the CPU.
+   * A free thread takes a job of the pipeline with the highest priority; the pipelines of
+   * the same priority take turns. Must be called before Build()
+   */
+  DLL_PUBLIC void EnableSharedThreadPool(bool enable = true, int priority = 0) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after \"Build()\" has been called are not allowed - "
+                 "cannot set the shared thread pool.");
+    shared_thread_pool_ = enable;
+    thread_pool_priority_ = priority;
+  }
+
+  /**
+   * @brief Makes the pipeline run the work of its CPU operators with a thread pool in which
+   * each thread has its own work queue and steals the jobs of the other threads once it runs out
+   * of its own (disabled by default)
+   *
+   * It reduces the contention on the work queue when the operators issue many short jobs.
+   * The priorities of the jobs are honored only approximately. It can't be combined with
+   * the shared thread pool. Must be called before Build()
+   */
+  DLL_PUBLIC void EnableWorkStealingThreadPool(bool enable = true) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after \"Build()\" has been called are not allowed - "
+                 "cannot set the work-stealing thread pool.");
+    work_stealing_thread_pool_ = enable;
+  }
+
+  /**
+   * @brief Sets the batch sizes the iterations should preferably have, for the pipelines whose
+   * inputs coalesce the requests of varying sizes (see the max_batch_delay argument of
+   * ExternalSource) - the batches are made of as many requests as give one of the buckets.
+   *
+   * With CUDA graphs, the GPU stage is captured for each of the buckets. The maximum batch
+   * size is always a bucket. Must be called before Build()
+   */
+  DLL_PUBLIC void SetBatchSizeBuckets(std::vector<int> buckets) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after \"Build()\" has been called are not "
+                 "allowed - cannot set the batch size buckets.");
+    batch_size_buckets_ = std::move(buckets);
+  }
+
+  /**
+   * @brief Makes the pipeline process `iterations` consecutive iterations as one, with
+   * a batch `iterations` times larger, and return its outputs split back into `iterations`
+   * batches of at most max_batch_size() samples (by default 1 - no coalescing)
+   *
+   * It amortizes the fixed cost of an iteration (the executor's bookkeeping, the setup of
+   * the operators and the launches of the kernels) for the pipelines with tiny batches.
+   * The operators, including the external sources, work with batches of up to
+   * coalesced_batch_size() samples - each batch fed to an external source provides the data of
+   * `iterations` returned batches. Every `iterations`-th RunCPU/RunGPU call runs the stage;
+   * the completion callback is called once per coalesced iteration. The returned batches share
+   * the memory of the coalesced one. Can't be used with checkpointing. Must be called before
+   * Build()
+   */
+  DLL_PUBLIC void SetIterationCoalescing(int iterations) {
+    DALI_ENFORCE(!built_,
+                 "Alterations to the pipeline after \"Build()\" has been called are not "
+                 "allowed - cannot set the iteration coalescing.");
+    DALI_ENFORCE(iterations > 0, make_string("The number of coalesced iterations must be "
+                                             "positive, got ", iterations, "."));
+    coalesce_iterations_ = iterations;
+  }
+
+  /**
+   * @brief Makes the GPU outputs of the pipeline use the memory obtained from `alloc`,
+   * e.g. the memory of the tensors of a framework, so the outputs don't need to be copied.
+   *
+   * The memory of an output is not reused by the pipeline once the outputs are released - the
+   * pipeline drops its reference and allocates new memory in the next iteration.
+   * Can be called after Build(), but before the pipeline is run
+   */
+  DLL_PUBLIC void SetOutputAllocator(OutputAllocFunc alloc) {
+    output_alloc_ = alloc;
+    if (built_)
+      executor_->SetOutputAllocator(std::move(alloc));
+  }
+
+  /**
+   * @brief Returns the device memory quota of the pipeline or nullptr, if there are no limits
+   */
+  DLL_PUBLIC const mm::device_quota_resource *GetDeviceMemoryQuota() const {
+    return device_quota_.get();
+  }
+
+  /**
+   * @brief Returns the prefetch queue depth currently used by the executor
+   */
+  DLL_PUBLIC QueueSizes GetActiveQueueSizes() const {
+    DALI_ENFORCE(built_, "\"Build()\" must be called prior to querying the queue sizes.");
+    return executor_->ActiveQueueSizes();
+  }
+
   ///@{
   /**
    * @brief Set descriptors of the outputs of the pipeline. Used to update the graph without
@@ -361,6 +690,10 @@ class DLL_PUBLIC Pipeline {
    * @brief Sets completion callback which is called when GPU work is done
    * It blocks next GPU iteration so it is up to the developer to schedule
    * long lasting work in some thread and just fire the work from this CB
+   *
+   * When the callback is called, the outputs of the iteration are ready to be shared,
+   * so TryShareOutputs succeeds. It's also called when the execution fails, so that
+   * TryShareOutputs reports the error.
    */
   DLL_PUBLIC void SetCompletionCallback(ExecutorBase::ExecutorCallback cb);
 
@@ -382,6 +715,14 @@ class DLL_PUBLIC Pipeline {
    */
   DLL_PUBLIC void ShareOutputs(DeviceWorkspace *ws);
 
+  /**
+   * @brief Like ShareOutputs, but doesn't block - returns false, if the next batch is not
+   * complete yet.
+   *
+   * The completion callback, see SetCompletionCallback, can be used to learn when to try again.
+   */
+  DLL_PUBLIC bool TryShareOutputs(DeviceWorkspace *ws);
+
   /**
    * @brief Release buffers returned by the Output call
    * This method is meant for cases where buffers are coppied out
@@ -410,6 +751,14 @@ class DLL_PUBLIC Pipeline {
   DLL_PUBLIC inline int max_batch_size() const { return max_batch_size_; }
   /// @}
 
+  /**
+   * @brief Returns the maximum batch size of the operators - the maximum batch size times
+   * the number of coalesced iterations, see SetIterationCoalescing
+   */
+  DLL_PUBLIC inline int coalesced_batch_size() const {
+    return max_batch_size_ * coalesce_iterations_;
+  }
+
   /**
    * @brief Returns the map of (node name, reader meta) for all nodes that return a valid meta
    */
@@ -420,6 +769,12 @@ class DLL_PUBLIC Pipeline {
    */
   DLL_PUBLIC ReaderMeta GetReaderMeta(std::string name);
 
+  /**
+   * @brief Returns the map of (node name, diagnostics) for all nodes that register
+   *        any diagnostics, see OperatorBase::GetDiagnostics
+   */
+  DLL_PUBLIC std::map<std::string, std::map<std::string, double>> GetOperatorDiagnostics();
+
   /**
    * @brief Get the data layout required by the external input with a given name.
    */
@@ -562,6 +917,22 @@ class DLL_PUBLIC Pipeline {
    */
   bool ValidateOutputs(const DeviceWorkspace &ws) const;
 
+  /**
+   * @brief Runs the stages for the coalesced iterations, whose batches turned out to be
+   * `missing_slots` fewer than assumed when scheduling them
+   */
+  void RunMissingCoalescedIterations(int missing_slots);
+
+  /**
+   * @brief Fills `ws` with the next `max_batch_size_` samples of the coalesced outputs
+   *
+   * @param blocking  if false and a new coalesced iteration would have to be waited for,
+   *                  returns false instead
+   */
+  bool ShareCoalescedOutputs(DeviceWorkspace *ws, bool blocking);
+
+  void ReleaseCoalescedOutputs();
+
   const int MAX_SEEDS = 1024;
 
   bool built_;
@@ -569,6 +940,7 @@ class DLL_PUBLIC Pipeline {
   bool pipelined_execution_;
   bool separated_execution_;
   bool async_execution_;
+  bool dynamic_execution_ = false;
   size_t bytes_per_sample_hint_;
   int set_affinity_;
   int max_num_stream_;
@@ -576,7 +948,43 @@ class DLL_PUBLIC Pipeline {
   int next_logical_id_ = 0;
   int next_internal_logical_id_ = -1;
   QueueSizes prefetch_queue_depth_;
+  bool adaptive_prefetch_ = false;
+  AdaptiveQueueDepthParams adaptive_prefetch_params_;
   bool enable_memory_stats_ = false;
+  bool enable_operator_timing_ = false;
+  bool op_fusion_ = true;
+  bool buffer_reuse_ = true;
+  ExecutorMetaMap memory_profile_;
+  size_t device_memory_soft_limit_ = 0;
+  size_t device_memory_hard_limit_ = 0;
+  std::shared_ptr<mm::device_quota_resource> device_quota_;
+  bool growable_buffers_ = false;
+  bool cuda_graphs_ = false;
+  bool checkpointing_ = false;
+  // the pipeline was run, so a checkpoint cannot be restored anymore
+  bool started_ = false;
+  bool low_latency_ = false;
+  bool sample_chaining_ = false;
+  bool shared_thread_pool_ = false;
+  int thread_pool_priority_ = 0;
+  bool work_stealing_thread_pool_ = false;
+  std::vector<int> batch_size_buckets_;
+  OutputAllocFunc output_alloc_;
+
+  int coalesce_iterations_ = 1;
+  /// The not yet run returned batches of the scheduled CPU and GPU stages
+  int coalesced_cpu_slots_ = 0, coalesced_gpu_slots_ = 0;
+  std::mutex coalesced_run_mutex_;
+
+  /// The outputs of a coalesced iteration, shared by the pipeline and returned in parts
+  struct CoalescedOutputs {
+    DeviceWorkspace ws;
+    int num_slots = 0;
+    int shared = 0;
+    int released = 0;
+  };
+  std::deque<CoalescedOutputs> coalesced_outputs_;
+  std::mutex coalesced_outputs_mutex_;
 
   std::vector<int64_t> seed_;
   int original_seed_;
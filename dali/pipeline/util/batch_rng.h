@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,9 +16,11 @@
 #define DALI_PIPELINE_UTIL_BATCH_RNG_H_
 
 #include <random>
+#include <string>
 #include <vector>
 
 #include "dali/core/span.h"
+#include "dali/pipeline/operator/checkpointing.h"
 
 namespace dali {
 
@@ -53,6 +55,26 @@ class BatchRNG {
     return rngs_[sample];
   }
 
+  /**
+   * @brief Returns the state of the engines, to be stored in a checkpoint
+   */
+  std::string SaveState() const {
+    std::string state;
+    for (auto &rng : rngs_)
+      AppendOpState(state, rng);
+    return state;
+  }
+
+  /**
+   * @brief Restores the state of the engines returned by SaveState
+   */
+  void RestoreState(const std::string &state) {
+    size_t offset = 0;
+    for (auto &rng : rngs_)
+      ReadOpState(rng, state, offset);
+    CheckOpStateEnd(state, offset);
+  }
+
 
  private:
   int64_t seed_;
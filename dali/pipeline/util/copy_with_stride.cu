@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,11 +16,16 @@
 #include <cuda_runtime.h>
 #include <dali/core/util.h>
 #include <dali/core/dev_array.h>
+#include "dali/kernels/common/cooperative_copy.cuh"
 
 namespace dali {
 
 constexpr int MAX_DIMS = 15;
 
+// The shortest contiguous run, in bytes, copied with vectorized accesses
+constexpr Index kMinVectorizedRun = 256;
+constexpr int kRunsBlockSize = 256;
+
 __global__ void CopyWithStrideKernel(uint8_t *output, const uint8_t *input, Index size,
                                      DeviceArray<Index, MAX_DIMS> out_strides,
                                      DeviceArray<Index, MAX_DIMS> in_strides,
@@ -38,6 +43,33 @@ __global__ void CopyWithStrideKernel(uint8_t *output, const uint8_t *input, Inde
   output[out_idx] = input[in_idx + elem_offset];
 }
 
+/**
+ * @brief Copies the runs of `run_size` bytes, which are contiguous in both the input and
+ * the output; `runs_per_block` groups of threads of each block copy one run each
+ *
+ * The strides are given only for the `ndim` outer dimensions, in which the runs are laid out.
+ */
+__global__ void CopyRunsWithStrideKernel(uint8_t *output, const uint8_t *input, Index num_runs,
+                                         Index run_size,
+                                         DeviceArray<Index, MAX_DIMS> out_strides,
+                                         DeviceArray<Index, MAX_DIMS> in_strides,
+                                         int ndim, int runs_per_block) {
+  int group_size = blockDim.x / runs_per_block;
+  Index run = static_cast<Index>(blockIdx.x) * runs_per_block + threadIdx.x / group_size;
+  if (run >= num_runs)
+    return;
+  Index out_offset = run * run_size;
+  Index in_offset = 0;
+  Index elem_offset = out_offset;
+  for (int dim = 0; dim < ndim; ++dim) {
+    auto n = elem_offset / out_strides[dim];
+    in_offset += n * in_strides[dim];
+    elem_offset -= n * out_strides[dim];
+  }
+  kernels::CooperativeCopy(output + out_offset, input + in_offset, run_size,
+                           threadIdx.x % group_size, group_size);
+}
+
 template <>
 void CopyWithStride<GPUBackend>(void *output, const void *input,
                                 const Index *in_strides,
@@ -59,6 +91,26 @@ void CopyWithStride<GPUBackend>(void *output, const void *input,
   DeviceArray<Index, MAX_DIMS> in_strides_arr{};
   std::copy(in_strides, in_strides + ndim, in_strides_arr.data());
   Index size = volume(shape, shape + ndim) * item_size;
+
+  // The innermost dimensions with the same strides form runs, contiguous in both buffers
+  int outer_dims = ndim;
+  while (outer_dims > 0 && in_strides[outer_dims - 1] == out_strides[outer_dims - 1])
+    outer_dims--;
+  if (outer_dims == 0) {
+    CUDA_CALL(cudaMemcpyAsync(output, input, size, cudaMemcpyDeviceToDevice, stream));
+    return;
+  }
+  Index run_size = out_strides[outer_dims - 1];
+  if (run_size >= kMinVectorizedRun && size > 0) {
+    // a long run is copied by the whole block, the shorter ones by a warp each
+    int runs_per_block = run_size >= kRunsBlockSize * 16 ? 1 : kRunsBlockSize / 32;
+    Index num_runs = size / run_size;
+    auto blocks_num = (num_runs + runs_per_block - 1) / runs_per_block;
+    CopyRunsWithStrideKernel<<<blocks_num, kRunsBlockSize, 0, stream>>>
+        (static_cast<uint8_t*>(output), static_cast<const uint8_t*>(input), num_runs, run_size,
+         out_strides, in_strides_arr, outer_dims, runs_per_block);
+    return;
+  }
   auto blocks_num = (size + 1023) / 1024;
   auto block_size = (size < 1024) ? size : 1024;
   CopyWithStrideKernel<<<blocks_num, block_size, 0, stream>>>
@@ -0,0 +1,182 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_UTIL_SPSC_QUEUE_H_
+#define DALI_PIPELINE_UTIL_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+/**
+ * @brief A bounded, lock-free queue for exactly one producer and one consumer thread
+ *
+ * The producer calls only try_push, the consumer calls only try_pop. Reset is not thread-safe.
+ */
+template <typename T>
+class SpscQueue {
+ public:
+  explicit SpscQueue(int capacity = 0) {
+    Reset(capacity);
+  }
+
+  /**
+   * @brief Discards the contents and changes the capacity of the queue
+   */
+  void Reset(int capacity) {
+    slots_.clear();
+    slots_.resize(capacity + 1);
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+  }
+
+  int capacity() const {
+    return static_cast<int>(slots_.size()) - 1;
+  }
+
+  /**
+   * @brief Appends the value to the queue; returns false if the queue is full
+   */
+  bool try_push(const T &value) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t next = Next(tail);
+    if (next == head_.load(std::memory_order_acquire))
+      return false;
+    slots_[tail] = value;
+    tail_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Takes the oldest value from the queue; returns false if the queue is empty
+   */
+  bool try_pop(T &value) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+      return false;
+    value = slots_[head];
+    head_.store(Next(head), std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+ private:
+  size_t Next(size_t pos) const {
+    return pos + 1 == slots_.size() ? 0 : pos + 1;
+  }
+
+  std::vector<T> slots_;
+  // the consumer and the producer positions are kept on separate cache lines
+  std::atomic<size_t> head_{0};
+  char padding_[64];
+  std::atomic<size_t> tail_{0};
+};
+
+/**
+ * @brief SpscQueue with a blocking Pop
+ *
+ * The consumer first polls the queue `spin_count` times and only then parks on a condition
+ * variable. The producer touches the mutex only when the consumer is actually parked, so with
+ * enough spinning the hand-off doesn't involve any system calls.
+ */
+template <typename T>
+class SpscHandoff {
+ public:
+  /**
+   * @brief Discards the contents and sets the capacity and the wait strategy;
+   * not thread-safe
+   *
+   * @param spin_count number of polls before the consumer parks; 0 parks immediately
+   */
+  void Reset(int capacity, int spin_count = 0) {
+    queue_.Reset(capacity);
+    spin_count_ = spin_count;
+    stop_ = false;
+    waiting_ = false;
+  }
+
+  /**
+   * @brief Passes the value to the consumer
+   */
+  void Push(const T &value) {
+    DALI_ENFORCE(queue_.try_push(value), "Stage hand-off queue overflow.");
+    // Orders the push before reading `waiting_`; paired with the fence in Pop - either
+    // the consumer sees the value, or we see that it is parked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cv_.notify_one();
+    }
+  }
+
+  /**
+   * @brief Waits for a value; returns false if the hand-off was stopped
+   */
+  bool Pop(T &value) {
+    for (int i = 0; i < spin_count_; i++) {
+      if (stop_.load(std::memory_order_acquire))
+        return false;
+      if (queue_.try_pop(value))
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    cv_.wait(lock, [&]() { return stop_ || !queue_.empty(); });
+    waiting_.store(false, std::memory_order_relaxed);
+    if (stop_)
+      return false;
+    return queue_.try_pop(value);
+  }
+
+  /**
+   * @brief Wakes the consumer; all the subsequent Pop calls return false
+   */
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  void NotifyAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_all();
+  }
+
+  bool IsStopped() const {
+    return stop_;
+  }
+
+ private:
+  SpscQueue<T> queue_;
+  int spin_count_ = 0;
+  std::atomic<bool> stop_{false};
+  std::atomic<bool> waiting_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_UTIL_SPSC_QUEUE_H_
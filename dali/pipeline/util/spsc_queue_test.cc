@@ -0,0 +1,97 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+#include "dali/pipeline/util/spsc_queue.h"
+
+namespace dali {
+
+namespace test {
+
+TEST(SpscQueue, PushPop) {
+  SpscQueue<int> q(3);
+  EXPECT_EQ(q.capacity(), 3);
+  EXPECT_TRUE(q.empty());
+  int value = -1;
+  EXPECT_FALSE(q.try_pop(value));
+  // wrap around a few times
+  for (int iter = 0; iter < 5; iter++) {
+    EXPECT_TRUE(q.try_push(iter * 10 + 1));
+    EXPECT_TRUE(q.try_push(iter * 10 + 2));
+    EXPECT_TRUE(q.try_push(iter * 10 + 3));
+    EXPECT_FALSE(q.try_push(0));
+    for (int i = 1; i <= 3; i++) {
+      ASSERT_TRUE(q.try_pop(value));
+      EXPECT_EQ(value, iter * 10 + i);
+    }
+    EXPECT_TRUE(q.empty());
+  }
+}
+
+void TestHandoff(int spin_count) {
+  const int kCapacity = 4;
+  const int kCount = 100000;
+  SpscHandoff<int> to_consumer, to_producer;
+  to_consumer.Reset(kCapacity, spin_count);
+  to_producer.Reset(kCapacity, spin_count);
+  // the producer can only send a value after getting a free slot back, like the executor stages
+  for (int i = 0; i < kCapacity; i++)
+    to_producer.Push(i);
+
+  std::thread producer([&]() {
+    int slot;
+    for (int i = 0; i < kCount; i++) {
+      ASSERT_TRUE(to_producer.Pop(slot));
+      to_consumer.Push(i);
+    }
+  });
+
+  for (int i = 0; i < kCount; i++) {
+    int value = -1;
+    ASSERT_TRUE(to_consumer.Pop(value));
+    EXPECT_EQ(value, i);
+    to_producer.Push(0);
+  }
+  producer.join();
+}
+
+TEST(SpscHandoff, Park) {
+  TestHandoff(0);
+}
+
+TEST(SpscHandoff, SpinThenPark) {
+  TestHandoff(1000);
+}
+
+TEST(SpscHandoff, StopWakesConsumer) {
+  for (int spin_count : {0, 1000}) {
+    SpscHandoff<int> handoff;
+    handoff.Reset(2, spin_count);
+    std::thread consumer([&]() {
+      int value;
+      EXPECT_FALSE(handoff.Pop(value));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    handoff.Stop();
+    consumer.join();
+    EXPECT_TRUE(handoff.IsStopped());
+  }
+}
+
+}  // namespace test
+
+}  // namespace dali
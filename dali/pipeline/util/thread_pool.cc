@@ -12,12 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
 #include <utility>
 #include "dali/pipeline/util/thread_pool.h"
+#include "dali/pipeline/util/work_stealing_thread_pool.h"
 #if NVML_ENABLED
 #include "dali/util/nvml.h"
 #endif
+#include "dali/core/allocation_counter.h"
 #include "dali/core/format.h"
 #include "dali/core/cuda_utils.h"
 #include "dali/core/device_guard.h"
@@ -25,9 +31,213 @@
 
 namespace dali {
 
+class ThreadPool::Workers {
+ public:
+  Workers(int device_id, bool shared) : device_id_(device_id), shared_(shared) {}
+
+  ~Workers() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_ = false;
+    }
+    condition_.notify_all();
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+  }
+
+  /**
+   * @brief Returns the threads shared by the pools of the device, starting them if necessary
+   */
+  static std::shared_ptr<Workers> GetShared(int device_id) {
+    static std::mutex registry_mutex;
+    static std::map<int, std::weak_ptr<Workers>> registry;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto &entry = registry[device_id];
+    auto workers = entry.lock();
+    if (!workers) {
+      workers = std::make_shared<Workers>(device_id, true);
+      entry = workers;
+    }
+    return workers;
+  }
+
+  /**
+   * @brief Adds the pool to the served ones and starts as many threads as it needs
+   */
+  void Attach(ThreadPool *pool, bool set_affinity, const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pools_.push_back(pool);
+    for (int i = threads_.size(); i < pool->num_thread_; i++) {
+      threads_.emplace_back(&Workers::ThreadMain, this, i, set_affinity,
+                            make_string("[DALI][TP", i, "]", shared_ ? "shared" : name));
+    }
+  }
+
+  void Detach(ThreadPool *pool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pools_.erase(std::find(pools_.begin(), pools_.end(), pool));
+  }
+
+  std::vector<std::thread::id> GetThreadIds() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::thread::id> tids;
+    tids.reserve(threads_.size());
+    for (const auto &thread : threads_)
+      tids.emplace_back(thread.get_id());
+    return tids;
+  }
+
+  std::mutex &mutex() {
+    return mutex_;
+  }
+
+  void NotifyOne() {
+    condition_.notify_one();
+  }
+
+  void NotifyAll() {
+    condition_.notify_all();
+  }
+
+  bool shared() const {
+    return shared_;
+  }
+
+ private:
+  /**
+   * @brief Selects the pool to take the next job from; requires mutex_ to be held
+   *
+   * The pool with the highest priority is selected, the one served least recently among
+   * the pools of the same priority.
+   */
+  ThreadPool *PickPool() {
+    ThreadPool *best = nullptr;
+    for (auto *pool : pools_) {
+      if (!pool->IsRunnable())
+        continue;
+      if (!best || pool->priority_ > best->priority_ ||
+          (pool->priority_ == best->priority_ && pool->last_served_ < best->last_served_))
+        best = pool;
+    }
+    if (best)
+      best->last_served_ = ++serve_count_;
+    return best;
+  }
+
+  void ThreadMain(int thread_idx, bool set_affinity, const std::string &name) {
+    SetThreadName(name.c_str());
+    DeviceGuard g(device_id_);
+    try {
+      if (set_affinity)
+        detail::SetPoolThreadAffinity(thread_idx);
+    } catch (std::exception &e) {
+      ReportStartupError(thread_idx, e.what());
+    } catch (...) {
+      ReportStartupError(thread_idx, "Caught unknown exception");
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+      // Block on the condition to wait for work
+      ThreadPool *pool = nullptr;
+      condition_.wait(lock, [&] { return !running_ || (pool = PickPool()) != nullptr; });
+      // If we're no longer running, exit the run loop
+      if (!running_) break;
+
+      // Get work from the queue & mark this thread as active in the pool; the shared threads
+      // take one of the thread_ids of the pool not used by its running jobs
+      Work work = pool->PopWork();
+      int thread_id = thread_idx;
+      if (shared_) {
+        thread_id = pool->free_thread_ids_.back();
+        pool->free_thread_ids_.pop_back();
+      }
+      ++pool->active_threads_;
+
+      lock.unlock();
+
+      // If an error occurs, we save it in tl_errors_. When
+      // WaitForWork is called, we will check for any errors
+      // in the threads and return an error if one occured.
+#if ALLOCATION_COUNTING_ENABLED
+      AllocationCounter allocations;
+#endif
+      try {
+        DomainTimeRange tr("[DALI][ThreadPool] Job", DomainTimeRange::kGreen);
+        work(thread_id);
+      } catch (std::exception &e) {
+        lock.lock();
+        pool->tl_errors_[thread_id].push(e.what());
+        lock.unlock();
+      } catch (...) {
+        lock.lock();
+        pool->tl_errors_[thread_id].push("Caught unknown exception");
+        lock.unlock();
+      }
+
+      // the captures of the job are released before the work is reported as complete
+      work = {};
+#if ALLOCATION_COUNTING_ENABLED
+      pool->num_allocations_ += allocations.count();
+#endif
+
+      // Mark this thread as idle & check for complete work; the pool can be destroyed as soon
+      // as its work is complete and the lock is released, so it's notified under the lock
+      lock.lock();
+      --pool->active_threads_;
+      if (shared_) {
+        pool->free_thread_ids_.push_back(thread_id);
+        // the pool might have been waiting for a free thread_id - let another thread take it
+        if (pool->IsRunnable())
+          condition_.notify_one();
+      }
+      if (pool->work_queue_.empty() && pool->active_threads_ == 0) {
+        pool->work_complete_ = true;
+        pool->completed_.notify_one();
+      }
+    }
+  }
+
+  void ReportStartupError(int thread_idx, const std::string &message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!shared_ && !pools_.empty()) {
+      pools_[0]->tl_errors_[thread_idx].push(message);
+    } else {
+      DALI_WARN("Failed to set up the shared pool thread ", thread_idx, ": ", message);
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<std::thread> threads_;
+  std::vector<ThreadPool *> pools_;
+  uint64_t serve_count_ = 0;
+  bool running_ = true;
+  int device_id_;
+  bool shared_;
+};
+
 ThreadPool::ThreadPool(int num_thread, int device_id, bool set_affinity, const std::string &name)
-    : threads_(num_thread), running_(true), work_complete_(true), started_(false)
-    , active_threads_(0) {
+    : ThreadPool(num_thread, device_id, set_affinity, name,
+                 std::make_shared<Workers>(device_id, false), 0) {}
+
+ThreadPool::ThreadPool(int num_thread, int device_id, bool set_affinity, const std::string &name,
+                       Shared shared)
+    : ThreadPool(num_thread, device_id, set_affinity, name, Workers::GetShared(device_id),
+                 shared.priority) {}
+
+ThreadPool::ThreadPool(int num_thread, int device_id, bool set_affinity, const std::string &name,
+                       WorkStealing)
+    : work_stealing_(std::make_unique<WorkStealingThreadPool>(num_thread, device_id, set_affinity,
+                                                              name))
+    , num_thread_(num_thread), priority_(0)
+    , work_complete_(true), started_(false), active_threads_(0), device_id_(device_id) {}
+
+ThreadPool::ThreadPool(int num_thread, int device_id, bool set_affinity, const std::string &name,
+                       std::shared_ptr<Workers> workers, int priority)
+    : workers_(std::move(workers)), num_thread_(num_thread), priority_(priority)
+    , work_complete_(true), started_(false), active_threads_(0), device_id_(device_id) {
   DALI_ENFORCE(num_thread > 0, "Thread pool must have non-zero size");
 #if NVML_ENABLED
   // only for the CPU pipeline
@@ -35,55 +245,67 @@ ThreadPool::ThreadPool(int num_thread, int device_id, bool set_affinity, const s
     nvml::Init();
   }
 #endif
-  // Start the threads in the main loop
-  for (int i = 0; i < num_thread; ++i) {
-    threads_[i] = std::thread(std::bind(&ThreadPool::ThreadMain, this, i, device_id, set_affinity,
-                                        make_string("[DALI][TP", i, "]", name)));
-  }
   tl_errors_.resize(num_thread);
+  if (workers_->shared()) {
+    // the lowest thread_ids are taken first
+    for (int i = num_thread - 1; i >= 0; i--)
+      free_thread_ids_.push_back(i);
+  }
+  // Start the threads in the main loop
+  workers_->Attach(this, set_affinity, name);
 }
 
 ThreadPool::~ThreadPool() {
-  WaitForWork(false);
-
-  std::unique_lock<std::mutex> lock(mutex_);
-  running_ = false;
-  condition_.notify_all();
-  lock.unlock();
-
-  for (auto &thread : threads_) {
-    thread.join();
+  if (work_stealing_) {
+    // waits for the work and joins the threads
+    work_stealing_.reset();
+    return;
   }
+  WaitForWork(false);
+  workers_->Detach(this);
+  // joins the threads, unless they're shared with other pools
+  workers_.reset();
 #if NVML_ENABLED
   nvml::Shutdown();
 #endif
 }
 
 void ThreadPool::AddWork(Work work, int64_t priority, bool start_immediately) {
+  if (work_stealing_) {
+    work_stealing_->AddWork(std::move(work), priority, start_immediately);
+    return;
+  }
   bool started_before = false;
+  bool started = false;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    work_queue_.push({priority, std::move(work)});
+    std::lock_guard<std::mutex> lock(workers_->mutex());
+    work_queue_.emplace_back(priority, std::move(work));
+    std::push_heap(work_queue_.begin(), work_queue_.end(), SortByPriority());
     work_complete_ = false;
     started_before = started_;
     started_ |= start_immediately;
+    started = started_;
   }
-  if (started_) {
+  if (started) {
     if (!started_before)
-      condition_.notify_all();
+      workers_->NotifyAll();
     else
-      condition_.notify_one();
+      workers_->NotifyOne();
   }
 }
 
 // Blocks until all work issued to the thread pool is complete
 void ThreadPool::WaitForWork(bool checkForErrors) {
-  std::unique_lock<std::mutex> lock(mutex_);
+  if (work_stealing_) {
+    work_stealing_->WaitForWork(checkForErrors);
+    return;
+  }
+  std::unique_lock<std::mutex> lock(workers_->mutex());
   completed_.wait(lock, [this] { return this->work_complete_; });
   started_ = false;
   if (checkForErrors) {
     // Check for errors
-    for (size_t i = 0; i < threads_.size(); ++i) {
+    for (size_t i = 0; i < tl_errors_.size(); ++i) {
       if (!tl_errors_[i].empty()) {
         // Throw the first error that occurred
         string error = make_string("Error in thread ", i, ": ", tl_errors_[i].front());
@@ -95,97 +317,87 @@ void ThreadPool::WaitForWork(bool checkForErrors) {
 }
 
 void ThreadPool::RunAll(bool wait) {
+  if (work_stealing_) {
+    work_stealing_->RunAll(wait);
+    return;
+  }
+  if (wait && inline_single_work_) {
+    std::unique_lock<std::mutex> lock(workers_->mutex());
+    if (!started_ && active_threads_ == 0 && work_queue_.size() == 1) {
+      Work work = PopWork();
+      work_complete_ = true;
+      lock.unlock();
+      DeviceGuard g(device_id_);
+      try {
+        work(0);
+      } catch (std::exception &e) {
+        // the same error as the one reported by WaitForWork
+        throw std::runtime_error(make_string("Error in thread 0: ", e.what()));
+      } catch (...) {
+        throw std::runtime_error("Error in thread 0: Caught unknown exception");
+      }
+      return;
+    }
+  }
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(workers_->mutex());
     started_ = true;
   }
-  condition_.notify_all();  // other threads will be waken up if needed
+  workers_->NotifyAll();  // other threads will be waken up if needed
   if (wait) {
     WaitForWork();
   }
 }
 
+ThreadPool::Work ThreadPool::PopWork() {
+  std::pop_heap(work_queue_.begin(), work_queue_.end(), SortByPriority());
+  Work work = std::move(work_queue_.back().second);
+  work_queue_.pop_back();
+  return work;
+}
+
 int ThreadPool::NumThreads() const {
-  return threads_.size();
+  return num_thread_;
 }
 
-std::vector<std::thread::id> ThreadPool::GetThreadIds() const {
-  std::vector<std::thread::id> tids;
-  tids.reserve(threads_.size());
-  for (const auto &thread : threads_)
-    tids.emplace_back(thread.get_id());
-  return tids;
+void ThreadPool::SetInlineSingleWork(bool enable) {
+  inline_single_work_ = enable;
+  if (work_stealing_)
+    work_stealing_->SetInlineSingleWork(enable);
 }
 
+int64_t ThreadPool::NumAllocations() const {
+  return work_stealing_ ? work_stealing_->NumAllocations() : num_allocations_.load();
+}
 
-void ThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity,
-                            const std::string &name) {
-  SetThreadName(name.c_str());
-  DeviceGuard g(device_id);
-  try {
-#if NVML_ENABLED
-    if (set_affinity) {
-      const char *env_affinity = std::getenv("DALI_AFFINITY_MASK");
-      int core = -1;
-      if (env_affinity) {
-        const auto &vec = string_split(env_affinity, ',');
-        if ((size_t)thread_id < vec.size()) {
-          core = std::stoi(vec[thread_id]);
-        } else {
-          DALI_WARN("DALI_AFFINITY_MASK environment variable is set, "
-                    "but does not have enough entries: thread_id (", thread_id,
-                    ") vs #entries (", vec.size(), "). Ignoring...");
-        }
-      }
-      nvml::SetCPUAffinity(core);
-    }
-#endif
-  } catch (std::exception &e) {
-    tl_errors_[thread_id].push(e.what());
-  } catch (...) {
-    tl_errors_[thread_id].push("Caught unknown exception");
-  }
+std::vector<std::thread::id> ThreadPool::GetThreadIds() const {
+  return work_stealing_ ? work_stealing_->GetThreadIds() : workers_->GetThreadIds();
+}
 
-  while (running_) {
-    // Block on the condition to wait for work
-    std::unique_lock<std::mutex> lock(mutex_);
-    condition_.wait(lock, [this] { return !running_ || (!work_queue_.empty() && started_); });
-    // If we're no longer running, exit the run loop
-    if (!running_) break;
-
-    // Get work from the queue & mark
-    // this thread as active
-    Work work = std::move(work_queue_.top().second);
-    work_queue_.pop();
-    ++active_threads_;
-
-    // Unlock the lock
-    lock.unlock();
-
-    // If an error occurs, we save it in tl_errors_. When
-    // WaitForWork is called, we will check for any errors
-    // in the threads and return an error if one occured.
-    try {
-      work(thread_id);
-    } catch (std::exception &e) {
-      lock.lock();
-      tl_errors_[thread_id].push(e.what());
-      lock.unlock();
-    } catch (...) {
-      lock.lock();
-      tl_errors_[thread_id].push("Caught unknown exception");
-      lock.unlock();
-    }
+bool ThreadPool::IsShared() const {
+  return workers_ && workers_->shared();
+}
 
-    // Mark this thread as idle & check for complete work
-    lock.lock();
-    --active_threads_;
-    if (work_queue_.empty() && active_threads_ == 0) {
-      work_complete_ = true;
-      lock.unlock();
-      completed_.notify_one();
+namespace detail {
+
+void SetPoolThreadAffinity(int thread_id) {
+#if NVML_ENABLED
+  const char *env_affinity = std::getenv("DALI_AFFINITY_MASK");
+  int core = -1;
+  if (env_affinity) {
+    const auto &vec = string_split(env_affinity, ',');
+    if ((size_t)thread_id < vec.size()) {
+      core = std::stoi(vec[thread_id]);
+    } else {
+      DALI_WARN("DALI_AFFINITY_MASK environment variable is set, "
+                "but does not have enough entries: thread_id (", thread_id,
+                ") vs #entries (", vec.size(), "). Ignoring...");
     }
   }
+  nvml::SetCPUAffinity(core);
+#endif
 }
 
+}  // namespace detail
+
 }  // namespace dali
@@ -17,26 +17,73 @@
 
 #include <cstdlib>
 #include <utility>
+#include <atomic>
 #include <condition_variable>
-#include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
 #include <vector>
 #include <string>
 #include "dali/core/common.h"
+#include "dali/core/inline_function.h"
 
 
 namespace dali {
 
+class WorkStealingThreadPool;
+
 class DLL_PUBLIC ThreadPool {
  public:
-  // Basic unit of work that our threads do
-  typedef std::function<void(int)> Work;
+  // Basic unit of work that our threads do; the typical job - a lambda capturing a few
+  // references and indices - is stored without a heap allocation
+  typedef InlineFunction<void(int)> Work;
+
+  /**
+   * @brief Selects the worker threads shared by the process, see the constructor
+   */
+  struct Shared {
+    /** The pools with a higher priority get the free threads first */
+    int priority = 0;
+  };
+
+  /**
+   * @brief Selects the work-stealing implementation of the pool, see the constructor
+   */
+  struct WorkStealing {};
 
   DLL_PUBLIC ThreadPool(int num_thread, int device_id, bool set_affinity,
                         const std::string &name);
 
+  /**
+   * @brief Creates a pool which runs its work on the worker threads shared by all the pools
+   *        of the device created this way, instead of starting threads of its own
+   *
+   * It lets many pipelines in one process (e.g. on a serving host) together use as many threads
+   * as the largest of them, instead of oversubscribing the CPU. Otherwise the pool behaves like
+   * one with its own threads: at most `num_thread` of its jobs run at a time, with the thread_id
+   * in the range [0, num_thread), and WaitForWork waits for (and reports the errors of) its own
+   * work only. A free shared thread takes a job of the started pool with the highest priority;
+   * the pools of the same priority take turns, one job at a time.
+   *
+   * @remarks The thread_id doesn't identify the OS thread which runs the job and GetThreadIds
+   *          returns all the shared threads.
+   */
+  DLL_PUBLIC ThreadPool(int num_thread, int device_id, bool set_affinity,
+                        const std::string &name, Shared shared);
+
+  /**
+   * @brief Creates a pool which runs its work with a WorkStealingThreadPool - each thread has
+   *        its own queue and takes the jobs from the other threads' queues once it runs out of
+   *        its own
+   *
+   * The users of the pool don't change: the interface and the semantics are the same, except
+   * that the priorities are honored only approximately (see WorkStealingThreadPool).
+   * With many short jobs, it avoids the contention on the single queue of the pool.
+   */
+  DLL_PUBLIC ThreadPool(int num_thread, int device_id, bool set_affinity,
+                        const std::string &name, WorkStealing);
+
   DLL_PUBLIC ~ThreadPool();
 
   /**
@@ -61,17 +108,64 @@ class DLL_PUBLIC ThreadPool {
    */
   DLL_PUBLIC void WaitForWork(bool checkForErrors = true);
 
+  /**
+   * @brief Makes RunAll(true) run the work in the calling thread, when only one job is queued
+   *
+   * It saves the round trip to a pool thread (waking it up and waiting for it) which, for
+   * a batch of one sample, can take longer than the work itself. The job is called with
+   * thread_id 0, while the pool threads are idle.
+   */
+  DLL_PUBLIC void SetInlineSingleWork(bool enable);
+
+  /**
+   * @brief The number of the heap allocations made by the jobs so far
+   *
+   * Only counted when DALI is built with BUILD_ALLOCATION_COUNTING; otherwise it's 0.
+   */
+  DLL_PUBLIC int64_t NumAllocations() const;
+
   DLL_PUBLIC int NumThreads() const;
 
   DLL_PUBLIC std::vector<std::thread::id> GetThreadIds() const;
 
+  /**
+   * @brief Whether the pool runs its work on the threads shared by the process
+   */
+  DLL_PUBLIC bool IsShared() const;
+
+  /**
+   * @brief Whether the pool runs its work with the work-stealing implementation
+   */
+  DLL_PUBLIC bool IsWorkStealing() const {
+    return work_stealing_ != nullptr;
+  }
+
   DISABLE_COPY_MOVE_ASSIGN(ThreadPool);
 
  private:
-  DLL_PUBLIC void ThreadMain(int thread_id, int device_id, bool set_affinity,
-                             const std::string &name);
+  // the worker threads, owned by the pool or shared by the pools of a device
+  class Workers;
+  friend class Workers;
 
-  vector<std::thread> threads_;
+  ThreadPool(int num_thread, int device_id, bool set_affinity, const std::string &name,
+             std::shared_ptr<Workers> workers, int priority);
+
+  /**
+   * @brief Whether a free thread can take a job of this pool; requires the workers' mutex
+   */
+  bool IsRunnable() const {
+    return started_ && !work_queue_.empty() && active_threads_ < num_thread_;
+  }
+
+  std::shared_ptr<Workers> workers_;
+  // the work-stealing implementation, used instead of workers_ if set
+  std::unique_ptr<WorkStealingThreadPool> work_stealing_;
+  int num_thread_;
+  int priority_;
+  // the order in which the pools of one priority were last served
+  uint64_t last_served_ = 0;
+  // the thread_ids not taken by the running jobs, only used with the shared threads
+  std::vector<int> free_thread_ids_;
 
   using PrioritizedWork = std::pair<int64_t, Work>;
   struct SortByPriority {
@@ -79,20 +173,42 @@ class DLL_PUBLIC ThreadPool {
       return a.first < b.first;
     }
   };
-  std::priority_queue<PrioritizedWork, std::vector<PrioritizedWork>, SortByPriority> work_queue_;
 
-  bool running_;
+  /**
+   * @brief Takes the highest priority job out of the queue; requires the workers' mutex
+   *
+   * std::priority_queue gives only a const access to the top element, which can't be moved from.
+   */
+  Work PopWork();
+
+  // a heap ordered with SortByPriority; the storage is kept between the batches of work;
+  // the queue and the state of the work are guarded by the workers' mutex
+  std::vector<PrioritizedWork> work_queue_;
+
   bool work_complete_;
   bool started_;
   int active_threads_;
-  std::mutex mutex_;
-  std::condition_variable condition_;
+  int device_id_;
+  std::atomic<bool> inline_single_work_{false};
+  std::atomic<int64_t> num_allocations_{0};
   std::condition_variable completed_;
 
   //  Stored error strings for each thread
   vector<std::queue<string>> tl_errors_;
 };
 
+namespace detail {
+
+/**
+ * @brief Pins the calling pool thread to a CPU core
+ *
+ * The core is taken from the DALI_AFFINITY_MASK environment variable (indexed with `thread_id`)
+ * or, if the variable is not set, chosen by NVML to be close to the current device.
+ */
+DLL_PUBLIC void SetPoolThreadAffinity(int thread_id);
+
+}  // namespace detail
+
 }  // namespace dali
 
 #endif  // DALI_PIPELINE_UTIL_THREAD_POOL_H_
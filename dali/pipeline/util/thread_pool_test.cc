@@ -14,7 +14,13 @@
 
 #include "dali/pipeline/util/thread_pool.h"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 namespace dali {
 
@@ -68,6 +74,47 @@ TEST(ThreadPool, AddWorkWithPriority) {
   ASSERT_EQ(((1+1) << 3) + 1, count);
 }
 
+TEST(ThreadPool, MoveOnlyWork) {
+  ThreadPool tp(2, 0, false, "ThreadPool test");
+  std::atomic<int> sum{0};
+  for (int i = 0; i < 16; i++) {
+    auto value = std::make_unique<int>(i);
+    tp.AddWork([&sum, value = std::move(value)](int) { sum += *value; }, i);
+  }
+  tp.RunAll();
+  EXPECT_EQ(sum, 15 * 16 / 2);
+}
+
+TEST(ThreadPool, InlineSingleWork) {
+  ThreadPool tp(4, 0, false, "ThreadPool test");
+  tp.SetInlineSingleWork(true);
+  auto caller = std::this_thread::get_id();
+  std::thread::id runner;
+  tp.AddWork([&](int thread_id) {
+    EXPECT_EQ(thread_id, 0);
+    runner = std::this_thread::get_id();
+  });
+  tp.RunAll();
+  EXPECT_EQ(runner, caller);
+
+  // more jobs are still run by the pool threads
+  std::atomic<int> inline_count{0};
+  for (int i = 0; i < 8; i++) {
+    tp.AddWork([&](int) {
+      if (std::this_thread::get_id() == caller)
+        inline_count++;
+    });
+  }
+  tp.RunAll();
+  EXPECT_EQ(inline_count, 0);
+
+  tp.AddWork([](int) { throw std::runtime_error("inline error"); });
+  EXPECT_THROW(tp.RunAll(), std::runtime_error);
+  // the pool is usable after the error
+  tp.AddWork([&](int) { runner = std::this_thread::get_id(); });
+  tp.RunAll();
+  EXPECT_EQ(runner, caller);
+}
 
 TEST(ThreadPool, CheckName) {
   const char given_thread_pool_name[] = "ThreadPool test";
@@ -87,6 +134,105 @@ TEST(ThreadPool, CheckName) {
                       std::min(sizeof(full_thread_pool_name), sizeof(read_thread_pool_name)) - 1));
 }
 
+TEST(ThreadPool, SharedThreads) {
+  ThreadPool tp1(4, 0, false, "ThreadPool test", ThreadPool::Shared{});
+  ThreadPool tp2(2, 0, false, "ThreadPool test", ThreadPool::Shared{});
+  EXPECT_TRUE(tp1.IsShared());
+  EXPECT_EQ(tp1.NumThreads(), 4);
+  EXPECT_EQ(tp2.NumThreads(), 2);
+  // the threads are shared by the pools - as many as the largest needs
+  EXPECT_EQ(tp1.GetThreadIds(), tp2.GetThreadIds());
+  EXPECT_EQ(tp1.GetThreadIds().size(), 4u);
+
+  std::mutex mtx;
+  std::vector<int> running(2, 0), max_running(2, 0);
+  std::atomic<int> bad_thread_ids{0};
+  auto add_work = [&](ThreadPool &tp, int pool_idx) {
+    for (int i = 0; i < 32; i++) {
+      tp.AddWork([&, pool_idx](int thread_id) {
+        if (thread_id < 0 || thread_id >= (pool_idx == 0 ? 4 : 2))
+          bad_thread_ids++;
+        {
+          std::lock_guard<std::mutex> g(mtx);
+          running[pool_idx]++;
+          max_running[pool_idx] = std::max(max_running[pool_idx], running[pool_idx]);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        std::lock_guard<std::mutex> g(mtx);
+        running[pool_idx]--;
+      });
+    }
+  };
+  add_work(tp1, 0);
+  add_work(tp2, 1);
+  std::thread other([&]() { tp2.RunAll(); });
+  tp1.RunAll();
+  other.join();
+  EXPECT_EQ(bad_thread_ids, 0);
+  EXPECT_LE(max_running[0], 4);
+  EXPECT_LE(max_running[1], 2);
+
+  // the errors are reported by the pool which ran the failing job only
+  tp2.AddWork([](int) { throw std::runtime_error("shared error"); });
+  EXPECT_THROW(tp2.RunAll(), std::runtime_error);
+  tp1.AddWork([](int) {});
+  EXPECT_NO_THROW(tp1.RunAll());
+}
+
+TEST(ThreadPool, SharedThreadsPriority) {
+  ThreadPool low(1, 0, false, "ThreadPool test", ThreadPool::Shared{0});
+  ThreadPool high(1, 0, false, "ThreadPool test", ThreadPool::Shared{1});
+  std::mutex mtx;
+  std::vector<int> order;
+  // occupy the only shared thread until both pools have their work started
+  std::atomic<bool> release{false};
+  low.AddWork([&](int) {
+    while (!release) std::this_thread::yield();
+  }, 0, true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  for (int i = 0; i < 4; i++) {
+    low.AddWork([&](int) { std::lock_guard<std::mutex> g(mtx); order.push_back(0); }, 0, true);
+    high.AddWork([&](int) { std::lock_guard<std::mutex> g(mtx); order.push_back(1); }, 0, true);
+  }
+  release = true;
+  high.WaitForWork();
+  low.WaitForWork();
+  std::vector<int> expected = {1, 1, 1, 1, 0, 0, 0, 0};
+  EXPECT_EQ(order, expected);
+}
+
+TEST(ThreadPool, WorkStealing) {
+  ThreadPool tp(4, 0, false, "ThreadPool test", ThreadPool::WorkStealing{});
+  EXPECT_TRUE(tp.IsWorkStealing());
+  EXPECT_FALSE(tp.IsShared());
+  EXPECT_EQ(tp.NumThreads(), 4);
+  EXPECT_EQ(tp.GetThreadIds().size(), 4u);
+  std::atomic<int> sum{0};
+  for (int i = 1; i <= 100; i++) {
+    tp.AddWork([&, i](int thread_id) {
+      EXPECT_GE(thread_id, 0);
+      EXPECT_LT(thread_id, 4);
+      sum += i;
+    }, i);
+  }
+  tp.RunAll();
+  EXPECT_EQ(sum, 100 * 101 / 2);
+
+  tp.AddWork([](int) { throw std::runtime_error("work stealing error"); });
+  EXPECT_THROW(tp.RunAll(), std::runtime_error);
+
+  // the inline execution of a single job applies to this pool as well
+  tp.SetInlineSingleWork(true);
+  auto caller = std::this_thread::get_id();
+  std::thread::id runner;
+  tp.AddWork([&](int thread_id) {
+    EXPECT_EQ(thread_id, 0);
+    runner = std::this_thread::get_id();
+  });
+  tp.RunAll();
+  EXPECT_EQ(runner, caller);
+}
+
 }  // namespace test
 
 }  // namespace dali
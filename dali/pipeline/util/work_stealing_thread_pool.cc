@@ -0,0 +1,248 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <utility>
+#include "dali/pipeline/util/work_stealing_thread_pool.h"
+#include "dali/pipeline/util/thread_pool.h"
+#if NVML_ENABLED
+#include "dali/util/nvml.h"
+#endif
+#include "dali/core/allocation_counter.h"
+#include "dali/core/format.h"
+#include "dali/core/device_guard.h"
+#include "dali/core/nvtx.h"
+
+namespace dali {
+
+WorkStealingThreadPool::WorkStealingThreadPool(int num_thread, int device_id, bool set_affinity,
+                                               const std::string &name)
+    : device_id_(device_id) {
+  DALI_ENFORCE(num_thread > 0, "Thread pool must have non-zero size");
+#if NVML_ENABLED
+  // only for the CPU pipeline
+  if (device_id != CPU_ONLY_DEVICE_ID) {
+    nvml::Init();
+  }
+#endif
+  tl_errors_.resize(num_thread);
+  queues_.resize(num_thread);
+  for (auto &q : queues_)
+    q = std::make_unique<WorkQueue>();
+  threads_.resize(num_thread);
+  for (int i = 0; i < num_thread; ++i) {
+    threads_[i] = std::thread(std::bind(&WorkStealingThreadPool::ThreadMain, this, i, device_id,
+                                        set_affinity, make_string("[DALI][WS", i, "]", name)));
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  WaitForWork(false);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  running_ = false;
+  condition_.notify_all();
+  lock.unlock();
+
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+#if NVML_ENABLED
+  nvml::Shutdown();
+#endif
+}
+
+void WorkStealingThreadPool::AddWork(Work work, int64_t priority, bool start_immediately) {
+  outstanding_++;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (started_) {
+    Push({priority, std::move(work)});
+    condition_.notify_one();
+    return;
+  }
+  pending_.emplace_back(priority, std::move(work));
+  if (start_immediately) {
+    started_ = true;
+    StartPending();
+  }
+}
+
+void WorkStealingThreadPool::StartPending() {
+  std::stable_sort(pending_.begin(), pending_.end(),
+                   [](const PrioritizedWork &a, const PrioritizedWork &b) {
+                     return a.first > b.first;
+                   });
+  // each queue gets its jobs in order of decreasing priority
+  for (auto &work : pending_)
+    Push(std::move(work));
+  pending_.clear();
+  condition_.notify_all();
+}
+
+void WorkStealingThreadPool::Push(PrioritizedWork &&work) {
+  auto &q = *queues_[next_queue_];
+  if (++next_queue_ == static_cast<int>(queues_.size()))
+    next_queue_ = 0;
+  {
+    std::lock_guard<spinlock> qlock(q.lock);
+    q.jobs.push_back(std::move(work));
+  }
+  queued_++;
+}
+
+bool WorkStealingThreadPool::TryPop(int thread_id, Work &work) {
+  if (queued_ == 0)
+    return false;
+  {
+    // the own queue is processed from the highest priority...
+    auto &q = *queues_[thread_id];
+    std::lock_guard<spinlock> qlock(q.lock);
+    if (!q.jobs.empty()) {
+      work = std::move(q.jobs.front().second);
+      q.jobs.pop_front();
+      queued_--;
+      return true;
+    }
+  }
+  int n = queues_.size();
+  for (int i = 1; i < n; i++) {
+    // ...and the other threads steal from the opposite end to minimize contention
+    auto &q = *queues_[(thread_id + i) % n];
+    std::lock_guard<spinlock> qlock(q.lock);
+    if (!q.jobs.empty()) {
+      work = std::move(q.jobs.back().second);
+      q.jobs.pop_back();
+      queued_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::RunAll(bool wait) {
+  if (wait && inline_single_work_) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!started_ && pending_.size() == 1 && outstanding_ == 1) {
+      Work work = std::move(pending_.back().second);
+      pending_.clear();
+      outstanding_ = 0;
+      lock.unlock();
+      DeviceGuard g(device_id_);
+      try {
+        work(0);
+      } catch (std::exception &e) {
+        // the same error as the one reported by WaitForWork
+        throw std::runtime_error(make_string("Error in thread 0: ", e.what()));
+      } catch (...) {
+        throw std::runtime_error("Error in thread 0: Caught unknown exception");
+      }
+      return;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    started_ = true;
+    StartPending();
+  }
+  if (wait) {
+    WaitForWork();
+  }
+}
+
+void WorkStealingThreadPool::WaitForWork(bool checkForErrors) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  completed_.wait(lock, [this] { return outstanding_ == 0; });
+  started_ = false;
+  lock.unlock();
+  if (checkForErrors) {
+    std::lock_guard<std::mutex> elock(error_mutex_);
+    for (size_t i = 0; i < threads_.size(); ++i) {
+      if (!tl_errors_[i].empty()) {
+        // Throw the first error that occurred
+        string error = make_string("Error in thread ", i, ": ", tl_errors_[i].front());
+        tl_errors_[i].pop();
+        throw std::runtime_error(error);
+      }
+    }
+  }
+}
+
+int WorkStealingThreadPool::NumThreads() const {
+  return threads_.size();
+}
+
+std::vector<std::thread::id> WorkStealingThreadPool::GetThreadIds() const {
+  std::vector<std::thread::id> tids;
+  tids.reserve(threads_.size());
+  for (const auto &thread : threads_)
+    tids.emplace_back(thread.get_id());
+  return tids;
+}
+
+void WorkStealingThreadPool::RecordError(int thread_id, std::string message) {
+  std::lock_guard<std::mutex> elock(error_mutex_);
+  tl_errors_[thread_id].push(std::move(message));
+}
+
+void WorkStealingThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity,
+                                        const std::string &name) {
+  SetThreadName(name.c_str());
+  DeviceGuard g(device_id);
+  try {
+    if (set_affinity)
+      detail::SetPoolThreadAffinity(thread_id);
+  } catch (std::exception &e) {
+    RecordError(thread_id, e.what());
+  } catch (...) {
+    RecordError(thread_id, "Caught unknown exception");
+  }
+
+  Work work;
+  for (;;) {
+    if (!TryPop(thread_id, work)) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this] { return !running_ || queued_ > 0; });
+      if (!running_)
+        break;
+      continue;
+    }
+
+    // If an error occurs, we save it in tl_errors_. When
+    // WaitForWork is called, we will check for any errors
+    // in the threads and return an error if one occured.
+#if ALLOCATION_COUNTING_ENABLED
+    AllocationCounter allocations;
+#endif
+    try {
+      DomainTimeRange tr("[DALI][ThreadPool] Job", DomainTimeRange::kGreen);
+      work(thread_id);
+    } catch (std::exception &e) {
+      RecordError(thread_id, e.what());
+    } catch (...) {
+      RecordError(thread_id, "Caught unknown exception");
+    }
+    work = {};
+#if ALLOCATION_COUNTING_ENABLED
+    num_allocations_ += allocations.count();
+#endif
+
+    if (--outstanding_ == 0) {
+      // the lock prevents the notification from being lost by a thread entering WaitForWork
+      std::lock_guard<std::mutex> lock(mutex_);
+      completed_.notify_all();
+    }
+  }
+}
+
+}  // namespace dali
@@ -0,0 +1,150 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_UTIL_WORK_STEALING_THREAD_POOL_H_
+#define DALI_PIPELINE_UTIL_WORK_STEALING_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "dali/core/common.h"
+#include "dali/core/inline_function.h"
+#include "dali/core/spinlock.h"
+
+namespace dali {
+
+/**
+ * @brief A thread pool with a work queue per thread and work stealing
+ *
+ * The pool has the same interface and semantics as ThreadPool (and satisfies the
+ * ExecutionEngine concept), but instead of keeping all the jobs in a single queue guarded by
+ * one mutex, each thread has its own deque. When the work is started, the pending jobs are sorted
+ * by priority and dealt to the threads in a round-robin fashion, so each thread processes its
+ * jobs from the highest priority. A thread that runs out of work steals the lowest priority job
+ * from another thread's queue.
+ *
+ * The priorities are therefore honored only approximately: with one thread the order is exact,
+ * with more threads the highest priority jobs are started first, but no global order is enforced.
+ */
+class DLL_PUBLIC WorkStealingThreadPool {
+ public:
+  // Basic unit of work that our threads do, see ThreadPool::Work
+  using Work = InlineFunction<void(int)>;
+
+  DLL_PUBLIC WorkStealingThreadPool(int num_thread, int device_id, bool set_affinity,
+                                    const std::string &name);
+
+  DLL_PUBLIC ~WorkStealingThreadPool();
+
+  /**
+   * @brief Adds work to the queue with optional priority, and optionally starts processing
+   *
+   * @see ThreadPool::AddWork
+   */
+  DLL_PUBLIC void AddWork(Work work, int64_t priority = 0, bool start_immediately = false);
+
+  /**
+   * @brief Wakes up all the threads to complete all the queued work,
+   *        optionally not waiting for the work to be finished before return
+   */
+  DLL_PUBLIC void RunAll(bool wait = true);
+
+  /**
+   * @brief Waits until all work issued to the thread pool is complete
+   */
+  DLL_PUBLIC void WaitForWork(bool checkForErrors = true);
+
+  /**
+   * @brief Makes RunAll(true) run the work in the calling thread, when only one job is queued
+   *
+   * @see ThreadPool::SetInlineSingleWork
+   */
+  DLL_PUBLIC void SetInlineSingleWork(bool enable) {
+    inline_single_work_ = enable;
+  }
+
+  /**
+   * @brief The number of the heap allocations made by the jobs so far, see ThreadPool
+   */
+  DLL_PUBLIC int64_t NumAllocations() const {
+    return num_allocations_;
+  }
+
+  DLL_PUBLIC int NumThreads() const;
+
+  DLL_PUBLIC std::vector<std::thread::id> GetThreadIds() const;
+
+  DISABLE_COPY_MOVE_ASSIGN(WorkStealingThreadPool);
+
+ private:
+  using PrioritizedWork = std::pair<int64_t, Work>;
+
+  struct WorkQueue {
+    spinlock lock;
+    std::deque<PrioritizedWork> jobs;
+    // avoids false sharing between the queues of different threads
+    char padding[64];
+  };
+
+  void ThreadMain(int thread_id, int device_id, bool set_affinity, const std::string &name);
+
+  /**
+   * @brief Moves the pending work to the per-thread queues; requires mutex_ to be held
+   */
+  void StartPending();
+
+  void Push(PrioritizedWork &&work);
+
+  bool TryPop(int thread_id, Work &work);
+
+  void RecordError(int thread_id, std::string message);
+
+  std::vector<std::thread> threads_;
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+
+  // jobs added before the work was started; guarded by mutex_
+  std::vector<PrioritizedWork> pending_;
+  // the queue that receives the next job
+  int next_queue_ = 0;
+
+  // the number of jobs that were added, but haven't completed yet
+  std::atomic<int64_t> outstanding_{0};
+  // the number of jobs in the per-thread queues
+  std::atomic<int64_t> queued_{0};
+
+  bool running_ = true;
+  bool started_ = false;
+  int device_id_;
+  std::atomic<bool> inline_single_work_{false};
+  std::atomic<int64_t> num_allocations_{0};
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::condition_variable completed_;
+
+  //  Stored error strings for each thread
+  std::mutex error_mutex_;
+  std::vector<std::queue<std::string>> tl_errors_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_UTIL_WORK_STEALING_THREAD_POOL_H_
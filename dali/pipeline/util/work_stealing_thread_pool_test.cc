@@ -0,0 +1,145 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/util/work_stealing_thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace dali {
+
+namespace test {
+
+TEST(WorkStealingThreadPool, AddWork) {
+  WorkStealingThreadPool tp(16, CPU_ONLY_DEVICE_ID, false, "WorkStealingThreadPool test");
+  std::atomic<int> count{0};
+  auto increase = [&count](int thread_id) { count++; };
+  for (int i = 0; i < 64; i++) {
+    tp.AddWork(increase);
+  }
+  ASSERT_EQ(count, 0);
+  tp.RunAll();
+  ASSERT_EQ(count, 64);
+}
+
+TEST(WorkStealingThreadPool, AddWorkImmediateStart) {
+  WorkStealingThreadPool tp(16, CPU_ONLY_DEVICE_ID, false, "WorkStealingThreadPool test");
+  std::atomic<int> count{0};
+  auto increase = [&count](int thread_id) { count++; };
+  for (int i = 0; i < 64; i++) {
+    tp.AddWork(increase, 0, true);
+  }
+  tp.WaitForWork();
+  ASSERT_EQ(count, 64);
+}
+
+TEST(WorkStealingThreadPool, AddWorkWithPriority) {
+  // only one thread to ensure deterministic behavior
+  WorkStealingThreadPool tp(1, CPU_ONLY_DEVICE_ID, false, "WorkStealingThreadPool test");
+  std::atomic<int> count{0};
+  auto set_to_1 = [&count](int thread_id) {
+    count = 1;
+  };
+  auto increase_by_1 = [&count](int thread_id) {
+    count++;
+  };
+  auto mult_by_2 = [&count](int thread_id) {
+    int val = count.load();
+    while (!count.compare_exchange_weak(val, val * 2)) {}
+  };
+  tp.AddWork(increase_by_1, 2);
+  tp.AddWork(mult_by_2, 7);
+  tp.AddWork(mult_by_2, 9);
+  tp.AddWork(mult_by_2, 8);
+  tp.AddWork(increase_by_1, 100);
+  tp.AddWork(set_to_1, 1000);
+
+  tp.RunAll();
+  ASSERT_EQ(((1+1) << 3) + 1, count);
+}
+
+TEST(WorkStealingThreadPool, Stealing) {
+  const int num_threads = 4;
+  const int num_jobs = 99;
+  WorkStealingThreadPool tp(num_threads, CPU_ONLY_DEVICE_ID, false, "WorkStealingThreadPool test");
+  std::atomic<bool> blocking{false};
+  std::atomic<int> done{0};
+  int blocking_thread = -1;
+  bool all_done_while_blocked = false;
+  std::vector<int> job_threads(num_jobs, -1);
+  // The first job (highest priority) goes to the first queue and occupies its thread until all
+  // the other jobs are complete, so the other jobs of that queue must be stolen. The other jobs
+  // don't start before it, so no thread can run any of them before it gets blocked.
+  tp.AddWork([&](int thread_id) {
+    blocking_thread = thread_id;
+    blocking = true;
+    // the time limit only prevents the test from hanging if the jobs are not stolen
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (done < num_jobs && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::yield();
+    all_done_while_blocked = done == num_jobs;
+  }, 1000);
+  for (int i = 0; i < num_jobs; i++) {
+    tp.AddWork([&, i](int thread_id) {
+      while (!blocking)
+        std::this_thread::yield();
+      job_threads[i] = thread_id;
+      done++;
+    });
+  }
+  tp.RunAll();
+  EXPECT_TRUE(all_done_while_blocked);
+  ASSERT_GE(blocking_thread, 0);
+  for (int i = 0; i < num_jobs; i++) {
+    EXPECT_GE(job_threads[i], 0);
+    EXPECT_NE(job_threads[i], blocking_thread) << "job " << i;
+  }
+}
+
+TEST(WorkStealingThreadPool, Error) {
+  WorkStealingThreadPool tp(4, CPU_ONLY_DEVICE_ID, false, "WorkStealingThreadPool test");
+  std::atomic<int> count{0};
+  for (int i = 0; i < 16; i++) {
+    tp.AddWork([&, i](int thread_id) {
+      if (i == 5)
+        throw std::runtime_error("Test error");
+      count++;
+    });
+  }
+  EXPECT_THROW(tp.RunAll(), std::runtime_error);
+  EXPECT_EQ(count, 15);
+  // the pool is still usable
+  tp.AddWork([&](int) { count++; });
+  tp.RunAll();
+  EXPECT_EQ(count, 16);
+}
+
+TEST(WorkStealingThreadPool, Reuse) {
+  WorkStealingThreadPool tp(8, CPU_ONLY_DEVICE_ID, false, "WorkStealingThreadPool test");
+  std::atomic<int> count{0};
+  for (int iter = 0; iter < 100; iter++) {
+    for (int i = 0; i < 32; i++) {
+      tp.AddWork([&](int) { count++; }, i);
+    }
+    tp.RunAll();
+    ASSERT_EQ(count, (iter + 1) * 32);
+  }
+}
+
+}  // namespace test
+
+}  // namespace dali
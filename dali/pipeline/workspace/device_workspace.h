@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -64,6 +64,14 @@ class DLL_PUBLIC DeviceWorkspace : public WorkspaceBase<DeviceInputType, DeviceO
     stream_ = stream;
   }
 
+  /**
+   * @brief Removes the stream set with 'set_stream', without clearing the contents.
+   */
+  DLL_PUBLIC inline void reset_stream() {
+    has_stream_ = false;
+    stream_ = 0;
+  }
+
   /**
    * @brief Returns true if 'set_stream' has been called.
    */
@@ -102,7 +110,7 @@ class DLL_PUBLIC DeviceWorkspace : public WorkspaceBase<DeviceInputType, DeviceO
   /**
    * @brief Returns the set of parent events this workspace stores.
    */
-  DLL_PUBLIC inline vector<cudaEvent_t> ParentEvents() const { return parent_events_; }
+  DLL_PUBLIC inline const vector<cudaEvent_t> &ParentEvents() const { return parent_events_; }
 
  private:
   cudaStream_t stream_impl() const override {
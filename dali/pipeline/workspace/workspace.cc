@@ -0,0 +1,25 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include "dali/pipeline/workspace/workspace.h"
+
+namespace dali {
+
+uint64_t ArgumentWorkspace::NextArgumentInputsVersion() {
+  static std::atomic<uint64_t> next_version{1};
+  return next_version.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace dali
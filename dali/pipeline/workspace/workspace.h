@@ -47,12 +47,26 @@ class ArgumentWorkspace {
   ArgumentWorkspace() {}
   virtual ~ArgumentWorkspace() = default;
 
+  // the copies get a new version, as the argument input descriptors are not shared
+  ArgumentWorkspace(const ArgumentWorkspace &other)
+  : argument_inputs_(other.argument_inputs_), gpu_argument_inputs_(other.gpu_argument_inputs_) {}
+
+  ArgumentWorkspace &operator=(const ArgumentWorkspace &other) {
+    argument_inputs_ = other.argument_inputs_;
+    gpu_argument_inputs_ = other.gpu_argument_inputs_;
+    argument_inputs_version_ = NextArgumentInputsVersion();
+    return *this;
+  }
+
   inline void Clear() {
     argument_inputs_.clear();
+    gpu_argument_inputs_.clear();
+    argument_inputs_version_ = NextArgumentInputsVersion();
   }
 
   void AddArgumentInput(const std::string &arg_name, shared_ptr<TensorVector<CPUBackend>> input) {
     argument_inputs_[arg_name] = { std::move(input), false };
+    argument_inputs_version_ = NextArgumentInputsVersion();
   }
 
   void AddArgumentInput(const std::string &arg_name, shared_ptr<TensorList<CPUBackend>> input) {
@@ -60,19 +74,48 @@ class ArgumentWorkspace {
       std::make_shared<TensorVector<CPUBackend>>(std::move(input)),
       true
     };
+    argument_inputs_version_ = NextArgumentInputsVersion();
+  }
+
+  /**
+   * @brief Adds an argument input stored in the GPU memory
+   *
+   * Only the arguments allowed with OpSchema::AllowGPUArgumentInput are passed this way.
+   * They are not visible to the CPU argument input accessors (and iteration).
+   */
+  void AddArgumentInput(const std::string &arg_name, shared_ptr<TensorList<GPUBackend>> input) {
+    gpu_argument_inputs_[arg_name] = std::move(input);
+    argument_inputs_version_ = NextArgumentInputsVersion();
   }
 
   const TensorVector<CPUBackend>& ArgumentInput(const std::string &arg_name) const {
     auto it = argument_inputs_.find(arg_name);
-    DALI_ENFORCE(it != argument_inputs_.end(), "Argument \"" + arg_name + "\" not found.");
-    if (it->second.should_update) {
-      // the underlying tensor list might have changed - update the views
-      it->second.tvec->UpdateViews();
+    if (it == argument_inputs_.end()) {
+      DALI_ENFORCE(!ArgumentInputIsGPU(arg_name), make_string("Argument input \"", arg_name,
+                   "\" is stored in the GPU memory and can't be accessed from the host."));
+      DALI_FAIL("Argument \"" + arg_name + "\" not found.");
     }
-    return *it->second.tvec;
+    return ArgumentInput(it->second);
+  }
+
+  /**
+   * @brief Tells whether the argument input `arg_name` is stored in the GPU memory
+   */
+  bool ArgumentInputIsGPU(const std::string &arg_name) const {
+    return gpu_argument_inputs_.count(arg_name) > 0;
+  }
+
+  bool HasGPUArgumentInputs() const {
+    return !gpu_argument_inputs_.empty();
+  }
+
+  const TensorList<GPUBackend>& GPUArgumentInput(const std::string &arg_name) const {
+    auto it = gpu_argument_inputs_.find(arg_name);
+    DALI_ENFORCE(it != gpu_argument_inputs_.end(), make_string("GPU argument input \"",
+                 arg_name, "\" not found."));
+    return *it->second;
   }
 
- protected:
   struct ArgumentInputDesc {
     shared_ptr<TensorVector<CPUBackend>> tvec;
     // If true, the views in TensorVector are updated to reflect the underlying TensorList;
@@ -82,9 +125,48 @@ class ArgumentWorkspace {
     bool should_update = false;
   };
 
+  /**
+   * @brief Looks up the argument input, so that it can be later accessed without the name lookup
+   *
+   * The result stays valid as long as ArgumentInputsVersion() doesn't change.
+   *
+   * @return the argument input descriptor or nullptr, if there's no such argument input
+   */
+  const ArgumentInputDesc *FindArgumentInput(const std::string &arg_name) const {
+    auto it = argument_inputs_.find(arg_name);
+    return it != argument_inputs_.end() ? &it->second : nullptr;
+  }
+
+  /**
+   * @brief Gets the argument input previously found with FindArgumentInput
+   */
+  const TensorVector<CPUBackend>& ArgumentInput(const ArgumentInputDesc &desc) const {
+    if (desc.should_update) {
+      // the underlying tensor list might have changed - update the views
+      desc.tvec->UpdateViews();
+    }
+    return *desc.tvec;
+  }
+
+  /**
+   * @brief Identifies the set of argument inputs of this workspace
+   *
+   * The version changes whenever the argument inputs are added or removed and it's unique
+   * across all the workspaces in the process, so it can be used to tell whether the descriptors
+   * obtained from FindArgumentInput are still valid.
+   */
+  uint64_t ArgumentInputsVersion() const {
+    return argument_inputs_version_;
+  }
+
+ protected:
+  DLL_PUBLIC static uint64_t NextArgumentInputsVersion();
+
   // Argument inputs
   using argument_input_storage_t = std::unordered_map<std::string, ArgumentInputDesc>;
   argument_input_storage_t argument_inputs_;
+  std::unordered_map<std::string, shared_ptr<TensorList<GPUBackend>>> gpu_argument_inputs_;
+  uint64_t argument_inputs_version_ = NextArgumentInputsVersion();
 
  public:
   using const_iterator = argument_input_storage_t::const_iterator;
@@ -1,4 +1,4 @@
-// Copyright (c) 2018, 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2018, 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -12,12 +12,53 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <dirent.h>
 #include <dlfcn.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "dali/plugin/plugin_manager.h"
 #include "dali/core/error_handling.h"
 
 namespace dali {
 
+namespace {
+
+const char kManifestSuffix[] = ".ops";
+
+struct OperatorModule {
+    std::string lib_path;
+    bool loaded = false;
+};
+
+/**
+ * @brief The operator modules and the schemas they provide
+ *
+ * Loading a module runs its static initializers, which may look up other schemas - hence
+ * the recursive mutex.
+ */
+struct OperatorModules {
+    std::recursive_mutex mtx;
+    std::vector<OperatorModule> modules;
+    std::unordered_map<std::string, int> schema_to_module;
+
+    static OperatorModules &instance() {
+        static OperatorModules modules;
+        return modules;
+    }
+
+    void Load(OperatorModule &module) {
+        // marked first, so that the schema lookups from the module don't load it again
+        module.loaded = true;
+        PluginManager::LoadLibrary(module.lib_path);
+    }
+};
+
+}  // namespace
+
 void PluginManager::LoadLibrary(const std::string& lib_path, bool global_symbols) {
     // dlopen is thread safe
     int flags = global_symbols ? RTLD_GLOBAL : RTLD_LOCAL;
@@ -26,4 +67,57 @@ void PluginManager::LoadLibrary(const std::string& lib_path, bool global_symbols
     DALI_ENFORCE(handle != nullptr, "Failed to load library: " + std::string(dlerror()));
 }
 
+void PluginManager::AddOperatorModule(const std::string& lib_path,
+                                      const std::vector<std::string>& schema_names) {
+    auto &inst = OperatorModules::instance();
+    std::lock_guard<std::recursive_mutex> g(inst.mtx);
+    int idx = inst.modules.size();
+    inst.modules.push_back({ lib_path });
+    for (auto &name : schema_names)
+        inst.schema_to_module.emplace(name, idx);
+}
+
+void PluginManager::DiscoverOperatorModules(const std::string& dir) {
+    std::unique_ptr<DIR, int(*)(DIR*)> dir_handle(opendir(dir.c_str()), closedir);
+    if (!dir_handle)
+        return;
+    const size_t suffix_len = sizeof(kManifestSuffix) - 1;
+    while (auto *entry = readdir(dir_handle.get())) {
+        std::string name = entry->d_name;
+        if (name.size() <= suffix_len ||
+            name.compare(name.size() - suffix_len, suffix_len, kManifestSuffix) != 0)
+            continue;
+        std::ifstream manifest(dir + "/" + name);
+        std::vector<std::string> schema_names;
+        std::string schema;
+        while (std::getline(manifest, schema)) {
+            if (!schema.empty())
+                schema_names.push_back(schema);
+        }
+        AddOperatorModule(dir + "/" + name.substr(0, name.size() - suffix_len), schema_names);
+    }
+}
+
+bool PluginManager::LoadOperatorModule(const std::string& schema_name) {
+    auto &inst = OperatorModules::instance();
+    std::lock_guard<std::recursive_mutex> g(inst.mtx);
+    auto it = inst.schema_to_module.find(schema_name);
+    if (it == inst.schema_to_module.end())
+        return false;
+    auto &module = inst.modules[it->second];
+    if (module.loaded)
+        return false;
+    inst.Load(module);
+    return true;
+}
+
+void PluginManager::LoadAllOperatorModules() {
+    auto &inst = OperatorModules::instance();
+    std::lock_guard<std::recursive_mutex> g(inst.mtx);
+    for (auto &module : inst.modules) {
+        if (!module.loaded)
+            inst.Load(module);
+    }
+}
+
 }  // namespace dali
@@ -1,4 +1,4 @@
-// Copyright (c) 2018, 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2018, 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,7 @@
 #define DALI_PLUGIN_PLUGIN_MANAGER_H_
 
 #include <string>
+#include <vector>
 #include "dali/core/common.h"
 
 namespace dali {
@@ -31,6 +32,36 @@ class DLL_PUBLIC PluginManager {
      * @throws std::runtime_error if the library could not be loaded
      */
     static DLL_PUBLIC void LoadLibrary(const std::string& lib_path, bool global_symbols = false);
+
+    /**
+     * @brief Registers a library of operators, which is loaded only when one of its schemas
+     *        is looked up
+     * @param [in] lib_path path to the library
+     * @param [in] schema_names the names of the schemas registered by the library
+     */
+    static DLL_PUBLIC void AddOperatorModule(const std::string& lib_path,
+                                             const std::vector<std::string>& schema_names);
+
+    /**
+     * @brief Registers the operator modules found in `dir`
+     *
+     * A module is a library accompanied by a manifest `<library>.ops`, which lists the names
+     * of its schemas, one per line.
+     */
+    static DLL_PUBLIC void DiscoverOperatorModules(const std::string& dir);
+
+    /**
+     * @brief Loads the operator module, which provides the schema `schema_name`
+     * @return true if a module was loaded, false if the schema isn't provided by any module,
+     *         which is not loaded yet
+     * @throws std::runtime_error if the module could not be loaded
+     */
+    static DLL_PUBLIC bool LoadOperatorModule(const std::string& schema_name);
+
+    /**
+     * @brief Loads all the registered operator modules, which are not loaded yet
+     */
+    static DLL_PUBLIC void LoadAllOperatorModules();
 };
 
 }  // namespace dali
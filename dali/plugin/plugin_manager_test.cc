@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 #include "dali/plugin/plugin_manager.h"
+#include "dali/pipeline/operator/op_schema.h"
 #include "dali/test/dali_test_utils.h"
 
 const char kNonExistingLibName[] = "not_a_dali_plugin.so";
@@ -41,3 +42,21 @@ TEST(PluginManagerTest, LoadingSameLibraryTwiceShouldBeOk) {
             dali::PluginManager::LoadLibrary(DummyPluginLibPath()) );
     }
 }
+
+TEST(PluginManagerTest, OperatorModuleLoadedOnSchemaLookup) {
+    dali::PluginManager::AddOperatorModule(DummyPluginLibPath(), {"CustomDummy"});
+    EXPECT_NE(dali::SchemaRegistry::TryGetSchema("CustomDummy"), nullptr);
+}
+
+TEST(PluginManagerTest, OperatorModuleUnknownSchema) {
+    EXPECT_FALSE(dali::PluginManager::LoadOperatorModule("NotAnOperatorOfAnyModule"));
+}
+
+TEST(PluginManagerTest, OperatorModuleLoadFail) {
+    dali::PluginManager::AddOperatorModule(kNonExistingLibName, {"NotADaliPluginOperator"});
+    EXPECT_THROW(
+        dali::PluginManager::LoadOperatorModule("NotADaliPluginOperator"),
+        std::runtime_error);
+    // the module is not retried
+    EXPECT_FALSE(dali::PluginManager::LoadOperatorModule("NotADaliPluginOperator"));
+}
@@ -0,0 +1,54 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <mutex>
+#include <string>
+#include "dali/plugin/source_provider.h"
+
+namespace dali {
+
+namespace {
+
+struct SourceProviderRegistry {
+  std::mutex mtx;
+  std::map<std::string, const daliSourceProvider *> providers;
+};
+
+// The providers are registered by the static initializers of the plugins, so the registry
+// is created on first use.
+SourceProviderRegistry &GetRegistry() {
+  static SourceProviderRegistry registry;
+  return registry;
+}
+
+}  // namespace
+
+}  // namespace dali
+
+int daliRegisterSourceProvider(const char *name, const daliSourceProvider *provider) {
+  if (!name || !provider || provider->abi_version != DALI_SOURCE_PROVIDER_ABI_VERSION)
+    return -1;
+  auto &registry = dali::GetRegistry();
+  std::lock_guard<std::mutex> guard(registry.mtx);
+  auto it = registry.providers.emplace(name, provider).first;
+  return it->second == provider ? 0 : -1;
+}
+
+const daliSourceProvider *daliGetSourceProvider(const char *name) {
+  auto &registry = dali::GetRegistry();
+  std::lock_guard<std::mutex> guard(registry.mtx);
+  auto it = registry.providers.find(name);
+  return it != registry.providers.end() ? it->second : nullptr;
+}
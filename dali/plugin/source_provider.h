@@ -0,0 +1,125 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PLUGIN_SOURCE_PROVIDER_H_
+#define DALI_PLUGIN_SOURCE_PROVIDER_H_
+
+#include <inttypes.h>
+#include "dali/c_api.h"
+#include "dali/core/api_helper.h"
+
+/**
+ * @file
+ *
+ * C interface of the data sources implemented in plugin libraries.
+ *
+ * A source provider produces the batches of the `PluginSource` operator. The samples are written
+ * directly to the output of the operator, in parallel, by the threads of DALI's thread pool,
+ * so the user code is not bound by the GIL and doesn't need the serialization of the Python
+ * external source workers.
+ *
+ * A plugin library registers its providers when it's loaded (e.g. with
+ * `nvidia.dali.plugin_manager.load_library`), typically with DALI_REGISTER_SOURCE_PROVIDER.
+ */
+
+#define DALI_SOURCE_PROVIDER_ABI_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The table of functions implementing a source provider.
+ *
+ * The functions return 0 on success and a nonzero (provider-specific) status on failure.
+ * A failure is reported as an error of the operator, the status is included in the message.
+ */
+typedef struct {
+  /** Must be DALI_SOURCE_PROVIDER_ABI_VERSION */
+  int abi_version;
+
+  /**
+   * @brief Creates the state of the provider for an operator instance.
+   *
+   * @param config the `config` argument of the operator, passed verbatim
+   * @return the state passed to the remaining functions or NULL on failure
+   */
+  void *(*create)(const char *config);
+
+  /** Destroys the state created with `create` */
+  void (*destroy)(void *state);
+
+  /**
+   * @brief Describes the output: the type and the number of dimensions, which are the same
+   *        for all the batches. Called once, after `create`.
+   */
+  int (*get_output_desc)(void *state, dali_data_type_t *dtype, int *ndim);
+
+  /**
+   * @brief Prepares the batch of the given iteration and reports the shapes of its samples.
+   *
+   * Called for consecutive iterations, from one thread at a time.
+   *
+   * @param batch_size  on input - the maximum batch size of the pipeline; the provider may set
+   *                    a smaller number of samples
+   * @param shapes      `batch_size * ndim` extents to be filled, sample after sample
+   */
+  int (*prepare_batch)(void *state, int64_t iteration, int *batch_size, int64_t *shapes);
+
+  /**
+   * @brief Writes the sample `sample_idx` of the prepared batch to `data`.
+   *
+   * The samples of a batch are produced concurrently, from the threads of DALI's thread pool.
+   * `data` has the size and type given by `prepare_batch` and `get_output_desc`.
+   *
+   * @param thread_idx  the index of the calling thread (in the range [0, num_threads)), which
+   *                    can be used to access per-thread scratch memory
+   */
+  int (*produce_sample)(void *state, int64_t iteration, int sample_idx, void *data,
+                        int thread_idx);
+} daliSourceProvider;
+
+/**
+ * @brief Registers a source provider under the given name.
+ *
+ * The `provider` table must stay valid for as long as the library is loaded.
+ * Registering the same table again is a no-op.
+ *
+ * @return 0 on success; nonzero if the ABI version doesn't match or if a different provider
+ *         is already registered with this name
+ */
+DLL_PUBLIC int daliRegisterSourceProvider(const char *name, const daliSourceProvider *provider);
+
+/**
+ * @brief Returns the provider registered with the given name or NULL, if there's none.
+ */
+DLL_PUBLIC const daliSourceProvider *daliGetSourceProvider(const char *name);
+
+#ifdef __cplusplus
+}  // extern "C"
+
+#define DALI_SOURCE_PROVIDER_CONCAT_IMPL(a, b) a##b
+#define DALI_SOURCE_PROVIDER_CONCAT(a, b) DALI_SOURCE_PROVIDER_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Registers the `provider` (a daliSourceProvider with static storage) when the library
+ *        is loaded.
+ */
+#define DALI_REGISTER_SOURCE_PROVIDER(name, provider)                                   \
+  static const int DALI_SOURCE_PROVIDER_CONCAT(dali_source_provider_reg_, __LINE__) = \
+      daliRegisterSourceProvider(name, &(provider))
+
+#endif  // __cplusplus
+
+#endif  // DALI_PLUGIN_SOURCE_PROVIDER_H_
@@ -14,12 +14,15 @@
 
 #include <cuda_runtime_api.h>
 #include <dlfcn.h>
+#include "dali/core/cuda_peer_access.h"
 #include "dali/core/cuda_utils.h"
 #include "dali/core/device_guard.h"
+#include "dali/core/mm/default_resources.h"
 #if SHM_WRAPPER_ENABLED
 #include "dali/core/os/shared_mem.h"
 #endif
 #include "dali/core/python_util.h"
+#include "dali/core/tracer.h"
 #include "dali/operators.h"
 #include "dali/kernels/kernel.h"
 #include "dali/operators/reader/parser/tfrecord_parser.h"
@@ -34,6 +37,7 @@
 #include "dali/pipeline/operator/operator.h"
 #include "dali/pipeline/pipeline.h"
 #include "dali/pipeline/pipeline_debug.h"
+#include "dali/pipeline/util/copy_with_stride.h"
 #include "dali/plugin/plugin_manager.h"
 #include "dali/python/python3_compat.h"
 #include "dali/util/half.hpp"
@@ -163,6 +167,55 @@ void CheckContiguousTensor(const TStrides &strides, const TShape &shape, size_t
   CheckContiguousTensor(strides, dali::size(strides), shape, dali::size(shape), element_size);
 }
 
+/**
+ * @brief Tells whether the strides (in bytes) describe densely packed data of the given shape
+ */
+template<typename TStrides, typename TShape>
+bool IsDenselyPacked(const TStrides &strides, const TShape &shape, int ndim, size_t element_size) {
+  int64_t stride_from_shape = element_size;
+  for (int i = ndim - 1; i >= 0; i--) {
+    if (strides[i] != stride_from_shape)
+      return false;
+    stride_from_shape *= shape[i];
+  }
+  return true;
+}
+
+template <typename Backend>
+void *RawMutableData(Tensor<Backend> &t) {
+  return t.raw_mutable_data();
+}
+
+template <typename Backend>
+void *RawMutableData(TensorList<Backend> &tl) {
+  return unsafe_raw_mutable_data(tl);
+}
+
+/**
+ * @brief Fills `batch` with a densely packed copy of strided data
+ *
+ * A strided view (e.g. a transposed or sliced array) can't be wrapped, so it's gathered
+ * once into the memory of the batch - the densely packed data is still wrapped without a copy.
+ * The GPU data is copied on the current device and the copy is complete when this returns.
+ *
+ * @param shape        the shape of the data (with the outermost, sample dimension for batches)
+ * @param byte_strides the strides of the data, in bytes
+ */
+template <typename Backend, template<typename> class BatchType, typename BatchShape>
+void CopyStridedData(BatchType<Backend> *batch, const void *data,
+                     const std::vector<Index> &byte_strides, const TensorShape<> &shape,
+                     const BatchShape &batch_shape, const TypeInfo &type) {
+  batch->Reset();
+  batch->set_pinned(false);
+  batch->Resize(batch_shape, type.id());
+  if (volume(shape) == 0)
+    return;
+  CopyWithStride<Backend>(RawMutableData(*batch), data, byte_strides.data(), shape.data(),
+                          shape.size(), type.size());
+  if (std::is_same<Backend, GPUBackend>::value)
+    CUDA_CALL(cudaStreamSynchronize(0));
+}
+
 template<typename SrcBackend, template<typename> class SourceDataType>
 void FillTensorFromDlPack(py::capsule capsule, SourceDataType<SrcBackend> *batch, string layout) {
   auto dlm_tensor_ptr = DLMTensorPtrFromCapsule(capsule);
@@ -180,12 +233,27 @@ void FillTensorFromDlPack(py::capsule capsule, SourceDataType<SrcBackend> *batch
     shape[i] = dl_tensor.shape[i];
   }
 
-  CheckContiguousTensor(dl_tensor.strides, dl_tensor.ndim, dl_tensor.shape, dl_tensor.ndim, 1);
   size_t bytes = volume(shape) * dali_type.size();
+  auto typed_shape = ConvertShape(shape, batch);
+
+  if (dl_tensor.strides &&
+      !IsDenselyPacked(dl_tensor.strides, dl_tensor.shape, dl_tensor.ndim, 1)) {
+    std::vector<Index> byte_strides(dl_tensor.ndim);
+    for (int i = 0; i < dl_tensor.ndim; i++)
+      byte_strides[i] = dl_tensor.strides[i] * dali_type.size();
+    const void *data = static_cast<const uint8_t *>(dl_tensor.data) + dl_tensor.byte_offset;
+    if (dl_tensor.device.device_type == kDLCUDA) {
+      DeviceGuard dg(dl_tensor.device.device_id);
+      CopyStridedData(batch, data, byte_strides, shape, typed_shape, dali_type);
+    } else {
+      CopyStridedData(batch, data, byte_strides, shape, typed_shape, dali_type);
+    }
+    batch->SetLayout(layout);
+    return;
+  }
 
   // empty lambda that just captures dlm_tensor_ptr unique ptr that would be destructed when
   // shared ptr is destroyed
-  auto typed_shape = ConvertShape(shape, batch);
   bool is_pinned = dl_tensor.device.device_type == kDLCUDAHost;
   batch->ShareData(shared_ptr<void>(dl_tensor.data,
                                     [dlm_tensor_ptr = move(dlm_tensor_ptr)](void*) {}),
@@ -366,12 +434,18 @@ void ExposeTensor(py::module &m) {
           }
           size_t bytes = volume(i_shape) * info.itemsize;
 
-          // Validate the stride
-          CheckContiguousTensor(info.strides, info.shape, info.itemsize);
-
-          // Create the Tensor and wrap the data
           auto t = std::make_unique<Tensor<CPUBackend>>();
           const TypeInfo &type = TypeFromFormatStr(info.format);
+          DALI_ENFORCE(info.strides.size() == info.shape.size(),
+            "There should be exactly as many strides as there are extents in array shape.");
+          if (!IsDenselyPacked(info.strides, info.shape, info.ndim, info.itemsize)) {
+            std::vector<Index> strides(info.strides.begin(), info.strides.end());
+            CopyStridedData(t.get(), info.ptr, strides, i_shape, i_shape, type);
+            t->SetLayout(layout);
+            return t.release();
+          }
+
+          // Wrap the data
           // Keep a copy of the input buffer ref in the deleter, so its refcount is increased
           // while this shared_ptr is alive (and the data should be kept alive)
           t->ShareData(shared_ptr<void>(info.ptr, [buf_ref = b](void *) {}),
@@ -612,7 +686,11 @@ void ExposeEagerOperator(py::module &m) {
            [](EagerOperator<GPUBackend> &op,
               const std::vector<std::shared_ptr<TensorList<GPUBackend>>> &inputs,
               const std::unordered_map<std::string, std::shared_ptr<TensorList<CPUBackend>>>
-                  &kwargs) { return op.Run(inputs, kwargs); });
+                  &kwargs,
+              bool synchronize) { return op.Run(inputs, kwargs, synchronize); },
+           "inputs"_a, "kwargs"_a, "synchronize"_a = true)
+      .def_static("synchronize_shared_stream",
+                  &EagerOperator<GPUBackend>::SynchronizeSharedStream);
 
   py::class_<EagerOperator<MixedBackend>>(m, "EagerOperatorMixed")
       .def(py::init([](const OpSpec &op_spec) {
@@ -623,7 +701,11 @@ void ExposeEagerOperator(py::module &m) {
            [](EagerOperator<MixedBackend> &op,
               const std::vector<std::shared_ptr<TensorList<CPUBackend>>> &inputs,
               const std::unordered_map<std::string, std::shared_ptr<TensorList<CPUBackend>>>
-                  &kwargs) { return op.Run(inputs, kwargs); });
+                  &kwargs,
+              bool synchronize) { return op.Run(inputs, kwargs, synchronize); },
+           "inputs"_a, "kwargs"_a, "synchronize"_a = true)
+      .def_static("synchronize_shared_stream",
+                  &EagerOperator<MixedBackend>::SynchronizeSharedStream);
 }
 
 void ExposePipelineDebug(py::module &m) {
@@ -767,12 +849,19 @@ void ExposeTensorList(py::module &m) {
         auto i_shape = uniform_list_shape(info.shape[0], tensor_shape);
         size_t bytes = volume(tensor_shape)*i_shape.size()*info.itemsize;
 
-        // Validate the stride
-        CheckContiguousTensor(info.strides, info.shape, info.itemsize);
-
-        // Create the Tensor and wrap the data
         auto t = std::make_shared<TensorList<CPUBackend>>();
         const TypeInfo &type = TypeFromFormatStr(info.format);
+        DALI_ENFORCE(info.strides.size() == info.shape.size(),
+          "There should be exactly as many strides as there are extents in array shape.");
+        if (!IsDenselyPacked(info.strides, info.shape, info.ndim, info.itemsize)) {
+          std::vector<Index> strides(info.strides.begin(), info.strides.end());
+          TensorShape<> shape(info.shape.begin(), info.shape.end());
+          CopyStridedData(t.get(), info.ptr, strides, shape, i_shape, type);
+          t->SetLayout(layout);
+          return t;
+        }
+
+        // Wrap the data
         // Keep a copy of the input buffer ref in the deleter, so its refcount is increased
         // while this shared_ptr is alive (and the data should be kept alive)
         t->ShareData(shared_ptr<void>(info.ptr, [buf_ref = b](void *){}),
@@ -806,7 +895,8 @@ void ExposeTensorList(py::module &m) {
       layout : str
             Layout of the data
       )code")
-    .def("_as_gpu", [](TensorList<CPUBackend> &t) {
+    .def("_as_gpu", [](TensorList<CPUBackend> &t, int device_id) {
+          DeviceGuard g(device_id);
           auto ret = std::make_shared<TensorList<GPUBackend>>();
           int dev = -1;
           CUDA_CALL(cudaGetDevice(&dev));
@@ -817,8 +907,11 @@ void ExposeTensorList(py::module &m) {
           us->Wait(*ret);
           return ret;
         },
+      "device_id"_a = -1,
       R"code(
       Returns a `TensorListGPU` object being a copy of this `TensorListCPU`.
+
+      The copy is placed on the `device_id` or, if it's negative, on the current device.
       )code",
       py::return_value_policy::take_ownership)
     .def("layout", [](TensorList<CPUBackend> &t) {
@@ -1065,6 +1158,38 @@ void ExposeTensorList(py::module &m) {
       Returns a `TensorListCPU` object being a copy of this `TensorListGPU`.
       )code",
       py::return_value_policy::take_ownership)
+    .def("_copy_to_device", [](TensorList<GPUBackend> &t, int device_id, int begin, int end) {
+          DALI_ENFORCE(0 <= begin && begin <= end && end <= t.num_samples(), make_string(
+              "Invalid range of samples [", begin, ", ", end, ") in a batch of ",
+              t.num_samples(), " samples."));
+          DeviceGuard g(device_id);
+          auto ret = std::make_shared<TensorList<GPUBackend>>();
+          ret->set_device_id(device_id);
+          TensorListShape<> shape(end - begin, t.sample_dim());
+          for (int i = begin; i < end; i++)
+            shape.set_tensor_shape(i - begin, t.tensor_shape(i));
+          ret->SetContiguous(true);
+          ret->Resize(shape, t.type());
+          ret->SetLayout(t.GetLayout());
+          UserStream *us = UserStream::Get();
+          cudaStream_t s = us->GetStream(*ret);
+          size_t item_size = t.type_info().size();
+          for (int i = begin; i < end; i++) {
+            CopyPeer(ret->raw_mutable_tensor(i - begin), device_id, t.raw_tensor(i), t.device_id(),
+                     volume(t.tensor_shape_span(i)) * item_size, s);
+          }
+          us->Wait(*ret);
+          return ret;
+        },
+      "device_id"_a,
+      "begin"_a,
+      "end"_a,
+      R"code(
+      Returns a `TensorListGPU` on the `device_id` with a copy of the samples [`begin`, `end`).
+
+      The samples are copied directly between the devices, when the peer access is possible.
+      )code",
+      py::return_value_policy::take_ownership)
     .def("shape", &py_shape_list<GPUBackend>,
       R"code(
       Shape of the tensor list.
@@ -1280,6 +1405,111 @@ void ExposeBufferPolicyFunctions(py::module &m) {
   m.def("RestrictPinnedMemUsage", RestrictPinnedMemUsage);
 }
 
+mm::pool_stats_provider *GetMemoryPoolStatsProvider(const std::string &kind, int device_id) {
+  if (kind == "device")
+    return mm::GetDefaultDevicePoolStats(device_id);
+  if (kind == "pinned")
+    return mm::GetDefaultPinnedPoolStats(device_id);
+  throw py::value_error(make_string("Unknown memory pool kind: \"", kind,
+                                    "\". Expected \"device\" or \"pinned\"."));
+}
+
+py::object PoolStatsToDict(const mm::pool_stats &stats) {
+  py::dict d;
+  d["reserved_bytes"] = stats.reserved_bytes;
+  d["peak_reserved_bytes"] = stats.peak_reserved_bytes;
+  d["allocated_bytes"] = stats.allocated_bytes;
+  d["peak_allocated_bytes"] = stats.peak_allocated_bytes;
+  d["free_bytes"] = stats.free.bytes;
+  d["free_blocks"] = stats.free.blocks;
+  d["largest_free_block"] = stats.free.largest_block;
+  d["allocations"] = stats.allocations;
+  d["deallocations"] = stats.deallocations;
+  d["upstream_allocations"] = stats.upstream_allocations;
+  d["upstream_deallocations"] = stats.upstream_deallocations;
+  d["fragmentation"] = stats.fragmentation();
+  return d;
+}
+
+void ExposeMemoryPoolStats(py::module &m) {
+  m.def("GetMemoryPoolStats", [](const std::string &kind, int device_id) -> py::object {
+    auto *provider = GetMemoryPoolStatsProvider(kind, device_id);
+    if (!provider)
+      return py::none();
+    return PoolStatsToDict(provider->get_stats());
+  }, "kind"_a, "device_id"_a = -1,
+  R"code(Returns the statistics of the default memory pool as a dictionary.
+
+Args:
+    kind: ``"device"`` or ``"pinned"``
+    device_id: Device index; if negative, the current device is used
+
+Returns ``None`` if the default memory resource of given kind is not a pool.
+)code");
+
+  m.def("GetPinnedHugePageStats", []() -> py::object {
+    auto stats = mm::GetPinnedHugePageStats();
+    py::dict d;
+    d["huge_page_size"] = stats.huge_page_size;
+    d["huge_page_bytes"] = stats.huge_page_bytes;
+    d["fallback_bytes"] = stats.fallback_bytes;
+    return d;
+  },
+  R"code(Returns the huge page usage of the pinned memory pools as a dictionary.
+
+The ``huge_page_size`` is the size set with ``DALI_PINNED_HUGEPAGES`` (0 if huge pages are not
+used), ``huge_page_bytes`` is the memory mapped with huge pages and ``fallback_bytes`` is the memory
+mapped with regular pages, because huge pages couldn't be obtained.
+)code");
+
+  m.def("ResetMemoryPoolPeakStats", [](const std::string &kind, int device_id) {
+    if (auto *provider = GetMemoryPoolStatsProvider(kind, device_id))
+      provider->reset_peak_stats();
+  }, "kind"_a, "device_id"_a = -1,
+  "Sets the peak values in the statistics of the default memory pool to the current ones.");
+
+  m.def("TrimMemoryPool", [](const std::string &kind, int device_id, size_t keep_bytes) {
+    auto *provider = GetMemoryPoolStatsProvider(kind, device_id);
+    return provider ? provider->trim(keep_bytes) : size_t{0};
+  }, "kind"_a, "device_id"_a = -1, "keep_bytes"_a = 0,
+  R"code(Returns the free memory of the default memory pool to the system.
+
+The free memory is released until at most ``keep_bytes`` stay reserved by the pool; only
+the memory which is entirely free can be released.
+
+Args:
+    kind: ``"device"`` or ``"pinned"``
+    device_id: Device index; if negative, the current device is used
+    keep_bytes: The reserved size of the pool to keep
+
+Returns the number of bytes released.
+)code");
+
+  m.def("StartTracing", [](size_t max_events) {
+    Tracer::instance().Start(max_events);
+  }, "max_events"_a = Tracer::kDefaultMaxEvents,
+  R"code(Starts recording the timeline of DALI's work, discarding the one recorded before.
+
+The recorded spans are the stages of the executor, the ``Setup`` and ``Run`` of the operators,
+the jobs of the thread pools, the prefetching of the readers and the GPU work of the operators,
+timed with CUDA events. At most ``max_events`` spans are recorded.
+)code");
+
+  m.def("StopTracing", []() {
+    Tracer::instance().Stop();
+  }, "Stops recording the timeline. The recorded spans are kept until the next ``StartTracing``.");
+
+  m.def("WriteTrace", [](const std::string &filename) {
+    py::gil_scoped_release interpreter_unlock{};
+    Tracer::instance().Write(filename);
+  }, "filename"_a,
+  R"code(Writes the recorded timeline as a Chrome trace (JSON), to be opened with Perfetto
+or ``chrome://tracing``.
+
+Waits for the GPU work of the recorded spans to complete.
+)code");
+}
+
 py::dict DeprecatedArgMetaToDict(const DeprecatedArgDef & meta) {
   py::dict d;
   d["msg"] = meta.msg;
@@ -1322,6 +1552,97 @@ py::dict ExecutorMetaToDict(const ExecutorMetaMap &meta) {
   return d;
 }
 
+py::dict ExecutorTimingToDict(const ExecutorTiming &timing) {
+  py::dict operators;
+  for (const auto &op : timing.operators) {
+    py::dict op_dict;
+    op_dict["num_runs"] = op.second.num_runs;
+    op_dict["num_samples"] = op.second.num_samples;
+    op_dict["host_time"] = op.second.host_time;
+    op_dict["num_gpu_runs"] = op.second.num_gpu_runs;
+    op_dict["gpu_time"] = op.second.gpu_time;
+    operators[op.first.c_str()] = op_dict;
+  }
+  py::dict stages, bottleneck;
+  for (auto stage : { OpType::CPU, OpType::MIXED, OpType::GPU }) {
+    const auto &st = timing.stages[static_cast<int>(stage)];
+    py::dict stage_dict;
+    stage_dict["num_iterations"] = st.num_iterations;
+    stage_dict["num_samples"] = st.num_samples;
+    stage_dict["host_time"] = st.host_time;
+    stage_dict["wait_time"] = st.wait_time;
+    stage_dict["mean_queue_occupancy"] = st.num_queue_samples
+        ? static_cast<double>(st.queue_occupancy_sum) / st.num_queue_samples : 0.0;
+    stage_dict["max_queue_occupancy"] = st.max_queue_occupancy;
+    stage_dict["producer_wait"] = st.producer_wait;
+    stage_dict["consumer_wait"] = st.consumer_wait;
+    stage_dict["num_allocations"] = st.num_allocations;
+    stage_dict["last_allocations"] = st.last_allocations;
+    stage_dict["num_graph_captures"] = st.num_graph_captures;
+    stage_dict["num_graph_replays"] = st.num_graph_replays;
+    stages[to_string(stage).c_str()] = stage_dict;
+    bottleneck[to_string(stage).c_str()] = timing.bottleneck.stages[static_cast<int>(stage)];
+  }
+  bottleneck["consumer"] = timing.bottleneck.consumer;
+  py::dict d;
+  d["operators"] = operators;
+  d["stages"] = stages;
+  d["bottleneck"] = bottleneck;
+  d["elapsed_time"] = timing.elapsed_time;
+  return d;
+}
+
+py::tuple PipelineOutputsToPy(DeviceWorkspace &ws) {
+  py::tuple outs(ws.NumOutput());
+  for (int i = 0; i < ws.NumOutput(); ++i) {
+    if (ws.OutputIsType<CPUBackend>(i)) {
+      outs[i] = ws.OutputPtr<CPUBackend>(i);
+    } else {
+      outs[i] = ws.OutputPtr<GPUBackend>(i);
+    }
+  }
+  return outs;
+}
+
+/**
+ * @brief Returns the outputs of the pipeline along with the shapes of all their samples
+ *
+ * The shapes are gathered in a single int64 array of shape (num_outputs, max_batch, max_ndim),
+ * with the unused trailing entries set to 0, and the numbers of samples and dimensions
+ * of the outputs are returned as int32 arrays - so that the consumers don't need to query
+ * the shapes sample by sample.
+ * The outputs stay in the queue of the pipeline, so the Python objects of the
+ * TensorLists, which are still alive, are reused by pybind.
+ */
+py::tuple PipelineOutputsWithShapesToPy(DeviceWorkspace &ws) {
+  int num_outputs = ws.NumOutput();
+  std::vector<const TensorListShape<> *> shapes;
+  int max_batch = 0, max_ndim = 0;
+  for (int i = 0; i < num_outputs; ++i) {
+    shapes.push_back(ws.OutputIsType<CPUBackend>(i) ? &ws.Output<CPUBackend>(i).shape()
+                                                    : &ws.Output<GPUBackend>(i).shape());
+    max_batch = std::max(max_batch, shapes[i]->num_samples());
+    max_ndim = std::max(max_ndim, shapes[i]->sample_dim());
+  }
+  py::array_t<int64_t> shape_array({num_outputs, max_batch, max_ndim});
+  std::fill_n(shape_array.mutable_data(), shape_array.size(), 0);
+  py::array_t<int32_t> num_samples(num_outputs), ndims(num_outputs);
+  auto shape_data = shape_array.mutable_unchecked<3>();
+  auto num_samples_data = num_samples.mutable_unchecked<1>();
+  auto ndims_data = ndims.mutable_unchecked<1>();
+  for (int i = 0; i < num_outputs; ++i) {
+    const auto &sh = *shapes[i];
+    num_samples_data(i) = sh.num_samples();
+    ndims_data(i) = sh.sample_dim();
+    for (int s = 0; s < sh.num_samples(); s++) {
+      auto sample_shape = sh.tensor_shape_span(s);
+      for (int d = 0; d < sh.sample_dim(); d++)
+        shape_data(i, s, d) = sample_shape[d];
+    }
+  }
+  return py::make_tuple(PipelineOutputsToPy(ws), shape_array, num_samples, ndims);
+}
+
 template <typename Backend>
 void FeedPipeline(Pipeline *p, const string &name, py::list list, AccessOrder order,
                   bool sync = false, bool use_copy_kernel = false) {
@@ -1342,12 +1663,15 @@ void FeedPipeline(Pipeline *p, const string &name, py::list list, AccessOrder or
 
 PYBIND11_MODULE(backend_impl, m) {
   dali::InitOperatorsLib();
+  // The Python API is generated from the list of all the registered operators
+  PluginManager::LoadAllOperatorModules();
   m.doc() = "Python bindings for the C++ portions of DALI";
 
   // DALI Init function
   m.def("Init", &DALIInit);
 
   ExposeBufferPolicyFunctions(m);
+  ExposeMemoryPoolStats(m);
 
   m.def("LoadLibrary", &PluginManager::LoadLibrary,
     py::arg("lib_path"),
@@ -1423,7 +1747,9 @@ PYBIND11_MODULE(backend_impl, m) {
            })
       .def("resize", &SharedMem::resize)
       .def("close_handle", &SharedMem::close_handle)
-      .def("close", &SharedMem::close);
+      .def("close", &SharedMem::close)
+      .def("set_pinned", &SharedMem::set_pinned, "pinned"_a, "device_id"_a = -1)
+      .def_property_readonly("is_pinned", &SharedMem::is_pinned);
 
 #endif
 
@@ -1586,12 +1912,14 @@ PYBIND11_MODULE(backend_impl, m) {
          })
     .def("Build", [](Pipeline *p) { p->Build(); } )
     .def("SetExecutionTypes",
-        [](Pipeline *p, bool exec_pipelined, bool exec_separated, bool exec_async) {
-          p->SetExecutionTypes(exec_pipelined, exec_separated, exec_async);
+        [](Pipeline *p, bool exec_pipelined, bool exec_separated, bool exec_async,
+           bool exec_dynamic) {
+          p->SetExecutionTypes(exec_pipelined, exec_separated, exec_async, exec_dynamic);
         },
         "exec_pipelined"_a = true,
         "exec_separated"_a = false,
-        "exec_async"_a = true)
+        "exec_async"_a = true,
+        "exec_dynamic"_a = false)
     .def("EnableExecutorMemoryStats",
         [](Pipeline *p, bool enable_memory_stats) {
           p->EnableExecutorMemoryStats(enable_memory_stats);
@@ -1602,10 +1930,109 @@ PYBIND11_MODULE(backend_impl, m) {
           auto ret = p->GetExecutorMeta();
           return ExecutorMetaToDict(ret);
         })
+    .def("EnableOperatorTiming",
+        [](Pipeline *p, bool enable) {
+          p->EnableOperatorTiming(enable);
+        },
+        "enable"_a = true)
+    .def("operator_timing",
+        [](Pipeline *p) {
+          return ExecutorTimingToDict(p->GetOperatorTiming());
+        })
+    .def("SaveMemoryProfile",
+        [](Pipeline *p, const std::string &path) {
+          p->SaveMemoryProfile(path);
+        },
+        "path"_a)
+    .def("LoadMemoryProfile",
+        [](Pipeline *p, const std::string &path) {
+          p->LoadMemoryProfile(path);
+        },
+        "path"_a)
+    .def("SetDeviceMemoryLimits",
+        [](Pipeline *p, size_t soft_limit, size_t hard_limit) {
+          p->SetDeviceMemoryLimits(soft_limit, hard_limit);
+        },
+        "soft_limit"_a,
+        "hard_limit"_a = 0)
+    .def("EnableGrowableBuffers",
+        [](Pipeline *p, bool enable) {
+          p->EnableGrowableBuffers(enable);
+        },
+        "enable"_a = true)
+    .def("EnableCudaGraphs",
+        [](Pipeline *p, bool enable) {
+          p->EnableCudaGraphs(enable);
+        },
+        "enable"_a = true)
+    .def("EnableCheckpointing",
+        [](Pipeline *p, bool enable) {
+          p->EnableCheckpointing(enable);
+        },
+        "enable"_a = true)
+    .def("GetSerializedCheckpoint",
+        [](Pipeline *p) -> py::bytes {
+          return p->GetSerializedCheckpoint();
+        })
+    .def("RestoreFromSerializedCheckpoint",
+        [](Pipeline *p, const std::string &checkpoint) {
+          p->RestoreFromSerializedCheckpoint(checkpoint);
+        },
+        "checkpoint"_a)
+    .def("SetLowLatency",
+        [](Pipeline *p, bool low_latency) {
+          p->SetLowLatency(low_latency);
+        },
+        "low_latency"_a = true)
+    .def("EnableSampleChaining",
+        [](Pipeline *p, bool enable) {
+          p->EnableSampleChaining(enable);
+        },
+        "enable"_a = true)
+    .def("EnableSharedThreadPool",
+        [](Pipeline *p, bool enable, int priority) {
+          p->EnableSharedThreadPool(enable, priority);
+        },
+        "enable"_a = true, "priority"_a = 0)
+    .def("EnableWorkStealingThreadPool",
+        [](Pipeline *p, bool enable) {
+          p->EnableWorkStealingThreadPool(enable);
+        },
+        "enable"_a = true)
+    .def("SetIterationCoalescing",
+        [](Pipeline *p, int iterations) {
+          p->SetIterationCoalescing(iterations);
+        },
+        "iterations"_a)
+    .def("SetBatchSizeBuckets",
+        [](Pipeline *p, const std::vector<int> &buckets) {
+          p->SetBatchSizeBuckets(buckets);
+        },
+        "buckets"_a)
+    .def("device_memory_usage",
+        [](Pipeline *p) -> py::object {
+          auto *quota = p->GetDeviceMemoryQuota();
+          if (!quota)
+            return py::none();
+          py::dict usage;
+          usage["current"] = quota->usage();
+          usage["peak"] = quota->peak_usage();
+          return usage;
+        })
     .def("SetQueueSizes",
         [](Pipeline *p, int cpu_size, int gpu_size) {
           p->SetQueueSizes(cpu_size, gpu_size);
         })
+    .def("EnableAdaptivePrefetch",
+        [](Pipeline *p, int max_cpu_size, int max_gpu_size, size_t memory_budget) {
+          p->EnableAdaptivePrefetch(max_cpu_size, max_gpu_size, memory_budget);
+        },
+        "max_cpu_size"_a, "max_gpu_size"_a, "memory_budget"_a = 0)
+    .def("ActiveQueueSizes",
+        [](Pipeline *p) {
+          auto sizes = p->GetActiveQueueSizes();
+          return py::make_tuple(sizes.cpu_size, sizes.gpu_size);
+        })
     .def("SetOutputDescs",
         [](Pipeline *p, const std::vector<OutputDesc>& outputs) {
           std::vector<PipelineOutputDesc> out_desc;
@@ -1620,31 +2047,25 @@ PYBIND11_MODULE(backend_impl, m) {
         [](Pipeline *p) {
           DeviceWorkspace ws;
           p->Outputs(&ws);
-
-          py::tuple outs(ws.NumOutput());
-          for (int i = 0; i < ws.NumOutput(); ++i) {
-            if (ws.OutputIsType<CPUBackend>(i)) {
-              outs[i] = ws.OutputPtr<CPUBackend>(i);
-            } else {
-              outs[i] = ws.OutputPtr<GPUBackend>(i);
-            }
-          }
-          return outs;
+          return PipelineOutputsToPy(ws);
         }, py::return_value_policy::take_ownership)
     .def("ShareOutputs",
         [](Pipeline *p) {
           DeviceWorkspace ws;
           p->ShareOutputs(&ws);
-
-          py::tuple outs(ws.NumOutput());
-          for (int i = 0; i < ws.NumOutput(); ++i) {
-            if (ws.OutputIsType<CPUBackend>(i)) {
-              outs[i] = ws.OutputPtr<CPUBackend>(i);
-            } else {
-              outs[i] = ws.OutputPtr<GPUBackend>(i);
-            }
-          }
-          return outs;
+          return PipelineOutputsToPy(ws);
+        }, py::return_value_policy::take_ownership)
+    .def("OutputsWithShapes",
+        [](Pipeline *p) {
+          DeviceWorkspace ws;
+          p->Outputs(&ws);
+          return PipelineOutputsWithShapesToPy(ws);
+        }, py::return_value_policy::take_ownership)
+    .def("ShareOutputsWithShapes",
+        [](Pipeline *p) {
+          DeviceWorkspace ws;
+          p->ShareOutputs(&ws);
+          return PipelineOutputsWithShapesToPy(ws);
         }, py::return_value_policy::take_ownership)
     .def("ReleaseOutputs",
         [](Pipeline *p) {
@@ -1703,7 +2124,7 @@ PYBIND11_MODULE(backend_impl, m) {
           // tries to call the deleted copy constructor for Tensor.
           // instead, we cast to a reference type and manually
           // move into the vector.
-          DALI_ENFORCE(static_cast<int>(list.size()) <= p->max_batch_size(),
+          DALI_ENFORCE(static_cast<int>(list.size()) <= p->coalesced_batch_size(),
              "Data list provided to feed_input exceeds maximum batch_size for this pipeline.");
 
           // not the most beautiful but at least it doesn't throw as plain cast<T>()
@@ -1757,6 +2178,16 @@ PYBIND11_MODULE(backend_impl, m) {
           DALI_ENFORCE(meta,
               "Operator " + op_name + "  not found or does not expose valid metadata.");
           return ReaderMetaToDict(meta);
+        })
+    .def("operator_diagnostics", [](Pipeline* p) {
+          py::dict d;
+          for (auto const& op : p->GetOperatorDiagnostics()) {
+            py::dict op_dict;
+            for (auto const& value : op.second)
+              op_dict[value.first.c_str()] = value.second;
+            d[op.first.c_str()] = op_dict;
+          }
+          return d;
         });
 
 #define DALI_OPSPEC_ADDARG(T) \
@@ -1779,6 +2210,9 @@ PYBIND11_MODULE(backend_impl, m) {
         "regular_input"_a = true,
         py::return_value_policy::reference_internal)
     .def("AddArgumentInput", &OpSpec::AddArgumentInput,
+        "arg_name"_a,
+        "inp_name"_a,
+        "device"_a = "cpu",
         py::return_value_policy::reference_internal)
     .def("AddOutput", &OpSpec::AddOutput,
         py::return_value_policy::reference_internal)
@@ -12,8 +12,10 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import copy
 import inspect
 import traceback
+import warnings
 from queue import Queue
 
 import nvidia.dali.backend as _b
@@ -30,11 +32,25 @@ from nvidia.dali._utils.external_source_impl import \
 
 
 class DataNodeDebug(_DataNode):
-    """Wrapper class around Tensor, implementing all of the DataNode attributes."""
+    """Wrapper class around Tensor, implementing all of the DataNode attributes.
 
-    def __init__(self, data, name, device, source):
+    When `evaluate` is given, the data is computed by calling it on first access (used by the
+    iterations run with the captured graph).
+    """
+
+    def __init__(self, data, name, device, source, evaluate=None):
         super().__init__(name, device, source)
-        self._data = data
+        self._data_value = data
+        self._evaluate = evaluate
+        # (iteration, trace entry, output index, device) of the node in the capture mode
+        self._capture_ref = None
+
+    @property
+    def _data(self):
+        if self._evaluate is not None:
+            self._data_value = self._evaluate()
+            self._evaluate = None
+        return self._data_value
 
     def __str__(self):
         indent = ' ' * 4
@@ -46,7 +62,14 @@ class DataNodeDebug(_DataNode):
     def gpu(self):
         if self.device == 'gpu':
             return self
-        return DataNodeDebug(self._data._as_gpu(), self.name, 'gpu', self.source)
+        if self._evaluate is not None:
+            node = DataNodeDebug(None, self.name, 'gpu', self.source,
+                                 lambda: self._data._as_gpu())
+        else:
+            node = DataNodeDebug(self._data._as_gpu(), self.name, 'gpu', self.source)
+        if self._capture_ref is not None:
+            node._capture_ref = self._capture_ref[:-1] + ('gpu',)
+        return node
 
     def get(self):
         return self._data
@@ -317,6 +340,7 @@ class _OperatorManager:
 
         self._device = self._init_args.get('device', 'cpu')
         self._expected_inputs_size = len(inputs)
+        self._op_class = op_class
         self.op_helper = op_class(**self._init_args)
         self._op_name = op_name
         self.op_spec = self.op_helper._spec
@@ -470,11 +494,99 @@ class _OperatorManager:
         return res
 
 
+def _same_value(value, other):
+    """Compares constant arguments of the calls recorded by the capture mode."""
+    import numpy as np
+    if type(value) is not type(other):
+        return False
+    try:
+        if isinstance(value, np.ndarray):
+            return value.dtype == other.dtype and np.array_equal(value, other)
+        return bool(value == other)
+    except Exception:
+        # Not comparable (e.g. a list of arrays) - treated as changed.
+        return False
+
+
+def _same_call_args(desc, other):
+    """Compares the descriptions of the call arguments returned by
+    :meth:`_PipelineDebug._describe_call_args`."""
+    (args, kwargs), (other_args, other_kwargs) = desc, other
+    if len(args) != len(other_args) or kwargs.keys() != other_kwargs.keys():
+        return False
+    pairs = list(zip(args, other_args)) + [(kwargs[key], other_kwargs[key]) for key in kwargs]
+    return all(kind == other_kind and
+               (value == other_value if kind == 'node' else _same_value(value, other_value))
+               for (kind, value), (other_kind, other_value) in pairs)
+
+
+class _TraceEntry:
+    """Call of an operator (or an external source, if `op_manager` is None) recorded in the
+    capture iteration of the debug pipeline.
+
+    The external sources and the operators without inputs (e.g. readers) are `fed` - they are
+    always run eagerly, so that they keep a single state, and their outputs are fed to the
+    captured graph.
+    """
+
+    def __init__(self, key, op_manager, call_args, output_devices, fed):
+        self.key = key
+        self.op_manager = op_manager
+        self.call_args = call_args
+        self.output_devices = output_devices
+        self.fed = fed
+
+    def node_refs(self):
+        args, kwargs = self.call_args
+        return [value for kind, value in args + list(kwargs.values()) if kind == 'node']
+
+
+class _DeferredOpCall:
+    """Operator call of an iteration run with the captured graph. The operator is run eagerly only
+    if its outputs are accessed, which makes the pipeline fall back to eager execution."""
+
+    def __init__(self, pipe, op_manager, inputs, kwargs):
+        self._pipe = pipe
+        self._op_manager = op_manager
+        self._inputs = inputs
+        self._kwargs = kwargs
+        self._outputs = None
+
+    def output(self, idx):
+        if self._outputs is None:
+            self._pipe._replay_fallback = True
+            res = self._op_manager.run(self._inputs, self._kwargs)
+            res = res if isinstance(res, list) else [res]
+            self._outputs = [node.get() for node in res]
+            self._inputs = self._kwargs = None
+        return self._outputs[idx]
+
+
 class _PipelineDebug(_pipeline.Pipeline):
-    """Debug mode for pipeline. Allows access to data inside the pipeline execution."""
+    """Debug mode for pipeline. Allows access to data inside the pipeline execution.
+
+    In the capture mode, the operators called in the first iteration are recorded and built into
+    a regular pipeline. The later iterations still run the Python code, but the operators only
+    check that they are called the same way and return placeholders, and the outputs are computed
+    by the regular pipeline. If an iteration diverges from the recorded one or accesses the data
+    of a placeholder, the operators of that iteration are run eagerly.
+    """
 
-    def __init__(self, exec_func, **kwargs):
+    def __init__(self, exec_func, capture=False, **kwargs):
         super().__init__(**kwargs)
+        self._capture = capture
+        # The captured graph is fed with the external source data of every iteration.
+        self._graph_kwargs = dict(kwargs, prefetch_queue_depth=1, max_prefetch_queue_depth=None)
+        self._iter_idx = 0
+        self._trace = None
+        self._trace_outputs = None
+        self._graph_pipe = None
+        self._graph_feeds = []
+        self._replaying = False
+        self._replay_pos = 0
+        self._replay_diverged = False
+        self._replay_fallback = False
+        self._replay_data = {}
         self._debug_on = False
         self._external_sources = {}
         self._feed_input_data = {}
@@ -515,18 +627,31 @@ class _PipelineDebug(_pipeline.Pipeline):
         self._debug_on = True
         self._cur_operator_id = -1
         self._cur_iter_batch_info.reset()
+        self._iter_idx += 1
+        capturing = self._capture and not self._operators_built
+        self._trace = [] if capturing else self._trace
+        self._start_replay()
         _pipeline.Pipeline.push_current(self)
 
-        res = self._exec_func()
+        try:
+            res = self._exec_func()
+        finally:
+            self._debug_on = False
+            _pipeline.Pipeline.pop_current()
         if res is None:
             res = ()
         elif not isinstance(res, tuple):
             res = (res,)
 
-        self._debug_on = False
         if not self._operators_built:
             self._operators_built = True
-        _pipeline.Pipeline.pop_current()
+
+        if capturing:
+            self._finish_capture(res)
+        elif self._replaying:
+            graph_outputs = self._finish_replay(res)
+            if graph_outputs is not None:
+                return graph_outputs
 
         # Transforming all variables to TensorLists.
         outputs = []
@@ -596,6 +721,10 @@ class _PipelineDebug(_pipeline.Pipeline):
             data = self._external_sources[key]._fetch(self._epoch_idx)
             self._check_external_source_batch_size(
                 data, ''.join(traceback.format_stack(cur_frame, limit=1)))
+            if self._replaying:
+                self._replay_fed_call(key, data)
+            else:
+                self._record_call(key, None, (), {}, data)
             return data
         else:
             raise RuntimeError(f"Unexpected operator 'ExternalSource'. Debug mode does not support"
@@ -638,9 +767,208 @@ class _PipelineDebug(_pipeline.Pipeline):
             self._create_op(op_class, op_name, key, cur_context, inputs, kwargs)
 
         if key in self._operators:
+            op_inputs = inputs
             if op_name == 'arithmetic_generic_op':
-                inputs = _PipelineDebug._extract_data_node_inputs(inputs)
-            return self._run_op(self._operators[key], inputs, kwargs)
+                op_inputs = _PipelineDebug._extract_data_node_inputs(inputs)
+            if self._replaying and len(inputs) > 0:
+                return self._replay_op_call(key, self._operators[key], inputs, op_inputs, kwargs)
+            res = self._run_op(self._operators[key], op_inputs, kwargs)
+            if self._replaying:
+                self._replay_fed_call(key, res)
+            else:
+                self._record_call(key, self._operators[key], inputs, kwargs, res)
+            return res
         else:
             raise RuntimeError(f"Unexpected operator '{op_name}'. Debug mode does not support"
                                " changing the order of operators executed within the pipeline.")
+
+    def _current_ref(self, node):
+        """Returns the reference to the trace entry producing the node in this iteration."""
+        ref = node._capture_ref
+        if ref is None or ref[0] != self._iter_idx:
+            return None
+        return ref[1:]
+
+    def _describe_call_args(self, op_manager, inputs, kwargs):
+        """Describes the arguments of a call as references to the nodes produced in the iteration
+        or as constant values. Returns None if the call can't be captured."""
+
+        def describe(value):
+            if isinstance(value, DataNodeDebug):
+                ref = self._current_ref(value)
+                return None if ref is None else ('node', ref)
+            return ('value', value)
+
+        args = [describe(value) for value in inputs]
+        kwargs = {key: describe(value) for key, value in kwargs.items()}
+        if any(desc is None for desc in args + list(kwargs.values())):
+            return None
+        # Constant inputs are a part of the expression only for the arithmetic operators.
+        if op_manager is not None and op_manager._op_name != 'arithmetic_generic_op' and \
+                any(kind == 'value' for kind, _ in args):
+            return None
+        return args, kwargs
+
+    def _record_call(self, key, op_manager, inputs, kwargs, outputs):
+        """Records a call of the capture iteration and marks its outputs."""
+        if self._trace is None or self._operators_built:
+            return
+        outputs = outputs if isinstance(outputs, list) else [outputs]
+        call_args = None
+        if op_manager is None or len(op_manager.logical_ids) == 1:
+            call_args = self._describe_call_args(op_manager, inputs, kwargs)
+        if call_args is None or not all(isinstance(out, DataNodeDebug) for out in outputs):
+            self._trace = None
+            return
+        try:
+            # The constants are compared with the ones of the later iterations.
+            call_args = copy.deepcopy(call_args)
+        except Exception:
+            self._trace = None
+            return
+        entry_idx = len(self._trace)
+        fed = op_manager is None or len(inputs) == 0
+        self._trace.append(
+            _TraceEntry(key, op_manager, call_args, [out.device for out in outputs], fed))
+        for i, out in enumerate(outputs):
+            out._capture_ref = (self._iter_idx, entry_idx, i, out.device)
+            if fed:
+                self._replay_data[entry_idx, i] = out.get()
+
+    def _finish_capture(self, res):
+        refs = [self._current_ref(val) if isinstance(val, DataNodeDebug) else None for val in res]
+        if self._trace is None or not refs or None in refs:
+            warnings.warn("The pipeline cannot be captured in the debug mode (e.g. it passes "
+                          "non-DALI data to the operators or returns it), the operators will be "
+                          "run eagerly.", RuntimeWarning)
+            self._trace = None
+            return
+        self._trace_outputs = refs
+        try:
+            self._graph_pipe = self._build_captured_graph()
+            # The graph runs the captured iteration once, so that the state of its operators
+            # (e.g. the random number generators) matches the eager ones.
+            self._run_captured_graph()
+        except Exception as e:
+            warnings.warn("Failed to build the pipeline captured in the debug mode, "
+                          f"the operators will be run eagerly: {e}", RuntimeWarning)
+            self._trace = None
+            self._graph_pipe = None
+
+    def _build_captured_graph(self):
+        """Builds a regular pipeline computing the outputs of the captured iteration."""
+        from nvidia.dali.external_source import external_source
+
+        # Only the calls contributing to the outputs are added (the external sources that are
+        # not used can't be fed).
+        needed = {ref[:2] for ref in self._trace_outputs}
+        for idx in reversed(range(len(self._trace))):
+            entry = self._trace[idx]
+            if not entry.fed and \
+                    any((idx, i) in needed for i in range(len(entry.output_devices))):
+                needed.update(ref[:2] for ref in entry.node_refs())
+
+        nodes = {}
+
+        def resolve(ref):
+            node = nodes[ref[:2]]
+            return node.gpu() if ref[2] == 'gpu' else node
+
+        pipe = _pipeline.Pipeline(**self._graph_kwargs)
+        self._graph_feeds = []
+        with pipe:
+            for idx, entry in enumerate(self._trace):
+                if entry.fed:
+                    for i, device in enumerate(entry.output_devices):
+                        if (idx, i) in needed:
+                            name = f'__debug_capture_{idx}_{i}'
+                            nodes[idx, i] = external_source(name=name, device=device)
+                            self._graph_feeds.append(((idx, i), name))
+                    continue
+                if not any((idx, i) in needed for i in range(len(entry.output_devices))):
+                    continue
+                op_manager = entry.op_manager
+                args, kwargs = entry.call_args
+                init_args = dict(op_manager._init_args)
+                inputs = [resolve(value) for kind, value in args if kind == 'node']
+                if op_manager._op_name == 'arithmetic_generic_op' and init_args['device'] == 'gpu':
+                    inputs = [input.gpu() for input in inputs]
+                call_args = {}
+                for key, (kind, value) in kwargs.items():
+                    if kind == 'node':
+                        call_args[key] = resolve(value)
+                    elif key not in init_args:
+                        # Constant arrays are passed to the eager operators as batches.
+                        init_args[key] = value
+                outputs = op_manager._op_class(**init_args)(*inputs, **call_args)
+                outputs = outputs if isinstance(outputs, list) else [outputs]
+                for i, output in enumerate(outputs):
+                    nodes[idx, i] = output
+            pipe.set_outputs(*[resolve(ref) for ref in self._trace_outputs])
+        pipe.build()
+        return pipe
+
+    def _start_replay(self):
+        self._replaying = self._graph_pipe is not None
+        self._replay_pos = 0
+        self._replay_diverged = False
+        self._replay_fallback = False
+        self._replay_data = {}
+
+    def _next_trace_entry(self, key):
+        """Returns the recorded counterpart of the current call or None, if the iteration
+        diverged."""
+        pos = self._replay_pos
+        self._replay_pos += 1
+        if self._replay_diverged or pos >= len(self._trace) or self._trace[pos].key != key:
+            self._replay_diverged = True
+            return None
+        return self._trace[pos]
+
+    def _replay_fed_call(self, key, data):
+        """Marks the outputs of an external source or an operator without inputs, run eagerly,
+        to be fed to the captured graph."""
+        outputs = data if isinstance(data, list) else [data]
+        entry = self._next_trace_entry(key)
+        if entry is None or not entry.fed or \
+                entry.output_devices != [getattr(out, 'device', None) for out in outputs]:
+            self._replay_diverged = True
+            return
+        entry_idx = self._replay_pos - 1
+        for i, out in enumerate(outputs):
+            out._capture_ref = (self._iter_idx, entry_idx, i, out.device)
+            self._replay_data[entry_idx, i] = out.get()
+
+    def _replay_op_call(self, key, op_manager, inputs, op_inputs, kwargs):
+        entry = self._next_trace_entry(key)
+        call_args = None
+        if entry is not None and not entry.fed:
+            call_args = self._describe_call_args(op_manager, inputs, kwargs)
+        if call_args is None or not _same_call_args(call_args, entry.call_args):
+            self._replay_diverged = True
+            return self._run_op(op_manager, op_inputs, kwargs)
+
+        entry_idx = self._replay_pos - 1
+        call = _DeferredOpCall(self, op_manager, op_inputs, kwargs)
+        outputs = []
+        for i, device in enumerate(entry.output_devices):
+            node = DataNodeDebug(None, op_manager._op_name, device, op_manager,
+                                 lambda i=i: call.output(i))
+            node._capture_ref = (self._iter_idx, entry_idx, i, device)
+            outputs.append(node)
+        return outputs[0] if len(outputs) == 1 else outputs
+
+    def _finish_replay(self, res):
+        """Runs the captured graph, if the iteration matched the captured one. Returns the outputs
+        or None, if the iteration has to be computed eagerly."""
+        if self._replay_diverged or self._replay_fallback or self._replay_pos != len(self._trace):
+            return None
+        refs = [self._current_ref(val) if isinstance(val, DataNodeDebug) else None for val in res]
+        if refs != self._trace_outputs:
+            return None
+        return self._run_captured_graph()
+
+    def _run_captured_graph(self):
+        for ref, name in self._graph_feeds:
+            self._graph_pipe.feed_input(name, self._replay_data[ref])
+        return tuple(self._graph_pipe.run())
@@ -79,6 +79,7 @@ class ShmChunkManager:
             [self.allocate_chunk(self.initial_chunk_capacity) for _ in range(self.num_minibatches)]
             for _ in range(self.queue_depth)]
         self.chunks_ids = [chunk_id for dest_buf in self.chunks_ids_by_pos for chunk_id in dest_buf]
+        self.pinned = False
 
     def allocate_chunk(self, capacity):
         chunk_id = len(self.shm_pool)
@@ -86,6 +87,13 @@ class ShmChunkManager:
         self.shm_pool.append(chunk)
         return chunk_id
 
+    def pin_chunks(self, device_id):
+        """Registers the chunks as pinned memory, so that the batches can be copied to the GPU
+        without staging them in another pinned buffer"""
+        for chunk in self.get_chunks():
+            chunk.pin(device_id)
+        self.pinned = True
+
     def close_handles(self):
         for shm_chunk_id in self.chunks_ids:
             self.shm_pool[shm_chunk_id].close_handle()
@@ -564,7 +572,7 @@ class WorkerPool:
     @classmethod
     def from_groups(
             cls, groups, keep_alive_queue_size, start_method="fork", num_workers=1,
-            initial_chunk_size=1024 * 1024, py_callback_pickler=None):
+            initial_chunk_size=1024 * 1024, py_callback_pickler=None, pin_device_id=None):
         """Creates new WorkerPool instance for given list of ExternalSource groups.
 
         Parameters
@@ -582,6 +590,10 @@ class WorkerPool:
             Number of workers to be created in ProcPool.
         `initial_chunk_size` : int
             Minimal initial size of each shared memory chunk, NOTE it must be enough to accommodate serialized `ScheduledTask` instance.
+        `pin_device_id` : int, optional
+            If specified, the shared memory chunks are registered as pinned memory (with the device
+            current), so that the batches can be passed to the pipeline without copying them
+            to pinned buffers. It is done in the main process only, once the workers are started.
         """
         import_numpy()
         if len(groups) == 0:
@@ -623,6 +635,9 @@ class WorkerPool:
             # passed to the workers processes
             for context in contexts:
                 context.shm_manager.close_handles()
+            if pin_device_id is not None:
+                for context in contexts:
+                    context.shm_manager.pin_chunks(pin_device_id)
             return cls(contexts, pool)
         except:
             if pool is not None:
@@ -732,6 +747,10 @@ class WorkerPool:
         res = context.take_processed(scheduled_i)
         return res
 
+    def is_pinned(self, context_i):
+        """Whether the batches of the ``context_i``th callback are placed in pinned memory."""
+        return self.contexts[context_i].shm_manager.pinned
+
     def _receive_chunk(self):
         completed_tasks_meta = self.pool.wait_for_res()
         if completed_tasks_meta is None:
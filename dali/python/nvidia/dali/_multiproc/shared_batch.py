@@ -1,4 +1,4 @@
-# Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -85,6 +85,9 @@ class BufShmChunk:
         self._shm_chunk.resize(size, trunc)
         self.capacity = size
 
+    def pin(self, device_id=None):
+        self._shm_chunk.pin(device_id)
+
     def close(self):
         self._shm_chunk.close()
 
@@ -99,6 +102,10 @@ class BufShmChunk:
     def buf(self):
         return self._shm_chunk.buf
 
+    @property
+    def is_pinned(self):
+        return self._shm_chunk is not None and self._shm_chunk.is_pinned
+
 
 class SampleMeta:
     """Metadata describing serialized sample in a memory buffer.
@@ -1,4 +1,4 @@
-# Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -97,6 +97,22 @@ class SharedMem:
         self.shm.resize(size, trunc)
         self.capacity = size
 
+    def pin(self, device_id=None):
+        """Registers the mapped memory with CUDA as page-locked (pinned), so that it can be copied
+        to the GPU directly, without staging it in another pinned buffer. The memory stays pinned
+        when the chunk is resized and is unregistered when it is closed.
+
+        Parameters
+        ----------
+        `device_id` : int, optional
+            Device to be current when registering the memory. None keeps the current device.
+        """
+        self.shm.set_pinned(True, -1 if device_id is None else device_id)
+
+    @property
+    def is_pinned(self):
+        return self.shm.is_pinned
+
     def close(self):
         """Removes maping of the memory into process address space and closes related handle.
         If all processes sharing given chunk close it, it will be automatically released by the OS.
@@ -0,0 +1,81 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Conditional execution of the parts of a pipeline, evaluated per sample."""
+
+from nvidia.dali.data_node import DataNode as _DataNode
+
+
+def _as_list(outputs):
+    if isinstance(outputs, (list, tuple)):
+        return list(outputs), type(outputs)
+    return [outputs], None
+
+
+def if_else(predicate, true_fn, false_fn, *inputs):
+    """Runs ``true_fn`` on the samples for which ``predicate`` is true and ``false_fn`` on the rest.
+
+    The ``inputs`` are split into two batches: the samples with a true predicate and the
+    remaining ones. Each branch function is called with its part of the inputs and the operators
+    which it adds to the pipeline run only on the samples routed to it. A branch which receives
+    no samples in an iteration is not run at all. The outputs of the branches are merged back
+    into full batches, in the original order of the samples.
+
+    Both branches must return the same number of outputs, and the corresponding outputs must
+    have the same type, dimensionality and layout. If one of them is on the GPU, the other one
+    is moved there as well.
+
+    The operators without any inputs (e.g. the random number generators) produce the full batch,
+    so they cannot be used inside the branches - their results should be computed beforehand
+    and passed to the branches as ``inputs``.
+
+    Args:
+        predicate: A CPU batch of per-sample boolean or integral scalars, e.g. the result of
+            ``fn.random.coin_flip()`` or of a comparison like ``labels == 0``.
+        true_fn: A function which gets the samples with a true predicate of each of ``inputs``
+            and returns the branch output (a ``DataNode``, or a list or a tuple of them).
+        false_fn: Like ``true_fn``, for the samples with a false predicate.
+        *inputs: The batches to split between the branches.
+
+    Returns:
+        The merged outputs, in the same structure as returned by the branch functions.
+    """
+    from nvidia.dali import fn
+
+    if not isinstance(predicate, _DataNode):
+        raise TypeError("The predicate must be a DataNode - a per-sample batch of scalars.")
+    if predicate.device != "cpu":
+        raise ValueError("The predicate must be a CPU batch.")
+
+    true_inputs = []
+    false_inputs = []
+    for input in inputs:
+        true_part, false_part = fn._conditional.split(input, predicate=predicate)
+        true_inputs.append(true_part)
+        false_inputs.append(false_part)
+
+    true_outputs, seq_type = _as_list(true_fn(*true_inputs))
+    false_outputs, _ = _as_list(false_fn(*false_inputs))
+    if len(true_outputs) != len(false_outputs):
+        raise ValueError("Both branches must return the same number of outputs. Got {} and {}."
+                         .format(len(true_outputs), len(false_outputs)))
+
+    merged = []
+    for true_out, false_out in zip(true_outputs, false_outputs):
+        if true_out.device == "cpu" and false_out.device == "gpu":
+            true_out = true_out.gpu()
+        elif true_out.device == "gpu" and false_out.device == "cpu":
+            false_out = false_out.gpu()
+        merged.append(fn._conditional.merge(true_out, false_out, predicate=predicate))
+    return seq_type(merged) if seq_type is not None else merged[0]
@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import contextlib
 import sys
 
 from nvidia.dali import backend as _b
@@ -60,6 +61,42 @@ _generator_operators = {
 _stateless_operators_cache = {}
 
 
+# Depth of the nested `no_sync` blocks.
+_no_sync_depth = 0
+
+
+@contextlib.contextmanager
+def no_sync():
+    """Context manager running the GPU and mixed eager operators without waiting for their
+    work to complete.
+
+    The operators issue the work to a CUDA stream shared by all the eager operators, so their
+    outputs can be passed directly to other GPU and mixed eager operators, without a host
+    synchronization after each operator. The work is waited for at the exit of the outermost
+    ``no_sync`` block. The blocks can be nested.
+
+    .. warning::
+        The outputs of GPU and mixed operators run in the block must not be accessed by the
+        host (e.g. copied with ``as_cpu``) before the outermost block exits.
+
+    Example::
+
+        with eager.no_sync():
+            images = eager.decoders.image(jpegs, device='mixed')
+            images = eager.resize(images, resize_x=224, resize_y=224)
+        # here `images` are ready
+    """
+    global _no_sync_depth
+    _no_sync_depth += 1
+    try:
+        yield
+    finally:
+        _no_sync_depth -= 1
+        if _no_sync_depth == 0:
+            _b.EagerOperatorMixed.synchronize_shared_stream()
+            _b.EagerOperatorGPU.synchronize_shared_stream()
+
+
 def _eager_op_base_factory(op_class, op_name, num_inputs, call_args_names):
     class EagerOperatorBase(op_class):
         def __init__(self, *, max_batch_size, device_id, **kwargs):
@@ -91,7 +128,10 @@ def _stateless_op_factory(op_class, op_name, num_inputs, call_args_names):
     class EagerOperator(_eager_op_base_factory(op_class, op_name, num_inputs, call_args_names)):
         def __call__(self, inputs, kwargs):
             # Here all kwargs are supposed to be TensorLists.
-            output = self._backend_op(inputs, kwargs)
+            if self._device == 'cpu':
+                output = self._backend_op(inputs, kwargs)
+            else:
+                output = self._backend_op(inputs, kwargs, synchronize=_no_sync_depth == 0)
 
             if len(output) == 1:
                 return output[0]
@@ -263,3 +303,6 @@ def _wrap_eager_op(op_class, submodule, wrapper_name, wrapper_doc):
             wrapper.__module__ = op_module.__name__
 
         setattr(op_module, wrapper_name, wrapper)
+
+
+_internal.get_submodule(sys.modules[__name__], 'experimental').no_sync = no_sync
@@ -54,7 +54,7 @@ def _check_data_batch(data, batch_size, layout):
         if layout is not None and layout != "" and dim != len(layout):
             raise RuntimeError("The layout '{}' cannot describe {}-dimensional data".format(layout, dim))
 
-def _prep_data_for_feed_input(data, batch_size, layout, device_id = None):
+def _prep_data_for_feed_input(data, batch_size, layout, device_id = None, is_pinned = False):
     def to_numpy(x):
         if _types._is_mxnet_array(x):
             return x.asnumpy()
@@ -92,7 +92,7 @@ def _prep_data_for_feed_input(data, batch_size, layout, device_id = None):
                 inp = _tensors.TensorGPU(datum, layout or "", array_device_id)
             else:
                 datum = to_numpy(datum)
-                inp = _tensors.TensorCPU(datum, layout or "")
+                inp = _tensors.TensorCPU(datum, layout or "", is_pinned)
             inputs.append(inp)
         assert all(isinstance(inp, type(inputs[0])) for inp in inputs), \
             "Mixed input types are not support, all need to reside on the CPU or GPU"
@@ -113,19 +113,20 @@ def _prep_data_for_feed_input(data, batch_size, layout, device_id = None):
                 data = _tensors.TensorListCPU(data, layout or "")
         else:
             data = to_numpy(data)
-            data = _tensors.TensorListCPU(data, layout or "")
+            data = _tensors.TensorListCPU(data, layout or "", is_pinned)
     return data
 
 
 class _ExternalDataBatch:
-    def __init__(self, group, pipeline, data, batch_size):
+    def __init__(self, group, pipeline, data, batch_size, is_pinned=False):
         self._group = group
         self._pipepline = pipeline
         self._data = data
         self._batch_size = batch_size
+        self._is_pinned = is_pinned
 
     def feed(self):
-        self._group.feed(self._pipepline, self._data, self._batch_size)
+        self._group.feed(self._pipepline, self._data, self._batch_size, self._is_pinned)
 
 class _ExternalSourceGroup(object):
     def __init__(
@@ -218,7 +219,8 @@ class _ExternalSourceGroup(object):
             self.current_sample += batch_size
             self.current_iter += 1
             self.prefetch(pool, context_i, batch_size, epoch_idx)
-            return _ExternalDataBatch(self, pipeline, callback_out, batch_size)
+            return _ExternalDataBatch(self, pipeline, callback_out, batch_size,
+                                      pool.is_pinned(context_i))
         except StopIteration:
             self.reset_indices()
             pool.reset_context(context_i)
@@ -239,9 +241,10 @@ class _ExternalSourceGroup(object):
             raise
         return _ExternalDataBatch(self, pipeline, callback_out, batch_size)
 
-    def feed(self, pipeline, callback_out, batch_size):
+    def feed(self, pipeline, callback_out, batch_size, is_pinned=False):
         """Feed the `callback_out` data obtained from source to the ExternalSource nodes
-        in the `pipeline`"""
+        in the `pipeline`. `is_pinned` tells that the NumPy arrays in `callback_out` are views
+        of pinned memory (the shared memory of the parallel workers)"""
         if self.is_multioutput:
             for op in self.instances:
                 if self.batch:
@@ -249,11 +252,13 @@ class _ExternalSourceGroup(object):
                 else:
                     # extract a single output
                     data = [callback_out[i][op._output_index] for i in range(batch_size)]
-                pipeline._feed_input(op._name, data, op._layout, self._cuda_stream, self.use_copy_kernel)
+                pipeline._feed_input(op._name, data, op._layout, self._cuda_stream,
+                                     self.use_copy_kernel, is_pinned)
         else:
             data = callback_out
             op = self.instances[0]
-            pipeline._feed_input(op._name, data, op._layout, self._cuda_stream, self.use_copy_kernel)
+            pipeline._feed_input(op._name, data, op._layout, self._cuda_stream,
+                                 self.use_copy_kernel, is_pinned)
 
 
 class ExternalSource():
@@ -0,0 +1,293 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Materialization of the deterministic beginning of the processing.
+
+The leading part of a pipeline which gives the same results in every epoch (e.g. decoding and
+resizing to a fixed size) can be run once, by a separate pipeline, and its outputs stored on
+the disk. The later epochs read them from there, at the cost of the space needed for the
+processed samples::
+
+    @pipeline_def(batch_size=64, num_threads=8, device_id=None)
+    def prefix():
+        jpegs, labels = fn.readers.file(file_root=images_dir, name="Reader")
+        images = fn.decoders.image(jpegs, device="cpu")
+        return fn.resize(images, resize_shorter=256), labels
+
+    @pipeline_def(batch_size=64, num_threads=4, device_id=0)
+    def train_pipe():
+        images, labels = materialize.cached(prefix(), "/cache/train", reader_name="Reader",
+                                            shuffle=True)
+        images = fn.random_resized_crop(images.gpu(), size=[224, 224])
+        return images, labels
+
+The stored outputs are memory-mapped when read, so that the samples come from the page cache
+when it can hold the dataset.
+"""
+
+import json
+import os
+import shutil
+
+import numpy as np
+
+from nvidia.dali import fn
+from nvidia.dali import tensors as _tensors
+from nvidia.dali.ops import _schema_name
+from nvidia.dali.pipeline import Pipeline
+
+_format_version = 1
+_meta_file = "meta.json"
+
+# the operators, whose results differ between the epochs
+_random_schemas = {
+    "CoinFlip", "Uniform", "NormalDistribution", "Jitter", "RandomResizedCrop",
+    "RandomResizedCropMirrorNormalize", "RandomBBoxCrop", "SSDRandomCrop", "ROIRandomCrop",
+    "RandomCropAttr", "ImageDecoderRandomCrop", "decoders__ImageRandomCrop", "PythonFunction",
+    "TorchPythonFunction", "DLTensorPythonFunction", "NumbaFunction",
+}
+_random_prefixes = ("random__", "noise__", "segmentation__Random")
+
+
+def _data_file(path, output_idx):
+    return os.path.join(path, f"output_{output_idx}.bin")
+
+
+def _index_file(path, output_idx):
+    return os.path.join(path, f"output_{output_idx}.idx.npy")
+
+
+def _random_operators(pipeline):
+    if not pipeline._py_graph_built:
+        pipeline._build_graph()
+    names = set()
+    for op in pipeline._ops:
+        schema = _schema_name(type(op._op))
+        if schema in _random_schemas or schema.startswith(_random_prefixes):
+            names.add(schema)
+    return sorted(names)
+
+
+def _num_samples(pipeline, reader_name):
+    if reader_name is None:
+        return None
+    meta = pipeline.reader_meta(reader_name)
+    if meta["number_of_shards"] != 1:
+        raise ValueError("The materialized pipeline must read the whole dataset - the shards "
+                         "are selected when reading the stored outputs.")
+    return meta["epoch_size"]
+
+
+def write(pipeline, path, reader_name=None, allow_random=False):
+    """Runs one epoch of `pipeline` and stores its outputs in the directory `path`.
+
+    Parameters
+    ----------
+    `pipeline` : :class:`Pipeline`
+        The pipeline computing the deterministic part of the processing. Its outputs must reside
+        in the CPU memory. It's processed until the end of the epoch of `reader_name` or,
+        without a reader, until it raises ``StopIteration``.
+    `path` : str
+        The directory to store the outputs in. It's written only after all the outputs are
+        computed, so an interrupted run doesn't leave an incomplete cache there.
+    `reader_name` : str, optional
+        The name of the reader, which defines the epoch. The reader must not be sharded.
+    `allow_random` : bool, optional, default = False
+        Allows the random operators in `pipeline`, whose results would be frozen in the stored
+        outputs. By default, such a pipeline is rejected.
+
+    Returns
+    -------
+    The number of the stored samples.
+    """
+    random_ops = _random_operators(pipeline)
+    if random_ops and not allow_random:
+        raise ValueError(
+            "The materialized pipeline should be deterministic, but it contains the random "
+            f"operators: {', '.join(random_ops)}. Move them to the pipeline which reads "
+            "the stored outputs or pass `allow_random=True`.")
+    pipeline.build()
+    num_samples = _num_samples(pipeline, reader_name)
+
+    tmp_path = path.rstrip(os.sep) + ".tmp"
+    if os.path.exists(tmp_path):
+        shutil.rmtree(tmp_path)
+    os.makedirs(tmp_path)
+    data_files = []
+    indices = []
+    outputs_meta = None
+    written = 0
+    try:
+        while num_samples is None or written < num_samples:
+            try:
+                outputs = pipeline.run()
+            except StopIteration:
+                break
+            if outputs_meta is None:
+                outputs_meta = []
+                for i, out in enumerate(outputs):
+                    outputs_meta.append({"dtype": None, "layout": out.layout(), "ndim": None})
+                    data_files.append(open(_data_file(tmp_path, i), "wb"))
+                    indices.append([])
+            count = len(outputs[0])
+            if num_samples is not None:
+                count = min(count, num_samples - written)
+            for out_meta, out, data_file, index in zip(outputs_meta, outputs, data_files,
+                                                      indices):
+                if not isinstance(out, _tensors.TensorListCPU):
+                    raise RuntimeError(
+                        "The outputs of the materialized pipeline must reside in the CPU memory.")
+                for s in range(count):
+                    sample = np.asarray(out[s])
+                    if out_meta["dtype"] is None:
+                        out_meta["dtype"] = sample.dtype.str
+                        out_meta["ndim"] = sample.ndim
+                    index.append((data_file.tell(),) + sample.shape)
+                    data_file.write(np.ascontiguousarray(sample).data)
+            written += count
+    finally:
+        for data_file in data_files:
+            data_file.close()
+    if outputs_meta is None:
+        shutil.rmtree(tmp_path)
+        raise RuntimeError("The materialized pipeline didn't produce any samples.")
+
+    for i, index in enumerate(indices):
+        np.save(_index_file(tmp_path, i), np.array(index, dtype=np.int64).reshape(written, -1))
+    with open(os.path.join(tmp_path, _meta_file), "w") as f:
+        json.dump({"version": _format_version, "num_samples": written,
+                   "outputs": outputs_meta}, f)
+    if os.path.exists(path):
+        shutil.rmtree(path)
+    os.rename(tmp_path, path)
+    return written
+
+
+def _read_meta(path):
+    with open(os.path.join(path, _meta_file)) as f:
+        meta = json.load(f)
+    if meta.get("version") != _format_version:
+        raise RuntimeError(f"Unsupported version of the materialized outputs in \"{path}\".")
+    return meta
+
+
+class _StoredSource:
+    """Produces the batches of the stored outputs of one shard.
+
+    The files are mapped by the process which calls it, so the source can be passed
+    to the parallel external source workers."""
+
+    def __init__(self, path, batch_size, shuffle, seed, shard_id, num_shards):
+        meta = _read_meta(path)
+        self._path = path
+        self._num_outputs = len(meta["outputs"])
+        self._dtypes = [np.dtype(out["dtype"]) for out in meta["outputs"]]
+        self._batch_size = batch_size
+        self._shuffle = shuffle
+        self._seed = seed
+        num_samples = meta["num_samples"]
+        self._begin = num_samples * shard_id // num_shards
+        self._end = num_samples * (shard_id + 1) // num_shards
+        self._data = None
+        self._order_epoch = None
+
+    def __getstate__(self):
+        state = self.__dict__.copy()
+        state["_data"] = None
+        state["_order_epoch"] = None
+        return state
+
+    def _map(self):
+        self._data = [np.memmap(_data_file(self._path, i), dtype=np.uint8, mode="r")
+                      if os.path.getsize(_data_file(self._path, i)) else np.empty(0, np.uint8)
+                      for i in range(self._num_outputs)]
+        self._indices = [np.load(_index_file(self._path, i)) for i in range(self._num_outputs)]
+
+    def _sample_order(self, epoch_idx):
+        if self._order_epoch != epoch_idx:
+            order = np.arange(self._begin, self._end)
+            if self._shuffle:
+                np.random.default_rng((self._seed, epoch_idx)).shuffle(order)
+            self._order = order
+            self._order_epoch = epoch_idx
+        return self._order
+
+    def _sample(self, output_idx, sample_idx):
+        entry = self._indices[output_idx][sample_idx]
+        dtype = self._dtypes[output_idx]
+        shape = tuple(entry[1:])
+        size = int(np.prod(shape)) * dtype.itemsize
+        return self._data[output_idx][entry[0]:entry[0] + size].view(dtype).reshape(shape)
+
+    def __call__(self, batch_info):
+        if self._data is None:
+            self._map()
+        begin = batch_info.iteration * self._batch_size
+        order = self._sample_order(batch_info.epoch_idx)
+        if begin >= len(order):
+            raise StopIteration
+        samples = order[begin:begin + self._batch_size]
+        return tuple([self._sample(i, s) for s in samples] for i in range(self._num_outputs))
+
+
+def read(path, shuffle=False, seed=0, shard_id=0, num_shards=1, parallel=False, **kwargs):
+    """Returns the outputs stored by :func:`write`.
+
+    An epoch covers the samples of the shard `shard_id` once. The last batch of the epoch can
+    be partial.
+
+    Parameters
+    ----------
+    `path` : str
+        The directory with the stored outputs.
+    `shuffle` : bool, optional, default = False
+        Reads the samples in a different random order in each epoch.
+    `seed` : int, optional, default = 0
+        The seed of the order of the samples, when `shuffle` is set.
+    `shard_id` : int, optional, default = 0
+        The index of the shard to read.
+    `num_shards` : int, optional, default = 1
+        The number of the shards, into which the stored samples are divided.
+    `parallel` : bool, optional, default = False
+        Reads the samples in the worker processes of the pipeline, see ``py_num_workers``
+        in :class:`Pipeline`.
+    `**kwargs`
+        Other arguments of :meth:`nvidia.dali.fn.external_source`.
+
+    Returns
+    -------
+    A list of :class:`DataNode` objects - one for each stored output.
+    """
+    if not 0 <= shard_id < num_shards:
+        raise ValueError(f"Invalid shard {shard_id} of {num_shards}.")
+    pipe = Pipeline.current()
+    if pipe is None:
+        raise RuntimeError("The stored outputs can be read only in a pipeline definition.")
+    source = _StoredSource(path, pipe.max_batch_size, shuffle, seed, shard_id, num_shards)
+    layouts = [out["layout"] for out in _read_meta(path)["outputs"]]
+    outputs = fn.external_source(source=source, num_outputs=len(layouts), batch=True,
+                                 batch_info=True, layout=layouts, parallel=parallel, **kwargs)
+    return list(outputs)
+
+
+def cached(pipeline, path, reader_name=None, allow_random=False, **kwargs):
+    """Returns the outputs of `pipeline`, stored in `path`.
+
+    If `path` doesn't contain the stored outputs yet, they're computed with :func:`write`
+    first. The arguments `pipeline`, `reader_name` and `allow_random` are used only then.
+    The remaining arguments are passed to :func:`read`.
+    """
+    if not os.path.exists(os.path.join(path, _meta_file)):
+        write(pipeline, path, reader_name, allow_random)
+    return read(path, **kwargs)
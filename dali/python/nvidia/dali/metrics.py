@@ -0,0 +1,285 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Publishes the metrics of long-running pipelines in the Prometheus text format."""
+
+import threading
+from http.server import BaseHTTPRequestHandler, HTTPServer
+from socketserver import ThreadingMixIn
+
+from nvidia.dali import backend as _b
+
+_CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8"
+
+_OPERATOR_METRICS = [
+    ("operator_runs_total", "counter", "num_runs",
+     "Number of iterations in which the operator ran."),
+    ("operator_samples_total", "counter", "num_samples",
+     "Number of samples processed by the operator."),
+    ("operator_host_seconds_total", "counter", "host_time",
+     "Wall time of the operator in the executor thread."),
+    ("operator_gpu_runs_total", "counter", "num_gpu_runs",
+     "Number of runs of the operator with the device time measured."),
+    ("operator_gpu_seconds_total", "counter", "gpu_time",
+     "Time of the work of the operator in the CUDA stream."),
+]
+
+_STAGE_METRICS = [
+    ("stage_iterations_total", "counter", "num_iterations",
+     "Number of iterations of the executor stage."),
+    ("stage_samples_total", "counter", "num_samples",
+     "Number of samples processed by the executor stage."),
+    ("stage_host_seconds_total", "counter", "host_time",
+     "Time the executor stage spent on the iterations."),
+    ("stage_wait_seconds_total", "counter", "wait_time",
+     "Time the executor stage waited for the input batches and the free buffers."),
+    ("stage_producer_wait_seconds_total", "counter", "producer_wait",
+     "Time the executor stage waited for a free buffer of the queue after it."),
+    ("stage_consumer_wait_seconds_total", "counter", "consumer_wait",
+     "Time the consumer of the queue after the executor stage waited for a batch."),
+    ("stage_queue_occupancy_mean", "gauge", "mean_queue_occupancy",
+     "Mean number of batches ready in the prefetch queue after the stage."),
+    ("stage_queue_occupancy_max", "gauge", "max_queue_occupancy",
+     "Maximum number of batches ready in the prefetch queue after the stage."),
+    ("stage_allocations_total", "counter", "num_allocations",
+     "Number of heap allocations made by the executor stage, if counted by the build."),
+]
+
+_POOL_METRICS = [
+    ("memory_pool_reserved_bytes", "gauge", "reserved_bytes",
+     "Memory obtained by the pool from the upstream resource."),
+    ("memory_pool_peak_reserved_bytes", "gauge", "peak_reserved_bytes",
+     "Peak memory obtained by the pool from the upstream resource."),
+    ("memory_pool_allocated_bytes", "gauge", "allocated_bytes",
+     "Memory allocated from the pool."),
+    ("memory_pool_peak_allocated_bytes", "gauge", "peak_allocated_bytes",
+     "Peak memory allocated from the pool."),
+    ("memory_pool_free_bytes", "gauge", "free_bytes",
+     "Memory held by the pool and not allocated."),
+    ("memory_pool_fragmentation", "gauge", "fragmentation",
+     "Fragmentation of the free memory of the pool, from 0 to 1."),
+]
+
+# the diagnostics of the decoders counting the samples decoded with each of the paths
+# (e.g. nsamples_hw, nsamples_cuda - the hybrid decoding, nsamples_host)
+_DECODER_COUNTER_PREFIX = "nsamples_"
+
+
+def _escape(value):
+    return str(value).replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n")
+
+
+class _Metrics:
+    """Groups the samples by the metric, as the text format requires."""
+
+    def __init__(self, prefix):
+        self._prefix = prefix
+        self._metrics = {}
+
+    def add(self, name, metric_type, help_text, labels, value):
+        name = f"{self._prefix}_{name}" if self._prefix else name
+        if name not in self._metrics:
+            self._metrics[name] = (metric_type, help_text, [])
+        self._metrics[name][2].append((labels, value))
+
+    def text(self):
+        lines = []
+        for name, (metric_type, help_text, samples) in self._metrics.items():
+            lines.append(f"# HELP {name} {help_text}")
+            lines.append(f"# TYPE {name} {metric_type}")
+            for labels, value in samples:
+                label_str = ",".join(f"{k}=\"{_escape(v)}\"" for k, v in labels.items())
+                lines.append(f"{name}{{{label_str}}} {float(value)!r}")
+        return "\n".join(lines) + "\n"
+
+
+def _named_pipelines(pipelines):
+    if isinstance(pipelines, dict):
+        return list(pipelines.items())
+    if not isinstance(pipelines, (list, tuple)):
+        pipelines = [pipelines]
+    return [(str(i), pipe) for i, pipe in enumerate(pipelines)]
+
+
+def _add_pipeline_metrics(metrics, name, pipe):
+    timing = pipe.operator_timing() if pipe.enable_operator_timing else None
+    if timing is not None:
+        for op_key, op in timing["operators"].items():
+            labels = {"pipeline": name, "operator": op_key}
+            for metric, metric_type, key, help_text in _OPERATOR_METRICS:
+                metrics.add(metric, metric_type, help_text, labels, op[key])
+        for stage, stats in timing["stages"].items():
+            labels = {"pipeline": name, "stage": stage}
+            for metric, metric_type, key, help_text in _STAGE_METRICS:
+                metrics.add(metric, metric_type, help_text, labels, stats[key])
+        for part, fraction in timing["bottleneck"].items():
+            metrics.add("pipeline_limiter_ratio", "gauge",
+                        "Fraction of the time for which the stage or the consumer was the limiter.",
+                        {"pipeline": name, "part": part}, fraction)
+        metrics.add("pipeline_elapsed_seconds", "gauge",
+                    "Time since the first iteration of the pipeline.", {"pipeline": name},
+                    timing["elapsed_time"])
+
+    for reader, meta in pipe.reader_meta().items():
+        labels = {"pipeline": name, "reader": reader}
+        metrics.add("reader_epoch_size", "gauge", "Number of samples in the epoch of the reader.",
+                    labels, meta["epoch_size"])
+        # the readers run on the CPU - their timing has the key of a CPU operator
+        op = timing["operators"].get("CPU_" + reader) if timing is not None else None
+        if op is not None:
+            metrics.add("reader_samples_total", "counter", "Number of samples read.", labels,
+                        op["num_samples"])
+
+    for op_name, diagnostics in pipe._pipe.operator_diagnostics().items():
+        for key, value in diagnostics.items():
+            if key.startswith(_DECODER_COUNTER_PREFIX):
+                labels = {"pipeline": name, "operator": op_name,
+                          "path": key[len(_DECODER_COUNTER_PREFIX):]}
+                metrics.add("decoder_samples_total", "counter",
+                            "Number of samples decoded with each of the decoding paths.",
+                            labels, value)
+            else:
+                labels = {"pipeline": name, "operator": op_name, "name": key}
+                metrics.add("operator_diagnostic", "gauge", "Diagnostic value of an operator.",
+                            labels, value)
+
+
+def _add_pool_metrics(metrics, device_ids):
+    for kind in ("device", "pinned"):
+        for device_id in device_ids:
+            stats = _b.GetMemoryPoolStats(kind, device_id)
+            if stats is None:
+                continue
+            labels = {"kind": kind, "device": device_id}
+            for metric, metric_type, key, help_text in _POOL_METRICS:
+                metrics.add(metric, metric_type, help_text, labels, stats[key])
+
+
+def metrics_text(pipelines, prefix="dali"):
+    """Returns the current metrics of the pipelines in the Prometheus text format.
+
+    The text can be published with :class:`MetricsExporter` or pushed to a collector
+    by the application.
+
+    Parameters
+    ----------
+    `pipelines` : :class:`Pipeline`, list of :class:`Pipeline` or dict
+        The pipelines to report - in a dictionary, the keys are used as the values of
+        the ``pipeline`` label; otherwise, the indices are used.
+    `prefix` : str, optional, default = "dali"
+        The prefix of the names of the metrics.
+    """
+    metrics = _Metrics(prefix)
+    device_ids = []
+    for name, pipe in _named_pipelines(pipelines):
+        if not pipe._built:
+            continue
+        _add_pipeline_metrics(metrics, name, pipe)
+        if pipe.device_id is not None and pipe.device_id not in device_ids:
+            device_ids.append(pipe.device_id)
+    _add_pool_metrics(metrics, device_ids)
+    return metrics.text()
+
+
+class _ThreadingHTTPServer(ThreadingMixIn, HTTPServer):
+    daemon_threads = True
+
+
+class MetricsExporter:
+    """Serves the metrics of the pipelines (see :func:`metrics_text`) at the ``/metrics``
+    endpoint, to be scraped by Prometheus or an OpenTelemetry collector with
+    the Prometheus receiver.
+
+    The metrics include the time of the operators and the executor stages, the fill level of
+    the prefetch queues and the time the stages waited for them (with
+    ``enable_operator_timing=True``), the number of samples read by the readers and decoded with
+    each of the decoder paths (hardware, CUDA, host), and the usage of the memory pools.
+    They are gathered when the endpoint is queried, in the thread of the HTTP server, so
+    the exporter adds no work to the pipelines between the queries::
+
+        pipe = my_pipeline(enable_operator_timing=True)
+        pipe.build()
+        exporter = MetricsExporter({"train": pipe}, port=9100)
+        exporter.start()
+
+    Parameters
+    ----------
+    `pipelines` : :class:`Pipeline`, list of :class:`Pipeline` or dict
+        The pipelines to report, see :func:`metrics_text`.
+    `port` : int, optional, default = 8000
+        The port of the HTTP server; 0 selects a free port, see :attr:`port`.
+    `addr` : str, optional, default = ""
+        The address the server listens on; by default, all the interfaces.
+    `prefix` : str, optional, default = "dali"
+        The prefix of the names of the metrics.
+    """
+
+    def __init__(self, pipelines, port=8000, addr="", prefix="dali"):
+        self._pipelines = pipelines
+        self._address = (addr, port)
+        self._prefix = prefix
+        self._server = None
+        self._thread = None
+
+    @property
+    def port(self):
+        """The port the server listens on, once started."""
+        return self._server.server_address[1] if self._server else self._address[1]
+
+    def start(self):
+        """Starts the HTTP server in a daemon thread."""
+        if self._server is not None:
+            return
+        exporter = self
+
+        class Handler(BaseHTTPRequestHandler):
+            def do_GET(self):
+                if self.path.split("?")[0] != "/metrics":
+                    self.send_error(404)
+                    return
+                try:
+                    body = metrics_text(exporter._pipelines, exporter._prefix).encode("utf-8")
+                except Exception as e:
+                    self.send_error(500, str(e))
+                    return
+                self.send_response(200)
+                self.send_header("Content-Type", _CONTENT_TYPE)
+                self.send_header("Content-Length", str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+            def log_message(self, format, *args):
+                pass
+
+        self._server = _ThreadingHTTPServer(self._address, Handler)
+        self._thread = threading.Thread(target=self._server.serve_forever,
+                                        name="DALI metrics exporter", daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        """Stops the HTTP server."""
+        if self._server is None:
+            return
+        self._server.shutdown()
+        self._server.server_close()
+        self._thread.join()
+        self._server = None
+        self._thread = None
+
+    def __enter__(self):
+        self.start()
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.stop()
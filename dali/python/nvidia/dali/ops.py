@@ -441,7 +441,7 @@ class _OperatorInstance(object):
 
                 _check_arg_input(op._schema, type(self._op).__name__, k)
 
-                self._spec.AddArgumentInput(k, arg_inp.name)
+                self._spec.AddArgumentInput(k, arg_inp.name, arg_inp.device)
                 self._inputs = list(self._inputs) + [arg_inp]
 
         if self._op.schema.IsDeprecated():
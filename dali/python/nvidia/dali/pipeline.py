@@ -26,6 +26,7 @@ import inspect
 import warnings
 import weakref
 import ctypes
+import os
 import sys
 
 pipeline_tls = tls()
@@ -105,7 +106,9 @@ Parameters
     This parameter is currently unused (and behavior of
     unrestricted number of streams is assumed).
 `default_cuda_stream_priority` : int, optional, default = 0
-    CUDA stream priority used by DALI. See `cudaStreamCreateWithPriority` in CUDA documentation
+    CUDA stream priority used by DALI. See `cudaStreamCreateWithPriority` in CUDA documentation.
+    The priority applies to all the streams of the pipeline: the executor streams and the
+    internal streams of the operators (e.g. the decoders and the GPU readers).
 `enable_memory_stats`: bool, optional, default = 1
     If DALI should print operator output buffer statistics.
     Usefull for `bytes_per_sample_hint` operator parameter.
@@ -170,6 +173,113 @@ Parameters
 
     If the ``output_ndim`` value is a single value (not a list), it will be broadcast to the
     number of outputs from the pipeline.
+`exec_dynamic` : bool, optional, default = False
+    Whether to schedule the operators as a dependency graph instead of running the CPU, mixed
+    and GPU stages one after another. Independent branches of the pipeline are processed
+    concurrently and the GPU operators on independent branches use separate CUDA streams
+    (at most `max_streams`, if positive). Separated prefetch queues are not supported in this mode.
+`max_prefetch_queue_depth` : int or {"cpu_size": int, "gpu_size": int}, optional, default = None
+    If set, the depth of the prefetch queues is adjusted at runtime, based on how long the
+    pipeline stages wait for each other. The queues start with the `prefetch_queue_depth` and
+    grow (up to this value) when the consumer of a queue keeps waiting for the data, or shrink
+    when the producer keeps waiting for free buffers. The memory of the buffers which are taken
+    out of circulation is freed.
+    Enables separated execution - an integer `prefetch_queue_depth` is used for both the CPU
+    and the GPU queue.
+`prefetch_memory_budget` : int, optional, default = 0
+    Upper bound, in bytes, for the memory of the buffers of one adaptive prefetch queue.
+    The queue is not grown beyond it and is shrunk when the buffers outgrow it. 0 means no limit.
+    Used only with `max_prefetch_queue_depth`.
+`memory_profile` : str, optional, default = None
+    Path to a memory profile saved with :meth:`save_memory_profile` by a previous run of the same
+    pipeline. If the file exists when the pipeline is built, the output buffers of the operators
+    are reserved up front for the sizes recorded in the profile, instead of growing during the
+    first iterations.
+`device_memory_limit` : int, optional, default = 0
+    Maximum amount of device memory, in bytes, used by the buffers of this pipeline. The pipelines
+    running on the same device share the memory pool; this limit keeps one of them from taking
+    the memory needed by the others. An allocation beyond the limit fails. 0 means no limit.
+`device_memory_soft_limit` : int, optional, default = 0
+    Amount of device memory, in bytes, above which the GPU buffers of this pipeline release the
+    memory they hold in excess (e.g. after one unusually large batch), so that it can be reused
+    by other pipelines on the same device. 0 means no limit.
+`growable_gpu_buffers` : bool, optional, default = False
+    If True, the GPU output buffers of the operators are backed by the CUDA virtual memory
+    management API: when a buffer needs to grow, more physical memory is mapped at its end,
+    instead of allocating a new buffer. When it shrinks (see ``device_memory_soft_limit``), the
+    memory at its end is unmapped and returned to the device. This memory doesn't come from the
+    memory pool and doesn't count towards ``device_memory_limit``.
+    Ignored if the virtual memory management is not supported.
+`cuda_graphs` : bool, optional, default = False
+    If True, the work of the GPU operators is captured in a CUDA graph, after a few iterations
+    with the same input and output shapes, and the graph is replayed instead of launching the
+    kernels one by one. When the shapes or the buffers change, the operators are run directly
+    until the new shapes prove stable, and then captured again.
+    The graph is used only if all the GPU operators support it and have neither CPU nor
+    argument inputs; otherwise the option is ignored.
+`enable_checkpointing` : bool, optional, default = False
+    If True, the pipeline keeps the state of its readers (the position in the dataset, the
+    shard and the shuffling) and of its random operators, so that it can be saved with
+    :meth:`checkpoint` and the processing can be resumed exactly where it stopped.
+`checkpoint` : bytes, optional, default = None
+    A checkpoint returned by :meth:`checkpoint` of a pipeline with the same definition.
+    The pipeline, when built, resumes from the checkpoint: it returns the same outputs as
+    the checkpointed pipeline would in the following iterations. The readers skip to their
+    position without reading the skipped samples. The readers with ``global_shuffle`` can
+    be restored with a different number of shards, see their ``global_shuffle`` argument.
+    Implies ``enable_checkpointing=True``.
+`enable_operator_timing` : bool, optional, default = False
+    If True, the executor measures the time spent in each operator (on the host and, with CUDA
+    events, in the device stream), the time of the stages and the occupancy of the prefetch
+    queues. The cumulative counters are returned by :meth:`operator_timing`.
+`low_latency` : bool, optional, default = False
+    If True, the pipeline is tuned for the latency of a single iteration, e.g. for online
+    inference with one request per batch: the stages run synchronously in the thread calling
+    :meth:`run`, without prefetching (it implies ``exec_pipelined=False``, ``exec_async=False``
+    and ``prefetch_queue_depth=1``), and the work that a CPU operator issues as a single job
+    (e.g. for a batch of one sample) is run in that thread too, without the round trip to
+    the thread pool. To avoid allocations after the first iterations, pass a ``memory_profile``
+    gathered with the largest expected inputs. Can't be used with separated queues nor with
+    ``exec_dynamic``.
+`sample_chaining` : bool, optional, default = False
+    If True, the consecutive CPU operators that process the samples one by one (e.g. the CPU
+    ``decoders.image`` followed by ``resize_crop_mirror``) run as one job per sample, instead of
+    each of them waiting for the whole batch to be processed by the previous one. It helps when
+    the time of the samples varies a lot. Ignored with ``exec_dynamic``.
+`batch_size_buckets` : list of int, optional, default = None
+    The batch sizes the iterations should preferably have, for serving pipelines that get
+    requests of varying sizes. An ``external_source`` with ``max_batch_delay`` coalesces
+    the requests fed to it into batches, and it takes as many requests as give one of
+    the buckets, when possible. With ``cuda_graphs=True``, the GPU stage is captured separately
+    for each bucket, so iterations of different buckets don't capture the graph again.
+    ``batch_size`` is always a bucket.
+`shared_thread_pool` : bool, optional, default = False
+    If True, the work of the CPU operators runs on the worker threads shared by all the
+    pipelines in the process that set this option, instead of ``num_threads`` threads of
+    the pipeline's own. There are as many shared threads as the ``num_threads`` of the largest
+    of these pipelines, so that many pipelines in one process (e.g. on a serving host) don't
+    oversubscribe the CPU. A pipeline still runs at most ``num_threads`` jobs at a time.
+`thread_pool_priority` : int, optional, default = 0
+    The priority of the pipeline in the shared thread pool: a free thread takes the work of
+    the pipeline with the highest priority, the pipelines with the same priority take turns.
+    Used only with ``shared_thread_pool=True``.
+`work_stealing_thread_pool` : bool, optional, default = False
+    If True, the work of the CPU operators runs on a thread pool in which each thread has its
+    own work queue and, once it runs out of work, takes the jobs queued for other threads.
+    It reduces the contention on the work queue when the operators issue many short jobs;
+    the jobs are started in the order of their priorities only approximately.
+    It can't be used together with ``shared_thread_pool``.
+`coalesce_iterations` : int, optional, default = 1
+    The number of consecutive iterations processed as one, for the pipelines with tiny batches,
+    whose time is dominated by the fixed cost of an iteration (the executor's bookkeeping,
+    the setup of the operators and the kernel launches). The operators process batches of up to
+    ``coalesce_iterations * max_batch_size`` samples and the outputs are returned as
+    ``coalesce_iterations`` consecutive batches of up to ``max_batch_size`` samples, which
+    share the memory of the larger batch. The stages run on every ``coalesce_iterations``-th
+    call to :meth:`run` (or :meth:`schedule_run`). The data fed to an ``external_source``
+    with :meth:`feed_input` is the data of ``coalesce_iterations`` iterations - a batch of up to
+    ``coalesce_iterations * max_batch_size`` samples. Can't be used with checkpointing nor
+    with an ``external_source`` with a ``source``.
 """
     def __init__(self, batch_size = -1, num_threads = -1, device_id = -1, seed = -1,
                  exec_pipelined=True, prefetch_queue_depth=2,
@@ -177,7 +287,14 @@ Parameters
                  set_affinity=False, max_streams=-1, default_cuda_stream_priority = 0,
                  *,
                  enable_memory_stats=False, py_num_workers=1, py_start_method="fork",
-                 py_callback_pickler=None, output_dtype=None, output_ndim=None):
+                 py_callback_pickler=None, output_dtype=None, output_ndim=None,
+                 exec_dynamic=False, max_prefetch_queue_depth=None, prefetch_memory_budget=0,
+                 memory_profile=None, device_memory_limit=0, device_memory_soft_limit=0,
+                 growable_gpu_buffers=False, cuda_graphs=False, enable_operator_timing=False,
+                 low_latency=False, batch_size_buckets=None, shared_thread_pool=False,
+                 thread_pool_priority=0, work_stealing_thread_pool=False,
+                 enable_checkpointing=False, checkpoint=None, sample_chaining=False,
+                 coalesce_iterations=1):
         self._sinks = []
         self._max_batch_size = batch_size
         self._num_threads = num_threads
@@ -203,6 +320,7 @@ Parameters
         self._gpu_batches_to_consume = 0
         self._names_and_devices = None
         self._exec_async = exec_async
+        self._exec_dynamic = exec_dynamic
         self._bytes_per_sample = bytes_per_sample
         self._set_affinity = set_affinity
         self._max_streams = max_streams
@@ -224,6 +342,36 @@ Parameters
         self._parallel_input_callbacks = None
         self._seq_input_callbacks = None
         self._enable_memory_stats = enable_memory_stats
+        self._enable_operator_timing = enable_operator_timing
+        self._memory_profile = memory_profile
+        self._device_memory_limit = device_memory_limit
+        self._device_memory_soft_limit = device_memory_soft_limit
+        self._growable_gpu_buffers = growable_gpu_buffers
+        self._cuda_graphs = cuda_graphs
+        self._checkpoint = checkpoint
+        self._checkpointing = enable_checkpointing or checkpoint is not None
+        self._batch_size_buckets = list(batch_size_buckets) if batch_size_buckets else []
+        self._shared_thread_pool = shared_thread_pool
+        self._thread_pool_priority = thread_pool_priority
+        if shared_thread_pool and work_stealing_thread_pool:
+            raise ValueError("`shared_thread_pool` and `work_stealing_thread_pool` "
+                             "can't be used together.")
+        self._work_stealing_thread_pool = work_stealing_thread_pool
+        self._low_latency = low_latency
+        self._sample_chaining = sample_chaining
+        if coalesce_iterations < 1:
+            raise ValueError(f"``coalesce_iterations`` must be positive, got {coalesce_iterations}.")
+        if coalesce_iterations > 1 and self._checkpointing:
+            raise ValueError("``coalesce_iterations`` can't be used with checkpointing.")
+        self._coalesce_iterations = coalesce_iterations
+        if low_latency:
+            if exec_dynamic or type(prefetch_queue_depth) is dict or \
+                    max_prefetch_queue_depth is not None:
+                raise ValueError("``low_latency`` can't be used with separated queues nor with "
+                                 "``exec_dynamic``.")
+            self._exec_pipelined = False
+            self._exec_async = False
+            prefetch_queue_depth = 1
         self._prefetch_queue_depth = prefetch_queue_depth
         if type(prefetch_queue_depth) is dict:
             self._exec_separated = True
@@ -235,6 +383,20 @@ Parameters
             self._gpu_queue_size = prefetch_queue_depth
         else:
             raise TypeError("Expected prefetch_queue_depth to be either int or Dict[int, int]")
+        self._max_prefetch_queue_depth = max_prefetch_queue_depth
+        self._output_objects = None
+        self._prefetch_memory_budget = prefetch_memory_budget
+        if max_prefetch_queue_depth is not None:
+            self._exec_separated = True
+            if type(max_prefetch_queue_depth) is dict:
+                self._max_cpu_queue_size = max_prefetch_queue_depth["cpu_size"]
+                self._max_gpu_queue_size = max_prefetch_queue_depth["gpu_size"]
+            elif type(max_prefetch_queue_depth) is int:
+                self._max_cpu_queue_size = max_prefetch_queue_depth
+                self._max_gpu_queue_size = max_prefetch_queue_depth
+            else:
+                raise TypeError(
+                    "Expected max_prefetch_queue_depth to be either int or Dict[int, int]")
 
         # Assign and validate output_dtype
         if isinstance(output_dtype, (list, tuple)):
@@ -303,6 +465,11 @@ Parameters
         """If true, asynchronous execution is used."""
         return self._exec_async
 
+    @property
+    def exec_dynamic(self):
+        """If true, the operators are scheduled as a dependency graph instead of stages."""
+        return self._exec_dynamic
+
     @property
     def set_affinity(self):
         """If True, worker threads are bound to CPU cores."""
@@ -318,6 +485,11 @@ Parameters
         """Depth (or depths) of the prefetch queue, as specified in the ``__init__`` arguments."""
         return self._prefetch_queue_depth
 
+    @property
+    def max_prefetch_queue_depth(self):
+        """Maximum depth of the adaptive prefetch queues; None if the depth is fixed."""
+        return self._max_prefetch_queue_depth
+
     @property
     def default_cuda_stream_priority(self):
         """Default priority of the CUDA streams used by this pipeline."""
@@ -328,6 +500,21 @@ Parameters
         """If True, memory usage statistics are gathered."""
         return self._enable_memory_stats
 
+    @property
+    def enable_operator_timing(self):
+        """If True, the timing of the operators and stages is gathered."""
+        return self._enable_operator_timing
+
+    @property
+    def low_latency(self):
+        """If True, the pipeline runs in the low latency mode."""
+        return self._low_latency
+
+    @property
+    def coalesce_iterations(self):
+        """The number of iterations processed as one."""
+        return self._coalesce_iterations
+
     @property
     def py_num_workers(self):
         """The number of Python worker processes used by parallel ```external_source```."""
@@ -404,6 +591,110 @@ Parameters
             raise RuntimeError("Pipeline must be built first.")
         return self._pipe.executor_statistics()
 
+    def operator_timing(self):
+        """Returns the timing gathered by the executor since the pipeline was built, as
+        a dictionary. Requires ``enable_operator_timing=True``.
+
+        The counters are cumulative - the rates (e.g. samples per second) of a period are obtained
+        from the difference of two snapshots. All the times are in seconds.
+
+            * ``operators`` - a dictionary with an entry for each operator, with the same keys as
+              in :meth:`executor_statistics`:
+
+                * ``num_runs``, ``num_samples`` - the number of iterations and samples processed,
+                * ``host_time`` - the wall time of the operator in the executor's thread,
+                * ``gpu_time`` - the time of the operator's work in the CUDA stream, measured
+                  in ``num_gpu_runs`` runs. The work of the GPU operators replayed as a CUDA
+                  graph (see ``cuda_graphs``) is not timed.
+
+            * ``stages`` - a dictionary with an entry for the ``cpu``, ``mixed`` and ``gpu``
+              stage:
+
+                * ``num_iterations``, ``num_samples``,
+                * ``host_time`` - the time spent on the iterations of the stage,
+                * ``wait_time`` - the time the stage waited for the input and output buffers,
+                * ``mean_queue_occupancy``, ``max_queue_occupancy`` - the number of batches
+                  ready in the queue after the stage, when the next stage (or the user) takes
+                  one. A queue which is usually full is drained by a slower consumer.
+                * ``producer_wait`` - the time the stage waited for a free buffer of the queue,
+                * ``consumer_wait`` - the time the next stage (or the user, for the last stage)
+                  waited for a batch in the queue.
+                * ``num_allocations``, ``last_allocations`` - the number of heap allocations
+                  made in the iterations of the stage and in the last one. They are only
+                  counted when DALI is built with ``BUILD_ALLOCATION_COUNTING`` (otherwise
+                  they are 0); a pipeline in the steady state should make no allocations.
+                * ``num_graph_captures``, ``num_graph_replays`` - the number of iterations run
+                  as a CUDA graph, which was captured in the iteration or replayed. Only the
+                  ``gpu`` stage is run as a CUDA graph, see ``cuda_graphs``.
+
+            * ``bottleneck`` - the fraction of the elapsed time for which the ``cpu``, ``mixed``
+              and ``gpu`` stage, or the ``consumer`` of the outputs, was the limiter, see
+              :meth:`bottleneck_summary`.
+            * ``elapsed_time`` - the time since the first iteration was started.
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        if not self._enable_operator_timing:
+            raise RuntimeError("Operator timing requires ``enable_operator_timing=True``.")
+        return self._pipe.operator_timing()
+
+    def checkpoint(self):
+        """Returns the state of the pipeline after the iterations whose outputs were returned
+        by :meth:`run` (or :meth:`outputs`), as bytes. Requires ``enable_checkpointing=True``.
+
+        The iterations prefetched by the pipeline, but not returned yet, are not included - a
+        pipeline created with the checkpoint (see the ``checkpoint`` argument) returns the
+        outputs of these iterations first. The state covers the position of the readers
+        and the state of the random operators; the data fed to ``external_source`` is not
+        included.
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        if not self._checkpointing:
+            raise RuntimeError("Checkpoints require ``enable_checkpointing=True``.")
+        return self._pipe.GetSerializedCheckpoint()
+
+    def bottleneck_summary(self):
+        """Returns a human-readable report of which part of the pipeline limited its
+        throughput, e.g. ``"gpu stage was the limiter 71.5% of the time"``, one line for each
+        part, starting with the main limiter. Requires ``enable_operator_timing=True``.
+
+        The time the user didn't wait for the outputs is attributed to the ``consumer`` (e.g.
+        the training loop). The time it waited is attributed to the last stage, except for the
+        part in which that stage itself waited for its input, which is attributed to the previous
+        stage, and so on. The attribution is meaningful when the stages run in separate threads
+        (``exec_async=True``).
+        """
+        bottleneck = self.operator_timing()["bottleneck"]
+        parts = sorted(bottleneck.items(), key=lambda part: part[1], reverse=True)
+        lines = []
+        for name, fraction in parts:
+            label = name if name == "consumer" else f"{name} stage"
+            lines.append(f"{label} was the limiter {fraction * 100:.1f}% of the time")
+        return "\n".join(lines)
+
+    def save_memory_profile(self, filename):
+        """Saves the peak sizes of the operator outputs observed so far to a file, which can be
+        passed as the ``memory_profile`` to the pipelines created in subsequent runs.
+
+        Requires ``enable_memory_stats=True``. The profile is typically saved after a few
+        warm-up iterations.
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        if not self._enable_memory_stats:
+            raise RuntimeError("Saving the memory profile requires ``enable_memory_stats=True``.")
+        self._pipe.SaveMemoryProfile(filename)
+
+    def device_memory_usage(self):
+        """Returns the device memory used by the buffers of the pipeline, as a dictionary with
+        the ``current`` and ``peak`` number of bytes, or None, if the pipeline has no
+        device memory limits (see ``device_memory_limit`` and ``device_memory_soft_limit``).
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        return self._pipe.device_memory_usage()
+
     def reader_meta(self, name = None):
         """Returns provided reader metadata as a dictionary. If no name is provided if provides
         a dictionary with data for all readers as {reader_name : meta}
@@ -639,12 +930,21 @@ Parameters
             # Otherwise the backend may try to access unmmaped memory which leads to crashes at the Python teardown.
             self._pipe.SetPyObjDependency(self._py_pool)
 
+    def _py_pin_device_id(self):
+        # The batches produced by the parallel external sources are placed in pinned memory
+        # when the pipeline uses a GPU, so that they don't have to be copied to pinned buffers
+        # before they are transferred to the device.
+        if self._device_id is None or self._device_id == types.CPU_ONLY_DEVICE_ID:
+            return None
+        return self._device_id
+
     def _start_py_workers(self):
         if not self._parallel_input_callbacks:
             return
         self._py_pool = WorkerPool.from_groups(
             self._parallel_input_callbacks, self._prefetch_queue_depth, self._py_start_method,
-            self._py_num_workers, py_callback_pickler=self._py_callback_pickler)
+            self._py_num_workers, py_callback_pickler=self._py_callback_pickler,
+            pin_device_id=self._py_pin_device_id())
         # ensure processes started by the pool are termineted when pipeline is no longer used
         weakref.finalize(self, lambda pool : pool.close(), self._py_pool)
         self._py_pool_started = True
@@ -664,9 +964,22 @@ Parameters
                                 self._set_affinity,
                                 self._max_streams,
                                 self._default_cuda_stream_priority)
-        self._pipe.SetExecutionTypes(self._exec_pipelined, self._exec_separated, self._exec_async)
+        self._pipe.SetExecutionTypes(self._exec_pipelined, self._exec_separated, self._exec_async,
+                                     self._exec_dynamic)
         self._pipe.SetQueueSizes(self._cpu_queue_size, self._gpu_queue_size)
+        self._enable_adaptive_prefetch()
         self._pipe.EnableExecutorMemoryStats(self._enable_memory_stats)
+        self._pipe.EnableOperatorTiming(self._enable_operator_timing)
+        self._load_memory_profile()
+        self._set_device_memory_limits()
+        self._enable_growable_buffers()
+        self._enable_cuda_graphs()
+        self._enable_checkpointing()
+        self._set_thread_pool()
+        self._set_low_latency()
+        self._set_sample_chaining()
+        self._set_batch_size_buckets()
+        self._set_iteration_coalescing()
 
         # Add the ops to the graph and build the backend
         related_logical_id = {}
@@ -687,6 +1000,9 @@ Parameters
                 group = op._group
                 groups.add(group)
         groups = list(groups)
+        if groups and self._coalesce_iterations > 1:
+            raise ValueError("``coalesce_iterations`` can't be used with an ``external_source`` "
+                             "with a ``source`` - feed the data with ``feed_input`` instead.")
         self._input_callbacks = groups
         if self._py_num_workers == 0:
             self._parallel_input_callbacks = []
@@ -757,9 +1073,11 @@ Parameters
         self._setup_pipe_pool_dependency()
 
         self._pipe.Build(self._generate_build_args())
+        self._restore_checkpoint()
         self._built = True
 
-    def _feed_input(self, name, data, layout=None, cuda_stream=None, use_copy_kernel=False):
+    def _feed_input(self, name, data, layout=None, cuda_stream=None, use_copy_kernel=False,
+                    is_pinned=False):
         from nvidia.dali.external_source import _prep_data_for_feed_input
         if cuda_stream is None:
             cuda_stream = types._get_default_stream_for_array(data)
@@ -768,7 +1086,8 @@ Parameters
         else:
             cuda_stream = types._raw_cuda_stream(cuda_stream)
 
-        data = _prep_data_for_feed_input(data, self._max_batch_size, layout, self._device_id)
+        data = _prep_data_for_feed_input(data, self._max_batch_size * self._coalesce_iterations,
+                                         layout, self._device_id, is_pinned)
 
         if isinstance(data, list):
             self._pipe.SetExternalTensorInput(
@@ -893,7 +1212,8 @@ Parameters
             if self._first_iter and self._exec_pipelined:
                 self._prefetch()
             else:
-                self._run_once()
+                for _ in range(self._runs_to_schedule()):
+                    self._run_once()
 
     # for the backward compatibility
     def _run(self):
@@ -925,6 +1245,45 @@ Parameters
             self._gpu_batches_to_consume -= 1
             return self._pipe.ShareOutputs()
 
+    def share_outputs_with_shapes(self):
+        """Returns the outputs of the pipeline along with the shapes of all their samples.
+
+        Works like :meth:`share_outputs`, but the shapes of the samples of all the outputs are
+        gathered in a single NumPy array, so that they don't need to be queried through
+        the outputs, sample by sample. The Python objects of the outputs are kept alive
+        for as many iterations as there are buffers in the prefetch queues, so that they are
+        reused, instead of recreated, when the same buffers are returned again.
+        Needs to be used together with :meth:`release_outputs`
+        and :meth:`schedule_run`
+        Should not be mixed with :meth:`run` in the same pipeline.
+
+        :return:
+            A tuple ``(outputs, shapes, num_samples, ndims)``, where ``outputs`` is a tuple of
+            `TensorList` objects for respective pipeline outputs, ``shapes`` is an int64 array
+            of shape ``(num_outputs, max_batch_size, max_ndim)``, and ``num_samples`` and
+            ``ndims`` are int32 arrays with the number of samples and dimensions of each output.
+            The extents beyond the number of samples or dimensions of an output are 0.
+        """
+        with self._check_api_type_scope(types.PipelineAPIType.SCHEDULED):
+            if self._batches_to_consume == 0 or self._gpu_batches_to_consume == 0:
+                raise StopIteration
+            self._batches_to_consume -= 1
+            self._gpu_batches_to_consume -= 1
+            return self._keep_output_objects(self._pipe.ShareOutputsWithShapes())
+
+    def _keep_output_objects(self, outputs_with_shapes):
+        """Keeps the Python objects of the outputs of the last iterations alive.
+
+        pybind returns the existing Python object for a TensorList which still has one,
+        so the wrappers of the buffers in the output queues are created only once."""
+        if self._output_objects is None:
+            depth = max(self._cpu_queue_size, self._gpu_queue_size)
+            if self._max_prefetch_queue_depth is not None:
+                depth = max(depth, self._max_cpu_queue_size, self._max_gpu_queue_size)
+            self._output_objects = deque(maxlen=depth + 1)
+        self._output_objects.append(outputs_with_shapes[0])
+        return outputs_with_shapes
+
     # for the backward compatibility
     def _share_outputs(self):
         """Deprecated. Use :meth:`share_outputs` instead"""
@@ -962,6 +1321,22 @@ Parameters
             raise RuntimeError("Pipeline must be built first.")
         return self._pipe.Outputs()
 
+    def outputs_with_shapes(self):
+        """Returns the outputs of the pipeline along with the shapes of all their samples
+        and releases previous buffer.
+
+        Works like :meth:`outputs`; the result is the same as that of
+        :meth:`share_outputs_with_shapes`.
+        """
+        with self._check_api_type_scope(types.PipelineAPIType.SCHEDULED):
+            if self._batches_to_consume == 0 or self._gpu_batches_to_consume == 0:
+                raise StopIteration
+            self._batches_to_consume -= 1
+            self._gpu_batches_to_consume -= 1
+            if not self._built:
+                raise RuntimeError("Pipeline must be built first.")
+            return self._keep_output_objects(self._pipe.OutputsWithShapes())
+
     def run(self):
         """Run the pipeline and return the result.
 
@@ -991,6 +1366,16 @@ Parameters
                 self._run_once()
         self._first_iter = False
 
+    def _runs_to_schedule(self):
+        """Number of iterations to start, so that the prefetch queues stay full.
+
+        With the adaptive prefetch queues it follows the depth chosen by the executor:
+        it is 0 when a queue was shrunk and 2 when it was grown."""
+        if self._max_prefetch_queue_depth is None or not self._exec_pipelined:
+            return 1
+        cpu_size, gpu_size = self._pipe.ActiveQueueSizes()
+        return max(cpu_size + gpu_size - self._batches_to_consume, 0)
+
     def _run_once(self):
         """Start running the whole pipeline once without waiting for its results.
 
@@ -1024,6 +1409,58 @@ Parameters
         except StopIteration:
             self._last_iter = True
 
+    def _load_memory_profile(self):
+        if self._memory_profile is not None and os.path.exists(self._memory_profile):
+            self._pipe.LoadMemoryProfile(self._memory_profile)
+
+    def _set_device_memory_limits(self):
+        if self._device_memory_limit or self._device_memory_soft_limit:
+            self._pipe.SetDeviceMemoryLimits(self._device_memory_soft_limit,
+                                             self._device_memory_limit)
+
+    def _enable_growable_buffers(self):
+        if self._growable_gpu_buffers:
+            self._pipe.EnableGrowableBuffers(True)
+
+    def _enable_cuda_graphs(self):
+        if self._cuda_graphs:
+            self._pipe.EnableCudaGraphs(True)
+
+    def _enable_checkpointing(self):
+        if self._checkpointing:
+            self._pipe.EnableCheckpointing(True)
+
+    def _restore_checkpoint(self):
+        if self._checkpoint is not None:
+            self._pipe.RestoreFromSerializedCheckpoint(self._checkpoint)
+
+    def _set_thread_pool(self):
+        if self._shared_thread_pool:
+            self._pipe.EnableSharedThreadPool(True, self._thread_pool_priority)
+        if self._work_stealing_thread_pool:
+            self._pipe.EnableWorkStealingThreadPool(True)
+
+    def _set_low_latency(self):
+        if self._low_latency:
+            self._pipe.SetLowLatency(True)
+
+    def _set_sample_chaining(self):
+        if self._sample_chaining:
+            self._pipe.EnableSampleChaining(True)
+
+    def _set_iteration_coalescing(self):
+        if self._coalesce_iterations > 1:
+            self._pipe.SetIterationCoalescing(self._coalesce_iterations)
+
+    def _set_batch_size_buckets(self):
+        if self._batch_size_buckets:
+            self._pipe.SetBatchSizeBuckets(self._batch_size_buckets)
+
+    def _enable_adaptive_prefetch(self):
+        if self._max_prefetch_queue_depth is not None:
+            self._pipe.EnableAdaptivePrefetch(self._max_cpu_queue_size, self._max_gpu_queue_size,
+                                              self._prefetch_memory_budget)
+
     def _schedule_py_workers(self):
         if self._py_pool is None:
             return
@@ -1134,7 +1571,15 @@ Parameters
             raise ValueError(
                 "serialized_pipeline and filename arguments are mutually exclusive. "
                 "Precisely one of them should be defined.")
-        pipeline = cls()
+        pipeline = cls(low_latency=kw.get("low_latency", False),
+                       batch_size_buckets=kw.get("batch_size_buckets", None),
+                       shared_thread_pool=kw.get("shared_thread_pool", False),
+                       thread_pool_priority=kw.get("thread_pool_priority", 0),
+                       work_stealing_thread_pool=kw.get("work_stealing_thread_pool", False),
+                       enable_checkpointing=kw.get("enable_checkpointing", False),
+                       checkpoint=kw.get("checkpoint", None),
+                       sample_chaining=kw.get("sample_chaining", False),
+                       coalesce_iterations=kw.get("coalesce_iterations", 1))
         if filename is not None:
             with open(filename, 'rb') as pipeline_file:
                 serialized_pipeline = pipeline_file.read()
@@ -1143,9 +1588,9 @@ Parameters
             kw.get("batch_size", -1),
             kw.get("num_threads", -1),
             kw.get("device_id", -1),
-            kw.get("exec_pipelined", True),
-            kw.get("prefetch_queue_depth", 2),
-            kw.get("exec_async", True),
+            kw.get("exec_pipelined", True) and not pipeline._low_latency,
+            1 if pipeline._low_latency else kw.get("prefetch_queue_depth", 2),
+            kw.get("exec_async", True) and not pipeline._low_latency,
             kw.get("bytes_per_sample", 0),
             kw.get("set_affinity", False),
             kw.get("max_streams", -1),
@@ -1154,11 +1599,24 @@ Parameters
         if pipeline.device_id != types.CPU_ONLY_DEVICE_ID:
             b.check_cuda_runtime()
         pipeline._pipe.SetExecutionTypes(pipeline._exec_pipelined, pipeline._exec_separated,
-                                         pipeline._exec_async)
+                                         pipeline._exec_async, pipeline._exec_dynamic)
         pipeline._pipe.SetQueueSizes(pipeline._cpu_queue_size, pipeline._gpu_queue_size)
+        pipeline._enable_adaptive_prefetch()
         pipeline._pipe.EnableExecutorMemoryStats(pipeline._enable_memory_stats)
+        pipeline._pipe.EnableOperatorTiming(pipeline._enable_operator_timing)
+        pipeline._load_memory_profile()
+        pipeline._set_device_memory_limits()
+        pipeline._enable_growable_buffers()
+        pipeline._enable_cuda_graphs()
+        pipeline._enable_checkpointing()
+        pipeline._set_thread_pool()
+        pipeline._set_low_latency()
+        pipeline._set_sample_chaining()
+        pipeline._set_batch_size_buckets()
+        pipeline._set_iteration_coalescing()
         pipeline._backend_prepared = True
         pipeline._pipe.Build()
+        pipeline._restore_checkpoint()
         pipeline._built = True
         return pipeline
 
@@ -1181,11 +1639,25 @@ Parameters
                                 self._set_affinity,
                                 self._max_streams,
                                 self._default_cuda_stream_priority)
-        self._pipe.SetExecutionTypes(self._exec_pipelined, self._exec_separated, self._exec_async)
+        self._pipe.SetExecutionTypes(self._exec_pipelined, self._exec_separated, self._exec_async,
+                                     self._exec_dynamic)
         self._pipe.SetQueueSizes(self._cpu_queue_size, self._gpu_queue_size)
+        self._enable_adaptive_prefetch()
         self._pipe.EnableExecutorMemoryStats(self._enable_memory_stats)
+        self._pipe.EnableOperatorTiming(self._enable_operator_timing)
+        self._load_memory_profile()
+        self._set_device_memory_limits()
+        self._enable_growable_buffers()
+        self._enable_cuda_graphs()
+        self._enable_checkpointing()
+        self._set_thread_pool()
+        self._set_low_latency()
+        self._set_sample_chaining()
+        self._set_batch_size_buckets()
+        self._set_iteration_coalescing()
         self._backend_prepared = True
         self._pipe.Build()
+        self._restore_checkpoint()
         self._built = True
 
     def save_graph_to_dot_file(self, filename, show_tensors = False, show_ids = False,
@@ -1413,7 +1885,7 @@ def _pipeline_def_experimental(fn=None, **pipeline_kwargs):
             pipeline_args = {**pipeline_kwargs, **ctor_args}  # Merge and overwrite dict
             if debug_mode_on:
                 pipe = _PipelineDebug(functools.partial(func, *args, **fn_kwargs),
-                                     **pipeline_args)
+                                      capture=debug_mode_on == 'capture', **pipeline_args)
             else:
                 pipe = Pipeline(**pipeline_args)
                 with pipe:
@@ -240,9 +240,12 @@ class _DaliBaseIterator(object):
             if_drop = np.less(left, self.batch_size)
         return if_drop, left
 
-    def _get_outputs(self):
+    def _get_outputs(self, with_shapes=False):
         """
         Checks iterator stop condition, gets DALI outputs and perform reset in case of StopIteration
+
+        If `with_shapes` is set, the outputs of each pipeline are returned as a tuple
+        ``(outputs, shapes, num_samples, ndims)`` - see `Pipeline.share_outputs_with_shapes`.
         """
         # if pipeline was not scheduled ever do it here
         if not self._ever_scheduled:
@@ -254,22 +257,25 @@ class _DaliBaseIterator(object):
         try:
             for p in self._pipes:
                 with p._check_api_type_scope(types.PipelineAPIType.ITERATOR):
-                    outputs.append(p.share_outputs())
+                    if with_shapes:
+                        outputs.append(p.share_outputs_with_shapes())
+                    else:
+                        outputs.append(p.share_outputs())
         except StopIteration as e:
             # in case ExternalSource returns StopIteration
             if self._size < 0 and self._auto_reset:
                 self.reset()
             raise e
-        self._check_batch_size(outputs)
+        self._check_batch_size(outputs, with_shapes)
         return outputs
 
-    def _check_batch_size(self, outs):
+    def _check_batch_size(self, outs, with_shapes=False):
         if not isinstance(outs, Iterable):
             outs = [outs]
         if self._reader_name or self._size != -1:
             for out in outs:
-                for o in out:
-                    batch_len = len(o)
+                batch_lens = out[2] if with_shapes else [len(o) for o in out]
+                for batch_len in batch_lens:
                     assert self.batch_size == batch_len, \
                         "Variable batch size is not supported by the iterator when reader_name is " + \
                         "provided or iterator size is set explicitly"
@@ -46,6 +46,20 @@ def address_as_void_pointer(typingctx, src):
         return builder.inttoptr(args[0], cgutils.voidptr_t)
     return sig, codegen
 
+def _to_dim3(value, name):
+    if isinstance(value, int):
+        value = (value,)
+    value = tuple(value)
+    if not 1 <= len(value) <= 3:
+        raise ValueError("`{}` should be an integer or a tuple of up to 3 integers.".format(name))
+    return list(value) + [1] * (3 - len(value))
+
+def _get_cufunc_handle(kernel, sig):
+    # loads the kernel in the current context and returns the address of the CUfunction
+    cufunc = kernel.overloads[sig.args]._codelibrary.get_cufunc()
+    handle = cufunc.handle
+    return handle.value if hasattr(handle, "value") else int(handle)
+
 @njit
 def _get_shape_view(shapes_ptr, ndims_ptr, num_dims, num_samples):
     ndims = carray(address_as_void_pointer(ndims_ptr), num_dims, dtype=np.int32)
@@ -61,6 +75,7 @@ def _get_shape_view(shapes_ptr, ndims_ptr, num_dims, num_samples):
 class NumbaFunction(metaclass=ops._DaliOperatorMeta):
     schema_name = 'NumbaFunction'
     ops.register_cpu_op('NumbaFunction')
+    ops.register_gpu_op('NumbaFunction')
 
     @property
     def spec(self):
@@ -147,7 +162,16 @@ class NumbaFunction(metaclass=ops._DaliOperatorMeta):
                        "Python Operators do not support Multiple Input Sets.")
                       .format(type(inp).__name__))
         op_instance = ops._OperatorInstance(inputs, self, **kwargs)
-        op_instance.spec.AddArg("run_fn", self.run_fn)
+        if self.device == 'gpu':
+            from numba import cuda
+            # the kernel must be loaded in the context of the pipeline's device
+            with cuda.gpus[pipeline.device_id]:
+                run_fn = _get_cufunc_handle(self._cuda_kernel, self._cuda_sig)
+            op_instance.spec.AddArg("run_fn", run_fn)
+            op_instance.spec.AddArg("blocks", self.blocks)
+            op_instance.spec.AddArg("threads_per_block", self.threads_per_block)
+        else:
+            op_instance.spec.AddArg("run_fn", self.run_fn)
         if self.setup_fn != None:
             op_instance.spec.AddArg("setup_fn", self.setup_fn)
         op_instance.spec.AddArg("out_types", self.out_types)
@@ -176,7 +200,8 @@ class NumbaFunction(metaclass=ops._DaliOperatorMeta):
             outputs.append(t)
         return outputs[0] if len(outputs) == 1 else outputs
 
-    def __init__(self, run_fn, out_types, in_types, outs_ndim, ins_ndim, setup_fn=None, device='cpu', batch_processing=False, **kwargs):
+    def __init__(self, run_fn, out_types, in_types, outs_ndim, ins_ndim, setup_fn=None, device='cpu', batch_processing=False,
+                 blocks=None, threads_per_block=None, **kwargs):
         assert len(in_types) == len(ins_ndim), "Number of input types and input dimensions should match."
         assert len(out_types) == len(outs_ndim), "Number of output types and output dimensions should match."
         if not isinstance(outs_ndim, list):
@@ -198,6 +223,11 @@ class NumbaFunction(metaclass=ops._DaliOperatorMeta):
                 setup_fn(out_shapes_np, in_shapes_np)
             setup_fn_address = setup_cfunc.address
 
+        if device == 'gpu':
+            self._init_gpu(run_fn, out_types, in_types, outs_ndim, ins_ndim, setup_fn_address, batch_processing,
+                           blocks, threads_per_block, **kwargs)
+            return
+
         out0_lambda, out1_lambda, out2_lambda, out3_lambda, out4_lambda, out5_lambda = self._get_carrays_eval_lambda(out_types, outs_ndim)
         in0_lambda, in1_lambda, in2_lambda, in3_lambda, in4_lambda, in5_lambda = self._get_carrays_eval_lambda(in_types, ins_ndim)
         run_fn = njit(run_fn)
@@ -295,4 +325,39 @@ class NumbaFunction(metaclass=ops._DaliOperatorMeta):
         self.batch_processing = batch_processing
         self._preserve = True
 
+    def _init_gpu(self, run_fn, out_types, in_types, outs_ndim, ins_ndim, setup_fn_address, batch_processing,
+                  blocks, threads_per_block, **kwargs):
+        from numba import cuda
+        if batch_processing:
+            raise ValueError("Batch processing is not supported by NumbaFunction running on the GPU.")
+        if blocks is None or threads_per_block is None:
+            raise ValueError("`blocks` and `threads_per_block` must be specified when running on the GPU.")
+        # the kernel takes the C-contiguous outputs and inputs of a sample as device arrays
+        arg_types = [numba_types.Array(getattr(numba_types, _to_numpy[dtype]), ndim, 'C')
+                     for dtype, ndim in zip(out_types + in_types, outs_ndim + ins_ndim)]
+        self._cuda_sig = numba_types.void(*arg_types)
+        self._cuda_kernel = cuda.jit(self._cuda_sig)(run_fn)
+
+        self._impl_name = "NumbaFuncImpl"
+        self._schema = _b.GetSchema(self._impl_name)
+        self._spec = _b.OpSpec(self._impl_name)
+        self._device = 'gpu'
+
+        kwargs, self._call_args = ops._separate_kwargs(kwargs)
+
+        for key, value in kwargs.items():
+            self._spec.AddArg(key, value)
+
+        self.run_fn = None
+        self.setup_fn = setup_fn_address
+        self.out_types = out_types
+        self.in_types = in_types
+        self.outs_ndim = outs_ndim
+        self.ins_ndim = ins_ndim
+        self.num_outputs = len(out_types)
+        self.batch_processing = False
+        self.blocks = _to_dim3(blocks, "blocks")
+        self.threads_per_block = _to_dim3(threads_per_block, "threads_per_block")
+        self._preserve = True
+
 ops._wrap_op(NumbaFunction, "fn.experimental", "nvidia.dali.plugin.numba")
@@ -20,6 +20,7 @@ from nvidia.dali.plugin.base_iterator import _DaliBaseIterator
 from nvidia.dali.plugin.base_iterator import LastBatchPolicy
 import torch
 import torch.utils.dlpack as torch_dlpack
+import collections
 import ctypes
 import numpy as np
 
@@ -57,6 +58,12 @@ def feed_ndarray(dali_tensor, arr, cuda_stream = None):
     assert dali_tensor.shape() == list(arr.size()), \
             ("Shapes do not match: DALI tensor has size {0}"
             ", but PyTorch Tensor has size {1}".format(dali_tensor.shape(), list(arr.size())))
+    return _copy_to_torch(dali_tensor, arr, cuda_stream)
+
+
+def _copy_to_torch(dali_tensor, arr, cuda_stream=None):
+    """Copies the contents of a DALI Tensor or TensorList to a PyTorch tensor,
+    without checking the type and shape."""
     cuda_stream = types._raw_cuda_stream(cuda_stream)
 
     # turn raw int to a c void pointer
@@ -67,6 +74,113 @@ def feed_ndarray(dali_tensor, arr, cuda_stream = None):
         dali_tensor.copy_to_external(c_type_pointer)
     return arr
 
+
+def _dense_shape(shapes, num_samples, ndim):
+    """Returns the shape of a batch viewed as a tensor or None, if the samples differ in shape.
+
+    `shapes` is the (max_batch_size, max_ndim) slice of the shapes returned by
+    `Pipeline.share_outputs_with_shapes` for one output."""
+    sample_shapes = shapes[:num_samples, :ndim]
+    if num_samples > 0 and not (sample_shapes == sample_shapes[0]).all():
+        return None
+    sample_shape = sample_shapes[0].tolist() if num_samples > 0 else [0] * ndim
+    return [int(num_samples)] + sample_shape
+
+
+class _SharedIteration:
+    """Counts the PyTorch tensors which reference the outputs of one iteration of a pipeline.
+
+    When the last of them is freed, an event is recorded in the current stream of the device,
+    so the buffers are returned to the pipeline only after the work already issued on them."""
+    def __init__(self, device):
+        self._device = device
+        self.refs = 0
+        self.event = None
+
+    def drop(self):
+        self.refs -= 1
+        if self.refs == 0 and self._device is not None:
+            self.event = torch.cuda.Event()
+            self.event.record(torch.cuda.current_stream(self._device))
+
+    def is_released(self, wait):
+        if self.refs > 0:
+            return False
+        if self.event is not None and not self.event.query():
+            if not wait:
+                return False
+            self.event.synchronize()
+        return True
+
+
+class _SharedOutput:
+    """Exposes the memory of a DALI tensor to PyTorch.
+
+    PyTorch keeps the object alive as long as the storage of the tensor created from it."""
+    def __init__(self, tensor, iteration):
+        self._tensor = tensor
+        self._iteration = iteration
+        iteration.refs += 1
+        if isinstance(tensor, TensorGPU):
+            self.__cuda_array_interface__ = tensor.__cuda_array_interface__
+        else:
+            self.__array_interface__ = tensor.__array_interface__
+
+    def __del__(self):
+        self._tensor = None
+        self._iteration.drop()
+
+
+class _OutputHandoff:
+    """Keeps the iterations of a pipeline, whose outputs were returned without a copy, in use
+    until PyTorch no longer references them.
+
+    The pipeline releases its outputs in the order they were shared, so an iteration is returned
+    only after all the previous ones."""
+    def __init__(self, pipe):
+        depth = pipe.prefetch_queue_depth
+        if isinstance(depth, dict):
+            depth = min(depth["cpu_size"], depth["gpu_size"])
+        self._pipe = pipe
+        self._depth = depth
+        self._held = collections.deque()
+
+    def release(self):
+        """Returns the iterations no longer referenced to the pipeline."""
+        while self._held and self._held[0].is_released(wait=False):
+            self._pop()
+
+    def make_room(self):
+        """Makes sure that the pipeline has a buffer for the next iteration to share."""
+        self.release()
+        while len(self._held) >= self._depth:
+            if not self._held[0].is_released(wait=True):
+                raise RuntimeError(
+                    f"All {self._depth} output buffers of the pipeline are referenced by the "
+                    "tensors returned by the iterator, so it can't produce the next batch. "
+                    "Free the tensors of the earlier batches or increase the "
+                    "`prefetch_queue_depth` of the pipeline.")
+            self._pop()
+
+    def share(self, device):
+        iteration = _SharedIteration(device)
+        self._held.append(iteration)
+        return iteration
+
+    def _pop(self):
+        self._held.popleft()
+        with self._pipe._check_api_type_scope(types.PipelineAPIType.ITERATOR):
+            self._pipe.release_outputs()
+
+
+def _to_torch_tensor(tensor, iteration, device):
+    """Creates a PyTorch tensor using the memory of a DALI tensor."""
+    shared = _SharedOutput(tensor, iteration)
+    if isinstance(tensor, TensorGPU):
+        return torch.as_tensor(shared, device=device)
+    return torch.from_numpy(np.asarray(shared))
+
+
 class DALIGenericIterator(_DaliBaseIterator):
     """
     General DALI iterator for PyTorch. It can return any number of
@@ -124,6 +238,16 @@ class DALIGenericIterator(_DaliBaseIterator):
     prepare_first_batch : bool, optional, default = True
                 Whether DALI should buffer the first batch right after the creation of the iterator,
                 so one batch is already prepared when the iterator is prompted for the data
+    zero_copy : bool, optional, default = False
+                Whether the returned tensors should use the memory of the pipeline outputs instead
+                of a copy of them. The output buffers of an iteration are returned to the pipeline
+                when PyTorch frees all the tensors using them, so the pipeline prefetches only
+                into the buffers not referenced by the earlier batches. ``prefetch_queue_depth``
+                of the pipelines must exceed the number of batches kept alive at a time - the
+                iterator raises an error when all the buffers are referenced.
+                The returned tensors must not be written to.
+                Requires the pipelines to be executed asynchronously, with a fixed prefetch
+                queue depth.
 
     Example
     -------
@@ -151,12 +275,22 @@ class DALIGenericIterator(_DaliBaseIterator):
                  dynamic_shape=False,
                  last_batch_padded=False,
                  last_batch_policy=LastBatchPolicy.FILL,
-                 prepare_first_batch=True):
+                 prepare_first_batch=True,
+                 zero_copy=False):
 
         # check the assert first as _DaliBaseIterator would run the prefetch
         assert len(set(output_map)) == len(output_map), "output_map names should be distinct"
         self._output_categories = set(output_map)
         self.output_map = output_map
+        self._zero_copy = zero_copy
+        if zero_copy:
+            if not isinstance(pipelines, list):
+                pipelines = [pipelines]
+            for p in pipelines:
+                assert p.exec_async and p.max_prefetch_queue_depth is None, \
+                    "The zero-copy iterator requires asynchronous pipelines with a fixed " \
+                    "prefetch queue depth"
+            self._handoffs = [_OutputHandoff(p) for p in pipelines]
 
         _DaliBaseIterator.__init__(self,
                                    pipelines,
@@ -181,24 +315,28 @@ class DALIGenericIterator(_DaliBaseIterator):
             self._first_batch = None
             return batch
 
+        if self._zero_copy:
+            for handoff in self._handoffs:
+                handoff.make_room()
+
         # Gather outputs
-        outputs = self._get_outputs()
+        outputs = self._get_outputs(with_shapes=True)
 
         data_batches = [None for i in range(self._num_gpus)]
         for i in range(self._num_gpus):
             dev_id = self._pipes[i].device_id
+            pipe_outputs, shapes, num_samples, ndims = outputs[i]
             # initialize dict for all output categories
             category_outputs = dict()
-            # segregate outputs into categories
-            for j, out in enumerate(outputs[i]):
-                category_outputs[self.output_map[j]] = out
-
-            # Change DALI TensorLists into Tensors
-            category_tensors = dict()
             category_shapes = dict()
-            for category, out in category_outputs.items():
-                category_tensors[category] = out.as_tensor()
-                category_shapes[category] = category_tensors[category].shape()
+            # segregate outputs into categories; the shapes come from a single array,
+            # the TensorLists are not queried sample by sample
+            for j, out in enumerate(pipe_outputs):
+                category = self.output_map[j]
+                category_outputs[category] = out
+                category_shapes[category] = _dense_shape(shapes[j], num_samples[j], ndims[j])
+                if category_shapes[category] is None:
+                    out.as_tensor()  # raises the error about the non-uniform shape
 
             category_torch_type = dict()
             category_device = dict()
@@ -206,8 +344,8 @@ class DALIGenericIterator(_DaliBaseIterator):
             torch_cpu_device = torch.device('cpu')
             # check category and device
             for category in self._output_categories:
-                category_torch_type[category] = to_torch_type[category_tensors[category].dtype]
-                if type(category_tensors[category]) is TensorGPU:
+                category_torch_type[category] = to_torch_type[category_outputs[category].dtype]
+                if isinstance(category_outputs[category], TensorListGPU):
                     if not torch_gpu_device:
                         torch_gpu_device = torch.device('cuda', dev_id)
                     category_device[category] = torch_gpu_device
@@ -215,6 +353,15 @@ class DALIGenericIterator(_DaliBaseIterator):
                     category_device[category] = torch_cpu_device
 
             pyt_tensors = dict()
+            if self._zero_copy:
+                iteration = self._handoffs[i].share(torch_gpu_device)
+                for category in self._output_categories:
+                    pyt_tensors[category] = _to_torch_tensor(category_outputs[category].as_tensor(),
+                                                             iteration,
+                                                             category_device[category])
+                data_batches[i] = pyt_tensors
+                continue
+
             for category in self._output_categories:
                 pyt_tensors[category] = torch.empty(category_shapes[category],
                                                     dtype=category_torch_type[category],
@@ -222,16 +369,20 @@ class DALIGenericIterator(_DaliBaseIterator):
 
             data_batches[i] = pyt_tensors
 
-            # Copy data from DALI Tensors to torch tensors
-            for category, tensor in category_tensors.items():
-                if isinstance(tensor, (TensorGPU, TensorListGPU)):
+            # Copy data from DALI TensorLists to torch tensors
+            for category, tensor_list in category_outputs.items():
+                if isinstance(tensor_list, TensorListGPU):
                     # Using same cuda_stream used by torch.zeros to set the memory
                     stream = torch.cuda.current_stream(device=pyt_tensors[category].device)
-                    feed_ndarray(tensor, pyt_tensors[category], cuda_stream=stream)
+                    _copy_to_torch(tensor_list, pyt_tensors[category], cuda_stream=stream)
                 else:
-                    feed_ndarray(tensor, pyt_tensors[category])
+                    _copy_to_torch(tensor_list, pyt_tensors[category])
 
-        self._schedule_runs()
+        if self._zero_copy:
+            # the outputs are released when PyTorch frees the tensors using them
+            for handoff in self._handoffs:
+                handoff.release()
+        self._schedule_runs(release_outputs=not self._zero_copy)
 
         self._advance_and_check_drop_last()
 
@@ -332,6 +483,16 @@ class DALIClassificationIterator(DALIGenericIterator):
     prepare_first_batch : bool, optional, default = True
                 Whether DALI should buffer the first batch right after the creation of the iterator,
                 so one batch is already prepared when the iterator is prompted for the data
+    zero_copy : bool, optional, default = False
+                Whether the returned tensors should use the memory of the pipeline outputs instead
+                of a copy of them. The output buffers of an iteration are returned to the pipeline
+                when PyTorch frees all the tensors using them, so the pipeline prefetches only
+                into the buffers not referenced by the earlier batches. ``prefetch_queue_depth``
+                of the pipelines must exceed the number of batches kept alive at a time - the
+                iterator raises an error when all the buffers are referenced.
+                The returned tensors must not be written to.
+                Requires the pipelines to be executed asynchronously, with a fixed prefetch
+                queue depth.
 
     Example
     -------
@@ -358,7 +519,8 @@ class DALIClassificationIterator(DALIGenericIterator):
                  dynamic_shape=False,
                  last_batch_padded=False,
                  last_batch_policy=LastBatchPolicy.FILL,
-                 prepare_first_batch=True):
+                 prepare_first_batch=True,
+                 zero_copy=False):
         super(DALIClassificationIterator, self).__init__(pipelines, ["data", "label"],
                                                          size,
                                                          reader_name=reader_name,
@@ -367,7 +529,8 @@ class DALIClassificationIterator(DALIGenericIterator):
                                                          dynamic_shape=dynamic_shape,
                                                          last_batch_padded=last_batch_padded,
                                                          last_batch_policy=last_batch_policy,
-                                                         prepare_first_batch=prepare_first_batch)
+                                                         prepare_first_batch=prepare_first_batch,
+                                                         zero_copy=zero_copy)
 
 
 class TorchPythonFunction(ops.PythonFunctionBase):
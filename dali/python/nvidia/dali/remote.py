@@ -0,0 +1,385 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Remote execution of the CPU stage of a pipeline.
+
+The CPU stage runs in a :class:`PipelineServer` on a worker node, which streams the batches
+over TCP to the trainers. There, :func:`inputs` feeds them to the pipeline running the mixed
+and GPU stages::
+
+    # on each worker node
+    @pipeline_def(batch_size=64, num_threads=16, device_id=None)
+    def cpu_stage():
+        jpegs, labels = fn.readers.file(file_root=images_dir, shard_id=worker_id,
+                                        num_shards=num_workers)
+        return fn.decoders.image(jpegs, device="cpu"), labels
+
+    remote.PipelineServer(cpu_stage(), port=5000).serve_forever()
+
+    # on the trainer
+    @pipeline_def(batch_size=64, num_threads=2, device_id=0)
+    def gpu_stage():
+        images, labels = remote.inputs(["worker1:5000", "worker2:5000"])
+        return fn.resize(images.gpu(), size=[224, 224]), labels
+
+A worker can also be started from a serialized pipeline with
+``python -m nvidia.dali.remote --port 5000 pipeline.bin``.
+"""
+
+import json
+import socket
+import struct
+import threading
+import zlib
+
+import numpy as np
+
+from nvidia.dali import fn
+from nvidia.dali import tensors as _tensors
+from nvidia.dali.pipeline import Pipeline
+
+# requests
+_NEXT = b"N"
+_RESET = b"R"
+# replies
+_BATCH = b"B"
+_END = b"E"
+_ERROR = b"X"
+
+_size = struct.Struct("<Q")
+
+
+def _parse_address(address):
+    if isinstance(address, str):
+        host, _, port = address.rpartition(":")
+        return host, int(port)
+    return tuple(address)
+
+
+def _recv_exact(sock, size):
+    buf = bytearray(size)
+    view = memoryview(buf)
+    received = 0
+    while received < size:
+        n = sock.recv_into(view[received:])
+        if n == 0:
+            raise ConnectionError("The connection was closed by the peer.")
+        received += n
+    return buf
+
+
+def _send_msg(sock, kind, payload=b""):
+    sock.sendall(kind + _size.pack(len(payload)) + payload)
+
+
+def _recv_msg(sock):
+    header = _recv_exact(sock, 1 + _size.size)
+    kind = bytes(header[:1])
+    size, = _size.unpack_from(header, 1)
+    return kind, _recv_exact(sock, size)
+
+
+def _encode_batch(outputs, compression):
+    """Returns the description of the batch and the buffers with its data"""
+    desc = []
+    buffers = []
+    for batch in outputs:
+        if not isinstance(batch, _tensors.TensorListCPU):
+            raise RuntimeError("The outputs of the served pipeline must reside in the CPU memory.")
+        samples = [np.asarray(batch[i]) for i in range(len(batch))]
+        dtype = samples[0].dtype.str if samples else "|u1"
+        if compression == "zlib":
+            compressor = zlib.compressobj(1)
+            chunks = [compressor.compress(sample) for sample in samples]
+            chunks.append(compressor.flush())
+        else:
+            chunks = [memoryview(np.ascontiguousarray(sample)).cast("B") for sample in samples]
+        desc.append({
+            "dtype": dtype,
+            "layout": batch.layout(),
+            "shapes": [sample.shape for sample in samples],
+            "size": sum(len(chunk) for chunk in chunks),
+        })
+        buffers += chunks
+    return {"compression": compression, "outputs": desc}, buffers
+
+
+def _decode_batch(sock, desc):
+    outputs = []
+    for out in desc["outputs"]:
+        data = _recv_exact(sock, out["size"])
+        if desc["compression"] == "zlib":
+            data = zlib.decompress(data)
+        dtype = np.dtype(out["dtype"])
+        samples = []
+        offset = 0
+        for shape in out["shapes"]:
+            count = int(np.prod(shape))
+            samples.append(np.frombuffer(data, dtype, count, offset).reshape(shape))
+            offset += count * dtype.itemsize
+        outputs.append(_tensors.TensorListCPU(samples, out["layout"]))
+    return outputs
+
+
+class PipelineServer:
+    """Runs a CPU-only pipeline and sends its batches to the remote :func:`inputs`.
+
+    The clients are served one at a time, in the order of connecting; a trainer which needs
+    more throughput than one worker provides connects to several of them. Each batch request
+    runs one iteration of the pipeline - the client keeps a few requests in flight, so that
+    the worker computes the next batches while the previous ones are being transferred.
+    When the pipeline reaches the end of its data, the client is notified and can reset it
+    to start the next epoch.
+
+    Parameters
+    ----------
+    `pipeline` : :class:`Pipeline` or str or bytes
+        The pipeline to run, or its serialized form, as returned by :meth:`Pipeline.serialize`.
+        It must not contain any mixed or GPU operators - a serialized pipeline is instantiated
+        with ``device_id=None``.
+    `host` : str, optional, default = ""
+        The address to listen on; by default, all the interfaces of the node.
+    `port` : int, optional, default = 0
+        The port to listen on. 0 selects a free port, see :attr:`address`.
+    `compression` : str, optional, default = None
+        ``"zlib"`` compresses the data of the batches, which trades the CPU time of the worker
+        and the trainer for the network bandwidth. ``None`` sends the data as is.
+    `**kwargs`
+        Other arguments passed to :meth:`Pipeline.deserialize` for a serialized pipeline.
+    """
+
+    def __init__(self, pipeline, host="", port=0, compression=None, **kwargs):
+        if compression not in (None, "zlib"):
+            raise ValueError(f"Unsupported compression: {compression}. Use None or \"zlib\".")
+        if isinstance(pipeline, (str, bytes)):
+            pipeline = Pipeline.deserialize(serialized_pipeline=pipeline, device_id=None,
+                                            **kwargs)
+        elif pipeline.device_id is not None:
+            raise ValueError("The served pipeline must be created with `device_id=None`.")
+        self._pipe = pipeline
+        self._pipe.build()
+        self._compression = compression
+        self._listener = socket.create_server((host, port))
+        self._thread = None
+        self._conn = None
+        self._closed = False
+
+    @property
+    def address(self):
+        """The ``(host, port)`` on which the server listens."""
+        return self._listener.getsockname()[:2]
+
+    def serve_forever(self):
+        """Accepts the clients and serves them, until :meth:`close` is called."""
+        while not self._closed:
+            try:
+                conn, _ = self._listener.accept()
+            except OSError:
+                break  # closed
+            with conn:
+                conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+                self._conn = conn
+                try:
+                    self._serve(conn)
+                except OSError:
+                    pass  # disconnected
+                self._conn = None
+
+    def start(self):
+        """Serves the clients in a background thread."""
+        self._thread = threading.Thread(target=self.serve_forever, daemon=True)
+        self._thread.start()
+
+    def close(self):
+        """Disconnects the current client and stops accepting new ones."""
+        self._closed = True
+        for sock in (self._listener, self._conn):
+            try:
+                sock.shutdown(socket.SHUT_RDWR)
+            except (OSError, AttributeError):
+                pass
+        self._listener.close()
+        if self._thread is not None:
+            self._thread.join()
+
+    def _serve(self, conn):
+        hello = {"num_outputs": len(self._pipe.output_dtype()),
+                 "batch_size": self._pipe.max_batch_size}
+        _send_msg(conn, _BATCH, json.dumps(hello).encode())
+        at_end = False
+        while True:
+            kind, _ = _recv_msg(conn)
+            if kind == _RESET:
+                self._pipe.reset()
+                at_end = False
+                continue
+            if at_end:
+                _send_msg(conn, _END)
+                continue
+            try:
+                outputs = self._pipe.run()
+            except StopIteration:
+                at_end = True
+                _send_msg(conn, _END)
+                continue
+            except Exception as e:
+                # the pipeline can't be trusted to continue, the client's iteration fails
+                _send_msg(conn, _ERROR, str(e).encode())
+                return
+            desc, buffers = _encode_batch(outputs, self._compression)
+            _send_msg(conn, _BATCH, json.dumps(desc).encode())
+            for buf in buffers:
+                conn.sendall(buf)
+
+
+class _Worker:
+    def __init__(self, address, prefetch):
+        self._sock = socket.create_connection(_parse_address(address))
+        self._sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self._prefetch = prefetch
+        self._in_flight = 0
+        self.at_end = False
+        _, hello = _recv_msg(self._sock)
+        hello = json.loads(hello.decode())
+        self.num_outputs = hello["num_outputs"]
+        self.batch_size = hello["batch_size"]
+
+    def request(self):
+        while not self.at_end and self._in_flight < self._prefetch:
+            _send_msg(self._sock, _NEXT)
+            self._in_flight += 1
+
+    def receive(self):
+        """Returns the next batch, or None at the end of the data of the worker."""
+        self.request()
+        kind, payload = _recv_msg(self._sock)
+        self._in_flight -= 1
+        if kind == _ERROR:
+            raise RuntimeError("The remote pipeline failed: " + payload.decode())
+        if kind == _END:
+            self.at_end = True
+            return None
+        return _decode_batch(self._sock, json.loads(payload.decode()))
+
+    def reset(self):
+        # the requests sent after the end of the data are answered before the reset
+        while self._in_flight:
+            self._recv_end()
+        _send_msg(self._sock, _RESET)
+        self.at_end = False
+
+    def _recv_end(self):
+        kind, payload = _recv_msg(self._sock)
+        self._in_flight -= 1
+        if kind == _BATCH:
+            _decode_batch(self._sock, json.loads(payload.decode()))
+
+    def close(self):
+        self._sock.close()
+
+
+class RemoteSource:
+    """The source of the external source fed by the remote workers, see :func:`inputs`.
+
+    Takes the batches from the workers in turns - an epoch ends when all of them reached
+    the end of their data, and the next one starts with a reset of all the workers."""
+
+    def __init__(self, addresses, prefetch=2):
+        if isinstance(addresses, str):
+            addresses = [addresses]
+        if prefetch < 1:
+            raise ValueError("At least one batch must be requested at a time.")
+        self._workers = [_Worker(address, prefetch) for address in addresses]
+        if not self._workers:
+            raise ValueError("At least one worker address is required.")
+        self.num_outputs = self._workers[0].num_outputs
+        if any(w.num_outputs != self.num_outputs for w in self._workers):
+            raise ValueError("All the workers must run pipelines with the same number of outputs.")
+        self.batch_size = max(w.batch_size for w in self._workers)
+        self._next_worker = 0
+        self._started = False
+        for worker in self._workers:
+            worker.request()
+
+    def __iter__(self):
+        if self._started:
+            for worker in self._workers:
+                worker.reset()
+                worker.request()
+        self._started = True
+        self._next_worker = 0
+        return self
+
+    def __next__(self):
+        active = [w for w in self._workers if not w.at_end]
+        while active:
+            worker = active[self._next_worker % len(active)]
+            batch = worker.receive()
+            if batch is not None:
+                self._next_worker += 1
+                return tuple(batch)
+            active.remove(worker)
+        raise StopIteration
+
+    def close(self):
+        for worker in self._workers:
+            worker.close()
+
+
+def inputs(addresses, prefetch=2, **kwargs):
+    """Returns the outputs of the pipelines served by the remote workers.
+
+    Connects to the :class:`PipelineServer` instances at `addresses` and creates an external
+    source, which produces their batches in turns. The workers should process disjoint parts
+    of the data (e.g. different shards of the readers); the epoch ends when all of them
+    reached the end of their data. The batch size of the pipeline must not be smaller than
+    the batch size of any worker.
+
+    Parameters
+    ----------
+    `addresses` : str or list of str
+        The ``"host:port"`` addresses of the workers.
+    `prefetch` : int, optional, default = 2
+        The number of batches requested from each worker ahead of time.
+    `**kwargs`
+        Other arguments of :meth:`nvidia.dali.fn.external_source`.
+
+    Returns
+    -------
+    A list of :class:`DataNode` objects - one for each output of the remote pipelines.
+    """
+    source = RemoteSource(addresses, prefetch)
+    outputs = fn.external_source(source=source, num_outputs=source.num_outputs, batch=True,
+                                 cycle="raise", **kwargs)
+    return list(outputs)
+
+
+def _main():
+    import argparse
+    parser = argparse.ArgumentParser(description="Serves a serialized CPU-only DALI pipeline.")
+    parser.add_argument("pipeline", help="the file with the serialized pipeline")
+    parser.add_argument("--host", default="")
+    parser.add_argument("--port", type=int, required=True)
+    parser.add_argument("--compression", choices=["zlib"], default=None)
+    parser.add_argument("--num_threads", type=int, default=None)
+    args = parser.parse_args()
+    with open(args.pipeline, "rb") as f:
+        serialized = f.read()
+    kwargs = {"num_threads": args.num_threads} if args.num_threads else {}
+    server = PipelineServer(serialized, args.host, args.port, args.compression, **kwargs)
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    _main()
@@ -0,0 +1,219 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from nvidia.dali import fn
+from nvidia.dali import tensors as _tensors
+from nvidia.dali.pipeline import Pipeline
+
+
+class _ShardedSource:
+    """Runs the host pipeline and splits each of its batches into shards.
+
+    A batch is kept until every shard has taken its part - the device pipelines may prefetch
+    a different number of iterations."""
+
+    def __init__(self, pipeline, device_ids, peer_copies):
+        self._pipe = pipeline
+        self._device_ids = device_ids
+        self._num_shards = len(device_ids)
+        self._peer_copies = peer_copies
+        self.reset()
+
+    def reset(self):
+        self._shards = {}
+        self._pending = {}
+        self._next_iter = 0
+        self._end_iter = None
+
+    def get(self, shard_id, iteration):
+        while iteration >= self._next_iter:
+            if self._end_iter is not None:
+                raise StopIteration
+            try:
+                outputs = self._pipe.run()
+            except StopIteration:
+                self._end_iter = self._next_iter
+                raise
+            self._shards[self._next_iter] = [self._split(out) for out in outputs]
+            self._pending[self._next_iter] = self._num_shards
+            self._next_iter += 1
+        # the copies in the shards are independent of the buffers of the host pipeline
+        shard = tuple(shards[shard_id] for shards in self._shards[iteration])
+        self._pending[iteration] -= 1
+        if self._pending[iteration] == 0:
+            del self._shards[iteration]
+            del self._pending[iteration]
+        return shard
+
+    def _split(self, batch):
+        if not isinstance(batch, _tensors.TensorListCPU):
+            raise RuntimeError("The outputs of the host pipeline must reside in the CPU memory.")
+        if len(batch) % self._num_shards != 0:
+            raise RuntimeError(
+                f"The batch size of the host pipeline ({len(batch)}) is not divisible by "
+                f"the number of shards ({self._num_shards}).")
+        shard_size = len(batch) // self._num_shards
+        if self._peer_copies:
+            # one upload of the whole batch, the shards are copied between the devices
+            gpu_batch = batch._as_gpu(self._device_ids[0])
+            return [gpu_batch._copy_to_device(device_id, s * shard_size, (s + 1) * shard_size)
+                    for s, device_id in enumerate(self._device_ids)]
+        return [_tensors.TensorListCPU([batch[i] for i in range(s * shard_size,
+                                                               (s + 1) * shard_size)],
+                                       batch.layout())
+                for s in range(self._num_shards)]
+
+
+class _ShardCallback:
+    """The source of the external source of one device pipeline"""
+
+    def __init__(self, source, shard_id):
+        self._source = source
+        self._shard_id = shard_id
+        self.reset()
+
+    def reset(self):
+        self._iter = 0
+
+    def __call__(self):
+        shard = self._source.get(self._shard_id, self._iter)
+        self._iter += 1
+        return shard
+
+
+class ShardedPipeline:
+    """Runs the host part of the processing once, for all the shards, and spreads the device
+    part across several GPUs, producing one output shard per device.
+
+    Instead of a separate pipeline per GPU, each with its own readers, host decoders, thread pool
+    and caches, one CPU-only `host_pipeline` processes the data of all the shards. Its batches
+    are split evenly between the devices and passed to the device pipelines, which run the mixed
+    and GPU operators defined by `device_fn`::
+
+        @pipeline_def(batch_size=shard_batch_size * num_gpus, num_threads=8, device_id=None)
+        def host_pipe():
+            jpegs, labels = fn.readers.file(file_root=images_dir)
+            images = fn.decoders.image(jpegs, device="cpu")
+            return images, labels
+
+        def device_fn(images, labels):
+            images = fn.resize(images.gpu(), size=[224, 224])
+            return images, labels
+
+        pipe = ShardedPipeline(host_pipe(), device_fn, device_ids=range(num_gpus))
+        pipe.build()
+        shards = pipe.run()  # shards[i] contains the outputs for device_ids[i]
+
+    Each shard of a host batch is copied once, in the host memory, before it is passed to
+    the device pipeline. With ``peer_copies=True``, the whole batch is instead uploaded to
+    the first device and the shards are copied from there to the other devices, directly when
+    the devices support the peer access (e.g. over NVLink). This takes the host-to-device
+    transfers off the links of the other devices, which helps on the nodes where these links
+    are the bottleneck. The inputs of `device_fn` are then GPU data nodes, so the host pipeline
+    should do all the processing which needs the data on the host (e.g. decoding).
+
+    Parameters
+    ----------
+    `host_pipeline` : :class:`Pipeline`
+        The pipeline which reads and processes the data on the host. It must run on the CPU only
+        (``device_id=None``) and its batch size must be divisible by the number of devices.
+    `device_fn` : callable
+        Defines the processing of one shard on the device - called with the outputs of
+        `host_pipeline` (one :class:`DataNode` for each), it returns the outputs of the sharded
+        pipeline.
+    `device_ids` : list of int
+        The devices, on which the shards are processed.
+    `num_threads` : int, optional, default = 1
+        The number of CPU threads used by each device pipeline.
+    `peer_copies` : bool, optional, default = False
+        If True, the batch is uploaded once, to the first device, and distributed to
+        the other devices by peer-to-peer copies.
+    `**kwargs`
+        Other arguments of the device pipelines, see :class:`Pipeline`.
+    """
+
+    def __init__(self, host_pipeline, device_fn, device_ids, num_threads=1, peer_copies=False,
+                 **kwargs):
+        self._device_ids = list(device_ids)
+        if not self._device_ids:
+            raise ValueError("At least one device is required.")
+        if host_pipeline.device_id is not None:
+            raise ValueError("The host pipeline must be created with `device_id=None`.")
+        if host_pipeline.max_batch_size % len(self._device_ids) != 0:
+            raise ValueError(
+                f"The batch size of the host pipeline ({host_pipeline.max_batch_size}) must be "
+                f"divisible by the number of devices ({len(self._device_ids)}).")
+        self._host_pipe = host_pipeline
+        self._device_fn = device_fn
+        self._num_threads = num_threads
+        self._peer_copies = peer_copies
+        self._kwargs = kwargs
+        self._source = None
+        self._callbacks = []
+        self._device_pipes = []
+        self._built = False
+
+    @property
+    def device_pipelines(self):
+        """The pipelines processing the shards, in the order of `device_ids`."""
+        return self._device_pipes
+
+    def build(self):
+        """Builds the host pipeline and a pipeline for each device."""
+        if self._built:
+            return
+        self._host_pipe.build()
+        num_inputs = len(self._host_pipe.output_dtype())
+        num_shards = len(self._device_ids)
+        shard_batch_size = self._host_pipe.max_batch_size // num_shards
+        self._source = _ShardedSource(self._host_pipe, self._device_ids, self._peer_copies)
+        for shard_id, device_id in enumerate(self._device_ids):
+            callback = _ShardCallback(self._source, shard_id)
+            pipe = Pipeline(batch_size=shard_batch_size, num_threads=self._num_threads,
+                            device_id=device_id, **self._kwargs)
+            with pipe:
+                inputs = fn.external_source(source=callback, num_outputs=num_inputs,
+                                            device="gpu" if self._peer_copies else "cpu",
+                                            no_copy=True)
+                outputs = self._device_fn(*inputs)
+                if not isinstance(outputs, (tuple, list)):
+                    outputs = (outputs,)
+                pipe.set_outputs(*outputs)
+            pipe.build()
+            self._callbacks.append(callback)
+            self._device_pipes.append(pipe)
+        self._built = True
+
+    def run(self):
+        """Runs one iteration on all the devices.
+
+        :return:
+            A list with the outputs of each device pipeline
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        # the devices work concurrently - the results are collected after all are scheduled
+        for pipe in self._device_pipes:
+            pipe.schedule_run()
+        return [pipe.outputs() for pipe in self._device_pipes]
+
+    def reset(self):
+        """Resets the host pipeline and the device pipelines, after they reached the end."""
+        self._host_pipe.reset()
+        for pipe in self._device_pipes:
+            pipe.reset()
+        if self._source is not None:
+            self._source.reset()
+        for callback in self._callbacks:
+            callback.reset()
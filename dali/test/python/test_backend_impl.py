@@ -44,6 +44,14 @@ def test_create_tensorlist_as_tensor():
     assert_array_equal(np.array(tensor), tensorlist.as_array())
 
 
+def test_create_from_strided():
+    arr = np.random.rand(4, 5, 6)
+    for view in [arr.transpose(2, 0, 1), arr[:, ::2, :], arr[::-1]]:
+        assert not view.flags.c_contiguous
+        assert_array_equal(view, np.array(TensorCPU(view, "HWC")))
+        assert_array_equal(view, TensorListCPU(view, "HWC").as_array())
+
+
 def test_empty_tensor_tensorlist():
     arr = np.array([], dtype=np.float32)
     tensor = TensorCPU(arr, "NHWC")
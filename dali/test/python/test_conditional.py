@@ -0,0 +1,215 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import nvidia.dali.fn as fn
+import nvidia.dali.types as types
+from nvidia.dali import pipeline_def
+from nvidia.dali.conditional import if_else
+import numpy as np
+from nose.tools import nottest
+from nose_utils import assert_raises
+from test_utils import check_batch
+
+batch_size = 16
+
+
+def sample_source(sample_info):
+    rng = np.random.default_rng(sample_info.idx_in_epoch)
+    shape = rng.integers(1, 20, size=2)
+    data = rng.integers(0, 100, size=shape).astype(np.int32)
+    label = np.array(rng.integers(0, 3), dtype=np.int32)
+    return data, label
+
+
+def reference(data, label):
+    return data * 2 if label == 0 else data + 100
+
+
+@nottest
+def _test_if_else(device, predicate_fn):
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+    def pipe():
+        data, label = fn.external_source(sample_source, num_outputs=2, batch=False)
+        if device == "gpu":
+            data = data.gpu()
+        out = if_else(predicate_fn(label), lambda x: x * 2, lambda x: x + 100, data)
+        return out, data, label
+
+    p = pipe()
+    p.build()
+    for _ in range(5):
+        out, data, label = p.run()
+        if device == "gpu":
+            out = out.as_cpu()
+            data = data.as_cpu()
+        ref = [reference(data.at(i), label.at(i)) for i in range(batch_size)]
+        check_batch(out, ref, batch_size)
+
+
+def test_if_else():
+    for device in ["cpu", "gpu"]:
+        yield _test_if_else, device, lambda label: label == 0
+        # integral predicates are accepted as well
+        yield _test_if_else, device, lambda label: fn.cast(label == 0, dtype=types.INT32)
+
+
+def test_if_else_cpu_only():
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=None)
+    def pipe():
+        data, label = fn.external_source(sample_source, num_outputs=2, batch=False)
+        return if_else(label == 0, lambda x: x * 2, lambda x: x + 100, data), data, label
+
+    p = pipe()
+    p.build()
+    for _ in range(3):
+        out, data, label = p.run()
+        check_batch(out, [reference(data.at(i), label.at(i)) for i in range(batch_size)],
+                    batch_size)
+
+
+def test_branch_runs_on_its_samples():
+    batch_sizes = {"true": [], "false": []}
+
+    def record(branch):
+        def impl(samples):
+            batch_sizes[branch].append(len(samples))
+            return samples
+        return impl
+
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0,
+                  exec_async=False, exec_pipelined=False)
+    def pipe():
+        data, label = fn.external_source(sample_source, num_outputs=2, batch=False)
+        out = if_else(label == 0,
+                      lambda x: fn.python_function(x, function=record("true"),
+                                                   batch_processing=True),
+                      lambda x: fn.python_function(x, function=record("false"),
+                                                   batch_processing=True),
+                      data)
+        return out, data, label
+
+    p = pipe()
+    p.build()
+    for _ in range(3):
+        out, data, label = p.run()
+        labels = np.array([label.at(i) for i in range(batch_size)])
+        num_true = int(np.sum(labels == 0))
+        assert batch_sizes["true"][-1:] == ([num_true] if num_true else [])
+        assert batch_sizes["false"][-1:] == ([batch_size - num_true] if num_true < batch_size
+                                             else [])
+        check_batch(out, data, batch_size)
+        batch_sizes["true"].clear()
+        batch_sizes["false"].clear()
+
+
+@nottest
+def _test_one_branch_empty(device, all_true):
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+    def pipe():
+        data, label = fn.external_source(sample_source, num_outputs=2, batch=False)
+        if device == "gpu":
+            data = data.gpu()
+        predicate = label >= 0 if all_true else label < 0
+        return if_else(predicate, lambda x: x * 2, lambda x: x - 1, data), data
+
+    p = pipe()
+    p.build()
+    for _ in range(3):
+        out, data = p.run()
+        if device == "gpu":
+            out = out.as_cpu()
+            data = data.as_cpu()
+        ref = [data.at(i) * 2 if all_true else data.at(i) - 1 for i in range(batch_size)]
+        check_batch(out, ref, batch_size)
+
+
+def test_one_branch_empty():
+    for device in ["cpu", "gpu"]:
+        for all_true in [False, True]:
+            yield _test_one_branch_empty, device, all_true
+
+
+def test_nested():
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+    def pipe():
+        data, label = fn.external_source(sample_source, num_outputs=2, batch=False)
+
+        def not_zero(x, lbl):
+            return if_else(lbl == 1, lambda y: y - 1, lambda y: y + 1, x)
+
+        return if_else(label == 0, lambda x, lbl: x, not_zero, data, label), data, label
+
+    p = pipe()
+    p.build()
+    for _ in range(3):
+        out, data, label = p.run()
+        ref = []
+        for i in range(batch_size):
+            sample, lbl = data.at(i), label.at(i)
+            ref.append(sample if lbl == 0 else sample - 1 if lbl == 1 else sample + 1)
+        check_batch(out, ref, batch_size)
+
+
+def test_multiple_outputs():
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+    def pipe():
+        data, label = fn.external_source(sample_source, num_outputs=2, batch=False)
+        a, b = if_else(label == 0,
+                       lambda x: (x, x.gpu() * 3),
+                       lambda x: (x + 1, (x * 4).gpu()),
+                       data)
+        return a, b, data, label
+
+    p = pipe()
+    p.build()
+    a, b, data, label = p.run()
+    b = b.as_cpu()
+    for i in range(batch_size):
+        sample, lbl = data.at(i), label.at(i)
+        np.testing.assert_array_equal(a.at(i), sample if lbl == 0 else sample + 1)
+        np.testing.assert_array_equal(b.at(i), sample * 3 if lbl == 0 else sample * 4)
+
+
+def test_mismatched_outputs():
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+    def pipe():
+        data, label = fn.external_source(sample_source, num_outputs=2, batch=False)
+        return if_else(label == 0, lambda x: x, lambda x: fn.cast(x, dtype=types.FLOAT), data)
+
+    with assert_raises(RuntimeError,
+                       glob="*outputs of both branches must have the same type*"):
+        p = pipe()
+        p.build()
+        for _ in range(3):
+            p.run()
+
+
+def test_number_of_outputs():
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+    def pipe():
+        data, label = fn.external_source(sample_source, num_outputs=2, batch=False)
+        return if_else(label == 0, lambda x: (x, x), lambda x: x, data)
+
+    with assert_raises(ValueError, glob="*same number of outputs*"):
+        pipe()
+
+
+def test_gpu_predicate():
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+    def pipe():
+        data, label = fn.external_source(sample_source, num_outputs=2, batch=False)
+        return if_else(label.gpu() == 0, lambda x: x, lambda x: x, data)
+
+    with assert_raises(ValueError, glob="*predicate must be a CPU batch*"):
+        pipe()
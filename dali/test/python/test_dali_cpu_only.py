@@ -1172,11 +1172,15 @@ tested_methods = [
 excluded_methods = [
     "hidden.*",
     "jitter",               # not supported for CPU
+    "random_resized_crop_mirror_normalize",  # not supported for CPU
     "video_reader",         # not supported for CPU
     "video_reader_resize",  # not supported for CPU
     "readers.video",        # not supported for CPU
+    "segmentation.rasterize_polygons",  # not supported for CPU
     "readers.video_resize", # not supported for CPU
     "optical_flow",         # not supported for CPU
+    "bbox_transform",       # not supported for CPU
+    "encoders.jpeg",        # not supported for CPU
 ]
 
 def test_coverage():
@@ -289,6 +289,7 @@ ops_image_custom_args = [
     (fn.color_space_conversion, {'image_type': types.BGR, 'output_type': types.RGB}),
     (fn.coord_transform, {'M': .5, 'T': 2}),
     (fn.crop, {'crop': (5, 5)}),
+    (fn.encoders.jpeg, {'devices': ['gpu']}),
     (fn.erase, {'anchor': [0.3], 'axis_names': "H", 'normalized_anchor': True,
                 'shape': [0.1], 'normalized_shape': True}),
     (fn.fast_resize_crop_mirror, {'crop': [5, 5], 'resize_shorter': 10, 'devices': ['cpu']}),
@@ -340,10 +341,11 @@ def test_float_array_ops():
 random_ops = [
     (fn.jitter, {'devices': ['gpu']}),
     (fn.random_resized_crop, {'size': 69}),
+    (fn.random_resized_crop_mirror_normalize, {'devices': ['gpu'], 'size': 69}),
     (fn.noise.gaussian, {}),
     (fn.noise.shot, {}),
     (fn.noise.salt_and_pepper, {}),
-    (fn.segmentation.random_mask_pixel, {'devices': ['cpu']}),
+    (fn.segmentation.random_mask_pixel, {'devices': ['cpu', 'gpu']}),
     (fn.roi_random_crop, {'devices': ['cpu'], 'crop_shape': [10, 15, 3], 'roi_start': [25, 20, 0],
                           'roi_shape': [40, 30, 3]})
 ]
@@ -520,7 +522,7 @@ def test_random_object_bbox():
                 [0, 2, 0, 1],
                 [0, 2, 2, 1]])
     ]
-    run_pipeline(get_data, pipeline_fn=pipe, devices=['cpu'])
+    run_pipeline(get_data, pipeline_fn=pipe, devices=['cpu', 'gpu'])
 
 def test_math_ops():
     def pipe(max_batch_size, input_data, device):
@@ -716,7 +718,24 @@ def test_bbox_paste():
         return pipe
 
     check_pipeline(generate_data(31, 13, custom_shape_generator(150, 250, 4, 4)), pipe, eps=.5,
-                   devices=['cpu'])
+                   devices=['cpu', 'gpu'])
+
+
+def test_bbox_transform():
+    def pipe(max_batch_size, input_data, device):
+        pipe = Pipeline(batch_size=max_batch_size, num_threads=4, device_id=0)
+        data = fn.external_source(source=input_data, cycle=False, device=device)
+        crop_anchor = fn.random.uniform(range=(0, 0.5), shape=2)
+        crop_shape = fn.random.uniform(range=(0.5, 1), shape=2)
+        flip = fn.random.coin_flip()
+        paste_ratio = fn.random.uniform(range=(1, 2))
+        processed = fn.bbox_transform(data, crop_anchor=crop_anchor, crop_shape=crop_shape,
+                                      horizontal=flip, paste_ratio=paste_ratio)
+        pipe.set_outputs(processed)
+        return pipe
+
+    check_pipeline(generate_data(31, 13, custom_shape_generator(150, 250, 4, 4)), pipe, eps=.5,
+                   devices=['gpu'])
 
 
 def test_coord_flip():
@@ -985,6 +1004,21 @@ def test_segmentation_select_masks():
     check_pipeline(input_data, pipeline_fn=pipe, devices=["cpu"])
 
 
+def test_segmentation_rasterize_polygons():
+    def pipe(max_batch_size, input_data, device):
+        pipe = Pipeline(batch_size=max_batch_size, num_threads=4, device_id=0, seed=1234)
+        with pipe:
+            polygons, vertices, _ = fn.external_source(num_outputs=3, source=input_data)
+            masks = fn.segmentation.rasterize_polygons(polygons, vertices, shape=[20, 30],
+                                                       normalized=True)
+        pipe.set_outputs(masks)
+        return pipe
+    input_data = [make_batch_select_masks(random.randint(5, 31), vertex_ndim=2,
+                                          npolygons_range=(1, 5), nvertices_range=(3, 10))
+                  for _ in range(13)]
+    check_pipeline(input_data, pipeline_fn=pipe, devices=["gpu"])
+
+
 def test_optical_flow():
     if not is_of_supported():
         raise nose.SkipTest('Optical Flow is not supported on this platform')
@@ -1064,6 +1098,7 @@ tested_methods = [
     "color_space_conversion",
     "coord_transform",
     "crop",
+    "encoders.jpeg",
     "erase",
     "fast_resize_crop_mirror",
     "flip",
@@ -1084,6 +1119,7 @@ tested_methods = [
     "to_decibels",
     "jitter",
     "random_resized_crop",
+    "random_resized_crop_mirror_normalize",
     "cast",
     "copy",
     "crop",
@@ -1104,6 +1140,7 @@ tested_methods = [
     "constant",
     "mfcc",
     "bbox_paste",
+    "bbox_transform",
     "sequence_rearrange",
     "coord_flip",
     "lookup_table",
@@ -1121,6 +1158,7 @@ tested_methods = [
     "random.normal",
     "arithmetic_generic_op",
     "segmentation.select_masks",
+    "segmentation.rasterize_polygons",
     "expand_dims",
     "tensor_subscript",
     "subscript_dim_check",
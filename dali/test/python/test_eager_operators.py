@@ -193,3 +193,24 @@ def _test_disqualified_argument(key):
 def test_disqualified_arguments():
     for arg in ['bytes_per_sample_hint', 'preserve', 'seed']:
         yield _test_disqualified_argument, arg
+
+
+def test_reused_outputs_cpu():
+    # The outputs of the previous calls are still referenced, so their memory can't be reused.
+    inputs = [tensors.TensorListCPU(np.array(get_data(i)), layout="HWC") for i in range(5)]
+    outputs = [eager.flip(input_tl, horizontal=1) for input_tl in inputs]
+    for input_tl, out in zip(inputs, outputs):
+        check_batch(out, [np.flip(np.array(sample), axis=1) for sample in input_tl], batch_size)
+
+
+def test_no_sync_gpu():
+    inputs = [tensors.TensorListCPU(np.array(get_data(i)), layout="HWC") for i in range(5)]
+    outputs = []
+    with eager.no_sync():
+        for input_tl in inputs:
+            with eager.no_sync():
+                out = eager.flip(input_tl.as_gpu(), horizontal=1)
+            outputs.append(eager.flip(out, vertical=1))
+    for input_tl, out in zip(inputs, outputs):
+        ref = [np.flip(np.array(sample), axis=(0, 1)) for sample in input_tl]
+        check_batch(out.as_cpu(), ref, batch_size)
@@ -383,3 +383,30 @@ def test_layout_changing():
     src_pipe.build()
     src_pipe.feed_input("input", [np.zeros((1))], layout="W")
     src_pipe.feed_input("input", [np.zeros((1))], layout="H")
+
+
+def test_coalesce_requests():
+    pipe = Pipeline(8, 1, 0, exec_pipelined=False, exec_async=False, prefetch_queue_depth=1,
+                    batch_size_buckets=[2, 4])
+    with pipe:
+        pipe.set_outputs(fn.external_source(name="input", max_batch_delay=0.001))
+    pipe.build()
+    requests = [np.full((1, 3), i, dtype=np.int32) for i in range(5)]
+    for request in requests:
+        pipe.feed_input("input", request)
+    # the requests are taken up to the largest bucket, in their order
+    out, = pipe.run()
+    assert len(out) == 4
+    for i in range(4):
+        np.testing.assert_array_equal(out.at(i), requests[i][0])
+    out, = pipe.run()
+    assert len(out) == 1
+    np.testing.assert_array_equal(out.at(0), requests[4][0])
+
+
+@raises(RuntimeError, glob="only by the CPU ExternalSource")
+def test_coalesce_requests_gpu():
+    pipe = Pipeline(8, 1, 0)
+    with pipe:
+        pipe.set_outputs(fn.external_source(name="input", device="gpu", max_batch_delay=0))
+    pipe.build()
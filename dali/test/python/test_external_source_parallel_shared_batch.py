@@ -56,6 +56,22 @@ def test_serialize_deserialize_random():
                 yield check_serialize_deserialize, batch
 
 
+def test_serialize_deserialize_pinned():
+    batch = [np.full((10, 20), i, dtype=np.int32) for i in range(4)]
+    shm_chunk = BufShmChunk.allocate("chunk_0", 100)
+    with closing(shm_chunk) as shm_chunk:
+        shm_chunk.pin(0)
+        assert shm_chunk.is_pinned
+        # the writer resizes the chunk to fit the batch, the memory must be pinned again
+        writer = SharedBatchWriter(shm_chunk, batch)
+        assert shm_chunk.capacity > 100
+        assert shm_chunk.is_pinned
+        batch_meta = SharedBatchMeta.from_writer(writer)
+        deserialized_batch = deserialize_batch(shm_chunk, batch_meta)
+        for sample, deserialized in zip(batch, deserialized_batch):
+            np.testing.assert_array_equal(sample, deserialized)
+
+
 def worker(start_method, sock, task_queue, res_queue, worker_cb, worker_params):
     if start_method == "spawn":
         task_queue.open_shm(multiprocessing.reduction.recv_handle(sock))
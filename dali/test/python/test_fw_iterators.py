@@ -1510,6 +1510,45 @@ def test_pytorch_feed_ndarray():
     torch_tensor = torch.empty((1), dtype=torch.int8, device = 'cpu')
     assert_raises(AssertionError, feed_ndarray, out, torch_tensor, glob="The element type of DALI Tensor/TensorList doesn't match the element type of the target PyTorch Tensor:")
 
+@pipeline_def
+def zero_copy_test_pipeline():
+    # the samples of the batch `i` are filled with `i`
+    idx = fn.external_source(lambda info: np.array([info.iteration], dtype=np.int32),
+                             batch=False)
+    data = fn.cat(idx, idx, idx)
+    return data.gpu(), data
+
+
+def test_pytorch_zero_copy():
+    from nvidia.dali.plugin.pytorch import DALIGenericIterator as PyTorchIterator
+    batch_size = 4
+    pipe = zero_copy_test_pipeline(batch_size=batch_size, num_threads=1, device_id=0,
+                                   prefetch_queue_depth=3)
+    it = PyTorchIterator(pipe, ["gpu", "cpu"], zero_copy=True)
+    kept = []
+    for i in range(10):
+        batch = next(it)[0]
+        assert batch["gpu"].is_cuda and not batch["cpu"].is_cuda
+        assert list(batch["gpu"].shape) == [batch_size, 3]
+        # the batches kept alive are not overwritten by the following iterations
+        kept = kept[-1:] + [batch]
+        for j, kept_batch in enumerate(kept):
+            expected = i - len(kept) + 1 + j
+            np.testing.assert_equal(kept_batch["gpu"].cpu().numpy(), expected)
+            np.testing.assert_equal(kept_batch["cpu"].numpy(), expected)
+
+
+def test_pytorch_zero_copy_all_buffers_referenced():
+    from nvidia.dali.plugin.pytorch import DALIGenericIterator as PyTorchIterator
+    pipe = zero_copy_test_pipeline(batch_size=2, num_threads=1, device_id=0,
+                                   prefetch_queue_depth=2)
+    it = PyTorchIterator(pipe, ["gpu", "cpu"], zero_copy=True)
+    kept = [next(it), next(it)]
+    with assert_raises(RuntimeError, glob="All 2 output buffers of the pipeline are referenced*"):
+        next(it)
+    kept.pop(0)
+    next(it)
+
 # last_batch_policy type check
 def check_iterator_build_error(ErrorType, Iterator, glob, *args, **kwargs):
     batch_size = 4
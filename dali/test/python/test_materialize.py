@@ -0,0 +1,143 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import tempfile
+import numpy as np
+from numpy.testing import assert_array_equal
+from nose.tools import nottest
+
+import nvidia.dali.fn as fn
+import nvidia.dali.types as types
+from nvidia.dali import pipeline_def, materialize
+from nose_utils import assert_raises
+
+batch_size = 4
+num_samples = 10
+
+
+def sample_data(idx):
+    return np.full((idx % 3 + 1, 2), idx, dtype=np.int32), np.array(idx, dtype=np.int64)
+
+
+def prefix_batches():
+    samples = [sample_data(i) for i in range(num_samples)]
+    return [tuple([s[k] for s in samples[b:b + batch_size]] for k in range(2))
+            for b in range(0, num_samples, batch_size)]
+
+
+@pipeline_def(batch_size=batch_size, num_threads=2, device_id=None)
+def prefix_pipe():
+    data, idx = fn.external_source(source=prefix_batches(), num_outputs=2, cycle=False,
+                                   layout=["XY", ""])
+    return data * 2, idx
+
+
+@pipeline_def(batch_size=batch_size, num_threads=2, device_id=None)
+def read_pipe(path, **kwargs):
+    data, idx = materialize.read(path, **kwargs)
+    return data, idx
+
+
+def read_epoch(pipe):
+    samples = []
+    while True:
+        try:
+            data, idx = pipe.run()
+        except StopIteration:
+            pipe.reset()
+            return samples
+        assert data.layout() == "XY"
+        samples += [(data.at(i), int(idx.at(i))) for i in range(len(idx))]
+
+
+def check_samples(samples, expected_indices):
+    assert [idx for _, idx in samples] == list(expected_indices)
+    for data, idx in samples:
+        assert_array_equal(data, sample_data(idx)[0] * 2)
+
+
+def test_write_read():
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "cache")
+        assert materialize.write(prefix_pipe(), path) == num_samples
+        assert not os.path.exists(path + ".tmp")
+        pipe = read_pipe(path)
+        pipe.build()
+        for _ in range(2):
+            check_samples(read_epoch(pipe), range(num_samples))
+
+
+def test_shuffle():
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "cache")
+        materialize.write(prefix_pipe(), path)
+        pipe = read_pipe(path, shuffle=True, seed=123)
+        pipe.build()
+        epochs = [read_epoch(pipe) for _ in range(3)]
+        orders = [[idx for _, idx in epoch] for epoch in epochs]
+        for epoch, order in zip(epochs, orders):
+            check_samples(epoch, order)
+            assert sorted(order) == list(range(num_samples))
+        assert orders[0] != orders[1] or orders[1] != orders[2]
+
+
+@nottest
+def _test_shards(num_shards):
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "cache")
+        materialize.write(prefix_pipe(), path)
+        all_indices = []
+        for shard_id in range(num_shards):
+            pipe = read_pipe(path, shard_id=shard_id, num_shards=num_shards)
+            pipe.build()
+            samples = read_epoch(pipe)
+            begin = num_samples * shard_id // num_shards
+            end = num_samples * (shard_id + 1) // num_shards
+            check_samples(samples, range(begin, end))
+            all_indices += [idx for _, idx in samples]
+        assert all_indices == list(range(num_samples))
+
+
+def test_shards():
+    for num_shards in [2, 3]:
+        yield _test_shards, num_shards
+
+
+def test_cached():
+    @pipeline_def(batch_size=batch_size, num_threads=2, device_id=None)
+    def pipe(path):
+        data, idx = materialize.cached(prefix_pipe(), path)
+        return data, idx
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "cache")
+        for _ in range(2):
+            p = pipe(path)
+            p.build()
+            check_samples(read_epoch(p), range(num_samples))
+        assert os.listdir(path)
+
+
+def test_random_operators_rejected():
+    @pipeline_def(batch_size=batch_size, num_threads=2, device_id=None)
+    def random_prefix():
+        data = fn.external_source(source=prefix_batches(), num_outputs=2, cycle=False)[0]
+        return data + fn.random.uniform(range=[0, 1], dtype=types.INT32)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        with assert_raises(ValueError, glob="*contains the random operators: random__Uniform*"):
+            materialize.write(random_prefix(), os.path.join(tmp, "cache"))
+        assert materialize.write(random_prefix(), os.path.join(tmp, "cache"),
+                                 allow_random=True) == num_samples
@@ -0,0 +1,91 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import urllib.error
+import urllib.request
+
+import nvidia.dali.fn as fn
+from nvidia.dali import pipeline_def
+from nvidia.dali.metrics import MetricsExporter, metrics_text
+from nose_utils import assert_raises
+from test_utils import get_dali_extra_path
+
+jpeg_folder = os.path.join(get_dali_extra_path(), 'db', 'single', 'jpeg')
+batch_size = 8
+
+
+@pipeline_def(batch_size=batch_size, num_threads=2, device_id=0)
+def decoder_pipe():
+    jpegs, _ = fn.readers.file(file_root=jpeg_folder, name="Reader")
+    images = fn.decoders.image(jpegs, device="mixed")
+    return fn.resize(images, size=[64, 64])
+
+
+def parse_samples(text):
+    samples = {}
+    for line in text.splitlines():
+        if line.startswith("#"):
+            continue
+        name, value = line.rsplit(" ", 1)
+        samples[name] = float(value)
+    return samples
+
+
+def run_pipe(iters=3, **kwargs):
+    pipe = decoder_pipe(**kwargs)
+    pipe.build()
+    for _ in range(iters):
+        pipe.run()
+    return pipe
+
+
+def test_metrics_text():
+    pipe = run_pipe(enable_operator_timing=True)
+    text = metrics_text({"train": pipe})
+    assert "# TYPE dali_stage_iterations_total counter" in text
+    samples = parse_samples(text)
+    for stage in ("cpu", "mixed", "gpu"):
+        key = f'dali_stage_iterations_total{{pipeline="train",stage="{stage}"}}'
+        assert samples[key] >= 3, key
+        key = f'dali_stage_queue_occupancy_max{{pipeline="train",stage="{stage}"}}'
+        assert samples[key] >= 1, key
+        key = f'dali_stage_consumer_wait_seconds_total{{pipeline="train",stage="{stage}"}}'
+        assert samples[key] >= 0, key
+    limiter = sum(v for k, v in samples.items() if k.startswith("dali_pipeline_limiter_ratio{"))
+    assert abs(limiter - 1) < 1e-6
+    assert samples['dali_reader_samples_total{pipeline="train",reader="Reader"}'] >= 3 * batch_size
+    assert samples['dali_reader_epoch_size{pipeline="train",reader="Reader"}'] > 0
+    decoded = sum(v for k, v in samples.items() if k.startswith("dali_decoder_samples_total{"))
+    assert decoded >= 3 * batch_size
+    assert any(k.startswith("dali_memory_pool_reserved_bytes{") for k in samples)
+
+
+def test_metrics_without_timing():
+    pipe = run_pipe(iters=1)
+    samples = parse_samples(metrics_text([pipe], prefix="data"))
+    assert not any(k.startswith("data_stage_") for k in samples)
+    assert 'data_reader_epoch_size{pipeline="0",reader="Reader"}' in samples
+
+
+def test_exporter():
+    pipe = run_pipe(enable_operator_timing=True)
+    with MetricsExporter({"train": pipe}, port=0, addr="127.0.0.1") as exporter:
+        url = f"http://127.0.0.1:{exporter.port}"
+        with urllib.request.urlopen(url + "/metrics") as response:
+            assert response.headers["Content-Type"].startswith("text/plain")
+            text = response.read().decode("utf-8")
+        assert 'dali_operator_runs_total{pipeline="train"' in text
+        with assert_raises(urllib.error.HTTPError, glob="404"):
+            urllib.request.urlopen(url + "/other")
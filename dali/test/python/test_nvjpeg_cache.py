@@ -1,4 +1,4 @@
-# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+# Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -37,23 +37,24 @@ def compare(tl1, tl2):
         assert_array_equal(tl1_cpu.at(i), tl2_cpu.at(i), "cached and non-cached images differ")
 
 class HybridDecoderPipeline(Pipeline):
-    def __init__(self, batch_size, num_threads, device_id, cache_size):
+    def __init__(self, batch_size, num_threads, device_id, cache_size, policy = "threshold",
+                 host_cache_size = 0, shared_name = ""):
         super(HybridDecoderPipeline, self).__init__(batch_size, num_threads, device_id, seed = seed)
         self.input = ops.readers.File(file_root = image_dir)
-        policy = None
-        if cache_size > 0:
-          policy = "threshold"
-        self.decode = ops.decoders.Image(device = 'mixed', output_type = types.RGB, cache_debug = False, cache_size = cache_size, cache_type = policy, cache_batch_copy = True)
+        if cache_size == 0:
+          policy = None
+        self.decode = ops.decoders.Image(device = 'mixed', output_type = types.RGB, cache_debug = False, cache_size = cache_size, cache_type = policy, cache_host_size = host_cache_size, cache_shared_name = shared_name, cache_batch_copy = True)
 
     def define_graph(self):
         jpegs, labels = self.input(name="Reader")
         images = self.decode(jpegs)
         return (images, labels)
 
-def test_nvjpeg_cached():
+def check_nvjpeg_cached(cache_size, policy, host_cache_size = 0, shared_name = ""):
     ref_pipe = HybridDecoderPipeline(batch_size, 1, 0, 0)
     ref_pipe.build()
-    cached_pipe = HybridDecoderPipeline(batch_size, 1, 0, 100)
+    cached_pipe = HybridDecoderPipeline(batch_size, 1, 0, cache_size, policy, host_cache_size,
+                                        shared_name)
     cached_pipe.build()
     epoch_size = ref_pipe.epoch_size("Reader")
 
@@ -69,8 +70,24 @@ def test_nvjpeg_cached():
       out_images, _ = cached_pipe.run()
       compare(ref_images, out_images)
 
+def test_nvjpeg_cached():
+    check_nvjpeg_cached(100, "threshold")
+
+def test_nvjpeg_cached_lru():
+    # a cache smaller than the decoded dataset, so that the images are evicted
+    check_nvjpeg_cached(16, "lru")
+
+def test_nvjpeg_cached_lru_host():
+    check_nvjpeg_cached(16, "lru", 16)
+
+def test_nvjpeg_cached_shared():
+    check_nvjpeg_cached(100, "shared", shared_name = "dali_test_nvjpeg_cache_{}".format(os.getpid()))
+
 def main():
     test_nvjpeg_cached()
+    test_nvjpeg_cached_lru()
+    test_nvjpeg_cached_lru_host()
+    test_nvjpeg_cached_shared()
 
 if __name__ == '__main__':
     main()
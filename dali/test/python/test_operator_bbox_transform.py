@@ -0,0 +1,120 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import nvidia.dali.fn as fn
+from nvidia.dali import pipeline_def
+import numpy as np
+from nose.tools import nottest
+from nose_utils import assert_raises
+from test_utils import check_batch
+
+batch_size = 8
+
+
+def random_boxes(ltrb):
+    n = np.random.randint(1, 50)
+    lo = np.random.uniform(0, 0.9, size=(n, 2)).astype(np.float32)
+    extent = np.random.uniform(0.01, 0.5, size=(n, 2)).astype(np.float32)
+    if ltrb:
+        return np.concatenate([lo, np.minimum(lo + extent, np.float32(1))], axis=1)
+    else:
+        return np.concatenate([lo, np.minimum(extent, np.float32(1) - lo)], axis=1)
+
+
+def crop_boxes(boxes, anchor, shape, ltrb):
+    """Reference crop, following RemapBox"""
+    lo = boxes[:, :2]
+    hi = boxes[:, 2:] if ltrb else boxes[:, :2] + boxes[:, 2:]
+    crop_lo = anchor
+    crop_hi = anchor + shape
+    extent = crop_hi - crop_lo
+    start = np.clip((np.maximum(crop_lo, lo) - crop_lo) / extent, 0, 1)
+    end = np.clip((np.minimum(crop_hi, hi) - crop_lo) / extent, 0, 1)
+    return np.concatenate([start, end if ltrb else end - start], axis=1).astype(np.float32)
+
+
+@nottest
+def _test_vs_chain(ltrb, crop, flip, paste):
+    def source(sample_info):
+        rng = np.random.default_rng(sample_info.idx_in_epoch)
+        np.random.seed(sample_info.idx_in_epoch)
+        boxes = random_boxes(ltrb)
+        anchor = rng.uniform(0, 0.5, size=2).astype(np.float32)
+        shape = rng.uniform(0.2, 0.5, size=2).astype(np.float32)
+        cropped = crop_boxes(boxes, anchor, shape, ltrb) if crop else boxes
+        return boxes, cropped, anchor, shape
+
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0, seed=1234)
+    def pipe():
+        boxes, cropped, anchor, shape = fn.external_source(source, num_outputs=4, batch=False)
+        kwargs = {}
+        ref = cropped
+        if crop:
+            kwargs.update(crop_anchor=anchor, crop_shape=shape)
+        if flip:
+            horz = fn.random.coin_flip(seed=123)
+            vert = fn.random.coin_flip(seed=321)
+            kwargs.update(horizontal=horz, vertical=vert)
+            ref = fn.bb_flip(ref, ltrb=ltrb, horizontal=horz, vertical=vert)
+        if paste:
+            ratio = fn.random.uniform(range=(1, 3), seed=42)
+            px = fn.random.uniform(range=(0, 1), seed=43)
+            py = fn.random.uniform(range=(0, 1), seed=44)
+            kwargs.update(paste_ratio=ratio, paste_x=px, paste_y=py)
+            ref = fn.bbox_paste(ref, ltrb=ltrb, ratio=ratio, paste_x=px, paste_y=py)
+        out = fn.bbox_transform(boxes.gpu(), ltrb=ltrb, **kwargs)
+        return out, ref
+
+    p = pipe()
+    p.build()
+    for _ in range(3):
+        out, ref = p.run()
+        check_batch(out.as_cpu(), ref, batch_size, eps=1e-6)
+
+
+def test_vs_chain():
+    for ltrb in [True, False]:
+        for crop, flip, paste in [(True, False, False), (False, True, False),
+                                  (False, False, True), (True, True, True)]:
+            yield _test_vs_chain, ltrb, crop, flip, paste
+
+
+def test_bbox_paste_gpu():
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0, seed=1234)
+    def pipe():
+        boxes = fn.external_source(lambda: random_boxes(True), batch=False)
+        ratio = fn.random.uniform(range=(1, 3))
+        px = fn.random.uniform(range=(0, 1))
+        py = fn.random.uniform(range=(0, 1))
+        cpu = fn.bbox_paste(boxes, ltrb=True, ratio=ratio, paste_x=px, paste_y=py)
+        gpu = fn.bbox_paste(boxes.gpu(), ltrb=True, ratio=ratio, paste_x=px, paste_y=py)
+        return cpu, gpu
+
+    p = pipe()
+    p.build()
+    for _ in range(3):
+        cpu, gpu = p.run()
+        check_batch(cpu, gpu.as_cpu(), batch_size, eps=1e-6)
+
+
+def test_anchor_without_shape():
+    @pipeline_def(batch_size=1, num_threads=1, device_id=0)
+    def pipe():
+        boxes = fn.external_source(lambda: random_boxes(True), batch=False, device="gpu")
+        return fn.bbox_transform(boxes, crop_anchor=[0.1, 0.1])
+
+    with assert_raises(RuntimeError, glob="``crop_anchor`` cannot be used without ``crop_shape``"):
+        p = pipe()
+        p.build()
+        p.run()
@@ -0,0 +1,58 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import numpy as np
+import nvidia.dali.fn as fn
+from nvidia.dali import pipeline_def
+from test_utils import check_batch
+
+
+def random_boxes(rng, n):
+    lt = rng.uniform(0, 0.9, size=(n, 2))
+    wh = rng.uniform(0.01, 0.5, size=(n, 2))
+    return np.concatenate([lt, np.minimum(lt + wh, 1)], axis=1).astype(np.float32)
+
+
+def check_cpu_vs_gpu(anchor_count, box_counts, offset):
+    rng = np.random.default_rng(anchor_count)
+    anchors = random_boxes(rng, anchor_count).flatten().tolist()
+    batch_size = len(box_counts)
+
+    def get_data():
+        boxes = [random_boxes(rng, n) for n in box_counts]
+        labels = [rng.integers(1, 80, size=(n,), dtype=np.int32) for n in box_counts]
+        return boxes, labels
+
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+    def pipe():
+        boxes, labels = fn.external_source(source=get_data, num_outputs=2)
+        kwargs = dict(criteria=0.5, anchors=anchors, offset=offset, scale=300.0,
+                      stds=[0.1, 0.1, 0.2, 0.2])
+        boxes_cpu, labels_cpu = fn.box_encoder(boxes, labels, **kwargs)
+        boxes_gpu, labels_gpu = fn.box_encoder(boxes.gpu(), labels.gpu(), **kwargs)
+        return boxes_cpu, labels_cpu, boxes_gpu, labels_gpu
+
+    p = pipe()
+    p.build()
+    for _ in range(2):
+        boxes_cpu, labels_cpu, boxes_gpu, labels_gpu = p.run()
+        check_batch(labels_cpu, labels_gpu, batch_size, eps=0)
+        check_batch(boxes_cpu, boxes_gpu, batch_size, eps=1e-3)
+
+
+def test_cpu_vs_gpu():
+    # the anchors span many tiles and one of the samples has more boxes than fit in a chunk
+    for anchor_count in [1, 8732, 120000]:
+        for offset in [False, True]:
+            yield check_cpu_vs_gpu, anchor_count, [0, 1, 17, 300], offset
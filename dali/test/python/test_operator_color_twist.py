@@ -122,3 +122,49 @@ def test_color_twist():
         for out_dtype in [types.FLOAT, types.INT16, types.UINT8]:
             has_3_dims = random.choice([False, True])
             yield check_ref, inp_dtype, out_dtype, has_3_dims
+
+@pipeline_def()
+def FusedColorPipeline(data_iterator, device):
+    imgs = fn.external_source(source=data_iterator)
+    inp = imgs.gpu() if device == "gpu" else imgs
+    H = fn.random.uniform(range=[-20, 20])
+    C = fn.random.uniform(range=[0, 2])
+    # the Hsv is applied by the ColorTwist, which has argument inputs
+    hsv = fn.hsv(inp, hue=15.0, saturation=0.8, dtype=types.FLOAT)
+    out_twist = fn.color_twist(hsv, hue=H, contrast=C, brightness=1.2, dtype=types.UINT8)
+    # both are replaced with a single ColorTwist
+    twist = fn.color_twist(inp, hue=10.0, saturation=1.2, contrast=0.8, dtype=types.FLOAT)
+    out_bc = fn.brightness_contrast(twist, brightness=0.9, brightness_shift=0.1, contrast=1.1,
+                                    dtype=types.UINT8)
+    return imgs, out_twist, out_bc, H, C
+
+def ref_brightness_contrast(img, brightness, brightness_shift, contrast, out_dtype):
+    # the input is float
+    center = 0.5
+    out_range = np.iinfo(out_dtype).max
+    out = brightness_shift * out_range + brightness * (center + contrast * (img - center))
+    return convert_sat(out, out_dtype)
+
+def check_fused_chain(device):
+    batch_size = 16
+    ri = RandomDataIterator(batch_size, shape=(64, 32, 3), dtype=np.uint8)
+    pipe = FusedColorPipeline(seed=1313, batch_size=batch_size, num_threads=4, device_id=0,
+                              data_iterator=ri, device=device)
+    pipe.build()
+    for _ in range(3):
+        imgs, out_twist, out_bc, H, C = pipe.run()
+        if device == "gpu":
+            out_twist = out_twist.as_cpu()
+            out_bc = out_bc.as_cpu()
+        for i in range(batch_size):
+            img = imgs.at(i)
+            hsv = ref_color_twist(img, 15.0, 0.8, 1, 1, np.float32)
+            ref = ref_color_twist(hsv, H.at(i), 1, 1.2, C.at(i), np.uint8)
+            assert np.allclose(out_twist.at(i), ref, 1/512, 1)
+            twist = ref_color_twist(img, 10.0, 1.2, 1, 0.8, np.float32)
+            ref = ref_brightness_contrast(twist, 0.9, 0.1, 1.1, np.uint8)
+            assert np.allclose(out_bc.at(i), ref, 1/512, 1)
+
+def test_fused_chain():
+    for device in ["cpu", "gpu"]:
+        yield check_fused_chain, device
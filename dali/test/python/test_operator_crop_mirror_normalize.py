@@ -579,6 +579,38 @@ def test_per_sample_norm_args():
             for scale, shift in [(None, None), (255.0, -128.0)]:
                 yield check_cmn_per_sample_norm_args, device, random_mean, random_stdev, scale, shift
 
+def check_cmn_per_channel_quantization(device, dtype, scale, shift):
+    @pipeline_def(num_threads=3, device_id=0)
+    def pipe():
+        image_like = fn.random.uniform(device=device, range=(0, 255), shape=(80, 120, 3))
+        image_like = fn.reshape(image_like, layout="HWC")
+        mean = [0.485 * 255, 0.456 * 255, 0.406 * 255]
+        std = [0.229 * 255, 0.224 * 255, 0.225 * 255]
+        out = fn.crop_mirror_normalize(image_like, dtype=dtype, output_layout="HWC",
+                                       mean=mean, std=std, scale=scale, shift=shift)
+        return out, image_like
+
+    batch_size = 4
+    p = pipe(batch_size=batch_size)
+    p.build()
+    outs = p.run()
+    out_type = dali_type_to_np(dtype)
+    info = np.iinfo(out_type)
+    mean = np.array([0.485 * 255, 0.456 * 255, 0.406 * 255])
+    std = np.array([0.229 * 255, 0.224 * 255, 0.225 * 255])
+    for s in range(batch_size):
+        out, image_like = [as_array(o[s]) for o in outs]
+        assert out.dtype == out_type
+        ref_out = np.array(scale) * (image_like - mean) / std + np.array(shift)
+        ref_out = np.clip(np.round(ref_out), info.min, info.max)
+        np.testing.assert_allclose(out, ref_out, atol=1)
+
+def test_per_channel_quantization():
+    for device in ['cpu', 'gpu']:
+        yield check_cmn_per_channel_quantization, device, types.INT8, [60., 40., 50.], [0., 5., -5.]
+        yield check_cmn_per_channel_quantization, device, types.INT8, 50., [0., 5., -5.]
+        yield check_cmn_per_channel_quantization, device, types.UINT8, [50., 60., 70.], 128.
+
 def check_crop_mirror_normalize_wrong_layout(device, batch_size, input_shape=(100, 200, 3), layout="ABC"):
     assert len(layout) == len(input_shape)
     @pipeline_def
@@ -1,4 +1,4 @@
-# Copyright (c) 2019-2021, NVIDIA CORPORATION. All rights reserved.
+# Copyright (c) 2019-2022, NVIDIA CORPORATION. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -194,3 +194,75 @@ def test_audio_decoder_correctness():
   dtype = types.INT16
   for fmt in ['wav', 'flac', 'ogg']:
     yield check_audio_decoder_correctness, fmt, dtype
+
+def check_audio_decoder_window(fmt, offset, duration):
+  batch_size = 8
+  @pipeline_def(batch_size=batch_size, device_id=0, num_threads=4)
+  def audio_decoder_pipe(fnames, **window):
+      encoded, _ = fn.readers.file(files=fnames)
+      decoded, rates = fn.decoders.audio(encoded, dtype=types.INT16, **window)
+      return decoded, rates
+
+  audio_files = get_files(os.path.join('db', 'audio', fmt), fmt)
+  ref_pipe = audio_decoder_pipe(audio_files)
+  pipe = audio_decoder_pipe(audio_files, offset=offset, duration=duration)
+  ref_pipe.build()
+  pipe.build()
+  for _ in range(2):
+    ref_data, ref_rates = ref_pipe.run()
+    data, rates = pipe.run()
+    for s in range(batch_size):
+      rate = float(np.array(rates[s]))
+      assert rate == float(np.array(ref_rates[s]))
+      ref = np.array(ref_data[s])
+      start = int(offset * rate)
+      end = len(ref) if duration < 0 else start + int(duration * rate)
+      ref = ref[start:end]
+      arr = np.array(data[s])
+      assert arr.shape == ref.shape, f"{arr.shape} vs {ref.shape}"
+      if fmt == 'wav':
+        np.testing.assert_equal(arr, ref)
+      else:
+        # lossy codecs may decode the frames around the seek point slightly differently
+        assert np.mean(np.abs(arr.astype(np.float32) - ref)) < 1
+
+def test_audio_decoder_window():
+  for fmt in ['wav', 'flac', 'ogg']:
+    for offset, duration in [(0, 0.5), (0.25, -1), (0.1, 0.3), (1e4, 1)]:
+      yield check_audio_decoder_window, fmt, offset, duration
+
+def check_audio_decoder_preemphasis(sample_rate, downmix, border):
+  batch_size = 8
+  @pipeline_def(batch_size=batch_size, device_id=0, num_threads=4)
+  def audio_decoder_pipe(fnames):
+      encoded, _ = fn.readers.file(files=fnames)
+      fused, _ = fn.decoders.audio(encoded, dtype=types.FLOAT, sample_rate=sample_rate,
+                                   downmix=downmix, preemph_coeff=0.97, preemph_border=border)
+      decoded, _ = fn.decoders.audio(encoded, dtype=types.FLOAT, sample_rate=sample_rate,
+                                     downmix=downmix)
+      return fused, decoded
+
+  pipe = audio_decoder_pipe(names)
+  pipe.build()
+  for _ in range(2):
+    fused, decoded = pipe.run()
+    for s in range(batch_size):
+      arr = np.array(fused[s])
+      ref = np.array(decoded[s])
+      assert arr.shape == ref.shape
+      ref = ref.reshape(ref.shape[0], -1)
+      if border == 'zero':
+        first = np.zeros_like(ref[:1])
+      elif border == 'reflect' and ref.shape[0] > 1:
+        first = ref[1:2]
+      else:
+        first = ref[:1]
+      prev = np.concatenate([first, ref[:-1]])
+      ref = (ref - 0.97 * prev).reshape(arr.shape)
+      np.testing.assert_allclose(arr, ref, atol=1e-5)
+
+def test_audio_decoder_preemphasis():
+  for sample_rate in [None, 12999]:
+    for downmix in [False, True]:
+      for border in ['zero', 'clamp', 'reflect']:
+        yield check_audio_decoder_preemphasis, sample_rate, downmix, border
@@ -1,4 +1,4 @@
-# Copyright (c) 2017-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -142,6 +142,32 @@ def test_element_extract_layout():
     for device in ["cpu", "gpu"]:
         yield check_element_extract, [4, 3, 3], "FXY", [0, 1, 2, 3, 3, 2, 1, 0], device
 
+def test_element_extract_shared_input():
+    # the CPU outputs reference the input sequences - check them in both stages, over several
+    # iterations with different data
+    F = 5
+
+    def source(info):
+        frames = np.arange(F, dtype=np.int32).reshape(F, 1, 1) * 10
+        return [np.full((F, 3, 2), info.iteration * 100 + i, dtype=np.int32) + frames
+                for i in range(batch_size)]
+
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0, prefetch_queue_depth=2)
+    def pipe():
+        input = fn.external_source(source=source, batch_info=True, layout="FHW")
+        first, last = fn.element_extract(input, element_map=[0, F - 1])
+        return first, last.gpu(), input
+
+    p = pipe()
+    p.build()
+    for _ in range(5):
+        first, last, input = p.run()
+        last = last.as_cpu()
+        for i in range(batch_size):
+            assert first.layout() == "HW" and last.layout() == "HW"
+            np.testing.assert_array_equal(first.at(i), input.at(i)[0])
+            np.testing.assert_array_equal(last.at(i), input.at(i)[F - 1])
+
 def test_raises():
     with assert_raises(RuntimeError,
                        glob="Input must have at least two dimensions - outermost for sequence and"
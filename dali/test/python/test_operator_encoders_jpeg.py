@@ -0,0 +1,98 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from nvidia.dali import pipeline_def
+import nvidia.dali.fn as fn
+import nvidia.dali.types as types
+import numpy as np
+import os
+import cv2
+
+test_data_root = os.environ['DALI_EXTRA_PATH']
+images_dir = os.path.join(test_data_root, 'db', 'single', 'jpeg')
+
+
+def _cv_round_trip(img, q):
+    bgr = cv2.cvtColor(img, cv2.COLOR_RGB2BGR)
+    _, encoded = cv2.imencode('.jpg', bgr, params=[int(cv2.IMWRITE_JPEG_QUALITY), q])
+    return cv2.cvtColor(cv2.imdecode(encoded, cv2.IMREAD_COLOR), cv2.COLOR_BGR2RGB)
+
+
+def _testimpl_jpeg_encoder(batch_size, quality, chroma_subsampling):
+    @pipeline_def(batch_size=batch_size, num_threads=3, device_id=0, seed=1234)
+    def jpeg_encoder_pipe():
+        encoded, _ = fn.readers.file(file_root=images_dir)
+        images = fn.decoders.image(encoded, device='cpu')
+        q = quality
+        if q is None:
+            q = fn.random.uniform(range=[1, 99], dtype=types.INT32)
+        out = fn.encoders.jpeg(images.gpu(), quality=q, chroma_subsampling=chroma_subsampling)
+        return out, images, q
+
+    pipe = jpeg_encoder_pipe()
+    pipe.build()
+    for _ in range(3):
+        out, images, q = pipe.run()
+        out = out.as_cpu()
+        for i in range(batch_size):
+            bitstream = np.array(out[i])
+            image = np.array(images[i])
+            sample_q = int(np.array(q[i]))
+            assert bitstream.dtype == np.uint8 and bitstream.ndim == 1
+            # the start and the end of image markers
+            assert bitstream[0] == 0xff and bitstream[1] == 0xd8
+            assert bitstream[-2] == 0xff and bitstream[-1] == 0xd9
+            decoded = cv2.cvtColor(cv2.imdecode(bitstream, cv2.IMREAD_COLOR), cv2.COLOR_BGR2RGB)
+            assert decoded.shape == image.shape
+            diff = np.average(cv2.absdiff(decoded, _cv_round_trip(image, sample_q)))
+            assert diff < 5, f"Absolute difference with the reference is too big: {diff}"
+
+
+def test_jpeg_encoder():
+    for batch_size in [1, 15]:
+        for quality in [2, None, 95]:
+            yield _testimpl_jpeg_encoder, batch_size, quality, True
+        # the reference keeps the chroma subsampled, so only the high qualities are comparable
+        for quality in [75, 95]:
+            yield _testimpl_jpeg_encoder, batch_size, quality, False
+
+
+def test_jpeg_encoder_decode_back():
+    batch_size = 8
+
+    @pipeline_def(batch_size=batch_size, num_threads=3, device_id=0)
+    def encode_pipe():
+        encoded, _ = fn.readers.file(file_root=images_dir)
+        images = fn.decoders.image(encoded, device='mixed')
+        return fn.encoders.jpeg(images, quality=100), images
+
+    pipe = encode_pipe()
+    pipe.build()
+    bitstreams, images = [out.as_cpu() for out in pipe.run()]
+
+    @pipeline_def(batch_size=batch_size, num_threads=3, device_id=0)
+    def decode_pipe():
+        data = fn.external_source(source=[[np.array(bitstreams[i]) for i in range(batch_size)]],
+                                  cycle=True)
+        return fn.decoders.image(data, device='cpu')
+
+    pipe = decode_pipe()
+    pipe.build()
+    decoded, = pipe.run()
+    for i in range(batch_size):
+        image = np.array(images[i])
+        decoded_image = np.array(decoded[i])
+        assert decoded_image.shape == image.shape
+        diff = np.average(cv2.absdiff(decoded_image, image))
+        assert diff < 3, f"Absolute difference with the input is too big: {diff}"
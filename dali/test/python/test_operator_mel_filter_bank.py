@@ -1,4 +1,4 @@
-# Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -144,3 +144,32 @@ def test_operator_mel_filter_bank_vs_python():
                          (128, 44100.0, 1000.0, 22050.0, (513, 100), 'tf')]:
                         yield check_operator_mel_filter_bank_vs_python, device, batch_size, shape, \
                             nfilter, sample_rate, freq_low, freq_high, normalize, mel_formula, layout
+
+def check_mel_filter_bank_to_decibels(device, batch_size, shape, layout, multiplier, reference,
+                                      cutoff_db):
+    rng = np.random.default_rng(seed=1234)
+    def data():
+        return [rng.random(shape, dtype=np.float32) for _ in range(batch_size)]
+    pipe = Pipeline(batch_size=batch_size, num_threads=3, device_id=0)
+    with pipe:
+        spectrum = dali.fn.external_source(source=data, layout=layout)
+        if device == 'gpu':
+            spectrum = spectrum.gpu()
+        fused = dali.fn.mel_filter_bank(spectrum, nfilter=64, sample_rate=16000.0,
+                                        to_decibels=True, db_multiplier=multiplier,
+                                        db_reference=reference, db_cutoff=cutoff_db)
+        mel = dali.fn.mel_filter_bank(spectrum, nfilter=64, sample_rate=16000.0)
+        separate = dali.fn.to_decibels(mel, multiplier=multiplier, reference=reference,
+                                       cutoff_db=cutoff_db)
+        pipe.set_outputs(fused, separate)
+    pipe.build()
+    for _ in range(3):
+        fused, separate = pipe.run()
+        check_batch(fused, separate, batch_size, eps=1e-04)
+
+def test_mel_filter_bank_to_decibels():
+    for device in ['cpu', 'gpu']:
+        for shape, layout in [((257, 100), 'ft'), ((100, 257), 'tf')]:
+            for multiplier, reference, cutoff_db in [(10.0, 1.0, -80.0), (20.0, 0.5, -200.0)]:
+                yield check_mel_filter_bank_to_decibels, device, 2, shape, layout, \
+                    multiplier, reference, cutoff_db
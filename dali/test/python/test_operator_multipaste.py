@@ -1,4 +1,4 @@
-# Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -305,6 +305,11 @@ def test_operator_multipaste():
         [4, 2, (128, 128), (128, 128), False, False, False, False, None, False, None, types.FLOAT, 0],
 
         [4, 2, (128, 256), (128, 128), False, False, False, False, None, False, None, types.UINT8, 4],
+
+        # many overlapping pastes per output, as in mosaic or copy-paste augmentation
+        [4, 40, (64, 64), (256, 256), True, False, False, False, None, False, None, types.UINT8, 0],
+        # more pastes overlapping a single tile than the GPU kernel caches in shared memory
+        [2, 200, (64, 64), (64, 64), True, False, False, False, None, False, None, types.UINT8, 0],
     ]
     for t in tests:
         yield (check_operator_multipaste, *t, "cpu")
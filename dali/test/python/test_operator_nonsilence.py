@@ -88,3 +88,36 @@ def test_nonsilence_operator():
                 for cc in cutoff_coeffs:
                     yield check_nonsilence_operator, \
                             batch_size, cc, ws, rp, ri, ws
+
+@pipeline_def
+def nonsilent_region_int_pipe(dtype, cutoff_value, window_size, reference_power):
+    raw, _ = fn.readers.file(files=audio_files)
+    audio, _ = fn.decoders.audio(raw, dtype=dtype, downmix=True)
+    begin_cpu, len_cpu = fn.nonsilent_region(
+        audio, cutoff_db=cutoff_value, window_length=window_size,
+        reference_power=reference_power)
+    begin_gpu, len_gpu = fn.nonsilent_region(
+        audio.gpu(), cutoff_db=cutoff_value, window_length=window_size,
+        reference_power=reference_power)
+    return begin_cpu, len_cpu, begin_gpu, len_gpu
+
+def check_nonsilence_operator_int(batch_size, dtype, cutoff_value, window_size, reference_power):
+    pipe = nonsilent_region_int_pipe(
+        dtype, cutoff_value, window_size, reference_power,
+        batch_size=batch_size, num_threads=3, device_id=0, seed=42)
+    pipe.build()
+    for _ in range(3):
+        begin_cpu, len_cpu, begin_gpu, len_gpu = pipe.run()
+        for s in range(batch_size):
+            # the sums of squares of integers are exact, so are the results of both backends
+            np.testing.assert_array_equal(test_utils.as_array(begin_cpu[s]),
+                                          test_utils.as_array(begin_gpu[s]))
+            np.testing.assert_array_equal(test_utils.as_array(len_cpu[s]),
+                                          test_utils.as_array(len_gpu[s]))
+
+def test_nonsilence_operator_int():
+    for window_size in [256, 2048]:
+        for reference_power in [None, 1e6]:
+            for cutoff_value in [-20, -60]:
+                yield check_nonsilence_operator_int, 3, types.INT16, cutoff_value, window_size, \
+                    reference_power
@@ -1,4 +1,4 @@
-# Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+# Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -207,3 +207,40 @@ def test_multiple_ins():
         outs = pipe.run()
         out_arr = np.array(outs[0][0])
         assert np.array_equal(out_arr, np.zeros((10, 10, 3), dtype=np.uint8))
+
+def transpose_gpu_sample(out0, in0):
+    from numba import cuda
+    i, j = cuda.grid(2)
+    if i < in0.shape[0] and j < in0.shape[1]:
+        out0[j, i] = in0[i, j]
+
+def setup_transpose(outs, ins):
+    out0 = outs[0]
+    in0 = ins[0]
+    for sample_idx in range(len(out0)):
+        out0[sample_idx][0] = in0[sample_idx][1]
+        out0[sample_idx][1] = in0[sample_idx][0]
+
+def get_data_arange(shapes, dtype):
+    return [np.arange(np.prod(shape), dtype=dtype).reshape(shape) for shape in shapes]
+
+@pipeline_def
+def numba_func_gpu_pipe(shapes, dtype, run_fn=None, out_types=None, in_types=None, outs_ndim=None, ins_ndim=None, setup_fn=None,
+                        blocks=None, threads_per_block=None):
+    data = fn.external_source(lambda: get_data_arange(shapes, dtype), batch=True, device="gpu")
+    return numba_function(data, run_fn=run_fn, out_types=out_types, in_types=in_types, outs_ndim=outs_ndim, ins_ndim=ins_ndim,
+                          setup_fn=setup_fn, device="gpu", blocks=blocks, threads_per_block=threads_per_block)
+
+def test_numba_func_gpu():
+    shapes = [(10, 20), (33, 5), (1, 64)]
+    for dtype, dali_dtype in [(np.uint8, dali_types.UINT8), (np.float32, dali_types.FLOAT), (np.int64, dali_types.INT64)]:
+        pipe = numba_func_gpu_pipe(batch_size=len(shapes), num_threads=1, device_id=0, shapes=shapes, dtype=dtype,
+                                   run_fn=transpose_gpu_sample, setup_fn=setup_transpose, out_types=[dali_dtype], in_types=[dali_dtype],
+                                   outs_ndim=[2], ins_ndim=[2], blocks=(8, 8), threads_per_block=(8, 8))
+        pipe.build()
+        expected = [arr.T for arr in get_data_arange(shapes, dtype)]
+        for _ in range(3):
+            outs, = pipe.run()
+            outs = outs.as_cpu()
+            for i in range(len(shapes)):
+                assert np.array_equal(np.array(outs[i]), expected[i])
@@ -1,4 +1,4 @@
-# Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -484,3 +484,35 @@ def test_err_threshold_dim_clash():
 
 def test_large_data():
     yield _test_random_object_bbox_with_class, 4, 5, np.int32, None, 1., [1,2,3], None, None, None, 10
+
+@nottest
+def _test_cpu_vs_gpu(batch_size, ndim, dtype, kwargs={}):
+    def get_pipe(device):
+        pipe = dali.Pipeline(batch_size, 4, device_id=0, seed=4321)
+        with pipe:
+            inp = fn.external_source(batch_generator(batch_size, ndim, dtype), device=device)
+            outs = fn.segmentation.random_object_bbox(inp, seed=1234, **kwargs)
+            pipe.set_outputs(*outs)
+        return pipe
+
+    np.random.seed(1234)
+    pipe_cpu = get_pipe("cpu")
+    pipe_cpu.build()
+    cpu_outs = [pipe_cpu.run() for _ in range(3)]
+    np.random.seed(1234)
+    pipe_gpu = get_pipe("gpu")
+    pipe_gpu.build()
+    for cpu_out in cpu_outs:
+        gpu_out = pipe_gpu.run()
+        for out_cpu, out_gpu in zip(cpu_out, gpu_out):
+            check_batch(out_cpu, out_gpu.as_cpu(), batch_size)
+
+def test_cpu_vs_gpu():
+    for ndim in [1, 2, 3]:
+        for dtype in [np.uint8, np.int32]:
+            yield _test_cpu_vs_gpu, 8, ndim, dtype
+    yield _test_cpu_vs_gpu, 8, 2, np.int16, dict(ignore_class=True, format="box")
+    yield _test_cpu_vs_gpu, 8, 3, np.uint16, dict(output_class=True, k_largest=2,
+                                                  threshold=[2, 2, 2], foreground_prob=0.7)
+    yield _test_cpu_vs_gpu, 8, 2, np.int32, dict(classes=[1, 2, 3], class_weights=[1., 2., 3.],
+                                                 format="start_end", output_class=True)
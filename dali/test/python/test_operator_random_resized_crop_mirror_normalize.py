@@ -0,0 +1,86 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import nvidia.dali.fn as fn
+import nvidia.dali.types as types
+from nvidia.dali import pipeline_def
+import numpy as np
+from test_utils import as_array
+
+batch_size = 8
+
+
+def random_images(seed):
+    rng = np.random.default_rng(seed)
+
+    def gen():
+        return [rng.integers(0, 256, size=(rng.integers(50, 400), rng.integers(50, 400), 3),
+                             dtype=np.uint8) for _ in range(batch_size)]
+    return gen
+
+
+@pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+def fused_vs_separate_pipe(size, mirror, output_layout, dtype):
+    images = fn.external_source(source=random_images(1234), layout="HWC").gpu()
+    fused = fn.random_resized_crop_mirror_normalize(images, size=size, mirror=mirror, seed=42,
+                                                    output_layout=output_layout, dtype=dtype)
+    resized = fn.random_resized_crop(images, size=size, seed=42)
+    separate = fn.crop_mirror_normalize(resized, mirror=mirror, output_layout=output_layout,
+                                        dtype=types.FLOAT)
+    return fused, separate
+
+
+def check_fused_vs_separate(size, mirror, output_layout, dtype):
+    pipe = fused_vs_separate_pipe(size, mirror, output_layout, dtype)
+    pipe.build()
+    for _ in range(3):
+        fused, separate = pipe.run()
+        for i in range(batch_size):
+            a = as_array(fused[i]).astype(np.float32)
+            b = as_array(separate[i])
+            assert a.shape == b.shape, f"{a.shape} vs {b.shape}"
+            # the separate path rounds the intermediate to uint8 and the filters are
+            # approximated differently
+            assert np.max(np.abs(a - b)) <= 2, f"max difference: {np.max(np.abs(a - b))}"
+            assert np.mean(np.abs(a - b)) < 0.6, f"mean difference: {np.mean(np.abs(a - b))}"
+
+
+def test_fused_vs_separate():
+    for size in [(224, 224), (64, 96), (500, 400)]:
+        for mirror in [0, 1]:
+            for output_layout in ["CHW", "HWC"]:
+                for dtype in [types.FLOAT, types.FLOAT16]:
+                    yield check_fused_vs_separate, size, mirror, output_layout, dtype
+
+
+@pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+def normalize_pipe(mean, std):
+    images = fn.external_source(source=random_images(4321), layout="HWC").gpu()
+    plain = fn.random_resized_crop_mirror_normalize(images, size=(100, 120), seed=7)
+    normalized = fn.random_resized_crop_mirror_normalize(images, size=(100, 120), seed=7,
+                                                         mean=mean, std=std)
+    return plain, normalized
+
+
+def test_normalize():
+    mean = [0.485 * 255, 0.456 * 255, 0.406 * 255]
+    std = [0.229 * 255, 0.224 * 255, 0.225 * 255]
+    pipe = normalize_pipe(mean, std)
+    pipe.build()
+    plain, normalized = pipe.run()
+    mean = np.array(mean, dtype=np.float32).reshape(3, 1, 1)
+    std = np.array(std, dtype=np.float32).reshape(3, 1, 1)
+    for i in range(batch_size):
+        ref = (as_array(plain[i]) - mean) / std
+        assert np.allclose(as_array(normalized[i]), ref, atol=1e-4)
@@ -1,4 +1,4 @@
-# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+# Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -14,9 +14,12 @@
 
 import math
 from nvidia.dali.pipeline import Pipeline
+from nvidia.dali import pipeline_def
 import nvidia.dali.ops as ops
+import nvidia.dali.fn as fn
 import numpy as np
 import os
+from nose_utils import assert_raises
 from test_utils import get_dali_extra_path
 
 class COCOReaderPipeline(Pipeline):
@@ -196,6 +199,87 @@ def test_dont_mix_epochs():
     assert img_ids_list_set[1] == img_ids_list_set_new[0]
 
 
+@pipeline_def(batch_size=1, num_threads=4, device_id=0, prefetch_queue_depth=1)
+def coco_ids_pipe(shard_id, num_shards, **kwargs):
+    _, _, _, ids = fn.readers.coco(file_root=data_sets[0][0], annotations_file=data_sets[0][1],
+                                   shard_id=shard_id, num_shards=num_shards, image_ids=True,
+                                   name="Reader", **kwargs)
+    return ids
+
+
+# each epoch should go through the entire dataset, split between the shards, in a new order
+def test_global_shuffle():
+    num_shards = 3
+    pipes = [coco_ids_pipe(shard_id, num_shards, global_shuffle=True) for shard_id in range(num_shards)]
+    [pipe.build() for pipe in pipes]
+    dataset_size = pipes[0].epoch_size("Reader")
+    prev_ids = None
+    for _ in range(2):
+        ids = []
+        for shard_id, pipe in enumerate(pipes):
+            shard_size = dataset_size * (shard_id + 1) // num_shards - dataset_size * shard_id // num_shards
+            for _ in range(shard_size):
+                ids.append(int(pipe.run()[0].as_array()[0]))
+        assert len(set(ids)) == dataset_size
+        assert ids != sorted(ids)
+        assert ids != prev_ids
+        prev_ids = ids
+
+
+def test_global_shuffle_random_shuffle_exclusive():
+    with assert_raises(RuntimeError, glob="global_shuffle and random_shuffle cannot be both true"):
+        pipe = coco_ids_pipe(0, 1, global_shuffle=True, random_shuffle=True)
+        pipe.build()
+
+
+@pipeline_def(batch_size=1, num_threads=4, device_id=0, prefetch_queue_depth=1)
+def lmdb_pipe(reader, path, **kwargs):
+    data, _ = reader(path=path, name="Reader", **kwargs)
+    return data
+
+
+def _test_lmdb_global_shuffle(reader, path, num_io_threads):
+    ref = lmdb_pipe(reader, path)
+    parallel = lmdb_pipe(reader, path, num_io_threads=num_io_threads)
+    shuffled = lmdb_pipe(reader, path, global_shuffle=True, num_io_threads=num_io_threads)
+    for pipe in [ref, parallel, shuffled]:
+        pipe.build()
+    dataset_size = ref.epoch_size("Reader")
+
+    def read_epoch(pipe):
+        return [pipe.run()[0].at(0).tobytes() for _ in range(dataset_size)]
+
+    ref_samples = read_epoch(ref)
+    # the parallel reads don't change the order of the samples
+    assert read_epoch(parallel) == ref_samples
+    prev_samples = ref_samples
+    for _ in range(2):
+        samples = read_epoch(shuffled)
+        assert sorted(samples) == sorted(ref_samples)
+        assert samples != prev_samples
+        prev_samples = samples
+
+
+def test_lmdb_global_shuffle():
+    for reader, db in [(fn.readers.caffe, 'lmdb'), (fn.readers.caffe2, 'c2lmdb')]:
+        for num_io_threads in [1, 4]:
+            yield _test_lmdb_global_shuffle, reader, os.path.join(test_data_root, 'db', db), \
+                num_io_threads
+
+
+def test_global_shuffle_unsupported():
+    sequence_folder = os.path.join(test_data_root, 'db', 'sequence', 'frames')
+
+    @pipeline_def(batch_size=1, num_threads=1, device_id=0)
+    def pipe():
+        return fn.readers.sequence(file_root=sequence_folder, sequence_length=2,
+                                   global_shuffle=True)
+
+    with assert_raises(RuntimeError, glob="This reader doesn't support ``global_shuffle``."):
+        p = pipe()
+        p.build()
+
+
 def create_pipeline(creator, batch_size, num_gpus):
     iters = 0
     # make sure that data size and batch are not divisible
@@ -1,4 +1,4 @@
-# Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -212,3 +212,37 @@ def test_coco_reader_alias():
 
     for polygon_masks, pixelwise_masks in [(None, None), (True, None), (None, True)]:
         yield check_coco_reader_alias, polygon_masks, pixelwise_masks
+
+
+def check_preprocessed_annotations(annotations_file, polygon_masks, pixelwise_masks):
+    file_root = os.path.join(test_data_root, 'db', 'coco_pixelwise', 'images')
+    masks_args = dict(polygon_masks=polygon_masks, pixelwise_masks=pixelwise_masks)
+    with tempfile.TemporaryDirectory() as annotations_dir:
+        json_pipe = Pipeline(batch_size=2, num_threads=4, device_id=0)
+        with json_pipe:
+            outputs = fn.readers.coco(file_root=file_root, annotations_file=annotations_file,
+                                      save_preprocessed_annotations=True,
+                                      save_preprocessed_annotations_dir=annotations_dir,
+                                      name="Reader", **masks_args)
+            json_pipe.set_outputs(*outputs)
+        json_pipe.build()
+
+        preprocessed_pipe = Pipeline(batch_size=2, num_threads=4, device_id=0)
+        with preprocessed_pipe:
+            outputs = fn.readers.coco(file_root=file_root,
+                                      preprocessed_annotations=annotations_dir,
+                                      name="Reader", **masks_args)
+            preprocessed_pipe.set_outputs(*outputs)
+        preprocessed_pipe.build()
+        epoch_size = json_pipe.epoch_size("Reader")
+        assert epoch_size == preprocessed_pipe.epoch_size("Reader")
+        compare_pipelines(json_pipe, preprocessed_pipe, batch_size=2,
+                          N_iterations=(epoch_size + 1) // 2)
+
+
+def test_preprocessed_annotations():
+    coco_pixelwise_dir = os.path.join(test_data_root, 'db', 'coco_pixelwise')
+    for annotations_file in ['instances.json', 'instances_rle_counts.json']:
+        for polygon_masks, pixelwise_masks in [(False, False), (True, False), (False, True)]:
+            yield check_preprocessed_annotations, \
+                os.path.join(coco_pixelwise_dir, annotations_file), polygon_masks, pixelwise_masks
@@ -21,6 +21,7 @@ import nvidia.dali.fn as fn
 from nvidia.dali import Pipeline, pipeline_def
 from test_utils import compare_pipelines
 from nose_utils import assert_raises
+from test_operator_readers_numpy import is_gds_supported
 
 def ref_contents(path):
     fname = path[path.rfind('/')+1:]
@@ -87,6 +88,31 @@ def test_file_reader():
             for shuffle in [False, True]:
                 yield _test_reader_files_arg, use_root, use_labels, shuffle
 
+def _test_file_reader_handle_cache(cache_size, num_io_threads, no_atime):
+    batch_size = 3
+    fnames = [os.path.join(g_root, f) for f in g_files]
+    pipe = Pipeline(batch_size, 1, 0)
+    files, labels = fn.readers.file(files=fnames, random_shuffle=True, dont_use_mmap=True,
+                                    file_handle_cache_size=cache_size,
+                                    num_io_threads=num_io_threads, no_atime=no_atime)
+    pipe.set_outputs(files, labels)
+    pipe.build()
+
+    # a few epochs, so that the cached handles are reused
+    num_iters = 3 * (len(fnames) + batch_size - 1) // batch_size
+    for i in range(num_iters):
+        out_f, out_l = pipe.run()
+        for j in range(batch_size):
+            contents = bytes(out_f.at(j)).decode('utf-8')
+            index = out_l.at(j)[0]
+            assert contents == ref_contents(fnames[index])
+
+def test_file_reader_handle_cache():
+    for cache_size in [1, 4, 100]:
+        for num_io_threads in [1, 2]:
+            for no_atime in [False, True]:
+                yield _test_file_reader_handle_cache, cache_size, num_io_threads, no_atime
+
 def test_file_reader_relpath():
     batch_size = 3
     rel_root = os.path.relpath(g_root, os.getcwd())
@@ -181,6 +207,23 @@ def test_file_reader_alias():
     legacy_pipe = file_pipe(fn.file_reader, file_list)
     compare_pipelines(new_pipe, legacy_pipe, batch_size_alias_test, 50)
 
+batch_size_device_test = 3
+
+@pipeline_def(batch_size=batch_size_device_test, device_id=0, num_threads=4)
+def file_pipe_device(device, file_root, files, shuffle):
+    files, labels = fn.readers.file(device=device, file_root=file_root, files=files,
+                                    random_shuffle=shuffle, seed=123)
+    return files, labels
+
+def test_file_reader_gpu():
+    if not is_gds_supported():
+        return
+    fnames = g_files
+    for shuffle in [False, True]:
+        cpu_pipe = file_pipe_device("cpu", g_root, fnames, shuffle)
+        gpu_pipe = file_pipe_device("gpu", g_root, fnames, shuffle)
+        compare_pipelines(cpu_pipe, gpu_pipe, batch_size_device_test, 5)
+
 def test_invalid_number_of_shards():
     @pipeline_def(batch_size=1, device_id=0, num_threads=4)
     def get_test_pipe():
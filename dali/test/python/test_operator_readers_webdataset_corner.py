@@ -1,4 +1,4 @@
-# Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -69,6 +69,11 @@ def test_read_ahead():
     general_corner_case(read_ahead=True)
 
 
+def test_dont_use_mmap():
+    # the components of the samples are read together and returned as views
+    general_corner_case(dont_use_mmap=True)
+
+
 def test_single_sample():
     test_batch_size = 1
     num_samples = 1
@@ -327,3 +327,43 @@ def test_index_generation():
             test_batch_size,
             math.ceil(num_samples / num_shards / test_batch_size) * 2,
         )
+
+
+def test_index_cache_dir():
+    global test_batch_size
+    num_samples = 3000
+    tar_file_paths = [
+        os.path.join(get_dali_extra_path(), "db/webdataset/MNIST/devel-0.tar"),
+        os.path.join(get_dali_extra_path(), "db/webdataset/MNIST/devel-1.tar"),
+        os.path.join(get_dali_extra_path(), "db/webdataset/MNIST/devel-2.tar"),
+    ]
+    index_files = [generate_temp_index_file(tar_file_path) for tar_file_path in tar_file_paths]
+    cache_dir = tempfile.TemporaryDirectory()
+
+    # the first run stores the inferred indices, the second one reads them
+    for _ in range(2):
+        compare_pipelines(
+            webdataset_raw_pipeline(
+                tar_file_paths,
+                [],
+                ["jpg", "cls"],
+                missing_component_behavior="error",
+                index_cache_dir=cache_dir.name,
+                batch_size=test_batch_size,
+                device_id=0,
+                num_threads=4,
+            ),
+            webdataset_raw_pipeline(
+                tar_file_paths,
+                [index_file.name for index_file in index_files],
+                ["jpg", "cls"],
+                missing_component_behavior="error",
+                batch_size=test_batch_size,
+                device_id=0,
+                num_threads=1,
+            ),
+            test_batch_size,
+            math.ceil(num_samples / test_batch_size),
+        )
+        assert_equal(len(glob(os.path.join(cache_dir.name, "wds_index_*.bin"))),
+                     len(tar_file_paths))
@@ -0,0 +1,107 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from nvidia.dali import pipeline_def
+import nvidia.dali.fn as fn
+import numpy as np
+from numpy.testing import assert_array_equal
+import itertools
+import json
+import os
+import tempfile
+
+rng = np.random.RandomState(12345)
+
+
+def write_zarr_array(path, arr, chunks, order='C', fill_value=0, skip_chunks=()):
+    """Writes an uncompressed Zarr (v2) array; the chunks in `skip_chunks` are not stored"""
+    os.makedirs(path)
+    meta = {
+        "zarr_format": 2,
+        "shape": list(arr.shape),
+        "chunks": list(chunks),
+        "dtype": arr.dtype.str,
+        "order": order,
+        "compressor": None,
+        "fill_value": fill_value,
+        "filters": None,
+    }
+    with open(os.path.join(path, ".zarray"), "w") as f:
+        json.dump(meta, f)
+    grid = [range((s + c - 1) // c) for s, c in zip(arr.shape, chunks)]
+    for pos in itertools.product(*grid):
+        if pos in skip_chunks:
+            continue
+        # the edge chunks are stored padded to the full chunk shape
+        chunk = np.full(chunks, fill_value, dtype=arr.dtype)
+        src = tuple(slice(p * c, min((p + 1) * c, s)) for p, c, s in zip(pos, chunks, arr.shape))
+        chunk[tuple(slice(0, sl.stop - sl.start) for sl in src)] = arr[src]
+        key = ".".join(str(p) for p in pos) if pos else "0"
+        with open(os.path.join(path, key), "wb") as f:
+            f.write(chunk.tobytes(order=order))
+
+
+@pipeline_def(batch_size=2, num_threads=3, device_id=None)
+def zarr_pipe(**kwargs):
+    return fn.readers.zarr(**kwargs)
+
+
+def _test_zarr_reader(order, roi_args, chunks=(4, 3, 5)):
+    arrays = [(rng.random_sample((10, 7, 12)) * 100).astype(np.int32) for _ in range(2)]
+    with tempfile.TemporaryDirectory() as root:
+        for i, arr in enumerate(arrays):
+            write_zarr_array(os.path.join(root, f"arr{i}"), arr, chunks, order=order)
+        pipe = zarr_pipe(file_root=root, **roi_args)
+        pipe.build()
+        out, = pipe.run()
+        for i, arr in enumerate(arrays):
+            ref = arr
+            if roi_args:
+                start, end = roi_args["roi_start"], roi_args["roi_end"]
+                ref = arr[tuple(slice(s, e) for s, e in zip(start, end))]
+            assert_array_equal(np.array(out[i]), ref)
+
+
+def test_zarr_reader():
+    for order in ['C', 'F']:
+        for roi_args in [{}, {"roi_start": [1, 2, 3], "roi_end": [9, 5, 11]},
+                         {"roi_start": [4, 0, 5], "roi_end": [5, 7, 6]}]:
+            yield _test_zarr_reader, order, roi_args
+
+
+def test_zarr_reader_missing_chunks():
+    arr = np.arange(8 * 6, dtype=np.float32).reshape(8, 6)
+    with tempfile.TemporaryDirectory() as root:
+        write_zarr_array(os.path.join(root, "arr"), arr, (4, 3), fill_value=-1,
+                         skip_chunks=[(0, 1), (1, 0)])
+        pipe = zarr_pipe(file_root=root, batch_size=1)
+        pipe.build()
+        out, = pipe.run()
+        ref = arr.copy()
+        ref[0:4, 3:6] = -1
+        ref[4:8, 0:3] = -1
+        assert_array_equal(np.array(out[0]), ref)
+
+
+def test_zarr_reader_out_of_bounds():
+    arr = np.arange(5 * 5, dtype=np.uint8).reshape(5, 5)
+    with tempfile.TemporaryDirectory() as root:
+        write_zarr_array(os.path.join(root, "arr"), arr, (2, 2))
+        pipe = zarr_pipe(file_root=root, batch_size=1, roi_start=[-1, 3], roi_end=[2, 7],
+                         out_of_bounds_policy="pad", fill_value=42)
+        pipe.build()
+        out, = pipe.run()
+        ref = np.full((3, 4), 42, dtype=np.uint8)
+        ref[1:3, 0:2] = arr[0:2, 3:5]
+        assert_array_equal(np.array(out[0]), ref)
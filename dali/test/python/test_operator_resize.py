@@ -611,6 +611,31 @@ def test_very_small_output():
         for dim in [2, 3]:
             yield _test_very_small_output, dim, device
 
+def _test_pyramid(device):
+    batch_size = 8
+    pipe = Pipeline(batch_size=batch_size, num_threads=4, device_id=0, seed=1234)
+    with pipe:
+        files, labels = dali.fn.readers.caffe(path = db_2d_folder, random_shuffle = True)
+        images = dali.fn.decoders.image(files, device="cpu")
+        if device == "gpu":
+            images = images.gpu()
+        levels = fn.resize(images, resize_x=80, resize_y=64, pyramid_levels=3)
+        ref = [fn.resize(images, resize_x=80, resize_y=64)]
+        for x, y in [(40, 32), (20, 16)]:
+            ref.append(fn.resize(ref[-1], resize_x=x, resize_y=y))
+        pipe.set_outputs(*levels, *ref)
+    pipe.build()
+    for it in range(2):
+        outs = pipe.run()
+        for level, ref_level, shape in zip(outs[:3], outs[3:], [[64, 80, 3], [32, 40, 3], [16, 20, 3]]):
+            for t in level:
+                assert t.shape() == shape
+            check_batch(level, ref_level, batch_size, max_allowed_error=1)
+
+def test_pyramid():
+    for device in ["cpu", "gpu"]:
+        yield _test_pyramid, device
+
 def test_checkerboard_dali_vs_onnx_ref():
     improc_data_dir = os.path.join(test_data_root, 'db', 'imgproc')
     ref_dir = os.path.join(improc_data_dir, 'ref', 'resampling')
@@ -1,4 +1,4 @@
-# Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -17,11 +17,15 @@ import nvidia.dali as dali
 import nvidia.dali.fn as fn
 import nvidia.dali.types as types
 import nvidia.dali.math as math
+from nvidia.dali.backend import TensorListGPU
 
 np.random.seed(4321)
 
+def as_cpu(outputs):
+    return [out.as_cpu() if isinstance(out, TensorListGPU) else out for out in outputs]
+
 def check_random_mask_pixel(ndim=2, batch_size=3,
-                            min_extent=20, max_extent=50):
+                            min_extent=20, max_extent=50, device='cpu'):
     pipe = dali.pipeline.Pipeline(batch_size=batch_size, num_threads=4, device_id=0, seed=1234)
     with pipe:
         # Input mask
@@ -29,17 +33,21 @@ def check_random_mask_pixel(ndim=2, batch_size=3,
                                  dtype=types.INT32) for d in range(ndim)]
         in_shape = fn.cat(*in_shape_dims, axis=0)
         in_mask = fn.cast(fn.random.uniform(range=(0, 2), device='cpu', shape=in_shape), dtype=types.INT32)
+        mask = in_mask.gpu() if device == 'gpu' else in_mask
 
-        fg_pixel1 = fn.segmentation.random_mask_pixel(in_mask, foreground=1)  # > 0
-        fg_pixel2 = fn.segmentation.random_mask_pixel(in_mask, foreground=1, threshold=0.99)  # > 0.99
-        fg_pixel3 = fn.segmentation.random_mask_pixel(in_mask, foreground=1, value=2)  # == 2
-        rnd_pixel = fn.segmentation.random_mask_pixel(in_mask, foreground=0)
+        fg_pixel1 = fn.segmentation.random_mask_pixel(mask, foreground=1)  # > 0
+        fg_pixel2 = fn.segmentation.random_mask_pixel(mask, foreground=1, threshold=0.99)  # > 0.99
+        fg_pixel3 = fn.segmentation.random_mask_pixel(mask, foreground=1, value=2)  # == 2
+        rnd_pixel = fn.segmentation.random_mask_pixel(mask, foreground=0)
         coin_flip = fn.random.coin_flip(probability=0.7)
-        fg_biased = fn.segmentation.random_mask_pixel(in_mask, foreground=coin_flip)
+        fg_biased = fn.segmentation.random_mask_pixel(mask, foreground=coin_flip)
 
         # Demo purposes: Taking a random pixel and produce a valid anchor to feed slice
+        # (the anchor of slice is a CPU input)
+        anchor_pixel = fg_pixel1 if device == 'cpu' else \
+            fn.segmentation.random_mask_pixel(in_mask, foreground=1)
         crop_shape = in_shape - 2  # We want to force the center adjustment, therefore the large crop shape
-        anchor = fn.cast(fg_pixel1, dtype=types.INT32) - crop_shape // 2
+        anchor = fn.cast(anchor_pixel, dtype=types.INT32) - crop_shape // 2
         anchor = math.min(math.max(0, anchor), in_shape - crop_shape)
         out_mask = fn.slice(in_mask, anchor, crop_shape, axes=tuple(range(ndim)))
 
@@ -47,7 +55,7 @@ def check_random_mask_pixel(ndim=2, batch_size=3,
                      anchor, crop_shape, out_mask)
     pipe.build()
     for iter in range(3):
-        outputs = pipe.run()
+        outputs = as_cpu(pipe.run())
         for idx in range(batch_size):
             in_mask = outputs[0].at(idx)
             fg_pixel1 = outputs[1].at(idx).tolist()
@@ -70,5 +78,42 @@ def check_random_mask_pixel(ndim=2, batch_size=3,
             assert out_mask.shape == tuple(crop_shape)
 
 def test_random_mask_pixel():
-    for ndim in (2, 3):
-        yield check_random_mask_pixel, ndim
+    for device in ('cpu', 'gpu'):
+        for ndim in (2, 3):
+            yield check_random_mask_pixel, ndim, 3, 20, 50, device
+
+def check_random_mask_pixel_sparse(device):
+    # a single foreground pixel in a mask spanning many tiles, and masks without any foreground
+    shapes = [(300, 400), (5, 7), (1, 1000)]
+    batch_size = len(shapes)
+
+    def get_data():
+        masks = []
+        for i, sh in enumerate(shapes):
+            mask = np.zeros(sh, dtype=np.uint8)
+            if i == 0:
+                mask[271, 313] = 5
+            masks.append(mask)
+        return masks
+
+    pipe = dali.pipeline.Pipeline(batch_size=batch_size, num_threads=4, device_id=0, seed=1234)
+    with pipe:
+        mask = fn.external_source(source=get_data, device=device)
+        fg_pixel = fn.segmentation.random_mask_pixel(mask, foreground=1)
+        fg_value = fn.segmentation.random_mask_pixel(mask, foreground=1, value=5)
+    pipe.set_outputs(fg_pixel, fg_value)
+    pipe.build()
+    for iter in range(3):
+        fg_pixel, fg_value = as_cpu(pipe.run())
+        assert fg_pixel.at(0).tolist() == [271, 313]
+        assert fg_value.at(0).tolist() == [271, 313]
+        for idx in range(1, batch_size):
+            for out in (fg_pixel, fg_value):
+                pixel = out.at(idx)
+                assert pixel.shape == (len(shapes[idx]),)
+                for d, extent in enumerate(shapes[idx]):
+                    assert 0 <= pixel[d] < extent
+
+def test_random_mask_pixel_sparse():
+    for device in ('cpu', 'gpu'):
+        yield check_random_mask_pixel_sparse, device
@@ -0,0 +1,121 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import numpy as np
+import random
+import nvidia.dali.fn as fn
+from nvidia.dali import pipeline_def
+from nose.tools import nottest
+from nose_utils import assert_raises
+from segmentation_test_utils import make_batch_select_masks
+
+
+def rasterize_ref(polygons, vertices, shape, labels=None, normalized=False):
+    h, w = shape
+    out = np.zeros((h, w, 1), dtype=np.int32)
+    ys, xs = np.mgrid[0:h, 0:w]
+    px = xs.astype(np.float32) + np.float32(0.5)
+    py = ys.astype(np.float32) + np.float32(0.5)
+    for mask_id, start, end in polygons:
+        if end - start < 3:
+            continue
+        v = vertices[start:end].astype(np.float32)
+        if normalized:
+            v = v * np.float32([w, h])
+        inside = np.zeros((h, w), dtype=bool)
+        for i in range(len(v)):
+            (xi, yi), (xj, yj) = v[i], v[i - 1]
+            crosses = (yi > py) != (yj > py)
+            with np.errstate(divide='ignore', invalid='ignore'):
+                x_cross = (xj - xi) * (py - yi) / (yj - yi) + xi
+            inside ^= crosses & (px < x_cross)
+        out[inside, 0] = labels[mask_id] if labels is not None else mask_id + 1
+    return out
+
+
+@nottest
+def _test_rasterize_polygons(batch_size, normalized, use_labels, per_sample_shape):
+    polygons, vertices, _ = make_batch_select_masks(batch_size, npolygons_range=(1, 6),
+                                                    nvertices_range=(3, 12))
+    if not normalized:
+        vertices = [v * np.float32([50, 40]) for v in vertices]
+    labels = [np.random.randint(1, 100, size=len(p), dtype=np.int32) for p in polygons]
+    shapes = [np.array([random.randint(1, 70), random.randint(1, 70)], dtype=np.int32)
+              for _ in range(batch_size)]
+    if not per_sample_shape:
+        shapes = [np.int32([40, 50])] * batch_size
+
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+    def pipe():
+        p, v, lbl, shape = fn.external_source(lambda: (polygons, vertices, labels, shapes),
+                                              num_outputs=4)
+        inputs = [p, v, lbl] if use_labels else [p, v]
+        shape_arg = shape if per_sample_shape else [40, 50]
+        return fn.segmentation.rasterize_polygons(*inputs, shape=shape_arg,
+                                                  normalized=normalized)
+
+    p = pipe()
+    p.build()
+    out, = p.run()
+    assert out.layout() == "HWC"
+    out = out.as_cpu()
+    for i in range(batch_size):
+        ref = rasterize_ref(polygons[i], vertices[i], shapes[i],
+                            labels[i] if use_labels else None, normalized)
+        np.testing.assert_array_equal(out.at(i), ref)
+
+
+def test_rasterize_polygons():
+    for normalized in [False, True]:
+        for use_labels in [False, True]:
+            for per_sample_shape in [False, True]:
+                yield _test_rasterize_polygons, 5, normalized, use_labels, per_sample_shape
+
+
+def test_overlapping_polygons():
+    # the second mask covers the right half of the first one; a mask can have several polygons
+    polygons = np.int32([[0, 0, 4], [1, 4, 8], [0, 8, 11]])
+    vertices = np.float32([[0, 0], [8, 0], [8, 8], [0, 8],
+                           [4, 0], [8, 0], [8, 8], [4, 8],
+                           [10, 10], [16, 10], [10, 16]])
+
+    @pipeline_def(batch_size=1, num_threads=1, device_id=0)
+    def pipe():
+        return fn.segmentation.rasterize_polygons(
+            fn.external_source(lambda: [polygons], batch=True),
+            fn.external_source(lambda: [vertices], batch=True),
+            shape=[16, 16])
+
+    p = pipe()
+    p.build()
+    out = p.run()[0].as_cpu().at(0)[:, :, 0]
+    assert np.all(out[:8, :4] == 1)
+    assert np.all(out[:8, 4:8] == 2)
+    assert out[10, 10] == 1 and out[15, 10] == 1
+    assert out[15, 15] == 0 and out[9, 9] == 0
+    np.testing.assert_array_equal(out, rasterize_ref(polygons, vertices, (16, 16))[:, :, 0])
+
+
+def test_invalid_vertex_range():
+    @pipeline_def(batch_size=1, num_threads=1, device_id=0)
+    def pipe():
+        return fn.segmentation.rasterize_polygons(
+            fn.external_source(lambda: [np.int32([[0, 0, 5]])], batch=True),
+            fn.external_source(lambda: [np.zeros([4, 2], dtype=np.float32)], batch=True),
+            shape=[8, 8])
+
+    with assert_raises(RuntimeError, glob="*is out of the range of the 4 vertices*"):
+        p = pipe()
+        p.build()
+        p.run()
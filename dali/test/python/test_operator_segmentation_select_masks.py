@@ -1,4 +1,4 @@
-# Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+# Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -19,11 +19,12 @@ from test_utils import check_batch, dali_type
 import random
 from segmentation_test_utils import make_batch_select_masks
 from nose_utils import assert_raises
+from nvidia.dali.backend import TensorListGPU
 
 random.seed(1234)
 np.random.seed(4321)
 
-def check_select_masks(batch_size, npolygons_range = (1, 10), nvertices_range = (3, 40), vertex_ndim = 2, vertex_dtype = np.float32, reindex_masks = False):
+def check_select_masks(batch_size, npolygons_range = (1, 10), nvertices_range = (3, 40), vertex_ndim = 2, vertex_dtype = np.float32, reindex_masks = False, device = 'cpu'):
     def get_data_source(*args, **kwargs):
         return lambda: make_batch_select_masks(*args, **kwargs)
     pipe = dali.pipeline.Pipeline(batch_size=batch_size, num_threads=4, device_id=0, seed=1234)
@@ -33,13 +34,15 @@ def check_select_masks(batch_size, npolygons_range = (1, 10), nvertices_range =
             nvertices_range=nvertices_range, vertex_ndim=vertex_ndim, vertex_dtype=vertex_dtype),
             num_outputs = 3, device='cpu'
         )
+        # mask_ids and polygons are always CPU inputs
+        in_vertices = vertices.gpu() if device == 'gpu' else vertices
         out_polygons, out_vertices = fn.segmentation.select_masks(
-            mask_ids, polygons, vertices, reindex_masks=reindex_masks
+            mask_ids, polygons, in_vertices, reindex_masks=reindex_masks
         )
     pipe.set_outputs(polygons, vertices, mask_ids, out_polygons, out_vertices)
     pipe.build()
     for iter in range(3):
-        outputs = pipe.run()
+        outputs = [out.as_cpu() if isinstance(out, TensorListGPU) else out for out in pipe.run()]
         for idx in range(batch_size):
             in_polygons = outputs[0].at(idx)
             in_vertices = outputs[1].at(idx)
@@ -80,8 +83,9 @@ def test_select_masks():
         for vertex_ndim in [2, 3, 6]:
             for vertex_dtype in [np.float, random.choice([np.int8, np.int16, np.int32, np.int64])]:
                 reindex_masks = random.choice([False, True])
-                yield check_select_masks, batch_size, npolygons_range, nvertices_range, \
-                      vertex_ndim, vertex_dtype, reindex_masks
+                for device in ['cpu', 'gpu']:
+                    yield check_select_masks, batch_size, npolygons_range, nvertices_range, \
+                          vertex_ndim, vertex_dtype, reindex_masks, device
 
 
 @dali.pipeline_def(batch_size=1, num_threads=4, device_id=0, seed=1234)
@@ -1,4 +1,4 @@
-# Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -13,6 +13,7 @@
 # limitations under the License.
 
 from nvidia.dali.pipeline import Pipeline
+from nvidia.dali import pipeline_def
 import nvidia.dali.fn as fn
 import numpy as np
 from nose_utils import raises
@@ -74,14 +75,41 @@ def check_sequence_rearrange(batch_size, shape, reorders, persample_reorder=True
 order_0 = ([3, 2, 1, 0], False)
 order_1 = ([np.int32([3, 0]), np.int32([2, 1]), np.int32([1, 1]), np.int32([0, 1, 2]), np.int32([3])], True)
 order_2 = ([np.int32([0]), np.int32([1]), np.int32([2]), np.int32([3]), np.int32([0, 1, 2, 3])], True)
+# ranges of consecutive frames - the CPU operator references the input instead of copying
+order_3 = ([np.int32([1, 2]), np.int32([0, 1, 2, 3]), np.int32([3]), np.int32([0]), np.int32([2, 3])], True)
 
 def test_sequence_rearrange():
     for dev in ["cpu", "gpu"]:
         for shape in [[4, 3, 2], [5, 1]]:
-            for new_order, per_sample in [order_0, order_1, order_2]:
+            for new_order, per_sample in [order_0, order_1, order_2, order_3]:
                 for layout in ["FHW"[:len(shape)], ""]:
                     yield check_sequence_rearrange, 5, shape, new_order, per_sample, dev, layout
 
+def test_sequence_rearrange_shared_input():
+    batch_size = 4
+    shape = [6, 3, 2]
+    new_order = [1, 2, 3]
+
+    def source(info):
+        return [get_sequence(shape, (info.iteration * batch_size + i) * shape[0])
+                for i in range(batch_size)]
+
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0, prefetch_queue_depth=2)
+    def pipe():
+        input = fn.external_source(source=source, batch_info=True, layout="FHW")
+        rearranged = fn.sequence_rearrange(input, new_order=new_order)
+        return rearranged, rearranged.gpu(), input
+
+    p = pipe()
+    p.build()
+    for _ in range(5):
+        cpu_out, gpu_out, input = p.run()
+        baseline = reorder(to_batch(input, batch_size), shape[0], new_order, False)
+        gpu_out = gpu_out.as_cpu()
+        for i in range(batch_size):
+            np.testing.assert_array_equal(cpu_out.at(i), baseline[i])
+            np.testing.assert_array_equal(gpu_out.at(i), baseline[i])
+
 def check_fail_sequence_rearrange(batch_size, shape, reorders, persample_reorder=True, op_type="cpu", layout=""):
     check_sequence_rearrange(batch_size, shape, reorders, persample_reorder, op_type, layout)
 
@@ -1,4 +1,4 @@
-# Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+# Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -114,3 +114,32 @@ def test_uniform_discrete():
     for device in ['cpu', 'gpu']:
         for values in [(0, 1, 2, 3, 4, 5), (200, 400, 5000, 1)]:
             yield check_uniform_discrete, device, batch_size, shape, values, niter
+
+def check_uniform_reproducible(device, shape):
+    def run(batch_size, num_threads, niter):
+        pipe = Pipeline(batch_size=batch_size, device_id=0, num_threads=num_threads, seed=1234)
+        with pipe:
+            pipe.set_outputs(dali.fn.random.uniform(device=device, shape=shape, seed=4321))
+        pipe.build()
+        results = []
+        for it in range(niter):
+            out, = pipe.run()
+            out = out.as_cpu() if isinstance(out, TensorListGPU) else out
+            results.append([np.array(out[i]) for i in range(batch_size)])
+        return results
+
+    niter = 3
+    ref = run(2, 1, niter)
+    out = run(5, 4, niter)
+    for it in range(niter):
+        for i in range(2):
+            # The numbers depend only on the seed, the iteration and the sample index
+            np.testing.assert_array_equal(ref[it][i], out[it][i])
+        assert not np.array_equal(out[it][0], out[it][1])
+        if it > 0:
+            assert not np.array_equal(out[it][0], out[it - 1][0])
+
+def test_uniform_reproducible():
+    for device in ['cpu', 'gpu']:
+        for shape in [[1000], [1000000]]:
+            yield check_uniform_reproducible, device, shape
@@ -1,4 +1,4 @@
-# Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -262,3 +262,25 @@ def _test_extremely_large_data(device):
 def test_extremely_large_data():
   for device in ["cpu", "gpu"]:
     yield _test_extremely_large_data, device
+
+def test_gpu_matrix_arg_input():
+  batch_size = 5
+  rng = np.random.default_rng(1234)
+
+  def get_images():
+    return [rng.integers(0, 255, size=[120, 160, 3], dtype=np.uint8) for _ in range(batch_size)]
+
+  def get_matrices():
+    return list(gen_transforms(batch_size, 15))
+
+  pipe = Pipeline(batch_size, 3, 0)
+  with pipe:
+    images = fn.external_source(source=get_images).gpu()
+    matrices = fn.external_source(source=get_matrices)
+    warped_cpu_arg = fn.warp_affine(images, matrix=matrices, size=[100, 100], fill_value=42)
+    warped_gpu_arg = fn.warp_affine(images, matrix=matrices.gpu(), size=[100, 100], fill_value=42)
+    pipe.set_outputs(warped_cpu_arg, warped_gpu_arg)
+  pipe.build()
+  for _ in range(3):
+    out_cpu_arg, out_gpu_arg = pipe.run()
+    check_batch(out_cpu_arg, out_gpu_arg, batch_size)
@@ -94,16 +94,17 @@ def load_frames(sample_info=types.SampleInfo(0, 0, 0, 0), hint_grid=None):
     return result
 
 @pipeline_def(batch_size=1, seed=16)
-def of_pipeline(output_grid=1, hint_grid=1, use_temporal_hints=False):
+def of_pipeline(output_grid=1, hint_grid=1, use_temporal_hints=False, num_sessions=1):
     if hint_grid is not None:
         seq, hint = fn.external_source(lambda info: load_frames(info, hint_grid), layout=["FHWC", "FHWC"], batch=False, num_outputs=2)
 
         of = fn.optical_flow(seq.gpu(), hint.gpu(), device="gpu", output_grid=output_grid,
-                             hint_grid=hint_grid, enable_temporal_hints=use_temporal_hints)
+                             hint_grid=hint_grid, enable_temporal_hints=use_temporal_hints,
+                             num_sessions=num_sessions)
     else:
         seq = fn.external_source(lambda info: load_frames(info, hint_grid), layout="FHWC", batch=False)
         of = fn.optical_flow(seq.gpu(), device="gpu", output_grid=output_grid,
-                             enable_temporal_hints=use_temporal_hints)
+                             enable_temporal_hints=use_temporal_hints, num_sessions=num_sessions)
     return seq, of
 
 def make_colorwheel():
@@ -224,10 +225,11 @@ def flow_to_color(flow_uv, clip_flow=None, convert_to_bgr=False):
 
 interactive = False
 
-def check_optflow(output_grid=1, hint_grid=1, use_temporal_hints=False):
+def check_optflow(output_grid=1, hint_grid=1, use_temporal_hints=False, num_sessions=1):
     batch_size = 3
     pipe = of_pipeline(batch_size=batch_size, num_threads=3, device_id=0, output_grid=output_grid,
-                       hint_grid=hint_grid, use_temporal_hints=use_temporal_hints)
+                       hint_grid=hint_grid, use_temporal_hints=use_temporal_hints,
+                       num_sessions=num_sessions)
     pipe.build()
     if get_arch() < 8:
         if output_grid != 4 and (hint_grid in [4, 8, None]):
@@ -264,6 +266,8 @@ def test_optflow():
         hint_grid = random.choice([None, 1, 2, 4, 8])
         for use_temporal_hints in [True, False]:
             yield check_optflow, output_grid, hint_grid, use_temporal_hints
+        # the sequences of the batch are split between two sessions
+        yield check_optflow, output_grid, hint_grid, False, 2
 
 @raises(RuntimeError, "Output grid size: 3 is not supported, supported are:")
 def test_wrong_out_grid_size():
@@ -29,6 +29,7 @@ import random
 from PIL import Image
 from math import floor, ceil
 import sys
+import time
 import warnings
 from webdataset_base import generate_temp_index_file as generate_temp_wds_index
 
@@ -1349,6 +1350,30 @@ def test_duplicated_outs_cpu_op_to_gpu():
     for device in ["cpu", "gpu"]:
         yield check_duplicated_outs_cpu_to_gpu, device
 
+def test_cpu_outputs_contiguous_and_not():
+    batch_size = 4
+    iteration = 0
+
+    # even iterations provide a contiguous batch, odd ones - a list of separate samples
+    def get_data():
+        nonlocal iteration
+        data = np.full((batch_size, 3, 5), iteration, dtype=np.int32) + \
+            np.arange(batch_size, dtype=np.int32)[:, np.newaxis, np.newaxis]
+        iteration += 1
+        return data if iteration % 2 else [sample.copy() for sample in data]
+
+    pipe = Pipeline(batch_size, 2, 0, prefetch_queue_depth=2)
+    with pipe:
+        data = fn.external_source(source=get_data)
+        pipe.set_outputs(data, fn.cast(data, dtype=types.FLOAT))
+    pipe.build()
+    for i in range(6):
+        data, cast = pipe.run()
+        for j in range(batch_size):
+            expected = np.full((3, 5), i + j, dtype=np.int32)
+            assert_array_equal(data.at(j), expected)
+            assert_array_equal(cast.at(j), expected.astype(np.float32))
+
 def test_ref_count():
     class HybridPipe(Pipeline):
         def __init__(self):
@@ -1445,6 +1470,187 @@ def test_bytes_per_sample_hint():
     new_reader_meta = obtain_reader_meta(iters=1, bytes_per_sample_hint = [int(v * 1.1) for v in reader_meta['max_reserved_memory_size']])
     assert new_reader_meta['max_reserved_memory_size'] > reader_meta['max_reserved_memory_size']
 
+def test_operator_timing():
+    batch_size = 8
+    iters = 5
+    pipe = Pipeline(batch_size, 2, 0, enable_operator_timing=True)
+    with pipe:
+        data = fn.random.uniform(range=(0, 1), shape=(64, 64))
+        out = fn.flip(data.gpu(), horizontal=1)
+        pipe.set_outputs(out)
+    pipe.build()
+    for _ in range(iters):
+        pipe.run()
+    timing = pipe.operator_timing()
+    assert timing["elapsed_time"] > 0
+    gpu_ops = [k for k in timing["operators"].keys() if k.startswith("GPU_")]
+    assert len(gpu_ops) > 0
+    # the pipeline prefetches the iterations ahead of run()
+    for k, v in timing["operators"].items():
+        assert v["num_runs"] >= iters, k
+        assert v["num_samples"] == v["num_runs"] * batch_size, k
+        assert v["host_time"] >= 0, k
+    for k in gpu_ops:
+        assert timing["operators"][k]["num_gpu_runs"] > 0, k
+    for stage in ("cpu", "mixed", "gpu"):
+        stats = timing["stages"][stage]
+        assert stats["num_iterations"] >= iters, stage
+        assert stats["num_samples"] == stats["num_iterations"] * batch_size, stage
+        assert stats["max_queue_occupancy"] >= 1, stage
+        assert stats["num_allocations"] >= stats["last_allocations"] >= 0, stage
+
+def test_bottleneck_summary():
+    pipe = Pipeline(8, 2, 0, enable_operator_timing=True, exec_separated=True,
+                    prefetch_queue_depth={"cpu_size": 2, "gpu_size": 2})
+    with pipe:
+        data = fn.random.uniform(range=(0, 1), shape=(64, 64))
+        pipe.set_outputs(fn.flip(data.gpu(), horizontal=1))
+    pipe.build()
+    for _ in range(5):
+        pipe.run()
+        # a slow consumer - the stages wait for the free buffers
+        time.sleep(0.05)
+    timing = pipe.operator_timing()
+    for stage in ("cpu", "mixed", "gpu"):
+        assert timing["stages"][stage]["producer_wait"] >= 0, stage
+        assert timing["stages"][stage]["consumer_wait"] >= 0, stage
+    bottleneck = timing["bottleneck"]
+    assert set(bottleneck.keys()) == {"cpu", "mixed", "gpu", "consumer"}
+    assert abs(sum(bottleneck.values()) - 1) < 1e-6
+    assert max(bottleneck, key=bottleneck.get) == "consumer"
+    summary = pipe.bottleneck_summary().splitlines()
+    assert len(summary) == 4
+    assert summary[0].startswith("consumer was the limiter")
+
+def test_operator_timing_disabled():
+    pipe = Pipeline(1, 1, 0)
+    with pipe:
+        pipe.set_outputs(fn.random.uniform(range=(0, 1)))
+    pipe.build()
+    with assert_raises(RuntimeError, glob="enable_operator_timing"):
+        pipe.operator_timing()
+
+def test_tracing():
+    import json
+    import tempfile
+    from nvidia.dali import backend
+    pipe = Pipeline(2, 2, 0)
+    with pipe:
+        data = fn.random.uniform(range=(0, 1), shape=[16])
+        pipe.set_outputs(fn.flip(data.gpu(), horizontal=1, name="flip"))
+    pipe.build()
+    backend.StartTracing()
+    for _ in range(3):
+        pipe.run()
+    backend.StopTracing()
+    with tempfile.TemporaryDirectory() as tmp:
+        filename = os.path.join(tmp, "trace.json")
+        backend.WriteTrace(filename)
+        with open(filename) as f:
+            trace = json.load(f)
+    spans = [e for e in trace["traceEvents"] if e["ph"] == "X"]
+    names = set(e["name"] for e in spans)
+    assert "[DALI][Executor] RunCPU" in names
+    assert "[DALI][GPU op] flip Setup" in names
+    assert "[DALI][GPU op] flip Run" in names
+    assert any(e["cat"] == "gpu" and e["name"] == "[DALI][GPU op] flip" for e in spans)
+    assert all(e["dur"] >= 0 for e in spans)
+
+def test_low_latency():
+    pipe = Pipeline(1, 2, 0, low_latency=True)
+    with pipe:
+        data = fn.external_source(name="data", device="cpu")
+        pipe.set_outputs(fn.flip(data, horizontal=1), data.gpu())
+    pipe.build()
+    assert pipe.low_latency
+    assert not pipe.exec_pipelined
+    assert not pipe.exec_async
+    for i in range(3):
+        sample = np.full((4, 8, 3), i, dtype=np.uint8)
+        sample[:, 0] = 255
+        pipe.feed_input("data", [sample])
+        flipped, gpu = pipe.run()
+        assert_array_equal(flipped.at(0), sample[:, ::-1])
+        assert_array_equal(gpu.as_cpu().at(0), sample)
+
+def test_low_latency_invalid():
+    with assert_raises(ValueError, glob="low_latency"):
+        Pipeline(1, 1, 0, low_latency=True, prefetch_queue_depth={"cpu_size": 1, "gpu_size": 1})
+    with assert_raises(ValueError, glob="low_latency"):
+        Pipeline(1, 1, 0, low_latency=True, exec_dynamic=True)
+
+def test_coalesce_iterations():
+    batch_size = 2
+    coalesce = 4
+    pipe = Pipeline(batch_size, 2, 0, prefetch_queue_depth=1, coalesce_iterations=coalesce)
+    with pipe:
+        data = fn.external_source(name="data", device="cpu")
+        pipe.set_outputs(data + 1, data.gpu())
+    pipe.build()
+    assert pipe.coalesce_iterations == coalesce
+    # the last coalesced batch is short - it makes 3 batches, the last of them of one sample
+    feeds = [list(range(0, 8)), list(range(8, 16)), list(range(16, 21))]
+    for feed in feeds:
+        pipe.feed_input("data", [np.full((j % 3 + 1, 2), j, dtype=np.int32) for j in feed])
+    expected = [j for feed in feeds for j in feed]
+    iters = 4 + 4 + 3
+    for i in range(iters):
+        plus_one, gpu = pipe.run()
+        cpu = gpu.as_cpu()
+        samples = expected[i * batch_size:(i + 1) * batch_size]
+        assert len(plus_one) == len(samples)
+        for k, j in enumerate(samples):
+            ref = np.full((j % 3 + 1, 2), j, dtype=np.int32)
+            assert_array_equal(plus_one.at(k), ref + 1)
+            assert_array_equal(cpu.at(k), ref)
+
+def test_coalesce_iterations_invalid():
+    with assert_raises(ValueError, glob="coalesce_iterations"):
+        Pipeline(1, 1, 0, coalesce_iterations=2, enable_checkpointing=True)
+    pipe = Pipeline(1, 1, 0, coalesce_iterations=2)
+    with pipe:
+        pipe.set_outputs(fn.external_source(source=lambda: [np.zeros(1)]))
+    with assert_raises(ValueError, glob="coalesce_iterations"):
+        pipe.build()
+
+def test_shared_thread_pool():
+    batch_size = 8
+    rng = np.random.default_rng(4321)
+    data = [rng.integers(0, 255, size=(16, 32, 3), dtype=np.uint8) for _ in range(batch_size)]
+
+    def make_pipe(num_threads, priority):
+        pipe = Pipeline(batch_size, num_threads, 0, shared_thread_pool=True,
+                        thread_pool_priority=priority)
+        with pipe:
+            pipe.set_outputs(fn.flip(fn.external_source(source=lambda: data), horizontal=1))
+        pipe.build()
+        return pipe
+
+    pipes = [make_pipe(2, 0), make_pipe(4, 0), make_pipe(3, 1)]
+    for _ in range(3):
+        for pipe in pipes:
+            out, = pipe.run()
+            for i in range(batch_size):
+                assert_array_equal(out.at(i), data[i][:, ::-1])
+
+def test_work_stealing_thread_pool():
+    batch_size = 32
+    rng = np.random.default_rng(1234)
+    data = [rng.integers(0, 255, size=(16, 32, 3), dtype=np.uint8) for _ in range(batch_size)]
+
+    pipe = Pipeline(batch_size, 4, 0, work_stealing_thread_pool=True)
+    with pipe:
+        pipe.set_outputs(fn.flip(fn.external_source(source=lambda: data), horizontal=1))
+    pipe.build()
+    for _ in range(3):
+        out, = pipe.run()
+        for i in range(batch_size):
+            assert_array_equal(out.at(i), data[i][:, ::-1])
+
+def test_work_stealing_and_shared_thread_pool():
+    with assert_raises(ValueError, glob="can't be used together"):
+        Pipeline(1, 1, 0, shared_thread_pool=True, work_stealing_thread_pool=True)
+
 def trigger_output_dtype_deprecated_warning():
     batch_size = 10
     shape = (120, 60, 3)
@@ -1778,3 +1984,67 @@ def test_double_output_dtype_ndim():
         create_test_package(output_dtype=int)
     with assert_raises(ValueError, glob="*types.NO_TYPE*"):
         create_test_package(output_dtype=types.NO_TYPE)
+
+
+def test_cuda_graphs():
+    batch_size = 4
+    rng = np.random.default_rng(1234)
+    # the shapes are stable for a while (captured and replayed), then change (captured again);
+    # each of the queue slots sees every other iteration and is captured after it was stable
+    # for two eager runs
+    shapes = [(10, 3)] * 10 + [(7, 3)] * 10 + [(10, 3)] * 3
+    batches = [[rng.uniform(-10, 10, size=shape).astype(np.float32)
+                for _ in range(batch_size)] for shape in shapes]
+
+    @pipeline_def(batch_size=batch_size, num_threads=1, device_id=0)
+    def pipe():
+        points = fn.external_source(source=batches, cycle=False).gpu()
+        points = fn.coord_transform(points, M=[1, 2, 3, 4, 5, 6, 7, 8, 9], T=[1, 2, 3])
+        return fn.cast(points, dtype=types.INT16)
+
+    def outputs(cuda_graphs):
+        p = pipe(cuda_graphs=cuda_graphs, enable_operator_timing=True)
+        p.build()
+        out = [p.run()[0].as_cpu().as_array().copy() for _ in shapes]
+        return out, p.operator_timing()["stages"]["gpu"]
+
+    ref, ref_stats = outputs(False)
+    out, stats = outputs(True)
+    for ref_batch, out_batch in zip(ref, out):
+        assert_array_equal(ref_batch, out_batch)
+    assert ref_stats["num_graph_captures"] == 0 and ref_stats["num_graph_replays"] == 0
+    # captured (and replayed) for both shapes
+    assert stats["num_graph_captures"] >= 2, stats
+    assert stats["num_graph_replays"] >= 2, stats
+
+
+def test_share_outputs_with_shapes():
+    batch_size = 5
+    rng = np.random.default_rng(4321)
+
+    def get_data():
+        return [rng.integers(0, 100, size=(rng.integers(1, 10), rng.integers(1, 4), 3),
+                             dtype=np.uint8) for _ in range(batch_size)]
+
+    @pipeline_def(batch_size=batch_size, num_threads=2, device_id=0, prefetch_queue_depth=2)
+    def pipe():
+        data = fn.external_source(source=get_data)
+        flat = fn.reshape(data, shape=[-1])
+        return data, flat.gpu(), fn.shapes(data)
+
+    p = pipe()
+    p.build()
+    for _ in range(6):
+        p.schedule_run()
+        outputs, shapes, num_samples, ndims = p.share_outputs_with_shapes()
+        assert shapes.dtype == np.int64
+        assert shapes.shape == (3, batch_size, 3)
+        assert num_samples.tolist() == [batch_size] * 3
+        assert ndims.tolist() == [3, 1, 1]
+        for o, out in enumerate(outputs):
+            for s, sample_shape in enumerate(out.shape()):
+                assert shapes[o, s, :ndims[o]].tolist() == list(sample_shape)
+                assert (shapes[o, s, ndims[o]:] == 0).all()
+        # the shapes of the samples are also the contents of the last output
+        assert_array_equal(shapes[0], outputs[2].as_array())
+        p.release_outputs()
@@ -0,0 +1,153 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import math
+import numpy as np
+import os
+import nvidia.dali.fn as fn
+from nvidia.dali import pipeline_def
+from nose.tools import nottest
+from nose_utils import assert_raises
+from test_utils import check_batch, get_dali_extra_path
+
+images_dir = os.path.join(get_dali_extra_path(), 'db', 'single', 'jpeg')
+batch_size = 8
+
+
+@pipeline_def(batch_size=batch_size, num_threads=4, device_id=0, seed=1234)
+def augment_pipe(decoder_device, num_io_threads):
+    jpegs, labels = fn.readers.file(file_root=images_dir, random_shuffle=True, initial_fill=32,
+                                    shard_id=1, num_shards=3, pad_last_batch=True,
+                                    num_io_threads=num_io_threads, name="Reader")
+    images = fn.decoders.image_random_crop(jpegs, device=decoder_device)
+    images = fn.resize(images, size=(64, 64))
+    images = fn.random_resized_crop(images, size=(32, 32))
+    flip = fn.random.coin_flip()
+    noise = fn.random.uniform(range=(0, 1), shape=[10])
+    return images, labels, flip, noise
+
+
+def run_outputs(pipe, num_iters):
+    outputs = []
+    for _ in range(num_iters):
+        outputs.append([out.as_cpu() if hasattr(out, 'as_cpu') else out for out in pipe.run()])
+    return outputs
+
+
+def compare_outputs(outputs, ref):
+    assert len(outputs) == len(ref)
+    for iter_out, iter_ref in zip(outputs, ref):
+        for out, ref_out in zip(iter_out, iter_ref):
+            check_batch(out, ref_out, batch_size)
+
+
+@nottest
+def _test_resume(decoder_device, num_io_threads, skipped_epochs):
+    ref_pipe = augment_pipe(decoder_device, num_io_threads, enable_checkpointing=True)
+    ref_pipe.build()
+    iters_per_epoch = math.ceil(ref_pipe.epoch_size("Reader") / 3 / batch_size)
+    skipped_iters = int(skipped_epochs * iters_per_epoch)
+    run_outputs(ref_pipe, skipped_iters)
+    checkpoint = ref_pipe.checkpoint()
+    ref = run_outputs(ref_pipe, 10)
+
+    pipe = augment_pipe(decoder_device, num_io_threads, checkpoint=checkpoint)
+    pipe.build()
+    compare_outputs(run_outputs(pipe, 5), ref[:5])
+
+    # a restored pipeline can be checkpointed again
+    resumed = augment_pipe(decoder_device, num_io_threads, checkpoint=pipe.checkpoint())
+    resumed.build()
+    compare_outputs(run_outputs(resumed, 5), ref[5:])
+
+
+def test_resume():
+    for decoder_device in ['cpu', 'mixed']:
+        for num_io_threads in [1, 4]:
+            for skipped_epochs in [0, 0.5, 1.5]:
+                yield _test_resume, decoder_device, num_io_threads, skipped_epochs
+
+
+def test_checkpoint_not_enabled():
+    pipe = augment_pipe('cpu', 1)
+    pipe.build()
+    pipe.run()
+    with assert_raises(RuntimeError, glob="*enable_checkpointing=True*"):
+        pipe.checkpoint()
+
+
+def test_checkpoint_mismatch():
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0, seed=1234)
+    def other_pipe():
+        return fn.random.normal(shape=[10]), fn.random.coin_flip()
+
+    pipe = augment_pipe('cpu', 1, enable_checkpointing=True)
+    pipe.build()
+    pipe.run()
+    with assert_raises(RuntimeError, glob="*checkpoint doesn't match the pipeline*"):
+        other = other_pipe(checkpoint=pipe.checkpoint())
+        other.build()
+
+
+@pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+def sharded_pipe(shard_id, num_shards):
+    jpegs, _ = fn.readers.file(file_root=images_dir, global_shuffle=True, shard_id=shard_id,
+                               num_shards=num_shards, name="Reader")
+    return fn.get_property(jpegs, key="source_info")
+
+
+def read_files(pipe, num_iters):
+    files = []
+    for _ in range(num_iters):
+        out, = pipe.run()
+        files += [np.array(out[i]).tobytes().decode() for i in range(len(out))]
+    return files
+
+
+def test_reshard():
+    # 3 ranks read a part of the epoch, then 2 ranks take over from the checkpoint of one of them
+    pipes = [sharded_pipe(shard_id, 3, enable_checkpointing=True) for shard_id in range(3)]
+    for pipe in pipes:
+        pipe.build()
+    epoch_size = pipes[0].epoch_size("Reader")
+    num_iters = max(epoch_size // 9 // batch_size, 1)
+    files = []
+    for pipe in pipes:
+        files += read_files(pipe, num_iters)
+    checkpoint = pipes[0].checkpoint()
+
+    left = epoch_size - len(files)
+    for shard_id in range(2):
+        pipe = sharded_pipe(shard_id, 2, checkpoint=checkpoint)
+        pipe.build()
+        shard_left = left * (shard_id + 1) // 2 - left * shard_id // 2
+        # the last batch is filled up with the samples of the next epoch
+        files += read_files(pipe, -(-shard_left // batch_size))[:shard_left]
+    assert len(files) == epoch_size
+    assert len(set(files)) == epoch_size
+
+
+def test_reshard_pad_last_batch():
+    @pipeline_def(batch_size=batch_size, num_threads=4, device_id=0)
+    def padded_pipe(shard_id, num_shards):
+        jpegs, _ = fn.readers.file(file_root=images_dir, global_shuffle=True, shard_id=shard_id,
+                                   num_shards=num_shards, pad_last_batch=True)
+        return jpegs
+
+    pipe = padded_pipe(0, 3, enable_checkpointing=True)
+    pipe.build()
+    pipe.run()
+    with assert_raises(RuntimeError, glob="*``pad_last_batch`` cannot be resharded*"):
+        other = padded_pipe(0, 2, checkpoint=pipe.checkpoint())
+        other.build()
@@ -580,3 +580,35 @@ def test_variable_batch_size():
     pipe = incorrect_variable_batch_size_pipeline()
     pipe.build()
     pipe.run()
+
+
+def test_debug_pipeline_capture():
+    pipe_standard = rn50_pipeline_base()
+    pipe_capture = rn50_pipeline_base(debug='capture')
+    compare_pipelines(pipe_standard, pipe_capture, 8, 10)
+    assert pipe_capture._graph_pipe is not None
+
+
+@pipeline_def(batch_size=8, num_threads=3, device_id=0)
+def capture_fallback_pipeline(access_data=None):
+    jpegs, labels = fn.readers.file(file_root=file_root)
+    images = fn.decoders.image(jpegs, device='mixed')
+    images = fn.resize(images, resize_x=224, resize_y=224)
+    if access_data is not None and access_data():
+        # Accessing the data makes the iteration run eagerly.
+        image = np.array(images.get().as_cpu()[0])
+        assert image.shape == (224, 224, 3) and image.dtype == np.uint8
+    output = fn.flip(images, horizontal=1) + 1
+    return output, labels
+
+
+def test_debug_pipeline_capture_fallback():
+    iteration = [0]
+
+    def access_data():
+        iteration[0] += 1
+        return iteration[0] % 3 == 0
+
+    pipe_standard = capture_fallback_pipeline()
+    pipe_capture = capture_fallback_pipeline(access_data, debug='capture')
+    compare_pipelines(pipe_standard, pipe_capture, 8, 10)
@@ -0,0 +1,110 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import numpy as np
+from numpy.testing import assert_array_equal
+from nose.tools import nottest
+
+import nvidia.dali.fn as fn
+from nvidia.dali import pipeline_def, remote
+from nose_utils import assert_raises
+
+batch_size = 4
+num_iters = 3
+
+
+def worker_batches(worker_id):
+    return [[np.full((i % 3 + 1, 2), worker_id * 1000 + it * 100 + i, dtype=np.int32)
+             for i in range(batch_size)] for it in range(num_iters)]
+
+
+@pipeline_def(batch_size=batch_size, num_threads=2, device_id=None)
+def worker_pipe(batches):
+    data = fn.external_source(source=batches, cycle=False, layout="XY")
+    return data, fn.cast(data, dtype=np.float32) * 0.5
+
+
+@pipeline_def(batch_size=batch_size, num_threads=2, device_id=0)
+def trainer_pipe(addresses, prefetch):
+    data, halves = remote.inputs(addresses, prefetch=prefetch)
+    return data.gpu() + 1, halves
+
+
+def start_servers(num_workers, compression):
+    servers = [remote.PipelineServer(worker_pipe(worker_batches(w)), host="localhost",
+                                     compression=compression) for w in range(num_workers)]
+    for server in servers:
+        server.start()
+    return servers, ["{}:{}".format(*server.address) for server in servers]
+
+
+@nottest
+def _test_remote_inputs(num_workers, compression, prefetch):
+    servers, addresses = start_servers(num_workers, compression)
+    try:
+        pipe = trainer_pipe(addresses, prefetch)
+        pipe.build()
+        for epoch in range(2):
+            # the workers are visited in turns
+            expected = [(worker_batches(w)[it], w) for it in range(num_iters)
+                        for w in range(num_workers)]
+            for ref, _ in expected:
+                data, halves = pipe.run()
+                assert data.layout() == "XY"
+                data = data.as_cpu()
+                for i in range(batch_size):
+                    assert_array_equal(data.at(i), ref[i] + 1)
+                    assert_array_equal(halves.at(i), ref[i].astype(np.float32) * 0.5)
+            with assert_raises(StopIteration):
+                pipe.run()
+            pipe.reset()
+    finally:
+        for server in servers:
+            server.close()
+
+
+def test_remote_inputs():
+    for num_workers in [1, 2]:
+        for compression in [None, "zlib"]:
+            for prefetch in [1, 3]:
+                yield _test_remote_inputs, num_workers, compression, prefetch
+
+
+def test_gpu_pipeline_rejected():
+    @pipeline_def(batch_size=batch_size, num_threads=2, device_id=0)
+    def pipe():
+        return fn.external_source(source=worker_batches(0), cycle=False)
+
+    with assert_raises(ValueError, glob="*must be created with `device_id=None`*"):
+        remote.PipelineServer(pipe())
+
+
+def test_worker_error():
+    def failing_source():
+        raise ValueError("a failure in the worker")
+        yield
+
+    @pipeline_def(batch_size=batch_size, num_threads=2, device_id=None)
+    def pipe():
+        return fn.external_source(source=failing_source)
+
+    server = remote.PipelineServer(pipe(), host="localhost")
+    server.start()
+    try:
+        source = remote.RemoteSource("{}:{}".format(*server.address))
+        with assert_raises(RuntimeError, glob="*remote pipeline failed*a failure in the worker*"):
+            next(iter(source))
+        source.close()
+    finally:
+        server.close()
@@ -0,0 +1,90 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import numpy as np
+from numpy.testing import assert_array_equal
+
+import nvidia.dali.fn as fn
+from nvidia.dali import pipeline_def, ShardedPipeline
+from nose_utils import assert_raises
+
+shard_batch_size = 3
+num_shards = 2
+num_iters = 4
+
+
+def host_batches():
+    return [[np.full((i % 5 + 1, 2), it * 100 + i, dtype=np.int32)
+             for i in range(shard_batch_size * num_shards)] for it in range(num_iters)]
+
+
+@pipeline_def(batch_size=shard_batch_size * num_shards, num_threads=2, device_id=None)
+def host_pipe(batches):
+    data = fn.external_source(source=batches, cycle=False, layout="XY")
+    return data, data * 2
+
+
+def device_fn(data, doubled):
+    return data.gpu() + 1, doubled, data
+
+
+def test_sharded_outputs():
+    batches = host_batches()
+    # the shards may be processed on the same device
+    pipe = ShardedPipeline(host_pipe(batches), device_fn, device_ids=[0] * num_shards,
+                           prefetch_queue_depth=2)
+    pipe.build()
+    for epoch in range(2):
+        for it in range(num_iters):
+            shards = pipe.run()
+            assert len(shards) == num_shards
+            for s, (plus_one, doubled, data) in enumerate(shards):
+                assert data.layout() == "XY"
+                for i in range(shard_batch_size):
+                    ref = batches[it][s * shard_batch_size + i]
+                    assert_array_equal(plus_one.as_cpu().at(i), ref + 1)
+                    assert_array_equal(doubled.at(i), ref * 2)
+        with assert_raises(StopIteration):
+            pipe.run()
+        pipe.reset()
+
+
+def test_peer_copies():
+    batches = host_batches()
+    pipe = ShardedPipeline(host_pipe(batches), device_fn, device_ids=[0] * num_shards,
+                           peer_copies=True)
+    pipe.build()
+    for it in range(num_iters):
+        shards = pipe.run()
+        for s, (plus_one, doubled, data) in enumerate(shards):
+            # the inputs of the device pipelines are already on the GPU
+            assert data.layout() == "XY"
+            plus_one, doubled = plus_one.as_cpu(), doubled.as_cpu()
+            for i in range(shard_batch_size):
+                ref = batches[it][s * shard_batch_size + i]
+                assert_array_equal(plus_one.at(i), ref + 1)
+                assert_array_equal(doubled.at(i), ref * 2)
+    with assert_raises(StopIteration):
+        pipe.run()
+
+
+def test_indivisible_batch():
+    with assert_raises(ValueError, glob="*must be divisible by the number of devices*"):
+        ShardedPipeline(host_pipe(host_batches()), device_fn, device_ids=[0] * 4)
+
+
+def test_host_pipeline_on_gpu():
+    pipe = host_pipe(host_batches(), device_id=0)
+    with assert_raises(ValueError, glob="*must be created with `device_id=None`*"):
+        ShardedPipeline(pipe, device_fn, device_ids=[0] * num_shards)
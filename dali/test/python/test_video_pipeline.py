@@ -1,4 +1,4 @@
-# Copyright (c) 2019-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -419,3 +419,85 @@ def test_pad_sequence():
 
     assert sampl_idx == padded_sampl
     assert ts_index == last_sample_frame_count
+
+def test_frame_cache():
+    @pipeline_def(batch_size=BATCH_SIZE, num_threads=2, device_id=0)
+    def create_video_pipe(frame_cache_size):
+        fr, _, fr_num, time_stamp = fn.readers.video(device="gpu", filenames=VIDEO_FILES[:1], labels=[],
+                                                     sequence_length=COUNT, step=2, stride=1,
+                                                     enable_timestamps=True, enable_frame_num=True,
+                                                     random_shuffle=False,
+                                                     frame_cache_size=frame_cache_size)
+        return fr, fr_num, time_stamp
+
+    # the sequences overlap and the epochs wrap around, so most of the frames come from the cache
+    ref_pipe = create_video_pipe(0)
+    pipe = create_video_pipe(64)
+    ref_pipe.build()
+    pipe.build()
+    for _ in range(3 * ITER):
+        ref_out = ref_pipe.run()
+        out = pipe.run()
+        for ref, tested in zip(ref_out, out):
+            for i in range(BATCH_SIZE):
+                np.testing.assert_array_equal(np.array(ref.as_cpu()[i]), np.array(tested.as_cpu()[i]))
+
+def test_sparse_sampling():
+    stride = 8
+    span = 1 + (COUNT - 1) * stride
+    @pipeline_def(batch_size=BATCH_SIZE, num_threads=2, device_id=0)
+    def create_video_pipe(sequence_length, stride):
+        return fn.readers.video(device="gpu", filenames=VIDEO_FILES, sequence_length=sequence_length,
+                                step=span + 3, stride=stride, random_shuffle=False)
+
+    # the non-reference frames which are not returned are not decoded in the sparse pipeline
+    sparse_pipe = create_video_pipe(COUNT, stride)
+    dense_pipe = create_video_pipe(span, 1)
+    sparse_pipe.build()
+    dense_pipe.build()
+    for _ in range(ITER):
+        sparse_out, = sparse_pipe.run()
+        dense_out, = dense_pipe.run()
+        for i in range(BATCH_SIZE):
+            sparse = np.array(sparse_out.as_cpu()[i])
+            dense = np.array(dense_out.as_cpu()[i])
+            np.testing.assert_array_equal(sparse, dense[::stride])
+
+def check_fused_output(dtype, layout, mean, std):
+    @pipeline_def(batch_size=BATCH_SIZE, num_threads=2, device_id=0)
+    def create_video_pipe(**kwargs):
+        return fn.experimental.readers.video(device="gpu", filenames=VIDEO_FILES[:2],
+                                             sequence_length=COUNT, step=COUNT, **kwargs)
+
+    ref_pipe = create_video_pipe()
+    kwargs = {"dtype": dtype, "output_layout": layout}
+    if mean is not None:
+        kwargs["mean"] = mean
+        kwargs["std"] = std
+    pipe = create_video_pipe(**kwargs)
+    ref_pipe.build()
+    pipe.build()
+    perm = ["FHWC".index(dim) for dim in layout]
+    for _ in range(ITER):
+        ref_out, = ref_pipe.run()
+        out, = pipe.run()
+        assert out.layout() == layout
+        for i in range(BATCH_SIZE):
+            ref = np.array(ref_out.as_cpu()[i]).astype(np.float32)
+            if mean is not None:
+                ref = (ref - np.float32(mean)) / np.float32(std)
+            ref = np.transpose(ref, perm)
+            tested = np.array(out.as_cpu()[i])
+            assert tested.dtype == types.to_numpy_type(dtype)
+            # the uint8 reference is rounded
+            np.testing.assert_allclose(tested.astype(np.float32), ref,
+                                       atol=(1 if mean is None else 1 / min(std) + 1e-2))
+
+def test_fused_output():
+    for dtype, layout, mean, std in [
+            (types.UINT8, "FCHW", None, None),
+            (types.FLOAT, "FHWC", None, None),
+            (types.FLOAT, "FCHW", [0.485 * 255, 0.456 * 255, 0.406 * 255],
+             [0.229 * 255, 0.224 * 255, 0.225 * 255]),
+            (types.FLOAT16, "CFHW", [128], [64])]:
+        yield check_fused_output, dtype, layout, mean, std
@@ -171,3 +171,30 @@ def test_video_resize(batch_size=2):
     for vp in video_reader_params:
         for rp in resize_params:
             yield run_for_params, batch_size, vp, rp
+
+
+def run_hw_resize_for_params(batch_size, video_reader_params, resize_params):
+    pipeline = video_reader_resize_pipeline(
+        batch_size, video_reader_params, resize_params)
+    gt_pipeline = ground_truth_pipeline(
+        batch_size, video_reader_params, resize_params)
+
+    batch = pipeline.run()[0].as_cpu()
+    for sample_id in range(batch_size):
+        sample = batch.at(sample_id)
+        for frame_id in range(video_reader_params['sequence_length']):
+            frame = sample[frame_id]
+            gt_frame = gt_pipeline.run()[0].as_cpu().as_array()[0]
+            assert gt_frame.shape == frame.shape, "Shapes are not equal: {} != {}".format(
+                gt_frame.shape, frame.shape)
+            # the decoder's scaler doesn't match the resize exactly
+            mean_err = np.mean(np.abs(gt_frame.astype(np.float32) - frame.astype(np.float32)))
+            assert mean_err < 8, "Mean error too large: {}".format(mean_err)
+    gc.collect()
+
+
+def test_video_resize_hw(batch_size=2):
+    for vp in video_reader_params:
+        for size_args in [{'resize_x': 300, 'resize_y': 200}, {'size': [120, 160]}]:
+            rp = {'interp_type': types.DALIInterpType.INTERP_LINEAR, **size_args}
+            yield run_hw_resize_for_params, batch_size, vp, rp
@@ -1,4 +1,4 @@
-# Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 #
 # Licensed under the Apache License, Version 2.0 (the "License");
 # you may not use this file except in compliance with the License.
@@ -44,6 +44,7 @@ def webdataset_raw_pipeline(
     lazy_init=False,
     read_ahead=False,
     stick_to_shard=False,
+    index_cache_dir="",
 ):
     out = readers.webdataset(
         paths=paths,
@@ -60,6 +61,7 @@ def webdataset_raw_pipeline(
         pad_last_batch=pad_last_batch,
         lazy_init=lazy_init,
         read_ahead=read_ahead,
+        index_cache_dir=index_cache_dir,
     )
     return out if not isinstance(out, list) else tuple(out)
 
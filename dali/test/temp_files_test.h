@@ -0,0 +1,81 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_TEST_TEMP_FILES_TEST_H_
+#define DALI_TEST_TEMP_FILES_TEST_H_
+
+#include <ftw.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace dali {
+namespace test {
+
+/**
+ * @brief A fixture for the tests reading files; creates a temporary directory for them
+ *        and removes it, along with its contents, after the test
+ */
+class TempFilesTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string tmpl = "/tmp/dali_test_XXXXXX";
+    const char *dir = mkdtemp(&tmpl[0]);
+    ASSERT_NE(dir, nullptr) << "Cannot create a temporary directory: " << std::strerror(errno);
+    root_ = dir;
+  }
+
+  void TearDown() override {
+    if (!root_.empty())
+      nftw(root_.c_str(), Remove, 64, FTW_DEPTH | FTW_PHYS);
+  }
+
+  /**
+   * @brief Creates the file `name` of `size` bytes in the temporary directory
+   *
+   * @return the path of the file
+   */
+  std::string MakeFile(const std::string &name, size_t size) {
+    std::string path = root_ + "/" + name;
+    std::ofstream f(path);
+    for (size_t i = 0; i < size; i++)
+      f.put(name[0] + i % 7);
+    return path;
+  }
+
+  /**
+   * @brief Returns the contents of the file
+   */
+  std::string Expected(const std::string &path) {
+    std::ifstream f(path);
+    return { std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() };
+  }
+
+  std::string root_;
+
+ private:
+  static int Remove(const char *fpath, const struct stat *, int, struct FTW *) {
+    return remove(fpath);
+  }
+};
+
+}  // namespace test
+}  // namespace dali
+
+#endif  // DALI_TEST_TEMP_FILES_TEST_H_
@@ -0,0 +1,125 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "dali/core/dynlink_cufile.h"
+#include "dali/util/cufile_batch.h"
+#include "dali/util/std_cufile.h"
+
+namespace dali {
+
+void CUFileBatchIO::AddRead(CUFileStream &file, uint8_t *buffer, ptrdiff_t buffer_offset,
+                            int64 file_offset, size_t n_bytes) {
+  DALI_ENFORCE(!full(), "The batch of cuFile reads is full.");
+  auto *std_file = dynamic_cast<StdCUFileStream *>(&file);
+  DALI_ENFORCE(std_file, "The batch I/O requires a file opened with StdCUFileStream.");
+  DALI_ENFORCE(file_offset >= 0 && static_cast<size_t>(file_offset) <= std_file->Size(),
+               "Invalid file offset");
+  n_bytes = std::min(n_bytes, std_file->Size() - file_offset);
+  if (n_bytes == 0)
+    return;
+  reads_.push_back({ std_file, buffer, buffer_offset, file_offset, n_bytes });
+}
+
+#ifdef CUFILE_BATCH_API
+
+namespace {
+
+class CUFileBatchIOImpl : public CUFileBatchIO {
+ public:
+  CUFileBatchIOImpl(CUfileBatchHandle_t handle, int capacity)
+  : CUFileBatchIO(capacity), handle_(handle) {
+    params_.reserve(capacity);
+    events_.resize(capacity);
+  }
+
+  ~CUFileBatchIOImpl() override {
+    cuFileBatchIODestroy(handle_);
+  }
+
+  void Run() override {
+    if (reads_.empty())
+      return;
+    params_.clear();
+    for (size_t i = 0; i < reads_.size(); i++) {
+      auto &read = reads_[i];
+      CUfileIOParams_t params = {};
+      params.mode = CUFILE_BATCH;
+      params.u.batch.devPtr_base = read.buffer;
+      params.u.batch.devPtr_offset = read.buffer_offset;
+      params.u.batch.file_offset = read.file_offset;
+      params.u.batch.size = read.n_bytes;
+      params.fh = read.file->Handle().cufh;
+      params.opcode = CUFILE_READ;
+      params.cookie = reinterpret_cast<void *>(i);
+      params_.push_back(params);
+    }
+
+    // the reads are forgotten even if they fail, so the batch can be reused
+    auto reads = std::move(reads_);
+    reads_.clear();
+    unsigned num_reads = reads.size();
+    CUDA_CALL(cuFileBatchIOSubmit(handle_, num_reads, params_.data(), 0));
+
+    unsigned num_done = 0;
+    while (num_done < num_reads) {
+      unsigned num_events = num_reads - num_done;
+      CUDA_CALL(cuFileBatchIOGetStatus(handle_, num_events, &num_events,
+                                       events_.data() + num_done, nullptr));
+      num_done += num_events;
+    }
+
+    for (unsigned i = 0; i < num_reads; i++) {
+      auto &event = events_[i];
+      auto &read = reads[reinterpret_cast<uintptr_t>(event.cookie)];
+      if (event.status != CUFILE_COMPLETE) {
+        DALI_FAIL(make_string("CUFile batch read failed for file ", read.file->Path(),
+                              " with status ", static_cast<int>(event.status), "."));
+      }
+      if (event.ret < read.n_bytes) {
+        read.file->ReadAtGPU(read.buffer, read.n_bytes - event.ret,
+                             read.buffer_offset + event.ret, read.file_offset + event.ret);
+      }
+    }
+  }
+
+ private:
+  CUfileBatchHandle_t handle_;
+  std::vector<CUfileIOParams_t> params_;
+  std::vector<CUfileIOEvents_t> events_;
+};
+
+}  // namespace
+
+std::unique_ptr<CUFileBatchIO> CUFileBatchIO::Create(int max_batch_size) {
+  CUfileBatchHandle_t handle;
+  // fails also when the loaded cuFile library doesn't provide the batch API
+  if (cuFileBatchIOSetUp(&handle, max_batch_size).err != CU_FILE_SUCCESS)
+    return nullptr;
+  return std::make_unique<CUFileBatchIOImpl>(handle, max_batch_size);
+}
+
+#else  // CUFILE_BATCH_API
+
+std::unique_ptr<CUFileBatchIO> CUFileBatchIO::Create(int max_batch_size) {
+  return nullptr;
+}
+
+#endif  // CUFILE_BATCH_API
+
+}  // namespace dali
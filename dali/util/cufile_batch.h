@@ -0,0 +1,95 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_UTIL_CUFILE_BATCH_H_
+#define DALI_UTIL_CUFILE_BATCH_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "dali/core/api_helper.h"
+#include "dali/core/common.h"
+#include "dali/util/cufile.h"
+
+namespace dali {
+
+class StdCUFileStream;
+
+/**
+ * @brief Reads to the GPU memory with the batch I/O API of cuFile
+ *
+ * The reads are collected with `AddRead` and submitted to cuFile together, as one batch,
+ * by `Run`. This saves the CPU time of issuing them one by one and lets the storage process
+ * them concurrently.
+ */
+class DLL_PUBLIC CUFileBatchIO {
+ public:
+  virtual ~CUFileBatchIO() = default;
+
+  /**
+   * @brief Creates a batch of at most `max_batch_size` reads
+   *
+   * @return nullptr, if the batch I/O is not supported by the cuFile library
+   */
+  static std::unique_ptr<CUFileBatchIO> Create(int max_batch_size);
+
+  /**
+   * @brief Adds a read of `n_bytes` from `file_offset` in `file` to the registered buffer
+   *        `buffer` at `buffer_offset`
+   *
+   * The reads are not started until `Run` is called. The stream must stay open until then.
+   */
+  void AddRead(CUFileStream &file, uint8_t *buffer, ptrdiff_t buffer_offset,
+               int64 file_offset, size_t n_bytes);
+
+  /**
+   * @brief Submits the added reads and waits until they're complete
+   *
+   * The reads which return fewer bytes than requested are completed synchronously.
+   */
+  virtual void Run() = 0;
+
+  int size() const {
+    return reads_.size();
+  }
+
+  int capacity() const {
+    return capacity_;
+  }
+
+  bool full() const {
+    return size() >= capacity();
+  }
+
+ protected:
+  explicit CUFileBatchIO(int capacity) : capacity_(capacity) {
+    reads_.reserve(capacity);
+  }
+
+  struct Read {
+    StdCUFileStream *file;
+    uint8_t *buffer;
+    ptrdiff_t buffer_offset;
+    int64 file_offset;
+    size_t n_bytes;
+  };
+
+  std::vector<Read> reads_;
+  int capacity_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_UTIL_CUFILE_BATCH_H_
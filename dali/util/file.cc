@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -12,16 +12,83 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <errno.h>
+#include <fcntl.h>
+#include <cctype>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "dali/core/error_handling.h"
 #include "dali/util/file.h"
 #include "dali/util/mmaped_file.h"
 #include "dali/util/std_file.h"
+#include "dali/util/uring_file.h"
 
 namespace dali {
 
+namespace {
+
+std::mutex scheme_mutex;
+std::unordered_map<std::string, FileStream::StreamFactory> &scheme_registry() {
+  static std::unordered_map<std::string, FileStream::StreamFactory> registry;
+  return registry;
+}
+
+/**
+ * @brief Returns the scheme of the URI or an empty string, if it doesn't have one
+ */
+std::string uri_scheme(const std::string &uri) {
+  auto pos = uri.find("://");
+  if (pos == std::string::npos || pos == 0 || !std::isalpha(uri[0]))
+    return {};
+  for (size_t i = 1; i < pos; i++) {
+    char c = uri[i];
+    if (!std::isalnum(c) && c != '+' && c != '-' && c != '.')
+      return {};
+  }
+  return uri.substr(0, pos);
+}
+
+}  // namespace
+
+void FileStream::RegisterScheme(const std::string &scheme, StreamFactory factory) {
+  DALI_ENFORCE(!scheme.empty() && scheme != "file", make_string("Invalid scheme: ", scheme));
+  std::lock_guard<std::mutex> guard(scheme_mutex);
+  if (factory)
+    scheme_registry()[scheme] = std::move(factory);
+  else
+    scheme_registry().erase(scheme);
+}
+
+int FileStream::OpenReadOnly(const std::string &path, bool no_atime) {
+#ifdef O_NOATIME
+  if (no_atime) {
+    int fd = open(path.c_str(), O_RDONLY | O_NOATIME);
+    if (fd >= 0 || errno != EPERM)
+      return fd;
+  }
+#endif
+  return open(path.c_str(), O_RDONLY);
+}
+
 std::unique_ptr<FileStream> FileStream::Open(const std::string& uri, bool read_ahead,
-                                             bool use_mmap) {
+                                             bool use_mmap, bool use_io_uring, bool no_atime) {
+  std::string scheme = uri_scheme(uri);
+  if (!scheme.empty() && scheme != "file") {
+    StreamFactory factory;
+    {
+      std::lock_guard<std::mutex> guard(scheme_mutex);
+      auto it = scheme_registry().find(scheme);
+      if (it != scheme_registry().end())
+        factory = it->second;
+    }
+    if (factory)
+      return factory(uri);
+  }
+
   std::string processed_uri;
 
   if (uri.find("file://") == 0) {
@@ -31,10 +98,24 @@ std::unique_ptr<FileStream> FileStream::Open(const std::string& uri, bool read_a
   }
 
   if (use_mmap) {
-    return std::unique_ptr<FileStream>(new MmapedFileStream(processed_uri, read_ahead));
+    return std::unique_ptr<FileStream>(new MmapedFileStream(processed_uri, read_ahead, no_atime));
+  } else if (use_io_uring && UringFileStream::IsSupported()) {
+    return std::unique_ptr<FileStream>(new UringFileStream(processed_uri, no_atime));
   } else {
-    return std::unique_ptr<FileStream>(new StdFileStream(processed_uri));
+    return std::unique_ptr<FileStream>(new StdFileStream(processed_uri, no_atime));
+  }
+}
+
+void FileStream::ReadBatch(span<ReadRequest> requests) {
+  std::vector<ReadRequest *> uring_requests;
+  for (auto &req : requests) {
+    if (dynamic_cast<UringFileStream *>(req.stream))
+      uring_requests.push_back(&req);
+    else
+      req.bytes_read = req.stream->ReadAt(req.buffer, req.n_bytes, req.offset);
   }
+  if (!uring_requests.empty())
+    UringFileStream::ReadBatch(make_span(uring_requests));
 }
 
 bool FileStream::ReserveFileMappings(unsigned int num) {
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,11 +16,13 @@
 #define DALI_UTIL_FILE_H_
 
 #include <cstdio>
+#include <functional>
 #include <memory>
 #include <string>
 
 #include "dali/core/api_helper.h"
 #include "dali/core/common.h"
+#include "dali/core/span.h"
 
 namespace dali {
 
@@ -68,10 +70,83 @@ class DLL_PUBLIC FileStream {
    private:
     unsigned int reserved;
   };
-  static std::unique_ptr<FileStream> Open(const std::string &uri, bool read_ahead, bool use_mmap);
+  /**
+   * @brief A single read issued as a part of a batch, see ReadBatch
+   */
+  struct ReadRequest {
+    FileStream *stream = nullptr;
+    uint8_t *buffer = nullptr;
+    size_t n_bytes = 0;
+    int64 offset = 0;
+    /// The number of bytes actually read, set by ReadBatch
+    size_t bytes_read = 0;
+  };
+
+  /**
+   * @brief Opens a file stream
+   *
+   * URIs of the form `<scheme>://...` are opened with the backend registered for the scheme
+   * (see RegisterScheme) - the remaining arguments are then ignored. The `file://` prefix and
+   * the URIs with unregistered schemes denote local files.
+   *
+   * @param use_mmap     map the file in memory; takes precedence over use_io_uring
+   * @param use_io_uring use a stream which services ReadBatch with io_uring, if the system
+   *                     supports it
+   * @param no_atime     don't update the access time of the file, see OpenReadOnly
+   */
+  static std::unique_ptr<FileStream> Open(const std::string &uri, bool read_ahead, bool use_mmap,
+                                          bool use_io_uring = false, bool no_atime = false);
+
+  /**
+   * @brief Opens a local file for reading and returns its descriptor, or -1 with errno set
+   *
+   * With `no_atime`, the file is opened with O_NOATIME, which saves the inode updates (and,
+   * on network file systems, the round trips) caused by reading. The flag is dropped for
+   * the files that the process doesn't own, for which it's not permitted.
+   */
+  static int OpenReadOnly(const std::string &path, bool no_atime);
+
+  using StreamFactory = std::function<std::unique_ptr<FileStream>(const std::string &uri)>;
+
+  /**
+   * @brief Registers a backend which opens the URIs of the form `<scheme>://...`
+   *
+   * This way, the readers can access data outside of the local file system, e.g. objects in
+   * an object storage (see RangeFileStream). Registering an empty factory removes the backend.
+   */
+  static void RegisterScheme(const std::string &scheme, StreamFactory factory);
+
+  /**
+   * @brief Reads multiple ranges, possibly from different streams, at once
+   *
+   * The positions of the streams are not affected. The requests directed to streams supporting
+   * batched I/O are submitted together and completed asynchronously by the OS, the remaining ones
+   * are serviced one by one with ReadAt.
+   */
+  static void ReadBatch(span<ReadRequest> requests);
 
   virtual void Close() = 0;
   virtual size_t Read(uint8_t *buffer, size_t n_bytes) = 0;
+
+  /**
+   * @brief Reads `n_bytes` starting at `offset`, without affecting the current position
+   */
+  virtual size_t ReadAt(uint8_t *buffer, size_t n_bytes, int64 offset) {
+    int64 pos = Tell();
+    Seek(offset);
+    size_t ret = Read(buffer, n_bytes);
+    Seek(pos);
+    return ret;
+  }
+
+  /**
+   * @brief Hints that the file is read sequentially, so the stream can read up to `n_bytes`
+   *        ahead of the current position.
+   *
+   * It must be called before the stream is used. The default implementation does nothing.
+   */
+  virtual void SetReadAhead(size_t n_bytes) {}
+
   virtual shared_ptr<void> Get(size_t n_bytes) = 0;
   virtual void Seek(int64 pos) = 0;
   virtual int64 Tell() const = 0;
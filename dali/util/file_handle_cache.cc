@@ -0,0 +1,167 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/util/file_handle_cache.h"
+#include <utility>
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+namespace {
+
+void CloseAll(std::vector<std::unique_ptr<FileStream>> &streams) {
+  for (auto &stream : streams)
+    stream->Close();
+  streams.clear();
+}
+
+}  // namespace
+
+FileHandleCache::FileHandleCache(int capacity, int num_threads)
+: capacity_(capacity), num_threads_(num_threads) {
+  DALI_ENFORCE(capacity_ > 0, make_string("The capacity must be positive, got ", capacity_, "."));
+  DALI_ENFORCE(num_threads_ > 0,
+               make_string("The number of threads must be positive, got ", num_threads_, "."));
+}
+
+FileHandleCache::~FileHandleCache() {
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto &t : threads_)
+    t.join();
+  for (auto &entry : entries_) {
+    if (entry.second.stream)
+      entry.second.stream->Close();
+  }
+}
+
+std::unique_ptr<FileStream> FileHandleCache::Open(const std::string &uri, const Opener &open) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = entries_.find(uri);
+  while (it != entries_.end() && it->second.pending) {
+    opened_cv_.wait(lock);
+    it = entries_.find(uri);
+  }
+  if (it == entries_.end()) {
+    stats_.misses++;
+    lock.unlock();
+    return open();
+  }
+  stats_.hits++;
+  auto stream = std::move(it->second.stream);
+  lru_.erase(it->second.lru_pos);
+  entries_.erase(it);
+  lock.unlock();
+  stream->Seek(0);
+  return stream;
+}
+
+void FileHandleCache::Release(const std::string &uri, std::unique_ptr<FileStream> stream) {
+  std::vector<std::unique_ptr<FileStream>> to_close;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    if (entries_.count(uri)) {
+      // the file was opened more than once - one stream is enough
+      to_close.push_back(std::move(stream));
+    } else {
+      InsertLocked(uri, std::move(stream), false);
+      to_close = EvictLocked();
+    }
+  }
+  CloseAll(to_close);
+}
+
+void FileHandleCache::Prefetch(const std::string &uri, Opener open) {
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    // the pending streams are not evicted, so there can't be more of them than fit in the cache
+    if (entries_.count(uri) || num_pending_ >= capacity_)
+      return;
+    entries_[uri].pending = true;
+    num_pending_++;
+    work_.emplace_back(uri, std::move(open));
+    if (threads_.empty()) {
+      for (int i = 0; i < num_threads_; i++)
+        threads_.emplace_back(&FileHandleCache::WorkerLoop, this);
+    }
+  }
+  work_cv_.notify_one();
+}
+
+FileHandleCache::Stats FileHandleCache::GetStats() const {
+  std::lock_guard<std::mutex> g(mutex_);
+  return stats_;
+}
+
+void FileHandleCache::InsertLocked(const std::string &uri, std::unique_ptr<FileStream> stream,
+                                   bool prefetched) {
+  auto &entry = entries_[uri];
+  entry.stream = std::move(stream);
+  entry.pending = false;
+  entry.prefetched = prefetched;
+  entry.lru_pos = lru_.insert(lru_.end(), uri);
+}
+
+std::vector<std::unique_ptr<FileStream>> FileHandleCache::EvictLocked() {
+  std::vector<std::unique_ptr<FileStream>> evicted;
+  while (static_cast<int>(lru_.size()) + num_pending_ > capacity_ && !lru_.empty()) {
+    auto it = entries_.find(lru_.front());
+    if (it->second.prefetched)
+      stats_.wasted_prefetches++;
+    evicted.push_back(std::move(it->second.stream));
+    entries_.erase(it);
+    lru_.pop_front();
+  }
+  return evicted;
+}
+
+void FileHandleCache::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    work_cv_.wait(lock, [&]() { return stop_ || !work_.empty(); });
+    if (stop_)
+      return;
+    auto work = std::move(work_.front());
+    work_.pop_front();
+    lock.unlock();
+
+    std::unique_ptr<FileStream> stream;
+    try {
+      stream = work.second();
+    } catch (const std::exception &) {
+      // Open reports the error, when it opens the file again
+    }
+
+    std::vector<std::unique_ptr<FileStream>> to_close;
+    lock.lock();
+    num_pending_--;
+    if (stream) {
+      InsertLocked(work.first, std::move(stream), true);
+      to_close = EvictLocked();
+    } else {
+      entries_.erase(work.first);
+    }
+    opened_cv_.notify_all();
+    if (!to_close.empty()) {
+      lock.unlock();
+      CloseAll(to_close);
+      lock.lock();
+    }
+  }
+}
+
+}  // namespace dali
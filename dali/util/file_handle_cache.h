@@ -0,0 +1,134 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_UTIL_FILE_HANDLE_CACHE_H_
+#define DALI_UTIL_FILE_HANDLE_CACHE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dali/core/api_helper.h"
+#include "dali/core/common.h"
+#include "dali/util/file.h"
+
+namespace dali {
+
+/**
+ * @brief Keeps the streams of the recently used files open, so that reading a file again doesn't
+ *        pay for the metadata round trips of opening and closing it.
+ *
+ * Meant for the readers accessing a file per sample on network file systems (NFS, Lustre), where
+ * open and close can cost more than reading a small file. The streams are taken from the cache
+ * with Open and put back with Release; when there are more than `capacity` of them, the least
+ * recently released ones are closed.
+ *
+ * The files can also be opened ahead of need with Prefetch, by the threads of the cache, so that
+ * the opening overlaps with reading the preceding files.
+ *
+ * The files are identified by their URIs; an open stream keeps referring to the file it was
+ * opened for, even if the path is replaced in the meantime. The methods can be called
+ * concurrently.
+ */
+class DLL_PUBLIC FileHandleCache {
+ public:
+  struct Stats {
+    int64 hits = 0;
+    int64 misses = 0;
+    /// The number of prefetched streams which were closed before they were used
+    int64 wasted_prefetches = 0;
+  };
+
+  using Opener = std::function<std::unique_ptr<FileStream>()>;
+
+  /**
+   * @param capacity    the maximum number of streams kept open
+   * @param num_threads the number of threads which open the prefetched files
+   */
+  explicit FileHandleCache(int capacity, int num_threads = 1);
+
+  ~FileHandleCache();
+
+  /**
+   * @brief Returns an open stream for the file, positioned at its beginning
+   *
+   * The stream is taken from the cache, if it's there, or opened with `open`. If the file is
+   * being opened by Prefetch, the call waits for it.
+   */
+  std::unique_ptr<FileStream> Open(const std::string &uri, const Opener &open);
+
+  /**
+   * @brief Puts the stream, obtained with Open, back in the cache
+   */
+  void Release(const std::string &uri, std::unique_ptr<FileStream> stream);
+
+  /**
+   * @brief Starts opening the file in the background, unless it's already in the cache
+   *
+   * The errors are ignored - they are reported when the file is opened with Open.
+   */
+  void Prefetch(const std::string &uri, Opener open);
+
+  Stats GetStats() const;
+
+  int capacity() const {
+    return capacity_;
+  }
+
+ private:
+  struct Entry {
+    std::unique_ptr<FileStream> stream;
+    /// Whether the file is being opened by Prefetch
+    bool pending = false;
+    /// Whether the stream was opened by Prefetch and not used yet
+    bool prefetched = false;
+    std::list<std::string>::iterator lru_pos;
+  };
+
+  void InsertLocked(const std::string &uri, std::unique_ptr<FileStream> stream, bool prefetched);
+
+  /**
+   * @brief Removes the least recently used streams over the capacity
+   *
+   * @return The removed streams, to be closed without holding the lock
+   */
+  std::vector<std::unique_ptr<FileStream>> EvictLocked();
+
+  void WorkerLoop();
+
+  int capacity_;
+  int num_threads_;
+  mutable std::mutex mutex_;
+  std::condition_variable opened_cv_, work_cv_;
+  std::unordered_map<std::string, Entry> entries_;
+  /// The URIs of the ready streams, the least recently used first
+  std::list<std::string> lru_;
+  int num_pending_ = 0;
+  std::deque<std::pair<std::string, Opener>> work_;
+  std::vector<std::thread> threads_;
+  bool stop_ = false;
+  Stats stats_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_UTIL_FILE_HANDLE_CACHE_H_
@@ -0,0 +1,119 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/util/file_handle_cache.h"  // NOLINT
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "dali/test/temp_files_test.h"
+
+namespace dali {
+namespace test {
+
+class FileHandleCacheTest : public TempFilesTest {
+ protected:
+  FileHandleCache::Opener Opener(const std::string &path) {
+    return [this, path]() {
+      opened_++;
+      return FileStream::Open(path, false, false, false, true);
+    };
+  }
+
+  std::string ReadAll(FileHandleCache &cache, const std::string &path) {
+    auto stream = cache.Open(path, Opener(path));
+    std::string data(stream->Size(), '\0');
+    EXPECT_EQ(stream->Read(reinterpret_cast<uint8_t *>(&data[0]), data.size()), data.size());
+    cache.Release(path, std::move(stream));
+    return data;
+  }
+
+  std::atomic<int> opened_{0};
+};
+
+TEST_F(FileHandleCacheTest, ReusesOpenFiles) {
+  FileHandleCache cache(2);
+  std::vector<std::string> files = { MakeFile("a", 100), MakeFile("b", 200) };
+  for (int epoch = 0; epoch < 3; epoch++) {
+    for (auto &file : files)
+      EXPECT_EQ(ReadAll(cache, file), Expected(file));
+  }
+  EXPECT_EQ(opened_, 2);
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.hits, 4);
+}
+
+TEST_F(FileHandleCacheTest, ClosesLeastRecentlyUsed) {
+  FileHandleCache cache(2);
+  auto a = MakeFile("a", 10), b = MakeFile("b", 20), c = MakeFile("c", 30);
+  ReadAll(cache, a);
+  ReadAll(cache, b);
+  ReadAll(cache, a);
+  ReadAll(cache, c);  // b is closed
+  EXPECT_EQ(opened_, 3);
+  ReadAll(cache, a);
+  EXPECT_EQ(opened_, 3);
+  EXPECT_EQ(ReadAll(cache, b), Expected(b));
+  EXPECT_EQ(opened_, 4);
+}
+
+TEST_F(FileHandleCacheTest, Prefetch) {
+  FileHandleCache cache(8, 2);
+  std::vector<std::string> files;
+  for (char name = 'a'; name < 'a' + 6; name++)
+    files.push_back(MakeFile(std::string(1, name), 10 + name));
+  for (auto &file : files)
+    cache.Prefetch(file, Opener(file));
+  // already scheduled
+  cache.Prefetch(files[0], Opener(files[0]));
+  for (auto &file : files)
+    EXPECT_EQ(ReadAll(cache, file), Expected(file));
+  EXPECT_EQ(opened_, 6);
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.misses, 0);
+  EXPECT_EQ(stats.hits, 6);
+  EXPECT_EQ(stats.wasted_prefetches, 0);
+
+  // a failed prefetch is reported when the file is opened
+  std::string missing = root_ + "/missing";
+  cache.Prefetch(missing, Opener(missing));
+  EXPECT_THROW(cache.Open(missing, Opener(missing)), std::exception);
+}
+
+TEST_F(FileHandleCacheTest, Concurrent) {
+  FileHandleCache cache(3, 2);
+  std::vector<std::string> files, expected;
+  for (char name = 'a'; name < 'a' + 5; name++) {
+    files.push_back(MakeFile(std::string(1, name), 100 + name));
+    expected.push_back(Expected(files.back()));
+  }
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 100; i++) {
+        int idx = (i * 3 + t) % files.size();
+        cache.Prefetch(files[(idx + 1) % files.size()], Opener(files[(idx + 1) % files.size()]));
+        EXPECT_EQ(ReadAll(cache, files[idx]), expected[idx]);
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+}
+
+}  // namespace test
+}  // namespace dali
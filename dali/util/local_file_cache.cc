@@ -0,0 +1,241 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+#include "dali/util/local_file_cache.h"
+
+namespace dali {
+
+namespace {
+
+constexpr char kSuffix[] = ".cached";
+constexpr size_t kCopyChunkSize = 4 << 20;
+
+/**
+ * @brief The name of the cached copy - 64-bit FNV-1a of the URI, which must not change between
+ *        runs and builds
+ */
+std::string cached_name(const std::string &uri) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (unsigned char c : uri) {
+    h ^= c;
+    h *= 0x100000001b3ull;
+  }
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx%s",
+           static_cast<unsigned long long>(h), kSuffix);  // NOLINT(runtime/int)
+  return name;
+}
+
+bool is_cached_name(const char *name) {
+  size_t len = strlen(name), suffix_len = sizeof(kSuffix) - 1;
+  return len > suffix_len && strcmp(name + len - suffix_len, kSuffix) == 0;
+}
+
+}  // namespace
+
+LocalFileCache::LocalFileCache(const std::string &dir, int64 capacity)
+: dir_(dir), capacity_(capacity) {
+  DALI_ENFORCE(!dir_.empty(), "The cache directory must not be empty.");
+  DALI_ENFORCE(capacity_ >= 0, make_string("Invalid cache capacity: ", capacity_));
+  if (mkdir(dir_.c_str(), 0755) != 0 && errno != EEXIST)
+    DALI_FAIL(make_string("Cannot create the cache directory ", dir_, ": ", strerror(errno)));
+  DIR *d = opendir(dir_.c_str());
+  DALI_ENFORCE(d != nullptr, make_string("Cannot open the cache directory ", dir_, ": ",
+                                         strerror(errno)));
+  // reuse the files cached earlier, the least recently modified are evicted first
+  std::vector<std::tuple<int64, int64, std::string, int64>> found;
+  while (struct dirent *entry = readdir(d)) {
+    struct stat s;
+    if (!is_cached_name(entry->d_name) ||
+        stat((dir_ + "/" + entry->d_name).c_str(), &s) != 0 || !S_ISREG(s.st_mode))
+      continue;
+    found.emplace_back(s.st_mtim.tv_sec, s.st_mtim.tv_nsec, entry->d_name, s.st_size);
+  }
+  closedir(d);
+  std::sort(found.begin(), found.end());
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto &f : found)
+    Adopt(std::get<2>(f), std::get<3>(f));
+}
+
+std::shared_ptr<LocalFileCache> LocalFileCache::Get(const std::string &dir, int64 capacity) {
+  static std::mutex registry_mutex;
+  static std::unordered_map<std::string, std::shared_ptr<LocalFileCache>> registry;
+  std::lock_guard<std::mutex> registry_guard(registry_mutex);
+  auto &cache = registry[dir];
+  if (!cache) {
+    cache = std::make_shared<LocalFileCache>(dir, capacity);
+  } else {
+    std::lock_guard<std::mutex> guard(cache->mutex_);
+    if (cache->capacity_ > 0 && (capacity == 0 || capacity > cache->capacity_))
+      cache->capacity_ = capacity;
+  }
+  return cache;
+}
+
+LocalFileCache::Stats LocalFileCache::GetStats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+void LocalFileCache::Reserve(int64 size) {
+  while (capacity_ > 0 && stats_.size + size > capacity_ && !lru_.empty()) {
+    auto it = entries_.find(lru_.front());
+    // the file may still be open - it's removed from the disk when closed
+    remove((dir_ + "/" + it->first).c_str());
+    stats_.size -= it->second.size;
+    stats_.evictions++;
+    entries_.erase(it);
+    lru_.pop_front();
+  }
+}
+
+void LocalFileCache::Adopt(const std::string &name, int64 size) {
+  Reserve(size);
+  lru_.push_back(name);
+  entries_[name] = { size, std::prev(lru_.end()) };
+  stats_.size += size;
+}
+
+void LocalFileCache::Drop(const std::string &name) {
+  auto it = entries_.find(name);
+  if (it == entries_.end())
+    return;
+  stats_.size -= it->second.size;
+  lru_.erase(it->second.lru_pos);
+  entries_.erase(it);
+}
+
+bool LocalFileCache::Lookup(const std::string &name, std::string &path) {
+  path = dir_ + "/" + name;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = entries_.find(name);
+    if (it != entries_.end()) {
+      lru_.splice(lru_.end(), lru_, it->second.lru_pos);
+    } else {
+      // it may have been cached by another process sharing the directory
+      struct stat s;
+      if (stat(path.c_str(), &s) != 0 || !S_ISREG(s.st_mode))
+        return false;
+      Adopt(name, s.st_size);
+    }
+    stats_.hits++;
+  }
+  // keep the order of use for the following runs
+  utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+  return true;
+}
+
+bool LocalFileCache::Fetch(const std::string &uri, const std::string &name) {
+  auto source = FileStream::Open(uri, false, false);
+  int64 size = source->Size();
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (capacity_ > 0 && size > capacity_)
+      return false;
+    // reserve the space up front, so that concurrent fetches don't exceed the capacity
+    Reserve(size);
+    stats_.size += size;
+  }
+  auto unreserve = [&]() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stats_.size -= size;
+  };
+
+  // Several threads or processes may fetch the same file - each writes its own copy and
+  // atomically replaces the cached file with it.
+  static std::atomic<uint64_t> tmp_counter{0};
+  std::string path = dir_ + "/" + name;
+  std::string tmp_path = make_string(path, ".tmp.", getpid(), ".", tmp_counter++);
+  FILE *f = fopen(tmp_path.c_str(), "wb");
+  bool ok = f != nullptr;
+  if (ok) {
+    std::vector<uint8_t> buffer(std::min<size_t>(size, kCopyChunkSize));
+    try {
+      for (int64 copied = 0; ok && copied < size; ) {
+        size_t n = source->Read(buffer.data(), std::min<int64>(buffer.size(), size - copied));
+        DALI_ENFORCE(n > 0, make_string("Unexpected end of file: ", uri));
+        ok = fwrite(buffer.data(), 1, n, f) == n;
+        copied += n;
+      }
+    } catch (...) {
+      fclose(f);
+      remove(tmp_path.c_str());
+      unreserve();
+      throw;
+    }
+    ok = (fclose(f) == 0) && ok;
+    ok = ok && rename(tmp_path.c_str(), path.c_str()) == 0;
+  }
+  if (!ok) {
+    DALI_WARN("Cannot write ", tmp_path, " to the file cache: ", strerror(errno));
+    remove(tmp_path.c_str());
+    unreserve();
+    return false;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  stats_.bytes_fetched += size;
+  // fetched concurrently - the reservation replaces the previous entry
+  Drop(name);
+  lru_.push_back(name);
+  entries_[name] = { size, std::prev(lru_.end()) };
+  return true;
+}
+
+std::unique_ptr<FileStream> LocalFileCache::Open(const std::string &uri, bool read_ahead,
+                                                 bool use_mmap) {
+  std::string name = cached_name(uri), path;
+  if (Lookup(name, path)) {
+    try {
+      return FileStream::Open(path, read_ahead, use_mmap);
+    } catch (std::exception &) {
+      // evicted by another process in the meantime
+      std::lock_guard<std::mutex> guard(mutex_);
+      Drop(name);
+      stats_.hits--;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stats_.misses++;
+  }
+  if (Fetch(uri, name)) {
+    try {
+      return FileStream::Open(path, read_ahead, use_mmap);
+    } catch (std::exception &) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      Drop(name);
+    }
+  }
+  return FileStream::Open(uri, read_ahead, use_mmap);
+}
+
+}  // namespace dali
@@ -0,0 +1,118 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_UTIL_LOCAL_FILE_CACHE_H_
+#define DALI_UTIL_LOCAL_FILE_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "dali/core/api_helper.h"
+#include "dali/core/common.h"
+#include "dali/util/file.h"
+
+namespace dali {
+
+/**
+ * @brief Keeps copies of the files read from a (remote or slow) storage in a local directory,
+ *        e.g. on a local NVMe drive, so that subsequent epochs are served from there.
+ *
+ * The files are copied whole on the first access and evicted in the least-recently-used order
+ * when the total size of the cached files exceeds the capacity. The cached files are identified
+ * by their URIs only - the dataset is assumed not to change while it's cached.
+ *
+ * The files found in the directory when the cache is created (e.g. left by a previous run or
+ * another process sharing the directory) are reused; the capacity is only enforced for the files
+ * known to this process.
+ *
+ * The methods can be called concurrently.
+ */
+class DLL_PUBLIC LocalFileCache {
+ public:
+  struct Stats {
+    int64 hits = 0;
+    int64 misses = 0;
+    /// The number of bytes copied from the original storage to the cache
+    int64 bytes_fetched = 0;
+    int64 evictions = 0;
+    /// The total size of the cached files
+    int64 size = 0;
+  };
+
+  /**
+   * @brief Creates a cache backed by `dir`
+   *
+   * @param capacity  the maximum total size of the cached files, in bytes; 0 means no limit
+   */
+  LocalFileCache(const std::string &dir, int64 capacity);
+
+  /**
+   * @brief Returns the cache backed by the given directory, shared by all the users in
+   *        the process; creates it, if it doesn't exist yet.
+   *
+   * When the cache already exists, its capacity is raised to `capacity`, if needed.
+   */
+  static std::shared_ptr<LocalFileCache> Get(const std::string &dir, int64 capacity = 0);
+
+  /**
+   * @brief Opens the cached copy of the file, fetching it first if it's not cached yet.
+   *
+   * The arguments have the same meaning as in FileStream::Open. If the file cannot be cached
+   * (it's larger than the capacity or the copy cannot be written), the original is opened.
+   */
+  std::unique_ptr<FileStream> Open(const std::string &uri, bool read_ahead, bool use_mmap);
+
+  Stats GetStats() const;
+
+  const std::string &dir() const {
+    return dir_;
+  }
+
+ private:
+  struct Entry {
+    int64 size;
+    std::list<std::string>::iterator lru_pos;
+  };
+
+  /// Returns the path of the cached copy of the file, if it's cached
+  bool Lookup(const std::string &name, std::string &path);
+
+  /**
+   * @brief Copies the file to the cache
+   *
+   * @return false, if the file cannot be cached; errors reading the original are thrown
+   */
+  bool Fetch(const std::string &uri, const std::string &name);
+
+  /// Makes room for `size` bytes, evicting the least recently used files; the lock must be held
+  void Reserve(int64 size);
+  /// Adds a file found in the directory; the lock must be held
+  void Adopt(const std::string &name, int64 size);
+  /// Forgets a file which turned out not to be there anymore; the lock must be held
+  void Drop(const std::string &name);
+
+  std::string dir_;
+  int64 capacity_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  std::list<std::string> lru_;  // the least recently used first
+  Stats stats_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_UTIL_LOCAL_FILE_CACHE_H_
@@ -0,0 +1,107 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/util/local_file_cache.h"  // NOLINT
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "dali/test/temp_files_test.h"
+
+namespace dali {
+namespace test {
+
+class LocalFileCacheTest : public TempFilesTest {
+ protected:
+  void SetUp() override {
+    TempFilesTest::SetUp();
+    cache_dir_ = root_ + "/cache";
+  }
+
+  std::string ReadAll(LocalFileCache &cache, const std::string &path) {
+    auto stream = cache.Open(path, false, false);
+    std::string data(stream->Size(), '\0');
+    EXPECT_EQ(stream->Read(reinterpret_cast<uint8_t *>(&data[0]), data.size()), data.size());
+    return data;
+  }
+
+  std::string cache_dir_;
+};
+
+TEST_F(LocalFileCacheTest, HitsAndMisses) {
+  LocalFileCache cache(cache_dir_, 0);
+  std::vector<std::string> files = { MakeFile("a", 100), MakeFile("b", 200), MakeFile("c", 0) };
+  for (int epoch = 0; epoch < 2; epoch++) {
+    for (auto &file : files)
+      EXPECT_EQ(ReadAll(cache, file), Expected(file));
+  }
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.misses, 3);
+  EXPECT_EQ(stats.hits, 3);
+  EXPECT_EQ(stats.bytes_fetched, 300);
+  EXPECT_EQ(stats.size, 300);
+  EXPECT_EQ(stats.evictions, 0);
+
+  // the copies are used - the originals are not needed anymore
+  std::string expected = Expected(files[0]);
+  remove(files[0].c_str());
+  EXPECT_EQ(ReadAll(cache, files[0]), expected);
+
+  // a new cache over the same directory reuses the copies
+  LocalFileCache cache2(cache_dir_, 0);
+  EXPECT_EQ(ReadAll(cache2, files[0]), expected);
+  EXPECT_EQ(cache2.GetStats().hits, 1);
+  EXPECT_EQ(cache2.GetStats().misses, 0);
+  EXPECT_EQ(cache2.GetStats().size, 300);
+}
+
+TEST_F(LocalFileCacheTest, Eviction) {
+  LocalFileCache cache(cache_dir_, 250);
+  auto a = MakeFile("a", 100), b = MakeFile("b", 100), c = MakeFile("c", 100);
+  ReadAll(cache, a);
+  ReadAll(cache, b);
+  ReadAll(cache, a);  // b is now the least recently used
+  ReadAll(cache, c);
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_EQ(stats.size, 200);
+  EXPECT_EQ(stats.misses, 3);
+
+  ReadAll(cache, a);
+  ReadAll(cache, c);
+  EXPECT_EQ(cache.GetStats().hits, 3);
+  EXPECT_EQ(ReadAll(cache, b), Expected(b));
+  EXPECT_EQ(cache.GetStats().misses, 4);
+  EXPECT_EQ(cache.GetStats().evictions, 2);
+}
+
+TEST_F(LocalFileCacheTest, TooLarge) {
+  LocalFileCache cache(cache_dir_, 100);
+  auto big = MakeFile("big", 1000);
+  for (int i = 0; i < 2; i++)
+    EXPECT_EQ(ReadAll(cache, big), Expected(big));
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.bytes_fetched, 0);
+  EXPECT_EQ(stats.size, 0);
+}
+
+TEST_F(LocalFileCacheTest, Shared) {
+  auto cache = LocalFileCache::Get(cache_dir_, 100);
+  EXPECT_EQ(LocalFileCache::Get(cache_dir_), cache);
+  EXPECT_NE(LocalFileCache::Get(root_ + "/other"), cache);
+}
+
+}  // namespace test
+}  // namespace dali
@@ -0,0 +1,152 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "dali/core/error_handling.h"
+#include "dali/util/memory_file_cache.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief A read-only stream over a buffer kept alive by the cache and by the pointers
+ *        returned from Get
+ */
+class MemoryFileStream : public FileStream {
+ public:
+  MemoryFileStream(const std::string &path, std::shared_ptr<uint8_t> data, size_t size)
+  : FileStream(path), data_(std::move(data)), size_(size) {}
+
+  void Close() override {
+    data_.reset();
+    size_ = 0;
+    pos_ = 0;
+  }
+
+  size_t Read(uint8_t *buffer, size_t n_bytes) override {
+    n_bytes = std::min(n_bytes, size_ - pos_);
+    memcpy(buffer, data_.get() + pos_, n_bytes);
+    pos_ += n_bytes;
+    return n_bytes;
+  }
+
+  size_t ReadAt(uint8_t *buffer, size_t n_bytes, int64 offset) override {
+    if (offset < 0 || static_cast<size_t>(offset) >= size_)
+      return 0;
+    n_bytes = std::min<size_t>(n_bytes, size_ - offset);
+    memcpy(buffer, data_.get() + offset, n_bytes);
+    return n_bytes;
+  }
+
+  shared_ptr<void> Get(size_t n_bytes) override {
+    if (pos_ + n_bytes > size_)
+      return nullptr;
+    // aliasing constructor - shares the ownership of the whole buffer
+    shared_ptr<void> p(data_, data_.get() + pos_);
+    pos_ += n_bytes;
+    return p;
+  }
+
+  void Seek(int64 pos) override {
+    DALI_ENFORCE(pos >= 0 && static_cast<size_t>(pos) <= size_,
+                 make_string("Invalid seek to ", pos, " in ", path_));
+    pos_ = pos;
+  }
+
+  int64 Tell() const override {
+    return pos_;
+  }
+
+  size_t Size() const override {
+    return size_;
+  }
+
+ private:
+  std::shared_ptr<uint8_t> data_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+}  // namespace
+
+MemoryFileCache::MemoryFileCache(int64 capacity) : capacity_(capacity) {
+  DALI_ENFORCE(capacity_ > 0, make_string("Invalid cache capacity: ", capacity_));
+}
+
+MemoryFileCache::Stats MemoryFileCache::GetStats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+std::shared_ptr<uint8_t> MemoryFileCache::ReadAll(FileStream &stream, const std::string &uri,
+                                                  int64 size) {
+  std::shared_ptr<uint8_t> data(new uint8_t[std::max<int64>(size, 1)],
+                                std::default_delete<uint8_t[]>());
+  for (int64 offset = 0; offset < size; ) {
+    size_t n = stream.Read(data.get() + offset, size - offset);
+    DALI_ENFORCE(n > 0, make_string("Unexpected end of file: ", uri));
+    offset += n;
+  }
+  return data;
+}
+
+std::unique_ptr<FileStream> MemoryFileCache::Open(const std::string &uri, const Opener &open) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = entries_.find(uri);
+    if (it != entries_.end()) {
+      stats_.hits++;
+      return std::make_unique<MemoryFileStream>(uri, it->second.data, it->second.size);
+    }
+    stats_.misses++;
+  }
+
+  auto stream = open();
+  int64 size = stream->Size();
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (stats_.size + size > capacity_) {
+      stats_.rejected++;
+      return stream;
+    }
+    // reserve the space up front, so that concurrent reads don't exceed the capacity
+    stats_.size += size;
+  }
+
+  std::shared_ptr<uint8_t> data;
+  try {
+    data = ReadAll(*stream, uri, size);
+  } catch (...) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stats_.size -= size;
+    throw;
+  }
+  stream->Close();
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto inserted = entries_.emplace(uri, Entry{ data, size });
+  if (!inserted.second) {
+    // read concurrently by another thread - keep the first copy
+    stats_.size -= size;
+    data = inserted.first->second.data;
+  }
+  return std::make_unique<MemoryFileStream>(uri, std::move(data), size);
+}
+
+}  // namespace dali
@@ -0,0 +1,92 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_UTIL_MEMORY_FILE_CACHE_H_
+#define DALI_UTIL_MEMORY_FILE_CACHE_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "dali/core/api_helper.h"
+#include "dali/core/common.h"
+#include "dali/util/file.h"
+
+namespace dali {
+
+/**
+ * @brief Keeps the contents of the files read by a reader in host memory, so that the following
+ *        epochs don't access the storage at all.
+ *
+ * The files are read whole on the first access and added until their total size reaches
+ * the capacity; they are never evicted. With a shuffled dataset that doesn't fit, evicting
+ * would only replace one random part of it with another, while a fixed part is a steady hit rate.
+ * The cached files are identified by their URIs only - the dataset is assumed not to change while
+ * it's cached.
+ *
+ * The streams returned for the cached files share the memory of the cache, so the data obtained
+ * with FileStream::Get is not copied. The methods can be called concurrently.
+ */
+class DLL_PUBLIC MemoryFileCache {
+ public:
+  struct Stats {
+    int64 hits = 0;
+    int64 misses = 0;
+    /// The number of files which didn't fit in the cache
+    int64 rejected = 0;
+    /// The total size of the cached files
+    int64 size = 0;
+  };
+
+  using Opener = std::function<std::unique_ptr<FileStream>()>;
+
+  /**
+   * @param capacity the maximum total size of the cached files, in bytes
+   */
+  explicit MemoryFileCache(int64 capacity);
+
+  /**
+   * @brief Returns a stream over the cached contents of the file
+   *
+   * If the file is not cached, it's opened with `open` and read into the cache, if it fits.
+   * Otherwise, the stream returned by `open` is passed through.
+   */
+  std::unique_ptr<FileStream> Open(const std::string &uri, const Opener &open);
+
+  Stats GetStats() const;
+
+  int64 capacity() const {
+    return capacity_;
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<uint8_t> data;
+    int64 size;
+  };
+
+  /// Reads the whole file; the space for it must have been reserved
+  std::shared_ptr<uint8_t> ReadAll(FileStream &stream, const std::string &uri, int64 size);
+
+  int64 capacity_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  Stats stats_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_UTIL_MEMORY_FILE_CACHE_H_
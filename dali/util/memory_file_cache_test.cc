@@ -0,0 +1,125 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/util/memory_file_cache.h"  // NOLINT
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "dali/test/temp_files_test.h"
+
+namespace dali {
+namespace test {
+
+class MemoryFileCacheTest : public TempFilesTest {
+ protected:
+  std::string ReadAll(MemoryFileCache &cache, const std::string &path) {
+    auto stream = cache.Open(path, [&]() { return FileStream::Open(path, false, false); });
+    std::string data(stream->Size(), '\0');
+    EXPECT_EQ(stream->Read(reinterpret_cast<uint8_t *>(&data[0]), data.size()), data.size());
+    return data;
+  }
+};
+
+TEST_F(MemoryFileCacheTest, HitsAndMisses) {
+  MemoryFileCache cache(1000);
+  std::vector<std::string> files = { MakeFile("a", 100), MakeFile("b", 200), MakeFile("c", 0) };
+  std::vector<std::string> expected;
+  for (auto &file : files)
+    expected.push_back(Expected(file));
+  for (int epoch = 0; epoch < 2; epoch++) {
+    for (size_t i = 0; i < files.size(); i++)
+      EXPECT_EQ(ReadAll(cache, files[i]), expected[i]);
+  }
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.misses, 3);
+  EXPECT_EQ(stats.hits, 3);
+  EXPECT_EQ(stats.rejected, 0);
+  EXPECT_EQ(stats.size, 300);
+
+  // the storage is not accessed anymore
+  remove(files[0].c_str());
+  int opened = 0;
+  auto stream = cache.Open(files[0], [&]() {
+    opened++;
+    return FileStream::Open(files[0], false, false);
+  });
+  EXPECT_EQ(opened, 0);
+  auto p = stream->Get(stream->Size());
+  ASSERT_NE(p, nullptr);
+  stream->Close();
+  stream.reset();
+  // the data obtained with Get outlives the stream
+  EXPECT_EQ(std::string(static_cast<const char *>(p.get()), 100), expected[0]);
+}
+
+TEST_F(MemoryFileCacheTest, Capacity) {
+  MemoryFileCache cache(250);
+  auto a = MakeFile("a", 100), b = MakeFile("b", 100), c = MakeFile("c", 100);
+  for (int epoch = 0; epoch < 2; epoch++) {
+    EXPECT_EQ(ReadAll(cache, a), Expected(a));
+    EXPECT_EQ(ReadAll(cache, b), Expected(b));
+    EXPECT_EQ(ReadAll(cache, c), Expected(c));
+  }
+  auto stats = cache.GetStats();
+  // the files are never evicted - c doesn't fit and is read from the storage each time
+  EXPECT_EQ(stats.size, 200);
+  EXPECT_EQ(stats.hits, 2);
+  EXPECT_EQ(stats.misses, 4);
+  EXPECT_EQ(stats.rejected, 2);
+}
+
+TEST_F(MemoryFileCacheTest, SeekAndReadAt) {
+  MemoryFileCache cache(1000);
+  auto a = MakeFile("a", 100);
+  std::string expected = Expected(a);
+  ReadAll(cache, a);
+  auto stream = cache.Open(a, [&]() { return FileStream::Open(a, false, false); });
+  char buf[10];
+  stream->Seek(50);
+  EXPECT_EQ(stream->Tell(), 50);
+  EXPECT_EQ(stream->Read(reinterpret_cast<uint8_t *>(buf), 10), 10u);
+  EXPECT_EQ(std::string(buf, 10), expected.substr(50, 10));
+  EXPECT_EQ(stream->ReadAt(reinterpret_cast<uint8_t *>(buf), 10, 95), 5u);
+  EXPECT_EQ(std::string(buf, 5), expected.substr(95, 5));
+  EXPECT_EQ(stream->Tell(), 60);
+  EXPECT_EQ(stream->Get(50), nullptr);
+  EXPECT_NE(stream->Get(40), nullptr);
+  EXPECT_EQ(stream->Tell(), 100);
+}
+
+TEST_F(MemoryFileCacheTest, Concurrent) {
+  MemoryFileCache cache(350);
+  std::vector<std::string> files;
+  for (char name = 'a'; name < 'e'; name++)
+    files.push_back(MakeFile(std::string(1, name), 100));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 20; i++) {
+        auto &file = files[(t + i) % files.size()];
+        EXPECT_EQ(ReadAll(cache, file), Expected(file));
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  auto stats = cache.GetStats();
+  EXPECT_LE(stats.size, 350);
+  EXPECT_EQ(stats.hits + stats.misses, 80);
+}
+
+}  // namespace test
+}  // namespace dali
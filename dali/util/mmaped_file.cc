@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -74,7 +74,7 @@ static int get_max_vm_cnt() {
   return vm_cnt;
 }
 
-static void *file_map(const char *path, size_t *length, bool read_ahead) {
+static void *file_map(const char *path, size_t *length, bool read_ahead, bool no_atime) {
   int fd = -1;
   struct stat s;
   void *p = nullptr;
@@ -85,7 +85,7 @@ static void *file_map(const char *path, size_t *length, bool read_ahead) {
 #endif
   }
 
-  if ((fd = open(path, O_RDONLY)) < 0) {
+  if ((fd = dali::FileStream::OpenReadOnly(path, no_atime)) < 0) {
     goto fail;
   }
 
@@ -125,14 +125,14 @@ static unsigned int dali_reserved_mv_cnt = 0;
 std::mutex mapped_files_mutex;
 std::map<std::string, MappedFile> mapped_files;
 
-MmapedFileStream::MmapedFileStream(const std::string& path, bool read_ahead) :
+MmapedFileStream::MmapedFileStream(const std::string& path, bool read_ahead, bool no_atime) :
   FileStream(path), length_(0), pos_(0), read_ahead_whole_file_(read_ahead) {
   std::lock_guard<std::mutex> lock(mapped_files_mutex);
   std::weak_ptr<void> mapped_memory;
   std::tie(mapped_memory, length_) = mapped_files[path];
 
   if (!(p_ = mapped_memory.lock())) {
-    void *p = file_map(path.c_str(), &length_, read_ahead_whole_file_);
+    void *p = file_map(path.c_str(), &length_, read_ahead_whole_file_, no_atime);
     size_t length_tmp = length_;
     p_ = shared_ptr<void>(p, [=](void*) {
       // we are not touching mapped_files, weak_ptr is enough to check if
@@ -147,6 +147,11 @@ MmapedFileStream::MmapedFileStream(const std::string& path, bool read_ahead) :
   DALI_ENFORCE(p_ != nullptr, "Could not open file " + path + ": " + std::strerror(errno));
 }
 
+void MmapedFileStream::SetReadAhead(size_t /*n_bytes*/) {
+  if (p_)
+    madvise(p_.get(), length_, MADV_SEQUENTIAL);
+}
+
 void MmapedFileStream::Close() {
   // Not doing any munmap right now, since Buffer objects might still
   // reference the memory range of the mapping.
@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -26,7 +26,7 @@ namespace dali {
 
 class MmapedFileStream : public FileStream {
  public:
-  explicit MmapedFileStream(const std::string& path, bool read_ahead);
+  explicit MmapedFileStream(const std::string& path, bool read_ahead, bool no_atime = false);
   void Close() override;
   shared_ptr<void> Get(size_t n_bytes) override;
   static bool ReserveFileMappings(unsigned int num);
@@ -35,6 +35,7 @@ class MmapedFileStream : public FileStream {
   void Seek(int64 pos) override;
   int64 Tell() const override;
   size_t Size() const override;
+  void SetReadAhead(size_t n_bytes) override;
 
   ~MmapedFileStream() override {
     Close();
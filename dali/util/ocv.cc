@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <tuple>
 #include "dali/core/error_handling.h"
+#include "dali/kernels/imgproc/color_manipulation/color_space_conversion_cpu.h"
 #include "dali/kernels/imgproc/color_manipulation/color_space_conversion_impl.h"
 
 namespace dali {
@@ -70,40 +71,6 @@ static cv::ColorConversionCodes GetOpenCvColorConversionCode(
 template <DALIImageType input_type, DALIImageType output_type>
 void custom_conversion_pixel(const uint8_t* input, uint8_t* output);
 
-template <>
-inline void custom_conversion_pixel<DALI_RGB, DALI_YCbCr>(const uint8_t* input, uint8_t* output) {
-  vec<3, uint8_t> rgb = {input[0], input[1], input[2]};
-  output[0] = kernels::color::itu_r_bt_601::rgb_to_y<uint8_t>(rgb);
-  output[1] = kernels::color::itu_r_bt_601::rgb_to_cb<uint8_t>(rgb);
-  output[2] = kernels::color::itu_r_bt_601::rgb_to_cr<uint8_t>(rgb);
-}
-
-template <>
-inline void custom_conversion_pixel<DALI_BGR, DALI_YCbCr>(const uint8_t* input, uint8_t* output) {
-  vec<3, uint8_t> rgb = {input[2], input[1], input[0]};
-  output[0] = kernels::color::itu_r_bt_601::rgb_to_y<uint8_t>(rgb);
-  output[1] = kernels::color::itu_r_bt_601::rgb_to_cb<uint8_t>(rgb);
-  output[2] = kernels::color::itu_r_bt_601::rgb_to_cr<uint8_t>(rgb);
-}
-
-template <>
-inline void custom_conversion_pixel<DALI_YCbCr, DALI_RGB>(const uint8_t* input, uint8_t* output) {
-  vec<3, uint8_t> ycbcr{input[0], input[1], input[2]};
-  auto rgb = kernels::color::itu_r_bt_601::ycbcr_to_rgb<uint8_t>(ycbcr);
-  output[0] = rgb[0];
-  output[1] = rgb[1];
-  output[2] = rgb[2];
-}
-
-template <>
-inline void custom_conversion_pixel<DALI_YCbCr, DALI_BGR>(const uint8_t* input, uint8_t* output) {
-  vec<3, uint8_t> ycbcr{input[0], input[1], input[2]};
-  auto rgb = kernels::color::itu_r_bt_601::ycbcr_to_rgb<uint8_t>(ycbcr);
-  output[0] = rgb[2];
-  output[1] = rgb[1];
-  output[2] = rgb[0];
-}
-
 template <>
 inline void custom_conversion_pixel<DALI_GRAY, DALI_YCbCr>(const uint8_t* input, uint8_t* output) {
   output[0] = kernels::color::itu_r_bt_601::gray_to_y<uint8_t>(input[0]);
@@ -128,6 +95,28 @@ inline void custom_conversion(const cv::Mat& img, cv::Mat& output_img) {
   }
 }
 
+// The 3-channel conversions are vectorized
+
+template <>
+inline void custom_conversion<DALI_RGB, DALI_YCbCr>(const cv::Mat& img, cv::Mat& output_img) {
+  kernels::color::rgb_to_ycbcr<false>(output_img.data, img.data, img.rows * img.cols);
+}
+
+template <>
+inline void custom_conversion<DALI_BGR, DALI_YCbCr>(const cv::Mat& img, cv::Mat& output_img) {
+  kernels::color::rgb_to_ycbcr<true>(output_img.data, img.data, img.rows * img.cols);
+}
+
+template <>
+inline void custom_conversion<DALI_YCbCr, DALI_RGB>(const cv::Mat& img, cv::Mat& output_img) {
+  kernels::color::ycbcr_to_rgb<false>(output_img.data, img.data, img.rows * img.cols);
+}
+
+template <>
+inline void custom_conversion<DALI_YCbCr, DALI_BGR>(const cv::Mat& img, cv::Mat& output_img) {
+  kernels::color::ycbcr_to_rgb<true>(output_img.data, img.data, img.rows * img.cols);
+}
+
 void OpenCvColorConversion(DALIImageType input_type, const cv::Mat& input_img,
                            DALIImageType output_type, cv::Mat& output_img) {
   DALI_ENFORCE(input_img.elemSize() == static_cast<size_t>(NumberOfChannels(input_type)),
@@ -1,4 +1,4 @@
-// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -37,6 +37,14 @@ class DLL_PUBLIC RandomCropGenerator {
   DLL_PUBLIC CropWindow GenerateCropWindow(const TensorShape<>& shape);
   DLL_PUBLIC std::vector<CropWindow> GenerateCropWindows(const TensorShape<>& shape,
                                                          std::size_t N);
+
+  /**
+   * @brief The random engine, e.g. to store its state in a checkpoint
+   */
+  DLL_PUBLIC std::mt19937 &GetRNG() {
+    return rand_gen_;
+  }
+
  private:
   CropWindow GenerateCropWindowImpl(const TensorShape<>& shape);
 
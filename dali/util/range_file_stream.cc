@@ -0,0 +1,176 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+#include "dali/core/util.h"
+#include "dali/util/range_file_stream.h"
+
+namespace dali {
+
+RangeFileStream::RangeFileStream(const std::string &uri, std::shared_ptr<RangeSource> source,
+                                 RangeStreamOptions options)
+: FileStream(uri), source_(std::move(source)), options_(std::move(options)) {
+  DALI_ENFORCE(source_ != nullptr, "The source must not be null.");
+  DALI_ENFORCE(options_.chunk_size > 0, "The chunk size must be positive.");
+  options_.max_cached_chunks = std::max(options_.max_cached_chunks, 1);
+  options_.prefetch_chunks = std::max(options_.prefetch_chunks, 0);
+  size_ = source_->Size();
+  num_chunks_ = div_ceil(size_, options_.chunk_size);
+}
+
+RangeFileStream::~RangeFileStream() {
+  Close();
+}
+
+void RangeFileStream::Close() {
+  // waits for the pending fetches
+  chunks_.clear();
+}
+
+std::string RangeFileStream::SpillPath(size_t chunk_idx) const {
+  // the size is a part of the key, so that a replaced object is not read from stale chunks
+  size_t hash = std::hash<std::string>()(path_);
+  char name[64];
+  snprintf(name, sizeof(name), "%016zx_%zu_%zu.chunk", hash, size_, chunk_idx);
+  return options_.spill_dir + "/" + name;
+}
+
+RangeFileStream::ChunkData RangeFileStream::FetchChunk(size_t chunk_idx) const {
+  size_t offset = chunk_idx * options_.chunk_size;
+  size_t n_bytes = std::min(options_.chunk_size, size_ - offset);
+  auto data = std::make_shared<std::vector<uint8_t>>(n_bytes);
+
+  std::string spill_path;
+  if (!options_.spill_dir.empty()) {
+    spill_path = SpillPath(chunk_idx);
+    if (FILE *f = fopen(spill_path.c_str(), "rb")) {
+      bool ok = fread(data->data(), 1, n_bytes, f) == n_bytes && fgetc(f) == EOF;
+      fclose(f);
+      if (ok)
+        return data;
+    }
+  }
+
+  size_t n_read = source_->ReadRange(data->data(), n_bytes, offset);
+  DALI_ENFORCE(n_read == n_bytes, make_string("Could not read ", n_bytes, " bytes at ", offset,
+               " from ", path_, " - got ", n_read, " bytes."));
+
+  if (!spill_path.empty()) {
+    // a failure to store the chunk is not an error - it's just not cached
+    std::string tmp_path = make_string(spill_path, ".tmp.", getpid(), ".", this);
+    if (FILE *f = fopen(tmp_path.c_str(), "wb")) {
+      bool ok = fwrite(data->data(), 1, n_bytes, f) == n_bytes;
+      ok = (fclose(f) == 0) && ok;
+      if (!ok || rename(tmp_path.c_str(), spill_path.c_str()) != 0)
+        remove(tmp_path.c_str());
+    }
+  }
+  return data;
+}
+
+std::shared_future<RangeFileStream::ChunkData> RangeFileStream::Fetch(size_t chunk_idx) {
+  use_counter_++;
+  for (auto &chunk : chunks_) {
+    if (chunk.index == chunk_idx) {
+      chunk.last_use = use_counter_;
+      return chunk.data;
+    }
+  }
+  size_t max_chunks = options_.max_cached_chunks + options_.prefetch_chunks;
+  if (chunks_.size() >= max_chunks) {
+    auto lru = std::min_element(chunks_.begin(), chunks_.end(),
+        [](const Chunk &a, const Chunk &b) { return a.last_use < b.last_use; });
+    chunks_.erase(lru);
+  }
+  auto data = std::async(std::launch::async, [this, chunk_idx]() {
+    return FetchChunk(chunk_idx);
+  }).share();
+  chunks_.push_back({ chunk_idx, data, use_counter_ });
+  return data;
+}
+
+size_t RangeFileStream::ReadAt(uint8_t *buffer, size_t n_bytes, int64 offset) {
+  if (offset < 0 || static_cast<size_t>(offset) >= size_ || n_bytes == 0)
+    return 0;
+  n_bytes = std::min(n_bytes, size_ - offset);
+  size_t first = offset / options_.chunk_size;
+  size_t last = (offset + n_bytes - 1) / options_.chunk_size;
+
+  // issue all the requests first, so that they run in parallel
+  std::vector<std::shared_future<ChunkData>> needed;
+  needed.reserve(last - first + 1);
+  for (size_t c = first; c <= last; c++)
+    needed.push_back(Fetch(c));
+  for (size_t c = last + 1; c <= last + options_.prefetch_chunks && c < num_chunks_; c++)
+    Fetch(c);
+
+  size_t copied = 0;
+  for (size_t c = first; c <= last; c++) {
+    ChunkData data;
+    try {
+      data = needed[c - first].get();
+    } catch (...) {
+      // don't keep the failure - the next read will retry
+      chunks_.erase(std::remove_if(chunks_.begin(), chunks_.end(),
+                                   [c](const Chunk &chunk) { return chunk.index == c; }),
+                    chunks_.end());
+      throw;
+    }
+    size_t chunk_start = c * options_.chunk_size;
+    size_t begin = std::max<size_t>(offset, chunk_start) - chunk_start;
+    size_t end = std::min<size_t>(offset + n_bytes, chunk_start + data->size()) - chunk_start;
+    std::memcpy(buffer + copied, data->data() + begin, end - begin);
+    copied += end - begin;
+  }
+  return copied;
+}
+
+size_t RangeFileStream::Read(uint8_t *buffer, size_t n_bytes) {
+  size_t n_read = ReadAt(buffer, n_bytes, pos_);
+  pos_ += n_read;
+  return n_read;
+}
+
+shared_ptr<void> RangeFileStream::Get(size_t n_bytes) {
+  if (pos_ + n_bytes > size_)
+    return {};
+  shared_ptr<uint8_t> data(new uint8_t[n_bytes], std::default_delete<uint8_t[]>());
+  Read(data.get(), n_bytes);
+  return data;
+}
+
+void RangeFileStream::Seek(int64 pos) {
+  DALI_ENFORCE(pos >= 0 && static_cast<size_t>(pos) <= size_,
+               make_string("Invalid seek position ", pos, " in ", path_, " of size ", size_));
+  pos_ = pos;
+}
+
+int64 RangeFileStream::Tell() const {
+  return pos_;
+}
+
+size_t RangeFileStream::Size() const {
+  return size_;
+}
+
+}  // namespace dali
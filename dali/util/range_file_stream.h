@@ -0,0 +1,110 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_UTIL_RANGE_FILE_STREAM_H_
+#define DALI_UTIL_RANGE_FILE_STREAM_H_
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dali/core/api_helper.h"
+#include "dali/core/common.h"
+#include "dali/util/file.h"
+
+namespace dali {
+
+/**
+ * @brief Data which can be read in arbitrary ranges, e.g. an object in a remote storage,
+ *        accessed with HTTP range requests.
+ *
+ * The methods can be called concurrently.
+ */
+class DLL_PUBLIC RangeSource {
+ public:
+  virtual ~RangeSource() = default;
+
+  /// The total size of the data
+  virtual size_t Size() = 0;
+
+  /**
+   * @brief Reads `n_bytes` starting at `offset` to `buffer`
+   *
+   * @return The number of bytes read - less than `n_bytes` only at the end of the data.
+   *         Errors are reported by throwing.
+   */
+  virtual size_t ReadRange(uint8_t *buffer, size_t n_bytes, size_t offset) = 0;
+};
+
+struct RangeStreamOptions {
+  /// The size of the ranges requested from the source
+  size_t chunk_size = 8 << 20;
+  /// The number of chunks kept in memory
+  int max_cached_chunks = 4;
+  /// The number of chunks following the current one, fetched in the background
+  int prefetch_chunks = 2;
+  /// A local directory where the fetched chunks are stored for reuse; empty disables it
+  std::string spill_dir;
+};
+
+/**
+ * @brief A stream over a RangeSource.
+ *
+ * The data is fetched in chunks; the chunks needed by a read are fetched in parallel and, when
+ * the stream is read sequentially, the following chunks are fetched in the background.
+ * Optionally, the chunks are stored in a local directory (e.g. on an SSD), so that subsequent
+ * epochs or runs don't need to fetch them again.
+ */
+class DLL_PUBLIC RangeFileStream : public FileStream {
+ public:
+  RangeFileStream(const std::string &uri, std::shared_ptr<RangeSource> source,
+                  RangeStreamOptions options = {});
+  ~RangeFileStream() override;
+
+  void Close() override;
+  size_t Read(uint8_t *buffer, size_t n_bytes) override;
+  size_t ReadAt(uint8_t *buffer, size_t n_bytes, int64 offset) override;
+  /// Returns a copy of the data - there's no memory to share
+  shared_ptr<void> Get(size_t n_bytes) override;
+  void Seek(int64 pos) override;
+  int64 Tell() const override;
+  size_t Size() const override;
+
+ private:
+  using ChunkData = std::shared_ptr<const std::vector<uint8_t>>;
+
+  struct Chunk {
+    size_t index;
+    std::shared_future<ChunkData> data;
+    int64 last_use;
+  };
+
+  /// Starts fetching the chunk, unless it's already cached or being fetched
+  std::shared_future<ChunkData> Fetch(size_t chunk_idx);
+  ChunkData FetchChunk(size_t chunk_idx) const;
+  std::string SpillPath(size_t chunk_idx) const;
+
+  std::shared_ptr<RangeSource> source_;
+  RangeStreamOptions options_;
+  size_t size_ = 0;
+  size_t num_chunks_ = 0;
+  int64 pos_ = 0;
+  std::vector<Chunk> chunks_;
+  int64 use_counter_ = 0;
+};
+
+}  // namespace dali
+
+#endif  // DALI_UTIL_RANGE_FILE_STREAM_H_
@@ -0,0 +1,164 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/util/range_file_stream.h"  // NOLINT
+#include <ftw.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace dali {
+namespace test {
+
+namespace {
+
+class MemorySource : public RangeSource {
+ public:
+  explicit MemorySource(const std::vector<uint8_t> &data) : data_(data) {}
+
+  size_t Size() override {
+    return data_.size();
+  }
+
+  size_t ReadRange(uint8_t *buffer, size_t n_bytes, size_t offset) override {
+    num_requests++;
+    if (fail_next.exchange(false))
+      throw std::runtime_error("Simulated failure");
+    n_bytes = std::min(n_bytes, data_.size() - offset);
+    std::memcpy(buffer, data_.data() + offset, n_bytes);
+    return n_bytes;
+  }
+
+  std::atomic<int> num_requests{0};
+  std::atomic<bool> fail_next{false};
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+std::vector<uint8_t> RandomData(size_t size) {
+  std::vector<uint8_t> data(size);
+  std::mt19937 rng(1234);
+  for (auto &x : data)
+    x = rng();
+  return data;
+}
+
+int Remove(const char *fpath, const struct stat *, int, struct FTW *) {
+  return remove(fpath);
+}
+
+RangeStreamOptions SmallChunks() {
+  RangeStreamOptions opts;
+  opts.chunk_size = 64;
+  opts.max_cached_chunks = 2;
+  opts.prefetch_chunks = 1;
+  return opts;
+}
+
+}  // namespace
+
+TEST(RangeFileStream, Read) {
+  auto data = RandomData(1000);
+  auto source = std::make_shared<MemorySource>(data);
+  RangeFileStream stream("mem://data", source, SmallChunks());
+  EXPECT_EQ(stream.Size(), data.size());
+
+  std::vector<uint8_t> out(data.size() + 100);
+  size_t pos = 0;
+  while (size_t n = stream.Read(out.data() + pos, 37))
+    pos += n;
+  ASSERT_EQ(pos, data.size());
+  EXPECT_EQ(stream.Tell(), static_cast<int64>(data.size()));
+  out.resize(pos);
+  EXPECT_EQ(out, data);
+  EXPECT_EQ(source->num_requests, 16) << "Each chunk should be requested once";
+
+  // a read spanning many chunks, which are not cached anymore
+  std::vector<uint8_t> big(500);
+  ASSERT_EQ(stream.ReadAt(big.data(), big.size(), 100), big.size());
+  EXPECT_TRUE(std::equal(big.begin(), big.end(), data.begin() + 100));
+  EXPECT_EQ(stream.Tell(), static_cast<int64>(data.size())) << "ReadAt should not move";
+
+  stream.Seek(990);
+  auto tail = stream.Get(10);
+  ASSERT_NE(tail, nullptr);
+  EXPECT_EQ(std::memcmp(tail.get(), data.data() + 990, 10), 0);
+  EXPECT_EQ(stream.Get(1), nullptr) << "Reading past the end should fail";
+  EXPECT_THROW(stream.Seek(1001), std::exception);
+}
+
+TEST(RangeFileStream, RetryAfterFailure) {
+  auto data = RandomData(100);
+  auto opts = SmallChunks();
+  opts.prefetch_chunks = 0;
+  auto source = std::make_shared<MemorySource>(data);
+  RangeFileStream stream("mem://data", source, opts);
+  std::vector<uint8_t> out(10);
+  source->fail_next = true;
+  EXPECT_THROW(stream.Read(out.data(), out.size()), std::exception);
+  EXPECT_EQ(stream.Read(out.data(), out.size()), out.size());
+  EXPECT_TRUE(std::equal(out.begin(), out.end(), data.begin()));
+}
+
+TEST(RangeFileStream, SpillCache) {
+  std::string tmpl = "/tmp/range_stream_test_XXXXXX";
+  std::string spill_dir = mkdtemp(&tmpl[0]);
+  auto data = RandomData(300);
+  auto opts = SmallChunks();
+  opts.spill_dir = spill_dir;
+  std::vector<uint8_t> out(data.size());
+  {
+    auto source = std::make_shared<MemorySource>(data);
+    RangeFileStream stream("mem://data", source, opts);
+    ASSERT_EQ(stream.Read(out.data(), out.size()), data.size());
+    EXPECT_EQ(source->num_requests, 5);
+  }
+  {
+    auto source = std::make_shared<MemorySource>(data);
+    RangeFileStream stream("mem://data", source, opts);
+    std::fill(out.begin(), out.end(), 0);
+    ASSERT_EQ(stream.Read(out.data(), out.size()), data.size());
+    EXPECT_EQ(out, data);
+    EXPECT_EQ(source->num_requests, 0) << "The chunks should be read from the spill directory";
+  }
+  nftw(spill_dir.c_str(), Remove, 64, FTW_DEPTH | FTW_PHYS);
+}
+
+TEST(RangeFileStream, RegisterScheme) {
+  auto data = RandomData(100);
+  FileStream::RegisterScheme("mem", [&](const std::string &uri) {
+    return std::make_unique<RangeFileStream>(uri, std::make_shared<MemorySource>(data));
+  });
+  auto stream = FileStream::Open("mem://bucket/object", false, true);
+  EXPECT_EQ(stream->Size(), data.size());
+  std::vector<uint8_t> out(data.size());
+  EXPECT_EQ(stream->Read(out.data(), out.size()), data.size());
+  EXPECT_EQ(out, data);
+
+  FileStream::RegisterScheme("mem", {});
+  EXPECT_THROW(FileStream::Open("mem://bucket/object", false, false), std::exception)
+      << "Without a backend, the URI should be treated as a (nonexistent) local path";
+}
+
+}  // namespace test
+}  // namespace dali
@@ -43,6 +43,17 @@ class StdCUFileStream : public CUFileStream {
   void HandleIOError(int64 ret) const;
   size_t Size() const override;
 
+  /**
+   * @brief The cuFile handle of the file, registered for direct reads
+   */
+  const cufile::CUFileHandle &Handle() const {
+    return f_;
+  }
+
+  const std::string &Path() const {
+    return path_;
+  }
+
   ~StdCUFileStream() override {
     Close();
   }
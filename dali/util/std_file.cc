@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cstdio>
 #include <cstring>
 #include <memory>
@@ -24,11 +26,25 @@
 
 namespace dali {
 
-StdFileStream::StdFileStream(const std::string& path) : FileStream(path) {
-  fp_ = std::fopen(path.c_str(), "rb");
+StdFileStream::StdFileStream(const std::string& path, bool no_atime) : FileStream(path) {
+  int fd = OpenReadOnly(path, no_atime);
+  fp_ = fd >= 0 ? fdopen(fd, "rb") : nullptr;
+  if (fp_ == nullptr && fd >= 0) {
+    int err = errno;
+    close(fd);
+    errno = err;
+  }
   DALI_ENFORCE(fp_ != nullptr, "Could not open file " + path + ": " + std::strerror(errno));
 }
 
+void StdFileStream::SetReadAhead(size_t n_bytes) {
+  // a larger buffer turns small reads of consecutive records into large reads from the file
+  buffer_.reset(new char[n_bytes]);
+  if (std::setvbuf(fp_, buffer_.get(), _IOFBF, n_bytes) != 0)
+    buffer_.reset();
+  posix_fadvise(fileno(fp_), 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
 void StdFileStream::Close() {
   if (fp_ != nullptr) {
     std::fclose(fp_);
@@ -58,7 +74,8 @@ shared_ptr<void> StdFileStream::Get(size_t /*n_bytes*/) {
 
 size_t StdFileStream::Size() const {
   struct stat sb;
-  if (stat(path_.c_str(), &sb) == -1) {
+  // the open descriptor is queried, when there is one, to avoid a path lookup
+  if ((fp_ ? fstat(fileno(fp_), &sb) : stat(path_.c_str(), &sb)) == -1) {
     DALI_FAIL("Unable to stat file " + path_ + ": " + std::strerror(errno));
   }
   return sb.st_size;
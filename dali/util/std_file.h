@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -26,13 +26,14 @@ namespace dali {
 
 class StdFileStream : public FileStream {
  public:
-  explicit StdFileStream(const std::string& path);
+  explicit StdFileStream(const std::string& path, bool no_atime = false);
   void Close() override;
   shared_ptr<void>  Get(size_t n_bytes) override;
   size_t Read(uint8_t * buffer, size_t n_bytes) override;
   void Seek(int64 pos) override;
   int64 Tell() const override;
   size_t Size() const override;
+  void SetReadAhead(size_t n_bytes) override;
 
   ~StdFileStream() override {
     Close();
@@ -40,6 +41,7 @@ class StdFileStream : public FileStream {
 
  private:
   FILE * fp_;
+  std::unique_ptr<char[]> buffer_;
 };
 
 }  // namespace dali
@@ -0,0 +1,324 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define DALI_HAS_IO_URING 1
+#endif
+#endif
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "dali/core/error_handling.h"
+#include "dali/core/small_vector.h"
+#include "dali/util/uring_file.h"
+
+namespace dali {
+
+namespace {
+
+#if DALI_HAS_IO_URING && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+
+/**
+ * @brief A minimal io_uring wrapper, capable of submitting reads and reaping their completions
+ */
+class IoUring {
+ public:
+  static constexpr unsigned kQueueDepth = 128;
+
+  IoUring() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = syscall(__NR_io_uring_setup, kQueueDepth, &params);
+    if (ring_fd_ < 0)
+      return;
+
+    sq_entries_ = params.sq_entries;
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    single_mmap_ = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap_)
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+    sq_ring_ = Map(sq_ring_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap_ ? sq_ring_ : Map(cq_ring_size_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe *>(Map(sqes_size_, IORING_OFF_SQES));
+    if (!sq_ring_ || !cq_ring_ || !sqes_) {
+      Release();
+      return;
+    }
+
+    auto *sq = static_cast<char *>(sq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    auto *cq = static_cast<char *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  }
+
+  ~IoUring() {
+    Release();
+  }
+
+  bool IsValid() const {
+    return ring_fd_ >= 0;
+  }
+
+  unsigned QueueDepth() const {
+    return sq_entries_;
+  }
+
+  /**
+   * @brief Puts a read in the submission queue; the caller must not exceed QueueDepth in flight
+   */
+  void PrepareRead(int fd, void *buffer, size_t n_bytes, int64 offset, uint64_t user_data) {
+    unsigned tail = *sq_tail_;
+    unsigned idx = tail & sq_mask_;
+    io_uring_sqe &sqe = sqes_[idx];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<uint64_t>(buffer);
+    sqe.len = n_bytes;
+    sqe.off = offset;
+    sqe.user_data = user_data;
+    sq_array_[idx] = idx;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    to_submit_++;
+  }
+
+  /**
+   * @brief Submits the prepared reads and waits for at least `min_complete` completions
+   */
+  void Submit(unsigned min_complete) {
+    int ret;
+    do {
+      ret = syscall(__NR_io_uring_enter, ring_fd_, to_submit_, min_complete,
+                    min_complete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+    } while (ret < 0 && errno == EINTR);
+    DALI_ENFORCE(ret >= 0, make_string("io_uring_enter failed: ", std::strerror(errno)));
+    to_submit_ -= std::min<unsigned>(ret, to_submit_);
+  }
+
+  /**
+   * @brief Calls `callback(user_data, result)` for every completion available
+   */
+  template <typename Callback>
+  void Reap(Callback &&callback) {
+    unsigned head = *cq_head_;
+    while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+      uint64_t user_data = cqe.user_data;
+      int res = cqe.res;
+      head++;
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+      callback(user_data, res);
+    }
+  }
+
+ private:
+  void *Map(size_t size, off_t offset) {
+    void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   ring_fd_, offset);
+    return p == MAP_FAILED ? nullptr : p;
+  }
+
+  void Release() {
+    if (sqes_)
+      munmap(sqes_, sqes_size_);
+    if (cq_ring_ && cq_ring_ != sq_ring_)
+      munmap(cq_ring_, cq_ring_size_);
+    if (sq_ring_)
+      munmap(sq_ring_, sq_ring_size_);
+    sqes_ = nullptr;
+    sq_ring_ = cq_ring_ = nullptr;
+    if (ring_fd_ >= 0)
+      close(ring_fd_);
+    ring_fd_ = -1;
+  }
+
+  int ring_fd_ = -1;
+  bool single_mmap_ = false;
+  unsigned sq_entries_ = 0;
+  unsigned to_submit_ = 0;
+  size_t sq_ring_size_ = 0, cq_ring_size_ = 0, sqes_size_ = 0;
+  void *sq_ring_ = nullptr, *cq_ring_ = nullptr;
+  io_uring_sqe *sqes_ = nullptr;
+  unsigned *sq_tail_ = nullptr, *sq_array_ = nullptr;
+  unsigned *cq_head_ = nullptr, *cq_tail_ = nullptr;
+  unsigned sq_mask_ = 0, cq_mask_ = 0;
+  io_uring_cqe *cqes_ = nullptr;
+};
+
+/**
+ * @brief Returns the io_uring instance of the calling thread or nullptr if not supported
+ */
+IoUring *ThisThreadRing() {
+  static thread_local std::unique_ptr<IoUring> ring = std::make_unique<IoUring>();
+  return ring->IsValid() ? ring.get() : nullptr;
+}
+
+#else
+
+struct IoUring {};
+
+IoUring *ThisThreadRing() {
+  return nullptr;
+}
+
+#endif
+
+size_t PRead(int fd, uint8_t *buffer, size_t n_bytes, int64 offset) {
+  size_t total = 0;
+  while (total < n_bytes) {
+    ssize_t ret = pread(fd, buffer + total, n_bytes - total, offset + total);
+    if (ret < 0 && errno == EINTR)
+      continue;
+    DALI_ENFORCE(ret >= 0, make_string("Read operation did not succeed: ", std::strerror(errno)));
+    if (ret == 0)
+      break;
+    total += ret;
+  }
+  return total;
+}
+
+}  // namespace
+
+UringFileStream::UringFileStream(const std::string& path, bool no_atime) : FileStream(path) {
+  fd_ = OpenReadOnly(path, no_atime);
+  DALI_ENFORCE(fd_ >= 0, "Could not open file " + path + ": " + std::strerror(errno));
+}
+
+void UringFileStream::Close() {
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+  pos_ = 0;
+}
+
+shared_ptr<void> UringFileStream::Get(size_t /*n_bytes*/) {
+  // there's no mapping to share the data from
+  return {};
+}
+
+size_t UringFileStream::Read(uint8_t *buffer, size_t n_bytes) {
+  size_t ret = PRead(fd_, buffer, n_bytes, pos_);
+  pos_ += ret;
+  return ret;
+}
+
+size_t UringFileStream::ReadAt(uint8_t *buffer, size_t n_bytes, int64 offset) {
+  return PRead(fd_, buffer, n_bytes, offset);
+}
+
+void UringFileStream::Seek(int64 pos) {
+  DALI_ENFORCE(pos >= 0, "Invalid seek");
+  pos_ = pos;
+}
+
+int64 UringFileStream::Tell() const {
+  return pos_;
+}
+
+size_t UringFileStream::Size() const {
+  struct stat sb;
+  if (fstat(fd_, &sb) == -1) {
+    DALI_FAIL("Unable to stat file " + path_ + ": " + std::strerror(errno));
+  }
+  return sb.st_size;
+}
+
+bool UringFileStream::IsSupported() {
+  return ThisThreadRing() != nullptr;
+}
+
+void UringFileStream::ReadBatch(span<ReadRequest *> requests) {
+  for (auto *req : requests)
+    req->bytes_read = 0;
+#if DALI_HAS_IO_URING && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+  IoUring *ring = ThisThreadRing();
+  if (ring) {
+    auto fd_of = [](const ReadRequest *req) {
+      return static_cast<UringFileStream *>(req->stream)->fd_;
+    };
+    auto prepare = [&](int64_t idx) {
+      auto *req = requests[idx];
+      ring->PrepareRead(fd_of(req), req->buffer + req->bytes_read, req->n_bytes - req->bytes_read,
+                        req->offset + req->bytes_read, idx);
+    };
+    int64_t next = 0, n = requests.size();
+    unsigned in_flight = 0;
+    // the indices of the requests which got a short read and need to be resumed
+    SmallVector<int64_t, 16> resubmit;
+    std::string error;
+    while (in_flight > 0 || (error.empty() && (next < n || !resubmit.empty()))) {
+      while (!resubmit.empty() && in_flight < ring->QueueDepth() && error.empty()) {
+        prepare(resubmit.back());
+        resubmit.pop_back();
+        in_flight++;
+      }
+      for (; next < n && in_flight < ring->QueueDepth() && error.empty(); next++) {
+        if (requests[next]->n_bytes == 0)
+          continue;
+        prepare(next);
+        in_flight++;
+      }
+      if (in_flight == 0)
+        break;
+      ring->Submit(1);
+      ring->Reap([&](uint64_t idx, int res) {
+        in_flight--;
+        auto *req = requests[idx];
+        auto *stream = static_cast<UringFileStream *>(req->stream);
+        if (res == -EINVAL) {
+          // IORING_OP_READ is not supported by older kernels - read synchronously instead
+          req->bytes_read += PRead(stream->fd_, req->buffer + req->bytes_read,
+                                   req->n_bytes - req->bytes_read, req->offset + req->bytes_read);
+        } else if (res < 0) {
+          // don't throw yet - the reads which are still in flight write to the user's buffers
+          if (error.empty())
+            error = make_string("Read operation on ", stream->path_, " did not succeed: ",
+                                std::strerror(-res));
+        } else {
+          req->bytes_read += res;
+          if (res > 0 && req->bytes_read < req->n_bytes && error.empty())
+            resubmit.push_back(idx);
+        }
+      });
+      if (!error.empty() && in_flight == 0)
+        break;
+    }
+    DALI_ENFORCE(error.empty(), error);
+    return;
+  }
+#endif
+  for (auto *req : requests)
+    req->bytes_read = req->stream->ReadAt(req->buffer, req->n_bytes, req->offset);
+}
+
+}  // namespace dali
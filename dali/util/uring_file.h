@@ -0,0 +1,66 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_UTIL_URING_FILE_H_
+#define DALI_UTIL_URING_FILE_H_
+
+#include <string>
+#include <memory>
+
+#include "dali/core/common.h"
+#include "dali/core/span.h"
+#include "dali/util/file.h"
+
+namespace dali {
+
+/**
+ * @brief File stream which services batched reads with io_uring
+ *
+ * Single reads are plain `pread` calls. ReadBatch puts all the requests in the submission
+ * queue of a per-thread io_uring instance and waits for their completion, so the device sees
+ * the whole batch at once instead of one blocking request after another.
+ */
+class DLL_PUBLIC UringFileStream : public FileStream {
+ public:
+  explicit UringFileStream(const std::string& path, bool no_atime = false);
+  void Close() override;
+  shared_ptr<void> Get(size_t n_bytes) override;
+  size_t Read(uint8_t * buffer, size_t n_bytes) override;
+  size_t ReadAt(uint8_t *buffer, size_t n_bytes, int64 offset) override;
+  void Seek(int64 pos) override;
+  int64 Tell() const override;
+  size_t Size() const override;
+
+  ~UringFileStream() override {
+    Close();
+  }
+
+  /**
+   * @brief Checks whether io_uring is available (the kernel supports it and it's not blocked)
+   */
+  static bool IsSupported();
+
+  /**
+   * @brief Reads all the requests (which must refer to UringFileStream) using io_uring
+   */
+  static void ReadBatch(span<ReadRequest *> requests);
+
+ private:
+  int fd_ = -1;
+  int64 pos_ = 0;
+};
+
+}  // namespace dali
+
+#endif  // DALI_UTIL_URING_FILE_H_
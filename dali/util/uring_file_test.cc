@@ -0,0 +1,109 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "dali/util/file.h"
+#include "dali/util/uring_file.h"
+
+namespace dali {
+namespace test {
+
+class FileStreamBatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/dali_file_batch_XXXXXX";
+    int fd = mkstemp(name);
+    ASSERT_GE(fd, 0);
+    path_ = name;
+    data_.resize(1 << 20);
+    for (size_t i = 0; i < data_.size(); i++)
+      data_[i] = static_cast<uint8_t>(i * 7 + (i >> 9));
+    ASSERT_EQ(write(fd, data_.data(), data_.size()), static_cast<ssize_t>(data_.size()));
+    close(fd);
+  }
+
+  void TearDown() override {
+    unlink(path_.c_str());
+  }
+
+  void TestBatch(bool use_io_uring) {
+    std::vector<std::unique_ptr<FileStream>> streams;
+    for (int i = 0; i < 4; i++)
+      streams.push_back(FileStream::Open(path_, false, false, use_io_uring && i % 2 == 0));
+
+    const int n = 500;  // more than the depth of the submission queue
+    std::vector<FileStream::ReadRequest> requests(n);
+    std::vector<std::vector<uint8_t>> buffers(n);
+    for (int i = 0; i < n; i++) {
+      auto &req = requests[i];
+      req.stream = streams[i % streams.size()].get();
+      req.offset = (i * 2011) % data_.size();
+      req.n_bytes = (i * 977) % 8000;
+      buffers[i].resize(req.n_bytes);
+      req.buffer = buffers[i].data();
+    }
+    // a read crossing the end of the file
+    requests[1].offset = data_.size() - 100;
+
+    FileStream::ReadBatch(make_span(requests));
+
+    for (int i = 0; i < n; i++) {
+      auto &req = requests[i];
+      size_t expected = std::min<size_t>(req.n_bytes, data_.size() - req.offset);
+      ASSERT_EQ(req.bytes_read, expected) << "at request " << i;
+      EXPECT_EQ(std::memcmp(req.buffer, data_.data() + req.offset, expected), 0)
+          << "at request " << i;
+    }
+
+    // the stream positions are not affected by the batch
+    for (auto &stream : streams)
+      EXPECT_EQ(stream->Tell(), 0);
+  }
+
+  std::string path_;
+  std::vector<uint8_t> data_;
+};
+
+TEST_F(FileStreamBatchTest, StdFileStream) {
+  TestBatch(false);
+}
+
+TEST_F(FileStreamBatchTest, UringFileStream) {
+  if (!UringFileStream::IsSupported())
+    GTEST_SKIP() << "io_uring is not supported";
+  TestBatch(true);
+}
+
+TEST_F(FileStreamBatchTest, UringFileStreamRead) {
+  if (!UringFileStream::IsSupported())
+    GTEST_SKIP() << "io_uring is not supported";
+  auto stream = FileStream::Open(path_, false, false, true);
+  ASSERT_NE(dynamic_cast<UringFileStream *>(stream.get()), nullptr);
+  EXPECT_EQ(stream->Size(), data_.size());
+  std::vector<uint8_t> buf(1000);
+  stream->Seek(12345);
+  ASSERT_EQ(stream->Read(buf.data(), buf.size()), buf.size());
+  EXPECT_EQ(std::memcmp(buf.data(), data_.data() + 12345, buf.size()), 0);
+  EXPECT_EQ(stream->Tell(), 12345 + static_cast<int64>(buf.size()));
+}
+
+}  // namespace test
+}  // namespace dali
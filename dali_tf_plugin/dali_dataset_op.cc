@@ -50,6 +50,7 @@
 #include "dali/core/common.h"
 #include "dali/core/format.h"
 #include "dali_tf_plugin/dali_helper.h"
+#include "dali_tf_plugin/tfallocator.h"
 
 #include "dali_tf_plugin/dali_dataset.h"
 
@@ -293,6 +294,13 @@ class DALIDatasetOp::Dataset::Iterator : public DatasetIterator<Dataset> {
                          &pipeline_handle_, dataset()->input_desc_.input_names[i].c_str()));
       }
     }
+    if (dataset()->device_type_ == device_type_t::GPU) {
+      // The pipeline writes the GPU outputs directly to the memory of TF tensors
+      output_allocator_ = std::make_unique<TFOutputAllocator>(context->allocator({}));
+      output_allocator_->SetStream(dataset()->stream_);
+      TF_DALI_CALL(daliSetOutputAllocator(&pipeline_handle_, TFOutputAllocator::Allocate,
+                                          TFOutputAllocator::Free, output_allocator_.get()));
+    }
     TF_RETURN_IF_ERROR(PrefetchPipeline(context, &pipeline_handle_));
     return CheckOutputDevices();
   }
@@ -551,6 +559,9 @@ class DALIDatasetOp::Dataset::Iterator : public DatasetIterator<Dataset> {
   /**
    * @brief Obtain the last computed outputs from DALI Pipeline and copy them to the TF Tensors
    * that we allocated for outputs. Release the DALI Pipeline Outputs.
+   *
+   * The GPU outputs stored in the memory of TF tensors, see TFOutputAllocator, are returned
+   * without copying.
    */
   Status ProduceOutputs(IteratorContext *context, std::vector<Tensor> *out_tensors,
                         bool &end_of_sequence) {
@@ -558,6 +569,7 @@ class DALIDatasetOp::Dataset::Iterator : public DatasetIterator<Dataset> {
 
     auto num_outputs = 0;
     TF_DALI_CALL(num_outputs = daliGetNumOutput(&pipeline_handle_));
+    bool copied_to_gpu = false;
 
     for (int out_id = 0; out_id < num_outputs; ++out_id) {
       TensorShape output_shape;
@@ -605,6 +617,22 @@ class DALIDatasetOp::Dataset::Iterator : public DatasetIterator<Dataset> {
         return errors::InvalidArgument(ss.str());
       }
 
+      if (output_allocator_) {
+        // If the output is stored in the memory of a TF tensor, return that tensor
+        Tensor shared;
+        const void *data = nullptr;
+        size_t dali_tensor_size = 0;
+        TF_DALI_CALL(data = daliOutputData(&pipeline_handle_, out_id));
+        TF_DALI_CALL(dali_tensor_size = daliTensorSize(&pipeline_handle_, out_id));
+        size_t tf_tensor_size =
+            output_shape.num_elements() * DataTypeSize(dataset()->dtypes_[out_id]);
+        if (dali_tensor_size == tf_tensor_size &&
+            output_allocator_->Adopt(data, dataset()->dtypes_[out_id], output_shape, &shared)) {
+          out_tensors->push_back(std::move(shared));
+          continue;
+        }
+      }
+
       out_tensors->emplace_back(context->allocator({}), dataset()->dtypes_[out_id], output_shape);
       tensorflow::Tensor &output = out_tensors->operator[](out_id);
 
@@ -652,16 +680,16 @@ class DALIDatasetOp::Dataset::Iterator : public DatasetIterator<Dataset> {
               std::to_string(out_id));
       }
 
-      // Synchronize with the dataset()->stream_ when doing the last copy, so the outputs
-      // are fully finished before we release the output buffers for reuse.
+      TF_DALI_CALL(daliOutputCopy(&pipeline_handle_, dst, out_id, dataset()->device_type_,
+                                  dataset()->stream_, DALI_ext_default));
       // if the OP runs on the CPU the output memory is not pinned and we don't need to sync
-      unsigned int wait_flag = dataset()->device_type_ != device_type_t::CPU &&
-                               (out_id == num_outputs - 1) ?
-                                  DALI_ext_force_sync :
-                                  DALI_ext_default;
+      copied_to_gpu = copied_to_gpu || dataset()->device_type_ != device_type_t::CPU;
+    }
 
-      TF_DALI_CALL(daliOutputCopy(&pipeline_handle_, dst, out_id, dataset()->device_type_,
-                                  dataset()->stream_, wait_flag));
+    // Synchronize with the dataset()->stream_, so the copies are fully finished before we
+    // release the output buffers for reuse.
+    if (copied_to_gpu && cudaStreamSynchronize(dataset()->stream_) != cudaSuccess) {
+      return errors::Internal("Cannot synchronize with the stream of the DALI outputs");
     }
 
     end_of_sequence = false;
@@ -875,6 +903,8 @@ class DALIDatasetOp::Dataset::Iterator : public DatasetIterator<Dataset> {
   InputState iterator_state_ = InputState::in_progress;
   daliPipelineHandle pipeline_handle_;
   bool enable_memory_stats_;
+  // provides the GPU outputs with the memory of TF tensors; must outlive the pipeline
+  std::unique_ptr<TFOutputAllocator> output_allocator_;
 };
 
 void DALIDatasetOp::MakeDataset(OpKernelContext *context, DatasetBase **output) {
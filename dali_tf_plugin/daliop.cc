@@ -14,6 +14,7 @@
 
 #include <cuda_runtime_api.h>
 #include <chrono>
+#include <memory>
 #include <sstream>
 
 #include "tensorflow/core/framework/op.h"
@@ -28,14 +29,10 @@
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 
-#define USE_TF_ALLOCATOR 0
-#if USE_TF_ALLOCATOR
-#include "dali_tf_plugin/tfallocator.h"
-#endif
-
 #include "dali/c_api.h"
 #include "dali/core/common.h"
 #include "dali_tf_plugin/dali_helper.h"
+#include "dali_tf_plugin/tfallocator.h"
 
 typedef std::chrono::high_resolution_clock Clock;
 
@@ -149,10 +146,13 @@ class DaliOp : public tf::OpKernel {
                    prefetch_queue_depth_,
                    enable_memory_stats_));
 
-#if USE_TF_ALLOCATOR
-    SetupTFAllocator(device_id_);
-    UpdateTFAllocaterContext<tf::OpKernelConstruction>(context, device_id_);
-#endif
+    if (this->device_type_ == device_type_t::GPU) {
+      // The pipeline writes the GPU outputs directly to the memory of TF tensors
+      output_allocator_ = std::make_unique<TFOutputAllocator>(
+          context->device()->GetAllocator(tf::AllocatorAttributes()));
+      TF_DALI_CALL(daliSetOutputAllocator(&pipe_handle_, TFOutputAllocator::Allocate,
+                                          TFOutputAllocator::Free, output_allocator_.get()));
+    }
     LOG_LINE << "Pipeline created\n";
     LOG_LINE << "Prefetching...\n";
     if (!exec_separated) {
@@ -193,10 +193,6 @@ class DaliOp : public tf::OpKernel {
   void Compute(tf::OpKernelContext* context) override {
     auto total_s = Clock::now();
 
-#if USE_TF_ALLOCATOR
-    UpdateTFAllocaterContext<tf::OpKernelContext>(context, device_id_);
-    LOG_LINE << "Updated context\n";
-#endif
     LOG_LINE << "Before output...\n";
 
     auto s = Clock::now();
@@ -220,7 +216,9 @@ class DaliOp : public tf::OpKernel {
     cudaStream_t stream = 0;
     if (this->device_type_ == device_type_t::GPU) {
       stream = context->eigen_device<Eigen::GpuDevice>().stream();
+      output_allocator_->SetStream(stream);
     }
+    bool copied_to_gpu = false;
 
     for (unsigned i = 0, j = 0; i < dali_num_out; ++i, ++j) {
       bool should_be_sparse_tensor = i < sparse_.size() && sparse_[i];
@@ -261,6 +259,20 @@ class DaliOp : public tf::OpKernel {
         tf::errors::InvalidArgument("DALI pipeline output shape at " + std::to_string(i) +
                                     " " + data_output_shape.DebugString() + " != "
                                     + shapes_[i].DebugString() + " plugin `shapes` argument"));
+        if (output_allocator_) {
+          // If the output is stored in the memory of a TF tensor, return that tensor
+          tf::Tensor shared;
+          const void *data = nullptr;
+          size_t dali_tensor_size = 0;
+          TF_DALI_CALL(data = daliOutputData(&pipe_handle_, i));
+          TF_DALI_CALL(dali_tensor_size = daliTensorSize(&pipe_handle_, i));
+          size_t tf_tensor_size = data_output_shape.num_elements() * tf::DataTypeSize(types_[j]);
+          if (dali_tensor_size == tf_tensor_size &&
+              output_allocator_->Adopt(data, types_[j], data_output_shape, &shared)) {
+            outputs.set(j, shared);
+            continue;
+          }
+        }
         OP_REQUIRES_OK(context, outputs.allocate(j, data_output_shape, &data_output_tensors[j]));
       } else {
         TF_DALI_CALL(elms = daliNumTensors(&pipe_handle_, i));
@@ -350,15 +362,10 @@ class DaliOp : public tf::OpKernel {
           break;
       }
 
-      // Synchronize with the dataset()->stream_ when doing the last copy, so the outputs
-      // are fully finished before we release the output buffers for reuse.
-      // if the OP runs on the CPU the output memory is not pinned and we don't need to sync
-      unsigned int wait_flag = this->device_type_ != device_type_t::CPU && (i == dali_num_out - 1) ?
-                                  DALI_ext_force_sync :
-                                  DALI_ext_default;
-
       TF_DALI_CALL(
-          daliOutputCopy(&pipe_handle_, dst, i, this->device_type_, stream, wait_flag));
+          daliOutputCopy(&pipe_handle_, dst, i, this->device_type_, stream, DALI_ext_default));
+      // if the OP runs on the CPU the output memory is not pinned and we don't need to sync
+      copied_to_gpu = copied_to_gpu || this->device_type_ != device_type_t::CPU;
       if (should_be_sparse_tensor) {
         ++j;
         // copy out shape
@@ -371,6 +378,11 @@ class DaliOp : public tf::OpKernel {
         }
       }
     }
+    // The copies must be finished before we release the output buffers for reuse.
+    if (copied_to_gpu) {
+      OP_REQUIRES(context, cudaStreamSynchronize(stream) == cudaSuccess,
+                  tf::errors::Internal("Cannot synchronize with the stream of the DALI outputs"));
+    }
     int64_t copy_time =  std::chrono::duration_cast<std::chrono::microseconds>(
                            Clock::now() - s).count();
 
@@ -399,6 +411,7 @@ class DaliOp : public tf::OpKernel {
   device_type_t device_type_;
   std::vector<bool> sparse_;
   bool enable_memory_stats_;
+  std::unique_ptr<TFOutputAllocator> output_allocator_;
 };
 
 using tf::int64;
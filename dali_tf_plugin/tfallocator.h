@@ -1,4 +1,4 @@
-// Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+// Copyright (c) 2017-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,119 +15,108 @@
 #ifndef DALI_TF_PLUGIN_TFALLOCATOR_H_
 #define DALI_TF_PLUGIN_TFALLOCATOR_H_
 
-#include <cstdint>
-#include <memory>
-#include <utility>
+#include <cuda_runtime_api.h>
+#include <mutex>
 #include <unordered_map>
+#include <utility>
 
-#include "tensorflow/core/framework/op_kernel.h"
-#include "tensorflow/core/framework/op.h"
-#include "tensorflow/core/framework/shape_inference.h"
-#include "tensorflow/stream_executor/stream.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
 
-#include "dali/pipeline/data/allocator.h"
-#include "dali/core/common.h"
-#include "dali/c_api.h"
-#include "dali/pipeline/operator/op_spec.h"
-#include "dali/pipeline/data/backend.h"
+#include "dali/core/cuda_error.h"
 
 namespace tf = tensorflow;
 
-namespace dali {
+namespace dali_tf_impl {
 
-class TFGPUAllocator : public GPUAllocator {
+/**
+ * @brief Provides the GPU outputs of a DALI pipeline with the memory of TensorFlow tensors.
+ *
+ * The pipeline writes its outputs directly to the tensors, which can then be returned from
+ * the operator without copying. Pass `Allocate` and `Free` with a pointer to the object
+ * to daliSetOutputAllocator; the object must outlive the pipeline.
+ */
+class TFOutputAllocator {
  public:
-  explicit TFGPUAllocator(const OpSpec &spec) :
-    GPUAllocator(spec),
-    construction_context_(nullptr),
-    context_(nullptr) {}
-  virtual ~TFGPUAllocator() = default;
-
-  void New(void **ptr, size_t bytes) override {
-    LOG_LINE << "[Allocating with TF]\n";
-    std::shared_ptr<tf::PersistentTensor> t = std::make_shared<tf::PersistentTensor>();
-    tf::TensorShape shape;
-    shape.AddDim(bytes);
-    tf::Tensor* unused;
-    tf::Status status;
-    if (context_ == nullptr) {
-      status = construction_context_->allocate_persistent(tf::DT_INT8, shape,
-        t.get(), &unused);
-    } else {
-      status = context_->allocate_persistent(tf::DT_INT8, shape,
-        t.get(), &unused);
-    }
+  explicit TFOutputAllocator(tf::Allocator *allocator) : allocator_(allocator) {
+    CUDA_CALL(cudaEventCreateWithFlags(&event_, cudaEventDisableTiming));
+  }
 
-    if (!status.ok()) {
-      throw status;
-    }
+  ~TFOutputAllocator() {
+    cudaEventDestroy(event_);
+  }
 
-    if (context_ != nullptr) {
-      auto device_context = context_->op_device_context();
-      if (device_context != nullptr) {
-        // Check status in TF way
-        SE_CHECK_OK(device_context->stream()->BlockHostUntilDone());
-      }
-    }
+  TFOutputAllocator(const TFOutputAllocator &) = delete;
+  TFOutputAllocator &operator=(const TFOutputAllocator &) = delete;
 
-    void* data = GetData(t);
-    *ptr = data;
-    allocated_tensors_.insert(std::make_pair(reinterpret_cast<intptr_t>(data), t));
+  /**
+   * @brief Sets the stream in which TensorFlow uses the memory of its tensors.
+   */
+  void SetStream(cudaStream_t stream) {
+    std::lock_guard<std::mutex> guard(mtx_);
+    tf_stream_ = stream;
+    has_stream_ = true;
   }
 
-  void Delete(void *ptr, size_t /* unused */) override {
-    LOG_LINE << "[Deleting with TF]\n";
+  /**
+   * @brief Makes `out` a tensor of given type and shape, which uses the memory at `ptr`, if
+   *        that memory was obtained from this allocator and is large enough.
+   *
+   * @return true, if the tensor was created
+   */
+  bool Adopt(const void *ptr, tf::DataType dtype, const tf::TensorShape &shape, tf::Tensor *out) {
+    size_t bytes = shape.num_elements() * tf::DataTypeSize(dtype);
+    if (!ptr || bytes == 0)
+      return false;
+    std::lock_guard<std::mutex> guard(mtx_);
+    auto it = tensors_.find(ptr);
+    if (it == tensors_.end() || static_cast<size_t>(it->second.NumElements()) < bytes)
+      return false;
+    tf::Tensor data = it->second.Slice(0, bytes);
+    return out->BitcastFrom(data, dtype, shape).ok();
   }
 
-  void UpdateContext(tf::OpKernelConstruction* context) {
-    construction_context_ = context;
+  static void *Allocate(void *context, int output_idx, size_t size, int device_id,
+                        cudaStream_t stream) {
+    auto *self = static_cast<TFOutputAllocator *>(context);
+    tf::Tensor tensor(self->allocator_, tf::DT_INT8,
+                      tf::TensorShape({static_cast<tf::int64>(size)}));
+    if (!tensor.IsInitialized())
+      return nullptr;  // out of memory
+    void *ptr = const_cast<char *>(tensor.tensor_data().data());
+    if (!ptr)
+      return nullptr;
+    std::lock_guard<std::mutex> guard(self->mtx_);
+    // The memory might have been used by TensorFlow before - wait for that work.
+    if (self->has_stream_) {
+      if (cudaEventRecord(self->event_, self->tf_stream_) != cudaSuccess ||
+          cudaStreamWaitEvent(stream, self->event_, 0) != cudaSuccess)
+        return nullptr;
+    } else if (cudaDeviceSynchronize() != cudaSuccess) {
+      return nullptr;
+    }
+    self->tensors_.emplace(ptr, std::move(tensor));
+    return ptr;
   }
 
-  void UpdateContext(tf::OpKernelContext* context) {
-    context_ = context;
+  static void Free(void *context, int output_idx, void *ptr) {
+    auto *self = static_cast<TFOutputAllocator *>(context);
+    std::lock_guard<std::mutex> guard(self->mtx_);
+    // If the memory was returned as an output, the output tensor keeps it alive.
+    self->tensors_.erase(ptr);
   }
 
  private:
-  tf::OpKernelConstruction* construction_context_;
-  tf::OpKernelContext* context_;
-  std::unordered_map<intptr_t, std::shared_ptr<tf::PersistentTensor> > allocated_tensors_;
-
-  void* GetData(std::shared_ptr<tf::PersistentTensor> t) {
-    if (context_ == nullptr) {
-      return const_cast<void*>(
-          reinterpret_cast<const void*>(
-            t->AccessTensor(construction_context_)->tensor_data().data()));
-    } else {
-      return const_cast<void*>(
-          reinterpret_cast<const void*>(
-            t->AccessTensor(context_)->tensor_data().data()));
-    }
-  }
+  tf::Allocator *allocator_;
+  std::mutex mtx_;
+  std::unordered_map<const void *, tf::Tensor> tensors_;
+  cudaEvent_t event_ = nullptr;
+  cudaStream_t tf_stream_ = 0;
+  bool has_stream_ = false;
 };
 
-DALI_DECLARE_OPTYPE_REGISTRY(TFGPUAllocator, TFGPUAllocator);
-
-}  // namespace dali
-
-void SetupTFAllocator(int device_id) {
-  int dev;
-  CUDA_CALL(cudaGetDevice(&dev));
-  CUDA_CALL(cudaSetDevice(device_id));
-  dali::OpSpec spec("TFGPUAllocator");
-  std::unique_ptr<dali::GPUAllocator> allocator(new dali::TFGPUAllocator(spec));
-  dali::SetGPUAllocator(std::move(allocator));
-  CUDA_CALL(cudaSetDevice(dev));
-}
-
-template <typename Ctx>
-void UpdateTFAllocaterContext(Ctx* context, int device_id) {
-  int dev;
-  CUDA_CALL(cudaGetDevice(&dev));
-  CUDA_CALL(cudaSetDevice(device_id));
-  dali::TFGPUAllocator& tfGPUAllocator = dynamic_cast<dali::TFGPUAllocator&>(
-                                                        dali::GetGPUAllocator());
-  tfGPUAllocator.UpdateContext(context);
-  CUDA_CALL(cudaSetDevice(dev));
-}
+}  // namespace dali_tf_impl
 
 #endif  // DALI_TF_PLUGIN_TFALLOCATOR_H_
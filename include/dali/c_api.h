@@ -35,8 +35,11 @@ typedef struct {
   void *ws;
   void *batch_size_map;     /// @see batch_size_map_t
   cudaStream_t copy_stream;  /// Stream to perform copy operations on
+  void *output_handoff;     /// Tracks the outputs referenced by DLPack tensors
 } daliPipelineHandle;
 
+struct DLManagedTensor;
+
 typedef enum {
   CPU = 0,
   GPU = 1
@@ -90,6 +93,69 @@ typedef struct {
   size_t *max_reserved;        // the biggest reserved memory size for the tensor in the batch
 } daliExecutorMetadata;
 
+/*
+ * Need to keep that in sync with OperatorTiming from operator_timing.h
+ */
+typedef struct {
+  char *operator_name;         // operator name, user need to free the memory
+  int64_t num_runs;            // number of the iterations in which the operator ran
+  int64_t num_samples;         // number of the samples processed
+  double host_time;            // wall time of the operator in the executor thread, in seconds
+  int64_t num_gpu_runs;        // number of the runs, in which the device time was measured
+  double gpu_time;             // time of the operator's work in the CUDA stream, in seconds
+} daliOperatorTiming;
+
+/*
+ * Need to keep that in sync with StageTiming from operator_timing.h
+ */
+typedef struct {
+  int64_t num_iterations;      // number of the iterations of the stage
+  int64_t num_samples;         // number of the samples processed
+  double host_time;            // time spent on the iterations, in seconds
+  double wait_time;            // time spent waiting for the buffers, in seconds
+  double mean_queue_occupancy;  // mean number of ready batches in the queue after the stage
+  int max_queue_occupancy;     // maximum number of ready batches in the queue after the stage
+  double elapsed_time;         // time since the first iteration of the pipeline, in seconds
+  double producer_wait;        // time the stage waited for a free buffer of the queue after it
+  double consumer_wait;        // time the consumer of the queue after the stage waited for a batch
+  int64_t num_allocations;     // heap allocations made in the iterations, if counted (see
+                               // BUILD_ALLOCATION_COUNTING)
+  int64_t last_allocations;    // heap allocations made in the last iteration, if counted
+} daliStageTiming;
+
+/*
+ * Need to keep that in sync with BottleneckSummary from operator_timing.h
+ */
+typedef struct {
+  double cpu;                  // fraction of the elapsed time, for which the CPU stage
+  double mixed;                // (the mixed, the GPU stage, the user of the outputs)
+  double gpu;                  // was the limiter of the pipeline
+  double consumer;
+} daliBottleneckSummary;
+
+typedef enum {
+  DALI_MEMORY_POOL_DEVICE = 0,
+  DALI_MEMORY_POOL_PINNED = 1
+} dali_memory_pool_t;
+
+/*
+ * Need to keep that in sync with pool_stats from dali/core/mm/pool_stats.h
+ */
+typedef struct {
+  size_t reserved_bytes;          // memory obtained from the upstream and not returned yet
+  size_t peak_reserved_bytes;
+  size_t allocated_bytes;         // memory allocated from the pool and not freed yet
+  size_t peak_allocated_bytes;
+  size_t free_bytes;              // memory available in the pool without calling the upstream
+  size_t free_blocks;             // number of the free blocks
+  size_t largest_free_block;      // size of the largest free block
+  size_t allocations;             // number of the allocations served by the pool
+  size_t deallocations;
+  size_t upstream_allocations;    // number of the calls to the upstream resource
+  size_t upstream_deallocations;
+  double fragmentation;           // 1 - largest_free_block / free_bytes
+} daliMemoryPoolStats;
+
 /**
  * @brief DALI initialization
  *
@@ -340,6 +406,8 @@ DLL_PUBLIC int daliGetExternalInputNdim(daliPipelineHandle *pipe_handle, const c
 
 /**
  * @brief Start the execution of the pipeline.
+ *
+ * The iteration is only scheduled - the call doesn't wait for it to complete.
  */
 DLL_PUBLIC void daliRun(daliPipelineHandle *pipe_handle);
 
@@ -366,11 +434,153 @@ DLL_PUBLIC void daliOutput(daliPipelineHandle *pipe_handle);
  */
 DLL_PUBLIC void daliShareOutput(daliPipelineHandle *pipe_handle);
 
+/**
+ * @brief Like daliShareOutput, but doesn't wait for the GPU outputs on the host.
+ *
+ * The GPU outputs are ready only for the work issued to `stream` after this call; the host
+ * waits only until the work of the iteration is issued. The buffers of the outputs are reused
+ * by the pipeline after the work issued to `stream` before daliOutputRelease completes, so
+ * the outputs can be consumed asynchronously and released right after the work is issued.
+ */
+DLL_PUBLIC void daliShareOutputAsync(daliPipelineHandle *pipe_handle, cudaStream_t stream);
+
+/**
+ * @brief Non-blocking version of daliShareOutput.
+ *
+ * Shares the outputs of the next iteration, if it's complete, otherwise returns immediately,
+ * leaving the previously shared outputs in place. Together with daliSetOutputReadyCallback,
+ * it lets a single thread (e.g. an event loop) drive many pipelines.
+ *
+ * @return 1, if the outputs were shared, 0 if no iteration is ready yet
+ */
+DLL_PUBLIC int daliTryShareOutput(daliPipelineHandle *pipe_handle);
+
+/**
+ * @brief Called when the outputs of an iteration become ready or when the execution fails
+ *
+ * @param context The context passed to daliSetOutputReadyCallback
+ */
+typedef void (*daliOutputReadyCallback)(void *context);
+
+/**
+ * @brief Sets the function called whenever the outputs of an iteration can be obtained with
+ * daliTryShareOutput without waiting.
+ *
+ * The callback is called from an internal thread of the pipeline (for the GPU pipelines,
+ * as a CUDA host callback), so it must be short and must not call DALI or CUDA - typically, it
+ * signals an event loop (e.g. writes to an eventfd), which then calls daliTryShareOutput until
+ * it returns 0. When the execution fails, it's called as well and daliTryShareOutput
+ * reports the error. The notifications may be spurious.
+ *
+ * Must be called before the pipeline is run, i.e. before daliPrefetchUniform,
+ * daliPrefetchSeparate or daliRun.
+ *
+ * @param pipe_handle Pointer to pipeline handle
+ * @param callback    The function to call; NULL removes the callback
+ * @param context     Passed to `callback`; must remain valid until the pipeline is deleted
+ */
+DLL_PUBLIC void daliSetOutputReadyCallback(daliPipelineHandle *pipe_handle,
+                                           daliOutputReadyCallback callback, void *context);
+
 /**
  * @brief Releases buffer returned by last daliOutput call.
+ *
+ * If DLPack tensors were obtained from the outputs, the buffer is returned to the pipeline when
+ * the last of them is deleted, see daliOutputDLPack.
  */
 DLL_PUBLIC void daliOutputRelease(daliPipelineHandle *pipe_handle);
 
+/**
+ * @brief Allocates device memory for an output of the pipeline.
+ *
+ * @param context     The context passed to daliSetOutputAllocator
+ * @param output_idx  Index of the pipeline output
+ * @param size        Number of bytes to allocate
+ * @param device_id   Device on which the memory is used
+ * @param stream      Stream in which the pipeline writes to the memory; the memory must be ready
+ *                    for use in this stream (if the memory was used before in another stream,
+ *                    `stream` must wait for that work)
+ * @return Pointer to the allocated memory or NULL, if the allocation failed
+ */
+typedef void *(*daliOutputAllocFunc)(void *context, int output_idx, size_t size, int device_id,
+                                     cudaStream_t stream);
+
+/**
+ * @brief Drops the reference of the pipeline to the memory obtained from daliOutputAllocFunc.
+ *
+ * The pipeline doesn't access the memory after this call.
+ *
+ * @param context     The context passed to daliSetOutputAllocator
+ * @param output_idx  Index of the pipeline output
+ * @param ptr         Pointer returned by daliOutputAllocFunc
+ */
+typedef void (*daliOutputFreeFunc)(void *context, int output_idx, void *ptr);
+
+/**
+ * @brief Makes the GPU outputs of the pipeline use the memory provided by the caller
+ * (e.g. the memory of the tensors of a framework), so that they don't need to be copied.
+ *
+ * The memory handed out as an output, see daliOutputData, is not reused by the pipeline:
+ * daliOutputRelease calls `free_fn` for it and the next iterations get new memory from
+ * `alloc_fn`. The caller can keep the memory for as long as it needs.
+ * Call it before the pipeline is run (i.e. before daliPrefetchUniform/daliPrefetchSeparate).
+ *
+ * @param pipe_handle Pointer to pipeline handle
+ * @param alloc_fn    Allocation function; NULL restores the default allocation
+ * @param free_fn     Deallocation function
+ * @param context     Passed to `alloc_fn` and `free_fn`; must remain valid until the pipeline
+ *                    is deleted
+ */
+DLL_PUBLIC void daliSetOutputAllocator(daliPipelineHandle *pipe_handle,
+                                       daliOutputAllocFunc alloc_fn, daliOutputFreeFunc free_fn,
+                                       void *context);
+
+/**
+ * @brief Returns the pointer to the data of the GPU output stored at position `output_idx`,
+ * or NULL for CPU outputs.
+ *
+ * The data is contiguous and valid until daliOutputRelease is called.
+ */
+DLL_PUBLIC const void *daliOutputData(daliPipelineHandle *pipe_handle, int output_idx);
+
+/**
+ * @brief Returns the output stored at position `output_idx` as a DLPack tensor, without copying.
+ *
+ * The output must have a uniform shape and be stored contiguously, see daliOutputHasUniformShape;
+ * the outermost dimension of the tensor is the sample index.
+ *
+ * The tensor shares the memory of the output and keeps it alive until its deleter is called.
+ * The outputs of an iteration are returned to the pipeline only when daliOutputRelease was called
+ * (or the next daliOutput) and all the DLPack tensors obtained from them are deleted, so the
+ * tensors can be handed over to a framework with no copy.
+ * The iterations are returned in order and the pipeline has only as many buffers as its prefetch
+ * queue depth, so keeping the tensors of an iteration for longer stalls the pipeline.
+ * The deleter may be called from any thread, also after the pipeline is deleted.
+ *
+ * The GPU outputs are ready for the host and any stream when daliOutput or daliShareOutput
+ * returns; after daliShareOutputAsync, only for the work issued to its stream.
+ *
+ * @param pipe_handle Pointer to pipeline handle
+ * @param output_idx  Index of the pipeline output
+ * @return The tensor; the caller must call its `deleter`
+ */
+DLL_PUBLIC struct DLManagedTensor *daliOutputDLPack(daliPipelineHandle *pipe_handle,
+                                                    int output_idx);
+
+/**
+ * @brief Returns the sample `sample_idx` of the output stored at position `output_idx` as
+ * a DLPack tensor, without copying.
+ *
+ * The lifetime of the tensor follows the same rules as for daliOutputDLPack.
+ *
+ * @param pipe_handle Pointer to pipeline handle
+ * @param output_idx  Index of the pipeline output
+ * @param sample_idx  Index of the sample in the batch
+ * @return The tensor; the caller must call its `deleter`
+ */
+DLL_PUBLIC struct DLManagedTensor *daliOutputSampleDLPack(daliPipelineHandle *pipe_handle,
+                                                          int output_idx, int sample_idx);
+
 /**
  * @brief Returns 1 if the the output batch stored at position `n` in the pipeline can
  * be represented as dense, uniform tensor. Otherwise 0.
@@ -557,6 +767,72 @@ DLL_PUBLIC void daliGetExecutorMetadata(daliPipelineHandle* pipe_handle,
 DLL_PUBLIC void daliFreeExecutorMetadata(daliExecutorMetadata *operator_meta,
                                          size_t operator_meta_num);
 
+/**
+ * @brief Enables or disables the timing of the operators and the stages of the pipeline
+ *  @see daliGetOperatorTiming, daliGetStageTiming, daliGetBottleneckSummary
+ */
+DLL_PUBLIC void daliEnableOperatorTiming(daliPipelineHandle* pipe_handle, int enable);
+
+/**
+ * @brief Obtains the cumulative timing of the operators, gathered since it was enabled
+ *  @param timing Pointer to the memory allocated by the function with timing_num entries.
+ *                To free it use `daliFreeOperatorTiming` function
+ *  @param timing_num Pointer to the variable which will tell how many entries (operators)
+ *                    have been filled
+ */
+DLL_PUBLIC void daliGetOperatorTiming(daliPipelineHandle* pipe_handle,
+                                      daliOperatorTiming **timing, size_t *timing_num);
+
+/**
+ * @brief Frees the operator timing obtained from daliGetOperatorTiming
+ */
+DLL_PUBLIC void daliFreeOperatorTiming(daliOperatorTiming *timing, size_t timing_num);
+
+/**
+ * @brief Obtains the cumulative timing of a stage of the pipeline, gathered since the timing
+ *        was enabled
+ *  @param stage The stage - DALI_BACKEND_CPU, DALI_BACKEND_MIXED or DALI_BACKEND_GPU
+ *  @param timing Pointer to the timing to be filled by the function
+ */
+DLL_PUBLIC void daliGetStageTiming(daliPipelineHandle* pipe_handle, dali_backend_t stage,
+                                   daliStageTiming *timing);
+
+/**
+ * @brief Obtains the fractions of the time, for which each of the stages and the user of
+ *        the outputs limited the throughput of the pipeline, since the timing was enabled
+ *  @param summary Pointer to the summary to be filled by the function
+ */
+DLL_PUBLIC void daliGetBottleneckSummary(daliPipelineHandle* pipe_handle,
+                                         daliBottleneckSummary *summary);
+
+/**
+ * @brief Obtains the statistics of the default memory pool
+ *  @param pool Kind of the pool to query
+ *  @param device_id Device index; if negative, current device is used. For the pinned memory,
+ *                   the pool used with given device is queried.
+ *  @param stats Pointer to the statistics to be filled by the function
+ *  @return 1 if the statistics were obtained, 0 if the default resource is not a memory pool
+ */
+DLL_PUBLIC int daliGetMemoryPoolStats(dali_memory_pool_t pool, int device_id,
+                                      daliMemoryPoolStats *stats);
+
+/**
+ * @brief Sets the peak values in the statistics of the default memory pool to the current ones
+ *  @see daliGetMemoryPoolStats
+ */
+DLL_PUBLIC void daliResetMemoryPoolPeakStats(dali_memory_pool_t pool, int device_id);
+
+/**
+ * @brief Returns the free memory of the default memory pool to the system, until at most
+ *        `keep_bytes` stay reserved by the pool
+ *
+ * Only the memory which is entirely free can be released. Waits for the memory freed in
+ * CUDA streams to become available.
+ *  @see daliGetMemoryPoolStats
+ *  @return The number of bytes released
+ */
+DLL_PUBLIC size_t daliTrimMemoryPool(dali_memory_pool_t pool, int device_id, size_t keep_bytes);
+
 #ifdef __cplusplus
 }
 #endif
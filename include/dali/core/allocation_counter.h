@@ -0,0 +1,55 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_ALLOCATION_COUNTER_H_
+#define DALI_CORE_ALLOCATION_COUNTER_H_
+
+#include <cstdint>
+#include "dali/core/api_helper.h"
+
+namespace dali {
+
+/**
+ * @brief Whether DALI was built with the heap allocation counting (BUILD_ALLOCATION_COUNTING)
+ *
+ * The counting replaces the global operator new, so it's meant for debugging only.
+ */
+DLL_PUBLIC bool AllocationCountingEnabled();
+
+/**
+ * @brief The number of the heap allocations (the calls to the global operator new) made by
+ *        the calling thread so far; always 0 if the counting is not enabled
+ */
+DLL_PUBLIC int64_t ThreadAllocationCount();
+
+/**
+ * @brief Counts the heap allocations made by the calling thread since the object was created
+ *
+ * The allocations made by other threads - e.g. the jobs of a thread pool - are not counted.
+ */
+class AllocationCounter {
+ public:
+  AllocationCounter() : start_(ThreadAllocationCount()) {}
+
+  int64_t count() const {
+    return ThreadAllocationCount() - start_;
+  }
+
+ private:
+  int64_t start_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_CORE_ALLOCATION_COUNTER_H_
@@ -0,0 +1,46 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_CUDA_PEER_ACCESS_H_
+#define DALI_CORE_CUDA_PEER_ACCESS_H_
+
+#include <cuda_runtime_api.h>
+#include <cstddef>
+#include "dali/core/api_helper.h"
+
+namespace dali {
+
+/**
+ * @brief Enables the access from `device` to the memory of `peer`, if the devices support it
+ *
+ * The result is cached - the access is enabled once per pair of devices in the process.
+ *
+ * @return true, if `device` can access the memory of `peer` directly (e.g. over NVLink);
+ *         a device can always access its own memory
+ */
+DLL_PUBLIC bool EnablePeerAccess(int device, int peer);
+
+/**
+ * @brief Copies memory between devices, in stream order
+ *
+ * The copy goes directly between the devices when they support the peer access (which is
+ * enabled on first use), otherwise it is staged through the host.
+ * The stream should belong to `dst_device`.
+ */
+DLL_PUBLIC void CopyPeer(void *dst, int dst_device, const void *src, int src_device, size_t bytes,
+                         cudaStream_t stream);
+
+}  // namespace dali
+
+#endif  // DALI_CORE_CUDA_PEER_ACCESS_H_
@@ -36,11 +36,12 @@ class DLL_PUBLIC CUDAStreamPool {
    *
    * @param device_id   CUDA runtime API device ordinal. If negative, calling thread's
    *                    current device is used.
+   * @param priority    The priority of the stream, see cudaStreamCreateWithPriority
    *
-   * @return A CUDA stream wrapper object. If there were any streams in the pools, the
-   *         stream is taken from it, otherwise a new stream is created.
+   * @return A CUDA stream wrapper object. If there were any streams of this priority in
+   *         the pool, the stream is taken from it, otherwise a new stream is created.
    */
-  CUDAStreamLease Get(int device_id = -1);
+  CUDAStreamLease Get(int device_id = -1, int priority = 0);
 
   /**
    * @brief Places a stream for given device in the pool.
@@ -49,6 +50,8 @@ class DLL_PUBLIC CUDAStreamPool {
    *                  created. If negative, the device is obtained from the device context
    *                  associated with the stream.
    *
+   * The stream is returned by the subsequent calls to Get with the priority of the stream.
+   *
    * @remarks It is an error to misstate the device_id. Placing a stream with improper device_id
    *          will render the stream pool unusable.
    */
@@ -77,13 +80,14 @@ class DLL_PUBLIC CUDAStreamPool {
 
   void Init();
 
-  CUDAStream GetFromPool(int device_id);
+  CUDAStream GetFromPool(int device_id, int priority);
 
   struct StreamEntry {
     StreamEntry() = default;
-    explicit StreamEntry(CUDAStream stream, StreamEntry *next = nullptr)
-    : stream(std::move(stream)), next(next) {}
+    explicit StreamEntry(CUDAStream stream, int priority = 0, StreamEntry *next = nullptr)
+    : stream(std::move(stream)), priority(priority), next(next) {}
     CUDAStream stream;
+    int priority = 0;
     StreamEntry *next = nullptr;
   };
 
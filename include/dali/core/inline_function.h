@@ -0,0 +1,168 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_INLINE_FUNCTION_H_
+#define DALI_CORE_INLINE_FUNCTION_H_
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dali {
+
+template <typename Signature, size_t Capacity = 64>
+class InlineFunction;
+
+/**
+ * @brief A move-only replacement of std::function, which stores the callables of up to
+ *        `Capacity` bytes in the object itself
+ *
+ * std::function allocates the callables which exceed its (implementation-defined, usually 16 B)
+ * small buffer - e.g. most of the lambdas capturing a few references. InlineFunction stores
+ * such callables in place, so that creating, moving and calling it doesn't touch the heap.
+ * The callables which are larger, overaligned or not nothrow-movable are still allocated.
+ *
+ * Not being copyable, InlineFunction also accepts move-only callables.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+ public:
+  InlineFunction() noexcept = default;
+  InlineFunction(std::nullptr_t) noexcept {}  // NOLINT(runtime/explicit)
+
+  template <typename F,
+            typename = std::enable_if_t<!std::is_same<std::decay_t<F>, InlineFunction>::value>>
+  InlineFunction(F &&f) {  // NOLINT(runtime/explicit)
+    using Fn = std::decay_t<F>;
+    if constexpr (is_inline<Fn>()) {
+      new (&storage_) Fn(std::forward<F>(f));
+    } else {
+      *reinterpret_cast<Fn **>(&storage_) = new Fn(std::forward<F>(f));
+    }
+    ops_ = &ops<Fn>;
+  }
+
+  InlineFunction(InlineFunction &&other) noexcept {
+    MoveFrom(other);
+  }
+
+  InlineFunction &operator=(InlineFunction &&other) noexcept {
+    if (this != &other) {
+      reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  InlineFunction &operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+
+  ~InlineFunction() {
+    reset();
+  }
+
+  void reset() noexcept {
+    if (ops_) {
+      ops_->destroy(&storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  explicit operator bool() const noexcept {
+    return ops_ != nullptr;
+  }
+
+  R operator()(Args... args) const {
+    if (!ops_)
+      throw std::bad_function_call();
+    return ops_->invoke(&storage_, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Whether the callable of type F is stored in place, without allocating it
+   */
+  template <typename F>
+  static constexpr bool is_inline() {
+    return sizeof(F) <= Capacity && alignof(F) <= alignof(Storage) &&
+           std::is_nothrow_move_constructible<F>::value;
+  }
+
+ private:
+  using Storage = std::aligned_storage_t<(Capacity < sizeof(void *) ? sizeof(void *) : Capacity),
+                                         alignof(std::max_align_t)>;
+
+  struct Ops {
+    R (*invoke)(void *storage, Args &&...args);
+    // move-constructs the callable in `dst` and destroys the one in `src`
+    void (*relocate)(void *dst, void *src) noexcept;
+    void (*destroy)(void *storage) noexcept;
+  };
+
+  template <typename F>
+  static F *get(void *storage) {
+    if constexpr (is_inline<F>())
+      return std::launder(reinterpret_cast<F *>(storage));
+    else
+      return *reinterpret_cast<F **>(storage);
+  }
+
+  template <typename F>
+  static R Invoke(void *storage, Args &&...args) {
+    if constexpr (std::is_void<R>::value)
+      (*get<F>(storage))(std::forward<Args>(args)...);  // the result, if any, is discarded
+    else
+      return (*get<F>(storage))(std::forward<Args>(args)...);
+  }
+
+  template <typename F>
+  static void Relocate(void *dst, void *src) noexcept {
+    if constexpr (is_inline<F>()) {
+      F *f = get<F>(src);
+      new (dst) F(std::move(*f));
+      f->~F();
+    } else {
+      *reinterpret_cast<F **>(dst) = get<F>(src);
+    }
+  }
+
+  template <typename F>
+  static void Destroy(void *storage) noexcept {
+    if constexpr (is_inline<F>())
+      get<F>(storage)->~F();
+    else
+      delete get<F>(storage);
+  }
+
+  template <typename F>
+  static constexpr Ops ops = { &Invoke<F>, &Relocate<F>, &Destroy<F> };
+
+  void MoveFrom(InlineFunction &other) noexcept {
+    if (other.ops_) {
+      other.ops_->relocate(&storage_, &other.storage_);
+      ops_ = other.ops_;
+      other.ops_ = nullptr;
+    }
+  }
+
+  mutable Storage storage_;
+  const Ops *ops_ = nullptr;
+};
+
+}  // namespace dali
+
+#endif  // DALI_CORE_INLINE_FUNCTION_H_
@@ -22,6 +22,7 @@
 #include <vector>
 #include "dali/core/mm/pool_resource.h"
 #include "dali/core/mm/detail/free_list.h"
+#include "dali/core/mm/pool_stats.h"
 #include "dali/core/small_vector.h"
 #include "dali/core/cuda_event_pool.h"
 #include "dali/core/cuda_stream.h"
@@ -38,17 +39,19 @@ template <typename Kind,
     typename GlobalPool = pool_resource_base<Kind, coalescing_free_tree, spinlock>,
     typename LockType = std::mutex,
     typename Upstream = memory_resource<Kind>>
-class async_pool_resource : public async_memory_resource<Kind> {
+class async_pool_resource : public async_memory_resource<Kind>, public pool_stats_provider {
  public:
   /**
    * @param upstream       Upstream resource, used by the global pool
    * @param avoid_upstream If true, synchronize with outstanding deallocations before
    *                       using upstream.
+   * @param options        Options of the global pool
    */
   template <typename P = GlobalPool,
             typename = std::enable_if_t<std::is_constructible<P, Upstream*, pool_options>::value>>
-  explicit async_pool_resource(Upstream *upstream, bool avoid_upstream = true)
-  : global_pool_(upstream, global_pool_options()), avoid_upstream_(avoid_upstream) {
+  explicit async_pool_resource(Upstream *upstream, bool avoid_upstream = true,
+                               const pool_options &options = global_pool_options())
+  : global_pool_(upstream, options), avoid_upstream_(avoid_upstream) {
     CUDAEventPool::instance();
   }
 
@@ -101,6 +104,48 @@ class async_pool_resource : public async_memory_resource<Kind> {
     synchronize_impl(true);
   }
 
+  /**
+   * @brief Returns the statistics of the global pool, with the allocations counted
+   *        at the level of this resource.
+   *
+   * The memory deallocated on a stream and not returned to the global pool yet is reported
+   * as free.
+   */
+  pool_stats get_stats() const override {
+    std::lock_guard<LockType> guard(lock_);
+    pool_stats stats = global_pool_.get_stats();
+    stats.allocated_bytes = stats_.allocated_bytes;
+    stats.peak_allocated_bytes = stats_.peak_allocated_bytes;
+    stats.allocations = stats_.allocations;
+    stats.deallocations = stats_.deallocations;
+    for (auto &kv : stream_free_) {
+      for (auto &size_pending : kv.second.by_size)
+        stats.free.add_block(size_pending.first);
+    }
+    return stats;
+  }
+
+  void reset_peak_stats() override {
+    std::lock_guard<LockType> guard(lock_);
+    global_pool_.reset_peak_stats();
+    stats_.peak_allocated_bytes = stats_.allocated_bytes;
+  }
+
+  /**
+   * @brief Waits for the pending per-stream frees, moves them to the global pool and returns
+   *        the unused memory of the global pool to the upstream, until at most `keep_bytes`
+   *        stay reserved.
+   */
+  size_t trim(size_t keep_bytes) override {
+    std::lock_guard<LockType> guard(lock_);
+    if (num_pending_frees_ > 0) {
+      synchronize_impl(false);
+      for (auto &kv : stream_free_)
+        free_ready(kv.second);
+    }
+    return global_pool_.trim(keep_bytes);
+  }
+
  private:
   void synchronize_impl(bool lock) {
     {
@@ -126,7 +171,10 @@ class async_pool_resource : public async_memory_resource<Kind> {
   void *do_allocate(size_t bytes, size_t alignment) override {
     adjust_size_and_alignment(bytes, alignment, true);
     std::lock_guard<LockType> guard(lock_);
-    return allocate_from_global_pool(bytes, alignment);
+    void *ptr = allocate_from_global_pool(bytes, alignment);
+    if (ptr)
+      stat_add_allocation(bytes);
+    return ptr;
   }
 
   void do_deallocate(void *mem, size_t bytes, size_t alignment) override {
@@ -134,6 +182,7 @@ class async_pool_resource : public async_memory_resource<Kind> {
       return;
     adjust_size_and_alignment(bytes, alignment, false);
     std::lock_guard<LockType> guard(lock_);
+    stat_add_deallocation(bytes);
     char *ptr = static_cast<char *>(mem);
     pop_block_padding(ptr, bytes, alignment);
     global_pool_.deallocate(ptr, bytes, alignment);
@@ -156,13 +205,13 @@ class async_pool_resource : public async_memory_resource<Kind> {
     adjust_size_and_alignment(bytes, alignment, true);
     std::lock_guard<LockType> guard(lock_);
     auto it = stream_free_.find(stream.get());
-    void *ptr;
-    if (it != stream_free_.end()) {
+    void *ptr = nullptr;
+    if (it != stream_free_.end())
       ptr = try_allocate(it->second, bytes, alignment);
-      if (ptr)
-        return ptr;
-    }
-    return allocate_from_global_pool(bytes, alignment);
+    if (!ptr)
+      ptr = allocate_from_global_pool(bytes, alignment);
+    stat_add_allocation(bytes);
+    return ptr;
   }
 
   /**
@@ -194,8 +243,17 @@ class async_pool_resource : public async_memory_resource<Kind> {
         free_ready(kv.second);
     }
     // Finally, allocate from the global pool, this time allowing fallback to the upstream.
-    ptr = global_pool_.allocate(bytes, alignment);
-    return ptr;
+    if (num_pending_frees_ == 0)
+      return global_pool_.allocate(bytes, alignment);
+    try {
+      return global_pool_.allocate(bytes, alignment);
+    } catch (const std::bad_alloc &) {
+      // Out of memory - as a last resort, wait for the pending frees and try again.
+      synchronize_impl(false);
+      for (auto &kv : stream_free_)
+        free_ready(kv.second);
+    }
+    return global_pool_.allocate(bytes, alignment);
   }
 
   void do_deallocate_async(void *mem, size_t bytes, size_t alignment, stream_view stream) override {
@@ -211,11 +269,25 @@ class async_pool_resource : public async_memory_resource<Kind> {
     CUDA_CALL(cudaEventRecord(event, stream.get()));
 
     std::lock_guard<LockType> guard(lock_);
+    stat_add_deallocation(bytes);
     char *ptr = static_cast<char*>(mem);
     pop_block_padding(ptr, bytes, alignment);
     deallocate_async_impl(stream_free_[stream.get()], ptr, bytes, alignment, ctx, std::move(event));
   }
 
+  // the statistics are guarded by lock_
+  void stat_add_allocation(size_t bytes) {
+    stats_.allocations++;
+    stats_.allocated_bytes += bytes;
+    stats_.peak_allocated_bytes = std::max(stats_.peak_allocated_bytes, stats_.allocated_bytes);
+  }
+
+  void stat_add_deallocation(size_t bytes) {
+    stats_.deallocations++;
+    assert(stats_.allocated_bytes >= bytes);
+    stats_.allocated_bytes -= bytes;
+  }
+
   /**
    * @brief Increases minimum alignment based on size and quantizes the size to a multiple
    *        of the alignment.
@@ -524,7 +596,7 @@ class async_pool_resource : public async_memory_resource<Kind> {
 
   using FreeDescAlloc = detail::object_pool_allocator<pending_free>;
 
-  LockType lock_;
+  mutable LockType lock_;
   vector<CUDAStream> sync_streams_;
   CUDAStream &GetSyncStream(int device_id) {
     int ndev = sync_streams_.size();
@@ -585,6 +657,8 @@ class async_pool_resource : public async_memory_resource<Kind> {
 
   int num_pending_frees_ = 0;
   bool avoid_upstream_ = true;
+  /// Only the allocation counters are used; the rest comes from the global pool
+  pool_stats stats_;
 };
 
 }  // namespace mm
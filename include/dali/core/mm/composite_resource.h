@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -20,6 +20,7 @@
 #include <tuple>
 #include <utility>
 #include "dali/core/mm/memory_resource.h"
+#include "dali/core/mm/pool_stats.h"
 
 namespace dali {
 namespace mm {
@@ -102,6 +103,29 @@ class CompositeResourceImpl<async_memory_resource<Kind>, Resource, Extra...>
   }
 };
 
+/**
+ * @brief Exposes the pool statistics of the inner resource, if it provides them
+ */
+template <typename Composite, typename Resource,
+          bool has_stats = std::is_base_of<pool_stats_provider, Resource>::value>
+class CompositeStatsForwarder {};
+
+template <typename Composite, typename Resource>
+class CompositeStatsForwarder<Composite, Resource, true> : public pool_stats_provider {
+ public:
+  pool_stats get_stats() const override {
+    return static_cast<const Composite *>(this)->resource->get_stats();
+  }
+
+  void reset_peak_stats() override {
+    static_cast<Composite *>(this)->resource->reset_peak_stats();
+  }
+
+  size_t trim(size_t keep_bytes) override {
+    return static_cast<Composite *>(this)->resource->trim(keep_bytes);
+  }
+};
+
 }  // namespace detail
 
 /**
@@ -113,11 +137,15 @@ class CompositeResourceImpl<async_memory_resource<Kind>, Resource, Extra...>
  */
 template <typename Resource, typename... Extra>
 class CompositeResource
-: public detail::CompositeResourceImpl<detail::resource_interface_t<Resource>, Resource, Extra...> {
+: public detail::CompositeResourceImpl<detail::resource_interface_t<Resource>, Resource, Extra...>
+, public detail::CompositeStatsForwarder<CompositeResource<Resource, Extra...>, Resource> {
  public:
   using interface_type = detail::resource_interface_t<Resource>;
   using Base = detail::CompositeResourceImpl<interface_type, Resource, Extra...>;
   using Base::Base;
+
+ private:
+  friend class detail::CompositeStatsForwarder<CompositeResource, Resource>;
 };
 
 
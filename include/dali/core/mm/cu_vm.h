@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,7 +16,9 @@
 #define DALI_CORE_MM_CU_VM_H_
 
 #include <cuda.h>
-#include <utility>  // This should be in ifdef, but cpplint can't see it there
+#include <new>      // These should be in ifdef, but cpplint can't see them there
+#include <utility>
+#include <vector>
 #if CUDA_VERSION >= 10020
 #define DALI_USE_CUDA_VM_MAP 1
 
@@ -256,6 +258,98 @@ inline void Unmap(const void *ptr, size_t size) {
   Unmap(reinterpret_cast<CUdeviceptr>(ptr), size);
 }
 
+/**
+ * @brief A virtual address range with physical memory mapped on demand, starting from
+ *        the beginning of the range.
+ *
+ * Growing maps new physical memory after the memory mapped so far - the address doesn't change
+ * and the contents are preserved without copying. Shrinking unmaps and releases the memory at
+ * the end of the range; the memory is mapped in chunks and only whole chunks are released.
+ *
+ * The caller must make sure that the memory is not in use when it's unmapped.
+ */
+class GrowableMapping {
+ public:
+  /**
+   * @param max_size        The size of the virtual address range - the mapping cannot grow
+   *                        beyond it
+   * @param device_ordinal  The device on which the physical memory is allocated;
+   *                        -1 means the current device
+   */
+  explicit GrowableMapping(size_t max_size, int device_ordinal = -1)
+  : va_(CUMemAddressRange::Reserve(max_size)), device_ordinal_(device_ordinal) {
+    if (device_ordinal_ < 0)
+      CUDA_CALL(cudaGetDevice(&device_ordinal_));
+  }
+
+  ~GrowableMapping() {
+    while (!chunks_.empty()) {
+      size_t chunk_size = chunks_.back().size();
+      CUDA_DTOR_CALL(cuMemUnmap(va_.ptr() + mapped_ - chunk_size, chunk_size));
+      mapped_ -= chunk_size;
+      chunks_.pop_back();
+    }
+  }
+
+  GrowableMapping(const GrowableMapping &) = delete;
+  GrowableMapping &operator=(const GrowableMapping &) = delete;
+
+  void *ptr() const noexcept {
+    return reinterpret_cast<void *>(va_.ptr());
+  }
+
+  /// The size of the virtual address range
+  size_t max_size() const noexcept {
+    return va_.size();
+  }
+
+  /// The size of the mapped memory; a multiple of the allocation granularity
+  size_t size() const noexcept {
+    return mapped_;
+  }
+
+  int device_ordinal() const noexcept {
+    return device_ordinal_;
+  }
+
+  /**
+   * @brief Tells whether resizing to `size` would unmap any memory.
+   */
+  bool would_unmap(size_t size) const noexcept {
+    return !chunks_.empty() && mapped_ - chunks_.back().size() >= size;
+  }
+
+  /**
+   * @brief Maps or unmaps the memory, so that at least `size` bytes are mapped.
+   *
+   * When shrinking, the mapped size may stay larger than `size`, up to the size of the last
+   * chunk that's still needed.
+   */
+  void resize(size_t size) {
+    if (size > max_size())
+      throw std::bad_alloc();
+    if (size > mapped_) {
+      auto mem = CUMem::Create(size - mapped_, device_ordinal_);
+      Map(va_.ptr() + mapped_, mem.handle(), mem.size());
+      mapped_ += mem.size();
+      chunks_.push_back(std::move(mem));
+    } else {
+      while (!chunks_.empty() && mapped_ - chunks_.back().size() >= size) {
+        size_t chunk_size = chunks_.back().size();
+        Unmap(va_.ptr() + mapped_ - chunk_size, chunk_size);
+        mapped_ -= chunk_size;
+        chunks_.pop_back();
+      }
+    }
+  }
+
+ private:
+  CUMemAddressRange va_;
+  std::vector<CUMem> chunks_;  // mapped one after another, from the beginning of the range
+  size_t mapped_ = 0;
+  int device_ordinal_ = -1;
+};
+
 
 }  // namespace cuvm
 }  // namespace mm
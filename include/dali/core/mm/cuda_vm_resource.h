@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -30,6 +30,7 @@
 #include "dali/core/spinlock.h"
 #include "dali/core/mm/memory_resource.h"
 #include "dali/core/mm/detail/free_list.h"
+#include "dali/core/mm/pool_stats.h"
 #include "dali/core/small_vector.h"
 
 namespace dali {
@@ -39,7 +40,8 @@ namespace test {
 class VMResourceTest;
 }  // namespace test
 
-class cuda_vm_resource : public memory_resource<memory_kind::device> {
+class cuda_vm_resource : public memory_resource<memory_kind::device>,
+                         public pool_stats_provider {
  public:
   explicit cuda_vm_resource(int device_ordinal = -1,
                             size_t block_size = 0,
@@ -83,6 +85,7 @@ class cuda_vm_resource : public memory_resource<memory_kind::device> {
     size_t total_allocations;
     size_t total_deallocations;
     size_t total_unmaps;
+    size_t released_blocks;
   };
 
   size_t block_size() const noexcept {
@@ -103,6 +106,66 @@ class cuda_vm_resource : public memory_resource<memory_kind::device> {
     stat_ = {};
   }
 
+  /**
+   * @brief Returns the statistics of the pool
+   *
+   * The reserved memory is the physical memory mapped by the resource; the free memory is
+   * the part of it which is not allocated.
+   */
+  pool_stats get_stats() const override {
+    lock_guard pool_guard(pool_lock_);
+    pool_stats stats;
+    stats.reserved_bytes = stat_.allocated_blocks * block_size_;
+    stats.peak_reserved_bytes = stat_.peak_allocated_blocks * block_size_;
+    stats.allocated_bytes = stat_.curr_allocated;
+    stats.peak_allocated_bytes = stat_.peak_allocated;
+    stats.free = free_mapped_.space_stats();
+    stats.allocations = stat_.total_allocations;
+    stats.deallocations = stat_.total_deallocations;
+    // the physical blocks are released only by trim or when the resource is destroyed
+    stats.upstream_allocations = stat_.allocated_blocks + stat_.released_blocks;
+    stats.upstream_deallocations = stat_.released_blocks;
+    return stats;
+  }
+
+  void reset_peak_stats() override {
+    lock_guard pool_guard(pool_lock_);
+    stat_.peak_allocated = stat_.curr_allocated;
+    stat_.peak_allocations = stat_.curr_allocations;
+    stat_.peak_allocated_blocks = stat_.allocated_blocks;
+  }
+
+  /**
+   * @brief Unmaps and releases the physical blocks which are completely free, until at most
+   *        `keep_bytes` of physical memory stay mapped
+   *
+   * The virtual address space is kept - the blocks are mapped again when needed.
+   */
+  size_t trim(size_t keep_bytes) override {
+    lock_guard pool_guard(pool_lock_);
+    mem_lock_guard mem_guard(mem_lock_);
+    DeviceGuard dg(device_ordinal_);
+    size_t released = 0;
+    for (va_region &r : va_regions_) {
+      for (int block_idx = r.available.find(true);
+           block_idx < r.num_blocks();
+           block_idx = r.available.find(true, block_idx + 1)) {
+        if (stat_.allocated_blocks * block_size_ <= keep_bytes)
+          return released;
+        char *block_ptr = r.block_ptr<char>(block_idx);
+        free_mapped_.get_specific_block(block_ptr, block_size_);
+        stat_take_free(block_size_);
+        // the memory is released when the handle goes out of scope
+        cuvm::CUMem mem = r.unmap_block(block_idx);
+        stat_.total_unmaps++;
+        stat_.allocated_blocks--;
+        stat_.released_blocks++;
+        released += block_size_;
+      }
+    }
+    return released;
+  }
+
   void dump_stats(std::ostream &os) {
     print(os, "cuda_vm_resource stat dump:",
       "\ntotal VM size:         ", stat_.allocated_va,
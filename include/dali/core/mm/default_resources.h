@@ -1,4 +1,4 @@
-// Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -19,6 +19,8 @@
 #include <memory>
 #include "dali/core/api_helper.h"
 #include "dali/core/mm/memory_resource.h"
+#include "dali/core/mm/pool_stats.h"
+#include "dali/core/mm/quota_resource.h"
 
 namespace dali {
 namespace mm {
@@ -95,6 +97,93 @@ std::shared_ptr<device_async_resource> ShareDefaultDeviceResource(int device_id
 DLL_PUBLIC
 device_async_resource *GetDefaultDeviceResource(int device_id = -1);
 
+/**
+ * @brief Gets a shared pointer to a pinned memory resource suitable for use with given device.
+ *
+ * On multi-socket systems, the memory is allocated on the NUMA node closest to the device, so
+ * that the host-to-device transfers don't cross the inter-socket link. On single-node systems,
+ * if the NUMA placement is disabled with DALI_USE_NUMA_PINNED_MEM=0 or if the default pinned
+ * resource was replaced by the user, the default pinned memory resource is returned.
+ *
+ * @param device_id Device index; if negative, current device is used.
+ */
+DLL_PUBLIC
+std::shared_ptr<pinned_async_resource> ShareDefaultPinnedResource(int device_id = -1);
+
+/**
+ * @brief Gets a pinned memory resource suitable for use with given device.
+ *
+ * @see ShareDefaultPinnedResource
+ *
+ * @param device_id Device index; if negative, current device is used.
+ */
+DLL_PUBLIC
+pinned_async_resource *GetDefaultPinnedResource(int device_id = -1);
+
+/**
+ * @brief Gets the statistics interface of the default device memory pool.
+ *
+ * @param device_id Device index; if negative, current device is used.
+ * @return The statistics provider or nullptr, if the default device resource is not a pool
+ *         (e.g. DALI_USE_DEVICE_MEM_POOL=0 or a user-supplied resource).
+ */
+DLL_PUBLIC
+pool_stats_provider *GetDefaultDevicePoolStats(int device_id = -1);
+
+/**
+ * @brief Gets the statistics interface of the default pinned memory pool used with given device.
+ *
+ * @see GetDefaultPinnedResource
+ *
+ * @param device_id Device index; if negative, current device is used.
+ * @return The statistics provider or nullptr, if the pinned memory resource is not a pool.
+ */
+DLL_PUBLIC
+pool_stats_provider *GetDefaultPinnedPoolStats(int device_id = -1);
+
+/**
+ * @brief The huge page usage of the default pinned memory pools
+ */
+struct pinned_huge_page_stats {
+  /// The size of the huge pages requested with DALI_PINNED_HUGEPAGES; 0, if they are not used
+  size_t huge_page_size = 0;
+  /// The total number of bytes obtained from the OS with huge pages
+  size_t huge_page_bytes = 0;
+  /// The total number of bytes obtained from the OS with regular pages, because huge pages
+  /// couldn't be obtained
+  size_t fallback_bytes = 0;
+};
+
+/**
+ * @brief Gets the huge page usage of the default pinned memory pools.
+ *
+ * When DALI_PINNED_HUGEPAGES is set to a huge page size (e.g. 2M or 1G), the pinned memory pools
+ * obtain their memory with huge pages, falling back to regular pages when the system has no
+ * huge pages of that size available. This function tells how much memory was actually obtained
+ * either way; the memory of the pools which were already destroyed is not counted.
+ */
+DLL_PUBLIC
+pinned_huge_page_stats GetPinnedHugePageStats();
+
+/**
+ * @brief Creates a resource which allocates from the default device memory resource and tracks
+ *        the usage of one of its clients (e.g. a pipeline) against the client's limits.
+ *
+ * The clients of the same device share the default resource (the pool), so the memory freed by
+ * one of them can be reused by the others. The quota resource is kept alive until all the memory
+ * allocated through it is freed, even if the client drops its pointer earlier.
+ *
+ * @param device_id   Device index; if negative, current device is used.
+ * @param soft_limit  The usage above which the client is expected to release the memory it
+ *                    doesn't need; 0 means no limit.
+ * @param hard_limit  The usage which cannot be exceeded - the allocations fail with
+ *                    `quota_exceeded`; 0 means no limit.
+ */
+DLL_PUBLIC
+std::shared_ptr<device_quota_resource> CreateDeviceQuotaResource(int device_id,
+                                                                 size_t soft_limit,
+                                                                 size_t hard_limit = 0);
+
 /**
  * @brief Sets the default device memory resource for a specific device,
  *        optionally granting ownership.
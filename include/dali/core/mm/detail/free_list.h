@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -24,6 +24,7 @@
 #include "dali/core/mm/detail/align.h"
 #include "dali/core/mm/detail/aux_alloc.h"
 #include "dali/core/mm/detail/aux_collections.h"
+#include "dali/core/mm/pool_stats.h"
 
 namespace dali {
 namespace mm {
@@ -247,6 +248,16 @@ class best_fit_free_list {
     return false;
   }
 
+  /**
+   * @brief Describes the free blocks in the list; takes linear time.
+   */
+  free_space_stats space_stats() const {
+    free_space_stats stats;
+    for (block *b = head_; b; b = b->next)
+      stats.add_block(b->end - b->start);
+    return stats;
+  }
+
  protected:
   /**
    * @brief Recycle an unused block descriptor or create a new one.
@@ -673,6 +684,19 @@ class coalescing_free_tree {
     }
   }
 
+  /**
+   * @brief Describes the free blocks in the tree; takes linear time.
+   */
+  free_space_stats space_stats() const {
+    free_space_stats stats;
+    for (auto &blk : by_addr_)
+      stats.bytes += blk.second;
+    stats.blocks = by_addr_.size();
+    if (!by_size_.empty())
+      stats.largest_block = by_size_.rbegin()->first;
+    return stats;
+  }
+
  protected:
   detail::pooled_map<char *, size_t, true> by_addr_;
   detail::pooled_set<std::pair<size_t, char *>, true> by_size_;
@@ -782,6 +806,19 @@ class best_fit_free_tree {
     return get_specific_block(base, size) != nullptr;
   }
 
+  /**
+   * @brief Describes the free blocks in the tree; takes linear time.
+   */
+  free_space_stats space_stats() const {
+    free_space_stats stats;
+    for (auto &blk : by_addr_)
+      stats.bytes += blk.second;
+    stats.blocks = by_addr_.size();
+    if (!by_size_.empty())
+      stats.largest_block = by_size_.rbegin()->first;
+    return stats;
+  }
+
   detail::pooled_set<std::pair<size_t, char *>, true> by_size_;
   detail::pooled_map<char *, size_t, true> by_addr_;
   detail::pooled_map<char *, std::pair<char *, size_t>, true> original_;
@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -17,9 +17,18 @@
 
 #include <stdlib.h>
 #include <malloc.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <atomic>
 #include "dali/core/mm/memory_resource.h"
 #include "dali/core/cuda_error.h"
 #include "dali/core/mm/detail/align.h"
+#include "dali/core/os/numa.h"
+#include "dali/core/util.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
 
 namespace dali {
 namespace mm {
@@ -140,6 +149,136 @@ class pinned_malloc_memory_resource : public pinned_async_resource {
   }
 };
 
+/**
+ * @brief A memory resource that allocates pinned memory placed on a given NUMA node.
+ *
+ * The memory is obtained with mmap, bound to the node and page-locked with cudaHostRegister.
+ * If the OS doesn't support memory policies, the memory is just allocated with default placement.
+ *
+ * Optionally, the memory can be mapped with huge pages (MAP_HUGETLB), which reduces the TLB
+ * pressure and the cost of page-locking large pools. If the huge pages can't be obtained (e.g.
+ * none are reserved in the system), the allocation falls back to regular pages, with transparent
+ * huge pages requested with madvise.
+ */
+class numa_pinned_memory_resource : public pinned_async_resource {
+ public:
+  /**
+   * @param node            the NUMA node; if negative, the memory is placed by the OS
+   * @param huge_page_size  the size of the huge pages (e.g. 2 MiB or 1 GiB) or 0, to use
+   *                        regular pages
+   */
+  explicit numa_pinned_memory_resource(int node, size_t huge_page_size = 0)
+  : node_(node), huge_page_size_(huge_page_size) {
+    DALI_ENFORCE(huge_page_size == 0 || (is_pow2(huge_page_size) && huge_page_size > page_size()),
+      make_string("Invalid huge page size: ", huge_page_size, ". The size must be a power of 2 "
+                  "greater than the page size (", page_size(), ")."));
+  }
+
+  int node() const noexcept {
+    return node_;
+  }
+
+  size_t huge_page_size() const noexcept {
+    return huge_page_size_;
+  }
+
+  /**
+   * @brief The total number of bytes mapped with huge pages
+   */
+  size_t huge_page_bytes() const noexcept {
+    return huge_page_bytes_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief The total number of bytes mapped with regular pages, because huge pages couldn't be
+   *        obtained
+   */
+  size_t fallback_bytes() const noexcept {
+    return fallback_bytes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static size_t page_size() {
+    static const size_t size = sysconf(_SC_PAGESIZE);
+    return size;
+  }
+
+  size_t mapping_size(size_t bytes) const {
+    // munmap of a huge page mapping requires the length to be a multiple of the huge page size
+    return align_up(bytes, huge_page_size_ ? huge_page_size_ : page_size());
+  }
+
+  void *map(size_t size) {
+    const int prot = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (huge_page_size_) {
+      int huge_flags = MAP_HUGETLB | (ilog2(huge_page_size_) << MAP_HUGE_SHIFT);
+      void *mem = mmap(nullptr, size, prot, flags | huge_flags, -1, 0);
+      if (mem != MAP_FAILED) {
+        huge_page_bytes_.fetch_add(size, std::memory_order_relaxed);
+        return mem;
+      }
+      fallback_bytes_.fetch_add(size, std::memory_order_relaxed);
+      DALI_WARN_ONCE("Warning: Cannot map pinned memory with ", huge_page_size_ >> 10,
+                     " kiB huge pages - using regular pages. Check /proc/sys/vm/nr_hugepages.");
+    }
+    void *mem = mmap(nullptr, size, prot, flags, -1, 0);
+    if (mem == MAP_FAILED)
+      throw std::bad_alloc();
+    if (huge_page_size_)
+      madvise(mem, size, MADV_HUGEPAGE);  // best effort - transparent huge pages may be disabled
+    return mem;
+  }
+
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    if (bytes == 0)
+      return nullptr;
+    if (alignment <= page_size())
+      alignment = 1;  // mmap returns page-aligned memory
+
+    return detail::aligned_alloc([this](size_t size) {
+      size = mapping_size(size);
+      void *mem = map(size);
+      numa::BindMemory(mem, size, node_);
+      cudaError_t err = cudaHostRegister(mem, size, cudaHostRegisterPortable);
+      if (err != cudaSuccess) {
+        munmap(mem, size);
+        CUDA_CALL(err);
+      }
+      return mem;
+    }, bytes, alignment);
+  }
+
+  void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
+    if (ptr) {
+      if (alignment <= page_size())
+        alignment = 1;
+      detail::aligned_dealloc([this](void *ptr, size_t size) {
+        CUDA_DTOR_CALL(cudaHostUnregister(ptr));
+        munmap(ptr, mapping_size(size));
+      }, ptr, bytes, alignment);
+    }
+  }
+
+  void *do_allocate_async(size_t bytes, size_t alignment, stream_view) override {
+    return allocate(bytes, alignment);
+  }
+
+  void do_deallocate_async(void *mem, size_t bytes, size_t alignment, stream_view) override {
+    return deallocate(mem, bytes, alignment);
+  }
+
+  bool do_is_equal(const memory_resource<memory_kind> &other) const noexcept override {
+    auto *numa_other = dynamic_cast<const numa_pinned_memory_resource*>(&other);
+    return numa_other && numa_other->node_ == node_ &&
+           numa_other->huge_page_size_ == huge_page_size_;
+  }
+
+  int node_;
+  size_t huge_page_size_;
+  std::atomic<size_t> huge_page_bytes_{0}, fallback_bytes_{0};
+};
+
 /**
  * @brief A memory resource that directly calls cudaMallocManaged and cudaFree.
  */
@@ -19,6 +19,7 @@
 #include <condition_variable>
 #include "dali/core/mm/memory_resource.h"
 #include "dali/core/mm/detail/free_list.h"
+#include "dali/core/mm/pool_stats.h"
 #include "dali/core/small_vector.h"
 #include "dali/core/device_guard.h"
 #include "dali/core/util.h"
@@ -64,6 +65,14 @@ struct pool_options {
    * padding to accommodate for the required (sub)allocation alignment.
    */
   size_t max_upstream_alignment = 256;
+
+  /**
+   * @brief Maximum total size of the blocks obtained from the upstream resource.
+   *
+   * When the limit is reached, the allocations which cannot be served from the pool fail
+   * with std::bad_alloc, as if the upstream resource was out of memory.
+   */
+  size_t max_upstream_size = -1_uz;  // no limit
 };
 
 constexpr pool_options default_host_pool_opts() noexcept {
@@ -85,7 +94,7 @@ constexpr pool_options default_pool_opts<memory_kind::host>() noexcept {
 }
 
 template <typename Kind, class FreeList, class LockType>
-class pool_resource_base : public memory_resource<Kind> {
+class pool_resource_base : public memory_resource<Kind>, public pool_stats_provider {
  public:
   explicit pool_resource_base(memory_resource<Kind> *upstream = nullptr,
                               const pool_options &opt = default_pool_opts<Kind>())
@@ -105,6 +114,7 @@ class pool_resource_base : public memory_resource<Kind> {
     lock_guard guard(lock_);
     for (auto &block : blocks_) {
       upstream_->deallocate(block.ptr, block.bytes, block.alignment);
+      stat_remove_block(block.bytes);
     }
     blocks_.clear();
     free_list_.clear();
@@ -127,7 +137,10 @@ class pool_resource_base : public memory_resource<Kind> {
 
     {
       lock_guard guard(lock_);
-      return free_list_.get(bytes, alignment);
+      void *ptr = free_list_.get(bytes, alignment);
+      if (ptr)
+        stat_add_allocation(bytes);
+      return ptr;
     }
   }
 
@@ -135,6 +148,32 @@ class pool_resource_base : public memory_resource<Kind> {
     return options_;
   }
 
+  pool_stats get_stats() const override {
+    upstream_lock_guard uguard(upstream_lock_);
+    lock_guard guard(lock_);
+    pool_stats stats = stats_;
+    stats.free = free_list_.space_stats();
+    return stats;
+  }
+
+  void reset_peak_stats() override {
+    upstream_lock_guard uguard(upstream_lock_);
+    lock_guard guard(lock_);
+    stats_.peak_reserved_bytes = stats_.reserved_bytes;
+    stats_.peak_allocated_bytes = stats_.allocated_bytes;
+  }
+
+  /**
+   * @brief Returns the upstream blocks which are completely free, until at most `keep_bytes`
+   *        stay reserved
+   *
+   * The most recently obtained blocks, which are usually the largest ones, are returned first.
+   */
+  size_t trim(size_t keep_bytes) override {
+    upstream_lock_guard uguard(upstream_lock_);
+    return release_free_blocks(keep_bytes);
+  }
+
  protected:
   void *do_allocate(size_t bytes, size_t alignment) override {
     if (!bytes)
@@ -159,21 +198,23 @@ class pool_resource_base : public memory_resource<Kind> {
     char *block_end = block_start + blk_size;
     assert(tail <= block_end);
 
+    lock_guard guard(lock_);
     if (blk_size != bytes) {
       // we've allocated an oversized block - put the front & back padding in the free list
-      lock_guard guard(lock_);
       if (ret != block_start)
         free_list_.put(block_start, ret - block_start);
 
       if (tail != block_end)
         free_list_.put(tail, block_end - tail);
     }
+    stat_add_allocation(bytes);
     return ret;
   }
 
   void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
     lock_guard guard(lock_);
     free_list_.put(ptr, bytes);
+    stat_add_deallocation(bytes);
   }
 
   void *get_upstream_block(size_t &blk_size, size_t min_bytes, size_t alignment) {
@@ -191,6 +232,8 @@ class pool_resource_base : public memory_resource<Kind> {
     void *new_block = nullptr;
     for (;;) {
       try {
+        if (blk_size > options_.max_upstream_size - stats_.reserved_bytes)
+          throw std::bad_alloc();  // the pool has reached its size limit
         new_block = upstream_->allocate(blk_size, alignment);
         break;
       } catch (const std::bad_alloc &) {
@@ -207,29 +250,9 @@ class pool_resource_base : public memory_resource<Kind> {
           // (the free list covers them completely), we can try to return them
           // to the upstream, with the hope that it will reorganize and succeed in
           // the subsequent allocation attempt.
-          int blocks_freed = 0;
-          SmallVector<bool, 32> removed;
-          removed.resize(blocks_.size(), false);
-          {
-            lock_guard guard(lock_);
-            for (int i = 0; i < static_cast<int>(blocks_.size()); i++) {
-              UpstreamBlock blk = blocks_[i];
-              removed[i] = free_list_.remove_if_in_list(blk.ptr, blk.bytes);
-              if (removed[i])
-                blocks_freed++;
-            }
-          }
-
-          if (!blocks_freed)
+          if (!release_free_blocks(0))
             throw;  // we freed nothing, so there's no point in retrying to allocate
 
-          for (int i = blocks_.size() - 1; i >= 0; i--) {
-            if (removed[i]) {
-              UpstreamBlock blk = blocks_[i];
-              upstream_->deallocate(blk.ptr, blk.bytes, blk.alignment);
-              blocks_.erase_at(i);
-            }
-          }
           // mark that we've tried, so we can fail fast the next time
           tried_return_to_upstream = true;
         }
@@ -246,9 +269,47 @@ class pool_resource_base : public memory_resource<Kind> {
       upstream_->deallocate(new_block, blk_size, alignment);
       throw;
     }
+    stat_add_block(blk_size);
     return new_block;
   }
 
+  /**
+   * @brief Returns the completely free upstream blocks, newest first, until at most `keep_bytes`
+   *        stay reserved
+   *
+   * Must be called with upstream_lock_ held.
+   *
+   * @return The number of bytes returned to the upstream
+   */
+  size_t release_free_blocks(size_t keep_bytes) {
+    size_t released = 0;
+    SmallVector<bool, 32> removed;
+    removed.resize(blocks_.size(), false);
+    {
+      lock_guard guard(lock_);
+      for (int i = static_cast<int>(blocks_.size()) - 1; i >= 0; i--) {
+        if (stats_.reserved_bytes - released <= keep_bytes)
+          break;
+        UpstreamBlock blk = blocks_[i];
+        removed[i] = free_list_.remove_if_in_list(blk.ptr, blk.bytes);
+        if (removed[i])
+          released += blk.bytes;
+      }
+    }
+
+    // the upstream is called without holding lock_, so the allocations from the free list
+    // don't have to wait for it
+    for (int i = static_cast<int>(blocks_.size()) - 1; i >= 0; i--) {
+      if (removed[i]) {
+        UpstreamBlock blk = blocks_[i];
+        upstream_->deallocate(blk.ptr, blk.bytes, blk.alignment);
+        stat_remove_block(blk.bytes);
+        blocks_.erase_at(i);
+      }
+    }
+    return released;
+  }
+
   size_t next_block_size(size_t upcoming_allocation_size) {
     size_t actual_block_size = std::max<size_t>(upcoming_allocation_size,
                                                 next_block_size_ * options_.growth_factor);
@@ -267,12 +328,36 @@ class pool_resource_base : public memory_resource<Kind> {
     return actual_block_size;
   }
 
+  // the allocation statistics are guarded by lock_, the upstream ones - by upstream_lock_
+  void stat_add_allocation(size_t bytes) {
+    stats_.allocations++;
+    stats_.allocated_bytes += bytes;
+    stats_.peak_allocated_bytes = std::max(stats_.peak_allocated_bytes, stats_.allocated_bytes);
+  }
+
+  void stat_add_deallocation(size_t bytes) {
+    stats_.deallocations++;
+    assert(stats_.allocated_bytes >= bytes);
+    stats_.allocated_bytes -= bytes;
+  }
+
+  void stat_add_block(size_t bytes) {
+    stats_.upstream_allocations++;
+    stats_.reserved_bytes += bytes;
+    stats_.peak_reserved_bytes = std::max(stats_.peak_reserved_bytes, stats_.reserved_bytes);
+  }
+
+  void stat_remove_block(size_t bytes) {
+    stats_.upstream_deallocations++;
+    stats_.reserved_bytes -= bytes;
+  }
+
   memory_resource<Kind> *upstream_;
   FreeList free_list_;
 
   // locking order: upstream_lock_, lock_
-  std::mutex upstream_lock_;
-  LockType lock_;
+  mutable std::mutex upstream_lock_;
+  mutable LockType lock_;
   pool_options options_;
   size_t next_block_size_ = 0;
   int device_ordinal_ = -1;
@@ -283,6 +368,7 @@ class pool_resource_base : public memory_resource<Kind> {
   };
 
   SmallVector<UpstreamBlock, 16> blocks_;
+  pool_stats stats_;
   using lock_guard = std::lock_guard<LockType>;
   using unique_lock = std::unique_lock<LockType>;
   using upstream_lock_guard = std::lock_guard<std::mutex>;
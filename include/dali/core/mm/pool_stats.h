@@ -0,0 +1,118 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_MM_POOL_STATS_H_
+#define DALI_CORE_MM_POOL_STATS_H_
+
+#include <algorithm>
+#include <cstddef>
+
+namespace dali {
+namespace mm {
+
+/**
+ * @brief Describes the free memory kept in a free list
+ */
+struct free_space_stats {
+  /// Total size of the free blocks
+  size_t bytes = 0;
+  /// Number of the (non-adjacent) free blocks
+  size_t blocks = 0;
+  /// Size of the largest free block
+  size_t largest_block = 0;
+
+  void add_block(size_t size) {
+    bytes += size;
+    blocks++;
+    largest_block = std::max(largest_block, size);
+  }
+
+  free_space_stats &operator+=(const free_space_stats &other) {
+    bytes += other.bytes;
+    blocks += other.blocks;
+    largest_block = std::max(largest_block, other.largest_block);
+    return *this;
+  }
+};
+
+/**
+ * @brief Memory usage statistics of a pool resource
+ *
+ * The peak values are tracked since the creation of the pool or since the last call to
+ * `pool_stats_provider::reset_peak_stats`.
+ */
+struct pool_stats {
+  /// Memory obtained from the upstream resource and not returned yet
+  size_t reserved_bytes = 0;
+  size_t peak_reserved_bytes = 0;
+  /// Memory allocated from the pool and not freed yet
+  size_t allocated_bytes = 0;
+  size_t peak_allocated_bytes = 0;
+  /// Memory available in the pool without calling the upstream resource
+  free_space_stats free;
+  /// Number of the allocations and deallocations served by the pool
+  size_t allocations = 0;
+  size_t deallocations = 0;
+  /// Number of the calls to the upstream resource
+  size_t upstream_allocations = 0;
+  size_t upstream_deallocations = 0;
+
+  /**
+   * @brief The fraction of the free memory which cannot be used for an allocation
+   *        as large as the free memory
+   *
+   * 0 means that the free memory is contiguous; the value approaches 1 as the free memory
+   * gets scattered over many small blocks.
+   */
+  double fragmentation() const noexcept {
+    return free.bytes ? 1.0 - static_cast<double>(free.largest_block) / free.bytes : 0.0;
+  }
+};
+
+/**
+ * @brief An interface of the memory resources which can report the pool statistics and return
+ *        the memory they don't use to the upstream
+ */
+class pool_stats_provider {
+ public:
+  virtual ~pool_stats_provider() = default;
+
+  /**
+   * @brief Returns a snapshot of the current statistics.
+   *
+   * The function obtains the locks of the pool and traverses the free list - it's intended for
+   * monitoring, not for use on every allocation.
+   */
+  virtual pool_stats get_stats() const = 0;
+
+  /**
+   * @brief Sets the peak values to the current ones
+   */
+  virtual void reset_peak_stats() = 0;
+
+  /**
+   * @brief Returns the free memory to the upstream, until at most `keep_bytes` stay reserved
+   *
+   * Only the memory which is entirely free can be released - the reserved size may remain
+   * above `keep_bytes` if the free memory is interleaved with allocations.
+   *
+   * @return The number of bytes released
+   */
+  virtual size_t trim(size_t keep_bytes) = 0;
+};
+
+}  // namespace mm
+}  // namespace dali
+
+#endif  // DALI_CORE_MM_POOL_STATS_H_
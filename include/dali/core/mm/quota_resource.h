@@ -0,0 +1,160 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_MM_QUOTA_RESOURCE_H_
+#define DALI_CORE_MM_QUOTA_RESOURCE_H_
+
+#include <atomic>
+#include <cassert>
+#include <new>
+#include <string>
+#include "dali/core/format.h"
+#include "dali/core/mm/memory_resource.h"
+
+namespace dali {
+namespace mm {
+
+/**
+ * @brief Thrown when an allocation would exceed the hard limit of a quota_resource
+ */
+class quota_exceeded : public std::bad_alloc {
+ public:
+  quota_exceeded(size_t requested, size_t usage, size_t limit)
+  : message_(make_string("Cannot allocate ", requested, " bytes: the memory quota of ", limit,
+                         " bytes would be exceeded (", usage, " bytes in use).")) {}
+
+  const char *what() const noexcept override {
+    return message_.c_str();
+  }
+
+ private:
+  std::string message_;
+};
+
+/**
+ * @brief A proxy resource which accounts the memory allocated by one client of a shared
+ *        upstream resource (typically a pool) and enforces the client's limits.
+ *
+ * The hard limit is enforced - an allocation that would exceed it throws `quota_exceeded`
+ * without reaching the upstream. The soft limit is advisory: the client can query
+ * `over_soft_limit` and release the memory it doesn't need, so that the other clients of the
+ * upstream can reuse it. A limit equal to 0 means no limit.
+ *
+ * The memory is returned to the upstream as soon as it's freed - the quota resource doesn't
+ * cache it, so the freed memory is immediately available to the other clients.
+ */
+template <typename Kind, typename Upstream = async_memory_resource<Kind>>
+class quota_resource : public async_memory_resource<Kind> {
+ public:
+  quota_resource(Upstream *upstream, size_t soft_limit, size_t hard_limit = 0)
+  : upstream_(upstream), soft_limit_(soft_limit), hard_limit_(hard_limit) {
+    assert(upstream);
+  }
+
+  quota_resource(const quota_resource &) = delete;
+  quota_resource(quota_resource &&) = delete;
+
+  Upstream *upstream() const noexcept {
+    return upstream_;
+  }
+
+  size_t soft_limit() const noexcept {
+    return soft_limit_;
+  }
+
+  size_t hard_limit() const noexcept {
+    return hard_limit_;
+  }
+
+  /// The number of bytes currently allocated through this resource
+  size_t usage() const noexcept {
+    return usage_.load(std::memory_order_relaxed);
+  }
+
+  /// The highest usage since the creation of the resource or the last call to reset_peak_usage
+  size_t peak_usage() const noexcept {
+    return peak_usage_.load(std::memory_order_relaxed);
+  }
+
+  void reset_peak_usage() noexcept {
+    peak_usage_ = usage();
+  }
+
+  bool over_soft_limit() const noexcept {
+    return soft_limit_ && usage() > soft_limit_;
+  }
+
+ private:
+  void charge(size_t bytes) {
+    size_t prev = usage_.fetch_add(bytes, std::memory_order_relaxed);
+    size_t curr = prev + bytes;
+    if (hard_limit_ && curr > hard_limit_) {
+      usage_.fetch_sub(bytes, std::memory_order_relaxed);
+      throw quota_exceeded(bytes, prev, hard_limit_);
+    }
+    size_t peak = peak_usage_.load(std::memory_order_relaxed);
+    while (curr > peak && !peak_usage_.compare_exchange_weak(peak, curr,
+                                                             std::memory_order_relaxed)) {}
+  }
+
+  void uncharge(size_t bytes) noexcept {
+    usage_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    charge(bytes);
+    try {
+      return upstream_->allocate(bytes, alignment);
+    } catch (...) {
+      uncharge(bytes);
+      throw;
+    }
+  }
+
+  void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
+    upstream_->deallocate(ptr, bytes, alignment);
+    uncharge(bytes);
+  }
+
+  void *do_allocate_async(size_t bytes, size_t alignment, stream_view stream) override {
+    charge(bytes);
+    try {
+      return upstream_->allocate_async(bytes, alignment, stream);
+    } catch (...) {
+      uncharge(bytes);
+      throw;
+    }
+  }
+
+  void do_deallocate_async(void *ptr, size_t bytes, size_t alignment,
+                           stream_view stream) override {
+    upstream_->deallocate_async(ptr, bytes, alignment, stream);
+    uncharge(bytes);
+  }
+
+  bool do_is_equal(const memory_resource<Kind> &other) const noexcept override {
+    return this == &other;
+  }
+
+  Upstream *upstream_;
+  size_t soft_limit_, hard_limit_;
+  std::atomic<size_t> usage_{0}, peak_usage_{0};
+};
+
+using device_quota_resource = quota_resource<memory_kind::device>;
+
+}  // namespace mm
+}  // namespace dali
+
+#endif  // DALI_CORE_MM_QUOTA_RESOURCE_H_
@@ -0,0 +1,329 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_MM_SLAB_RESOURCE_H_
+#define DALI_CORE_MM_SLAB_RESOURCE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "dali/core/mm/memory_resource.h"
+#include "dali/core/mm/detail/align.h"
+#include "dali/core/mm/detail/util.h"
+#include "dali/core/spinlock.h"
+#include "dali/core/util.h"
+
+namespace dali {
+namespace mm {
+
+struct slab_options {
+  /**
+   * @brief Largest size (or alignment) of an allocation served from the slabs
+   *
+   * Larger allocations are passed directly to the upstream resource.
+   */
+  size_t max_object_size = 4096;
+  /// Size of the blocks obtained from the upstream resource and split into objects
+  size_t slab_size = 1 << 16;
+  /**
+   * @brief The number of the free objects of each size class kept by a thread
+   *
+   * When the thread cache is empty, half of that is taken from the shared free list at once;
+   * when it overflows, half of it is returned.
+   */
+  int thread_cache_size = 64;
+};
+
+/**
+ * @brief A front-end for small allocations, which serves them from size classes carved out
+ *        of large blocks (slabs) obtained from the upstream resource.
+ *
+ * The allocation sizes are rounded up to a power of two (at least 16 bytes); each size class
+ * has a free list shared by all threads and a small per-thread cache of free objects, which
+ * is used without locking. The objects are aligned to their size, so the alignment is
+ * satisfied by choosing a class not smaller than the alignment.
+ *
+ * Allocations larger than `max_object_size` go directly to the upstream resource.
+ * The slabs are returned to the upstream only when the resource is destroyed.
+ *
+ * The free lists are stored in the freed objects, hence the memory must be host-accessible.
+ * As with any memory_resource, the size and alignment passed to `deallocate` must match those
+ * passed to `allocate`.
+ */
+template <typename Kind, typename Upstream = memory_resource<Kind>>
+class slab_resource : public memory_resource<Kind> {
+  static_assert(detail::is_host_accessible<Kind>,
+                "The slab resource keeps the free lists in the free memory - it must be "
+                "accessible by the host.");
+
+ public:
+  static constexpr size_t kMinObjectSize = 16;
+  static constexpr int kMaxClasses = 16;
+
+  explicit slab_resource(Upstream *upstream, const slab_options &opt = {})
+  : upstream_(upstream), options_(opt)
+  , central_(std::make_shared<central_state>(next_id())) {
+    assert(upstream);
+    if (options_.max_object_size < kMinObjectSize)
+      options_.max_object_size = 0;  // all allocations go to the upstream
+    else
+      options_.max_object_size = size_t(1) << ilog2(options_.max_object_size);
+    options_.max_object_size = std::min(options_.max_object_size,
+                                        kMinObjectSize << (kMaxClasses - 1));
+    options_.slab_size = std::max(options_.slab_size, options_.max_object_size);
+    options_.thread_cache_size = std::max(options_.thread_cache_size, 2);
+  }
+
+  slab_resource(const slab_resource &) = delete;
+  slab_resource(slab_resource &&) = delete;
+
+  ~slab_resource() {
+    std::vector<slab> slabs;
+    {
+      std::lock_guard<spinlock> guard(central_->lock);
+      slabs = std::move(central_->slabs);
+    }
+    // the thread caches which outlive the resource drop their objects
+    central_.reset();
+    for (auto &s : slabs)
+      upstream_->deallocate(s.ptr, s.bytes, s.alignment);
+  }
+
+  constexpr const slab_options &options() const noexcept {
+    return options_;
+  }
+
+ private:
+  struct free_object {
+    free_object *next;
+  };
+
+  /// An intrusive singly-linked list of free objects
+  struct object_list {
+    free_object *head = nullptr;
+    free_object *tail = nullptr;
+    int count = 0;
+
+    void *pop() {
+      free_object *obj = head;
+      if (obj) {
+        head = obj->next;
+        if (!head)
+          tail = nullptr;
+        count--;
+      }
+      return obj;
+    }
+
+    void push(void *ptr) {
+      auto *obj = static_cast<free_object *>(ptr);
+      obj->next = head;
+      head = obj;
+      if (!tail)
+        tail = obj;
+      count++;
+    }
+
+    /// Appends all the objects from `other` and leaves it empty
+    void splice(object_list &other) {
+      if (!other.head)
+        return;
+      other.tail->next = head;
+      if (!tail)
+        tail = other.tail;
+      head = other.head;
+      count += other.count;
+      other = {};
+    }
+
+    /// Removes up to `n` objects from the front of the list
+    object_list take(int n) {
+      object_list ret;
+      if (n <= 0 || !head)
+        return ret;
+      if (n >= count) {
+        ret = *this;
+        *this = {};
+        return ret;
+      }
+      ret.head = head;
+      free_object *last = head;
+      for (int i = 1; i < n; i++)
+        last = last->next;
+      head = last->next;
+      last->next = nullptr;
+      ret.tail = last;
+      ret.count = n;
+      count -= n;
+      return ret;
+    }
+  };
+
+  struct slab {
+    void *ptr;
+    size_t bytes, alignment;
+  };
+
+  struct central_state {
+    explicit central_state(uint64_t id) : id(id) {}
+    const uint64_t id;
+    spinlock lock;
+    object_list free[kMaxClasses];
+    std::vector<slab> slabs;
+  };
+
+  struct thread_cache {
+    thread_cache(uint64_t id, std::weak_ptr<central_state> owner)
+    : id(id), owner(std::move(owner)) {}
+
+    ~thread_cache() {
+      // return the objects, if the resource still exists
+      if (auto central = owner.lock()) {
+        std::lock_guard<spinlock> guard(central->lock);
+        for (int c = 0; c < kMaxClasses; c++)
+          central->free[c].splice(free[c]);
+      }
+    }
+
+    const uint64_t id;
+    std::weak_ptr<central_state> owner;
+    object_list free[kMaxClasses];
+  };
+
+  /**
+   * @brief The caches of the calling thread for all slab resources of this type
+   *
+   * The caches are identified by the unique id of the resource, so a cache of a destroyed
+   * resource is never used by a resource created later at the same address.
+   */
+  static std::vector<std::unique_ptr<thread_cache>> &thread_caches() {
+    static thread_local std::vector<std::unique_ptr<thread_cache>> caches;
+    return caches;
+  }
+
+  static uint64_t next_id() {
+    static std::atomic<uint64_t> id{0};
+    return ++id;
+  }
+
+  thread_cache &get_thread_cache() {
+    auto &caches = thread_caches();
+    uint64_t id = central_->id;
+    for (auto &cache : caches) {
+      if (cache->id == id)
+        return *cache;
+    }
+    // drop the caches of the destroyed resources
+    caches.erase(std::remove_if(caches.begin(), caches.end(), [](auto &cache) {
+      return cache->owner.expired();
+    }), caches.end());
+    caches.push_back(std::make_unique<thread_cache>(id, central_));
+    return *caches.back();
+  }
+
+  /**
+   * @brief Returns the index of the size class or -1, if the allocation is not served
+   *        from the slabs.
+   */
+  int size_class(size_t bytes, size_t alignment) const {
+    size_t size = std::max(std::max(bytes, alignment), kMinObjectSize);
+    if (size > options_.max_object_size)
+      return -1;
+    int c = 0;
+    for (size_t s = (size - 1) / kMinObjectSize; s; s >>= 1)
+      c++;
+    return c;
+  }
+
+  static constexpr size_t class_size(int size_class) {
+    return kMinObjectSize << size_class;
+  }
+
+  /**
+   * @brief Moves a batch of objects from the shared free list to the thread cache,
+   *        allocating a new slab, if necessary.
+   */
+  void refill(object_list &cache, int size_class) {
+    int batch = options_.thread_cache_size / 2;
+    std::lock_guard<spinlock> guard(central_->lock);
+    auto &central = central_->free[size_class];
+    if (!central.head)
+      allocate_slab(central, size_class);
+    auto objects = central.take(batch);
+    cache.splice(objects);
+  }
+
+  void allocate_slab(object_list &list, int size_class) {
+    size_t size = class_size(size_class);
+    size_t bytes = options_.slab_size;
+    char *base = static_cast<char *>(upstream_->allocate(bytes, size));
+    try {
+      central_->slabs.push_back({ base, bytes, size });
+    } catch (...) {
+      upstream_->deallocate(base, bytes, size);
+      throw;
+    }
+    // push in reverse order, so that the objects are used in the order of addresses
+    for (size_t i = bytes / size; i-- > 0; )
+      list.push(base + i * size);
+  }
+
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    if (!bytes)
+      return nullptr;
+    int c = size_class(bytes, alignment);
+    if (c < 0)
+      return upstream_->allocate(bytes, alignment);
+    auto &cache = get_thread_cache().free[c];
+    if (!cache.head)
+      refill(cache, c);
+    void *ptr = cache.pop();
+    assert(ptr && detail::is_aligned(ptr, alignment));
+    return ptr;
+  }
+
+  void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
+    if (!ptr || !bytes)
+      return;
+    int c = size_class(bytes, alignment);
+    if (c < 0)
+      return upstream_->deallocate(ptr, bytes, alignment);
+    auto &cache = get_thread_cache().free[c];
+    cache.push(ptr);
+    if (cache.count > options_.thread_cache_size) {
+      // keep the objects freed most recently and return the rest
+      object_list old = cache;
+      cache = old.take(options_.thread_cache_size / 2);
+      std::lock_guard<spinlock> guard(central_->lock);
+      central_->free[c].splice(old);
+    }
+  }
+
+  bool do_is_equal(const memory_resource<Kind> &other) const noexcept override {
+    return this == &other;
+  }
+
+  Upstream *upstream_;
+  slab_options options_;
+  std::shared_ptr<central_state> central_;
+};
+
+}  // namespace mm
+}  // namespace dali
+
+#endif  // DALI_CORE_MM_SLAB_RESOURCE_H_
@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #if NVTX_ENABLED
   // Just to get CUDART_VERSION value
@@ -31,6 +32,7 @@
 #endif
 
 #include "dali/core/api_helper.h"
+#include "dali/core/tracer.h"
 
 namespace dali {
 
@@ -88,16 +90,38 @@ struct TimeRange : RangeBase {
   bool started = false;
 };
 
+/**
+ * @brief A range of the DALI domain in NVTX, also recorded by the Tracer, when it's enabled
+ */
 struct DomainTimeRange : RangeBase {
   explicit DomainTimeRange(const std::string &name, const uint32_t rgb = kBlue)
     : DomainTimeRange(name.c_str(), rgb) {}
+
+  explicit DomainTimeRange(const char *name, const uint32_t rgb = kBlue) {
+#if NVTX_ENABLED
+    StartNVTX(name, rgb);
+#endif
+    if (Tracer::instance().enabled()) {
+      trace_name_ = name;
+      trace_start_ = Tracer::Now();
+    }
+  }
+
+  ~DomainTimeRange() {
+#if NVTX_ENABLED
+    StopNVTX();
+#endif
+    if (trace_start_ >= 0)
+      Tracer::instance().AddSpan(std::move(trace_name_), trace_start_, Tracer::Now());
+  }
+
+ private:
 #if NVTX_ENABLED
-  explicit DomainTimeRange(const char *name, const uint32_t rgb = kBlue);
-  ~DomainTimeRange();
-#else
-  explicit DomainTimeRange(const char *name, const uint32_t rgb = kBlue) {}
-  ~DomainTimeRange() {}
+  DLL_PUBLIC static void StartNVTX(const char *name, const uint32_t rgb);
+  DLL_PUBLIC static void StopNVTX();
 #endif
+  std::string trace_name_;
+  int64_t trace_start_ = -1;
 };
 
 /*
@@ -0,0 +1,48 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_OS_NUMA_H_
+#define DALI_CORE_OS_NUMA_H_
+
+#include <cstddef>
+#include "dali/core/api_helper.h"
+
+namespace dali {
+namespace numa {
+
+/**
+ * @brief Returns the number of NUMA nodes in the system (at least 1)
+ */
+DLL_PUBLIC int NumNodes();
+
+/**
+ * @brief Returns the NUMA node closest to the given CUDA device or -1 if it cannot be determined
+ *
+ * @param device_id CUDA device ordinal; if negative, current device is used
+ */
+DLL_PUBLIC int GetDeviceNode(int device_id = -1);
+
+/**
+ * @brief Sets the memory policy of a (page-aligned) range of memory to prefer the given node
+ *
+ * The pages which are not yet populated will be allocated on the `node`, if possible.
+ *
+ * @return true on success, false if the OS does not support memory policies
+ */
+DLL_PUBLIC bool BindMemory(void *ptr, size_t bytes, int node);
+
+}  // namespace numa
+}  // namespace dali
+
+#endif  // DALI_CORE_OS_NUMA_H_
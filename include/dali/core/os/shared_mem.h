@@ -1,4 +1,4 @@
-// Copyright (c) 2020-2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,6 +16,7 @@
 #define DALI_CORE_OS_SHARED_MEM_H_
 
 #include <stdint.h>
+#include <string.h>
 #include <memory>
 #include <string>
 #include "dali/core/common.h"
@@ -28,7 +29,7 @@ namespace dali {
 using shm_handle_t = int;
 using fd_handle_t = int;
 
-void handle_strerror(int errnum, char *buf, size_t buflen) {
+inline void handle_strerror(int errnum, char *buf, size_t buflen) {
   #if (_POSIX_C_SOURCE >= 200112L) && !_GNU_SOURCE
     DALI_ENFORCE(strerror_r(errnum, buf, buflen) == 0, "Call to strerror_r failed.");
   #else
@@ -139,7 +140,7 @@ class DLL_PUBLIC SharedMem {
  public:
   DLL_PUBLIC SharedMem(shm_handle_t handle, uint64_t size);
 
-  DLL_PUBLIC ~SharedMem() = default;
+  DLL_PUBLIC ~SharedMem();
 
   DLL_PUBLIC uint64_t size() const;
 
@@ -164,8 +165,26 @@ class DLL_PUBLIC SharedMem {
 
   DLL_PUBLIC void close();
 
+  /**
+   * @brief Registers (page-locks) the mapped memory with CUDA or unregisters it.
+   *
+   * The pinned mapping can be a source of asynchronous host-to-device copies without a staging
+   * copy. The registration is kept across `resize` and is removed before the memory is unmapped.
+   *
+   * @param device_id the device which is current when registering the memory (-1 keeps the current
+   *                  one), so that no CUDA context is created for an unrelated device
+   */
+  DLL_PUBLIC void set_pinned(bool pinned, int device_id = -1);
+
+  DLL_PUBLIC bool is_pinned() const;
+
  private:
+  void register_mapping();
+  void unregister_mapping();
+
   uint64_t size_;
+  bool pinned_ = false;
+  int pinned_device_id_ = -1;
   ShmHandle shm_handle_;
   MemoryMapping memory_mapping_;
 };
@@ -0,0 +1,156 @@
+// Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_TRACER_H_
+#define DALI_CORE_TRACER_H_
+
+#include <driver_types.h>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "dali/core/api_helper.h"
+#include "dali/core/cuda_event.h"
+#include "dali/core/cuda_stream.h"
+
+namespace dali {
+
+/**
+ * @brief Records the timeline of DALI's work and writes it in the Chrome trace format
+ *        (the JSON Trace Event Format, read by Perfetto and chrome://tracing)
+ *
+ * The host spans are the DomainTimeRanges - the stages of the executor, the Setup and Run of
+ * the operators, the jobs of the thread pools, the prefetching of the readers and the waits
+ * for it - recorded in the threads which run them. The GPU spans are the work of the operators
+ * in their streams, timed with CUDA events, each stream shown as a thread of its own.
+ *
+ * The recording is toggled at runtime with Start and Stop; when it's stopped, a DomainTimeRange
+ * costs one atomic load more than NVTX alone. At most `max_events` spans are kept.
+ */
+class DLL_PUBLIC Tracer {
+ public:
+  static Tracer &instance();
+
+  /// @brief The events around the work recorded with BeginGPUSpan
+  struct GPUSpan {
+    CUDAEvent start, end;
+    int device_id = -1;
+  };
+
+  /**
+   * @brief Discards the recorded spans and starts recording new ones
+   *
+   * @param max_events the maximum number of recorded spans; the following ones are dropped
+   */
+  void Start(size_t max_events = kDefaultMaxEvents);
+
+  /// @brief Stops recording; the recorded spans are kept until the next Start
+  void Stop();
+
+  bool enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /// @brief The current time, in nanoseconds, on the clock of the spans
+  static int64_t Now();
+
+  /// @brief Records a span of the calling thread
+  void AddSpan(std::string name, int64_t begin_ns, int64_t end_ns);
+
+  /**
+   * @brief Records the start event of a GPU span in the stream
+   *
+   * The span is added with EndGPUSpan, called after the timed work is issued.
+   */
+  GPUSpan BeginGPUSpan(cudaStream_t stream);
+
+  void EndGPUSpan(std::string name, GPUSpan span, cudaStream_t stream);
+
+  /**
+   * @brief Returns the recorded spans as a Chrome trace
+   *
+   * Waits for the GPU spans which are still pending.
+   */
+  std::string ToJSON();
+
+  /// @brief Writes the result of ToJSON to a file
+  void Write(const std::string &filename);
+
+  /// @brief The number of spans which didn't fit in `max_events`
+  int64_t dropped_events() const;
+
+  static constexpr size_t kDefaultMaxEvents = 1 << 20;
+
+ private:
+  Tracer() = default;
+
+  struct Span {
+    std::string name;
+    int64_t begin_ns, end_ns;
+    int64_t tid;
+    bool gpu;
+  };
+
+  /**
+   * @brief A point of the GPU timeline with a known host time - the GPU spans are placed
+   *        on the host timeline with the time elapsed since (or before) it
+   */
+  struct GPUReference {
+    CUDAEvent event;
+    int64_t host_ns;
+  };
+
+  struct PendingGPUSpan {
+    std::string name;
+    GPUSpan span;
+    std::shared_ptr<GPUReference> reference;
+    int64_t tid;
+  };
+
+  void AddSpanLocked(Span span);
+
+  /// @brief Resolves the pending GPU spans whose work is complete (or all of them, if `wait`)
+  void CollectGPUSpans(bool wait);
+
+  std::shared_ptr<GPUReference> GetGPUReference(int device_id);
+
+  int64_t StreamTid(cudaStream_t stream, int device_id);
+
+  std::atomic<bool> enabled_{false};
+  mutable std::mutex mtx_;
+  size_t max_events_ = kDefaultMaxEvents;
+  int64_t dropped_events_ = 0;
+  /// The time of the last Start - the beginning of the trace
+  int64_t start_ns_ = 0;
+  std::vector<Span> spans_;
+  std::deque<PendingGPUSpan> pending_;
+  /// device_id -> events ready for reuse
+  std::map<int, std::vector<CUDAEvent>> free_events_;
+  std::map<int, std::shared_ptr<GPUReference>> gpu_references_;
+  /// device_id -> the stream of the reference events
+  std::map<int, CUDAStream> reference_streams_;
+  /// tid -> thread name
+  std::map<int64_t, std::string> thread_names_;
+  /// (stream, device_id) -> the tid of the stream's track
+  std::map<std::pair<cudaStream_t, int>, int64_t> stream_tids_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_CORE_TRACER_H_
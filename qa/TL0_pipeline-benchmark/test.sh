@@ -0,0 +1,62 @@
+#!/bin/bash -ex
+
+test_body() {
+  BINNAME=dali_pipeline_benchmark.bin
+
+  for DIRNAME in \
+    "../../build/dali/python/nvidia/dali" \
+    "$(python -c 'import os; from nvidia import dali; print(os.path.dirname(dali.__file__))' 2>/dev/null || echo '')"
+  do
+      if [ -x "$DIRNAME/test/$BINNAME" ]; then
+          FULLPATH="$DIRNAME/test/$BINNAME"
+          break
+      fi
+  done
+
+  if [[ -z "$FULLPATH" ]]; then
+      echo "ERROR: $BINNAME not found"
+      exit 1
+  fi
+
+  TMPDIR=$(mktemp -d)
+  python -c "
+import os
+import sys
+import nvidia.dali.fn as fn
+from nvidia.dali import pipeline_def
+
+@pipeline_def(batch_size=32, num_threads=4, device_id=0)
+def pipe():
+    jpegs, labels = fn.readers.file(file_root=os.path.join(os.environ['DALI_EXTRA_PATH'], 'db', 'single', 'jpeg'))
+    images = fn.decoders.image(jpegs, device='mixed')
+    return fn.resize(images, size=[224, 224]), labels
+
+pipe().serialize(filename=sys.argv[1])
+" "$TMPDIR/pipeline.pb"
+
+  "$FULLPATH" "$TMPDIR/pipeline.pb" --iterations=50 --warmup=5 --output="$TMPDIR/report.json"
+  python -c "
+import json
+import sys
+report = json.load(open(sys.argv[1]))
+assert report['samples_per_second'] > 0
+assert report['latency']['p50'] <= report['latency']['p99'] <= report['latency']['max']
+assert any(op.startswith('MIXED_') for op in report['operators'])
+" "$TMPDIR/report.json"
+
+  # the latency of single-sample requests in the low latency mode
+  "$FULLPATH" "$TMPDIR/pipeline.pb" --iterations=50 --warmup=5 --batch_size=1 --low_latency=1 \
+      --output="$TMPDIR/report_low_latency.json"
+  python -c "
+import json
+import sys
+report = json.load(open(sys.argv[1]))
+assert report['low_latency'] and report['batch_size'] == 1
+assert report['latency']['p50'] <= report['latency']['p99'] <= report['latency']['max']
+" "$TMPDIR/report_low_latency.json"
+  rm -rf "$TMPDIR"
+}
+
+pushd ../..
+source ./qa/test_template.sh
+popd
@@ -0,0 +1,127 @@
+# Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Calibrates the `huffman_cost_model` argument of the mixed image decoder.
+# Each image is decoded alone, once with the host and once with the hybrid (GPU) Huffman decoder,
+# and the coefficients of the model are fitted to the measured times.
+
+from nvidia.dali.pipeline import pipeline_def
+import nvidia.dali.types as types
+import nvidia.dali.fn as fn
+import numpy as np
+import argparse
+import os
+import struct
+import time
+
+parser = argparse.ArgumentParser(description='DALI Huffman decoder cost model calibration')
+parser.add_argument('-d', dest='device_id', help='device id', default=0, type=int)
+parser.add_argument('-i', dest='images_dir', help='images dir (JPEG files)', required=True)
+parser.add_argument('-t', dest='total_images', help='total images', default=500, type=int)
+parser.add_argument('-r', dest='repeat', help='measurements per image', default=5, type=int)
+args = parser.parse_args()
+
+
+def jpeg_features(path):
+    """Returns (encoded size, decoded samples, progressive, restart markers) or None"""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:2] != b'\xff\xd8':
+        return None
+    pos, samples, progressive, restart = 2, None, False, False
+    while pos + 4 <= len(data):
+        if data[pos] != 0xff:
+            return None
+        marker = data[pos + 1]
+        if marker == 0xff:
+            pos += 1
+            continue
+        length, = struct.unpack('>H', data[pos + 2:pos + 4])
+        segment = data[pos + 4:pos + 2 + length]
+        if marker in (0xc0, 0xc1, 0xc2):
+            progressive = marker == 0xc2
+            h, w, ncomp = struct.unpack('>HHB', segment[1:6])
+            factors = [(segment[7 + 3 * c] >> 4, segment[7 + 3 * c] & 15) for c in range(ncomp)]
+            hmax, vmax = max(f[0] for f in factors), max(f[1] for f in factors)
+            samples = sum(h * w * fh * fv / (hmax * vmax) for fh, fv in factors)
+        elif marker == 0xdd:
+            restart = struct.unpack('>H', segment[:2])[0] != 0
+        elif marker == 0xda:
+            break
+        pos += 2 + length
+    if samples is None:
+        return None
+    return len(data), samples, progressive, restart
+
+
+files = []
+for root, _, names in os.walk(args.images_dir):
+    for name in sorted(names):
+        path = os.path.join(root, name)
+        features = jpeg_features(path)
+        # progressive JPEGs are always decoded on the host - they don't help the fit
+        if features is not None and not features[2]:
+            files.append((path, features))
+files = files[:args.total_images]
+if len(files) < 10:
+    raise RuntimeError('Not enough baseline JPEG images found')
+
+
+def measure(threshold):
+    @pipeline_def(batch_size=1, num_threads=1, device_id=args.device_id, prefetch_queue_depth=1)
+    def decoder_pipe():
+        jpegs, _ = fn.readers.file(files=[p for p, _ in files])
+        return fn.decoders.image(jpegs, device='mixed', output_type=types.RGB, hw_decoder_load=0,
+                                 hybrid_huffman_threshold=threshold)
+
+    pipe = decoder_pipe()
+    pipe.build()
+    pipe.run()  # warmup
+    times = np.zeros(len(files))
+    for _ in range(args.repeat):
+        # the reader starts from the second file, since the first one was used for the warmup
+        for i in range(len(files)):
+            start = time.perf_counter()
+            pipe.run()
+            times[(i + 1) % len(files)] += time.perf_counter() - start
+    return times / args.repeat * 1e9  # ns
+
+
+host_times = measure(threshold=2**32 - 1)
+gpu_times = measure(threshold=0)
+
+nbytes = np.array([f[0] for _, f in files], dtype=np.float64)
+nsamples = np.array([f[1] for _, f in files], dtype=np.float64)
+restart = np.array([f[3] for _, f in files])
+ones = np.ones_like(nbytes)
+
+# host: t = overhead + c0 * bytes + c1 * samples
+(overhead, c0, c1), *_ = np.linalg.lstsq(np.stack([ones, nbytes, nsamples], 1), host_times,
+                                         rcond=None)
+# GPU: t = overhead + c3 + c4 * bytes (/ c5 with restart markers) + the same per-sample work
+gpu_rest = gpu_times - c1 * nsamples
+(gpu_overhead, c4), *_ = np.linalg.lstsq(np.stack([ones[~restart], nbytes[~restart]], 1),
+                                         gpu_rest[~restart], rcond=None)
+c5 = 1.0
+if restart.sum() >= 5:
+    (_, c4_restart), *_ = np.linalg.lstsq(np.stack([ones[restart], nbytes[restart]], 1),
+                                          gpu_rest[restart], rcond=None)
+    if c4_restart > 0:
+        c5 = c4 / c4_restart
+c3 = gpu_overhead - overhead
+c2 = 1.0  # the CPU part of the hybrid decoder can't be separated from the wall time; use default
+
+coeffs = [max(float(c), 0.0) for c in (c0, c1, c2, c3, c4)] + [max(float(c5), 1e-3)]
+print('Images: ', len(files), ', with restart markers: ', int(restart.sum()))
+print('huffman_cost_model=[' + ', '.join(f'{c:.4g}' for c in coeffs) + ']')